@@ -89,6 +89,8 @@ set(OGRE_CONTAINERS_USE_CUSTOM_MEMORY_ALLOCATOR ${OGRE_CONFIG_CONTAINERS_USE_CUS
 set(OGRE_STRING_USE_CUSTOM_MEMORY_ALLOCATOR ${OGRE_CONFIG_STRING_USE_CUSTOM_ALLOCATOR})
 set(OGRE_MEMORY_TRACKER_DEBUG_MODE ${OGRE_CONFIG_MEMTRACK_DEBUG})
 set(OGRE_MEMORY_TRACKER_RELEASE_MODE ${OGRE_CONFIG_MEMTRACK_RELEASE})
+set(OGRE_MEMORY_STATS ${OGRE_CONFIG_MEMSTATS})
+set(OGRE_SIMD_MATH ${OGRE_CONFIG_SIMD_MATH})
 set(OGRE_SET_ASSERT_MODE ${OGRE_ASSERT_MODE})
 set(OGRE_SET_THREADS ${OGRE_CONFIG_THREADS})
 set(OGRE_SET_THREAD_PROVIDER ${OGRE_THREAD_PROVIDER})
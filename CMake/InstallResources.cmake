@@ -76,12 +76,18 @@ endif ()
 if (NOT OGRE_BUILD_RENDERSYSTEM_GLES2)
   set(OGRE_COMMENT_RENDERSYSTEM_GLES2 "#")
 endif ()
+if (NOT OGRE_BUILD_RENDERSYSTEM_NULL)
+  set(OGRE_COMMENT_RENDERSYSTEM_NULL "#")
+endif ()
 if (NOT OGRE_BUILD_PLUGIN_BSP)
   set(OGRE_COMMENT_PLUGIN_BSP "#")
 endif ()
 if (NOT OGRE_BUILD_PLUGIN_OCTREE)
   set(OGRE_COMMENT_PLUGIN_OCTREE "#")
 endif ()
+if (NOT OGRE_BUILD_PLUGIN_BVH)
+  set(OGRE_COMMENT_PLUGIN_BVH "#")
+endif ()
 if (NOT OGRE_BUILD_PLUGIN_PCZ)
   set(OGRE_COMMENT_PLUGIN_PCZ "#")
 endif ()
@@ -70,6 +70,7 @@ protected:
     Ogre::Camera* mCamera;      // main camera
     TrayManager* mTrayMgr;      // tray interface manager
     ParamsPanel* mDetailsPanel; // sample details panel
+    unsigned int mStatsIndex;   // first row of the render statistics
 #ifdef OGRE_BUILD_COMPONENT_RTSHADERSYSTEM
     Ogre::RTShader::ShaderGenerator* mShaderGenerator;
 #endif
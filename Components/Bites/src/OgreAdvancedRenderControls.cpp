@@ -39,6 +39,22 @@ AdvancedRenderControls::AdvancedRenderControls(TrayManager* trayMgr, Ogre::Camer
     items.push_back("Generated FS");
 #endif
 
+    // per frame statistics of the render system
+    mStatsIndex = items.size();
+    items.push_back("");
+    items.push_back("Draw Calls");
+    items.push_back("Program Binds");
+    items.push_back("Texture Binds");
+    items.push_back("State Changes");
+    items.push_back("Uniform KB");
+    items.push_back("Static Lock KB");
+    items.push_back("Dynamic Lock KB");
+    items.push_back("Discard Lock KB");
+    items.push_back("VAO Binds");
+    items.push_back("RT Switches");
+    items.push_back("RT Updates");
+    items.push_back("RT Skipped");
+
     mDetailsPanel = mTrayMgr->createParamsPanel(TL_NONE, "DetailsPanel", 200, items);
     mDetailsPanel->hide();
 
@@ -258,6 +274,20 @@ void AdvancedRenderControls::frameRendered(const Ogre::FrameEvent& evt) {
         mDetailsPanel->setParamValue(14, Ogre::StringConverter::toString(mShaderGenerator->getVertexShaderCount()));
         mDetailsPanel->setParamValue(15, Ogre::StringConverter::toString(mShaderGenerator->getFragmentShaderCount()));
 #endif
+
+        const Ogre::RenderSystem::RenderStats& stats = mRoot->getRenderSystem()->getRenderStats();
+        unsigned int i = mStatsIndex + 1;
+        mDetailsPanel->setParamValue(i++, Ogre::StringConverter::toString(stats.drawCalls));
+        mDetailsPanel->setParamValue(i++, Ogre::StringConverter::toString(stats.programBinds));
+        mDetailsPanel->setParamValue(i++, Ogre::StringConverter::toString(stats.textureBinds));
+        mDetailsPanel->setParamValue(i++, Ogre::StringConverter::toString(stats.stateChanges));
+        mDetailsPanel->setParamValue(i++, Ogre::StringConverter::toString(stats.uniformBytes / 1024));
+        for (int usage = 0; usage < Ogre::HardwareBuffer::LU_COUNT; ++usage)
+            mDetailsPanel->setParamValue(i++, Ogre::StringConverter::toString(stats.bufferLockBytes[usage] / 1024));
+        mDetailsPanel->setParamValue(i++, Ogre::StringConverter::toString(stats.vertexArrayBinds));
+        mDetailsPanel->setParamValue(i++, Ogre::StringConverter::toString(stats.renderTargetSwitches));
+        mDetailsPanel->setParamValue(i++, Ogre::StringConverter::toString(stats.renderTargetUpdates));
+        mDetailsPanel->setParamValue(i++, Ogre::StringConverter::toString(stats.renderTargetsSkipped));
     }
 }
 
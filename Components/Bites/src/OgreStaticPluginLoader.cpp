@@ -15,6 +15,9 @@
 #ifdef OGRE_BUILD_RENDERSYSTEM_GLES2
 #define OGRE_STATIC_GLES2
 #endif
+#ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+#define OGRE_STATIC_Null
+#endif
 #ifdef OGRE_BUILD_RENDERSYSTEM_D3D9
 #define OGRE_STATIC_Direct3D9
 #endif
@@ -70,6 +73,9 @@
 #ifdef OGRE_STATIC_GLES2
 #  include "OgreGLES2Plugin.h"
 #endif
+#ifdef OGRE_STATIC_Null
+#  include "OgreNullPlugin.h"
+#endif
 #ifdef OGRE_STATIC_Direct3D9
 #  include "OgreD3D9Plugin.h"
 #endif
@@ -105,6 +111,10 @@ void OgreBites::StaticPluginLoader::load()
     plugin = OGRE_NEW GLES2Plugin();
     mPlugins.push_back(plugin);
 #endif
+#ifdef OGRE_STATIC_Null
+    plugin = OGRE_NEW NullPlugin();
+    mPlugins.push_back(plugin);
+#endif
 #ifdef OGRE_STATIC_Direct3D9
     plugin = OGRE_NEW D3D9Plugin();
     mPlugins.push_back(plugin);
@@ -42,58 +42,28 @@ namespace Ogre
 	/** \addtogroup Hlms
 	*  @{
 	*/
-    class SubStringRef;
-
 	class _OgreHlmsExport ShaderGenerator : public PassAlloc
 	{
-	protected:
-
-		typedef map<IdString, String>::type PiecesMap;
-
-		enum ExpressionType
-		{
-			EXPR_OPERATOR_OR,        //||
-			EXPR_OPERATOR_AND,       //&&
-			EXPR_OBJECT,             //(...)
-			EXPR_VAR
-		};
-
-		struct Expression
-		{
-			bool                    result;
-			bool                    negated;
-			ExpressionType          type;
-			vector<Expression>::type children;
-			String            value;
-
-			Expression() : result(false), negated(false), type(EXPR_VAR) {}
-		};
-
-		typedef vector<Expression>::type ExpressionVec;
-
-		static void copy(String &outBuffer, const SubStringRef &inSubString, size_t length);
-		static void repeat(String &outBuffer, const SubStringRef &inSubString, size_t length,
-			size_t passNum, const String &counterVar);
-		static bool parseMath(const String &inBuffer, String &outBuffer, PropertyMap &properties);
-		static bool parseForEach(const String &inBuffer, String &outBuffer, PropertyMap &properties);
-		static bool parseProperties(String &inBuffer, String &outBuffer, PropertyMap &properties);
-		static bool collectPieces(const String &inBuffer, String &outBuffer, PropertyMap &properties, PiecesMap& pieces);
-		static bool insertPieces(String &inBuffer, String &outBuffer, PropertyMap &properties, PiecesMap& pieces);
-		static bool parseCounter(const String &inBuffer, String &outBuffer, PropertyMap &properties);
-
-		static void findBlockEnd(SubStringRef &outSubString, bool &syntaxError);
-
-		static bool evaluateExpression(SubStringRef &outSubString, bool &outSyntaxError, PropertyMap &properties);
-		static bool evaluateExpressionRecursive(ExpressionVec &expression, bool &outSyntaxError, PropertyMap &properties);
-		static size_t evaluateExpressionEnd(const SubStringRef &outSubString);
-
-		static void evaluateParamArgs(SubStringRef &outSubString, StringVector &outArgs,
-			bool &outSyntaxError);
-
-		static size_t calculateLineCount(const String &buffer, size_t idx);
-		static size_t calculateLineCount(const SubStringRef &subString);
-
 	public:
+		/** A shader template and its piece files, parsed into blocks.
+		@remarks
+			Compiling does not depend on any properties, so the result is shared
+			by all permutations of a template. Generating a permutation evaluates
+			the blocks against its properties in a single pass, instead of
+			rescanning the text once per keyword.
+		*/
+		struct CompiledTemplate;
+
+		/** Parse a template and the piece files it inserts from.
+		@return The compiled template, to be released with destroy().
+		*/
+		static CompiledTemplate* compile(const String& templateSource, const StringVector& pieceFiles);
+		static void destroy(CompiledTemplate* compiledTemplate);
+
+		/// Generate the shader code of a compiled template for the given properties
+		static String generate(const CompiledTemplate& compiledTemplate, PropertyMap &properties);
+
+		/// Compile and generate in one go, for templates used only once
 		static String parse(String &inBuffer, PropertyMap &properties, const StringVector& pieceFiles);
 	};
 }
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "Ogre.h"		 
 #include "OgreHlmsPrerequisites.h"
 #include "OgreHlmsShaderPiecesManager.h"
+#include "OgreHlmsShaderGenerator.h"
 
 namespace Ogre
 {
@@ -54,8 +55,11 @@ namespace Ogre
 
 	protected:
 		typedef map<uint32, GpuProgramPtr>::type ShaderCacheMap;
+		/// Compiled templates by template hash, language and shader type
+		typedef map<String, ShaderGenerator::CompiledTemplate*>::type CompiledTemplateMap;
 
 		ShaderCacheMap mShaderCache;
+		CompiledTemplateMap mCompiledTemplates;
 		ShaderPiecesManager mShaderPiecesManager;
     };
 }
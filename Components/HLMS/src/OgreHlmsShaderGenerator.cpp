@@ -30,1011 +30,948 @@ THE SOFTWARE.
 
 namespace Ogre
 {
-    class SubStringRef
-    {
-        String const *mOriginal;
-        size_t  mStart;
-        size_t  mEnd;
-
-    public:
-        SubStringRef(const String *original, size_t start) :
-            mOriginal( original ),
-            mStart( start ),
-            mEnd( original->size() )
-        {
-            assert( start <= original->size() );
-        }
-
-        SubStringRef(const String *original, size_t _start, size_t _end) :
-            mOriginal( original ),
-            mStart( _start ),
-            mEnd( _end )
-        {
-            assert( _start <= _end );
-            assert( _end <= original->size() );
-        }
-
-        SubStringRef(const String *original, String::const_iterator _start) :
-            mOriginal( original ),
-            mStart( _start - original->begin() ),
-            mEnd( original->size() )
-        {
-        }
-
-        size_t find( const char *value, size_t pos=0 ) const
-        {
-            size_t retVal = mOriginal->find( value, mStart + pos );
-            if( retVal >= mEnd )
-                retVal = String::npos;
-            else if (retVal != String::npos)
-                retVal -= mStart;
-
-            return retVal;
-        }
-
-        size_t find(const String &value) const
-        {
-            size_t retVal = mOriginal->find( value, mStart );
-            if( retVal >= mEnd )
-                retVal = String::npos;
-            else if (retVal != String::npos)
-                retVal -= mStart;
-
-            return retVal;
-        }
-
-        size_t findFirstOf( const char *c, size_t pos ) const
-        {
-            size_t retVal = mOriginal->find_first_of( c, mStart + pos );
-            if( retVal >= mEnd )
-                retVal = String::npos;
-            else if (retVal != String::npos)
-                retVal -= mStart;
-
-            return retVal;
-        }
-
-        bool matchEqual( const char *stringCompare ) const
-        {
-            const char *origStr = mOriginal->c_str() + mStart;
-            ptrdiff_t length = mEnd - mStart;
-            while( *origStr == *stringCompare && *origStr && --length )
-                ++origStr, ++stringCompare;
-
-            return length == 0 && *origStr == *stringCompare;
-        }
-
-        void setStart( size_t newStart )            { mStart = std::min( newStart, mOriginal->size() ); }
-        void setEnd( size_t newEnd )                { mEnd = std::min( newEnd, mOriginal->size() ); }
-        size_t getStart(void) const                 { return mStart; }
-        size_t getEnd(void) const                   { return mEnd; }
-        size_t getSize(void) const                  { return mEnd - mStart; }
-        String::const_iterator begin() const        { return mOriginal->begin() + mStart; }
-        String::const_iterator end() const          { return mOriginal->begin() + mEnd; }
-        const String& getOriginalBuffer() const     { return *mOriginal; }
-    };
-	//-----------------------------------------------------------------------------------
-	void ShaderGenerator::findBlockEnd(SubStringRef &outSubString, bool &syntaxError)
+	int setOp(int op1, int op2) { return op2; }
+	int addOp(int op1, int op2) { return op1 + op2; }
+	int subOp(int op1, int op2) { return op1 - op2; }
+	int mulOp(int op1, int op2) { return op1 * op2; }
+	int divOp(int op1, int op2) { return op1 / op2; }
+	int modOp(int op1, int op2) { return op1 % op2; }
+
+	struct Operation
+	{
+		const char *opName;
+		size_t length;
+		int(*opFunc)(int, int);
+		Operation(const char *_name, size_t len, int(*_opFunc)(int, int)) :
+			opName(_name), length(len), opFunc(_opFunc) {}
+	};
+
+	const Operation c_operations[6] =
+	{
+		Operation("pset", sizeof("@pset"), &setOp),
+		Operation("padd", sizeof("@padd"), &addOp),
+		Operation("psub", sizeof("@psub"), &subOp),
+		Operation("pmul", sizeof("@pmul"), &mulOp),
+		Operation("pdiv", sizeof("@pdiv"), &divOp),
+		Operation("pmod", sizeof("@pmod"), &modOp)
+	};
+
+	const Operation c_counterOperations[8] =
+	{
+		Operation("counter", sizeof("@counter"), 0),
+		Operation("value", sizeof("@value"), 0),
+		Operation("set", sizeof("@set"), &setOp),
+		Operation("add", sizeof("@add"), &addOp),
+		Operation("sub", sizeof("@sub"), &subOp),
+		Operation("mul", sizeof("@mul"), &mulOp),
+		Operation("div", sizeof("@div"), &divOp),
+		Operation("mod", sizeof("@mod"), &modOp)
+	};
+
+	namespace
 	{
-		const char *blockNames[] =
+		/// Argument of a keyword, either a number or a property name
+		struct Argument
 		{
-			"foreach",
-			"property",
-			"piece"
+			String text;
+			IdString name;
+			/// The name refers to the counter of an enclosing @foreach, e.g. uv@n
+			bool hasCounter;
+			bool isNumber;
+			int number;
+
+			Argument() : hasCounter(false), isNumber(false), number(0) {}
 		};
 
-		String::const_iterator it = outSubString.begin();
-		String::const_iterator en = outSubString.end();
+		typedef vector<Argument>::type ArgumentVec;
 
-		int nesting = 0;
+		enum ExpressionType
+		{
+			EXPR_OPERATOR_OR,        //||
+			EXPR_OPERATOR_AND,       //&&
+			EXPR_OBJECT,             //(...)
+			EXPR_VAR
+		};
 
-		while (it != en && nesting >= 0)
+		struct Expression
 		{
-			if (*it == '@')
-			{
-				SubStringRef subString(&outSubString.getOriginalBuffer(), it + 1);
+			bool                    negated;
+			ExpressionType          type;
+			vector<Expression>::type children;
+			String                  value;
+			IdString                name;
+			bool                    hasCounter;
+
+			Expression() : negated(false), type(EXPR_VAR), hasCounter(false) {}
+		};
 
-				size_t idx = subString.find("end");
-				if (idx == 0)
-				{
-					--nesting;
-					it += sizeof("end") - 1;
-				}
-				else
-				{
-					for (size_t i = 0; i < sizeof(blockNames) / sizeof(char*); ++i)
-					{
-						size_t idxBlock = subString.find(blockNames[i]);
-						if (idxBlock == 0)
-						{
-							it = subString.begin() + strlen(blockNames[i]);
-							++nesting;
-							break;
-						}
-					}
-				}
-			}
+		typedef vector<Expression>::type ExpressionVec;
 
-			++it;
-		}
+		enum NodeType
+		{
+			NODE_TEXT,           // Text copied as is
+			NODE_COUNTER,        // @n, the counter of an enclosing @foreach( n, ... )
+			NODE_FOREACH,        // @foreach( n, start, count ) ... @end
+			NODE_PROPERTY,       // @property( expression ) ... @end
+			NODE_PIECE,          // @piece( name ) ... @end
+			NODE_INSERT_PIECE,   // @insertpiece( name )
+			NODE_COUNTER_OP      // @counter, @value, @set, @add, ...
+		};
+
+		struct Node
+		{
+			NodeType type;
+			/// Range of the text, or for counters how many @foreach to go up
+			size_t start;
+			size_t length;
+			/// Index into c_counterOperations
+			size_t operation;
+			size_t line;
+			ArgumentVec args;
+			ExpressionVec expression;
+			vector<Node>::type children;
+
+			Node(NodeType _type, size_t _line) :
+				type(_type), start(0), length(0), operation(0), line(_line) {}
+		};
 
-		assert(nesting == -1);
+		typedef vector<Node>::type NodeVec;
 
-		if (nesting == -1)
-			outSubString.setEnd(it - outSubString.getOriginalBuffer().begin() - sizeof("end"));
-		else
+		/// @pset, @padd, ... which are applied before anything else of their file
+		struct MathOperation
 		{
-			syntaxError = false;
-			printf("Syntax Error at line %zu: start block (e.g. @foreach; @property) "
-				"without matching @end\n", calculateLineCount(outSubString));
-		}
-	}
-	//-----------------------------------------------------------------------------------
-	bool ShaderGenerator::evaluateExpression(SubStringRef &outSubString, bool &outSyntaxError, PropertyMap &properties)
-	{
-		size_t expEnd = evaluateExpressionEnd(outSubString);
+			size_t operation;
+			ArgumentVec args;
+		};
 
-		if (expEnd == String::npos)
+		struct Source
 		{
-			outSyntaxError = true;
-			return false;
-		}
+			String text;
+			vector<MathOperation>::type mathOperations;
+			NodeVec nodes;
+		};
 
-		SubStringRef subString(&outSubString.getOriginalBuffer(), outSubString.getStart(),
-			outSubString.getStart() + expEnd);
+		/// Counter of a @foreach being generated
+		struct CounterScope
+		{
+			const String *name;
+			int value;
+			const CounterScope *parent;
+		};
 
-		outSubString = SubStringRef(&outSubString.getOriginalBuffer(),
-			outSubString.getStart() + expEnd + 1);
+		/// Position in the generated text where a piece is inserted or a counter op runs
+		struct Marker
+		{
+			size_t offset;
+			const Node *node;
+			IdString names[3];
+		};
 
-		bool textStarted = false;
-		bool syntaxError = false;
-		bool nextExpressionNegates = false;
+		/// Generated text of a file or piece, up to inserting the pieces
+		struct Output
+		{
+			String text;
+			vector<Marker>::type markers;
+		};
 
-		vector<Expression*>::type expressionParents;
-		ExpressionVec outExpressions;
-		outExpressions.clear();
-		outExpressions.resize(1);
+		typedef map<IdString, Output>::type PiecesMap;
 
-		Expression *currentExpression = &outExpressions.back();
+		/// Maximum nesting of @insertpiece, protects against pieces inserting themselves
+		const size_t c_maxPieceDepth = 32;
+	}
 
-		String::const_iterator it = subString.begin();
-		String::const_iterator en = subString.end();
+	struct ShaderGenerator::CompiledTemplate : public PassAlloc
+	{
+		/// The piece files followed by the template itself
+		vector<Source>::type sources;
+	};
 
-		while (it != en && !syntaxError)
+	namespace
+	{
+		//-----------------------------------------------------------------------------------
+		class TemplateCompiler
 		{
-			char c = *it;
+		public:
+			TemplateCompiler(Source &source) : mSource(source), mText(source.text), mLinePos(0), mLine(1) {}
 
-			if (c == '(')
+			void compile()
 			{
-				currentExpression->children.push_back(Expression());
-				expressionParents.push_back(currentExpression);
-
-				currentExpression->children.back().negated = nextExpressionNegates;
+				size_t pos = 0;
+				compileBlock(pos, mSource.nodes, false);
+			}
 
-				textStarted = false;
-				nextExpressionNegates = false;
+		private:
+			Source &mSource;
+			const String &mText;
+			/// Names of the counters of the enclosing @foreach blocks
+			vector<const String*>::type mCounters;
+			size_t mLinePos;
+			size_t mLine;
 
-				currentExpression = &currentExpression->children.back();
-			}
-			else if (c == ')')
+			size_t lineAt(size_t pos)
 			{
-				if (expressionParents.empty())
-					syntaxError = true;
-				else
+				if (pos < mLinePos)
 				{
-					currentExpression = expressionParents.back();
-					expressionParents.pop_back();
+					mLinePos = 0;
+					mLine = 1;
 				}
 
-				textStarted = false;
-			}
-			else if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
-			{
-				textStarted = false;
+				for (; mLinePos < pos; ++mLinePos)
+				{
+					if (mText[mLinePos] == '\n')
+						++mLine;
+				}
+
+				return mLine;
 			}
-			else if (c == '!')
+
+			bool startsWith(size_t pos, const char *value) const
 			{
-				nextExpressionNegates = true;
+				return mText.compare(pos, strlen(value), value) == 0;
 			}
-			else
+
+			size_t findOperation(const Operation *operations, size_t count, size_t at) const
 			{
-				if (!textStarted)
-				{
-					textStarted = true;
-					currentExpression->children.push_back(Expression());
-					currentExpression->children.back().negated = nextExpressionNegates;
-				}
+				size_t keywordEnd = mText.find_first_of(" \t(", at + 1);
+				keywordEnd = keywordEnd == String::npos ? mText.size() : keywordEnd;
 
-				if (c == '&' || c == '|')
+				for (size_t i = 0; i < count; ++i)
 				{
-					if (currentExpression->children.empty() || nextExpressionNegates)
-					{
-						syntaxError = true;
-					}
-					else if (!currentExpression->children.back().value.empty() &&
-						c != *(currentExpression->children.back().value.end() - 1))
-					{
-						currentExpression->children.push_back(Expression());
-					}
+					if (mText.compare(at + 1, keywordEnd - at - 1, operations[i].opName) == 0)
+						return i;
 				}
 
-				currentExpression->children.back().value.push_back(c);
-				nextExpressionNegates = false;
+				return ~(size_t)0;
 			}
 
-			++it;
-		}
-
-		bool retVal = false;
-
-		if (!expressionParents.empty())
-			syntaxError = true;
-
-		if (!syntaxError)
-			retVal = evaluateExpressionRecursive(outExpressions, syntaxError, properties);
+			/// Index of the counter named after the '@' at the given position, innermost first
+			size_t findCounter(size_t at) const
+			{
+				for (size_t i = mCounters.size(); i > 0; --i)
+				{
+					const String &name = *mCounters[i - 1];
+					if (!name.empty() && mText.compare(at + 1, name.size(), name) == 0)
+						return mCounters.size() - i;
+				}
 
-		if (syntaxError)
-			printf("Syntax Error at line %zu\n", calculateLineCount(subString));
+				return ~(size_t)0;
+			}
 
-		outSyntaxError = syntaxError;
+			void addText(NodeVec &nodes, size_t start, size_t end)
+			{
+				if (start >= end)
+					return;
 
-		return retVal;
-	}
-	//-----------------------------------------------------------------------------------
-	bool ShaderGenerator::evaluateExpressionRecursive(ExpressionVec &expression, bool &outSyntaxError, PropertyMap &properties)
-	{
-		ExpressionVec::iterator itor = expression.begin();
-		ExpressionVec::iterator end = expression.end();
+				if (!nodes.empty() && nodes.back().type == NODE_TEXT &&
+					nodes.back().start + nodes.back().length == start)
+				{
+					nodes.back().length += end - start;
+					return;
+				}
 
-		while (itor != end)
-		{
-			if (itor->value == "&&")
-				itor->type = EXPR_OPERATOR_AND;
-			else if (itor->value == "||")
-				itor->type = EXPR_OPERATOR_OR;
-			else if (!itor->children.empty())
-				itor->type = EXPR_OBJECT;
-			else
-				itor->type = EXPR_VAR;
-
-			++itor;
-		}
+				nodes.push_back(Node(NODE_TEXT, 0));
+				nodes.back().start = start;
+				nodes.back().length = end - start;
+			}
 
-		bool syntaxError = outSyntaxError;
-		bool lastExpWasOperator = true;
+			size_t findExpressionEnd(size_t pos)
+			{
+				int nesting = 0;
 
-		itor = expression.begin();
+				for (size_t i = pos; i < mText.size(); ++i)
+				{
+					if (mText[i] == '(')
+						++nesting;
+					else if (mText[i] == ')' && --nesting < 0)
+						return i;
+				}
 
-		while (itor != end && !syntaxError)
-		{
-			Expression &exp = *itor;
-			if (((exp.type == EXPR_OPERATOR_OR || exp.type == EXPR_OPERATOR_AND) && lastExpWasOperator) ||
-				((exp.type == EXPR_VAR || exp.type == EXPR_OBJECT) && !lastExpWasOperator))
-			{
-				syntaxError = true;
-				printf("Unrecognized token '%s'", exp.value.c_str());
+				printf("Syntax Error at line %zu: opening parenthesis without matching closure\n",
+					lineAt(pos));
+				return String::npos;
 			}
-			else if (exp.type == EXPR_OPERATOR_OR || exp.type == EXPR_OPERATOR_AND)
-			{
-				lastExpWasOperator = true;
-			}
-			else if (exp.type == EXPR_VAR)
-			{
-				exp.result = properties.getProperty(exp.value) != 0;
-				lastExpWasOperator = false;
-			}
-			else
+
+			bool parseArgs(size_t &pos, ArgumentVec &outArgs, int numberBase, bool allowCounters = true)
 			{
-				exp.result = evaluateExpressionRecursive(exp.children, syntaxError, properties);
-				lastExpWasOperator = false;
-			}
+				size_t expEnd = findExpressionEnd(pos);
 
-			++itor;
-		}
+				if (expEnd == String::npos)
+					return false;
 
-		bool retVal = true;
+				int expressionState = 0;
+				bool syntaxError = false;
 
-		if (!syntaxError)
-		{
-			itor = expression.begin();
-			bool andMode = true;
+				outArgs.clear();
+				outArgs.push_back(Argument());
 
-			while (itor != end)
-			{
-				if (itor->type == EXPR_OPERATOR_OR)
-					andMode = false;
-				else if (itor->type == EXPR_OPERATOR_AND)
-					andMode = true;
-				else
+				for (size_t i = pos; i < expEnd && !syntaxError; ++i)
 				{
-					if (andMode)
-						retVal &= itor->negated ? !itor->result : itor->result;
+					char c = mText[i];
+
+					if (c == '@' && allowCounters && !mCounters.empty())
+					{
+						// Replaced by the counter value while generating
+						outArgs.back().text.push_back(c);
+						outArgs.back().hasCounter = true;
+						expressionState = 1;
+					}
+					else if (c == '(' || c == ')' || c == '@' || c == '&' || c == '|')
+					{
+						syntaxError = true;
+					}
+					else if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+					{
+						if (expressionState == 1)
+							expressionState = 2;
+					}
+					else if (c == ',')
+					{
+						expressionState = 0;
+						outArgs.push_back(Argument());
+					}
 					else
-						retVal |= itor->negated ? !itor->result : itor->result;
+					{
+						if (expressionState == 2)
+						{
+							printf("Syntax Error at line %zu: ',' or ')' expected\n", lineAt(i));
+							syntaxError = true;
+						}
+						else
+						{
+							outArgs.back().text.push_back(c);
+							expressionState = 1;
+						}
+					}
 				}
 
-				++itor;
-			}
-		}
-
-		outSyntaxError = syntaxError;
-
-		return retVal;
-	}
-	//-----------------------------------------------------------------------------------
-	size_t ShaderGenerator::evaluateExpressionEnd(const SubStringRef &outSubString)
-	{
-		String::const_iterator it = outSubString.begin();
-		String::const_iterator en = outSubString.end();
-
-		int nesting = 0;
-
-		while (it != en && nesting >= 0)
-		{
-			if (*it == '(')
-				++nesting;
-			else if (*it == ')')
-				--nesting;
-			++it;
-		}
+				if (syntaxError)
+				{
+					printf("Syntax Error at line %zu\n", lineAt(pos));
+					return false;
+				}
 
-		assert(nesting >= -1);
+				ArgumentVec::iterator itor = outArgs.begin();
+				ArgumentVec::iterator end = outArgs.end();
 
-		size_t retVal = String::npos;
-		if (it != en && nesting < 0)
-		{
-			retVal = it - outSubString.begin() - 1;
-		}
-		else
-		{
-			printf("Syntax Error at line %zu: opening parenthesis without matching closure\n",
-				calculateLineCount(outSubString));
-		}
+				for (; itor != end; ++itor)
+				{
+					char *endPtr;
+					itor->number = (int)strtol(itor->text.c_str(), &endPtr, numberBase);
+					itor->isNumber = itor->text.c_str() != endPtr;
 
-		return retVal;
-	}
-	//-----------------------------------------------------------------------------------
-	void ShaderGenerator::evaluateParamArgs(SubStringRef &outSubString, StringVector &outArgs,
-		bool &outSyntaxError)
-	{
-		size_t expEnd = evaluateExpressionEnd(outSubString);
+					if (!itor->hasCounter)
+						itor->name = itor->text;
+				}
 
-		if (expEnd == String::npos)
-		{
-			outSyntaxError = true;
-			return;
-		}
+				pos = expEnd + 1;
+				return true;
+			}
 
-		SubStringRef subString(&outSubString.getOriginalBuffer(), outSubString.getStart(),
-			outSubString.getStart() + expEnd);
+			bool classifyExpression(ExpressionVec &expression)
+			{
+				ExpressionVec::iterator itor = expression.begin();
+				ExpressionVec::iterator end = expression.end();
 
-		outSubString = SubStringRef(&outSubString.getOriginalBuffer(),
-			outSubString.getStart() + expEnd + 1);
+				bool lastExpWasOperator = true;
 
-		int expressionState = 0;
-		bool syntaxError = false;
+				for (; itor != end; ++itor)
+				{
+					Expression &exp = *itor;
+
+					if (exp.value == "&&")
+						exp.type = EXPR_OPERATOR_AND;
+					else if (exp.value == "||")
+						exp.type = EXPR_OPERATOR_OR;
+					else if (!exp.children.empty())
+						exp.type = EXPR_OBJECT;
+					else
+						exp.type = EXPR_VAR;
 
-		outArgs.clear();
-		outArgs.push_back(String());
+					bool isOperator = exp.type == EXPR_OPERATOR_OR || exp.type == EXPR_OPERATOR_AND;
+					if (isOperator == lastExpWasOperator)
+					{
+						printf("Unrecognized token '%s'", exp.value.c_str());
+						return false;
+					}
+					lastExpWasOperator = isOperator;
 
-		String::const_iterator it = subString.begin();
-		String::const_iterator en = subString.end();
+					if (exp.type == EXPR_OBJECT && !classifyExpression(exp.children))
+						return false;
 
-		while (it != en && !syntaxError)
-		{
-			char c = *it;
+					if (exp.type == EXPR_VAR)
+					{
+						exp.hasCounter = !mCounters.empty() && exp.value.find('@') != String::npos;
+						if (!exp.hasCounter)
+							exp.name = exp.value;
+					}
+				}
 
-			if (c == '(' || c == ')' || c == '@' || c == '&' || c == '|')
-			{
-				syntaxError = true;
-			}
-			else if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
-			{
-				if (expressionState == 1)
-					expressionState = 2;
+				return true;
 			}
-			else if (c == ',')
-			{
-				expressionState = 0;
-				outArgs.push_back(String());
-			}
-			else
+
+			bool parseExpression(size_t &pos, ExpressionVec &outExpressions)
 			{
-				if (expressionState == 2)
-				{
-					printf("Syntax Error at line %zu: ',' or ')' expected\n",
-						calculateLineCount(subString));
-					syntaxError = true;
-				}
-				else
-				{
-					outArgs.back().push_back(*it);
-					expressionState = 1;
-				}
-			}
+				size_t expEnd = findExpressionEnd(pos);
 
-			++it;
-		}
+				if (expEnd == String::npos)
+					return false;
 
-		if (syntaxError)
-			printf("Syntax Error at line %zu\n", calculateLineCount(subString));
+				bool textStarted = false;
+				bool syntaxError = false;
+				bool nextExpressionNegates = false;
 
-		outSyntaxError = syntaxError;
-	}
-	//-----------------------------------------------------------------------------------
-	void ShaderGenerator::copy(String &outBuffer, const SubStringRef &inSubString, size_t length)
-	{
-		String::const_iterator itor = inSubString.begin();
-		String::const_iterator end = inSubString.begin() + length;
+				vector<Expression*>::type expressionParents;
+				outExpressions.clear();
+				outExpressions.resize(1);
 
-		while (itor != end)
-			outBuffer.push_back(*itor++);
-	}
-	//-----------------------------------------------------------------------------------
-	void ShaderGenerator::repeat(String &outBuffer, const SubStringRef &inSubString, size_t length,
-		size_t passNum, const String &counterVar)
-	{
-		String::const_iterator itor = inSubString.begin();
-		String::const_iterator end = inSubString.begin() + length;
+				Expression *currentExpression = &outExpressions.back();
 
-		while (itor != end)
-		{
-			if (*itor == '@' && !counterVar.empty())
-			{
-				SubStringRef subString(&inSubString.getOriginalBuffer(), itor + 1);
-				if (subString.find(counterVar) == 0)
+				for (size_t i = pos; i < expEnd && !syntaxError; ++i)
 				{
-					outBuffer += StringConverter::toString(passNum);
-					itor += counterVar.size() + 1;
-				}
-				else
-				{
-					outBuffer.push_back(*itor++);
-				}
-			}
-			else
-			{
-				outBuffer.push_back(*itor++);
-			}
-		}
-	}
-	//-----------------------------------------------------------------------------------
-	int setOp(int op1, int op2) { return op2; }
-	int addOp(int op1, int op2) { return op1 + op2; }
-	int subOp(int op1, int op2) { return op1 - op2; }
-	int mulOp(int op1, int op2) { return op1 * op2; }
-	int divOp(int op1, int op2) { return op1 / op2; }
-	int modOp(int op1, int op2) { return op1 % op2; }
-
-	struct Operation
-	{
-		const char *opName;
-		size_t length;
-		int(*opFunc)(int, int);
-		Operation(const char *_name, size_t len, int(*_opFunc)(int, int)) :
-			opName(_name), length(len), opFunc(_opFunc) {}
-	};
-
-	const Operation c_operations[6] =
-	{
-		Operation("pset", sizeof("@pset"), &setOp),
-		Operation("padd", sizeof("@padd"), &addOp),
-		Operation("psub", sizeof("@psub"), &subOp),
-		Operation("pmul", sizeof("@pmul"), &mulOp),
-		Operation("pdiv", sizeof("@pdiv"), &divOp),
-		Operation("pmod", sizeof("@pmod"), &modOp)
-	};
-	//-----------------------------------------------------------------------------------
-	bool ShaderGenerator::parseMath(const String &inBuffer, String &outBuffer, PropertyMap &properties)
-	{
-		outBuffer.clear();
-		outBuffer.reserve(inBuffer.size());
+					char c = mText[i];
 
-		StringVector argValues;
-		SubStringRef subString(&inBuffer, 0);
-
-		size_t pos;
-		pos = subString.find("@");
-		size_t keyword = ~0;
+					if (c == '(')
+					{
+						currentExpression->children.push_back(Expression());
+						expressionParents.push_back(currentExpression);
 
-		while (pos != String::npos && keyword == (size_t)~0)
-		{
-			size_t maxSize = subString.findFirstOf(" \t(", pos + 1);
-			maxSize = maxSize == String::npos ? subString.getSize() : maxSize;
-			SubStringRef keywordStr(&inBuffer, subString.getStart() + pos + 1,
-				subString.getStart() + maxSize);
+						currentExpression->children.back().negated = nextExpressionNegates;
 
-			for (size_t i = 0; i < 6 && keyword == (size_t)~0; ++i)
-			{
-				if (keywordStr.matchEqual(c_operations[i].opName))
-					keyword = i;
-			}
+						textStarted = false;
+						nextExpressionNegates = false;
 
-			if (keyword == (size_t)~0)
-				pos = subString.find("@", pos + 1);
-		}
+						currentExpression = &currentExpression->children.back();
+					}
+					else if (c == ')')
+					{
+						if (expressionParents.empty())
+							syntaxError = true;
+						else
+						{
+							currentExpression = expressionParents.back();
+							expressionParents.pop_back();
+						}
 
-		bool syntaxError = false;
+						textStarted = false;
+					}
+					else if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+					{
+						textStarted = false;
+					}
+					else if (c == '!')
+					{
+						nextExpressionNegates = true;
+					}
+					else
+					{
+						if (!textStarted)
+						{
+							textStarted = true;
+							currentExpression->children.push_back(Expression());
+							currentExpression->children.back().negated = nextExpressionNegates;
+						}
 
-		while (pos != String::npos && !syntaxError)
-		{
-			//Copy what comes before the block
-			copy(outBuffer, subString, pos);
+						if (c == '&' || c == '|')
+						{
+							if (currentExpression->children.empty() || nextExpressionNegates)
+							{
+								syntaxError = true;
+							}
+							else if (!currentExpression->children.back().value.empty() &&
+								c != *(currentExpression->children.back().value.end() - 1))
+							{
+								currentExpression->children.push_back(Expression());
+							}
+						}
 
-			subString.setStart(subString.getStart() + pos + c_operations[keyword].length);
-			evaluateParamArgs(subString, argValues, syntaxError);
+						currentExpression->children.back().value.push_back(c);
+						nextExpressionNegates = false;
+					}
+				}
 
-			syntaxError |= argValues.size() < 2 || argValues.size() > 3;
+				if (!expressionParents.empty())
+					syntaxError = true;
 
-			if (!syntaxError)
-			{
-				IdString dstProperty;
-				IdString srcProperty;
-				int op1Value;
-				int op2Value;
+				if (!syntaxError)
+					syntaxError = !classifyExpression(outExpressions);
 
-				dstProperty = argValues[0];
-				size_t idx = 1;
-				srcProperty = dstProperty;
-				if (argValues.size() == 3)
-					srcProperty = argValues[idx++];
-				op1Value = properties.getProperty(srcProperty);
-				op2Value = StringConverter::parseInt(argValues[idx],
-					-std::numeric_limits<int>::max());
-
-				if (op2Value == -std::numeric_limits<int>::max())
+				if (syntaxError)
 				{
-					//Not a number, interpret as property
-					op2Value = properties.getProperty(argValues[idx]);
+					printf("Syntax Error at line %zu\n", lineAt(pos));
+					return false;
 				}
 
-				int result = c_operations[keyword].opFunc(op1Value, op2Value);
-				properties.setProperty(dstProperty, result);
+				pos = expEnd + 1;
+				return true;
 			}
-			else
+
+			/// Skip the @end of a block, @foreach and @piece also swallow the character after it
+			void skipBlockEnd(size_t &pos, bool swallowNext)
 			{
-				size_t lineCount = calculateLineCount(subString);
-				if (keyword <= 1)
-				{
-					printf("Syntax Error at line %zu: @%s expects one parameter",
-						lineCount, c_operations[keyword].opName);
-				}
-				else
-				{
-					printf("Syntax Error at line %zu: @%s expects two or three parameters",
-						lineCount, c_operations[keyword].opName);
-				}
+				pos = std::min(pos + sizeof("@end") - (swallowNext ? 0 : 1), mText.size());
 			}
 
-			pos = subString.find("@");
-			keyword = ~0;
-
-			while (pos != String::npos && keyword == (size_t)~0)
+			bool compileBlock(size_t &pos, NodeVec &nodes, bool inBlock)
 			{
-				size_t maxSize = subString.findFirstOf(" \t(", pos + 1);
-				maxSize = maxSize == String::npos ? subString.getSize() : maxSize;
-				SubStringRef keywordStr(&inBuffer, subString.getStart() + pos + 1,
-					subString.getStart() + maxSize);
+				size_t textStart = pos;
+				size_t at = mText.find('@', pos);
 
-				for (size_t i = 0; i < 6 && keyword == (size_t)~0; ++i)
+				while (at != String::npos)
 				{
-					if (keywordStr.matchEqual(c_operations[i].opName))
-						keyword = i;
-				}
-
-				if (keyword == (size_t)~0)
-					pos = subString.find("@", pos + 1);
-			}
-		}
-
-		copy(outBuffer, subString, subString.getSize());
-
-		return syntaxError;
-	}
-	//-----------------------------------------------------------------------------------
-	bool ShaderGenerator::parseForEach(const String &inBuffer, String &outBuffer, PropertyMap &properties)
-	{
-		outBuffer.clear();
-		outBuffer.reserve(inBuffer.size());
-
-		StringVector argValues;
-		SubStringRef subString(&inBuffer, 0);
-		size_t pos = subString.find("@foreach");
+					size_t line = lineAt(at);
+					size_t keyword = findOperation(c_operations, 6, at);
 
-		bool syntaxError = false;
-
-		while (pos != String::npos && !syntaxError)
-		{
-			//Copy what comes before the block
-			copy(outBuffer, subString, pos);
-
-			subString.setStart(subString.getStart() + pos + sizeof("@foreach"));
-			evaluateParamArgs(subString, argValues, syntaxError);
-
-			SubStringRef blockSubString = subString;
-			findBlockEnd(blockSubString, syntaxError);
+					if (keyword != ~(size_t)0)
+					{
+						// Math is applied to the properties before anything else of the file
+						addText(nodes, textStart, at);
+						pos = at + c_operations[keyword].length;
 
-			if (!syntaxError)
-			{
-				char *endPtr;
+						mSource.mathOperations.push_back(MathOperation());
+						MathOperation &mathOperation = mSource.mathOperations.back();
+						mathOperation.operation = keyword;
 
-				// Arg 1 (var)
-				String counterVar;
-				counterVar = argValues[0];
+						if (!parseArgs(pos, mathOperation.args, 0, false) ||
+							mathOperation.args.size() < 2 || mathOperation.args.size() > 3)
+						{
+							printf("Syntax Error at line %zu: @%s expects two or three parameters",
+								line, c_operations[keyword].opName);
+							mSource.mathOperations.pop_back();
+							return false;
+						}
+					}
+					else if (startsWith(at + 1, "end"))
+					{
+						if (inBlock)
+						{
+							addText(nodes, textStart, at);
+							pos = at;
+							return true;
+						}
 
-				// Agr 2 (start)
-				long start = strtol(argValues[1].c_str(), &endPtr, 10);
-				if (argValues[1].c_str() == endPtr)
-				{
-					//This isn't a number. Let's try if it's a variable
-					start = properties.getProperty(argValues[1], 0);
-				}
+						// Stray @end, kept as text
+						at = mText.find('@', at + 1);
+						continue;
+					}
+					else if ((keyword = findCounter(at)) != ~(size_t)0)
+					{
+						addText(nodes, textStart, at);
+						nodes.push_back(Node(NODE_COUNTER, line));
+						nodes.back().start = keyword;
+						pos = at + 1 + mCounters[mCounters.size() - 1 - keyword]->size();
+					}
+					else if (startsWith(at + 1, "foreach"))
+					{
+						addText(nodes, textStart, at);
+						pos = at + sizeof("@foreach");
 
-				// Arg 3 (count)
-				long count = strtol(argValues[2].c_str(), &endPtr, 10);
-				if (argValues[2].c_str() == endPtr)
-				{
-					//This isn't a number. Let's try if it's a variable
-					count = properties.getProperty(argValues[2], 0);
-				}
+						nodes.push_back(Node(NODE_FOREACH, line));
+						Node &node = nodes.back();
 
-				// Repeat the block
-				for (int i = 0; i < count; ++i)
-					repeat(outBuffer, blockSubString, blockSubString.getSize(), start + i, counterVar);
-			}
+						if (!parseArgs(pos, node.args, 10) || node.args.size() != 3 || node.args[0].hasCounter)
+						{
+							printf("Syntax Error at line %zu: @foreach expects three parameters", line);
+							return false;
+						}
 
-			subString.setStart(blockSubString.getEnd() + sizeof("@end"));
-			pos = subString.find("@foreach");
-		}
+						mCounters.push_back(&node.args[0].text);
+						bool blockClosed = compileBlock(pos, node.children, true);
+						mCounters.pop_back();
 
-		copy(outBuffer, subString, subString.getSize());
+						if (!blockClosed)
+							return false;
+						skipBlockEnd(pos, true);
+					}
+					else if (startsWith(at + 1, "property"))
+					{
+						addText(nodes, textStart, at);
+						pos = at + sizeof("@property");
 
-		return syntaxError;
-	}
-	//-----------------------------------------------------------------------------------
-	bool ShaderGenerator::parseProperties(String &inBuffer, String &outBuffer, PropertyMap &properties)
-	{
-		outBuffer.clear();
-		outBuffer.reserve(inBuffer.size());
+						nodes.push_back(Node(NODE_PROPERTY, line));
+						Node &node = nodes.back();
 
-		SubStringRef subString(&inBuffer, 0);
-		size_t pos = subString.find("@property");
+						if (!parseExpression(pos, node.expression) || !compileBlock(pos, node.children, true))
+							return false;
+						skipBlockEnd(pos, false);
+					}
+					else if (startsWith(at + 1, "piece"))
+					{
+						addText(nodes, textStart, at);
+						pos = at + sizeof("@piece");
 
-		bool syntaxError = false;
+						nodes.push_back(Node(NODE_PIECE, line));
+						Node &node = nodes.back();
 
-		while (pos != String::npos && !syntaxError)
-		{
-			//Copy what comes before the block
-			copy(outBuffer, subString, pos);
+						if (!parseArgs(pos, node.args, 10) || node.args.size() != 1)
+						{
+							printf("Syntax Error at line %zu: @piece expects one parameter", line);
+							return false;
+						}
 
-			subString.setStart(subString.getStart() + pos + sizeof("@property"));
-			bool result = evaluateExpression(subString, syntaxError, properties);
+						if (!compileBlock(pos, node.children, true))
+							return false;
+						skipBlockEnd(pos, true);
+					}
+					else if (startsWith(at + 1, "insertpiece"))
+					{
+						addText(nodes, textStart, at);
+						pos = at + sizeof("@insertpiece");
 
-			SubStringRef blockSubString = subString;
-			findBlockEnd(blockSubString, syntaxError);
+						nodes.push_back(Node(NODE_INSERT_PIECE, line));
 
-			if (result && !syntaxError)
-				copy(outBuffer, blockSubString, blockSubString.getSize());
+						if (!parseArgs(pos, nodes.back().args, 10) || nodes.back().args.size() != 1)
+						{
+							printf("Syntax Error at line %zu: @insertpiece expects one parameter", line);
+							return false;
+						}
+					}
+					else if ((keyword = findOperation(c_counterOperations, 8, at)) != ~(size_t)0)
+					{
+						addText(nodes, textStart, at);
+						pos = at + c_counterOperations[keyword].length;
 
-			subString.setStart(blockSubString.getEnd() + sizeof("@end") - 1);
-			pos = subString.find("@property");
-		}
+						nodes.push_back(Node(NODE_COUNTER_OP, line));
+						Node &node = nodes.back();
+						node.operation = keyword;
 
-		copy(outBuffer, subString, subString.getSize());
+						bool syntaxError = !parseArgs(pos, node.args, 0);
+						if (keyword <= 1)
+							syntaxError |= node.args.size() != 1;
+						else
+							syntaxError |= node.args.size() < 2 || node.args.size() > 3;
 
-		while (!syntaxError && outBuffer.find("@property") != String::npos)
-		{
-			inBuffer.swap(outBuffer);
-			syntaxError = parseProperties(inBuffer, outBuffer, properties);
-		}
+						if (syntaxError)
+						{
+							if (keyword <= 1)
+							{
+								printf("Syntax Error at line %zu: @%s expects one parameter",
+									line, c_counterOperations[keyword].opName);
+							}
+							else
+							{
+								printf("Syntax Error at line %zu: @%s expects two or three parameters",
+									line, c_counterOperations[keyword].opName);
+							}
+							return false;
+						}
+					}
+					else
+					{
+						// Not a keyword, kept as text
+						at = mText.find('@', at + 1);
+						continue;
+					}
 
-		return syntaxError;
-	}
-	//-----------------------------------------------------------------------------------
-	bool ShaderGenerator::collectPieces(const String &inBuffer, String &outBuffer, PropertyMap &properties, PiecesMap& pieces)
-	{
-		outBuffer.clear();
-		outBuffer.reserve(inBuffer.size());
+					textStart = pos;
+					at = mText.find('@', pos);
+				}
 
-		StringVector argValues;
-		SubStringRef subString(&inBuffer, 0);
-		size_t pos = subString.find("@piece");
+				addText(nodes, textStart, mText.size());
+				pos = mText.size();
 
-		bool syntaxError = false;
+				if (inBlock)
+				{
+					printf("Syntax Error at line %zu: start block (e.g. @foreach; @property) "
+						"without matching @end\n", lineAt(pos));
+					return false;
+				}
 
-		while (pos != String::npos && !syntaxError)
+				return true;
+			}
+		};
+		//-----------------------------------------------------------------------------------
+		class TemplateGenerator
 		{
-			//Copy what comes before the block
-			copy(outBuffer, subString, pos);
-
-			subString.setStart(subString.getStart() + pos + sizeof("@piece"));
-			evaluateParamArgs(subString, argValues, syntaxError);
+		public:
+			TemplateGenerator(PropertyMap &properties) : mProperties(properties) {}
 
-			syntaxError |= argValues.size() != 1;
-
-			if (!syntaxError)
+			void generateSource(const Source &source, Output &output)
 			{
-				const IdString pieceName(argValues[0]);
-				PiecesMap::const_iterator it = pieces.find(pieceName);
-				if (it != pieces.end())
-				{
-					syntaxError = true;
-					printf("Error at line %zu: @piece '%s' already defined",
-						calculateLineCount(subString), argValues[0].c_str());
-				}
-				else
-				{
-					SubStringRef blockSubString = subString;
-					findBlockEnd(blockSubString, syntaxError);
+				vector<MathOperation>::type::const_iterator itor = source.mathOperations.begin();
+				vector<MathOperation>::type::const_iterator end = source.mathOperations.end();
 
-					String tmpBuffer;
-					copy(tmpBuffer, blockSubString, blockSubString.getSize());
-					pieces[pieceName] = tmpBuffer;
+				for (; itor != end; ++itor)
+				{
+					IdString names[3];
+					for (size_t i = 0; i < itor->args.size(); ++i)
+						names[i] = itor->args[i].name;
 
-					subString.setStart(blockSubString.getEnd() + sizeof("@end"));
+					applyOperation(c_operations[itor->operation].opFunc, itor->args, names);
 				}
-			}
-			else
-			{
-				printf("Syntax Error at line %zu: @piece expects one parameter",
-					calculateLineCount(subString));
+
+				generateNodes(source, source.nodes, 0, output);
 			}
 
-			pos = subString.find("@piece");
-		}
+			/// Insert the pieces and run the counter ops, in the order they appear
+			void write(const Output &output, String &outBuffer, size_t depth)
+			{
+				size_t textPos = 0;
 
-		copy(outBuffer, subString, subString.getSize());
+				vector<Marker>::type::const_iterator itor = output.markers.begin();
+				vector<Marker>::type::const_iterator end = output.markers.end();
 
-		return syntaxError;
-	}
-	//-----------------------------------------------------------------------------------
-	bool ShaderGenerator::insertPieces(String &inBuffer, String &outBuffer, PropertyMap &properties, PiecesMap& pieces)
-	{
-		outBuffer.clear();
-		outBuffer.reserve(inBuffer.size());
+				for (; itor != end; ++itor)
+				{
+					outBuffer.append(output.text, textPos, itor->offset - textPos);
+					textPos = itor->offset;
 
-		StringVector argValues;
-		SubStringRef subString(&inBuffer, 0);
-		size_t pos = subString.find("@insertpiece");
+					const Node &node = *itor->node;
 
-		bool syntaxError = false;
+					if (node.type == NODE_INSERT_PIECE)
+					{
+						PiecesMap::const_iterator it = mPieces.find(itor->names[0]);
+						if (it == mPieces.end())
+							continue;
+
+						if (depth < c_maxPieceDepth)
+							write(it->second, outBuffer, depth + 1);
+						else
+							printf("Error at line %zu: @insertpiece nested too deep", node.line);
+					}
+					else if (node.operation <= 1)
+					{
+						//@value & @counter write, the others are invisible
+						int value = mProperties.getProperty(itor->names[0]);
+						outBuffer += StringConverter::toString(value);
 
-		while (pos != String::npos && !syntaxError)
-		{
-			//Copy what comes before the block
-			copy(outBuffer, subString, pos);
+						if (node.operation == 0)
+							mProperties.setProperty(itor->names[0], value + 1);
+					}
+					else
+					{
+						applyOperation(c_counterOperations[node.operation].opFunc, node.args, itor->names);
+					}
+				}
 
-			subString.setStart(subString.getStart() + pos + sizeof("@insertpiece"));
-			evaluateParamArgs(subString, argValues, syntaxError);
+				outBuffer.append(output.text, textPos, String::npos);
+			}
 
-			syntaxError |= argValues.size() != 1;
+		private:
+			PropertyMap &mProperties;
+			PiecesMap mPieces;
 
-			if (!syntaxError)
+			IdString resolveName(const String &text, IdString name, bool hasCounter,
+				const CounterScope *counters) const
 			{
-				const IdString pieceName(argValues[0]);
-				PiecesMap::const_iterator it = pieces.find(pieceName);
-				if (it != pieces.end())
-					outBuffer += it->second;
-			}
-			else
-			{
-				printf("Syntax Error at line %zu: @insertpiece expects one parameter",
-					calculateLineCount(subString));
-			}
+				if (!hasCounter)
+					return name;
 
-			pos = subString.find("@insertpiece");
-		}
+				String resolved;
+				resolved.reserve(text.size());
 
-		copy(outBuffer, subString, subString.getSize());
+				for (size_t i = 0; i < text.size(); ++i)
+				{
+					const CounterScope *scope = counters;
+					if (text[i] == '@')
+					{
+						while (scope && text.compare(i + 1, scope->name->size(), *scope->name) != 0)
+							scope = scope->parent;
+					}
 
-		while (!syntaxError && outBuffer.find("@insertpiece") != String::npos)
-		{
-			inBuffer.swap(outBuffer);
-			syntaxError = insertPieces(inBuffer, outBuffer, properties, pieces);
-		}
+					if (text[i] == '@' && scope)
+					{
+						resolved += StringConverter::toString(scope->value);
+						i += scope->name->size();
+					}
+					else
+					{
+						resolved.push_back(text[i]);
+					}
+				}
 
-		return syntaxError;
-	}
-	//-----------------------------------------------------------------------------------
-	const Operation c_counterOperations[8] =
-	{
-		Operation("counter", sizeof("@counter"), 0),
-		Operation("value", sizeof("@value"), 0),
-		Operation("set", sizeof("@set"), &setOp),
-		Operation("add", sizeof("@add"), &addOp),
-		Operation("sub", sizeof("@sub"), &subOp),
-		Operation("mul", sizeof("@mul"), &mulOp),
-		Operation("div", sizeof("@div"), &divOp),
-		Operation("mod", sizeof("@mod"), &modOp)
-	};
-	//-----------------------------------------------------------------------------------
-	bool ShaderGenerator::parseCounter(const String &inBuffer, String &outBuffer, PropertyMap &properties)
-	{
-		outBuffer.clear();
-		outBuffer.reserve(inBuffer.size());
+				return resolved;
+			}
 
-		StringVector argValues;
-		SubStringRef subString(&inBuffer, 0);
+			int argumentValue(const Argument &arg, const CounterScope *counters)
+			{
+				if (arg.isNumber)
+					return arg.number;
+				return mProperties.getProperty(resolveName(arg.text, arg.name, arg.hasCounter, counters), 0);
+			}
 
-		size_t pos;
-		pos = subString.find("@");
-		size_t keyword = ~0;
+			void applyOperation(int(*opFunc)(int, int), const ArgumentVec &args, const IdString *names)
+			{
+				IdString dstProperty = names[0];
+				IdString srcProperty = dstProperty;
+				size_t idx = 1;
+				if (args.size() == 3)
+					srcProperty = names[idx++];
 
-		if (pos != String::npos)
-		{
-			size_t maxSize = subString.findFirstOf(" \t(", pos + 1);
-			SubStringRef keywordStr(&inBuffer, subString.getStart() + pos + 1,
-				subString.getStart() + maxSize);
+				int op1Value = mProperties.getProperty(srcProperty);
+				int op2Value = args[idx].isNumber ? args[idx].number : mProperties.getProperty(names[idx]);
 
-			for (size_t i = 0; i < 8 && keyword == (size_t)~0; ++i)
-			{
-				if (keywordStr.matchEqual(c_counterOperations[i].opName))
-					keyword = i;
+				mProperties.setProperty(dstProperty, opFunc(op1Value, op2Value));
 			}
 
-			if (keyword == (size_t)~0)
-				pos = String::npos;
-		}
+			bool evaluateExpression(const ExpressionVec &expression, const CounterScope *counters)
+			{
+				bool retVal = true;
+				bool andMode = true;
 
-		bool syntaxError = false;
+				ExpressionVec::const_iterator itor = expression.begin();
+				ExpressionVec::const_iterator end = expression.end();
 
-		while (pos != String::npos && !syntaxError)
-		{
-			//Copy what comes before the block
-			copy(outBuffer, subString, pos);
+				for (; itor != end; ++itor)
+				{
+					if (itor->type == EXPR_OPERATOR_OR)
+						andMode = false;
+					else if (itor->type == EXPR_OPERATOR_AND)
+						andMode = true;
+					else
+					{
+						bool result;
+						if (itor->type == EXPR_VAR)
+						{
+							IdString name = resolveName(itor->value, itor->name, itor->hasCounter, counters);
+							result = mProperties.getProperty(name) != 0;
+						}
+						else
+						{
+							result = evaluateExpression(itor->children, counters);
+						}
 
-			subString.setStart(subString.getStart() + pos + c_counterOperations[keyword].length);
-			evaluateParamArgs(subString, argValues, syntaxError);
+						if (andMode)
+							retVal &= itor->negated ? !result : result;
+						else
+							retVal |= itor->negated ? !result : result;
+					}
+				}
 
-			if (keyword <= 1)
-				syntaxError |= argValues.size() != 1;
-			else
-				syntaxError |= argValues.size() < 2 || argValues.size() > 3;
+				return retVal;
+			}
 
-			if (!syntaxError)
+			void generateNodes(const Source &source, const NodeVec &nodes,
+				const CounterScope *counters, Output &output)
 			{
-				IdString dstProperty;
-				IdString srcProperty;
-				int op1Value;
-				int op2Value;
+				NodeVec::const_iterator itor = nodes.begin();
+				NodeVec::const_iterator end = nodes.end();
 
-				if (argValues.size() == 1)
+				for (; itor != end; ++itor)
 				{
-					dstProperty = argValues[0];
-					srcProperty = dstProperty;
-					op1Value = properties.getProperty(srcProperty);
-					op2Value = op1Value;
-
-					//@value & @counter write, the others are invisible
-					char tmp[16];
-					sprintf(tmp, "%i", op1Value);
-					outBuffer += tmp;
+					const Node &node = *itor;
 
-					if (keyword == 0)
+					switch (node.type)
 					{
-						++op1Value;
-						properties.setProperty(dstProperty, op1Value);
-					}
-				}
-				else
-				{
-					dstProperty = argValues[0];
-					size_t idx = 1;
-					srcProperty = dstProperty;
-					if (argValues.size() == 3)
-						srcProperty = argValues[idx++];
-					op1Value = properties.getProperty(srcProperty);
-					op2Value = StringConverter::parseInt(argValues[idx],
-						-std::numeric_limits<int>::max());
-
-					if (op2Value == -std::numeric_limits<int>::max())
+					case NODE_TEXT:
+						output.text.append(source.text, node.start, node.length);
+						break;
+					case NODE_COUNTER:
 					{
-						//Not a number, interpret as property
-						op2Value = properties.getProperty(argValues[idx]);
+						const CounterScope *scope = counters;
+						for (size_t i = 0; i < node.start; ++i)
+							scope = scope->parent;
+						output.text += StringConverter::toString(scope->value);
+						break;
 					}
+					case NODE_FOREACH:
+					{
+						int start = argumentValue(node.args[1], counters);
+						int count = argumentValue(node.args[2], counters);
 
-					int result = c_counterOperations[keyword].opFunc(op1Value, op2Value);
-					properties.setProperty(dstProperty, result);
-				}
-			}
-			else
-			{
-				size_t lineCount = calculateLineCount(subString);
-				if (keyword <= 1)
-				{
-					printf("Syntax Error at line %zu: @%s expects one parameter",
-						lineCount, c_counterOperations[keyword].opName);
-				}
-				else
-				{
-					printf("Syntax Error at line %zu: @%s expects two or three parameters",
-						lineCount, c_counterOperations[keyword].opName);
-				}
-			}
+						CounterScope scope;
+						scope.name = &node.args[0].text;
+						scope.parent = counters;
 
-			pos = subString.find("@");
-			keyword = ~0;
+						for (int i = 0; i < count; ++i)
+						{
+							scope.value = start + i;
+							generateNodes(source, node.children, &scope, output);
+						}
+						break;
+					}
+					case NODE_PROPERTY:
+						if (evaluateExpression(node.expression, counters))
+							generateNodes(source, node.children, counters, output);
+						break;
+					case NODE_PIECE:
+					{
+						const Argument &arg = node.args[0];
+						IdString pieceName = resolveName(arg.text, arg.name, arg.hasCounter, counters);
 
-			if (pos != String::npos)
-			{
-				size_t maxSize = subString.findFirstOf(" \t(", pos + 1);
-				SubStringRef keywordStr(&inBuffer, subString.getStart() + pos + 1,
-					subString.getStart() + maxSize);
+						if (mPieces.find(pieceName) != mPieces.end())
+						{
+							printf("Error at line %zu: @piece '%s' already defined",
+								node.line, arg.text.c_str());
+						}
+						else
+						{
+							generateNodes(source, node.children, counters, mPieces[pieceName]);
+						}
+						break;
+					}
+					case NODE_INSERT_PIECE:
+					case NODE_COUNTER_OP:
+					{
+						output.markers.push_back(Marker());
+						Marker &marker = output.markers.back();
+						marker.offset = output.text.size();
+						marker.node = &node;
 
-				for (size_t i = 0; i < 8 && keyword == (size_t)~0; ++i)
-				{
-					if (keywordStr.matchEqual(c_counterOperations[i].opName))
-						keyword = i;
+						for (size_t i = 0; i < node.args.size(); ++i)
+						{
+							const Argument &arg = node.args[i];
+							marker.names[i] = resolveName(arg.text, arg.name, arg.hasCounter, counters);
+						}
+						break;
+					}
+					}
 				}
-
-				if (keyword == (size_t)~0)
-					pos = String::npos;
 			}
-		}
-
-		copy(outBuffer, subString, subString.getSize());
-
-		return syntaxError;
+		};
 	}
 	//-----------------------------------------------------------------------------------
-	String ShaderGenerator::parse(String &inBuffer, PropertyMap &properties, const StringVector& pieceFiles)
+	ShaderGenerator::CompiledTemplate* ShaderGenerator::compile(const String& templateSource,
+		const StringVector& pieceFiles)
 	{
-		String outBuffer;
-		outBuffer.reserve(inBuffer.size());
-
-		PiecesMap pieces;
+		CompiledTemplate *compiledTemplate = OGRE_NEW CompiledTemplate();
+		compiledTemplate->sources.resize(pieceFiles.size() + 1);
 
-		if (!pieceFiles.empty())
+		for (size_t i = 0; i <= pieceFiles.size(); ++i)
 		{
-			//Collect pieces
-			StringVector::const_iterator itor = pieceFiles.begin();
-			StringVector::const_iterator end = pieceFiles.end();
+			Source &source = compiledTemplate->sources[i];
+			source.text = i < pieceFiles.size() ? pieceFiles[i] : templateSource;
 
-			String inPiece;
-			String outPiece;
-
-			while (itor != end)
-			{
-				parseMath(*itor, inPiece, properties);
-				parseForEach(inPiece, outPiece, properties);
-				parseProperties(outPiece, inPiece, properties);
-				collectPieces(inPiece, outPiece, properties, pieces);
-				++itor;
-			}
+			TemplateCompiler compiler(source);
+			compiler.compile();
 		}
 
-		parseMath(inBuffer, outBuffer, properties);
-		parseForEach(outBuffer, inBuffer, properties);
-		parseProperties(inBuffer, outBuffer, properties);
-		collectPieces(outBuffer, inBuffer, properties, pieces);
-		insertPieces(inBuffer, outBuffer, properties, pieces);
-		parseCounter(outBuffer, inBuffer, properties);
-
-		outBuffer.swap(inBuffer);
-
-		return outBuffer;
+		return compiledTemplate;
 	}
 	//-----------------------------------------------------------------------------------
-	size_t ShaderGenerator::calculateLineCount(const String &buffer, size_t idx)
+	void ShaderGenerator::destroy(CompiledTemplate* compiledTemplate)
 	{
-		String::const_iterator itor = buffer.begin();
-		String::const_iterator end = buffer.begin() + idx;
-
-		size_t lineCount = 0;
+		OGRE_DELETE compiledTemplate;
+	}
+	//-----------------------------------------------------------------------------------
+	String ShaderGenerator::generate(const CompiledTemplate& compiledTemplate, PropertyMap &properties)
+	{
+		TemplateGenerator generator(properties);
 
-		while (itor != end)
+		// The piece files only contribute their pieces, the rest of their text is dropped
+		const size_t numPieceFiles = compiledTemplate.sources.size() - 1;
+		for (size_t i = 0; i < numPieceFiles; ++i)
 		{
-			if (*itor == '\n')
-				++lineCount;
-			++itor;
+			Output pieceFileOutput;
+			generator.generateSource(compiledTemplate.sources[i], pieceFileOutput);
 		}
 
-		return lineCount + 1;
+		Output output;
+		generator.generateSource(compiledTemplate.sources.back(), output);
+
+		String outBuffer;
+		outBuffer.reserve(output.text.size());
+		generator.write(output, outBuffer, 0);
+
+		return outBuffer;
 	}
 	//-----------------------------------------------------------------------------------
-	size_t ShaderGenerator::calculateLineCount(const SubStringRef &subString)
+	String ShaderGenerator::parse(String &inBuffer, PropertyMap &properties, const StringVector& pieceFiles)
 	{
-		return calculateLineCount(subString.getOriginalBuffer(), subString.getStart());
+		CompiledTemplate *compiledTemplate = compile(inBuffer, pieceFiles);
+		String outBuffer = generate(*compiledTemplate, properties);
+		destroy(compiledTemplate);
+
+		return outBuffer;
 	}
 	//-----------------------------------------------------------------------------------
 }
@@ -53,6 +53,12 @@ namespace Ogre
 			gpuPrg.reset();
 		}
 		mShaderCache.clear();
+
+		CompiledTemplateMap::iterator templateIt = mCompiledTemplates.begin();
+		CompiledTemplateMap::iterator templateEndIt = mCompiledTemplates.end();
+		for (; templateIt != templateEndIt; ++templateIt)
+			ShaderGenerator::destroy(templateIt->second);
+		mCompiledTemplates.clear();
 	}
 	//-----------------------------------------------------------------------------------
 	GpuProgramPtr ShaderManager::getGpuProgram(HlmsDatablock* dataBlock)
@@ -72,10 +78,20 @@ namespace Ogre
 
 		String name = hashString + typeStr;
 
+		// the template and its pieces are parsed once and shared by all permutations
+		ShaderTemplate* shaderTemplate = dataBlock->getTemplate();
+		String templateKey = StringConverter::toString(shaderTemplate->getHash()) + "_" +
+			dataBlock->getLanguage() + typeStr;
+
+		ShaderGenerator::CompiledTemplate*& compiledTemplate = mCompiledTemplates[templateKey];
+		if (!compiledTemplate)
+		{
+			const StringVector& pieces = mShaderPiecesManager.getPieces(dataBlock->getLanguage(), dataBlock->getShaderType());
+			compiledTemplate = ShaderGenerator::compile(shaderTemplate->getTemplate(), pieces);
+		}
+
 		// generate the shader code
-		String code = dataBlock->getTemplate()->getTemplate();
-		const StringVector& pieces = mShaderPiecesManager.getPieces(dataBlock->getLanguage(), dataBlock->getShaderType());
-		code = ShaderGenerator::parse(code, *(dataBlock->getPropertyMap()), pieces);
+		String code = ShaderGenerator::generate(*compiledTemplate, *(dataBlock->getPropertyMap()));
 
 		GpuProgramPtr gpuProgram = createGpuProgram(name, code, dataBlock);
 
@@ -46,7 +46,7 @@ public:
     virtual ~LodCollapseCost() {}
     /// This is called after the LodInputProvider has initialized LodData.
     virtual void initCollapseCosts(LodData* data);
-    /// Called from initCollapseCosts for every edge.
+    /// Computes the collapse cost of a single vertex and adds it to the heap.
     virtual void initVertexCollapseCost(LodData* data, LodData::Vertex* vertex);
     /// Called when edge cost gets invalid.
     virtual void updateVertexCollapseCost(LodData* data, LodData::Vertex* vertex);
@@ -55,6 +55,9 @@ public:
     /// Returns the collapse cost of the given edge. 
     virtual Real computeEdgeCollapseCost(LodData* data, LodData::Vertex* src, LodData::Edge* dstEdge) = 0;
 protected:
+    /// Computes the initial cost of a range of vertices, used by initCollapseCosts on several threads.
+    struct VertexCostComputer;
+
     // Helper functions:
     bool isBorderVertex(const LodData::Vertex* vertex) const;
 };
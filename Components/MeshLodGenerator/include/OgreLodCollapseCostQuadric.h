@@ -48,11 +48,35 @@ public:
     virtual Real computeEdgeCollapseCost(LodData* data, LodData::Vertex* src, LodData::Edge* dstEdge);
 protected:
 
-    struct TriangleQuadricPlane {
-        Matrix4 quadric;
+    /// Symmetric 4x4 quadric, only the upper triangle is stored.
+    struct Quadric {
+        /// q00, q01, q02, q03, q11, q12, q13, q22, q23, q33
+        Real q[10];
+
+        void setZero() {
+            for (int i = 0; i < 10; i++) {
+                q[i] = 0;
+            }
+        }
+        Quadric& operator+=(const Quadric& rhs) {
+            for (int i = 0; i < 10; i++) {
+                q[i] += rhs.q[i];
+            }
+            return *this;
+        }
+        /// Returns v^T * Q * v with v = (p, 1)
+        Real evaluate(const Vector3& p) const {
+            return p.x * (q[0] * p.x + 2 * (q[1] * p.y + q[2] * p.z + q[3])) +
+                p.y * (q[4] * p.y + 2 * (q[5] * p.z + q[6])) +
+                p.z * (q[7] * p.z + 2 * q[8]) +
+                q[9];
+        }
     };
-    vector<Matrix4>::type mTrianglePlaneQuadricList;
-    vector<Matrix4>::type mVertexQuadricList;
+    /// Computes the quadrics of a range of triangles or vertices on several threads.
+    struct QuadricComputer;
+
+    vector<Quadric>::type mTrianglePlaneQuadricList;
+    vector<Quadric>::type mVertexQuadricList;
     void computeTrianglePlaneQuadric(LodData* data, size_t triangleID);
     void computeVertexQuadric(LodData* data, size_t vertexID);
 };
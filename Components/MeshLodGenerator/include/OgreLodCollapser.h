@@ -45,6 +45,7 @@ namespace Ogre
 class _OgreLodExport LodCollapser
 {
 public:
+    LodCollapser() : mLastReducedVertex(NULL), mMaxCollapseDistance(0) {}
     virtual ~LodCollapser() {}
     /// Reduces vertices until vertexCountLimit or collapseCostLimit is reached.
     virtual void collapse(LodData* data, LodCollapseCost* cost, LodOutputProvider* output, int vertexCountLimit, Real collapseCostLimit);
@@ -70,6 +71,14 @@ public:
      * @return Whether the outVec was changed. If the mesh is reduced at least 1 vertex, then it returns true.
      */
     bool _getLastVertexCollapseTo(LodData* data, Vector3& outVec);
+
+    /**
+     * @brief Returns the length of the longest edge collapsed since the last reset.
+     *
+     * This is how far a vertex moved at most, so it bounds the geometric error of the reduced mesh.
+     */
+    Real _getMaxCollapseDistance() const { return mMaxCollapseDistance; }
+    void _resetMaxCollapseDistance() { mMaxCollapseDistance = 0; }
 protected:
     struct CollapsedEdge {
         unsigned int srcID;
@@ -85,6 +94,9 @@ protected:
     /// Last reduced vertex. Can be used for debugging purposes. For example the Mesh Lod Editor uses it to select edge.
     LodData::Vertex* mLastReducedVertex;
 
+    /// Length of the longest edge collapsed since the last reset.
+    Real mMaxCollapseDistance;
+
     /// Collapses a single vertex.
     void collapseVertex(LodData* data, LodCollapseCost* cost, LodOutputProvider* output, LodData::Vertex* src);
     void assertOutdatedCollapseCost(LodData* data, LodCollapseCost* cost, LodData::Vertex* vertex);
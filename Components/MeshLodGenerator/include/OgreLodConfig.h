@@ -123,6 +123,13 @@ struct _OgreLodExport LodLevel {
      * @brief Whether the Lod level generation was skipped, because it has same vertex count as the previous Lod level.
      */
     bool outSkipped;
+
+    /**
+     * @brief The length of the longest edge collapsed up to this Lod level.
+     *
+     * With ScreenSpaceErrorLodStrategy this is used as the distance of the generated Lod levels.
+     */
+    Real outGeometricError;
 };
 
 struct _OgreLodExport LodConfig {
@@ -163,6 +170,10 @@ struct _OgreLodExport LodConfig {
         Ogre::Real outsideWalkAngle;
         /// If the algorithm makes errors, you can fix it, by adding the edge to the profile.
         LodProfile profile;
+        /// Store where every vertex collapses at each generated Lod level in SubMesh::mLodMorphTargets,
+        /// which lets entities morph smoothly into the next Lod level (see Entity::setLodMorphRange).
+        /// Costs one float3 vertex buffer per Lod level. (disabled by default)
+        bool useMorphTargets;
         Advanced();
     } advanced;
 };
@@ -64,7 +64,7 @@ struct _OgreLodExport LodData {
     typedef vector<Vertex>::type VertexList;
     typedef vector<Triangle>::type TriangleList;
     typedef OGRE_HashSet<Vertex*, VertexHash, VertexEqual> UniqueVertexSet;
-    typedef multimap<Real, Vertex*>::type CollapseCostHeap;
+    class CollapseCostHeap;
 
     typedef VectorSet<Edge, 8> VEdges;
     typedef VectorSet<Triangle*, 7> VTriangles;
@@ -104,7 +104,7 @@ struct _OgreLodExport LodData {
         Vector3 normal;
         Vertex* collapseTo;
         bool seam;
-        CollapseCostHeap::iterator costHeapPosition; /// Iterator pointing to the position in the mCollapseCostSet, which allows fast remove.
+        size_t costHeapPosition; /// Index of the vertex in mCollapseCostHeap, which allows fast remove.
 
         void addEdge(const Edge& edge);
         void removeEdge(const Edge& edge);
@@ -123,6 +123,65 @@ struct _OgreLodExport LodData {
         bool isMalformed();
     };
 
+    /** Vertices ordered by their collapse cost, the cheapest one first.
+    @remarks
+        A binary heap in one contiguous array, each vertex stores its index in
+        costHeapPosition. Vertices with the same cost come out in the order they
+        were inserted or last updated.
+    */
+    class _OgreLodExport CollapseCostHeap {
+    public:
+        /// costHeapPosition of vertices which aren't in the heap.
+        static const size_t NOT_IN_HEAP;
+
+        CollapseCostHeap() : mInsertCount(0) {}
+
+        void clear();
+        size_t size() const { return mEntries.size(); }
+        bool empty() const { return mEntries.empty(); }
+
+        /// Get the vertex with the lowest cost, the heap must not be empty.
+        Vertex* top() const { return mEntries.front().vertex; }
+        /// Get the lowest cost, the heap must not be empty.
+        Real topCost() const { return mEntries.front().cost; }
+        /// Get the vertex at an arbitrary position, for iterating all vertices.
+        Vertex* at(size_t i) const { return mEntries[i].vertex; }
+
+        /// Get whether the vertex is in the heap.
+        bool contains(const Vertex* v) const { return v->costHeapPosition < mEntries.size() && mEntries[v->costHeapPosition].vertex == v; }
+        /// Get the cost of a vertex in the heap.
+        Real getCost(const Vertex* v) const { return mEntries[v->costHeapPosition].cost; }
+
+        /// Add a vertex which isn't in the heap yet.
+        void insert(Vertex* v, Real cost);
+        /// Change the cost of a vertex in the heap, like removing and inserting it again.
+        void update(Vertex* v, Real cost);
+        /// Remove a vertex from the heap.
+        void erase(Vertex* v);
+
+    protected:
+        struct Entry {
+            Real cost;
+            size_t order;
+            Vertex* vertex;
+
+            bool operator< (const Entry& other) const {
+                return cost < other.cost || (cost == other.cost && order < other.order);
+            }
+        };
+        typedef vector<Entry>::type EntryList;
+        EntryList mEntries;
+        /// Counter giving the insertion order.
+        size_t mInsertCount;
+
+        void place(size_t i, const Entry& entry) {
+            mEntries[i] = entry;
+            entry.vertex->costHeapPosition = i;
+        }
+        void siftUp(size_t i);
+        void siftDown(size_t i);
+    };
+
     union IndexBufferPointer {
         unsigned short* pshort;
         unsigned int* pint;
@@ -158,6 +217,18 @@ struct _OgreLodExport LodData {
     Real mMeshBoundingSphereRadius;
     bool mUseVertexNormals;
 
+    typedef vector<Vertex*>::type VertexLookupList;
+    typedef vector<float>::type MorphTarget;
+    typedef vector<MorphTarget>::type MorphTargetList;
+    /// Whether the morph targets of the Lod levels are baked.
+    bool mUseMorphTargets;
+    /// Vertex buffer index to vertex lookup, used to bake the morph targets.
+    /// The first one is for the shared vertices, then one per submesh.
+    vector<VertexLookupList>::type mMorphVertexLookups;
+    /// Collapse destinations of the vertices, 3 floats per vertex laid out like mMorphVertexLookups,
+    /// for each baked Lod level. Manual Lod levels have no morph targets.
+    vector<MorphTargetList>::type mMorphTargets;
+
     template<typename T, typename A>
     static size_t getVectorIDFromPointer(const std::vector<T, A>& vec, const T* pointer) {
         size_t id = pointer - &vec.at(0);
@@ -169,7 +240,8 @@ struct _OgreLodExport LodData {
         mUniqueVertexSet((UniqueVertexSet::size_type) 0,
         (const UniqueVertexSet::hasher&) VertexHash(this)),
         mMeshBoundingSphereRadius(0.0f),
-        mUseVertexNormals(true)
+        mUseVertexNormals(true),
+        mUseMorphTargets(false)
     {}
 };
 /** @} */
@@ -86,6 +86,8 @@ public:
     void getAutoconfig(MeshPtr& inMesh, LodConfig& outLodConfig);
 
     static void _configureMeshLodUsage(const LodConfig& lodConfig);
+    /// Creates the morph target buffers of the mesh from the baked morph targets, if any.
+    static void _injectMorphTargets(const LodConfig& lodConfig, LodData* data);
     void _resolveComponents(LodConfig& lodConfig, LodCollapseCostPtr& cost, LodDataPtr& data, LodInputProviderPtr& input, LodOutputProviderPtr& output, LodCollapserPtr& collapser);
     void _process(LodConfig& lodConfig, LodCollapseCost* cost, LodData* data, LodInputProvider* input, LodOutputProvider* output, LodCollapser* collapser);
 
@@ -97,6 +99,8 @@ public:
 protected:
     void computeLods(LodConfig& lodConfig, LodData* data, LodCollapseCost* cost, LodOutputProvider* output, LodCollapser* collapser);
     void calcLodVertexCount(const LodLevel& lodLevel, size_t uniqueVertexCount, size_t& outVertexCountLimit, Real& outCollapseCostLimit);
+    void initMorphTargets(LodData* data);
+    void bakeMorphTargets(LodData* data, bool manualLevel);
 
     LodWorkQueueWorker* mWQWorker;
     LodWorkQueueInjector* mWQInjector;
@@ -29,17 +29,45 @@
 #include "OgreLodCollapseCost.h"
 
 #include "OgreLogManager.h"
+#include "Threading/OgreParallel.h"
 
 namespace Ogre
 {
+    struct LodCollapseCost::VertexCostComputer
+    {
+        LodCollapseCost* cost;
+        LodData* data;
+        Real* collapseCosts;
+
+        void operator()(size_t i) const
+        {
+            // Each call only writes to the edges of its own vertex.
+            LodData::Vertex* vertex = &data->mVertexList[i];
+            collapseCosts[i] = LodData::UNINITIALIZED_COLLAPSE_COST;
+            vertex->collapseTo = NULL;
+            if (!vertex->edges.empty()) {
+                cost->computeVertexCollapseCost(data, vertex, collapseCosts[i], vertex->collapseTo);
+            }
+        }
+    };
+
     void LodCollapseCost::initCollapseCosts( LodData* data )
     {
         data->mCollapseCostHeap.clear();
+
+        // The costs only depend on the mesh, so they are computed in parallel,
+        // while the heap is filled on this thread afterwards.
+        vector<Real>::type collapseCosts(data->mVertexList.size());
+        if (!collapseCosts.empty()) {
+            VertexCostComputer computer = { this, data, &collapseCosts[0] };
+            parallelFor(0, collapseCosts.size(), computer, 256);
+        }
+
         LodData::VertexList::iterator it = data->mVertexList.begin();
         LodData::VertexList::iterator itEnd = data->mVertexList.end();
-        for (; it != itEnd; it++) {
+        for (size_t i = 0; it != itEnd; it++, i++) {
             if (!it->edges.empty()) {
-                initVertexCollapseCost(data, &*it);
+                data->mCollapseCostHeap.insert(&*it, collapseCosts[i]);
             } else {
 #if OGRE_DEBUG_MODE
                 LogManager::getSingleton().stream() << "In " << data->mMeshName << " never used vertex found with ID: " << data->mCollapseCostHeap.size() << ". "
@@ -73,7 +101,7 @@ namespace Ogre
         computeVertexCollapseCost(data, vertex, collapseCost, collapseTo);
 
         vertex->collapseTo = collapseTo;
-        vertex->costHeapPosition = data->mCollapseCostHeap.insert(LodData::CollapseCostHeap::value_type(collapseCost, vertex));
+        data->mCollapseCostHeap.insert(vertex, collapseCost);
     }
 
     void LodCollapseCost::updateVertexCollapseCost( LodData* data, LodData::Vertex* vertex )
@@ -82,16 +110,15 @@ namespace Ogre
         LodData::Vertex* collapseTo = NULL;
         computeVertexCollapseCost(data, vertex, collapseCost, collapseTo);
 
-        if (vertex->collapseTo != collapseTo || collapseCost != vertex->costHeapPosition->first) {
-            OgreAssert(vertex->costHeapPosition != data->mCollapseCostHeap.end(), "");
-            data->mCollapseCostHeap.erase(vertex->costHeapPosition);
+        if (vertex->collapseTo != collapseTo || collapseCost != data->mCollapseCostHeap.getCost(vertex)) {
+            OgreAssert(data->mCollapseCostHeap.contains(vertex), "");
             if (collapseCost != LodData::UNINITIALIZED_COLLAPSE_COST) {
                 vertex->collapseTo = collapseTo;
-                vertex->costHeapPosition = data->mCollapseCostHeap.insert(LodData::CollapseCostHeap::value_type(collapseCost, vertex));
+                data->mCollapseCostHeap.update(vertex, collapseCost);
             } else {
+                data->mCollapseCostHeap.erase(vertex);
 #if OGRE_DEBUG_MODE
                 vertex->collapseTo = NULL;
-                vertex->costHeapPosition = data->mCollapseCostHeap.end();
 #endif
             }
         }
@@ -34,36 +34,53 @@
 
 #include "OgreLodCollapseCostQuadric.h"
 #include "OgreVector3.h"
+#include "Threading/OgreParallel.h"
 
 namespace Ogre
 {
 
+    struct LodCollapseCostQuadric::QuadricComputer
+    {
+        LodCollapseCostQuadric* cost;
+        LodData* data;
+        bool vertices;
+
+        void operator()(size_t i) const
+        {
+            if (vertices) {
+                cost->computeVertexQuadric(data, i);
+            } else {
+                cost->computeTrianglePlaneQuadric(data, i);
+            }
+        }
+    };
+
     void LodCollapseCostQuadric::initCollapseCosts( LodData* data )
     {
+        // Every quadric is written by one call only, the vertex quadrics just read the triangle ones.
         mTrianglePlaneQuadricList.resize(data->mTriangleList.size());
-        for(size_t i=0;i<mTrianglePlaneQuadricList.size();i++){
-            computeTrianglePlaneQuadric(data, i);
-        }
+        QuadricComputer triangleComputer = { this, data, false };
+        parallelFor(0, mTrianglePlaneQuadricList.size(), triangleComputer, 1024);
         mVertexQuadricList.resize(data->mVertexList.size());
-        for (size_t i=0;i<mVertexQuadricList.size();i++) {
-            computeVertexQuadric(data, i);
-        }
+        QuadricComputer vertexComputer = { this, data, true };
+        parallelFor(0, mVertexQuadricList.size(), vertexComputer, 512);
         LodCollapseCost::initCollapseCosts(data);
     }
 
     void LodCollapseCostQuadric::computeTrianglePlaneQuadric( LodData* data, size_t triangleID )
     {
         LodData::Triangle& triangle = data->mTriangleList[triangleID];
-        Matrix4& quadric = mTrianglePlaneQuadricList[triangleID];
+        Real* q = mTrianglePlaneQuadricList[triangleID].q;
         Real plane[4];
         plane[0] = triangle.normal.x;
         plane[1] = triangle.normal.y;
         plane[2] = triangle.normal.z;
         Vector3& v0 = triangle.vertex[0]->position;
         plane[3] = -v0.dotProduct(triangle.normal);
+        int k = 0;
         for(int i=0;i<4;i++){
-            for(int n=0;n<4;n++){
-                quadric[i][n] = plane[i] * plane[n];
+            for(int n=i;n<4;n++){
+                q[k++] = plane[i] * plane[n];
             }
         }
     }
@@ -79,17 +96,11 @@ namespace Ogre
             return LodData::NEVER_COLLAPSE_COST;
         }
 
-        Matrix4 Qnew = mVertexQuadricList[LodData::getVectorIDFromPointer(data->mVertexList, src)] +
-            mVertexQuadricList[LodData::getVectorIDFromPointer(data->mVertexList, dst)];
-
-        Vector4 Vnew(dst->position);
+        Quadric Qnew = mVertexQuadricList[LodData::getVectorIDFromPointer(data->mVertexList, src)];
+        Qnew += mVertexQuadricList[LodData::getVectorIDFromPointer(data->mVertexList, dst)];
 
         // error = Vnew^T * Qnew * Vnew
-        Real cost =
-            (Vnew[0] * Qnew[0][0] + Vnew[1] * Qnew[0][1] + Vnew[2] * Qnew[0][2] + Vnew[3] * Qnew[0][3]) * Vnew[0] +
-            (Vnew[0] * Qnew[1][0] + Vnew[1] * Qnew[1][1] + Vnew[2] * Qnew[1][2] + Vnew[3] * Qnew[1][3]) * Vnew[1] +
-            (Vnew[0] * Qnew[2][0] + Vnew[1] * Qnew[2][1] + Vnew[2] * Qnew[2][2] + Vnew[3] * Qnew[2][3]) * Vnew[2] +
-            (Vnew[0] * Qnew[3][0] + Vnew[1] * Qnew[3][1] + Vnew[2] * Qnew[3][2] + Vnew[3] * Qnew[3][3]) * Vnew[3];
+        Real cost = Qnew.evaluate(dst->position);
 
         if (dst->seam) {
             cost *= 8;
@@ -101,15 +112,15 @@ namespace Ogre
 
     void LodCollapseCostQuadric::computeVertexQuadric( LodData* data, size_t vertexID )
     {
-        Matrix4& quadric = mVertexQuadricList[vertexID];
-        quadric = Matrix4::ZERO;
+        Quadric& quadric = mVertexQuadricList[vertexID];
+        quadric.setZero();
         LodData::Vertex& vertex = data->mVertexList[vertexID];
         LodData::VTriangles::iterator tri, triEnd;
         tri = vertex.triangles.begin();
         triEnd = vertex.triangles.end();
         for (;tri != triEnd; ++tri) {
             size_t id = LodData::getVectorIDFromPointer(data->mTriangleList, *tri);
-            quadric = quadric + mTrianglePlaneQuadricList[id];
+            quadric += mTrianglePlaneQuadricList[id];
         }
     }
 
@@ -36,7 +36,8 @@ LodConfig::Advanced::Advanced() :
             useCompression(true),
             useVertexNormals(true),
             outsideWeight(0.0),
-            outsideWalkAngle(0.0)
+            outsideWalkAngle(0.0),
+            useMorphTargets(false)
 {
 }
 
@@ -32,6 +32,82 @@ namespace Ogre
 // Use float limits instead of Real limits, because LodConfigSerializer may convert them to float.
 const Real LodData::NEVER_COLLAPSE_COST = std::numeric_limits<float>::max();
 const Real LodData::UNINITIALIZED_COLLAPSE_COST = std::numeric_limits<float>::infinity();
+const size_t LodData::CollapseCostHeap::NOT_IN_HEAP = ~(size_t)0;
+
+void LodData::CollapseCostHeap::clear()
+{
+    // The vertices might not exist anymore, so their positions aren't reset.
+    mEntries.clear();
+    mInsertCount = 0;
+}
+
+void LodData::CollapseCostHeap::insert( LodData::Vertex* v, Real cost )
+{
+    Entry entry = { cost, mInsertCount++, v };
+    mEntries.push_back(entry);
+    v->costHeapPosition = mEntries.size() - 1;
+    siftUp(mEntries.size() - 1);
+}
+
+void LodData::CollapseCostHeap::update( LodData::Vertex* v, Real cost )
+{
+    OgreAssertDbg(contains(v), "");
+    size_t i = v->costHeapPosition;
+    mEntries[i].cost = cost;
+    mEntries[i].order = mInsertCount++;
+    // The entry can only get later in the order, so it moves up only for a lower cost.
+    siftUp(i);
+    siftDown(v->costHeapPosition);
+}
+
+void LodData::CollapseCostHeap::erase( LodData::Vertex* v )
+{
+    OgreAssertDbg(contains(v), "");
+    size_t i = v->costHeapPosition;
+    v->costHeapPosition = NOT_IN_HEAP;
+    Entry last = mEntries.back();
+    mEntries.pop_back();
+    if (i < mEntries.size()) {
+        place(i, last);
+        siftUp(i);
+        siftDown(last.vertex->costHeapPosition);
+    }
+}
+
+void LodData::CollapseCostHeap::siftUp( size_t i )
+{
+    Entry entry = mEntries[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!(entry < mEntries[parent])) {
+            break;
+        }
+        place(i, mEntries[parent]);
+        i = parent;
+    }
+    place(i, entry);
+}
+
+void LodData::CollapseCostHeap::siftDown( size_t i )
+{
+    Entry entry = mEntries[i];
+    size_t count = mEntries.size();
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && mEntries[child + 1] < mEntries[child]) {
+            child++;
+        }
+        if (!(mEntries[child] < entry)) {
+            break;
+        }
+        place(i, mEntries[child]);
+        i = child;
+    }
+    place(i, entry);
+}
 
 void LodData::Vertex::addEdge( const LodData::Edge& edge )
 {
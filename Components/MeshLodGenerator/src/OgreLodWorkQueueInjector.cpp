@@ -76,6 +76,7 @@ namespace Ogre
         }
 
         request->output->inject();
+        MeshLodGenerator::_injectMorphTargets(request->config, request->data.get());
         MeshLodGenerator::_configureMeshLodUsage(request->config);
         //lodConfig.mesh->buildEdgeList();
 
@@ -28,6 +28,7 @@
 
 #include "OgreMeshLodGenerator.h"
 #include "OgrePixelCountLodStrategy.h"
+#include "OgreScreenSpaceErrorLodStrategy.h"
 #include "OgreLodWorkQueueWorker.h"
 #include "OgreLodWorkQueueInjector.h"
 #include "OgreLodInputProvider.h"
@@ -44,6 +45,8 @@
 #include "OgreLodCollapseCostOutside.h"
 #include "OgreLodData.h"
 #include "OgreLodCollapser.h"
+#include "OgreSubMesh.h"
+#include "OgreHardwareBufferManager.h"
 
 
 namespace Ogre
@@ -105,6 +108,7 @@ void MeshLodGenerator::_configureMeshLodUsage(const LodConfig& lodConfig)
     lodConfig.mesh->setLodStrategy(lodConfig.strategy);
     MeshLodUsage usage;
     ushort n = 0;
+    bool useGeometricError = lodConfig.strategy == ScreenSpaceErrorLodStrategy::getSingletonPtr();
     lodConfig.mesh->_setLodInfo(ushort(lodConfig.levels.size()) + 1); // add Lod levels
     for(size_t i = 0; i < lodConfig.levels.size(); i++) {
         // Record usages. First Lod usage is the mesh itself.
@@ -113,6 +117,9 @@ void MeshLodGenerator::_configureMeshLodUsage(const LodConfig& lodConfig)
         if(!lodConfig.levels[i].outSkipped) {
 
             usage.userValue = lodConfig.levels[i].distance;
+            // The screen space error strategy needs the error of the level instead of a distance.
+            if(useGeometricError && lodConfig.levels[i].manualMeshName.empty())
+                usage.userValue = lodConfig.levels[i].outGeometricError;
             usage.value = lodConfig.mesh->getLodStrategy()->transformUserValue(usage.userValue);
             usage.edgeData = NULL;
             usage.manualMesh.reset();
@@ -196,6 +203,10 @@ void MeshLodGenerator::_process(LodConfig& lodConfig,
 {
     input->initData(data);
     data->mUseVertexNormals = data->mUseVertexNormals && lodConfig.advanced.useVertexNormals;
+    data->mUseMorphTargets = lodConfig.advanced.useMorphTargets;
+    if(data->mUseMorphTargets) {
+        initMorphTargets(data);
+    }
     cost->initCollapseCosts(data);
     output->prepare(data);
     computeLods(lodConfig, data, cost, output, collapser);
@@ -203,6 +214,7 @@ void MeshLodGenerator::_process(LodConfig& lodConfig,
     if(!lodConfig.advanced.useBackgroundQueue) {
         // This will be processed in LodWorkQueueInjector if we use background queue.
         output->inject();
+        _injectMorphTargets(lodConfig, data);
         _configureMeshLodUsage(lodConfig);
         //lodConfig.mesh->buildEdgeList();
     }
@@ -243,15 +255,20 @@ void MeshLodGenerator::computeLods(LodConfig& lodConfig,
 {
     int lodID = 0;
     size_t lastBakeVertexCount = data->mVertexList.size();
+    collapser->_resetMaxCollapseDistance();
     for(unsigned short curLod = 0; curLod < lodConfig.levels.size(); curLod++) {
         if(!lodConfig.levels[curLod].manualMeshName.empty()) {
             // Manual Lod level
             lodConfig.levels[curLod].outSkipped =
                 (curLod != 0 && lodConfig.levels[curLod].manualMeshName == lodConfig.levels[curLod - 1].manualMeshName);
             lodConfig.levels[curLod].outUniqueVertexCount = 0;
+            lodConfig.levels[curLod].outGeometricError = 0;
             lastBakeVertexCount = -1;
             if(!lodConfig.levels[curLod].outSkipped) {
                 output->bakeManualLodLevel(data, lodConfig.levels[curLod].manualMeshName, lodID++);
+                if(data->mUseMorphTargets) {
+                    bakeMorphTargets(data, true);
+                }
             }
         } else {
             size_t vertexCountLimit;
@@ -260,10 +277,117 @@ void MeshLodGenerator::computeLods(LodConfig& lodConfig,
             collapser->collapse(data, cost, output, static_cast<int>(vertexCountLimit), collapseCostLimit);
             size_t vertexCount = data->mCollapseCostHeap.size();
             lodConfig.levels[curLod].outUniqueVertexCount = vertexCount;
+            lodConfig.levels[curLod].outGeometricError = collapser->_getMaxCollapseDistance();
             lodConfig.levels[curLod].outSkipped = (vertexCount == lastBakeVertexCount);
             if(!lodConfig.levels[curLod].outSkipped) {
                 lastBakeVertexCount = vertexCount;
                 output->bakeLodLevel(data, lodID++);
+                if(data->mUseMorphTargets) {
+                    bakeMorphTargets(data, false);
+                }
+            }
+        }
+    }
+}
+void MeshLodGenerator::initMorphTargets(LodData* data)
+{
+    data->mMorphTargets.clear();
+    data->mMorphVertexLookups.clear();
+    data->mMorphVertexLookups.resize(data->mIndexBufferInfoList.size());
+
+    // Nothing is collapsed yet, so the triangles still reference the original vertices.
+    size_t triangleCount = data->mTriangleList.size();
+    for(size_t i = 0; i < triangleCount; i++) {
+        const LodData::Triangle& tri = data->mTriangleList[i];
+        LodData::VertexLookupList& lookup = data->mMorphVertexLookups[tri.submeshID];
+        for(int m = 0; m < 3; m++) {
+            if(tri.vertexID[m] >= lookup.size()) {
+                lookup.resize(tri.vertexID[m] + 1, NULL);
+            }
+            lookup[tri.vertexID[m]] = tri.vertex[m];
+        }
+    }
+}
+void MeshLodGenerator::bakeMorphTargets(LodData* data, bool manualLevel)
+{
+    data->mMorphTargets.push_back(LodData::MorphTargetList());
+    if(manualLevel) {
+        return;
+    }
+
+    LodData::MorphTargetList& targets = data->mMorphTargets.back();
+    size_t submeshCount = data->mMorphVertexLookups.size();
+    targets.resize(submeshCount);
+    for(size_t i = 0; i < submeshCount; i++) {
+        const LodData::VertexLookupList& lookup = data->mMorphVertexLookups[i];
+        LodData::MorphTarget& target = targets[i];
+        target.resize(lookup.size() * 3, 0.0f);
+        for(size_t v = 0; v < lookup.size(); v++) {
+            LodData::Vertex* vertex = lookup[v];
+            if(!vertex) {
+                continue;
+            }
+            // Follow the collapses until a vertex which is still part of this Lod level.
+            while(vertex->collapseTo && !data->mCollapseCostHeap.contains(vertex)) {
+                vertex = vertex->collapseTo;
+            }
+            target[v * 3] = vertex->position.x;
+            target[v * 3 + 1] = vertex->position.y;
+            target[v * 3 + 2] = vertex->position.z;
+        }
+    }
+}
+void MeshLodGenerator::_injectMorphTargets(const LodConfig& lodConfig, LodData* data)
+{
+    if(!data->mUseMorphTargets) {
+        return;
+    }
+
+    Mesh* mesh = lodConfig.mesh.get();
+    size_t submeshCount = mesh->getNumSubMeshes();
+    for(size_t i = 0; i < submeshCount; i++) {
+        mesh->getSubMesh(i)->mLodMorphTargets.clear();
+    }
+
+    for(size_t lod = 0; lod < data->mMorphTargets.size(); lod++) {
+        const LodData::MorphTargetList& targets = data->mMorphTargets[lod];
+        HardwareVertexBufferSharedPtr sharedBuffer;
+        for(size_t i = 0; i < submeshCount; i++) {
+            SubMesh* submesh = mesh->getSubMesh(i);
+            if(targets.empty()) {
+                // Manual Lod level
+                submesh->mLodMorphTargets.push_back(HardwareVertexBufferSharedPtr());
+                continue;
+            }
+            if(submesh->useSharedVertices && sharedBuffer) {
+                submesh->mLodMorphTargets.push_back(sharedBuffer);
+                continue;
+            }
+
+            VertexData* vertexData = submesh->useSharedVertices ? mesh->sharedVertexData : submesh->vertexData;
+            HardwareVertexBufferSharedPtr buf = HardwareBufferManager::getSingleton().createVertexBuffer(
+                sizeof(float) * 3, vertexData->vertexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+            float* pDst = static_cast<float*>(buf->lock(HardwareBuffer::HBL_DISCARD));
+            memset(pDst, 0, buf->getSizeInBytes());
+
+            // The shared vertices are merged from all the submeshes using them.
+            for(size_t n = i; n < submeshCount; n++) {
+                if(n != i && !(submesh->useSharedVertices && mesh->getSubMesh(n)->useSharedVertices)) {
+                    continue;
+                }
+                const LodData::VertexLookupList& lookup = data->mMorphVertexLookups[n];
+                size_t count = std::min(lookup.size(), vertexData->vertexCount);
+                for(size_t v = 0; v < count; v++) {
+                    if(lookup[v]) {
+                        memcpy(pDst + v * 3, &targets[n][v * 3], sizeof(float) * 3);
+                    }
+                }
+            }
+
+            buf->unlock();
+            submesh->mLodMorphTargets.push_back(buf);
+            if(submesh->useSharedVertices) {
+                sharedBuffer = buf;
             }
         }
     }
@@ -312,6 +436,7 @@ void MeshLodGenerator::_generateManualLodLevels(LodConfig& lodConfig)
             "Only manual Lod levels are supported! Call generateLodLevels() instead!");
         lodConfig.levels[curLod].outSkipped = false;
         lodConfig.levels[curLod].outUniqueVertexCount = 0;
+        lodConfig.levels[curLod].outGeometricError = 0;
         output.bakeManualLodLevel(NULL, lodConfig.levels[curLod].manualMeshName, curLod);
     }
     output.finalize(NULL);
@@ -179,6 +179,8 @@ namespace Ogre {
 
         /** @copydoc OverlayContainer::_updateRenderQueue */
         void _updateRenderQueue(RenderQueue* queue);
+        /** Not batched, the border is queued with the same Z-order as the panel. */
+        size_t _getBatchVertexCount(void) { return 0; }
         /// @copydoc OverlayElement::visitRenderables
         void visitRenderables(Renderable::Visitor* visitor, 
             bool debugRenderables = false);
@@ -107,6 +107,13 @@ namespace Ogre
             String doGet(const void* target) const;
             void doSet(void* target, const String& val);
         };
+        /// Command object for Font - see ParamCommand 
+        class _OgreOverlayExport CmdGlyphAtlasSize : public ParamCommand
+        {
+        public:
+            String doGet(const void* target) const;
+            void doSet(void* target, const String& val);
+        };
 
         // Command object for setting / getting parameters
         static CmdType msTypeCmd;
@@ -115,6 +122,7 @@ namespace Ogre
         static CmdSize msSizeCmd;
         static CmdResolution msResolutionCmd;
         static CmdCodePoints msCodePointsCmd;
+        static CmdGlyphAtlasSize msGlyphAtlasSizeCmd;
 
         /// The type of font
         FontType mType;
@@ -170,8 +178,21 @@ namespace Ogre
         /// Range of code points to generate glyphs for (truetype only)
         CodePointRangeList mCodePointRangeList;
 
+        /// Side of the texture glyphs are rasterised into on demand, 0 to generate all glyphs at load
+        uint mGlyphAtlasSize;
+        /// Incremented whenever glyphs are evicted from the atlas
+        uint32 mGlyphAtlasGeneration;
+        /// FreeType face and atlas slots, while loaded with a glyph atlas
+        struct GlyphCache;
+        GlyphCache* mGlyphCache;
+
         /// Internal method for loading from ttf
         void createTextureFromFont(void);
+        /// Open the ttf and lay out the atlas cells
+        void createGlyphCache(void);
+        void destroyGlyphCache(void);
+        /// Rasterise a glyph into its atlas cell, dest points to the cell, pitch is in bytes
+        bool renderGlyph(CodePoint id, uchar* dest, size_t pitch);
 
         /// @copydoc Resource::loadImpl
         virtual void loadImpl();
@@ -344,6 +365,37 @@ namespace Ogre
         */
         const GlyphInfo& getGlyphInfo(CodePoint id) const;
 
+        /** Sets the size of the glyph atlas of a truetype font, before loading.
+        @remarks
+            By default all glyphs of the code point ranges are rasterised into
+            a texture when the font is loaded, which is slow and large for big
+            ranges like CJK. With a glyph atlas, glyphs are rasterised into a
+            texture of size x size pixels when first used (see _loadGlyph), and
+            once the atlas is full the least recently used glyphs are replaced.
+            The code point ranges are then only rasterised up front as far as
+            they fit.
+        @param size Side of the atlas texture in pixels, 0 (the default) to
+            generate all glyphs at load time
+        */
+        void setGlyphAtlasSize(uint size);
+        /** Gets the size of the glyph atlas, 0 if the glyphs are generated at load time. */
+        uint getGlyphAtlasSize(void) const { return mGlyphAtlasSize; }
+
+        /** Makes sure the glyph of a code point is in the glyph atlas.
+        @remarks
+            Rasterises the glyph if it isn't yet, which may evict the least
+            recently used glyph. Does nothing unless the font is loaded with a
+            glyph atlas.
+        */
+        void _loadGlyph(CodePoint id);
+        /** Gets a number which changes whenever glyphs are evicted from the atlas.
+        @remarks
+            Text laid out while this had another value may use texture
+            coordinates which now belong to other glyphs, and has to be laid
+            out again.
+        */
+        uint32 _getGlyphAtlasGeneration(void) const { return mGlyphAtlasGeneration; }
+
         /** Adds a range of code points to the list of code point ranges to generate
             glyphs for, if this is a truetype based font.
         @remarks
@@ -33,6 +33,9 @@ THE SOFTWARE.
 #include "OgreIteratorWrappers.h"
 #include "OgreMatrix4.h"
 #include "OgreViewport.h"
+#include "OgreRenderable.h"
+#include "OgreRenderOperation.h"
+#include "OgreOverlayElement.h"
 
 namespace Ogre {
     class OverlayContainer;
@@ -99,6 +102,51 @@ namespace Ogre {
         bool mVisible;
         bool mInitialised;
         String mOrigin;
+
+        /// Consecutive elements sharing a material, drawn from the batch buffer of the OverlayManager
+        class ElementBatch : public Renderable, public OverlayAlloc
+        {
+        public:
+            ElementBatch();
+            ~ElementBatch();
+
+            /// Start collecting the elements of this frame
+            void begin(const MaterialPtr& material, ushort zOrder);
+            void addElement(OverlayElement* elem, size_t vertexCount);
+            /// Rewrite the vertices of elements that changed since the last frame
+            void end(void);
+
+            const MaterialPtr& getMaterial(void) const { return mMaterial; }
+            void getRenderOperation(RenderOperation& op);
+            void getWorldTransforms(Matrix4* xform) const;
+            Real getSquaredViewDepth(const Camera* cam) const { return 10000.0f - (Real)mZOrder; }
+            const LightList& getLights(void) const;
+
+        protected:
+            struct Entry
+            {
+                OverlayElement* element;
+                size_t vertexStart;
+                size_t vertexCount;
+            };
+            typedef vector<Entry>::type EntryList;
+
+            MaterialPtr mMaterial;
+            ushort mZOrder;
+            /// Elements of this frame and of the frame the vertices were written in
+            EntryList mEntries;
+            EntryList mWrittenEntries;
+            vector<OverlayBatchVertex>::type mVertices;
+            VertexData* mVertexData;
+            /// Batch buffer generation the vertices were uploaded in, 0 if they need uploading
+            uint32 mUploadGeneration;
+        };
+        typedef vector<ElementBatch*>::type ElementBatchList;
+        ElementBatchList mBatches;
+        /// Number of batches queued in the current frame, and the batch elements are added to
+        size_t mNumActiveBatches;
+        ElementBatch* mOpenBatch;
+
         /** Internal lazy update method. */
         void updateTransform(void) const;
         /** Internal method for initialising an overlay */
@@ -251,6 +299,14 @@ namespace Ogre {
         /** Internal method to put the overlay contents onto the render queue. */
         void _findVisibleObjects(Camera* cam, RenderQueue* queue, Viewport* vp);
 
+        /** Internal method for queueing an element of this overlay.
+        @remarks
+            When batching is enabled in the OverlayManager, consecutive elements
+            sharing a material are drawn together, otherwise the element is
+            added to the queue on its own.
+        */
+        void _queueElement(OverlayElement* elem, RenderQueue* queue);
+
         /** This returns a OverlayElement at position x,y. */
         virtual OverlayElement* findElementAt(Real x, Real y);
 
@@ -54,6 +54,17 @@ namespace Ogre {
     typedef String DisplayString;
 #   define OGRE_DEREF_DISPLAYSTRING_ITERATOR(it) *it
 #endif
+    /** Vertex written by elements drawn in a batch, see OverlayManager::setBatchingEnabled.
+    @remarks
+        The vertices form a triangle list in clip space, the colour is in the
+        format of the render system (see Root::convertColourValue).
+    */
+    struct OverlayBatchVertex
+    {
+        float x, y, z;
+        float u, v;
+        RGBA colour;
+    };
     /** Enum describing how the position / size of an element is to be recorded. 
     */
     enum GuiMetricsMode
@@ -179,6 +190,9 @@ namespace Ogre {
         /// Used to see if this element is created from a Template
         OverlayElement* mSourceTemplate ;
 
+        /// Flag indicating if the vertices written to a batch need rewriting
+        bool mBatchGeometryOutOfDate;
+
         /** Internal method which is triggered when the positions of the element get updated,
         meaning the element should be rebuilding it's mesh positions. Abstract since
         subclasses must implement this.
@@ -357,6 +371,21 @@ namespace Ogre {
         /** Internal method to put the contents onto the render queue. */
         virtual void _updateRenderQueue(RenderQueue* queue);
 
+        /** Gets the number of vertices this element writes when drawn in a batch.
+        @remarks
+            Elements returning 0, the default, are not batched and are queued
+            as separate renderables.
+        */
+        virtual size_t _getBatchVertexCount(void) { return 0; }
+        /** Writes the vertices of this element for drawing in a batch.
+        @param dest Destination of _getBatchVertexCount vertices
+        */
+        virtual void _writeBatchVertices(OverlayBatchVertex* dest) { (void)dest; }
+        /** Whether the vertices of this element changed since they were last written to a batch. */
+        bool _isBatchGeometryOutOfDate(void) const { return mBatchGeometryOutOfDate; }
+        /** Notifies the element that its vertices were written to a batch. */
+        void _notifyBatchGeometryWritten(void) { mBatchGeometryOutOfDate = false; }
+
         /// @copydoc MovableObject::visitRenderables
         void visitRenderables(Renderable::Visitor* visitor, 
             bool debugRenderables = false);
@@ -33,12 +33,14 @@ THE SOFTWARE.
 #include "OgreStringVector.h"
 #include "OgreScriptLoader.h"
 #include "OgreFrustum.h"
+#include "OgreHardwareVertexBuffer.h"
 
 namespace Ogre {
     class Overlay;
     class OverlayContainer;
     class OverlayElement;
     class OverlayElementFactory;
+    struct OverlayBatchVertex;
 
     /** \addtogroup Optional
     *  @{
@@ -99,6 +101,13 @@ namespace Ogre {
 
         void destroyAllOverlayElementsImpl(ElementMap& elementMap);
 
+        bool mBatchingEnabled;
+        /// Dynamic buffer all element batches are drawn from, filled as a ring
+        HardwareVertexBufferSharedPtr mBatchBuffer;
+        size_t mBatchBufferUsed;
+        /// Incremented whenever the ranges uploaded to the batch buffer become invalid
+        uint32 mBatchBufferGeneration;
+
     public:
         OverlayManager();
         virtual ~OverlayManager();
@@ -143,6 +152,32 @@ namespace Ogre {
         /** Gets the orientation mode of the destination viewport. */
         OrientationMode getViewportOrientationMode(void) const;
 
+        /** Sets whether elements are drawn in batches.
+        @remarks
+            When enabled, consecutive elements of an overlay which share a material
+            are merged into a single draw, fed from one dynamic vertex buffer that
+            is shared by all overlays. Only the vertices of elements which changed
+            are rewritten, so text updates no longer lock a buffer per element.
+        @par
+            Panels with at most one texture layer and text areas can be batched,
+            other elements are drawn on their own as before. As the elements of a
+            batch are drawn as one renderable, per element custom parameters and
+            render queue listeners see the batch instead. Disabled by default.
+        */
+        void setBatchingEnabled(bool enabled);
+        /** Gets whether elements are drawn in batches. */
+        bool isBatchingEnabled(void) const { return mBatchingEnabled; }
+
+        /** Internal method for copying the vertices of a batch into the batch buffer.
+        @return The vertex start of the copy, valid as long as the generation of the
+            buffer doesn't change
+        */
+        size_t _uploadBatchVertices(const OverlayBatchVertex* vertices, size_t count);
+        /** Gets the buffer element batches are drawn from. */
+        const HardwareVertexBufferSharedPtr& _getBatchBuffer(void) const { return mBatchBuffer; }
+        /** Gets the generation of the batch buffer, see _uploadBatchVertices. */
+        uint32 _getBatchBufferGeneration(void) const { return mBatchBufferGeneration; }
+
         /** Creates a new OverlayElement of the type requested.
         @remarks
         The type of element to create is passed in as a string because this
@@ -132,6 +132,9 @@ namespace Ogre  {
 
         /// The max number of profiles we can display
         uint mMaxDisplayProfiles;
+
+        /// Shows the MemoryStats report below the profiles
+        OverlayElement* mMemoryText;
     };
 }
 #endif
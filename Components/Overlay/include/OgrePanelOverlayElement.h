@@ -107,6 +107,10 @@ namespace Ogre {
         void setMaterialName(const String& matName);
         /** Overridden from OverlayContainer */
         void _updateRenderQueue(RenderQueue* queue);
+        /** @copydoc OverlayElement::_getBatchVertexCount */
+        virtual size_t _getBatchVertexCount(void);
+        /** @copydoc OverlayElement::_writeBatchVertices */
+        void _writeBatchVertices(OverlayBatchVertex* dest);
 
 
         /** Command object for specifying tiling (see ParamCommand).*/
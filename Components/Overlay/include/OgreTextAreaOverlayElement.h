@@ -87,6 +87,10 @@ namespace Ogre
         void getRenderOperation(RenderOperation& op);
         /** Overridden from OverlayElement */
         void setMaterialName(const String& matName);
+        /** @copydoc OverlayElement::_getBatchVertexCount */
+        size_t _getBatchVertexCount(void);
+        /** @copydoc OverlayElement::_writeBatchVertices */
+        void _writeBatchVertices(OverlayBatchVertex* dest);
 
         /** Sets the colour of the text. 
         @remarks
@@ -253,6 +257,28 @@ namespace Ogre
         ColourValue mColourTop;
         bool mColoursChanged;
 
+        /// Positions and texture coordinates written instead of the buffer while batched
+        vector<float>::type mBatchGeometry;
+
+        /// The last layout, appending to its caption only lays out the new characters
+        struct LayoutState
+        {
+            DisplayString caption;
+            /// Font and settings the glyphs were laid out with
+            const Font* font;
+            uint32 glyphGeneration;
+            bool batched;
+            float originLeft, originTop;
+            Real charHeight, spaceWidth, aspectCoef;
+            /// Where the layout ended
+            size_t vertexCount;
+            float left, top;
+            float largestWidth;
+
+            LayoutState() : font(0), glyphGeneration(0), batched(false), originLeft(0), originTop(0),
+                charHeight(0), spaceWidth(0), aspectCoef(0), vertexCount(0), left(0), top(0), largestWidth(0) {}
+        };
+        LayoutState mLayout;
 
         /// Internal method to allocate memory, only reallocates when necessary
         void checkMemoryAllocation( size_t numChars );
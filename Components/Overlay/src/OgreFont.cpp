@@ -34,6 +34,8 @@ THE SOFTWARE
 #include "OgreTextureUnitState.h"
 #include "OgreTechnique.h"
 #include "OgreBitwise.h"
+#include "OgreRoot.h"
+#include "OgreHardwarePixelBuffer.h"
 
 #define generic _generic    // keyword for C++/CX
 #include <ft2build.h>
@@ -52,12 +54,45 @@ namespace Ogre
     Font::CmdSize Font::msSizeCmd;
     Font::CmdResolution Font::msResolutionCmd;
     Font::CmdCodePoints Font::msCodePointsCmd;
+    Font::CmdGlyphAtlasSize Font::msGlyphAtlasSizeCmd;
+
+    //---------------------------------------------------------------------
+    struct Font::GlyphCache : public OverlayAlloc
+    {
+        FT_Library library;
+        FT_Face face;
+        /// The face reads from this memory for as long as it is open
+        MemoryDataStreamPtr ttfData;
+        /// Size of an atlas cell, which holds one glyph
+        uint cellWidth;
+        uint cellHeight;
+        uint columns;
+        size_t numCells;
+
+        /// Code points in the atlas, most recently used first
+        typedef list<CodePoint>::type UsageList;
+        UsageList usage;
+        struct Slot
+        {
+            size_t cell;
+            UsageList::iterator usage;
+            unsigned long lastFrame;
+        };
+        typedef map<CodePoint, Slot>::type SlotMap;
+        SlotMap slots;
+        /// Code points FreeType has no bitmap for, like spaces
+        set<CodePoint>::type blanks;
+        bool fullWarned;
+
+        GlyphCache() : library(0), face(0), cellWidth(0), cellHeight(0), columns(0), numCells(0), fullWarned(false) {}
+    };
 
     //---------------------------------------------------------------------
     Font::Font(ResourceManager* creator, const String& name, ResourceHandle handle,
         const String& group, bool isManual, ManualResourceLoader* loader)
         :Resource (creator, name, handle, group, isManual, loader),
-        mType(FT_TRUETYPE), mCharacterSpacer(5), mTtfSize(0), mTtfResolution(0), mTtfMaxBearingY(0), mAntialiasColour(false)
+        mType(FT_TRUETYPE), mCharacterSpacer(5), mTtfSize(0), mTtfResolution(0), mTtfMaxBearingY(0), mAntialiasColour(false),
+        mGlyphAtlasSize(0), mGlyphAtlasGeneration(0), mGlyphCache(0)
     {
 
         if (createParamDictionary("Font"))
@@ -81,6 +116,9 @@ namespace Ogre
             dict->addParameter(
                 ParameterDef("code_points", "Add a range of code points", PT_STRING),
                 &msCodePointsCmd);
+            dict->addParameter(
+                ParameterDef("glyph_atlas_size", "Size of the texture glyphs are rasterised into on demand", PT_UNSIGNED_INT),
+                &msGlyphAtlasSizeCmd);
         }
 
     }
@@ -159,6 +197,11 @@ namespace Ogre
         return i->second;
     }
     //---------------------------------------------------------------------
+    void Font::setGlyphAtlasSize(uint size)
+    {
+        mGlyphAtlasSize = size;
+    }
+    //---------------------------------------------------------------------
     void Font::loadImpl()
     {
         // Create a new material
@@ -175,6 +218,8 @@ namespace Ogre
         bool blendByAlpha = true;
         if (mType == FT_TRUETYPE)
         {
+            if (mGlyphAtlasSize)
+                createGlyphCache();
             createTextureFromFont();
             texLayer = mMaterial->getTechnique(0)->getPass(0)->getTextureUnitState(0);
             // Always blend by alpha
@@ -206,6 +251,19 @@ namespace Ogre
             // Use add if no alpha (assume black background)
             mMaterial->setSceneBlending(SBT_ADD);
         }
+
+        // Rasterise the requested ranges up front, as far as they fit
+        if (mGlyphCache)
+        {
+            for (CodePointRangeList::const_iterator r = mCodePointRangeList.begin();
+                r != mCodePointRangeList.end(); ++r)
+            {
+                for (CodePoint cp = r->first; cp <= r->second && mGlyphCache->slots.size() < mGlyphCache->numCells; ++cp)
+                {
+                    _loadGlyph(cp);
+                }
+            }
+        }
     }
     //---------------------------------------------------------------------
     void Font::unloadImpl()
@@ -221,6 +279,183 @@ namespace Ogre
             mTexture->unload();
             mTexture.reset();
         }
+
+        destroyGlyphCache();
+    }
+    //---------------------------------------------------------------------
+    void Font::createGlyphCache(void)
+    {
+        mGlyphCache = OGRE_NEW GlyphCache();
+
+        if( FT_Init_FreeType( &mGlyphCache->library ) )
+            OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR, "Could not init FreeType library!",
+            "Font::createGlyphCache");
+
+        // Glyphs are rasterised while the font is in use, so keep the ttf in memory
+        DataStreamPtr dataStreamPtr =
+            ResourceGroupManager::getSingleton().openResource(
+                mSource, mGroup, this);
+        mGlyphCache->ttfData.reset(OGRE_NEW MemoryDataStream(dataStreamPtr));
+
+        if( FT_New_Memory_Face( mGlyphCache->library, mGlyphCache->ttfData->getPtr(),
+            (FT_Long)mGlyphCache->ttfData->size(), 0, &mGlyphCache->face ) )
+            OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR,
+            "Could not open font face!", "Font::createGlyphCache" );
+
+        FT_F26Dot6 ftSize = (FT_F26Dot6)(mTtfSize * (1 << 6));
+        if( FT_Set_Char_Size( mGlyphCache->face, ftSize, 0, mTtfResolution, mTtfResolution ) )
+            OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR,
+            "Could not set char size!", "Font::createGlyphCache" );
+
+        // The glyphs aren't known yet, so size the cells from the face metrics
+        const FT_Size_Metrics& metrics = mGlyphCache->face->size->metrics;
+        mTtfMaxBearingY = static_cast<int>(metrics.ascender);
+        mGlyphCache->cellWidth = static_cast<uint>(metrics.max_advance >> 6) + mCharacterSpacer;
+        mGlyphCache->cellHeight = static_cast<uint>((metrics.ascender - metrics.descender) >> 6) + mCharacterSpacer;
+        mGlyphCache->columns = mGlyphAtlasSize / mGlyphCache->cellWidth;
+        mGlyphCache->numCells = mGlyphCache->columns * (mGlyphAtlasSize / mGlyphCache->cellHeight);
+
+        if (mGlyphCache->numCells == 0)
+        {
+            OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                "Glyph atlas of font " + mName + " is too small for a single glyph",
+                "Font::createGlyphCache" );
+        }
+
+        LogManager::getSingleton().logMessage("Font " + mName + " using a glyph atlas of size " +
+            StringConverter::toString(mGlyphAtlasSize) + " for " +
+            StringConverter::toString(mGlyphCache->numCells) + " glyphs");
+    }
+    //---------------------------------------------------------------------
+    void Font::destroyGlyphCache(void)
+    {
+        if (!mGlyphCache)
+            return;
+
+        if (mGlyphCache->face)
+            FT_Done_Face(mGlyphCache->face);
+        if (mGlyphCache->library)
+            FT_Done_FreeType(mGlyphCache->library);
+        OGRE_DELETE mGlyphCache;
+        mGlyphCache = 0;
+
+        // The texture coordinates pointed into the atlas
+        mCodePointMap.clear();
+        ++mGlyphAtlasGeneration;
+    }
+    //---------------------------------------------------------------------
+    bool Font::renderGlyph(CodePoint id, uchar* dest, size_t pitch)
+    {
+        const uint cellWidth = mGlyphCache->cellWidth;
+        const uint cellHeight = mGlyphCache->cellHeight;
+
+        // Reset content (White, transparent)
+        for (uint j = 0; j < cellHeight; ++j)
+        {
+            uchar* pDest = dest + j * pitch;
+            for (uint k = 0; k < cellWidth; ++k)
+            {
+                *pDest++ = 0xFF;
+                *pDest++ = 0x00;
+            }
+        }
+
+        FT_Face face = mGlyphCache->face;
+        if (FT_Load_Char( face, id, FT_LOAD_RENDER ) || !face->glyph->bitmap.buffer)
+            return false;
+
+        // Same placement as in loadResource, clipped to the cell
+        int y_bearing = ( mTtfMaxBearingY >> 6 ) - static_cast<int>( face->glyph->metrics.horiBearingY >> 6 );
+        int x_bearing = static_cast<int>( face->glyph->metrics.horiBearingX >> 6 );
+
+        for (int j = 0; j < (int)face->glyph->bitmap.rows; ++j)
+        {
+            int row = j + y_bearing;
+            if (row < 0 || row >= (int)cellHeight)
+                continue;
+
+            const uchar* buffer = face->glyph->bitmap.buffer + j * face->glyph->bitmap.pitch;
+            for (int k = 0; k < (int)face->glyph->bitmap.width; ++k, ++buffer)
+            {
+                int column = k + x_bearing;
+                if (column < 0 || column >= (int)cellWidth)
+                    continue;
+
+                uchar* pDest = dest + row * pitch + column * 2;
+                pDest[0] = mAntialiasColour ? *buffer : 0xFF;
+                pDest[1] = *buffer;
+            }
+        }
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void Font::_loadGlyph(CodePoint id)
+    {
+        if (!mGlyphCache)
+            return;
+
+        GlyphCache& cache = *mGlyphCache;
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+
+        GlyphCache::SlotMap::iterator i = cache.slots.find(id);
+        if (i != cache.slots.end())
+        {
+            // Mark as most recently used
+            cache.usage.splice(cache.usage.begin(), cache.usage, i->second.usage);
+            i->second.lastFrame = frame;
+            return;
+        }
+
+        if (cache.blanks.find(id) != cache.blanks.end())
+            return;
+
+        vector<uchar>::type pixels(cache.cellWidth * cache.cellHeight * 2);
+        if (!renderGlyph(id, &pixels[0], cache.cellWidth * 2))
+        {
+            cache.blanks.insert(id);
+            return;
+        }
+        FT_Pos advance = cache.face->glyph->advance.x >> 6;
+
+        // Cells are used in order until the atlas is full, then the least recently used one is replaced
+        size_t cell = cache.slots.size();
+        if (cell == cache.numCells)
+        {
+            GlyphCache::SlotMap::iterator victim = cache.slots.find(cache.usage.back());
+            if (victim->second.lastFrame == frame)
+            {
+                // Every glyph is in use this frame, so there is nothing to replace
+                if (!cache.fullWarned)
+                {
+                    LogManager::getSingleton().logMessage("Glyph atlas of font " + mName +
+                        " is too small for the glyphs in use, increase glyph_atlas_size", LML_CRITICAL);
+                    cache.fullWarned = true;
+                }
+                return;
+            }
+
+            cell = victim->second.cell;
+            mCodePointMap.erase(victim->first);
+            cache.usage.pop_back();
+            cache.slots.erase(victim);
+            ++mGlyphAtlasGeneration;
+        }
+
+        size_t left = (cell % cache.columns) * cache.cellWidth;
+        size_t top = (cell / cache.columns) * cache.cellHeight;
+        mTexture->getBuffer()->blitFromMemory(
+            PixelBox(cache.cellWidth, cache.cellHeight, 1, PF_BYTE_LA, &pixels[0]),
+            Box(left, top, left + cache.cellWidth, top + cache.cellHeight));
+
+        Real size = (Real)mGlyphAtlasSize;
+        setGlyphTexCoords(id, left / size, top / size, (left + advance) / size,
+            (top + cache.cellHeight - mCharacterSpacer) / size, 1.0);
+
+        cache.usage.push_front(id);
+        GlyphCache::Slot& slot = cache.slots[id];
+        slot.cell = cell;
+        slot.usage = cache.usage.begin();
+        slot.lastFrame = frame;
     }
     //---------------------------------------------------------------------
     void Font::createTextureFromFont(void)
@@ -245,6 +480,36 @@ namespace Ogre
     void Font::loadResource(Resource* res)
     {
         // ManualResourceLoader implementation - load the texture
+        if (mGlyphCache)
+        {
+            // (Re)create the atlas with the glyphs it currently holds
+            size_t pitch = mGlyphAtlasSize * 2;
+            DataStreamPtr memStream(OGRE_NEW MemoryDataStream(pitch * mGlyphAtlasSize));
+            uchar* imageData = static_cast<MemoryDataStream*>(memStream.get())->getPtr();
+
+            for (size_t i = 0; i < pitch * mGlyphAtlasSize; i += 2)
+            {
+                imageData[i + 0] = 0xFF; // luminance
+                imageData[i + 1] = 0x00; // alpha
+            }
+
+            for (GlyphCache::SlotMap::const_iterator i = mGlyphCache->slots.begin();
+                i != mGlyphCache->slots.end(); ++i)
+            {
+                size_t left = (i->second.cell % mGlyphCache->columns) * mGlyphCache->cellWidth;
+                size_t top = (i->second.cell / mGlyphCache->columns) * mGlyphCache->cellHeight;
+                renderGlyph(i->first, imageData + top * pitch + left * 2, pitch);
+            }
+
+            Image img;
+            img.loadRawData( memStream, mGlyphAtlasSize, mGlyphAtlasSize, 1, PF_BYTE_LA );
+
+            ConstImagePtrList imagePtrs;
+            imagePtrs.push_back(&img);
+            static_cast<Texture*>(res)->_loadImages( imagePtrs );
+            return;
+        }
+
         FT_Library ftLibrary;
         // Init freetype
         if( FT_Init_FreeType( &ftLibrary ) )
@@ -506,6 +771,17 @@ namespace Ogre
         f->setTrueTypeResolution(StringConverter::parseUnsignedInt(val));
     }
     //-----------------------------------------------------------------------
+    String Font::CmdGlyphAtlasSize::doGet(const void* target) const
+    {
+        const Font* f = static_cast<const Font*>(target);
+        return StringConverter::toString(f->getGlyphAtlasSize());
+    }
+    void Font::CmdGlyphAtlasSize::doSet(void* target, const String& val)
+    {
+        Font* f = static_cast<Font*>(target);
+        f->setGlyphAtlasSize(StringConverter::parseUnsignedInt(val));
+    }
+    //-----------------------------------------------------------------------
     String Font::CmdCodePoints::doGet(const void* target) const
     {
         const Font* f = static_cast<const Font*>(target);
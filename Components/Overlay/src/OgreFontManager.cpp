@@ -249,6 +249,17 @@ namespace Ogre
             // Set
             pFont->setAntialiasColour(StringConverter::parseBool(params[1]));
         }
+        else if (attrib == "glyph_atlas_size")
+        {
+            // Check params
+            if (params.size() != 2)
+            {
+                logBadAttrib(line, pFont);
+                return;
+            }
+            // Set
+            pFont->setGlyphAtlasSize(StringConverter::parseUnsignedInt(params[1]));
+        }
         else if (attrib == "code_points")
         {
             for (size_t c = 1; c < params.size(); ++c)
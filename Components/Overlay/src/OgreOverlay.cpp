@@ -33,6 +33,8 @@ THE SOFTWARE.
 #include "OgreSceneNode.h"
 #include "OgreRenderQueue.h"
 #include "OgreCamera.h"
+#include "OgreRoot.h"
+#include "OgreHardwareBufferManager.h"
 
 namespace Ogre {
 
@@ -44,7 +46,8 @@ namespace Ogre {
         mScaleX(1.0f), mScaleY(1.0f),
         mLastViewportWidth(0), mLastViewportHeight(0),
         mTransformOutOfDate(true), mTransformUpdated(true), 
-        mZOrder(100), mVisible(false), mInitialised(false)
+        mZOrder(100), mVisible(false), mInitialised(false),
+        mNumActiveBatches(0), mOpenBatch(0)
 
     {
         mRootNode = OGRE_NEW SceneNode(NULL);
@@ -56,6 +59,11 @@ namespace Ogre {
         // remove children
 
         OGRE_DELETE mRootNode;
+
+        for (size_t b = 0; b < mBatches.size(); ++b)
+        {
+            OGRE_DELETE mBatches[b];
+        }
         
         for (OverlayContainerList::iterator i = m2DElements.begin(); 
              i != m2DElements.end(); ++i)
@@ -301,6 +309,8 @@ namespace Ogre {
             queue->setDefaultQueueGroup(oldgrp);
             queue->setDefaultRenderablePriority(oldPriority);
             // Add 2D elements
+            mNumActiveBatches = 0;
+            mOpenBatch = 0;
             iend = m2DElements.end();
             for (i = m2DElements.begin(); i != iend; ++i)
             {
@@ -308,7 +318,137 @@ namespace Ogre {
 
                 (*i)->_updateRenderQueue(queue);
             }
+            mOpenBatch = 0;
+
+            // Write the vertices of the batched elements that changed
+            for (size_t b = 0; b < mNumActiveBatches; ++b)
+            {
+                mBatches[b]->end();
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void Overlay::_queueElement(OverlayElement* elem, RenderQueue* queue)
+    {
+        size_t vertexCount = 0;
+        if (OverlayManager::getSingleton().isBatchingEnabled())
+            vertexCount = elem->_getBatchVertexCount();
+
+        const MaterialPtr& material = elem->getMaterial();
+        if (vertexCount == 0 || !material)
+        {
+            // Ends the open batch, so elements after this one are drawn on top of it
+            mOpenBatch = 0;
+            queue->addRenderable(elem, RENDER_QUEUE_OVERLAY, elem->getZOrder());
+            return;
         }
+
+        // Elements are queued in Z-order, so a batch only takes elements that follow each other
+        if (!mOpenBatch || mOpenBatch->getMaterial() != material)
+        {
+            if (mNumActiveBatches == mBatches.size())
+                mBatches.push_back(OGRE_NEW ElementBatch());
+
+            mOpenBatch = mBatches[mNumActiveBatches++];
+            mOpenBatch->begin(material, elem->getZOrder());
+            queue->addRenderable(mOpenBatch, RENDER_QUEUE_OVERLAY, elem->getZOrder());
+        }
+        mOpenBatch->addElement(elem, vertexCount);
+    }
+    //---------------------------------------------------------------------
+    Overlay::ElementBatch::ElementBatch()
+        : mZOrder(0), mUploadGeneration(0)
+    {
+        mPolygonModeOverrideable = false;
+        mUseIdentityProjection = true;
+        mUseIdentityView = true;
+
+        mVertexData = OGRE_NEW VertexData();
+        VertexDeclaration* decl = mVertexData->vertexDeclaration;
+        size_t offset = 0;
+        offset += decl->addElement(0, offset, VET_FLOAT3, VES_POSITION).getSize();
+        offset += decl->addElement(0, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES, 0).getSize();
+        decl->addElement(0, offset, VET_COLOUR, VES_DIFFUSE);
+    }
+    //---------------------------------------------------------------------
+    Overlay::ElementBatch::~ElementBatch()
+    {
+        OGRE_DELETE mVertexData;
+    }
+    //---------------------------------------------------------------------
+    void Overlay::ElementBatch::begin(const MaterialPtr& material, ushort zOrder)
+    {
+        mMaterial = material;
+        mZOrder = zOrder;
+        mEntries.clear();
+    }
+    //---------------------------------------------------------------------
+    void Overlay::ElementBatch::addElement(OverlayElement* elem, size_t vertexCount)
+    {
+        Entry entry;
+        entry.element = elem;
+        entry.vertexStart = mEntries.empty() ? 0 : mEntries.back().vertexStart + mEntries.back().vertexCount;
+        entry.vertexCount = vertexCount;
+        mEntries.push_back(entry);
+    }
+    //---------------------------------------------------------------------
+    void Overlay::ElementBatch::end(void)
+    {
+        // Only the elements that changed are rewritten while the batch holds the same elements
+        bool layoutChanged = mEntries.size() != mWrittenEntries.size();
+        for (size_t i = 0; i < mEntries.size() && !layoutChanged; ++i)
+        {
+            layoutChanged = mEntries[i].element != mWrittenEntries[i].element ||
+                mEntries[i].vertexCount != mWrittenEntries[i].vertexCount;
+        }
+
+        if (layoutChanged)
+            mVertices.resize(mEntries.back().vertexStart + mEntries.back().vertexCount);
+
+        for (EntryList::iterator i = mEntries.begin(); i != mEntries.end(); ++i)
+        {
+            if (layoutChanged || i->element->_isBatchGeometryOutOfDate())
+            {
+                i->element->_writeBatchVertices(&mVertices[i->vertexStart]);
+                i->element->_notifyBatchGeometryWritten();
+                mUploadGeneration = 0;
+            }
+        }
+
+        if (layoutChanged)
+            mWrittenEntries = mEntries;
+    }
+    //---------------------------------------------------------------------
+    void Overlay::ElementBatch::getRenderOperation(RenderOperation& op)
+    {
+        OverlayManager& overlayManager = OverlayManager::getSingleton();
+
+        // The uploaded vertices stay valid until the batch buffer wraps around
+        if (mUploadGeneration != overlayManager._getBatchBufferGeneration())
+        {
+            mVertexData->vertexStart = overlayManager._uploadBatchVertices(&mVertices[0], mVertices.size());
+            mVertexData->vertexBufferBinding->setBinding(0, overlayManager._getBatchBuffer());
+            mUploadGeneration = overlayManager._getBatchBufferGeneration();
+        }
+        mVertexData->vertexCount = mVertices.size();
+
+        op.vertexData = mVertexData;
+        op.operationType = RenderOperation::OT_TRIANGLE_LIST;
+        op.useIndexes = false;
+        op.indexData = 0;
+        op.useGlobalInstancingVertexBufferIsAvailable = false;
+    }
+    //---------------------------------------------------------------------
+    void Overlay::ElementBatch::getWorldTransforms(Matrix4* xform) const
+    {
+        // All elements of an overlay share its transform
+        mEntries.front().element->getWorldTransforms(xform);
+    }
+    //---------------------------------------------------------------------
+    const LightList& Overlay::ElementBatch::getLights(void) const
+    {
+        static LightList ll;
+        return ll;
     }
     //---------------------------------------------------------------------
     void Overlay::updateTransform(void) const
@@ -80,6 +80,7 @@ namespace Ogre {
       , mEnabled(true)
       , mInitialised(false)
       , mSourceTemplate(0)
+      , mBatchGeometryOutOfDate(true)
     {
         // default overlays to preserve their own detail level
         mPolygonModeOverrideable = false;
@@ -404,6 +405,7 @@ namespace Ogre {
         if (mGeomPositionsOutOfDate && mInitialised)
         {
             updatePositionGeometry();
+            mBatchGeometryOutOfDate = true;
 
             // Within updatePositionGeometry() of TextOverlayElements,
             // the needed pixel width is calculated and as a result a new 
@@ -421,6 +423,7 @@ namespace Ogre {
         {
             updateTextureGeometry();
             mGeomUVsOutOfDate = false;
+            mBatchGeometryOutOfDate = true;
         } 
     }
     //---------------------------------------------------------------------
@@ -622,7 +625,11 @@ namespace Ogre {
     {
         if (mVisible)
         {
-            queue->addRenderable(this, RENDER_QUEUE_OVERLAY, mZOrder);
+            // The overlay merges batchable elements into shared draws
+            if (mOverlay)
+                mOverlay->_queueElement(this, queue);
+            else
+                queue->addRenderable(this, RENDER_QUEUE_OVERLAY, mZOrder);
         }      
     }
     //---------------------------------------------------------------------
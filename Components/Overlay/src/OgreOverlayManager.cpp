@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "OgreResourceGroupManager.h"
 #include "OgreOverlayElementFactory.h"
 #include "OgreStringConverter.h"
+#include "OgreHardwareBufferManager.h"
 
 namespace Ogre {
 
@@ -52,7 +53,10 @@ namespace Ogre {
     OverlayManager::OverlayManager() 
       : mLastViewportWidth(0), 
         mLastViewportHeight(0), 
-        mLastViewportOrientationMode(OR_DEGREE_0)
+        mLastViewportOrientationMode(OR_DEGREE_0),
+        mBatchingEnabled(false),
+        mBatchBufferUsed(0),
+        mBatchBufferGeneration(1)
     {
 
         // Scripting is supported by this manager
@@ -85,6 +89,9 @@ namespace Ogre {
             for(ElementMap::iterator i = elementMap.begin(), i_end = elementMap.end(); i != i_end; ++i)
                 i->second->_releaseManualHardwareResources();
         }
+
+        mBatchBuffer.reset();
+        ++mBatchBufferGeneration;
     }
     //---------------------------------------------------------------------
     void OverlayManager::_restoreManualHardwareResources()
@@ -97,6 +104,55 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OverlayManager::setBatchingEnabled(bool enabled)
+    {
+        if (mBatchingEnabled == enabled)
+            return;
+
+        mBatchingEnabled = enabled;
+
+        // Batched elements don't keep their own buffers up to date, so rebuild everything
+        for (ElementMap::iterator i = mInstances.begin(); i != mInstances.end(); ++i)
+            i->second->_positionsOutOfDate();
+
+        if (!mBatchingEnabled)
+        {
+            mBatchBuffer.reset();
+            ++mBatchBufferGeneration;
+        }
+    }
+    //---------------------------------------------------------------------
+    size_t OverlayManager::_uploadBatchVertices(const OverlayBatchVertex* vertices, size_t count)
+    {
+        const size_t vertexSize = sizeof(OverlayBatchVertex);
+
+        if (!mBatchBuffer || mBatchBuffer->getNumVertices() < count)
+        {
+            size_t numVertices = mBatchBuffer ? mBatchBuffer->getNumVertices() * 2 : 4096;
+            mBatchBuffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+                vertexSize, std::max(numVertices, count), HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+            // Start the new buffer with a discard
+            mBatchBufferUsed = mBatchBuffer->getNumVertices();
+        }
+
+        // Append behind the ranges in use this frame, and start over once the buffer is full
+        HardwareBuffer::LockOptions options = HardwareBuffer::HBL_NO_OVERWRITE;
+        if (mBatchBufferUsed + count > mBatchBuffer->getNumVertices())
+        {
+            options = HardwareBuffer::HBL_DISCARD;
+            mBatchBufferUsed = 0;
+            ++mBatchBufferGeneration;
+        }
+
+        size_t vertexStart = mBatchBufferUsed;
+        void* dest = mBatchBuffer->lock(vertexStart * vertexSize, count * vertexSize, options);
+        memcpy(dest, vertices, count * vertexSize);
+        mBatchBuffer->unlock();
+        mBatchBufferUsed += count;
+
+        return vertexStart;
+    }
+    //---------------------------------------------------------------------
     const StringVector& OverlayManager::getScriptPatterns(void) const
     {
         return mScriptPatterns;
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreOverlayElement.h"
 #include "OgreOverlay.h"
 #include "OgreStringConverter.h"
+#include "OgreMemoryStats.h"
 
 namespace Ogre
 {
@@ -49,6 +50,7 @@ namespace Ogre
         , mBarLineWidth(2)
         , mBarSpacing(3)
         , mMaxDisplayProfiles(50)
+        , mMemoryText(0)
     {
     }
     //-----------------------------------------------------------------------
@@ -100,6 +102,10 @@ namespace Ogre
             mProfileBars.push_back(element);
         }
 
+        // the memory usage goes below the profiles
+        mMemoryText = createTextArea("memoryText", mGuiWidth, mBarHeight, 0, 10, static_cast<uint>(mBarHeight + mBarSpacing), "", false);
+        mProfileGui->addChild(mMemoryText);
+
         // throw everything all the GUI stuff into the overlay and display it
         mOverlay->add2D(mProfileGui);
     }
@@ -118,6 +124,7 @@ namespace Ogre
                 OverlayManager::getSingleton().destroyOverlayElement(element);
             }
         }
+        mMemoryText = 0;
         if(mProfileGui)
             OverlayManager::getSingleton().destroyOverlayElement(mProfileGui);
         if(mOverlay)
@@ -139,6 +146,21 @@ namespace Ogre
             ProfileInstance* child = it->second;
             displayResults(child, bIter, maxTimeMillisecs, newGuiHeight, profileCount);
         }
+
+        // display the memory usage, one line per category
+        String memoryReport = MemoryStats::getReport();
+        if (memoryReport.empty())
+        {
+            mMemoryText->hide();
+        }
+        else
+        {
+            size_t lines = std::count(memoryReport.begin(), memoryReport.end(), '\n');
+            mMemoryText->show();
+            mMemoryText->setCaption(memoryReport);
+            mMemoryText->setTop(mGuiBorderWidth + profileCount * (mBarHeight + mBarSpacing));
+            newGuiHeight += lines * (mBarHeight + mBarSpacing);
+        }
             
         // set the main display dimensions
         mProfileGui->setMetricsMode(GMM_PIXELS);
@@ -231,6 +231,56 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    size_t PanelOverlayElement::_getBatchVertexCount(void)
+    {
+        // Batch vertices have a single set of texture coordinates
+        if (!mInitialised || !mMaterial ||
+            mMaterial->getTechnique(0)->getPass(0)->getNumTextureUnitStates() > 1)
+        {
+            return 0;
+        }
+        // Two triangles, as batches are drawn as lists
+        return 6;
+    }
+    //---------------------------------------------------------------------
+    void PanelOverlayElement::_writeBatchVertices(OverlayBatchVertex* dest)
+    {
+        // Same corners as updatePositionGeometry / updateTextureGeometry
+        Real left = _getDerivedLeft() * 2 - 1;
+        Real right = left + (mWidth * 2);
+        Real top = -((_getDerivedTop() * 2) - 1);
+        Real bottom = top - (mHeight * 2);
+        Real upperX = mU2 * mTileX[0];
+        Real upperY = mV2 * mTileY[0];
+
+        OverlayBatchVertex corners[4];
+        corners[0].x = corners[1].x = static_cast<float>(left);
+        corners[2].x = corners[3].x = static_cast<float>(right);
+        corners[0].y = corners[2].y = static_cast<float>(top);
+        corners[1].y = corners[3].y = static_cast<float>(bottom);
+        corners[0].u = corners[1].u = static_cast<float>(mU1);
+        corners[2].u = corners[3].u = static_cast<float>(upperX);
+        corners[0].v = corners[2].v = static_cast<float>(mV1);
+        corners[1].v = corners[3].v = static_cast<float>(upperY);
+
+        RGBA colour;
+        Root::getSingleton().convertColourValue(ColourValue::White, &colour);
+        Real zValue = Root::getSingleton().getRenderSystem()->getMaximumDepthInputValue();
+        for (int i = 0; i < 4; ++i)
+        {
+            corners[i].z = static_cast<float>(zValue);
+            corners[i].colour = colour;
+        }
+
+        // Triangles 0-1-2 and 2-1-3 of the strip
+        dest[0] = corners[0];
+        dest[1] = corners[1];
+        dest[2] = corners[2];
+        dest[3] = corners[2];
+        dest[4] = corners[1];
+        dest[5] = corners[3];
+    }
+    //---------------------------------------------------------------------
     void PanelOverlayElement::updatePositionGeometry(void)
     {
         /*
@@ -157,6 +157,7 @@ namespace Ogre {
         mGeomPositionsOutOfDate = true;
         mGeomUVsOutOfDate = true;
         mColoursChanged = true;
+        mLayout.font = 0;
     }
     //---------------------------------------------------------------------
     void TextAreaOverlayElement::_releaseManualHardwareResources()
@@ -181,30 +182,94 @@ namespace Ogre {
         }
 
         size_t charlen = mCaption.size();
+        size_t allocSize = mAllocSize;
         checkMemoryAllocation( charlen );
 
-        mRenderOp.vertexData->vertexCount = charlen * 6;
-        // Get position / texcoord buffer
-        const HardwareVertexBufferSharedPtr& vbuf = 
-            mRenderOp.vertexData->vertexBufferBinding->getBuffer(POS_TEX_BINDING);
-        pVert = static_cast<float*>(
-            vbuf->lock(HardwareBuffer::HBL_DISCARD, Root::getSingleton().getFreqUpdatedBuffersUploadOption()) );
-
-        float largestWidth = 0;
-        float left = _getDerivedLeft() * 2.0f - 1.0f;
-        float top = -( (_getDerivedTop() * 2.0f ) - 1.0f );
+        // When batched the vertices are copied into the batch, so the buffer isn't touched
+        bool batched = OverlayManager::getSingleton().isBatchingEnabled();
+        uint32 glyphGeneration = mFont->_getGlyphAtlasGeneration();
+        float originLeft = _getDerivedLeft() * 2.0f - 1.0f;
+        float originTop = -( (_getDerivedTop() * 2.0f ) - 1.0f );
 
         // Derive space with from a number 0
+        mFont->_loadGlyph(UNICODE_ZERO);
         if(!mSpaceWidthOverridden)
         {
             mSpaceWidth = mFont->getGlyphAspectRatio(UNICODE_ZERO) * mCharHeight;
         }
 
+        // When text was only appended, e.g. to a log window, the glyphs laid out before are kept.
+        // Other alignments move whole lines, and a trailing CR may join with a following LF.
+        size_t laidOut = mLayout.caption.size();
+        bool incremental = mAlignment == Left && mLayout.font == mFont.get() &&
+            mLayout.glyphGeneration == glyphGeneration && mLayout.batched == batched &&
+            mAllocSize == allocSize && mLayout.originLeft == originLeft && mLayout.originTop == originTop &&
+            mLayout.charHeight == mCharHeight && mLayout.spaceWidth == mSpaceWidth &&
+            mLayout.aspectCoef == mViewportAspectCoef &&
+            charlen >= laidOut && mCaption.compare(0, laidOut, mLayout.caption) == 0 &&
+            (laidOut == 0 || mLayout.caption[laidOut - 1] != UNICODE_CR);
+        if (!incremental)
+        {
+            laidOut = 0;
+            mLayout.vertexCount = 0;
+            mLayout.left = originLeft;
+            mLayout.top = originTop;
+            mLayout.largestWidth = 0;
+        }
+
         // Use iterator
         DisplayString::iterator i, iend;
         iend = mCaption.end();
+        DisplayString::iterator start = mCaption.begin();
+        for (size_t c = 0; c < laidOut; ++c)
+            ++start;
+
+        // Rasterise the glyphs into the atlas of the font, if it has one, before using their coordinates
+        for( i = start; i != iend; ++i )
+        {
+            Font::CodePoint character = OGRE_DEREF_DISPLAYSTRING_ITERATOR(i);
+            if (character != UNICODE_CR && character != UNICODE_NEL &&
+                character != UNICODE_LF && character != UNICODE_SPACE)
+            {
+                mFont->_loadGlyph(character);
+            }
+        }
+
+        mRenderOp.vertexData->vertexCount = mLayout.vertexCount + (charlen - laidOut) * 6;
+        size_t newVertexCount = (charlen - laidOut) * 6;
+
+        HardwareVertexBufferSharedPtr vbuf;
+        pVert = 0;
+        if (batched)
+        {
+            mBatchGeometry.resize(charlen * 6 * 5);
+            if (newVertexCount)
+                pVert = &mBatchGeometry[mLayout.vertexCount * 5];
+        }
+        else if (newVertexCount || !incremental)
+        {
+            // Get position / texcoord buffer, only the range behind the kept glyphs when appending
+            vbuf = mRenderOp.vertexData->vertexBufferBinding->getBuffer(POS_TEX_BINDING);
+            size_t vertexSize = vbuf->getVertexSize();
+            if (incremental)
+            {
+                pVert = static_cast<float*>(
+                    vbuf->lock(mLayout.vertexCount * vertexSize, newVertexCount * vertexSize,
+                        HardwareBuffer::HBL_NO_OVERWRITE, Root::getSingleton().getFreqUpdatedBuffersUploadOption()) );
+            }
+            else
+            {
+                pVert = static_cast<float*>(
+                    vbuf->lock(HardwareBuffer::HBL_DISCARD, Root::getSingleton().getFreqUpdatedBuffersUploadOption()) );
+            }
+        }
+
+        float largestWidth = mLayout.largestWidth;
+        float left = mLayout.left;
+        float top = mLayout.top;
+
         bool newLine = true;
-        for( i = mCaption.begin(); i != iend; ++i )
+        for( i = start; i != iend; ++i )
         {
             if( newLine )
             {
@@ -241,7 +306,7 @@ namespace Ogre {
                 || character == UNICODE_NEL
                 || character == UNICODE_LF)
             {
-                left = _getDerivedLeft() * 2.0f - 1.0f;
+                left = originLeft;
                 top -= mCharHeight * 2.0f;
                 newLine = true;
                 // Also reduce tri count
@@ -346,7 +411,22 @@ namespace Ogre {
             }
         }
         // Unlock vertex buffer
-        vbuf->unlock();
+        if (vbuf)
+            vbuf->unlock();
+
+        mLayout.caption = mCaption;
+        mLayout.font = mFont.get();
+        mLayout.glyphGeneration = glyphGeneration;
+        mLayout.batched = batched;
+        mLayout.originLeft = originLeft;
+        mLayout.originTop = originTop;
+        mLayout.charHeight = mCharHeight;
+        mLayout.spaceWidth = mSpaceWidth;
+        mLayout.aspectCoef = mViewportAspectCoef;
+        mLayout.vertexCount = mRenderOp.vertexData->vertexCount;
+        mLayout.left = left;
+        mLayout.top = top;
+        mLayout.largestWidth = largestWidth;
 
         if (mMetricsMode == GMM_PIXELS)
         {
@@ -475,6 +555,35 @@ namespace Ogre {
         OverlayElement::setMaterialName(matName);
     }
     //---------------------------------------------------------------------
+    size_t TextAreaOverlayElement::_getBatchVertexCount(void)
+    {
+        if (!mInitialised || !mFont)
+            return 0;
+        return mRenderOp.vertexData->vertexCount;
+    }
+    //---------------------------------------------------------------------
+    void TextAreaOverlayElement::_writeBatchVertices(OverlayBatchVertex* dest)
+    {
+        RGBA topColour, bottomColour;
+        Root::getSingleton().convertColourValue(mColourTop, &topColour);
+        Root::getSingleton().convertColourValue(mColourBottom, &bottomColour);
+
+        const float* pSrc = &mBatchGeometry[0];
+        size_t vertexCount = mRenderOp.vertexData->vertexCount;
+        for (size_t i = 0; i < vertexCount; ++i, ++dest)
+        {
+            dest->x = *pSrc++;
+            dest->y = *pSrc++;
+            dest->z = *pSrc++;
+            dest->u = *pSrc++;
+            dest->v = *pSrc++;
+
+            // Same pattern as updateColours, top, bottom, top then top, bottom, bottom
+            size_t corner = i % 6;
+            dest->colour = (corner == 1 || corner == 4 || corner == 5) ? bottomColour : topColour;
+        }
+    }
+    //---------------------------------------------------------------------
     void TextAreaOverlayElement::addBaseParameters(void)
     {
         OverlayElement::addBaseParameters();
@@ -642,12 +751,17 @@ namespace Ogre {
             break;
         }
 
+        // Glyphs were evicted from the atlas of the font, so their coordinates may be stale
+        if (mFont && mLayout.glyphGeneration != mFont->_getGlyphAtlasGeneration())
+            mGeomPositionsOutOfDate = true;
+
         OverlayElement::_update();
 
         if (mColoursChanged && mInitialised)
         {
             updateColours();
             mColoursChanged = false;
+            mBatchGeometryOutOfDate = true;
         }
     }
     //---------------------------------------------------------------------------------------------
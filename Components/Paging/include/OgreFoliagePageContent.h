@@ -0,0 +1,281 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __Ogre_FoliagePageContent_H__
+#define __Ogre_FoliagePageContent_H__
+
+#include "OgrePagingPrerequisites.h"
+#include "OgrePageContent.h"
+#include "OgrePageContentFactory.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreResourceGroupManager.h"
+
+namespace Ogre
+{
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Paging
+    *  Some details on paging component
+    *  @{
+    */
+
+
+    /** Specialisation of PageContent which holds the foliage of a page, drawn
+        through hardware instancing.
+    @remarks
+        The foliage is split into layers (grass, bushes, rocks...) which are
+        defined once on the FoliagePageContentFactory. Each page only stores a
+        compact list of instances per layer, that is a position plus a quantised
+        yaw and scale. The instances are generated procedurally (see generate)
+        or read from the page stream, both of which happen in prepare and so
+        in the background through the WorkQueue. Loading then only creates the
+        InstancedEntity objects, with no geometry to build.
+    @par
+        All pages share one InstanceManager per layer, so the mesh of a layer
+        is only held once whatever the number of pages. The material of a layer
+        must therefore support hardware basic instancing.
+    @par
+        The instances are kept in random order, which lets the density fall off
+        with the distance of the camera to the page by hiding the tail of the
+        list; the remaining instances stay evenly spread over the page.
+    @par
+    The data format for this in a file is:<br/>
+    <b>FoliagePageContentData (Identifier 'FOLD')</b>\n
+    [Version 1]
+    <table>
+    <tr>
+    <td><b>Name</b></td>
+    <td><b>Type</b></td>
+    <td><b>Description</b></td>
+    </tr>
+    <tr>
+    <td>Number of layers</td>
+    <td>uint16</td>
+    <td>The number of layers which follow</td>
+    </tr>
+    <tr>
+    <td>Layer name</td>
+    <td>String</td>
+    <td>The name of the layer on the FoliagePageContentFactory</td>
+    </tr>
+    <tr>
+    <td>Number of instances</td>
+    <td>uint32</td>
+    <td>The number of instances in this layer (n)</td>
+    </tr>
+    <tr>
+    <td>Positions</td>
+    <td>float[n*3]</td>
+    <td>The world positions of the instances</td>
+    </tr>
+    <tr>
+    <td>Yaws</td>
+    <td>uint8[n]</td>
+    <td>The yaw of the instances, in 256ths of a full turn</td>
+    </tr>
+    <tr>
+    <td>Scales</td>
+    <td>uint8[n]</td>
+    <td>The scale of the instances, from the minimum (0) to the maximum (255) scale of the layer</td>
+    </tr>
+    </table>
+    The layer entries are repeated for each layer.
+    */
+    class _OgrePagingExport FoliagePageContent : public PageContent
+    {
+    public:
+        static const uint32 CHUNK_ID;
+        static const uint16 CHUNK_VERSION;
+
+        /// A single foliage instance
+        struct Instance
+        {
+            float position[3];
+            uint8 yaw;
+            uint8 scale;
+        };
+        typedef vector<Instance>::type InstanceList;
+
+        FoliagePageContent(FoliagePageContentFactory* creator);
+        ~FoliagePageContent();
+
+        /** Fill the page with random instances of every layer of the factory.
+        @remarks
+            The number of instances of a layer is its density times the area of
+            the page, the heights come from the height function of the factory.
+            This is meant to be called from PageProvider::prepareProceduralPage,
+            so it may run in the background.
+        @param bounds The world bounds of the page; the instances are placed
+            within its x/z extents, at the minimum height if the factory has
+            no height function
+        @param seed Seed of the placement, so that a page always gets the same
+            foliage
+        */
+        void generate(const AxisAlignedBox& bounds, uint32 seed);
+
+        /** Add a single instance to a layer.
+        @param layerName The name of the layer on the factory
+        @param position World position of the instance
+        @param yaw Rotation of the instance around the Y axis
+        @param scale Scale of the instance, clamped to the range of the layer
+        */
+        void addInstance(const String& layerName, const Vector3& position,
+            const Radian& yaw, Real scale);
+
+        /// Remove all the instances (only when unloaded)
+        void clearInstances();
+
+        /// Get the instances of a layer
+        const InstanceList& getInstances(const String& layerName) const;
+
+        /// Get the bounds of all the instances of the page
+        const AxisAlignedBox& getBounds() const { return mBounds; }
+
+        // Overridden from PageContent
+        void save(StreamSerialiser& stream);
+        void notifyCamera(Camera* cam);
+        bool prepare(StreamSerialiser& stream);
+        void load();
+        void unload();
+        void unprepare();
+
+    protected:
+        typedef map<String, InstanceList>::type LayerInstanceMap;
+        typedef vector<InstancedEntity*>::type EntityList;
+
+        /// The entities of a loaded layer, the first mVisibleCount of which are shown
+        struct LoadedLayer
+        {
+            const String* layerName;
+            EntityList entities;
+            size_t visibleCount;
+        };
+        typedef vector<LoadedLayer>::type LoadedLayerList;
+
+        FoliagePageContentFactory* mFoliageCreator;
+        LayerInstanceMap mInstances;
+        LoadedLayerList mLoadedLayers;
+        AxisAlignedBox mBounds;
+    };
+
+
+    /** Factory class for FoliagePageContent, which also holds the foliage layers.
+    @remarks
+        This factory is not registered by default; create one, add the layers
+        and register it with PageManager::addContentFactory before the pages
+        are prepared. The layers must not change while pages are prepared in
+        the background.
+    */
+    class _OgrePagingExport FoliagePageContentFactory : public PageContentFactory
+    {
+    public:
+        static String FACTORY_NAME;
+
+        /// The definition of a type of foliage, shared by all pages
+        struct Layer
+        {
+            /// Unique name of the layer
+            String name;
+            /// Mesh and material of the instances, the material must support HW basic instancing
+            String meshName;
+            String materialName;
+            String resourceGroup;
+            /// Number of instances per square world unit, for generate
+            Real density;
+            /// Range of the instance scales
+            Real minScale;
+            Real maxScale;
+            /// The distance at which the density starts falling off
+            Real fadeStartDistance;
+            /// The distance at which no instance is left
+            Real maxDistance;
+            /// Number of instances per batch of the shared InstanceManager
+            size_t instancesPerBatch;
+
+            Layer()
+                : resourceGroup(ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME)
+                , density(0.01f), minScale(1), maxScale(1)
+                , fadeStartDistance(100), maxDistance(200), instancesPerBatch(256) {}
+        };
+
+        /** Interface giving the ground height to generate, may be called in the
+            background.
+        */
+        class HeightFunction
+        {
+        public:
+            virtual ~HeightFunction() {}
+            /// Get the height of the ground at a world x/z position
+            virtual Real getHeightAt(Real x, Real z) = 0;
+        };
+
+        FoliagePageContentFactory() : mHeightFunction(0) {}
+        ~FoliagePageContentFactory() {}
+
+        const String& getName() const { return FACTORY_NAME; }
+
+        PageContent* createInstance()
+        {
+            return OGRE_NEW FoliagePageContent(this);
+        }
+        void destroyInstance(PageContent* c)
+        {
+            OGRE_DELETE c;
+        }
+
+        /// Add a layer, replacing any layer of the same name
+        void addLayer(const Layer& layer);
+        /// Get a layer by name, or 0 if there is none
+        const Layer* getLayer(const String& name) const;
+        /// Remove all the layers
+        void removeAllLayers() { mLayers.clear(); }
+
+        /// Set the height function used by FoliagePageContent::generate (not owned)
+        void setHeightFunction(HeightFunction* func) { mHeightFunction = func; }
+        HeightFunction* getHeightFunction() const { return mHeightFunction; }
+
+        typedef map<String, Layer>::type LayerMap;
+        /// Get all the layers
+        const LayerMap& getLayers() const { return mLayers; }
+
+        /** Get the InstanceManager shared by all the pages for a layer,
+            creating it in the SceneManager if needed.
+        */
+        InstanceManager* _getInstanceManager(SceneManager* sm, const Layer& layer);
+
+    protected:
+        LayerMap mLayers;
+        HeightFunction* mHeightFunction;
+    };
+
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -239,6 +239,11 @@ namespace Ogre
         void destroyData(PageStrategyData* d);
         void updateDebugDisplay(Page* p, SceneNode* sn);
         PageID getPageID(const Vector3& worldPos, PagedWorldSection* section);
+        bool getPageBounds(PageID pageID, PagedWorldSection* section, AxisAlignedBox& bounds);
+
+    protected:
+        /// For subclasses registering under their own name
+        Grid2DPageStrategy(const String& name, PageManager* manager);
     };
 
     /** @} */
@@ -58,6 +58,10 @@ namespace Ogre
         ContentCollectionList mContentCollections;
         uint16 mWorkQueueChannel;
         bool mDeferredProcessInProgress;
+        /// Whether the load in progress was requested to happen synchronously
+        bool mSynchronousLoad;
+        /// The prepare request in the WorkQueue, 0 if none
+        WorkQueue::RequestID mRequestID;
         bool mModified;
 
         SceneNode* mDebugNode;
@@ -67,6 +71,8 @@ namespace Ogre
         {
             ContentCollectionList collectionsToAdd;
         };
+        /// Data prepared in the background, waiting for PageManager to finalise it
+        PageData* mPreparedData;
         /// Structure for holding background page requests
         struct PageRequest
         {
@@ -91,6 +97,8 @@ namespace Ogre
         virtual bool prepareImpl(PageData* dataToPopulate);
         virtual bool prepareImpl(StreamSerialiser& str, PageData* dataToPopulate);
         virtual void loadImpl();
+        /// Drop any prepare request or prepared data of a load in progress
+        void cancelDeferredLoad();
 
         String generateFilename() const;
 
@@ -123,9 +131,19 @@ namespace Ogre
         virtual void touch();
 
         /** Load this page. 
+        @remarks
+            Unless synchronous, the load is queued with the PageManager, which
+            orders the background preparation of pages by their priority and
+            finalises them in the main thread within its time budget.
         @param synchronous Whether to force this to happen synchronously.
         */
         virtual void load(bool synchronous);
+        /// Send the background prepare request for a queued load, internal use by PageManager
+        void _requestPrepare();
+        /// Whether the background preparation has finished and the page waits to be finalised
+        bool _isPrepared() const { return mPreparedData != 0; }
+        /// Finish a load in the main thread once prepared, internal use by PageManager
+        void _finaliseLoad();
         /** Unload this page. 
         */
         virtual void unload();
@@ -432,6 +432,53 @@ namespace Ogre
         /** Get whether paging operations are currently allowed to happen. */
         bool getPagingOperationsEnabled() const { return mPagingEnabled; }
 
+        /** Set the maximum number of pages being prepared in the background at once.
+        @remarks
+            Pages requested beyond this wait in the manager, where they are
+            re-prioritised every frame by their distance to the closest camera;
+            pages outside the view of every camera come after the visible ones.
+            Pages which stop being held before their request is sent are dropped
+            without any work being done. 0 means no limit, which sends every
+            request to the WorkQueue as soon as it arrives. The default is 4.
+        */
+        void setMaxConcurrentPrepares(size_t count) { mMaxConcurrentPrepares = count; }
+        /** Get the maximum number of pages being prepared in the background at once. */
+        size_t getMaxConcurrentPrepares() const { return mMaxConcurrentPrepares; }
+
+        /** Set the time per frame the main thread may spend finalising pages.
+        @remarks
+            Prepared pages are finalised (Page::loadImpl, which for example
+            creates the GPU resources of their content) highest priority first,
+            until this budget is used up; the rest waits for the next frame. At
+            least one page is finalised per frame, however long it takes. 0 means
+            no limit, which is the default.
+        @param milliseconds The budget in milliseconds
+        */
+        void setPageLoadTimeBudget(Real milliseconds) { mPageLoadTimeBudget = milliseconds; }
+        /** Get the time per frame the main thread may spend finalising pages. */
+        Real getPageLoadTimeBudget() const { return mPageLoadTimeBudget; }
+
+        /** Get the number of page loads which haven't completed yet. */
+        size_t getPendingPageLoadCount() const
+        { return mPagesToPrepare.size() + mPagesPreparing.size() + mPagesToFinalise.size(); }
+
+        /** Get the loading priority of a page, lower values are loaded first.
+        @remarks
+            This is the squared distance between the page's bounds (see 
+            PageStrategy::getPageBounds) and the closest camera, multiplied for 
+            pages no camera can see.
+        */
+        virtual Real getPageLoadPriority(Page* page) const;
+
+        /// Queue a page to be prepared in the background, internal use by Page
+        void _queuePageLoad(Page* page);
+        /// Tell the manager the background preparation of a page finished, internal use by Page
+        void _notifyPagePrepared(Page* page);
+        /// Forget about a load in progress, internal use by Page
+        void _cancelPageLoad(Page* page);
+        /// Send prepare requests and finalise prepared pages, called once per frame
+        void _processPageLoads();
+
 
     protected:
 
@@ -469,7 +516,21 @@ namespace Ogre
 
         Grid2DPageStrategy* mGrid2DPageStrategy;
         Grid3DPageStrategy* mGrid3DPageStrategy;
+        PredictiveGrid2DPageStrategy* mPredictiveGrid2DPageStrategy;
         SimplePageContentCollectionFactory* mSimpleCollectionFactory;
+
+        typedef vector<Page*>::type PageList;
+        /// Pages waiting for their prepare request to be sent
+        PageList mPagesToPrepare;
+        /// Pages with a prepare request in the WorkQueue
+        PageList mPagesPreparing;
+        /// Prepared pages waiting to be finalised in the main thread
+        PageList mPagesToFinalise;
+        size_t mMaxConcurrentPrepares;
+        Real mPageLoadTimeBudget;
+
+        /// Sort pages by getPageLoadPriority, highest priority first
+        void sortByLoadPriority(PageList& pages) const;
     };
 
     /** @} */
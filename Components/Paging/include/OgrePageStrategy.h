@@ -129,6 +129,13 @@ namespace Ogre
         @return The page ID
         */
         virtual PageID getPageID(const Vector3& worldPos, PagedWorldSection* section) = 0;
+
+        /** Get the world space bounds of a page, used by PageManager to decide
+            which pages to load first.
+        @return false if this strategy can't tell, in which case the page gets
+            no particular priority
+        */
+        virtual bool getPageBounds(PageID pageID, PagedWorldSection* section, AxisAlignedBox& bounds) { return false; }
     };
 
     /*@}*/
@@ -97,6 +97,8 @@ namespace Ogre
 
         /// Get the name of this section
         virtual const String& getName() const { return mName; }
+        /// Get the number of pages this section currently has
+        virtual size_t getPageCount() const { return mPages.size(); }
         /// Get the page strategy which this section is using
         virtual PageStrategy* getStrategy() const { return mStrategy; }
         /** Change the page strategy.
@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 // Convenience header for user applications to reference all of the paging component
 
+#include "OgreFoliagePageContent.h"
 #include "OgreGrid2DPageStrategy.h"
 #include "OgrePage.h"
 #include "OgrePageConnection.h"
@@ -39,6 +40,7 @@ THE SOFTWARE.
 #include "OgrePagedWorldSection.h"
 #include "OgrePageManager.h"
 #include "OgrePageStrategy.h"
+#include "OgrePredictiveGrid2DPageStrategy.h"
 #include "OgreSimplePageContentCollection.h"
 
 
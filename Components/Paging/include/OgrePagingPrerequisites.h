@@ -34,6 +34,8 @@ THE SOFTWARE.
 namespace Ogre
 {
     // forward decls
+    class FoliagePageContent;
+    class FoliagePageContentFactory;
     class Grid2DPageStrategy;
     class Grid3DPageStrategy;
     class Page;
@@ -48,6 +50,7 @@ namespace Ogre
     class PageStrategy;
     class PageStrategyData;
     class PageProvider;
+    class PredictiveGrid2DPageStrategy;
     class SimplePageContentCollection;
     class SimplePageContentCollectionFactory;
 
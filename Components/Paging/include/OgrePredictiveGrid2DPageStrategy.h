@@ -0,0 +1,171 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __Ogre_PredictiveGrid2DPageStrategy_H__
+#define __Ogre_PredictiveGrid2DPageStrategy_H__
+
+#include "OgrePagingPrerequisites.h"
+#include "OgreGrid2DPageStrategy.h"
+
+namespace Ogre
+{
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Paging
+    *  Some details on paging component
+    * @{ */
+
+
+    /** Specialisation of Grid2DPageStrategyData for PredictiveGrid2DPageStrategy.
+    @remarks
+        Besides the grid, this holds how far ahead to predict the movement of
+        the cameras, the number of pages the section may have loaded before 
+        prefetching stops, and the motion tracked for every camera.
+    @par
+        The data format for this in a file is the Grid2DPageStrategyData chunk, 
+        followed by:<br/>
+        <b>PredictiveGrid2DPageStrategyData (Identifier 'PG2D')</b>\n
+        [Version 1]
+        <table>
+        <tr>
+            <td><b>Name</b></td>
+            <td><b>Type</b></td>
+            <td><b>Description</b></td>
+        </tr>
+        <tr>
+            <td>Look-ahead time</td>
+            <td>Real</td>
+            <td>How many seconds of camera movement to prefetch pages for</td>
+        </tr>
+        <tr>
+            <td>Page budget</td>
+            <td>uint32</td>
+            <td>Pages the section may hold before prefetching stops, 0 for no limit</td>
+        </tr>
+        </table>
+    */
+    class _OgrePagingExport PredictiveGrid2DPageStrategyData : public Grid2DPageStrategyData
+    {
+    public:
+        /// The movement of one camera, in grid space
+        struct CameraMotion
+        {
+            /// Position at the last update
+            Vector2 position;
+            /// Smoothed velocity
+            Vector2 velocity;
+            /// Smoothed rate of change of the heading, in radians per second
+            Real turnRate;
+            /// Value of the section's clock at the last update
+            Real lastUpdate;
+
+            CameraMotion() : position(Vector2::ZERO), velocity(Vector2::ZERO), turnRate(0), lastUpdate(-1) {}
+        };
+        typedef map<const Camera*, CameraMotion>::type CameraMotionMap;
+
+    protected:
+        Real mLookAheadTime;
+        uint32 mPageBudget;
+        /// Time advanced by frameStart, to measure the camera velocities
+        Real mTime;
+        CameraMotionMap mCameraMotion;
+
+    public:
+        static const uint32 CHUNK_ID;
+        static const uint16 CHUNK_VERSION;
+
+        PredictiveGrid2DPageStrategyData();
+        ~PredictiveGrid2DPageStrategyData();
+
+        /** Set how many seconds ahead to predict the movement of the cameras.
+        @remarks
+            Pages within the load radius of the predicted path are requested
+            before the camera gets there. 0 disables prefetching, which makes this
+            behave like Grid2DPageStrategy. The default is 2 seconds.
+        */
+        virtual void setLookAheadTime(Real seconds) { mLookAheadTime = seconds; }
+        /// Get how many seconds ahead the movement of the cameras is predicted
+        virtual Real getLookAheadTime() const { return mLookAheadTime; }
+        /** Set the number of pages the section may have before prefetching stops.
+        @remarks
+            This bounds the memory the prefetched pages use; the pages around the
+            cameras are always loaded regardless. 0 means no limit, which is the 
+            default.
+        */
+        virtual void setPageBudget(uint32 pages) { mPageBudget = pages; }
+        /// Get the number of pages the section may have before prefetching stops
+        virtual uint32 getPageBudget() const { return mPageBudget; }
+
+        /// Advance the clock used to measure velocities
+        void _advanceTime(Real seconds) { mTime += seconds; }
+        /** Measure the movement of a camera since its last update.
+        @return The motion of the camera, with the velocity reset when it 
+            jumped further than the hold radius
+        */
+        const CameraMotion& _updateCameraMotion(const Camera* cam, const Vector2& gridPos);
+
+        /// Load this data from a stream (returns true if successful)
+        bool load(StreamSerialiser& stream);
+        /// Save this data to a stream
+        void save(StreamSerialiser& stream);
+    };
+
+
+    /** Page strategy which extends Grid2DPageStrategy by prefetching pages 
+        along the predicted path of the cameras.
+    @remarks
+        The velocity and turn rate of each camera are measured and smoothed 
+        over successive frames, and the path is extrapolated for the look-ahead 
+        time of the section. Pages within the load radius of that path are 
+        requested in the order the camera is expected to reach them, until the 
+        section's page budget is used. Pages which are already loaded are held 
+        rather than unloaded as they leave the hold radius, as long as they 
+        remain on the path.
+    @par
+        Since PageManager loads the closest pages first, the prefetched pages
+        don't delay the ones the camera is in.
+    */
+    class _OgrePagingExport PredictiveGrid2DPageStrategy : public Grid2DPageStrategy
+    {
+    public:
+        PredictiveGrid2DPageStrategy(PageManager* manager);
+
+        ~PredictiveGrid2DPageStrategy();
+
+        // Overridden members
+        void frameStart(Real timeSinceLastFrame, PagedWorldSection* section);
+        void notifyCamera(Camera* cam, PagedWorldSection* section);
+        PageStrategyData* createData();
+    };
+
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -0,0 +1,342 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreFoliagePageContent.h"
+#include "OgreStreamSerialiser.h"
+#include "OgreSceneManager.h"
+#include "OgreInstanceManager.h"
+#include "OgreInstancedEntity.h"
+#include "OgreCamera.h"
+#include "OgreLogManager.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Small generator so that placements are repeatable and thread safe
+        class FoliageRandom
+        {
+        public:
+            FoliageRandom(uint32 seed) : mState(seed ? seed : 0x9E3779B9) {}
+
+            uint32 next()
+            {
+                mState ^= mState << 13;
+                mState ^= mState >> 17;
+                mState ^= mState << 5;
+                return mState;
+            }
+            /// Random value in [0, 1)
+            Real unit()
+            {
+                return (Real)(next() >> 8) / (Real)(1 << 24);
+            }
+        protected:
+            uint32 mState;
+        };
+
+        String getInstanceManagerName(const String& layerName)
+        {
+            return "FoliageLayer/" + layerName;
+        }
+    }
+    //---------------------------------------------------------------------
+    const uint32 FoliagePageContent::CHUNK_ID = StreamSerialiser::makeIdentifier("FOLD");
+    const uint16 FoliagePageContent::CHUNK_VERSION = 1;
+    //---------------------------------------------------------------------
+    FoliagePageContent::FoliagePageContent(FoliagePageContentFactory* creator)
+        : PageContent(creator), mFoliageCreator(creator)
+    {
+
+    }
+    //---------------------------------------------------------------------
+    FoliagePageContent::~FoliagePageContent()
+    {
+        unload();
+    }
+    //---------------------------------------------------------------------
+    void FoliagePageContent::generate(const AxisAlignedBox& bounds, uint32 seed)
+    {
+        clearInstances();
+
+        const Vector3& minimum = bounds.getMinimum();
+        Vector3 size = bounds.getSize();
+        Real area = size.x * size.z;
+        FoliagePageContentFactory::HeightFunction* heightFunc = mFoliageCreator->getHeightFunction();
+        FoliageRandom rnd(seed);
+
+        const FoliagePageContentFactory::LayerMap& layers = mFoliageCreator->getLayers();
+        for (FoliagePageContentFactory::LayerMap::const_iterator i = layers.begin(); i != layers.end(); ++i)
+        {
+            size_t count = static_cast<size_t>(i->second.density * area);
+            if (!count)
+                continue;
+
+            // Positions are uniformly random, so the list is already in random order
+            InstanceList& instances = mInstances[i->first];
+            instances.resize(count);
+            for (size_t n = 0; n < count; ++n)
+            {
+                Instance& inst = instances[n];
+                Real x = minimum.x + rnd.unit() * size.x;
+                Real z = minimum.z + rnd.unit() * size.z;
+                Real y = heightFunc ? heightFunc->getHeightAt(x, z) : minimum.y;
+                inst.position[0] = (float)x;
+                inst.position[1] = (float)y;
+                inst.position[2] = (float)z;
+                inst.yaw = static_cast<uint8>(rnd.next() >> 24);
+                inst.scale = static_cast<uint8>(rnd.next() >> 24);
+                mBounds.merge(Vector3(x, y, z));
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void FoliagePageContent::addInstance(const String& layerName, const Vector3& position,
+        const Radian& yaw, Real scale)
+    {
+        const FoliagePageContentFactory::Layer* layer = mFoliageCreator->getLayer(layerName);
+        if (!layer)
+        {
+            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND,
+                layerName + " is not the name of a foliage layer",
+                "FoliagePageContent::addInstance");
+        }
+
+        Real turns = yaw.valueRadians() / Math::TWO_PI;
+        turns -= Math::Floor(turns);
+        Real scaleRange = layer->maxScale - layer->minScale;
+        Real scaleFactor = scaleRange > 0 ? (scale - layer->minScale) / scaleRange : 0;
+
+        Instance inst;
+        inst.position[0] = (float)position.x;
+        inst.position[1] = (float)position.y;
+        inst.position[2] = (float)position.z;
+        inst.yaw = static_cast<uint8>(std::min(turns * 256, (Real)255));
+        inst.scale = static_cast<uint8>(Math::Clamp(scaleFactor, (Real)0, (Real)1) * 255);
+
+        // Keep the list in random order, as the density falls off from its tail
+        InstanceList& instances = mInstances[layerName];
+        instances.push_back(inst);
+        size_t slot = std::min(static_cast<size_t>(Math::UnitRandom() * instances.size()), instances.size() - 1);
+        std::swap(instances.back(), instances[slot]);
+        mBounds.merge(position);
+    }
+    //---------------------------------------------------------------------
+    void FoliagePageContent::clearInstances()
+    {
+        mInstances.clear();
+        mBounds.setNull();
+    }
+    //---------------------------------------------------------------------
+    const FoliagePageContent::InstanceList& FoliagePageContent::getInstances(const String& layerName) const
+    {
+        static const InstanceList emptyList;
+        LayerInstanceMap::const_iterator i = mInstances.find(layerName);
+        return i != mInstances.end() ? i->second : emptyList;
+    }
+    //---------------------------------------------------------------------
+    void FoliagePageContent::save(StreamSerialiser& stream)
+    {
+        stream.writeChunkBegin(CHUNK_ID, CHUNK_VERSION);
+
+        uint16 layerCount = static_cast<uint16>(mInstances.size());
+        stream.write(&layerCount);
+        for (LayerInstanceMap::iterator i = mInstances.begin(); i != mInstances.end(); ++i)
+        {
+            const InstanceList& instances = i->second;
+            uint32 count = static_cast<uint32>(instances.size());
+            stream.write(&i->first);
+            stream.write(&count);
+
+            for (uint32 n = 0; n < count; ++n)
+                stream.write(instances[n].position, 3);
+            for (uint32 n = 0; n < count; ++n)
+                stream.write(&instances[n].yaw);
+            for (uint32 n = 0; n < count; ++n)
+                stream.write(&instances[n].scale);
+        }
+
+        stream.writeChunkEnd(CHUNK_ID);
+    }
+    //---------------------------------------------------------------------
+    bool FoliagePageContent::prepare(StreamSerialiser& stream)
+    {
+        if (!stream.readChunkBegin(CHUNK_ID, CHUNK_VERSION, "FoliagePageContent"))
+            return false;
+
+        clearInstances();
+
+        uint16 layerCount;
+        stream.read(&layerCount);
+        for (uint16 l = 0; l < layerCount; ++l)
+        {
+            String layerName;
+            uint32 count;
+            stream.read(&layerName);
+            stream.read(&count);
+
+            InstanceList& instances = mInstances[layerName];
+            instances.resize(count);
+            for (uint32 n = 0; n < count; ++n)
+            {
+                Instance& inst = instances[n];
+                stream.read(inst.position, 3);
+                mBounds.merge(Vector3(inst.position[0], inst.position[1], inst.position[2]));
+            }
+            for (uint32 n = 0; n < count; ++n)
+                stream.read(&instances[n].yaw);
+            for (uint32 n = 0; n < count; ++n)
+                stream.read(&instances[n].scale);
+        }
+
+        stream.readChunkEnd(CHUNK_ID);
+
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void FoliagePageContent::load()
+    {
+        unload();
+
+        SceneManager* sm = getSceneManager();
+        for (LayerInstanceMap::iterator i = mInstances.begin(); i != mInstances.end(); ++i)
+        {
+            const FoliagePageContentFactory::Layer* layer = mFoliageCreator->getLayer(i->first);
+            if (!layer)
+            {
+                LogManager::getSingleton().logMessage("FoliagePageContent: skipping unknown layer " +
+                    i->first, LML_CRITICAL);
+                continue;
+            }
+
+            InstanceManager* mgr = mFoliageCreator->_getInstanceManager(sm, *layer);
+            const InstanceList& instances = i->second;
+
+            mLoadedLayers.push_back(LoadedLayer());
+            LoadedLayer& loaded = mLoadedLayers.back();
+            loaded.layerName = &i->first;
+            loaded.entities.reserve(instances.size());
+            loaded.visibleCount = instances.size();
+
+            Real scaleRange = layer->maxScale - layer->minScale;
+            for (InstanceList::const_iterator n = instances.begin(); n != instances.end(); ++n)
+            {
+                InstancedEntity* ent = mgr->createInstancedEntity(layer->materialName);
+                if (!ent)
+                    break;
+
+                Real scale = layer->minScale + scaleRange * (n->scale / (Real)255);
+                ent->setPosition(Vector3(n->position[0], n->position[1], n->position[2]), false);
+                ent->setOrientation(Quaternion(Radian(n->yaw * Math::TWO_PI / 256), Vector3::UNIT_Y), false);
+                ent->setScale(Vector3(scale, scale, scale));
+                loaded.entities.push_back(ent);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void FoliagePageContent::unload()
+    {
+        if (mLoadedLayers.empty())
+            return;
+
+        SceneManager* sm = getSceneManager();
+        for (LoadedLayerList::iterator i = mLoadedLayers.begin(); i != mLoadedLayers.end(); ++i)
+        {
+            for (EntityList::iterator e = i->entities.begin(); e != i->entities.end(); ++e)
+                sm->destroyInstancedEntity(*e);
+        }
+        mLoadedLayers.clear();
+    }
+    //---------------------------------------------------------------------
+    void FoliagePageContent::unprepare()
+    {
+        clearInstances();
+    }
+    //---------------------------------------------------------------------
+    void FoliagePageContent::notifyCamera(Camera* cam)
+    {
+        if (mLoadedLayers.empty() || mBounds.isNull())
+            return;
+
+        Real distance = mBounds.distance(cam->getDerivedPosition());
+        if (Real lodBias = cam->getLodBias())
+            distance /= lodBias;
+
+        for (LoadedLayerList::iterator i = mLoadedLayers.begin(); i != mLoadedLayers.end(); ++i)
+        {
+            const FoliagePageContentFactory::Layer* layer = mFoliageCreator->getLayer(*i->layerName);
+            if (!layer)
+                continue;
+
+            // Thin out linearly between the fade start and the maximum distance
+            Real fadeRange = layer->maxDistance - layer->fadeStartDistance;
+            Real density = fadeRange > 0 ?
+                (layer->maxDistance - distance) / fadeRange :
+                (distance < layer->maxDistance ? 1 : 0);
+            density = Math::Clamp(density, (Real)0, (Real)1);
+
+            EntityList& entities = i->entities;
+            size_t visibleCount = static_cast<size_t>(density * entities.size());
+            if (visibleCount == i->visibleCount)
+                continue;
+
+            // Only the instances whose state changes are touched
+            for (size_t n = std::min(visibleCount, i->visibleCount);
+                n < std::max(visibleCount, i->visibleCount); ++n)
+            {
+                entities[n]->setVisible(n < visibleCount);
+            }
+            i->visibleCount = visibleCount;
+        }
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    String FoliagePageContentFactory::FACTORY_NAME = "Foliage";
+    //---------------------------------------------------------------------
+    void FoliagePageContentFactory::addLayer(const Layer& layer)
+    {
+        mLayers[layer.name] = layer;
+    }
+    //---------------------------------------------------------------------
+    const FoliagePageContentFactory::Layer* FoliagePageContentFactory::getLayer(const String& name) const
+    {
+        LayerMap::const_iterator i = mLayers.find(name);
+        return i != mLayers.end() ? &i->second : 0;
+    }
+    //---------------------------------------------------------------------
+    InstanceManager* FoliagePageContentFactory::_getInstanceManager(SceneManager* sm, const Layer& layer)
+    {
+        // Looked up every time rather than cached, since the SceneManager owns it
+        String name = getInstanceManagerName(layer.name);
+        if (sm->hasInstanceManager(name))
+            return sm->getInstanceManager(name);
+
+        return sm->createInstanceManager(name, layer.meshName, layer.resourceGroup,
+            InstanceManager::HWInstancingBasic, layer.instancesPerBatch);
+    }
+
+}
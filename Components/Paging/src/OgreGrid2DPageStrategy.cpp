@@ -283,6 +283,12 @@ namespace Ogre
         : PageStrategy("Grid2D", manager)
     {
 
+    }
+    //---------------------------------------------------------------------
+    Grid2DPageStrategy::Grid2DPageStrategy(const String& name, PageManager* manager)
+        : PageStrategy(name, manager)
+    {
+
     }
     //---------------------------------------------------------------------
     Grid2DPageStrategy::~Grid2DPageStrategy()
@@ -451,6 +457,31 @@ namespace Ogre
         return stratData->calculatePageID(x, y);
         
     }
+    //---------------------------------------------------------------------
+    bool Grid2DPageStrategy::getPageBounds(PageID pageID, PagedWorldSection* section, AxisAlignedBox& bounds)
+    {
+        Grid2DPageStrategyData* stratData = static_cast<Grid2DPageStrategyData*>(section->getStrategyData());
+
+        int32 x, y;
+        stratData->calculateCell(pageID, &x, &y);
+        Vector2 gridCorners[4];
+        stratData->getCornersGridSpace(x, y, gridCorners);
+
+        // The grid doesn't know about the 3rd dimension, take it from the section if possible
+        const AxisAlignedBox& sectionBounds = section->getBoundingBox();
+        bool useSection = sectionBounds.isFinite();
+        bounds.setNull();
+        for (int i = 0; i < 4; ++i)
+        {
+            Vector3 worldMin = useSection ? sectionBounds.getMinimum() : Vector3::ZERO;
+            Vector3 worldMax = useSection ? sectionBounds.getMaximum() : Vector3::ZERO;
+            stratData->convertGridToWorldSpace(gridCorners[i], worldMin);
+            stratData->convertGridToWorldSpace(gridCorners[i], worldMax);
+            bounds.merge(worldMin);
+            bounds.merge(worldMax);
+        }
+        return true;
+    }
 
 
 }
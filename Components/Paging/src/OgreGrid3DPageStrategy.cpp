@@ -419,4 +419,16 @@ namespace Ogre
         stratData->determineGridLocation(pos, &x, &y, &z);
         return stratData->calculatePageID(x, y, z);
     }
+    //---------------------------------------------------------------------
+    bool Grid3DPageStrategy::getPageBounds(PageID pageID, PagedWorldSection* section, AxisAlignedBox& bounds)
+    {
+        Grid3DPageStrategyData* stratData = static_cast<Grid3DPageStrategyData*>(section->getStrategyData());
+
+        int32 x, y, z;
+        stratData->calculateCell(pageID, &x, &y, &z);
+        Vector3 bottomLeft;
+        stratData->getBottomLeftGridSpace(x, y, z, bottomLeft);
+        bounds.setExtents(bottomLeft, bottomLeft + stratData->getCellSize());
+        return true;
+    }
 }
@@ -57,8 +57,11 @@ namespace Ogre
         : mID(pageID)
         , mParent(parent)
         , mDeferredProcessInProgress(false)
+        , mSynchronousLoad(false)
+        , mRequestID(0)
         , mModified(false)
         , mDebugNode(0)
+        , mPreparedData(0)
     {
         WorkQueue* wq = Root::getSingleton().getWorkQueue();
         mWorkQueueChannel = wq->getChannel("Ogre/Page");
@@ -73,6 +76,7 @@ namespace Ogre
         wq->removeRequestHandler(mWorkQueueChannel, this);
         wq->removeResponseHandler(mWorkQueueChannel, this);
 
+        cancelDeferredLoad();
         destroyAllContentCollections();
         if (mDebugNode)
         {
@@ -92,7 +96,7 @@ namespace Ogre
         for (ContentCollectionList::iterator i = mContentCollections.begin(); 
             i != mContentCollections.end(); ++i)
         {
-            delete *i;
+            getManager()->destroyContentCollection(*i);
         }
         mContentCollections.clear();
     }
@@ -186,16 +190,66 @@ namespace Ogre
         if (!mDeferredProcessInProgress)
         {
             destroyAllContentCollections();
-            PageRequest req(this);
             mDeferredProcessInProgress = true;
-            Root::getSingleton().getWorkQueue()->addRequest(mWorkQueueChannel, WORKQUEUE_PREPARE_REQUEST, 
-                Any(req), 0, synchronous);
+            mSynchronousLoad = synchronous;
+            if (synchronous)
+                _requestPrepare();
+            else
+                getManager()->_queuePageLoad(this);
         }
 
     }
     //---------------------------------------------------------------------
+    void Page::_requestPrepare()
+    {
+        PageRequest req(this);
+        mRequestID = Root::getSingleton().getWorkQueue()->addRequest(mWorkQueueChannel, 
+            WORKQUEUE_PREPARE_REQUEST, Any(req), 0, mSynchronousLoad);
+    }
+    //---------------------------------------------------------------------
+    void Page::_finaliseLoad()
+    {
+        if (!mPreparedData)
+            return;
+
+        if(!mPreparedData->collectionsToAdd.empty())
+            std::swap(mContentCollections, mPreparedData->collectionsToAdd);
+
+        loadImpl();
+
+        OGRE_DELETE mPreparedData;
+        mPreparedData = 0;
+
+        mDeferredProcessInProgress = false;
+    }
+    //---------------------------------------------------------------------
+    void Page::cancelDeferredLoad()
+    {
+        if (!mDeferredProcessInProgress)
+            return;
+
+        getManager()->_cancelPageLoad(this);
+        if (mRequestID)
+        {
+            Root::getSingleton().getWorkQueue()->abortRequest(mRequestID);
+            mRequestID = 0;
+        }
+        if (mPreparedData)
+        {
+            for (ContentCollectionList::iterator i = mPreparedData->collectionsToAdd.begin(); 
+                i != mPreparedData->collectionsToAdd.end(); ++i)
+            {
+                getManager()->destroyContentCollection(*i);
+            }
+            OGRE_DELETE mPreparedData;
+            mPreparedData = 0;
+        }
+        mDeferredProcessInProgress = false;
+    }
+    //---------------------------------------------------------------------
     void Page::unload()
     {
+        cancelDeferredLoad();
         destroyAllContentCollections();
     }
     //---------------------------------------------------------------------
@@ -260,18 +314,25 @@ namespace Ogre
         if (preq.srcPage!= this)
             return;
 
+        mRequestID = 0;
+
         // final loading behaviour
         if (res->succeeded())
         {
-            if(!pres.pageData->collectionsToAdd.empty())
-                std::swap(mContentCollections, pres.pageData->collectionsToAdd);
-
-            loadImpl();
+            mPreparedData = pres.pageData;
+            // the main thread work is spread over frames by the manager
+            if (mSynchronousLoad)
+                _finaliseLoad();
+            else
+                getManager()->_notifyPagePrepared(this);
+        }
+        else
+        {
+            OGRE_DELETE pres.pageData;
+            if (!mSynchronousLoad)
+                getManager()->_notifyPagePrepared(this);
+            mDeferredProcessInProgress = false;
         }
-
-        OGRE_DELETE pres.pageData;
-
-        mDeferredProcessInProgress = false;
 
     }
     //---------------------------------------------------------------------
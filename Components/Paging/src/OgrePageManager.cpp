@@ -34,10 +34,14 @@ THE SOFTWARE.
 #include "OgrePagedWorld.h"
 #include "OgreGrid2DPageStrategy.h"
 #include "OgreGrid3DPageStrategy.h"
+#include "OgrePredictiveGrid2DPageStrategy.h"
 #include "OgreSimplePageContentCollection.h"
 #include "OgreStreamSerialiser.h"
 #include "OgreRoot.h"
 #include "OgrePageContent.h"
+#include "OgrePage.h"
+#include "OgrePageStrategy.h"
+#include "OgreTimer.h"
 
 namespace Ogre
 {
@@ -50,7 +54,10 @@ namespace Ogre
         , mPagingEnabled(true)
         , mGrid2DPageStrategy(0)
         , mGrid3DPageStrategy(0)
+        , mPredictiveGrid2DPageStrategy(0)
         , mSimpleCollectionFactory(0)
+        , mMaxConcurrentPrepares(4)
+        , mPageLoadTimeBudget(0)
     {
 
         mEventRouter.pManager = this;
@@ -68,6 +75,7 @@ namespace Ogre
     {
         Root::getSingleton().removeFrameListener(&mEventRouter);
 
+        OGRE_DELETE mPredictiveGrid2DPageStrategy;
         OGRE_DELETE mGrid3DPageStrategy;
         OGRE_DELETE mGrid2DPageStrategy;
         OGRE_DELETE mSimpleCollectionFactory;
@@ -80,6 +88,9 @@ namespace Ogre
 
         mGrid3DPageStrategy = OGRE_NEW Grid3DPageStrategy(this);
         addStrategy(mGrid3DPageStrategy);
+
+        mPredictiveGrid2DPageStrategy = OGRE_NEW PredictiveGrid2DPageStrategy(this);
+        addStrategy(mPredictiveGrid2DPageStrategy);
     }
     //---------------------------------------------------------------------
     void PageManager::createStandardContentFactories()
@@ -500,6 +511,121 @@ namespace Ogre
         return mCameraList;
     }
     //---------------------------------------------------------------------
+    Real PageManager::getPageLoadPriority(Page* page) const
+    {
+        // Pages outside the view come after visible ones up to twice as far away
+        const Real hiddenScale = 4;
+
+        AxisAlignedBox bounds;
+        PagedWorldSection* section = page->getParentSection();
+        if (mCameraList.empty() || !section->getStrategy() ||
+            !section->getStrategy()->getPageBounds(page->getID(), section, bounds))
+            return 0;
+
+        Real priority = std::numeric_limits<Real>::max();
+        for (CameraList::const_iterator c = mCameraList.begin(); c != mCameraList.end(); ++c)
+        {
+            Real dist = bounds.squaredDistance((*c)->getDerivedPosition());
+            if (!(*c)->isVisible(bounds))
+                dist *= hiddenScale;
+            priority = std::min(priority, dist);
+        }
+        return priority;
+    }
+    //---------------------------------------------------------------------
+    static bool lessPriority(const std::pair<Real, Page*>& a, const std::pair<Real, Page*>& b)
+    {
+        return a.first < b.first;
+    }
+    //---------------------------------------------------------------------
+    void PageManager::sortByLoadPriority(PageList& pages) const
+    {
+        if (pages.size() < 2)
+            return;
+
+        typedef vector<std::pair<Real, Page*> >::type PriorityList;
+        PriorityList priorities;
+        priorities.reserve(pages.size());
+        for (PageList::iterator i = pages.begin(); i != pages.end(); ++i)
+            priorities.push_back(std::make_pair(getPageLoadPriority(*i), *i));
+
+        // stable, so that pages of equal priority keep the order they were requested in
+        std::stable_sort(priorities.begin(), priorities.end(), lessPriority);
+
+        for (size_t i = 0; i < pages.size(); ++i)
+            pages[i] = priorities[i].second;
+    }
+    //---------------------------------------------------------------------
+    void PageManager::_queuePageLoad(Page* page)
+    {
+        mPagesToPrepare.push_back(page);
+    }
+    //---------------------------------------------------------------------
+    void PageManager::_notifyPagePrepared(Page* page)
+    {
+        PageList::iterator i = std::find(mPagesPreparing.begin(), mPagesPreparing.end(), page);
+        if (i != mPagesPreparing.end())
+            mPagesPreparing.erase(i);
+
+        if (page->_isPrepared())
+            mPagesToFinalise.push_back(page);
+    }
+    //---------------------------------------------------------------------
+    void PageManager::_cancelPageLoad(Page* page)
+    {
+        PageList* lists[] = { &mPagesToPrepare, &mPagesPreparing, &mPagesToFinalise };
+        for (size_t l = 0; l < 3; ++l)
+        {
+            PageList::iterator i = std::find(lists[l]->begin(), lists[l]->end(), page);
+            if (i != lists[l]->end())
+                lists[l]->erase(i);
+        }
+    }
+    //---------------------------------------------------------------------
+    void PageManager::_processPageLoads()
+    {
+        // Requests waiting for a free slot are re-prioritised as the cameras move
+        if (!mPagesToPrepare.empty())
+        {
+            sortByLoadPriority(mPagesToPrepare);
+            size_t count = mPagesToPrepare.size();
+            if (mMaxConcurrentPrepares)
+            {
+                size_t freeSlots = mMaxConcurrentPrepares > mPagesPreparing.size() ?
+                    mMaxConcurrentPrepares - mPagesPreparing.size() : 0;
+                count = std::min(count, freeSlots);
+            }
+
+            PageList toSend(mPagesToPrepare.begin(), mPagesToPrepare.begin() + count);
+            mPagesToPrepare.erase(mPagesToPrepare.begin(), mPagesToPrepare.begin() + count);
+            for (PageList::iterator i = toSend.begin(); i != toSend.end(); ++i)
+            {
+                mPagesPreparing.push_back(*i);
+                (*i)->_requestPrepare();
+            }
+        }
+
+        if (mPagesToFinalise.empty())
+            return;
+
+        sortByLoadPriority(mPagesToFinalise);
+        Timer* timer = Root::getSingleton().getTimer();
+        unsigned long start = timer->getMicroseconds();
+        unsigned long budget = (unsigned long)(mPageLoadTimeBudget * 1000);
+        size_t done = 0;
+        // loadImpl may queue or cancel other loads, so take each page off the list first
+        while (!mPagesToFinalise.empty())
+        {
+            if (done && budget && timer->getMicroseconds() - start >= budget)
+                break;
+
+            Page* page = mPagesToFinalise.front();
+            mPagesToFinalise.erase(mPagesToFinalise.begin());
+            page->_finaliseLoad();
+            ++done;
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     void PageManager::EventRouter::cameraPreRenderScene(Camera* cam)
     {
@@ -528,6 +654,8 @@ namespace Ogre
             }
         }
 
+        pManager->_processPageLoads();
+
         return true;
     }
     //---------------------------------------------------------------------
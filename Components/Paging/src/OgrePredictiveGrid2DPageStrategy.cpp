@@ -0,0 +1,228 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgrePredictiveGrid2DPageStrategy.h"
+#include "OgreStreamSerialiser.h"
+#include "OgreCamera.h"
+#include "OgrePagedWorldSection.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Time over which the measured velocity settles
+        const Real VELOCITY_SMOOTHING_TIME = 0.25f;
+        /// Slower cameras aren't extrapolated, in cells per second
+        const Real MIN_PREDICTED_SPEED = 0.05f;
+    }
+    //---------------------------------------------------------------------
+    const uint32 PredictiveGrid2DPageStrategyData::CHUNK_ID = StreamSerialiser::makeIdentifier("PG2D");
+    const uint16 PredictiveGrid2DPageStrategyData::CHUNK_VERSION = 1;
+    //---------------------------------------------------------------------
+    PredictiveGrid2DPageStrategyData::PredictiveGrid2DPageStrategyData()
+        : Grid2DPageStrategyData()
+        , mLookAheadTime(2)
+        , mPageBudget(0)
+        , mTime(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    PredictiveGrid2DPageStrategyData::~PredictiveGrid2DPageStrategyData()
+    {
+    }
+    //---------------------------------------------------------------------
+    const PredictiveGrid2DPageStrategyData::CameraMotion& 
+    PredictiveGrid2DPageStrategyData::_updateCameraMotion(const Camera* cam, const Vector2& gridPos)
+    {
+        CameraMotion& motion = mCameraMotion[cam];
+        Real dt = mTime - motion.lastUpdate;
+        if (motion.lastUpdate < 0)
+        {
+            motion.position = gridPos;
+            motion.lastUpdate = mTime;
+            return motion;
+        }
+        // notified more than once in a frame
+        if (dt <= 0)
+            return motion;
+
+        Vector2 moved = gridPos - motion.position;
+        motion.position = gridPos;
+        motion.lastUpdate = mTime;
+        if (moved.length() > mHoldRadius)
+        {
+            // teleported, nothing to extrapolate from
+            motion.velocity = Vector2::ZERO;
+            motion.turnRate = 0;
+            return motion;
+        }
+
+        Vector2 measured = moved / dt;
+        Real blend = 1 - Math::Exp(-dt / VELOCITY_SMOOTHING_TIME);
+        Real minSpeed = MIN_PREDICTED_SPEED * mCellSize;
+        if (motion.velocity.length() > minSpeed && measured.length() > minSpeed)
+        {
+            // signed angle between the old and new heading
+            Real turned = Math::ATan2(motion.velocity.crossProduct(measured), 
+                motion.velocity.dotProduct(measured)).valueRadians();
+            motion.turnRate += (turned / dt - motion.turnRate) * blend;
+        }
+        else
+            motion.turnRate = 0;
+        motion.velocity += (measured - motion.velocity) * blend;
+
+        return motion;
+    }
+    //---------------------------------------------------------------------
+    bool PredictiveGrid2DPageStrategyData::load(StreamSerialiser& ser)
+    {
+        if (!Grid2DPageStrategyData::load(ser))
+            return false;
+
+        // absent when the section was saved with the plain 2D grid
+        if (ser.peekNextChunkID() == CHUNK_ID)
+        {
+            if (!ser.readChunkBegin(CHUNK_ID, CHUNK_VERSION, "PredictiveGrid2DPageStrategyData"))
+                return false;
+
+            ser.read(&mLookAheadTime);
+            ser.read(&mPageBudget);
+
+            ser.readChunkEnd(CHUNK_ID);
+        }
+
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void PredictiveGrid2DPageStrategyData::save(StreamSerialiser& ser)
+    {
+        Grid2DPageStrategyData::save(ser);
+
+        ser.writeChunkBegin(CHUNK_ID, CHUNK_VERSION);
+        ser.write(&mLookAheadTime);
+        ser.write(&mPageBudget);
+        ser.writeChunkEnd(CHUNK_ID);
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    PredictiveGrid2DPageStrategy::PredictiveGrid2DPageStrategy(PageManager* manager)
+        : Grid2DPageStrategy("PredictiveGrid2D", manager)
+    {
+
+    }
+    //---------------------------------------------------------------------
+    PredictiveGrid2DPageStrategy::~PredictiveGrid2DPageStrategy()
+    {
+
+    }
+    //---------------------------------------------------------------------
+    void PredictiveGrid2DPageStrategy::frameStart(Real timeSinceLastFrame, PagedWorldSection* section)
+    {
+        PredictiveGrid2DPageStrategyData* stratData = 
+            static_cast<PredictiveGrid2DPageStrategyData*>(section->getStrategyData());
+        stratData->_advanceTime(timeSinceLastFrame);
+    }
+    //---------------------------------------------------------------------
+    void PredictiveGrid2DPageStrategy::notifyCamera(Camera* cam, PagedWorldSection* section)
+    {
+        // the pages around the camera come first
+        Grid2DPageStrategy::notifyCamera(cam, section);
+
+        PredictiveGrid2DPageStrategyData* stratData = 
+            static_cast<PredictiveGrid2DPageStrategyData*>(section->getStrategyData());
+
+        Vector2 gridpos;
+        stratData->convertWorldToGridSpace(cam->getDerivedPosition(), gridpos);
+        const PredictiveGrid2DPageStrategyData::CameraMotion& motion = 
+            stratData->_updateCameraMotion(cam, gridpos);
+
+        Real lookAhead = stratData->getLookAheadTime();
+        Real speed = motion.velocity.length();
+        Real cellSize = stratData->getCellSize();
+        if (lookAhead <= 0 || speed < MIN_PREDICTED_SPEED * cellSize)
+            return;
+
+        uint32 budget = stratData->getPageBudget();
+        size_t pageCount = section->getPageCount();
+        if (budget && pageCount >= budget)
+            return;
+
+        Real loadRadius = stratData->getLoadRadiusInCells();
+        int32 minX = stratData->getCellRangeMinX();
+        int32 maxX = stratData->getCellRangeMaxX();
+        int32 minY = stratData->getCellRangeMinY();
+        int32 maxY = stratData->getCellRangeMaxY();
+
+        // half a cell per step, so that no cell along the path is skipped
+        Real step = std::min(lookAhead, cellSize * 0.5f / speed);
+        Real heading = Math::ATan2(motion.velocity.y, motion.velocity.x).valueRadians();
+        Vector2 pos = gridpos;
+        int32 lastX = 0, lastY = 0;
+        bool first = true;
+        for (Real t = step; t <= lookAhead + 1e-4f; t += step)
+        {
+            heading += motion.turnRate * step;
+            pos += Vector2(Math::Cos(heading), Math::Sin(heading)) * (speed * step);
+
+            int32 x, y;
+            stratData->determineGridLocation(pos, &x, &y);
+            if (!first && x == lastX && y == lastY)
+                continue;
+            first = false;
+            lastX = x;
+            lastY = y;
+
+            int32 xmin = std::max(minX, (int32)Math::Floor(x - loadRadius));
+            int32 xmax = std::min(maxX, (int32)Math::Ceil(x + loadRadius));
+            int32 ymin = std::max(minY, (int32)Math::Floor(y - loadRadius));
+            int32 ymax = std::min(maxY, (int32)Math::Ceil(y + loadRadius));
+            for (int32 cy = ymin; cy <= ymax; ++cy)
+            {
+                for (int32 cx = xmin; cx <= xmax; ++cx)
+                {
+                    PageID pageID = stratData->calculatePageID(cx, cy);
+                    if (section->getPage(pageID))
+                    {
+                        // still on the path, don't let it go
+                        section->holdPage(pageID);
+                    }
+                    else if (!budget || pageCount < budget)
+                    {
+                        section->loadPage(pageID);
+                        ++pageCount;
+                    }
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    PageStrategyData* PredictiveGrid2DPageStrategy::createData()
+    {
+        return OGRE_NEW PredictiveGrid2DPageStrategyData();
+    }
+
+}
@@ -41,6 +41,8 @@ THE SOFTWARE.
 #include "OgreShaderExIntegratedPSSM3.h"
 #include "OgreShaderExLayeredBlending.h"
 #include "OgreShaderExHardwareSkinning.h"
+#include "OgreShaderExClusteredLighting.h"
+#include "OgreShaderExLodMorph.h"
 #include "OgreShaderMaterialSerializerListener.h"
 
 /** \addtogroup Optional
@@ -0,0 +1,177 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _ShaderExClusteredLighting_
+#define _ShaderExClusteredLighting_
+
+#include "OgreShaderPrerequisites.h"
+#ifdef RTSHADER_SYSTEM_BUILD_EXT_SHADERS
+#include "OgreShaderSubRenderState.h"
+
+namespace Ogre {
+namespace RTShader {
+
+/** \addtogroup Optional
+*  @{
+*/
+/** \addtogroup RTShader
+*  @{
+*/
+
+#define SGX_LIB_CLUSTEREDLIGHTING                   "SGXLib_ClusteredLighting"
+#define SGX_FUNC_LIGHT_CLUSTERED                    "SGX_Light_Clustered"
+
+/** Clustered forward lighting extension sub render state implementation.
+Derives from SubRenderState class.
+@remarks
+    Shades every light of the fragment's cluster in a single pass, reading
+    the clusters and lights from the texture of the LightClusters of the
+    active scene manager, see SceneManager::setLightClustering. Unlike
+    PerPixelLighting the generated programs do not depend on the light
+    count, so all objects share them no matter how many lights are around.
+    Vertex colour tracking is not supported and neither are HLSL 4 and
+    GLSL ES.
+    Enabled with 'lighting_stage clustered'.
+*/
+class _OgreRTSSExport ClusteredLighting : public SubRenderState
+{
+public:
+    ClusteredLighting();
+
+    /** 
+    @see SubRenderState::getType.
+    */
+    virtual const String& getType() const;
+
+    /** 
+    @see SubRenderState::getExecutionOrder.
+    */
+    virtual int getExecutionOrder() const;
+
+    /** 
+    @see SubRenderState::updateGpuProgramsParams.
+    */
+    virtual void updateGpuProgramsParams(Renderable* rend, Pass* pass, const AutoParamDataSource* source, const LightList* pLightList);
+
+    /** 
+    @see SubRenderState::copyFrom.
+    */
+    virtual void copyFrom(const SubRenderState& rhs);
+
+    /** 
+    @see SubRenderState::preAddToRenderState.
+    */
+    virtual bool preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass);
+
+    static String Type;
+
+protected:
+    /** 
+    @see SubRenderState::resolveParameters.
+    */
+    virtual bool resolveParameters(ProgramSet* programSet);
+
+    /** 
+    @see SubRenderState::resolveDependencies.
+    */
+    virtual bool resolveDependencies(ProgramSet* programSet);
+
+    /** 
+    @see SubRenderState::addFunctionInvocations.
+    */
+    virtual bool addFunctionInvocations(ProgramSet* programSet);
+
+    /// Index of the cluster texture unit in the destination pass.
+    ushort mClusterSamplerIndex;
+    /// Cluster texture sampler.
+    UniformParameterPtr mClusterSampler;
+    /// Tiles, slice scale and slice bias of the cluster grid.
+    UniformParameterPtr mClusterGrid;
+    /// Light start, index start, directional light count and slice count.
+    UniformParameterPtr mClusterLayout;
+    /// Width, inverse width and inverse height of the cluster texture.
+    UniformParameterPtr mClusterTexel;
+    /// Projection matrix to find the tile of a fragment.
+    UniformParameterPtr mProjMatrix;
+    UniformParameterPtr mWorldViewMatrix;
+    UniformParameterPtr mWorldViewITMatrix;
+    UniformParameterPtr mDerivedSceneColour;
+    UniformParameterPtr mSurfaceDiffuseColour;
+    UniformParameterPtr mSurfaceSpecularColour;
+    UniformParameterPtr mSurfaceShininess;
+    ParameterPtr mVSInPosition;
+    ParameterPtr mVSInNormal;
+    ParameterPtr mVSOutViewPos;
+    ParameterPtr mVSOutNormal;
+    ParameterPtr mPSInViewPos;
+    ParameterPtr mPSInNormal;
+    ParameterPtr mPSDiffuse;
+    ParameterPtr mPSSpecular;
+    ParameterPtr mPSOutDiffuse;
+    ParameterPtr mPSTempDiffuseColour;
+    ParameterPtr mPSTempSpecularColour;
+};
+
+
+/** 
+A factory that enables creation of ClusteredLighting instances.
+@remarks Sub class of SubRenderStateFactory
+*/
+class _OgreRTSSExport ClusteredLightingFactory : public SubRenderStateFactory
+{
+public:
+
+    /** 
+    @see SubRenderStateFactory::getType.
+    */
+    virtual const String& getType() const;
+
+    /** 
+    @see SubRenderStateFactory::createInstance.
+    */
+    virtual SubRenderState* createInstance(ScriptCompiler* compiler, PropertyAbstractNode* prop, Pass* pass, SGScriptTranslator* translator);
+
+    /** 
+    @see SubRenderStateFactory::writeInstance.
+    */
+    virtual void writeInstance(MaterialSerializer* ser, SubRenderState* subRenderState, Pass* srcPass, Pass* dstPass);
+
+protected:
+
+    /** 
+    @see SubRenderStateFactory::createInstanceImpl.
+    */
+    virtual SubRenderState* createInstanceImpl();
+};
+
+/** @} */
+/** @} */
+
+}
+}
+
+#endif
+#endif
@@ -150,6 +150,11 @@ public:
     */
     virtual void copyFrom(const SubRenderState& rhs);
 
+    /** 
+    @see SubRenderState::writeCacheKey.
+    */
+    virtual bool writeCacheKey(StringStream& key) const;
+
     static String Type;
 
 // Protected methods
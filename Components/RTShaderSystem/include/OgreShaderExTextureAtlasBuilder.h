@@ -0,0 +1,137 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _ShaderExTextureAtlasBuilder_
+#define _ShaderExTextureAtlasBuilder_
+
+#include "OgreShaderPrerequisites.h"
+#ifdef RTSHADER_SYSTEM_BUILD_EXT_SHADERS
+#include "OgreShaderExTextureAtlasSampler.h"
+#include "OgreImage.h"
+
+namespace Ogre {
+namespace RTShader {
+
+/** \addtogroup Optional
+*  @{
+*/
+/** \addtogroup RTShader
+*  @{
+*/
+
+/** Packs textures into a texture atlas for the TextureAtlasSampler.
+
+The added textures are packed into one 2d atlas, each surrounded by a border of
+its repeated edge pixels as recommended by the TextureAtlasSampler, and the atlas
+table describing them is registered with the TextureAtlasSamplerFactory. The
+texture units of passes remapped with remapPass then sample the atlas through the
+TextureAtlasSampler sub render state, so materials which only differ by their
+textures become alike and the objects using them can share one material and batch.
+
+The sampler selects the texture of each texture unit by an index stored in an
+extra texture coordinate of the vertices, which addTextureIndices adds.
+
+For offline use the atlas image returned by getAtlasImage can be saved under the
+atlas name along with saveDefinition, and loaded back by
+TextureAtlasSamplerFactory::addTexutreAtlasDefinition.
+*/
+class _OgreRTSSExport TextureAtlasBuilder : public RTShaderSystemAlloc
+{
+public:
+    /**
+    @param atlasName Name of the atlas texture
+    @param groupName Resource group of the packed textures and of the atlas texture
+    @param maxSize Maximum width and height of the atlas
+    @param padding Width of the border around each texture, in pixels
+    */
+    TextureAtlasBuilder(const String& atlasName, const String& groupName,
+        uint32 maxSize = 2048, uint32 padding = 1);
+
+    /** Adds a texture to pack, it is loaded as an image from the resource group by build. */
+    void addTexture(const String& textureName);
+
+    /** Adds the textures of the 2d texture units of all passes of the material. */
+    void addMaterialTextures(const MaterialPtr& material);
+
+    /** Packs the added textures into the atlas.
+    @remarks
+        Textures which do not fit or are compressed are left out, with a message
+        in the log. The atlas texture is created if there is a texture manager,
+        replacing a texture of the same name, and the atlas table is registered
+        with the TextureAtlasSamplerFactory if there is one.
+    @return The number of textures in the atlas
+    */
+    size_t build(void);
+
+    /** Returns the index of a texture in the atlas table, or -1 if it is not in the atlas. */
+    int getTextureIndex(const String& textureName) const;
+
+    /** Returns the atlas table made by build. */
+    const TextureAtlasTablePtr& getAtlasTable(void) const { return mAtlasTable; }
+
+    /** Returns the atlas image made by build. */
+    const Image& getAtlasImage(void) const { return mAtlasImage; }
+
+    /** Makes the texture units of the pass which use a texture of the atlas use the atlas.
+    @param pass The pass to change
+    @param indices If not null, receives the atlas index of the texture of the first to
+        fourth texture unit, for addTextureIndices
+    @return false if no texture unit uses a texture of the atlas
+    */
+    bool remapPass(Pass* pass, Vector4* indices = NULL) const;
+
+    /** Adds the texture coordinate holding the atlas indices of the texture units.
+    @param vertexData The vertices, the coordinate is added in a new buffer
+    @param texCoordIndex The texture coordinate set the TextureAtlasSampler reads the
+        indices from, see TextureAtlasSamplerFactory::setDefaultAtlasingAttributes
+    @param indices The atlas index of the texture of the first to fourth texture unit
+    */
+    static void addTextureIndices(VertexData* vertexData, unsigned short texCoordIndex,
+        const Vector4& indices);
+
+    /** Writes the atlas table in the ".tai" format of TextureAtlasSamplerFactory::addTexutreAtlasDefinition. */
+    void saveDefinition(const String& filename) const;
+
+protected:
+    String mAtlasName;
+    String mGroupName;
+    uint32 mMaxSize;
+    uint32 mPadding;
+    // The textures to pack, in the order they were added
+    StringVector mTextureNames;
+    TextureAtlasTablePtr mAtlasTable;
+    Image mAtlasImage;
+};
+
+/** @} */
+/** @} */
+
+}
+}
+
+#endif
+#endif
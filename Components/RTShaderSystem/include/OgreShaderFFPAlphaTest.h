@@ -86,6 +86,11 @@ public:
     */
     virtual bool preAddToRenderState (const RenderState* renderState, Pass* srcPass, Pass* dstPass);
 
+    /** 
+    @see SubRenderState::writeCacheKey.
+    */
+    virtual bool writeCacheKey(StringStream& key) const;
+
     /** 
     @see SubRenderState::copyFrom.
     */
@@ -83,6 +83,11 @@ public:
     @see SubRenderState::preAddToRenderState.
     */
     virtual bool preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass);
+
+    /** 
+    @see SubRenderState::writeCacheKey.
+    */
+    virtual bool writeCacheKey(StringStream& key) const;
     
     //Direct3D HLSL specific methods
     /// Wraps a sampler with a SamplerData[x]D struct defined in FFPLib_Texturing.hlsl
@@ -213,7 +218,7 @@ protected:
     /** 
     Determines if the given texture unit state need to use texture transformation matrix.
     */
-    bool needsTextureMatrix(TextureUnitState* textureUnitState);
+    bool needsTextureMatrix(TextureUnitState* textureUnitState) const;
 
     /** 
     Determines whether a given texture unit needs to be processed by this srs
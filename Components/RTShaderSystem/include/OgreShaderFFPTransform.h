@@ -71,6 +71,16 @@ public:
     */
     virtual bool createCpuSubPrograms(ProgramSet* programSet);
 
+    /** 
+    @see SubRenderState::resolveCpuSubPrograms.
+    */
+    virtual bool resolveCpuSubPrograms(ProgramSet* programSet);
+
+    /** 
+    @see SubRenderState::writeCacheKey.
+    */
+    virtual bool writeCacheKey(StringStream& key) const;
+
 
     static String Type;
 };
@@ -174,6 +174,13 @@ public:
     /** 
     Set the output shader cache path. Generated shader code will be written to this path.
     In case of empty cache path shaders will be generated directly from system memory.
+    @remarks
+    The sources of render states made only of sub render states that support
+    SubRenderState::writeCacheKey are also stored here by their key, so a later run
+    takes them from the cache without generating them. The program names are hashes of
+    their sources, so their compiled form is found in the GpuProgramManager microcode
+    cache as well when it is saved and loaded by the application.
+    Delete the cached files when the shader libraries change.
     @param cachePath The cache path of the shader.  
     The default is empty cache path.
     */
@@ -485,6 +492,38 @@ public:
     */
     bool getCreateShaderOverProgrammablePass() const { return mCreateShaderOverProgrammablePass; }
 
+    /** Sets whether the programs are generated on the worker threads of the Root WorkQueue.
+    @remarks
+        When enabled, validating a scheme creates the CPU programs and writes
+        the program sources of all its out of date techniques in parallel.
+        The GPU programs are still created and compiled on the calling
+        thread, since that needs the render system. Custom sub render states
+        must then only touch their own state in createCpuSubPrograms.
+    */
+    void setParallelProgramGeneration(bool enabled) { mParallelProgramGeneration = enabled; }
+
+    /** Returns whether the programs are generated on worker threads.
+    @see setParallelProgramGeneration(). 
+    */
+    bool getParallelProgramGeneration() const { return mParallelProgramGeneration; }
+
+    /** Sets how many shader based techniques get their programs per scheme validation.
+    @remarks
+        With a budget, the programs of new materials are compiled over several
+        frames instead of all at once, to avoid hitches. Until its programs
+        are ready a shader based technique is kept out of its scheme, so the
+        material falls back to its other techniques, the same as before the
+        technique was created. validateMaterial leaves the programs to the
+        next scheme validation as well.
+    @param techniqueCount The number of techniques, 0 (the default) for no limit.
+    */
+    void setProgramBudget(size_t techniqueCount) { mProgramBudget = techniqueCount; }
+
+    /** Returns how many shader based techniques get their programs per scheme validation.
+    @see setProgramBudget(). 
+    */
+    size_t getProgramBudget() const { return mProgramBudget; }
+
 
     /** Returns the amount of schemes used in the for RT shader generation
     */
@@ -553,6 +592,13 @@ protected:
         /** Acquire the CPU/GPU programs for this pass. */
         void acquirePrograms();
 
+        /** Create the CPU programs and write the GPU program sources for this pass.
+        @remarks
+            May run on a worker thread, acquirePrograms then creates the GPU
+            programs from the sources.
+        */
+        void generatePrograms();
+
         /** Release the CPU/GPU programs of this pass. */
         void releasePrograms();
 
@@ -600,6 +646,13 @@ protected:
         RenderState* mCustomRenderState;
         // The compiled render state.
         TargetRenderState* mTargetRenderState;
+        // Program sources written by generatePrograms.
+        String mVSSource;
+        String mPSSource;
+        // Tells if generatePrograms ran since the render state was built.
+        bool mProgramsGenerated;
+        // Error raised while generating the programs.
+        String mGenerateError;
     };
 
     
@@ -625,9 +678,21 @@ protected:
         /** Build the render state. */
         void buildTargetRenderState();
 
-        /** Acquire the CPU/GPU programs for this technique. */
+        /** Acquire the CPU/GPU programs for this technique.
+        @remarks
+            Puts the destination technique into its scheme once its programs are ready.
+        */
         void acquirePrograms();
 
+        /** Create the CPU programs and write the GPU program sources of all passes.
+        @remarks
+            May run on a worker thread.
+        */
+        void generatePrograms();
+
+        /** Tells if the render state was built but the programs were not acquired yet. */
+        bool getProgramsPending() const { return mProgramsPending; }
+
 		/** Build the render state for illumination passes. */
 		void buildIlluminationTargetRenderState();
 
@@ -682,6 +747,8 @@ protected:
         RenderStateList mCustomRenderStates;
         // Flag that tells if destination technique should be build.        
         bool mBuildDstTechnique;
+        // Flag that tells if the programs of the destination technique are yet to be acquired.
+        bool mProgramsPending;
         // Scheme name of destination technique.
         String mDstTechniqueSchemeName;
     };
@@ -786,6 +853,9 @@ protected:
         /** Synchronize the fog settings of this scheme with the current settings of the scene. */
         void synchronizeWithFogSettings();
 
+        /** Generates the programs of techniques on the worker threads. */
+        struct ProgramGenerator;
+
 
     protected:
         // Scheme name.
@@ -1096,6 +1166,10 @@ protected:
     VSOutputCompactPolicy mVSOutputCompactPolicy;
     // Tells whether shaders are created for passes with shaders
     bool mCreateShaderOverProgrammablePass;
+    // Tells whether the programs are generated on worker threads.
+    bool mParallelProgramGeneration;
+    // Number of techniques getting their programs per scheme validation, 0 for all.
+    size_t mProgramBudget;
     // A flag to indicate finalizing
     bool mIsFinalizing;
 private:
@@ -84,6 +84,31 @@ public:
     */
     void acquirePrograms(Pass* pass, TargetRenderState* renderState);
 
+    /** Create the CPU programs of the given render state and write the source of its GPU programs.
+    @remarks
+        When the render state has a cache key and its sources are in the cache,
+        only the parameters of the CPU programs are resolved and the cached sources are returned.
+    @par
+        Nothing is created on the GPU or in the resource managers, so this may
+        run on a worker thread, as long as no two threads share a program writer.
+        Pass the sources to the acquirePrograms overload taking them afterwards.
+    @param renderState The render state that describes the program that need to be generated.
+    @param programWriter A program writer of the target language, see ProgramWriterManager::createProgramWriter.
+    @param vsSource Receives the vertex program source.
+    @param psSource Receives the fragment program source.
+    @return false if the programs could not be generated.
+    */
+    bool generatePrograms(TargetRenderState* renderState, ProgramWriter* programWriter,
+        String& vsSource, String& psSource);
+
+    /** Create the GPU programs of a render state from the sources written by generatePrograms and bind them to the pass.
+    @param pass The pass to bind the programs to.
+    @param renderState The render state given to generatePrograms.
+    @param vsSource The vertex program source.
+    @param psSource The fragment program source.
+    */
+    void acquirePrograms(Pass* pass, TargetRenderState* renderState, const String& vsSource, const String& psSource);
+
     /** Release CPU/GPU programs set associated with the given render state and pass.
     @param pass The pass to release the programs from.
     @param renderState The render state holds the programs.
@@ -94,11 +119,18 @@ public:
     */
     void flushGpuProgramsCache();
 
+    /** Flush the program sources cached by render state key.
+    @remarks The files written to the shader cache path are kept.
+    */
+    void flushProgramSourceCache();
+
 protected:
 
     //-----------------------------------------------------------------------------
     typedef map<String, GpuProgramPtr>::type            GpuProgramsMap;
     typedef map<String, String>::type                   ProgramSourceToNameMap;
+    typedef map<String, std::pair<String, String> >::type ProgramSourceCache;
+    typedef ProgramSourceCache::iterator                ProgramSourceCacheIterator;
     typedef GpuProgramsMap::iterator                    GpuProgramsMapIterator;
     typedef GpuProgramsMap::const_iterator              GpuProgramsMapConstIterator;
 
@@ -142,10 +174,38 @@ protected:
     */
     void destroyCpuProgram(Program* shaderProgram);
 
-    /** Create GPU programs for the given program set based on the CPU programs it contains.
+    /** Write the source of the GPU programs for the given program set.
     @param programSet The program set container.
+    @param programWriter The program writer instance.
+    @param vsSource Receives the vertex program source.
+    @param psSource Receives the fragment program source.
+    */
+    bool writeGpuProgramSources(ProgramSet* programSet, ProgramWriter* programWriter,
+        String& vsSource, String& psSource);
+
+    /** Create GPU programs for the given program set from their source.
+    @param programSet The program set container.
+    @param vsSource The vertex program source.
+    @param psSource The fragment program source.
+    */
+    bool createGpuPrograms(ProgramSet* programSet, const String& vsSource, const String& psSource);
+
+    /** Bind the GPU programs and uniform parameters of the given program set to the pass. */
+    void bindPrograms(Pass* pass, ProgramSet* programSet);
+
+    /** Get the program writer of the given language, creating it if needed. */
+    ProgramWriter* getProgramWriter(const String& language);
+
+    /** Look up the program sources cached for a render state key, in memory and then in the shader cache path.
+    @param cacheKey The hash of the render state key.
+    @param vsSource Receives the vertex program source.
+    @param psSource Receives the fragment program source.
+    @return false if the sources are not cached.
     */
-    bool createGpuPrograms(ProgramSet* programSet);
+    bool getCachedProgramSources(const String& cacheKey, String& vsSource, String& psSource);
+
+    /** Cache the program sources of a render state key, writing them to the shader cache path if there is one. */
+    void addCachedProgramSources(const String& cacheKey, const String& vsSource, const String& psSource);
         
     /** 
     Generates a unique hash from a string
@@ -156,14 +216,14 @@ protected:
 
     /** Create GPU program based on the give CPU program.
     @param shaderProgram The CPU program instance.
-    @param programWriter The program writer instance.
+    @param source The program source written for the CPU program.
     @param language The target shader language.
     @param profiles The profiles string for program compilation.
     @param profilesList The profiles string for program compilation as string list.
     @param cachePath The output path to write the program into.
     */
     GpuProgramPtr createGpuProgram(Program* shaderProgram, 
-        ProgramWriter* programWriter,
+        const String& source,
         const String& language,
         const String& profiles,
         const StringVector& profilesList,
@@ -210,6 +270,8 @@ protected:
 protected:
     // CPU programs list.                   
     ProgramList mCpuProgramsList;
+    // Guards the CPU programs list, programs are generated on worker threads.
+    OGRE_WQ_MUTEX(mCpuProgramsMutex);
     // Map between target language and shader program writer.                   
     ProgramWriterMap mProgramWritersMap;
     // Map between target language and shader program processor.    
@@ -224,6 +286,10 @@ protected:
     ProgramProcessorList mDefaultProgramProcessors;
     // map the source code of the shaders to a name for them
     ProgramSourceToNameMap mProgramSourceToNameMap;
+    // The vertex and fragment program sources by the hash of their render state key.
+    ProgramSourceCache mProgramSourceCache;
+    // Guards the program sources cache, programs are generated on worker threads.
+    OGRE_WQ_MUTEX(mProgramSourceCacheMutex);
 
 private:
     friend class ProgramSet;
@@ -170,8 +170,16 @@ protected:
     void sortSubRenderStates();
     
     /** Create CPU programs that represent this render state.   
+    @param resolveOnly Only resolve the parameters and dependencies of the programs,
+    used when their sources are taken from the program cache.
     */
-    bool createCpuPrograms();
+    bool createCpuPrograms(bool resolveOnly = false);
+
+    /** Write the cache key of the programs of this render state.
+    @see SubRenderState::writeCacheKey.
+    @return false if any of the sub render states can not be cached.
+    */
+    bool writeCacheKey(StringStream& key);
 
     /** Create the program set of this render state.
     */
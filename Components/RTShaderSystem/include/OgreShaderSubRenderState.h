@@ -94,6 +94,24 @@ public:
     */
     virtual bool createCpuSubPrograms(ProgramSet* programSet);
 
+    /** Create the parts of the sub programs that bind this sub render state to its GPU programs.
+    Called instead of createCpuSubPrograms when the program sources are taken from the program cache,
+    so only the parameters and dependencies are resolved and no function invocations are added.
+    @param programSet container class of CPU and GPU programs that this sub state will affect on.
+    */
+    virtual bool resolveCpuSubPrograms(ProgramSet* programSet);
+
+    /** Write everything the sub programs of this sub render state depend on to the given key.
+    @remarks
+    Render states with the same key are assumed to generate the same programs, so their sources
+    are taken from the program cache instead of being generated again. The key must cover every
+    setting used by addFunctionInvocations and resolveCpuSubPrograms must still resolve all the
+    parameters that get bound to the GPU programs.
+    @param key The stream to write the key to.
+    @return false if the programs of this sub render state can not be cached, which is the default.
+    */
+    virtual bool writeCacheKey(StringStream& key) const { return false; }
+
     /** Update GPU programs parameters before a rendering operation occurs.
     This method is called in the context of SceneManager::renderSingle object via the RenderObjectListener interface and
     lets this sub render state instance opportunity to update custom GPU program parameters before the rendering action occurs.
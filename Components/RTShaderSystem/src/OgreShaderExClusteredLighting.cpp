@@ -0,0 +1,319 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreShaderExClusteredLighting.h"
+#ifdef RTSHADER_SYSTEM_BUILD_EXT_SHADERS
+#include "OgreShaderFFPRenderState.h"
+#include "OgreShaderExPerPixelLighting.h"
+#include "OgreShaderProgram.h"
+#include "OgreShaderParameter.h"
+#include "OgreShaderProgramSet.h"
+#include "OgreShaderRenderState.h"
+#include "OgreShaderGenerator.h"
+#include "OgreSceneManager.h"
+#include "OgreLightClusters.h"
+#include "OgrePass.h"
+#include "OgreMaterialSerializer.h"
+
+namespace Ogre {
+namespace RTShader {
+
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+String ClusteredLighting::Type = "SGX_ClusteredLighting";
+
+//-----------------------------------------------------------------------
+ClusteredLighting::ClusteredLighting() : mClusterSamplerIndex(0)
+{
+}
+
+//-----------------------------------------------------------------------
+const String& ClusteredLighting::getType() const
+{
+    return Type;
+}
+
+//-----------------------------------------------------------------------
+int ClusteredLighting::getExecutionOrder() const
+{
+    return FFP_LIGHTING;
+}
+
+//-----------------------------------------------------------------------
+void ClusteredLighting::updateGpuProgramsParams(Renderable* rend, Pass* pass, const AutoParamDataSource* source, 
+    const LightList* pLightList)
+{
+    SceneManager* sceneManager = ShaderGenerator::getSingleton().getActiveSceneManager();
+    LightClusters* clusters = sceneManager ? sceneManager->getLightClusters() : NULL;
+    if (clusters == NULL)
+    {
+        // no clusters, only the ambient and emissive light is left
+        mClusterLayout->setGpuParameter(Vector4::ZERO);
+        mClusterGrid->setGpuParameter(Vector4(1, 1, 0, 0));
+        return;
+    }
+
+    const TexturePtr& texture = clusters->getTexture();
+    TextureUnitState* textureUnit = pass->getTextureUnitState(mClusterSamplerIndex);
+    if (textureUnit->_getTexturePtr() != texture)
+        textureUnit->_setTexturePtr(texture);
+
+    mClusterGrid->setGpuParameter(clusters->getGridParams());
+    mClusterLayout->setGpuParameter(Vector4(
+        static_cast<Real>(clusters->getLightStart()),
+        static_cast<Real>(clusters->getIndexStart()),
+        static_cast<Real>(clusters->getDirectionalLightCount()),
+        static_cast<Real>(clusters->getSlices())));
+    mClusterTexel->setGpuParameter(Vector4(
+        static_cast<Real>(texture->getWidth()), 1.0f / texture->getWidth(), 1.0f / texture->getHeight(), 0));
+}
+
+//-----------------------------------------------------------------------
+bool ClusteredLighting::resolveParameters(ProgramSet* programSet)
+{
+    Program* vsProgram = programSet->getCpuVertexProgram();
+    Program* psProgram = programSet->getCpuFragmentProgram();
+    Function* vsMain = vsProgram->getEntryPointFunction();
+    Function* psMain = psProgram->getEntryPointFunction();
+
+    mWorldViewMatrix = vsProgram->resolveAutoParameterInt(GpuProgramParameters::ACT_WORLDVIEW_MATRIX, 0);
+    mWorldViewITMatrix = vsProgram->resolveAutoParameterInt(GpuProgramParameters::ACT_INVERSE_TRANSPOSE_WORLDVIEW_MATRIX, 0);
+    mProjMatrix = psProgram->resolveAutoParameterInt(GpuProgramParameters::ACT_PROJECTION_MATRIX, 0);
+    mDerivedSceneColour = psProgram->resolveAutoParameterInt(GpuProgramParameters::ACT_DERIVED_SCENE_COLOUR, 0);
+    mSurfaceDiffuseColour = psProgram->resolveAutoParameterInt(GpuProgramParameters::ACT_SURFACE_DIFFUSE_COLOUR, 0);
+    mSurfaceSpecularColour = psProgram->resolveAutoParameterInt(GpuProgramParameters::ACT_SURFACE_SPECULAR_COLOUR, 0);
+    mSurfaceShininess = psProgram->resolveAutoParameterInt(GpuProgramParameters::ACT_SURFACE_SHININESS, 0);
+
+    mClusterSampler = psProgram->resolveParameter(GCT_SAMPLER2D, mClusterSamplerIndex, (uint16)GPV_GLOBAL, "gClusterSampler");
+    mClusterGrid = psProgram->resolveParameter(GCT_FLOAT4, -1, (uint16)GPV_GLOBAL, "gClusterGrid");
+    mClusterLayout = psProgram->resolveParameter(GCT_FLOAT4, -1, (uint16)GPV_GLOBAL, "gClusterLayout");
+    mClusterTexel = psProgram->resolveParameter(GCT_FLOAT4, -1, (uint16)GPV_GLOBAL, "gClusterTexel");
+
+    mVSInPosition = vsMain->resolveInputParameter(Parameter::SPS_POSITION, 0, Parameter::SPC_POSITION_OBJECT_SPACE, GCT_FLOAT4);
+    mVSInNormal = vsMain->resolveInputParameter(Parameter::SPS_NORMAL, 0, Parameter::SPC_NORMAL_OBJECT_SPACE, GCT_FLOAT3);
+    mVSOutViewPos = vsMain->resolveOutputParameter(Parameter::SPS_TEXTURE_COORDINATES, -1, Parameter::SPC_POSITION_VIEW_SPACE, GCT_FLOAT3);
+    mVSOutNormal = vsMain->resolveOutputParameter(Parameter::SPS_TEXTURE_COORDINATES, -1, Parameter::SPC_NORMAL_VIEW_SPACE, GCT_FLOAT3);
+    if (mVSOutViewPos.get() == NULL || mVSOutNormal.get() == NULL)
+        return false;
+
+    mPSInViewPos = psMain->resolveInputParameter(Parameter::SPS_TEXTURE_COORDINATES, 
+        mVSOutViewPos->getIndex(), 
+        mVSOutViewPos->getContent(),
+        GCT_FLOAT3);
+    mPSInNormal = psMain->resolveInputParameter(Parameter::SPS_TEXTURE_COORDINATES, 
+        mVSOutNormal->getIndex(), 
+        mVSOutNormal->getContent(),
+        GCT_FLOAT3);
+
+    const ShaderParameterList& inputParams = psMain->getInputParameters();
+    const ShaderParameterList& localParams = psMain->getLocalParameters();
+
+    mPSDiffuse = psMain->getParameterByContent(inputParams, Parameter::SPC_COLOR_DIFFUSE, GCT_FLOAT4);
+    if (mPSDiffuse.get() == NULL)
+        mPSDiffuse = psMain->getParameterByContent(localParams, Parameter::SPC_COLOR_DIFFUSE, GCT_FLOAT4);
+    mPSSpecular = psMain->getParameterByContent(inputParams, Parameter::SPC_COLOR_SPECULAR, GCT_FLOAT4);
+    if (mPSSpecular.get() == NULL)
+        mPSSpecular = psMain->getParameterByContent(localParams, Parameter::SPC_COLOR_SPECULAR, GCT_FLOAT4);
+
+    mPSOutDiffuse = psMain->resolveOutputParameter(Parameter::SPS_COLOR, 0, Parameter::SPC_COLOR_DIFFUSE, GCT_FLOAT4);
+    mPSTempDiffuseColour = psMain->resolveLocalParameter(Parameter::SPS_UNKNOWN, 0, "lClusteredDiffuse", GCT_FLOAT4);
+    mPSTempSpecularColour = psMain->resolveLocalParameter(Parameter::SPS_UNKNOWN, 0, "lClusteredSpecular", GCT_FLOAT4);
+
+    if (!mWorldViewMatrix.get() || !mWorldViewITMatrix.get() || !mProjMatrix.get() || !mDerivedSceneColour.get() ||
+        !mSurfaceDiffuseColour.get() || !mSurfaceSpecularColour.get() || !mSurfaceShininess.get() ||
+        !mClusterSampler.get() || !mClusterGrid.get() || !mClusterLayout.get() || !mClusterTexel.get() ||
+        !mVSInPosition.get() || !mVSInNormal.get() || !mPSInViewPos.get() || !mPSInNormal.get() ||
+        !mPSDiffuse.get() || !mPSOutDiffuse.get() || !mPSTempDiffuseColour.get() || !mPSTempSpecularColour.get())
+    {
+        OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR, 
+                "Not all parameters could be constructed for the sub-render state.",
+                "ClusteredLighting::resolveParameters" );
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+bool ClusteredLighting::resolveDependencies(ProgramSet* programSet)
+{
+    Program* vsProgram = programSet->getCpuVertexProgram();
+    Program* psProgram = programSet->getCpuFragmentProgram();
+
+    vsProgram->addDependency(FFP_LIB_COMMON);
+    vsProgram->addDependency(SGX_LIB_PERPIXELLIGHTING);
+
+    psProgram->addDependency(FFP_LIB_COMMON);
+    psProgram->addDependency(SGX_LIB_CLUSTEREDLIGHTING);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+bool ClusteredLighting::addFunctionInvocations(ProgramSet* programSet)
+{
+    Function* vsMain = programSet->getCpuVertexProgram()->getEntryPointFunction();
+    Function* psMain = programSet->getCpuFragmentProgram()->getEntryPointFunction();
+    int internalCounter = 0;
+    FunctionInvocation* curFuncInvocation = NULL;
+
+    // View space normal and position.
+    curFuncInvocation = OGRE_NEW FunctionInvocation(SGX_FUNC_TRANSFORMNORMAL, FFP_VS_LIGHTING, internalCounter++); 
+    curFuncInvocation->pushOperand(mWorldViewITMatrix, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInNormal, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSOutNormal, Operand::OPS_OUT); 
+    vsMain->addAtomInstance(curFuncInvocation);
+
+    curFuncInvocation = OGRE_NEW FunctionInvocation(SGX_FUNC_TRANSFORMPOSITION, FFP_VS_LIGHTING, internalCounter++); 
+    curFuncInvocation->pushOperand(mWorldViewMatrix, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInPosition, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSOutViewPos, Operand::OPS_OUT);    
+    vsMain->addAtomInstance(curFuncInvocation);
+
+    // Start from the ambient and emissive light.
+    internalCounter = 0;
+    curFuncInvocation = OGRE_NEW FunctionInvocation(FFP_FUNC_ASSIGN, FFP_PS_COLOUR_BEGIN + 1, internalCounter++); 
+    curFuncInvocation->pushOperand(mDerivedSceneColour, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mPSTempDiffuseColour, Operand::OPS_OUT); 
+    psMain->addAtomInstance(curFuncInvocation);
+
+    curFuncInvocation = OGRE_NEW FunctionInvocation(FFP_FUNC_ASSIGN, FFP_PS_COLOUR_BEGIN + 1, internalCounter++); 
+    curFuncInvocation->pushOperand(ParameterFactory::createConstParamVector4(Vector4::ZERO), Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mPSTempSpecularColour, Operand::OPS_OUT); 
+    psMain->addAtomInstance(curFuncInvocation);
+
+    // Add all lights of the cluster.
+    curFuncInvocation = OGRE_NEW FunctionInvocation(SGX_FUNC_LIGHT_CLUSTERED, FFP_PS_COLOUR_BEGIN + 1, internalCounter++); 
+    curFuncInvocation->pushOperand(mPSInNormal, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mPSInViewPos, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mProjMatrix, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mClusterGrid, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mClusterLayout, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mClusterTexel, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mClusterSampler, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mSurfaceDiffuseColour, Operand::OPS_IN, Operand::OPM_XYZ);
+    curFuncInvocation->pushOperand(mSurfaceSpecularColour, Operand::OPS_IN, Operand::OPM_XYZ);
+    curFuncInvocation->pushOperand(mSurfaceShininess, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mPSTempDiffuseColour, Operand::OPS_INOUT, Operand::OPM_XYZ);
+    curFuncInvocation->pushOperand(mPSTempSpecularColour, Operand::OPS_INOUT, Operand::OPM_XYZ);
+    psMain->addAtomInstance(curFuncInvocation);
+
+    // Hand the colours on to the following stages.
+    curFuncInvocation = OGRE_NEW FunctionInvocation(FFP_FUNC_ASSIGN, FFP_PS_COLOUR_BEGIN + 1, internalCounter++);                               
+    curFuncInvocation->pushOperand(mPSTempDiffuseColour, Operand::OPS_IN);  
+    curFuncInvocation->pushOperand(mPSDiffuse, Operand::OPS_OUT);   
+    psMain->addAtomInstance(curFuncInvocation); 
+
+    curFuncInvocation = OGRE_NEW FunctionInvocation(FFP_FUNC_ASSIGN, FFP_PS_COLOUR_BEGIN + 1, internalCounter++);                               
+    curFuncInvocation->pushOperand(mPSDiffuse, Operand::OPS_IN);    
+    curFuncInvocation->pushOperand(mPSOutDiffuse, Operand::OPS_OUT);    
+    psMain->addAtomInstance(curFuncInvocation);
+
+    if (mPSSpecular.get() != NULL)
+    {
+        curFuncInvocation = OGRE_NEW FunctionInvocation(FFP_FUNC_ASSIGN, FFP_PS_COLOUR_BEGIN + 1, internalCounter++); 
+        curFuncInvocation->pushOperand(mPSTempSpecularColour, Operand::OPS_IN);
+        curFuncInvocation->pushOperand(mPSSpecular, Operand::OPS_OUT);          
+        psMain->addAtomInstance(curFuncInvocation); 
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+void ClusteredLighting::copyFrom(const SubRenderState& rhs)
+{
+    const ClusteredLighting& rhsLighting = static_cast<const ClusteredLighting&>(rhs);
+    mClusterSamplerIndex = rhsLighting.mClusterSamplerIndex;
+}
+
+//-----------------------------------------------------------------------
+bool ClusteredLighting::preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass)
+{
+    if (srcPass->getLightingEnabled() == false || ShaderGenerator::getSingleton().IsHlsl4())
+        return false;
+
+    // The programs loop over the clusters, they do not depend on the light count.
+    const_cast<RenderState*>(renderState)->setLightCountAutoUpdate(false);
+
+    TextureUnitState* clusterTexture = dstPass->createTextureUnitState();
+    clusterTexture->setTextureFiltering(TFO_NONE);
+    clusterTexture->setTextureAddressingMode(TextureUnitState::TAM_CLAMP);
+    mClusterSamplerIndex = dstPass->getNumTextureUnitStates() - 1;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+const String& ClusteredLightingFactory::getType() const
+{
+    return ClusteredLighting::Type;
+}
+
+//-----------------------------------------------------------------------
+SubRenderState* ClusteredLightingFactory::createInstance(ScriptCompiler* compiler, 
+                                                         PropertyAbstractNode* prop, Pass* pass, SGScriptTranslator* translator)
+{
+    if (prop->name == "lighting_stage")
+    {
+        if(prop->values.size() == 1)
+        {
+            String modelType;
+            
+            if(false == SGScriptTranslator::getString(prop->values.front(), &modelType))
+            {
+                compiler->addError(ScriptCompiler::CE_INVALIDPARAMETERS, prop->file, prop->line);
+                return NULL;
+            }
+            
+            if (modelType == "clustered")
+            {
+                return createOrRetrieveInstance(translator);
+            }
+        }       
+    }
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------
+void ClusteredLightingFactory::writeInstance(MaterialSerializer* ser, SubRenderState* subRenderState, 
+                                             Pass* srcPass, Pass* dstPass)
+{
+    ser->writeAttribute(4, "lighting_stage");
+    ser->writeValue("clustered");
+}
+
+//-----------------------------------------------------------------------
+SubRenderState* ClusteredLightingFactory::createInstanceImpl()
+{
+    return OGRE_NEW ClusteredLighting;
+}
+
+}
+}
+
+#endif
@@ -155,6 +155,13 @@ bool LayeredBlending::resolveDependencies(ProgramSet* programSet)
     return true;
 }
 
+//-----------------------------------------------------------------------
+bool LayeredBlending::writeCacheKey(StringStream& key) const
+{
+    // The blend and source modifier invocations are not part of the texturing key.
+    return false;
+}
+
 //-----------------------------------------------------------------------
 void LayeredBlending::copyFrom(const SubRenderState& rhs)
 {
@@ -0,0 +1,152 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreShaderExLodMorph.h"
+#ifdef RTSHADER_SYSTEM_BUILD_EXT_SHADERS
+#include "OgreShaderFFPRenderState.h"
+#include "OgreShaderProgram.h"
+#include "OgreShaderParameter.h"
+#include "OgreShaderProgramSet.h"
+#include "OgreRenderable.h"
+#include "OgreSubMesh.h"
+#include "OgreMaterialSerializer.h"
+
+namespace Ogre {
+namespace RTShader {
+
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+String LodMorph::type = "SGX_LodMorph";
+
+//-----------------------------------------------------------------------
+const String& LodMorph::getType() const
+{
+    return type;
+}
+
+//-----------------------------------------------------------------------
+int LodMorph::getExecutionOrder() const
+{
+    return FFP_PRE_PROCESS;
+}
+
+//-----------------------------------------------------------------------
+void LodMorph::copyFrom(const SubRenderState& rhs)
+{
+}
+
+//-----------------------------------------------------------------------
+bool LodMorph::resolveParameters(ProgramSet* programSet)
+{
+    Program* vsProgram = programSet->getCpuVertexProgram();
+    Function* vsMain = vsProgram->getEntryPointFunction();
+
+    mVSInPosition = vsMain->resolveInputParameter(Parameter::SPS_POSITION, 0,
+        Parameter::SPC_POSITION_OBJECT_SPACE, GCT_FLOAT4);
+    mVSInMorphTarget = vsMain->resolveInputParameter(Parameter::SPS_TEXTURE_COORDINATES,
+        SubMesh::LOD_MORPH_TEXCOORD,
+        Parameter::Content(Parameter::SPC_TEXTURE_COORDINATE0 + SubMesh::LOD_MORPH_TEXCOORD), GCT_FLOAT4);
+    mVSMorphFactor = vsProgram->resolveParameter(GCT_FLOAT1, -1, (uint16)GPV_PER_OBJECT, "lodMorphFactor");
+
+    return mVSInPosition.get() && mVSInMorphTarget.get() && mVSMorphFactor.get();
+}
+
+//-----------------------------------------------------------------------
+bool LodMorph::resolveDependencies(ProgramSet* programSet)
+{
+    Program* vsProgram = programSet->getCpuVertexProgram();
+    vsProgram->addDependency(FFP_LIB_COMMON);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+bool LodMorph::addFunctionInvocations(ProgramSet* programSet)
+{
+    Program* vsProgram = programSet->getCpuVertexProgram();
+    Function* vsMain = vsProgram->getEntryPointFunction();
+
+    // Move the position before anything reads it, skinning and transform included
+    FunctionInvocation* curFuncInvocation = OGRE_NEW FunctionInvocation(FFP_FUNC_LERP, FFP_VS_PRE_PROCESS, 0);
+    curFuncInvocation->pushOperand(mVSInPosition, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInMorphTarget, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSMorphFactor, Operand::OPS_IN);
+    curFuncInvocation->pushOperand(mVSInPosition, Operand::OPS_OUT);
+    vsMain->addAtomInstance(curFuncInvocation);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+void LodMorph::updateGpuProgramsParams(Renderable* rend, Pass* pass, const AutoParamDataSource* source,
+                                       const LightList* pLightList)
+{
+    // Renderables without the parameter are not morphing, and must not keep the last factor
+    Real factor = 0;
+    if (rend->hasCustomParameter(SubMesh::LOD_MORPH_CUSTOM_PARAMETER))
+        factor = rend->getCustomParameter(SubMesh::LOD_MORPH_CUSTOM_PARAMETER).x;
+    mVSMorphFactor->setGpuParameter(factor);
+}
+
+//-----------------------------------------------------------------------
+const String& LodMorphFactory::getType() const
+{
+    return LodMorph::type;
+}
+
+//-----------------------------------------------------------------------
+SubRenderState* LodMorphFactory::createInstance(ScriptCompiler* compiler,
+                                                PropertyAbstractNode* prop, Pass* pass, SGScriptTranslator* translator)
+{
+    if (prop->name == "lod_morph")
+    {
+        if (prop->values.empty())
+            return createOrRetrieveInstance(translator);
+
+        compiler->addError(ScriptCompiler::CE_INVALIDPARAMETERS, prop->file, prop->line);
+    }
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------
+void LodMorphFactory::writeInstance(MaterialSerializer* ser, SubRenderState* subRenderState,
+                                    Pass* srcPass, Pass* dstPass)
+{
+    ser->writeAttribute(4, "lod_morph");
+}
+
+//-----------------------------------------------------------------------
+SubRenderState* LodMorphFactory::createInstanceImpl()
+{
+    return OGRE_NEW LodMorph;
+}
+
+}
+}
+
+#endif
@@ -732,6 +732,15 @@ bool PerPixelLighting::addPSFinalAssignmentInvocation( Function* psMain, const i
 }
 
 
+//-----------------------------------------------------------------------
+bool PerPixelLighting::writeCacheKey(StringStream& key) const
+{
+    key << mTrackVertexColourType << ' ' << mSpecularEnable;
+    for (unsigned int i=0; i < mLightParamsList.size(); ++i)
+        key << ' ' << mLightParamsList[i].mType;
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void PerPixelLighting::copyFrom(const SubRenderState& rhs)
 {
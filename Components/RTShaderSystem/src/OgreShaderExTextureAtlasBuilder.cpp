@@ -0,0 +1,286 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreShaderExTextureAtlasBuilder.h"
+#ifdef RTSHADER_SYSTEM_BUILD_EXT_SHADERS
+#include "OgreMaterial.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreTextureUnitState.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreLogManager.h"
+#include "OgreBitwise.h"
+#include <fstream>
+
+namespace Ogre {
+namespace RTShader {
+
+namespace {
+    // Orders the textures by decreasing height, which keeps the shelves of the packing full
+    struct TallerImage
+    {
+        const vector<Image>::type& images;
+        TallerImage(const vector<Image>::type& imgs) : images(imgs) {}
+        bool operator()(size_t a, size_t b) const
+        {
+            if (images[a].getHeight() != images[b].getHeight())
+                return images[a].getHeight() > images[b].getHeight();
+            return images[a].getWidth() > images[b].getWidth();
+        }
+    };
+}
+
+//-----------------------------------------------------------------------
+TextureAtlasBuilder::TextureAtlasBuilder(const String& atlasName, const String& groupName,
+                                         uint32 maxSize, uint32 padding) :
+    mAtlasName(atlasName),
+    mGroupName(groupName),
+    mMaxSize(maxSize),
+    mPadding(padding),
+    mAtlasTable(OGRE_NEW_T(TextureAtlasTable, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T)
+{
+}
+
+//-----------------------------------------------------------------------
+void TextureAtlasBuilder::addTexture(const String& textureName)
+{
+    if (std::find(mTextureNames.begin(), mTextureNames.end(), textureName) == mTextureNames.end())
+        mTextureNames.push_back(textureName);
+}
+
+//-----------------------------------------------------------------------
+void TextureAtlasBuilder::addMaterialTextures(const MaterialPtr& material)
+{
+    for (unsigned short t = 0; t < material->getNumTechniques(); ++t)
+    {
+        Technique* technique = material->getTechnique(t);
+        for (unsigned short p = 0; p < technique->getNumPasses(); ++p)
+        {
+            Pass* pass = technique->getPass(p);
+            for (unsigned short i = 0; i < pass->getNumTextureUnitStates(); ++i)
+            {
+                TextureUnitState* state = pass->getTextureUnitState(i);
+                if (state->getTextureType() == TEX_TYPE_2D && !state->getTextureName().empty() &&
+                    state->getTextureName() != mAtlasName)
+                {
+                    addTexture(state->getTextureName());
+                }
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------
+size_t TextureAtlasBuilder::build(void)
+{
+    mAtlasTable->clear();
+
+    vector<Image>::type images(mTextureNames.size());
+    vector<size_t>::type order;
+    for (size_t i = 0; i < mTextureNames.size(); ++i)
+    {
+        try
+        {
+            images[i].load(mTextureNames[i], mGroupName);
+        }
+        catch (Exception& e)
+        {
+            LogManager::getSingleton().logMessage("TextureAtlasBuilder: leaving " + mTextureNames[i] +
+                " out of " + mAtlasName + ", " + e.getDescription());
+            continue;
+        }
+        if (PixelUtil::isCompressed(images[i].getFormat()))
+        {
+            LogManager::getSingleton().logMessage("TextureAtlasBuilder: leaving compressed texture " +
+                mTextureNames[i] + " out of " + mAtlasName);
+            continue;
+        }
+        order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), TallerImage(images));
+
+    // Place the textures on shelves, left to right and top to bottom
+    vector<Box>::type places(mTextureNames.size());
+    vector<size_t>::type placed;
+    uint32 x = 0, y = 0, shelfHeight = 0, usedWidth = 0;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const Image& image = images[order[i]];
+        uint32 width = static_cast<uint32>(image.getWidth()) + 2 * mPadding;
+        uint32 height = static_cast<uint32>(image.getHeight()) + 2 * mPadding;
+        if (x + width > mMaxSize)
+        {
+            y += shelfHeight;
+            x = 0;
+            shelfHeight = 0;
+        }
+        if (width > mMaxSize || y + height > mMaxSize)
+        {
+            LogManager::getSingleton().logMessage("TextureAtlasBuilder: " + mTextureNames[order[i]] +
+                " does not fit in " + mAtlasName);
+            continue;
+        }
+
+        places[order[i]] = Box(x + mPadding, y + mPadding,
+            x + mPadding + static_cast<uint32>(image.getWidth()),
+            y + mPadding + static_cast<uint32>(image.getHeight()));
+        placed.push_back(order[i]);
+        x += width;
+        shelfHeight = std::max(shelfHeight, height);
+        usedWidth = std::max(usedWidth, x);
+    }
+    // Keep the order of the table independent of the sizes
+    std::sort(placed.begin(), placed.end());
+
+    uint32 atlasWidth = Bitwise::firstPO2From(std::max<uint32>(usedWidth, 1));
+    uint32 atlasHeight = Bitwise::firstPO2From(std::max<uint32>(y + shelfHeight, 1));
+    size_t atlasBytes = PixelUtil::getMemorySize(atlasWidth, atlasHeight, 1, PF_A8R8G8B8);
+    uchar* atlasData = OGRE_ALLOC_T(uchar, atlasBytes, MEMCATEGORY_GENERAL);
+    memset(atlasData, 0, atlasBytes);
+    mAtlasImage.loadDynamicImage(atlasData, atlasWidth, atlasHeight, 1, PF_A8R8G8B8, true);
+    PixelBox atlasBox = mAtlasImage.getPixelBox();
+    uint32* pixels = static_cast<uint32*>(atlasBox.data);
+
+    for (size_t i = 0; i < placed.size(); ++i)
+    {
+        const Box& place = places[placed[i]];
+        PixelUtil::bulkPixelConversion(images[placed[i]].getPixelBox(), atlasBox.getSubVolume(place, false));
+
+        // Repeat the edge pixels into the padding around the texture
+        for (uint32 row = place.top - mPadding; row < place.bottom + mPadding; ++row)
+        {
+            uint32 srcRow = Math::Clamp<uint32>(row, place.top, place.bottom - 1);
+            for (uint32 col = place.left - mPadding; col < place.right + mPadding; ++col)
+            {
+                uint32 srcCol = Math::Clamp<uint32>(col, place.left, place.right - 1);
+                if (srcRow != row || srcCol != col)
+                    pixels[row * atlasWidth + col] = pixels[srcRow * atlasWidth + srcCol];
+            }
+        }
+
+        mAtlasTable->push_back(TextureAtlasRecord(mTextureNames[placed[i]], mAtlasName,
+            static_cast<float>(place.left) / atlasWidth, static_cast<float>(place.top) / atlasHeight,
+            static_cast<float>(place.getWidth()) / atlasWidth, static_cast<float>(place.getHeight()) / atlasHeight,
+            mAtlasTable->size()));
+    }
+
+    if (TextureManager::getSingletonPtr())
+    {
+        TextureManager::getSingleton().remove(mAtlasName, mGroupName);
+        TextureManager::getSingleton().loadImage(mAtlasName, mGroupName, mAtlasImage);
+    }
+    if (TextureAtlasSamplerFactory::getSingletonPtr())
+    {
+        TextureAtlasSamplerFactory::getSingleton().removeTextureAtlasTable(mAtlasName);
+        TextureAtlasSamplerFactory::getSingleton().setTextureAtlasTable(mAtlasName, mAtlasTable);
+    }
+
+    return mAtlasTable->size();
+}
+
+//-----------------------------------------------------------------------
+int TextureAtlasBuilder::getTextureIndex(const String& textureName) const
+{
+    for (size_t i = 0; i < mAtlasTable->size(); ++i)
+    {
+        if ((*mAtlasTable)[i].originalTextureName == textureName)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+//-----------------------------------------------------------------------
+bool TextureAtlasBuilder::remapPass(Pass* pass, Vector4* indices) const
+{
+    bool remapped = false;
+    if (indices)
+        *indices = Vector4::ZERO;
+
+    for (unsigned short i = 0; i < pass->getNumTextureUnitStates(); ++i)
+    {
+        TextureUnitState* state = pass->getTextureUnitState(i);
+        int index = getTextureIndex(state->getTextureName());
+        if (index < 0 || state->getTextureType() != TEX_TYPE_2D)
+            continue;
+
+        if (indices && i < TAS_MAX_TEXTURES)
+            (*indices)[i] = static_cast<Real>(index);
+        state->setTextureName(mAtlasName);
+        remapped = true;
+    }
+    return remapped;
+}
+
+//-----------------------------------------------------------------------
+void TextureAtlasBuilder::addTextureIndices(VertexData* vertexData, unsigned short texCoordIndex,
+                                            const Vector4& indices)
+{
+    if (vertexData->vertexDeclaration->findElementBySemantic(VES_TEXTURE_COORDINATES, texCoordIndex))
+    {
+        OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM,
+            "The vertices already have texture coordinate set " + StringConverter::toString(texCoordIndex),
+            "TextureAtlasBuilder::addTextureIndices");
+    }
+
+    HardwareVertexBufferSharedPtr buffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+        VertexElement::getTypeSize(VET_FLOAT4), vertexData->vertexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+    float* data = static_cast<float*>(buffer->lock(HardwareBuffer::HBL_DISCARD));
+    for (size_t i = 0; i < vertexData->vertexCount; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+            *data++ = static_cast<float>(indices[j]);
+    }
+    buffer->unlock();
+
+    unsigned short source = vertexData->vertexBufferBinding->getNextIndex();
+    vertexData->vertexBufferBinding->setBinding(source, buffer);
+    vertexData->vertexDeclaration->addElement(source, 0, VET_FLOAT4, VES_TEXTURE_COORDINATES, texCoordIndex);
+}
+
+//-----------------------------------------------------------------------
+void TextureAtlasBuilder::saveDefinition(const String& filename) const
+{
+    std::ofstream out(filename.c_str());
+    if (!out)
+    {
+        OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE, "Cannot create '" + filename + "'",
+            "TextureAtlasBuilder::saveDefinition");
+    }
+
+    // <original texture filename>\t\t<atlas filename>, <atlas idx>, <atlas type>, <woffset>, <hoffset>, <depth offset>, <width>, <height>
+    for (TextureAtlasTable::const_iterator it = mAtlasTable->begin(); it != mAtlasTable->end(); ++it)
+    {
+        out << it->originalTextureName << "\t\t" << it->atlasTextureName << ", 0, 2D, "
+            << it->posU << ", " << it->posV << ", 0.0, " << it->width << ", " << it->height << "\n";
+    }
+}
+
+}
+}
+
+#endif
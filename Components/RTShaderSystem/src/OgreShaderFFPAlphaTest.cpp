@@ -107,6 +107,12 @@ namespace Ogre {
 			return srcPass->getAlphaRejectFunction() != CMPF_ALWAYS_PASS;
 		}
 
+		bool FFPAlphaTest::writeCacheKey( StringStream& key ) const
+		{
+			// The function and reference value are uniforms
+			return true;
+		}
+
 		void FFPAlphaTest::updateGpuProgramsParams( Renderable* rend, Pass* pass, const AutoParamDataSource* source, const LightList* pLightList )
 		{
 			mPSAlphaFunc->setGpuParameter((float)pass->getAlphaRejectFunction());
@@ -265,6 +265,13 @@ bool FFPColour::addFunctionInvocations(ProgramSet* programSet)
 }
 
 
+//-----------------------------------------------------------------------
+bool FFPColour::writeCacheKey(StringStream& key) const
+{
+    key << mResolveStageFlags;
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void FFPColour::copyFrom(const SubRenderState& rhs)
 {
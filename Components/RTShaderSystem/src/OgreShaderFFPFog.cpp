@@ -288,6 +288,14 @@ bool FFPFog::addFunctionInvocations(ProgramSet* programSet)
     return true;
 }
 
+//-----------------------------------------------------------------------
+bool FFPFog::writeCacheKey(StringStream& key) const
+{
+    // The fog colour and parameters are uniforms.
+    key << mCalcMode << ' ' << mFogMode;
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void FFPFog::copyFrom(const SubRenderState& rhs)
 {
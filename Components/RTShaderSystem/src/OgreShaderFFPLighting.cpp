@@ -606,6 +606,15 @@ bool FFPLighting::addIlluminationInvocation(LightParams* curLightParams, Functio
 }
 
 
+//-----------------------------------------------------------------------
+bool FFPLighting::writeCacheKey(StringStream& key) const
+{
+    key << mTrackVertexColourType << ' ' << mSpecularEnable;
+    for (unsigned int i=0; i < mLightParamsList.size(); ++i)
+        key << ' ' << mLightParamsList[i].mType;
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void FFPLighting::copyFrom(const SubRenderState& rhs)
 {
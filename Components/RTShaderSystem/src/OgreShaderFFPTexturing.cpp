@@ -830,7 +830,7 @@ TexCoordCalcMethod FFPTexturing::getTexCalcMethod(TextureUnitState* textureUnitS
 }
 
 //-----------------------------------------------------------------------
-bool FFPTexturing::needsTextureMatrix(TextureUnitState* textureUnitState)
+bool FFPTexturing::needsTextureMatrix(TextureUnitState* textureUnitState) const
 {
     const TextureUnitState::EffectMap&      effectMap = textureUnitState->getEffects(); 
     TextureUnitState::EffectMap::const_iterator effi;
@@ -861,6 +861,35 @@ bool FFPTexturing::needsTextureMatrix(TextureUnitState* textureUnitState)
 }
 
 
+//-----------------------------------------------------------------------
+bool FFPTexturing::writeCacheKey(StringStream& key) const
+{
+    for (unsigned int i=0; i < mTextureUnitParamsList.size(); ++i)
+    {
+        const TextureUnitParams& curParams = mTextureUnitParamsList[i];
+        TextureUnitState* texUnitState = curParams.mTextureUnitState;
+        const LayerBlendModeEx& colourBlend = texUnitState->getColourBlendMode();
+        const LayerBlendModeEx& alphaBlend  = texUnitState->getAlphaBlendMode();
+
+        key << '[' << curParams.mTextureSamplerIndex << ' ' << curParams.mTextureSamplerType
+            << ' ' << curParams.mVSInTextureCoordinateType << ' ' << curParams.mVSOutTextureCoordinateType
+            << ' ' << curParams.mTexCoordCalcMethod << ' ' << texUnitState->getTextureCoordSet()
+            << ' ' << needsTextureMatrix(texUnitState);
+
+        // Manual blend sources and factors end up as constants in the source.
+        const LayerBlendModeEx* blends[2] = { &colourBlend, &alphaBlend };
+        for (int j=0; j < 2; ++j)
+        {
+            const LayerBlendModeEx& blend = *blends[j];
+            key << ' ' << blend.operation << ' ' << blend.source1 << ' ' << blend.source2
+                << ' ' << blend.colourArg1 << ' ' << blend.colourArg2
+                << ' ' << blend.alphaArg1 << ' ' << blend.alphaArg2 << ' ' << blend.factor;
+        }
+        key << ']';
+    }
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void FFPTexturing::copyFrom(const SubRenderState& rhs)
 {
@@ -91,6 +91,19 @@ bool FFPTransform::createCpuSubPrograms(ProgramSet* programSet)
 }
 
 
+//-----------------------------------------------------------------------
+bool FFPTransform::resolveCpuSubPrograms(ProgramSet* programSet)
+{
+    // Resolving is all this sub render state does besides the transform invocation.
+    return createCpuSubPrograms(programSet);
+}
+
+//-----------------------------------------------------------------------
+bool FFPTransform::writeCacheKey(StringStream& key) const
+{
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void FFPTransform::copyFrom(const SubRenderState& rhs)
 {
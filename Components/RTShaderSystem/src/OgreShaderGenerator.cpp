@@ -43,6 +43,11 @@ THE SOFTWARE.
 #include "OgreHighLevelGpuProgramManager.h"
 #include "OgreShaderExTextureAtlasSampler.h"
 #include "OgreShaderExTriplanarTexturing.h"
+#include "OgreShaderExClusteredLighting.h"
+#include "OgreShaderExLodMorph.h"
+#include "OgreShaderProgramWriterManager.h"
+#include "OgreShaderProgramWriter.h"
+#include "Threading/OgreParallel.h"
 #include "OgreRoot.h"
 #include "OgreException.h"
 
@@ -76,7 +81,8 @@ ShaderGenerator::ShaderGenerator() :
     mActiveSceneMgr(NULL), mRenderObjectListener(NULL), mSceneManagerListener(NULL), mScriptTranslatorManager(NULL),
     mMaterialSerializerListener(NULL), mShaderLanguage(""), mProgramManager(NULL), mProgramWriterManager(NULL),
     mFSLayer(0), mFFPRenderStateBuilder(NULL),mActiveViewportValid(false), mVSOutputCompactPolicy(VSOCP_LOW),
-    mCreateShaderOverProgrammablePass(false), mIsFinalizing(false)
+    mCreateShaderOverProgrammablePass(false), mParallelProgramGeneration(false), mProgramBudget(0),
+    mIsFinalizing(false)
 {
     mLightCount[0]              = 0;
     mLightCount[1]              = 0;
@@ -210,6 +216,10 @@ void ShaderGenerator::createSubRenderStateExFactories()
         curFactory = OGRE_NEW HardwareSkinningFactory;  
         addSubRenderStateFactory(curFactory);
         mSubRenderStateExFactories[curFactory->getType()] = (curFactory);
+
+        curFactory = OGRE_NEW ClusteredLightingFactory;
+        addSubRenderStateFactory(curFactory);
+        mSubRenderStateExFactories[curFactory->getType()] = (curFactory);
     }
 
     curFactory = OGRE_NEW TextureAtlasSamplerFactory;
@@ -219,6 +229,10 @@ void ShaderGenerator::createSubRenderStateExFactories()
     curFactory = OGRE_NEW TriplanarTexturingFactory;
     addSubRenderStateFactory(curFactory);
     mSubRenderStateExFactories[curFactory->getType()] = (curFactory);
+
+    curFactory = OGRE_NEW LodMorphFactory;
+    addSubRenderStateFactory(curFactory);
+    mSubRenderStateExFactories[curFactory->getType()] = (curFactory);
 #endif
 }
 
@@ -1231,6 +1245,7 @@ void ShaderGenerator::flushShaderCache()
     }
 
     ProgramManager::getSingleton().flushGpuProgramsCache();
+    ProgramManager::getSingleton().flushProgramSourceCache();
     
     SGSchemeIterator itScheme = mSchemeEntriesMap.begin();
     SGSchemeIterator itSchemeEnd = mSchemeEntriesMap.end();
@@ -1542,6 +1557,7 @@ ShaderGenerator::SGPass::SGPass(SGTechnique* parent, Pass* srcPass, Pass* dstPas
 	mStage				= stage;
     mCustomRenderState  = NULL;
     mTargetRenderState  = NULL;
+    mProgramsGenerated  = false;
     mDstPass->getUserObjectBindings().setUserAny(SGPass::UserKey, Any(this));
 }
 
@@ -1563,6 +1579,7 @@ void ShaderGenerator::SGPass::buildTargetRenderState()
     
 
     mTargetRenderState = OGRE_NEW TargetRenderState;
+    mProgramsGenerated = false;
 
     // Set light properties.
     int lightCount[3] = {0};    
@@ -1604,7 +1621,45 @@ void ShaderGenerator::SGPass::buildTargetRenderState()
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGPass::acquirePrograms()
 {
-    ProgramManager::getSingleton().acquirePrograms(mDstPass, mTargetRenderState);
+    if (mProgramsGenerated == false)
+    {
+        ProgramManager::getSingleton().acquirePrograms(mDstPass, mTargetRenderState);
+        return;
+    }
+
+    mProgramsGenerated = false;
+    if (!mGenerateError.empty())
+    {
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, mGenerateError,
+            "ShaderGenerator::SGPass::acquirePrograms" );
+    }
+
+    ProgramManager::getSingleton().acquirePrograms(mDstPass, mTargetRenderState, mVSSource, mPSSource);
+    mVSSource.clear();
+    mPSSource.clear();
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGPass::generatePrograms()
+{
+    mGenerateError.clear();
+
+    // Each call writes with a program writer of its own, they keep state while writing.
+    ProgramWriter* programWriter = ProgramWriterManager::getSingleton().createProgramWriter(
+        ShaderGenerator::getSingleton().getTargetLanguage());
+    try
+    {
+        if (false == ProgramManager::getSingleton().generatePrograms(mTargetRenderState, programWriter, mVSSource, mPSSource))
+            mGenerateError = "Could not create gpu programs from render state ";
+    }
+    catch (Exception& e)
+    {
+        // Raised again by acquirePrograms, on the calling thread.
+        mGenerateError = e.getDescription();
+    }
+    OGRE_DELETE programWriter;
+
+    mProgramsGenerated = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -1668,7 +1723,7 @@ SubRenderState* ShaderGenerator::SGPass::getCustomFFPSubState(int subStateOrder,
 
 //-----------------------------------------------------------------------------
 ShaderGenerator::SGTechnique::SGTechnique(SGMaterial* parent, Technique* srcTechnique, const String& dstTechniqueSchemeName) :
-    mParent(parent), mSrcTechnique(srcTechnique), mDstTechnique(NULL), mBuildDstTechnique(true), mDstTechniqueSchemeName(dstTechniqueSchemeName)
+    mParent(parent), mSrcTechnique(srcTechnique), mDstTechnique(NULL), mBuildDstTechnique(true), mProgramsPending(false), mDstTechniqueSchemeName(dstTechniqueSchemeName)
 {
 }
 
@@ -1821,7 +1876,9 @@ void ShaderGenerator::SGTechnique::buildTargetRenderState()
     mDstTechnique   = mSrcTechnique->getParent()->createTechnique();
     mDstTechnique->getUserObjectBindings().setUserAny(SGTechnique::UserKey, Any(this));
     *mDstTechnique  = *mSrcTechnique;
-    mDstTechnique->setSchemeName(mDstTechniqueSchemeName);
+    // Keep the technique out of its scheme until its programs are acquired.
+    mDstTechnique->setSchemeName(mDstTechniqueSchemeName + "/Pending");
+    mProgramsPending = true;
     createSGPasses();
 
 
@@ -1839,6 +1896,17 @@ void ShaderGenerator::SGTechnique::acquirePrograms()
 	for(SGPassIterator itPass = mPassEntries.begin(); itPass != mPassEntries.end(); ++itPass)
 		if(!(*itPass)->isIlluminationPass())
 			(*itPass)->acquirePrograms();
+
+    mDstTechnique->setSchemeName(mDstTechniqueSchemeName);
+    mProgramsPending = false;
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGTechnique::generatePrograms()
+{
+    for (SGPassIterator itPass = mPassEntries.begin(); itPass != mPassEntries.end(); ++itPass)
+        if (!(*itPass)->isIlluminationPass())
+            (*itPass)->generatePrograms();
 }
 
 //-----------------------------------------------------------------------------
@@ -1884,6 +1952,7 @@ void ShaderGenerator::SGTechnique::releasePrograms()
         }
         mDstTechnique = NULL;
     }
+    mProgramsPending = false;
 
     // Release CPU/GPU programs that associated with this technique passes.
     for (SGPassIterator itPass = mPassEntries.begin(); itPass != mPassEntries.end(); ++itPass)
@@ -1993,6 +2062,14 @@ void ShaderGenerator::SGScheme::removeTechniqueEntry(SGTechnique* techEntry)
     }
 }
 
+//-----------------------------------------------------------------------------
+struct ShaderGenerator::SGScheme::ProgramGenerator
+{
+    const SGTechniqueList& techniques;
+    ProgramGenerator(const SGTechniqueList& t) : techniques(t) {}
+    void operator()(size_t i) const { techniques[i]->generatePrograms(); }
+};
+
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGScheme::validate()
 {   
@@ -2007,6 +2084,7 @@ void ShaderGenerator::SGScheme::validate()
         return;
     
     SGTechniqueIterator itTech;
+    SGTechniqueList pendingTechniques;
 
     // Build render state for each technique.
     for (itTech = mTechniqueEntries.begin(); itTech != mTechniqueEntries.end(); ++itTech)
@@ -2014,28 +2092,33 @@ void ShaderGenerator::SGScheme::validate()
         SGTechnique* curTechEntry = *itTech;
 
         if (curTechEntry->getBuildDestinationTechnique())
+        {
             curTechEntry->buildTargetRenderState();     
-    }
+            curTechEntry->setBuildDestinationTechnique(false);
+        }
 
-    // Acquire GPU programs for each technique.
-    for (itTech = mTechniqueEntries.begin(); itTech != mTechniqueEntries.end(); ++itTech)
-    {
-        SGTechnique* curTechEntry = *itTech;
-        
-        if (curTechEntry->getBuildDestinationTechnique())
-            curTechEntry->acquirePrograms();        
+        if (curTechEntry->getProgramsPending())
+            pendingTechniques.push_back(curTechEntry);
     }
 
-    // Turn off the build destination technique flag.
-    for (itTech = mTechniqueEntries.begin(); itTech != mTechniqueEntries.end(); ++itTech)
-    {
-        SGTechnique* curTechEntry = *itTech;
+    // Leave the techniques over the budget to the next validation.
+    size_t budget = ShaderGenerator::getSingleton().getProgramBudget();
+    bool upToDate = budget == 0 || pendingTechniques.size() <= budget;
+    if (!upToDate)
+        pendingTechniques.resize(budget);
+
+    // Generate the CPU programs and the program sources in parallel.
+    if (ShaderGenerator::getSingleton().getParallelProgramGeneration())
+        parallelFor(0, pendingTechniques.size(), ProgramGenerator(pendingTechniques));
 
-        curTechEntry->setBuildDestinationTechnique(false);
+    // Acquire GPU programs for each technique.
+    for (itTech = pendingTechniques.begin(); itTech != pendingTechniques.end(); ++itTech)
+    {
+        (*itTech)->acquirePrograms();        
     }
     
     // Mark this scheme as up to date.
-    mOutOfDate = false;
+    mOutOfDate = !upToDate;
 }
 
 //-----------------------------------------------------------------------------
@@ -2106,12 +2189,15 @@ bool ShaderGenerator::SGScheme::validate(const String& materialName, const Strin
             // Build render state for each technique.
             curTechEntry->buildTargetRenderState();
 
-            // Acquire the CPU/GPU programs.
-            curTechEntry->acquirePrograms();
-
             // Turn off the build destination technique flag.
             curTechEntry->setBuildDestinationTechnique(false);
 
+            // Acquire the CPU/GPU programs, or leave them to the scheme validation.
+            if (ShaderGenerator::getSingleton().getProgramBudget() == 0)
+                curTechEntry->acquirePrograms();
+            else
+                mOutOfDate = true;
+
 			return true;
         }                   
     }
@@ -91,24 +91,145 @@ ProgramManager::~ProgramManager()
 //-----------------------------------------------------------------------------
 void ProgramManager::acquirePrograms(Pass* pass, TargetRenderState* renderState)
 {
+    String vsSource, psSource;
+
+    // Create the CPU programs and the program sources.
+    if (false == generatePrograms(renderState,
+        getProgramWriter(ShaderGenerator::getSingleton().getTargetLanguage()), vsSource, psSource))
+    {
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+            "Could not apply render state ",
+            "ProgramManager::acquireGpuPrograms" );
+    }
+
+    acquirePrograms(pass, renderState, vsSource, psSource);
+}
+
+//-----------------------------------------------------------------------------
+bool ProgramManager::generatePrograms(TargetRenderState* renderState, ProgramWriter* programWriter,
+                                      String& vsSource, String& psSource)
+{
+    String cacheKey;
+    StringStream keyStream;
+
+    // Render states with the same key share their sources, so look them up before generating.
+    if (renderState->writeCacheKey(keyStream))
+    {
+        ShaderGenerator& shaderGenerator = ShaderGenerator::getSingleton();
+
+        keyStream << shaderGenerator.getTargetLanguage() << ' ' << shaderGenerator.getTargetLanguageVersion()
+            << ' ' << shaderGenerator.getVertexShaderProfiles() << ' ' << shaderGenerator.getFragmentShaderProfiles()
+            << ' ' << GpuProgramManager::getSingleton().isSyntaxSupported("vs_4_0_level_9_1");
+        cacheKey = generateHash(keyStream.str());
+
+        if (getCachedProgramSources(cacheKey, vsSource, psSource))
+            return renderState->createCpuPrograms(true);
+    }
+
     // Create the CPU programs.
     if (false == renderState->createCpuPrograms())
+        return false;
+
+    if (false == writeGpuProgramSources(renderState->getProgramSet(), programWriter, vsSource, psSource))
+        return false;
+
+    if (!cacheKey.empty())
+        addCachedProgramSources(cacheKey, vsSource, psSource);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool ProgramManager::getCachedProgramSources(const String& cacheKey, String& vsSource, String& psSource)
+{
     {
-        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
-            "Could not apply render state ", 
-            "ProgramManager::acquireGpuPrograms" ); 
-    }   
+        OGRE_WQ_LOCK_MUTEX(mProgramSourceCacheMutex);
+        ProgramSourceCacheIterator it = mProgramSourceCache.find(cacheKey);
+
+        if (it != mProgramSourceCache.end())
+        {
+            vsSource = it->second.first;
+            psSource = it->second.second;
+            return true;
+        }
+    }
+
+    const String& cachePath = ShaderGenerator::getSingleton().getShaderCachePath();
+
+    if (cachePath.empty())
+        return false;
+
+    // The file holds the length of both sources followed by the sources themselves.
+    std::ifstream cacheFile((cachePath + cacheKey + ".rtss").c_str(), std::ios::in | std::ios::binary);
+    size_t vsLength = 0;
+    size_t psLength = 0;
+
+    if (!(cacheFile >> vsLength >> psLength) || vsLength == 0 || psLength == 0)
+        return false;
+    cacheFile.get();
+
+    String vsCached(vsLength, ' ');
+    String psCached(psLength, ' ');
+    cacheFile.read(&vsCached[0], vsLength);
+    cacheFile.read(&psCached[0], psLength);
+
+    if (!cacheFile)
+        return false;
+
+    OGRE_WQ_LOCK_MUTEX(mProgramSourceCacheMutex);
+    mProgramSourceCache[cacheKey] = std::make_pair(vsCached, psCached);
+    vsSource = vsCached;
+    psSource = psCached;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::addCachedProgramSources(const String& cacheKey, const String& vsSource, const String& psSource)
+{
+    {
+        OGRE_WQ_LOCK_MUTEX(mProgramSourceCacheMutex);
+        mProgramSourceCache[cacheKey] = std::make_pair(vsSource, psSource);
+    }
+
+    const String& cachePath = ShaderGenerator::getSingleton().getShaderCachePath();
+
+    if (cachePath.empty())
+        return;
+
+    std::ofstream cacheFile((cachePath + cacheKey + ".rtss").c_str(), std::ios::out | std::ios::binary);
 
+    if (cacheFile)
+        cacheFile << vsSource.size() << ' ' << psSource.size() << '\n' << vsSource << psSource;
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::flushProgramSourceCache()
+{
+    OGRE_WQ_LOCK_MUTEX(mProgramSourceCacheMutex);
+    mProgramSourceCache.clear();
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::acquirePrograms(Pass* pass, TargetRenderState* renderState, 
+                                     const String& vsSource, const String& psSource)
+{
     ProgramSet* programSet = renderState->getProgramSet();
 
     // Create the GPU programs.
-    if (false == createGpuPrograms(programSet))
+    if (programSet == NULL || false == createGpuPrograms(programSet, vsSource, psSource))
     {
         OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
             "Could not create gpu programs from render state ", 
                         "ProgramManager::acquireGpuPrograms" );
     }   
 
+    bindPrograms(pass, programSet);
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::bindPrograms(Pass* pass, ProgramSet* programSet)
+{
     // Bind the created GPU programs to the target pass.
     pass->setVertexProgram(programSet->getGpuVertexProgram()->getName());
     pass->setFragmentProgram(programSet->getGpuFragmentProgram()->getName());
@@ -116,7 +237,6 @@ void ProgramManager::acquirePrograms(Pass* pass, TargetRenderState* renderState)
     // Bind uniform parameters to pass parameters.
     bindUniformParameters(programSet->getCpuVertexProgram(), pass->getVertexProgramParameters());
     bindUniformParameters(programSet->getCpuFragmentProgram(), pass->getFragmentProgramParameters());
-
 }
 
 //-----------------------------------------------------------------------------
@@ -253,6 +373,7 @@ Program* ProgramManager::createCpuProgram(GpuProgramType type)
 {
     Program* shaderProgram = OGRE_NEW Program(type);
 
+    OGRE_WQ_LOCK_MUTEX(mCpuProgramsMutex);
     mCpuProgramsList.insert(shaderProgram);
 
     return shaderProgram;
@@ -262,6 +383,7 @@ Program* ProgramManager::createCpuProgram(GpuProgramType type)
 //-----------------------------------------------------------------------------
 void ProgramManager::destroyCpuProgram(Program* shaderProgram)
 {
+    OGRE_WQ_LOCK_MUTEX(mCpuProgramsMutex);
     ProgramListIterator it    = mCpuProgramsList.find(shaderProgram);
     
     if (it != mCpuProgramsList.end())
@@ -272,7 +394,24 @@ void ProgramManager::destroyCpuProgram(Program* shaderProgram)
 }
 
 //-----------------------------------------------------------------------------
-bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
+ProgramWriter* ProgramManager::getProgramWriter(const String& language)
+{
+    ProgramWriterIterator itWriter = mProgramWritersMap.find(language);
+
+    // No writer found -> create new one.
+    if (itWriter == mProgramWritersMap.end())
+    {
+        ProgramWriter* programWriter = ProgramWriterManager::getSingletonPtr()->createProgramWriter(language);
+        mProgramWritersMap[language] = programWriter;
+        return programWriter;
+    }
+
+    return itWriter->second;
+}
+
+//-----------------------------------------------------------------------------
+bool ProgramManager::writeGpuProgramSources(ProgramSet* programSet, ProgramWriter* programWriter,
+                                            String& vsSource, String& psSource)
 {
     // Before we start we need to make sure that the pixel shader input
     //  parameters are the same as the vertex output, this required by 
@@ -285,22 +424,7 @@ bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
         synchronizePixelnToBeVertexOut(programSet);
     }
 
-    // Grab the matching writer.
     const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
-    ProgramWriterIterator itWriter = mProgramWritersMap.find(language);
-    ProgramWriter* programWriter = NULL;
-
-    // No writer found -> create new one.
-    if (itWriter == mProgramWritersMap.end())
-    {
-        programWriter = ProgramWriterManager::getSingletonPtr()->createProgramWriter(language);
-        mProgramWritersMap[language] = programWriter;
-    }
-    else
-    {
-        programWriter = itWriter->second;
-    }
-
     ProgramProcessorIterator itProcessor = mProgramProcessorsMap.find(language);
     ProgramProcessor* programProcessor = NULL;
 
@@ -313,18 +437,34 @@ bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
 
     programProcessor = itProcessor->second;
 
-    bool success;
-    
     // Call the pre creation of GPU programs method.
-    success = programProcessor->preCreateGpuPrograms(programSet);
-    if (success == false)   
+    if (false == programProcessor->preCreateGpuPrograms(programSet))
         return false;   
+
+    // Generate source code.
+    stringstream vsSourceStream;
+    programWriter->writeSourceCode(vsSourceStream, programSet->getCpuVertexProgram());
+    vsSource = vsSourceStream.str();
+
+    stringstream psSourceStream;
+    programWriter->writeSourceCode(psSourceStream, programSet->getCpuFragmentProgram());
+    psSource = psSourceStream.str();
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool ProgramManager::createGpuPrograms(ProgramSet* programSet, const String& vsSource, const String& psSource)
+{
+    const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
+    ProgramProcessor* programProcessor = mProgramProcessorsMap[language];
+    bool success;
     
     // Create the vertex shader program.
     GpuProgramPtr vsGpuProgram;
     
     vsGpuProgram = createGpuProgram(programSet->getCpuVertexProgram(), 
-        programWriter,
+        vsSource,
         language, 
         ShaderGenerator::getSingleton().getVertexShaderProfiles(),
         ShaderGenerator::getSingleton().getVertexShaderProfilesList(),
@@ -342,7 +482,7 @@ bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
     GpuProgramPtr psGpuProgram;
 
     psGpuProgram = createGpuProgram(programSet->getCpuFragmentProgram(), 
-        programWriter,
+        psSource,
         language, 
         ShaderGenerator::getSingleton().getFragmentShaderProfiles(),
         ShaderGenerator::getSingleton().getFragmentShaderProfilesList(),
@@ -380,17 +520,13 @@ void ProgramManager::bindUniformParameters(Program* pCpuProgram, const GpuProgra
 
 //-----------------------------------------------------------------------------
 GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram, 
-                                               ProgramWriter* programWriter,
+                                               const String& generatedSource,
                                                const String& language,
                                                const String& profiles,
                                                const StringVector& profilesList,
                                                const String& cachePath)
 {
-    stringstream sourceCodeStringStream;
-
-    // Generate source code.
-    programWriter->writeSourceCode(sourceCodeStringStream, shaderProgram);
-    String source = sourceCodeStringStream.str();
+    String source = generatedSource;
 
     // Generate program name.
     String programName = generateHash(source);
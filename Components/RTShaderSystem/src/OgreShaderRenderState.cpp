@@ -162,7 +162,7 @@ void TargetRenderState::removeSubRenderStateInstance(SubRenderState* subRenderSt
 }
 
 //-----------------------------------------------------------------------
-bool TargetRenderState::createCpuPrograms()
+bool TargetRenderState::createCpuPrograms(bool resolveOnly)
 {
     sortSubRenderStates();
 
@@ -186,7 +186,10 @@ bool TargetRenderState::createCpuPrograms()
     {
         SubRenderState* srcSubRenderState = *it;
 
-        if (false == srcSubRenderState->createCpuSubPrograms(programSet))
+        bool success = resolveOnly ? srcSubRenderState->resolveCpuSubPrograms(programSet) :
+            srcSubRenderState->createCpuSubPrograms(programSet);
+
+        if (false == success)
         {
             LogManager::getSingleton().stream() << "RTShader::TargetRenderState : Could not generate sub render program of type: " << srcSubRenderState->getType();
             return false;
@@ -196,6 +199,24 @@ bool TargetRenderState::createCpuPrograms()
     return true;
 }
 
+//-----------------------------------------------------------------------
+bool TargetRenderState::writeCacheKey(StringStream& key)
+{
+    sortSubRenderStates();
+
+    for (SubRenderStateListIterator it=mSubRenderStateList.begin(); it != mSubRenderStateList.end(); ++it)
+    {
+        SubRenderState* curSubRenderState = *it;
+
+        key << curSubRenderState->getType() << '(';
+        if (false == curSubRenderState->writeCacheKey(key))
+            return false;
+        key << ')';
+    }
+
+    return true;
+}
+
 //-----------------------------------------------------------------------
 ProgramSet* TargetRenderState::createProgramSet()
 {
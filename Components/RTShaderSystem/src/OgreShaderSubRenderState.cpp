@@ -146,6 +146,12 @@ bool SubRenderState::createCpuSubPrograms(ProgramSet* programSet)
     return true;
 }
 
+//-----------------------------------------------------------------------
+bool SubRenderState::resolveCpuSubPrograms(ProgramSet* programSet)
+{
+    return resolveParameters(programSet) && resolveDependencies(programSet);
+}
+
 //-----------------------------------------------------------------------
 bool SubRenderState::resolveParameters(ProgramSet* programSet)
 {
@@ -49,6 +49,10 @@ namespace Ogre
     *  @{
     */
 
+    class TerrainHeightSnapshot;
+    class TerrainPatchRenderer;
+    typedef SharedPtr<const TerrainHeightSnapshot> TerrainHeightSnapshotPtr;
+
     /** The main containing class for a chunk of terrain.
     @par
         Terrain can be edited and stored.
@@ -690,6 +694,22 @@ namespace Ogre
             this form.
         */
         void save(StreamSerialiser& stream);
+        /** Save terrain data in native form into memory, to be written to a file later.
+        @remarks
+            Does what save(const String&) does except for the compression, which
+            is left to StreamSerialiser::writeDeferred. That and the writing of
+            the file can then be done on another thread while the terrain goes on
+            being used and edited, see TerrainGroup::saveAllTerrains.
+            Call _notifySaved once the file is written.
+        @return A deferred serialiser holding the data, to be deleted with OGRE_DELETE
+        */
+        StreamSerialiser* saveDeferred();
+        /** Notify the terrain that the data of saveDeferred was written.
+        @param filename The file the data was written to
+        @param succeeded Whether it was written, if not the terrain is marked as
+            modified again
+        */
+        void _notifySaved(const String& filename, bool succeeded);
 
         /** Prepare the terrain from a standalone file.
         @note
@@ -784,6 +804,9 @@ namespace Ogre
             This pointer is not const, so you can update the height data if you
             wish. However, changes will not be propagated until you call 
             Terrain::dirty or Terrain::dirtyRect.
+        @par
+            If the height data was compressed (see compressHeightData), it is
+            unpacked first, so only call this from the main thread.
         */
         float* getHeightData() const;
 
@@ -824,11 +847,23 @@ namespace Ogre
         */
         float getHeightAtWorldPosition(const Vector3& pos) const;
 
+        /** Get the heights for a batch of world positions, see getHeightAtWorldPosition.
+        @param positions Array of count positions in world space
+        @param count Number of positions
+        @param heights Array of count heights to write the results to
+        @remarks The positions are spread over the worker threads. This can be 
+        called from any thread as long as no parallel write to the heightmap data occurs.
+        */
+        void getHeightsAtWorldPositions(const Vector3* positions, size_t count, float* heights) const;
+
         /** Get a pointer to all the delta data for this terrain.
         @remarks
             The delta data is a measure at a given vertex of by how much vertically
             a vertex will have to move to reach the point at which it will be
             removed in the next lower LOD.
+        @par
+            If the delta data was compressed (see compressHeightData), it is
+            unpacked first, so only call this from the main thread.
         */
         const float* getDeltaData() const;
 
@@ -1316,6 +1351,26 @@ namespace Ogre
          */
         std::pair<bool, Vector3> rayIntersects(const Ray& ray, 
             bool cascadeToNeighbours = false, Real distanceLimit = 0); //const;
+
+        /** Test a batch of rays for intersection with this terrain only.
+        @param rays Array of count rays to test
+        @param count Number of rays
+        @param results Array of count results to write to, each containing whether
+            the ray hit the terrain and, if so, where.
+        @remarks The rays are spread over the worker threads. This can be called
+        from any thread as long as no parallel write to the heightmap data occurs.
+        */
+        void rayIntersects(const Ray* rays, size_t count, std::pair<bool, Vector3>* results) const;
+
+        /** Get the latest snapshot of the heights of this terrain, which can be 
+            queried from any thread.
+        @remarks
+            This never blocks, so it can be called every tick from simulation
+            threads while the terrain is being loaded, edited or having its derived
+            data updated. Returns a null pointer before the terrain is prepared.
+            See TerrainHeightSnapshot for when a new snapshot is published.
+        */
+        TerrainHeightSnapshotPtr getHeightSnapshot() const;
         
         /// Get the AABB (local coords) of the entire terrain
         const AxisAlignedBox& getAABB() const;
@@ -1452,9 +1507,31 @@ namespace Ogre
             freed. You might want to do this for example when you are finished
             editing a particular terrain and want to have optimal runtime
             efficiency.
+        @par
+            If TerrainGlobalOptions::getCompressHeightData is set, this also
+            calls compressHeightData.
         */
         void freeTemporaryResources();
 
+        /** Pack the height and delta data to 16 bits per sample to save memory.
+        @remarks
+            The samples are quantised in blocks of COMPRESSED_HEIGHT_BLOCK_SIZE
+            squared, each with its own offset and scale, so the error is at most
+            1/131070 of the height range of a block. Height and ray queries read
+            the packed samples they need directly. Anything needing the raw data,
+            like editing, getHeightData, updating derived data or streaming in 
+            a higher LOD, unpacks it again.
+        @note
+            Compression is lossy: after unpacking, the heights are the quantised
+            ones and not the originals.
+        */
+        void compressHeightData();
+        /// Whether the height data is currently compressed, see compressHeightData
+        bool isHeightDataCompressed() const { return !mHeightData && mCompressedHeightData; }
+
+        /// Size of the blocks of samples compressHeightData quantises together
+        static const uint16 COMPRESSED_HEIGHT_BLOCK_SIZE;
+
         /** Get a blend texture with a given index.
         @param index The blend texture index (note: not layer index; derive
         the texture index from getLayerBlendTextureIndex)
@@ -1533,6 +1610,31 @@ namespace Ogre
 
         /// Whether we're using vertex compression or not
         bool _getUseVertexCompression() const; 
+
+        /** Whether nodes are drawn as instanced patches reading the height texture,
+            see TerrainGlobalOptions::setUseInstancedPatches.
+        */
+        bool _getUseInstancedPatches() const;
+
+        /** Return the terrain to the state it was in when constructed, so that it
+            can be prepared and loaded again with other data, internal use.
+        @remarks
+            The scene node, listener and request handlers are kept, everything
+            else is released. Nothing is done, and false returned, while the
+            terrain is still preparing or generating its material in the background.
+        */
+        bool _resetForReuse();
+
+        /// Get the renderer used for instanced patches (only valid while loaded in that mode)
+        TerrainPatchRenderer* _getPatchRenderer() const { return mPatchRenderer; }
+
+        /** Get the floating point copy of the heights, if one exists.
+        @remarks
+            This is only kept when the derived maps are rendered on the GPU or
+            nodes are drawn as instanced patches. Rows are stored top to bottom,
+            ie the Y axis is inverted compared to the height data.
+        */
+        const TexturePtr& getHeightTexture() const { return mHeightTexture; }
         
         /// WorkQueue::RequestHandler override
         bool canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
@@ -1693,7 +1795,115 @@ namespace Ogre
         void getPointAlign(long x, long y, float height, Alignment align, Vector3* outpos) const;
         void calculateCurrentLod(Viewport* vp);
         /// Test a single quad of the terrain for ray intersection.
-        std::pair<bool, Vector3> checkQuadIntersection(int x, int y, const Ray& ray); //const;
+        /// Range of heights of an area of the terrain
+        struct HeightRange
+        {
+            float minHeight;
+            float maxHeight;
+        };
+        typedef vector<HeightRange>::type HeightRangeList;
+        typedef vector<HeightRangeList>::type HeightRangePyramid;
+        /// Offset and scale to decode a block of 16 bit quantised samples
+        struct QuantisedRange
+        {
+            float offset;
+            float scale;
+
+            float decode(uint16 value) const { return offset + value * scale; }
+        };
+        /** Quantise a block of samples to 16 bits.
+        @param src, dst Rows of width samples, srcStride and dstStride samples apart
+        @return The range to decode the block with
+        */
+        static QuantisedRange quantise(const float* src, size_t srcStride, 
+            uint16* dst, size_t dstStride, size_t width, size_t height);
+        /// Height and delta data packed by compressHeightData
+        struct CompressedHeightData
+        {
+            uint16 size;
+            uint16 blocksPerSide;
+            vector<uint16>::type heights;
+            vector<uint16>::type deltas;
+            vector<QuantisedRange>::type heightRanges;
+            vector<QuantisedRange>::type deltaRanges;
+
+            CompressedHeightData(const float* heightData, const float* deltaData, uint16 size);
+            float getHeight(long x, long y) const
+            {
+                size_t block = (y / COMPRESSED_HEIGHT_BLOCK_SIZE) * blocksPerSide + x / COMPRESSED_HEIGHT_BLOCK_SIZE;
+                return heightRanges[block].decode(heights[y * size + x]);
+            }
+            void decompress(float* heightData, float* deltaData) const;
+        };
+        /// Shared with the snapshots published while compressed
+        typedef SharedPtr<const CompressedHeightData> CompressedHeightDataPtr;
+
+        /// Heights and height ranges to run queries on, either our own or a snapshot's
+        struct HeightQueryData
+        {
+            /// Full heights, or null to use compressedHeights
+            const float* heights;
+            const CompressedHeightData* compressedHeights;
+            const HeightRangePyramid* heightRanges;
+            uint16 size;
+            Real worldSize;
+            Vector3 position;
+            Alignment alignment;
+
+            float getHeight(long x, long y) const
+            {
+                return heights ? heights[y * size + x] : compressedHeights->getHeight(x, y);
+            }
+        };
+        HeightQueryData getHeightQueryData() const;
+        /// Unclamped height at a point, without unpacking compressed heights
+        float getStoredHeight(long x, long y) const;
+        /// Restore the full height and delta data if it's compressed
+        void decompressHeightData();
+
+        /// Test a ray in vertex space for intersection with a single quad
+        static std::pair<bool, Vector3> checkQuadIntersection(const HeightQueryData& data, 
+            int x, int z, const Ray& ray);
+        /// Test a ray for intersection with the heights in data only, not neighbours
+        static std::pair<bool, Vector3> rayIntersectsHeights(const HeightQueryData& data, const Ray& ray);
+        /** Test a ray in vertex space against a node of the height range pyramid
+            and its children, nearest first.
+        */
+        static bool rayIntersectsHeightRange(const HeightQueryData& data, const Ray& localRay, 
+            size_t level, long x, long z, Vector3* hit);
+        /** Interpolate the height at terrain space x, y on the triangles of the 
+            quad starting at point startX, startY, from the heights of its corners
+            in the order bottom left, bottom right, top right, top left.
+        */
+        static float interpolateQuadHeight(uint16 size, Real x, Real y, 
+            long startX, long startY, const float cornerHeights[4]);
+        /// Update the height range pyramid for changes of the heights in rect
+        void updateHeightRanges(const Rect& rect);
+        /// Make a copy of the heights available to getHeightSnapshot
+        void publishHeightSnapshot();
+        friend class TerrainHeightSnapshot;
+
+        /// Spreads batched ray and height queries over the worker threads
+        class QueryJob;
+        friend class QueryJob;
+
+        /// Processes rows of normals and lightmap, or levels of height deltas, in parallel
+        class DerivedDataJob;
+        friend class DerivedDataJob;
+        /// Get the area of height deltas affected by changes in rect at a LOD level
+        Rect getHeightDeltaRect(const Rect& rect, int targetLevel) const;
+        /// Calculate the height deltas of vertices removed at a LOD level, see calculateHeightDeltas
+        void calculateHeightDeltasAtLevel(const Rect& rect, int targetLevel);
+        /// Calculate the normals of rows [top, bottom) of rect into the data of calculateNormals
+        void calculateNormalsRows(const Rect& rect, uint8* pData, long top, long bottom) const;
+        /// Calculate the lightmap of rows [top, bottom) of rect into the data of calculateLightmap
+        void calculateLightmapRows(const Rect& rect, uint8* pData, long top, long bottom);
+        /// Get the area of the lightmap, in lightmap space, affected by changes in rect
+        Rect getLightmapUpdateRect(const Rect& rect, const Rect& extraTargetRect);
+        /// Render the requested normal map and lightmap on the GPU, returns the types done
+        uint8 renderDerivedDataOnGpu(const Rect& rect, const Rect& lightmapExtraRect, uint8 typeMask);
+        /// Copy the heights in rect into the floating point texture used by renderDerivedDataOnGpu
+        void updateGPUHeightTexture(const Rect& rect);
 
         /// Delete blend maps for all layers >= lowIndex
         void deleteBlendMaps(uint8 lowIndex);
@@ -1737,6 +1947,16 @@ namespace Ogre
         float* mHeightData;
         /// The delta information defining how a vertex moves before it is removed at a lower LOD
         float* mDeltaData;
+        /** Height ranges of each quad in level 0, then of 2x2 nodes of the level
+            below in each following level, up to a single node for the whole terrain.
+            This is used to skip over areas that a ray can't hit.
+        */
+        HeightRangePyramid mHeightRanges;
+        /// Latest snapshot of the heights, only accessed under mHeightSnapshotMutex
+        TerrainHeightSnapshotPtr mHeightSnapshot;
+        OGRE_WQ_MUTEX(mHeightSnapshotMutex);
+        /// Replaces mHeightData and mDeltaData while compressed
+        CompressedHeightDataPtr mCompressedHeightData;
         Alignment mAlign;
         Real mWorldSize;
         uint16 mSize;
@@ -1767,6 +1987,8 @@ namespace Ogre
         bool mDerivedDataUpdateInProgress;
         /// If another update is requested while one is already running
         uint8 mDerivedUpdatePendingMask;
+        /// Request of the running derived data update, promoted when waiting for it
+        WorkQueue::RequestID mDerivedDataRequestID;
 
         bool mGenerateMaterialInProgress;
         /// Don't release Height/DeltaData when preparing
@@ -1867,6 +2089,10 @@ namespace Ogre
         bool mCompositeMapRequired;
         /// Texture storing normals for the whole terrrain
         TexturePtr mTerrainNormalMap;
+        /// Heights as a texture, only used when rendering derived data on the GPU or instanced patches
+        TexturePtr mHeightTexture;
+        /// Draws the nodes when using instanced patches
+        TerrainPatchRenderer* mPatchRenderer;
 
         /// Pending data 
         PixelBox* mCpuTerrainNormalMap;
@@ -1884,6 +2110,9 @@ namespace Ogre
         size_t getDeltaBufVertexSize() const;
 
         TerrainLodManager* mLodManager;
+        Real mLodStreamingPriority;
+        /// Whether the LOD data file was closed by saveDeferred, to reopen in _notifySaved
+        bool mReopenLodData;
 
     public:
         /** Increase Terrain's LOD level by 1
@@ -1898,6 +2127,62 @@ namespace Ogre
         int getHighestLodPrepared() const { return (mLodManager) ? mLodManager->getHighestLodPrepared() : -1; };
         int getHighestLodLoaded() const { return (mLodManager) ? mLodManager->getHighestLodLoaded() : -1; };
         int getTargetLodLevel() const { return (mLodManager) ? mLodManager->getTargetLodLevel() : -1; };
+
+        /** Set how urgently LOD data for this terrain should be streamed in.
+        @remarks
+            When more terrains are waiting to stream LOD levels than 
+            TerrainGlobalOptions::getMaxConcurrentLodRequests allows, the ones
+            with the lowest value are served first. TerrainAutoUpdateLodByDistance
+            sets this to the distance from the camera. The default is 0.
+        */
+        void setLodStreamingPriority(Real priority) { mLodStreamingPriority = priority; }
+        /// Get how urgently LOD data for this terrain should be streamed in, lower is sooner
+        Real getLodStreamingPriority() const { return mLodStreamingPriority; }
+    };
+
+
+    /** Immutable copy of the heights of a Terrain, to query from any thread.
+    @remarks
+        A Terrain publishes a new snapshot when it has been prepared, moved or
+        resized, and when updateGeometry applies changed heights. Get the latest
+        one with Terrain::getHeightSnapshot, without locking. A snapshot stays
+        valid for as long as it's referenced, even if the terrain is changed,
+        unloaded or destroyed meanwhile, so readers never see torn data.
+    @par
+        Queries use the full resolution heights, whichever LOD is loaded. The
+        snapshot of a terrain with compressed heights shares them instead of
+        copying.
+    */
+    class _OgreTerrainExport TerrainHeightSnapshot : public TerrainAlloc
+    {
+    public:
+        /// Copy the current heights of a prepared terrain
+        explicit TerrainHeightSnapshot(const Terrain& terrain);
+
+        /** Get the height at a world position, projecting the point down on to
+            the terrain. Positions are clamped to the edge of the terrain.
+        */
+        float getHeightAtWorldPosition(const Vector3& pos) const;
+        /** Test for intersection of a ray with the terrain.
+        @return A pair which contains whether the ray hit the terrain and, if so, where.
+        */
+        std::pair<bool, Vector3> rayIntersects(const Ray& ray) const;
+        /// Get the AABB (world coords) of the heights
+        const AxisAlignedBox& getWorldAABB() const { return mWorldAABB; }
+        /// Get the size of the terrain in vertices along one side
+        uint16 getSize() const { return mData.size; }
+        /// Get the world position of the terrain centre
+        const Vector3& getPosition() const { return mData.position; }
+
+    protected:
+        float getHeightAtPoint(long x, long y) const;
+
+        /// Copy of the heights, or empty if they're shared compressed ones
+        vector<float>::type mHeights;
+        Terrain::CompressedHeightDataPtr mCompressedHeights;
+        Terrain::HeightRangePyramid mHeightRanges;
+        Terrain::HeightQueryData mData;
+        AxisAlignedBox mWorldAABB;
     };
 
 
@@ -1933,6 +2218,11 @@ namespace Ogre
         Real mCompositeMapDistance;
         String mResourceGroup;
         bool mUseVertexCompressionWhenAvailable;
+        bool mDerivedMapsOnGpu;
+        bool mCompressHeightData;
+        bool mUseInstancedPatches;
+        uint32 mMaxConcurrentLodRequests;
+        size_t mTerrainPoolSize;
 
     public:
         TerrainGlobalOptions();
@@ -2113,6 +2403,94 @@ namespace Ogre
          */
         void setUseVertexCompressionWhenAvailable(bool enable) { mUseVertexCompressionWhenAvailable = enable; }
 
+        /** Get whether the normal map and lightmap are rendered on the GPU when
+            the material generator supports it.
+        */
+        bool getDerivedMapsOnGpu() const { return mDerivedMapsOnGpu; }
+
+        /** Set whether the normal map and lightmap are rendered on the GPU when
+            the material generator supports it.
+        @remarks
+            When enabled, the normal map and lightmap are rendered straight into
+            their textures from a floating point copy of the height data, in the 
+            render thread, instead of being calculated in the background and 
+            uploaded. This avoids a CPU round trip when deforming terrain. Shadows
+            cast by neighbouring terrains are not considered in this mode, and
+            the edge normals are clamped rather than taken from neighbours.
+            The default is false.
+        */
+        void setDerivedMapsOnGpu(bool enable) { mDerivedMapsOnGpu = enable; }
+
+        /** Get whether height data is stored compressed, see setCompressHeightData.
+        */
+        bool getCompressHeightData() const { return mCompressHeightData; }
+
+        /** Set whether height data is stored compressed.
+        @remarks
+            When enabled, Terrain::save quantises the height and delta data to
+            16 bits per sample in blocks with their own offset and scale, and
+            Terrain::freeTemporaryResources compresses the data kept in memory
+            the same way (see Terrain::compressHeightData). This roughly halves
+            the memory and file size used by heights, at the cost of a small
+            loss of precision. Files saved either way can be loaded regardless
+            of this setting. The default is false.
+        */
+        void setCompressHeightData(bool compress) { mCompressHeightData = compress; }
+
+        /** Get whether terrain is drawn with instanced patches when available,
+            see setUseInstancedPatches.
+        */
+        bool getUseInstancedPatches() const { return mUseInstancedPatches; }
+
+        /** Set whether terrain is drawn with instanced patches when available.
+        @remarks
+            When enabled, and the material generator and hardware support vertex
+            texture fetch and instancing, quadtree nodes do not own any vertex or
+            index buffers. Instead, one shared grid patch of minBatchSize vertices
+            per side is instanced over every visible node, and the heights are
+            read from a floating point height texture in the vertex shader. This
+            saves GPU memory and makes LOD changes free, at the cost of the terrain
+            not casting dynamic shadows. Vertex compression must also be in use.
+        @note You should only call this before loading any terrain instances.
+            The default is false.
+        */
+        void setUseInstancedPatches(bool enable) { mUseInstancedPatches = enable; }
+
+        /** Get the maximum number of LOD streaming requests in the background
+            at any one time, see setMaxConcurrentLodRequests.
+        */
+        uint32 getMaxConcurrentLodRequests() const { return mMaxConcurrentLodRequests; }
+
+        /** Set the maximum number of LOD streaming requests in the background
+            at any one time, across all terrains.
+        @remarks
+            LOD levels are streamed in one at a time, coarsest first. Terrains
+            needing more data than can be requested at once wait in a queue
+            ordered by Terrain::getLodStreamingPriority, and drop out of it if
+            they no longer need the data before their turn comes. This bounds
+            the disk bandwidth spent on LOD data so that near terrains don't 
+            wait behind far ones. 0 means no limit. The default is 2.
+        */
+        void setMaxConcurrentLodRequests(uint32 count) { mMaxConcurrentLodRequests = count; }
+
+        /** Get the number of unloaded Terrain instances a TerrainGroup keeps for
+            reuse, see setTerrainPoolSize.
+        */
+        size_t getTerrainPoolSize() const { return mTerrainPoolSize; }
+
+        /** Set the number of unloaded Terrain instances a TerrainGroup keeps for
+            reuse.
+        @remarks
+            When paging, terrains are unloaded and loaded all the time. Rather than
+            destroying an unloaded instance, TerrainGroup keeps up to this many of
+            them and loads the next terrain into one, which saves recreating its
+            scene node and request handlers; its vertex buffers are returned to the
+            group's GpuBufferAllocator for the next one as well. Set this to about
+            the number of pages that are unloaded at once. The default is 0,
+            which destroys every unloaded instance.
+        */
+        void setTerrainPoolSize(size_t count) { mTerrainPoolSize = count; }
+
         /// @copydoc Singleton::getSingleton()
         static TerrainGlobalOptions& getSingleton(void);
         /// @copydoc Singleton::getSingleton()
@@ -37,6 +37,8 @@ THE SOFTWARE.
 namespace Ogre
 {
     class TerrainAutoUpdateLod;
+    class TerrainGroupHeightSnapshot;
+    typedef SharedPtr<const TerrainGroupHeightSnapshot> TerrainGroupHeightSnapshotPtr;
 
     /** \addtogroup Optional
     *  @{
@@ -261,7 +263,8 @@ namespace Ogre
         @remarks
             This destroys the Terrain instance but retains the slot definition (so
             it would be reloaded next time you call loadAllTerrains() if you did not
-            remove it beforehand).
+            remove it beforehand). If TerrainGlobalOptions::getTerrainPoolSize allows,
+            the instance is kept for reuse by the next terrain to load instead.
         @note
             While the definition of the terrain is kept, if you used import data
             to populate it, this will have been lost so repeat loading cannot occur. 
@@ -280,9 +283,19 @@ namespace Ogre
         virtual void removeTerrain(long x, long y);
 
         /** Remove all terrain instances. 
+        @remarks
+            This also destroys the instances kept for reuse, see clearTerrainPool.
         */
         void removeAllTerrains();
 
+        /** Destroy the unloaded Terrain instances kept for reuse.
+        @see TerrainGlobalOptions::setTerrainPoolSize
+        */
+        void clearTerrainPool();
+
+        /// Get the number of unloaded Terrain instances kept for reuse
+        size_t getTerrainPoolCount() const { return mTerrainPool.size(); }
+
         /** Save all terrain instances using the assigned file names, or
             via the filename convention.
         @see setFilenameConvention
@@ -296,8 +309,19 @@ namespace Ogre
             This is recommended since it makes everything more consistent, although
             you might want to use manual filenames in the original definition to import 
             previously separate data. 
+        @param synchronous If false, only the serialisation of the terrains into memory
+            is done here. Compressing the data and writing the files is done through
+            the WorkQueue, one request per terrain, so several files are compressed at
+            once and the frame isn't held up by the disk. Each file is written next to
+            the old one and then renamed over it, so a failed save keeps the old file.
+            A terrain still being saved is skipped, @see isSaveInProgress.
+        */
+        void saveAllTerrains(bool onlyIfModified, bool replaceManualFilenames = true,
+            bool synchronous = true);
+
+        /** Whether terrains saved with saveAllTerrains(..., false) are still being written.
         */
-        void saveAllTerrains(bool onlyIfModified, bool replaceManualFilenames = true);
+        bool isSaveInProgress() const { return !mSavingSlots.empty(); }
         
         /** Definition of how to populate a 'slot' in the terrain group.
         */
@@ -416,6 +440,38 @@ namespace Ogre
          the terrain data occurs.
          */
         RayResult rayIntersects(const Ray& ray, Real distanceLimit = 0) const; 
+
+        /** Test a batch of rays for intersection with any terrain in the group.
+         @param rays Array of count rays to test
+         @param count Number of rays
+         @param results Array of count results to write to, see rayIntersects
+         @param distanceLimit The distance from the ray origin at which we will stop looking,
+            0 indicates no limit
+         @remarks The rays are spread over the worker threads. This can be called from 
+         any thread as long as no parallel write to the terrain data occurs.
+         */
+        void rayIntersects(const Ray* rays, size_t count, RayResult* results, Real distanceLimit = 0) const;
+
+        /** Get the heights for a batch of world positions, see getHeightAtWorldPosition.
+         @param positions Array of count positions in world space
+         @param count Number of positions
+         @param heights Array of count heights to write to, 0 where there is no loaded terrain
+         @remarks The positions are spread over the worker threads. This can be called from 
+         any thread as long as no parallel write to the terrain data occurs.
+         */
+        void getHeightsAtWorldPositions(const Vector3* positions, size_t count, float* heights) const;
+
+        /** Get the latest immutable copy of the heights of all loaded terrains.
+        @remarks
+            Unlike the queries above, this may be called from any thread while
+            the group is being edited, loaded or unloaded on the main thread:
+            the snapshot is swapped atomically and readers keep the one they
+            got for as long as they reference it. A new snapshot is published
+            when a terrain finishes loading or is unloaded, and by update,
+            updateGeometry and the methods moving or resizing the terrains.
+        @return The current snapshot, never null
+        */
+        TerrainGroupHeightSnapshotPtr getHeightSnapshot() const;
         
         typedef vector<Terrain*>::type TerrainList; 
         /** Test intersection of a box with the terrain. 
@@ -499,6 +555,7 @@ namespace Ogre
 
 
         static const uint16 WORKQUEUE_LOAD_REQUEST;
+        static const uint16 WORKQUEUE_SAVE_REQUEST;
         static const uint32 CHUNK_ID;
         static const uint16 CHUNK_VERSION;
 
@@ -526,6 +583,10 @@ namespace Ogre
         String mResourceGroup;
         TerrainAutoUpdateLod *mAutoUpdateLod;
         Terrain::DefaultGpuBufferAllocator mBufferAllocator;
+        /// Unloaded instances waiting to be reused
+        TerrainList mTerrainPool;
+        /// Packed indices of the slots being saved in the background
+        set<uint32>::type mSavingSlots;
         
         /// Get the position of a terrain instance
         Vector3 getTerrainSlotPosition(long x, long y);
@@ -534,7 +595,19 @@ namespace Ogre
         TerrainSlot* getTerrainSlot(long x, long y) const;
         void connectNeighbour(TerrainSlot* slot, long offsetx, long offsety);
 
+        /// Spreads batched ray and height queries over the worker threads
+        class QueryJob;
+        friend class QueryJob;
+
+        /// Latest heights of the loaded terrains, only accessed under mHeightSnapshotMutex
+        TerrainGroupHeightSnapshotPtr mHeightSnapshot;
+        OGRE_WQ_MUTEX(mHeightSnapshotMutex);
+        /// Replace mHeightSnapshot with the current snapshots of the loaded terrains
+        void publishHeightSnapshot();
+
         void loadTerrainImpl(TerrainSlot* slot, bool synchronous);
+        /// Release the instance of a slot, keeping it for reuse if the pool has room
+        void freeTerrainInstance(TerrainSlot* slot);
 
         /// Structure for holding the load request
         struct LoadRequest
@@ -545,10 +618,62 @@ namespace Ogre
             _OgreTerrainExport friend std::ostream& operator<<(std::ostream& o, const LoadRequest& r)
             { return o; }       
         };
+
+        /// Structure for holding the save request
+        struct SaveRequest
+        {
+            long x;
+            long y;
+            /// Only compared with the slot instance on response, never accessed in the background
+            Terrain* terrain;
+            String filename;
+            String resourceGroup;
+            /// Deferred serialiser from Terrain::saveDeferred, deleted by handleRequest
+            StreamSerialiser* data;
+            TerrainGroup* origin;
+            _OgreTerrainExport friend std::ostream& operator<<(std::ostream& o, const SaveRequest& r)
+            { return o; }       
+        };
+        WorkQueue::Response* handleSaveRequest(const WorkQueue::Request* req);
+        void handleSaveResponse(const WorkQueue::Response* res);
         
 
     };
 
+    /** Immutable copy of the heights of the terrains in a TerrainGroup.
+    @see TerrainGroup::getHeightSnapshot
+    */
+    class _OgreTerrainExport TerrainGroupHeightSnapshot : public TerrainAlloc
+    {
+    public:
+        TerrainGroupHeightSnapshot(Terrain::Alignment align, Real terrainWorldSize, const Vector3& origin);
+
+        /// Add the snapshot of the terrain in slot x, y
+        void addTerrain(long x, long y, const TerrainHeightSnapshotPtr& terrain);
+
+        /** Get the height at a world position, projecting the point down on to
+            the terrain underneath.
+        @return The height, or 0 if there is no loaded terrain at this position
+        */
+        float getHeightAtWorldPosition(const Vector3& pos) const;
+        /** Test for intersection of a ray with any terrain in the snapshot.
+        @param ray The ray to test for intersection
+        @param distanceLimit The distance from the ray origin at which we will stop looking,
+            0 indicates no limit
+        @return A pair which contains whether the ray hit a terrain and, if so, where.
+        */
+        std::pair<bool, Vector3> rayIntersects(const Ray& ray, Real distanceLimit = 0) const;
+        /// Get the snapshot of the terrain in slot x, y, null if it wasn't loaded
+        TerrainHeightSnapshotPtr getTerrain(long x, long y) const;
+
+    protected:
+        typedef map<std::pair<long, long>, TerrainHeightSnapshotPtr>::type TerrainMap;
+        TerrainMap mTerrains;
+        Terrain::Alignment mAlignment;
+        Real mTerrainWorldSize;
+        Vector3 mOrigin;
+    };
+
 
     /** @} */
     /** @} */
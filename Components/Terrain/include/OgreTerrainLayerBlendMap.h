@@ -70,7 +70,8 @@ namespace Ogre
         float* mData;
 
         void download();
-        void upload();
+        /// Write the given region of several layers sharing mBuffer to the GPU
+        void upload(TerrainLayerBlendMap** maps, size_t numMaps, const Box& box);
 
     public:
         /** Constructor
@@ -177,6 +178,11 @@ namespace Ogre
         void loadImage(const String& filename, const String& groupName);
 
         /** Publish any changes you made to the blend data back to the blend map. 
+        @remarks
+            Only the region covered by the calls to dirtyRect since the last update
+            is written. Other layers packed into the same blend texture are written
+            along with this one, so their pending changes are published too and
+            updating each of them afterwards costs nothing.
         @note
             Can only be called in the main render thread.
         */
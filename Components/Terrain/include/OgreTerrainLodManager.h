@@ -64,12 +64,14 @@ namespace Ogre
                 , currentPreparedLod(preparedLod)
                 , currentLoadedLod(loadedLod)
                 , requestedLod(target)
+                , synchronous(false)
             {
             }
             TerrainLodManager* requestee;
             uint16 currentPreparedLod;
             uint16 currentLoadedLod;
             uint16 requestedLod;
+            bool synchronous;
             _OgreTerrainExport friend std::ostream& operator<<(std::ostream& o, const LoadLodRequest& r)
             { return o; }
         };
@@ -120,6 +122,10 @@ namespace Ogre
         int getHighestLodPrepared(){ return mHighestLodPrepared; }
         int getHighestLodLoaded(){ return mHighestLodLoaded; }
         int getTargetLodLevel(){ return mTargetLodLevel; }
+        /// Is this waiting for its turn to stream in a LOD level?
+        bool isRequestPending() const { return mRequestPending; }
+        /// Get the number of background LOD requests currently in progress, across all terrains
+        static uint32 getRequestsInFlight() { return msRequestsInFlight; }
 
         LodInfo& getLodInfo(uint lodLevel)
         {
@@ -131,6 +137,23 @@ namespace Ogre
         void init();
         void buildLodInfoTable();
 
+        /** Send a request for the next LOD level to the work queue, or for 
+            all of them up to the target if synchronous.
+        */
+        void issueLoadRequest(bool synchronous);
+        /// Remove this from the queue of managers waiting to stream
+        void cancelPendingRequest();
+        /** Issue requests for waiting managers, nearest first, while 
+            TerrainGlobalOptions::getMaxConcurrentLodRequests allows.
+        */
+        static void dispatchPendingRequests();
+
+        typedef list<TerrainLodManager*>::type ManagerList;
+        /// Managers waiting for their turn to stream, main thread only
+        static ManagerList msPendingRequests;
+        /// Background requests in progress, main thread only
+        static uint32 msRequestsInFlight;
+
         /** Separate geometry data by LOD level
         @param data A geometry data to separate i.e. mHeightData/mDeltaData
         @param size Dimension of the input data
@@ -148,7 +171,20 @@ namespace Ogre
                 1: 02 10 12 14 22
                 0: 01 03 05 06 07 08 09 11 13 15 16 17 18 19 21 23
           */
-        static void separateData(float* data, uint16 size, uint16 numLodLevels, LodsData& lods );
+        static void separateData(const float* data, uint16 size, uint16 numLodLevels, LodsData& lods );
+
+        /// How the samples in a LOD data chunk are stored, since chunk version 2
+        enum LodDataEncoding
+        {
+            LOD_DATA_FLOAT = 0,
+            /// Blocks of QUANTISED_LOD_DATA_BLOCK_SIZE 16 bit samples, each with an offset and scale
+            LOD_DATA_QUANTISED = 1
+        };
+        static const size_t QUANTISED_LOD_DATA_BLOCK_SIZE;
+        /// Write count samples as LOD_DATA_QUANTISED
+        static void writeQuantised(StreamSerialiser& stream, const float* data, size_t count);
+        /// Read count samples written by writeQuantised
+        static void readQuantised(StreamSerialiser& stream, float* data, size_t count);
     private:
         Terrain* mTerrain;
         DataStreamPtr mDataStream;
@@ -161,6 +197,8 @@ namespace Ogre
         int mHighestLodLoaded;  /// Highest LOD level loaded in GPU
 
         bool mIncreaseLodLevelInProgress;  /// Is increaseLodLevel() running?
+        WorkQueue::RequestID mLoadRequestID;  /// Request of the running increaseLodLevel()
+        bool mRequestPending;  /// Waiting in msPendingRequests?
         bool mLastRequestSynchronous;
     };
     /** @} */
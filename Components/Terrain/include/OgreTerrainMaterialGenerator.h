@@ -183,6 +183,10 @@ namespace Ogre
             const String& getDescription() const { return mDesc; }
             /// Compressed vertex format supported?
             virtual bool isVertexCompressionSupported() const = 0;      
+            /** Can the generated material draw instanced patches which read the
+                heights from Terrain::getHeightTexture? (default false)
+            */
+            virtual bool isInstancedPatchRenderingSupported() const { return false; }
             /// Generate / reuse a material for the terrain
             virtual MaterialPtr generate(const Terrain* terrain) = 0;
             /// Generate / reuse a material for the terrain
@@ -392,7 +396,50 @@ namespace Ogre
             const MaterialPtr& mat, const TexturePtr& destCompositeMap);
 
         Texture* _getCompositeMapRTT() { return mCompositeMapRTT; }
+
+        /// Derived maps which can be rendered by _renderDerivedMap
+        enum DerivedMap
+        {
+            /// Object space normals, as stored in Terrain::getTerrainNormalMap
+            DM_NORMAL_MAP = 0,
+            /// Shadowed lightmap, as stored in Terrain::getLightmap
+            DM_LIGHTMAP = 1,
+            DM_COUNT = 2
+        };
+
+        /** Whether the current render system can render the terrain normal map 
+            and lightmap with _renderDerivedMap. 
+        @remarks
+            This needs render to texture, floating point textures and either
+            GLSL 1.50 or shader model 4.
+        */
+        virtual bool isDerivedMapRenderingSupported() const;
+
+        /** Whether terrains can be drawn as instanced patches, see
+            TerrainGlobalOptions::setUseInstancedPatches.
+        @remarks
+            This needs the active profile to support it, as well as vertex
+            texture fetch, instanced vertex data and floating point textures.
+        */
+        virtual bool isInstancedPatchRenderingSupported() const;
+
+        /** Helper method to render a normal map or lightmap from the terrain heights.
+        @param terrain The terrain to render for
+        @param map The map to render
+        @param heightMap A PF_FLOAT32_R texture of the terrain heights, with
+            rows inverted in Y to match image space
+        @param rect The region of the map to update, in image space
+        @param dest The texture to write the result to; its size is the map size
+        */
+        virtual void _renderDerivedMap(const Terrain* terrain, DerivedMap map, 
+            const TexturePtr& heightMap, const Rect& rect, const TexturePtr& dest);
     protected:
+        /// Create the scene used to render maps, if not already created
+        void createCompositeMapScene(size_t size, const MaterialPtr& mat);
+        /// Render a region of the scene into rtt, then copy it to dest
+        void renderToTexture(Texture* rtt, const Rect& rect, const TexturePtr& dest);
+        /// Get the material used to render a derived map, creating it if needed
+        MaterialPtr getDerivedMapMaterial(DerivedMap map);
 
         ProfileList mProfiles;
         mutable Profile* mActiveProfile;
@@ -404,6 +451,7 @@ namespace Ogre
         Texture* mCompositeMapRTT; // deliberately holding this by raw pointer to avoid shutdown issues
         ManualObject* mCompositeMapPlane;
         Light* mCompositeMapLight;
+        Texture* mDerivedMapRTT[DM_COUNT]; // raw pointers for the same reason as mCompositeMapRTT
 
 
 
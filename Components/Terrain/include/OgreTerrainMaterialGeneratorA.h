@@ -69,6 +69,7 @@ namespace Ogre
             void updateParamsForCompositeMap(const MaterialPtr& mat, const Terrain* terrain);
             void requestOptions(Terrain* terrain);
             bool isVertexCompressionSupported() const;
+            bool isInstancedPatchRenderingSupported() const;
 
             /** Whether to support normal mapping per layer in the shader (default true). 
             */
@@ -207,6 +208,10 @@ namespace Ogre
                 void generateFpDynamicShadowsHelpers(const SM2Profile* prof, const Terrain* terrain, TechniqueType tt, StringStream& outStream);
                 void generateFpDynamicShadowsParams(uint* texCoord, uint* sampler, const SM2Profile* prof, const Terrain* terrain, TechniqueType tt, StringStream& outStream);
                 void generateFpDynamicShadows(const SM2Profile* prof, const Terrain* terrain, TechniqueType tt, StringStream& outStream);
+                /// Height lookup used by instanced patches, goes before the entry point
+                void generateVpPatchHelpers(bool sm4, StringStream& outStream);
+                /// Derive posIndex, height, delta and lodMorph from the instanced patch inputs
+                void generateVpPatchInputs(StringStream& outStream);
             };
 
             class _OgreTerrainExport ShaderHelperHLSL : public ShaderHelperCg
@@ -0,0 +1,145 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __Ogre_TerrainPatchRenderer_H__
+#define __Ogre_TerrainPatchRenderer_H__
+
+#include "OgreTerrainPrerequisites.h"
+#include "OgreRenderable.h"
+#include "OgreHardwareVertexBuffer.h"
+
+namespace Ogre
+{
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Terrain
+    *  Some details on the terrain component
+    *  @{
+    */
+
+    /** Draws the nodes of a terrain by instancing one shared grid patch.
+    @remarks
+        Used instead of the per-node vertex and index data when
+        TerrainGlobalOptions::setUseInstancedPatches is enabled. The patch is a
+        grid of minBatchSize vertices along each side, plus a ring of skirt
+        vertices, which only holds grid coordinates. A node rendered at a LOD
+        where it has more vertices than that is covered by several patches, each
+        one being a single instance described by its offset into the terrain
+        data, the spacing of its vertices and the node's LOD transition. The
+        vertex program reads the heights from Terrain::getHeightTexture.
+    @par
+        TerrainQuadTreeNode still performs the culling and LOD selection; every
+        node selected for rendering hands itself to _queueNode, and instances
+        are accumulated into one Renderable per material LOD index until the
+        next visibility pass starts.
+    */
+    class _OgreTerrainExport TerrainPatchRenderer : public TerrainAlloc
+    {
+    public:
+        /// Buffer binding used for the shared grid
+        static unsigned short PATCH_BUFFER;
+        /// Buffer binding used for the per instance data
+        static unsigned short INSTANCE_BUFFER;
+
+        TerrainPatchRenderer(Terrain* terrain);
+        virtual ~TerrainPatchRenderer();
+
+        /// Get the number of vertices along one side of the shared patch (excluding skirts)
+        uint16 getPatchSize() const { return mPatchSize; }
+
+        /// Get the number of instances queued since the last visibility pass began
+        size_t getInstanceCount() const;
+
+        /// Discard the instances collected for the previous visibility pass, internal use
+        void _beginPass();
+
+        /** Add the patches covering a node at its current LOD, internal use.
+        @remarks
+            The first time a material LOD index is used in a pass, the Renderable
+            drawing it is added to the queue; the instance data is uploaded when
+            it is actually rendered.
+        */
+        void _queueNode(TerrainQuadTreeNode* node, RenderQueue* queue);
+
+    protected:
+        /// All the instances drawn with one material LOD index
+        class _OgreTerrainExport Batch : public Renderable, public TerrainAlloc
+        {
+        public:
+            Batch(TerrainPatchRenderer* parent, unsigned short materialLodIndex);
+            virtual ~Batch();
+
+            /// Remove all instances
+            void clear();
+            /// Add one patch instance
+            void addInstance(float offsetX, float offsetY, float step, float morph);
+            /// Get the number of instances
+            size_t getInstanceCount() const { return mInstanceData.size() / 4; }
+
+            /// Node which provides the lights
+            TerrainQuadTreeNode* mLightNode;
+
+            const MaterialPtr& getMaterial(void) const;
+            Technique* getTechnique(void) const;
+            void getRenderOperation(RenderOperation& op);
+            void getWorldTransforms(Matrix4* xform) const;
+            Real getSquaredViewDepth(const Camera* cam) const;
+            const LightList& getLights(void) const;
+            bool getCastsShadows(void) const;
+
+        protected:
+            TerrainPatchRenderer* mParent;
+            unsigned short mMaterialLodIndex;
+            /// offsetX, offsetY, step, morph for each instance
+            vector<float>::type mInstanceData;
+            bool mInstanceDataDirty;
+            VertexData* mVertexData;
+            HardwareVertexBufferSharedPtr mInstanceBuffer;
+
+            void uploadInstanceData();
+        };
+        typedef vector<Batch*>::type BatchList;
+
+        Terrain* mTerrain;
+        uint16 mPatchSize;
+        /// The grid shared by all batches
+        HardwareVertexBufferSharedPtr mPatchBuffer;
+        IndexData* mPatchIndexData;
+        /// Batches indexed by material LOD index, created on demand
+        BatchList mBatches;
+
+        void createPatch();
+        Batch* getBatch(unsigned short materialLodIndex);
+    };
+
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -99,6 +99,8 @@ namespace Ogre
         uint16 getYOffset() const { return mOffsetY; }
         /// Is this a leaf node (no children)
         bool isLeaf() const;
+        /// Get the number of vertices at the original terrain resolution this node encompasses
+        uint16 getSize() const { return mSize; }
         /// Get the base LOD level this node starts at (the highest LOD it handles)
         uint16 getBaseLod() const { return mBaseLod; }
         /// Get the number of LOD levels this node can represent itself (only > 1 for leaf nodes)
@@ -249,6 +251,8 @@ namespace Ogre
         void setCurrentLod(int lod);
         /// Get the transition state between the current LOD and the next lower one (only valid after calculateCurrentLod)
         float getLodTransition() const { return mLodTransition; }
+        /// Get the material LOD index used by the current LOD (only valid after calculateCurrentLod)
+        unsigned short getMaterialLodIndex() const { return mMaterialLodIndex; }
         /// Manually set the current LOD transition state, intended for internal use only
         void setLodTransition(float t);
 
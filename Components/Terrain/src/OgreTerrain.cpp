@@ -48,6 +48,8 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreTimer.h"
 #include "OgreTerrainMaterialGeneratorA.h"
+#include "OgreTerrainPatchRenderer.h"
+#include "Threading/OgreParallel.h"
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
 #include "macUtils.h"
@@ -76,6 +78,7 @@ namespace Ogre
     const uint16 Terrain::TERRAINDERIVEDDATA_CHUNK_VERSION = 1;
     // since 129^2 is the greatest power we can address in 16-bit index
     const uint16 Terrain::TERRAIN_MAX_BATCH_SIZE = 129; 
+    const uint16 Terrain::COMPRESSED_HEIGHT_BLOCK_SIZE = 32;
     const uint16 Terrain::WORKQUEUE_DERIVED_DATA_REQUEST = 1;
     const uint64 Terrain::TERRAIN_GENERATE_MATERIAL_INTERVAL_MS = 400;
     const uint16 Terrain::WORKQUEUE_GENERATE_MATERIAL_REQUEST = 2;
@@ -117,6 +120,11 @@ namespace Ogre
         , mCompositeMapDistance(4000)
         , mResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mUseVertexCompressionWhenAvailable(true)
+        , mDerivedMapsOnGpu(false)
+        , mCompressHeightData(false)
+        , mUseInstancedPatches(false)
+        , mMaxConcurrentLodRequests(2)
+        , mTerrainPoolSize(0)
     {
     }
     //---------------------------------------------------------------------
@@ -169,6 +177,7 @@ namespace Ogre
         , mDirtyLightmapFromNeighboursRect(0, 0, 0, 0)
         , mDerivedDataUpdateInProgress(false)
         , mDerivedUpdatePendingMask(0)
+        , mDerivedDataRequestID(0)
         , mGenerateMaterialInProgress(false)
         , mPrepareInProgress(false)
         , mMaterialGenerationCount(0)
@@ -194,12 +203,15 @@ namespace Ogre
         , mLightMapRequired(false)
         , mLightMapShadowsOnly(true)
         , mCompositeMapRequired(false)
+        , mPatchRenderer(0)
         , mCpuTerrainNormalMap(0)
         , mLastLODCamera(0)
         , mLastLODFrame(0)
         , mLastViewportHeight(0)
         , mCustomGpuBufferAllocator(0)
         , mLodManager(0)
+        , mLodStreamingPriority(0)
+        , mReopenLodData(false)
 
     {
         mRootNode = sm->getRootSceneNode()->createChildSceneNode();
@@ -313,6 +325,41 @@ namespace Ogre
             mLodManager->open(filename);
     }
     //---------------------------------------------------------------------
+    StreamSerialiser* Terrain::saveDeferred()
+    {
+        // force to load highest lod, or quadTree may contain hole
+        load(0,true);
+
+        // the file is replaced later on, all the LOD data is loaded meanwhile
+        if (mLodManager && mLodManager->isOpen())
+        {
+            mLodManager->close();
+            mReopenLodData = true;
+        }
+
+        StreamSerialiser* stream = StreamSerialiser::createDeferred();
+        try
+        {
+            save(*stream);
+        }
+        catch (Exception&)
+        {
+            OGRE_DELETE stream;
+            throw;
+        }
+        return stream;
+    }
+    //---------------------------------------------------------------------
+    void Terrain::_notifySaved(const String& filename, bool succeeded)
+    {
+        if (!succeeded)
+            mModified = true;
+
+        if (mLodManager && mReopenLodData)
+            mLodManager->open(filename);
+        mReopenLodData = false;
+    }
+    //---------------------------------------------------------------------
     void Terrain::save(StreamSerialiser& stream)
     {
         // wait for any queued processes to finish
@@ -320,6 +367,7 @@ namespace Ogre
 
         if (mHeightDataModified)
         {
+            decompressHeightData();
             // When modifying, for efficiency we only increase the max deltas at each LOD,
             // we never reduce them (since that would require re-examining more samples)
             // Since we now save this data in the file though, we need to make sure we've
@@ -788,6 +836,9 @@ namespace Ogre
         mQuadTree = OGRE_NEW TerrainQuadTreeNode(this, 0, 0, 0, mSize, mNumLodLevels - 1, 0, 0);
         mQuadTree->prepare(stream);
 
+        updateHeightRanges(Rect(0, 0, mSize, mSize));
+        publishHeightSnapshot();
+
         // stop uncompressing
         if(mainChunk->version > 1)
             stream.stopDeflate();
@@ -921,6 +972,8 @@ namespace Ogre
 
         mQuadTree = OGRE_NEW TerrainQuadTreeNode(this, 0, 0, 0, mSize, mNumLodLevels - 1, 0, 0);
         mQuadTree->prepare();
+        updateHeightRanges(Rect(0, 0, mSize, mSize));
+        publishHeightSnapshot();
 
         // calculate entire terrain
         Rect rect;
@@ -1140,6 +1193,8 @@ namespace Ogre
     //---------------------------------------------------------------------
     void Terrain::load(int lodLevel, bool synchronous)
     {
+        // vertex data is filled from the raw heights
+        decompressHeightData();
         if (mQuadTree)
             mLodManager->updateToLodLevel(lodLevel,synchronous);
 
@@ -1174,6 +1229,9 @@ namespace Ogre
         if (mQuadTree)
             mQuadTree->unload();
 
+        OGRE_DELETE mPatchRenderer;
+        mPatchRenderer = 0;
+
         // free own buffers if used, but not custom
         mDefaultGpuBufferAllocator.freeAllBuffers();
 
@@ -1189,17 +1247,50 @@ namespace Ogre
             mQuadTree->unprepare();
     }
     //---------------------------------------------------------------------
+    bool Terrain::_resetForReuse()
+    {
+        if (mPrepareInProgress || mGenerateMaterialInProgress)
+            return false;
+
+        mDerivedUpdatePendingMask = 0;
+        waitForDerivedProcesses();
+
+        removeFromNeighbours();
+        memset(mNeighbours, 0, sizeof(Terrain*) * NEIGHBOUR_COUNT);
+
+        unload();
+        unprepare();
+        freeLodData();
+        freeGPUResources();
+        freeCPUResources();
+        freeTemporaryResources();
+        mLayerBlendMapList.clear();
+        mLayers.clear();
+
+        return true;
+    }
+    //---------------------------------------------------------------------
     float* Terrain::getHeightData() const
     {
+        const_cast<Terrain*>(this)->decompressHeightData();
         return mHeightData;
     }
     //---------------------------------------------------------------------
     float* Terrain::getHeightData(long x, long y) const
     {
         assert (x >= 0 && x < mSize && y >= 0 && y < mSize);
+        const_cast<Terrain*>(this)->decompressHeightData();
         return &mHeightData[y * mSize + x];
     }
     //---------------------------------------------------------------------
+    float Terrain::getStoredHeight(long x, long y) const
+    {
+        assert (x >= 0 && x < mSize && y >= 0 && y < mSize);
+        if (!mHeightData && mCompressedHeightData)
+            return mCompressedHeightData->getHeight(x, y);
+        return mHeightData[y * mSize + x];
+    }
+    //---------------------------------------------------------------------
     float Terrain::getHeightAtPoint(long x, long y) const
     {
         // clamp
@@ -1211,7 +1302,7 @@ namespace Ogre
         int highestLod = mLodManager->getHighestLodPrepared();
         long skip = 1 << (highestLod != -1 ? highestLod : 0);
         if (x % skip == 0 && y % skip == 0)
-        return *getHeightData(x, y);
+        return getStoredHeight(x, y);
 
         long x1 = std::min( (x/skip) * skip         , (long)mSize - 1L );
         long x2 = std::min( ((x+skip) / skip) * skip, (long)mSize - 1L );
@@ -1221,10 +1312,10 @@ namespace Ogre
         float rx = (float(x % skip) / skip);
         float ry = (float(y % skip) / skip);
 
-        return *getHeightData(x1, y1) * (1.0f-rx) * (1.0f-ry)
-            + *getHeightData(x2, y1) * rx * (1.0f-ry)
-            + *getHeightData(x1, y2) * (1.0f-rx) * ry
-            + *getHeightData(x2, y2) * rx * ry;
+        return getStoredHeight(x1, y1) * (1.0f-rx) * (1.0f-ry)
+            + getStoredHeight(x2, y1) * rx * (1.0f-ry)
+            + getStoredHeight(x1, y2) * (1.0f-rx) * ry
+            + getStoredHeight(x2, y2) * rx * ry;
     }
     //---------------------------------------------------------------------
     void Terrain::setHeightAtPoint(long x, long y, float h)
@@ -1250,10 +1341,23 @@ namespace Ogre
     {
         // get left / bottom points (rounded down)
         Real factor = (Real)mSize - 1.0f;
-        Real invFactor = 1.0f / factor;
-
         long startX = static_cast<long>(x * factor);
         long startY = static_cast<long>(y * factor);
+
+        // point-sampled heights of the corners, clamped to the edges
+        float cornerHeights[4] = {
+            getHeightAtPoint(startX, startY), 
+            getHeightAtPoint(startX + 1, startY),
+            getHeightAtPoint(startX + 1, startY + 1), 
+            getHeightAtPoint(startX, startY + 1) };
+        return interpolateQuadHeight(mSize, x, y, startX, startY, cornerHeights);
+    }
+    //---------------------------------------------------------------------
+    float Terrain::interpolateQuadHeight(uint16 size, Real x, Real y, 
+        long startX, long startY, const float cornerHeights[4])
+    {
+        Real factor = (Real)size - 1.0f;
+        Real invFactor = 1.0f / factor;
         long endX = startX + 1;
         long endY = startY + 1;
 
@@ -1264,10 +1368,6 @@ namespace Ogre
         Real endXTS = endX * invFactor;
         Real endYTS = endY * invFactor;
 
-        // now clamp
-        endX = std::min(endX, (long)mSize-1);
-        endY = std::min(endY, (long)mSize-1);
-
         // get parametric from start coord to next point
         Real xParam = (x - startXTS) / invFactor;
         Real yParam = (y - startYTS) / invFactor;
@@ -1280,11 +1380,11 @@ namespace Ogre
         0---1   0---1
         */
 
-        // Build all 4 positions in terrain space, using point-sampled height
-        Vector3 v0 (startXTS, startYTS, getHeightAtPoint(startX, startY));
-        Vector3 v1 (endXTS, startYTS, getHeightAtPoint(endX, startY));
-        Vector3 v2 (endXTS, endYTS, getHeightAtPoint(endX, endY));
-        Vector3 v3 (startXTS, endYTS, getHeightAtPoint(startX, endY));
+        // Build all 4 positions in terrain space
+        Vector3 v0 (startXTS, startYTS, cornerHeights[0]);
+        Vector3 v1 (endXTS, startYTS, cornerHeights[1]);
+        Vector3 v2 (endXTS, endYTS, cornerHeights[2]);
+        Vector3 v3 (startXTS, endYTS, cornerHeights[3]);
         // define this plane in terrain space
         Plane plane;
         if (startY % 2)
@@ -1328,12 +1428,14 @@ namespace Ogre
     //---------------------------------------------------------------------
     const float* Terrain::getDeltaData() const
     {
+        const_cast<Terrain*>(this)->decompressHeightData();
         return mDeltaData;
     }
     //---------------------------------------------------------------------
     const float* Terrain::getDeltaData(long x, long y) const
     {
         assert (x >= 0 && x < mSize && y >= 0 && y < mSize);
+        const_cast<Terrain*>(this)->decompressHeightData();
         return &mDeltaData[y * mSize + x];
     }
     //---------------------------------------------------------------------
@@ -1514,7 +1616,7 @@ namespace Ogre
     //---------------------------------------------------------------------
     void Terrain::getPointAlign(long x, long y, Alignment align, Vector3* outpos) const
     {
-        getPointAlign(x, y, *getHeightData(x, y), align, outpos);
+        getPointAlign(x, y, getStoredHeight(x, y), align, outpos);
     }
     //---------------------------------------------------------------------
     void Terrain::getPointAlign(long x, long y, float height, Alignment align, Vector3* outpos) const
@@ -1853,6 +1955,7 @@ namespace Ogre
             mRootNode->setPosition(pos);
             updateBaseScale();
             mModified = true;
+            publishHeightSnapshot();
         }
     }
     //---------------------------------------------------------------------
@@ -1879,10 +1982,12 @@ namespace Ogre
     //---------------------------------------------------------------------
     void Terrain::dirtyRect(const Rect& rect)
     {
+        decompressHeightData();
         mDirtyGeometryRect.merge(rect);
         mDirtyGeometryRectForNeighbours.merge(rect);
         mDirtyDerivedDataRect.merge(rect);
         mCompositeMapDirtyRect.merge(rect);
+        updateHeightRanges(rect);
 
         mModified = true;
         mHeightDataModified = true;
@@ -1922,7 +2027,10 @@ namespace Ogre
         if (!mDirtyGeometryRect.isNull())
         {
             mQuadTree->updateVertexData(true, false, mDirtyGeometryRect, false);
+            if (mPatchRenderer)
+                updateGPUHeightTexture(mDirtyGeometryRect);
             mDirtyGeometryRect.setNull();
+            publishHeightSnapshot();
         }
 
         // propagate changes
@@ -1934,12 +2042,17 @@ namespace Ogre
         if (!mDirtyGeometryRect.isNull())
         {
             mQuadTree->updateVertexData(true, false, mDirtyGeometryRect, false);
+            if (mPatchRenderer)
+                updateGPUHeightTexture(mDirtyGeometryRect);
             mDirtyGeometryRect.setNull();
+            publishHeightSnapshot();
         }
     }
     //---------------------------------------------------------------------
     void Terrain::updateDerivedData(bool synchronous, uint8 typeMask)
     {
+        // the background update reads the raw heights
+        decompressHeightData();
         if (!mDirtyDerivedDataRect.isNull() || !mDirtyLightmapFromNeighboursRect.isNull())
         {
             mModified = true;
@@ -1983,8 +2096,23 @@ namespace Ogre
             req.typeMask = req.typeMask & ~DERIVED_DATA_NORMALS;
         if (!mLightMapRequired)
             req.typeMask = req.typeMask & ~DERIVED_DATA_LIGHTMAP;
+        if (TerrainGlobalOptions::getSingleton().getDerivedMapsOnGpu() &&
+            mMaterialGenerator->isDerivedMapRenderingSupported())
+        {
+            // we're in the render thread, so render them now; the request still
+            // goes through the queue so that the composite map is updated after
+            // any height deltas
+            req.typeMask = req.typeMask & 
+                ~renderDerivedDataOnGpu(rect, lightmapExtraRect, req.typeMask);
+        }
+        else if (mHeightTexture && !mPatchRenderer)
+        {
+            // heights are no longer tracked, drop the stale copy
+            TextureManager::getSingleton().remove(mHeightTexture->getHandle());
+            mHeightTexture.reset();
+        }
 
-        Root::getSingleton().getWorkQueue()->addRequest(
+        mDerivedDataRequestID = Root::getSingleton().getWorkQueue()->addRequest(
             mWorkQueueChannel, WORKQUEUE_DERIVED_DATA_REQUEST, 
             Any(req), 0, synchronous);
 
@@ -1992,6 +2120,10 @@ namespace Ogre
     //---------------------------------------------------------------------
     void Terrain::waitForDerivedProcesses()
     {
+        // don't wait behind the updates of other terrains
+        if (mDerivedDataUpdateInProgress)
+            Root::getSingleton().getWorkQueue()->promoteRequest(mDerivedDataRequestID);
+
         while (mDerivedDataUpdateInProgress || mGenerateMaterialInProgress || mPrepareInProgress)
         {
             // we need to wait for this to finish
@@ -2009,6 +2141,10 @@ namespace Ogre
         OGRE_FREE(mDeltaData, MEMCATEGORY_GEOMETRY);
         mDeltaData = 0;
 
+        mCompressedHeightData.reset();
+        mHeightRanges.clear();
+        publishHeightSnapshot();
+
         OGRE_DELETE mQuadTree;
         mQuadTree = 0;
 
@@ -2031,6 +2167,9 @@ namespace Ogre
     //---------------------------------------------------------------------
     void Terrain::freeGPUResources()
     {
+        OGRE_DELETE mPatchRenderer;
+        mPatchRenderer = 0;
+
         // remove textures
         TextureManager* tmgr = TextureManager::getSingletonPtr();
         if (tmgr)
@@ -2047,6 +2186,12 @@ namespace Ogre
                 mTerrainNormalMap.reset();
             }
 
+            if (mHeightTexture)
+            {
+                tmgr->remove(mHeightTexture->getHandle());
+                mHeightTexture.reset();
+            }
+
             if (mColourMap)
             {
                 tmgr->remove(mColourMap->getHandle());
@@ -2089,6 +2234,45 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    /// Calculates derived data for a range of rows, or LOD levels for height deltas
+    class Terrain::DerivedDataJob : public ParallelJob
+    {
+    public:
+        enum Type
+        {
+            HEIGHT_DELTAS,
+            NORMALS,
+            LIGHTMAP
+        };
+
+        DerivedDataJob(Terrain* terrain, Type type, const Rect& rect, uint8* data,
+            size_t count, size_t grainSize)
+            : ParallelJob(count, grainSize), mTerrain(terrain), mType(type), mRect(rect), mData(data) {}
+
+        void execute(size_t begin, size_t end)
+        {
+            switch (mType)
+            {
+            case HEIGHT_DELTAS:
+                for (size_t i = begin; i < end; ++i)
+                    mTerrain->calculateHeightDeltasAtLevel(mRect, static_cast<int>(i) + 1);
+                break;
+            case NORMALS:
+                mTerrain->calculateNormalsRows(mRect, mData, mRect.top + (long)begin, mRect.top + (long)end);
+                break;
+            case LIGHTMAP:
+                mTerrain->calculateLightmapRows(mRect, mData, mRect.top + (long)begin, mRect.top + (long)end);
+                break;
+            }
+        }
+
+    private:
+        Terrain* mTerrain;
+        Type mType;
+        Rect mRect;
+        uint8* mData;
+    };
+    //---------------------------------------------------------------------
     Rect Terrain::calculateHeightDeltas(const Rect& rect)
     {
         Rect clampedRect(rect);
@@ -2101,149 +2285,162 @@ namespace Ogre
 
         mQuadTree->preDeltaCalculation(clampedRect);
 
-        /// Iterate over target levels, 
+        // need to widen the dirty rectangle since change will affect surrounding
+        // vertices at lower LOD, keep a merge of the widest
         for (int targetLevel = 1; targetLevel < mNumLodLevels; ++targetLevel)
-        {
-            int sourceLevel = targetLevel - 1;
-            int step = 1 << targetLevel;
-            // The step of the next higher LOD
-//          int higherstep = step >> 1;
-
-            // need to widen the dirty rectangle since change will affect surrounding
-            // vertices at lower LOD
-            Rect widenedRect(rect);
-            widenedRect.left = std::max(0L, widenedRect.left - step);
-            widenedRect.top = std::max(0L, widenedRect.top - step);
-            widenedRect.right = std::min((long)mSize, widenedRect.right + step);
-            widenedRect.bottom = std::min((long)mSize, widenedRect.bottom + step);
-
-            // keep a merge of the widest
-            finalRect.merge(widenedRect);
-            
+            finalRect.merge(getHeightDeltaRect(rect, targetLevel));
+
+        // Each level writes separate delta values and LOD levels of the quadtree,
+        // so the levels are calculated in parallel
+        if (mNumLodLevels > 1)
+            ParallelJob::run(ParallelJobPtr(OGRE_NEW DerivedDataJob(
+                this, DerivedDataJob::HEIGHT_DELTAS, rect, 0, mNumLodLevels - 1, 1)));
+
+        mQuadTree->postDeltaCalculation(clampedRect);
+
+        return finalRect;
+
+    }
+    //---------------------------------------------------------------------
+    Rect Terrain::getHeightDeltaRect(const Rect& rect, int targetLevel) const
+    {
+        int step = 1 << targetLevel;
+        Rect widenedRect(rect);
+        widenedRect.left = std::max(0L, widenedRect.left - step);
+        widenedRect.top = std::max(0L, widenedRect.top - step);
+        widenedRect.right = std::min((long)mSize, widenedRect.right + step);
+        widenedRect.bottom = std::min((long)mSize, widenedRect.bottom + step);
+        return widenedRect;
+    }
+    //---------------------------------------------------------------------
+    void Terrain::calculateHeightDeltasAtLevel(const Rect& rect, int targetLevel)
+    {
+        int sourceLevel = targetLevel - 1;
+        int step = 1 << targetLevel;
+        // The step of the next higher LOD
+//      int higherstep = step >> 1;
 
-            // now round the rectangle at this level so that it starts & ends on 
-            // the step boundaries
-            Rect lodRect(widenedRect);
-            lodRect.left -= lodRect.left % step;
-            lodRect.top -= lodRect.top % step;
-            if (lodRect.right % step)
-                lodRect.right += step - (lodRect.right % step);
-            if (lodRect.bottom % step)
-                lodRect.bottom += step - (lodRect.bottom % step);
-
-            for (long j = lodRect.top; j < lodRect.bottom - step; j += step )
+        // need to widen the dirty rectangle since change will affect surrounding
+        // vertices at lower LOD
+        Rect widenedRect = getHeightDeltaRect(rect, targetLevel);
+
+        // now round the rectangle at this level so that it starts & ends on 
+        // the step boundaries
+        Rect lodRect(widenedRect);
+        lodRect.left -= lodRect.left % step;
+        lodRect.top -= lodRect.top % step;
+        if (lodRect.right % step)
+            lodRect.right += step - (lodRect.right % step);
+        if (lodRect.bottom % step)
+            lodRect.bottom += step - (lodRect.bottom % step);
+
+        for (long j = lodRect.top; j < lodRect.bottom - step; j += step )
+        {
+            for (long i = lodRect.left; i < lodRect.right - step; i += step )
             {
-                for (long i = lodRect.left; i < lodRect.right - step; i += step )
+                // Form planes relating to the lower detail tris to be produced
+                // For even tri strip rows, they are this shape:
+                // 2---3
+                // | / |
+                // 0---1
+                // For odd tri strip rows, they are this shape:
+                // 2---3
+                // | \ |
+                // 0---1
+
+                Vector3 v0, v1, v2, v3;
+                getPointAlign(i, j, ALIGN_X_Y, &v0);
+                getPointAlign(i + step, j, ALIGN_X_Y, &v1);
+                getPointAlign(i, j + step, ALIGN_X_Y, &v2);
+                getPointAlign(i + step, j + step, ALIGN_X_Y, &v3);
+
+                Plane t1, t2;
+                bool backwardTri = false;
+                // Odd or even in terms of target level
+                if ((j / step) % 2 == 0)
                 {
-                    // Form planes relating to the lower detail tris to be produced
-                    // For even tri strip rows, they are this shape:
-                    // 2---3
-                    // | / |
-                    // 0---1
-                    // For odd tri strip rows, they are this shape:
-                    // 2---3
-                    // | \ |
-                    // 0---1
-
-                    Vector3 v0, v1, v2, v3;
-                    getPointAlign(i, j, ALIGN_X_Y, &v0);
-                    getPointAlign(i + step, j, ALIGN_X_Y, &v1);
-                    getPointAlign(i, j + step, ALIGN_X_Y, &v2);
-                    getPointAlign(i + step, j + step, ALIGN_X_Y, &v3);
-
-                    Plane t1, t2;
-                    bool backwardTri = false;
-                    // Odd or even in terms of target level
-                    if ((j / step) % 2 == 0)
-                    {
-                        t1.redefine(v0, v1, v3);
-                        t2.redefine(v0, v3, v2);
-                    }
-                    else
-                    {
-                        t1.redefine(v1, v3, v2);
-                        t2.redefine(v0, v1, v2);
-                        backwardTri = true;
-                    }
+                    t1.redefine(v0, v1, v3);
+                    t2.redefine(v0, v3, v2);
+                }
+                else
+                {
+                    t1.redefine(v1, v3, v2);
+                    t2.redefine(v0, v1, v2);
+                    backwardTri = true;
+                }
 
-                    // include the bottommost row of vertices if this is the last row
-                    int yubound = (j == (mSize - step)? step : step - 1);
-                    for ( int y = 0; y <= yubound; y++ )
+                // include the bottommost row of vertices if this is the last row
+                int yubound = (j == (mSize - step)? step : step - 1);
+                for ( int y = 0; y <= yubound; y++ )
+                {
+                    // include the rightmost col of vertices if this is the last col
+                    int xubound = (i == (mSize - step)? step : step - 1);
+                    for ( int x = 0; x <= xubound; x++ )
                     {
-                        // include the rightmost col of vertices if this is the last col
-                        int xubound = (i == (mSize - step)? step : step - 1);
-                        for ( int x = 0; x <= xubound; x++ )
+                        int fulldetailx = static_cast<int>(i + x);
+                        int fulldetaily = static_cast<int>(j + y);
+                        if ( fulldetailx % step == 0 && 
+                            fulldetaily % step == 0 )
                         {
-                            int fulldetailx = static_cast<int>(i + x);
-                            int fulldetaily = static_cast<int>(j + y);
-                            if ( fulldetailx % step == 0 && 
-                                fulldetaily % step == 0 )
-                            {
-                                // Skip, this one is a vertex at this level
-                                continue;
-                            }
-
-                            Real ypct = (Real)y / (Real)step;
-                            Real xpct = (Real)x / (Real)step;
-
-                            //interpolated height
-                            Vector3 actualPos;
-                            getPointAlign(fulldetailx, fulldetaily, ALIGN_X_Y, &actualPos);
-                            Real interp_h;
-                            // Determine which tri we're on 
-                            if ((xpct > ypct && !backwardTri) ||
-                                (xpct > (1-ypct) && backwardTri))
-                            {
-                                // Solve for x/z
-                                interp_h = 
-                                    (-t1.normal.x * actualPos.x
-                                    - t1.normal.y * actualPos.y
-                                    - t1.d) / t1.normal.z;
-                            }
-                            else
-                            {
-                                // Second tri
-                                interp_h = 
-                                    (-t2.normal.x * actualPos.x
-                                    - t2.normal.y * actualPos.y
-                                    - t2.d) / t2.normal.z;
-                            }
-
-                            Real actual_h = actualPos.z;
-                            Real delta = interp_h - actual_h;
-
-                            // max(delta) is the worst case scenario at this LOD
-                            // compared to the original heightmap
-
-                            // tell the quadtree about this 
-                            mQuadTree->notifyDelta(fulldetailx, fulldetaily, sourceLevel, delta);
-
-
-                            // If this vertex is being removed at this LOD, 
-                            // then save the height difference since that's the move
-                            // it will need to make. Vertices to be removed at this LOD
-                            // are halfway between the steps, but exclude those that
-                            // would have been eliminated at earlier levels
-                            int halfStep = step / 2;
-                            if (
-                             ((fulldetailx % step) == halfStep && (fulldetaily % halfStep) == 0) ||
-                             ((fulldetaily % step) == halfStep && (fulldetailx % halfStep) == 0))
-                            {
-                                // Save height difference 
-                                mDeltaData[fulldetailx + (fulldetaily * mSize)] = delta;
-                            }
+                            // Skip, this one is a vertex at this level
+                            continue;
+                        }
 
+                        Real ypct = (Real)y / (Real)step;
+                        Real xpct = (Real)x / (Real)step;
+
+                        //interpolated height
+                        Vector3 actualPos;
+                        getPointAlign(fulldetailx, fulldetaily, ALIGN_X_Y, &actualPos);
+                        Real interp_h;
+                        // Determine which tri we're on 
+                        if ((xpct > ypct && !backwardTri) ||
+                            (xpct > (1-ypct) && backwardTri))
+                        {
+                            // Solve for x/z
+                            interp_h = 
+                                (-t1.normal.x * actualPos.x
+                                - t1.normal.y * actualPos.y
+                                - t1.d) / t1.normal.z;
+                        }
+                        else
+                        {
+                            // Second tri
+                            interp_h = 
+                                (-t2.normal.x * actualPos.x
+                                - t2.normal.y * actualPos.y
+                                - t2.d) / t2.normal.z;
                         }
 
-                    }
-                } // i
-            } // j
+                        Real actual_h = actualPos.z;
+                        Real delta = interp_h - actual_h;
 
-        } // targetLevel
+                        // max(delta) is the worst case scenario at this LOD
+                        // compared to the original heightmap
 
-        mQuadTree->postDeltaCalculation(clampedRect);
+                        // tell the quadtree about this 
+                        mQuadTree->notifyDelta(fulldetailx, fulldetaily, sourceLevel, delta);
 
-        return finalRect;
+
+                        // If this vertex is being removed at this LOD, 
+                        // then save the height difference since that's the move
+                        // it will need to make. Vertices to be removed at this LOD
+                        // are halfway between the steps, but exclude those that
+                        // would have been eliminated at earlier levels
+                        int halfStep = step / 2;
+                        if (
+                         ((fulldetailx % step) == halfStep && (fulldetaily % halfStep) == 0) ||
+                         ((fulldetaily % step) == halfStep && (fulldetailx % halfStep) == 0))
+                        {
+                            // Save height difference 
+                            mDeltaData[fulldetailx + (fulldetaily * mSize)] = delta;
+                        }
+
+                    }
+
+                }
+            } // i
+        } // j
 
     }
     //---------------------------------------------------------------------
@@ -2283,6 +2480,10 @@ namespace Ogre
         if (!mIsLoaded)
             return;
 
+        // patches are collected again for every visibility pass
+        if (mPatchRenderer)
+            mPatchRenderer->_beginPass();
+
         // check deferred updates
         unsigned long currMillis = Root::getSingleton().getTimer()->getMilliseconds();
         unsigned long elapsedMillis = currMillis - mLastMillis;
@@ -2344,17 +2545,48 @@ namespace Ogre
     //---------------------------------------------------------------------
     std::pair<bool, Vector3> Terrain::rayIntersects(const Ray& ray, 
         bool cascadeToNeighbours /* = false */, Real distanceLimit /* = 0 */)
+    {
+        std::pair<bool, Vector3> result = rayIntersectsHeights(getHeightQueryData(), ray);
+        if (!result.first && cascadeToNeighbours)
+        {
+            OGRE_LOCK_RW_MUTEX_READ(mNeighbourMutex);
+            Terrain* neighbour = raySelectNeighbour(ray, distanceLimit);
+            if (neighbour)
+                result = neighbour->rayIntersects(ray, cascadeToNeighbours, distanceLimit);
+        }
+        return result;
+    }
+    //---------------------------------------------------------------------
+    Terrain::HeightQueryData Terrain::getHeightQueryData() const
+    {
+        HeightQueryData data;
+        data.heights = mHeightData;
+        data.compressedHeights = mHeightData ? 0 : mCompressedHeightData.get();
+        data.heightRanges = &mHeightRanges;
+        data.size = mSize;
+        data.worldSize = mWorldSize;
+        data.position = mPos;
+        data.alignment = mAlign;
+        return data;
+    }
+    //---------------------------------------------------------------------
+    std::pair<bool, Vector3> Terrain::rayIntersectsHeights(const HeightQueryData& data, const Ray& ray)
     {
         typedef std::pair<bool, Vector3> Result;
+        if (data.heightRanges->empty())
+            return Result(false, Vector3());
+        const Real worldSize = data.worldSize;
+        const Real scale = worldSize / (Real)(data.size - 1);
+
         // first step: convert the ray to a local vertex space
         // we assume terrain to be in the x-z plane, with the [0,0] vertex
         // at origin and a plane distance of 1 between vertices.
         // This makes calculations easier.
-        Vector3 rayOrigin = ray.getOrigin() - getPosition();
+        Vector3 rayOrigin = ray.getOrigin() - data.position;
         Vector3 rayDirection = ray.getDirection();
         // change alignment
         Vector3 tmp;
-        switch (getAlignment())
+        switch (data.alignment)
         {
         case ALIGN_X_Y:
             std::swap(rayOrigin.y, rayOrigin.z);
@@ -2378,116 +2610,265 @@ namespace Ogre
             break;
         }
         // readjust coordinate origin
-        rayOrigin.x += mWorldSize/2;
-        rayOrigin.z += mWorldSize/2;
+        rayOrigin.x += worldSize/2;
+        rayOrigin.z += worldSize/2;
         // scale down to vertex level
-        rayOrigin.x /= mScale;
-        rayOrigin.z /= mScale;
-        rayDirection.x /= mScale;
-        rayDirection.z /= mScale;
+        rayOrigin.x /= scale;
+        rayOrigin.z /= scale;
+        rayDirection.x /= scale;
+        rayDirection.z /= scale;
         rayDirection.normalise();
         Ray localRay (rayOrigin, rayDirection);
 
-        // test if the ray actually hits the terrain's bounds
-        Real maxHeight = getMaxHeight();
-        Real minHeight = getMinHeight();
+        // descend the height range pyramid from the single top node, only
+        // visiting the quads whose bounds the ray passes through
+        Result result(false, Vector3::ZERO);
+        result.first = rayIntersectsHeightRange(data, localRay, data.heightRanges->size() - 1, 0, 0, &result.second);
 
-        AxisAlignedBox aabb (Vector3(0, minHeight, 0), Vector3(mSize, maxHeight, mSize));
-        std::pair<bool, Real> aabbTest = localRay.intersects(aabb);
-        if (!aabbTest.first)
+        if (result.first)
         {
-            if (cascadeToNeighbours)
+            // transform the point of intersection back to world space
+            result.second.x *= scale;
+            result.second.z *= scale;
+            result.second.x -= worldSize/2;
+            result.second.z -= worldSize/2;
+            switch (data.alignment)
             {
-                OGRE_LOCK_RW_MUTEX_READ(mNeighbourMutex);
-                Terrain* neighbour = raySelectNeighbour(ray, distanceLimit);
-                if (neighbour)
-                    return neighbour->rayIntersects(ray, cascadeToNeighbours, distanceLimit);
+            case ALIGN_X_Y:
+                std::swap(result.second.y, result.second.z);
+                break;
+            case ALIGN_Y_Z:
+                // z = x, y = z, x = -y
+                tmp.x = -result.second.y; 
+                tmp.y = result.second.z; 
+                tmp.z = result.second.x; 
+                result.second = tmp;
+                break;
+            case ALIGN_X_Z:
+                result.second.z = -result.second.z;
+                break;
             }
-            return Result(false, Vector3());
+            result.second += data.position;
         }
-        // get intersection point and move inside
-        Vector3 cur = localRay.getPoint(aabbTest.second);
-
-        // now check every quad the ray touches
-        int quadX = std::min(std::max(static_cast<int>(cur.x), 0), (int)mSize-2);
-        int quadZ = std::min(std::max(static_cast<int>(cur.z), 0), (int)mSize-2);
-        int flipX = (rayDirection.x < 0 ? 0 : 1);
-        int flipZ = (rayDirection.z < 0 ? 0 : 1);
-        int xDir = (rayDirection.x < 0 ? -1 : 1);
-        int zDir = (rayDirection.z < 0 ? -1 : 1);
+        return result;
+    }
+    //---------------------------------------------------------------------
+    bool Terrain::rayIntersectsHeightRange(const HeightQueryData& data, const Ray& localRay, 
+        size_t level, long x, long z, Vector3* hit)
+    {
+        const HeightRangePyramid& heightRanges = *data.heightRanges;
+        const long quads = data.size - 1;
+        const long levelSize = (quads + (1L << level) - 1) >> level;
+        const HeightRange& range = heightRanges[level][z * levelSize + x];
 
-        Result result(true, Vector3::ZERO);
-        Real dummyHighValue = (Real)mSize * 10000.0f;
+        // bounds of the node in vertex space, padded like the quad test
+        long left = x << level;
+        long top = z << level;
+        long right = std::min(left + (1L << level), quads);
+        long bottom = std::min(top + (1L << level), quads);
+        AxisAlignedBox box(
+            Vector3((Real)left - 0.01f, range.minHeight - 1e-3f, (Real)top - 0.01f),
+            Vector3((Real)right + 0.01f, range.maxHeight + 1e-3f, (Real)bottom + 0.01f));
+        if (!localRay.intersects(box).first)
+            return false;
 
+        if (level == 0)
+        {
+            std::pair<bool, Vector3> quadHit = checkQuadIntersection(data, (int)x, (int)z, localRay);
+            if (quadHit.first)
+                *hit = quadHit.second;
+            return quadHit.first;
+        }
 
-        while (cur.y >= (minHeight - 1e-3) && cur.y <= (maxHeight + 1e-3))
+        // Visit the children in the order the ray enters them, the footprints
+        // don't overlap so the first hit is the nearest
+        const size_t childLevel = level - 1;
+        const long childSize = (quads + (1L << childLevel) - 1) >> childLevel;
+        long childX[4], childZ[4];
+        Real childDist[4];
+        int numChildren = 0;
+        for (long cz = z * 2; cz < std::min(z * 2 + 2, childSize); ++cz)
         {
-            if (quadX < 0 || quadX >= (int)mSize-1 || quadZ < 0 || quadZ >= (int)mSize-1)
-                break;
+            for (long cx = x * 2; cx < std::min(x * 2 + 2, childSize); ++cx)
+            {
+                const HeightRange& childRange = heightRanges[childLevel][cz * childSize + cx];
+                long childLeft = cx << childLevel;
+                long childTop = cz << childLevel;
+                AxisAlignedBox childBox(
+                    Vector3((Real)childLeft - 0.01f, childRange.minHeight - 1e-3f, (Real)childTop - 0.01f),
+                    Vector3((Real)std::min(childLeft + (1L << childLevel), quads) + 0.01f, 
+                        childRange.maxHeight + 1e-3f, 
+                        (Real)std::min(childTop + (1L << childLevel), quads) + 0.01f));
+                std::pair<bool, Real> childHit = localRay.intersects(childBox);
+                if (!childHit.first)
+                    continue;
 
-            result = checkQuadIntersection(quadX, quadZ, localRay);
-            if (result.first)
-                break;
+                // insertion sort by distance
+                int i = numChildren++;
+                for (; i > 0 && childDist[i - 1] > childHit.second; --i)
+                {
+                    childX[i] = childX[i - 1];
+                    childZ[i] = childZ[i - 1];
+                    childDist[i] = childDist[i - 1];
+                }
+                childX[i] = cx;
+                childZ[i] = cz;
+                childDist[i] = childHit.second;
+            }
+        }
 
-            // determine next quad to test
-            Real xDist = Math::RealEqual(rayDirection.x, 0.0) ? dummyHighValue : 
-                (quadX - cur.x + flipX) / rayDirection.x;
-            Real zDist = Math::RealEqual(rayDirection.z, 0.0) ? dummyHighValue : 
-                (quadZ - cur.z + flipZ) / rayDirection.z;
-            if (xDist < zDist)
+        for (int i = 0; i < numChildren; ++i)
+        {
+            if (rayIntersectsHeightRange(data, localRay, childLevel, childX[i], childZ[i], hit))
+                return true;
+        }
+        return false;
+    }
+    //---------------------------------------------------------------------
+    void Terrain::updateHeightRanges(const Rect& rect)
+    {
+        if (!mHeightData && !mCompressedHeightData)
+            return;
+
+        const long quads = mSize - 1;
+        Rect quadRect(0, 0, quads, quads);
+        if (mHeightRanges.empty() || mHeightRanges[0].size() != (size_t)(quads * quads))
+        {
+            // (re)build all levels
+            mHeightRanges.clear();
+            for (long levelSize = quads; ; levelSize = (levelSize + 1) / 2)
             {
-                quadX += xDir;
-                cur += rayDirection * xDist;
+                mHeightRanges.push_back(HeightRangeList(levelSize * levelSize));
+                if (levelSize == 1)
+                    break;
             }
-            else
+        }
+        else
+        {
+            // a changed point affects the quads on all sides of it
+            quadRect.left = std::max(0L, rect.left - 1L);
+            quadRect.top = std::max(0L, rect.top - 1L);
+            quadRect.right = std::min(quads, rect.right);
+            quadRect.bottom = std::min(quads, rect.bottom);
+            if (quadRect.isNull())
+                return;
+        }
+
+        const HeightQueryData data = getHeightQueryData();
+        HeightRangeList& quadRanges = mHeightRanges[0];
+        for (long z = quadRect.top; z < quadRect.bottom; ++z)
+        {
+            for (long x = quadRect.left; x < quadRect.right; ++x)
             {
-                quadZ += zDir;
-                cur += rayDirection * zDist;
+                float h1 = data.getHeight(x, z), h2 = data.getHeight(x + 1, z);
+                float h3 = data.getHeight(x, z + 1), h4 = data.getHeight(x + 1, z + 1);
+                HeightRange& range = quadRanges[z * quads + x];
+                range.minHeight = std::min(std::min(h1, h2), std::min(h3, h4));
+                range.maxHeight = std::max(std::max(h1, h2), std::max(h3, h4));
+                // checkQuadIntersection accepts hits up to 0.01 outside the quad on
+                // the extended triangle planes, which can leave the quad's heights
+                float pad = (range.maxHeight - range.minHeight) * 0.02f;
+                range.minHeight -= pad;
+                range.maxHeight += pad;
             }
-
         }
 
-        if (result.first)
+        long childSize = quads;
+        for (size_t level = 1; level < mHeightRanges.size(); ++level)
         {
-            // transform the point of intersection back to world space
-            result.second.x *= mScale;
-            result.second.z *= mScale;
-            result.second.x -= mWorldSize/2;
-            result.second.z -= mWorldSize/2;
-            switch (getAlignment())
+            long levelSize = (childSize + 1) / 2;
+            quadRect.left /= 2;
+            quadRect.top /= 2;
+            quadRect.right = (quadRect.right + 1) / 2;
+            quadRect.bottom = (quadRect.bottom + 1) / 2;
+
+            const HeightRangeList& childRanges = mHeightRanges[level - 1];
+            HeightRangeList& ranges = mHeightRanges[level];
+            for (long z = quadRect.top; z < quadRect.bottom; ++z)
             {
-            case ALIGN_X_Y:
-                std::swap(result.second.y, result.second.z);
-                break;
-            case ALIGN_Y_Z:
-                // z = x, y = z, x = -y
-                tmp.x = -rayOrigin.y; 
-                tmp.y = rayOrigin.z; 
-                tmp.z = rayOrigin.x; 
-                rayOrigin = tmp;
-                break;
-            case ALIGN_X_Z:
-                result.second.z = -result.second.z;
-                break;
+                for (long x = quadRect.left; x < quadRect.right; ++x)
+                {
+                    HeightRange& range = ranges[z * levelSize + x];
+                    range = childRanges[z * 2 * childSize + x * 2];
+                    for (long cz = z * 2; cz < std::min(z * 2 + 2, childSize); ++cz)
+                    {
+                        for (long cx = x * 2; cx < std::min(x * 2 + 2, childSize); ++cx)
+                        {
+                            const HeightRange& childRange = childRanges[cz * childSize + cx];
+                            range.minHeight = std::min(range.minHeight, childRange.minHeight);
+                            range.maxHeight = std::max(range.maxHeight, childRange.maxHeight);
+                        }
+                    }
+                }
             }
-            result.second += getPosition();
+            childSize = levelSize;
         }
-        else if (cascadeToNeighbours)
+    }
+    //---------------------------------------------------------------------
+    class Terrain::QueryJob : public ParallelJob
+    {
+    public:
+        QueryJob(const Terrain* terrain, const Ray* rays, std::pair<bool, Vector3>* rayResults,
+            const Vector3* positions, float* heights, size_t count)
+            : ParallelJob(count, 64), mTerrain(terrain), mData(terrain->getHeightQueryData())
+            , mRays(rays), mRayResults(rayResults)
+            , mPositions(positions), mHeights(heights) {}
+
+        void execute(size_t begin, size_t end)
         {
-            Terrain* neighbour = raySelectNeighbour(ray, distanceLimit);
-            if (neighbour)
-                result = neighbour->rayIntersects(ray, cascadeToNeighbours, distanceLimit);
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (mRays)
+                    mRayResults[i] = rayIntersectsHeights(mData, mRays[i]);
+                else
+                    mHeights[i] = mTerrain->getHeightAtWorldPosition(mPositions[i]);
+            }
         }
-        return result;
+
+    private:
+        const Terrain* mTerrain;
+        HeightQueryData mData;
+        const Ray* mRays;
+        std::pair<bool, Vector3>* mRayResults;
+        const Vector3* mPositions;
+        float* mHeights;
+    };
+    //---------------------------------------------------------------------
+    void Terrain::rayIntersects(const Ray* rays, size_t count, std::pair<bool, Vector3>* results) const
+    {
+        if (count)
+            ParallelJob::run(ParallelJobPtr(OGRE_NEW QueryJob(this, rays, results, 0, 0, count)));
+    }
+    //---------------------------------------------------------------------
+    void Terrain::getHeightsAtWorldPositions(const Vector3* positions, size_t count, float* heights) const
+    {
+        if (count)
+            ParallelJob::run(ParallelJobPtr(OGRE_NEW QueryJob(this, 0, 0, positions, heights, count)));
+    }
+    //---------------------------------------------------------------------
+    void Terrain::publishHeightSnapshot()
+    {
+        TerrainHeightSnapshotPtr snapshot;
+        if ((mHeightData || mCompressedHeightData) && !mHeightRanges.empty())
+            snapshot.reset(OGRE_NEW TerrainHeightSnapshot(*this));
+        OGRE_WQ_LOCK_MUTEX(mHeightSnapshotMutex);
+        std::swap(mHeightSnapshot, snapshot);
+    }
+    //---------------------------------------------------------------------
+    TerrainHeightSnapshotPtr Terrain::getHeightSnapshot() const
+    {
+        OGRE_WQ_LOCK_MUTEX(mHeightSnapshotMutex);
+        return mHeightSnapshot;
     }
     //---------------------------------------------------------------------
-    std::pair<bool, Vector3> Terrain::checkQuadIntersection(int x, int z, const Ray& ray)
+    std::pair<bool, Vector3> Terrain::checkQuadIntersection(const HeightQueryData& data, 
+        int x, int z, const Ray& ray)
     {
         // build the two planes belonging to the quad's triangles
-        Vector3 v1 ((Real)x, *getHeightData(x,z), (Real)z);
-        Vector3 v2 ((Real)x+1, *getHeightData(x+1,z), (Real)z);
-        Vector3 v3 ((Real)x, *getHeightData(x,z+1), (Real)z+1);
-        Vector3 v4 ((Real)x+1, *getHeightData(x+1,z+1), (Real)z+1);
+        Vector3 v1 ((Real)x, data.getHeight(x, z), (Real)z);
+        Vector3 v2 ((Real)x+1, data.getHeight(x + 1, z), (Real)z);
+        Vector3 v3 ((Real)x, data.getHeight(x, z + 1), (Real)z+1);
+        Vector3 v4 ((Real)x+1, data.getHeight(x + 1, z + 1), (Real)z+1);
 
         Plane p1, p2;
         bool oddRow = false;
@@ -3020,6 +3401,115 @@ namespace Ogre
 
         // Editable structures for blend layers (not needed at runtime,  only blend textures are)
         deleteBlendMaps(0); 
+
+        if (TerrainGlobalOptions::getSingleton().getCompressHeightData() && !mPrepareInProgress)
+            compressHeightData();
+    }
+    //---------------------------------------------------------------------
+    void Terrain::compressHeightData()
+    {
+        if (!mHeightData)
+            return;
+
+        // nothing may be reading the raw data in the background
+        waitForDerivedProcesses();
+        if (mLodManager)
+            mLodManager->waitForDerivedProcesses();
+
+        mCompressedHeightData.reset(OGRE_NEW CompressedHeightData(mHeightData, mDeltaData, mSize));
+        OGRE_FREE(mHeightData, MEMCATEGORY_GEOMETRY);
+        mHeightData = 0;
+        OGRE_FREE(mDeltaData, MEMCATEGORY_GEOMETRY);
+        mDeltaData = 0;
+
+        // ranges must contain the quantised heights for ray queries to find them
+        updateHeightRanges(Rect(0, 0, mSize, mSize));
+        publishHeightSnapshot();
+    }
+    //---------------------------------------------------------------------
+    void Terrain::decompressHeightData()
+    {
+        if (mHeightData || !mCompressedHeightData)
+            return;
+
+        size_t numVertices = mSize * mSize;
+        mHeightData = OGRE_ALLOC_T(float, numVertices, MEMCATEGORY_GEOMETRY);
+        mDeltaData = OGRE_ALLOC_T(float, numVertices, MEMCATEGORY_GEOMETRY);
+        mCompressedHeightData->decompress(mHeightData, mDeltaData);
+        // published snapshots may still share it
+        mCompressedHeightData.reset();
+    }
+    //---------------------------------------------------------------------
+    Terrain::QuantisedRange Terrain::quantise(const float* src, size_t srcStride, 
+        uint16* dst, size_t dstStride, size_t width, size_t height)
+    {
+        float minValue = src[0], maxValue = src[0];
+        for (size_t y = 0; y < height; ++y)
+        {
+            const float* pSrc = src + y * srcStride;
+            for (size_t x = 0; x < width; ++x)
+            {
+                minValue = std::min(minValue, pSrc[x]);
+                maxValue = std::max(maxValue, pSrc[x]);
+            }
+        }
+
+        QuantisedRange range;
+        range.offset = minValue;
+        range.scale = (maxValue - minValue) / 65535.0f;
+        float invScale = range.scale > 0 ? 1.0f / range.scale : 0.0f;
+        for (size_t y = 0; y < height; ++y)
+        {
+            const float* pSrc = src + y * srcStride;
+            uint16* pDst = dst + y * dstStride;
+            for (size_t x = 0; x < width; ++x)
+            {
+                float value = (pSrc[x] - minValue) * invScale + 0.5f;
+                pDst[x] = static_cast<uint16>(std::min(value, 65535.0f));
+            }
+        }
+        return range;
+    }
+    //---------------------------------------------------------------------
+    Terrain::CompressedHeightData::CompressedHeightData(const float* heightData, 
+        const float* deltaData, uint16 terrainSize)
+        : size(terrainSize)
+        , blocksPerSide((terrainSize + COMPRESSED_HEIGHT_BLOCK_SIZE - 1) / COMPRESSED_HEIGHT_BLOCK_SIZE)
+        , heights(terrainSize * terrainSize)
+        , deltas(terrainSize * terrainSize)
+        , heightRanges(blocksPerSide * blocksPerSide)
+        , deltaRanges(blocksPerSide * blocksPerSide)
+    {
+        for (uint16 by = 0; by < blocksPerSide; ++by)
+        {
+            for (uint16 bx = 0; bx < blocksPerSide; ++bx)
+            {
+                size_t x = bx * COMPRESSED_HEIGHT_BLOCK_SIZE;
+                size_t y = by * COMPRESSED_HEIGHT_BLOCK_SIZE;
+                size_t width = std::min<size_t>(COMPRESSED_HEIGHT_BLOCK_SIZE, size - x);
+                size_t height = std::min<size_t>(COMPRESSED_HEIGHT_BLOCK_SIZE, size - y);
+                size_t offset = y * size + x;
+                size_t block = by * blocksPerSide + bx;
+                heightRanges[block] = quantise(heightData + offset, size, &heights[offset], size, width, height);
+                deltaRanges[block] = quantise(deltaData + offset, size, &deltas[offset], size, width, height);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void Terrain::CompressedHeightData::decompress(float* heightData, float* deltaData) const
+    {
+        for (size_t y = 0; y < size; ++y)
+        {
+            const QuantisedRange* pHeightRanges = &heightRanges[(y / COMPRESSED_HEIGHT_BLOCK_SIZE) * blocksPerSide];
+            const QuantisedRange* pDeltaRanges = &deltaRanges[(y / COMPRESSED_HEIGHT_BLOCK_SIZE) * blocksPerSide];
+            for (size_t x = 0; x < size; ++x)
+            {
+                size_t i = y * size + x;
+                size_t block = x / COMPRESSED_HEIGHT_BLOCK_SIZE;
+                heightData[i] = pHeightRanges[block].decode(heights[i]);
+                deltaData[i] = pDeltaRanges[block].decode(deltas[i]);
+            }
+        }
     }
     //---------------------------------------------------------------------
     void Terrain::deleteBlendMaps(uint8 lowIndex)
@@ -3125,6 +3615,14 @@ namespace Ogre
             TerrainGlobalOptions::getSingleton().getUseVertexCompressionWhenAvailable();
     }
     //---------------------------------------------------------------------
+    bool Terrain::_getUseInstancedPatches() const
+    {
+        // patches are positioned by vertex index, which is the compressed layout
+        return TerrainGlobalOptions::getSingleton().getUseInstancedPatches() &&
+            _getUseVertexCompression() &&
+            mMaterialGenerator->isInstancedPatchRenderingSupported();
+    }
+    //---------------------------------------------------------------------
     bool Terrain::canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
     {
         if(req->getType()==WORKQUEUE_DERIVED_DATA_REQUEST)
@@ -3281,6 +3779,13 @@ namespace Ogre
         switch(gmreq.stage)
         {
         case GEN_MATERIAL:
+            if (_getUseInstancedPatches())
+            {
+                // the material samples the heights, so they must exist first
+                updateGPUHeightTexture(Rect(0, 0, 0, 0));
+                if (!mPatchRenderer)
+                    mPatchRenderer = OGRE_NEW TerrainPatchRenderer(this);
+            }
             mMaterial = mMaterialGenerator->generate(this);
             mMaterial->load();
             // init next stage
@@ -3350,6 +3855,20 @@ namespace Ogre
         PixelBox* pixbox = OGRE_NEW PixelBox(static_cast<uint32>(widenedRect.width()),
                                              static_cast<uint32>(widenedRect.height()), 1, PF_BYTE_RGB, pData);
 
+        // Rows are processed in parallel, in chunks of a few thousand normals
+        size_t rows = static_cast<size_t>(widenedRect.height());
+        size_t grainSize = std::max<size_t>(1, 4096 / std::max(1L, widenedRect.width()));
+        if (rows)
+            ParallelJob::run(ParallelJobPtr(OGRE_NEW DerivedDataJob(
+                this, DerivedDataJob::NORMALS, widenedRect, pData, rows, grainSize)));
+
+        finalRect = widenedRect;
+
+        return pixbox;
+    }
+    //---------------------------------------------------------------------
+    void Terrain::calculateNormalsRows(const Rect& rect, uint8* pData, long top, long bottom) const
+    {
         // Evaluate normal like this
         //  3---2---1
         //  | \ | / |
@@ -3357,29 +3876,40 @@ namespace Ogre
         //  | / | \ |
         //  5---6---7
 
+        // Keep the points of the rows below, at and above the current one, since
+        // each point is shared by the normals of 9 elements
+        const long rowSize = rect.width() + 2;
+        vector<Vector3>::type points(rowSize * 3);
+        Vector3* rowPoints[3] = { &points[0], &points[rowSize], &points[rowSize * 2] };
+        for (long i = 0; i < rowSize; ++i)
+        {
+            getPointFromSelfOrNeighbour(rect.left - 1 + i, top - 1, &rowPoints[0][i]);
+            getPointFromSelfOrNeighbour(rect.left - 1 + i, top, &rowPoints[1][i]);
+        }
+
         Plane plane;
-        for (long y = widenedRect.top; y < widenedRect.bottom; ++y)
+        for (long y = top; y < bottom; ++y)
         {
-            for (long x = widenedRect.left; x < widenedRect.right; ++x)
+            for (long i = 0; i < rowSize; ++i)
+                getPointFromSelfOrNeighbour(rect.left - 1 + i, y + 1, &rowPoints[2][i]);
+
+            const Vector3* below = rowPoints[0];
+            const Vector3* row = rowPoints[1];
+            const Vector3* above = rowPoints[2];
+            for (long x = rect.left; x < rect.right; ++x)
             {
                 Vector3 cumulativeNormal = Vector3::ZERO;
 
                 // Build points to sample
-                Vector3 centrePoint;
-                Vector3 adjacentPoints[8];
-                getPointFromSelfOrNeighbour(x  , y,   &centrePoint);
-                getPointFromSelfOrNeighbour(x+1, y,   &adjacentPoints[0]);
-                getPointFromSelfOrNeighbour(x+1, y+1, &adjacentPoints[1]);
-                getPointFromSelfOrNeighbour(x,   y+1, &adjacentPoints[2]);
-                getPointFromSelfOrNeighbour(x-1, y+1, &adjacentPoints[3]);
-                getPointFromSelfOrNeighbour(x-1, y,   &adjacentPoints[4]);
-                getPointFromSelfOrNeighbour(x-1, y-1, &adjacentPoints[5]);
-                getPointFromSelfOrNeighbour(x,   y-1, &adjacentPoints[6]);
-                getPointFromSelfOrNeighbour(x+1, y-1, &adjacentPoints[7]);
-
-                for (int i = 0; i < 8; ++i)
+                long i = x - rect.left + 1;
+                const Vector3& centrePoint = row[i];
+                const Vector3* adjacentPoints[8] = {
+                    &row[i+1], &above[i+1], &above[i], &above[i-1],
+                    &row[i-1], &below[i-1], &below[i], &below[i+1] };
+
+                for (int n = 0; n < 8; ++n)
                 {
-                    plane.redefine(centrePoint, adjacentPoints[i], adjacentPoints[(i+1)%8]);
+                    plane.redefine(centrePoint, *adjacentPoints[n], *adjacentPoints[(n+1)%8]);
                     cumulativeNormal += plane.normal;
                 }
 
@@ -3388,21 +3918,21 @@ namespace Ogre
 
                 // encode as RGB, object space
                 // invert the Y to deal with image space
-                long storeX = x - widenedRect.left;
-                long storeY = widenedRect.bottom - y - 1;
+                long storeX = x - rect.left;
+                long storeY = rect.bottom - y - 1;
 
-                uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX) * 3;
+                uint8* pStore = pData + ((storeY * rect.width()) + storeX) * 3;
                 *pStore++ = static_cast<uint8>((cumulativeNormal.x + 1.0f) * 0.5f * 255.0f);
                 *pStore++ = static_cast<uint8>((cumulativeNormal.y + 1.0f) * 0.5f * 255.0f);
                 *pStore++ = static_cast<uint8>((cumulativeNormal.z + 1.0f) * 0.5f * 255.0f);
-
-
             }
-        }
 
-        finalRect = widenedRect;
-
-        return pixbox;
+            // move the rows down
+            Vector3* oldest = rowPoints[0];
+            rowPoints[0] = rowPoints[1];
+            rowPoints[1] = rowPoints[2];
+            rowPoints[2] = oldest;
+        }
     }
     //---------------------------------------------------------------------
     void Terrain::finaliseNormals(const Ogre::Rect &rect, Ogre::PixelBox *normalsBox)
@@ -3496,14 +4026,8 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
-    PixelBox* Terrain::calculateLightmap(const Rect& rect, const Rect& extraTargetRect, Rect& outFinalRect)
+    Rect Terrain::getLightmapUpdateRect(const Rect& rect, const Rect& extraTargetRect)
     {
-        // as well as calculating the lighting changes for the area that is
-        // dirty, we also need to calculate the effect on casting shadow on
-        // other areas. To do this, we project the dirt rect by the light direction
-        // onto the minimum height
-
-
         const Vector3& lightVec = TerrainGlobalOptions::getSingleton().getLightMapDirection();
         Ogre::Rect widenedRect;
         widenRectByVector(lightVec, rect, widenedRect);
@@ -3525,6 +4049,18 @@ namespace Ogre
         widenedRect.right = std::min((long)mLightmapSizeActual, widenedRect.right);
         widenedRect.bottom = std::min((long)mLightmapSizeActual, widenedRect.bottom);
 
+        return widenedRect;
+    }
+    //---------------------------------------------------------------------
+    PixelBox* Terrain::calculateLightmap(const Rect& rect, const Rect& extraTargetRect, Rect& outFinalRect)
+    {
+        // as well as calculating the lighting changes for the area that is
+        // dirty, we also need to calculate the effect on casting shadow on
+        // other areas. To do this, we project the dirt rect by the light direction
+        // onto the minimum height
+
+
+        Rect widenedRect = getLightmapUpdateRect(rect, extraTargetRect);
         outFinalRect = widenedRect;
 
         // allocate memory (L8)
@@ -3534,11 +4070,25 @@ namespace Ogre
         PixelBox* pixbox = OGRE_NEW PixelBox(static_cast<uint32>(widenedRect.width()),
                                              static_cast<uint32>(widenedRect.height()), 1, PF_L8, pData);
 
+        // Every element casts a ray, so rows are processed in parallel one by one
+        size_t rows = static_cast<size_t>(widenedRect.height());
+        if (rows)
+            ParallelJob::run(ParallelJobPtr(OGRE_NEW DerivedDataJob(
+                this, DerivedDataJob::LIGHTMAP, widenedRect, pData, rows, 1)));
+
+        return pixbox;
+
+
+    }
+    //---------------------------------------------------------------------
+    void Terrain::calculateLightmapRows(const Rect& rect, uint8* pData, long top, long bottom)
+    {
+        const Vector3& lightVec = TerrainGlobalOptions::getSingleton().getLightMapDirection();
         Real heightPad = (getMaxHeight() - getMinHeight()) * 1.0e-3f;
 
-        for (long y = widenedRect.top; y < widenedRect.bottom; ++y)
+        for (long y = top; y < bottom; ++y)
         {
-            for (long x = widenedRect.left; x < widenedRect.right; ++x)
+            for (long x = rect.left; x < rect.right; ++x)
             {
                 float litVal = 1.0f;
 
@@ -3563,18 +4113,14 @@ namespace Ogre
 
                 // encode as L8
                 // invert the Y to deal with image space
-                long storeX = x - widenedRect.left;
-                long storeY = widenedRect.bottom - y - 1;
+                long storeX = x - rect.left;
+                long storeY = rect.bottom - y - 1;
 
-                uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX);
+                uint8* pStore = pData + ((storeY * rect.width()) + storeX);
                 *pStore = (unsigned char)(litVal * 255.0);
 
             }
         }
-
-        return pixbox;
-
-
     }
     //---------------------------------------------------------------------
     void Terrain::finaliseLightmap(const Rect& rect, PixelBox* lightmapBox)
@@ -3606,6 +4152,77 @@ namespace Ogre
         OGRE_DELETE(lightmapBox);
 
 
+    }
+    //---------------------------------------------------------------------
+    void Terrain::updateGPUHeightTexture(const Rect& rect)
+    {
+        Rect updateRect = rect;
+        if (!mHeightTexture)
+        {
+            mHeightTexture = TextureManager::getSingleton().createManual(
+                mMaterialName + "/height", _getDerivedResourceGroup(), 
+                TEX_TYPE_2D, mSize, mSize, 1, 0, PF_FLOAT32_R, TU_DYNAMIC_WRITE_ONLY);
+            updateRect = Rect(0, 0, mSize, mSize);
+        }
+
+        if (updateRect.isNull())
+            return;
+
+        // invert the Y to deal with image space, like the maps it's used to render
+        size_t width = static_cast<size_t>(updateRect.width());
+        size_t height = static_cast<size_t>(updateRect.height());
+        float* pData = static_cast<float*>(
+            OGRE_MALLOC(width * height * sizeof(float), MEMCATEGORY_GENERAL));
+        for (size_t y = 0; y < height; ++y)
+        {
+            const float* pSrc = getHeightData(updateRect.left, updateRect.bottom - 1 - y);
+            memcpy(pData + y * width, pSrc, width * sizeof(float));
+        }
+        PixelBox src(static_cast<uint32>(width), static_cast<uint32>(height), 1, PF_FLOAT32_R, pData);
+        Box dstBox(static_cast<uint32>(updateRect.left), static_cast<uint32>(mSize - updateRect.bottom),
+                   static_cast<uint32>(updateRect.right), static_cast<uint32>(mSize - updateRect.top));
+        mHeightTexture->getBuffer()->blitFromMemory(src, dstBox);
+
+        OGRE_FREE(pData, MEMCATEGORY_GENERAL);
+    }
+    //---------------------------------------------------------------------
+    uint8 Terrain::renderDerivedDataOnGpu(const Rect& rect, const Rect& lightmapExtraRect, uint8 typeMask)
+    {
+        uint8 done = typeMask & (DERIVED_DATA_NORMALS | DERIVED_DATA_LIGHTMAP);
+        if (!done)
+            return 0;
+
+        updateGPUHeightTexture(rect);
+
+        if (done & DERIVED_DATA_NORMALS)
+        {
+            createOrDestroyGPUNormalMap();
+            // Widen the rectangle by 1 element in all directions since height
+            // changes affect neighbours normals, then invert to image space
+            Rect imgRect(
+                std::max(0L, rect.left - 1L), 
+                std::max(0L, (long)mSize - rect.bottom - 1L), 
+                std::min((long)mSize, rect.right + 1L), 
+                std::min((long)mSize, (long)mSize - rect.top + 1L)
+                );
+            mMaterialGenerator->_renderDerivedMap(this, TerrainMaterialGenerator::DM_NORMAL_MAP,
+                mHeightTexture, imgRect, mTerrainNormalMap);
+            mCompositeMapDirtyRect.merge(rect);
+        }
+        if (done & DERIVED_DATA_LIGHTMAP)
+        {
+            createOrDestroyGPULightmap();
+            Rect lmRect = getLightmapUpdateRect(rect, lightmapExtraRect);
+            Rect imgRect(lmRect.left, (long)mLightmapSizeActual - lmRect.bottom,
+                lmRect.right, (long)mLightmapSizeActual - lmRect.top);
+            if (!imgRect.isNull())
+                mMaterialGenerator->_renderDerivedMap(this, TerrainMaterialGenerator::DM_LIGHTMAP,
+                    mHeightTexture, imgRect, mLightmap);
+            mCompositeMapDirtyRect.merge(rect);
+            mCompositeMapDirtyRectLightmapUpdate = true;
+        }
+
+        return done;
     }
     //---------------------------------------------------------------------
     void Terrain::updateCompositeMap()
@@ -4538,6 +5155,7 @@ namespace Ogre
             mWorldSize = newWorldSize;
 
             updateBaseScale();
+            publishHeightSnapshot();
 
             deriveUVMultipliers();
 
@@ -4597,6 +5215,8 @@ namespace Ogre
 
             mQuadTree = OGRE_NEW TerrainQuadTreeNode(this, 0, 0, 0, mSize, mNumLodLevels - 1, 0, 0);
             mQuadTree->prepare();
+            updateHeightRanges(Rect(0, 0, mSize, mSize));
+            publishHeightSnapshot();
 
             // calculate entire terrain
             Rect rect;
@@ -4749,4 +5369,67 @@ namespace Ogre
             neighbour->setNeighbour(getOppositeNeighbour(ni), 0, false, false);
         }
     }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    TerrainHeightSnapshot::TerrainHeightSnapshot(const Terrain& terrain)
+        : mHeightRanges(terrain.mHeightRanges)
+        , mData(terrain.getHeightQueryData())
+    {
+        if (terrain.mHeightData)
+        {
+            mHeights.assign(terrain.mHeightData, terrain.mHeightData + terrain.mSize * terrain.mSize);
+            mData.heights = &mHeights[0];
+        }
+        else
+        {
+            mCompressedHeights = terrain.mCompressedHeightData;
+            mData.compressedHeights = mCompressedHeights.get();
+        }
+        mData.heightRanges = &mHeightRanges;
+
+        // the top of the pyramid holds the range of the whole terrain
+        const Terrain::HeightRange& range = mHeightRanges.back()[0];
+        Real halfWorldSize = mData.worldSize * 0.5f;
+        Vector3 corner1, corner2;
+        Terrain::convertTerrainToWorldAxes(mData.alignment,
+            Vector3(-halfWorldSize, -halfWorldSize, range.minHeight), &corner1);
+        Terrain::convertTerrainToWorldAxes(mData.alignment,
+            Vector3(halfWorldSize, halfWorldSize, range.maxHeight), &corner2);
+        mWorldAABB.merge(mData.position + corner1);
+        mWorldAABB.merge(mData.position + corner2);
+    }
+    //---------------------------------------------------------------------
+    float TerrainHeightSnapshot::getHeightAtWorldPosition(const Vector3& pos) const
+    {
+        // same mapping as Terrain::getTerrainPosition
+        Vector3 terrainPos;
+        Terrain::convertWorldToTerrainAxes(mData.alignment, pos - mData.position, &terrainPos);
+        Real x = terrainPos.x / mData.worldSize + 0.5f;
+        Real y = terrainPos.y / mData.worldSize + 0.5f;
+
+        Real factor = (Real)mData.size - 1.0f;
+        long startX = static_cast<long>(x * factor);
+        long startY = static_cast<long>(y * factor);
+
+        // corners in the same order as Terrain::getHeightAtTerrainPosition
+        float cornerHeights[4] = {
+            getHeightAtPoint(startX, startY),
+            getHeightAtPoint(startX + 1, startY),
+            getHeightAtPoint(startX + 1, startY + 1),
+            getHeightAtPoint(startX, startY + 1) };
+        return Terrain::interpolateQuadHeight(mData.size, x, y, startX, startY, cornerHeights);
+    }
+    //---------------------------------------------------------------------
+    float TerrainHeightSnapshot::getHeightAtPoint(long x, long y) const
+    {
+        const long lastPoint = mData.size - 1;
+        x = Math::Clamp(x, 0L, lastPoint);
+        y = Math::Clamp(y, 0L, lastPoint);
+        return mData.getHeight(x, y);
+    }
+    //---------------------------------------------------------------------
+    std::pair<bool, Vector3> TerrainHeightSnapshot::rayIntersects(const Ray& ray) const
+    {
+        return Terrain::rayIntersectsHeights(mData, ray);
+    }
 }
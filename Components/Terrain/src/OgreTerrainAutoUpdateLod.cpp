@@ -75,7 +75,11 @@ namespace Ogre
 
         int maxLod = traverseTreeByDistance(terrain->getQuadTree(), cam, cFactor, holdDistance);
         if (maxLod >= 0)
+        {
+            // stream the nearest terrains first
+            terrain->setLodStreamingPriority(terrain->getWorldAABB().distance(cam->getDerivedPosition()));
             terrain->load(maxLod,synchronous);
+        }
     }
 
     int TerrainAutoUpdateLodByDistance::traverseTreeByDistance(TerrainQuadTreeNode *node,
@@ -31,11 +31,17 @@ THE SOFTWARE.
 #include "OgreStreamSerialiser.h"
 #include "OgreLogManager.h"
 #include "OgreTerrainAutoUpdateLod.h"
+#include "Threading/OgreParallel.h"
 #include <iomanip>
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
+#include "macUtils.h"
+#endif
+
 namespace Ogre
 {
     const uint16 TerrainGroup::WORKQUEUE_LOAD_REQUEST = 1;
+    const uint16 TerrainGroup::WORKQUEUE_SAVE_REQUEST = 2;
     const uint32 TerrainGroup::CHUNK_ID = StreamSerialiser::makeIdentifier("TERG");
     const uint16 TerrainGroup::CHUNK_VERSION = 1;
     uint TerrainGroup::LoadRequest::loadingTaskNum = 0;
@@ -65,6 +71,7 @@ namespace Ogre
         wq->addRequestHandler(mWorkQueueChannel, this);
         wq->addResponseHandler(mWorkQueueChannel, this);
 
+        publishHeightSnapshot();
     }
     //---------------------------------------------------------------------
     TerrainGroup::TerrainGroup(SceneManager* sm)
@@ -89,6 +96,8 @@ namespace Ogre
         mWorkQueueChannel = wq->getChannel("Ogre/TerrainGroup");
         wq->addRequestHandler(mWorkQueueChannel, this);
         wq->addResponseHandler(mWorkQueueChannel, this);
+
+        publishHeightSnapshot();
     }
     //---------------------------------------------------------------------
     TerrainGroup::~TerrainGroup()
@@ -100,7 +109,7 @@ namespace Ogre
         }
 
         // waiting for terrain preparing finished
-        while(LoadRequest::loadingTaskNum>0)
+        while(LoadRequest::loadingTaskNum>0 || !mSavingSlots.empty())
         {
             OGRE_THREAD_SLEEP(50);
             Root::getSingleton().getWorkQueue()->processResponses();
@@ -127,6 +136,7 @@ namespace Ogre
                     slot->instance->setPosition(getTerrainSlotPosition(slot->x, slot->y));
                 }
             }
+            publishHeightSnapshot();
         }
 
     }
@@ -255,7 +265,7 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
-    void TerrainGroup::saveAllTerrains(bool onlyIfModified, bool replaceFilenames)
+    void TerrainGroup::saveAllTerrains(bool onlyIfModified, bool replaceFilenames, bool synchronous)
     {
         for (TerrainSlotMap::iterator i = mTerrainSlots.begin(); i != mTerrainSlots.end(); ++i)
         {
@@ -276,8 +286,29 @@ namespace Ogre
                     else
                         filename = generateFilename(slot->x, slot->y);
 
-                    t->save(filename);
+                    if (synchronous)
+                    {
+                        t->save(filename);
+                        continue;
+                    }
 
+                    // the previous save of this terrain hasn't been written yet
+                    uint32 key = packIndex(slot->x, slot->y);
+                    if (!mSavingSlots.insert(key).second)
+                        continue;
+
+                    // the terrain may be edited as soon as we return, so it has
+                    // to be serialised here, the rest is left to the workers
+                    SaveRequest req;
+                    req.x = slot->x;
+                    req.y = slot->y;
+                    req.terrain = t;
+                    req.filename = filename;
+                    req.resourceGroup = t->_getDerivedResourceGroup();
+                    req.data = t->saveDeferred();
+                    req.origin = this;
+                    Root::getSingleton().getWorkQueue()->addRequest(
+                        mWorkQueueChannel, WORKQUEUE_SAVE_REQUEST, Any(req));
                 }
             }
             
@@ -301,7 +332,13 @@ namespace Ogre
             (!slot->def.filename.empty() || slot->def.importData))
         {
             // Allocate in main thread so no race conditions
-            slot->instance = OGRE_NEW Terrain(mSceneManager);
+            if (!mTerrainPool.empty())
+            {
+                slot->instance = mTerrainPool.back();
+                mTerrainPool.pop_back();
+            }
+            else
+                slot->instance = OGRE_NEW Terrain(mSceneManager);
             slot->instance->setResourceGroup(mResourceGroup);
             // Use shared pool of buffers
             slot->instance->setGpuBufferAllocator(&mBufferAllocator);
@@ -370,7 +407,8 @@ namespace Ogre
         TerrainSlot* slot = getTerrainSlot(x, y, false);
         if (slot)
         {
-            slot->freeInstance();
+            freeTerrainInstance(slot);
+            publishHeightSnapshot();
         }
 
 
@@ -382,8 +420,10 @@ namespace Ogre
         TerrainSlotMap::iterator i = mTerrainSlots.find(key);
         if (i != mTerrainSlots.end())
         {
+            freeTerrainInstance(i->second);
             OGRE_DELETE i->second;
             mTerrainSlots.erase(i);
+            publishHeightSnapshot();
         }
 
     }
@@ -395,10 +435,35 @@ namespace Ogre
             OGRE_DELETE i->second;
         }
         mTerrainSlots.clear();
-        // Also clear buffer pools, if we're clearing completely may not be representative
+        publishHeightSnapshot();
+        // Also clear pools, if we're clearing completely may not be representative
+        clearTerrainPool();
         mBufferAllocator.freeAllBuffers();
     }
     //---------------------------------------------------------------------
+    void TerrainGroup::clearTerrainPool()
+    {
+        for (TerrainList::iterator i = mTerrainPool.begin(); i != mTerrainPool.end(); ++i)
+        {
+            OGRE_DELETE *i;
+        }
+        mTerrainPool.clear();
+    }
+    //---------------------------------------------------------------------
+    void TerrainGroup::freeTerrainInstance(TerrainSlot* slot)
+    {
+        if (slot->instance &&
+            mTerrainPool.size() < TerrainGlobalOptions::getSingleton().getTerrainPoolSize() &&
+            slot->instance->_resetForReuse())
+        {
+            // the vertex buffers have gone back to mBufferAllocator
+            mTerrainPool.push_back(slot->instance);
+            slot->instance = 0;
+        }
+        else
+            slot->freeInstance();
+    }
+    //---------------------------------------------------------------------
     TerrainGroup::TerrainSlotDefinition* TerrainGroup::getTerrainDefinition(long x, long y) const
     {
         TerrainSlot* slot = getTerrainSlot(x, y);
@@ -580,6 +645,79 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    class TerrainGroup::QueryJob : public ParallelJob
+    {
+    public:
+        QueryJob(const TerrainGroup* group, const Ray* rays, RayResult* rayResults, Real distanceLimit,
+            const Vector3* positions, float* heights, size_t count)
+            : ParallelJob(count, 64), mGroup(group), mRays(rays), mRayResults(rayResults)
+            , mDistanceLimit(distanceLimit), mPositions(positions), mHeights(heights) {}
+
+        void execute(size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (mRays)
+                {
+                    mRayResults[i] = mGroup->rayIntersects(mRays[i], mDistanceLimit);
+                }
+                else
+                {
+                    long x, y;
+                    mGroup->convertWorldPositionToTerrainSlot(mPositions[i], &x, &y);
+                    TerrainSlot* slot = mGroup->getTerrainSlot(x, y);
+                    if (slot && slot->instance && slot->instance->isLoaded())
+                        mHeights[i] = slot->instance->getHeightAtWorldPosition(mPositions[i]);
+                    else
+                        mHeights[i] = 0;
+                }
+            }
+        }
+
+    private:
+        const TerrainGroup* mGroup;
+        const Ray* mRays;
+        RayResult* mRayResults;
+        Real mDistanceLimit;
+        const Vector3* mPositions;
+        float* mHeights;
+    };
+    //---------------------------------------------------------------------
+    void TerrainGroup::rayIntersects(const Ray* rays, size_t count, RayResult* results, 
+        Real distanceLimit /* = 0 */) const
+    {
+        if (count)
+            ParallelJob::run(ParallelJobPtr(OGRE_NEW QueryJob(this, rays, results, distanceLimit, 0, 0, count)));
+    }
+    //---------------------------------------------------------------------
+    void TerrainGroup::getHeightsAtWorldPositions(const Vector3* positions, size_t count, float* heights) const
+    {
+        if (count)
+            ParallelJob::run(ParallelJobPtr(OGRE_NEW QueryJob(this, 0, 0, 0, positions, heights, count)));
+    }
+    //---------------------------------------------------------------------
+    TerrainGroupHeightSnapshotPtr TerrainGroup::getHeightSnapshot() const
+    {
+        OGRE_WQ_LOCK_MUTEX(mHeightSnapshotMutex);
+        return mHeightSnapshot;
+    }
+    //---------------------------------------------------------------------
+    void TerrainGroup::publishHeightSnapshot()
+    {
+        TerrainGroupHeightSnapshot* snapshot = 
+            OGRE_NEW TerrainGroupHeightSnapshot(mAlignment, mTerrainWorldSize, mOrigin);
+        for (TerrainSlotMap::iterator i = mTerrainSlots.begin(); i != mTerrainSlots.end(); ++i)
+        {
+            TerrainSlot* slot = i->second;
+            // a terrain still being prepared in the background isn't published yet
+            if (slot->instance && slot->instance->isLoaded())
+                snapshot->addTerrain(slot->x, slot->y, slot->instance->getHeightSnapshot());
+        }
+        TerrainGroupHeightSnapshotPtr published(snapshot);
+        OGRE_WQ_LOCK_MUTEX(mHeightSnapshotMutex);
+        std::swap(mHeightSnapshot, published);
+    }
+    //---------------------------------------------------------------------
     void TerrainGroup::boxIntersects(const AxisAlignedBox& box, TerrainList* resultList) const
     {
         resultList->clear();
@@ -643,9 +781,11 @@ namespace Ogre
     //---------------------------------------------------------------------
     bool TerrainGroup::canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
     {
-        LoadRequest lreq = any_cast<LoadRequest>(req->getData());
+        TerrainGroup* origin = req->getType() == WORKQUEUE_SAVE_REQUEST ?
+            any_cast<SaveRequest>(req->getData()).origin :
+            any_cast<LoadRequest>(req->getData()).origin;
         // only deal with own requests
-        if (lreq.origin != this)
+        if (origin != this)
             return false;
         else
             return RequestHandler::canHandleRequest(req, srcQ);
@@ -654,6 +794,9 @@ namespace Ogre
     //---------------------------------------------------------------------
     WorkQueue::Response* TerrainGroup::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
     {
+        if (req->getType() == WORKQUEUE_SAVE_REQUEST)
+            return handleSaveRequest(req);
+
         LoadRequest lreq = any_cast<LoadRequest>(req->getData());
 
         TerrainSlotDefinition& def = lreq.slot->def;
@@ -687,9 +830,12 @@ namespace Ogre
     //---------------------------------------------------------------------
     bool TerrainGroup::canHandleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
     {
-        LoadRequest lreq = any_cast<LoadRequest>(res->getRequest()->getData());
+        const WorkQueue::Request* req = res->getRequest();
+        TerrainGroup* origin = req->getType() == WORKQUEUE_SAVE_REQUEST ?
+            any_cast<SaveRequest>(req->getData()).origin :
+            any_cast<LoadRequest>(req->getData()).origin;
         // only deal with own requests
-        if (lreq.origin != this)
+        if (origin != this)
             return false;
         else
             return true;
@@ -698,6 +844,12 @@ namespace Ogre
     //---------------------------------------------------------------------
     void TerrainGroup::handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
     {
+        if (res->getRequest()->getType() == WORKQUEUE_SAVE_REQUEST)
+        {
+            handleSaveResponse(res);
+            return;
+        }
+
         // No response data, just request
         LoadRequest lreq = any_cast<LoadRequest>(res->getRequest()->getData());
         --LoadRequest::loadingTaskNum;
@@ -728,6 +880,8 @@ namespace Ogre
                     }
 
                 }
+
+                publishHeightSnapshot();
             }
         }
         else
@@ -741,6 +895,55 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    WorkQueue::Response* TerrainGroup::handleSaveRequest(const WorkQueue::Request* req)
+    {
+        SaveRequest sreq = any_cast<SaveRequest>(req->getData());
+        String path =
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
+            iOSDocumentsDirectory() + "/" +
+#endif
+            sreq.filename;
+        String tempPath = path + ".tmp";
+
+        WorkQueue::Response* response = 0;
+        try
+        {
+            {
+                DataStreamPtr stream = Root::createFileStream(tempPath, sreq.resourceGroup, true);
+                sreq.data->writeDeferred(stream);
+                stream->close();
+            }
+            Root::replaceFile(tempPath, path, sreq.resourceGroup);
+            response = OGRE_NEW WorkQueue::Response(req, true, Any());
+        }
+        catch (Exception& e)
+        {
+            response = OGRE_NEW WorkQueue::Response(req, false, Any(), 
+                e.getFullDescription());
+        }
+        OGRE_DELETE sreq.data;
+
+        return response;
+    }
+    //---------------------------------------------------------------------
+    void TerrainGroup::handleSaveResponse(const WorkQueue::Response* res)
+    {
+        SaveRequest sreq = any_cast<SaveRequest>(res->getRequest()->getData());
+        mSavingSlots.erase(packIndex(sreq.x, sreq.y));
+
+        if (!res->succeeded())
+        {
+            LogManager::getSingleton().stream(LML_CRITICAL) <<
+                "We failed to save the terrain at (" << sreq.x << ", " <<
+                sreq.y <<") with the error '" << res->getMessages() << "'";
+        }
+
+        // the terrain may have been removed in the meantime
+        TerrainSlot* slot = getTerrainSlot(sreq.x, sreq.y);
+        if (slot && slot->instance == sreq.terrain)
+            sreq.terrain->_notifySaved(sreq.filename, res->succeeded());
+    }
+    //---------------------------------------------------------------------
     void TerrainGroup::connectNeighbour(TerrainSlot* slot, long offsetx, long offsety)
     {
         TerrainSlot* neighbourSlot = getTerrainSlot(slot->x + offsetx, slot->y + offsety);
@@ -842,6 +1045,7 @@ namespace Ogre
             if (i->second->instance)
                 i->second->instance->update();
         }
+        publishHeightSnapshot();
 
     }
     //---------------------------------------------------------------------
@@ -852,6 +1056,7 @@ namespace Ogre
             if (i->second->instance)
                 i->second->instance->updateGeometry();
         }
+        publishHeightSnapshot();
 
     }
     //---------------------------------------------------------------------
@@ -955,7 +1160,7 @@ namespace Ogre
 
         ser.readChunkEnd(CHUNK_ID);
 
-
+        publishHeightSnapshot();
     }
     //---------------------------------------------------------------------
     void TerrainGroup::setTerrainWorldSize(Real newWorldSize)
@@ -971,6 +1176,7 @@ namespace Ogre
                     i->second->instance->setPosition(getTerrainSlotPosition(i->second->x, i->second->y));
                 }
             }
+            publishHeightSnapshot();
         }
     }
     //---------------------------------------------------------------------
@@ -986,6 +1192,7 @@ namespace Ogre
                     i->second->instance->setSize(newTerrainSize);
                 }
             }
+            publishHeightSnapshot();
         }
     }
     //---------------------------------------------------------------------
@@ -1028,5 +1235,71 @@ namespace Ogre
         instance = 0;
     }
 
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    TerrainGroupHeightSnapshot::TerrainGroupHeightSnapshot(Terrain::Alignment align, 
+        Real terrainWorldSize, const Vector3& origin)
+        : mAlignment(align)
+        , mTerrainWorldSize(terrainWorldSize)
+        , mOrigin(origin)
+    {
+    }
+    //---------------------------------------------------------------------
+    void TerrainGroupHeightSnapshot::addTerrain(long x, long y, const TerrainHeightSnapshotPtr& terrain)
+    {
+        if (terrain)
+            mTerrains[std::make_pair(x, y)] = terrain;
+    }
+    //---------------------------------------------------------------------
+    TerrainHeightSnapshotPtr TerrainGroupHeightSnapshot::getTerrain(long x, long y) const
+    {
+        TerrainMap::const_iterator i = mTerrains.find(std::make_pair(x, y));
+        return i != mTerrains.end() ? i->second : TerrainHeightSnapshotPtr();
+    }
+    //---------------------------------------------------------------------
+    float TerrainGroupHeightSnapshot::getHeightAtWorldPosition(const Vector3& pos) const
+    {
+        if (mTerrains.empty())
+            return 0;
+
+        // same as TerrainGroup::convertWorldPositionToTerrainSlot
+        Vector3 terrainPos;
+        Terrain::convertWorldToTerrainAxes(mAlignment, pos - mOrigin, &terrainPos);
+        Real offset = mTerrainWorldSize * 0.5f;
+        long x = static_cast<long>(floor((terrainPos.x + offset) / mTerrainWorldSize));
+        long y = static_cast<long>(floor((terrainPos.y + offset) / mTerrainWorldSize));
+
+        TerrainHeightSnapshotPtr terrain = getTerrain(x, y);
+        return terrain ? terrain->getHeightAtWorldPosition(pos) : 0;
+    }
+    //---------------------------------------------------------------------
+    std::pair<bool, Vector3> TerrainGroupHeightSnapshot::rayIntersects(const Ray& ray, 
+        Real distanceLimit /* = 0 */) const
+    {
+        // the terrains don't overlap, so testing them in the order the ray
+        // enters their bounds means the first hit is the nearest
+        typedef std::pair<Real, const TerrainHeightSnapshot*> Candidate;
+        vector<Candidate>::type candidates;
+        for (TerrainMap::const_iterator i = mTerrains.begin(); i != mTerrains.end(); ++i)
+        {
+            std::pair<bool, Real> boxHit = Math::intersects(ray, i->second->getWorldAABB());
+            if (boxHit.first && (distanceLimit == 0 || boxHit.second <= distanceLimit))
+                candidates.push_back(Candidate(boxHit.second, i->second.get()));
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (size_t i = 0; i < candidates.size(); ++i)
+        {
+            std::pair<bool, Vector3> result = candidates[i].second->rayIntersects(ray);
+            if (result.first)
+            {
+                if (distanceLimit != 0 && 
+                    (result.second - ray.getOrigin()).length() > distanceLimit)
+                    break;
+                return result;
+            }
+        }
+        return std::pair<bool, Vector3>(false, Vector3::ZERO);
+    }
 }
 
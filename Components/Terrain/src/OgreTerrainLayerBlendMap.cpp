@@ -174,39 +174,81 @@ namespace Ogre
     {
         if (mData && mDirty)
         {
-            // Upload data
-            float* pSrcBase = mData + mDirtyBox.top * mBuffer->getWidth() + mDirtyBox.left;
-            uint8* pDstBase = static_cast<uint8*>(mBuffer->lock(mDirtyBox, HardwarePixelBuffer::HBL_NORMAL).data);
-            pDstBase += mChannelOffset;
-            size_t dstInc = PixelUtil::getNumElemBytes(mBuffer->getFormat());
-            for (size_t y = 0; y < mDirtyBox.getHeight(); ++y)
+            // All the layers packed into the same texture are uploaded together,
+            // so gather them and merge their dirty regions
+            uint8 texIndex = mParent->getLayerBlendTextureIndex(mLayerIdx).first;
+            uint8 firstLayer = texIndex * 4 + 1;
+            uint8 endLayer = std::min(static_cast<uint8>(firstLayer + 4), mParent->getLayerCount());
+            TerrainLayerBlendMap* maps[4];
+            size_t numMaps = 0;
+            Box box = mDirtyBox;
+            for (uint8 l = firstLayer; l < endLayer; ++l)
             {
-                float* pSrc = pSrcBase + y * mBuffer->getWidth();
-                uint8* pDst = pDstBase + y * mBuffer->getWidth() * dstInc;
-                for (size_t x = 0; x < mDirtyBox.getWidth(); ++x)
+                TerrainLayerBlendMap* map = (l == mLayerIdx) ? this : mParent->getLayerBlendMap(l);
+                if (map->mDirty && map != this)
                 {
-                    *pDst = static_cast<uint8>(*pSrc++ * 255);
-                    pDst += dstInc;
+                    box.left = std::min(box.left, map->mDirtyBox.left);
+                    box.top = std::min(box.top, map->mDirtyBox.top);
+                    box.right = std::max(box.right, map->mDirtyBox.right);
+                    box.bottom = std::max(box.bottom, map->mDirtyBox.bottom);
                 }
+                maps[numMaps++] = map;
             }
-            mBuffer->unlock();
 
-            mDirty = false;
+            upload(maps, numMaps, box);
+
+            for (size_t i = 0; i < numMaps; ++i)
+                maps[i]->mDirty = false;
 
             // make sure composite map is updated
-            // mDirtyBox is in image space, convert to terrain units
+            // box is in image space, convert to terrain units
             Rect compositeMapRect;
             float blendToTerrain = (float)mParent->getSize() / (float)mBuffer->getWidth();
-            compositeMapRect.left = (long)(mDirtyBox.left * blendToTerrain);
-            compositeMapRect.right = (long)(mDirtyBox.right * blendToTerrain + 1);
-            compositeMapRect.top = (long)((mBuffer->getHeight() - mDirtyBox.bottom) * blendToTerrain);
-            compositeMapRect.bottom = (long)((mBuffer->getHeight() - mDirtyBox.top) * blendToTerrain + 1);
+            compositeMapRect.left = (long)(box.left * blendToTerrain);
+            compositeMapRect.right = (long)(box.right * blendToTerrain + 1);
+            compositeMapRect.top = (long)((mBuffer->getHeight() - box.bottom) * blendToTerrain);
+            compositeMapRect.bottom = (long)((mBuffer->getHeight() - box.top) * blendToTerrain + 1);
             mParent->_dirtyCompositeMapRect(compositeMapRect);
             mParent->updateCompositeMapWithDelay();
 
         }
     }
     //---------------------------------------------------------------------
+    void TerrainLayerBlendMap::upload(TerrainLayerBlendMap** maps, size_t numMaps, const Box& box)
+    {
+        // Pack the region of every channel into a staging area in the texture's
+        // own format, then write only that region; the texture is never locked,
+        // so there is no read back of what is already on the GPU
+        PixelFormat fmt = mBuffer->getFormat();
+        size_t pixelSize = PixelUtil::getNumElemBytes(fmt);
+        size_t width = box.getWidth();
+        size_t height = box.getHeight();
+        size_t stagingSize = width * height * pixelSize;
+        uint8* pStaging = static_cast<uint8*>(OGRE_MALLOC(stagingSize, MEMCATEGORY_GENERAL));
+        // channels without a layer stay empty
+        memset(pStaging, 0, stagingSize);
+
+        for (size_t i = 0; i < numMaps; ++i)
+        {
+            const TerrainLayerBlendMap* map = maps[i];
+            uint8* pDst = pStaging + map->mChannelOffset;
+            for (size_t y = box.top; y < box.bottom; ++y)
+            {
+                const float* pSrc = map->mData + y * mBuffer->getWidth() + box.left;
+                for (size_t x = 0; x < width; ++x)
+                {
+                    *pDst = static_cast<uint8>(*pSrc++ * 255);
+                    pDst += pixelSize;
+                }
+            }
+        }
+
+        PixelBox src(width, height, 1, fmt, pStaging);
+        mBuffer->blitFromMemory(src, box);
+
+        OGRE_FREE(pStaging, MEMCATEGORY_GENERAL);
+    }
+    //---------------------------------------------------------------------
     void TerrainLayerBlendMap::blit(const PixelBox &src, const Box &dstBox)
     {
         const PixelBox* srcBox = &src;
@@ -36,7 +36,10 @@ namespace Ogre
 {
     const uint16 TerrainLodManager::WORKQUEUE_LOAD_LOD_DATA_REQUEST = 1;
     const uint32 TerrainLodManager::TERRAINLODDATA_CHUNK_ID = StreamSerialiser::makeIdentifier("TLDA");
-    const uint16 TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION = 1;
+    const uint16 TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION = 2;
+    const size_t TerrainLodManager::QUANTISED_LOD_DATA_BLOCK_SIZE = 256;
+    TerrainLodManager::ManagerList TerrainLodManager::msPendingRequests;
+    uint32 TerrainLodManager::msRequestsInFlight = 0;
 
     TerrainLodManager::TerrainLodManager(Terrain* t, DataStreamPtr& stream)
         : mTerrain(t)
@@ -75,6 +78,8 @@ namespace Ogre
         mHighestLodLoaded = -1;
         mTargetLodLevel = -1;
         mIncreaseLodLevelInProgress = false;
+        mLoadRequestID = 0;
+        mRequestPending = false;
         mLastRequestSynchronous = false;
         mLodInfoTable = 0;
 
@@ -86,6 +91,7 @@ namespace Ogre
 
     TerrainLodManager::~TerrainLodManager()
     {
+        cancelPendingRequest();
         waitForDerivedProcesses();
         WorkQueue* wq = Root::getSingleton().getWorkQueue();
         wq->removeRequestHandler(mWorkQueueChannel, this);
@@ -120,7 +126,10 @@ namespace Ogre
             return OGRE_NEW WorkQueue::Response(req, false, Any(), e.getFullDescription());
         }
 
+        // the band of the tree already loaded has its vertex data
         int lastTreeStart = -1;
+        if (lreq.currentLoadedLod < mTerrain->getNumLodLevels())
+            lastTreeStart = getLodInfo(lreq.currentLoadedLod).treeStart;
         for( int level=lreq.currentLoadedLod-1; level>=lreq.requestedLod; --level )
         {
             LodInfo& lodinfo = getLodInfo(level);
@@ -142,6 +151,8 @@ namespace Ogre
         LoadLodRequest lreq = any_cast<LoadLodRequest>(req->getData());
 
         mIncreaseLodLevelInProgress = false;
+        if (!lreq.synchronous)
+            --msRequestsInFlight;
 
         if (res->succeeded())
         {
@@ -180,6 +191,9 @@ namespace Ogre
         {
             LogManager::getSingleton().stream(LML_CRITICAL) << "Failed to prepare and load terrain LOD: " << res->getMessages();
         }
+
+        // a slot is free for whoever is nearest
+        dispatchPendingRequests();
     }
     void TerrainLodManager::buildLodInfoTable()
     {
@@ -239,7 +253,7 @@ namespace Ogre
     }
 
     // data are reorganized from lowest lod level(mNumLodLevels-1) to highest(0)
-    void TerrainLodManager::separateData(float* data, uint16 size, uint16 numLodLevels, LodsData& lods)
+    void TerrainLodManager::separateData(const float* data, uint16 size, uint16 numLodLevels, LodsData& lods)
     {
         lods.resize(numLodLevels);
         for (int level = numLodLevels - 1; level >= 0; level--)
@@ -276,20 +290,35 @@ namespace Ogre
         // need loading
         if(mTargetLodLevel<mHighestLodLoaded)
         {
+            // the new levels are filled in from the background
+            mTerrain->decompressHeightData();
+
             // no task is running
             if (!mIncreaseLodLevelInProgress)
             {
-                mIncreaseLodLevelInProgress = true;
-                LoadLodRequest req(this,mHighestLodPrepared,mHighestLodLoaded,mTargetLodLevel);
-                Root::getSingleton().getWorkQueue()->addRequest(
-                    mWorkQueueChannel, WORKQUEUE_LOAD_LOD_DATA_REQUEST,
-                    Any(req), 0, synchronous);
+                if (synchronous)
+                {
+                    // the caller is waiting, don't queue behind anyone
+                    cancelPendingRequest();
+                    issueLoadRequest(true);
+                }
+                else if (!mRequestPending)
+                {
+                    mRequestPending = true;
+                    msPendingRequests.push_back(this);
+                    dispatchPendingRequests();
+                }
             }
             else if(synchronous)
                 waitForDerivedProcesses();
+            return;
         }
+
+        // the camera moved away before our turn came, nothing to read any more
+        cancelPendingRequest();
+
         // need unloading
-        else if(mTargetLodLevel>mHighestLodLoaded)
+        if(mTargetLodLevel>mHighestLodLoaded)
         {
             for( int level=mHighestLodLoaded; level<mTargetLodLevel; level++ )
             {
@@ -303,24 +332,120 @@ namespace Ogre
         }
     }
 
+    //---------------------------------------------------------------------
+    void TerrainLodManager::issueLoadRequest(bool synchronous)
+    {
+        mIncreaseLodLevelInProgress = true;
+        // stream one level at a time, coarsest first, so that other terrains
+        // get a turn in between and the new detail shows up progressively
+        uint16 requestedLod = static_cast<uint16>(synchronous ? mTargetLodLevel : mHighestLodLoaded - 1);
+        LoadLodRequest req(this,mHighestLodPrepared,mHighestLodLoaded,requestedLod);
+        req.synchronous = synchronous;
+        if (!synchronous)
+            ++msRequestsInFlight;
+        mLoadRequestID = Root::getSingleton().getWorkQueue()->addRequest(
+            mWorkQueueChannel, WORKQUEUE_LOAD_LOD_DATA_REQUEST,
+            Any(req), 0, synchronous);
+    }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::cancelPendingRequest()
+    {
+        if (mRequestPending)
+        {
+            msPendingRequests.remove(this);
+            mRequestPending = false;
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::dispatchPendingRequests()
+    {
+        uint32 maxRequests = TerrainGlobalOptions::getSingleton().getMaxConcurrentLodRequests();
+        while (!msPendingRequests.empty() && (!maxRequests || msRequestsInFlight < maxRequests))
+        {
+            ManagerList::iterator next = msPendingRequests.begin();
+            for (ManagerList::iterator i = next; i != msPendingRequests.end(); ++i)
+            {
+                if ((*i)->mTerrain->getLodStreamingPriority() < (*next)->mTerrain->getLodStreamingPriority())
+                    next = i;
+            }
+            TerrainLodManager* mgr = *next;
+            msPendingRequests.erase(next);
+            mgr->mRequestPending = false;
+            mgr->issueLoadRequest(false);
+        }
+    }
+    //---------------------------------------------------------------------
     // save each LOD level separately compressed so seek is possible
     void TerrainLodManager::saveLodData(StreamSerialiser& stream, Terrain* terrain)
     {
         uint16 numLodLevels = terrain->getNumLodLevels();
+        uint16 size = terrain->getSize();
+
+        const float* heightData = terrain->mHeightData;
+        const float* deltaData = terrain->mDeltaData;
+        LodData unpacked;
+        if (terrain->isHeightDataCompressed())
+        {
+            // don't keep the data unpacked just for saving
+            unpacked.resize(2 * size * size);
+            terrain->mCompressedHeightData->decompress(&unpacked[0], &unpacked[size * size]);
+            heightData = &unpacked[0];
+            deltaData = &unpacked[size * size];
+        }
 
         LodsData lods;
-        separateData(terrain->mHeightData, terrain->getSize(), numLodLevels, lods);
-        separateData(terrain->mDeltaData, terrain->getSize(), numLodLevels, lods);
+        separateData(heightData, size, numLodLevels, lods);
+        separateData(deltaData, size, numLodLevels, lods);
 
+        uint8 encoding = TerrainGlobalOptions::getSingleton().getCompressHeightData() ?
+            LOD_DATA_QUANTISED : LOD_DATA_FLOAT;
         for (int level = numLodLevels - 1; level >=0; level--)
         {
             stream.writeChunkBegin(TERRAINLODDATA_CHUNK_ID, TERRAINLODDATA_CHUNK_VERSION);
             stream.startDeflate();
-            stream.write(&(lods[level][0]), lods[level].size());
+            stream.write(&encoding);
+            const LodData& lod = lods[level];
+            if (encoding == LOD_DATA_QUANTISED)
+            {
+                // first half is height data, second half delta data
+                writeQuantised(stream, &lod[0], lod.size() / 2);
+                writeQuantised(stream, &lod[lod.size() / 2], lod.size() / 2);
+            }
+            else
+                stream.write(&lod[0], lod.size());
             stream.stopDeflate();
             stream.writeChunkEnd(TERRAINLODDATA_CHUNK_ID);
         }
     }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::writeQuantised(StreamSerialiser& stream, const float* data, size_t count)
+    {
+        uint16 quantised[QUANTISED_LOD_DATA_BLOCK_SIZE];
+        for (size_t start = 0; start < count; start += QUANTISED_LOD_DATA_BLOCK_SIZE)
+        {
+            size_t blockSize = std::min(QUANTISED_LOD_DATA_BLOCK_SIZE, count - start);
+            Terrain::QuantisedRange range = 
+                Terrain::quantise(data + start, blockSize, quantised, blockSize, blockSize, 1);
+            stream.write(&range.offset);
+            stream.write(&range.scale);
+            stream.write(quantised, blockSize);
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::readQuantised(StreamSerialiser& stream, float* data, size_t count)
+    {
+        uint16 quantised[QUANTISED_LOD_DATA_BLOCK_SIZE];
+        for (size_t start = 0; start < count; start += QUANTISED_LOD_DATA_BLOCK_SIZE)
+        {
+            size_t blockSize = std::min(QUANTISED_LOD_DATA_BLOCK_SIZE, count - start);
+            Terrain::QuantisedRange range;
+            stream.read(&range.offset);
+            stream.read(&range.scale);
+            stream.read(quantised, blockSize);
+            for (size_t i = 0; i < blockSize; ++i)
+                data[start + i] = range.decode(quantised[i]);
+        }
+    }
 
     void TerrainLodManager::readLodData(uint16 lowerLodBound, uint16 higherLodBound)
     {
@@ -359,7 +484,16 @@ namespace Ogre
                 const StreamSerialiser::Chunk *c = stream.readChunkBegin(TERRAINLODDATA_CHUNK_ID,
                         TERRAINLODDATA_CHUNK_VERSION);
                 stream.startDeflate(c->length);
-                stream.read(lodData, dataSize);
+                uint8 encoding = LOD_DATA_FLOAT;
+                if (c->version > 1)
+                    stream.read(&encoding);
+                if (encoding == LOD_DATA_QUANTISED)
+                {
+                    readQuantised(stream, lodData, dataSize / 2);
+                    readQuantised(stream, lodData + dataSize / 2, dataSize / 2);
+                }
+                else
+                    stream.read(lodData, dataSize);
                 stream.stopDeflate();
                 stream.readChunkEnd(TERRAINLODDATA_CHUNK_ID);
 
@@ -399,6 +533,9 @@ namespace Ogre
     }
     void TerrainLodManager::waitForDerivedProcesses()
     {
+        if (mIncreaseLodLevelInProgress)
+            Root::getSingleton().getWorkQueue()->promoteRequest(mLoadRequestID);
+
         while (mIncreaseLodLevelInProgress)
         {
             // we need to wait for this to finish
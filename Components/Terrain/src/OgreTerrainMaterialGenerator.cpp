@@ -38,6 +38,13 @@ THE SOFTWARE.
 #include "OgreRenderTarget.h"
 #include "OgreRenderTexture.h"
 #include "OgreSceneNode.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreGpuProgramManager.h"
+#include "OgreRenderSystemCapabilities.h"
 
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
 // we do lots of conversions here, casting them all is tedious & cluttered, we know what we're doing
@@ -58,6 +65,8 @@ namespace Ogre
         , mCompositeMapPlane(0)
         , mCompositeMapLight(0)
     {
+        for (int i = 0; i < DM_COUNT; ++i)
+            mDerivedMapRTT[i] = 0;
 
     }
     //---------------------------------------------------------------------
@@ -71,6 +80,14 @@ namespace Ogre
             TextureManager::getSingleton().remove(mCompositeMapRTT->getHandle());
             mCompositeMapRTT = 0;
         }
+        for (int i = 0; i < DM_COUNT; ++i)
+        {
+            if (mDerivedMapRTT[i] && TextureManager::getSingletonPtr())
+            {
+                TextureManager::getSingleton().remove(mDerivedMapRTT[i]->getHandle());
+                mDerivedMapRTT[i] = 0;
+            }
+        }
         if (mCompositeMapSM && Root::getSingletonPtr())
         {
             // will also delete cam and objects etc
@@ -82,48 +99,78 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    void TerrainMaterialGenerator::createCompositeMapScene(size_t size, const MaterialPtr& mat)
+    {
+        if (mCompositeMapSM)
+            return;
+
+        // dedicated SceneManager
+        mCompositeMapSM = Root::getSingleton().createSceneManager(DefaultSceneManagerFactory::FACTORY_TYPE_NAME);
+        float camDist = 100;
+        float halfCamDist = camDist * 0.5f;
+        mCompositeMapCam = mCompositeMapSM->createCamera("cam");
+        mCompositeMapCam->setPosition(Vector3(0, 0, camDist));
+        mCompositeMapCam->lookAt(Vector3::ZERO);
+        mCompositeMapCam->setProjectionType(PT_ORTHOGRAPHIC);
+        mCompositeMapCam->setNearClipDistance(10);
+        mCompositeMapCam->setFarClipDistance(500);
+        mCompositeMapCam->setOrthoWindow(camDist, camDist);
+
+        // Just in case material relies on light auto params
+        mCompositeMapLight = mCompositeMapSM->createLight();
+        mCompositeMapLight->setType(Light::LT_DIRECTIONAL);
+
+        RenderSystem* rSys = Root::getSingleton().getRenderSystem();
+        Real hOffset = rSys->getHorizontalTexelOffset() / (Real)size;
+        Real vOffset = rSys->getVerticalTexelOffset() / (Real)size;
+
+
+        // set up scene
+        mCompositeMapPlane = mCompositeMapSM->createManualObject();
+        mCompositeMapPlane->begin(mat->getName(), RenderOperation::OT_TRIANGLE_LIST, mat->getGroup());
+        mCompositeMapPlane->position(-halfCamDist, halfCamDist, 0);
+        mCompositeMapPlane->textureCoord(0 - hOffset, 0 - vOffset);
+        mCompositeMapPlane->position(-halfCamDist, -halfCamDist, 0);
+        mCompositeMapPlane->textureCoord(0 - hOffset, 1 - vOffset);
+        mCompositeMapPlane->position(halfCamDist, -halfCamDist, 0);
+        mCompositeMapPlane->textureCoord(1 - hOffset, 1 - vOffset);
+        mCompositeMapPlane->position(halfCamDist, halfCamDist, 0);
+        mCompositeMapPlane->textureCoord(1 - hOffset, 0 - vOffset);
+        mCompositeMapPlane->quad(0, 1, 2, 3);
+        mCompositeMapPlane->end();
+        mCompositeMapSM->getRootSceneNode()->attachObject(mCompositeMapPlane);
+
+    }
+    //---------------------------------------------------------------------
+    void TerrainMaterialGenerator::renderToTexture(Texture* rttTex, const Rect& rect, const TexturePtr& dest)
+    {
+        // calculate the area we need to update
+        Real size = (Real)rttTex->getWidth();
+        Real vpleft = (Real)rect.left / size;
+        Real vptop = (Real)rect.top / size;
+        Real vpright = (Real)rect.right / size;
+        Real vpbottom = (Real)rect.bottom / size;
+
+        RenderTarget* rtt = rttTex->getBuffer()->getRenderTarget();
+        mCompositeMapCam->setWindow(vpleft, vptop, vpright, vpbottom);
+
+        rtt->update();
+
+        // We have an RTT, we want to copy the results into a regular texture
+        // That's because in non-update scenarios we don't want to keep an RTT
+        // around. We use a single RTT to serve all terrain pages which is more
+        // efficient.
+        Box box(static_cast<uint32>(rect.left),
+                       static_cast<uint32>(rect.top),
+                       static_cast<uint32>(rect.right),
+                       static_cast<uint32>(rect.bottom));
+        dest->getBuffer()->blit(rttTex->getBuffer(), box, box);
+    }
+    //---------------------------------------------------------------------
     void TerrainMaterialGenerator::_renderCompositeMap(size_t size, 
         const Rect& rect, const MaterialPtr& mat, const TexturePtr& destCompositeMap)
     {
-        if (!mCompositeMapSM)
-        {
-            // dedicated SceneManager
-            mCompositeMapSM = Root::getSingleton().createSceneManager(DefaultSceneManagerFactory::FACTORY_TYPE_NAME);
-            float camDist = 100;
-            float halfCamDist = camDist * 0.5f;
-            mCompositeMapCam = mCompositeMapSM->createCamera("cam");
-            mCompositeMapCam->setPosition(Vector3(0, 0, camDist));
-            mCompositeMapCam->lookAt(Vector3::ZERO);
-            mCompositeMapCam->setProjectionType(PT_ORTHOGRAPHIC);
-            mCompositeMapCam->setNearClipDistance(10);
-            mCompositeMapCam->setFarClipDistance(500);
-            mCompositeMapCam->setOrthoWindow(camDist, camDist);
-
-            // Just in case material relies on light auto params
-            mCompositeMapLight = mCompositeMapSM->createLight();
-            mCompositeMapLight->setType(Light::LT_DIRECTIONAL);
-
-            RenderSystem* rSys = Root::getSingleton().getRenderSystem();
-            Real hOffset = rSys->getHorizontalTexelOffset() / (Real)size;
-            Real vOffset = rSys->getVerticalTexelOffset() / (Real)size;
-
-
-            // set up scene
-            mCompositeMapPlane = mCompositeMapSM->createManualObject();
-            mCompositeMapPlane->begin(mat->getName());
-            mCompositeMapPlane->position(-halfCamDist, halfCamDist, 0);
-            mCompositeMapPlane->textureCoord(0 - hOffset, 0 - vOffset);
-            mCompositeMapPlane->position(-halfCamDist, -halfCamDist, 0);
-            mCompositeMapPlane->textureCoord(0 - hOffset, 1 - vOffset);
-            mCompositeMapPlane->position(halfCamDist, -halfCamDist, 0);
-            mCompositeMapPlane->textureCoord(1 - hOffset, 1 - vOffset);
-            mCompositeMapPlane->position(halfCamDist, halfCamDist, 0);
-            mCompositeMapPlane->textureCoord(1 - hOffset, 0 - vOffset);
-            mCompositeMapPlane->quad(0, 1, 2, 3);
-            mCompositeMapPlane->end();
-            mCompositeMapSM->getRootSceneNode()->attachObject(mCompositeMapPlane);
-
-        }
+        createCompositeMapScene(size, mat);
 
         // update
         mCompositeMapPlane->setMaterialName(0, mat->getName());
@@ -155,27 +202,7 @@ namespace Ogre
 
         }
 
-        // calculate the area we need to update
-        Real vpleft = (Real)rect.left / (Real)size;
-        Real vptop = (Real)rect.top / (Real)size;
-        Real vpright = (Real)rect.right / (Real)size;
-        Real vpbottom = (Real)rect.bottom / (Real)size;
-
-        RenderTarget* rtt = mCompositeMapRTT->getBuffer()->getRenderTarget();
-        mCompositeMapCam->setWindow(vpleft, vptop, vpright, vpbottom);
-
-        rtt->update();
-
-        // We have an RTT, we want to copy the results into a regular texture
-        // That's because in non-update scenarios we don't want to keep an RTT
-        // around. We use a single RTT to serve all terrain pages which is more
-        // efficient.
-        Box box(static_cast<uint32>(rect.left),
-                       static_cast<uint32>(rect.top),
-                       static_cast<uint32>(rect.right),
-                       static_cast<uint32>(rect.bottom));
-        destCompositeMap->getBuffer()->blit(mCompositeMapRTT->getBuffer(), box, box);
-
+        renderToTexture(mCompositeMapRTT, rect, destCompositeMap);
         
     }
     //---------------------------------------------------------------------
@@ -209,7 +236,345 @@ namespace Ogre
             terrain->getCompositeMap());
 
     }
+    //---------------------------------------------------------------------
+    // Shaders used to render derived maps. Both work on a PF_FLOAT32_R copy of
+    // the heights, whose rows are inverted in Y like the maps themselves.
+    // Heights are read with texelFetch / Load so no filtering is involved.
+    static const char* sDerivedMapVpGLSL =
+        "#version 150\n"
+        "uniform mat4 worldViewProj;\n"
+        "in vec4 vertex;\n"
+        "in vec2 uv0;\n"
+        "out vec2 oUv;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_Position = worldViewProj * vertex;\n"
+        "    oUv = uv0;\n"
+        "}\n";
+    static const char* sDerivedMapVpHLSL =
+        "uniform float4x4 worldViewProj;\n"
+        "void main(float4 pos : POSITION, float2 uv : TEXCOORD0,\n"
+        "    out float4 oPos : SV_POSITION, out float2 oUv : TEXCOORD0)\n"
+        "{\n"
+        "    oPos = mul(worldViewProj, pos);\n"
+        "    oUv = uv;\n"
+        "}\n";
+    // Same 8 triangle fan as Terrain::calculateNormals, built in terrain axes
+    // and rotated into world axes at the end
+    static const char* sNormalMapFpGLSL =
+        "#version 150\n"
+        "uniform sampler2D heightMap;\n"
+        "uniform float heightMapSize;\n"
+        "uniform float spacing;\n"
+        "uniform vec3 axisX;\n"
+        "uniform vec3 axisY;\n"
+        "uniform vec3 axisZ;\n"
+        "in vec2 oUv;\n"
+        "out vec4 fragColour;\n"
+        "float heightAt(ivec2 p)\n"
+        "{\n"
+        "    int last = int(heightMapSize) - 1;\n"
+        "    p = clamp(p, ivec2(0), ivec2(last));\n"
+        "    return texelFetch(heightMap, ivec2(p.x, last - p.y), 0).r;\n"
+        "}\n"
+        "void main()\n"
+        "{\n"
+        "    ivec2 texel = ivec2(floor(oUv * heightMapSize));\n"
+        "    ivec2 c = ivec2(texel.x, int(heightMapSize) - 1 - texel.y);\n"
+        "    const ivec2 offsets[8] = ivec2[8](ivec2(1, 0), ivec2(1, 1), ivec2(0, 1), ivec2(-1, 1),\n"
+        "        ivec2(-1, 0), ivec2(-1, -1), ivec2(0, -1), ivec2(1, -1));\n"
+        "    float centre = heightAt(c);\n"
+        "    vec3 adj[8];\n"
+        "    for (int i = 0; i < 8; ++i)\n"
+        "        adj[i] = vec3(vec2(offsets[i]) * spacing, heightAt(c + offsets[i]) - centre);\n"
+        "    vec3 n = vec3(0.0);\n"
+        "    for (int i = 0; i < 8; ++i)\n"
+        "        n += normalize(cross(adj[i], adj[(i + 1) % 8]));\n"
+        "    n = normalize(n);\n"
+        "    vec3 w = n.x * axisX + n.y * axisY + n.z * axisZ;\n"
+        "    fragColour = vec4(w * 0.5 + 0.5, 1.0);\n"
+        "}\n";
+    static const char* sNormalMapFpHLSL =
+        "Texture2D heightMap : register(t0);\n"
+        "uniform float heightMapSize;\n"
+        "uniform float spacing;\n"
+        "uniform float3 axisX;\n"
+        "uniform float3 axisY;\n"
+        "uniform float3 axisZ;\n"
+        "float heightAt(int2 p)\n"
+        "{\n"
+        "    int last = (int)heightMapSize - 1;\n"
+        "    p = clamp(p, int2(0, 0), int2(last, last));\n"
+        "    return heightMap.Load(int3(p.x, last - p.y, 0)).r;\n"
+        "}\n"
+        "float4 main(float4 pos : SV_POSITION, float2 uv : TEXCOORD0) : SV_Target\n"
+        "{\n"
+        "    int2 texel = (int2)floor(uv * heightMapSize);\n"
+        "    int2 c = int2(texel.x, (int)heightMapSize - 1 - texel.y);\n"
+        "    static const int2 offsets[8] = { int2(1, 0), int2(1, 1), int2(0, 1), int2(-1, 1),\n"
+        "        int2(-1, 0), int2(-1, -1), int2(0, -1), int2(1, -1) };\n"
+        "    float centre = heightAt(c);\n"
+        "    float3 adj[8];\n"
+        "    [unroll] for (int i = 0; i < 8; ++i)\n"
+        "        adj[i] = float3((float2)offsets[i] * spacing, heightAt(c + offsets[i]) - centre);\n"
+        "    float3 n = 0;\n"
+        "    [unroll] for (int j = 0; j < 8; ++j)\n"
+        "        n += normalize(cross(adj[j], adj[(j + 1) % 8]));\n"
+        "    n = normalize(n);\n"
+        "    float3 w = n.x * axisX + n.y * axisY + n.z * axisZ;\n"
+        "    return float4(w * 0.5 + 0.5, 1.0);\n"
+        "}\n";
+    // March from each lightmap element towards the light one terrain point at
+    // a time, like Terrain::calculateLightmap but without visiting neighbours
+    static const char* sLightmapFpGLSL =
+        "#version 150\n"
+        "uniform sampler2D heightMap;\n"
+        "uniform float heightMapSize;\n"
+        "uniform float lightmapSize;\n"
+        "uniform vec3 rayStep;\n"
+        "uniform float heightPad;\n"
+        "uniform float maxSteps;\n"
+        "in vec2 oUv;\n"
+        "out vec4 fragColour;\n"
+        "float fetchHeight(ivec2 p, int last)\n"
+        "{\n"
+        "    return texelFetch(heightMap, ivec2(p.x, last - p.y), 0).r;\n"
+        "}\n"
+        "float heightAt(vec2 p)\n"
+        "{\n"
+        "    int last = int(heightMapSize) - 1;\n"
+        "    vec2 f = fract(p);\n"
+        "    ivec2 p0 = ivec2(floor(p));\n"
+        "    ivec2 p1 = min(p0 + 1, ivec2(last));\n"
+        "    float h0 = mix(fetchHeight(p0, last), fetchHeight(ivec2(p1.x, p0.y), last), f.x);\n"
+        "    float h1 = mix(fetchHeight(ivec2(p0.x, p1.y), last), fetchHeight(p1, last), f.x);\n"
+        "    return mix(h0, h1, f.y);\n"
+        "}\n"
+        "void main()\n"
+        "{\n"
+        "    vec2 texel = floor(oUv * lightmapSize);\n"
+        "    vec2 t = vec2(texel.x, lightmapSize - 1.0 - texel.y) / (lightmapSize - 1.0);\n"
+        "    vec2 p = t * (heightMapSize - 1.0);\n"
+        "    float h = heightAt(p) + heightPad;\n"
+        "    float lit = 1.0;\n"
+        "    for (float s = 0.0; s < maxSteps; s += 1.0)\n"
+        "    {\n"
+        "        p += rayStep.xy;\n"
+        "        h += rayStep.z;\n"
+        "        if (any(lessThan(p, vec2(0.0))) || any(greaterThan(p, vec2(heightMapSize - 1.0))))\n"
+        "            break;\n"
+        "        if (heightAt(p) > h)\n"
+        "        {\n"
+        "            lit = 0.0;\n"
+        "            break;\n"
+        "        }\n"
+        "    }\n"
+        "    fragColour = vec4(lit, lit, lit, 1.0);\n"
+        "}\n";
+    static const char* sLightmapFpHLSL =
+        "Texture2D heightMap : register(t0);\n"
+        "uniform float heightMapSize;\n"
+        "uniform float lightmapSize;\n"
+        "uniform float3 rayStep;\n"
+        "uniform float heightPad;\n"
+        "uniform float maxSteps;\n"
+        "float fetchHeight(int2 p, int last)\n"
+        "{\n"
+        "    return heightMap.Load(int3(p.x, last - p.y, 0)).r;\n"
+        "}\n"
+        "float heightAt(float2 p)\n"
+        "{\n"
+        "    int last = (int)heightMapSize - 1;\n"
+        "    float2 f = frac(p);\n"
+        "    int2 p0 = (int2)floor(p);\n"
+        "    int2 p1 = min(p0 + 1, int2(last, last));\n"
+        "    float h0 = lerp(fetchHeight(p0, last), fetchHeight(int2(p1.x, p0.y), last), f.x);\n"
+        "    float h1 = lerp(fetchHeight(int2(p0.x, p1.y), last), fetchHeight(p1, last), f.x);\n"
+        "    return lerp(h0, h1, f.y);\n"
+        "}\n"
+        "float4 main(float4 pos : SV_POSITION, float2 uv : TEXCOORD0) : SV_Target\n"
+        "{\n"
+        "    float2 texel = floor(uv * lightmapSize);\n"
+        "    float2 t = float2(texel.x, lightmapSize - 1.0 - texel.y) / (lightmapSize - 1.0);\n"
+        "    float2 p = t * (heightMapSize - 1.0);\n"
+        "    float h = heightAt(p) + heightPad;\n"
+        "    float lit = 1.0;\n"
+        "    [loop] for (float s = 0.0; s < maxSteps; s += 1.0)\n"
+        "    {\n"
+        "        p += rayStep.xy;\n"
+        "        h += rayStep.z;\n"
+        "        if (any(p < 0.0) || any(p > heightMapSize - 1.0))\n"
+        "            break;\n"
+        "        if (heightAt(p) > h)\n"
+        "        {\n"
+        "            lit = 0.0;\n"
+        "            break;\n"
+        "        }\n"
+        "    }\n"
+        "    return float4(lit, lit, lit, 1.0);\n"
+        "}\n";
+    //---------------------------------------------------------------------
+    bool TerrainMaterialGenerator::isDerivedMapRenderingSupported() const
+    {
+        RenderSystem* rSys = Root::getSingleton().getRenderSystem();
+        if (!rSys)
+            return false;
+        const RenderSystemCapabilities* caps = rSys->getCapabilities();
+        if (!caps->hasCapability(RSC_HWRENDER_TO_TEXTURE) || !caps->hasCapability(RSC_TEXTURE_FLOAT))
+            return false;
+
+        GpuProgramManager& gmgr = GpuProgramManager::getSingleton();
+        return gmgr.isSyntaxSupported("glsl150") || gmgr.isSyntaxSupported("ps_4_0");
+    }
+    //---------------------------------------------------------------------
+    bool TerrainMaterialGenerator::isInstancedPatchRenderingSupported() const
+    {
+        RenderSystem* rSys = Root::getSingleton().getRenderSystem();
+        if (!rSys)
+            return false;
+        const RenderSystemCapabilities* caps = rSys->getCapabilities();
+        if (!caps->hasCapability(RSC_VERTEX_TEXTURE_FETCH) || 
+            !caps->hasCapability(RSC_VERTEX_BUFFER_INSTANCE_DATA) ||
+            !caps->hasCapability(RSC_TEXTURE_FLOAT))
+            return false;
+
+        Profile* p = getActiveProfile();
+        return p && p->isInstancedPatchRenderingSupported();
+    }
+    //---------------------------------------------------------------------
+    MaterialPtr TerrainMaterialGenerator::getDerivedMapMaterial(DerivedMap map)
+    {
+        const String& group = ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME;
+        String matName = map == DM_NORMAL_MAP ? "OgreTerrain/DerivedNormalMap" : "OgreTerrain/DerivedLightmap";
+        MaterialPtr mat = MaterialManager::getSingleton().getByName(matName, group);
+        if (mat)
+            return mat;
+
+        HighLevelGpuProgramManager& mgr = HighLevelGpuProgramManager::getSingleton();
+        bool glsl = GpuProgramManager::getSingleton().isSyntaxSupported("glsl150");
+        String language = glsl ? "glsl" : "hlsl";
 
+        String vpName = "OgreTerrain/DerivedMapVp";
+        HighLevelGpuProgramPtr vp = mgr.getByName(vpName, group);
+        if (!vp)
+        {
+            vp = mgr.createProgram(vpName, group, language, GPT_VERTEX_PROGRAM);
+            vp->setSource(glsl ? sDerivedMapVpGLSL : sDerivedMapVpHLSL);
+            if (!glsl)
+            {
+                vp->setParameter("target", "vs_4_0");
+                vp->setParameter("entry_point", "main");
+            }
+            vp->getDefaultParameters()->setNamedAutoConstant("worldViewProj", 
+                GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX);
+        }
+
+        HighLevelGpuProgramPtr fp = mgr.createProgram(matName + "/Fp", group, language, GPT_FRAGMENT_PROGRAM);
+        if (map == DM_NORMAL_MAP)
+            fp->setSource(glsl ? sNormalMapFpGLSL : sNormalMapFpHLSL);
+        else
+            fp->setSource(glsl ? sLightmapFpGLSL : sLightmapFpHLSL);
+        if (glsl)
+        {
+            fp->getDefaultParameters()->setNamedConstant("heightMap", 0);
+        }
+        else
+        {
+            fp->setParameter("target", "ps_4_0");
+            fp->setParameter("entry_point", "main");
+        }
+
+        mat = MaterialManager::getSingleton().create(matName, group);
+        Pass* pass = mat->getTechnique(0)->getPass(0);
+        pass->setLightingEnabled(false);
+        pass->setDepthCheckEnabled(false);
+        pass->setDepthWriteEnabled(false);
+        pass->setCullingMode(CULL_NONE);
+        pass->setVertexProgram(vpName);
+        pass->setFragmentProgram(fp->getName());
+        TextureUnitState* tu = pass->createTextureUnitState();
+        tu->setTextureAddressingMode(TextureUnitState::TAM_CLAMP);
+        tu->setTextureFiltering(TFO_NONE);
+        mat->load();
+
+        return mat;
+    }
+    //---------------------------------------------------------------------
+    void TerrainMaterialGenerator::_renderDerivedMap(const Terrain* terrain, DerivedMap map, 
+        const TexturePtr& heightMap, const Rect& rect, const TexturePtr& dest)
+    {
+        size_t size = dest->getWidth();
+        MaterialPtr mat = getDerivedMapMaterial(map);
+        createCompositeMapScene(size, mat);
+        mCompositeMapPlane->setMaterialName(0, mat->getName(), mat->getGroup());
+
+        Pass* pass = mat->getTechnique(0)->getPass(0);
+        pass->getTextureUnitState(0)->setTexture(heightMap);
+
+        Real heightMapSize = (Real)heightMap->getWidth();
+        Real spacing = terrain->getWorldSize() / (heightMapSize - 1);
+        GpuProgramParametersSharedPtr params = pass->getFragmentProgramParameters();
+        params->setNamedConstant("heightMapSize", heightMapSize);
+        if (map == DM_NORMAL_MAP)
+        {
+            Vector3 axis;
+            params->setNamedConstant("spacing", spacing);
+            Terrain::convertTerrainToWorldAxes(terrain->getAlignment(), Vector3::UNIT_X, &axis);
+            params->setNamedConstant("axisX", axis);
+            Terrain::convertTerrainToWorldAxes(terrain->getAlignment(), Vector3::UNIT_Y, &axis);
+            params->setNamedConstant("axisY", axis);
+            Terrain::convertTerrainToWorldAxes(terrain->getAlignment(), Vector3::UNIT_Z, &axis);
+            params->setNamedConstant("axisZ", axis);
+        }
+        else
+        {
+            // step one terrain point along the dominant axis of the light
+            // direction, and keep going until the terrain is left or the ray is
+            // above the highest point
+            Vector3 dir;
+            Terrain::convertWorldToTerrainAxes(terrain->getAlignment(), 
+                -TerrainGlobalOptions::getSingleton().getLightMapDirection(), &dir);
+            Real heightRange = terrain->getMaxHeight() - terrain->getMinHeight();
+            Real planar = std::max(Math::Abs(dir.x), Math::Abs(dir.y));
+            Vector3 rayStep = Vector3::ZERO;
+            Real maxSteps = 0;
+            if (planar > 1e-4f)
+            {
+                rayStep = Vector3(dir.x / planar, dir.y / planar, dir.z * spacing / planar);
+                maxSteps = heightMapSize * 1.5f;
+                if (rayStep.z > 0)
+                    maxSteps = std::min(maxSteps, Math::Ceil(heightRange / rayStep.z) + 1);
+            }
+            params->setNamedConstant("lightmapSize", (Real)size);
+            params->setNamedConstant("rayStep", rayStep);
+            params->setNamedConstant("heightPad", heightRange * 1.0e-3f);
+            params->setNamedConstant("maxSteps", maxSteps);
+        }
+
+        // recreate the RTT if the size changed
+        Texture*& rttTex = mDerivedMapRTT[map];
+        if (rttTex && size != rttTex->getWidth())
+        {
+            TextureManager::getSingleton().remove(rttTex->getHandle());
+            rttTex = 0;
+        }
+
+        if (!rttTex)
+        {
+            rttTex = TextureManager::getSingleton().createManual(
+                mCompositeMapSM->getName() + (map == DM_NORMAL_MAP ? "/nmRTT" : "/lmRTT"), 
+                ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, TEX_TYPE_2D, static_cast<uint>(size), static_cast<uint>(size), 0, PF_BYTE_RGBA,
+                TU_RENDERTARGET).get();
+            RenderTarget* rtt = rttTex->getBuffer()->getRenderTarget();
+            // don't render all the time, only on demand
+            rtt->setAutoUpdated(false);
+            Viewport* vp = rtt->addViewport(mCompositeMapCam);
+            // don't render overlays
+            vp->setOverlaysEnabled(false);
+        }
+
+        renderToTexture(rttTex, rect, dest);
+    }
 
 }
 
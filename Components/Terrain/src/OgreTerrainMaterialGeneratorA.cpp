@@ -137,6 +137,16 @@ namespace Ogre
             return true;
     }
     //---------------------------------------------------------------------
+    bool TerrainMaterialGeneratorA::SM2Profile::isInstancedPatchRenderingSupported() const
+    {
+        // patches are fed through the compressed vertex path, and fetching
+        // the heights needs vertex shader model 3
+        if (!isVertexCompressionSupported())
+            return false;
+        GpuProgramManager& gmgr = GpuProgramManager::getSingleton();
+        return gmgr.isSyntaxSupported("vs_3_0") || gmgr.isSyntaxSupported("vs_4_0");
+    }
+    //---------------------------------------------------------------------
     void TerrainMaterialGeneratorA::SM2Profile::setLayerNormalMappingEnabled(bool enabled)
     {
         if (enabled != mLayerNormalMappingEnabled)
@@ -376,6 +386,17 @@ namespace Ogre
         pass->setVertexProgram(vprog->getName());
         pass->setFragmentProgram(fprog->getName());
 
+        if (terrain->_getUseInstancedPatches() && tt != RENDER_COMPOSITE_MAP)
+        {
+            // heights for the instanced patches, always the first unit since
+            // some APIs only have a handful of vertex samplers
+            TextureUnitState* tu = pass->createTextureUnitState();
+            tu->setTextureName(terrain->getHeightTexture()->getName());
+            tu->setBindingType(TextureUnitState::BT_VERTEX);
+            tu->setTextureFiltering(TFO_NONE);
+            tu->setTextureAddressingMode(TextureUnitState::TAM_CLAMP);
+        }
+
         if (tt == HIGH_LOD || tt == RENDER_COMPOSITE_MAP)
         {
             // global normal map
@@ -581,6 +602,13 @@ namespace Ogre
             params->setNamedConstant("posIndexToObjectSpace", posIndexToObjectSpace);
         }
 
+        if (terrain->_getUseInstancedPatches() && tt != RENDER_COMPOSITE_MAP)
+        {
+            // 1 / height texture size, skirt size, last vertex index
+            params->setNamedConstant("patchParams", Vector4(1.0f / terrain->getSize(),
+                terrain->getSkirtSize(), terrain->getSize() - 1.0f, 0.0f));
+        }
+
         
         
     }
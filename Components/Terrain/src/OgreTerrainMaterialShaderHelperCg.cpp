@@ -90,10 +90,20 @@ namespace Ogre
     void TerrainMaterialGeneratorA::SM2Profile::ShaderHelperCg::generateVpHeader(
         const SM2Profile* prof, const Terrain* terrain, TechniqueType tt, StringStream& outStream)
     {
+        bool instanced = terrain->_getUseInstancedPatches() && tt != RENDER_COMPOSITE_MAP;
+        if (instanced)
+            generateVpPatchHelpers(false, outStream);
+
         outStream << 
             "void main_vp(\n";
         bool compression = terrain->_getUseVertexCompression() && tt != RENDER_COMPOSITE_MAP;
-        if (compression)
+        if (instanced)
+        {
+            outStream <<
+                "float3 patchVertex : POSITION,\n" // grid x, grid y, skirt
+                "float4 patchInstance : TEXCOORD1,\n"; // offset x, offset y, step, morph
+        }
+        else if (compression)
         {
             const char* idx2 = prof->_isSM4Available() ? "int2" : "float2";
             outStream << 
@@ -107,13 +117,14 @@ namespace Ogre
                 "float2 uv  : TEXCOORD0,\n";
 
         }
-        if (tt != RENDER_COMPOSITE_MAP)
+        if (tt != RENDER_COMPOSITE_MAP && !instanced)
             outStream << "float2 delta  : TEXCOORD1,\n"; // lodDelta, lodThreshold
 
         outStream << 
             "uniform float4x4 worldMatrix,\n"
-            "uniform float4x4 viewProjMatrix,\n"
-            "uniform float2   lodMorph,\n"; // morph amount, morph LOD target
+            "uniform float4x4 viewProjMatrix,\n";
+        if (!instanced)
+            outStream << "uniform float2   lodMorph,\n"; // morph amount, morph LOD target
 
         if (compression)
         {
@@ -180,6 +191,8 @@ namespace Ogre
         outStream <<
             ")\n"
             "{\n";
+        if (instanced)
+            generateVpPatchInputs(outStream);
         if (compression)
         {
             outStream <<
@@ -303,7 +316,9 @@ namespace Ogre
                 "float fogVal : COLOR,\n";
         }
 
-        uint currentSamplerIdx = 0;
+        // instanced patches read the heights from the first unit
+        uint currentSamplerIdx = 
+            (terrain->_getUseInstancedPatches() && tt != RENDER_COMPOSITE_MAP) ? 1 : 0;
 
         outStream <<
             // Only 1 light supported in this version
@@ -903,4 +918,57 @@ namespace Ogre
             "   shadow = min(shadow, rtshadow);\n";
         
     }
+    //---------------------------------------------------------------------
+    void TerrainMaterialGeneratorA::SM2Profile::ShaderHelperCg::generateVpPatchHelpers(
+        bool sm4, StringStream& outStream)
+    {
+        // heights are in the first texture unit, with rows inverted
+        if (sm4)
+        {
+            outStream <<
+                "Texture2D heightMap : register(t0);\n"
+                "float4 patchParams;\n";
+        }
+        else
+        {
+            outStream <<
+                "uniform sampler2D heightMap : register(s0);\n"
+                "uniform float4 patchParams;\n";
+        }
+        // x = 1 / terrain size, y = skirt size, z = last vertex index
+        outStream <<
+            "float patchHeight(float2 posIndex)\n"
+            "{\n";
+        if (sm4)
+        {
+            outStream <<
+                "   return heightMap.Load(int3(posIndex.x, patchParams.z - posIndex.y, 0)).r;\n";
+        }
+        else
+        {
+            outStream <<
+                "   float2 uv = float2(posIndex.x + 0.5, patchParams.z - posIndex.y + 0.5) * patchParams.x;\n"
+                "   return tex2Dlod(heightMap, float4(uv, 0, 0)).r;\n";
+        }
+        outStream <<
+            "}\n";
+    }
+    //---------------------------------------------------------------------
+    void TerrainMaterialGeneratorA::SM2Profile::ShaderHelperCg::generateVpPatchInputs(
+        StringStream& outStream)
+    {
+        // Vertices on odd rows / columns of the patch disappear at the next
+        // LOD, so they morph towards the middle of the coarser edge or diagonal
+        // they lie on; that makes lodMorph.y a constant and delta.y a flag.
+        outStream <<
+            "   float2 posIndex = patchInstance.xy + patchVertex.xy * patchInstance.z;\n"
+            "   float2 odd = fmod(patchVertex.xy, 2.0);\n"
+            "   float2 neighbourOffset = odd * patchInstance.z;\n"
+            "   float skirt = patchVertex.z * patchParams.y;\n"
+            "   float height = patchHeight(posIndex) - skirt;\n"
+            "   float morphTarget = 0.5 * (patchHeight(posIndex - neighbourOffset) + \n"
+            "       patchHeight(posIndex + neighbourOffset)) - skirt;\n"
+            "   float2 delta = float2(morphTarget - height, 1 - max(odd.x, odd.y));\n"
+            "   float2 lodMorph = float2(patchInstance.w, 1);\n";
+    }
 }
@@ -158,10 +158,20 @@ namespace Ogre
         outStream << "};\n";
         //output/input structure finished
 
+        bool instanced = terrain->_getUseInstancedPatches() && tt != RENDER_COMPOSITE_MAP;
+        if (instanced)
+            generateVpPatchHelpers(true, outStream);
+
         outStream << 
             "v2p main_vp(\n";
         bool compression = terrain->_getUseVertexCompression() && tt != RENDER_COMPOSITE_MAP;
-        if (compression)
+        if (instanced)
+        {
+            outStream <<
+                "float3 patchVertex : POSITION,\n" // grid x, grid y, skirt
+                "float4 patchInstance : TEXCOORD1,\n"; // offset x, offset y, step, morph
+        }
+        else if (compression)
         {
             outStream << 
                 "float2 posIndex : POSITION,\n"
@@ -174,13 +184,14 @@ namespace Ogre
                 "float2 uv  : TEXCOORD0,\n";
 
         }
-        if (tt != RENDER_COMPOSITE_MAP)
+        if (tt != RENDER_COMPOSITE_MAP && !instanced)
             outStream << "float2 delta  : TEXCOORD1,\n"; // lodDelta, lodThreshold
 
         outStream << 
             "uniform matrix worldMatrix,\n"
-            "uniform matrix viewProjMatrix,\n"
-            "uniform float2   lodMorph,\n"; // morph amount, morph LOD target
+            "uniform matrix viewProjMatrix,\n";
+        if (!instanced)
+            outStream << "uniform float2   lodMorph,\n"; // morph amount, morph LOD target
 
         if (compression)
         {
@@ -215,6 +226,8 @@ namespace Ogre
         outStream <<
             ")\n"
             "{\n";
+        if (instanced)
+            generateVpPatchInputs(outStream);
         if (compression)
         {
             outStream <<
@@ -467,7 +480,9 @@ namespace Ogre
         outStream << "};\n";
         //output/input structure finished
 
-        uint currentSamplerIdx = 0;
+        // instanced patches read the heights from the first unit
+        uint currentSamplerIdx = 
+            (terrain->_getUseInstancedPatches() && tt != RENDER_COMPOSITE_MAP) ? 1 : 0;
         if (tt == LOW_LOD)
         {
             // single composite map covers all the others below
@@ -0,0 +1,305 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreTerrainPatchRenderer.h"
+#include "OgreTerrain.h"
+#include "OgreTerrainQuadTreeNode.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreVertexIndexData.h"
+#include "OgreRenderQueue.h"
+#include "OgreSceneNode.h"
+#include "OgreMaterial.h"
+#include "OgreTechnique.h"
+
+namespace Ogre
+{
+    unsigned short TerrainPatchRenderer::PATCH_BUFFER = 0;
+    unsigned short TerrainPatchRenderer::INSTANCE_BUFFER = 1;
+    //---------------------------------------------------------------------
+    TerrainPatchRenderer::TerrainPatchRenderer(Terrain* terrain)
+        : mTerrain(terrain)
+        , mPatchSize(terrain->getMinBatchSize())
+        , mPatchIndexData(0)
+    {
+        createPatch();
+    }
+    //---------------------------------------------------------------------
+    TerrainPatchRenderer::~TerrainPatchRenderer()
+    {
+        for (BatchList::iterator i = mBatches.begin(); i != mBatches.end(); ++i)
+            OGRE_DELETE *i;
+        mBatches.clear();
+
+        OGRE_DELETE mPatchIndexData;
+    }
+    //---------------------------------------------------------------------
+    void TerrainPatchRenderer::createPatch()
+    {
+        // Grid vertices first, then a ring of skirt vertices along each edge
+        // in the order bottom (y = 0), top, left (x = 0), right. Each vertex is
+        // its grid coordinate plus a skirt flag.
+        size_t gridCount = mPatchSize * mPatchSize;
+        size_t vertexCount = gridCount + 4 * mPatchSize;
+        mPatchBuffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+            sizeof(float) * 3, vertexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+
+        float* pVert = static_cast<float*>(mPatchBuffer->lock(HardwareBuffer::HBL_DISCARD));
+        for (uint16 y = 0; y < mPatchSize; ++y)
+        {
+            for (uint16 x = 0; x < mPatchSize; ++x)
+            {
+                *pVert++ = x;
+                *pVert++ = y;
+                *pVert++ = 0;
+            }
+        }
+        uint16 last = mPatchSize - 1;
+        for (int edge = 0; edge < 4; ++edge)
+        {
+            for (uint16 i = 0; i < mPatchSize; ++i)
+            {
+                *pVert++ = edge < 2 ? i : (edge == 2 ? 0 : last);
+                *pVert++ = edge < 2 ? (edge == 0 ? 0 : last) : i;
+                *pVert++ = 1;
+            }
+        }
+        mPatchBuffer->unlock();
+
+        // Triangle list, counter-clockwise seen from above; skirts face outwards
+        size_t indexCount = last * last * 6 + 4 * last * 6;
+        mPatchIndexData = OGRE_NEW IndexData();
+        mPatchIndexData->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+            HardwareIndexBuffer::IT_16BIT, indexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        mPatchIndexData->indexStart = 0;
+        mPatchIndexData->indexCount = indexCount;
+
+        uint16* pIdx = static_cast<uint16*>(
+            mPatchIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+        for (uint16 y = 0; y < last; ++y)
+        {
+            for (uint16 x = 0; x < last; ++x)
+            {
+                uint16 a = y * mPatchSize + x;
+                uint16 b = a + 1;
+                uint16 c = b + mPatchSize;
+                uint16 d = a + mPatchSize;
+                *pIdx++ = a; *pIdx++ = b; *pIdx++ = c;
+                *pIdx++ = a; *pIdx++ = c; *pIdx++ = d;
+            }
+        }
+        for (int edge = 0; edge < 4; ++edge)
+        {
+            uint16 skirtStart = static_cast<uint16>(gridCount + edge * mPatchSize);
+            // the right and bottom edges wind one way, the left and top the other
+            bool reverse = (edge == 1 || edge == 2);
+            for (uint16 i = 0; i < last; ++i)
+            {
+                uint16 p0, p1;
+                if (edge < 2)
+                {
+                    p0 = (edge == 0 ? 0 : last) * mPatchSize + i;
+                    p1 = p0 + 1;
+                }
+                else
+                {
+                    p0 = i * mPatchSize + (edge == 2 ? 0 : last);
+                    p1 = p0 + mPatchSize;
+                }
+                uint16 s0 = skirtStart + i;
+                uint16 s1 = s0 + 1;
+                if (reverse)
+                {
+                    *pIdx++ = p0; *pIdx++ = p1; *pIdx++ = s1;
+                    *pIdx++ = p0; *pIdx++ = s1; *pIdx++ = s0;
+                }
+                else
+                {
+                    *pIdx++ = p0; *pIdx++ = s1; *pIdx++ = p1;
+                    *pIdx++ = p0; *pIdx++ = s0; *pIdx++ = s1;
+                }
+            }
+        }
+        mPatchIndexData->indexBuffer->unlock();
+    }
+    //---------------------------------------------------------------------
+    size_t TerrainPatchRenderer::getInstanceCount() const
+    {
+        size_t count = 0;
+        for (BatchList::const_iterator i = mBatches.begin(); i != mBatches.end(); ++i)
+        {
+            if (*i)
+                count += (*i)->getInstanceCount();
+        }
+        return count;
+    }
+    //---------------------------------------------------------------------
+    void TerrainPatchRenderer::_beginPass()
+    {
+        for (BatchList::iterator i = mBatches.begin(); i != mBatches.end(); ++i)
+        {
+            if (*i)
+                (*i)->clear();
+        }
+    }
+    //---------------------------------------------------------------------
+    TerrainPatchRenderer::Batch* TerrainPatchRenderer::getBatch(unsigned short materialLodIndex)
+    {
+        if (materialLodIndex >= mBatches.size())
+            mBatches.resize(materialLodIndex + 1, 0);
+        if (!mBatches[materialLodIndex])
+            mBatches[materialLodIndex] = OGRE_NEW Batch(this, materialLodIndex);
+        return mBatches[materialLodIndex];
+    }
+    //---------------------------------------------------------------------
+    void TerrainPatchRenderer::_queueNode(TerrainQuadTreeNode* node, RenderQueue* queue)
+    {
+        const TerrainQuadTreeNode::LodLevel* ll =
+            node->getLodLevel(static_cast<uint16>(node->getCurrentLod()));
+        // spacing of the vertices at this LOD, and how many patches cover the node
+        uint16 step = (node->getSize() - 1) / (ll->batchSize - 1);
+        uint16 patchesPerSide = (ll->batchSize - 1) / (mPatchSize - 1);
+        uint16 patchExtent = (mPatchSize - 1) * step;
+
+        Batch* batch = getBatch(node->getMaterialLodIndex());
+        if (!batch->getInstanceCount())
+        {
+            batch->mLightNode = node;
+            queue->addRenderable(batch, mTerrain->getRenderQueueGroup());
+        }
+
+        for (uint16 j = 0; j < patchesPerSide; ++j)
+        {
+            for (uint16 i = 0; i < patchesPerSide; ++i)
+            {
+                batch->addInstance(node->getXOffset() + i * patchExtent,
+                    node->getYOffset() + j * patchExtent, step, node->getLodTransition());
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    TerrainPatchRenderer::Batch::Batch(TerrainPatchRenderer* parent, unsigned short materialLodIndex)
+        : mLightNode(0)
+        , mParent(parent)
+        , mMaterialLodIndex(materialLodIndex)
+        , mInstanceDataDirty(false)
+    {
+        mVertexData = OGRE_NEW VertexData();
+        mVertexData->vertexDeclaration->addElement(PATCH_BUFFER, 0, VET_FLOAT3, VES_POSITION);
+        mVertexData->vertexDeclaration->addElement(INSTANCE_BUFFER, 0, VET_FLOAT4,
+            VES_TEXTURE_COORDINATES, 1);
+        mVertexData->vertexBufferBinding->setBinding(PATCH_BUFFER, mParent->mPatchBuffer);
+        mVertexData->vertexStart = 0;
+        mVertexData->vertexCount = mParent->mPatchBuffer->getNumVertices();
+    }
+    //---------------------------------------------------------------------
+    TerrainPatchRenderer::Batch::~Batch()
+    {
+        OGRE_DELETE mVertexData;
+    }
+    //---------------------------------------------------------------------
+    void TerrainPatchRenderer::Batch::clear()
+    {
+        mInstanceData.clear();
+        mLightNode = 0;
+        mInstanceDataDirty = true;
+    }
+    //---------------------------------------------------------------------
+    void TerrainPatchRenderer::Batch::addInstance(float offsetX, float offsetY, float step, float morph)
+    {
+        mInstanceData.push_back(offsetX);
+        mInstanceData.push_back(offsetY);
+        mInstanceData.push_back(step);
+        mInstanceData.push_back(morph);
+        mInstanceDataDirty = true;
+    }
+    //---------------------------------------------------------------------
+    void TerrainPatchRenderer::Batch::uploadInstanceData()
+    {
+        if (!mInstanceDataDirty || mInstanceData.empty())
+            return;
+
+        size_t count = getInstanceCount();
+        if (!mInstanceBuffer || mInstanceBuffer->getNumVertices() < count)
+        {
+            // grow geometrically so that a moving camera doesn't keep reallocating
+            size_t capacity = std::max(count, mInstanceBuffer ? mInstanceBuffer->getNumVertices() * 2 : 0);
+            mInstanceBuffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+                sizeof(float) * 4, capacity, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+            mInstanceBuffer->setIsInstanceData(true);
+            mInstanceBuffer->setInstanceDataStepRate(1);
+            mVertexData->vertexBufferBinding->setBinding(INSTANCE_BUFFER, mInstanceBuffer);
+        }
+        mInstanceBuffer->writeData(0, count * sizeof(float) * 4, &mInstanceData[0], true);
+        mInstanceDataDirty = false;
+    }
+    //---------------------------------------------------------------------
+    const MaterialPtr& TerrainPatchRenderer::Batch::getMaterial(void) const
+    {
+        return mParent->mTerrain->getMaterial();
+    }
+    //---------------------------------------------------------------------
+    Technique* TerrainPatchRenderer::Batch::getTechnique(void) const
+    {
+        return getMaterial()->getBestTechnique(mMaterialLodIndex, this);
+    }
+    //---------------------------------------------------------------------
+    void TerrainPatchRenderer::Batch::getRenderOperation(RenderOperation& op)
+    {
+        uploadInstanceData();
+
+        op.operationType = RenderOperation::OT_TRIANGLE_LIST;
+        op.useIndexes = true;
+        op.vertexData = mVertexData;
+        op.indexData = mParent->mPatchIndexData;
+        op.numberOfInstances = getInstanceCount();
+    }
+    //---------------------------------------------------------------------
+    void TerrainPatchRenderer::Batch::getWorldTransforms(Matrix4* xform) const
+    {
+        // patches are positioned in terrain space, like compressed vertices
+        *xform = Matrix4::IDENTITY;
+        xform->setTrans(mParent->mTerrain->getPosition());
+    }
+    //---------------------------------------------------------------------
+    Real TerrainPatchRenderer::Batch::getSquaredViewDepth(const Camera* cam) const
+    {
+        return mParent->mTerrain->_getRootSceneNode()->getSquaredViewDepth(cam);
+    }
+    //---------------------------------------------------------------------
+    const LightList& TerrainPatchRenderer::Batch::getLights(void) const
+    {
+        static LightList emptyLights;
+        return mLightNode ? mLightNode->_getRenderable()->getLights() : emptyLights;
+    }
+    //---------------------------------------------------------------------
+    bool TerrainPatchRenderer::Batch::getCastsShadows(void) const
+    {
+        // the shadow caster materials don't know how to read the height texture
+        return false;
+    }
+}
@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 #include "OgreTerrainQuadTreeNode.h"
 #include "OgreTerrain.h"
+#include "OgreTerrainPatchRenderer.h"
 #include "OgreVertexIndexData.h"
 #include "OgreDefaultHardwareBufferManager.h"
 #include "OgreCamera.h"
@@ -266,8 +267,12 @@ namespace Ogre
     }
     void TerrainQuadTreeNode::loadSelf()
     {
-        createGpuVertexData();
-        createGpuIndexData();
+        // instanced patches share one grid, the node only needs to be placed & culled
+        if (!mTerrain->_getUseInstancedPatches())
+        {
+            createGpuVertexData();
+            createGpuIndexData();
+        }
         if (!mLocalNode)
             mLocalNode = mTerrain->_getRootSceneNode()->createChildSceneNode(mLocalCentre);
 
@@ -536,18 +541,23 @@ namespace Ogre
                 // if so, destroy it to free RAM, this should be fast enough to 
                 // to direct
                 HardwareVertexBufferSharedPtr posbuf, deltabuf;
-                VertexData* targetVertexData = mVertexDataRecord->cpuVertexData;
-                if(!cpuData)
+                // instanced patches read the height texture, so only the bounds
+                // need updating when there is no GPU vertex data
+                if (cpuData || !mTerrain->_getUseInstancedPatches())
                 {
-                    if(mVertexDataRecord->gpuVertexData == NULL) 
-                        createGpuVertexData();
-                    targetVertexData = mVertexDataRecord->gpuVertexData;
-                }
+                    VertexData* targetVertexData = mVertexDataRecord->cpuVertexData;
+                    if(!cpuData)
+                    {
+                        if(mVertexDataRecord->gpuVertexData == NULL) 
+                            createGpuVertexData();
+                        targetVertexData = mVertexDataRecord->gpuVertexData;
+                    }
 
-                if (positions) 
-                    posbuf = targetVertexData->vertexBufferBinding->getBuffer(POSITION_BUFFER);
-                if (deltas)
-                    deltabuf = targetVertexData->vertexBufferBinding->getBuffer(DELTA_BUFFER);
+                    if (positions) 
+                        posbuf = targetVertexData->vertexBufferBinding->getBuffer(POSITION_BUFFER);
+                    if (deltas)
+                        deltabuf = targetVertexData->vertexBufferBinding->getBuffer(DELTA_BUFFER);
+                }
                 updateVertexBuffer(posbuf, deltabuf, updateRect);
             }
 
@@ -1420,7 +1430,13 @@ namespace Ogre
     {
         if (isRenderedAtCurrentLod())
         {
-            queue->addRenderable(mRend, mTerrain->getRenderQueueGroup());           
+            if (mTerrain->_getUseInstancedPatches())
+            {
+                if (mTerrain->_getPatchRenderer())
+                    mTerrain->_getPatchRenderer()->_queueNode(this, queue);
+            }
+            else
+                queue->addRenderable(mRend, mTerrain->getRenderQueueGroup());           
         }
     }
     //---------------------------------------------------------------------
@@ -71,6 +71,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
     };
 
     /** A plane.
@@ -102,6 +110,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
     };
 
     /** A not rotated cube.
@@ -166,6 +182,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
     };
 
     /** Abstract operation volume source holding two sources as operants.
@@ -244,6 +268,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
     };
 
     /** Builds the union between two sources.
@@ -271,6 +303,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
     };
 
     /** Builds the difference between two sources.
@@ -299,6 +339,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
     };
 
     /** Source which does a unary operation to another one.
@@ -359,6 +407,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
     };
 
     /** Scales the given volume source.
@@ -386,6 +442,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
     };
 
     class _OgreVolumeExport CSGNoiseSource: public CSGUnarySource
@@ -413,20 +477,31 @@ namespace Volume {
         /// Prepares the node members.
         void setData(void);
 
-        /* Gets the density value.
+        /* Gets the noise added to the density value.
         @param position
             The position of the value.
         @return
-            The value.
+            The noise.
         */
-        inline Real getInternalValue(const Vector3 &position) const
+        inline Real getNoise(const Vector3 &position) const
         {
             Real toAdd = (Real)0.0;
             for (size_t i = 0; i < mNumOctaves; ++i)
             {
                 toAdd += mNoise.noise(position.x * mFrequencies[i], position.y * mFrequencies[i], position.z * mFrequencies[i]) * mAmplitudes[i];
             }
-            return mSrc->getValue(position) + toAdd;
+            return toAdd;
+        }
+
+        /* Gets the density value.
+        @param position
+            The position of the value.
+        @return
+            The value.
+        */
+        inline Real getInternalValue(const Vector3 &position) const
+        {
+            return mSrc->getValue(position) + getNoise(position);
         }
 
     public:
@@ -464,6 +539,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
         
         /** Gets the initial seed.
         @return
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #define __Ogre_Volume_CacheSource_H__
 
 #include "OgreVector4.h"
+#include "OgreCommon.h"
+#include "Threading/OgreThreadHeaders.h"
 
 #include "OgreVolumeSource.h"
 #include "OgreVolumePrerequisites.h"
@@ -52,17 +54,56 @@ namespace Volume {
     bool _OgreVolumeExport operator<(const Vector3& a, const Vector3& b);
 
     /** A caching Source.
+    @remarks
+        The cache is split into shards which are selected by the hash of the
+        position, each guarded by its own mutex, so that chunks loaded on
+        several WorkQueue threads rarely wait for each other. Every shard is a
+        fixed size, direct mapped table: a new value replaces the one it
+        collides with, which bounds the memory used no matter how many
+        positions are queried. A shard's table is only allocated once the
+        first value is stored in it.
     */
     class _OgreVolumeExport CacheSource : public Source
     {
     protected:
-        
-        /// Map for the cache
-        typedef map<Vector3, Vector4>::type UMapPositionValue;
-        mutable UMapPositionValue mCache;
+
+        /// The amount of independently locked parts of the cache.
+        static const size_t NUM_SHARDS = 64;
+
+        /// One cached density value and gradient.
+        struct Entry
+        {
+            Vector3 position;
+            Vector4 value;
+            bool valid;
+        };
+        typedef vector<Entry>::type EntryList;
+
+        /// A part of the cache with its own lock.
+        struct Shard
+        {
+            OGRE_WQ_MUTEX(mutex);
+            /// Empty until the first value is stored.
+            EntryList entries;
+        };
+        mutable Shard mShards[NUM_SHARDS];
+
+        /// The amount of entries of every shard, a power of two.
+        size_t mEntriesPerShard;
 
         /// The source to cache.
         const Source *mSrc;
+
+        /** Hashes a position.
+        @param position
+            The position to hash.
+        @return
+            The hash.
+        */
+        inline uint32 hashPosition(const Vector3 &position) const
+        {
+            return FastHash((const char*)&position, sizeof(Vector3));
+        }
         
         /** Gets a density value and gradient from the cache.
         @param position
@@ -72,16 +113,36 @@ namespace Volume {
         */
         inline Vector4 getFromCache(const Vector3 &position) const
         {
-            Vector4 result;
-            map<Vector3, Vector4>::iterator it = mCache.find(position);
-            if (it == mCache.end())
+            uint32 hash = hashPosition(position);
+            Shard &shard = mShards[hash % NUM_SHARDS];
+            // The low bits already picked the shard.
+            size_t index = (hash / NUM_SHARDS) & (mEntriesPerShard - 1);
             {
-                result = mSrc->getValueAndGradient(position);
-                mCache[position] = result;
+                OGRE_WQ_LOCK_MUTEX(shard.mutex);
+                if (!shard.entries.empty())
+                {
+                    const Entry &entry = shard.entries[index];
+                    if (entry.valid && memcmp(&entry.position, &position, sizeof(Vector3)) == 0)
+                    {
+                        return entry.value;
+                    }
+                }
             }
-            else
+
+            // Evaluate without holding the lock, the source might be slow.
+            Vector4 result = mSrc->getValueAndGradient(position);
             {
-                result = it->second;
+                OGRE_WQ_LOCK_MUTEX(shard.mutex);
+                if (shard.entries.empty())
+                {
+                    Entry empty;
+                    empty.valid = false;
+                    shard.entries.resize(mEntriesPerShard, empty);
+                }
+                Entry &entry = shard.entries[index];
+                entry.position = position;
+                entry.value = result;
+                entry.valid = true;
             }
             return result;
         }
@@ -91,8 +152,11 @@ namespace Volume {
         /** Constructor.
         @param src
             The source to cache.
+        @param maxEntries
+            The maximum amount of cached values, rounded up so every shard holds a power of two.
+            Each takes about 32 bytes, allocated as the shards get used.
         */
-        CacheSource(const Source *src);
+        CacheSource(const Source *src, size_t maxEntries = 262144);
         
         /** Overridden from Source.
         */
@@ -102,6 +166,14 @@ namespace Volume {
         */
         virtual Real getValue(const Vector3 &position) const;
 
+        /** Empties the cache, for example after the cached source changed.
+        */
+        void clear(void);
+
+        /** Gets the amount of values the cache currently has room for.
+        */
+        size_t getAllocatedEntries(void) const;
+
     };
     /** @} */
     /** @} */
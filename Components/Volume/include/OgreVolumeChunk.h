@@ -96,12 +96,18 @@ namespace Volume {
         /// Whether to load the chunks async. if set to false, the call to load waits for the whole chunk. false is the default.
         bool async;
 
+        /// Directory where generated chunk meshes are stored and loaded from on the next initial load. Empty (the default) disables the cache.
+        String meshCachePath;
+
+        /// Identifies the content of the source for the mesh cache, change it whenever the source data changes. 0 is the default.
+        uint32 sourceHash;
+
         /** Constructor.
         */
         ChunkParameters(void) :
             sceneManager(0), src(0), baseError((Real)0.0), errorMultiplicator((Real)1.0), createOctreeVisualization(false),
             createDualGridVisualization(false), skirtFactor(0), lodCallback(0), scale((Real)1.0), maxScreenSpaceError(0), createGeometryFromLevel(0),
-            updateFrom(Vector3::ZERO), updateTo(Vector3::ZERO), async(false)
+            updateFrom(Vector3::ZERO), updateTo(Vector3::ZERO), async(false), sourceHash(0)
         {
         }
     } ChunkParameters;
@@ -125,9 +131,22 @@ namespace Volume {
         /// The parameters with which the chunktree got loaded.
         ChunkParameters *parameters;
 
+        /// The scene node the root chunk got loaded into.
+        SceneNode *parent;
+
+        /// The back lower left corner of the world.
+        Vector3 totalFrom;
+
+        /// The front upper right corner of the world.
+        Vector3 totalTo;
+
+        /// The amount of LOD levels of the tree.
+        size_t maxLevels;
+
         /** Constructor.
         */
-        ChunkTreeSharedData(const ChunkParameters *params) : octreeVisible(false), dualGridVisible(false), volumeVisible(true), chunksBeingProcessed(0)
+        ChunkTreeSharedData(const ChunkParameters *params) : octreeVisible(false), dualGridVisible(false), volumeVisible(true), chunksBeingProcessed(0),
+            parent(0), totalFrom(Vector3::ZERO), totalTo(Vector3::ZERO), maxLevels(0)
         {
             this->parameters = new ChunkParameters(*params);
         }
@@ -259,6 +278,40 @@ namespace Volume {
         */
         virtual void prepareGeometry(size_t level, OctreeNode *root, DualGridGenerator *dualGridGenerator, MeshBuilder *meshBuilder, const Vector3 &totalFrom, const Vector3 &totalTo);
 
+        /** Gets the file of the mesh cache holding the geometry of a chunk request.
+        @param level
+            The current LOD level.
+        @param root
+            The root of the Octree of the chunk.
+        @param totalFrom
+            The back lower left corner of the world.
+        @param totalTo
+            The front upper rightcorner of the world.
+        @return
+            The filename or an empty string if the cache can't be used with the current parameters.
+        */
+        virtual String getMeshCacheFile(size_t level, const OctreeNode *root, const Vector3 &totalFrom, const Vector3 &totalTo) const;
+
+        /** Tries to fill the MeshBuilder of a chunk request from the mesh cache. To be called in a different thread.
+        @param level
+            The current LOD level.
+        @param meshBuilder
+            The MeshBuilder which will contain the geometry.
+        @param filename
+            The cache file from getMeshCacheFile.
+        @return
+            true if the geometry got loaded, false if it has to be generated.
+        */
+        virtual bool loadFromMeshCache(size_t level, MeshBuilder *meshBuilder, const String &filename);
+
+        /** Stores the generated geometry of a chunk request in the mesh cache. To be called in a different thread.
+        @param meshBuilder
+            The MeshBuilder holding the geometry.
+        @param filename
+            The cache file from getMeshCacheFile.
+        */
+        virtual void saveToMeshCache(const MeshBuilder *meshBuilder, const String &filename) const;
+
         /** Loads the actual geometry when the processing is done.
         @param meshBuilder
             The MeshBuilder holding the geometry.
@@ -273,6 +326,14 @@ namespace Volume {
         */
         virtual void loadGeometry(MeshBuilder *meshBuilder, DualGridGenerator *dualGridGenerator, OctreeNode *root, size_t level, bool isUpdate);
 
+        /** Replaces the geometry of this chunk, freeing the old one.
+        @param vertexData
+            The new vertex data, may be 0.
+        @param indexData
+            The new index data, may be 0.
+        */
+        void setGeometry(VertexData *vertexData, IndexData *indexData);
+
         /** Sets the visibility of this chunk.
         @param visible
             Whether this chunk is visible or not.
@@ -369,6 +430,27 @@ namespace Volume {
             The resource group where to search for the configuration file.
         */
         virtual void load(SceneNode *parent, SceneManager *sceneManager, const String& filename, bool validSourceResult = false, MeshBuilderCallback *lodCallback = 0, const String& resourceGroup = ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+
+        /** Regenerates the geometry of the chunks intersecting a region after the source
+        got modified there, for example via GridSource::combineWithSource.
+        @remarks
+            Must be called on the root chunk of a loaded tree. Only the chunks whose cube
+            intersects the region are remeshed, on all LOD levels. Each of them keeps showing
+            its old geometry until the new one is ready, then both are swapped at once. If
+            the tree got loaded with ChunkParameters::async, this returns immediately and
+            the work is done by the WorkQueue, else it waits for all chunks.
+        @param from
+            The back lower left corner of the modified region.
+        @param to
+            The front upper right corner of the modified region.
+        */
+        virtual void updateRegion(const Vector3 &from, const Vector3 &to);
+
+        /** Gets whether chunks of this tree are still being generated.
+        @return
+            true if a load or update is in progress.
+        */
+        virtual bool isProcessing(void) const;
         
         /** Shows the debug visualization entity of the dualgrid.
         @param visible
@@ -120,26 +120,181 @@ namespace Volume {
             The x coordinate of the point.
         */
         inline const Vector3 getGradient(size_t x, size_t y, size_t z) const
+        {
+            return sampleGradient(VirtualSampler(this), x, y, z);
+        }
+
+        /// Reads the grid through getVolumeGridValue.
+        struct VirtualSampler
+        {
+            const GridSource *mSrc;
+            explicit VirtualSampler(const GridSource *src) : mSrc(src) {}
+            float operator()(size_t x, size_t y, size_t z) const
+            {
+                return mSrc->getVolumeGridValue(x, y, z);
+            }
+        };
+
+        /** Gets a gradient of a point with optional sobel blurring, reading the grid
+        through a sampler.
+        @remarks
+            A sampler is called with the x, y and z coordinates of a grid point and
+            returns the density there, like getVolumeGridValue. Subclasses use one which
+            reads their data directly in getValues and getValuesAndGradients, so that the
+            grid is read without a virtual call per grid point.
+        @param sampler
+            The sampler.
+        @param x
+            The x coordinate of the point.
+        @param y
+            The x coordinate of the point.
+        @param z
+            The x coordinate of the point.
+        */
+        template<typename Sampler>
+        inline Vector3 sampleGradient(const Sampler &sampler, size_t x, size_t y, size_t z) const
         {
             if (mSobelGradient)
             {
                 // Calculate gradient like in the original MC paper but mix a bit of Sobel in
                 return Vector3(
-                (getVolumeGridValue(x + 1, y - 1, z) - getVolumeGridValue(x - 1, y - 1, z))
-                        + (Real)2.0 * (getVolumeGridValue(x + 1, y, z) - getVolumeGridValue(x - 1, y, z))
-                        + (getVolumeGridValue(x + 1, y + 1, z) - getVolumeGridValue(x - 1, y + 1, z)),
-                (getVolumeGridValue(x, y + 1, z - 1) - getVolumeGridValue(x, y - 1, z - 1))
-                    + (Real)2.0 * (getVolumeGridValue(x, y + 1, z) - getVolumeGridValue(x, y - 1, z))
-                    + (getVolumeGridValue(x, y + 1, z + 1) - getVolumeGridValue(x, y - 1, z + 1)),
-                (getVolumeGridValue(x - 1, y, z + 1) - getVolumeGridValue(x - 1, y, z - 1))
-                    + (Real)2.0 * (getVolumeGridValue(x, y, z + 1) - getVolumeGridValue(x, y, z - 1))
-                    + (getVolumeGridValue(x + 1, y, z + 1) - getVolumeGridValue(x + 1, y, z - 1))) / (Real)4.0;
+                (sampler(x + 1, y - 1, z) - sampler(x - 1, y - 1, z))
+                        + (Real)2.0 * (sampler(x + 1, y, z) - sampler(x - 1, y, z))
+                        + (sampler(x + 1, y + 1, z) - sampler(x - 1, y + 1, z)),
+                (sampler(x, y + 1, z - 1) - sampler(x, y - 1, z - 1))
+                    + (Real)2.0 * (sampler(x, y + 1, z) - sampler(x, y - 1, z))
+                    + (sampler(x, y + 1, z + 1) - sampler(x, y - 1, z + 1)),
+                (sampler(x - 1, y, z + 1) - sampler(x - 1, y, z - 1))
+                    + (Real)2.0 * (sampler(x, y, z + 1) - sampler(x, y, z - 1))
+                    + (sampler(x + 1, y, z + 1) - sampler(x + 1, y, z - 1))) / (Real)4.0;
             }
             // Calculate gradient like in the original MC paper
             return Vector3(
-                getVolumeGridValue(x + 1, y, z) - getVolumeGridValue(x - 1, y, z),
-                getVolumeGridValue(x, y + 1, z) - getVolumeGridValue(x, y - 1, z),
-                getVolumeGridValue(x, y, z + 1) - getVolumeGridValue(x, y, z - 1));
+                sampler(x + 1, y, z) - sampler(x - 1, y, z),
+                sampler(x, y + 1, z) - sampler(x, y - 1, z),
+                sampler(x, y, z + 1) - sampler(x, y, z - 1));
+        }
+
+        /** Gets the density at a position, reading the grid through a sampler.
+        @param sampler
+            The sampler, see sampleGradient.
+        @param position
+            The position.
+        @return
+            The density.
+        */
+        template<typename Sampler>
+        inline Real sampleValue(const Sampler &sampler, const Vector3 &position) const
+        {
+            Vector3 scaledPosition(position.x * mPosXScale, position.y * mPosYScale, position.z * mPosZScale);
+            Real value;
+            if (mTrilinearValue)
+            {
+                size_t x0 = (size_t)scaledPosition.x;
+                size_t x1 = (size_t)ceil(scaledPosition.x);
+                size_t y0 = (size_t)scaledPosition.y;
+                size_t y1 = (size_t)ceil(scaledPosition.y);
+                size_t z0 = (size_t)scaledPosition.z;
+                size_t z1 = (size_t)ceil(scaledPosition.z);
+
+                Real dX = scaledPosition.x - (Real)x0;
+                Real dY = scaledPosition.y - (Real)y0;
+                Real dZ = scaledPosition.z - (Real)z0;
+
+                Real f000 = sampler(x0, y0, z0);
+                Real f100 = sampler(x1, y0, z0);
+                Real f010 = sampler(x0, y1, z0);
+                Real f001 = sampler(x0, y0, z1);
+                Real f101 = sampler(x1, y0, z1);
+                Real f011 = sampler(x0, y1, z1);
+                Real f110 = sampler(x1, y1, z0);
+                Real f111 = sampler(x1, y1, z1);
+
+                Real oneMinX = (Real)1.0 - dX;
+                Real oneMinY = (Real)1.0 - dY;
+                Real oneMinZ = (Real)1.0 - dZ;
+                Real oneMinXoneMinY = oneMinX * oneMinY;
+                Real dXOneMinY = dX * oneMinY;
+
+                value = oneMinZ * (f000 * oneMinXoneMinY
+                    + f100 * dXOneMinY
+                    + f010 * oneMinX * dY)
+                    + dZ * (f001 * oneMinXoneMinY
+                    + f101 * dXOneMinY
+                    + f011 * oneMinX * dY)
+                    + dX * dY * (f110 * oneMinZ
+                    + f111 * dZ);
+        
+            }
+            else
+            {
+                // Nearest neighbour else
+                size_t x = (size_t)(scaledPosition.x + (Real)0.5);
+                size_t y = (size_t)(scaledPosition.y + (Real)0.5);
+                size_t z = (size_t)(scaledPosition.z + (Real)0.5);
+                value = (Real)sampler(x, y, z);
+            }
+            return value;
+        }
+
+        /** Gets the density and gradient at a position, reading the grid through a sampler.
+        @param sampler
+            The sampler, see sampleGradient.
+        @param position
+            The position.
+        @return
+            A vector with x, y, z containing the gradient and w containing the density.
+        */
+        template<typename Sampler>
+        inline Vector4 sampleValueAndGradient(const Sampler &sampler, const Vector3 &position) const
+        {
+            Vector3 scaledPosition(position.x * mPosXScale, position.y * mPosYScale, position.z * mPosZScale);
+            Vector3 gradient;
+            if (mTrilinearGradient)
+            {
+                size_t x0 = (size_t)scaledPosition.x;
+                size_t x1 = (size_t)ceil(scaledPosition.x);
+                size_t y0 = (size_t)scaledPosition.y;
+                size_t y1 = (size_t)ceil(scaledPosition.y);
+                size_t z0 = (size_t)scaledPosition.z;
+                size_t z1 = (size_t)ceil(scaledPosition.z);
+        
+                Real dX = scaledPosition.x - (Real)x0;
+                Real dY = scaledPosition.y - (Real)y0;
+                Real dZ = scaledPosition.z - (Real)z0;
+        
+                Vector3 f000 = sampleGradient(sampler, x0, y0, z0);
+                Vector3 f100 = sampleGradient(sampler, x1, y0, z0);
+                Vector3 f010 = sampleGradient(sampler, x0, y1, z0);
+                Vector3 f001 = sampleGradient(sampler, x0, y0, z1);
+                Vector3 f101 = sampleGradient(sampler, x1, y0, z1);
+                Vector3 f011 = sampleGradient(sampler, x0, y1, z1);
+                Vector3 f110 = sampleGradient(sampler, x1, y1, z0);
+                Vector3 f111 = sampleGradient(sampler, x1, y1, z1);
+
+                Real oneMinX = (Real)1.0 - dX;
+                Real oneMinY = (Real)1.0 - dY;
+                Real oneMinZ = (Real)1.0 - dZ;
+                Real oneMinXoneMinY = oneMinX * oneMinY;
+                Real dXOneMinY = dX * oneMinY;
+
+                gradient = oneMinZ * (f000 * oneMinXoneMinY
+                    + f100 * dXOneMinY
+                    + f010 * oneMinX * dY)
+                    + dZ * (f001 * oneMinXoneMinY
+                    + f101 * dXOneMinY
+                    + f011 * oneMinX * dY)
+                    + dX * dY * (f110 * oneMinZ
+                    + f111 * dZ);
+
+                gradient *= (Real)-1.0;
+            }
+            else
+            {
+                gradient = sampleGradient(sampler, (size_t)(scaledPosition.x + (Real)0.5), (size_t)(scaledPosition.y + (Real)0.5), (size_t)(scaledPosition.z + (Real)0.5));
+                gradient *= (Real)-1.0;
+            }
+            return Vector4(gradient.x, gradient.y, gradient.z, sampleValue(sampler, position));
         }
 
     public:
@@ -158,6 +313,14 @@ namespace Volume {
         */
         virtual Real getValue(const Vector3 &position) const;
 
+        /** Overridden from VolumeSource.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Overridden from VolumeSource.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
+
         /** Gets the width of the texture.
         @return
             The width of the texture.
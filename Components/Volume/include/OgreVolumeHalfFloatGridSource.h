@@ -56,6 +56,9 @@ namespace Volume {
         /// influencing the compression rate on serialization.
         Real mMaxClampedAbsoluteDensity;
         
+        /// Reads the grid without a virtual call, see GridSource::sampleGradient.
+        struct Sampler;
+
         /** Overridden from GridSource.
         */
         virtual float getVolumeGridValue(size_t x, size_t y, size_t z) const;
@@ -92,6 +95,14 @@ namespace Volume {
         */
         Real getMaxClampedAbsoluteDensity(void) const;
 
+        /** Overridden from VolumeSource.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Overridden from VolumeSource.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
+
         /** Destructor.
         */
         ~HalfFloatGridSource(void);
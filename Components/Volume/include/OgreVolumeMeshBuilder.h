@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreManualObject.h"
 #include "OgreVector3.h"
 #include "OgreAxisAlignedBox.h"
+#include "OgreStreamSerialiser.h"
 #include "OgreVolumePrerequisites.h"
 
 namespace Ogre {
@@ -138,6 +139,10 @@ namespace Volume {
         /// The buffer binding.
         static const unsigned short MAIN_BINDING;
 
+        /// The chunk ID and version of the serialised mesh data.
+        static const uint32 CHUNK_ID;
+        static const uint16 CHUNK_VERSION;
+
         /// Map to get a vertex index.
         typedef map<Vertex, size_t>::type UMapVertexIndex;
         UMapVertexIndex mIndexMap;
@@ -340,6 +345,20 @@ namespace Volume {
         */
         void executeCallback(MeshBuilderCallback *callback, const SimpleRenderable *simpleRenderable, size_t level, int inProcess) const;
 
+        /** Writes the vertices, indices and bounding box to a stream.
+        @param stream
+            The stream to write to.
+        */
+        void save(StreamSerialiser &stream) const;
+
+        /** Replaces the content of this instance with data written by save.
+        @param stream
+            The stream to read from.
+        @return
+            false if the stream doesn't hold mesh data of a supported version.
+        */
+        bool load(StreamSerialiser &stream);
+
     };
     /** @} */
     /** @} */
@@ -101,6 +101,32 @@ namespace Volume {
         */
         virtual Real getValue(const Vector3 &position) const = 0;
 
+        /** Gets the density values at several positions at once.
+        @remarks
+            The default implementation calls getValue for every position. Sources
+            override it to evaluate the whole array without a virtual call per
+            position; operations on other sources pass the array on to them.
+        @param positions
+            The positions.
+        @param count
+            The amount of positions.
+        @param values
+            Receives the density of each position.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Gets the density values and gradients at several positions at once.
+        @param positions
+            The positions.
+        @param count
+            The amount of positions.
+        @param values
+            Receives a vector for each position with x, y, z containing the gradient and w
+            containing the density.
+        @see getValues
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
+
         /** Serializes a volume source to a discrete grid file with deflated
         compression. To achieve better compression, all density values are clamped
         within a maximum absolute value of (to - from).length() / 16.0. The values
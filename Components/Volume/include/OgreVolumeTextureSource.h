@@ -51,6 +51,9 @@ namespace Volume {
         /// The raw volume data.
         float *mData;
         
+        /// Reads the grid without a virtual call, see GridSource::sampleGradient.
+        struct Sampler;
+
         /** Overridden from GridSource.
         */
         virtual float getVolumeGridValue(size_t x, size_t y, size_t z) const;
@@ -79,6 +82,14 @@ namespace Volume {
         */
         explicit TextureSource(const String &volumeTextureName, const Real worldWidth, const Real worldHeight, const Real worldDepth, const bool trilinearValue = true, const bool trilinearGradient = false, const bool sobelGradient = false);
         
+        /** Overridden from VolumeSource.
+        */
+        virtual void getValues(const Vector3 *positions, size_t count, Real *values) const;
+
+        /** Overridden from VolumeSource.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const;
+
         /** Destructor.
         */
         ~TextureSource(void);
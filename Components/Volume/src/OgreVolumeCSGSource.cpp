@@ -30,6 +30,9 @@ THE SOFTWARE.
 namespace Ogre {
 namespace Volume {
 
+    /// The amount of positions combined operations evaluate at once.
+    static const size_t BATCH_SIZE = 64;
+
     Vector3 CSGCubeSource::mBoxNormals[6] = {
         Vector3::UNIT_X,
         Vector3::UNIT_Y,
@@ -69,6 +72,26 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGSphereSource::getValues(const Vector3 *positions, size_t count, Real *values) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = CSGSphereSource::getValue(positions[i]);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGSphereSource::getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = CSGSphereSource::getValueAndGradient(positions[i]);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGPlaneSource::CSGPlaneSource(const Real d, const Vector3 &normal) : mD(d), mNormal(normal.normalisedCopy())
     {
     }
@@ -96,6 +119,26 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGPlaneSource::getValues(const Vector3 *positions, size_t count, Real *values) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = CSGPlaneSource::getValue(positions[i]);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGPlaneSource::getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = CSGPlaneSource::getValueAndGradient(positions[i]);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGCubeSource::CSGCubeSource(const Vector3 &min, const Vector3 &max)
     {
         mBox.setExtents(min, max);
@@ -106,9 +149,9 @@ namespace Volume {
     Vector4 CSGCubeSource::getValueAndGradient(const Vector3 &position) const
     { 
         // Just approximate the normal via a simple Prewitt. To get the real normal, 26 cases had to be evaluated...
-        Vector3 gradient(getValue(Vector3(position.x + (Real)1.0, position.y, position.z)) - getValue(Vector3(position.x - (Real)1.0, position.y, position.z)),
-            getValue(Vector3(position.x, position.y + (Real)1.0, position.z)) - getValue(Vector3(position.x, position.y - (Real)1.0, position.z)),
-            getValue(Vector3(position.x, position.y, position.z + (Real)1.0)) - getValue(Vector3(position.x, position.y, position.z - (Real)1.0)));
+        Vector3 gradient(distanceTo(Vector3(position.x + (Real)1.0, position.y, position.z)) - distanceTo(Vector3(position.x - (Real)1.0, position.y, position.z)),
+            distanceTo(Vector3(position.x, position.y + (Real)1.0, position.z)) - distanceTo(Vector3(position.x, position.y - (Real)1.0, position.z)),
+            distanceTo(Vector3(position.x, position.y, position.z + (Real)1.0)) - distanceTo(Vector3(position.x, position.y, position.z - (Real)1.0)));
         gradient.normalise();
         gradient *= (Real)-1.0;
         return Vector4(
@@ -127,6 +170,26 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGCubeSource::getValues(const Vector3 *positions, size_t count, Real *values) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = CSGCubeSource::getValue(positions[i]);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGCubeSource::getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = CSGCubeSource::getValueAndGradient(positions[i]);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGOperationSource::CSGOperationSource(const Source *a, const Source *b) : mA(a), mB(b)
     {
     }
@@ -205,6 +268,48 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGIntersectionSource::getValues(const Vector3 *positions, size_t count, Real *values) const
+    {
+        Real valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t num = std::min(count - start, BATCH_SIZE);
+            Real *valuesA = values + start;
+            mA->getValues(positions + start, num, valuesA);
+            mB->getValues(positions + start, num, valuesB);
+            for (size_t i = 0; i < num; ++i)
+            {
+                if (valuesB[i] <= valuesA[i])
+                {
+                    valuesA[i] = valuesB[i];
+                }
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGIntersectionSource::getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const
+    {
+        Vector4 valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t num = std::min(count - start, BATCH_SIZE);
+            Vector4 *valuesA = values + start;
+            mA->getValuesAndGradients(positions + start, num, valuesA);
+            mB->getValuesAndGradients(positions + start, num, valuesB);
+            for (size_t i = 0; i < num; ++i)
+            {
+                if (valuesB[i].w <= valuesA[i].w)
+                {
+                    valuesA[i] = valuesB[i];
+                }
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGUnionSource::CSGUnionSource(const Source *a, const Source *b) : CSGOperationSource(a, b)
     {
     }
@@ -243,6 +348,48 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGUnionSource::getValues(const Vector3 *positions, size_t count, Real *values) const
+    {
+        Real valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t num = std::min(count - start, BATCH_SIZE);
+            Real *valuesA = values + start;
+            mA->getValues(positions + start, num, valuesA);
+            mB->getValues(positions + start, num, valuesB);
+            for (size_t i = 0; i < num; ++i)
+            {
+                if (valuesB[i] >= valuesA[i])
+                {
+                    valuesA[i] = valuesB[i];
+                }
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGUnionSource::getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const
+    {
+        Vector4 valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t num = std::min(count - start, BATCH_SIZE);
+            Vector4 *valuesA = values + start;
+            mA->getValuesAndGradients(positions + start, num, valuesA);
+            mB->getValuesAndGradients(positions + start, num, valuesB);
+            for (size_t i = 0; i < num; ++i)
+            {
+                if (valuesB[i].w >= valuesA[i].w)
+                {
+                    valuesA[i] = valuesB[i];
+                }
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGDifferenceSource::CSGDifferenceSource(const Source *a, const Source *b) : CSGOperationSource(a, b)
     {
     }
@@ -281,6 +428,50 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGDifferenceSource::getValues(const Vector3 *positions, size_t count, Real *values) const
+    {
+        Real valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t num = std::min(count - start, BATCH_SIZE);
+            Real *valuesA = values + start;
+            mA->getValues(positions + start, num, valuesA);
+            mB->getValues(positions + start, num, valuesB);
+            for (size_t i = 0; i < num; ++i)
+            {
+                Real valueB = (Real)-1.0 * valuesB[i];
+                if (valueB <= valuesA[i])
+                {
+                    valuesA[i] = valueB;
+                }
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGDifferenceSource::getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const
+    {
+        Vector4 valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t num = std::min(count - start, BATCH_SIZE);
+            Vector4 *valuesA = values + start;
+            mA->getValuesAndGradients(positions + start, num, valuesA);
+            mB->getValuesAndGradients(positions + start, num, valuesB);
+            for (size_t i = 0; i < num; ++i)
+            {
+                Vector4 valueB = (Real)-1.0 * valuesB[i];
+                if (valueB.w <= valuesA[i].w)
+                {
+                    valuesA[i] = valueB;
+                }
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGUnarySource::CSGUnarySource(const Source *src) : mSrc(src)
     {
     }
@@ -333,6 +524,28 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGNegateSource::getValues(const Vector3 *positions, size_t count, Real *values) const
+    {
+        mSrc->getValues(positions, count, values);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = (Real)-1.0 * values[i];
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGNegateSource::getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const
+    {
+        mSrc->getValuesAndGradients(positions, count, values);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = (Real)-1.0 * values[i];
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGScaleSource::CSGScaleSource(const Source *src, const Real scale) : CSGUnarySource(src), mScale(scale)
     {
     }
@@ -353,6 +566,46 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGScaleSource::getValues(const Vector3 *positions, size_t count, Real *values) const
+    {
+        Vector3 scaled[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t num = std::min(count - start, BATCH_SIZE);
+            for (size_t i = 0; i < num; ++i)
+            {
+                scaled[i] = positions[start + i] / mScale;
+            }
+            mSrc->getValues(scaled, num, values + start);
+            for (size_t i = 0; i < num; ++i)
+            {
+                values[start + i] *= mScale;
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGScaleSource::getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const
+    {
+        Vector3 scaled[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t num = std::min(count - start, BATCH_SIZE);
+            for (size_t i = 0; i < num; ++i)
+            {
+                scaled[i] = positions[start + i] / mScale;
+            }
+            mSrc->getValuesAndGradients(scaled, num, values + start);
+            for (size_t i = 0; i < num; ++i)
+            {
+                values[start + i] *= mScale;
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     void CSGNoiseSource::setData(void)
     {
         mGradientOff = fabs(mFrequencies[0]);
@@ -403,6 +656,57 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGNoiseSource::getValues(const Vector3 *positions, size_t count, Real *values) const
+    {
+        mSrc->getValues(positions, count, values);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] += getNoise(positions[i]);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGNoiseSource::getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const
+    {
+        // The gradient is a central difference, so each position needs seven samples
+        Vector3 samplePositions[BATCH_SIZE * 7];
+        Real sampleValues[BATCH_SIZE * 7];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            size_t num = std::min(count - start, BATCH_SIZE);
+            for (size_t i = 0; i < num; ++i)
+            {
+                const Vector3 &position = positions[start + i];
+                Vector3 *samples = samplePositions + i * 7;
+                samples[0] = Vector3(position.x + mGradientOff, position.y, position.z);
+                samples[1] = Vector3(position.x - mGradientOff, position.y, position.z);
+                samples[2] = Vector3(position.x, position.y + mGradientOff, position.z);
+                samples[3] = Vector3(position.x, position.y - mGradientOff, position.z);
+                samples[4] = Vector3(position.x, position.y, position.z + mGradientOff);
+                samples[5] = Vector3(position.x, position.y, position.z - mGradientOff);
+                samples[6] = position;
+            }
+            mSrc->getValues(samplePositions, num * 7, sampleValues);
+            for (size_t i = 0; i < num; ++i)
+            {
+                const Vector3 *samples = samplePositions + i * 7;
+                Real *sampled = sampleValues + i * 7;
+                for (size_t j = 0; j < 7; ++j)
+                {
+                    sampled[j] += getNoise(samples[j]);
+                }
+                values[start + i] = Vector4(
+                    -(sampled[0] - sampled[1]),
+                    -(sampled[2] - sampled[3]),
+                    -(sampled[4] - sampled[5]),
+                    sampled[6]);
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     long CSGNoiseSource::getSeed(void) const
     {
         return mSeed;
@@ -38,8 +38,12 @@ namespace Volume {
 
     //-----------------------------------------------------------------------
 
-    CacheSource::CacheSource(const Source *src) : mSrc(src)
+    CacheSource::CacheSource(const Source *src, size_t maxEntries) : mEntriesPerShard(1), mSrc(src)
     {
+        while (mEntriesPerShard * NUM_SHARDS < maxEntries)
+        {
+            mEntriesPerShard <<= 1;
+        }
     }
     
     //-----------------------------------------------------------------------
@@ -55,6 +59,34 @@ namespace Volume {
     {
         return getFromCache(position).w;
     }
+    
+    //-----------------------------------------------------------------------
+
+    void CacheSource::clear(void)
+    {
+        for (size_t i = 0; i < NUM_SHARDS; ++i)
+        {
+            OGRE_WQ_LOCK_MUTEX(mShards[i].mutex);
+            EntryList &entries = mShards[i].entries;
+            for (EntryList::iterator it = entries.begin(); it != entries.end(); ++it)
+            {
+                it->valid = false;
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    size_t CacheSource::getAllocatedEntries(void) const
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < NUM_SHARDS; ++i)
+        {
+            OGRE_WQ_LOCK_MUTEX(mShards[i].mutex);
+            count += mShards[i].entries.size();
+        }
+        return count;
+    }
 
 }
 }
\ No newline at end of file
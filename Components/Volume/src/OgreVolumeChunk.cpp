@@ -42,6 +42,7 @@ THE SOFTWARE.
 #include "OgreVolumeMeshBuilder.h"
 #include "OgreVolumeOctreeNode.h"
 #include "OgreMaterialManager.h"
+#include "OgreStreamSerialiser.h"
 
 namespace Ogre {
 namespace Volume {
@@ -150,7 +151,8 @@ namespace Volume {
     {
 
         // Handle the situation where we update an existing tree
-        if (mShared->parameters->updateFrom != Vector3::ZERO || mShared->parameters->updateTo != Vector3::ZERO)
+        bool isUpdate = mShared->parameters->updateFrom != Vector3::ZERO || mShared->parameters->updateTo != Vector3::ZERO;
+        if (isUpdate)
         {
             // Early out if an update of a part of the tree volume is going on and this chunk is outside of the area.
             AxisAlignedBox chunkCube(from, to);
@@ -159,26 +161,25 @@ namespace Volume {
             {
                 return;
             }
-            // Free memory from old mesh version
-            if (mRenderOp.vertexData)
-            {
-                OGRE_DELETE mRenderOp.vertexData;
-                mRenderOp.vertexData = 0;
-            }
-            if (mRenderOp.indexData)
-            {
-                OGRE_DELETE mRenderOp.indexData;
-                mRenderOp.indexData = 0;
-            }
+            // The old mesh stays visible until loadGeometry swaps in the new one.
+        }
+        else
+        {
+            // Set to invisible for now.
+            mVisible = false;
+            mInvisible = true;
         }
-
-        // Set to invisible for now.
-        mVisible = false;
-        mInvisible = true;
         
         // Don't generate this chunk if it doesn't contribute to the whole volume.
         if (!contributesToVolumeMesh(from, to))
         {
+            if (isUpdate)
+            {
+                // Everything got removed here, so drop the old mesh.
+                setGeometry(0, 0);
+                mVisible = false;
+                mInvisible = true;
+            }
             return;
         }
     
@@ -204,9 +205,95 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void Chunk::setGeometry(VertexData *vertexData, IndexData *indexData)
+    {
+        OGRE_DELETE mRenderOp.vertexData;
+        OGRE_DELETE mRenderOp.indexData;
+        mRenderOp.vertexData = vertexData;
+        mRenderOp.indexData = indexData;
+        if (!vertexData && mNode && isAttached())
+        {
+            mNode->detachObject(this);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    String Chunk::getMeshCacheFile(size_t level, const OctreeNode *root, const Vector3 &totalFrom, const Vector3 &totalTo) const
+    {
+        const ChunkParameters *parameters = mShared->parameters;
+        // The visualizations need the octree and dualgrid which aren't cached.
+        if (parameters->meshCachePath.empty() || parameters->createDualGridVisualization || parameters->createOctreeVisualization)
+        {
+            return BLANKSTRING;
+        }
+
+        uint32 hash = HashCombine(0, parameters->sourceHash);
+        hash = HashCombine(hash, root->getFrom());
+        hash = HashCombine(hash, root->getTo());
+        hash = HashCombine(hash, totalFrom);
+        hash = HashCombine(hash, totalTo);
+        hash = HashCombine(hash, static_cast<uint32>(level));
+        hash = HashCombine(hash, parameters->baseError);
+        hash = HashCombine(hash, parameters->errorMultiplicator);
+        hash = HashCombine(hash, parameters->skirtFactor);
+
+        String path = parameters->meshCachePath;
+        if (path[path.size() - 1] != '/' && path[path.size() - 1] != '\\')
+        {
+            path += "/";
+        }
+        return path + StringConverter::toString(hash, 8, '0', std::ios::hex) + ".volumemesh";
+    }
+    
+    //-----------------------------------------------------------------------
+
+    bool Chunk::loadFromMeshCache(size_t level, MeshBuilder *meshBuilder, const String &filename)
+    {
+        try
+        {
+            DataStreamPtr stream = Root::getSingleton().openFileStream(filename);
+            StreamSerialiser ser(stream);
+            if (!meshBuilder->load(ser))
+            {
+                return false;
+            }
+        }
+        catch (Exception &)
+        {
+            // Not cached yet or unreadable, generate it.
+            return false;
+        }
+        mError = (Real)level * mShared->parameters->errorMultiplicator * mShared->parameters->baseError;
+        return true;
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void Chunk::saveToMeshCache(const MeshBuilder *meshBuilder, const String &filename) const
+    {
+        try
+        {
+            DataStreamPtr stream = Root::getSingleton().createFileStream(filename, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+            StreamSerialiser ser(stream);
+            meshBuilder->save(ser);
+        }
+        catch (Exception &e)
+        {
+            // The cache is only an optimization.
+            LogManager::getSingleton().logMessage("Volume mesh cache: " + e.getDescription());
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     void Chunk::loadGeometry(MeshBuilder *meshBuilder, DualGridGenerator *dualGridGenerator, OctreeNode *root, size_t level, bool isUpdate)
     {
-        size_t chunkTriangles = meshBuilder->generateBuffers(mRenderOp);
+        // Build the new buffers aside and swap them in at once, so an updated chunk never shows a partial mesh.
+        RenderOperation newOp;
+        size_t chunkTriangles = meshBuilder->generateBuffers(newOp);
+        mRenderOp.operationType = newOp.operationType;
+        setGeometry(newOp.vertexData, newOp.indexData);
         mInvisible = chunkTriangles == 0;
 
         if (mShared->parameters->lodCallback)
@@ -216,16 +303,30 @@ namespace Volume {
 
         mBox = meshBuilder->getBoundingBox();
 
-        if (!mInvisible)
+        if (!mInvisible && !isAttached())
         {
-            if (isUpdate)
-            {
-                mNode->detachObject(this);
-            }
             mNode->attachObject(this);
         }
 
-        mVisible = false;
+        if (!isUpdate)
+        {
+            mVisible = false;
+        }
+
+        if (isUpdate)
+        {
+            // Replace the debug visualizations of the old mesh.
+            if (mDualGrid)
+            {
+                mShared->parameters->sceneManager->destroyEntity(mDualGrid);
+                mDualGrid = 0;
+            }
+            if (mOctree)
+            {
+                mShared->parameters->sceneManager->destroyEntity(mOctree);
+                mOctree = 0;
+            }
+        }
 
         if (mShared->parameters->createDualGridVisualization)
         {
@@ -326,6 +427,10 @@ namespace Volume {
         if (parameters->updateFrom == Vector3::ZERO && parameters->updateTo == Vector3::ZERO)
         {
             mShared = new ChunkTreeSharedData(parameters);
+            mShared->parent = parent;
+            mShared->totalFrom = from;
+            mShared->totalTo = to;
+            mShared->maxLevels = level;
             parent->scale(Vector3(parameters->scale));
         }
 
@@ -413,6 +518,46 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void Chunk::updateRegion(const Vector3 &from, const Vector3 &to)
+    {
+        if (!isRoot || !mShared || !mShared->parent)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+                "Only the root of a loaded chunk tree can be updated!",
+                __FUNCTION__);
+        }
+
+        ChunkParameters *parameters = mShared->parameters;
+        Vector3 oldUpdateFrom = parameters->updateFrom;
+        Vector3 oldUpdateTo = parameters->updateTo;
+        parameters->updateFrom = from;
+        parameters->updateTo = to;
+
+        doLoad(mShared->parent, mShared->totalFrom, mShared->totalTo, mShared->totalFrom, mShared->totalTo, mShared->maxLevels, mShared->maxLevels);
+
+        parameters->updateFrom = oldUpdateFrom;
+        parameters->updateTo = oldUpdateTo;
+
+        // Wait for the threads.
+        if (!parameters->async)
+        {
+            while(mShared->chunksBeingProcessed)
+            {
+                OGRE_THREAD_SLEEP(0);
+                mChunkHandler.processWorkQueue();
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    bool Chunk::isProcessing(void) const
+    {
+        return mShared && mShared->chunksBeingProcessed > 0;
+    }
+    
+    //-----------------------------------------------------------------------
+
     void Chunk::setDualGridVisible(const bool visible)
     {
         mShared->dualGridVisible = visible;
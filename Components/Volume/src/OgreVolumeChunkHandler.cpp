@@ -88,7 +88,16 @@ namespace Volume {
     WorkQueue::Response* ChunkHandler::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
     {
         ChunkRequest cReq = any_cast<ChunkRequest>(req->getData());
-        cReq.origin->prepareGeometry(cReq.level, cReq.root, cReq.dualGridGenerator, cReq.meshBuilder, cReq.totalFrom, cReq.totalTo);
+        // Updates come from a modified source, so they never use the cache.
+        String cacheFile = cReq.isUpdate ? BLANKSTRING : cReq.origin->getMeshCacheFile(cReq.level, cReq.root, cReq.totalFrom, cReq.totalTo);
+        if (cacheFile.empty() || !cReq.origin->loadFromMeshCache(cReq.level, cReq.meshBuilder, cacheFile))
+        {
+            cReq.origin->prepareGeometry(cReq.level, cReq.root, cReq.dualGridGenerator, cReq.meshBuilder, cReq.totalFrom, cReq.totalTo);
+            if (!cacheFile.empty())
+            {
+                cReq.origin->saveToMeshCache(cReq.meshBuilder, cacheFile);
+            }
+        }
         return OGRE_NEW WorkQueue::Response(req, true, Any());
     }
     
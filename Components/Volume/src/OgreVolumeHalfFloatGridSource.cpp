@@ -36,12 +36,46 @@ THE SOFTWARE.
 namespace Ogre {
 namespace Volume {
 
+    struct HalfFloatGridSource::Sampler
+    {
+        const HalfFloatGridSource *mSrc;
+        explicit Sampler(const HalfFloatGridSource *src) : mSrc(src) {}
+        inline float operator()(size_t x, size_t y, size_t z) const
+        {
+            x = x >= mSrc->mWidth ? mSrc->mWidth - 1 : x;
+            y = y >= mSrc->mHeight ? mSrc->mHeight - 1 : y;
+            z = z >= mSrc->mDepth ? mSrc->mDepth - 1 : z;
+            return Bitwise::halfToFloat(mSrc->mData[(mSrc->mDepth - z - 1) * mSrc->mDepthTimesHeight + x * mSrc->mHeight + y]);
+        }
+    };
+
+    //-----------------------------------------------------------------------
+
     float HalfFloatGridSource::getVolumeGridValue(size_t x, size_t y, size_t z) const
     {
-        x = x >= mWidth ? mWidth - 1 : x;
-        y = y >= mHeight ? mHeight - 1 : y;
-        z = z >= mDepth ? mDepth - 1 : z;
-        return Bitwise::halfToFloat(mData[(mDepth - z - 1) * mDepthTimesHeight + x * mHeight + y]);
+        return Sampler(this)(x, y, z);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void HalfFloatGridSource::getValues(const Vector3 *positions, size_t count, Real *values) const
+    {
+        Sampler sampler(this);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = sampleValue(sampler, positions[i]);
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void HalfFloatGridSource::getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const
+    {
+        Sampler sampler(this);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = sampleValueAndGradient(sampler, positions[i]);
+        }
     }
 
     //-----------------------------------------------------------------------
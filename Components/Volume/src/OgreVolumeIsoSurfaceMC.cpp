@@ -47,19 +47,28 @@ namespace Volume {
         Vector4 values[8];
 
         // Find out the case.
-        for (size_t i = 0; i < 8; ++i)
+        if (volumeValues)
         {
-            if (volumeValues)
+            for (size_t i = 0; i < 8; ++i)
             {
                 values[i] = volumeValues[i];
+                if (values[i].w >= ISO_LEVEL)
+                {
+                    cubeIndex |= 1 << i;
+                }
             }
-            else
-            {
-                values[i] = mSrc->getValueAndGradient(corners[i]);
-            }
-            if (values[i].w >= ISO_LEVEL)
+        }
+        else
+        {
+            // Classify with the densities alone, most cells don't intersect the surface and never need the gradients.
+            Real densities[8];
+            mSrc->getValues(corners, 8, densities);
+            for (size_t i = 0; i < 8; ++i)
             {
-                cubeIndex |= 1 << i;
+                if (densities[i] >= ISO_LEVEL)
+                {
+                    cubeIndex |= 1 << i;
+                }
             }
         }
 
@@ -71,6 +80,11 @@ namespace Volume {
             return;
         }
 
+        if (!volumeValues)
+        {
+            mSrc->getValuesAndGradients(corners, 8, values);
+        }
+
         // Find the intersection vertices.
         Vector3 intersectionPoints[12];
         Vector3 intersectionNormals[12];
@@ -56,6 +56,8 @@ namespace Volume {
     //-----------------------------------------------------------------------
 
     const unsigned short MeshBuilder::MAIN_BINDING = 0;
+    const uint32 MeshBuilder::CHUNK_ID = StreamSerialiser::makeIdentifier("VMSH");
+    const uint16 MeshBuilder::CHUNK_VERSION = 1;
     
     //-----------------------------------------------------------------------
 
@@ -197,6 +199,66 @@ namespace Volume {
     {
         callback->ready(simpleRenderable, mVertices, mIndices, level, inProcess);
     }
+    
+    //-----------------------------------------------------------------------
+
+    void MeshBuilder::save(StreamSerialiser &stream) const
+    {
+        stream.writeChunkBegin(CHUNK_ID, CHUNK_VERSION);
+
+        uint32 vertexCount = static_cast<uint32>(mVertices.size());
+        stream.write(&vertexCount);
+        if (vertexCount)
+        {
+            stream.write(&mVertices[0].x, vertexCount * 6);
+        }
+
+        uint32 indexCount = static_cast<uint32>(mIndices.size());
+        stream.write(&indexCount);
+        vector<uint32>::type indices(mIndices.begin(), mIndices.end());
+        if (indexCount)
+        {
+            stream.write(&indices[0], indexCount);
+        }
+
+        stream.write(&mBox);
+        stream.writeChunkEnd(CHUNK_ID);
+    }
+    
+    //-----------------------------------------------------------------------
+
+    bool MeshBuilder::load(StreamSerialiser &stream)
+    {
+        const StreamSerialiser::Chunk *chunk = stream.readChunkBegin();
+        if (!chunk || chunk->id != CHUNK_ID || chunk->version > CHUNK_VERSION)
+        {
+            return false;
+        }
+
+        mIndexMap.clear();
+
+        uint32 vertexCount;
+        stream.read(&vertexCount);
+        mVertices.resize(vertexCount);
+        if (vertexCount)
+        {
+            stream.read(&mVertices[0].x, vertexCount * 6);
+        }
+
+        uint32 indexCount;
+        stream.read(&indexCount);
+        vector<uint32>::type indices(indexCount);
+        if (indexCount)
+        {
+            stream.read(&indices[0], indexCount);
+        }
+        mIndices.assign(indices.begin(), indices.end());
+
+        stream.read(&mBox);
+        mBoxInit = vertexCount > 0;
+        stream.readChunkEnd(CHUNK_ID);
+        return true;
+    }
 
 }
 }
@@ -35,14 +35,48 @@ THE SOFTWARE.
 namespace Ogre {
 namespace Volume {
 
+    struct TextureSource::Sampler
+    {
+        const TextureSource *mSrc;
+        explicit Sampler(const TextureSource *src) : mSrc(src) {}
+        inline float operator()(size_t x, size_t y, size_t z) const
+        {
+            x = x >= mSrc->mWidth ? mSrc->mWidth - 1 : x;
+            y = y >= mSrc->mHeight ? mSrc->mHeight - 1 : y;
+            z = z >= mSrc->mDepth ? mSrc->mDepth - 1 : z;
+            return mSrc->mData[(mSrc->mDepth - z - 1) * mSrc->mWidthTimesHeight + y * mSrc->mWidth + x];
+        }
+    };
+
+    //-----------------------------------------------------------------------
+
     float TextureSource::getVolumeGridValue(size_t x, size_t y, size_t z) const
     {
-        x = x >= mWidth ? mWidth - 1 : x;
-        y = y >= mHeight ? mHeight - 1 : y;
-        z = z >= mDepth ? mDepth - 1 : z;
-        return mData[(mDepth - z - 1) * mWidthTimesHeight + y * mWidth + x];
+        return Sampler(this)(x, y, z);
     }
-    
+
+    //-----------------------------------------------------------------------
+
+    void TextureSource::getValues(const Vector3 *positions, size_t count, Real *values) const
+    {
+        Sampler sampler(this);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = sampleValue(sampler, positions[i]);
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void TextureSource::getValuesAndGradients(const Vector3 *positions, size_t count, Vector4 *values) const
+    {
+        Sampler sampler(this);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = sampleValueAndGradient(sampler, positions[i]);
+        }
+    }
+
     //-----------------------------------------------------------------------
 
     void TextureSource::setVolumeGridValue(int x, int y, int z, float value)
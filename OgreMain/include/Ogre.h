@@ -100,6 +100,7 @@ THE SOFTWARE.
 #include "OgreRenderTexture.h"
 #include "OgreRenderWindow.h"
 #include "OgreResourceBackgroundQueue.h"
+#include "OgreResourceStreamingQueue.h"
 #include "OgreResourceGroupManager.h"
 #include "OgreRibbonTrail.h"
 #include "OgreRoot.h"
@@ -118,6 +118,148 @@ JNIEnv* OgreJNIGetEnv() {
 %ignore *::getType;
 #endif
 
+#ifdef SWIGPYTHON
+// batch access from python. Any object supporting the buffer protocol, e.g. a
+// numpy array of float32 or float64, can be passed where a PyObject* is taken
+%{
+namespace {
+    /* A contiguous python buffer of Reals, stored as float or double */
+    class RealBuffer
+    {
+    public:
+        RealBuffer(PyObject* obj, size_t count, bool writable) : mValid(false)
+        {
+            int flags = PyBUF_FORMAT | PyBUF_C_CONTIGUOUS;
+            if (writable)
+                flags |= PyBUF_WRITABLE;
+            if (PyObject_GetBuffer(obj, &mView, flags) != 0)
+            {
+                PyErr_Clear();
+                OGRE_EXCEPT(Ogre::Exception::ERR_INVALIDPARAMS,
+                            writable ? "expected a writable contiguous buffer" : "expected a contiguous buffer",
+                            "RealBuffer");
+            }
+            mValid = true;
+
+            const char type = mView.format ? mView.format[strlen(mView.format) - 1] : 'B';
+            if (!(type == 'f' && mView.itemsize == sizeof(float)) &&
+                !(type == 'd' && mView.itemsize == sizeof(double)))
+                OGRE_EXCEPT(Ogre::Exception::ERR_INVALIDPARAMS, "expected a buffer of float32 or float64",
+                            "RealBuffer");
+            if (size_t(mView.len) < count * mView.itemsize)
+                OGRE_EXCEPT(Ogre::Exception::ERR_INVALIDPARAMS, "buffer is too small", "RealBuffer");
+        }
+        ~RealBuffer()
+        {
+            if (mValid)
+                PyBuffer_Release(&mView);
+        }
+
+        Ogre::Real get(size_t i) const
+        {
+            if (mView.itemsize == sizeof(float))
+                return Ogre::Real(static_cast<const float*>(mView.buf)[i]);
+            return Ogre::Real(static_cast<const double*>(mView.buf)[i]);
+        }
+        void set(size_t i, Ogre::Real value)
+        {
+            if (mView.itemsize == sizeof(float))
+                static_cast<float*>(mView.buf)[i] = float(value);
+            else
+                static_cast<double*>(mView.buf)[i] = double(value);
+        }
+    private:
+        Py_buffer mView;
+        bool mValid;
+    };
+
+    /* Memoryview of memory owned by Ogre. It does not keep the owner alive */
+    PyObject* createMemoryView(void* data, size_t size, bool writable)
+    {
+#if PY_MAJOR_VERSION >= 3
+        return PyMemoryView_FromMemory(static_cast<char*>(data), size, writable ? PyBUF_WRITE : PyBUF_READ);
+#else
+        return writable ? PyBuffer_FromReadWriteMemory(data, size) : PyBuffer_FromMemory(data, size);
+#endif
+    }
+
+    /* Batch transform setters and getters for Node and InstancedEntity */
+    template <class T>
+    void setPositions(const std::vector<T*>& objs, PyObject* positions)
+    {
+        RealBuffer buf(positions, objs.size() * 3, false);
+        for (size_t i = 0; i < objs.size(); ++i)
+            objs[i]->setPosition(Ogre::Vector3(buf.get(i * 3), buf.get(i * 3 + 1), buf.get(i * 3 + 2)));
+    }
+    template <class T>
+    void setScales(const std::vector<T*>& objs, PyObject* scales)
+    {
+        RealBuffer buf(scales, objs.size() * 3, false);
+        for (size_t i = 0; i < objs.size(); ++i)
+            objs[i]->setScale(Ogre::Vector3(buf.get(i * 3), buf.get(i * 3 + 1), buf.get(i * 3 + 2)));
+    }
+    template <class T>
+    void setOrientations(const std::vector<T*>& objs, PyObject* orientations)
+    {
+        RealBuffer buf(orientations, objs.size() * 4, false);
+        for (size_t i = 0; i < objs.size(); ++i)
+            objs[i]->setOrientation(Ogre::Quaternion(buf.get(i * 4), buf.get(i * 4 + 1),
+                                                     buf.get(i * 4 + 2), buf.get(i * 4 + 3)));
+    }
+    template <class T>
+    void getPositions(const std::vector<T*>& objs, PyObject* positions)
+    {
+        RealBuffer buf(positions, objs.size() * 3, true);
+        for (size_t i = 0; i < objs.size(); ++i)
+        {
+            const Ogre::Vector3& v = objs[i]->getPosition();
+            buf.set(i * 3, v.x);
+            buf.set(i * 3 + 1, v.y);
+            buf.set(i * 3 + 2, v.z);
+        }
+    }
+    template <class T>
+    void getOrientations(const std::vector<T*>& objs, PyObject* orientations)
+    {
+        RealBuffer buf(orientations, objs.size() * 4, true);
+        for (size_t i = 0; i < objs.size(); ++i)
+        {
+            const Ogre::Quaternion& q = objs[i]->getOrientation();
+            buf.set(i * 4, q.w);
+            buf.set(i * 4 + 1, q.x);
+            buf.set(i * 4 + 2, q.y);
+            buf.set(i * 4 + 3, q.z);
+        }
+    }
+}
+%}
+
+// the static batch methods taking a list of objects and a buffer with three
+// (positions, scales) or four (orientations as w, x, y, z) values per object
+%define ADD_BATCH_TRANSFORMS(classname)
+%extend Ogre::classname {
+    static void setPositions(const std::vector<Ogre::classname*>& objs, PyObject* positions) {
+        setPositions(objs, positions);
+    }
+    static void setScales(const std::vector<Ogre::classname*>& objs, PyObject* scales) {
+        setScales(objs, scales);
+    }
+    static void setOrientations(const std::vector<Ogre::classname*>& objs, PyObject* orientations) {
+        setOrientations(objs, orientations);
+    }
+    static void getPositions(const std::vector<Ogre::classname*>& objs, PyObject* positions) {
+        getPositions(objs, positions);
+    }
+    static void getOrientations(const std::vector<Ogre::classname*>& objs, PyObject* orientations) {
+        getOrientations(objs, orientations);
+    }
+}
+%enddef
+#else
+%define ADD_BATCH_TRANSFORMS(classname)
+%enddef
+#endif
+
 // connect operator[] to __getitem__
 %feature("python:slot", "sq_item", functype="ssizeargfunc") *::operator[];
 %rename(__getitem__) *::operator[];
@@ -238,10 +380,31 @@ ADD_REPR(ColourValue)
 %ignore Ogre::Image::loadDynamicImage(uchar*, uint32, uint32, PixelFormat); // deprecated
 %ignore Ogre::Image::loadRawData(DataStreamPtr&, uint32, uint32, PixelFormat); // deprecated
 %include "OgreImage.h"
+#ifdef SWIGPYTHON
+%extend Ogre::Image {
+    /// writable memoryview of the image data, only valid while the image is alive and not reloaded
+    PyObject* getDataView() {
+        return createMemoryView($self->getData(), $self->getSize(), true);
+    }
+}
+#endif
 %include "OgreBillboard.h"
 %include "OgreParticle.h"
 %include "OgreHardwareOcclusionQuery.h"
 %include "OgreHardwareBuffer.h"
+#ifdef SWIGPYTHON
+%extend Ogre::HardwareBuffer {
+    /// lock the buffer and return the locked memory as memoryview, only valid until unlock is called
+    PyObject* lockView(size_t offset, size_t length, Ogre::HardwareBuffer::LockOptions options) {
+        void* data = $self->lock(offset, length, options);
+        return createMemoryView(data, length, options != Ogre::HardwareBuffer::HBL_READ_ONLY);
+    }
+    PyObject* lockView(Ogre::HardwareBuffer::LockOptions options) {
+        void* data = $self->lock(options);
+        return createMemoryView(data, $self->getSizeInBytes(), options != Ogre::HardwareBuffer::HBL_READ_ONLY);
+    }
+}
+#endif
 %include "OgreParticleIterator.h"
 
 #ifndef SWIGJAVA
@@ -356,6 +519,9 @@ ADD_REPR(ColourValue)
     %ignore Ogre::Light::getPosition;
     %include "OgreLight.h"
     %include "OgreNode.h"
+    %template() Ogre::vector<Ogre::Node*>;
+    %template(NodeList) std::vector<Ogre::Node*>;
+    ADD_BATCH_TRANSFORMS(Node)
         %include "OgreBone.h"
         %include "OgreSceneNode.h"
     %template(ShadowCameraSetupPtr) Ogre::SharedPtr<Ogre::ShadowCameraSetup>;
@@ -392,6 +558,9 @@ ADD_REPR(ColourValue)
     %include "OgreSubEntity.h"
     %include "OgreParticleSystem.h"
     %include "OgreInstancedEntity.h"
+    %template() Ogre::vector<Ogre::InstancedEntity*>;
+    %template(InstancedEntityList) std::vector<Ogre::InstancedEntity*>;
+    ADD_BATCH_TRANSFORMS(InstancedEntity)
     %include "OgreInstanceBatch.h"
     %ignore Ogre::SimpleRenderable::setMaterial(const String&);
     %include "OgreSimpleRenderable.h"
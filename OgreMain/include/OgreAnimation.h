@@ -260,8 +260,11 @@ namespace Ogre {
             other animations.
         @param scale The scale to apply to translations and scalings, useful for 
             adapting an animation to a different size target.
+        @param keyFrameIndexHint Optional global keyframe index found at the previous
+            evaluation, updated on return (@see _getTimeIndex).
         */
-        void apply(Skeleton* skeleton, Real timePos, Real weight = 1.0, Real scale = 1.0f);
+        void apply(Skeleton* skeleton, Real timePos, Real weight = 1.0, Real scale = 1.0f,
+            uint* keyFrameIndexHint = 0);
 
         /** Applies all node tracks given a specific time point and weight to a given skeleton.
         @remarks
@@ -275,9 +278,12 @@ namespace Ogre {
             be modulated with the weight factor.
         @param scale The scale to apply to translations and scalings, useful for 
             adapting an animation to a different size target.
+        @param keyFrameIndexHint Optional global keyframe index found at the previous
+            evaluation, updated on return (@see _getTimeIndex).
         */
         void apply(Skeleton* skeleton, Real timePos, float weight,
-          const AnimationState::BoneBlendMask* blendMask, Real scale);
+          const AnimationState::BoneBlendMask* blendMask, Real scale,
+          uint* keyFrameIndexHint = 0);
 
         /** Applies all vertex tracks given a specific time point and weight to a given entity.
         @param entity The Entity to which this animation should be applied
@@ -423,6 +429,14 @@ namespace Ogre {
         */
         void optimise(bool discardIdentityNodeTracks = true);
 
+        /** Remove the node keyframes which interpolating their neighbours
+            reproduces within the given tolerances.
+        @see NodeAnimationTrack::reduceKeyFrames
+        @return The number of keyframes removed
+        */
+        size_t reduceKeyFrames(Real positionTolerance, const Radian& orientationTolerance,
+            Real scaleTolerance);
+
         /// A list of track handles
         typedef set<ushort>::type TrackHandleList;
 
@@ -449,7 +463,11 @@ namespace Ogre {
         
         /** Internal method used to tell the animation that keyframe list has been
             changed, which may cause it to rebuild some internal data */
-        void _keyFrameListChanged(void) { mKeyFrameTimesDirty = true; }
+        void _keyFrameListChanged(void) { mKeyFrameTimesDirty = true; mBatchedNodeTracksDirty = true; }
+
+        /** Internal method used to tell the animation that the data of a node
+            keyframe has been changed, which may cause it to rebuild some internal data */
+        void _keyFrameDataChanged(void) const { mBatchedNodeTracksDirty = true; }
 
         /** Internal method used to convert time position to time index object.
         @note
@@ -457,11 +475,15 @@ namespace Ogre {
             the animation object, if the animation object altered (e.g. create/remove
             keyframe or track), all related time index will invalidated.
         @param timePos The time position.
+        @param keyIndexHint Optional global keyframe index found by a previous
+            call, typically kept by an AnimationState. When the time has only
+            advanced to the same or the next keyframe the search is skipped.
+            Updated with the index found on return.
         @return The time index object which contains wrapped time position (in
             relation to the whole animation sequence) and lower bound index of
             global keyframe time list.
         */
-        TimeIndex _getTimeIndex(Real timePos) const;
+        TimeIndex _getTimeIndex(Real timePos, uint* keyIndexHint = 0) const;
         
         /** Sets a base keyframe which for the skeletal / pose keyframes 
             in this animation. 
@@ -528,6 +550,27 @@ namespace Ogre {
         /// Dirty flag indicate that keyframe time list need to rebuild
         mutable bool mKeyFrameTimesDirty;
 
+        /// Node track keyframes packed for OptimisedUtil::blendTransformKeyFrames
+        struct BatchedNodeTrack
+        {
+            NodeAnimationTrack* track;
+            unsigned short handle;
+            unsigned short numKeyFrames;
+            bool useShortestRotationPath;
+            /// Offset of the first keyframe in mBatchedKeyFrames
+            size_t keyFrameOffset;
+            /// Offset of the global to local keyframe index map in mBatchedKeyFrameIndexMap
+            size_t keyFrameIndexMapOffset;
+        };
+        typedef vector<BatchedNodeTrack>::type BatchedNodeTrackList;
+        mutable BatchedNodeTrackList mBatchedNodeTracks;
+        /// Keyframes of all node tracks, 12 floats each (the key time is kept in slot 7)
+        mutable vector<float>::type mBatchedKeyFrames;
+        /// Global to local keyframe index maps of all node tracks
+        mutable vector<ushort>::type mBatchedKeyFrameIndexMap;
+        /// Dirty flag indicate that the batched node tracks need to rebuild
+        mutable bool mBatchedNodeTracksDirty;
+
         bool mUseBaseKeyFrame;
         Real mBaseKeyFrameTime;
         String mBaseKeyFrameAnimationName;
@@ -538,6 +581,13 @@ namespace Ogre {
 
         /// Internal method to build global keyframe time list
         void buildKeyFrameTimeList(void) const;
+        /// Internal method to pack the keyframes of the node tracks
+        void buildBatchedNodeTracks(void) const;
+        /// Whether the node tracks can be applied by applyBatchedNodeTracks
+        bool canApplyBatchedNodeTracks(void) const;
+        /// Internal method to apply the node tracks to a skeleton a batch of bones at a time
+        void applyBatchedNodeTracks(Skeleton* skeleton, const TimeIndex& timeIndex, float weight,
+            const AnimationState::BoneBlendMask* blendMask, Real scale);
     };
 
     /** @} */
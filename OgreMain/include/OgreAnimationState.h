@@ -160,6 +160,11 @@ namespace Ogre {
       const BoneBlendMask* getBlendMask() const {return mBlendMask;}
       /// Return whether there is currently a valid blend mask set
       bool hasBlendMask() const {return mBlendMask != 0;}
+      /** Internal method returning the global keyframe index found at the last
+          evaluation of this state, used to skip the keyframe search when the
+          time position advances only slightly between frames.
+      */
+      uint* _getKeyFrameIndexHint(void) const { return &mKeyFrameIndexHint; }
       /// Set the weight for the bone identified by the given handle
       void setBlendMaskEntry(size_t boneHandle, float weight);
       /// Get the weight for the bone identified by the given handle
@@ -179,6 +184,8 @@ namespace Ogre {
         Real mWeight;
         bool mEnabled;
         bool mLoop;
+        /// Global keyframe index of the last evaluation, @see Animation::_getTimeIndex
+        mutable uint mKeyFrameIndexHint;
 
     };
 
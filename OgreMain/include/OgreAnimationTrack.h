@@ -238,6 +238,9 @@ namespace Ogre
         /** Set a listener for this track. */
         virtual void setListener(Listener* l) { mListener = l; }
 
+        /** Returns the listener for this track, if any. */
+        virtual Listener* getListener(void) const { return mListener; }
+
         /** Returns the parent Animation object for this track. */
         Animation *getParent() const { return mParent; }
     protected:
@@ -380,6 +383,23 @@ namespace Ogre
         /** Optimise the current track by removing any duplicate keyframes. */
         virtual void optimise(void);
 
+        /** Remove the keyframes which interpolating their neighbours reproduces
+            within the given tolerances.
+        @remarks
+            Unlike optimise, this also removes keyframes which change the
+            transform, as long as the error stays within bounds, which shrinks
+            sampled animation such as motion capture, with a keyframe for every
+            frame, considerably. The first and last keyframes are always kept.
+            The error is measured against linear interpolation, tracks of
+            animations using spline interpolation may deviate slightly more.
+        @param positionTolerance Largest distance between a removed translation and the interpolated one
+        @param orientationTolerance Largest angle between a removed rotation and the interpolated one
+        @param scaleTolerance Largest distance between a removed scale and the interpolated one
+        @return The number of keyframes removed
+        */
+        size_t reduceKeyFrames(Real positionTolerance, const Radian& orientationTolerance,
+            Real scaleTolerance);
+
         /** Clone this track (internal use only) */
         NodeAnimationTrack* _clone(Animation* newParent) const;
         
@@ -388,6 +408,9 @@ namespace Ogre
     protected:
         /// Specialised keyframe creation
         KeyFrame* createKeyFrameImpl(Real time);
+        /// Whether interpolating keyframes first and last reproduces those in between within tolerance
+        bool isInterpolatable(size_t first, size_t last, Real positionTolerance,
+            Real orientationDotTolerance, Real scaleTolerance) const;
         // Flag indicating we need to rebuild the splines next time
         virtual void buildInterpolationSplines(void) const;
 
@@ -67,7 +67,7 @@ namespace Ogre
 
         template<typename ValueType>
         explicit Any(const ValueType & value)
-          : mContent(OGRE_NEW_T(holder<ValueType>, MEMCATEGORY_GENERAL)(value))
+          : mContent(OGRE_NEW holder<ValueType>(value))
         {
         }
 
@@ -130,7 +130,7 @@ namespace Ogre
 
         void reset()
         {
-            OGRE_DELETE_T(mContent, placeholder, MEMCATEGORY_GENERAL);
+            OGRE_DELETE mContent;
             mContent = NULL;
         }
 
@@ -139,7 +139,7 @@ namespace Ogre
 
     protected: // types
 
-        class placeholder 
+        class placeholder : public AnyAlloc
         {
         public: // structors
     
@@ -176,7 +176,7 @@ namespace Ogre
 
             virtual placeholder * clone() const
             {
-                return OGRE_NEW_T(holder, MEMCATEGORY_GENERAL)(held);
+                return OGRE_NEW holder(held);
             }
 
             virtual void writeToStream(std::ostream& o)
@@ -233,7 +233,7 @@ namespace Ogre
         AnyNumeric(const ValueType & value)
             
         {
-            mContent = OGRE_NEW_T(numholder<ValueType>, MEMCATEGORY_GENERAL)(value);
+            mContent = OGRE_NEW numholder<ValueType>(value);
         }
 
         AnyNumeric(const AnyNumeric & other)
@@ -276,28 +276,28 @@ namespace Ogre
 
             virtual placeholder * clone() const
             {
-                return OGRE_NEW_T(numholder, MEMCATEGORY_GENERAL)(held);
+                return OGRE_NEW numholder(held);
             }
 
             virtual placeholder* add(placeholder* rhs)
             {
-                return OGRE_NEW_T(numholder, MEMCATEGORY_GENERAL)(held + static_cast<numholder*>(rhs)->held);
+                return OGRE_NEW numholder(held + static_cast<numholder*>(rhs)->held);
             }
             virtual placeholder* subtract(placeholder* rhs)
             {
-                return OGRE_NEW_T(numholder, MEMCATEGORY_GENERAL)(held - static_cast<numholder*>(rhs)->held);
+                return OGRE_NEW numholder(held - static_cast<numholder*>(rhs)->held);
             }
             virtual placeholder* multiply(placeholder* rhs)
             {
-                return OGRE_NEW_T(numholder, MEMCATEGORY_GENERAL)(held * static_cast<numholder*>(rhs)->held);
+                return OGRE_NEW numholder(held * static_cast<numholder*>(rhs)->held);
             }
             virtual placeholder* multiply(Real factor)
             {
-                return OGRE_NEW_T(numholder, MEMCATEGORY_GENERAL)(held * factor);
+                return OGRE_NEW numholder(held * factor);
             }
             virtual placeholder* divide(placeholder* rhs)
             {
-                return OGRE_NEW_T(numholder, MEMCATEGORY_GENERAL)(held / static_cast<numholder*>(rhs)->held);
+                return OGRE_NEW numholder(held / static_cast<numholder*>(rhs)->held);
             }
             virtual void writeToStream(std::ostream& o)
             {
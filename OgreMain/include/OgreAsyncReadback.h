@@ -0,0 +1,107 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __AsyncReadback_H__
+#define __AsyncReadback_H__
+
+#include "OgrePrerequisites.h"
+#include "OgrePixelFormat.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup RenderSystem
+    *  @{
+    */
+    /** Ticket of a copy of pixels from the GPU to memory.
+    @remarks
+        Reading back what the GPU rendered at once has to wait until it has caught
+        up with all the commands issued so far, stalling the frame. Instead,
+        RenderTarget::copyContentsToMemoryAsync and
+        HardwarePixelBuffer::blitToMemoryAsync start the copy and return a ticket,
+        and the data is fetched from it a few frames later, by which time the
+        copy is usually done. Render systems without asynchronous readback copy
+        at once, so the tickets are ready straight away.
+    */
+    class _OgreExport AsyncReadback : public BufferAlloc
+    {
+    public:
+        AsyncReadback(uint32 width, uint32 height, uint32 depth, PixelFormat format)
+            : mWidth(width), mHeight(height), mDepth(depth), mFormat(format) {}
+        virtual ~AsyncReadback() {}
+
+        /** Whether the data has arrived, so that fetch will not wait for it. */
+        virtual bool isReady(void) = 0;
+
+        /** Copies the data to memory, waiting for it if it has not arrived yet.
+        @param dst
+            PixelBox describing the destination pixels and format in memory, the
+            data is scaled if the sizes differ
+        */
+        virtual void fetch(const PixelBox& dst) = 0;
+
+        uint32 getWidth(void) const { return mWidth; }
+        uint32 getHeight(void) const { return mHeight; }
+        uint32 getDepth(void) const { return mDepth; }
+        /// Format the data is read back in, the best one to fetch it in
+        PixelFormat getFormat(void) const { return mFormat; }
+
+    protected:
+        uint32 mWidth;
+        uint32 mHeight;
+        uint32 mDepth;
+        PixelFormat mFormat;
+
+        /// Copies pixels, converting and scaling them as needed
+        static void copyPixels(const PixelBox& src, const PixelBox& dst);
+    };
+
+    /** Readback of pixels that were copied to memory at once. */
+    class _OgreExport MemoryAsyncReadback : public AsyncReadback
+    {
+    public:
+        MemoryAsyncReadback(uint32 width, uint32 height, uint32 depth, PixelFormat format);
+        ~MemoryAsyncReadback();
+
+        /// The memory to copy the pixels to
+        const PixelBox& getPixelBox(void) const { return mPixels; }
+
+        bool isReady(void) { return true; }
+        void fetch(const PixelBox& dst);
+
+    protected:
+        PixelBox mPixels;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreCommon.h"
 #include "OgreLight.h"
+#include "OgreGpuProgramParams.h"
 
 namespace Ogre {
 
@@ -77,6 +78,7 @@ namespace Ogre {
         mutable Matrix4 mSpotlightViewProjMatrix[OGRE_MAX_SIMULTANEOUS_LIGHTS];
         mutable Matrix4 mSpotlightWorldViewProjMatrix[OGRE_MAX_SIMULTANEOUS_LIGHTS];
         mutable Vector4 mShadowCamDepthRanges[OGRE_MAX_SIMULTANEOUS_LIGHTS];
+        Vector4 mTextureProjectorRegion[OGRE_MAX_SIMULTANEOUS_LIGHTS];
         mutable Matrix4 mViewMatrix;
         mutable Matrix4 mProjectionMatrix;
         mutable Real mDirLightExtrusionDistance;
@@ -121,6 +123,16 @@ namespace Ogre {
         const SceneManager* mCurrentSceneManager;
         const VisibleObjectsBoundsInfo* mMainCamBoundsInfo;
         const Pass* mCurrentPass;
+        bool mUseIdentityView;
+        bool mUseIdentityProjection;
+
+        /// Versions of the data each class of auto constants is derived from, by GpuParamVariability bit
+        uint32 mVariabilityVersions[3];
+        mutable size_t mNumAutoConstantsUpdated;
+        mutable size_t mNumAutoConstantsSkipped;
+
+        /// Notes that the data auto constants of the given GpuParamVariability mask are derived from changed
+        void markChanged(uint16 variability);
 
         Light mBlankLight;
     public:
@@ -135,6 +147,11 @@ namespace Ogre {
         void setCurrentLightList(const LightList* ll);
         /** Sets the current texture projector for a index */
         void setTextureProjector(const Frustum* frust, size_t index);
+        /** Sets the part of the texture a texture projector maps to, as
+            (left, top, right, bottom) texture coordinates. Reset to the whole
+            texture by setTextureProjector.
+        */
+        void setTextureProjectorRegion(const Vector4& region, size_t index);
         /** Sets the current render target */
         void setCurrentRenderTarget(const RenderTarget* target);
         /** Sets the current viewport */
@@ -198,6 +215,7 @@ namespace Ogre {
         const Vector4& getFogParams(void) const;
         const Matrix4& getTextureViewProjMatrix(size_t index) const;
         const Matrix4& getTextureWorldViewProjMatrix(size_t index) const;
+        const Vector4& getTextureProjectorRegion(size_t index) const;
         const Matrix4& getSpotlightViewProjMatrix(size_t index) const;
         const Matrix4& getSpotlightWorldViewProjMatrix(size_t index) const;
         const Matrix4& getTextureTransformMatrix(size_t index) const;
@@ -255,6 +273,32 @@ namespace Ogre {
         int getPassNumber(void) const;
         void setPassNumber(const int passNumber);
         void incPassNumber(void);
+
+        /** Gets a number which changes whenever the data auto constants of the
+            given variability are derived from may have changed.
+        @remarks
+            GpuProgramParameters compares these against the ones it was last
+            updated from, and skips auto constants whose source is unchanged.
+        @param variability One of GPV_GLOBAL, GPV_PER_OBJECT and GPV_LIGHTS
+        */
+        uint32 getVariabilityVersion(GpuParamVariability variability) const;
+
+        /// Records how many auto constants an update evaluated, and how many it skipped as unchanged
+        void _recordAutoConstantUpdate(size_t updated, size_t skipped) const
+        {
+            mNumAutoConstantsUpdated += updated;
+            mNumAutoConstantsSkipped += skipped;
+        }
+        /// Gets the number of auto constants evaluated since the counters were reset
+        size_t _getNumAutoConstantsUpdated(void) const { return mNumAutoConstantsUpdated; }
+        /// Gets the number of auto constants skipped as unchanged since the counters were reset
+        size_t _getNumAutoConstantsSkipped(void) const { return mNumAutoConstantsSkipped; }
+        /// Resets the auto constant update counters
+        void _resetAutoConstantCounters(void)
+        {
+            mNumAutoConstantsUpdated = 0;
+            mNumAutoConstantsSkipped = 0;
+        }
         void updateLightCustomGpuParameter(const GpuProgramParameters::AutoConstantEntry& constantEntry, GpuProgramParameters *params) const;
     };
     /** @} */
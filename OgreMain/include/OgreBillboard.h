@@ -65,7 +65,7 @@ namespace Ogre {
             BillboardSet
     */
 
-    class _OgreExport Billboard : public FXAlloc
+    class _OgreExport Billboard : public ParticleAlloc
     {
         friend class BillboardSet;
         friend class BillboardParticleRenderer;
@@ -76,6 +76,7 @@ namespace Ogre {
         FloatRect mTexcoordRect;    /// Individual texture coordinates
         Real mWidth;
         Real mHeight;
+        size_t mIndex;              /// Position in the active billboards of the parent set
     public:
         // Note the intentional public access to main internal variables used at runtime
         // Forcing access via get/set would be too costly for 000's of billboards
@@ -141,7 +142,7 @@ namespace Ogre {
         void setDimensions(Real width, Real height);
 
         /** Resets this Billboard to use the parent BillboardSet's dimensions instead of it's own. */
-        void resetDimensions(void) { mOwnDimensions = false; }
+        void resetDimensions(void);
         /** Sets the colour of this billboard.
             @remarks
                 Billboards can be tinted based on a base colour. This allows variations in colour irrespective of the
@@ -73,6 +73,10 @@ namespace Ogre {
         time - you have to do all this yourself as a user of the class. 
         Subclasses can however be used to provide this kind of behaviour 
         automatically. @see RibbonTrail
+    @par
+        When the SceneManager option "BatchBillboardChains" is set, chains
+        sharing a material and render queue are packed into a shared buffer
+        and drawn together, see BillboardChainBatcher.
     */
     class _OgreExport BillboardChain : public MovableObject, public Renderable
     {
@@ -355,6 +359,22 @@ namespace Ogre {
         /// Update the contents of the index buffer
         virtual void updateIndexBuffer(void);
         virtual void updateBoundingBox(void) const;
+        /** Write the vertices of all segments, each at its element index.
+        @param pBufferStart Where vertex 0 goes
+        @param vertexSize Size of one vertex in bytes
+        @param eyePos The camera position in the space of the chain
+        @param worldTransform If not null, positions are transformed by it
+        */
+        void writeVertices(char* pBufferStart, size_t vertexSize,
+            const Vector3& eyePos, const Matrix4* worldTransform) const;
+        /** Write the indexes of all segments, returns the number written.
+        @param pIndex Where the first index goes
+        @param baseVertex Offset added to every index
+        */
+        template<typename T>
+        size_t writeIndexes(T* pIndex, size_t baseVertex) const;
+
+        friend class BillboardChainBatcher;
 
         /// Chain segment has no elements
         static const size_t SEGMENT_EMPTY;
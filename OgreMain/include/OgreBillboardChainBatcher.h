@@ -0,0 +1,161 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BillboardChainBatcher_H__
+#define __BillboardChainBatcher_H__
+
+#include "OgrePrerequisites.h"
+
+#include "OgreRenderable.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreMatrix4.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Effects
+    *  @{
+    */
+    /** Draws the billboard chains of a scene which share a material together.
+    @remarks
+        Created by the SceneManager when its "BatchBillboardChains" option is set.
+        Chains found visible hand themselves to the batcher instead of queueing
+        their own render operation. Chains with the same material, render queue
+        group and priority and vertex layout are grouped into a batch, which keeps
+        one shared dynamic vertex buffer with a slot for each chain and draws all
+        chains of the group visible to a camera in a single render operation.
+    @par
+        Only the slots of chains whose elements, camera or transform changed are
+        rewritten, with a single lock spanning them. The vertices are stored in
+        world space, so chains moving with their node are rewritten every frame.
+        Many small trails, such as those of RibbonTrail, benefit the most.
+    */
+    class _OgreExport BillboardChainBatcher : public FXAlloc
+    {
+    public:
+        BillboardChainBatcher();
+        ~BillboardChainBatcher();
+
+        /** Internal method, adds a visible chain to the batch it belongs to and
+            queues the batch if it is the first of it in this render.
+        */
+        void _addChain(BillboardChain* chain, RenderQueue* queue);
+        /** Internal method, forgets a chain, called when it is destroyed. */
+        void _removeChain(BillboardChain* chain);
+        /** Internal method, starts gathering the visible chains of a render of the scene. */
+        void _beginScene(void);
+
+        /** Gets the number of batches, i.e. of distinct material and queue combinations. */
+        size_t getNumBatches(void) const { return mBatches.size(); }
+
+    protected:
+        /// What chains need in common to be drawn together
+        struct BatchKey
+        {
+            const Material* material;
+            uint8 queueID;
+            ushort priority;
+            bool useTexCoords;
+            bool useVertexColour;
+
+            bool operator<(const BatchKey& rhs) const;
+        };
+
+        /// Chains sharing one vertex buffer
+        class Batch : public Renderable, public FXAlloc
+        {
+        public:
+            Batch(const MaterialPtr& material, bool useTexCoords, bool useVertexColour);
+            ~Batch();
+
+            /// Adds a chain visible in this render, returns whether it was the first
+            bool addVisibleChain(BillboardChain* chain);
+            /// Releases the slot of a chain
+            void removeChain(BillboardChain* chain);
+            void clearVisibleChains(void) { mVisibleChains.clear(); mWorldAABB.setNull(); }
+            bool isEmpty(void) const { return mSlots.empty(); }
+
+            const MaterialPtr& getMaterial(void) const { return mMaterial; }
+            void getRenderOperation(RenderOperation& op);
+            bool preRender(SceneManager* sm, RenderSystem* rsys);
+            void getWorldTransforms(Matrix4* xform) const { *xform = Matrix4::IDENTITY; }
+            Real getSquaredViewDepth(const Camera* cam) const;
+            const LightList& getLights(void) const { return mLights; }
+
+        protected:
+            /// Range of the vertex buffer holding the vertices of a chain
+            struct Slot
+            {
+                size_t start;
+                size_t count;
+                /// Camera and transform the vertices were written for
+                const Camera* camera;
+                Matrix4 transform;
+                bool valid;
+            };
+            typedef map<BillboardChain*, Slot>::type SlotMap;
+            typedef vector<BillboardChain*>::type ChainList;
+
+            MaterialPtr mMaterial;
+            VertexData* mVertexData;
+            IndexData* mIndexData;
+            SlotMap mSlots;
+            /// Vertices allocated so far, slots are handed out from here
+            size_t mVertexEnd;
+            ChainList mVisibleChains;
+            AxisAlignedBox mWorldAABB;
+            LightList mLights;
+
+            /// Makes room for a slot of a number of vertices
+            void allocateSlot(Slot& slot, size_t count);
+            /// Moves the live slots together, growing the buffer if needed
+            void compact(size_t extraVertices);
+        };
+
+        typedef map<BatchKey, Batch*>::type BatchMap;
+        typedef map<BillboardChain*, Batch*>::type ChainBatchMap;
+
+        BatchMap mBatches;
+        /// The batch each chain has a slot in
+        ChainBatchMap mChainBatches;
+        /// The batches queued in this render of the scene
+        vector<Batch*>::type mQueuedBatches;
+
+        /// Takes a chain out of its batch, destroying the batch when it is unused
+        void releaseChain(ChainBatchMap::iterator it);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
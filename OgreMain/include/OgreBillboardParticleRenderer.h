@@ -107,6 +107,13 @@ namespace Ogre {
             String doGet(const void* target) const;
             void doSet(void* target, const String& val);
         };
+        /** Command object for instancing (see ParamCommand).*/
+        class _OgrePrivate CmdInstancing : public ParamCommand
+        {
+        public:
+            String doGet(const void* target) const;
+            void doSet(void* target, const String& val);
+        };
 
         /** Sets the type of billboard to render.
         @remarks
@@ -196,13 +203,19 @@ namespace Ogre {
         /// @copydoc BillboardSet::isPointRenderingEnabled
         bool isPointRenderingEnabled(void) const;
 
+        /// @copydoc BillboardSet::setInstancingEnabled
+        void setInstancingEnabled(bool enabled);
+
+        /// @copydoc BillboardSet::isInstancingEnabled
+        bool isInstancingEnabled(void) const;
+
 
 
         /// @copydoc ParticleSystemRenderer::getType
         const String& getType(void) const;
         /// @copydoc ParticleSystemRenderer::_updateRenderQueue
         void _updateRenderQueue(RenderQueue* queue, 
-            list<Particle*>::type& currentParticles, bool cullIndividually);
+            vector<Particle*>::type& currentParticles, bool cullIndividually);
         /// @copydoc ParticleSystemRenderer::visitRenderables
         void visitRenderables(Renderable::Visitor* visitor, 
             bool debugRenderables = false);
@@ -240,6 +253,7 @@ namespace Ogre {
         static CmdCommonUpVector msCommonUpVectorCmd;
         static CmdPointRendering msPointRenderingCmd;
         static CmdAccurateFacing msAccurateFacingCmd;
+        static CmdInstancing msInstancingCmd;
 
 
     };
@@ -147,26 +147,27 @@ namespace Ogre {
         bool mAllDefaultRotation;
         bool mWorldSpace;
 
-        typedef list<Billboard*>::type ActiveBillboardList;
-        typedef list<Billboard*>::type FreeBillboardList;
+        typedef vector<Billboard*>::type ActiveBillboardList;
+        typedef vector<Billboard*>::type FreeBillboardList;
         typedef vector<Billboard*>::type BillboardPool;
+        typedef vector<Billboard*>::type BillboardBlockList;
+        typedef vector<uint32>::type BillboardIndexList;
 
         /** Active billboard list.
         @remarks
-            This is a linked list of pointers to billboards in the billboard pool.
-        @par
-            This allows very fast insertions and deletions from anywhere in the list to activate / deactivate billboards
-            (required for particle systems etc.) as well as reuse of Billboard instances in the pool
-            without construction & destruction which avoids memory thrashing.
+            This is a dense array of pointers to billboards in the billboard pool, in creation order.
+            Each billboard knows its position in here, so it can be looked up and removed without
+            a search, and the vertex buffer holds the billboards at the same positions so that
+            changes to a few of them only need that range to be written again.
         */
         ActiveBillboardList mActiveBillboards;
 
-        /** Free billboard queue.
+        /** Free billboard stack.
         @remarks
-            This contains a list of the billboards free for use as new instances
+            This contains the billboards free for use as new instances
             as required by the set. Billboard instances are preconstructed up to the estimated size in the
-            mBillboardPool vector and are referenced on this deque at startup. As they get used this deque
-            reduces, as they get released back to to the set they get added back to the deque.
+            mBillboardPool vector and are referenced here at startup. As they get used this stack
+            reduces, as they get released back to to the set they get added back to the end.
         */
         FreeBillboardList mFreeBillboards;
 
@@ -176,6 +177,12 @@ namespace Ogre {
         */
         BillboardPool mBillboardPool;
 
+        /// Arrays the billboards of the pool are constructed in, one per increasePool call
+        BillboardBlockList mBillboardBlocks;
+
+        /// Order of the active billboards after sorting, as indices into mActiveBillboards
+        BillboardIndexList mSortedBillboards;
+
         /// The vertex position data for all billboards in this set.
         VertexData* mVertexData;
         /// Shortcut to main buffer (positions, colours, texture coords)
@@ -265,9 +272,11 @@ namespace Ogre {
         {
             /// Direction to sort in
             Vector3 sortDir;
+            /// Billboards the sorted indices refer to
+            const ActiveBillboardList& billboards;
 
-            SortByDirectionFunctor(const Vector3& dir);
-            float operator()(Billboard* bill) const;
+            SortByDirectionFunctor(const Vector3& dir, const ActiveBillboardList& bills);
+            float operator()(uint32 index) const;
         };
 
         /** Sort by distance functor */
@@ -275,15 +284,19 @@ namespace Ogre {
         {
             /// Position to sort in
             Vector3 sortPos;
+            /// Billboards the sorted indices refer to
+            const ActiveBillboardList& billboards;
 
-            SortByDistanceFunctor(const Vector3& pos);
-            float operator()(Billboard* bill) const;
+            SortByDistanceFunctor(const Vector3& pos, const ActiveBillboardList& bills);
+            float operator()(uint32 index) const;
         };
 
-        static RadixSort<ActiveBillboardList, Billboard*, float> mRadixSorter;
+        static RadixSort<BillboardIndexList, uint32, float> mRadixSorter;
 
         /// Use point rendering?
         bool mPointRendering;
+        /// Use hardware instancing?
+        bool mInstancing;
 
 
 
@@ -298,10 +311,33 @@ namespace Ogre {
         bool mAutoUpdate;
         /// True if the billboard data changed. Will cause vertex buffer update.
         bool mBillboardDataChanged;
+        /// Range of active billboards changed since the last vertex buffer update
+        size_t mDirtyBegin, mDirtyEnd;
+        /// Are the current buffers laid out for instancing?
+        bool mInstancedBuffers;
 
         /** Internal method creates vertex and index buffers.
         */
         void _createBuffers(void);
+        /** Internal method creates the quad and instance buffers for instancing.
+        */
+        void _createInstancedBuffers(void);
+        /** Internal method telling whether instancing can be used with the current settings.
+        */
+        bool canUseInstancing(void) const;
+        /** Internal method for writing the instance record of a billboard.
+        */
+        void genInstance(const Billboard& bb);
+        /** Internal method creating the buffers and computing the shared axes and offsets
+            before billboards are written.
+        */
+        void prepareBillboards(void);
+        /** Internal method returning the bytes of the main buffer used by one billboard.
+        */
+        size_t getBillboardSize(void) const;
+        /** Internal method rewriting only the changed range of billboards in the buffers.
+        */
+        void _updateDirtyBillboards(void);
         /** Internal method destroys vertex and index buffers.
         */
         void _destroyBuffers(void);
@@ -607,6 +643,15 @@ namespace Ogre {
         */
         virtual void _notifyBillboardRotated(void);
 
+        /** Internal callback used by Billboards to notify their parent that their data changed.
+        @param index The position of the billboard in the active billboards
+        */
+        void _notifyBillboardChanged(size_t index)
+        {
+            mDirtyBegin = std::min(mDirtyBegin, index);
+            mDirtyEnd = std::max(mDirtyEnd, index + 1);
+        }
+
         /** Returns whether or not billboards in this are tested individually for culling. */
         virtual bool getCullIndividually(void) const;
         /** Sets whether culling tests billboards in this individually as well as in a group.
@@ -831,6 +876,41 @@ namespace Ogre {
         /** Returns whether point rendering is enabled. */
         virtual bool isPointRenderingEnabled(void) const
         { return mPointRendering; }
+
+        /** Set whether or not the BillboardSet will use hardware instancing
+            rather than generating the quads on the CPU.
+        @remarks
+            With instancing, a single record is written per billboard and
+            the quads are expanded by the vertex program of the material,
+            so both the CPU time spent generating vertices and the upload
+            volume go down. The following applies:
+            \li The material needs a vertex program expanding the quads, see
+                InstancedBillboard.program in the sample media
+            \li The axes must be shared by all billboards, so BBT_ORIENTED_SELF,
+                BBT_PERPENDICULAR_SELF and accurate facing fall back to
+                generating the quads on the CPU
+            \li Texture coordinates are stored normalised, so they must lie
+                within [0, 1]
+        @par
+            Stream 0 holds the 4 corners of a quad as uv0 (float2), from (0, 0)
+            at the left top to (1, 1) at the right bottom. Stream 1 holds one
+            record per billboard: position (float4, the position and the
+            rotation in radians in w), colour, uv1 (float2, width and height)
+            and uv2 (ushort4 normalised, the left, top, right and bottom
+            texture coordinates). Custom parameters 0 and 1 are the x and y
+            axes of the billboards, 2 holds the left, right, top and bottom
+            parametric offsets of the origin and 3 has x set to 1 when the
+            rotation type is BBR_VERTEX.
+        @par
+            Point rendering takes precedence when both are enabled. Ignored
+            when the render system doesn't support instance data.
+        @param enabled True to enable instancing, false otherwise
+        */
+        virtual void setInstancingEnabled(bool enabled);
+
+        /** Returns whether instancing is enabled. */
+        virtual bool isInstancingEnabled(void) const
+        { return mInstancing; }
         
         /// Override to return specific type flag
         uint32 getTypeFlags(void) const;
@@ -841,8 +921,10 @@ namespace Ogre {
             By default auto update is true so the vertex buffer is being update every time this billboard set
             is about to be rendered. This behavior best fit when the billboards of this set changes frequently.
             When using static or semi-static billboards, it is recommended to set auto update to false.
-            In that case one should call notifyBillboardDataChanged method to reflect changes made to the
-            billboards data.
+            In that case billboards changed through their setters, created or removed are tracked and
+            only the range of the buffer holding them is written again (the whole buffer when sorting or
+            culling individual billboards). After writing to the public members of a Billboard directly
+            one should call notifyBillboardDataChanged method to reflect changes made to the billboards data.
         */
         void setAutoUpdate(bool autoUpdate);
 
@@ -335,6 +335,11 @@ namespace Ogre {
         /** All techniques are forced to one weight per vertex. */
         IM_FORCEONEWEIGHT = 0x0020,
 
+        /** Bake every frame of every skeletal animation into a vertex texture shared by all
+        batches, instances sample their pose from it (HW_VTF only, implies bone matrix lookup).
+        @see InstanceManager::setBakedAnimationFrameRate */
+        IM_VTFBAKEDANIMATION = 0x0040,
+
         IM_USEALL       = IM_USE16BIT|IM_VTFBESTFIT|IM_USEONEWEIGHT
     };
     
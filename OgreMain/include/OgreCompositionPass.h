@@ -57,7 +57,8 @@ namespace Ogre {
             PT_STENCIL,         /// Set stencil operation
             PT_RENDERSCENE,     /// Render the scene or part of it
             PT_RENDERQUAD,      /// Render a full screen quad
-            PT_RENDERCUSTOM     /// Render a custom sequence
+            PT_RENDERCUSTOM,    /// Render a custom sequence
+            PT_COMPUTE          /// Dispatch a compute program
         };
         
         /** Set the type of composition pass */
@@ -73,15 +74,15 @@ namespace Ogre {
         uint32 getIdentifier() const;
 
         /** Set the material used by this pass
-            @note applies when PassType is RENDERQUAD 
+            @note applies when PassType is RENDERQUAD or COMPUTE
         */
         void setMaterial(const MaterialPtr& mat);
         /** Set the material used by this pass 
-            @note applies when PassType is RENDERQUAD 
+            @note applies when PassType is RENDERQUAD or COMPUTE
         */
         void setMaterialName(const String &name);
         /** Get the material used by this pass 
-            @note applies when PassType is RENDERQUAD 
+            @note applies when PassType is RENDERQUAD or COMPUTE
         */
         const MaterialPtr& getMaterial() const;
         /** Set the first render queue to be rendered in this pass (inclusive) 
@@ -272,6 +273,61 @@ namespace Ogre {
             @note applies when PassType is RENDERQUAD 
         */
         void clearAllInputs();
+
+        /// Images (textures the compute program loads from and stores to)
+        struct ImageTex
+        {
+            /// Name (local) of the texture (empty == no image)
+            String name;
+            /// MRT surface index if applicable
+            size_t mrtIndex;
+            /// Access the compute program has to the texture
+            TextureAccess access;
+            ImageTex() : name(BLANKSTRING), mrtIndex(0), access(TA_READ_WRITE) {}
+            ImageTex(const String& _name, size_t _mrtIndex = 0, TextureAccess _access = TA_READ_WRITE)
+                : name(_name), mrtIndex(_mrtIndex), access(_access) {}
+        };
+
+        /** Set an image, a local texture bound to an image unit (GL) or unordered
+            access view slot (D3D11) of the compute program.
+            @param id    Binding point to set. Must be in 0..OGRE_MAX_TEXTURE_LAYERS-1
+            @param image Which texture to bind to this point. An empty string clears the image.
+            @param mrtIndex Which surface of an MRT to retrieve
+            @param access The access the program has to the texture
+            @note applies when PassType is COMPUTE
+        */
+        void setImage(size_t id, const String &image=BLANKSTRING, size_t mrtIndex=0,
+            TextureAccess access=TA_READ_WRITE);
+
+        /** Get the value of an image.
+            @param id    Binding point to get. Must be in 0..OGRE_MAX_TEXTURE_LAYERS-1.
+            @note applies when PassType is COMPUTE
+        */
+        const ImageTex &getImage(size_t id) const;
+
+        /** Get the number of images used.
+            @note applies when PassType is COMPUTE
+        */
+        size_t getNumImages() const;
+
+        /** Clear all images.
+            @note applies when PassType is COMPUTE
+        */
+        void clearAllImages();
+
+        /** Set the number of threads in each work group of the compute program.
+        @remarks
+            The number of groups dispatched is the size of the target divided by this,
+            rounded up. Zero (the default) dispatches the group count set on the program
+            instead, see GpuProgram::setComputeGroupDimensions.
+            @note applies when PassType is COMPUTE
+        */
+        void setThreadGroupSize(const Vector3& size);
+
+        /** Get the number of threads in each work group of the compute program.
+            @note applies when PassType is COMPUTE
+        */
+        const Vector3& getThreadGroupSize() const;
         
         /** Get parent object 
             @note applies when PassType is RENDERQUAD 
@@ -346,6 +402,10 @@ namespace Ogre {
         /** Inputs (for material used for rendering the quad).
             An empty string signifies that no input is used */
         InputTex mInputs[OGRE_MAX_TEXTURE_LAYERS];
+        /// Images of the compute program (in case of PT_COMPUTE)
+        ImageTex mImages[OGRE_MAX_TEXTURE_LAYERS];
+        /// Threads per work group (in case of PT_COMPUTE)
+        Vector3 mThreadGroupSize;
         /// Stencil operation parameters
         bool mStencilCheck;
         CompareFunction mStencilFunc; 
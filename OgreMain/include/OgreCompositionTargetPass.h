@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 #include "OgrePrerequisites.h"
 #include "OgreIteratorWrappers.h"
+#include "OgreRenderTarget.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
@@ -118,6 +119,35 @@ namespace Ogre {
         /** Get the scene LOD bias used by this pass 
         */
         float getLodBias();
+
+        /** Set what happens to the previous contents of some buffers of the
+            output when this target pass begins.
+        @remarks
+            On tile based GPUs LA_DONT_CARE skips loading buffers which the
+            passes overwrite anyway. Buffers cleared by a leading clear pass are
+            not loaded either way, see RenderTarget::setLoadAction.
+        @param action The load action
+        @param buffers Combination of one or more elements of FrameBufferType
+        */
+        void setLoadAction(RenderTarget::LoadAction action,
+            unsigned int buffers = FBT_COLOUR | FBT_DEPTH | FBT_STENCIL);
+        /** Get the mask of FrameBufferType of the buffers set to LA_DONT_CARE
+        */
+        unsigned int getDontCareBuffers(void) const { return mDontCareBuffers; }
+        /** Set what happens to the contents of some buffers of the output
+            when this target pass ends.
+        @remarks
+            On tile based GPUs SA_DISCARD skips storing buffers which are not
+            read afterwards, usually depth and stencil, see
+            RenderTarget::setStoreAction.
+        @param action The store action
+        @param buffers Combination of one or more elements of FrameBufferType
+        */
+        void setStoreAction(RenderTarget::StoreAction action,
+            unsigned int buffers = FBT_COLOUR | FBT_DEPTH | FBT_STENCIL);
+        /** Get the mask of FrameBufferType of the buffers set to SA_DISCARD
+        */
+        unsigned int getDiscardBuffers(void) const { return mDiscardBuffers; }
         
         /** Create a new pass, and return a pointer to it.
         */
@@ -166,6 +196,9 @@ namespace Ogre {
         String mMaterialScheme;
         /// Shadows option
         bool mShadowsEnabled;
+        /// FrameBufferType masks of the buffers not loaded and not stored
+        unsigned int mDontCareBuffers;
+        unsigned int mDiscardBuffers;
     };
 
     /** @} */
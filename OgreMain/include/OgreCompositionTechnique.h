@@ -76,9 +76,11 @@ namespace Ogre {
             uint16 depthBufferId;//Depth Buffer's pool ID. (unrelated to "pool" variable below)
             bool pooled;        // whether to use pooled textures for this one
             TextureScope scope; // Which scope has access to this texture
+            bool dynamicResolution; // rendered at the resolution scale of the chain (if width and height = 0)
 
             TextureDefinition() :width(0), height(0), widthFactor(1.0f), heightFactor(1.0f), 
-                fsaa(true), hwGammaWrite(false), depthBufferId(1), pooled(false), scope(TS_LOCAL) {}
+                fsaa(true), hwGammaWrite(false), depthBufferId(1), pooled(false), scope(TS_LOCAL),
+                dynamicResolution(false) {}
         };
         /// Typedefs for several iterators
         typedef vector<CompositionTargetPass *>::type TargetPasses;
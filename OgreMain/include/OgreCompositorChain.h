@@ -156,6 +156,35 @@ namespace Ogre {
         */
         CompositorInstance* getNextInstance(CompositorInstance* curr, bool activeOnly = true);
 
+        /** Set the resolution scale of the textures declared with 'dynamic_resolution'.
+        @remarks
+            These textures keep the size they are created with, but are only rendered
+            to in their top left area, scaled by this in each dimension. Quads reading
+            them sample the same area, so a render_quad pass into a target which isn't
+            scaled upscales them. Changing the scale doesn't reallocate anything.
+        @param scale
+            Scale in ]0;1], defaults to 1.
+        */
+        void setResolutionScale(Real scale);
+        /** Get the resolution scale of the textures declared with 'dynamic_resolution'. */
+        Real getResolutionScale() const { return mResolutionScale; }
+
+        /** Let the chain adjust the resolution scale every frame to meet a frame time.
+        @remarks
+            The frame time is measured between updates of the chain, and the scale is
+            moved towards the one whose pixel count would meet the target, on the basis
+            that the cost of the scaled targets grows with their area. The frame time
+            includes waiting for vertical sync, so set the target slightly above the
+            refresh interval or disable vsync.
+        @param targetFrameTime
+            Frame time to aim for in seconds, 0 to stop adjusting the scale.
+        @param minScale
+            The lowest resolution scale to go down to.
+        */
+        void setDynamicResolution(Real targetFrameTime, Real minScale = 0.5f);
+        /** Get the frame time the resolution scale is adjusted for, 0 if it isn't. */
+        Real getDynamicResolutionFrameTime() const { return mTargetFrameTime; }
+
     protected:
         /// Viewport affected by this CompositorChain
         Viewport *mViewport;
@@ -185,6 +214,11 @@ namespace Ogre {
 
         /** Clear compiled state */
         void clearCompiledState();
+
+        /** Remove target operations whose results are never read, if enabled, and
+            merge consecutive operations on the same target into one update.
+        */
+        void optimiseCompiledState();
         
         /** Prepare a viewport, the camera and the scene for a rendering operation
         */
@@ -247,6 +281,17 @@ namespace Ogre {
         /// Store old shadows enabled flag
         bool mOldShadowsEnabled;
 
+        /// Scale of the dynamic resolution targets
+        Real mResolutionScale;
+        /// Frame time controller of the scale, 0 if not enabled
+        Real mTargetFrameTime;
+        Real mMinResolutionScale;
+        /// Time of the last chain update, in microseconds
+        unsigned long mLastUpdateTime;
+
+        /** Adjust the resolution scale to the time since the last update */
+        void updateResolutionScale();
+
     };
     /** @} */
     /** @} */
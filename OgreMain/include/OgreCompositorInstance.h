@@ -122,7 +122,9 @@ namespace Ogre {
                 target(inTarget), currentQueueGroupID(0), visibilityMask(0xFFFFFFFF),
                 lodBias(1.0f),
                 onlyInitial(false), hasBeenRendered(false), findVisibleObjects(false), 
-                materialScheme(MaterialManager::DEFAULT_SCHEME_NAME), shadowsEnabled(true)
+                materialScheme(MaterialManager::DEFAULT_SCHEME_NAME), shadowsEnabled(true),
+                localOutput(false), dynamicResolution(false),
+                dontCareBuffers(0), discardBuffers(0)
             { 
             }
             /// Target
@@ -164,6 +166,19 @@ namespace Ogre {
             String materialScheme;
             /** Whether shadows will be enabled */
             bool shadowsEnabled;
+            /** Render targets read as pass inputs by this op */
+            typedef set<RenderTarget*>::type RenderTargetSet;
+            RenderTargetSet inputTargets;
+            /** Whether the target is a local texture of the compositor, which
+                nothing outside of the chain reads through the compositor inputs,
+                and the only texture the op writes to */
+            bool localOutput;
+            /** Whether the target is rendered at the resolution scale of the chain */
+            bool dynamicResolution;
+            /** FrameBufferType mask of the buffers not loaded before this op */
+            unsigned int dontCareBuffers;
+            /** FrameBufferType mask of the buffers not stored after this op */
+            unsigned int discardBuffers;
         };
         typedef vector<TargetOperation>::type CompiledState;
         
@@ -335,6 +350,21 @@ namespace Ogre {
             in case we switch back. 
         */
         ReserveTextureMap mReserveTextures;
+        /// Definitions whose textures were taken from the CompositorManager pool.
+        typedef set<CompositionTechnique::TextureDefinition*>::type TextureDefinitionSet;
+        TextureDefinitionSet mPooledTextureDefs;
+
+        /** Range of target passes a local texture is in use for, numbered in
+            compile order with the output target pass last.
+        */
+        struct TextureLifetime
+        {
+            size_t first;
+            size_t last;
+            /// Whether the content may be needed from one frame to the next
+            bool persistent;
+        };
+        typedef map<String, TextureLifetime>::type TextureLifetimeMap;
 
         /// Vector of listeners.
         typedef vector<Listener*>::type Listeners;
@@ -362,6 +392,18 @@ namespace Ogre {
         */
         void freeResources(bool forResizeOnly, bool clearReserveTextures);
 
+        /** Work out which target passes each local texture of the technique is used in.
+        @remarks
+            Pooled textures whose lifetimes don't overlap can share the same memory.
+            Textures which are read before they are overwritten in a frame, only
+            rendered initially or not referenced at all are persistent and get the
+            whole frame.
+        */
+        void computeTextureLifetimes(TextureLifetimeMap& lifetimes);
+
+        /// Whether the textures of a definition are shared through the CompositorManager pool
+        bool isPooled(CompositionTechnique::TextureDefinition* def) const;
+
         /** Get RenderTarget for a named local texture.
         */
         RenderTarget *getTargetForTex(const String &name);
@@ -387,6 +429,12 @@ namespace Ogre {
         void deriveTextureRenderTargetOptions(const String& texname, 
             bool *hwGammaWrite, uint *fsaa, String* fsaaHint);
 
+        /// Get the usage of a local texture, with unordered access if a compute pass binds it as image
+        int deriveTextureUsage(const String& texname) const;
+
+        /// Whether a local texture is rendered at the resolution scale of the chain
+        bool isDynamicResolution(const String& texname) const;
+
         /// Notify this instance that the primary viewport's camera has changed.
         void notifyCameraChanged(Camera* camera);
 
@@ -124,8 +124,9 @@ namespace Ogre {
         void setCompositorEnabled(Viewport *vp, const String &compositor, bool value);
 
         /** Get a textured fullscreen 2D rectangle, for internal use.
+            @param uvScale The texture coordinates span [0;uvScale] in both directions.
         */
-        Renderable *_getTexturedRectangle2D();
+        Renderable *_getTexturedRectangle2D(Real uvScale = 1.0f);
 
         /** Overridden from ResourceManager since we have to clean up chains too. */
         void removeAll(void);
@@ -141,17 +142,48 @@ namespace Ogre {
             same requester already, in which case it won't give the same texture
             twice (this is important for example if you request 2 ping-pong textures, 
             you don't want to get the same texture for both requests!
+            The usage is a combination of TU_RENDERTARGET and TU_UNORDERED_ACCESS.
         */
         TexturePtr getPooledTexture(const String& name, const String& localName, 
             size_t w, size_t h, 
             PixelFormat f, uint aa, const String& aaHint, bool srgb, UniqueTextureSet& texturesAlreadyAssigned, 
-            CompositorInstance* inst, CompositionTechnique::TextureScope scope);
+            CompositorInstance* inst, CompositionTechnique::TextureScope scope,
+            int usage = TU_RENDERTARGET);
 
         /** Free pooled textures from the shared pool (compositor instances still 
             using them will keep them in memory though). 
         */
         void freePooledTextures(bool onlyIfUnreferenced = true);
 
+        /** Sets whether local textures which don't carry content from one frame
+            to the next are pooled, even without the 'pooled' option.
+        @remarks
+            Pooled textures are shared between compositor instances in all chains,
+            and within an instance between textures which are not in use by the
+            same target passes. Enabling this saves memory on long chains, but
+            the contents of a transient texture can no longer be accessed
+            outside of the target passes using it. Takes effect when the
+            compositor resources are next created. Disabled by default.
+        */
+        void setPoolTransientTextures(bool pool) { mPoolTransientTextures = pool; }
+
+        /// Gets whether local textures which don't carry content between frames are pooled
+        bool getPoolTransientTextures() const { return mPoolTransientTextures; }
+
+        /** Sets whether target passes rendering to local textures which no pass
+            of the chain reads are skipped.
+        @remarks
+            This saves the work of compositors whose intermediate results aren't
+            used with the current setup. Textures read by other means than the
+            inputs of a pass, e.g. through a 'content_type compositor' texture unit
+            or by a listener, must then be scoped to the chain or globally.
+            Takes effect when the chains are next compiled. Disabled by default.
+        */
+        void setCullUnusedTargetPasses(bool cull) { mCullUnusedTargetPasses = cull; }
+
+        /// Gets whether target passes whose results are never read are skipped
+        bool getCullUnusedTargetPasses() const { return mCullUnusedTargetPasses; }
+
         /** Register a compositor logic for listening in to expecting composition
             techniques.
         */
@@ -205,6 +237,10 @@ namespace Ogre {
         void freeChains();
 
         Rectangle2D *mRectangle;
+        /// The built in "HiZ" custom composition pass
+        HiZCompositionPass *mHiZPass;
+        /// Texture coordinate scale the rectangle was last set up with
+        Real mRectangleUVScale;
 
         /// List of instances
         typedef vector<CompositorInstance *>::type Instances;
@@ -228,9 +264,10 @@ namespace Ogre {
             uint fsaa;
             String fsaaHint;
             bool sRGBwrite;
+            int usage;
 
-            TextureDef(size_t w, size_t h, PixelFormat f, uint aa, const String& aaHint, bool srgb)
-                : width(w), height(h), format(f), fsaa(aa), fsaaHint(aaHint), sRGBwrite(srgb)
+            TextureDef(size_t w, size_t h, PixelFormat f, uint aa, const String& aaHint, bool srgb, int u)
+                : width(w), height(h), format(f), fsaa(aa), fsaaHint(aaHint), sRGBwrite(srgb), usage(u)
             {
 
             }
@@ -261,6 +298,8 @@ namespace Ogre {
                                 {
                                     if (!x.sRGBwrite && y.sRGBwrite)
                                         return true;
+                                    else if (x.sRGBwrite == y.sRGBwrite)
+                                        return x.usage < y.usage;
                                 }
 
                             }
@@ -279,6 +318,9 @@ namespace Ogre {
         
         ChainTexturesByDef mChainTexturesByDef;
 
+        bool mPoolTransientTextures;
+        bool mCullUnusedTargetPasses;
+
         bool isInputPreviousTarget(CompositorInstance* inst, const Ogre::String& localName);
         bool isInputPreviousTarget(CompositorInstance* inst, TexturePtr tex);
         bool isInputToOutputTarget(CompositorInstance* inst, const Ogre::String& localName);
@@ -56,8 +56,12 @@ namespace Ogre {
     class _OgreExport ControllerManager : public Singleton<ControllerManager>, public ControllerAlloc
     {
     protected:
-        typedef set<Controller<Real>*>::type ControllerList;
+        /// Controllers in a fixed order, so they update the same way every run
+        typedef vector<Controller<Real>*>::type ControllerList;
         ControllerList mControllers;
+        /// Position of each controller in mControllers
+        typedef OGRE_HashMap<Controller<Real>*, size_t> ControllerIndexMap;
+        ControllerIndexMap mControllerIndices;
 
         /// Global predefined controller
         ControllerValueRealPtr mFrameTimeController;
@@ -65,6 +69,9 @@ namespace Ogre {
         /// Global predefined controller
         ControllerFunctionRealPtr mPassthroughFunction;
 
+        /// Whether to update the controllers on the worker threads
+        bool mParallelUpdate;
+
         /// Last frame number updated
         unsigned long mLastFrameNumber;
 
@@ -87,9 +94,26 @@ namespace Ogre {
         void clearControllers(void);
 
         /** Updates all the registered controllers.
+        @remarks
+            The controllers are updated in the same order every frame, and
+            those reading the frame time source share a single read of it.
         */
         void updateAllControllers(void);
 
+        /** Sets whether to update the controllers on the worker threads of the
+            work queue (default false).
+        @remarks
+            Only enable this when the controllers are independent, meaning no two
+            of them write the same destination and no destination or function
+            touches shared state, as is the case for the texture animators,
+            scrollers and wave transformers of different texture units. The
+            updates are spread over the workers in chunks, so it only pays off
+            with many thousands of controllers.
+        */
+        void setParallelUpdate(bool parallel) { mParallelUpdate = parallel; }
+        /// Gets whether the controllers are updated on the worker threads
+        bool getParallelUpdate(void) const { return mParallelUpdate; }
+
 
         /** Returns a ControllerValue which provides the time since the last frame as a control value source.
         @remarks
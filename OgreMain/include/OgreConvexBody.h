@@ -56,6 +56,9 @@ namespace Ogre
 
     protected:
         PolygonList mPolygons;
+        /// Scratch lists of clip and extend, kept so that they do not allocate once grown
+        PolygonList mClipPolygons;
+        Polygon::EdgeList mEdges;
 
         // Static 'free list' of polygons to save reallocation, shared between all bodies
         static PolygonList msFreePolygons;
@@ -247,7 +250,7 @@ namespace Ogre
         @return True if a match was found
         */
         bool findAndEraseEdgePair(const Vector3& vec, 
-            Polygon::EdgeMap& intersectionEdges, Vector3& vNext ) const;
+            Polygon::EdgeList& intersectionEdges, Vector3& vNext ) const;
 
     };
     /** @} */
@@ -475,6 +475,35 @@ namespace Ogre {
         void setFreeOnClose(bool free) { mFreeOnClose = free; }
     };
 
+    /** Read-only MemoryDataStream over a file which is mapped into memory.
+    @remarks
+        Reading copies straight from the page cache, and getPtr() gives access
+        to the whole file without reading it first, so it can be parsed in
+        place. Not available on WinRT.
+    */
+    class _OgreExport MappedFileDataStream : public MemoryDataStream
+    {
+    protected:
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        /// File and file mapping object handles
+        void* mFileHandle;
+        void* mMappingHandle;
+#endif
+    public:
+        /** Map a file into memory.
+        @param name The name to give the stream
+        @param path The path of the file
+        @param size The size of the file in bytes, must not be 0
+        */
+        MappedFileDataStream(const String& name, const String& path, size_t size);
+
+        ~MappedFileDataStream();
+
+        /** @copydoc DataStream::close
+        */
+        void close(void);
+    };
+
     /** Common subclass of DataStream for handling data from 
         std::basic_istream.
     */
@@ -0,0 +1,131 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __DebugDrawer_H__
+#define __DebugDrawer_H__
+
+#include "OgrePrerequisites.h"
+
+#include "OgreRenderable.h"
+#include "OgreRenderOperation.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreColourValue.h"
+#include "OgreVector3.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Collects debug lines, boxes and spheres and draws them all at once.
+    @remarks
+        Each SceneManager has one, see SceneManager::getDebugDrawer. The primitives
+        are given in world space and gathered in system memory, then uploaded to one
+        dynamic vertex buffer and drawn as a single line list for each camera
+        rendering the scene. Primitives drawn by the application last for the
+        frame, so they should be drawn again every frame to remain visible.
+    @par
+        The scene managers draw the bounding boxes of scene nodes
+        (SceneManager::showBoundingBoxes) and their own debug boxes through it as
+        well. These are gathered while the scene is culled for a camera and are
+        only drawn for that camera.
+    */
+    class _OgreExport DebugDrawer : public Renderable, public DebugGeomAlloc
+    {
+    public:
+        DebugDrawer();
+        ~DebugDrawer();
+
+        /** Draws a line. */
+        void drawLine(const Vector3& start, const Vector3& end,
+            const ColourValue& colour = ColourValue::White);
+        /** Draws the edges of a box. */
+        void drawBox(const AxisAlignedBox& box, const ColourValue& colour = ColourValue::White);
+        /** Draws a sphere as three circles around its axes.
+        @param segments The number of lines per circle.
+        */
+        void drawSphere(const Sphere& sphere, const ColourValue& colour = ColourValue::White,
+            unsigned int segments = 16);
+
+        /** Removes all primitives drawn so far. */
+        void clear(void);
+        /** Gets the number of lines drawn so far. */
+        size_t getNumLines(void) const { return mVertices.size() / 2; }
+
+        /** Internal method, starts gathering the primitives of a render of the scene. */
+        void _beginScene(void);
+        /** Internal method, uploads the primitives and adds them to the render queue. */
+        void _queueForRendering(RenderQueue* queue);
+        /** Internal method, removes the primitives gathered since _beginScene. */
+        void _endScene(void);
+
+        /** @copydoc Renderable::getMaterial */
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+        /** @copydoc Renderable::getRenderOperation */
+        void getRenderOperation(RenderOperation& op) { op = mRenderOp; }
+        /** @copydoc Renderable::getWorldTransforms */
+        void getWorldTransforms(Matrix4* xform) const;
+        /** @copydoc Renderable::getSquaredViewDepth */
+        Real getSquaredViewDepth(const Camera* cam) const { return 0; }
+        /** @copydoc Renderable::getLights */
+        const LightList& getLights(void) const;
+
+    protected:
+        /// A line end
+        struct Vertex
+        {
+            Vector3 position;
+            ColourValue colour;
+        };
+        typedef vector<Vertex>::type VertexList;
+
+        VertexList mVertices;
+        /// First vertex gathered for the current render of the scene
+        size_t mSceneStart;
+        /// Frame the primitives belong to
+        unsigned long mFrameNumber;
+        RenderOperation mRenderOp;
+        MaterialPtr mMaterial;
+
+        /// Drops the primitives of past frames
+        void checkFrame(void);
+        void addVertex(const Vector3& position, const ColourValue& colour);
+        /// Creates the vertex data and material on first use
+        void createResources(void);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
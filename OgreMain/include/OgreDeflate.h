@@ -108,6 +108,16 @@ namespace Ogre
             will actually be executed as passthroughs as a fallback. 
         */
         bool isCompressedStreamValid() const { return mIsCompressedValid; }
+
+        /** Compresses a block of memory at once, in the format this stream reads.
+        @remarks
+            Unlike writing through the stream, this needs no temporary file and
+            may be called from several threads at once.
+        @param data The data to compress
+        @param size The size of the data in bytes
+        @param compressed Receives the compressed data
+        */
+        static void compressData(const void* data, size_t size, vector<uint8>::type& compressed);
         
         /** @copydoc DataStream::read
          */
@@ -0,0 +1,173 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __DynamicRenderBatch_H__
+#define __DynamicRenderBatch_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreRenderable.h"
+#include "OgreRenderOperation.h"
+#include "OgreMatrix4.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup RenderSystem
+    *  @{
+    */
+    /** Small renderables sharing a pass, drawn together from one dynamic buffer.
+    @remarks
+        When dynamic batching is enabled on the SceneManager, renderables which
+        are drawn with the same pass and qualify (see isBatchable) are gathered
+        here instead of being drawn one by one. When the pass changes, or the
+        queue has been rendered, their vertices are transformed to world space
+        on the CPU and written with their indices into a shared vertex and index
+        buffer, which is then drawn once with an identity world transform.
+    @par
+        This trades CPU time for fewer draw calls, so it only pays off for
+        renderables with few vertices. The source buffers are read every time
+        the batch is built, so they must have a shadow buffer or be in system
+        memory, which is the default for meshes.
+    */
+    class _OgreExport DynamicRenderBatch : public Renderable, public RenderQueueAlloc
+    {
+    public:
+        DynamicRenderBatch();
+        ~DynamicRenderBatch();
+
+        /** Sets the maximum number of vertices a renderable may have to be batched. */
+        void setVertexLimit(size_t limit) { mVertexLimit = limit; }
+        /** Gets the maximum number of vertices a renderable may have to be batched. */
+        size_t getVertexLimit(void) const { return mVertexLimit; }
+
+        /** Returns whether a renderable may be batched when drawn with a pass.
+        @remarks
+            The pass must allow dynamic batching and not be iterated per light.
+            The renderable must have a single world transform, no texture
+            overrides or custom parameters and use the normal view and
+            projection. Its render operation must be a non instanced triangle
+            list without hardware animation and within the vertex limit, whose
+            buffers can be read back. Positions, normals, tangents and
+            binormals must be 3 floats, tangents may also be 4.
+        @param op Receives the render operation of the renderable
+        */
+        bool isBatchable(Renderable* rend, const Pass* pass, RenderOperation& op) const;
+
+        /** Returns whether a batchable renderable can join the renderables
+            gathered so far, which requires the same pass, rendering flags,
+            vertex declaration and lights, and room in 16 bit indices.
+        @param op The render operation returned by isBatchable
+        */
+        bool isCompatible(Renderable* rend, const RenderOperation& op, const Pass* pass,
+            bool scissoring, bool autoLights, const LightList* manualLightList) const;
+
+        /** Gathers a renderable, which must be batchable and compatible.
+        @param op The render operation returned by isBatchable
+        */
+        void add(Renderable* rend, const RenderOperation& op, const Pass* pass,
+            bool scissoring, bool autoLights, const LightList* manualLightList);
+
+        /** Transforms the gathered renderables into the shared buffers.
+        @param origin Position to write the vertices relative to, which becomes
+            the translation of the batch, for camera relative rendering
+        @param flipNegativeScale Whether to flip the winding of renderables with a
+            negative scale, see SceneManager::setFlipCullingOnNegativeScale
+        */
+        void build(const Vector3& origin, bool flipNegativeScale);
+
+        /** Forgets the gathered renderables. */
+        void clear(void);
+
+        /** Gets the number of renderables gathered. */
+        size_t getNumRenderables(void) const { return mEntries.size(); }
+        /** Gets a gathered renderable. */
+        Renderable* getRenderable(size_t index) const { return mEntries[index].renderable; }
+        /** Gets the pass the gathered renderables are drawn with. */
+        const Pass* getPass(void) const { return mPass; }
+        /** Gets whether the batch is drawn with light scissoring and clipping. */
+        bool getScissoring(void) const { return mScissoring; }
+        /** Gets whether the batch is drawn iterating over its lights. */
+        bool getAutoLights(void) const { return mAutoLights; }
+        /** Gets the manual light list the batch is drawn with, if any. */
+        const LightList* getManualLightList(void) const { return mManualLightList; }
+
+        /// @copydoc Renderable::getMaterial
+        const MaterialPtr& getMaterial(void) const;
+        /// @copydoc Renderable::getRenderOperation
+        void getRenderOperation(RenderOperation& op);
+        /// @copydoc Renderable::getWorldTransforms
+        void getWorldTransforms(Matrix4* xform) const;
+        /// @copydoc Renderable::getSquaredViewDepth
+        Real getSquaredViewDepth(const Camera* cam) const { return 0; }
+        /// @copydoc Renderable::getLights
+        const LightList& getLights(void) const;
+
+    protected:
+        /// A gathered renderable with what is needed to transform it
+        struct Entry
+        {
+            Renderable* renderable;
+            RenderOperation op;
+            Matrix4 transform;
+        };
+        typedef vector<Entry>::type EntryList;
+
+        EntryList mEntries;
+        size_t mVertexLimit;
+        /// Vertices and indices of the gathered renderables
+        size_t mNumVertices;
+        size_t mNumIndices;
+        /// The flags the batch is rendered with
+        const Pass* mPass;
+        bool mScissoring;
+        bool mAutoLights;
+        const LightList* mManualLightList;
+        /// Lights of the first renderable gathered
+        LightList mLights;
+        bool mPolygonModeOverrideable;
+
+        /// The shared buffers and the operation drawing them
+        RenderOperation mRenderOp;
+        VertexData* mVertexData;
+        IndexData* mIndexData;
+        Matrix4 mTransform;
+
+        /// Makes the declaration of the shared buffer match one of the renderables
+        void updateDeclaration(const VertexDeclaration* decl);
+    };
+
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define __EdgeListBuilder_H__
 
 #include "OgrePrerequisites.h"
+#include "OgreCommon.h"
 #include "OgreRenderOperation.h"
 #include "OgreVector3.h"
 #include "OgreVector4.h"
@@ -192,6 +193,14 @@ namespace Ogre {
         void addIndexData(const IndexData* indexData, size_t vertexSet = 0, 
             RenderOperation::OperationType opType = RenderOperation::OT_TRIANGLE_LIST);
 
+        /** Reads the positions and indexes of the geometry added so far into system memory.
+        @remarks
+            Called by build unless it was called beforehand. Reading locks the buffers, so
+            it has to happen on a thread allowed to, while build then only works on the
+            copies and may run on any thread, e.g. to build several edge lists at once.
+        */
+        void readGeometry(void);
+
         /** Builds the edge information based on the information built up so far.
         @remarks
             The caller takes responsibility for deleting the returned structure.
@@ -220,6 +229,7 @@ namespace Ogre {
             size_t indexSet;            /// The index data set this geometry data refers to
             const IndexData* indexData; /// The index information which describes the triangles.
             RenderOperation::OperationType opType;  /// The operation type used to render this geometry
+            vector<uint32>::type indexes;   /// The triangles, 3 indexes each, read by readGeometry
         };
         /** Comparator for sorting geometries by vertex set */
         struct geometryLess {
@@ -230,15 +240,20 @@ namespace Ogre {
                 return a.indexSet < b.indexSet;
             }
         };
-        /** Comparator for unique vertex list */
-        struct vectorLess {
-            bool operator()(const Vector3& a, const Vector3& b) const
+        /** Hash function for unique vertex list */
+        struct vectorHash {
+            size_t operator()(const Vector3& v) const
             {
-                if (a.x < b.x) return true;
-                if (a.x > b.x) return false;
-                if (a.y < b.y) return true;
-                if (a.y > b.y) return false;
-                return a.z < b.z;
+                // Adding zero turns -0 into +0, as they compare equal they must hash the same
+                Real p[3] = { v.x + 0, v.y + 0, v.z + 0 };
+                return FastHash(reinterpret_cast<const char*>(p), sizeof(p));
+            }
+        };
+        /** Hash function for edge map */
+        struct edgeHash {
+            size_t operator()(const std::pair<size_t, size_t>& e) const
+            {
+                return HashCombine(HashCombine(0, e.first), e.second);
             }
         };
 
@@ -248,18 +263,29 @@ namespace Ogre {
 
         GeometryList mGeometryList;
         VertexDataList mVertexDataList;
+        /// The positions of each vertex set, 3 floats per vertex, read by readGeometry
+        vector<vector<float>::type>::type mPositions;
+        bool mGeometryRead;
         CommonVertexList mVertices;
         EdgeData* mEdgeData;
         /// Map for identifying common vertices
-        typedef map<Vector3, size_t, vectorLess>::type CommonVertexMap;
+        typedef OGRE_HashMap<Vector3, size_t, vectorHash> CommonVertexMap;
         CommonVertexMap mCommonVertexMap;
         /** Edge map, used to connect edges. Note we allow many triangles on an edge,
         after connected an existing edge, we will remove it and never used again.
         */
-        typedef multimap< std::pair<size_t, size_t>, std::pair<size_t, size_t> >::type EdgeMap;
+        typedef OGRE_HashMap<std::pair<size_t, size_t>, std::pair<size_t, size_t>, edgeHash> EdgeMap;
         EdgeMap mEdgeMap;
+        /** Open edges sharing the vertices of one already in the edge map, in the order
+            they were created. Only non manifold meshes have any, the first one takes
+            the place of the mapped edge once that is connected.
+        */
+        typedef multimap< std::pair<size_t, size_t>, std::pair<size_t, size_t> >::type EdgeOverflowMap;
+        EdgeOverflowMap mEdgeOverflowMap;
 
         void buildTrianglesEdges(const Geometry &geometry);
+        /// Reads the indexes of a geometry as triangles
+        void readIndexes(Geometry& geometry);
 
         /// Finds an existing common vertex, or inserts a new one
         size_t findOrCreateCommonVertex(const Vector3& vec, size_t vertexSet, 
@@ -113,6 +113,10 @@ namespace Ogre {
         TempBlendedBufferInfo mTempSkelAnimInfo;
         /// Vertex data details for software skeletal anim of shared geometry
         VertexData* mSkelAnimVertexData;
+        /// Copy of the shared geometry skinned on the GPU instead, see GpuSkinningBatch
+        GpuSkinnedVertexData* mGpuSkinnedVertexData;
+        /// Whether the last software skeletal anim was done on the GPU
+        bool mGpuSkinned;
         /// Temp buffer details for software vertex anim of shared geometry
         TempBlendedBufferInfo mTempVertexAnimInfo;
         /// Vertex data details for software vertex anim of shared geometry
@@ -180,8 +184,17 @@ namespace Ogre {
         /// Records the last frame in which animation was updated.
         unsigned long mFrameAnimationLastUpdated;
 
-        /// Perform all the updates required for an animated entity.
-        void updateAnimation(void);
+        /** Perform all the updates required for an animated entity.
+        @param offscreen True if the entity is not seen by the camera, only by shadows,
+            in which case the pose is only evaluated as often as setOffscreenAnimationInterval says.
+        */
+        void updateAnimation(bool offscreen = false);
+        /// Whether the pose should be evaluated for an off-screen update in this frame
+        bool isOffscreenPoseDue(void);
+        /// Whether the entity has been off-screen since before the last frame
+        bool isOffscreen(void) const;
+        /// Sample the skeletal animations to compute mAnimatedBounds
+        void updateAnimatedBounds(void) const;
 
         /// Records the last frame in which the bones was updated.
         /// It's a pointer because it can be shared between different entities with
@@ -224,6 +237,27 @@ namespace Ogre {
         bool mAlwaysUpdateMainSkeleton;
         /// Flag indicating whether to update the bounding box from the bones of the skeleton.
         bool mUpdateBoundingBoxFromSkeleton;
+        /// Frames between pose evaluations while the entity is off-screen, see setOffscreenAnimationInterval
+        unsigned int mOffscreenAnimationInterval;
+        /// Frame the entity was last queued for a camera other than a shadow camera
+        unsigned long mFrameLastVisible;
+        /// Frame the pose was last evaluated while the entity was off-screen
+        unsigned long mFrameOffscreenAnimated;
+        /// Bounds enclosing all skeletal animations, used while off-screen
+        mutable AxisAlignedBox mAnimatedBounds;
+        mutable bool mAnimatedBoundsDirty;
+        /// Cache sharing evaluated bone matrices with other entities, if any
+        SkeletonAnimationCache* mSkeletonAnimationCache;
+        /// Drawn instead of the entity beyond mImpostorLodValue, if any
+        Impostor* mImpostor;
+        /// LOD value the impostor is drawn from, transformed by the mesh LOD strategy
+        Real mImpostorLodValue;
+        /// Whether the impostor is drawn for the current camera
+        bool mImpostorActive;
+        /// Fraction of each LOD over which the vertices morph into the next one
+        Real mLodMorphRange;
+        /// Morph factor towards the next LOD for the current camera
+        Real mLodMorphFactor;
 
 #if !OGRE_NO_MESHLOD
         /// The LOD number of the mesh to use, calculated by _notifyCurrentCamera.
@@ -318,6 +352,8 @@ namespace Ogre {
         mutable AxisAlignedBox mFullBoundingBox;  // note: this exists only so that getBoundingBox() can return an AAB by reference
 
         ShadowRenderableList mShadowRenderables;
+        /// Shadow volumes kept for reuse when not animated
+        ShadowVolumeCacheMap mShadowVolumeCaches;
 
         /** Nested class to allow entity shadows. */
         class _OgreExport EntityShadowRenderable : public ShadowRenderable
@@ -555,7 +591,46 @@ namespace Ogre {
             LOD will be limited by the number of LOD indexes used in the Material).
         */
         void setMaterialLodBias(Real factor, ushort maxDetailIndex = 0, ushort minDetailIndex = 99);
+
+        /** Sets how gradually the mesh of this entity changes into its next LOD.
+        @remarks
+            Switching LOD levels makes the mesh visibly pop, unless the LOD
+            distances are conservative. When the mesh has LOD morph targets (see
+            LodConfig::Advanced::useMorphTargets) the vertices can instead slide
+            to where they collapse at the next level over the end of each level,
+            so that the switch itself changes nothing on screen. This sets the
+            morph factor passed in the SubMesh::LOD_MORPH_CUSTOM_PARAMETER
+            custom parameter; the material has to do the blending, for instance
+            with the RTSS 'lod_morph' sub render state.
+        @param range Fraction of the LOD range, before the switch to the next
+            level, over which the vertices morph; 0 (the default) disables
+            morphing and 1 morphs over the whole range.
+        */
+        void setLodMorphRange(Real range);
+        /** Gets the fraction of the LOD range over which the vertices morph. */
+        Real getLodMorphRange(void) const { return mLodMorphRange; }
+        /** Gets the morph factor towards the next LOD for the last camera. */
+        Real getLodMorphFactor(void) const { return mLodMorphFactor; }
 #endif
+        /** Sets an impostor to draw instead of this entity in the distance.
+        @remarks
+            Beyond the given LOD value the entity is drawn as a camera facing quad
+            showing the impostor's picture of the mesh, together with the other
+            entities using the impostor (see ImpostorBatcher). The impostor is
+            generated if it wasn't yet, so call this outside of rendering.
+        @param impostor The impostor of the mesh of this entity, or 0 to stop
+            using one. It must not be destroyed while the entity uses it.
+        @param lodValue The LOD value beyond which the impostor is drawn, in the
+            terms of the LOD strategy of the mesh, such as a distance
+        */
+        void setImpostor(Impostor* impostor, Real lodValue);
+        /** Gets the impostor drawn instead of this entity in the distance, if any. */
+        Impostor* getImpostor(void) const { return mImpostor; }
+        /** Returns whether the impostor is drawn instead of this entity for the
+            last camera the entity was visible to.
+        */
+        bool isImpostorActive(void) const { return mImpostorActive; }
+
         /** Sets whether the polygon mode of this entire entity may be
             overridden by the camera detail settings.
         */
@@ -874,6 +949,24 @@ namespace Ogre {
             return mAlwaysUpdateMainSkeleton;
         }
 
+        /** Shares the evaluated bone matrices with other entities using the same cache.
+        @remarks
+            When several entities of the same skeleton play the same animation states,
+            only the first one updated in a frame evaluates its skeleton, the others
+            copy its bone matrices. Unlike shareSkeletonInstanceWith, the entities keep
+            their own animation states and only share a pose while these match.
+            Ignored while objects are attached to bones, bones are manually controlled,
+            the skeleton is displayed or the bounding box is updated from the skeleton,
+            since those need the bones of this entity's own SkeletonInstance.
+        @param cache The cache to use, or 0 to stop sharing. It is not owned by the
+            entity and must outlive it, or be reset to 0 first.
+        @see SkeletonAnimationCache
+        */
+        void setSkeletonAnimationCache(SkeletonAnimationCache* cache) { mSkeletonAnimationCache = cache; }
+
+        /** Gets the cache sharing the evaluated bone matrices, if any. */
+        SkeletonAnimationCache* getSkeletonAnimationCache(void) const { return mSkeletonAnimationCache; }
+
         /** If true, the skeleton of the entity will be used to update the bounding box for culling.
             Useful if you have skeletal animations that move the bones away from the root.  Otherwise, the
             bounding box of the mesh in the binding pose will be used.
@@ -892,6 +985,23 @@ namespace Ogre {
             return mUpdateBoundingBoxFromSkeleton;
         }
 
+        /** Sets how often the pose of the entity is evaluated while it is off-screen.
+        @remarks
+            An animated entity which is not seen by any camera may still need its animation
+            updated, for instance to cast stencil shadows or to be rendered into shadow
+            textures. With an interval above 1 the skeleton is only evaluated every so
+            many frames in that case, in between the last pose is reused. While the entity
+            is off-screen, bounds from the skeleton (see setUpdateBoundingBoxFromSkeleton)
+            are replaced by conservative bounds enclosing all the skeletal animations of
+            the mesh, sampled once, so that it is still found visible as soon as it would
+            show up on screen.
+        @param interval Frames between evaluations, 1 evaluates every frame as before and
+            0 never evaluates the pose while off-screen.
+        */
+        void setOffscreenAnimationInterval(unsigned int interval) { mOffscreenAnimationInterval = interval; }
+        /** Gets how often the pose of the entity is evaluated while it is off-screen. */
+        unsigned int getOffscreenAnimationInterval(void) const { return mOffscreenAnimationInterval; }
+
         
     };
 
@@ -120,7 +120,23 @@ namespace Ogre {
             return msIgnoreHidden;
         }
 
+        /** Set the size from which files opened read-only are mapped into memory
+            and returned as a MappedFileDataStream, or 0 to never map them.
+            The default is 1 MiB.
+        */
+        static void setMemoryMapThreshold(size_t size)
+        {
+            msMemoryMapThreshold = size;
+        }
+
+        /// Get the size from which files opened read-only are mapped into memory
+        static size_t getMemoryMapThreshold()
+        {
+            return msMemoryMapThreshold;
+        }
+
         static bool msIgnoreHidden;
+        static size_t msMemoryMapThreshold;
     };
 
     /** Specialisation of ArchiveFactory for FileSystem files. */
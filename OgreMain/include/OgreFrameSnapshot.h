@@ -0,0 +1,137 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __FrameSnapshot_H__
+#define __FrameSnapshot_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreFrameListener.h"
+#include "OgreVector3.h"
+#include "OgreVector4.h"
+#include "OgreQuaternion.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** Changes to the scene recorded away from the render thread, to be applied
+        between two frames.
+    @remarks
+        The snapshot only holds pointers to the nodes, objects and renderables it
+        changes, these must stay alive until it has been applied.
+    */
+    class _OgreExport FrameSnapshot : public UtilityAlloc
+    {
+    public:
+        /// Record the transform of a node
+        void setTransform(Node* node, const Vector3& position,
+            const Quaternion& orientation, const Vector3& scale = Vector3::UNIT_SCALE);
+        /// Record the visibility of a movable object
+        void setVisible(MovableObject* object, bool visible);
+        /// Record a custom parameter of a renderable, see Renderable::setCustomParameter
+        void setCustomParameter(Renderable* renderable, size_t index, const Vector4& value);
+
+        /** Apply the recorded changes.
+        @remarks
+            Must be called from the thread rendering the scene, while it is not
+            being rendered.
+        */
+        void apply();
+        /// Forget the recorded changes
+        void clear();
+        /// Returns whether nothing was recorded
+        bool isEmpty() const;
+        /// Exchange the recorded changes with another snapshot
+        void swap(FrameSnapshot& other);
+
+    protected:
+        struct NodeTransform
+        {
+            Node* node;
+            Vector3 position;
+            Quaternion orientation;
+            Vector3 scale;
+        };
+        struct ObjectVisibility
+        {
+            MovableObject* object;
+            bool visible;
+        };
+        struct CustomParameter
+        {
+            Renderable* renderable;
+            size_t index;
+            Vector4 value;
+        };
+        vector<NodeTransform>::type mTransforms;
+        vector<ObjectVisibility>::type mVisibilities;
+        vector<CustomParameter>::type mParameters;
+    };
+
+    /** Simulation of the next frame, run while the current one is rendered.
+    @remarks
+        Set with Root::setFrameSimulation. Each Root::renderOneFrame then starts
+        simulate for the next frame on a worker thread of the Root WorkQueue,
+        applies the snapshot the previous call simulated, and renders. So what is
+        displayed lags the simulation by one frame, and the simulation of frame
+        N+1 overlaps the culling and submission of frame N.
+    @par
+        Threading rules: simulate runs concurrently with everything the render
+        thread does, including frame listeners, SceneManager updates and
+        RenderSystem calls. It must therefore not call into SceneManager, nodes,
+        movable objects, resources or the RenderSystem, not even to read them,
+        since they are not thread safe. It may only use its own state, and hand
+        its results over through the snapshot. All other Ogre calls are made
+        from the render thread as usual, frame listeners included. The render
+        thread is the thread calling Root::renderOneFrame, which must be the one
+        which created the render system, as the GL and D3D contexts are bound to
+        it.
+    */
+    class _OgreExport FrameSimulation
+    {
+    public:
+        virtual ~FrameSimulation() {}
+
+        /** Simulate a frame, called from a worker thread.
+        @param evt The time elapsed since the previous frame was simulated.
+        @param snapshot Receives the changes to the scene, empty on entry.
+        */
+        virtual void simulate(const FrameEvent& evt, FrameSnapshot& snapshot) = 0;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
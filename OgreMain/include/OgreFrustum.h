@@ -471,6 +471,34 @@ namespace Ogre
         */
         virtual bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const;
 
+        /** Tests whether each of a batch of bounding boxes is visible in the Frustum.
+        @remarks
+            Gives the same results as isVisible(const AxisAlignedBox&, FrustumPlane*) for
+            each box, but tests several boxes at once using the SIMD routines of
+            OptimisedUtil. Subclasses which override that method to cull differently
+            should override this one as well.
+        @param bounds
+            The boxes (world space), packed with packBounds into an array of
+            getPackedBoundsSize floats. Must be aligned to SIMD alignment,
+            e.g. allocated with OGRE_MALLOC_SIMD.
+        @param numBoxes
+            Number of boxes in the batch.
+        @param visibility
+            Array of (numBoxes + 31) / 32 words, bit (i % 32) of visibility[i / 32] is set
+            if box i is visible.
+        */
+        virtual void isVisible(const float* bounds, size_t numBoxes, uint32* visibility) const;
+
+        /// Number of floats needed to pack the given number of boxes for the batched isVisible
+        static size_t getPackedBoundsSize(size_t numBoxes) { return ((numBoxes + 3) / 4) * 24; }
+
+        /** Stores a box at the given index of a batch for the batched isVisible.
+        @remarks
+            Null boxes are stored so they are never visible, and infinite boxes so they
+            always are, as for the single box test.
+        */
+        static void packBounds(const AxisAlignedBox& box, size_t index, float* bounds);
+
         /// Overridden from MovableObject::getTypeFlags
         uint32 getTypeFlags(void) const;
 
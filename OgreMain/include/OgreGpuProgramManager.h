@@ -200,6 +200,12 @@ namespace Ogre {
         */
         virtual const SharedParametersMap& getAvailableSharedParameters() const;
 
+        /** Releases the buffers the RenderSystem gave to the shared parameter
+            sets, see GpuSharedParameters::_setHardwareBuffer. Called by the
+            RenderSystem before it destroys its hardware buffers.
+        */
+        void _releaseSharedParametersBuffers(void);
+
         /** Get if the microcode of a shader should be saved to a cache
         */
         bool getSaveMicrocodesToCache();
@@ -537,6 +537,36 @@ namespace Ogre {
         static bool msGenerateAllConstantDefinitionArrayEntries;
     };
 
+    /** A named constant resolved once, so that it can be set without looking up its name.
+        @remarks
+        Handles are returned by GpuProgramParameters::getConstantHandle and
+        GpuSharedParameters::getConstantHandle. As they refer to the buffer position
+        of the constant, a handle from one GpuProgramParameters object can be used with
+        all the parameters of the same program, until the program is reloaded.
+    */
+    struct _OgreExport GpuConstantHandle
+    {
+        /// Physical start index in buffer, max for a constant which was not found
+        size_t physicalIndex;
+        /// Number of raw buffer slots per element
+        size_t elementSize;
+        /// Length of array
+        size_t arraySize;
+
+        GpuConstantHandle()
+            : physicalIndex((std::numeric_limits<size_t>::max)())
+            , elementSize(0)
+            , arraySize(0) {}
+
+        explicit GpuConstantHandle(const GpuConstantDefinition& def)
+            : physicalIndex(def.physicalIndex)
+            , elementSize(def.elementSize)
+            , arraySize(def.arraySize) {}
+
+        /// Returns false if the constant was not found, setting it does nothing then
+        bool isValid() const { return physicalIndex != (std::numeric_limits<size_t>::max)(); }
+    };
+
     /// Simple class for loading / saving GpuNamedConstants
     class _OgreExport GpuNamedConstantsSerializer : public Serializer
     {
@@ -609,6 +639,58 @@ namespace Ogre {
     // typedef vector<bool>::type BoolConstantList;
     // typedef deque<bool>::type BoolConstantList;
 
+    /** A list of constants shared between copies until one of them changes it.
+        @remarks
+        Copying the list shares the storage, edit makes a copy of the storage for this
+        list first if it is shared. Lists holding the same values can be made to share
+        their storage with shareWith.
+    */
+    template <typename T> class SharedConstantList
+    {
+    public:
+        typedef typename vector<T>::type List;
+
+        /// Returns the constants for reading
+        const List& get() const { return mList ? *mList : emptyList(); }
+        /// Returns the constants for changing, which this list then owns alone
+        List& edit()
+        {
+            if (!mList)
+                mList = SharedPtr<List>(OGRE_NEW_T(List, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+            else if (!mList.unique())
+                mList = SharedPtr<List>(OGRE_NEW_T(List, MEMCATEGORY_GENERAL)(*mList), SPFM_DELETE_T);
+            return *mList;
+        }
+        /// Replaces the constants by a copy of the given ones
+        void assign(const List& list) { edit() = list; }
+        size_t size() const { return mList ? mList->size() : 0; }
+        /// Returns whether the storage is used by other lists too
+        bool isShared() const { return mList && !mList.unique(); }
+        /// Returns whether this list uses the storage of the other one
+        bool sharesWith(const SharedConstantList& other) const { return mList && mList.get() == other.mList.get(); }
+        /** Makes this list use the storage of another one holding the same values.
+            @return false if the values differ or the storage is already the same
+        */
+        bool shareWith(const SharedConstantList& other)
+        {
+            if (!mList || !other.mList || mList.get() == other.mList.get() ||
+                mList->size() != other.mList->size() ||
+                (!mList->empty() && memcmp(&(*mList)[0], &(*other.mList)[0], sizeof(T) * mList->size()) != 0))
+                return false;
+            mList = other.mList;
+            return true;
+        }
+
+    private:
+        SharedPtr<List> mList;
+
+        static const List& emptyList()
+        {
+            static const List empty;
+            return empty;
+        }
+    };
+
     /** A group of manually updated parameters that are shared between many parameter sets.
         @remarks
         Sometimes you want to set some common parameters across many otherwise
@@ -654,6 +736,23 @@ namespace Ogre {
 
         bool mDirty;
 
+        /// Where a named constant lives in the hardware buffer.
+        struct HardwareBufferEntry
+        {
+            String name;
+            /// Byte offset of the first element
+            size_t offset;
+            /// Bytes between array elements, 0 when they are tightly packed
+            size_t arrayStride;
+        };
+        typedef vector<HardwareBufferEntry>::type HardwareBufferLayout;
+
+        /// Buffer the RenderSystem binds the parameters from, if any.
+        HardwareUniformBufferSharedPtr mHardwareBuffer;
+        HardwareBufferLayout mHardwareBufferLayout;
+        /// Staging copy of the buffer contents, kept to avoid reallocating on every upload.
+        vector<uchar>::type mHardwareBufferData;
+
     public:
         GpuSharedParameters(const String& name);
 
@@ -712,6 +811,34 @@ namespace Ogre {
         /// Get the frame in which this shared parameter set was last updated
         size_t getFrameLastUpdated() const { return mFrameLastUpdated; }
 
+        /** Internal method the RenderSystem uses to give the set a buffer of its
+            own, which programs declaring a uniform block or constant buffer
+            named after the set read from directly.
+            @remarks
+            The values are then uploaded once whenever they change, by
+            _updateHardwareBuffer, instead of being copied into the parameters
+            of every program using them. Setting a null buffer releases it,
+            which the RenderSystem must do before its buffers are destroyed.
+        */
+        void _setHardwareBuffer(const HardwareUniformBufferSharedPtr& buffer);
+
+        /// Get the buffer set by _setHardwareBuffer, if any.
+        const HardwareUniformBufferSharedPtr& _getHardwareBuffer() const { return mHardwareBuffer; }
+
+        /** Internal method recording where a named constant lives in the
+            hardware buffer, as laid out by the program declaring it.
+            @param name The name of the constant
+            @param offset The byte offset of its first element
+            @param arrayStride The bytes between its array elements, or 0 when
+            they are tightly packed
+        */
+        void _setHardwareBufferOffset(const String& name, size_t offset, size_t arrayStride = 0);
+
+        /** Internal method writing the values to the hardware buffer if they
+            changed since the last call, and marking the set clean.
+        */
+        void _updateHardwareBuffer();
+
         /** Gets an iterator over the named GpuConstantDefinition instances as defined
             by the user.
         */
@@ -752,6 +879,26 @@ namespace Ogre {
         // /* @copydoc GpuProgramParameters::setNamedConstant(const String& name, const bool *val, size_t count) */
         // void setNamedConstant(const String& name, const bool *val, size_t count);
 
+        /** Resolves a named constant for the handle overloads of setNamedConstant.
+            @return An invalid handle if there is no constant with this name
+        */
+        GpuConstantHandle getConstantHandle(const String& name) const;
+
+        /// Sets a constant resolved by getConstantHandle, see setNamedConstant(const String& name, Real val)
+        void setNamedConstant(const GpuConstantHandle& handle, Real val);
+        void setNamedConstant(const GpuConstantHandle& handle, int val);
+        void setNamedConstant(const GpuConstantHandle& handle, uint val);
+        void setNamedConstant(const GpuConstantHandle& handle, const Vector4& vec);
+        void setNamedConstant(const GpuConstantHandle& handle, const Vector3& vec);
+        void setNamedConstant(const GpuConstantHandle& handle, const Vector2& vec);
+        void setNamedConstant(const GpuConstantHandle& handle, const Matrix4& m);
+        void setNamedConstant(const GpuConstantHandle& handle, const Matrix4* m, size_t numEntries);
+        void setNamedConstant(const GpuConstantHandle& handle, const float *val, size_t count);
+        void setNamedConstant(const GpuConstantHandle& handle, const double *val, size_t count);
+        void setNamedConstant(const GpuConstantHandle& handle, const ColourValue& colour);
+        void setNamedConstant(const GpuConstantHandle& handle, const int *val, size_t count);
+        void setNamedConstant(const GpuConstantHandle& handle, const uint *val, size_t count);
+
         /// Get a pointer to the 'nth' item in the float buffer
         float* getFloatPointer(size_t pos) { _markDirty(); return &mFloatConstants[pos]; }
         /// Get a pointer to the 'nth' item in the float buffer
@@ -1409,6 +1556,13 @@ namespace Ogre {
             ACT_LOD_CAMERA_POSITION_OBJECT_SPACE,
             /** Binds custom per-light constants to the shaders. */
             ACT_LIGHT_CUSTOM,
+            /** Provides the part of its texture a texture projection frustum
+                maps to, which is the region of a shadow texture in the shadow
+                atlas (see SceneManager::setShadowTextureAtlas), and the whole
+                texture otherwise. Requires an index like ACT_TEXTURE_VIEWPROJ_MATRIX.
+                Passed as float4(left, top, right, bottom) in texture coordinates.
+            */
+            ACT_TEXTURE_VIEWPORT_RECT,
 
             ACT_UNKNOWN = 999
         };
@@ -1507,14 +1661,14 @@ namespace Ogre {
 
         static AutoConstantDefinition AutoConstantDictionary[];
 
-        /// Packed list of floating-point constants (physical indexing)
-        FloatConstantList mFloatConstants;
-        /// Packed list of double-point constants (physical indexing)
-        DoubleConstantList mDoubleConstants;
-        /// Packed list of integer constants (physical indexing)
-        IntConstantList mIntConstants;
-        /// Packed list of unsigned integer constants (physical indexing)
-        UnsignedIntConstantList mUnsignedIntConstants;
+        /// Packed list of floating-point constants (physical indexing), shared with copies
+        SharedConstantList<float> mFloatConstants;
+        /// Packed list of double-point constants (physical indexing), shared with copies
+        SharedConstantList<double> mDoubleConstants;
+        /// Packed list of integer constants (physical indexing), shared with copies
+        SharedConstantList<int> mIntConstants;
+        /// Packed list of unsigned integer constants (physical indexing), shared with copies
+        SharedConstantList<uint> mUnsignedIntConstants;
         // /// Packed list of boolean constants (physical indexing)
         // BoolConstantList mBoolConstants;
         /** Logical index to physical index map - for low-level programs
@@ -1560,6 +1714,10 @@ namespace Ogre {
         bool mIgnoreMissingParams;
         /// physical index for active pass iteration parameter real constant entry;
         size_t mActivePassIterationIndex;
+        /// Data source the auto constants were last updated from, or NULL if they need a full update
+        const AutoParamDataSource* mAutoParamSource;
+        /// Variability versions of mAutoParamSource the auto constants were last updated from
+        uint32 mAutoParamVersions[3];
 
         /// Return the variability for an auto constant
         uint16 deriveVariability(AutoConstantType act);
@@ -1942,29 +2100,29 @@ namespace Ogre {
 
 
         /// Get a reference to the list of float constants
-        const FloatConstantList& getFloatConstantList() const { return mFloatConstants; }
-        /// Get a pointer to the 'nth' item in the float buffer
-        float* getFloatPointer(size_t pos) { return &mFloatConstants[pos]; }
+        const FloatConstantList& getFloatConstantList() const { return mFloatConstants.get(); }
+        /// Get a pointer to the 'nth' item in the float buffer, which stops sharing it with copies
+        float* getFloatPointer(size_t pos) { return &mFloatConstants.edit()[pos]; }
         /// Get a pointer to the 'nth' item in the float buffer
-        const float* getFloatPointer(size_t pos) const { return &mFloatConstants[pos]; }
+        const float* getFloatPointer(size_t pos) const { return &mFloatConstants.get()[pos]; }
         /// Get a reference to the list of double constants
-        const DoubleConstantList& getDoubleConstantList() const { return mDoubleConstants; }
+        const DoubleConstantList& getDoubleConstantList() const { return mDoubleConstants.get(); }
+        /// Get a pointer to the 'nth' item in the double buffer, which stops sharing it with copies
+        double* getDoublePointer(size_t pos) { return &mDoubleConstants.edit()[pos]; }
         /// Get a pointer to the 'nth' item in the double buffer
-        double* getDoublePointer(size_t pos) { return &mDoubleConstants[pos]; }
-        /// Get a pointer to the 'nth' item in the double buffer
-        const double* getDoublePointer(size_t pos) const { return &mDoubleConstants[pos]; }
+        const double* getDoublePointer(size_t pos) const { return &mDoubleConstants.get()[pos]; }
         /// Get a reference to the list of int constants
-        const IntConstantList& getIntConstantList() const { return mIntConstants; }
-        /// Get a pointer to the 'nth' item in the int buffer
-        int* getIntPointer(size_t pos) { return &mIntConstants[pos]; }
+        const IntConstantList& getIntConstantList() const { return mIntConstants.get(); }
+        /// Get a pointer to the 'nth' item in the int buffer, which stops sharing it with copies
+        int* getIntPointer(size_t pos) { return &mIntConstants.edit()[pos]; }
         /// Get a pointer to the 'nth' item in the int buffer
-        const int* getIntPointer(size_t pos) const { return &mIntConstants[pos]; }
+        const int* getIntPointer(size_t pos) const { return &mIntConstants.get()[pos]; }
         /// Get a reference to the list of uint constants
-        const UnsignedIntConstantList& getUnsignedIntConstantList() const { return mUnsignedIntConstants; }
-        /// Get a pointer to the 'nth' item in the uint buffer
-        uint* getUnsignedIntPointer(size_t pos) { return &mUnsignedIntConstants[pos]; }
+        const UnsignedIntConstantList& getUnsignedIntConstantList() const { return mUnsignedIntConstants.get(); }
+        /// Get a pointer to the 'nth' item in the uint buffer, which stops sharing it with copies
+        uint* getUnsignedIntPointer(size_t pos) { return &mUnsignedIntConstants.edit()[pos]; }
         /// Get a pointer to the 'nth' item in the uint buffer
-        const uint* getUnsignedIntPointer(size_t pos) const { return &mUnsignedIntConstants[pos]; }
+        const uint* getUnsignedIntPointer(size_t pos) const { return &mUnsignedIntConstants.get()[pos]; }
         // /// Get a reference to the list of bool constants
         // const BoolConstantList& getBoolConstantList() const { return mBoolConstants; }
         // /// Get a pointer to the 'nth' item in the bool buffer
@@ -2316,6 +2474,54 @@ namespace Ogre {
         //
         // void setNamedConstant(const String& name, const bool *val, size_t count,
         //                       size_t multiple = 4);
+
+        /** Resolves a named constant once, for setting it with the handle overloads of
+            setNamedConstant without a lookup by name.
+            @remarks
+            Use this for constants set often, such as per object values set every frame.
+            The handle can be used with all the parameters of the same program.
+            @note
+            This named option will only work if you are using a parameters object created
+            from a high-level program (HighLevelGpuProgram).
+            @param name The name of the parameter
+            @return An invalid handle, which is ignored when set, if the parameter does not
+            exist and missing parameters are ignored, otherwise this throws then
+        */
+        GpuConstantHandle getConstantHandle(const String& name) const;
+        /** Sets a constant resolved by getConstantHandle.
+            @see setNamedConstant(const String& name, Real val)
+        */
+        void setNamedConstant(const GpuConstantHandle& handle, Real val);
+        /// @copydoc setNamedConstant(const GpuConstantHandle& handle, Real val)
+        void setNamedConstant(const GpuConstantHandle& handle, int val);
+        /// @copydoc setNamedConstant(const GpuConstantHandle& handle, Real val)
+        void setNamedConstant(const GpuConstantHandle& handle, uint val);
+        /// @copydoc setNamedConstant(const GpuConstantHandle& handle, Real val)
+        void setNamedConstant(const GpuConstantHandle& handle, const Vector4& vec);
+        /// @copydoc setNamedConstant(const GpuConstantHandle& handle, Real val)
+        void setNamedConstant(const GpuConstantHandle& handle, const Vector3& vec);
+        /// @copydoc setNamedConstant(const GpuConstantHandle& handle, Real val)
+        void setNamedConstant(const GpuConstantHandle& handle, const Vector2& vec);
+        /// @copydoc setNamedConstant(const GpuConstantHandle& handle, Real val)
+        void setNamedConstant(const GpuConstantHandle& handle, const Matrix4& m);
+        /// @copydoc setNamedConstant(const GpuConstantHandle& handle, Real val)
+        void setNamedConstant(const GpuConstantHandle& handle, const Matrix4* m, size_t numEntries);
+        /// @copydoc setNamedConstant(const GpuConstantHandle& handle, Real val)
+        void setNamedConstant(const GpuConstantHandle& handle, const ColourValue& colour);
+        /** Sets a multiple value constant resolved by getConstantHandle.
+            @see setNamedConstant(const String& name, const float *val, size_t count, size_t multiple)
+        */
+        void setNamedConstant(const GpuConstantHandle& handle, const float *val, size_t count,
+                              size_t multiple = 4);
+        /// @copydoc setNamedConstant(const GpuConstantHandle& handle, const float *val, size_t count, size_t multiple)
+        void setNamedConstant(const GpuConstantHandle& handle, const double *val, size_t count,
+                              size_t multiple = 4);
+        /// @copydoc setNamedConstant(const GpuConstantHandle& handle, const float *val, size_t count, size_t multiple)
+        void setNamedConstant(const GpuConstantHandle& handle, const int *val, size_t count,
+                              size_t multiple = 4);
+        /// @copydoc setNamedConstant(const GpuConstantHandle& handle, const float *val, size_t count, size_t multiple)
+        void setNamedConstant(const GpuConstantHandle& handle, const uint *val, size_t count,
+                              size_t multiple = 4);
         /** Sets up a constant which will automatically be updated by the system.
             @remarks
             Vertex and fragment programs often need parameters which are to do with the
@@ -2429,6 +2635,17 @@ namespace Ogre {
         */
         void copyConstantsFrom(const GpuProgramParameters& source);
 
+        /** Makes parameters holding the same constant values share their buffers.
+            @remarks
+            The constant buffers are shared copy-on-write, a parameters object gets its
+            own buffer again when it changes a value. Copies of parameters, like those of
+            cloned materials or of the default parameters of a program, share their buffers
+            already. This also finds the identical buffers of parameters which were set up
+            separately, such as those of materials setting the same values in scripts.
+            @return The number of bytes freed
+        */
+        static size_t shareIdenticalConstants(const vector<GpuProgramParameters*>::type& params);
+
         /** Copies the values of all matching named constants (including auto constants) from
             another GpuProgramParameters object.
             @remarks
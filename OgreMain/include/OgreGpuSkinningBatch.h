@@ -0,0 +1,152 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __GpuSkinningBatch_H__
+#define __GpuSkinningBatch_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreRenderable.h"
+#include "OgreRenderToVertexBuffer.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** The copy of a vertex data skinned on the GPU by a GpuSkinningBatch.
+    @remarks
+        Holds the RenderToVertexBuffer doing the skinning, and is its source
+        renderable as well.
+    */
+    class _OgreExport GpuSkinnedVertexData : public Renderable, public AnimationAlloc
+    {
+    public:
+        /** Constructor.
+        @param sourceVertexData The vertex data of the mesh, with blend indices and weights
+        @param renderVertexData The software skinning copy of the vertex data, whose
+            elements other than positions and normals are drawn along
+        */
+        GpuSkinnedVertexData(const VertexData* sourceVertexData, const VertexData* renderVertexData);
+        ~GpuSkinnedVertexData();
+
+        /// The vertex data to draw, valid once skinned
+        VertexData* getVertexData(void) const { return mVertexData; }
+        /// Whether the vertices have been skinned at least once
+        bool isSkinned(void) const { return mSkinned; }
+
+        /// @copydoc Renderable::getMaterial
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+        /// @copydoc Renderable::getRenderOperation
+        void getRenderOperation(RenderOperation& op);
+        /// @copydoc Renderable::getWorldTransforms
+        void getWorldTransforms(Matrix4* xform) const;
+        /// @copydoc Renderable::getSquaredViewDepth
+        Real getSquaredViewDepth(const Camera* cam) const { return 0; }
+        /// @copydoc Renderable::getLights
+        const LightList& getLights(void) const;
+
+    protected:
+        friend class GpuSkinningBatch;
+
+        const VertexData* mSourceVertexData;
+        VertexData* mVertexData;
+        /// Binding of the skinned positions and normals in mVertexData
+        unsigned short mOutputSource;
+        RenderToVertexBufferSharedPtr mBuffer;
+        MaterialPtr mMaterial;
+        /// Blend matrices of the next update, three rows of four floats each
+        vector<float>::type mMatrices;
+        bool mSkinned;
+
+        /// Skin the vertices with the matrices set by GpuSkinningBatch::addSkin
+        void update(SceneManager* sceneMgr);
+    };
+
+    /** Skins meshes on the GPU once per frame, into buffers all passes then read.
+    @remarks
+        An entity whose materials don't skin in their vertex programs is skinned in
+        software, once per frame, and every pass draws the skinned copy. A batch
+        moves that skinning to the GPU: each skinned vertex data gets a
+        GpuSkinnedVertexData, whose positions and normals are transformed through a
+        RenderToVertexBuffer. The shadow casters, depth and lighting passes then
+        draw the pre-skinned vertices, with neither skinning programs nor the
+        vertices going through the CPU.
+    @par
+        SceneManager uses one while finding the visible objects when the
+        "GpuSkinning" option is enabled, and flushes it before rendering starts.
+        The programs are GLSL 1.50, so this needs a GL 3 render system with render
+        to vertex buffer support, see isSupported. Meshes with vertex animation,
+        more than MAX_BLEND_MATRICES blend matrices or vertex data not starting at
+        the first vertex of its buffers are still skinned in software.
+    */
+    class _OgreExport GpuSkinningBatch : public AnimationAlloc
+    {
+    public:
+        /// Maximum number of blend matrices of a vertex data skinned on the GPU
+        static const size_t MAX_BLEND_MATRICES = 80;
+
+        GpuSkinningBatch();
+        /// Skinning left over is dropped, the vertex data keep their last pose
+        ~GpuSkinningBatch();
+
+        /** Whether vertex data can be skinned on the GPU with the current render system.
+        @param sourceVertexData The vertex data of the mesh, with blend indices and weights
+        @param numMatrices The number of blend matrices it uses
+        */
+        static bool isSupported(const VertexData* sourceVertexData, size_t numMatrices);
+
+        /** Skin vertex data with the next flush.
+        @remarks
+            The blend matrices are copied, unlike with SoftwareSkinningBatch::addBlend.
+            The vertex data must stay alive until the batch is flushed.
+        */
+        void addSkin(GpuSkinnedVertexData* data, const Matrix4* const* blendMatrices,
+            size_t numMatrices);
+
+        /// Skin all vertex data added, on the rendering thread
+        void flush(SceneManager* sceneMgr);
+
+        /// Returns whether there is vertex data waiting for flush
+        bool isEmpty() const { return mPending.empty(); }
+
+    protected:
+        typedef vector<GpuSkinnedVertexData*>::type SkinnedVertexDataList;
+        SkinnedVertexDataList mPending;
+    };
+
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
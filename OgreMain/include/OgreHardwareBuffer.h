@@ -31,6 +31,7 @@ THE SOFTWARE.
 // Precompiler options
 #include "OgrePrerequisites.h"
 #include "OgreException.h"
+#include "OgreAtomicScalar.h"
 
 namespace Ogre {
 
@@ -185,6 +186,17 @@ namespace Ogre {
                 */
                 HBU_ON_DEMAND = 0x0001
             };
+            /// Usage categories of the statistics of locked bytes
+            enum LockUsage
+            {
+                /// HBU_STATIC buffers
+                LU_STATIC,
+                /// HBU_DYNAMIC buffers
+                LU_DYNAMIC,
+                /// HBU_DISCARDABLE buffers
+                LU_DISCARDABLE,
+                LU_COUNT
+            };
 
         protected:
             size_t mSizeInBytes;
@@ -198,6 +210,22 @@ namespace Ogre {
             HardwareBuffer* mShadowBuffer;
             bool mShadowUpdated;
             bool mSuppressHardwareUpdate;
+            /// Whether locks count towards the locked bytes, off for buffers wrapped by another buffer
+            bool mCountLocks;
+
+            /// Bytes locked in hardware buffers since the last _takeLockedBytes call
+            static AtomicScalar<size_t> msLockedBytes[LU_COUNT];
+
+            /// Counts a lock of the hardware buffer
+            void countLock(size_t length)
+            {
+                if (mCountLocks && !mSystemMemory)
+                {
+                    LockUsage usage = (mUsage & HBU_DISCARDABLE) ? LU_DISCARDABLE :
+                        (mUsage & HBU_DYNAMIC) ? LU_DYNAMIC : LU_STATIC;
+                    msLockedBytes[usage] += length;
+                }
+            }
             
             /// Internal implementation of lock()
             virtual void* lockImpl(size_t offset, size_t length, LockOptions options) = 0;
@@ -209,7 +237,7 @@ namespace Ogre {
             HardwareBuffer(Usage usage, bool systemMemory, bool useShadowBuffer) 
                 : mSizeInBytes(0), mUsage(usage), mIsLocked(false), mLockStart(0), mLockSize(0), mSystemMemory(systemMemory),
                 mUseShadowBuffer(useShadowBuffer), mShadowBuffer(NULL), mShadowUpdated(false), 
-                mSuppressHardwareUpdate(false) 
+                mSuppressHardwareUpdate(false), mCountLocks(true) 
             {
                 // If use shadow buffer, upgrade to WRITE_ONLY on hardware side
                 if (useShadowBuffer && usage == HBU_DYNAMIC)
@@ -256,6 +284,7 @@ namespace Ogre {
                     // Lock the real buffer if there is no shadow buffer 
                     ret = lockImpl(offset, length, options);
                     mIsLocked = true;
+                    countLock(length);
                 }
                 mLockStart = offset;
                 mLockSize = length;
@@ -365,6 +394,7 @@ namespace Ogre {
                     
                     void *destData = this->lockImpl(
                         mLockStart, mLockSize, lockOpt);
+                    countLock(mLockSize);
                     // Copy shadow to real
                     memcpy(destData, srcData, mLockSize);
                     this->unlockImpl();
@@ -392,6 +422,12 @@ namespace Ogre {
                     _updateFromShadow();
             }
 
+            /** Takes the number of bytes locked in hardware buffers of a usage category
+                since the last call, used for RenderSystem::RenderStats
+            @remarks Shadowed buffers count when they are updated from their shadow.
+            */
+            static size_t _takeLockedBytes(LockUsage usage);
+
 
 
 
@@ -79,6 +79,8 @@ namespace Ogre {
         HardwareVertexBufferSharedPtr destNormalBuffer;
         /// Both positions and normals are contained in the same buffer.
         bool posNormalShareBuffer;
+        /// The buffers contain nothing but the positions and normals.
+        bool blendedElementsOnly;
         unsigned short posBindIndex;
         unsigned short normBindIndex;
         bool bindPositions;
@@ -88,8 +90,14 @@ namespace Ogre {
         ~TempBlendedBufferInfo(void);
         /// Utility method, extract info from the given VertexData.
         void extractFrom(const VertexData* sourceData);
-        /// Utility method, checks out temporary copies of src into dest.
-        void checkoutTempCopies(bool positions = true, bool normals = true);
+        /** Utility method, checks out temporary copies of src into dest.
+        @param useShadowBuffer
+            Whether the copies need a shadow buffer, because they are read back or
+            blended with the hardware upload suppressed. Copies that are only
+            written go without, so they take no system memory.
+        */
+        void checkoutTempCopies(bool positions = true, bool normals = true,
+            bool useShadowBuffer = true);
         /// Utility method, binds dest copies into a given VertexData struct.
         void bindTempCopies(VertexData* targetData, bool suppressHardwareUpload);
         /** Overridden member from HardwareBufferLicensee. */
@@ -214,6 +222,42 @@ namespace Ogre {
             const HardwareVertexBufferSharedPtr& source, 
             HardwareBuffer::Usage usage, bool useShadowBuffer);
 
+        /// Ranges of a pool page, from the first vertex or index to their count
+        typedef map<size_t, size_t>::type PoolRangeMap;
+        struct PoolPage;
+        typedef list<PoolPage*>::type PoolPageList;
+        /** Backing buffers that vertex or index data is sub-allocated from. */
+        struct PoolPage : public BufferAlloc
+        {
+            /// Pool the page belongs to
+            PoolPageList* pool;
+            /// Buffer of each vertex source, empty for unused sources
+            vector<HardwareVertexBufferSharedPtr>::type vertexBuffers;
+            HardwareIndexBufferSharedPtr indexBuffer;
+            /// Number of vertices or indexes in the buffers
+            size_t size;
+            PoolRangeMap freeRanges;
+            PoolRangeMap usedRanges;
+        };
+        /// Pools of pages by layout: the vertex size of each source, or the index type,
+        /// followed by the usage and whether the buffers are shadowed
+        typedef map<vector<size_t>::type, PoolPageList>::type PoolMap;
+        PoolMap mVertexPools;
+        PoolMap mIndexPools;
+        /// Page owning each of the pooled buffers
+        typedef map<const HardwareBuffer*, PoolPage*>::type PoolPageOwnerMap;
+        PoolPageOwnerMap mPoolPageOwners;
+        /// Size of new pages in bytes, 0 if pooling is disabled
+        size_t mPoolPageSize;
+        OGRE_MUTEX(mPoolsMutex);
+
+        /// Takes a range of count units from the pages of a pool, adding a page if none has room
+        PoolPage* allocatePoolRange(PoolPageList& pool, size_t count, size_t unitSize, size_t& start);
+        /// Returns a range to its page, which is destroyed once all its ranges are returned
+        void releasePoolRange(PoolPage* page, size_t start);
+        /// Destroys all pool pages
+        void destroyAllPools(void);
+
     public:
         HardwareBufferManagerBase();
         virtual ~HardwareBufferManagerBase();
@@ -337,12 +381,16 @@ namespace Ogre {
         @param copyData
             If @c true, the current data is copied as well as the 
             structure of the buffer/
+        @param useShadowBuffer
+            Whether the copy has a shadow buffer. Copies that are only ever
+            written with discarding locks can go without, their updates are
+            then streamed straight to the GPU.
         */
         virtual HardwareVertexBufferSharedPtr allocateVertexBufferCopy(
             const HardwareVertexBufferSharedPtr& sourceBuffer, 
             BufferLicenseType licenseType,
             HardwareBufferLicensee* licensee,
-            bool copyData = false);
+            bool copyData = false, bool useShadowBuffer = true);
 
         /** Manually release a vertex buffer copy for others to subsequently use.
         @remarks
@@ -421,6 +469,54 @@ namespace Ogre {
         void _notifyUniformBufferDestroyed(HardwareUniformBuffer* buf);
         /// Notification that at hardware counter buffer has been destroyed
         void _notifyCounterBufferDestroyed(HardwareCounterBuffer* buf);
+
+        /** Sets the size of the pages that pooled vertex and index data is
+            sub-allocated from.
+        @remarks
+            Every buffer is a separate allocation of the render system, so many small
+            meshes mean many small buffers, which are costly to create and to switch
+            between when drawing. With pooling, createPooledVertexData and
+            createPooledIndexData hand out ranges of large shared buffers instead,
+            so that draws of unrelated geometry use the same buffers and can be
+            submitted together by render systems that batch draws. There is a pool
+            per vertex layout (the vertex size of each source) or index type, usage
+            and shadow buffer setting, which grows a page of this size at a time.
+            Data larger than a page gets a page of its own.
+        @param bytes
+            The page size, 0 (the default) disables pooling.
+        */
+        virtual void setPoolPageSize(size_t bytes);
+        /** Gets the size of the pages pooled data is sub-allocated from, 0 if disabled. */
+        virtual size_t getPoolPageSize(void) const { return mPoolPageSize; }
+
+        /** Binds a range of pooled buffers to vertex data.
+        @remarks
+            Allocates vertexData->vertexCount vertices for each source of its
+            declaration, binds the buffers of the page holding them and sets
+            vertexStart to the first vertex of the range. Only that range belongs
+            to the vertex data, so it must be written at its offset without
+            discarding, and indexes stay relative to vertexStart. The range returns
+            to the pool when the vertex data is deleted, or when it is pooled again.
+        @return
+            @c false, leaving the vertex data untouched, if pooling is disabled or
+            the vertex data is empty
+        */
+        virtual bool createPooledVertexData(VertexData* vertexData, HardwareBuffer::Usage usage,
+            bool useShadowBuffer = false);
+        /** Sets a range of a pooled index buffer to index data.
+        @remarks
+            The index data counterpart of createPooledVertexData, allocating
+            indexData->indexCount indexes and setting indexStart to the first one.
+        @return
+            @c false, leaving the index data untouched, if pooling is disabled or
+            the index data is empty
+        */
+        virtual bool createPooledIndexData(IndexData* indexData, HardwareIndexBuffer::IndexType itype,
+            HardwareBuffer::Usage usage, bool useShadowBuffer = false);
+        /// Returns the pooled range of vertex data to its pool
+        virtual void _releasePooledVertexData(VertexData* vertexData);
+        /// Returns the pooled range of index data to its pool
+        virtual void _releasePooledIndexData(IndexData* indexData);
     };
 
     /** Singleton wrapper for hardware buffer manager. */
@@ -499,9 +595,10 @@ namespace Ogre {
             const HardwareVertexBufferSharedPtr& sourceBuffer, 
             BufferLicenseType licenseType,
             HardwareBufferLicensee* licensee,
-            bool copyData = false)
+            bool copyData = false, bool useShadowBuffer = true)
         {
-            return mImpl->allocateVertexBufferCopy(sourceBuffer, licenseType, licensee, copyData);
+            return mImpl->allocateVertexBufferCopy(sourceBuffer, licenseType, licensee, copyData,
+                useShadowBuffer);
         }
         /** @copydoc HardwareBufferManagerBase::releaseVertexBufferCopy */
         virtual void releaseVertexBufferCopy(
@@ -559,6 +656,39 @@ namespace Ogre {
             mImpl->_notifyCounterBufferDestroyed(buf);
         }
 
+        /** @copydoc HardwareBufferManagerBase::setPoolPageSize */
+        virtual void setPoolPageSize(size_t bytes)
+        {
+            mImpl->setPoolPageSize(bytes);
+        }
+        /** @copydoc HardwareBufferManagerBase::getPoolPageSize */
+        virtual size_t getPoolPageSize(void) const
+        {
+            return mImpl->getPoolPageSize();
+        }
+        /** @copydoc HardwareBufferManagerBase::createPooledVertexData */
+        virtual bool createPooledVertexData(VertexData* vertexData, HardwareBuffer::Usage usage,
+            bool useShadowBuffer = false)
+        {
+            return mImpl->createPooledVertexData(vertexData, usage, useShadowBuffer);
+        }
+        /** @copydoc HardwareBufferManagerBase::createPooledIndexData */
+        virtual bool createPooledIndexData(IndexData* indexData, HardwareIndexBuffer::IndexType itype,
+            HardwareBuffer::Usage usage, bool useShadowBuffer = false)
+        {
+            return mImpl->createPooledIndexData(indexData, itype, usage, useShadowBuffer);
+        }
+        /** @copydoc HardwareBufferManagerBase::_releasePooledVertexData */
+        virtual void _releasePooledVertexData(VertexData* vertexData)
+        {
+            mImpl->_releasePooledVertexData(vertexData);
+        }
+        /** @copydoc HardwareBufferManagerBase::_releasePooledIndexData */
+        virtual void _releasePooledIndexData(IndexData* indexData)
+        {
+            mImpl->_releasePooledIndexData(indexData);
+        }
+
         /// @copydoc Singleton::getSingleton()
         static HardwareBufferManager& getSingleton(void);
         /// @copydoc Singleton::getSingleton()
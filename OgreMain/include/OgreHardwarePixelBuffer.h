@@ -168,6 +168,15 @@ namespace Ogre {
         {
             blitToMemory(Box(0,0,0,mWidth,mHeight,mDepth), dst);
         }
+
+        /** Starts copying a region of this pixelbuffer to memory, without waiting
+            for the GPU to finish writing it.
+            @param srcBox   Box describing the source region of this buffer
+            @return Ticket to fetch the data from once it is ready, see AsyncReadback.
+            The default copies at once.
+            @note Only call this function when the buffer is unlocked.
+         */
+        virtual AsyncReadbackPtr blitToMemoryAsync(const Box &srcBox);
         
         /** Get a render target for this PixelBuffer, or a slice of it. The texture this
             was acquired from must have TU_RENDERTARGET set, otherwise it is possible to
@@ -0,0 +1,75 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __HardwareTimerQuery_H__
+#define __HardwareTimerQuery_H__
+
+#include "OgrePrerequisites.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup RenderSystem
+    *  @{
+    */
+    /** Records the time at which the GPU has completed the commands issued before it.
+    @remarks
+        Create these through RenderSystem::createHardwareTimerQuery, which returns 0 when
+        the render system has no timer queries. The time between two timestamps is the 
+        GPU time of the commands issued in between. The results only become available a 
+        few frames later, so check isStillOutstanding before pulling them unless you are 
+        willing to wait for the GPU.
+    */
+    class _OgreExport HardwareTimerQuery : public RenderSysAlloc
+    {
+    public:
+        virtual ~HardwareTimerQuery() {}
+
+        /** Issues the timestamp after the commands issued so far
+        @remarks Issuing a query again replaces its previous result.
+        */
+        virtual void queryTimestamp(void) = 0;
+
+        /** Lets you know whether the timestamp is still being processed by the GPU
+        @return true if the result isn't available yet.
+        */
+        virtual bool isStillOutstanding(void) = 0;
+
+        /** Pulls the timestamp
+        @note Waits until the result is available.
+        @param nanoseconds Gets the GPU time in nanoseconds, relative to an unspecified origin.
+        @return false if the result is not valid, e.g. the GPU clock changed in between.
+        */
+        virtual bool pullTimestamp(uint64* nanoseconds) = 0;
+    };
+
+    /** @} */
+    /** @} */
+}
+#endif
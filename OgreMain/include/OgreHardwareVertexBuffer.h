@@ -157,7 +157,9 @@ namespace Ogre {
         VET_SHORT2_NORM = 31,  /// signed shorts (normalized to -1..1)
         VET_SHORT4_NORM = 32,
         VET_USHORT2_NORM = 33, /// unsigned shorts (normalized to 0..1)
-        VET_USHORT4_NORM = 34
+        VET_USHORT4_NORM = 34,
+        VET_HALF2 = 35,  /// half precision floats
+        VET_HALF4 = 36
     };
 
     /** This class declares the usage of a single vertex buffer as a component
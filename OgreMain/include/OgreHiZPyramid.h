@@ -0,0 +1,136 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __HiZPyramid_H__
+#define __HiZPyramid_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreCompositorInstance.h"
+#include "OgreCustomCompositionPass.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Effects
+    *  @{
+    */
+    /** Hierarchical max depth pyramid of a depth texture.
+    @remarks
+        Level 0 is a copy of the depth, every further level halves the size and
+        holds the farthest depth of the texels it covers in the level above, down
+        to a single texel. A box whose nearest depth is behind the value of the
+        level texels covering its screen rectangle is occluded, which is what GPU
+        culling, occlusion culling and screen space effects test against.
+    @par
+        The levels are PF_FLOAT32_R render textures named "<name>/<level>", so
+        materials and compositors can sample them by name. They are reduced with
+        GLSL 1.50 fragment programs, so this needs a GL 3 render system. The
+        levels are separate textures rather than mips of one, so no level is read
+        while it is being rendered to.
+    @par
+        update has to be called while the scene manager renders, for example from
+        a RenderQueueListener or from the "HiZ" compositor pass (see
+        HiZCompositionPass). Since the pyramid keeps its levels until the next
+        update, anything rendered before that sees the pyramid of the previous
+        frame.
+    */
+    class _OgreExport HiZPyramid : public CompositorInstAlloc
+    {
+    public:
+        /** Constructor.
+        @param name
+            Unique name, the prefix of the level texture names
+        @param depth
+            Texture whose red channel holds the depth, a PF_DEPTH texture or a
+            floating point texture the depth was written to
+        */
+        HiZPyramid(const String& name, const TexturePtr& depth);
+        ~HiZPyramid();
+
+        /** Whether the render system can generate pyramids. */
+        static bool isSupported(void);
+
+        const String& getName(void) const { return mName; }
+        const TexturePtr& getSource(void) const { return mSource; }
+
+        /// Number of levels, down to a single texel
+        size_t getNumLevels(void) const { return mLevels.size(); }
+        /// Texture holding a level
+        const TexturePtr& getLevel(size_t level) const;
+
+        /** Reduces the source depth into all levels.
+        @remarks
+            Renders to the levels and restores the viewport of the render system
+            afterwards.
+        */
+        void update(SceneManager* sceneMgr);
+
+        /** Starts copying a level to memory for CPU occlusion tests.
+        @remarks
+            The level is copied as it is now, fetch it from the returned ticket a
+            frame or two later so the GPU is not waited on. Coarse levels are small
+            enough to read back every frame.
+        */
+        AsyncReadbackPtr requestReadback(size_t level) const;
+
+    protected:
+        String mName;
+        TexturePtr mSource;
+        vector<TexturePtr>::type mLevels;
+        /// The viewports rendering to each level
+        vector<Viewport*>::type mViewports;
+        /// The materials reducing into each level
+        vector<MaterialPtr>::type mMaterials;
+    };
+
+    /** Composition pass updating the HiZPyramid of a texture.
+    @remarks
+        Registered with the CompositorManager as "HiZ". Used with 'pass
+        render_custom HiZ' and an 'input 0 <texture>' naming the depth texture of
+        the compositor, usually filled by an earlier target pass. The pyramid is
+        named after the texture instance, so its levels are found with
+        CompositorInstance::getTextureInstanceName(texture) + "/HiZ/<level>",
+        for example by a CompositorInstance::Listener setting up materials.
+    */
+    class _OgreExport HiZCompositionPass : public CustomCompositionPass, public CompositorInstAlloc
+    {
+    public:
+        ~HiZCompositionPass() {}
+
+        /// @copydoc CustomCompositionPass::createOperation
+        CompositorInstance::RenderSystemOperation* createOperation(
+            CompositorInstance* instance, const CompositionPass* pass);
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -419,11 +419,35 @@ namespace Ogre {
             @param  filter      Which filter to use
             @remarks    This function can do pixel format conversion in the process.
             @note   dst and src can point to the same PixelBox object without any problem
+            @note   Large images are resampled in bands of rows on the worker threads
+                of the Root WorkQueue, see ParallelJob.
         */
         static void scale(const PixelBox &src, const PixelBox &dst, Filter filter = FILTER_BILINEAR);
         
         /** Resize a 2D image, applying the appropriate filter. */
         void resize(ushort width, ushort height, Filter filter = FILTER_BILINEAR);
+
+        /** Generate mipmaps by scaling down the previous level, up to the given count.
+        @remarks
+            Existing mipmaps are kept. Compressed images are not supported.
+        @param numMipmaps Number of mipmaps, not counting the top level. It is clamped
+            to the full chain down to 1x1x1.
+        @param filter Filter used to scale down each level
+        */
+        Image& generateMipmaps(uint32 numMipmaps, Filter filter = FILTER_BILINEAR);
+
+        /** Encode a 2D image or cube map, including its mipmaps, in a block compressed format.
+        @remarks
+            The blocks are encoded on the worker threads of the Root WorkQueue. The
+            encoders favour speed over quality, so offline tools give better results.
+            DXT images can be saved as DDS to cache the result.
+        @param format One of PF_DXT1, PF_DXT5, PF_ETC1_RGB8 or PF_ETC2_RGB8. Alpha is
+            only kept by PF_DXT5.
+        */
+        Image& compress(PixelFormat format);
+
+        /// Returns whether compress can encode the given format
+        static bool isCompressionSupported(PixelFormat format);
         
         /// Static function to calculate size in bytes from the number of mipmaps, faces and the dimensions
         static size_t calculateSize(size_t mipmaps, size_t faces, uint32 width, uint32 height, uint32 depth, PixelFormat format);
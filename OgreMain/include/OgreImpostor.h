@@ -0,0 +1,136 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __Impostor_H__
+#define __Impostor_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreColourValue.h"
+#include "OgreCommon.h"
+#include "OgreVector3.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup LOD
+    *  @{
+    */
+    /** Pictures of a mesh from several directions, drawn instead of distant entities.
+    @remarks
+        generate renders the mesh from a ring of directions around its vertical
+        axis, and optionally from several elevations, into the cells of an atlas
+        texture. Entities given the impostor with Entity::setImpostor are then
+        drawn beyond a LOD value as a single quad textured with the cell closest
+        to the direction they are seen from. The quads of all entities sharing
+        an impostor are drawn together by the ImpostorBatcher of their
+        SceneManager, so a forest or crowd in the distance costs a few draws.
+    @par
+        The mesh is rendered with white ambient light and no other lights, so
+        the atlas holds the unlit colours of its materials, and the quads are
+        not lit. Use setColour to tint them to the lighting of the scene.
+        Animation is not captured, the mesh is pictured in its bind pose.
+        The atlas is a render texture, so it must be generated again if the
+        render system loses its contents.
+    */
+    class _OgreExport Impostor : public ResourceAlloc
+    {
+    public:
+        /** Constructor.
+        @param mesh The mesh to picture
+        @param yawViews Number of directions around the vertical axis of the mesh
+        @param pitchViews Number of elevations, from the horizon to above the mesh
+        @param viewSize Size in pixels of the atlas cell of each view
+        */
+        Impostor(const MeshPtr& mesh, uint16 yawViews = 8, uint16 pitchViews = 1,
+            uint32 viewSize = 128);
+        ~Impostor();
+
+        /** Renders the atlas and creates the material drawing it.
+        @remarks
+            Called by Entity::setImpostor if needed. This renders to a texture
+            through a temporary SceneManager, so it must not be called while
+            rendering.
+        */
+        void generate(void);
+        /** Returns whether the atlas has been generated. */
+        bool isGenerated(void) const { return mTexture.get() != 0; }
+
+        /** Gets the mesh pictured. */
+        const MeshPtr& getMesh(void) const { return mMesh; }
+        /** Gets the atlas texture, once generated. */
+        const TexturePtr& getTexture(void) const { return mTexture; }
+        /** Gets the material drawing the quads, once generated. */
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+
+        /** Gets the number of directions around the vertical axis. */
+        uint16 getYawViews(void) const { return mYawViews; }
+        /** Gets the number of elevations. */
+        uint16 getPitchViews(void) const { return mPitchViews; }
+        /** Gets the size in pixels of the atlas cell of each view. */
+        uint32 getViewSize(void) const { return mViewSize; }
+
+        /** Gets the centre of the mesh bounds, which the quads are centred on. */
+        const Vector3& getCentre(void) const { return mCentre; }
+        /** Gets the radius around the centre pictured, half the size of the quads. */
+        Real getRadius(void) const { return mRadius; }
+
+        /** Sets the colour the quads are multiplied with. */
+        void setColour(const ColourValue& colour) { mColour = colour; }
+        /** Gets the colour the quads are multiplied with. */
+        const ColourValue& getColour(void) const { return mColour; }
+
+        /** Gets the texture coordinates of the cell picturing the mesh from a direction.
+        @param direction Direction from the mesh to the viewer, in mesh space
+        @param texCoords Receives the left, top, right and bottom coordinates of the cell
+        */
+        void getViewTexCoords(const Vector3& direction, FloatRect& texCoords) const;
+
+    protected:
+        MeshPtr mMesh;
+        uint16 mYawViews;
+        uint16 mPitchViews;
+        uint32 mViewSize;
+        Vector3 mCentre;
+        Real mRadius;
+        ColourValue mColour;
+        TexturePtr mTexture;
+        MaterialPtr mMaterial;
+
+        /// Elevation of the views of a row of the atlas
+        Radian getPitch(uint16 row) const;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -0,0 +1,139 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ImpostorBatcher_H__
+#define __ImpostorBatcher_H__
+
+#include "OgrePrerequisites.h"
+
+#include "OgreRenderable.h"
+#include "OgreQuaternion.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup LOD
+    *  @{
+    */
+    /** Draws the entities of a scene shown as impostors.
+    @remarks
+        Created by the SceneManager when an entity is first drawn as an
+        Impostor. Visible entities beyond their impostor LOD value hand their
+        transform to the batcher instead of queueing their sub entities. The
+        entities sharing an impostor, render queue group and priority form a
+        batch, which writes a camera facing quad for each of them into one
+        dynamic vertex buffer when it is rendered and draws them all at once.
+    @par
+        The quads turn around the vertical axis of their entity to face the
+        camera, or freely if the impostor has several elevations.
+    */
+    class _OgreExport ImpostorBatcher : public FXAlloc
+    {
+    public:
+        ImpostorBatcher();
+        ~ImpostorBatcher();
+
+        /** Internal method, adds a visible entity drawn as an impostor and
+            queues the batch of the impostor if it is the first in this render.
+        */
+        void _addEntity(Entity* entity, Impostor* impostor, uint8 queueID,
+            ushort priority, RenderQueue* queue);
+        /** Internal method, starts gathering the entities of a render of the scene. */
+        void _beginScene(void);
+
+        /** Gets the number of batches, i.e. of distinct impostor and queue combinations. */
+        size_t getNumBatches(void) const { return mBatches.size(); }
+
+    protected:
+        /// What entities need in common to be drawn together
+        struct BatchKey
+        {
+            const Impostor* impostor;
+            uint8 queueID;
+            ushort priority;
+
+            bool operator<(const BatchKey& rhs) const;
+        };
+
+        /// The quads of the entities sharing an impostor
+        class Batch : public Renderable, public FXAlloc
+        {
+        public:
+            Batch(Impostor* impostor);
+            ~Batch();
+
+            /// Adds an entity visible in this render, returns whether it was the first
+            bool addInstance(const Vector3& position, const Quaternion& orientation, Real scale);
+            void clearInstances(void) { mInstances.clear(); }
+            /// Frame the batch was last queued in
+            unsigned long getLastUsedFrame(void) const { return mLastUsedFrame; }
+
+            const MaterialPtr& getMaterial(void) const { return mMaterial; }
+            void getRenderOperation(RenderOperation& op);
+            bool preRender(SceneManager* sm, RenderSystem* rsys);
+            void getWorldTransforms(Matrix4* xform) const;
+            Real getSquaredViewDepth(const Camera* cam) const { return 0; }
+            const LightList& getLights(void) const { return mLights; }
+
+        protected:
+            struct Instance
+            {
+                Vector3 position;
+                Quaternion orientation;
+                Real scale;
+            };
+            typedef vector<Instance>::type InstanceList;
+
+            Impostor* mImpostor;
+            MaterialPtr mMaterial;
+            VertexData* mVertexData;
+            IndexData* mIndexData;
+            InstanceList mInstances;
+            unsigned long mLastUsedFrame;
+            LightList mLights;
+
+            /// Makes room in the buffers for a number of quads
+            void reserve(size_t quads);
+        };
+
+        typedef map<BatchKey, Batch*>::type BatchMap;
+
+        BatchMap mBatches;
+        /// The batches queued in this render of the scene
+        vector<Batch*>::type mQueuedBatches;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
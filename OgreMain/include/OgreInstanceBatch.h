@@ -300,6 +300,17 @@ namespace Ogre
         */
         virtual bool isStatic() const                       { return false; }
 
+        /** Culls the instances of this batch on the GPU rather than one by one on the CPU.
+            @remarks
+                Only supported by InstanceBatchHW, the other techniques ignore it.
+                @see InstanceBatchHW::setGpuCulling
+        */
+        virtual void setGpuCulling( bool enabled )          {}
+
+        /** Returns true if the instances of this batch are culled on the GPU. @see setGpuCulling
+        */
+        virtual bool getGpuCulling() const                  { return false; }
+
         /** Returns a pointer to a new InstancedEntity ready to use
             Note it's actually preallocated, so no memory allocation happens at
             this point.
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define __InstanceBatchHW_H__
 
 #include "OgreInstanceBatch.h"
+#include "OgreRenderToVertexBuffer.h"
 
 namespace Ogre
 {
@@ -60,7 +61,38 @@ namespace Ogre
      */
     class _OgreExport InstanceBatchHW : public InstanceBatch
     {
+        /// Draws the instance records as points, the input of the GPU culling
+        class CullRenderable : public Renderable
+        {
+        public:
+            CullRenderable( InstanceBatchHW *parent ) : mParent( parent ), mVertexData( 0 ) {}
+            ~CullRenderable();
+
+            /// Create the vertex data reading the given instance buffer
+            void create( const HardwareVertexBufferSharedPtr &instanceBuffer, size_t numRecords );
+            void setNumRecords( size_t numRecords )     { mVertexData->vertexCount = numRecords; }
+
+            const MaterialPtr& getMaterial(void) const  { return mParent->getMaterial(); }
+            void getRenderOperation( RenderOperation& op );
+            void getWorldTransforms( Matrix4* xform ) const { *xform = Matrix4::IDENTITY; }
+            Real getSquaredViewDepth( const Camera* cam ) const { return 0; }
+            const LightList& getLights(void) const      { return mParent->getLights(); }
+
+        protected:
+            InstanceBatchHW *mParent;
+            VertexData      *mVertexData;
+        };
+
         bool    mKeepStatic;
+        bool    mGpuCulling;
+
+        /// Holds the records of all instances, the GPU culling copies the visible ones
+        HardwareVertexBufferSharedPtr   mInstanceBuffer;
+        RenderToVertexBufferSharedPtr   mCullBuffer;
+        MaterialPtr                     mCullMaterial;
+        CullRenderable                  mCullRenderable;
+        /// Number of records in mInstanceBuffer
+        size_t                          mNumInstanceRecords;
 
         void setupVertices( const SubMesh* baseSubMesh );
         void setupIndices( const SubMesh* baseSubMesh );
@@ -70,6 +102,11 @@ namespace Ogre
 
         size_t updateVertexBuffer( Camera *currentCamera );
 
+        /// Creates the render to vertex buffer and programs of the GPU culling
+        void createCullBuffer(void);
+        /// Copies the instances visible to the camera into the culling buffer, returns their count
+        size_t cullOnGpu( Camera *currentCamera );
+
     public:
         InstanceBatchHW( InstanceManager *creator, MeshPtr &meshReference, const MaterialPtr &material,
                             size_t instancesPerBatch, const Mesh::IndexMap *indexToBoneMap,
@@ -97,6 +134,22 @@ namespace Ogre
 
         bool isStatic() const                       { return mKeepStatic; }
 
+        /** @see InstanceBatch::setGpuCulling.
+            @remarks
+                The instance records are kept in a buffer which a vertex and geometry program
+                (through a RenderToVertexBuffer) test against the camera frustum every frame,
+                drawing only those inside. For static batches the records are only written
+                by setStaticAndUpdate, so the CPU time no longer depends on the number of
+                instances. Dynamic batches still rewrite all records each frame, but skip
+                the per instance visibility test.
+            @par
+                The programs are GLSL 1.50, so this needs a GL 3 render system with geometry
+                programs and render to vertex buffer support. Otherwise a warning is logged
+                and the instances are culled on the CPU.
+        */
+        void setGpuCulling( bool enabled );
+        bool getGpuCulling() const                  { return mGpuCulling; }
+
         //Renderable overloads
         void getWorldTransforms( Matrix4* xform ) const;
         unsigned short getNumWorldTransforms(void) const;
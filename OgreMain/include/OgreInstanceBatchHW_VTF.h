@@ -64,6 +64,14 @@ namespace Ogre
         //Pointer to the buffer containing the per instance vertex data
         HardwareVertexBufferSharedPtr mInstanceVertexBuffer;
 
+        typedef vector<uint32>::type SlotVec;
+        /// Texel slots of the entities drawn this update and the last one. Without bone matrix
+        /// lookup every entity owns the slot of its index, so only moved instances are rewritten
+        SlotVec mDrawnSlots;
+        SlotVec mLastDrawnSlots;
+        /// Scratch space for the texels of one entity when updating it alone
+        vector<float>::type mEntityTexels;
+
         void setupVertices( const SubMesh* baseSubMesh );
         void setupIndices( const SubMesh* baseSubMesh );
 
@@ -78,6 +86,18 @@ namespace Ogre
         */
         virtual size_t updateInstanceDataBuffer(bool isFirstTime, Camera* currentCamera);
 
+        /// Writes the UV offsets pointing at the texels of the given matrix index
+        void writeInstanceUV( size_t matrixIndex, float *pDest ) const;
+
+        /// Writes the transforms of an entity, as stored in the vertex texture
+        void writeEntityTexels( InstancedEntity *entity, float *pDest );
+
+        /** Updates the texels of the drawn entities that changed since they were last written
+            and points the instance buffer at them. Used when not using bone matrix lookup
+        @return The number of instances to be rendered
+        */
+        size_t updateDirtyInstances( Camera *currentCamera );
+
 
         virtual bool checkSubMeshCompatibility( const SubMesh* baseSubMesh );
 
@@ -87,6 +107,9 @@ namespace Ogre
         size_t updateVertexTexture( Camera *currentCamera );
 
         virtual bool matricesTogetherPerRow() const { return true; }
+
+        /// Only parts of the texture are rewritten when not using bone matrix lookup
+        virtual TextureUsage getVertexTextureUsage(void) const;
     public:
         InstanceBatchHW_VTF( InstanceManager *creator, MeshPtr &meshReference, const MaterialPtr &material,
                             size_t instancesPerBatch, const Mesh::IndexMap *indexToBoneMap,
@@ -102,6 +102,14 @@ namespace Ogre
         bool mForceOneWeight;
         bool mUseOneWeight;
 
+        /// Frames per second the animations are baked at, zero when not baking
+        Real mBakedAnimationFrameRate;
+        /// First palette & number of frames of each baked animation, by name
+        typedef map<String, std::pair<size_t, size_t> >::type BakedAnimationMap;
+        BakedAnimationMap mBakedAnimations;
+        /// Number of bone palettes in the baked texture, including the binding pose
+        size_t mNumBakedPalettes;
+
         /** Clones the base material so it can have it's own vertex texture, and also
             clones it's shadow caster materials, if it has any
         */
@@ -125,6 +133,20 @@ namespace Ogre
         /** Creates the vertex texture */
         void createVertexTexture( const SubMesh* baseSubMesh );
 
+        /** Offset in floats of the matrices of the given instance (or lookup/palette slot)
+            within the vertex texture */
+        size_t getSlotOffset( size_t slot ) const;
+
+        /** Lays out a palette per frame of every skeletal animation, plus the binding pose */
+        void createBakedAnimationLayout(void);
+
+        /** Writes all the baked bone palettes to the vertex texture */
+        void bakeAnimations(void);
+
+        /** Usage of the vertex texture. It is entirely rewritten every update by default,
+            techniques which only update parts of it must not make it discardable */
+        virtual TextureUsage getVertexTextureUsage(void) const { return TU_DYNAMIC_WRITE_ONLY_DISCARDABLE; }
+
         /** Creates 2 TEXCOORD semantics that will be used to sample the vertex texture */
         virtual void createVertexSemantics( VertexData *thisVertexData, VertexData *baseVertexData,
                                     const HWBoneIdxVec &hwBoneIdx, const HWBoneWgtVec &hwBoneWgt) = 0;
@@ -199,6 +221,27 @@ namespace Ogre
 
         /** @return the maximum amount of shared transform entities when using lookup table*/
         virtual size_t getMaxLookupTableInstances() const { return mMaxLookupTableInstances; }
+
+        /** Bakes the bone palettes of every frame of every animation into the vertex texture
+        
+        The texture is filled once and shared among all the batches of the same InstanceManager.
+        Each instanced entity then picks its pose from its first enabled animation state,
+        rounded to the nearest baked frame, so no skeleton is evaluated on the CPU. Animation
+        blending is not supported; entities without an enabled animation use the binding pose.
+
+        This implies bone matrix lookup, thus it only works in VTF_HW for now.
+        This value needs to be set before adding any instanced entities
+        @param frameRate Frames per second to bake the animations at, zero to disable
+        */
+        void setBakedAnimation( Real frameRate );
+
+        /** Tells whether the animations are baked
+        @see setBakedAnimation()
+        */
+        bool useBakedAnimation() const { return mBakedAnimationFrameRate > 0; }
+
+        /** @return The baked palette the given entity currently samples from */
+        size_t getBakedPalette( const InstancedEntity *entity ) const;
         
     };
 
@@ -78,6 +78,8 @@ namespace Ogre
             CAST_SHADOWS        = 0,
             /// Makes each batch to display it's bounding box. Useful for debugging or profiling
             SHOW_BOUNDINGBOX,
+            /// Culls the instances of each batch on the GPU. @see InstanceBatch::setGpuCulling
+            GPU_CULLING,
 
             NUM_SETTINGS
         };
@@ -92,6 +94,7 @@ namespace Ogre
             {
                 setting[CAST_SHADOWS]     = true;
                 setting[SHOW_BOUNDINGBOX] = false;
+                setting[GPU_CULLING]      = false;
             }
         };
 
@@ -118,6 +121,7 @@ namespace Ogre
         SceneManager*           mSceneManager;
 
         size_t                  mMaxLookupTableInstances;
+        Real                    mBakedAnimationFrameRate;
         unsigned char           mNumCustomParams;       //Number of custom params per instance.
 
         /** Finds a batch with at least one free instanced entity we can use.
@@ -180,6 +184,14 @@ namespace Ogre
         */
         void setMaxLookupTableInstances( size_t maxLookupTableInstances );
 
+        /** Sets the frames per second skeletal animations are baked at when using
+            IM_VTFBAKEDANIMATION. Raises an exception if trying to change it after creating
+            the first InstancedEntity.
+        @remarks Higher rates give smoother animations at the cost of a larger vertex texture.
+        @param frameRate New frame rate, 30 by default
+        */
+        void setBakedAnimationFrameRate( Real frameRate );
+
         /** Sets the number of custom parameters per instance. Some techniques (i.e. HWInstancingBasic)
             support this, but not all of them. They also may have limitations to the max number. All
             instancing implementations assume each instance param is a Vector4 (4 floats).
@@ -124,6 +124,10 @@ namespace Ogre
         bool mNeedAnimTransformUpdate;
         /// Tells whether to use the local transform parameters
         bool mUseLocalTransform;
+        /// Tells if the data this entity keeps in its batch (i.e. its VTF texels) needs a rewrite
+        bool mNeedBatchDataUpdate;
+        /// Tells if this entity is static within a dynamic batch
+        bool mKeepStatic;
 
 
         /// Returns number of matrices written to transform, assumes transform has enough space
@@ -252,6 +256,17 @@ namespace Ogre
         /** Sets whether the entity is in use. */
         void setInUse(bool used);
 
+        /** Sets whether this entity is static within its batch
+        @remarks
+            Static entities aren't culled individually and their skeleton is only updated
+            when they move, so they cost almost nothing per frame while the rest of the batch
+            stays dynamic. Moving a static entity is still picked up.
+            Unlike InstanceBatch::setStaticAndUpdate this works per instance, but it is only
+            honoured by HW_VTF batches not using bone matrix lookup.
+        */
+        void setStatic( bool bStatic )          { mKeepStatic = bStatic; }
+        bool isStatic() const                   { return mKeepStatic; }
+
         /** Returns the world transform of the instanced entity including local transform */
         virtual const Matrix4& _getParentNodeFullTransform(void) const { 
             assert((!mNeedTransformUpdate || !mUseLocalTransform) && "Transform data should be updated at this point");
@@ -0,0 +1,191 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __LightClusters_H__
+#define __LightClusters_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreCommon.h"
+#include "OgreVector4.h"
+#include "OgreMatrix4.h"
+#include "OgreTexture.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** The lights of a camera view binned into clusters, for shading all
+        lights affecting a pixel in a single pass.
+    @remarks
+        The view frustum is divided into a grid of tiles across the screen
+        and slices in depth, the depth slices growing exponentially from the
+        near plane. Each cluster lists the point and spot lights whose range
+        reaches into it. Directional lights reach every cluster and are kept
+        apart. The slices are binned on the worker threads of the Root
+        WorkQueue (see parallelFor).
+    @par
+        The result is uploaded to a single floating point texture, one value
+        of four floats per texel, laid out in rows of TEXTURE_WIDTH texels:
+        <ol>
+        <li>A header per cluster, (first index, light count, 0, 0), for
+            cluster x + (y + slice * tilesY) * tilesX.</li>
+        <li>LIGHT_TEXELS texels per light starting at getLightStart, directional
+            lights first, all in view space: (position, type), (direction
+            towards the light, 0), (diffuse colour, 0), (specular colour, 0),
+            (range, constant, linear, quadratic attenuation) and (cosine of
+            half the inner angle, of half the outer angle, falloff, 0). Light
+            types are 0 for point, 1 for directional and 2 for spot lights.</li>
+        <li>The light indices of the clusters one after the other, in x,
+            starting at getIndexStart.</li>
+        </ol>
+        Only the rows in use are uploaded each frame.
+        A view space position falls into tile floor((ndc * 0.5 + 0.5) * tiles)
+        and slice floor(log(depth) * scale + bias), with tiles, scale and bias
+        in getGridParams.
+    */
+    class _OgreExport LightClusters : public SceneCtlAllocatedObject
+    {
+    public:
+        /// Row length of the texture
+        static const size_t TEXTURE_WIDTH = 512;
+        /// Texels per light in the texture
+        static const size_t LIGHT_TEXELS = 6;
+
+        /** Constructor.
+        @param name The name of the texture, which is created on the first upload
+        */
+        LightClusters(const String& name);
+        ~LightClusters();
+
+        /** Set how the view is divided, this recreates the texture.
+        @param tilesX Tiles across the screen
+        @param tilesY Tiles down the screen
+        @param slices Slices in depth
+        @param maxLightsPerCluster Lights beyond this many in a cluster are dropped
+        @param maxLights Lights beyond this many in the view are dropped, nearest kept
+        */
+        void setGrid(uint16 tilesX, uint16 tilesY, uint16 slices,
+            uint16 maxLightsPerCluster = 32, uint16 maxLights = 1024);
+        uint16 getTilesX(void) const { return mTilesX; }
+        uint16 getTilesY(void) const { return mTilesY; }
+        uint16 getSlices(void) const { return mSlices; }
+        uint16 getMaxLightsPerCluster(void) const { return mMaxLightsPerCluster; }
+        uint16 getMaxLights(void) const { return mMaxLights; }
+        size_t getClusterCount(void) const { return static_cast<size_t>(mTilesX) * mTilesY * mSlices; }
+
+        /** Bin the lights for a camera.
+        @param cam The camera, its projection and clip distances define the clusters
+        @param lights The lights to bin, usually the ones affecting the frustum
+        */
+        void build(const Camera* cam, const LightList& lights);
+        /** Bin the lights for a view and projection.
+        @param viewMatrix The view matrix
+        @param projMatrix The projection matrix, not converted for the render system
+        @param nearDistance The near clip distance
+        @param farDistance The far clip distance, 0 if infinite
+        @param lights The lights to bin
+        */
+        void build(const Matrix4& viewMatrix, const Matrix4& projMatrix,
+            Real nearDistance, Real farDistance, const LightList& lights);
+
+        /// The lights binned, directional ones first, indexed by the cluster light lists
+        const LightList& getLights(void) const { return mLights; }
+        /// How many of the lights are directional
+        size_t getDirectionalLightCount(void) const { return mDirectionalLightCount; }
+        /// Number of point and spot lights in a cluster
+        size_t getClusterLightCount(size_t x, size_t y, size_t slice) const;
+        /// The point and spot lights in a cluster, as indexes into getLights
+        const uint16* getClusterLights(size_t x, size_t y, size_t slice) const;
+        /// The slice a view space depth falls into, clamped to the grid
+        size_t getSlice(Real depth) const;
+
+        /// (tiles across, tiles down, slice scale, slice bias), see the class remarks
+        const Vector4& getGridParams(void) const { return mGridParams; }
+        /// Texel the lights start at
+        size_t getLightStart(void) const { return getClusterCount(); }
+        /// Texel the light indices start at
+        size_t getIndexStart(void) const { return getLightStart() + mMaxLights * LIGHT_TEXELS; }
+
+        /** Upload the clusters built last to the texture, creating it if needed.
+        @remarks
+            Needs a render system; call it from the rendering thread.
+        */
+        void _updateTexture(void);
+        /** Gets the texture, creating it if needed.
+        @remarks
+            It is sized for full clusters, so it is only recreated when the
+            grid changes. Needs a render system.
+        */
+        const TexturePtr& getTexture(void);
+
+    protected:
+        /// Bins the lights of one depth slice, called on the worker threads
+        struct SliceBinner;
+        friend struct SliceBinner;
+
+        /// Adds the lights reaching into a slice to its clusters
+        void binSlice(size_t slice);
+
+        String mName;
+        uint16 mTilesX;
+        uint16 mTilesY;
+        uint16 mSlices;
+        uint16 mMaxLightsPerCluster;
+        uint16 mMaxLights;
+
+        LightList mLights;
+        size_t mDirectionalLightCount;
+        /// View space bounding sphere of the lights after the directional ones
+        vector<Vector4>::type mLightSpheres;
+        /// First and last slice each light reaches into
+        vector<std::pair<size_t, size_t> >::type mLightSlices;
+        /// The lights of each cluster, mMaxLightsPerCluster per cluster
+        vector<uint16>::type mClusterLights;
+        vector<uint16>::type mClusterLightCounts;
+
+        Matrix4 mViewMatrix;
+        Matrix4 mProjMatrix;
+        Real mNearDistance;
+        Real mFarDistance;
+        Vector4 mGridParams;
+
+        TexturePtr mTexture;
+        /// Texels staged for the upload
+        vector<float>::type mTexels;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -90,6 +90,14 @@ namespace Ogre {
         /** Get the index of the LOD usage which applies to a given value. */
         virtual ushort getIndex(Real value, const Material::LodValueList& materialLodValueList) const = 0;
 
+        /** Get the index of the LOD level of a mesh which an object should use.
+        @remarks
+            Called for each object showing the mesh, along with the LOD index the
+            object used so far, which strategies may take into account to avoid
+            switching back and forth. The default just looks up the value in the mesh.
+        */
+        virtual ushort getMeshLodIndex(Real value, const Mesh* mesh, ushort previousIndex) const;
+
         /** Sort mesh LOD usage list from greatest to least detail */
         virtual void sort(Mesh::MeshLodUsageList& meshLodUsageList) const = 0;
 
@@ -97,6 +97,10 @@ namespace Ogre
         to begin(), and also consider using estimateVertexCount / estimateIndexCount
         if your geometry is going to be growing, to avoid buffer recreation during
         growth.
+    @par
+        Geometry which is rebuilt every frame can skip the per-vertex calls
+        altogether with beginDirectUpdate(), which hands out the hardware buffers
+        of an existing section to write the vertices and indices into.
     @par
         Note that like all OGRE geometry, triangles should be specified in 
         anti-clockwise winding order (whether you're doing it with just
@@ -175,6 +179,52 @@ namespace Ogre
             call to begin() would have created section 0, the second section 1, etc.
         */
         virtual void beginUpdate(size_t sectionIndex);
+
+        /** The buffer ranges of a section being written by beginDirectUpdate(). */
+        struct DirectUpdate
+        {
+            /// The vertices, laid out as in the vertex declaration of the section
+            void* vertices;
+            /// Size of a vertex in bytes
+            size_t vertexSize;
+            size_t vertexCount;
+            /// The indices, NULL if the section is not indexed
+            void* indices;
+            size_t indexCount;
+            /// Whether the indices are 32 bit rather than 16 bit
+            bool indices32Bit;
+
+            /// The vertices as an array of a type matching the vertex declaration
+            template<typename T> T* getVertices() const { return static_cast<T*>(vertices); }
+            /// The indices if they are 16 bit
+            uint16* getIndices16() const { return indices32Bit ? 0 : static_cast<uint16*>(indices); }
+            /// The indices if they are 32 bit
+            uint32* getIndices32() const { return indices32Bit ? static_cast<uint32*>(indices) : 0; }
+        };
+
+        /** Start an update of a section which writes straight to its hardware buffers.
+        @remarks
+            Unlike beginUpdate(), the vertices and indices are not specified one by
+            one but written to the returned buffer ranges, in the vertex layout the
+            section was created with (see ManualObjectSection::getRenderOperation).
+            Indices are relative to the first vertex of the range. Call
+            endDirectUpdate() once done writing.
+        @par
+            The buffers are used as a ring, each update takes the range after the
+            previous one so the GPU can still read that, and starts over with a
+            discarded buffer once the end is reached. They are only reallocated when
+            the counts do not fit, so call setDynamic(true) before creating the section
+            and use estimateVertexCount / estimateIndexCount to size them up front.
+        @note
+            The bounds are not updated, use setBoundingBox to set them.
+        @param sectionIndex The index of the section you want to update.
+        @param vertexCount The number of vertices to write.
+        @param indexCount The number of indices to write, 0 for non-indexed geometry.
+        */
+        virtual DirectUpdate beginDirectUpdate(size_t sectionIndex, size_t vertexCount, size_t indexCount = 0);
+
+        /** Finish an update started with beginDirectUpdate(). */
+        virtual void endDirectUpdate(void);
         /** Add a vertex position, starting a new vertex at the same time. 
         @remarks A vertex position is slightly special among the other vertex data
             methods like normal() and textureCoord(), since calling it indicates
@@ -486,6 +536,8 @@ namespace Ogre
         ManualObjectSection* mCurrentSection;
         /// Are we updating?
         bool mCurrentUpdating;
+        /// Are we writing the buffers directly?
+        bool mCurrentDirectUpdating;
         /// Temporary vertex structure
         struct TempVertex
         {
@@ -290,6 +290,16 @@ namespace Ogre {
         */
         virtual void removeListener(Listener* l, const Ogre::String& schemeName = BLANKSTRING);
 
+        /** Makes the program parameters of all passes share the buffers of identical constants.
+        @remarks
+            Materials setting the same constant values, like those cloned from one another or
+            created by the same script templates, then keep a single copy of the values. A pass
+            gets its own copy again when its parameters change.
+        @see GpuProgramParameters::shareIdenticalConstants
+        @return The number of bytes freed
+        */
+        virtual size_t shareIdenticalProgramConstants(void);
+
         /// Internal method for sorting out missing technique for a scheme
         virtual Technique* _arbitrateMissingTechniqueForActiveScheme(
             Material* mat, unsigned short lodIndex, const Renderable* rend);
@@ -34,6 +34,13 @@ THE SOFTWARE.
 #include "OgreMatrix3.h"
 #include "OgreVector4.h"
 #include "OgrePlane.h"
+#include "OgrePlatformInformation.h"
+
+#if OGRE_SIMD_MATH && __OGRE_HAVE_SSE
+#   include <xmmintrin.h>
+#elif OGRE_SIMD_MATH && __OGRE_HAVE_NEON
+#   include <arm_neon.h>
+#endif
 namespace Ogre
 {
     /** \addtogroup Core
@@ -173,6 +180,34 @@ namespace Ogre
         inline Matrix4 concatenate(const Matrix4 &m2) const
         {
             Matrix4 r;
+#if OGRE_SIMD_MATH && __OGRE_HAVE_SSE
+            // each row of the result is a combination of the rows of m2
+            __m128 b0 = _mm_loadu_ps(m2.m[0]);
+            __m128 b1 = _mm_loadu_ps(m2.m[1]);
+            __m128 b2 = _mm_loadu_ps(m2.m[2]);
+            __m128 b3 = _mm_loadu_ps(m2.m[3]);
+            for (size_t i = 0; i < 4; ++i)
+            {
+                __m128 row = _mm_mul_ps(_mm_set1_ps(m[i][0]), b0);
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i][1]), b1));
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i][2]), b2));
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i][3]), b3));
+                _mm_storeu_ps(r.m[i], row);
+            }
+#elif OGRE_SIMD_MATH && __OGRE_HAVE_NEON
+            float32x4_t b0 = vld1q_f32(m2.m[0]);
+            float32x4_t b1 = vld1q_f32(m2.m[1]);
+            float32x4_t b2 = vld1q_f32(m2.m[2]);
+            float32x4_t b3 = vld1q_f32(m2.m[3]);
+            for (size_t i = 0; i < 4; ++i)
+            {
+                float32x4_t row = vmulq_n_f32(b0, m[i][0]);
+                row = vmlaq_n_f32(row, b1, m[i][1]);
+                row = vmlaq_n_f32(row, b2, m[i][2]);
+                row = vmlaq_n_f32(row, b3, m[i][3]);
+                vst1q_f32(r.m[i], row);
+            }
+#else
             r.m[0][0] = m[0][0] * m2.m[0][0] + m[0][1] * m2.m[1][0] + m[0][2] * m2.m[2][0] + m[0][3] * m2.m[3][0];
             r.m[0][1] = m[0][0] * m2.m[0][1] + m[0][1] * m2.m[1][1] + m[0][2] * m2.m[2][1] + m[0][3] * m2.m[3][1];
             r.m[0][2] = m[0][0] * m2.m[0][2] + m[0][1] * m2.m[1][2] + m[0][2] * m2.m[2][2] + m[0][3] * m2.m[3][2];
@@ -192,6 +227,7 @@ namespace Ogre
             r.m[3][1] = m[3][0] * m2.m[0][1] + m[3][1] * m2.m[1][1] + m[3][2] * m2.m[2][1] + m[3][3] * m2.m[3][1];
             r.m[3][2] = m[3][0] * m2.m[0][2] + m[3][1] * m2.m[1][2] + m[3][2] * m2.m[2][2] + m[3][3] * m2.m[3][2];
             r.m[3][3] = m[3][0] * m2.m[0][3] + m[3][1] * m2.m[1][3] + m[3][2] * m2.m[2][3] + m[3][3] * m2.m[3][3];
+#endif
 
             return r;
         }
@@ -587,6 +623,40 @@ namespace Ogre
         {
             assert(isAffine() && m2.isAffine());
 
+#if OGRE_SIMD_MATH && __OGRE_HAVE_SSE
+            Matrix4 r;
+            __m128 b0 = _mm_loadu_ps(m2.m[0]);
+            __m128 b1 = _mm_loadu_ps(m2.m[1]);
+            __m128 b2 = _mm_loadu_ps(m2.m[2]);
+            for (size_t i = 0; i < 3; ++i)
+            {
+                __m128 row = _mm_mul_ps(_mm_set1_ps(m[i][0]), b0);
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i][1]), b1));
+                row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i][2]), b2));
+                // the translation adds to the last column only
+                row = _mm_add_ps(row, _mm_set_ps(m[i][3], 0, 0, 0));
+                _mm_storeu_ps(r.m[i], row);
+            }
+            r.m[3][0] = r.m[3][1] = r.m[3][2] = 0;
+            r.m[3][3] = 1;
+            return r;
+#elif OGRE_SIMD_MATH && __OGRE_HAVE_NEON
+            Matrix4 r;
+            float32x4_t b0 = vld1q_f32(m2.m[0]);
+            float32x4_t b1 = vld1q_f32(m2.m[1]);
+            float32x4_t b2 = vld1q_f32(m2.m[2]);
+            for (size_t i = 0; i < 3; ++i)
+            {
+                float32x4_t row = vmulq_n_f32(b0, m[i][0]);
+                row = vmlaq_n_f32(row, b1, m[i][1]);
+                row = vmlaq_n_f32(row, b2, m[i][2]);
+                row = vsetq_lane_f32(vgetq_lane_f32(row, 3) + m[i][3], row, 3);
+                vst1q_f32(r.m[i], row);
+            }
+            r.m[3][0] = r.m[3][1] = r.m[3][2] = 0;
+            r.m[3][3] = 1;
+            return r;
+#else
             return Matrix4(
                 m[0][0] * m2.m[0][0] + m[0][1] * m2.m[1][0] + m[0][2] * m2.m[2][0],
                 m[0][0] * m2.m[0][1] + m[0][1] * m2.m[1][1] + m[0][2] * m2.m[2][1],
@@ -604,6 +674,7 @@ namespace Ogre
                 m[2][0] * m2.m[0][3] + m[2][1] * m2.m[1][3] + m[2][2] * m2.m[2][3] + m[2][3],
 
                 0, 0, 0, 1);
+#endif
         }
 
         /** 3-D Vector transformation specially for an affine matrix.
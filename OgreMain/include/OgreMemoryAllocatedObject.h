@@ -57,7 +57,7 @@ namespace Ogre
     template <class Alloc>
     class _OgreExport AllocatedObject
     {
-#if OGRE_MEMORY_ALLOCATOR != OGRE_MEMORY_ALLOCATOR_STD || OGRE_MEMORY_TRACKER
+#if OGRE_MEMORY_ALLOCATOR != OGRE_MEMORY_ALLOCATOR_STD || OGRE_MEMORY_TRACKER || OGRE_MEMORY_STATS
     public:
         explicit AllocatedObject()
         { }
@@ -174,10 +174,12 @@ namespace Ogre
         MEMCATEGORY_SCRIPTING = 6,
         /// Rendersystem structures
         MEMCATEGORY_RENDERSYS = 7,
+        /// Transient data only valid until the end of the next frame, see FrameAllocPolicy
+        MEMCATEGORY_FRAME = 8,
 
         
         // sentinel value, do not use 
-        MEMCATEGORY_COUNT = 8
+        MEMCATEGORY_COUNT = 9
     };
     /** @} */
     /** @} */
@@ -186,6 +188,7 @@ namespace Ogre
 
 #include "OgreMemoryAllocatedObject.h"
 #include "OgreMemorySTLAllocator.h"
+#include "OgreMemoryStatsAlloc.h"
 
 #if OGRE_MEMORY_ALLOCATOR == OGRE_MEMORY_ALLOCATOR_NEDPOOLING
 
@@ -198,8 +201,13 @@ namespace Ogre
 
     // configurable category, for general malloc
     // notice how we ignore the category here, you could specialise
+#if OGRE_MEMORY_STATS
+    template <MemoryCategory Cat> class CategorisedAllocPolicy : public StatsAllocPolicy<Cat, NedPoolingPolicy>{};
+    template <MemoryCategory Cat, size_t align = 0> class CategorisedAlignAllocPolicy : public StatsAllocPolicy<Cat, NedPoolingAlignedPolicy<align>, align>{};
+#else
     template <MemoryCategory Cat> class CategorisedAllocPolicy : public NedPoolingPolicy{};
     template <MemoryCategory Cat, size_t align = 0> class CategorisedAlignAllocPolicy : public NedPoolingAlignedPolicy<align>{};
+#endif
 }
 
 #elif OGRE_MEMORY_ALLOCATOR == OGRE_MEMORY_ALLOCATOR_NED
@@ -213,8 +221,13 @@ namespace Ogre
 
     // configurable category, for general malloc
     // notice how we ignore the category here, you could specialise
+#if OGRE_MEMORY_STATS
+    template <MemoryCategory Cat> class CategorisedAllocPolicy : public StatsAllocPolicy<Cat, NedAllocPolicy>{};
+    template <MemoryCategory Cat, size_t align = 0> class CategorisedAlignAllocPolicy : public StatsAllocPolicy<Cat, NedAlignedAllocPolicy<align>, align>{};
+#else
     template <MemoryCategory Cat> class CategorisedAllocPolicy : public NedAllocPolicy{};
     template <MemoryCategory Cat, size_t align = 0> class CategorisedAlignAllocPolicy : public NedAlignedAllocPolicy<align>{};
+#endif
 }
 
 #elif OGRE_MEMORY_ALLOCATOR == OGRE_MEMORY_ALLOCATOR_STD
@@ -228,8 +241,13 @@ namespace Ogre
 
     // configurable category, for general malloc
     // notice how we ignore the category here
+#if OGRE_MEMORY_STATS
+    template <MemoryCategory Cat> class CategorisedAllocPolicy : public StatsAllocPolicy<Cat, StdAllocPolicy>{};
+    template <MemoryCategory Cat, size_t align = 0> class CategorisedAlignAllocPolicy : public StatsAllocPolicy<Cat, StdAlignedAllocPolicy<align>, align>{};
+#else
     template <MemoryCategory Cat> class CategorisedAllocPolicy : public StdAllocPolicy{};
     template <MemoryCategory Cat, size_t align = 0> class CategorisedAlignAllocPolicy : public StdAlignedAllocPolicy<align>{};
+#endif
 
     // if you wanted to specialise the allocation per category, here's how it might work:
     // template <> class CategorisedAllocPolicy<MEMCATEGORY_SCENE_OBJECTS> : public YourSceneObjectAllocPolicy{};
@@ -244,6 +262,16 @@ namespace Ogre
 
 #endif
 
+#include "OgreMemoryFrameAlloc.h"
+namespace Ogre
+{
+    // whatever the allocator, frame memory comes from the per thread arenas
+    template <> class CategorisedAllocPolicy<MEMCATEGORY_FRAME> : public FrameAllocPolicy{};
+    template <size_t align> class CategorisedAlignAllocPolicy<MEMCATEGORY_FRAME, align> : public FrameAlignedAllocPolicy<align>{};
+}
+
+#include "OgreMemoryPooledAlloc.h"
+
 namespace Ogre
 {
     // Useful shortcuts
@@ -256,6 +284,11 @@ namespace Ogre
     typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_SCRIPTING> ScriptingAllocPolicy;
     typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_RENDERSYS> RenderSysAllocPolicy;
 
+    // Thread local pools for small objects
+    typedef PooledAllocPolicy<Ogre::MEMCATEGORY_GENERAL> GeneralPooledAllocPolicy;
+    typedef PooledAllocPolicy<Ogre::MEMCATEGORY_SCENE_CONTROL> SceneCtlPooledAllocPolicy;
+    typedef PooledAllocPolicy<Ogre::MEMCATEGORY_SCENE_OBJECTS> SceneObjPooledAllocPolicy;
+
     // Now define all the base classes for each allocation
     typedef AllocatedObject<GeneralAllocPolicy> GeneralAllocatedObject;
     typedef AllocatedObject<GeometryAllocPolicy> GeometryAllocatedObject;
@@ -265,6 +298,9 @@ namespace Ogre
     typedef AllocatedObject<ResourceAllocPolicy> ResourceAllocatedObject;
     typedef AllocatedObject<ScriptingAllocPolicy> ScriptingAllocatedObject;
     typedef AllocatedObject<RenderSysAllocPolicy> RenderSysAllocatedObject;
+    typedef AllocatedObject<GeneralPooledAllocPolicy> GeneralPooledAllocatedObject;
+    typedef AllocatedObject<SceneCtlPooledAllocPolicy> SceneCtlPooledAllocatedObject;
+    typedef AllocatedObject<SceneObjPooledAllocPolicy> SceneObjPooledAllocatedObject;
 
 
     // Per-class allocators defined here
@@ -274,6 +310,7 @@ namespace Ogre
     typedef ScriptingAllocatedObject    AbstractNodeAlloc;
     typedef AnimationAllocatedObject    AnimableAlloc;
     typedef AnimationAllocatedObject    AnimationAlloc;
+    typedef GeneralPooledAllocatedObject AnyAlloc;
     typedef GeneralAllocatedObject      ArchiveAlloc;
     typedef GeometryAllocatedObject     BatchedGeometryAlloc;
     typedef RenderSysAllocatedObject    BufferAlloc;
@@ -290,9 +327,10 @@ namespace Ogre
     typedef GeometryAllocatedObject     IndexDataAlloc;
     typedef GeneralAllocatedObject      LogAlloc;
     typedef SceneObjAllocatedObject     MovableAlloc;
-    typedef SceneCtlAllocatedObject     NodeAlloc;
+    typedef SceneCtlPooledAllocatedObject NodeAlloc;
     typedef SceneObjAllocatedObject     OverlayAlloc;
     typedef RenderSysAllocatedObject    GpuParamsAlloc;
+    typedef SceneObjPooledAllocatedObject ParticleAlloc;
     typedef ResourceAllocatedObject     PassAlloc;
     typedef GeometryAllocatedObject     PatchAlloc;
     typedef GeneralAllocatedObject      PluginAlloc;
@@ -316,6 +354,7 @@ namespace Ogre
     typedef GeneralAllocatedObject      UtilityAlloc;
     typedef GeometryAllocatedObject     VertexDataAlloc;
     typedef RenderSysAllocatedObject    ViewportAlloc;
+    typedef GeneralPooledAllocatedObject WorkQueueAlloc;
     typedef SceneCtlAllocatedObject     LodAlloc;
     typedef GeneralAllocatedObject      FileSystemLayerAlloc;
     typedef GeneralAllocatedObject      StereoDriverAlloc;
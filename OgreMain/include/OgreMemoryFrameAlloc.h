@@ -0,0 +1,134 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __MemoryFrameAlloc_H__
+#define __MemoryFrameAlloc_H__
+
+#include <limits>
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup Memory
+	*  @{
+	*/
+	/**	An allocation policy for memory which only lives for a frame, for use
+		with STLAllocator and the MEMCATEGORY_FRAME category.
+		@par
+		Each thread bumps a pointer through an arena of its own and
+		deallocateBytes does nothing, so transient containers cost no more
+		than a pointer increment. The arena is double buffered: memory
+		allocated during a frame stays valid until the end of the following
+		frame, after which it is reused. The frame is advanced by 
+		Root::_fireFrameEnded, so nothing allocated here may be kept longer
+		than that, which rules out containers held by objects.
+		@par
+		Allocations are aligned to 16 bytes, see FrameAlignedAllocPolicy
+		for larger alignments.
+	*/
+	class _OgreExport FrameAllocPolicy
+	{
+	public:
+		static DECL_MALLOC void* allocateBytes(size_t count, 
+			const char* file = 0, int line = 0, const char* func = 0);
+
+		/// Memory is released in bulk when the frame is over
+		static inline void deallocateBytes(void*)
+		{ }
+
+		/// Get the maximum size of a single allocation
+		static inline size_t getMaxAllocationSize()
+		{
+			return std::numeric_limits<size_t>::max();
+		}
+
+		/// Allocate from the arena of the calling thread at a given alignment
+		static DECL_MALLOC void* allocateAlignedBytes(size_t count, size_t alignment);
+
+		/** Advance to the next frame, called by Root::_fireFrameEnded.
+		@remarks
+			Each thread recycles its arena on its first allocation of a new
+			frame, so the arenas of other threads are not touched here.
+		*/
+		static void _nextFrame();
+
+		/// Release the arena of the calling thread
+		static void _releaseThreadArena();
+	private:
+		// no instantiation
+		FrameAllocPolicy()
+		{ }
+	};
+
+	/**	A frame allocation policy which aligns memory at a given boundary (which 
+		should be a power of 2).
+		@note
+		template parameter Alignment equal to zero means the 16 bytes of 
+		FrameAllocPolicy.
+	*/
+	template <size_t Alignment = 0>
+	class FrameAlignedAllocPolicy
+	{
+	public:
+		// compile-time check alignment is available.
+		typedef int IsValidAlignment
+			[Alignment <= 128 && ((Alignment & (Alignment-1)) == 0) ? +1 : -1];
+
+		static inline DECL_MALLOC void* allocateBytes(size_t count, 
+			const char*  = 0, int  = 0, const char* = 0)
+		{
+			return FrameAllocPolicy::allocateAlignedBytes(count, Alignment);
+		}
+
+		static inline void deallocateBytes(void*)
+		{ }
+
+		/// Get the maximum size of a single allocation
+		static inline size_t getMaxAllocationSize()
+		{
+			return std::numeric_limits<size_t>::max();
+		}
+	private:
+		// No instantiation
+		FrameAlignedAllocPolicy()
+		{ }
+	};
+
+	/** @} */
+	/** @} */
+
+}// namespace Ogre
+
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __MemoryFrameAlloc_H__
@@ -0,0 +1,192 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __MemoryPooledAlloc_H__
+#define __MemoryPooledAlloc_H__
+
+#include <limits>
+
+#include "OgreMemoryAllocatedObject.h"
+#include "OgreHeaderPrefix.h"
+
+// Anything that has done a #define new <blah> will screw operator new definitions up
+// so undefine
+#ifdef new
+#  undef new
+#endif
+#ifdef delete
+#  undef delete
+#endif
+
+namespace Ogre
+{
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup Memory
+	*  @{
+	*/
+	/**	Non-templated part of PooledAllocPolicy, the thread local slab pools.
+		@par
+		Every thread owns a set of pools, one per MemoryCategory and size 
+		class, carving fixed size blocks out of slabs. Blocks freed by the 
+		owning thread go back to its free list without any synchronisation,
+		blocks freed by other threads are pushed onto a lock-free list of
+		the owning pool which is taken over when the local list runs dry. 
+		The pools of a finished thread are handed to the next new thread.
+	*/
+	class _OgreExport PooledAllocImpl
+	{
+	public:
+		/// Bytes in front of every block, recording where it came from
+		static const size_t HEADER_SIZE = 16;
+		/// Largest allocation, header included, served by the pools
+		static const size_t MAX_POOLED_SIZE = 1024;
+
+		/// Allocate a block of up to MAX_POOLED_SIZE - HEADER_SIZE bytes
+		static void* allocBytes(size_t count, MemoryCategory category,
+			const char* file, int line, const char* func);
+		/// Free a block returned by allocBytes, from any thread
+		static void deallocBytes(void* ptr);
+
+		/// Whether the header of an allocation says it lives in a pool
+		static inline bool isPooled(void* ptr)
+		{
+			return *reinterpret_cast<void**>(static_cast<uchar*>(ptr) - HEADER_SIZE) != 0;
+		}
+	};
+
+	/**	An allocation policy for use with AllocatedObject and STLAllocator
+		serving small allocations from thread local slab pools.
+		@par
+		Meant for small objects which are created and destroyed in large 
+		numbers, possibly from several threads, such as nodes and particles.
+		Allocations too big for the pools are passed on to 
+		CategorisedAllocPolicy of the same category.
+		@note
+		Every allocation carries a header of PooledAllocImpl::HEADER_SIZE 
+		bytes, so this is not worth it for large objects.
+	*/
+	template <MemoryCategory Cat>
+	class PooledAllocPolicy
+	{
+	public:
+		static inline void* allocateBytes(size_t count, 
+			const char* file = 0, int line = 0, const char* func = 0)
+		{
+			if (count <= PooledAllocImpl::MAX_POOLED_SIZE - PooledAllocImpl::HEADER_SIZE)
+				return PooledAllocImpl::allocBytes(count, Cat, file, line, func);
+
+			// Mark the allocation as not pooled
+			uchar* ptr = static_cast<uchar*>(CategorisedAllocPolicy<Cat>::allocateBytes(
+				count + PooledAllocImpl::HEADER_SIZE, file, line, func));
+			*reinterpret_cast<void**>(ptr) = 0;
+			return ptr + PooledAllocImpl::HEADER_SIZE;
+		}
+
+		static inline void deallocateBytes(void* ptr)
+		{
+			// deal with null
+			if (!ptr)
+				return;
+
+			if (PooledAllocImpl::isPooled(ptr))
+				PooledAllocImpl::deallocBytes(ptr);
+			else
+				CategorisedAllocPolicy<Cat>::deallocateBytes(static_cast<uchar*>(ptr) - PooledAllocImpl::HEADER_SIZE);
+		}
+
+		/// Get the maximum size of a single allocation
+		static inline size_t getMaxAllocationSize()
+		{
+			return std::numeric_limits<size_t>::max() - PooledAllocImpl::HEADER_SIZE;
+		}
+	private:
+		// No instantiation
+		PooledAllocPolicy()
+		{ }
+	};
+
+#if OGRE_MEMORY_ALLOCATOR == OGRE_MEMORY_ALLOCATOR_STD && !OGRE_MEMORY_TRACKER && !OGRE_MEMORY_STATS
+	/** With the std allocator AllocatedObject leaves new and delete to the
+		global operators, the pooled policy still needs its own.
+	*/
+	template <MemoryCategory Cat>
+	class AllocatedObject<PooledAllocPolicy<Cat> >
+	{
+	public:
+		explicit AllocatedObject()
+		{ }
+
+		~AllocatedObject()
+		{ }
+
+		void* operator new(size_t sz)
+		{
+			return PooledAllocPolicy<Cat>::allocateBytes(sz);
+		}
+
+		/// placement operator new
+		void* operator new(size_t sz, void* ptr)
+		{
+			(void) sz;
+			return ptr;
+		}
+
+		void* operator new[] ( size_t sz )
+		{
+			return PooledAllocPolicy<Cat>::allocateBytes(sz);
+		}
+
+		void operator delete( void* ptr )
+		{
+			PooledAllocPolicy<Cat>::deallocateBytes(ptr);
+		}
+
+		// Corresponding operator for placement delete (second param same as the first)
+		void operator delete( void* ptr, void* )
+		{
+			PooledAllocPolicy<Cat>::deallocateBytes(ptr);
+		}
+
+		void operator delete[] ( void* ptr )
+		{
+			PooledAllocPolicy<Cat>::deallocateBytes(ptr);
+		}
+	};
+#endif
+
+	/** @} */
+	/** @} */
+
+}// namespace Ogre
+
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __MemoryPooledAlloc_H__
@@ -215,6 +215,29 @@ namespace Ogre
         return true;
     }
 
+    class FrameAllocPolicy;
+
+    /** STLAllocator taking its memory from FrameAllocPolicy.
+    @remarks
+        Only for containers that are thrown away within the frame, see
+        FrameAllocPolicy for how long the memory lives. This is used
+        whether or not OGRE_CONTAINERS_USE_CUSTOM_MEMORY_ALLOCATOR is set.
+    */
+    template <typename T>
+    struct FrameSTLAllocator
+    {
+        typedef STLAllocator<T, FrameAllocPolicy> type;
+    };
+
+    /// A std::vector using FrameSTLAllocator, for per frame temporaries
+    template <typename T>
+    struct frame_vector
+    {
+        typedef typename std::vector<T, STLAllocator<T, FrameAllocPolicy> > type;
+        typedef typename std::vector<T, STLAllocator<T, FrameAllocPolicy> >::iterator iterator;
+        typedef typename std::vector<T, STLAllocator<T, FrameAllocPolicy> >::const_iterator const_iterator;
+    };
+
 
     /** @} */
     /** @} */
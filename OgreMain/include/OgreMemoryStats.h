@@ -0,0 +1,139 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __MemoryStats_H__
+#define __MemoryStats_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Memory
+    *  @{
+    */
+    /** Counters of the memory used by the parts of the engine, with budgets.
+    @remarks
+        Unlike MemoryTracker the counters are kept in every build type and
+        cost no more than an atomic add per allocation. Hardware buffers and
+        textures are always counted. The memory categories are only counted
+        when OGRE_MEMORY_STATS is set, since this puts a small header in front
+        of every allocation made through CategorisedAllocPolicy.
+    @par
+        A budget can be set on every part. When the usage goes over it, this
+        is logged and reported to the Listener, once until the usage drops
+        below the budget again. Budgets are checked at the end of every frame.
+    */
+    class _OgreExport MemoryStats
+    {
+    public:
+        /// Memory used by a part of the engine
+        struct Usage
+        {
+            /// Bytes in main memory
+            size_t cpuBytes;
+            /// Bytes in GPU memory
+            size_t gpuBytes;
+            /// Number of live allocations or objects
+            size_t count;
+
+            Usage() : cpuBytes(0), gpuBytes(0), count(0) {}
+
+            /// Bytes in both main and GPU memory
+            size_t getTotalBytes() const { return cpuBytes + gpuBytes; }
+        };
+
+        /// Parts of the engine counted on top of the memory categories
+        enum Pool
+        {
+            /// Vertex, index, uniform and counter buffers, shadow copies in main memory
+            POOL_HARDWARE_BUFFERS,
+            /// Textures, mipmaps included
+            POOL_TEXTURES,
+            POOL_COUNT
+        };
+
+        /** Listener notified when a budget is exceeded
+        */
+        class _OgreExport Listener
+        {
+        public:
+            virtual ~Listener() {}
+            /** Called at the end of the frame in which the usage went over the budget
+            @param name The memory category or pool, as returned by getName
+            */
+            virtual void budgetExceeded(const String& name, const Usage& usage, size_t budget) = 0;
+        };
+
+        /// Get the usage of a memory category, needs OGRE_MEMORY_STATS
+        static Usage getUsage(MemoryCategory category);
+        /// Get the usage of a pool
+        static Usage getUsage(Pool pool);
+
+        /// Get the display name of a memory category
+        static const String& getName(MemoryCategory category);
+        /// Get the display name of a pool
+        static const String& getName(Pool pool);
+
+        /** Set the budget of a memory category in bytes, 0 for none
+        @remarks
+            Compared against the bytes in main memory.
+        */
+        static void setBudget(MemoryCategory category, size_t bytes);
+        /** Set the budget of a pool in bytes, 0 for none
+        @remarks
+            Compared against the bytes in both main and GPU memory.
+        */
+        static void setBudget(Pool pool, size_t bytes);
+        static size_t getBudget(MemoryCategory category);
+        static size_t getBudget(Pool pool);
+
+        /// Set the listener notified of exceeded budgets, there is only one
+        static void setListener(Listener* listener);
+        static Listener* getListener(void);
+
+        /// Get a line per category and pool with their usage, empty ones skipped
+        static String getReport(void);
+
+        /// Check the budgets, called by Root at the end of every frame
+        static void _checkBudgets(void);
+        /// Count GPU or main memory of a pool being allocated
+        static void _recordAlloc(Pool pool, size_t bytes, bool systemMemory);
+        /// Count GPU or main memory of a pool being freed
+        static void _recordDealloc(Pool pool, size_t bytes, bool systemMemory);
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
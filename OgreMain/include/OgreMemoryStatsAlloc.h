@@ -0,0 +1,112 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __MemoryStatsAlloc_H__
+#define __MemoryStatsAlloc_H__
+
+#include <limits>
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+	/** \addtogroup Core
+	*  @{
+	*/
+	/** \addtogroup Memory
+	*  @{
+	*/
+	/**	Non-templated utility class holding the counters of MemoryStats.
+	*/
+	class _OgreExport MemoryStatsImpl
+	{
+	public:
+		static void recordAlloc(MemoryCategory category, size_t count);
+		static void recordDealloc(MemoryCategory category, size_t count);
+	};
+
+#if OGRE_MEMORY_STATS
+	/**	An allocation policy counting the bytes and allocations of a category
+		before passing them on to another policy.
+		@par
+		The size of each allocation is kept in a header in front of it, so
+		that the counters can be updated when it is freed. The header is as
+		large as the alignment of the allocation, at least 16 bytes.
+		@note
+		Only used by CategorisedAllocPolicy and CategorisedAlignAllocPolicy 
+		when OGRE_MEMORY_STATS is set, see MemoryStats for the results.
+	*/
+	template <MemoryCategory Cat, class Policy, size_t Alignment = 0>
+	class StatsAllocPolicy
+	{
+	public:
+		/// Bytes in front of every allocation
+		static const size_t HEADER_SIZE = Alignment > 16 ? Alignment : 16;
+
+		static inline void* allocateBytes(size_t count, 
+			const char* file = 0, int line = 0, const char* func = 0)
+		{
+			unsigned char* ptr = static_cast<unsigned char*>(
+				Policy::allocateBytes(count + HEADER_SIZE, file, line, func));
+			*reinterpret_cast<size_t*>(ptr) = count;
+			MemoryStatsImpl::recordAlloc(Cat, count);
+			return ptr + HEADER_SIZE;
+		}
+
+		static inline void deallocateBytes(void* ptr)
+		{
+			// deal with null
+			if (!ptr)
+				return;
+
+			unsigned char* base = static_cast<unsigned char*>(ptr) - HEADER_SIZE;
+			MemoryStatsImpl::recordDealloc(Cat, *reinterpret_cast<size_t*>(base));
+			Policy::deallocateBytes(base);
+		}
+
+		/// Get the maximum size of a single allocation
+		static inline size_t getMaxAllocationSize()
+		{
+			return Policy::getMaxAllocationSize() - HEADER_SIZE;
+		}
+	private:
+		// No instantiation
+		StatsAllocPolicy()
+		{ }
+	};
+#endif
+
+	/** @} */
+	/** @} */
+
+}// namespace Ogre
+
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __MemoryStatsAlloc_H__
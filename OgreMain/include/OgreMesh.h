@@ -723,6 +723,49 @@ namespace Ogre {
         bool suggestTangentVectorBuildParams(VertexElementSemantic targetSemantic,
             unsigned short& outSourceCoordSet, unsigned short& outIndex);
 
+        /** Reorders the geometry of this mesh to make better use of the post-transform
+            vertex cache.
+        @remarks
+            The faces of every triangle list SubMesh are reordered with
+            IndexData::optimiseVertexCacheTriList, including the manual LOD face
+            lists which don't share their index buffer with another level.
+            Optionally the vertices are then reordered in the order the faces
+            first use them, which improves the locality of vertex fetches;
+            vertices no face uses are moved to the end.
+        @par
+            The vertices are left alone if the mesh has poses or vertex animation,
+            or has been prepared for shadow volumes, since those rely on the vertex
+            order. Bone assignments are remapped and any edge list is rebuilt.
+        @param reorderVertices
+            Whether to reorder the vertices as well as the faces.
+        */
+        void optimiseVertexCache(bool reorderVertices = true);
+
+        /** Splits SubMeshes influenced by too many bones into several SubMeshes,
+            so that every one of them can be skinned in a vertex program.
+        @remarks
+            Skinning in a vertex program needs all blend matrices of a SubMesh in
+            its constants, which limits the number of bones it can be influenced by.
+            The faces of every triangle list SubMesh using more than maxBones bones
+            are grouped into partitions using at most maxBones bones each, and each
+            partition gets its own SubMesh with the same material and dedicated
+            vertex data holding only the vertices it uses. The blend indices are
+            then compiled again, so they index the smaller palette of each SubMesh.
+            A SubMesh using the shared geometry is moved to dedicated geometry, since
+            the shared palette holds the bones of all SubMeshes using it.
+        @par
+            Nothing is done if the mesh has poses or vertex animation, or has been
+            prepared for shadow volumes, since those rely on the vertex order. LOD
+            levels are removed, generate them afterwards. Any edge list is rebuilt.
+            The buffers are read back, so they need shadow buffers if the mesh was
+            loaded for rendering.
+        @param maxBones
+            The number of bones a SubMesh may be influenced by, at least 12 so a
+            triangle of vertices with 4 bones each always fits.
+        @return true if any SubMesh was split
+        */
+        bool splitSubMeshesByBones(size_t maxBones);
+
         /** Builds an edge list for this mesh, which can be used for generating a shadow volume
             among other things.
         */
@@ -864,6 +907,14 @@ namespace Ogre {
             const map<size_t, Vector3>::type& vertexOffsetMap,
             const map<size_t, Vector3>::type& normalsMap,
             VertexData* targetVertexData);
+        /** Performs a software vertex pose blend from the packed vertices of a pose.
+        @remarks
+            Same as the version taking the offset maps, but walks the arrays
+            of Pose::_getPackedIndexes with OptimisedUtil::accumulateVertexOffsets,
+            and splits large poses over the worker threads.
+        */
+        static void softwareVertexPoseBlend(Real weight, const Pose* pose,
+            VertexData* targetVertexData);
         /** Gets a reference to the optional name assignments of the SubMeshes. */
         const SubMeshNameMap& getSubMeshNameMap(void) const { return mSubMeshNameMap; }
 
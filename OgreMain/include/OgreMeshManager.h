@@ -370,6 +370,9 @@ namespace Ogre {
             @param ibUseShadow
                 Flag to determine if a shadow buffer is generated for the index buffer. See
                 HardwareBuffer for full details.
+            @param hardwareTessellation
+                Flag to keep just the control points in the mesh, to be subdivided by the
+                tessellation programs of the material. See PatchMesh for full details.
         */
         PatchMeshPtr createBezierPatch(
             const String& name, const String& groupName, void* controlPointBuffer, 
@@ -379,7 +382,8 @@ namespace Ogre {
             PatchSurface::VisibleSide visibleSide = PatchSurface::VS_FRONT,
             HardwareBuffer::Usage vbUsage = HardwareBuffer::HBU_STATIC_WRITE_ONLY, 
             HardwareBuffer::Usage ibUsage = HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY,
-            bool vbUseShadow = true, bool ibUseShadow = true);
+            bool vbUseShadow = true, bool ibUseShadow = true,
+            bool hardwareTessellation = false);
         
         /** Tells the mesh manager that all future meshes should prepare themselves for
             shadow volumes on loading.
@@ -186,14 +186,48 @@ namespace Ogre {
         /// This function can be overloaded to disable validation in debug builds.
         virtual void enableValidation();
 
+        /** Writes padding so that the following buffer data is aligned relative to
+            the start of the mesh data, returns its size. Buffer data is preceded and followed by padding which
+            together take up calcDataAlignmentSize bytes, so that chunk sizes do not
+            depend on the position in the file.
+        */
+        virtual size_t writeDataAlignment();
+        /// Writes the padding following buffer data
+        virtual void writeDataAlignmentEnd(size_t alignment);
+        /// Returns the size of the padding around buffer data
+        virtual size_t calcDataAlignmentSize();
+        /// Skips the padding preceding buffer data, returns its size
+        virtual size_t readDataAlignment(DataStreamPtr& stream);
+        /// Skips the padding following buffer data
+        virtual void readDataAlignmentEnd(DataStreamPtr& stream, size_t alignment);
+
         ushort exportedLodCount; // Needed to limit exported Edge data, when exporting
+
+        /// Position of the file header in the stream, which buffer data is aligned relative to
+        size_t mStartPosition;
+    };
+
+    /** Class for providing backwards-compatibility for loading version 1.10 of the .mesh format.
+     This mesh format was used from Ogre v1.10, it does not align buffer data.
+     */
+    class _OgrePrivate MeshSerializerImpl_v1_10 : public MeshSerializerImpl
+    {
+    public:
+        MeshSerializerImpl_v1_10();
+        ~MeshSerializerImpl_v1_10();
+    protected:
+        virtual size_t writeDataAlignment();
+        virtual void writeDataAlignmentEnd(size_t alignment);
+        virtual size_t calcDataAlignmentSize();
+        virtual size_t readDataAlignment(DataStreamPtr& stream);
+        virtual void readDataAlignmentEnd(DataStreamPtr& stream, size_t alignment);
     };
 
 
     /** Class for providing backwards-compatibility for loading version 1.8 of the .mesh format. 
      This mesh format was used from Ogre v1.8.
      */
-    class _OgrePrivate MeshSerializerImpl_v1_8 : public MeshSerializerImpl
+    class _OgrePrivate MeshSerializerImpl_v1_8 : public MeshSerializerImpl_v1_10
     {
     public:
         MeshSerializerImpl_v1_8();
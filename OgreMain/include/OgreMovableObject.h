@@ -144,6 +144,10 @@ namespace Ogre {
         mutable AxisAlignedBox mWorldDarkCapBounds;
         /// Does this object cast shadows?
         bool mCastShadows;
+        /// Does this object hide what is behind it from occlusion culling?
+        bool mOccluder;
+        /// Does this object never move, so its shadows may be cached?
+        bool mStaticShadowCaster;
 
         /// Does rendering this object disabled by listener?
         bool mRenderingDisabled;
@@ -533,6 +537,32 @@ namespace Ogre {
         void setCastShadows(bool enabled) { mCastShadows = enabled; }
         /** Returns whether shadow casting is enabled for this object. */
         bool getCastShadows(void) const { return mCastShadows; }
+        /** Sets whether this object is used as an occluder by scene managers
+            doing software occlusion culling.
+        @remarks
+            Occluders are drawn into a small depth buffer on the CPU, against
+            which the bounds of other objects are tested. Only mark large,
+            solid and static objects such as buildings or terrain, since
+            every occluder costs time, and objects seen through gaps in an
+            occluder may be culled. Scene managers without occlusion culling
+            ignore this. Off by default.
+        */
+        void setOccluder(bool occluder) { mOccluder = occluder; }
+        /** Returns whether this object is used as an occluder. */
+        bool isOccluder(void) const { return mOccluder; }
+        /** Sets whether this object is a static shadow caster.
+        @remarks
+            When shadow texture caching is enabled on the SceneManager, static
+            casters are rendered into the shadow textures once and kept until
+            a light or a static caster moves, see
+            SceneManager::setShadowTextureCaching. Moving, attaching or
+            detaching a static caster refreshes the cache, other changes to
+            how it looks (visibility, animation, material) need a call to
+            SceneManager::invalidateShadowTextureCache. Off by default.
+        */
+        void setStaticShadowCaster(bool isStatic);
+        /** Returns whether this object is a static shadow caster. */
+        bool isStaticShadowCaster(void) const { return mStaticShadowCaster; }
         /** Returns whether the Material of any Renderable that this MovableObject will add to 
             the render queue will receive shadows. 
         */
@@ -69,9 +69,22 @@ namespace Ogre {
         String generate()
         {
             OGRE_LOCK_AUTO_MUTEX;
-            StringStream s;
-            s << mPrefix << mNext++;
-            return s.str();
+            // Format the number by hand, a StringStream costs more than the rest of
+            // creating a scene object
+            char digits[24];
+            char* end = digits + sizeof(digits);
+            char* begin = end;
+            unsigned long long int n = mNext++;
+            do
+            {
+                *--begin = char('0' + n % 10);
+                n /= 10;
+            } while (n);
+
+            String name;
+            name.reserve(mPrefix.size() + (end - begin));
+            name.append(mPrefix).append(begin, end);
+            return name;
         }
 
         /// Reset the internal counter
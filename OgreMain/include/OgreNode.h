@@ -78,6 +78,10 @@ namespace Ogre {
         typedef VectorIterator<ChildNodeMap> ChildNodeIterator;
         typedef ConstVectorIterator<ChildNodeMap> ConstChildNodeIterator;
 #endif
+        /// A node whose subtree still has to be updated, with the parentHasChanged flag to pass to _update
+        typedef std::pair<Node*, bool> PendingUpdate;
+        typedef vector<PendingUpdate>::type PendingUpdateList;
+        typedef vector<Node*>::type NodeList;
 
         /** Listener which gets called back on Node events.
         */
@@ -191,6 +195,21 @@ namespace Ogre {
         */
         mutable Vector3 mDerivedScale;
 
+        /// Where the derived orientation is kept, mDerivedOrientation unless a NodeTransformPool holds it
+        Quaternion* mDerivedOrientationPtr;
+        /// Where the derived position is kept, mDerivedPosition unless a NodeTransformPool holds it
+        Vector3* mDerivedPositionPtr;
+        /// Where the derived scale is kept, mDerivedScale unless a NodeTransformPool holds it
+        Vector3* mDerivedScalePtr;
+
+        /// The pool holding the derived transform, if any
+        NodeTransformPool* mTransformPool;
+        /// Hierarchy level of the node in mTransformPool
+        size_t mTransformPoolDepth;
+        /// Slot of the node within its level of mTransformPool
+        size_t mTransformPoolIndex;
+        friend class NodeTransformPool;
+
         /** Triggers the node to update it's combined transforms.
         @par
             This method is called internally by Ogre to ask the node
@@ -585,6 +604,30 @@ namespace Ogre {
         */
         virtual void _update(bool updateChildren, bool parentHasChanged);
 
+        /** Internal method to update the top levels of the hierarchy only.
+        @remarks
+            Does the same work as _update(true, parentHasChanged), but stops descending
+            after maxDepth levels. The children at that depth which need updating are
+            appended to subtrees instead, so that their own _update calls can be issued
+            separately, e.g. from several threads since the subtrees are disjoint.
+        @param parentHasChanged
+            See _update.
+        @param maxDepth
+            Number of levels below this node to update here, must be at least 1.
+        @param subtrees
+            List to which the roots of the remaining subtrees are appended.
+        @param updated
+            List to which this node and every descendant updated here is appended,
+            children before their parents. Work that depends on the children being up
+            to date (like SceneNode::_updateBounds) can be completed in that order once
+            all subtrees have been updated.
+        */
+        void _updateToDepth(bool parentHasChanged, size_t maxDepth,
+            PendingUpdateList& subtrees, NodeList& updated);
+
+        /// Get the NodeTransformPool holding the derived transform of this node, if any
+        NodeTransformPool* _getTransformPool(void) const { return mTransformPool; }
+
         /** Sets a listener for this Node.
         @remarks
             Note for size and performance reasons only one listener per node is
@@ -0,0 +1,143 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NodeTransformPool_H__
+#define __NodeTransformPool_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreNode.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Contiguous storage for the derived transforms of a node hierarchy.
+    @remarks
+        Normally every Node keeps its derived orientation, position and scale
+        inside the node object, so updating a large hierarchy touches memory
+        spread all over the heap. Nodes attached to a pool store these values
+        in arrays instead, one set of arrays per hierarchy depth, so that the
+        parent values read while updating one level are packed next to each
+        other. The Node interface is unchanged, the getters simply read from
+        the pool.
+    @par
+        The arrays are allocated in fixed size chunks and a node keeps its slot
+        for as long as it is attached, so the references returned by
+        Node::_getDerivedPosition and friends stay valid while other nodes are
+        attached or detached. Freed slots are reused by the next attached node.
+    @par
+        The update method walks the hierarchy level by level instead of
+        recursively, updating all dirty nodes of a level in one pass.
+    @note
+        Nodes must be attached at their actual depth in the hierarchy, and
+        re-attached when they are moved to a different depth. SceneNode does
+        this automatically when its SceneManager has a pool.
+    */
+    class _OgreExport NodeTransformPool : public NodeAlloc
+    {
+    public:
+        NodeTransformPool();
+        /// Detaches all nodes, which get their derived transform copied back
+        ~NodeTransformPool();
+
+        /** Move the derived transform of a node into the pool.
+        @param node The node, which must not be attached to a pool yet
+        @param depth The number of ancestors of the node
+        */
+        void attach(Node* node, size_t depth);
+
+        /// Move the derived transform of a node back into the node
+        void detach(Node* node);
+
+        /// Attach a node and all its descendants, see attach
+        void attachHierarchy(Node* node, size_t depth);
+
+        /** Update the derived transforms of a hierarchy, one level at a time.
+        @remarks
+            Has the same effect as node->_update(true, false) for Node itself,
+            but any work a subclass does in addition to Node::_update is not
+            done.
+        @param root The root of the hierarchy to update
+        @param updated List to which all updated nodes are appended, parents
+            before their children. Iterate it backwards to do work which
+            depends on the children being up to date, like merging bounds.
+        */
+        void update(Node* root, Node::NodeList& updated);
+
+        /// Get the number of hierarchy levels which currently hold nodes
+        size_t getLevelCount(void) const { return mLevels.size(); }
+
+        /// Get the number of nodes stored for a hierarchy level
+        size_t getNodeCount(size_t depth) const;
+
+    protected:
+        /// Number of slots allocated at once
+        static const size_t CHUNK_SIZE = 256;
+
+        /// Slots of a level which never move, all arrays are indexed alike
+        struct Chunk : public NodeAlloc
+        {
+            Quaternion orientations[CHUNK_SIZE];
+            Vector3 positions[CHUNK_SIZE];
+            Vector3 scales[CHUNK_SIZE];
+            /// The node of each slot, null if free
+            Node* nodes[CHUNK_SIZE];
+        };
+        typedef vector<Chunk*>::type ChunkList;
+
+        /// Storage of one hierarchy level
+        struct Level : public NodeAlloc
+        {
+            ChunkList chunks;
+            /// Slots which were used before and are free now
+            vector<size_t>::type freeSlots;
+            /// Number of slots ever used, slots past it are unused
+            size_t usedSlots;
+            /// Number of attached nodes
+            size_t nodeCount;
+
+            Level() : usedSlots(0), nodeCount(0) {}
+        };
+        typedef vector<Level*>::type LevelList;
+        LevelList mLevels;
+
+        /// Nodes waiting to be updated by update, reused between calls
+        Node::PendingUpdateList mPending;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
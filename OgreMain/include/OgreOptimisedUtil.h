@@ -203,6 +203,87 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Calculate the visibility of axis aligned boxes against a set of planes.
+        @remarks
+            A box is invisible if it lies completely on the negative side of any
+            of the planes, as Plane::getSide reports it. Boxes are tested four at
+            a time.
+        @param planes An array of planes packed in (normal.x, normal.y,
+            normal.z, d) format. No alignment requirement.
+        @param numPlanes Number of planes in the array.
+        @param bounds The boxes packed in groups of four, each group holding
+            the centre x, y and z and the half size x, y and z of the four
+            boxes, four floats each (24 floats per group). The last group is
+            padded when numBoxes is not a multiple of four. Must be aligned to
+            SIMD alignment.
+        @param visibility Bitmask of the results, bit (i % 32) of
+            visibility[i / 32] is set if box i is visible. (numBoxes + 31) / 32
+            words are written, the bits after the last box are cleared.
+        @param numBoxes Number of boxes to test.
+        */
+        virtual void calculateBoxVisibility(
+            const float* planes,
+            size_t numPlanes,
+            const float* bounds,
+            uint32* visibility,
+            size_t numBoxes) = 0;
+
+        /** Interpolate and weight the transform keyframes of several node tracks.
+        @remarks
+            This is the batched form of NodeAnimationTrack::applyToNode for linear
+            interpolation with linear rotation interpolation. For each transform
+            the rotation is nlerp(weight, IDENTITY, nlerp(t, rotation1, rotation2)),
+            the translation lerp(t, translate1, translate2) * weight * scale and the
+            scale 1 + (lerp(t, scale1, scale2) - 1) * f, where f is the given scale
+            if it isn't 1 and the weight otherwise.
+        @par
+            Keyframes and results are packed in 12 floats: rotation w, x, y, z,
+            translation x, y, z and an unused float, then scale x, y, z and an
+            unused float.
+        @param keyFrames1 Pointers to the first keyframe of each transform. No
+            alignment requirement.
+        @param keyFrames2 Pointers to the second keyframe of each transform. No
+            alignment requirement.
+        @param interpolations Parametric time between both keyframes, per transform.
+        @param weights Weight of each transform.
+        @param scale The scale to apply to translations and scalings.
+        @param shortestPath Whether rotations are interpolated along the shortest path.
+        @param transforms Pointer to the resulting transforms, 12 floats each.
+            No alignment requirement.
+        @param numTransforms Number of transforms to compute.
+        */
+        virtual void blendTransformKeyFrames(
+            const float* const* keyFrames1,
+            const float* const* keyFrames2,
+            const float* interpolations,
+            const float* weights,
+            Real scale,
+            bool shortestPath,
+            float* transforms,
+            size_t numTransforms) = 0;
+
+        /** Add weighted offsets to some of the vertices of a buffer.
+        @remarks
+            This is the inner loop of Mesh::softwareVertexPoseBlend, which only
+            touches the vertices a pose moves. For each offset, the three floats at
+            dest + indexes[i] * destStride are incremented by the offset times weight.
+        @param weight The weight of the offsets.
+        @param offsets Pointer to the offsets, 3 floats each, packed. No alignment
+            requirement.
+        @param indexes The vertex each offset applies to, no index may appear twice.
+        @param dest Pointer to the first vertex element to increment. No alignment
+            requirement.
+        @param destStride The distance in bytes between the elements of two vertices.
+        @param numOffsets Number of offsets to add.
+        */
+        virtual void accumulateVertexOffsets(
+            Real weight,
+            const float* offsets,
+            const uint32* indexes,
+            float* dest,
+            size_t destStride,
+            size_t numOffsets) = 0;
     };
 
     /** Returns raw offseted of the given pointer.
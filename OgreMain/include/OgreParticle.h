@@ -48,7 +48,7 @@ namespace Ogre {
         class. If that's the case, then you should define a subclass of this class, 
         and construct it when asked in your custom ParticleSystemRenderer class.
     */
-    class _OgreExport ParticleVisualData : public FXAlloc
+    class _OgreExport ParticleVisualData : public ParticleAlloc
     {
     public:
         ParticleVisualData() {}
@@ -57,7 +57,7 @@ namespace Ogre {
     };
 
     /** Class representing a single particle instance. */
-    class _OgreExport Particle : public FXAlloc
+    class _OgreExport Particle : public ParticleAlloc
     {
     protected:
         /// Parent ParticleSystem
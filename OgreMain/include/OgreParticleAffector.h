@@ -107,8 +107,32 @@ namespace Ogre {
             pSystem Pointer to a ParticleSystem to affect.
         @param
             timeElapsed The number of seconds which have elapsed since the last call.
+        @note
+            The default implementation hands all the active particles to 
+            _affectParticleSpan at once; affectors should override one or the other.
         */
-        virtual void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) = 0;
+        virtual void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
+
+        /** Method called to apply the affector's effect to a contiguous span of particles.
+        @remarks
+            Working on an array rather than through a ParticleIterator lets the 
+            affector use a plain indexed loop over the particles, and allows the 
+            particles to be processed in several spans.
+        @param
+            pSystem Pointer to the ParticleSystem the particles belong to.
+        @param
+            timeElapsed The number of seconds which have elapsed since the last call.
+        @param
+            particles The particles to affect.
+        @param
+            count The number of particles in the span.
+        */
+        virtual void _affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, 
+            Particle** particles, size_t count)
+        {
+            /* by default do nothing */
+            (void)pSystem; (void)timeElapsed; (void)particles; (void)count;
+        }
 
         /** Returns the name of the type of affector. 
         @remarks
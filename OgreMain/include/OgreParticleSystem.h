@@ -347,6 +347,47 @@ namespace Ogre {
         */
         void _update(Real timeElapsed);
 
+        /** First part of _update, which must run on the updating thread (internal use).
+        @remarks
+            Checks whether the system is to be updated at all, configures the renderer
+            and brings the transform of the parent node up to date.
+        @param timeElapsed The time since the last frame, scaled by the speed factor
+            on return.
+        @return Whether _simulate and _updateBounds are to be called.
+        */
+        bool _prepareUpdate(Real& timeElapsed);
+
+        /** Second part of _update, which expires, affects, moves and emits particles (internal use).
+        @remarks
+            Only modifies this system, so separate systems may be simulated on
+            separate threads once they have been prepared.
+        */
+        void _simulate(Real timeElapsed);
+
+        /** Sets the seed of the random numbers used by the emitters and affectors of this system.
+        @remarks
+            Each system draws from its own sequence, so its particles only depend on
+            the seed and the elapsed times it has been updated with. The seed defaults
+            to a hash of the name and is not copied from templates.
+        */
+        void setRandomSeed(uint32 seed);
+        /// Gets the seed set with setRandomSeed
+        uint32 getRandomSeed(void) const { return mRandomSeed; }
+
+        /// Random number in [0, 1] from the sequence of this system, for emitters and affectors
+        Real _unitRandom(void)
+        {
+            // xorshift32
+            mRandomState ^= mRandomState << 13;
+            mRandomState ^= mRandomState >> 17;
+            mRandomState ^= mRandomState << 5;
+            return (mRandomState >> 8) * (Real(1) / 0xFFFFFF);
+        }
+        /// Random number in [low, high] from the sequence of this system
+        Real _rangeRandom(Real low, Real high) { return (high - low) * _unitRandom() + low; }
+        /// Random number in [-1, 1] from the sequence of this system
+        Real _symmetricRandom(void) { return 2 * _unitRandom() - 1; }
+
         /** Returns an iterator for stepping through all particles in this system.
         @remarks
             This method is designed to be used by people providing new ParticleAffector subclasses,
@@ -355,6 +396,13 @@ namespace Ogre {
         */
         ParticleIterator _getIterator(void);
 
+        /** Returns the active particles as one contiguous array of getNumParticles() entries.
+        @remarks
+            The array is only valid until particles are emitted or expire. Used by 
+            ParticleAffector::_affectParticleSpan.
+        */
+        Particle** _getActiveParticles(void) { return mActiveParticles.empty() ? 0 : &mActiveParticles[0]; }
+
         /** Sets the name of the material to be used for this billboard set.
             @param
                 name The new name of the material to use for this set.
@@ -595,6 +643,8 @@ namespace Ogre {
             number of seconds after which the automatic update will cease.
         */
         void setBoundsAutoUpdated(bool autoUpdate, Real stopIn = 0.0f);
+        /// Gets whether the bounds are automatically updated for the life of the system
+        bool getBoundsAutoUpdated(void) const { return mBoundsAutoUpdate; }
 
         /** Sets whether particles (and any affector effects) remain relative 
             to the node the particle system is attached to.
@@ -697,16 +747,20 @@ namespace Ogre {
         Real mTimeSinceLastVisible;
         /// Last frame in which known to be visible
         unsigned long mLastVisibleFrame;
-        /// Controller for time update
-        Controller<Real>* mTimeController;
+        /// Registered with ParticleSystemManager for updates?
+        bool mUpdateRegistered;
+        /// Seed and current state of the random sequence
+        uint32 mRandomSeed;
+        uint32 mRandomState;
         /// Indication whether the emitted emitter pool (= pool with particle emitters that are emitted) is initialised
         bool mEmittedEmitterPoolInitialised;
         /// Used to control if the particle system should emit particles or not.
         bool mIsEmitting;
 
-        typedef list<Particle*>::type ActiveParticleList;
-        typedef list<Particle*>::type FreeParticleList;
+        typedef vector<Particle*>::type ActiveParticleList;
+        typedef vector<Particle*>::type FreeParticleList;
         typedef vector<Particle*>::type ParticlePool;
+        typedef vector<Particle*>::type ParticleBlockList;
 
         /** Sort by direction functor */
         struct SortByDirectionFunctor
@@ -732,23 +786,21 @@ namespace Ogre {
 
         /** Active particle list.
             @remarks
-                This is a linked list of pointers to particles in the particle pool.
-            @par
-                This allows very fast insertions and deletions from anywhere in 
-                the list to activate / deactivate particles as well as reuse of 
-                Particle instances in the pool without construction & destruction 
-                which avoids memory thrashing.
+                This is a dense array of pointers to particles in the particle pool,
+                so that updating the particles is a linear walk. Expired particles
+                are removed by moving the last entry into their slot, hence the
+                order of the particles changes as they expire.
         */
         ActiveParticleList mActiveParticles;
 
-        /** Free particle queue.
+        /** Free particle stack.
             @remarks
-                This contains a list of the particles free for use as new instances
+                This contains the particles free for use as new instances
                 as required by the set. Particle instances are preconstructed up 
                 to the estimated size in the mParticlePool vector and are 
-                referenced on this deque at startup. As they get used this list
+                referenced here at startup. As they get used this list
                 reduces, as they get released back to to the set they get added
-                back to the list.
+                back to the end, so the most recently used ones are reused first.
         */
         FreeParticleList mFreeParticles;
 
@@ -758,6 +810,9 @@ namespace Ogre {
         */
         ParticlePool mParticlePool;
 
+        /// Arrays the particles of the pool are constructed in, one per increasePool call
+        ParticleBlockList mParticleBlocks;
+
         typedef list<ParticleEmitter*>::type FreeEmittedEmitterList;
         typedef list<ParticleEmitter*>::type ActiveEmittedEmitterList;
         typedef vector<ParticleEmitter*>::type EmittedEmitterList;
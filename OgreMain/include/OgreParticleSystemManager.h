@@ -99,6 +99,17 @@ namespace Ogre {
         // Factory instance
         ParticleSystemFactory* mFactory;
 
+        typedef vector<ParticleSystem*>::type ParticleSystemList;
+        /// Systems attached to a node, updated every frame
+        ParticleSystemList mUpdatedSystems;
+        /// Frame time controller calling _updateSystems, created with the first system
+        Controller<Real>* mUpdateController;
+        /// Update the systems on several threads?
+        bool mParallelUpdate;
+        /// Systems to simulate in the current parallel update, and their elapsed time
+        ParticleSystemList mSimulatedSystems;
+        vector<Real>::type mSimulatedTimes;
+
         /** Internal script parsing method. */
         void parseNewEmitter(const String& type, DataStreamPtr& chunk, ParticleSystem* sys);
         /** Internal script parsing method. */
@@ -341,6 +352,31 @@ namespace Ogre {
                 mSystemTemplates.begin(), mSystemTemplates.end());
         } 
 
+        /** Sets whether particle systems are updated in parallel.
+        @remarks
+            When enabled, the particles of all systems attached to a node are
+            simulated on the worker threads of the Root WorkQueue (see parallelFor),
+            which pays off with many small systems. Renderer setup, node transforms
+            and bounds are still handled on the updating thread. Emitters and
+            affectors must then only modify their own system, and take random
+            numbers from ParticleSystem::_unitRandom rather than Math::UnitRandom;
+            all the built in ones do. As every system has its own random sequence,
+            the results do not depend on the number of threads. Disabled by default.
+        */
+        void setParallelUpdateEnabled(bool enabled) { mParallelUpdate = enabled; }
+        /// Gets whether particle systems are updated in parallel
+        bool isParallelUpdateEnabled(void) const { return mParallelUpdate; }
+
+        /** Update all particle systems attached to a node (internal use).
+        @remarks
+            Called every frame by a frame time controller.
+        */
+        void _updateSystems(Real timeElapsed);
+        /// Start updating a system every frame, called when it is attached (internal use)
+        void _addUpdatedSystem(ParticleSystem* sys);
+        /// Stop updating a system, called when it is detached (internal use)
+        void _removeUpdatedSystem(ParticleSystem* sys);
+
         /** Get an instance of ParticleSystemFactory (internal use). */
         ParticleSystemFactory* _getFactory(void) { return mFactory; }
         
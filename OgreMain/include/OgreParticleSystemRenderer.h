@@ -63,7 +63,7 @@ namespace Ogre {
             instance(s) it wishes.
         */
         virtual void _updateRenderQueue(RenderQueue* queue, 
-            list<Particle*>::type& currentParticles, bool cullIndividually) = 0;
+            vector<Particle*>::type& currentParticles, bool cullIndividually) = 0;
 
         /** Sets the material this renderer must use; called by ParticleSystem. */
         virtual void _setMaterial(MaterialPtr& mat) = 0;
@@ -84,9 +84,9 @@ namespace Ogre {
         /** Optional callback notified when particle expired */
         virtual void _notifyParticleExpired(Particle* particle) {}
         /** Optional callback notified when particles moved */
-        virtual void _notifyParticleMoved(list<Particle*>::type& currentParticles) {}
+        virtual void _notifyParticleMoved(vector<Particle*>::type& currentParticles) {}
         /** Optional callback notified when particles cleared */
-        virtual void _notifyParticleCleared(list<Particle*>::type& currentParticles) {}
+        virtual void _notifyParticleCleared(vector<Particle*>::type& currentParticles) {}
         /** Create a new ParticleVisualData instance for attachment to a particle.
         @remarks
             If this renderer needs additional data in each particle, then this should
@@ -120,6 +120,18 @@ namespace Ogre {
         /** Gets the desired particles sort mode of this renderer */
         virtual SortMode _getSortMode(void) const = 0;
 
+        /** Lets the renderer simulate the particles instead of the system.
+        @remarks
+            Called on every update, before the system expires, affects, moves and
+            emits its own particles. Renderers which keep their particles on the GPU
+            take the emitters and affectors of the system into account themselves
+            and return true; the system then holds no particles of its own. This
+            may be called from a worker thread, see
+            ParticleSystemManager::setParallelUpdateEnabled. The default does
+            nothing and returns false.
+        */
+        virtual bool _simulateParticles(ParticleSystem* sys, Real timeElapsed) { return false; }
+
         /** Required method to allow the renderer to communicate the Renderables
             it will be using to render the system to a visitor.
         @see MovableObject::visitRenderables
@@ -246,6 +246,10 @@ namespace Ogre {
         bool mLightScissoring;
         /// User clip planes for light?
         bool mLightClipPlanes;
+        /// Gather renderables into RenderSystem draw batches?
+        bool mDrawBatching;
+        /// May small renderables be merged into SceneManager dynamic batches?
+        bool mDynamicBatching;
         /// Illumination stage?
         IlluminationStage mIlluminationStage;
         /// User objects binding.
@@ -262,6 +266,8 @@ namespace Ogre {
         static PassSet msDirtyHashList;
         /// The place where passes go to die
         static PassSet msPassGraveyard;
+        /// Counter bumped whenever a pass is created, destroyed or has its hash dirtied
+        static uint32 msPassSetGeneration;
         /// The Pass hash functor
         static HashFunc* msHashFunc;
     public:
@@ -1544,6 +1550,14 @@ namespace Ogre {
          */
         static const PassSet& getPassGraveyard(void)
         { return msPassGraveyard; }
+        /** Static method to retrieve a counter which changes whenever any Pass
+            is created, queued for deletion or has its hash dirtied.
+        @remarks
+            Anything which caches Pass pointers across frames (such as a
+            RenderCommandList) can compare this against the value it saw when
+            it was built to find out whether the cache may be stale.
+        */
+        static uint32 getPassSetGeneration(void);
         /** Static method to reset the list of passes which need their hash
             values recalculated.
             @remarks
@@ -1650,6 +1664,45 @@ namespace Ogre {
         */
         bool getLightClipPlanesEnabled() const { return mLightClipPlanes; }
 
+        /** Sets whether consecutive renderables using this pass may be gathered
+            into a single draw batch by the RenderSystem.
+            @remarks
+            When enabled, the SceneManager asks the RenderSystem to collect the
+            renderables drawn with this pass and submit them with as few draw
+            calls as it can (see RenderSystem::_beginDrawBatch). Per-object
+            GPU program parameters are then no longer valid per draw, since
+            only the last values set are seen by the whole batch; the programs
+            of the pass must instead read the per-draw data (such as the world
+            matrix) which the RenderSystem provides for batched draws.
+            @par
+            Passes iterated per light or more than once, and passes rendered
+            during texture shadow or stencil illumination stages, are never
+            batched. RenderSystems which do not support batching draw as usual.
+            Disabled by default.
+        */
+        void setDrawBatchingEnabled(bool enabled) { mDrawBatching = enabled; }
+        /** Gets whether consecutive renderables using this pass may be gathered
+            into a single draw batch by the RenderSystem.
+        */
+        bool getDrawBatchingEnabled() const { return mDrawBatching; }
+
+        /** Sets whether small renderables drawn with this pass may be merged
+            into one draw when the SceneManager does dynamic batching.
+            @remarks
+            Merged renderables are transformed to world space on the CPU and
+            drawn with the translation of the batch as their world matrix, with
+            the lights of the first of them (see
+            SceneManager::setDynamicBatchingEnabled). Passes whose programs
+            depend on the object space or on other per-object parameters must
+            opt out. Enabled by default, but only used when the SceneManager
+            has dynamic batching enabled.
+        */
+        void setDynamicBatchingEnabled(bool enabled) { mDynamicBatching = enabled; }
+        /** Gets whether small renderables drawn with this pass may be merged
+            into one draw when the SceneManager does dynamic batching.
+        */
+        bool getDynamicBatchingEnabled() const { return mDynamicBatching; }
+
         /** Manually set which illumination stage this pass is a member of.
             @remarks
             When using an additive lighting mode (SHADOWTYPE_STENCIL_ADDITIVE or
@@ -43,6 +43,12 @@ namespace Ogre {
     /** Patch specialisation of Mesh. 
     @remarks
         Instances of this class should be created by calling MeshManager::createBezierPatch.
+    @par
+        With hardware tessellation, the mesh holds the control points, drawn as 9 control
+        point patches (see PatchSurface::buildPatchIndexes), and the material must use
+        tessellation hull and domain programs which evaluate the biquadratic Bezier patches.
+        The control points are then uploaded once and the hull program chooses the subdivision
+        each frame, e.g. by distance, so setSubdivision has no effect.
     */
     class _OgreExport PatchMesh : public Mesh
     {
@@ -51,6 +57,11 @@ namespace Ogre {
         PatchSurface mSurface;
         /// Vertex declaration, cloned from the input
         VertexDeclaration* mDeclaration;
+        /// Whether the surface is subdivided by tessellation programs rather than on the CPU
+        bool mHardwareTessellation;
+
+        /// Copy the control points into the vertex buffer for hardware tessellation
+        void writeControlPoints(void);
     public:
         /// Constructor
         PatchMesh(ResourceManager* creator, const String& name, ResourceHandle handle,
@@ -67,12 +78,16 @@ namespace Ogre {
             PatchSurface::VisibleSide visibleSide = PatchSurface::VS_FRONT,
             HardwareBuffer::Usage vbUsage = HardwareBuffer::HBU_STATIC_WRITE_ONLY, 
             HardwareBuffer::Usage ibUsage = HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY,
-            bool vbUseShadow = false, bool ibUseShadow = false);
+            bool vbUseShadow = false, bool ibUseShadow = false,
+            bool hardwareTessellation = false);
 
         /* Sets the current subdivision level as a proportion of full detail.
         @param factor Subdivision factor as a value from 0 (control points only) to 1 (maximum
-            subdivision). */
+            subdivision). Ignored with hardware tessellation. */
         void setSubdivision(Real factor);
+
+        /// Returns whether the patch is subdivided by tessellation programs
+        bool isHardwareTessellated(void) const { return mHardwareTessellation; }
     protected:
         /// Overridden from Resource
         void loadImpl(void);
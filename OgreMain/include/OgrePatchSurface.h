@@ -152,6 +152,38 @@ namespace Ogre {
         void build(HardwareVertexBufferSharedPtr destVertexBuffer, size_t vertexStart,
             HardwareIndexBufferSharedPtr destIndexBuffer, size_t indexStart);
 
+        /** Builds several surfaces into consecutive regions of the same buffers.
+            @remarks
+                Each surface is built as by build, starting where the previous one ended, so
+                the buffers must have room for the sum of getRequiredVertexCount and
+                getRequiredIndexCount of the surfaces. The surfaces must have been defined with
+                vertex declarations of the same size. The vertex region of all surfaces is
+                locked at once and the surfaces are subdivided on the worker threads, see
+                parallelFor. Surfaces which are not defined are skipped.
+        */
+        static void buildSurfaces(const vector<PatchSurface*>::type& surfaces,
+            HardwareVertexBufferSharedPtr destVertexBuffer, size_t vertexStart,
+            HardwareIndexBufferSharedPtr destIndexBuffer, size_t indexStart);
+
+        /** Based on a previous call to defineSurface, establishes the number of indexes required
+            to draw this patch as control point patches for hardware tessellation.
+            @see buildPatchIndexes
+        */
+        size_t getRequiredPatchIndexCount(void) const;
+        /** Writes the indexes for drawing the control points of this surface as patches,
+            to have the surface subdivided on the GPU by tessellation programs.
+            @remarks
+                Every 3x3 block of control points is listed as one biquadratic patch of 9
+                control points, row by row, to be drawn with OT_PATCH_9_CONTROL_POINT. The
+                indexes refer to the control points in the order passed to defineSurface, and
+                the rows of the patches are flipped for the back side, which flips the winding
+                of the triangles the tessellator outputs. There must be room for
+                getRequiredPatchIndexCount indexes.
+            @param destIndexBuffer The destination index buffer
+            @param indexStart The offset at which to start writing indexes
+        */
+        void buildPatchIndexes(HardwareIndexBufferSharedPtr destIndexBuffer, size_t indexStart);
+
         /** Alters the level of subdivision for this surface.
             @remarks
                 This method changes the proportionate detail level of the patch; since
@@ -169,14 +201,31 @@ namespace Ogre {
         {
             return mControlPointBuffer;
         }
+        /// Returns the number of control points, only valid after calling defineSurface
+        size_t getControlPointCount(void) const { return mCtlCount; }
         /** Convenience method for telling the patch that the control points have been 
             deleted, since once the patch has been built they are not required. */
         void notifyControlPointBufferDeallocated(void) { 
             mControlPointBuffer = 0;
         }
     protected:
+        /// Subdivides the curves of a surface, see parallelFor
+        class CurveSubdivider;
+        /// Subdivides whole surfaces, see parallelFor
+        class SurfaceSubdivider;
+
+        /// Vertex count from which build subdivides the curves of a surface in parallel
+        static const size_t PARALLEL_VERTEX_COUNT = 4096;
+
         /// Vertex declaration describing the control point buffer
         VertexDeclaration* mDeclaration;
+        /// Vertex size and elements of the declaration, looked up once
+        size_t mVertexSize;
+        const VertexElement* mElemPos;
+        const VertexElement* mElemNorm;
+        const VertexElement* mElemDiffuse;
+        const VertexElement* mElemTex0;
+        const VertexElement* mElemTex1;
         /// Buffer containing the system-memory control points
         void* mControlPointBuffer;
         /// Type of surface
@@ -209,6 +258,8 @@ namespace Ogre {
         */
         size_t findLevel( Vector3& a, Vector3& b, Vector3& c);
 
+        /// Subdivides the surface to the max level into the locked vertex region of the surface
+        void tessellate(void* lockedBuffer, bool parallel);
         void distributeControlPoints(void* lockedBuffer);
         void subdivideCurve(void* lockedBuffer, size_t startIdx, size_t stepSize, size_t numSteps, size_t iterations);
         void interpolateVertexData(void* lockedBuffer, size_t leftIndex, size_t rightIndex, size_t destIndex);
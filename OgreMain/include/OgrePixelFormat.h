@@ -633,6 +633,13 @@ namespace Ogre {
         */
         static void bulkPixelConversion(const PixelBox &src, const PixelBox &dst);
 
+        /** Convert pixels between native endian formats by moving their bits.
+            @remarks Used by bulkPixelConversion for the pairs without an optimised
+            conversion. Returns false, converting nothing, if a channel would have
+            to be rescaled and the pixels have to go through floats.
+        */
+        static bool _shuffleConversion(const PixelBox &src, const PixelBox &dst);
+
         /** Flips pixels inplace in vertical direction.
             @param  box         PixelBox containing pixels, pitches and format
             @remarks Non consecutive pixel boxes are supported.
@@ -104,9 +104,19 @@ namespace Ogre {
 #   define __OGRE_HAVE_VFP  1
 #endif
 
+/* Define whether or not Ogre compiled with AVX2 support. Unlike SSE this is
+   never assumed, the AVX2 code paths are compiled alongside the SSE ones and
+   only selected when the CPU reports AVX2 and FMA at runtime.
+ */
+#if __OGRE_HAVE_SSE && ((OGRE_COMPILER == OGRE_COMPILER_MSVC && OGRE_COMP_VER >= 1700) || \
+    (OGRE_COMPILER == OGRE_COMPILER_GNUC && OGRE_COMP_VER >= 490) || OGRE_COMPILER == OGRE_COMPILER_CLANG)
+#   define __OGRE_HAVE_AVX2  1
+#endif
+
 /* Define whether or not Ogre compiled with NEON support.
  */
-#if OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_ARM && (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && defined(__ARM_ARCH_7A__) && defined(__ARM_NEON__)
+#if OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_ARM && (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && \
+    ((defined(__ARM_ARCH_7A__) && defined(__ARM_NEON__)) || (defined(__aarch64__) && defined(__ARM_NEON)))
 #   define __OGRE_HAVE_NEON  1
 #endif
 
@@ -120,6 +130,10 @@ namespace Ogre {
 #   define __OGRE_HAVE_SSE  0
 #endif
 
+#ifndef __OGRE_HAVE_AVX2
+#   define __OGRE_HAVE_AVX2  0
+#endif
+
 #ifndef __OGRE_HAVE_VFP
 #   define __OGRE_HAVE_VFP  0
 #endif
@@ -176,6 +190,9 @@ namespace Ogre {
             CPU_FEATURE_FPU             = 1 << 12,
             CPU_FEATURE_PRO             = 1 << 13,
             CPU_FEATURE_HTT             = 1 << 14,
+            CPU_FEATURE_AVX             = 1 << 18,
+            CPU_FEATURE_AVX2            = 1 << 19,
+            CPU_FEATURE_FMA             = 1 << 20,
 #elif OGRE_CPU == OGRE_CPU_ARM          
             CPU_FEATURE_VFP             = 1 << 15,
             CPU_FEATURE_NEON            = 1 << 16,
@@ -57,6 +57,7 @@ namespace Ogre
 
         typedef multimap<Vector3, Vector3>::type        EdgeMap;
         typedef std::pair< Vector3, Vector3>        Edge;
+        typedef vector<Edge>::type                  EdgeList;
 
     protected:
         VertexList      mVertexList;
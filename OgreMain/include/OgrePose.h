@@ -114,6 +114,19 @@ namespace Ogre {
         /** Get a hardware vertex buffer version of the vertex offsets. */
         const HardwareVertexBufferSharedPtr& _getHardwareVertexBuffer(const VertexData* origData) const;
 
+        /** Internal method, gets the indexes of the vertices the pose moves, ascending.
+        @remarks
+            Together with _getPackedOffsets and _getPackedNormals this is the pose in
+            the form Mesh::softwareVertexPoseBlend works on, built when first asked
+            for after the vertices changed.
+        */
+        const vector<uint32>::type& _getPackedIndexes(void) const;
+        /** Internal method, gets the offsets of the vertices of _getPackedIndexes, 3 floats each. */
+        const vector<float>::type& _getPackedOffsets(void) const;
+        /** Internal method, gets the normals of the vertices of _getPackedIndexes, 3 floats
+            each, or nothing if the pose has no normals. */
+        const vector<float>::type& _getPackedNormals(void) const;
+
         /** Clone this pose and create another one configured exactly the same
             way (only really useful for cloning holders of this class).
         */
@@ -129,6 +142,14 @@ namespace Ogre {
         NormalsMap mNormalsMap;
         /// Derived hardware buffer, covers all vertices
         mutable HardwareVertexBufferSharedPtr mBuffer;
+        /// Derived packed vertices, see _getPackedIndexes
+        mutable vector<uint32>::type mPackedIndexes;
+        mutable vector<float>::type mPackedOffsets;
+        mutable vector<float>::type mPackedNormals;
+        mutable bool mPackedDirty;
+
+        /// Fill the packed vertices from the maps
+        void packVertices(void) const;
     };
     typedef vector<Pose*>::type PoseList;
 
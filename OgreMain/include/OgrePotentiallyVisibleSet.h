@@ -0,0 +1,159 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __PotentiallyVisibleSet_H__
+#define __PotentiallyVisibleSet_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreDataStream.h"
+#include "OgreSerializer.h"
+#include "OgreStringVector.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Precomputed visibility between the cells of a scene.
+    @remarks
+        For each cell, records which other cells may be seen from anywhere
+        inside it, so at runtime the scene manager can look up the cell of
+        the camera and skip everything in cells which can't be seen, without
+        doing any occlusion work. Since the visibility is computed for the
+        static geometry, it remains correct for moving objects, which are
+        hidden by the same walls.
+    @par
+        The cells are either a regular grid dividing a box, as used by the
+        OctreeSceneManager, or a list of named cells, as used by the
+        PCZSceneManager for its zones. The data is computed offline by the
+        scene manager, saved with PotentiallyVisibleSetSerializer and loaded
+        again when the scene is.
+    */
+    class _OgreExport PotentiallyVisibleSet : public SceneCtlAllocatedObject
+    {
+    public:
+        /// Cell returned for points outside of the grid, or unknown names
+        static const size_t NO_CELL = ~static_cast<size_t>(0);
+
+        PotentiallyVisibleSet();
+
+        /** Make the cells a grid dividing the box.
+        @remarks
+            Cell (x, y, z) has index x + (y + z * divisionsY) * divisionsX.
+            All cells start out seeing only themselves.
+        */
+        void setGrid(const AxisAlignedBox& bounds, uint32 divisionsX, uint32 divisionsY,
+            uint32 divisionsZ);
+        /** Make the cells a list of named cells.
+        @remarks
+            All cells start out seeing only themselves.
+        */
+        void setCellNames(const StringVector& names);
+        /// Remove all cells
+        void clear(void);
+
+        /// Returns whether the cells are a grid rather than named
+        bool isGrid(void) const { return mGrid; }
+        /// Get the number of cells
+        size_t getCellCount(void) const { return mCellCount; }
+        /// Get the box divided by the grid
+        const AxisAlignedBox& getGridBounds(void) const { return mBounds; }
+        /// Get the number of grid cells along an axis, 0 for x, 1 for y and 2 for z
+        uint32 getGridDivisions(int axis) const { return mDivisions[axis]; }
+        /// Get the world bounds of a grid cell
+        AxisAlignedBox getCellBounds(size_t cell) const;
+        /// Get the name of a named cell
+        const String& getCellName(size_t cell) const;
+
+        /// Get the grid cell holding a position, or NO_CELL if it is outside of the grid
+        size_t getCell(const Vector3& position) const;
+        /// Get the cell with the name, or NO_CELL if there is none
+        size_t getCell(const String& name) const;
+
+        /// Set whether a cell may be seen from another one
+        void setVisible(size_t from, size_t to, bool visible = true);
+        /// Returns whether a cell may be seen from another one
+        bool isVisible(size_t from, size_t to) const
+        {
+            return (mBits[from * mRowWords + (to >> 5)] & (1u << (to & 31))) != 0;
+        }
+        /** Returns whether any grid cell the box overlaps may be seen from a cell.
+        @remarks
+            Boxes reaching outside of the grid are always visible, null ones never.
+        */
+        bool isVisible(size_t from, const AxisAlignedBox& box) const;
+        /// Get the number of cells which may be seen from a cell, itself included
+        size_t getVisibleCount(size_t from) const;
+
+    protected:
+        /// Size the visibility bits, leaving each cell seeing only itself
+        void resetVisibility(void);
+
+        bool mGrid;
+        size_t mCellCount;
+        AxisAlignedBox mBounds;
+        uint32 mDivisions[3];
+        Vector3 mCellSize;
+        StringVector mNames;
+        /// Words in the bit row of each cell
+        size_t mRowWords;
+        /// Bit to of row from is set when cell to may be seen from cell from
+        vector<uint32>::type mBits;
+    };
+
+    /** Class for serialising a PotentiallyVisibleSet to and from a binary .pvs file.
+    */
+    class _OgreExport PotentiallyVisibleSetSerializer : public Serializer
+    {
+    public:
+        PotentiallyVisibleSetSerializer();
+
+        /// Export the set to a file
+        void exportPVS(const PotentiallyVisibleSet* pvs, const String& filename,
+            Endian endianMode = ENDIAN_NATIVE);
+        /// Export the set to a stream
+        void exportPVS(const PotentiallyVisibleSet* pvs, DataStreamPtr stream,
+            Endian endianMode = ENDIAN_NATIVE);
+        /** Import a set from a stream.
+        @param stream The stream holding the .pvs data, at the start of the data
+        @param pDest The set to replace the contents of
+        */
+        void importPVS(DataStreamPtr& stream, PotentiallyVisibleSet* pDest);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
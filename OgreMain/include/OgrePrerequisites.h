@@ -146,11 +146,13 @@ namespace Ogre {
     class Archive;
     class ArchiveFactory;
     class ArchiveManager;
+    class AsyncReadback;
     class AutoParamDataSource;
     class AxisAlignedBox;
     class AxisAlignedBoxSceneQuery;
     class Billboard;
     class BillboardChain;
+    class BillboardChainBatcher;
     class BillboardSet;
     class Bone;
     class Camera;
@@ -162,9 +164,11 @@ namespace Ogre {
     class ControllerManager;
     template <typename T> class ControllerValue;
     class DataStream;
+    class DebugDrawer;
     class DefaultWorkQueue;
     class Degree;
     class DepthBuffer;
+    class DynamicRenderBatch;
     class DynLib;
     class DynLibManager;
     class EdgeData;
@@ -175,6 +179,8 @@ namespace Ogre {
     class Factory;
     struct FrameEvent;
     class FrameListener;
+    class FrameSimulation;
+    class FrameSnapshot;
     class Frustum;
     struct GpuLogicalBufferStruct;
     struct GpuNamedConstants;
@@ -183,15 +189,22 @@ namespace Ogre {
     class GpuProgram;
     class GpuProgramManager;
     class GpuProgramUsage;
+    class GpuSkinnedVertexData;
+    class GpuSkinningBatch;
     class HardwareCounterBuffer;
     class HardwareIndexBuffer;
     class HardwareOcclusionQuery;
+    class HardwareTimerQuery;
     class HardwareUniformBuffer;
     class HardwareVertexBuffer;
     class HardwarePixelBuffer;
     class HighLevelGpuProgram;
     class HighLevelGpuProgramManager;
     class HighLevelGpuProgramFactory;
+    class HiZCompositionPass;
+    class HiZPyramid;
+    class Impostor;
+    class ImpostorBatcher;
     class IndexData;
     class InstanceBatch;
     class InstanceBatchHW;
@@ -205,6 +218,7 @@ namespace Ogre {
     class Image;
     class KeyFrame;
     class Light;
+    class LightClusters;
     class Log;
     class LogManager;
     class LodStrategy;
@@ -226,6 +240,7 @@ namespace Ogre {
     class MovablePlane;
     class Node;
     class NodeAnimationTrack;
+    class NodeTransformPool;
     class NodeKeyFrame;
     class NumericAnimationTrack;
     class NumericKeyFrame;
@@ -245,6 +260,7 @@ namespace Ogre {
     class Plane;
     class PlaneBoundedVolume;
     class Plugin;
+    class PotentiallyVisibleSet;
     class Pose;
     class Profile;
     class Profiler;
@@ -253,6 +269,7 @@ namespace Ogre {
     class Ray;
     class RaySceneQuery;
     class RaySceneQueryListener;
+    class RenderCommandList;
     class Renderable;
     class RenderPriorityGroup;
     class RenderQueue;
@@ -274,6 +291,7 @@ namespace Ogre {
     class RenderOperation;
     class Resource;
     class ResourceBackgroundQueue;
+    class ResourceStreamingQueue;
     class ResourceGroupManager;
     class ResourceManager;
     class RibbonTrail;
@@ -294,8 +312,10 @@ namespace Ogre {
     class SimpleRenderable;
     class SimpleSpline;
     class Skeleton;
+    class SkeletonAnimationCache;
     class SkeletonInstance;
     class SkeletonManager;
+    class SoftwareSkinningBatch;
     class Sphere;
     class SphereSceneQuery;
     class StaticGeometry;
@@ -318,6 +338,7 @@ namespace Ogre {
     class Vector3;
     class Vector4;
     class Viewport;
+    class VirtualTexture;
     class VertexAnimationTrack;
     class VertexBufferBinding;
     class VertexData;
@@ -341,6 +362,7 @@ namespace Ogre {
     template<typename T> class SharedPtr;
 #endif
     typedef SharedPtr<AnimableValue> AnimableValuePtr;
+    typedef SharedPtr<AsyncReadback> AsyncReadbackPtr;
     typedef SharedPtr<Compositor> CompositorPtr;
     typedef SharedPtr<DataStream> DataStreamPtr;
     typedef SharedPtr<GpuProgram> GpuProgramPtr;
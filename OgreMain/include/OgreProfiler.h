@@ -43,9 +43,15 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 
 #include "OgrePrerequisites.h"
 #include "OgreSingleton.h"
+#include "OgreAtomicScalar.h"
 #include "OgreHeaderPrefix.h"
 
 #if OGRE_PROFILING == 1
+// the threading providers define these, except for the one without threads
+#   ifndef OGRE_TOKEN_PASTE_EXTRA
+#       define OGRE_TOKEN_PASTE(x, y) x ## y
+#       define OGRE_TOKEN_PASTE_EXTRA(x, y) OGRE_TOKEN_PASTE(x, y)
+#   endif
 #   define OgreProfile( a ) Ogre::Profile _OgreProfileInstance( (a) )
 #   define OgreProfileBegin( a ) Ogre::Profiler::getSingleton().beginProfile( (a) )
 #   define OgreProfileEnd( a ) Ogre::Profiler::getSingleton().endProfile( (a) )
@@ -55,6 +61,17 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #   define OgreProfileBeginGPUEvent( g ) Ogre::Profiler::getSingleton().beginGPUEvent(g)
 #   define OgreProfileEndGPUEvent( g ) Ogre::Profiler::getSingleton().endGPUEvent(g)
 #   define OgreProfileMarkGPUEvent( e ) Ogre::Profiler::getSingleton().markGPUEvent(e)
+#   define OgreProfileBeginGPUTimer( t ) do { if (Ogre::Profiler::_isRecording(Ogre::OGREPROF_RENDERING)) \
+        Ogre::Profiler::getSingleton().beginGPUTimer(t); } while (0)
+#   define OgreProfileEndGPUTimer() do { if (Ogre::Profiler::_isRecording(Ogre::OGREPROF_RENDERING)) \
+        Ogre::Profiler::getSingleton().endGPUTimer(); } while (0)
+// names carry the line so nested scopes don't shadow each other
+#   define OgreProfileScope( a ) \
+        static const Ogre::ProfileMarker OGRE_TOKEN_PASTE_EXTRA(_OgreProfileMarker, __LINE__)( (a) ); \
+        Ogre::ProfileScope OGRE_TOKEN_PASTE_EXTRA(_OgreProfileScope, __LINE__)( OGRE_TOKEN_PASTE_EXTRA(_OgreProfileMarker, __LINE__) )
+#   define OgreProfileScopeGroup( a, g ) \
+        static const Ogre::ProfileMarker OGRE_TOKEN_PASTE_EXTRA(_OgreProfileMarker, __LINE__)( (a), (g) ); \
+        Ogre::ProfileScope OGRE_TOKEN_PASTE_EXTRA(_OgreProfileScope, __LINE__)( OGRE_TOKEN_PASTE_EXTRA(_OgreProfileMarker, __LINE__) )
 #else
 #   define OgreProfile( a )
 #   define OgreProfileBegin( a )
@@ -65,6 +82,10 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #   define OgreProfileBeginGPUEvent( e )
 #   define OgreProfileEndGPUEvent( e )
 #   define OgreProfileMarkGPUEvent( e )
+#   define OgreProfileBeginGPUTimer( t )
+#   define OgreProfileEndGPUTimer()
+#   define OgreProfileScope( a )
+#   define OgreProfileScopeGroup( a, g )
 #endif
 
 namespace Ogre {
@@ -117,6 +138,31 @@ namespace Ogre {
             
     };
 
+    /** A static profiling marker for one call site
+        @remarks
+            Use the macro OgreProfileScope(name) instead of declaring markers directly.
+            It declares a function local static marker, so each call site registers its
+            name once and afterwards only passes its ID around. Unlike Profile, markers
+            may be used from any thread, each thread records into its own buffer which 
+            the Profiler collects when the frame ends.
+        @remarks
+            Markers of the same name share their ID, also with profiles started by name.
+    */
+    class _OgreExport ProfileMarker
+    {
+    public:
+        ProfileMarker(const char* name, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
+
+        /// The ID of this marker, unique for its name
+        uint32 getID() const { return mID; }
+        /// The group ID
+        uint32 getGroupID() const { return mGroupID; }
+
+    protected:
+        uint32 mID;
+        uint32 mGroupID;
+    };
+
     /** Represents the total timing information of a profile
         since profiles can be called more than once each frame
     */
@@ -254,6 +300,19 @@ namespace Ogre {
         /// Here we get the real profiling information which we can use 
         virtual void displayResults(const ProfileInstance& instance, ulong maxTotalFrameTime) {};
 
+        /** Called for each recorded profile, for listeners recording timelines
+        @remarks
+            Profiles are reported when the frame ends, before displayResults. GPU event 
+            regions are reported as they end, with the time their commands were issued
+            and the thread name "GPU events".
+        @param profileName The name of the profile
+        @param threadName "Main" for the main thread, the name of the thread profile otherwise
+        @param startTime, endTime The time the profile began and ended in microseconds,
+            measured by the timer of the Profiler
+        */
+        virtual void profileRecorded(const String& profileName, const String& threadName,
+                                     ulong startTime, ulong endTime) {}
+
         /// Set the display mode for the overlay. 
         void setDisplayMode(DisplayMode d) { mDisplayMode = d; }
     
@@ -272,6 +331,13 @@ namespace Ogre {
             OgreProfile(name) and braces to limit the scope. You must enable the Profile
             before you can used it with setEnabled(true). If you want to disable profiling
             in Ogre, simply set the macro OGRE_PROFILING to 0.
+        @par
+            Profiles are recorded as events into a lock free buffer per thread, which are
+            collected into the profile tree when the outermost profile of the main thread
+            (i.e. the frame) ends. Profiles of other threads show up under a "Thread N"
+            profile each. Profiles started by name can only be used from the main thread,
+            prefer OgreProfileScope(name) which can be used from any thread and skips the
+            name lookup.
         @author Amit Mathew (amitmathew (at) yahoo (dot) com)
         @todo resolve artificial cap on number of profiles displayed
         @todo fix display ordering of profiles not called every frame
@@ -299,7 +365,7 @@ namespace Ogre {
                 of its scope (i.e. the main game loop). If you use this function, make sure you 
                 use a corresponding OgreProfileEnd(name). Usually you would use the macro 
                 OgreProfile(name). This function will be ignored for a profile that has been 
-                disabled or if the profiler is disabled.
+                disabled or if the profiler is disabled. Must be called from the main thread.
             @param profileName Must be unique and must not be an empty string
             @param groupID A profile group identifier, which can allow you to mask profiles
             */
@@ -336,6 +402,27 @@ namespace Ogre {
              */
             void markGPUEvent(const String& event);
 
+            /** Begins measuring the GPU time of the commands issued until endGPUTimer
+             @remarks
+                Use the macro OgreProfileBeginGPUTimer(name) instead of calling this directly,
+                it only builds the name while rendering profiles are recorded. The timers are 
+                read back a few frames later, without waiting for the GPU, and show up under 
+                a "GPU" profile. Timers begun while another one is open are nested in it. 
+                Ignored if the render system has no timer queries. Must be called from the
+                rendering thread.
+             */
+            void beginGPUTimer(const String& timerName);
+
+            /** Ends the GPU timer begun last
+             @remarks Use the macro OgreProfileEndGPUTimer() instead of calling this directly.
+             */
+            void endGPUTimer(void);
+
+            /** Drops the timer queries of the render system
+             @remarks Called by the render system before it destroys them.
+             */
+            void _releaseGPUTimers(void);
+
             /** Sets whether this profiler is enabled. Only takes effect after the
                 the frame has ended.
                 @remarks When this is called the first time with the parameter true,
@@ -358,7 +445,7 @@ namespace Ogre {
 
             /** Set the mask which all profiles must pass to be enabled. 
             */
-            void setProfileGroupMask(uint32 mask) { mProfileMask = mask; }
+            void setProfileGroupMask(uint32 mask);
             /** Get the mask which all profiles must pass to be enabled. 
             */
             uint32 getProfileGroupMask() const { return mProfileMask; }
@@ -421,6 +508,17 @@ namespace Ogre {
             /// @copydoc Singleton::getSingleton()
             static Profiler* getSingletonPtr(void);
 
+            /** Returns whether profiles of the given group are recorded
+            @remarks Can be called from any thread.
+            */
+            static bool _isRecording(uint32 groupID) { return (msRecordMask.load() & groupID) != 0; }
+
+            /** Records the beginning or the end of a marker in the buffer of the calling thread
+            @remarks
+                Can be called from any thread, without locking. Used by ProfileScope.
+            */
+            static void _recordEvent(uint32 markerID, bool end);
+
         protected:
             friend class ProfileInstance;
 
@@ -432,6 +530,16 @@ namespace Ogre {
 
             void displayResults();
 
+            /** Collects the events recorded by all threads into the profile tree */
+            void processEvents(void);
+            /** Tells the listeners about a profile recorded this frame */
+            void notifyProfileRecorded(const String& profileName, const String& threadName,
+                                       ulong startTime, ulong endTime);
+            /** Gets the child profile of the given name, creating it if needed */
+            ProfileInstance* getChild(ProfileInstance* parent, const String& profileName);
+            /** Adds a call of the given time to the frame stats of a profile */
+            void addFrameTime(ProfileInstance* instance, ulong timeElapsed);
+
             /** Processes frame stats for all of the mRoot's children */
             void processFrameStats(void);
             /** Processes specific ProfileInstance and it's children recursively.*/
@@ -440,17 +548,56 @@ namespace Ogre {
             /** Handles a change of the profiler's enabled state*/
             void changeEnableState();
 
+            /** Gets the marker ID of a profile started by name */
+            uint32 getMarkerID(const String& profileName);
+
+            /** Gets a timer query from the pool, 0 if there are no timer queries */
+            HardwareTimerQuery* getGPUTimer(void);
+            /** Adds the GPU timers of the frames the GPU has completed to the profile tree */
+            void processGPUTimers(void);
+            /** Returns the pending GPU timers to the pool without reading them */
+            void discardGPUTimers(void);
+
             // lol. Uses typedef; put's original container type in name.
             typedef set<String>::type DisabledProfileMap;
+            typedef map<String, uint32>::type MarkerIDMap;
             typedef ProfileInstance::ProfileChildren ProfileChildren;
 
-            ProfileInstance* mCurrent;
-            ProfileInstance* mLast;
             ProfileInstance mRoot;
 
             /// Holds the names of disabled profiles
             DisabledProfileMap mDisabledProfiles;
 
+            /// The marker IDs of the profiles started by name
+            MarkerIDMap mMarkerIDs;
+
+            typedef vector<std::pair<String, ulong> >::type GPUEventStack;
+            /// The GPU events begun and the time they began at
+            GPUEventStack mGPUEvents;
+
+            /// A GPU timer waiting to be read back
+            struct GPUTimerSample
+            {
+                String name;
+                /// Index of the timer this is nested in, or NO_PARENT
+                size_t parent;
+                HardwareTimerQuery* begin;
+                /// 0 while the timer is open
+                HardwareTimerQuery* end;
+            };
+            typedef vector<GPUTimerSample>::type GPUTimerFrame;
+            typedef deque<GPUTimerFrame>::type GPUTimerFrameQueue;
+            typedef vector<HardwareTimerQuery*>::type GPUTimerList;
+
+            /// The GPU timers of the frames not read back yet, the current frame last
+            GPUTimerFrameQueue mGPUTimerFrames;
+            /// Indices of the open GPU timers of the current frame
+            vector<size_t>::type mGPUTimerStack;
+            /// The timer queries not in use
+            GPUTimerList mFreeGPUTimers;
+            /// Whether the render system gave us a timer query last time we asked
+            bool mGPUTimersSupported;
+
             /// Whether the GUI elements have been initialized
             bool mInitialized;
 
@@ -458,6 +605,10 @@ namespace Ogre {
             /// frame display is updated
             uint mUpdateDisplayFrequency;
 
+            /// The number of open profiles of the main loop, the frame ends
+            /// when they are all closed
+            uint mFrameDepth;
+
             /// The number of elapsed frame, used with mUpdateDisplayFrequency
             uint mCurrentFrame;
 
@@ -484,8 +635,38 @@ namespace Ogre {
             Real mAverageFrameTime;
             bool mResetExtents;
 
+            /// The groups recorded, the profile mask while enabled and 0 otherwise
+            static AtomicScalar<uint32> msRecordMask;
 
     }; // end class
+
+    /** Records a ProfileMarker for the duration of a scope
+        @remarks
+            Use the macro OgreProfileScope(name) instead of instantiating this directly.
+            When the profiler is disabled this costs a single load and compare.
+    */
+    class ProfileScope
+    {
+    public:
+        ProfileScope(const ProfileMarker& marker)
+            : mMarker(0)
+        {
+            if (Profiler::_isRecording(marker.getGroupID()))
+            {
+                mMarker = &marker;
+                Profiler::_recordEvent(marker.getID(), false);
+            }
+        }
+
+        ~ProfileScope()
+        {
+            if (mMarker)
+                Profiler::_recordEvent(mMarker->getID(), true);
+        }
+
+    protected:
+        const ProfileMarker* mMarker;
+    };
     /** @} */
     /** @} */
 
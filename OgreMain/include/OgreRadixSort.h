@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define __RadixSort_H__
 
 #include "OgrePrerequisites.h"
+#include "Threading/OgreParallel.h"
 
 namespace Ogre {
 
@@ -76,13 +77,19 @@ namespace Ogre {
         radixSorter.sort(myBibbleList, functor);
     @endcode
         You should try to reuse RadixSort instances, since repeated allocation of the 
-        internal storage is then avoided.
+        internal storage is then avoided. An instance must not be used by several
+        threads at once, while different instances can sort concurrently.
+    @par
+        For large random access containers, sortParallel spreads the work over
+        the worker threads, see parallelFor.
     @note
         Radix sorting is often associated with just unsigned integer values. Our
         implementation can handle both unsigned and signed integers, as well as
-        floats (which are often not supported by other radix sorters). doubles
-        are not supported; you will need to implement your functor object to convert
-        to float if you wish to use this sort routine.
+        floats (which are often not supported by other radix sorters). 64bit
+        unsigned integers are supported, which allows several criteria
+        to be packed into a single key. doubles are not supported; you will need to
+        implement your functor object to convert to float if you wish to use this
+        sort routine.
     */
     template <class TContainer, class TContainerValueType, typename TCompValueType>
     class RadixSort
@@ -91,8 +98,8 @@ namespace Ogre {
         typedef typename TContainer::iterator ContainerIter;
     protected:
         /// Alpha-pass counters of values (histogram)
-        /// 4 of them so we can radix sort a maximum of a 32bit value
-        int mCounters[4][256];
+        /// One per byte of the sort value, so 64bit integer keys can be sorted too
+        int mCounters[sizeof(TCompValueType)][256];
         /// Beta-pass offsets 
         int mOffsets[256];
         /// Sort area size
@@ -116,6 +123,10 @@ namespace Ogre {
         SortVector* mSrc;
         SortVector* mDest;
         TContainer mTmpContainer; // initial copy
+        /// Per chunk counters, then offsets, of sortParallel
+        vector<int>::type mChunkCounters;
+        /// Whether each chunk of sortParallel was already sorted
+        vector<uint8>::type mChunkSorted;
 
 
         void sortPass(int byteIndex)
@@ -232,6 +243,125 @@ namespace Ogre {
 #endif
         }
 
+        /** Byte of a value remapped so that unsigned byte order is value order,
+            which lets every pass of sortParallel be the same. Unsigned values
+            need no remapping.
+        */
+        template <typename T>
+        static unsigned char orderedByte(unsigned char byteVal, bool mostSignificant,
+            unsigned char topByte, T val)
+        {
+            return byteVal;
+        }
+        // signed int: flip the sign bit so negatives come first
+        static unsigned char orderedByte(unsigned char byteVal, bool mostSignificant,
+            unsigned char topByte, int val)
+        {
+            return mostSignificant ? byteVal ^ 0x80 : byteVal;
+        }
+        // float: negatives are in reverse order, so invert all their bits
+        static unsigned char orderedByte(unsigned char byteVal, bool mostSignificant,
+            unsigned char topByte, float val)
+        {
+            if (topByte & 0x80)
+                return ~byteVal;
+            return mostSignificant ? byteVal ^ 0x80 : byteVal;
+        }
+
+        inline unsigned char getOrderedByte(int byteIndex, TCompValueType val)
+        {
+            return orderedByte(getByte(byteIndex, val), byteIndex == mNumPasses - 1,
+                getByte(mNumPasses - 1, val), val);
+        }
+
+        /// Items [begin, end) of a chunk of sortParallel
+        void getChunkRange(size_t chunk, size_t grainSize, size_t& begin, size_t& end) const
+        {
+            begin = chunk * grainSize;
+            end = std::min(begin + grainSize, static_cast<size_t>(mSortSize));
+        }
+
+        /// Creates the sort entries of a chunk and checks whether they are in order
+        template <class TFunction>
+        void fillChunk(size_t chunk, size_t grainSize, const TFunction& func)
+        {
+            size_t begin, end;
+            getChunkRange(chunk, grainSize, begin, end);
+            ContainerIter it = mTmpContainer.begin() + begin;
+            uint8 sorted = 1;
+            for (size_t u = begin; u < end; ++u, ++it)
+            {
+                TCompValueType val = func(*it);
+                mSortArea1[u].key = val;
+                mSortArea1[u].iter = it;
+                if (u > begin && val < mSortArea1[u - 1].key)
+                    sorted = 0;
+            }
+            mChunkSorted[chunk] = sorted;
+        }
+
+        /// Counts the bytes of a chunk of the source area for a pass
+        void countChunk(size_t chunk, size_t grainSize, int byteIndex)
+        {
+            size_t begin, end;
+            getChunkRange(chunk, grainSize, begin, end);
+            int* counters = &mChunkCounters[chunk * 256];
+            memset(counters, 0, sizeof(int) * 256);
+            for (size_t u = begin; u < end; ++u)
+                ++counters[getOrderedByte(byteIndex, (*mSrc)[u].key)];
+        }
+
+        /// Moves a chunk of the source area to its offsets in the destination area
+        void scatterChunk(size_t chunk, size_t grainSize, int byteIndex)
+        {
+            size_t begin, end;
+            getChunkRange(chunk, grainSize, begin, end);
+            int* offsets = &mChunkCounters[chunk * 256];
+            for (size_t u = begin; u < end; ++u)
+            {
+                unsigned char byteVal = getOrderedByte(byteIndex, (*mSrc)[u].key);
+                (*mDest)[offsets[byteVal]++] = (*mSrc)[u];
+            }
+        }
+
+        /// Calls one of the chunk methods for each chunk, see parallelFor
+        template <class TFunction>
+        struct FillChunkFunctor
+        {
+            RadixSort* sorter;
+            const TFunction* func;
+            size_t grainSize;
+            void operator()(size_t chunk) const { sorter->fillChunk(chunk, grainSize, *func); }
+        };
+        struct CountChunkFunctor
+        {
+            RadixSort* sorter;
+            size_t grainSize;
+            int byteIndex;
+            void operator()(size_t chunk) const { sorter->countChunk(chunk, grainSize, byteIndex); }
+        };
+        struct ScatterChunkFunctor
+        {
+            RadixSort* sorter;
+            size_t grainSize;
+            int byteIndex;
+            void operator()(size_t chunk) const { sorter->scatterChunk(chunk, grainSize, byteIndex); }
+        };
+        struct CopyBackFunctor
+        {
+            RadixSort* sorter;
+            TContainer* container;
+            size_t grainSize;
+            void operator()(size_t chunk) const
+            {
+                size_t begin, end;
+                sorter->getChunkRange(chunk, grainSize, begin, end);
+                ContainerIter it = container->begin() + begin;
+                for (size_t u = begin; u < end; ++u, ++it)
+                    *it = *((*sorter->mSrc)[u].iter);
+            }
+        };
+
     public:
 
         RadixSort() {}
@@ -320,6 +450,96 @@ namespace Ogre {
             }
         }
 
+        /** Sort function spreading the work over the worker threads.
+        @remarks
+            Gives the same result as sort, but the items are split into chunks
+            of grainSize, which are keyed, counted and moved in parallel, see
+            parallelFor. Passes over bytes which are the same for all items are
+            skipped. Containers of up to two chunks are sorted by sort.
+        @par
+            The container must have random access iterators, and the functor
+            is called concurrently so it must be thread safe.
+        @param container A container of the type you declared when declaring
+        @param func A functor which returns the value for comparison when given
+            a container value
+        @param grainSize The number of items processed at once by a thread
+        */
+        template <class TFunction>
+        void sortParallel(TContainer& container, TFunction func, size_t grainSize = 8192)
+        {
+            grainSize = std::max<size_t>(grainSize, 1);
+            if (container.size() <= grainSize * 2)
+            {
+                sort(container, func);
+                return;
+            }
+
+            // Set up the sort areas
+            mSortSize = static_cast<int>(container.size());
+            mSortArea1.resize(container.size());
+            mSortArea2.resize(container.size());
+            mTmpContainer = container;
+            mNumPasses = sizeof(TCompValueType);
+
+            size_t numChunks = (container.size() + grainSize - 1) / grainSize;
+            mChunkCounters.resize(numChunks * 256);
+            mChunkSorted.resize(numChunks);
+
+            FillChunkFunctor<TFunction> fill = { this, &func, grainSize };
+            parallelFor(0, numChunks, fill);
+
+            // early exit if already sorted, chunk by chunk then across them
+            bool needsSorting = false;
+            for (size_t c = 0; c < numChunks && !needsSorting; ++c)
+            {
+                needsSorting = !mChunkSorted[c] ||
+                    (c > 0 && mSortArea1[c * grainSize].key < mSortArea1[c * grainSize - 1].key);
+            }
+            if (!needsSorting)
+                return;
+
+            mSrc = &mSortArea1;
+            mDest = &mSortArea2;
+
+            for (int p = 0; p < mNumPasses; ++p)
+            {
+                CountChunkFunctor count = { this, grainSize, p };
+                parallelFor(0, numChunks, count);
+
+                // Offsets of each chunk within each byte value, in chunk order
+                // so that the sort stays stable
+                int offset = 0;
+                bool skipPass = false;
+                for (int b = 0; b < 256 && !skipPass; ++b)
+                {
+                    int total = 0;
+                    for (size_t c = 0; c < numChunks; ++c)
+                    {
+                        int& counter = mChunkCounters[c * 256 + b];
+                        int n = counter;
+                        counter = offset;
+                        offset += n;
+                        total += n;
+                    }
+                    skipPass = total == mSortSize;
+                }
+                if (skipPass)
+                    continue;
+
+                ScatterChunkFunctor scatter = { this, grainSize, p };
+                parallelFor(0, numChunks, scatter);
+
+                // flip src/dst
+                SortVector* tmp = mSrc;
+                mSrc = mDest;
+                mDest = tmp;
+            }
+
+            // Copy everything back
+            CopyBackFunctor copyBack = { this, &container, grainSize };
+            parallelFor(0, numChunks, copyBack);
+        }
+
     };
 
     /** @} */
@@ -0,0 +1,123 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __RenderCommandList_H__
+#define __RenderCommandList_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup RenderSystem
+    *  @{
+    */
+    /** A recorded sequence of pass changes and draws for one render queue group.
+    @remarks
+        When a RenderQueueGroup has command lists enabled, the SceneManager records
+        the passes it sets and the renderables it draws while rendering the group
+        normally, together with the content hash of the group. On later frames,
+        if the group was filled with the same renderables and no Pass has changed,
+        the list is replayed instead, which skips sorting the group, visiting the
+        pass map and validating every pass and renderable again.
+    @par
+        Replaying still sets every pass and draws every renderable through the
+        RenderSystem, so world transforms, lights and GPU program parameters are
+        always those of the current frame; only the order and the selection of
+        the work are reused.
+    */
+    class _OgreExport RenderCommandList : public RenderQueueAlloc
+    {
+    public:
+        /// A single recorded command, either setting a pass or drawing a renderable
+        struct Command
+        {
+            /// The pass to set, or null if this command draws a renderable
+            const Pass* pass;
+            /// The renderable to draw with the last pass set
+            Renderable* renderable;
+            /// Manual light list to draw with, if any
+            const LightList* manualLightList;
+            /// Whether to use light scissoring and clipping
+            bool scissoring;
+            /// Whether to iterate over the automatic light list
+            bool autoLights;
+        };
+        typedef vector<Command>::type CommandList;
+
+    protected:
+        CommandList mCommands;
+        /// Content hash of the group when the list was recorded
+        uint32 mContentHash;
+        /// Pass::getPassSetGeneration when the list was recorded
+        uint32 mPassSetGeneration;
+        bool mValid;
+        bool mRecording;
+
+    public:
+        RenderCommandList();
+        ~RenderCommandList();
+
+        /** Discards the current contents and starts recording.
+        @param contentHash The RenderQueueGroup::getContentHash of the group being recorded.
+        */
+        void beginRecording(uint32 contentHash);
+        /** Finishes recording, making the list available for replay. */
+        void endRecording(void);
+        /** Stops recording and leaves the list invalid, because something was
+            rendered which cannot be replayed. */
+        void abortRecording(void);
+        /** Returns whether the list is currently recording. */
+        bool isRecording(void) const { return mRecording; }
+
+        /** Records setting a pass, if recording. */
+        void recordPass(const Pass* pass);
+        /** Records drawing a renderable with the last recorded pass, if recording. */
+        void recordRenderable(Renderable* rend, bool scissoring, bool autoLights,
+            const LightList* manualLightList);
+
+        /** Returns whether the list may be replayed for a group with the given
+            content hash. */
+        bool isValidFor(uint32 contentHash) const;
+        /** Marks the list as needing to be recorded again. */
+        void invalidate(void);
+
+        /** Gets the recorded commands. */
+        const CommandList& getCommands(void) const { return mCommands; }
+    };
+
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -98,6 +98,17 @@ namespace Ogre {
         typedef MapIterator<RenderQueueGroupMap> QueueGroupIterator;
         typedef ConstMapIterator<RenderQueueGroupMap> ConstQueueGroupIterator;
 
+        /// Which shadow casters are added when only adding shadow casters
+        enum ShadowCasterFilter
+        {
+            /// All shadow casters
+            SCF_ALL,
+            /// Only the casters flagged with MovableObject::setStaticShadowCaster
+            SCF_STATIC,
+            /// Only the casters not flagged as static
+            SCF_DYNAMIC
+        };
+
         /** Class to listen in on items being added to the render queue. 
         @remarks
             Use RenderQueue::setRenderableListener to get callbacks when an item
@@ -141,8 +152,17 @@ namespace Ogre {
         bool mSplitPassesByLightingType;
         bool mSplitNoShadowPasses;
         bool mShadowCastersCannotBeReceivers;
+        ShadowCasterFilter mShadowCasterFilter;
 
         RenderableListener* mRenderableListener;
+
+        /// Size in pixels on screen of the object being queued, for mipmap streaming, 0 if not needed
+        Real mScreenSize;
+
+        /// Estimates the size in pixels of the object on screen, from its bounding sphere
+        Real calculateScreenSize(MovableObject* mo, const Camera* cam) const;
+        /// Reports the size of the object being queued to the streamed textures of the technique
+        void notifyScreenSize(Technique* pTech) const;
     public:
         RenderQueue();
         virtual ~RenderQueue();
@@ -275,6 +295,17 @@ namespace Ogre {
         */
         bool getShadowCastersCannotBeReceivers(void) const;
 
+        /** Sets which shadow casters processVisibleObject adds when only
+            adding shadow casters, used for caching shadow textures.
+        */
+        void setShadowCasterFilter(ShadowCasterFilter filter) { mShadowCasterFilter = filter; }
+
+        /** Gets which shadow casters are added when only adding shadow casters. */
+        ShadowCasterFilter getShadowCasterFilter(void) const { return mShadowCasterFilter; }
+
+        /** Returns whether a shadow caster passes the shadow caster filter. */
+        bool isShadowCasterIncluded(const MovableObject* mo) const;
+
         /** Set a renderable listener on the queue.
         @remarks
             There can only be a single renderable listener on the queue, since
@@ -289,6 +320,17 @@ namespace Ogre {
         /** Merge render queue.
         */
         void merge( const RenderQueue* rhs );
+
+        /** Sorts all priority groups of the queue for a camera.
+        @remarks
+            The groups then skip sorting again when rendered for the camera,
+            see QueuedRenderableCollection::sort.
+        @param cam The camera
+        @param parallel Whether the groups, and the large collections within
+            them, are sorted on the worker threads, see parallelFor. Requires
+            Renderable::getSquaredViewDepth to be thread safe.
+        */
+        void sort(const Camera* cam, bool parallel);
         /** Utility method to perform the standard actions associated with 
             getting a visible object to add itself to the queue. This is 
             a replacement for SceneManager implementations of the associated
@@ -32,6 +32,8 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgrePass.h"
 #include "OgreRadixSort.h"
+#include "OgreVector3.h"
+#include "OgreQuaternion.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
@@ -128,7 +130,16 @@ namespace Ogre {
             /** Sort ascending camera distance 
                 Note value overlaps with descending since both use same sort
             */
-            OM_SORT_ASCENDING = 6
+            OM_SORT_ASCENDING = 6,
+            /** Group by pass using one packed 64bit key per item.
+            @remarks
+                Visited like OM_PASS_GROUP, and used in its place when it is requested
+                but this is the only grouping mode set. The items are kept in a flat
+                list sorted by pass hash, pass, then ascending camera distance within
+                each pass, so building the queue does not allocate once the list
+                has grown, and the renderables of a pass are drawn front to back.
+            */
+            OM_SORT_KEY = 8
         };
 
     protected:
@@ -205,9 +216,6 @@ namespace Ogre {
             }
         };
 
-        /// Radix sorter for accessing sort value 1 (Pass)
-        static RadixSort<RenderablePassList, RenderablePass, uint32> msRadixSorter1;
-
         /// Functor for descending sort value 2 for radix sort (distance)
         struct RadixSortFunctorDistance
         {
@@ -226,8 +234,51 @@ namespace Ogre {
             }
         };
 
-        /// Radix sorter for sort value 2 (distance)
-        static RadixSort<RenderablePassList, RenderablePass, float> msRadixSorter2;
+        /// RenderablePass with its packed sort key, for OM_SORT_KEY
+        struct KeyedRenderablePass
+        {
+            uint64 key;
+            RenderablePass renderablePass;
+
+            KeyedRenderablePass(Renderable* rend, Pass* p) : key(0), renderablePass(rend, p) {}
+        };
+        typedef vector<KeyedRenderablePass>::type KeyedRenderablePassList;
+
+        /// Functor for accessing the packed key for radix sort
+        struct RadixSortFunctorKey
+        {
+            uint64 operator()(const KeyedRenderablePass& p) const
+            {
+                return p.key;
+            }
+        };
+        /// Comparator ordering items by packed key
+        struct KeyLess
+        {
+            bool operator()(const KeyedRenderablePass& a, const KeyedRenderablePass& b) const
+            {
+                return a.key < b.key;
+            }
+        };
+
+        /// Radix sorters of a collection, so that collections can be sorted concurrently
+        struct RadixSorters : public RenderQueueAlloc
+        {
+            /// Sort value 1 (Pass)
+            RadixSort<RenderablePassList, RenderablePass, uint32> pass;
+            /// Sort value 2 (distance)
+            RadixSort<RenderablePassList, RenderablePass, float> distance;
+            /// The packed keys
+            RadixSort<KeyedRenderablePassList, KeyedRenderablePass, uint64> key;
+        };
+        /// Created when the collection first grows large enough for radix sorting
+        RadixSorters* mRadixSorters;
+
+        /// The camera the lists were last sorted for, 0 if they changed since
+        const Camera* mSortedCamera;
+        /// The pose of mSortedCamera when the lists were sorted
+        Vector3 mSortedPosition;
+        Quaternion mSortedOrientation;
 
         /// Bitmask of the organisation modes requested
         uint8 mOrganisationMode;
@@ -236,6 +287,8 @@ namespace Ogre {
         PassGroupRenderableMap mGrouped;
         /// Sorted descending (can iterate backwards to get ascending)
         RenderablePassList mSortedDescending;
+        /// Sorted by packed key
+        KeyedRenderablePassList mSortedByKey;
 
         /// Internal visitor implementation
         void acceptVisitorGrouped(QueuedRenderableVisitor* visitor) const;
@@ -243,9 +296,23 @@ namespace Ogre {
         void acceptVisitorDescending(QueuedRenderableVisitor* visitor) const;
         /// Internal visitor implementation
         void acceptVisitorAscending(QueuedRenderableVisitor* visitor) const;
+        /// Internal visitor implementation
+        void acceptVisitorSortKey(QueuedRenderableVisitor* visitor) const;
+
+        /// Returns the radix sorters, creating them if needed
+        RadixSorters* getRadixSorters(void);
 
     public:
         QueuedRenderableCollection();
+        ~QueuedRenderableCollection();
+
+        /** Packs the sort key of an item for OM_SORT_KEY.
+        @remarks
+            From the most significant bits: the pass hash, 8 bits telling
+            apart passes with the same hash, then the top 24 bits of the squared
+            view depth, which orders positive floats like integers.
+        */
+        static uint64 _getSortKey(const Pass* pass, Real squaredViewDepth);
 
         /// Empty the collection
         void clear(void);
@@ -265,6 +332,7 @@ namespace Ogre {
         void resetOrganisationModes(void) 
         { 
             mOrganisationMode = 0; 
+            mSortedCamera = 0;
         }
         
         /** Add a required sorting / grouping mode to this collection when next used.
@@ -275,15 +343,31 @@ namespace Ogre {
         void addOrganisationMode(OrganisationMode om) 
         { 
             mOrganisationMode |= om; 
+            mSortedCamera = 0;
+        }
+
+        /** Returns whether the given sorting / grouping mode was added to this collection.
+        @see OrganisationMode
+        */
+        bool hasOrganisationMode(OrganisationMode om) const
+        {
+            return (mOrganisationMode & om) != 0;
         }
 
         /// Add a renderable to the collection using a given pass
         void addRenderable(Pass* pass, Renderable* rend);
         
         /** Perform any sorting that is required on this collection.
+        @remarks
+            Sorting again for the same camera, which hasn't moved since, returns
+            at once unless renderables were added or removed in between. The
+            renderables are assumed not to move while they are queued.
         @param cam The camera
+        @param parallel Whether large collections may be sorted on the worker
+            threads, which requires Renderable::getSquaredViewDepth to be
+            thread safe, see RadixSort::sortParallel
         */
-        void sort(const Camera* cam);
+        void sort(const Camera* cam, bool parallel = false);
 
         /** Accept a visitor over the collection contents.
         @param visitor Visitor class which should be called back
@@ -413,8 +497,10 @@ namespace Ogre {
         void addRenderable(Renderable* pRend, Technique* pTech);
 
         /** Sorts the objects which have been added to the queue; transparent objects by their 
-            depth in relation to the passed in Camera. */
-        void sort(const Camera* cam);
+            depth in relation to the passed in Camera.
+        @see QueuedRenderableCollection::sort
+        */
+        void sort(const Camera* cam, bool parallel = false);
 
         /** Clears this group of renderables. 
         */
@@ -476,6 +562,10 @@ namespace Ogre {
         bool mShadowsEnabled;
         /// Bitmask of the organisation modes requested (for new priority groups)
         uint8 mOrganisationMode;
+        /// Whether the SceneManager may record and replay this group as a RenderCommandList
+        bool mCommandListEnabled;
+        /// Running hash of the renderables added since the last clear
+        uint32 mContentHash;
 
 
     public:
@@ -489,6 +579,8 @@ namespace Ogre {
             , mShadowCastersNotReceivers(shadowCastersNotReceivers)
             , mShadowsEnabled(true)
             , mOrganisationMode(0)
+            , mCommandListEnabled(false)
+            , mContentHash(0)
         {
         }
 
@@ -542,6 +634,9 @@ namespace Ogre {
             // Add
             pPriorityGrp->addRenderable(pRend, pTech);
 
+            mContentHash = HashCombine(mContentHash, pRend);
+            mContentHash = HashCombine(mContentHash, pTech);
+            mContentHash = HashCombine(mContentHash, priority);
         }
 
         /** Clears this group of renderables. 
@@ -566,8 +661,34 @@ namespace Ogre {
             if (destroy)
                 mPriorityGroups.clear();
 
+            mContentHash = 0;
         }
 
+        /** Gets a hash of the renderables, techniques and priorities added to
+            this group since it was last cleared, in the order they were added.
+        @remarks
+            Two frames which queue exactly the same objects in the same order
+            produce the same hash, which is what allows a RenderCommandList
+            recorded for this group to be replayed.
+        */
+        uint32 getContentHash(void) const { return mContentHash; }
+
+        /** Sets whether the SceneManager may record the render commands of this
+            group and replay them on later frames while its contents are unchanged.
+        @remarks
+            This only benefits groups of static, opaque geometry rendered without
+            shadows: a list is kept per camera, is only used when every renderable
+            in the group is a solid grouped by pass, and is re-recorded whenever
+            the queued renderables or any Pass change. Changes to a material which do not touch its passes' hashes,
+            such as switching it between opaque and transparent, are not detected;
+            call SceneManager::invalidateRenderCommandLists after making them.
+            Disabled by default.
+        */
+        void setCommandListEnabled(bool enabled) { mCommandListEnabled = enabled; }
+
+        /** Gets whether the SceneManager may record and replay this group's render commands. */
+        bool getCommandListEnabled(void) const { return mCommandListEnabled; }
+
         /** Indicate whether a given queue group will be doing any
         shadow setup.
         @remarks
@@ -716,6 +837,8 @@ namespace Ogre {
                 // merge
                 pDstPriorityGrp->merge( pSrcPriorityGrp );
             }
+
+            mContentHash = HashCombine(mContentHash, rhs->mContentHash);
         }
     };
 
@@ -118,6 +118,37 @@ namespace Ogre
     class _OgreExport RenderSystem : public RenderSysAlloc
     {
     public:
+        /** Statistics of the rendering commands issued in one frame
+        @see getRenderStats
+        */
+        struct RenderStats
+        {
+            /// Number of render operations drawn, each pass iteration counting once
+            size_t drawCalls;
+            /// Draw calls by render queue group ID
+            size_t drawCallsByQueue[256];
+            /// Number of GPU programs bound
+            size_t programBinds;
+            /// Number of textures bound to texture units
+            size_t textureBinds;
+            /// Number of pipeline states changed, if the render system tracks them
+            size_t stateChanges;
+            /// Number of bytes of GPU program parameters uploaded, if the render system tracks them
+            size_t uniformBytes;
+            /// Number of bytes locked in hardware buffers, by HardwareBuffer::LockUsage
+            size_t bufferLockBytes[HardwareBuffer::LU_COUNT];
+            /// Number of vertex array objects bound, if the render system has them
+            size_t vertexArrayBinds;
+            /// Number of times the render target changed
+            size_t renderTargetSwitches;
+            /// Number of render targets updated and skipped by _updateAllRenderTargets
+            size_t renderTargetUpdates;
+            size_t renderTargetsSkipped;
+
+            RenderStats() { reset(); }
+            void reset() { memset(this, 0, sizeof(RenderStats)); }
+        };
+
         /** Default Constructor.
         */
         RenderSystem();
@@ -182,6 +213,15 @@ namespace Ogre
         */
         virtual void destroyHardwareOcclusionQuery(HardwareOcclusionQuery *hq);
 
+        /** Create an object for recording GPU timestamps.
+        @return 0 if the render system doesn't support timer queries.
+        */
+        virtual HardwareTimerQuery* createHardwareTimerQuery(void) { return 0; }
+
+        /** Destroy a hardware timer query object. 
+        */
+        virtual void destroyHardwareTimerQuery(HardwareTimerQuery *tq);
+
         /** Validates the options set for the rendering system, returning a message if there are problems.
         @note
         If the returned string is empty, there are no problems.
@@ -855,6 +895,17 @@ namespace Ogre
         /** Reports the number of vertices passed to the renderer since the last _beginGeometryCount call. */
         virtual unsigned int _getVertexCount(void) const;
 
+        /** Gets the statistics of the rendering commands of the last frame
+        @remarks
+            A frame ends when _swapAllRenderTargetBuffers is called, which Root does
+            after updating all render targets.
+        */
+        const RenderStats& getRenderStats(void) const { return mLastRenderStats; }
+        /** Gets the statistics of the frame being rendered, for the render system to add to */
+        RenderStats& _getCurrentRenderStats(void) { return mRenderStats; }
+        /** Sets the render queue group the following draw calls are counted for */
+        void _setCurrentRenderQueue(uint8 queueID) { mCurrentRenderQueue = queueID; }
+
         /** Generates a packed data version of the passed in ColourValue suitable for
         use as with this RenderSystem.
         @remarks
@@ -1046,6 +1097,38 @@ namespace Ogre
         */
         virtual void _render(const RenderOperation& op);
 
+        /**
+        Dispatch the bound compute program.
+
+        The compute program, its parameters and the textures it samples are
+        bound as for _render, images written by the program are bound with
+        Texture::createShaderAccessPoint beforehand. Writes to the images are
+        visible to the operations that follow.
+
+        @param workgroupDim The number of work groups to launch in each dimension.
+        */
+        virtual void _dispatchCompute(const Vector3& workgroupDim);
+
+        /** Starts gathering the following rendering operations into a draw batch.
+        @remarks
+            Between this and _endDrawBatch, _render may defer the operations it is
+            given and submit several of them with a single draw call, for instance
+            through an indirect multi-draw. The RenderSystem flushes the pending
+            operations itself whenever a later call would change the state they
+            depend on. The world matrix set with _setWorldMatrix before each
+            operation is kept per draw, for the GPU programs to read; any other
+            GPU program parameter changed between batched operations applies to
+            all of them.
+        @return
+            false if the RenderSystem does not support draw batching, in which
+            case operations are rendered immediately as usual.
+        */
+        virtual bool _beginDrawBatch(void) { return false; }
+
+        /** Submits the operations gathered since _beginDrawBatch and stops
+            gathering them. */
+        virtual void _endDrawBatch(void) {}
+
         virtual void _renderUsingReadBackAsTexture(unsigned int secondPass,Ogre::String variableName,unsigned int StartSlot);
 
         /** Gets the capabilities of the render system. */
@@ -1122,12 +1205,55 @@ namespace Ogre
         */
         void _notifyCameraRemoved(const Camera* cam);
 
-        /** Internal method for updating all render targets attached to this rendering system. */
+        /** Sets the time automatic updates of secondary render targets may take per frame.
+        @remarks
+            Render targets with a priority below OGRE_DEFAULT_RT_GROUP, which are the
+            render textures and other views rendered before the windows, are postponed
+            while updating them would exceed the budget. The cost of a target is its
+            GPU time if the render system has timer queries, or else the time spent
+            submitting it, as measured in an earlier update. A target is postponed by
+            at most its update interval, so every target is eventually refreshed.
+        @param microseconds The budget, 0 for no limit
+        @see RenderTarget::setUpdateInterval
+        */
+        void setRenderTargetUpdateBudget(unsigned long microseconds) { mRenderTargetUpdateBudget = microseconds; }
+        /// Gets the time automatic updates of secondary render targets may take per frame
+        unsigned long getRenderTargetUpdateBudget(void) const { return mRenderTargetUpdateBudget; }
+
+        /** Internal method for updating all render targets attached to this rendering system.
+        @remarks
+            Skips the targets which are not due according to their update interval
+            and usage texture, or don't fit in the update budget.
+        */
         virtual void _updateAllRenderTargets(bool swapBuffers = true);
         /** Internal method for swapping all the buffers on all render targets,
         if _updateAllRenderTargets was called with a 'false' parameter. */
         virtual void _swapAllRenderTargetBuffers();
 
+        /** Fence the commands submitted so far, Root calls it after each frame
+            when limiting the frames in flight, see Root::setMaxFramesInFlight.
+        @remarks
+            Render systems without fences do nothing, and the driver decides how
+            far ahead the CPU may run.
+        */
+        virtual void _insertFrameFence(void) {}
+        /** Wait until at most the given number of frame fences are pending,
+            and release the completed ones.
+        @param maxPending The number of frames the GPU may still be working on
+            when this returns.
+        */
+        virtual void _waitFrameFences(size_t maxPending) {}
+
+        /** Tell the GPU the contents of some buffers of a render target are not
+            needed, see RenderTarget::setLoadAction and RenderTarget::setStoreAction.
+        @remarks
+            Tile based GPUs then skip loading the buffers into or storing them
+            out of their tiles. Render systems without such a hint do nothing.
+        @param target The render target, which may be made the active one
+        @param buffers Combination of one or more elements of FrameBufferType
+        */
+        virtual void _discardRenderTarget(RenderTarget* target, unsigned int buffers) {}
+
         /** Sets whether or not vertex windings set should be inverted; this can be important
         for rendering reflections. */
         void setInvertVertexWinding(bool invert);
@@ -1407,6 +1533,12 @@ namespace Ogre
         size_t mFaceCount;
         size_t mVertexCount;
 
+        /// Statistics of the frame being rendered and of the last frame
+        RenderStats mRenderStats;
+        RenderStats mLastRenderStats;
+        /// The render queue group draw calls are counted for
+        uint8 mCurrentRenderQueue;
+
         /// Saved manual colour blends
         ColourValue mManualBlendColours[OGRE_MAX_TEXTURE_LAYERS][2];
 
@@ -1453,6 +1585,31 @@ namespace Ogre
         typedef list<HardwareOcclusionQuery*>::type HardwareOcclusionQueryList;
         HardwareOcclusionQueryList mHwOcclusionQueries;
 
+        typedef list<HardwareTimerQuery*>::type HardwareTimerQueryList;
+        HardwareTimerQueryList mHwTimerQueries;
+
+        /// Measured cost of the updates of a render target within the update budget
+        struct RenderTargetTiming
+        {
+            HardwareTimerQuery* begin;
+            HardwareTimerQuery* end;
+            /// Whether the queries were created, they are 0 without timer query support
+            bool created;
+            /// Whether the queries hold a result not yet pulled
+            bool pending;
+            /// Cost of the last measured update in microseconds
+            unsigned long cost;
+
+            RenderTargetTiming() : begin(0), end(0), created(false), pending(false), cost(0) {}
+        };
+        typedef map<RenderTarget*, RenderTargetTiming>::type RenderTargetTimingMap;
+        RenderTargetTimingMap mRenderTargetTimings;
+        unsigned long mRenderTargetUpdateBudget;
+
+        /// Update a target within the budget, returns false if it was postponed
+        bool updateBudgetedRenderTarget(RenderTarget* target, bool swapBuffers,
+                                        unsigned long frame, unsigned long& spent);
+
         bool mVertexProgramBound;
         bool mGeometryProgramBound;
         bool mFragmentProgramBound;
@@ -99,6 +99,24 @@ namespace Ogre {
             FB_AUTO
         };
 
+        /// What happens to the previous contents of a buffer when an update begins
+        enum LoadAction
+        {
+            /// The contents are kept and rendered on top of
+            LA_LOAD,
+            /// The contents are undefined, they are going to be fully overwritten
+            LA_DONT_CARE
+        };
+
+        /// What happens to the contents of a buffer when an update ends
+        enum StoreAction
+        {
+            /// The contents are kept for later use
+            SA_STORE,
+            /// The contents are not needed anymore and may be thrown away
+            SA_DISCARD
+        };
+
         RenderTarget();
         virtual ~RenderTarget();
 
@@ -330,6 +348,79 @@ namespace Ogre {
         */
         virtual bool isAutoUpdated(void) const;
 
+        /** Sets how often this target is updated automatically.
+        @remarks
+            Targets whose contents change slowly, like reflections or environment
+            maps, can be updated every few frames instead of every frame. Giving
+            the faces of a cube map the same interval and different offsets
+            spreads their updates over the frames. An update may also be
+            postponed to stay within RenderSystem::setRenderTargetUpdateBudget.
+        @param interval Number of frames between updates, 1 updates every frame
+        @param offset Number of frames until the next update
+        */
+        void setUpdateInterval(uint32 interval, uint32 offset = 0);
+        /// Gets the number of frames between automatic updates
+        uint32 getUpdateInterval(void) const { return mUpdateInterval; }
+
+        /** Skips automatic updates while a texture is not being used for rendering.
+        @remarks
+            The texture is usually the one this target renders to, so that a
+            reflection or other secondary view is only updated while something
+            showing it was rendered in the previous frame. When it comes into
+            view again its contents are therefore one update late.
+        @param texture The texture to check, or 0 to update regardless
+        */
+        void setUpdateUsageTexture(const Texture* texture) { mUpdateUsageTexture = texture; }
+        /// Gets the texture whose use enables automatic updates, if any
+        const Texture* getUpdateUsageTexture(void) const { return mUpdateUsageTexture; }
+
+        /** Whether an automatic update is due in the given frame.
+        @see Root::getNextFrameNumber
+        */
+        bool _isUpdateDue(unsigned long frame) const;
+        /// Number of frames an automatic update due in the given frame is late
+        unsigned long _getUpdateDelay(unsigned long frame) const
+        { return frame > mNextUpdateFrame ? frame - mNextUpdateFrame : 0; }
+        /// Whether update was called in the given frame
+        bool _isUpdatedInFrame(unsigned long frame) const { return mLastUpdateFrame == frame; }
+
+        /** Sets what happens to the previous contents of some buffers of this
+            target when an update begins.
+        @remarks
+            Tile based GPUs copy the buffers from memory into their tiles before
+            rendering, unless told the contents are not needed. A buffer which is
+            fully overwritten every update, like a depth buffer which is cleared
+            anyway, can be set to LA_DONT_CARE to skip that. Note that clearing a
+            buffer at the start of an update, as viewports do by default, already
+            lets most drivers skip the load.
+        @param action The load action
+        @param buffers Combination of one or more elements of FrameBufferType
+            denoting which buffers the action applies to
+        */
+        void setLoadAction(LoadAction action,
+            unsigned int buffers = FBT_COLOUR | FBT_DEPTH | FBT_STENCIL);
+        /// Gets the load action of one of the buffers of this target
+        LoadAction getLoadAction(FrameBufferType buffer) const
+        { return (mDontCareBuffers & buffer) ? LA_DONT_CARE : LA_LOAD; }
+
+        /** Sets what happens to the contents of some buffers of this target
+            when an update ends.
+        @remarks
+            Tile based GPUs write the buffers from their tiles back to memory after
+            rendering, unless told the contents are not needed. The depth and
+            stencil buffers are usually only needed while rendering, setting them
+            to SA_DISCARD saves that bandwidth. Discarded buffers are undefined in
+            the next update, so only discard what is not read afterwards.
+        @param action The store action
+        @param buffers Combination of one or more elements of FrameBufferType
+            denoting which buffers the action applies to
+        */
+        void setStoreAction(StoreAction action,
+            unsigned int buffers = FBT_COLOUR | FBT_DEPTH | FBT_STENCIL);
+        /// Gets the store action of one of the buffers of this target
+        StoreAction getStoreAction(FrameBufferType buffer) const
+        { return (mDiscardBuffers & buffer) ? SA_DISCARD : SA_STORE; }
+
         /** Copies the current contents of the render target to a pixelbox. 
         @remarks See suggestPixelFormat for a tip as to the best pixel format to
             extract into, although you can use whatever format you like and the 
@@ -346,6 +437,20 @@ namespace Ogre {
         */
         OGRE_DEPRECATED void copyContentsToMemory(const PixelBox &dst, FrameBuffer buffer = FB_AUTO) { copyContentsToMemory(Box(0, 0, mWidth, mHeight), dst, buffer); }
 
+        /** Starts copying the contents of the render target to memory, without
+            waiting for the GPU to finish rendering them.
+        @remarks
+            For reading back every frame, such as for video capture, or GPU picking.
+            Fetch the data from the returned ticket once it is ready, typically a
+            few frames later. Render systems without asynchronous readback copy at
+            once, see AsyncReadback.
+        @param src
+            Box of the contents to copy
+        @param buffer
+            Which buffer to copy from
+        */
+        virtual AsyncReadbackPtr copyContentsToMemoryAsync(const Box& src, FrameBuffer buffer = FB_AUTO);
+
         /** Suggests a pixel format to use for extracting the data in this target, 
             when calling copyContentsToMemory.
         */
@@ -512,6 +617,18 @@ namespace Ogre {
         uint mFSAA;
         String mFSAAHint;
 		bool mStereoEnabled;
+        /// FrameBufferType mask of the buffers not loaded when an update begins
+        unsigned int mDontCareBuffers;
+        /// FrameBufferType mask of the buffers not stored when an update ends
+        unsigned int mDiscardBuffers;
+
+        /// Number of frames between automatic updates
+        uint32 mUpdateInterval;
+        /// Frames in which update was last called and the next automatic update is due
+        unsigned long mLastUpdateFrame;
+        unsigned long mNextUpdateFrame;
+        /// Texture which has to be used for automatic updates to happen
+        const Texture* mUpdateUsageTexture;
 
         virtual void updateStats(void);
 
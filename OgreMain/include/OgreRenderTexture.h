@@ -53,6 +53,8 @@ namespace Ogre
 
         using RenderTarget::copyContentsToMemory;
         virtual void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer = FB_AUTO);
+        /// @copydoc RenderTarget::copyContentsToMemoryAsync
+        virtual AsyncReadbackPtr copyContentsToMemoryAsync(const Box& src, FrameBuffer buffer = FB_AUTO);
         PixelFormat suggestPixelFormat() const;
 
     protected:
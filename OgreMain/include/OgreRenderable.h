@@ -256,6 +256,14 @@ namespace Ogre {
             return mCustomParameters.find(index) != mCustomParameters.end();
         }
 
+        /** Checks whether any custom value is associated with this Renderable.
+        @see setCustomParameter for full details.
+        */
+        bool hasCustomParameters(void) const
+        {
+            return !mCustomParameters.empty();
+        }
+
         /** Gets the custom value associated with this Renderable at the given index.
         @param index Index of the parameter to retrieve.
             @see setCustomParameter for full details.
@@ -311,6 +319,31 @@ namespace Ogre {
             }
         }
 
+        typedef map<String, TexturePtr>::type TextureOverrideMap;
+
+        /** Sets a texture this Renderable uses instead of that of a texture unit
+            of its material.
+        @remarks
+            Together with setCustomParameter, this lets many Renderables which
+            only differ in a texture or a colour share one material, rather than
+            each using a clone of it. The passes stay shared, so the Renderables
+            are still sorted and set up together, and only the texture is bound
+            again for each of them.
+        @param textureUnitName The name of the texture unit, in any pass of the material
+        @param texture The texture to use, or a null pointer to use that of the
+            texture unit again
+        */
+        void setTextureOverride(const String& textureUnitName, const TexturePtr& texture)
+        {
+            if (texture)
+                mTextureOverrides[textureUnitName] = texture;
+            else
+                mTextureOverrides.erase(textureUnitName);
+        }
+
+        /** Gets the textures set by setTextureOverride, by texture unit name. */
+        const TextureOverrideMap& getTextureOverrides(void) const { return mTextureOverrides; }
+
         /** Sets whether this renderable's chosen detail level can be
             overridden (downgraded) by the camera setting. 
         @param override true means that a lower camera detail will override this
@@ -408,6 +441,7 @@ namespace Ogre {
     protected:
         typedef map<size_t, Vector4>::type CustomParameterMap;
         CustomParameterMap mCustomParameters;
+        TextureOverrideMap mTextureOverrides;
         bool mPolygonModeOverrideable;
         bool mUseIdentityProjection;
         bool mUseIdentityView;
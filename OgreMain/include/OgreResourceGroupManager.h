@@ -309,7 +309,7 @@ namespace Ogre {
         ResourceLoadingListener *mLoadingListener;
 
         /// Resource index entry, resourcename->location 
-        typedef map<String, Archive*>::type ResourceLocationIndex;
+        typedef OGRE_HashMap<String, Archive*> ResourceLocationIndex;
 
         /// List of resources which can be loaded / unloaded
         typedef list<ResourcePtr>::type LoadUnloadResourceList;
@@ -433,6 +433,21 @@ namespace Ogre {
 
         /// Stored current group - optimisation for when bulk loading a group
         ResourceGroup* mCurrentGroup;
+
+        /// Files of an archive as listed at a modification time of it
+        struct ArchiveListing
+        {
+            String archiveName;
+            time_t modifiedTime;
+            StringVector files;
+        };
+        /// Archive listings by archive type, name and recursion
+        typedef map<String, ArchiveListing>::type ArchiveListingMap;
+        ArchiveListingMap mArchiveListings;
+        String mLocationIndexCachePath;
+        bool mArchiveListingsChanged;
+        /// Lists the files of an archive, through the location index cache if there is one
+        StringVectorPtr listResourceLocation(Archive* arch, bool recursive);
     public:
         ResourceGroupManager();
         virtual ~ResourceGroupManager();
@@ -665,6 +680,30 @@ namespace Ogre {
         bool resourceLocationExists(const String& name, 
             const String& resGroup = DEFAULT_RESOURCE_GROUP_NAME) const;
 
+        /** Sets a file which keeps the file listings of the resource locations
+            between runs.
+        @remarks
+            addResourceLocation lists all files of an archive to index them, which
+            takes long for big archives on slow file systems. With a cache file
+            the listing is taken from the cache as long as the modification time
+            of the archive is unchanged. For directories that is the time of the
+            directory itself, which does not change with files added in
+            subdirectories, use invalidateLocationIndexCache after such changes.
+            Set it before adding resource locations. The cache is written by
+            initialiseAllResourceGroups, saveLocationIndexCache and on shutdown,
+            if it changed.
+        @param path The cache file, empty to not use a cache
+        */
+        void setLocationIndexCache(const String& path);
+        /// Gets the file which keeps the file listings of the resource locations
+        const String& getLocationIndexCache(void) const { return mLocationIndexCachePath; }
+        /// Writes the location index cache file, if the listings changed
+        void saveLocationIndexCache(void);
+        /** Drops the cached file listings of an archive, so that it is listed
+            again the next time it is added as a resource location.
+        */
+        void invalidateLocationIndexCache(const String& archiveName);
+
         /** Declares a resource to be a part of a resource group, allowing you 
             to load and unload it as part of the group.
         @remarks
@@ -545,6 +545,8 @@ namespace Ogre {
         virtual void addImpl( ResourcePtr& res );
         /** Remove a resource from this manager; remove it from the lists. */
         virtual void removeImpl(const ResourcePtr& res );
+        /// Adds a resource to mResources or mResourcesWithGroup, returns false if the name is taken
+        bool insertResource(const ResourcePtr& res, bool isGlobal);
         /** Checks memory usage and pages out if required. This is automatically done after a new resource is loaded.
         */
         void checkUsage(void);
@@ -558,6 +560,11 @@ namespace Ogre {
         ResourceHandleMap mResourcesByHandle;
         ResourceMap mResources;
         ResourceWithGroupMap mResourcesWithGroup;
+        /** Guards the maps above for the lookups by name and handle, which don't
+            take the auto mutex so that threads looking up resources don't
+            serialise. Changes to the maps hold both.
+        */
+        OGRE_WQ_SHARED_MUTEX(mResourceIndexMutex);
         size_t mMemoryBudget; /// In bytes
         AtomicScalar<ResourceHandle> mNextHandle;
         AtomicScalar<size_t> mMemoryUsage; /// In bytes
@@ -0,0 +1,240 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ResourceStreamingQueue_H__
+#define __ResourceStreamingQueue_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreResourceBackgroundQueue.h"
+#include "OgreFrameListener.h"
+#include "OgreTimer.h"
+#include "OgreStringVector.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+
+    /** Streams resources in by priority, on top of ResourceBackgroundQueue.
+    @remarks
+        Requested resources are prepared in the background, which does the I/O
+        and decoding, and then loaded on the main thread, which does the upload
+        to the GPU. Requests are started in order of their priority class and
+        then their distance, as long as the number of requests in flight and the
+        I/O bandwidth allow. Prepared resources are loaded in the same order each
+        frame until the time budget for this is used up, so that streaming
+        never stalls a frame for long.
+    @par
+        Several requests for the same resource are coalesced into one, with the
+        highest priority among them. Requests can be cancelled one by one or all
+        those beyond a distance, e.g. when the camera moved away from them.
+    @par
+        The queue updates itself as a FrameListener of Root, so it must be
+        created after Root. Listeners are called from the main thread.
+    */
+    class _OgreExport ResourceStreamingQueue : public FrameListener, public ResourceBackgroundQueue::Listener,
+        public ResourceAlloc
+    {
+    public:
+        /// Classes of priority, all requests of one class are started before those of the next
+        enum PriorityClass
+        {
+            PC_CRITICAL,
+            PC_HIGH,
+            PC_NORMAL,
+            PC_LOW
+        };
+
+        ResourceStreamingQueue();
+        virtual ~ResourceStreamingQueue();
+
+        /** Requests a resource to be streamed in.
+        @param resType The type of the resource (from ResourceManager::getResourceType())
+        @param name The name of the resource
+        @param group The resource group of the resource
+        @param priority The priority class of the request
+        @param distance The distance of the resource, nearer ones are streamed first
+            within a priority class
+        @param listener Optional listener to call once the resource is loaded, or
+            streaming it failed. It is not called for cancelled requests.
+        @return Ticket identifying the request
+        */
+        BackgroundProcessTicket request(const String& resType, const String& name,
+            const String& group, PriorityClass priority = PC_NORMAL, Real distance = 0,
+            ResourceBackgroundQueue::Listener* listener = 0);
+
+        /** Changes the priority of a request, e.g. as the camera moves.
+        @remarks
+            Coalesced requests take the highest priority any of them was given.
+        */
+        void setPriority(BackgroundProcessTicket ticket, PriorityClass priority, Real distance);
+
+        /** Cancels a request.
+        @remarks
+            The resource is only left unloaded if no other request for it remains.
+            A resource which is already prepared stays so.
+        */
+        void cancel(BackgroundProcessTicket ticket);
+
+        /** Cancels all requests of the given priority class or lower, whose
+            distance is greater than the given one.
+        */
+        void cancelBeyond(Real distance, PriorityClass priority = PC_CRITICAL);
+
+        /// Returns whether a request has completed or was cancelled
+        bool isComplete(BackgroundProcessTicket ticket) const;
+
+        /// Sets the maximum number of resources prepared at once, 0 for no limit
+        void setMaxRequestsInFlight(size_t count) { mMaxRequestsInFlight = count; }
+        /// Gets the maximum number of resources prepared at once
+        size_t getMaxRequestsInFlight() const { return mMaxRequestsInFlight; }
+
+        /** Sets the number of bytes per second which may be read for streaming,
+            0 for no limit.
+        @remarks
+            The size of a resource is estimated by the size of its file, a
+            resource is started when the budget is not exhausted and it may
+            overdraw the budget, so that resources larger than the limit still
+            get streamed.
+        */
+        void setBandwidthLimit(size_t bytesPerSecond);
+        /// Gets the number of bytes per second which may be read for streaming
+        size_t getBandwidthLimit() const { return mBandwidthLimit; }
+
+        /** Sets the time per frame which may be spent loading prepared resources
+            on the main thread, in microseconds.
+        @remarks
+            At least one resource is loaded per frame regardless.
+        */
+        void setFrameTimeBudget(unsigned long microseconds) { mFrameTimeBudget = microseconds; }
+        /// Gets the time per frame which may be spent loading prepared resources
+        unsigned long getFrameTimeBudget() const { return mFrameTimeBudget; }
+
+        /// Returns the number of requested resources not loaded yet
+        size_t getNumPendingResources() const { return mResources.size(); }
+
+        /** Starts requests and loads prepared resources within the limits.
+        @param timeSinceLastUpdate The time in seconds since the last update,
+            which the bandwidth budget grows by
+        */
+        void update(Real timeSinceLastUpdate);
+
+        /// @copydoc FrameListener::frameStarted
+        bool frameStarted(const FrameEvent& evt);
+        /// @copydoc ResourceBackgroundQueue::Listener::operationCompleted
+        void operationCompleted(BackgroundProcessTicket ticket, const BackgroundProcessResult& result);
+
+    protected:
+        enum State
+        {
+            /// Waiting to be started
+            RS_PENDING,
+            /// Being prepared in the background
+            RS_PREPARING,
+            /// Prepared, waiting to be loaded
+            RS_PREPARED
+        };
+
+        /// A request for a resource
+        struct Request
+        {
+            BackgroundProcessTicket ticket;
+            ResourceBackgroundQueue::Listener* listener;
+            PriorityClass priority;
+            Real distance;
+        };
+        typedef vector<Request>::type RequestList;
+
+        /// A resource to be streamed, shared by all requests for it
+        struct StreamedResource : public ResourceAlloc
+        {
+            String resourceType;
+            String name;
+            String group;
+            /// Key in mResources
+            String key;
+            State state;
+            /// Highest priority of the requests
+            PriorityClass priority;
+            Real distance;
+            /// Ticket of the background request while preparing
+            BackgroundProcessTicket backgroundTicket;
+            RequestList requests;
+
+            /// Updates the priority from the requests
+            void updatePriority();
+        };
+        typedef map<String, StreamedResource*>::type StreamedResourceMap;
+        /// Resources by type, group and name
+        StreamedResourceMap mResources;
+        typedef map<BackgroundProcessTicket, StreamedResource*>::type TicketMap;
+        /// Resources by the tickets of their requests
+        TicketMap mTickets;
+        /// Resources by the tickets of their background requests
+        TicketMap mBackgroundTickets;
+
+        BackgroundProcessTicket mNextTicket;
+        size_t mMaxRequestsInFlight;
+        size_t mNumRequestsInFlight;
+        size_t mBandwidthLimit;
+        /// Bytes which may be read until the budget grows again
+        double mBandwidthBudget;
+        unsigned long mFrameTimeBudget;
+        Timer mTimer;
+
+        /** Gets the keys of the resources in the given state, sorted by priority.
+        @remarks
+            Keys rather than pointers, as listeners called while going through
+            them may cancel or complete any of the resources.
+        */
+        void getResources(State state, StringVector& keys) const;
+        /// Finds the resource with the given key if it is still in the given state
+        StreamedResource* findResource(const String& key, State state) const;
+        /// Starts preparing the resource in the background
+        void startPreparing(StreamedResource* res);
+        /// Loads the prepared resource
+        void loadPrepared(StreamedResource* res);
+        /// Calls the listeners of the resource and forgets about it
+        void complete(StreamedResource* res, const BackgroundProcessResult& result);
+        /// Forgets about a resource with no more requests
+        void remove(StreamedResource* res);
+        /// Estimates the number of bytes to read for the resource
+        size_t estimateSize(const StreamedResource* res) const;
+    };
+
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 
 #include "OgreSceneManagerEnumerator.h"
+#include "OgreFrameSnapshot.h"
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
 #include "Android/OgreAndroidLogListener.h"
@@ -50,6 +51,7 @@ namespace Ogre
     */
 
     typedef vector<RenderSystem*>::type RenderSystemList;
+    class ParallelJob;
     
     /** The root class of the Ogre system.
         @remarks
@@ -93,6 +95,7 @@ namespace Ogre
         
         ArchiveFactory *mZipArchiveFactory;
         ArchiveFactory *mEmbeddedZipArchiveFactory;
+        ArchiveFactory *mIndexedZipArchiveFactory;
         ArchiveFactory *mFileSystemArchiveFactory;
         
 #if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
@@ -146,6 +149,36 @@ namespace Ogre
 
         WorkQueue* mWorkQueue;
 
+        /// Simulation run while the previous frame renders, see setFrameSimulation
+        FrameSimulation* mFrameSimulation;
+        /// The snapshot to apply next and the one being simulated
+        FrameSnapshot mFrameSnapshots[2];
+        /// The job simulating into mFrameSnapshots[1], if any
+        SharedPtr<ParallelJob> mFrameSimulationJob;
+        /// When the last simulation was started, in microseconds
+        unsigned long mLastFrameSimulationTime;
+
+        /// Finish the simulated frame, start simulating the next one and apply the finished one
+        void advanceFrameSimulation(Real timeSinceLastFrame);
+        /// Wait for the frame being simulated and drop the snapshots
+        void stopFrameSimulation(void);
+
+        /// See setMaxFramesInFlight, 0 if not limited
+        size_t mMaxFramesInFlight;
+        /// See setTargetFrameTime, in microseconds
+        unsigned long mTargetFrameTime;
+        /// When the last frame started, in microseconds
+        unsigned long mLastFrameStartTime;
+        /// When the input of the frame being rendered was marked, 0 if it was not
+        unsigned long mInputTime;
+        /// See getInputLatency
+        Real mInputLatency;
+
+        /// Wait for the GPU and the target frame time before a frame starts
+        void paceFrame(void);
+        /// Fence the frame and measure the input latency after the buffers were swapped
+        void framePresented(void);
+
         ///Tells whether blend indices information needs to be passed to the GPU
         bool mIsBlendIndicesGpuRedundant;
         ///Tells whether blend weights information needs to be passed to the GPU
@@ -644,6 +677,21 @@ namespace Ogre
                 const String& groupName = ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
                 bool overwrite = false, const String& locationPattern = BLANKSTRING);
 
+        /** Helper method replacing a file by a temporary file written next to it.
+        @remarks
+            For saving without leaving a broken file behind if interrupted: write
+            the data to a temporary file with createFileStream, close it, then
+            replace the real file with it. The replacement is atomic where the
+            file system allows it. Both names are resolved like createFileStream
+            does, and have to end up in the same location.
+        @param tempFilename The name of the temporary file, which is renamed
+        @param filename The name of the file to replace
+        @param groupName The name of the group the files were created in, if the
+            resource system was used
+        */
+        static void replaceFile(const String& tempFilename, const String& filename,
+                const String& groupName = ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
         /** Helper method to assist you in accessing readable file streams.
         @remarks
             This is a high-level utility method which you can use to find a place to 
@@ -1033,6 +1081,66 @@ namespace Ogre
             at shutdown, so do not destroy it yourself.
         */
         void setWorkQueue(WorkQueue* queue);
+
+        /** Pipeline the simulation of the next frame with the rendering of this one.
+        @remarks
+            Opt-in. Once set, each renderOneFrame starts the simulation of the next
+            frame on a worker thread, applies the FrameSnapshot of the frame simulated
+            during the previous call, then fires the frame events and renders as
+            usual. See FrameSimulation for the threading rules which come with it.
+            Setting a different simulation, or none, first waits for the frame being
+            simulated and discards its snapshot.
+        @param simulation The simulation, or 0 to render without one. Root does
+            not take ownership of it.
+        */
+        void setFrameSimulation(FrameSimulation* simulation);
+        /// Get the simulation set with setFrameSimulation
+        FrameSimulation* getFrameSimulation(void) const { return mFrameSimulation; }
+
+        /** Limit how many frames the CPU may run ahead of the GPU.
+        @remarks
+            Before each renderOneFrame starts a frame, it waits until the GPU is
+            working on fewer than this many frames, using fences (GL sync objects,
+            D3D11 event queries). With 1 the GPU has finished every previous frame
+            when the frame starts, which gives the lowest latency but no overlap
+            of CPU and GPU work; 2 lets the CPU work on one frame while the GPU
+            draws the previous one. Render systems without fences ignore it.
+        @param frames The number of frames, or 0 to leave the queue depth to
+            the driver, which is the default.
+        */
+        void setMaxFramesInFlight(size_t frames);
+        /// Get the limit set with setMaxFramesInFlight
+        size_t getMaxFramesInFlight(void) const { return mMaxFramesInFlight; }
+
+        /** Set the minimum time between the starts of two frames.
+        @remarks
+            renderOneFrame waits for the rest of this time before starting a
+            frame, sleeping while enough time is left for the scheduler to wake
+            it up in time and spinning for the last couple of milliseconds. This
+            keeps the frame times even without vsync, and when the target is
+            above the time a frame takes, moves the wait before the input is
+            sampled rather than after the frame was queued.
+        @param seconds The frame time, or 0 not to wait, which is the default.
+        */
+        void setTargetFrameTime(Real seconds);
+        /// Get the time set with setTargetFrameTime
+        Real getTargetFrameTime(void) const { return mTargetFrameTime * 0.000001f; }
+
+        /** Mark when the input of the frame about to be rendered was sampled.
+        @remarks
+            Call it from frameStarted or before renderOneFrame, right after
+            reading the input devices. getInputLatency then reports the time
+            from the mark to the present of the frame.
+        */
+        void markInputSampled(void);
+        /** Get the time in seconds from the last markInputSampled until the
+            buffers of its frame were swapped.
+        @remarks
+            This is the latency until the frame was handed to the driver. The
+            frames queued ahead of it add to what is seen on screen, which
+            setMaxFramesInFlight bounds.
+        */
+        Real getInputLatency(void) const { return mInputLatency; }
             
         /** Sets whether blend indices information needs to be passed to the GPU.
             When entities use software animation they remove blend information such as
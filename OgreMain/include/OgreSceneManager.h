@@ -47,6 +47,7 @@ Torus Knot Software Ltd.
 #include "OgreInstanceManager.h"
 #include "OgreRenderSystem.h"
 #include "OgreLodListener.h"
+#include "OgreAtomicScalar.h"
 #include "OgreHeaderPrefix.h"
 #include "OgreNameGenerator.h"
 
@@ -355,7 +356,7 @@ namespace Ogre {
             const Pass* mUsedPass;
         public:
             SceneMgrQueuedRenderableVisitor() 
-                :transparentShadowCastersMode(false) {}
+                :transparentShadowCastersMode(false), commandList(0) {}
             ~SceneMgrQueuedRenderableVisitor() {}
             void visit(Renderable* r);
             bool visit(const Pass* p);
@@ -371,6 +372,8 @@ namespace Ogre {
             const LightList* manualLightList;
             /// Scissoring if requested?
             bool scissoring;
+            /// List to record the passes set and renderables drawn into, if any
+            RenderCommandList* commandList;
 
         };
         /// Allow visitor helper to access protected methods
@@ -423,6 +426,8 @@ namespace Ogre {
                 can look up nodes this way.
         */
         SceneNodeList mSceneNodes;
+        /// Adds a node to mSceneNodes
+        void addSceneNode(SceneNode* sn);
 
         /// Camera in progress
         Camera* mCameraInProgress;
@@ -483,6 +488,110 @@ namespace Ogre {
         bool mFlipCullingOnNegativeScale;
         CullingMode mPassCullingMode;
 
+        /// The render state last sent to the RenderSystem by _setPass
+        struct PassState
+        {
+            ColourValue ambient;
+            ColourValue diffuse;
+            ColourValue specular;
+            ColourValue selfIllumination;
+            Real shininess;
+            TrackVertexColourType vertexColourTracking;
+            bool lightingEnabled;
+
+            FogMode fogMode;
+            ColourValue fogColour;
+            Real fogDensity;
+            Real fogStart;
+            Real fogEnd;
+
+            SceneBlendFactor sourceBlendFactor;
+            SceneBlendFactor destBlendFactor;
+            SceneBlendFactor sourceBlendFactorAlpha;
+            SceneBlendFactor destBlendFactorAlpha;
+            SceneBlendOperation blendOperation;
+            SceneBlendOperation blendOperationAlpha;
+            bool separateBlending;
+
+            Real pointSize;
+            Real pointAttenuationConstant;
+            Real pointAttenuationLinear;
+            Real pointAttenuationQuadratic;
+            Real pointMinSize;
+            Real pointMaxSize;
+            bool pointAttenuationEnabled;
+            bool pointSpritesEnabled;
+
+            /// Pass whose texture units are bound
+            const Pass* texturePass;
+
+            CompareFunction depthFunction;
+            bool depthCheck;
+            bool depthWrite;
+            float depthBiasConstant;
+            float depthBiasSlopeScale;
+
+            CompareFunction alphaRejectFunction;
+            unsigned char alphaRejectValue;
+            bool alphaToCoverage;
+
+            bool colourWrite;
+            CullingMode cullingMode;
+            ShadeOptions shadingMode;
+            PolygonMode polygonMode;
+        };
+        PassState mPassState;
+        /// Mask of PassStateGroup whose mPassState values are those set in the RenderSystem
+        uint32 mPassStateValid;
+        /// Number of render state groups set and skipped by _setPass this frame
+        size_t mPassStateChangesApplied;
+        size_t mPassStateChangesSkipped;
+        /// Whether _setPass started a RenderSystem draw batch which is still open
+        bool mDrawBatchOpen;
+        /// Mask of the texture units bound to a texture of Renderable::setTextureOverride
+        uint32 mTextureOverrideUnits;
+
+        /** Binds the override textures of a renderable to the texture units of
+            the pass, and the textures of the pass to the units the previous
+            renderable had overridden.
+        */
+        void setTextureOverrides(const Renderable* rend, const Pass* pass);
+
+        /** Returns whether a group of the pass state can be left as it is, and
+            counts the change as skipped or applied. If not, the group is marked
+            valid, so the caller must then update mPassState and the RenderSystem.
+        */
+        bool isPassStateCurrent(uint32 group, bool sameValues)
+        {
+            if ((mPassStateValid & group) && sameValues)
+            {
+                ++mPassStateChangesSkipped;
+                return true;
+            }
+            mPassStateValid |= group;
+            ++mPassStateChangesApplied;
+            return false;
+        }
+
+        /** Gathers a renderable into the dynamic batch instead of drawing it.
+        @return false if dynamic batching is off or the renderable can't be
+            batched, in which case it must be drawn as usual
+        */
+        bool addToDynamicBatch(Renderable* rend, const Pass* pass, bool scissoring,
+            bool autoLights, const LightList* manualLightList);
+        /// Draws the renderables gathered in the dynamic batch, if any
+        void flushDynamicBatch(void);
+
+        /// Submits the RenderSystem draw batch opened by _setPass, if any
+        void endDrawBatch(void)
+        {
+            if (mDrawBatchOpen)
+            {
+                mDestRenderSystem->_endDrawBatch();
+                mDrawBatchOpen = false;
+            }
+        }
+
     protected:
 
         /** Visible objects bounding box list.
@@ -534,7 +643,7 @@ namespace Ogre {
         ulong mLightsDirtyCounter;
         LightList mShadowTextureCurrentCasterLightList;
 
-        typedef map<String, MovableObject*>::type MovableObjectMap;
+        typedef OGRE_HashMap<String, MovableObject*> MovableObjectMap;
         /// Simple structure to hold MovableObject map and a mutex to go with it.
         struct MovableObjectCollection
         {
@@ -687,6 +796,9 @@ namespace Ogre {
         /** Flag that indicates if all of the scene node's bounding boxes should be shown as a wireframe. */
         bool mShowBoundingBoxes;      
 
+        /// Gathers the debug primitives of the scene
+        DebugDrawer* mDebugDrawer;
+
         /** Internal method for rendering all objects using the default queue sequence. */
         void renderVisibleObjectsDefaultSequence(void);
         /** Internal method for rendering all objects using a custom queue sequence. */
@@ -745,6 +857,64 @@ namespace Ogre {
         typedef vector<Camera*>::type ShadowTextureCameraList;
         ShadowTextureCameraList mShadowTextureCameras;
         Texture* mCurrentShadowTexture;
+        /// The static casters of a shadow texture, see setShadowTextureCaching
+        struct ShadowTextureCache
+        {
+            /// The static casters as seen by the texture camera
+            TexturePtr texture;
+            /// The light and texture camera the static casters were rendered for
+            const Light* light;
+            Matrix4 viewMatrix;
+            Matrix4 projMatrix;
+            /// mStaticShadowCasterStateCount when rendered, 0 if never
+            uint32 stateCount;
+            /// Whether the cached matrices were forced on the texture camera
+            bool cameraOverridden;
+
+            ShadowTextureCache() : light(0), viewMatrix(Matrix4::IDENTITY), projMatrix(Matrix4::IDENTITY),
+                stateCount(0), cameraOverridden(false) {}
+        };
+        typedef vector<ShadowTextureCache>::type ShadowTextureCacheList;
+        ShadowTextureCacheList mShadowTextureCaches;
+        bool mShadowTextureCaching;
+        Real mShadowTextureCacheTexelTolerance;
+        /// The frustum a shadow texture was last rendered with, see ShadowCameraSetup::isShadowCameraUpdateDue
+        struct ShadowTextureUpdate
+        {
+            const Texture* texture;
+            const Light* light;
+            const Camera* camera;
+            Matrix4 viewMatrix;
+            Matrix4 projMatrix;
+            /// Whether the texture is kept this frame, with the matrices forced on the texture camera
+            bool skipped;
+
+            ShadowTextureUpdate() : texture(0), light(0), camera(0), skipped(false) {}
+        };
+        typedef vector<ShadowTextureUpdate>::type ShadowTextureUpdateList;
+        ShadowTextureUpdateList mShadowTextureUpdates;
+        /// Bumped whenever a static shadow caster changes, may be from several threads
+        AtomicScalar<uint32> mStaticShadowCasterStateCount;
+        /// Whether casters are being merged into a cached shadow texture
+        bool mShadowCasterMinBlending;
+        /// The casters of a shadow texture camera, culled ahead by cullShadowCastersParallel
+        struct CulledShadowCasters
+        {
+            const Camera* camera;
+            /// The matrices of the camera when culled, the nodes are stale if they changed
+            Matrix4 viewMatrix;
+            Matrix4 projMatrix;
+            vector<Node*>::type nodes;
+
+            CulledShadowCasters() : camera(0) {}
+        };
+        typedef vector<CulledShadowCasters>::type CulledShadowCastersList;
+        CulledShadowCastersList mCulledShadowCasters;
+        /// Whether the shadow textures are regions of one atlas, see setShadowTextureAtlas
+        bool mShadowAtlasEnabled;
+        ShadowAtlasAllocator mShadowAtlasAllocator;
+        /// The region of each shadow texture, as (left, top, right, bottom) texture coordinates
+        vector<Vector4>::type mShadowTextureRegions;
         bool mShadowUseInfiniteFarPlane;
         bool mShadowCasterRenderBackFaces;
         bool mShadowAdditiveLightClip;
@@ -792,6 +962,39 @@ namespace Ogre {
         virtual void ensureShadowTexturesCreated();
         /// Internal method for destroying shadow textures (texture-based shadows)
         virtual void destroyShadowTextures(void);
+        /** Internal method culling the scene for the casters of several shadow
+            texture cameras at once on the worker threads, used when the
+            parallel culling depth is set.
+        */
+        void cullShadowCastersParallel(const vector<Camera*>::type& cameras);
+        /** Internal method adding the casters culled ahead for a shadow texture camera.
+        @return false if there are none, or the camera moved since
+        */
+        bool addCulledShadowCasters(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds);
+        /// Internal method forgetting the casters culled ahead
+        void clearCulledShadowCasters(void);
+        /// Internal method for destroying the cached static casters of the shadow textures
+        void destroyShadowTextureCaches(void);
+        /// Internal method returning the viewport a shadow texture is rendered through
+        Viewport* getShadowTextureViewport(size_t index);
+        /** Internal method sizing the atlas regions of the shadow textures about to
+            be rendered by the share of the view their light covers.
+        @param textureLights The light and iteration of each shadow texture
+        */
+        void allocateShadowAtlasRegions(const Camera* cam,
+            const frame_vector<std::pair<Light*, size_t> >::type& textureLights);
+        /// Internal method binding the camera and region of a shadow texture to a texture projector
+        void setShadowTextureProjector(size_t shadowIndex, size_t projectorIndex);
+        /** Internal method for rendering a shadow texture from its cached static
+            casters and the dynamic casters.
+        @param index The index of the shadow texture
+        */
+        void renderCachedShadowTexture(size_t index, Light* light, Camera* texCam);
+        /// Internal method forcing the matrices the static casters were cached with on the camera
+        void keepShadowTextureCacheCamera(ShadowTextureCache& cache, Camera* texCam);
+        /// Returns whether the static casters cached for a shadow texture may be used with the camera
+        bool isShadowTextureCacheValid(const ShadowTextureCache& cache, const TexturePtr& shadowTex,
+            const Light* light, const Camera* texCam) const;
 
         typedef vector<InstanceManager*>::type      InstanceManagerVec;
         InstanceManagerVec mDirtyInstanceManagers;
@@ -876,6 +1079,85 @@ namespace Ogre {
         uint32 mVisibilityMask;
         bool mFindVisibleObjects;
 
+        /// Depth below which scene graph subtrees are updated on worker threads, 0 if disabled
+        size_t mParallelUpdateDepth;
+        /// Depth below which scene graph subtrees are culled on worker threads, 0 if disabled
+        size_t mParallelCullingDepth;
+        /// Storage of the derived transforms of all nodes in the scene graph, see the "TransformPool" option
+        NodeTransformPool* mTransformPool;
+        /// Software skinning deferred while finding visible objects, see the "ParallelSoftwareSkinning" option
+        SoftwareSkinningBatch* mSoftwareSkinningBatch;
+        /// Whether entities add their software skinning to mSoftwareSkinningBatch at the moment
+        bool mSoftwareSkinningBatchActive;
+        /// Skinning moved to the GPU while finding visible objects, see the "GpuSkinning" option
+        GpuSkinningBatch* mGpuSkinningBatch;
+        /// Whether entities add their skinning to mGpuSkinningBatch at the moment
+        bool mGpuSkinningBatchActive;
+        /// Draws billboard chains sharing a material together, see the "BatchBillboardChains" option
+        BillboardChainBatcher* mBillboardChainBatcher;
+        /// Draws the entities shown as impostors, created when first needed
+        ImpostorBatcher* mImpostorBatcher;
+        /// Merges small renderables sharing a pass, see the "DynamicBatching" option
+        DynamicRenderBatch* mDynamicBatch;
+        size_t mDynamicBatchVertexLimit;
+        /// Light clusters of the main camera, see setLightClustering
+        LightClusters* mLightClusters;
+
+        /// What the render queue was last built for, see the "SharedCulling" option
+        struct SharedCullingState
+        {
+            /// The culling frustum, 0 if the render queue may not be reused
+            const Frustum* frustum;
+            unsigned long frame;
+            uint32 visibilityMask;
+            String materialScheme;
+            RenderQueueInvocationSequence* invocationSequence;
+            bool shadowsEnabled;
+            bool skiesEnabled;
+            VisibleObjectsBoundsInfo visibleBounds;
+        };
+        /// Whether the render queue is sorted on worker threads after culling, see the "ParallelSorting" option
+        bool mParallelSorting;
+        /// Whether cameras sharing a culling frustum share the render queue
+        bool mSharedCulling;
+        SharedCullingState mSharedCullingState;
+        /// Whether the render queue built for mSharedCullingState can be rendered for a camera
+        bool canReuseRenderQueue(Camera* camera, Viewport* vp) const;
+
+        /** Updates the scene graph in parallel, see the "ParallelUpdateDepth" option.
+        @remarks
+            The levels above mParallelUpdateDepth are updated on the calling thread, the
+            subtrees below are distributed between the calling thread and the WorkQueue
+            worker threads. The bounds of the upper levels are merged once all subtrees
+            are done.
+        */
+        void updateSceneGraphParallel(void);
+
+        /// Updates the scene graph level by level through mTransformPool
+        void updateSceneGraphPooled(void);
+
+        /** Finds the visible objects with a parallel node culling pass, see the
+            "ParallelCullingDepth" option.
+        @remarks
+            Only the visibility of the nodes is tested on the worker threads. The objects
+            of the visible nodes are then passed to the render queue on the calling
+            thread, in scene graph order, since LOD events, listeners and the render
+            queue itself are not thread safe.
+        */
+        void findVisibleObjectsParallel(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds,
+            bool onlyShadowCasters);
+
+        /** Returns whether the scene nodes created by this manager can be updated from
+            several threads at once.
+        @remarks
+            Subclasses whose scene nodes update shared structures of the manager from
+            _update or _updateBounds (e.g. a spatial tree) must return false, which makes
+            the "ParallelUpdateDepth", "TransformPool" and "ParallelCullingDepth" options
+            unavailable. The "TransformPool" option updates the nodes level by level,
+            bypassing overrides of _update.
+        */
+        virtual bool isParallelUpdateSafe(void) const { return true; }
+
         /// Suppress render state changes?
         bool mSuppressRenderStateChanges;
         /// Suppress shadows?
@@ -981,6 +1263,15 @@ namespace Ogre {
         void resetLightClip();
         void checkCachedLightClippingInfo(bool forceScissorRectsInvalidation = false);
 
+        typedef std::pair<const Camera*, const RenderQueueGroup*> RenderCommandListKey;
+        typedef map<RenderCommandListKey, RenderCommandList*>::type RenderCommandListMap;
+        /// Recorded render commands of the queue groups which have them enabled
+        RenderCommandListMap mRenderCommandLists;
+        /// Remove the recorded render commands of a camera
+        void destroyRenderCommandLists(const Camera* cam);
+        /// Set the passes and draw the renderables recorded in a RenderCommandList
+        void renderCommandList(const RenderCommandList& commandList);
+
         /// The active renderable visitor class - subclasses could override this
         SceneMgrQueuedRenderableVisitor* mActiveQueuedRenderableVisitor;
         /// Storage for default renderable visitor
@@ -1207,6 +1498,20 @@ namespace Ogre {
         */
         const LightList& _getLightsAffectingFrustum(void) const;
 
+        /** Sets whether the lights affecting the frustum are binned into clusters.
+        @remarks
+            When enabled, each main camera render bins the lights returned by
+            _getLightsAffectingFrustum into the view frustum clusters of a
+            LightClusters on worker threads and uploads them to its texture,
+            so clustered forward shading (for example the RTSS
+            'lighting_stage clustered') can shade every light of a fragment's
+            cluster in a single pass. The per object light lists are not
+            affected.
+        */
+        void setLightClustering(bool enabled);
+        /** Gets the light clusters, or null if light clustering is disabled. */
+        LightClusters* getLightClusters(void) const { return mLightClusters; }
+
         /** Populate a light list with an ordered set of the lights which are closest
         to the position specified.
         @remarks
@@ -1690,6 +1995,64 @@ namespace Ogre {
         /** Method for setting a specific option of the Scene Manager. These options are usually
             specific for a certain implemntation of the Scene Manager class, and may (and probably
             will) not exist across different implementations.
+            @par
+                The following options are supported by all scene managers whose nodes
+                can be updated concurrently:
+                - "ParallelUpdateDepth" (size_t): when non-zero, the levels of the scene
+                  graph below this depth are updated as independent subtrees on the
+                  WorkQueue worker threads by _updateSceneGraph. Defaults to 0 (single
+                  threaded). Only enable this if node listeners and the bounding box
+                  calculations of attached objects are thread safe.
+                - "TransformPool" (bool): when true, the derived transforms of all nodes
+                  in the scene graph are kept in a NodeTransformPool and _updateSceneGraph
+                  updates them one hierarchy level at a time. Takes precedence over
+                  "ParallelUpdateDepth". Defaults to false.
+                - "ParallelCullingDepth" (size_t): when non-zero, the bounds of the scene
+                  nodes below this depth are tested against the camera on the WorkQueue
+                  worker threads by _findVisibleObjects. The visible objects are still
+                  queued on the calling thread. With texture shadows, the casters of all
+                  shadow textures are culled together before the first one is rendered.
+                  Defaults to 0 (single threaded).
+            @par
+                All scene managers support:
+                - "ParallelSoftwareSkinning" (bool): when true, entities found visible
+                  defer their software skinning to a SoftwareSkinningBatch, which skins
+                  all of them on the WorkQueue worker threads before rendering starts.
+                  Defaults to false.
+                - "GpuSkinning" (bool): when true, entities skinned in software are
+                  skinned on the GPU instead by a GpuSkinningBatch, once per frame,
+                  and all their passes draw the skinned vertices. Only for entities
+                  whose vertices aren't read back for stencil shadows or software
+                  animation requests, on render systems which support it.
+                  Defaults to false.
+                - "BatchBillboardChains" (bool): when true, visible billboard chains and
+                  ribbon trails sharing a material and render queue are drawn together
+                  by a BillboardChainBatcher, out of one shared vertex buffer.
+                  Defaults to false.
+                - "DynamicBatching" (bool): when true, small renderables drawn one
+                  after another with the same pass, vertex declaration and lights
+                  are merged by a DynamicRenderBatch and drawn together. Only the
+                  pass grouped solids are merged, and passes can opt out with
+                  Pass::setDynamicBatchingEnabled. Defaults to false.
+                - "DynamicBatchVertexLimit" (size_t): the maximum number of vertices
+                  of a renderable merged by "DynamicBatching". Defaults to 300.
+                - "SharedCulling" (bool): when true, cameras with the same culling
+                  frustum (see Camera::setCullingFrustum) rendered one after another in
+                  a frame share the render queue. The first one finds the visible
+                  objects, lights and shadow textures, the following ones only render
+                  the queue again with their own view and projection. Meant for
+                  stereo eyes or split screen views culled against one frustum
+                  enclosing all of them. Viewports need the same visibility mask,
+                  material scheme, render queue sequence, shadow and sky settings.
+                  Level of detail, billboard facing and skies follow the first
+                  camera, and the find visible objects listeners are only called for
+                  it. Defaults to false.
+                - "ParallelSorting" (bool): when true, the render queue is sorted
+                  once the visible objects are found, with the priority groups and
+                  the large collections within them sorted on the WorkQueue worker
+                  threads. Rendering the queue groups then skips sorting them.
+                  Only enable this if the queued renderables can report their
+                  view depth from several threads at once. Defaults to false.
             @param
                 strKey The name of the option to set
             @param
@@ -1700,8 +2063,7 @@ namespace Ogre {
             @par
                 On failure, false is returned.
         */
-        virtual bool setOption( const String& strKey, const void* pValue )
-        { (void)strKey; (void)pValue; return false; }
+        virtual bool setOption( const String& strKey, const void* pValue );
 
         /** Method for getting the value of an implementation-specific Scene Manager option.
             @param
@@ -1716,8 +2078,7 @@ namespace Ogre {
             @par
                 On failure, false is returned and pDestValue is set to NULL.
         */
-        virtual bool getOption( const String& strKey, void* pDestValue )
-        { (void)strKey; (void)pDestValue; return false; }
+        virtual bool getOption( const String& strKey, void* pDestValue );
 
         /** Method for verifying whether the scene manager has an implementation-specific
             option.
@@ -1728,8 +2089,7 @@ namespace Ogre {
             @remarks
                 If it does not, false is returned.
         */
-        virtual bool hasOption( const String& strKey ) const
-        { (void)strKey; return false; }
+        virtual bool hasOption( const String& strKey ) const;
 
         /** Method for getting all possible values for a specific option. When this list is too large
             (i.e. the option expects, for example, a float), the return value will be true, but the
@@ -1754,8 +2114,7 @@ namespace Ogre {
             @return
                 On success, true is returned. On failure, false is returned.
         */
-        virtual bool getOptionKeys( StringVector& refKeys )
-        { (void)refKeys; return false; }
+        virtual bool getOptionKeys( StringVector& refKeys );
 
         /** Internal method for updating the scene graph ie the tree of SceneNode instances managed by this class.
             @remarks
@@ -1767,6 +2126,32 @@ namespace Ogre {
         */
         virtual void _updateSceneGraph(Camera* cam);
 
+        /// Get the pool holding the derived transforms of the scene graph, if the "TransformPool" option is set
+        NodeTransformPool* _getTransformPool(void) const { return mTransformPool; }
+
+        /** Get the batch entities add their software skinning to, or null if they
+            skin immediately.
+        @remarks
+            Only set while finding the visible objects, with the "ParallelSoftwareSkinning"
+            option enabled.
+        */
+        SoftwareSkinningBatch* _getSoftwareSkinningBatch(void) const
+        { return mSoftwareSkinningBatchActive ? mSoftwareSkinningBatch : 0; }
+
+        /** Get the batch entities add their skinning to when it is done on the GPU,
+            or null if they skin in software.
+        @remarks
+            Only set while finding the visible objects, with the "GpuSkinning" option
+            enabled.
+        */
+        GpuSkinningBatch* _getGpuSkinningBatch(void) const
+        { return mGpuSkinningBatchActive ? mGpuSkinningBatch : 0; }
+
+        /// Get the batcher visible billboard chains add themselves to, if the "BatchBillboardChains" option is set
+        BillboardChainBatcher* _getBillboardChainBatcher(void) const { return mBillboardChainBatcher; }
+        /// Get the batcher entities drawn as impostors add themselves to, creating it if needed
+        ImpostorBatcher* _getImpostorBatcher(void);
+
         /** Internal method which parses the scene to find visible objects to render.
             @remarks
                 If you're implementing a custom scene manager, this is the most important method to
@@ -1790,8 +2175,11 @@ namespace Ogre {
         void _applySceneAnimations(void);
 
         /** Sends visible objects found in _findVisibleObjects to the rendering engine.
+        @remarks
+            Custom scene managers may override this to render something of their
+            own, such as occlusion queries, once the visible objects are drawn.
         */
-        void _renderVisibleObjects(void);
+        virtual void _renderVisibleObjects(void);
 
         /** Prompts the class to send its contents to the renderer.
             @remarks
@@ -2428,6 +2816,9 @@ namespace Ogre {
         /** Returns if all bounding boxes of scene nodes are to be displayed */
         bool getShowBoundingBoxes() const;
 
+        /** Gets the drawer for debug lines, boxes and spheres in this scene. */
+        DebugDrawer* getDebugDrawer() const { return mDebugDrawer; }
+
         /** Internal method for notifying the manager that a SceneNode is autotracking. */
         void _notifyAutotrackingSceneNode(SceneNode* node, bool autoTrack);
 
@@ -2761,6 +3152,69 @@ namespace Ogre {
         */
         const TexturePtr& getShadowTexture(size_t shadowIndex);
 
+        /** Sets whether texture shadows of static casters are cached.
+        @remarks
+            Normally every caster is rendered into every shadow texture each
+            frame. With caching, the casters flagged with
+            MovableObject::setStaticShadowCaster are rendered once into a
+            texture kept for each shadow texture, and each frame only the
+            other casters are rendered on top of a copy of it. The cache is
+            refreshed when a static caster changes, or when the light or the
+            shadow camera moves. A shadow camera which only slides sideways,
+            like the one of a directional light following the view, keeps the
+            cached frustum until it has slid by more than the texel tolerance.
+        @par
+            Casters are merged keeping the minimum value, which suits shadow
+            textures holding the caster depth or the shadow colour on a white
+            background, as both the built-in and the usual custom caster
+            materials do. Alpha blended casters lose their blending while
+            merged. Off by default.
+        @param enabled Whether to cache the static casters
+        @param texelTolerance How many texels a shadow camera may slide before
+            the cache is refreshed
+        */
+        void setShadowTextureCaching(bool enabled, Real texelTolerance = 8);
+        /** Gets whether texture shadows of static casters are cached. */
+        bool getShadowTextureCaching(void) const { return mShadowTextureCaching; }
+        /** Have the static casters rendered into the shadow textures again.
+        @remarks
+            Moving, attaching or detaching a static caster does this already.
+            May be called from several threads at once.
+        */
+        void invalidateShadowTextureCache(void) { ++mStaticShadowCasterStateCount; }
+
+        /** Sets whether the shadow textures are regions of one shared atlas.
+        @remarks
+            Instead of a texture for each shadow texture configuration, one
+            square texture with the format of the first configuration is
+            created, and each frame every shadowed light is assigned a region
+            of it. The edge of a region scales with how much of the view the
+            light covers: directional lights get the size configured for their
+            shadow texture, point and spot lights the share of it their range
+            covers on screen, but no less than the minimum region size. When
+            the regions do not all fit, the largest ones shrink first.
+        @par
+            The shadow camera setups work as before, each shadow texture
+            camera renders into its region through a viewport of its own.
+            Receivers have to use texture_viewproj_matrix or
+            texture_worldviewproj_matrix, which map into the region, and may
+            clamp their filtering with texture_viewport_rect. Fixed-function
+            projective texturing and setShadowTextureCaching are not
+            supported in atlas mode.
+        @param enabled Whether to render the shadow textures into an atlas
+        @param size The edge length of the atlas, rounded down to a power of two
+        @param minRegionSize The smallest region edge, rounded down to a power
+            of two; the atlas must hold a region this size for every shadow texture
+        */
+        void setShadowTextureAtlas(bool enabled, uint32 size = 4096, uint32 minRegionSize = 128);
+        /** Gets whether the shadow textures are regions of one shared atlas. */
+        bool getShadowTextureAtlas(void) const { return mShadowAtlasEnabled; }
+        /** Gets the region a shadow texture was last rendered to, as (left, top,
+            right, bottom) texture coordinates. Always the whole texture outside
+            of atlas mode.
+        */
+        const Vector4& getShadowTextureRegion(size_t shadowIndex) const;
+
         /** Sets the proportional distance which a texture shadow which is generated from a
             directional light will be offset into the camera view to make best use of texture space.
         @remarks
@@ -3260,6 +3714,13 @@ namespace Ogre {
         void _injectRenderWithPass(Pass *pass, Renderable *rend, bool shadowDerivation = true,
             bool doLightIteration = false, const LightList* manualLightList = 0);
 
+        /** Dispatch the compute program of a pass as if it came from the current queue.
+            @param pass     Material pass with the compute program, its parameters and textures.
+            @param rend     Renderable the auto constants of the program are evaluated for.
+            @param workgroupDim The number of work groups to launch in each dimension.
+         */
+        void _dispatchComputeWithPass(Pass *pass, Renderable *rend, const Vector3& workgroupDim);
+
         /** Indicates to the SceneManager whether it should suppress changing
             the RenderSystem states when rendering objects.
         @remarks
@@ -3300,6 +3761,64 @@ namespace Ogre {
         */
         const Pass* _setPass(const Pass* pass,
             bool evenIfSuppressed = false, bool shadowDerivation = true);
+
+        /// Groups of the render state set by _setPass which are tracked individually
+        enum PassStateGroup
+        {
+            PSG_SURFACE = 0x0001,
+            PSG_LIGHTING = 0x0002,
+            PSG_FOG = 0x0004,
+            PSG_BLENDING = 0x0008,
+            PSG_POINT = 0x0010,
+            PSG_POINT_SPRITES = 0x0020,
+            PSG_TEXTURE_UNITS = 0x0040,
+            PSG_DEPTH_FUNCTION = 0x0080,
+            PSG_DEPTH_CHECK = 0x0100,
+            PSG_DEPTH_WRITE = 0x0200,
+            PSG_DEPTH_BIAS = 0x0400,
+            PSG_ALPHA_REJECT = 0x0800,
+            PSG_COLOUR_WRITE = 0x1000,
+            PSG_CULLING = 0x2000,
+            PSG_SHADING = 0x4000,
+            PSG_POLYGON_MODE = 0x8000,
+            PSG_ALL = 0xFFFF
+        };
+        /** Forgets the render state last set by _setPass, so that the next pass
+            is set in full.
+        @remarks
+            _setPass only sends the render state which differs from that of the
+            previous pass to the RenderSystem. If you change the state of the
+            RenderSystem directly between passes, call this with the groups you
+            changed so they are not assumed to be still as _setPass left them.
+        @param groups Combination of SceneManager::PassStateGroup values.
+        */
+        void _invalidatePassState(uint32 groups = PSG_ALL)
+        { mPassStateValid &= ~groups; }
+
+        /** Gets the number of render state groups which _setPass sent to the
+            RenderSystem since the start of the frame. */
+        size_t _getNumPassStateChangesApplied(void) const { return mPassStateChangesApplied; }
+
+        /** Gets the number of render state groups which _setPass did not send to
+            the RenderSystem since the start of the frame, because the previous pass
+            had already set them to the same values.
+        @remarks
+            Comparing this with _getNumPassStateChangesApplied tells how well the
+            materials of a scene are sorted for state changes.
+        */
+        size_t _getNumPassStateChangesSkipped(void) const { return mPassStateChangesSkipped; }
+
+        /** Gets the number of auto constants of GPU program parameters which were
+            evaluated since the start of the frame. */
+        size_t _getNumAutoConstantsUpdated(void) const
+        { return mAutoParamDataSource->_getNumAutoConstantsUpdated(); }
+
+        /** Gets the number of auto constants of GPU program parameters which were
+            not evaluated since the start of the frame, because the data they are
+            derived from had not changed since they were last updated.
+        */
+        size_t _getNumAutoConstantsSkipped(void) const
+        { return mAutoParamDataSource->_getNumAutoConstantsSkipped(); }
         
         /** Method to allow you to mark gpu parameters as dirty, causing them to 
             be updated according to the mask that you set when updateGpuProgramParameters is
@@ -3354,6 +3873,14 @@ namespace Ogre {
         /** Gets the current visitor object which processes queued renderables. */
         SceneMgrQueuedRenderableVisitor* getQueuedRenderableVisitor(void) const;
 
+        /** Forces every recorded RenderCommandList to be recorded again the next
+            time its queue group is rendered.
+        @remarks
+            Use this after changing a material in a way which does not alter the
+            hash of its passes, such as making it transparent, while it is used
+            by a queue group with RenderQueueGroup::setCommandListEnabled.
+        */
+        void invalidateRenderCommandLists(void);
 
         /** Get the rendersystem subclass to which the output of this Scene Manager
             gets sent
@@ -70,8 +70,6 @@ namespace Ogre {
     protected:
         ObjectMap mObjectsByName;
 
-        /// Pointer to a Wire Bounding Box for this Node
-        WireBoundingBox *mWireBoundingBox;
         /// Flag that determines if the bounding box of the node should be displayed
         bool mShowBoundingBox;
         bool mHideBoundingBox;
@@ -111,6 +109,8 @@ namespace Ogre {
         Vector3 mAutoTrackLocalDirection;
         /// Is this node a current part of the scene graph?
         bool mIsInSceneGraph;
+        /// Index in the scene node list of the creator, for removal in constant time
+        size_t mGlobalIndex;
     public:
         /** Constructor, only to be called by the creator SceneManager.
         @remarks
@@ -216,6 +216,22 @@ namespace Ogre {
             VisibleObjectsBoundsInfo* visibleBounds, 
             bool includeChildren = true, bool displayNodes = false, bool onlyShadowCasters = false);
 
+        /** Internal method which collects this node and all its descendants whose bounds are
+            visible to the camera, in the order _findVisibleObjects would visit them.
+        @remarks
+            Only reads the scene graph, so it may be called for disjoint subtrees from
+            several threads at once once the frustum planes of the camera are up to date.
+        */
+        void _findVisibleNodes(const Camera* cam, NodeList& nodes);
+
+        /** Internal method which adds the objects attached to this node to the queue, like
+            _findVisibleObjects but without testing the bounds of the node or cascading to
+            the child nodes.
+        */
+        void _addVisibleObjects(Camera* cam, RenderQueue* queue,
+            VisibleObjectsBoundsInfo* visibleBounds,
+            bool displayNodes = false, bool onlyShadowCasters = false);
+
         /** Gets the axis-aligned bounding box of this node (and hence all subnodes).
         @remarks
             Recommended only if you are extending a SceneManager, because the bounding box returned
@@ -266,6 +282,11 @@ namespace Ogre {
         */
         SceneManager* getCreator(void) const { return mCreator; }
 
+        /// Internal method to set the index in the scene node list of the creator
+        void _setGlobalIndex(size_t index) { mGlobalIndex = index; }
+        /// Gets the index in the scene node list of the creator
+        size_t _getGlobalIndex(void) const { return mGlobalIndex; }
+
         /** This method removes and destroys the named child and all of its children.
         @remarks
             Unlike removeChild, which removes a single named child from this
@@ -307,6 +328,8 @@ namespace Ogre {
         void hideBoundingBox(bool bHide) { mHideBoundingBox = bHide; }
 
         /** Add the bounding box to the rendering queue.
+        @remarks
+            The box is drawn by the DebugDrawer of the creator, along with the other boxes.
         */
         void _addBoundingBoxToQueue(RenderQueue* queue);
 
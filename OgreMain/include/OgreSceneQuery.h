@@ -207,6 +207,10 @@ namespace Ogre {
         /// List of world fragments
         SceneQueryResultWorldFragmentList worldFragments;
     };
+    /// Movable objects found by a query, in a buffer owned by the caller
+    typedef vector<MovableObject*>::type SceneQueryResultMovableVector;
+    /// Where the results of each query of a batch start in the results buffer
+    typedef vector<size_t>::type SceneQueryBatchOffsets;
 
     /** Abstract class defining a query which returns single results from a region. 
     @remarks
@@ -241,6 +245,20 @@ namespace Ogre {
             which returns the results as a collection.
         */
         virtual void execute(SceneQueryListener* listener) = 0;
+
+        /** Executes the query, writing the movable objects found into a buffer
+            owned by the caller.
+        @remarks
+            The buffer is cleared first but keeps its capacity, so once it has
+            grown a query allocates nothing. World fragments are not returned.
+        @par
+            The queries of the scene managers only read the scene, so separate
+            query objects may be executed at the same time from several
+            threads, as long as nothing changes the scene meanwhile and
+            OGRE_THREAD_SUPPORT is enabled. A single query object must not be
+            used from several threads at once.
+        */
+        virtual void execute(SceneQueryResultMovableVector& results);
         
         /** Gets the results of the last query that was run using this object, provided
             the query was executed using the collection-returning version of execute. 
@@ -258,6 +276,10 @@ namespace Ogre {
         bool queryResult(MovableObject* first);
         /** Self-callback in order to deal with execute which returns collection. */
         bool queryResult(SceneQuery::WorldFragment* fragment);
+
+    protected:
+        /// Run the query, adding the movable objects found to the end of the buffer
+        void appendResults(SceneQueryResultMovableVector& results);
     };
 
     /** Specialises the SceneQuery class for querying within an axis aligned box. */
@@ -275,6 +297,16 @@ namespace Ogre {
         /** Gets the box which is being used for this query. */
         const AxisAlignedBox& getBox(void) const;
 
+        /** Runs the query for each of several boxes, writing the results into
+            buffers owned by the caller.
+        @remarks
+            The results of boxes[i] are results[offsets[i]] up to
+            results[offsets[i + 1]], offsets gets count + 1 entries. Both
+            buffers keep their capacity, see RegionSceneQuery::execute. The box
+            of the query is left unchanged.
+        */
+        void executeBatch(const AxisAlignedBox* boxes, size_t count,
+            SceneQueryResultMovableVector& results, SceneQueryBatchOffsets& offsets);
     };
 
     /** Specialises the SceneQuery class for querying within a sphere. */
@@ -291,6 +323,13 @@ namespace Ogre {
         /** Gets the sphere which is being used for this query. */
         const Sphere& getSphere() const;
 
+        /** Runs the query for each of several spheres, writing the results into
+            buffers owned by the caller.
+        @remarks
+            Same as AxisAlignedBoxSceneQuery::executeBatch.
+        */
+        void executeBatch(const Sphere* spheres, size_t count,
+            SceneQueryResultMovableVector& results, SceneQueryBatchOffsets& offsets);
     };
 
     /** Specialises the SceneQuery class for querying within a plane-bounded volume. 
@@ -425,6 +464,24 @@ namespace Ogre {
         */
         virtual void execute(RaySceneQueryListener* listener) = 0;
 
+        /** Executes the query, writing the results into a buffer owned by the
+            caller, sorted and limited as set by setSortByDistance.
+        @remarks
+            The buffer keeps its capacity, see RegionSceneQuery::execute, which
+            also describes when queries may run from several threads.
+        */
+        virtual void execute(RaySceneQueryResult& results);
+
+        /** Runs the query for each of several rays, writing the results into
+            buffers owned by the caller.
+        @remarks
+            The results of rays[i] are results[offsets[i]] up to
+            results[offsets[i + 1]], each sorted and limited as set by
+            setSortByDistance. The ray of the query is left unchanged.
+        */
+        void executeBatch(const Ray* rays, size_t count,
+            RaySceneQueryResult& results, SceneQueryBatchOffsets& offsets);
+
         /** Gets the results of the last query that was run using this object, provided
             the query was executed using the collection-returning version of execute. 
         */
@@ -442,9 +499,11 @@ namespace Ogre {
         /** Self-callback in order to deal with execute which returns collection. */
         bool queryResult(SceneQuery::WorldFragment* fragment, Real distance);
 
-
-
-
+    protected:
+        /// Run the query, adding the results to the end of the buffer
+        void appendResults(RaySceneQueryResult& results);
+        /// Sort and limit the results from the given one on, see setSortByDistance
+        void sortResults(RaySceneQueryResult& results, size_t first) const;
     };
 
     /** Alternative listener class for dealing with IntersectionSceneQuery.
@@ -0,0 +1,135 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __Screen_Space_Error_Lod_Strategy_H__
+#define __Screen_Space_Error_Lod_Strategy_H__
+
+#include "OgrePrerequisites.h"
+
+#include "OgreLodStrategy.h"
+#include "OgreSingleton.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup LOD
+    *  @{
+    */
+
+    /** Level of detail strategy based on the projected geometric error of the LOD levels.
+    @remarks
+        The user values of the LOD levels are the geometric error of each level in
+        object space, i.e. how far the reduced surface may be from the original one.
+        The MeshLodGenerator fills them in from the edges it collapsed when it is
+        given this strategy. A level is used as long as its error projects to no more
+        than the pixel tolerance on screen.
+    @par
+        To avoid popping back and forth at the switching points, a level is only left
+        once the projected error is off by more than the hysteresis. A triangle budget
+        can be set to limit the triangles drawn by all entities using this strategy,
+        the tolerance is then raised until the budget is met. The budget is measured
+        over a whole frame, so it takes effect from the next frame on.
+    */
+    class _OgreExport ScreenSpaceErrorLodStrategy : public LodStrategy, public Singleton<ScreenSpaceErrorLodStrategy>
+    {
+    protected:
+        /// @copydoc LodStrategy::getValueImpl
+        Real getValueImpl(const MovableObject *movableObject, const Camera *camera) const;
+
+    public:
+        /** Default constructor. */
+        ScreenSpaceErrorLodStrategy();
+
+        /// @copydoc LodStrategy::getBaseValue
+        Real getBaseValue() const;
+
+        /// @copydoc LodStrategy::transformBias
+        Real transformBias(Real factor) const;
+
+        /// @copydoc LodStrategy::getIndex
+        ushort getIndex(Real value, const Mesh::MeshLodUsageList& meshLodUsageList) const;
+
+        /// @copydoc LodStrategy::getIndex
+        ushort getIndex(Real value, const Material::LodValueList& materialLodValueList) const;
+
+        /// @copydoc LodStrategy::getMeshLodIndex
+        ushort getMeshLodIndex(Real value, const Mesh* mesh, ushort previousIndex) const;
+
+        /// @copydoc LodStrategy::sort
+        void sort(Mesh::MeshLodUsageList& meshLodUsageList) const;
+
+        /// @copydoc LodStrategy::isSorted
+        bool isSorted(const Mesh::LodValueList& values) const;
+
+        /** Sets the error in pixels which is tolerated on screen (default 1). */
+        void setPixelTolerance(Real pixels) { mPixelTolerance = pixels; }
+        /** Gets the error in pixels which is tolerated on screen. */
+        Real getPixelTolerance() const { return mPixelTolerance; }
+
+        /** Sets how much the projected error has to be off before the level changes.
+        @param hysteresis
+            Fraction of the switching value, 0.1 (the default) switches to a coarser
+            level at 110% of its error and back at 90%. 0 disables the hysteresis.
+        */
+        void setHysteresis(Real hysteresis) { mHysteresis = hysteresis; }
+        /** Gets how much the projected error has to be off before the level changes. */
+        Real getHysteresis() const { return mHysteresis; }
+
+        /** Sets the maximum number of triangles to draw per frame, 0 (the default) for no limit. */
+        void setTriangleBudget(size_t triangles);
+        /** Gets the maximum number of triangles to draw per frame. */
+        size_t getTriangleBudget() const { return mTriangleBudget; }
+
+        /** Gets the factor the pixel tolerance is currently raised by to meet the triangle budget. */
+        Real getBudgetBias() const { return mBudgetBias; }
+
+        /// @copydoc Singleton::getSingleton()
+        static ScreenSpaceErrorLodStrategy& getSingleton(void);
+        /// @copydoc Singleton::getSingleton()
+        static ScreenSpaceErrorLodStrategy* getSingletonPtr(void);
+
+    protected:
+        Real mPixelTolerance;
+        Real mHysteresis;
+        size_t mTriangleBudget;
+
+        /// Budget accounting, updated while the LOD of the objects is evaluated
+        mutable Real mBudgetBias;
+        mutable size_t mFrameTriangles;
+        mutable unsigned long mFrameNumber;
+
+        /// Adapt the budget bias to the triangles of the previous frame once a new frame started
+        void updateBudget() const;
+    };
+    /** @} */
+    /** @} */
+
+} // namespace
+
+#endif
@@ -201,6 +201,9 @@ namespace Ogre
         typedef SharedPtr<Error> ErrorPtr;
         typedef list<ErrorPtr>::type ErrorList;
 
+        // Fingerprints of the top-level objects of a script, by class and name
+        typedef map<String,uint32>::type ObjectHashMap;
+
         // These are the built-in error codes
         enum{
             CE_STRINGEXPECTED,
@@ -235,6 +238,27 @@ namespace Ogre
         AbstractNodeListPtr _generateAST(const String &str, const String &source, bool doImports = false, bool doObjects = false, bool doVariables = false);
         /// Compiles the given abstract syntax tree
         bool _compile(AbstractNodeListPtr nodes, const String &group, bool doImports = true, bool doObjects = true, bool doVariables = true);
+        /** Compiles resources from the given concrete node list like compile, and
+            serialises the abstract syntax tree for _compileSerialisedAST.
+        @return The tree after processing imports, object inheritance and variables,
+            or an empty pointer if the script can not be cached because it imports
+            other scripts or has errors
+        */
+        MemoryDataStreamPtr _compileAndSerialiseAST(const ConcreteNodeListPtr &nodes, const String &group);
+        /** Compiles resources from a tree serialised by _compileAndSerialiseAST
+        @return false if the tree refers to object classes unknown to this compiler,
+            nothing is compiled then
+        */
+        bool _compileSerialisedAST(const MemoryDataStreamPtr &ast, const String &group);
+        /** Compiles resources from the given concrete node list like compile, and
+            replaces the given fingerprints with those of its objects.
+        @param reload If true only the objects whose fingerprint changed are
+            translated, and existing materials and GPU programs are updated in
+            place instead of being created, see ScriptCompilerManager::reloadScript
+        @return The number of objects which were translated
+        */
+        size_t _compileChangedObjects(const ConcreteNodeListPtr &nodes, const String &group,
+            ObjectHashMap &hashes, bool reload);
         /// Adds the given error to the compiler's list of errors
         void addError(uint32 code, const String &file, int line, const String &msg = "");
         /// Sets the listener used by the compiler
@@ -270,6 +294,12 @@ namespace Ogre
 
     private: // Tree processing
         AbstractNodeListPtr convertToAST(const ConcreteNodeListPtr &nodes);
+        /// Converts the nodes to an AST and processes imports, object inheritance and variables
+        AbstractNodeListPtr processConcreteNodes(const ConcreteNodeListPtr &nodes, const String &group);
+        /// Translates the processed AST into resources
+        bool translate(const AbstractNodeListPtr &ast);
+        /// Reads a list of nodes written by writeNodes, returns false if it is invalid
+        bool readNodes(DataStream &stream, AbstractNodeList &nodes, AbstractNode *parent);
         /// This built-in function processes import nodes
         void processImports(AbstractNodeListPtr &nodes);
         /// Loads the requested script and converts it to an AST
@@ -286,6 +316,10 @@ namespace Ogre
         bool isNameExcluded(const String &cls, AbstractNode *parent);
         /// This function sets up the initial values in word id map
         void initWordMap();
+        /// Returns the existing material or GPU program a creation event asks for while reloading
+        bool reuseResource(ScriptCompilerEvent *evt, void *retval);
+        /// Reloads the loaded resources which were reused by the last translated object
+        void reloadReusedResources();
     private:
         // Resource group
         String mGroup;
@@ -312,6 +346,14 @@ namespace Ogre
 
         // The listener
         ScriptCompilerListener *mListener;
+
+        // Whether creation events reuse existing resources, set by _compileChangedObjects
+        bool mReloading;
+        // The loaded materials reused while translating the current object
+        vector<Material*>::type mReusedMaterials;
+        // The programs reused while translating the current object, with their settings before
+        typedef vector<std::pair<GpuProgram*, String> >::type ReusedProgramList;
+        ReusedProgramList mReusedPrograms;
     private: // Internal helper classes and processors
         class AbstractTreeBuilder
         {
@@ -418,6 +460,43 @@ namespace Ogre
 
         // A pointer to the specific compiler instance used
         OGRE_THREAD_POINTER(ScriptCompiler, mScriptCompiler);
+
+        // Whether the ASTs of compiled scripts are stored in the cache
+        bool mSaveCompiledScriptsToCache;
+        // Whether the cache changed since it was loaded
+        bool mScriptCacheDirty;
+
+        // An AST serialised by ScriptCompiler, along with the hash of its script
+        struct CachedScript
+        {
+            uint32 hash;
+            MemoryDataStreamPtr ast;
+        };
+        typedef map<String, CachedScript>::type ScriptCacheMap;
+        ScriptCacheMap mScriptCache;
+        // Guards the cache, which prepareScript reads from worker threads
+        OGRE_WQ_MUTEX(mScriptCacheMutex);
+
+        // Whether the fingerprints of the objects of compiled scripts are kept
+        bool mScriptReloadingEnabled;
+        typedef map<String, ScriptCompiler::ObjectHashMap>::type ObjectHashesMap;
+        ObjectHashesMap mObjectHashes;
+
+        // The result of prepareScript
+        struct PreparedNodes : public PreparedScript
+        {
+            uint32 hash;
+            MemoryDataStreamPtr cachedAST;
+            ConcreteNodeListPtr nodes;
+        };
+
+        /// Returns the compiler of the calling thread, with the listener set
+        ScriptCompiler* getThreadCompiler();
+        /// Returns the cached AST of the script, if its hash matches
+        MemoryDataStreamPtr getCachedAST(const String& name, uint32 hash);
+        /// Compiles the script from the cache or from its nodes, parsing them if not given
+        void compileScript(const String& name, uint32 hash, const MemoryDataStreamPtr& cachedAST,
+            ConcreteNodeListPtr nodes, DataStreamPtr& stream, const String& groupName);
     public:
         ScriptCompilerManager();
         virtual ~ScriptCompilerManager();
@@ -455,9 +534,74 @@ namespace Ogre
         const StringVector& getScriptPatterns(void) const;
         /// @copydoc ScriptLoader::parseScript
         void parseScript(DataStreamPtr& stream, const String& groupName);
+        /// Lexes and parses the script into its concrete syntax tree
+        PreparedScriptPtr prepareScript(DataStreamPtr& stream);
+        /// Compiles the concrete syntax tree made by prepareScript
+        void parsePreparedScript(DataStreamPtr& stream, const String& groupName,
+            const PreparedScriptPtr& prepared);
         /// @copydoc ScriptLoader::getLoadingOrder
         Real getLoadingOrder(void) const;
 
+        /** Get if the ASTs of compiled scripts should be saved to a cache
+        */
+        bool getSaveCompiledScriptsToCache() const;
+        /** Set if the ASTs of compiled scripts should be saved to a cache
+        @remarks
+            A script whose text did not change since it was cached is compiled
+            from its AST after import, object inheritance and variable processing,
+            skipping the lexer, parser and that processing. Scripts which import
+            others are not cached. ScriptCompilerListener::preConversion is not
+            called for scripts compiled from the cache.
+        */
+        void setSaveCompiledScriptsToCache(bool val);
+        /** Returns true if the script cache changed during the run.
+        */
+        bool isScriptCacheDirty() const;
+        /** Saves the script cache to disk.
+        @param stream The destination stream
+        */
+        void saveScriptCache(DataStreamPtr stream) const;
+        /** Loads the script cache from disk.
+        @param stream The source stream
+        */
+        void loadScriptCache(DataStreamPtr stream);
+
+        /** Get if the fingerprints of the objects of compiled scripts are kept for reloadScript
+        */
+        bool getScriptReloadingEnabled() const;
+        /** Set if the fingerprints of the objects of compiled scripts are kept for reloadScript
+        @remarks
+            The fingerprint of an object is taken after import, object inheritance
+            and variable processing, so objects depending on a changed abstract
+            object or variable are seen as changed too. While enabled, the script
+            cache is not used.
+        */
+        void setScriptReloadingEnabled(bool val);
+        /** Compiles a script again, updating only the objects which changed since it was compiled.
+        @remarks
+            This is meant to be called by a file watcher of the application when
+            it sees a script change. Materials and GPU programs which changed are
+            updated in place, so the entities and passes referring to them see
+            the changes. A changed material is rebuilt as a whole and reloaded
+            if it was loaded. A changed program is only reloaded if its source
+            file or parameters changed, otherwise it keeps its compiled code.
+            Changes to other objects, such as compositors or particle systems,
+            are logged and ignored, those need their resource group reloaded.
+            Objects removed from the script are not removed from their managers.
+        @par
+            Techniques generated from materials, for instance by the RTShader
+            system, are not regenerated here, the application has to invalidate
+            them for the reloaded materials.
+        @note
+            If the object fingerprints of the script were not kept, all its
+            objects are updated. Throws if the script can not be parsed, nothing
+            is updated then.
+        @param stream The new script
+        @param groupName The resource group the script was compiled into
+        @return The number of objects which were updated or created
+        */
+        size_t reloadScript(DataStreamPtr& stream, const String& groupName);
+
         /// @copydoc Singleton::getSingleton()
         static ScriptCompilerManager& getSingleton(void);
         /// @copydoc Singleton::getSingleton()
@@ -869,6 +1013,19 @@ namespace Ogre
         // Support for subroutine
         ID_SUBROUTINE,
 
+        // Compute composition passes
+        ID_IMAGE,
+        ID_THREAD_GROUP_SIZE,
+        ID_DYNAMIC_RESOLUTION,
+
+        // Load and store actions of target passes
+        ID_LOAD_ACTION,
+        ID_STORE_ACTION,
+        ID_LOAD,
+        ID_DONT_CARE,
+        ID_STORE,
+        ID_DISCARD,
+
         ID_END_BUILTIN_IDS
     };
     /** @} */
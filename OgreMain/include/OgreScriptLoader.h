@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreDataStream.h"
 #include "OgreStringVector.h"
+#include "OgreSharedPtr.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
@@ -41,6 +42,18 @@ namespace Ogre {
     /** \addtogroup General
     *  @{
     */
+    /** Result of ScriptLoader::prepareScript.
+    @remarks
+        Script loaders which prepare scripts derive their own type from this,
+        holding whatever parsePreparedScript needs.
+    */
+    class _OgreExport PreparedScript : public ScriptingAllocatedObject
+    {
+    public:
+        virtual ~PreparedScript() {}
+    };
+    typedef SharedPtr<PreparedScript> PreparedScriptPtr;
+
     /** Abstract class defining the interface used by classes which wish 
         to perform script loading to define instances of whatever they manage.
     @remarks
@@ -77,6 +90,31 @@ namespace Ogre {
         */
         virtual void parseScript(DataStreamPtr& stream, const String& groupName) = 0;
 
+        /** Does the part of parsing a script file which depends neither on other scripts
+            nor on the state of this loader, so that it can run for several files at once.
+        @remarks
+            ResourceGroupManager calls this from worker threads, with a stream which
+            is safe to read from any thread, and afterwards passes the result to
+            parsePreparedScript in loading order. The default prepares nothing.
+        @param stream The stream of the script, its position is undefined afterwards
+        @return The preparation, or a null pointer if the script is to be parsed
+            by parseScript as a whole
+        */
+        virtual PreparedScriptPtr prepareScript(DataStreamPtr& stream) { return PreparedScriptPtr(); }
+
+        /** Parse a script file which was prepared by prepareScript.
+        @remarks
+            The default ignores the preparation and calls parseScript.
+        @param stream The stream of the script, rewound to the start
+        @param groupName See parseScript
+        @param prepared The result of prepareScript
+        */
+        virtual void parsePreparedScript(DataStreamPtr& stream, const String& groupName,
+            const PreparedScriptPtr& prepared)
+        {
+            parseScript(stream, groupName);
+        }
+
         /** Gets the relative loading order of scripts of this type.
         @remarks
             There are dependencies between some kinds of scripts, and to enforce
@@ -69,6 +69,19 @@ namespace Ogre {
         /// Function to implement -- must set the shadow camera properties
         virtual void getShadowCamera (const SceneManager *sm, const Camera *cam, 
                                       const Viewport *vp, const Light *light, Camera *texCam, size_t iteration) const = 0;
+        /** Returns whether the shadow texture of an iteration has to be rendered this frame.
+        @remarks
+            A setup may have some shadow textures refreshed only every few frames.
+            The scene manager then keeps the texture along with the matrices it
+            was rendered with, which the receivers go on using, and getShadowCamera
+            is not called for it.
+        @param iteration The iteration of the shadow texture, as in getShadowCamera
+        @param lightIndex The index of the light among the shadow casting lights, so
+            that the updates of several lights may be spread over the frames
+        @param frameNumber The number of the frame being rendered
+        */
+        virtual bool isShadowCameraUpdateDue(size_t iteration, size_t lightIndex,
+            unsigned long frameNumber) const { return true; }
         /// Need virtual destructor in case subclasses use it
         virtual ~ShadowCameraSetup() {}
 
@@ -141,6 +141,7 @@ namespace Ogre {
 
         // Persistent calculations to prevent reallocation
         mutable ConvexBody mBodyB;
+        mutable ConvexBody mBodyLVS;
         mutable PointListBody mPointListBodyB;
         mutable PointListBody mPointListBodyLVS;
 
@@ -52,6 +52,12 @@ namespace Ogre
         Because PSSM uses multiple shadow maps per light, you will need to increase
         the number of shadow textures available (via SceneManager) to match the 
         number of shadow maps required (default is 3 per light). 
+    @par
+        With stable cascades, the splits of directional lights are orthographic
+        projections of a fixed size around the bounding sphere of the split,
+        moved by whole texels only. This trades some resolution for shadow
+        edges which do not crawl as the view moves and turns, and it lets the
+        far splits be refreshed less often, see setSplitUpdateInterval.
     */
     class _OgreExport PSSMShadowCameraSetup : public LiSPSMShadowCameraSetup
     {
@@ -65,6 +71,9 @@ namespace Ogre
         SplitPointList mSplitPoints;
         OptimalAdjustFactorList mOptimalAdjustFactors;
         Real mSplitPadding;
+        /// Frames between the updates of each split
+        vector<uint32>::type mSplitUpdateIntervals;
+        bool mStableCascades;
 
         mutable size_t mCurrentIteration;
 
@@ -106,10 +115,47 @@ namespace Ogre
         /// Get the number of splits. 
         uint getSplitCount() const { return mSplitCount; }
 
+        /** Sets whether the splits of directional lights use stable, texel snapped
+            orthographic projections instead of LiSPSM.
+        */
+        void setStableCascades(bool stable) { mStableCascades = stable; }
+        /// Gets whether the splits of directional lights use stable projections.
+        bool getStableCascades() const { return mStableCascades; }
+
+        /** Sets every how many frames the shadow texture of a split is rendered
+            (call after configuring splits).
+        @remarks
+            The far splits cover large areas which change little from one frame
+            to the next, so refreshing them every few frames saves much of the
+            shadow rendering. In between, the texture and the matrices it was
+            rendered with are kept, so the receivers stay consistent with it.
+            The frames are staggered by split and by light, so that splits and
+            lights with the same interval are refreshed in turn. Changes of the
+            light or the casters show up in a split up to interval - 1 frames
+            late, and the kept projection has to still cover the split, which
+            suits stable cascades as long as the view does not move by a good
+            part of the split per frame.
+        @par
+            Textures are kept only while their light and view camera stay the
+            same and the shadow texture atlas is not used. The shadow textures
+            must not be shared with another scene manager rendering shadows in
+            between.
+        @param splitIndex The split
+        @param frames Every how many frames to render the split, 1 for each frame
+        */
+        void setSplitUpdateInterval(size_t splitIndex, uint32 frames);
+        /// Gets every how many frames the shadow texture of a split is rendered.
+        uint32 getSplitUpdateInterval(size_t splitIndex) const
+        { return mSplitUpdateIntervals[splitIndex]; }
+
         /// Returns a LiSPSM shadow camera with PSSM splits base on iteration.
         virtual void getShadowCamera(const Ogre::SceneManager *sm, const Ogre::Camera *cam,
             const Ogre::Viewport *vp, const Ogre::Light *light, Ogre::Camera *texCam, size_t iteration) const;
 
+        /// Returns whether the split is due for an update, see setSplitUpdateInterval.
+        virtual bool isShadowCameraUpdateDue(size_t iteration, size_t lightIndex,
+            unsigned long frameNumber) const;
+
         /// Returns the calculated split points.
         inline const SplitPointList& getSplitPoints() const
         { return mSplitPoints; }
@@ -121,6 +167,11 @@ namespace Ogre
         /// Overridden, recommended internal use only since depends on current iteration
         Real getOptimalAdjustFactor() const;
 
+    protected:
+        /// Sets a stable projection of the split the view camera is clipped to on the texture camera
+        void getStableShadowCamera(const SceneManager *sm, const Camera *cam,
+            const Light *light, Camera *texCam) const;
+
     };
     /** @} */
     /** @} */
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreRenderable.h"
 #include "OgreRenderOperation.h"
+#include "OgreVector4.h"
 #include "OgreHeaderPrefix.h"
 
 
@@ -232,6 +233,44 @@ namespace Ogre {
         virtual void generateShadowVolume(EdgeData* edgeData, 
             const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize,
             const Light* light, ShadowRenderableList& shadowRenderables, unsigned long flags);
+
+        /** Indexes of a shadow volume, kept to be reused as long as the light and
+            the caster don't move relative to each other.
+        */
+        struct ShadowVolumeCache
+        {
+            ShadowVolumeCache() : edgeData(0), lightPos(Vector4::ZERO), flags(0), useMcGuire(false) {}
+
+            /// What the indexes were generated for, the light being in object space
+            const EdgeData* edgeData;
+            Vector4 lightPos;
+            unsigned long flags;
+            bool useMcGuire;
+            /// The generated indexes, copied into the index buffer whenever rendered
+            vector<unsigned short>::type indexes;
+            /// Number of indexes of each shadow renderable, followed by that of its light cap
+            vector<size_t>::type indexCounts;
+        };
+        /// Shadow volumes of a caster for each light
+        typedef map<const Light*, ShadowVolumeCache>::type ShadowVolumeCacheMap;
+
+        /** Does the same as updateEdgeListLightFacing followed by generateShadowVolume,
+            unless the volume for the light was already generated with the same object
+            space light position, in which case its indexes are copied instead.
+        @remarks
+            Only for casters whose geometry doesn't change, such as entities without
+            animation. The light facing of the edge data is not updated when the
+            volume is reused.
+        @param caches
+            The volumes of this caster, kept for a few lights.
+        @param lightPos
+            4D light position in object space, as passed to updateEdgeListLightFacing.
+        */
+        void generateShadowVolume(ShadowVolumeCacheMap& caches, const Vector4& lightPos,
+            EdgeData* edgeData, const HardwareIndexBufferSharedPtr& indexBuffer,
+            size_t& indexBufferUsedSize, const Light* light,
+            ShadowRenderableList& shadowRenderables, unsigned long flags);
+
         /** Utility method for extruding a bounding box. 
         @param box
             Original bounding box, will be updated in-place.
@@ -34,6 +34,8 @@ Torus Knot Software Ltd.
 #include "OgrePrerequisites.h"
 #include "OgreSingleton.h"
 #include "OgrePixelFormat.h"
+#include "OgreCommon.h"
+#include "OgreIteratorWrapper.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre
@@ -66,6 +68,41 @@ namespace Ogre
     _OgreExport bool operator!= ( const ShadowTextureConfig& lhs, const ShadowTextureConfig& rhs );
 
 
+    /** Assigns the shadow textures of a frame their regions of a shadow atlas.
+    @remarks
+        Region edges are rounded down to powers of two and the regions are
+        placed largest first along a Z-order curve, which walks the quadtree
+        subdivision of the atlas: regions which fit by area fit without
+        gaps. When they do not, the largest regions are halved, down to the
+        minimum region size, until they do.
+    */
+    class _OgreExport ShadowAtlasAllocator : public ShadowDataAlloc
+    {
+    protected:
+        uint32 mAtlasSize;
+        uint32 mMinRegionSize;
+
+    public:
+        ShadowAtlasAllocator(uint32 atlasSize = 4096, uint32 minRegionSize = 128);
+
+        /// Sets the edge length of the atlas, rounded down to a power of two
+        void setAtlasSize(uint32 size);
+        uint32 getAtlasSize(void) const { return mAtlasSize; }
+        /// Sets the smallest region edge length, rounded down to a power of two
+        void setMinRegionSize(uint32 size);
+        uint32 getMinRegionSize(void) const { return mMinRegionSize; }
+        /// Gets how many regions of the minimum size the atlas holds
+        size_t getMaxRegions(void) const;
+
+        /** Assigns a region to each requested size.
+        @param sizes The wanted edge length of each region, in texels
+        @param regions Receives the region for each size, in texels
+        @return false if the regions do not fit even at the minimum size,
+            the ones left over get empty rects then
+        */
+        bool allocate(const vector<uint32>::type& sizes, vector<Rect>::type& regions) const;
+    };
+
     /** Class to manage the available shadow textures which may be shared between
         many SceneManager instances if formats agree.
     @remarks
@@ -81,6 +118,7 @@ namespace Ogre
     protected:
         ShadowTextureList mTextureList;
         ShadowTextureList mNullTextureList;
+        ShadowTextureList mAtlasList;
         size_t mCount;
 
     public:
@@ -93,6 +131,13 @@ namespace Ogre
         virtual void getShadowTextures(const ShadowTextureConfigList& config, 
             ShadowTextureList& listToPopulate);
 
+        /** Get a shadow atlas texture as requested in the configuration.
+        @remarks
+            Atlases are kept apart from the other shadow textures, as their
+            viewports are laid out by the scene managers using them.
+        */
+        virtual TexturePtr getShadowAtlas(const ShadowTextureConfig& config);
+
         /** Get an appropriately defined 'null' texture, i.e. one which will always
             result in no shadows.
         */
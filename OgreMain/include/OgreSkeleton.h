@@ -314,6 +314,17 @@ namespace Ogre {
         */
         virtual void optimiseAllAnimations(bool preservingIdentityNodeTracks = false);
 
+        /** Remove the keyframes of all of this skeleton's animations which 
+            interpolating their neighbours reproduces within the given tolerances.
+        @remarks
+            Meant for sampled animation such as motion capture, applied when
+            converting it or right after loading.
+        @see NodeAnimationTrack::reduceKeyFrames
+        @return The number of keyframes removed
+        */
+        virtual size_t reduceAllAnimations(Real positionTolerance, const Radian& orientationTolerance,
+            Real scaleTolerance);
+
         /** Allows you to use the animations from another Skeleton object to animate
             this skeleton.
         @remarks
@@ -0,0 +1,136 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SkeletonAnimationCache_H__
+#define __SkeletonAnimationCache_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreMatrix4.h"
+#include "Threading/OgreThreadHeaders.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Shares the evaluated bone matrices of entities which play the same
+        animations at the same time.
+    @remarks
+        Entities created from the same skeleton and playing the same animation
+        states (e.g. a crowd, or synchronised idle loops) all compute identical
+        bone matrices every frame. Entities given the same cache through
+        Entity::setSkeletonAnimationCache only evaluate their skeleton when no
+        other entity of the cache has evaluated that pose during the current frame;
+        otherwise the matrices are copied from the first one.
+    @par
+        A pose is identified by the skeleton, and the animation, time position,
+        weight and blend mask of each enabled animation state. Time positions can
+        be quantised with setTimeQuantum, so states which are only slightly apart
+        share the pose of whichever entity was updated first.
+    @par
+        On a cache hit the bones of the SkeletonInstance are not updated. Entities
+        with objects attached to bones, manually controlled bones or a displayed
+        skeleton therefore always evaluate their own skeleton.
+    */
+    class _OgreExport SkeletonAnimationCache : public AnimationAlloc
+    {
+    public:
+        /** Constructor.
+        @param timeQuantum Time positions closer than this are considered equal,
+            0 to share poses only for identical time positions.
+        */
+        SkeletonAnimationCache(Real timeQuantum = 0);
+        ~SkeletonAnimationCache();
+
+        /// Sets the quantum time positions are rounded to, 0 to disable
+        void setTimeQuantum(Real timeQuantum) { mTimeQuantum = timeQuantum; }
+        /// Gets the quantum time positions are rounded to
+        Real getTimeQuantum(void) const { return mTimeQuantum; }
+
+        /** Gets the bone matrices for an animation state set.
+        @remarks
+            Copies the matrices of the pose if it was already evaluated during this
+            frame, otherwise applies the animation states to the skeleton instance
+            and records its bone matrices.
+        @param skeleton The master skeleton the instance was created from.
+        @param instance The skeleton instance to evaluate on a cache miss.
+        @param animSet The animation states to apply.
+        @param boneMatrices Receives the bone matrices, one per bone.
+        @param frameNumber The current frame, the cache is emptied whenever it changes.
+        @return Whether the matrices were found in the cache.
+        */
+        bool _getBoneMatrices(const Skeleton* skeleton, SkeletonInstance* instance,
+            const AnimationStateSet& animSet, Matrix4* boneMatrices, unsigned long frameNumber);
+
+        /// Empties the cache
+        void clear(void);
+
+        /// Number of poses evaluated during the current frame
+        size_t getNumEntries(void) const { return mEntries.size(); }
+        /// Number of cache hits during the current frame
+        size_t getNumHits(void) const { return mNumHits; }
+
+    protected:
+        /// A pose evaluated during the current frame
+        struct Entry
+        {
+            uint32 hash;
+            /// Range of the identifying key in mKeys
+            size_t keyOffset;
+            size_t keySize;
+            /// First matrix in mBoneMatrices
+            size_t boneMatrixOffset;
+        };
+        typedef vector<Entry>::type EntryList;
+        EntryList mEntries;
+        vector<uint32>::type mKeys;
+        vector<Matrix4>::type mBoneMatrices;
+        /// Key of the pose being looked up
+        vector<uint32>::type mCurrentKey;
+
+        Real mTimeQuantum;
+        unsigned long mFrameNumber;
+        size_t mNumHits;
+        OGRE_WQ_MUTEX(mMutex);
+
+        /// Builds the key identifying a pose in mCurrentKey
+        void buildKey(const Skeleton* skeleton, SkeletonInstance* instance,
+            const AnimationStateSet& animSet);
+    };
+
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
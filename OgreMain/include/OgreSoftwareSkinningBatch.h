@@ -0,0 +1,156 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SoftwareSkinningBatch_H__
+#define __SoftwareSkinningBatch_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Collects the software skinning of many meshes, to skin them all at once in
+        parallel.
+    @remarks
+        Mesh::softwareVertexBlend locks the buffers, skins the vertices and unlocks
+        the buffers again. A batch does the locking when a blend is added, since
+        buffers must only be locked on the rendering thread, and defers the skinning
+        to flush, which spreads the vertices of all blends over the worker threads
+        through ParallelJob and then unlocks the buffers. Source buffers shared by
+        several blends, such as those of entities using the same mesh, are locked
+        only once.
+    @par
+        SceneManager uses one while finding the visible objects when the
+        "ParallelSoftwareSkinning" option is enabled. The buffers of the blends must
+        not be used by anything else until the batch is flushed.
+    */
+    class _OgreExport SoftwareSkinningBatch : public AnimationAlloc
+    {
+    public:
+        /// Source buffers locked for reading, with their locked memory
+        typedef map<HardwareVertexBuffer*, std::pair<HardwareVertexBufferSharedPtr, void*> >::type
+            SourceLockMap;
+
+        /// Locked buffers and layout of a single software blend
+        struct _OgreExport Blend
+        {
+            float* srcPos;
+            float* srcNorm;
+            float* destPos;
+            float* destNorm;
+            float* blendWeight;
+            unsigned char* blendIdx;
+            size_t srcPosStride;
+            size_t srcNormStride;
+            size_t destPosStride;
+            size_t destNormStride;
+            size_t blendWeightStride;
+            size_t blendIdxStride;
+            unsigned short numWeightsPerVertex;
+            size_t vertexCount;
+            /// Index of the first blend matrix in the matrices of the batch
+            size_t matrixOffset;
+
+            /** Lock the buffers, see Mesh::softwareVertexBlend for the parameters.
+            @param sourceLocks
+                If given, source buffers are looked up here and only locked if missing,
+                so blends reading the same mesh share one lock. They are left locked
+                for the owner of the map to unlock, unlock only releases the target
+                buffers then.
+            */
+            void lock(const VertexData* sourceVertexData, const VertexData* targetVertexData,
+                bool blendNormals, SourceLockMap* sourceLocks = 0);
+            /// Skin the vertices [begin, end), may be called from any thread
+            void skin(const Matrix4* const* blendMatrices, size_t begin, size_t end) const;
+            /// Unlock the buffers locked by lock
+            void unlock();
+
+        protected:
+            HardwareVertexBufferSharedPtr mLocked[6];
+            size_t mNumLocked;
+
+            void lockBuffer(const HardwareVertexBufferSharedPtr& buf,
+                HardwareBuffer::LockOptions options, void** pBuffer,
+                SourceLockMap* sourceLocks);
+        };
+
+        SoftwareSkinningBatch();
+        /// Flushes the remaining blends
+        ~SoftwareSkinningBatch();
+
+        /** Add a software blend to the batch.
+        @remarks
+            Does the same as Mesh::softwareVertexBlend, except that the vertices are
+            skinned by flush. The blend matrices are copied, the matrices they point to
+            must stay unchanged until then.
+        */
+        void addBlend(const VertexData* sourceVertexData, const VertexData* targetVertexData,
+            const Matrix4* const* blendMatrices, size_t numMatrices, bool blendNormals);
+
+        /// Skin the vertices of all blends added and unlock their buffers
+        void flush();
+
+        /// Returns whether there are blends waiting for flush
+        bool isEmpty() const { return mBlends.empty(); }
+        /// Number of vertices waiting for flush
+        size_t getVertexCount() const { return mVertexCount; }
+
+        /** Number of vertices skinned by one work item (default 256).
+        @remarks
+            Blends are split into items of this size, so the vertices of a single
+            large mesh are spread over the workers too.
+        */
+        void setVerticesPerItem(size_t count) { mVerticesPerItem = count ? count : 1; }
+        /// Get the number of vertices skinned by one work item
+        size_t getVerticesPerItem() const { return mVerticesPerItem; }
+
+    protected:
+        typedef vector<Blend>::type BlendList;
+        BlendList mBlends;
+        /// Source buffers of all blends, each locked once
+        SourceLockMap mSourceLocks;
+        typedef vector<const Matrix4*>::type MatrixList;
+        MatrixList mMatrices;
+        size_t mVertexCount;
+        size_t mVerticesPerItem;
+    };
+
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
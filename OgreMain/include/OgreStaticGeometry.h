@@ -166,6 +166,8 @@ namespace Ogre {
             Vector3 scale;
             /// Pre-transformed world AABB 
             AxisAlignedBox worldBounds;
+            /// Entity this was queued from, only used to identify it (never dereferenced)
+            const Entity* source;
         };
         typedef vector<QueuedSubMesh*>::type QueuedSubMeshList;
         /// Structure recording a queued geometry for low level builds
@@ -177,6 +179,8 @@ namespace Ogre {
             Vector3 scale;
         };
         typedef vector<QueuedGeometry*>::type QueuedGeometryList;
+        /// Source buffers locked for reading during a build, each one once
+        typedef map<HardwareBuffer*, uchar*>::type SourceLockMap;
         
         // forward declarations
         class LODBucket;
@@ -206,6 +210,11 @@ namespace Ogre {
             HardwareIndexBuffer::IndexType mIndexType;
             /// Maximum vertex indexable
             size_t mMaxVertexIndex;
+            /// Destination index & vertex buffer locks, only valid during a build
+            uchar* mIndexLock;
+            vector<uchar*>::type mVertexLocks;
+            /// Vertex elements of each destination buffer, only valid during a build
+            vector<VertexDeclaration::VertexElementList>::type mBufferElements;
 
             template<typename T>
             void copyIndexes(const T* src, T* dst, size_t count, size_t indexOffset)
@@ -246,6 +255,18 @@ namespace Ogre {
             bool assign(QueuedGeometry* qsm);
             /// Build
             void build(bool stencilShadows);
+            /// First step of build, creates and locks the buffers (internal use)
+            void _createBuffers(bool stencilShadows);
+            /// Locks the source buffers which are not in the map yet (internal use)
+            void _lockSources(SourceLockMap& locks) const;
+            /** Transforms the geometry into the locked buffers (internal use)
+            @remarks
+                Touches nothing but the buffers of this bucket, so buckets can
+                be filled from several threads at once.
+            */
+            void _copyGeometry(const SourceLockMap& locks);
+            /// Last step of build, unlocks the buffers (internal use)
+            void _finishBuild(bool stencilShadows);
             /// Dump contents for diagnostics
             void dump(std::ofstream& of) const;
         };
@@ -284,6 +305,8 @@ namespace Ogre {
             void assign(QueuedGeometry* qsm);
             /// Build
             void build(bool stencilShadows);
+            /// Loads the material & creates the buffers of the geometry (internal use)
+            void _prepareBuild(bool stencilShadows, GeometryBucketList& buckets);
             /// Add children to the render queue
             void addRenderables(RenderQueue* queue, uint8 group, 
                 Real lodValue);
@@ -361,6 +384,10 @@ namespace Ogre {
             void assign(QueuedSubMesh* qsm, ushort atLod);
             /// Build
             void build(bool stencilShadows);
+            /// Prepares the materials and collects the geometry to fill (internal use)
+            void _prepareBuild(bool stencilShadows, MaterialBucket::GeometryBucketList& buckets);
+            /// Builds the edge list once the geometry is filled (internal use)
+            void _finishBuild(bool stencilShadows);
             /// Add children to the render queue
             void addRenderables(RenderQueue* queue, uint8 group, 
                 Real lodValue);
@@ -420,6 +447,8 @@ namespace Ogre {
             Real mLodValue;
             /// List of LOD buckets         
             LODBucketList mLodBucketList;
+            /// Shadow volumes kept for reuse, the geometry being static
+            ShadowVolumeCacheMap mShadowVolumeCaches;
             /// List of lights for this region
             mutable LightList mLightList;
             /// The last frame that this light list was updated in
@@ -441,6 +470,16 @@ namespace Ogre {
             void assign(QueuedSubMesh* qmesh);
             /// Build this region
             void build(bool stencilShadows);
+            /// Creates the node & buckets and collects the geometry to fill (internal use)
+            void _prepareBuild(bool stencilShadows, MaterialBucket::GeometryBucketList& buckets);
+            /// Completes the build once the geometry is filled (internal use)
+            void _finishBuild(bool stencilShadows);
+            /// Destroys the built buckets, recomputing bounds & LODs from the queue (internal use)
+            void _clearBuild(void);
+            /// Removes a queued mesh, the region must be rebuilt afterwards (internal use)
+            void _unassign(QueuedSubMesh* qmesh);
+            /// Tells whether any meshes are assigned to this region
+            bool hasQueuedSubMeshes(void) const { return !mQueuedSubMeshes.empty(); }
             /// Get the region ID of this region
             uint32 getID(void) const { return mRegionID; }
             /// Get the centre point of the region
@@ -519,6 +558,18 @@ namespace Ogre {
             
         /// Map of regions
         RegionMap mRegionMap;
+        /// Regions changed by addEntity / removeEntity since they were built
+        set<uint32>::type mDirtyRegions;
+
+        /// Builds the given regions, filling their geometry in parallel
+        void buildRegions(const vector<Region*>::type& regions);
+        /** Fills the buffers created for the given buckets and completes their build.
+        @remarks
+            Source buffers are locked once up front, then the buckets are filled
+            through parallelFor, since that touches no hardware state.
+        */
+        static void fillGeometryBuckets(const MaterialBucket::GeometryBucketList& buckets,
+            bool stencilShadows);
 
         /** Virtual method for getting a region most suitable for the
             passed in bounds. Can be overridden by subclasses.
@@ -607,7 +658,8 @@ namespace Ogre {
             completely safely, and destroy the Entity before destroying 
             this StaticGeometry if you like. The Entity passed in is simply 
             used as a definition.
-        @note Must be called before 'build'.
+        @note If called after 'build', the regions the Entity lands in are
+            only rebuilt by rebuildDirtyRegions.
         @param ent The Entity to use as a definition (the Mesh and Materials 
             referenced will be recorded for the build call).
         @param position The world position at which to add this Entity
@@ -638,18 +690,42 @@ namespace Ogre {
         */
         virtual void addSceneNode(const SceneNode* node);
 
+        /** Removes an Entity previously added to the static geometry.
+        @remarks
+            Removes everything queued by addEntity (or addSceneNode) with the
+            same Entity at the same position. The Entity is only compared, so
+            it may have been destroyed since. If called after 'build', the
+            affected regions are only rebuilt by rebuildDirtyRegions.
+        @param ent The Entity which was used as a definition
+        @param position The world position it was added at
+        */
+        virtual void removeEntity(const Entity* ent, const Vector3& position);
+
         /** Build the geometry. 
         @remarks
             Based on all the entities which have been added, and the batching 
             options which have been set, this method constructs the batched 
             geometry structures required. The batches are added to the scene 
             and will be rendered unless you specifically hide them.
+        @par
+            The buffers of all regions are created on the calling thread, but
+            the vertices are transformed and copied into them in parallel
+            (see parallelFor).
         @note
-            Once you have called this method, you can no longer add any more 
-            entities.
+            Entities added or removed afterwards only affect the regions they
+            are in, which can be rebuilt alone with rebuildDirtyRegions.
         */
         virtual void build(void);
 
+        /** Rebuilds the regions changed by addEntity / removeEntity since
+            the last build.
+        @remarks
+            The other regions and their hardware buffers are left alone, so this
+            is much cheaper than calling build again. Regions left empty are
+            destroyed. Equivalent to build if nothing was built yet.
+        */
+        virtual void rebuildDirtyRegions(void);
+
         /** Destroys all the built geometry state (reverse of build). 
         @remarks
             You can call build() again after this and it will pick up all the
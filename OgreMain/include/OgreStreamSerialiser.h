@@ -130,6 +130,35 @@ namespace Ogre
             );
         virtual ~StreamSerialiser();
 
+        /** Creates a serialiser writing into memory, which defers the compression
+            of startDeflate.
+        @remarks
+            Writing then mostly copies data, the compressed result is produced by
+            writeDeferred later on, which may be called from another thread. This
+            is what background saves are built on: objects are written into such
+            a serialiser on the thread which owns them, then a worker compresses
+            the data and writes it out. The parameters are as for the constructor.
+        @return A new serialiser, to be deleted with OGRE_DELETE
+        */
+        static StreamSerialiser* createDeferred(Endian endianMode = ENDIAN_AUTO, 
+            bool autoHeader = true, 
+#if OGRE_DOUBLE_PRECISION
+            RealStorageFormat realFormat = REAL_DOUBLE
+#else
+            RealStorageFormat realFormat = REAL_FLOAT
+#endif
+            );
+
+        /** Compresses the data of a serialiser made by createDeferred and writes
+            it to a stream.
+        @remarks
+            Each region between startDeflate and stopDeflate is compressed on its
+            own and the lengths of the chunks around it are corrected, so the result
+            is the same as if it had been written to the stream directly. All chunks
+            must have been ended. Nothing else may use this serialiser meanwhile.
+        */
+        void writeDeferred(const DataStreamPtr& stream);
+
         /** Get the endian mode.
         @remarks
             If the result is ENDIAN_AUTO, this mode will change when the first piece of
@@ -329,6 +358,18 @@ namespace Ogre
     protected:
         DataStreamPtr mStream;
         DataStreamPtr mOriginalStream;
+        /// A region to compress once written, see createDeferred
+        struct DeferredDeflate
+        {
+            size_t start;
+            /// The end of the region, 0 while it is being written
+            size_t end;
+            /// Offsets of the chunks the region is in, their lengths change when compressed
+            vector<uint32>::type chunkOffsets;
+        };
+        typedef vector<DeferredDeflate>::type DeferredDeflateList;
+        DeferredDeflateList mDeferredDeflates;
+        bool mDeflateDeferred;
         Endian mEndian;
         bool mFlipEndian;
         bool mReadWriteHeader;
@@ -173,6 +173,21 @@ namespace Ogre {
             0.0 if the value could not be parsed, otherwise the Real version of the String.
         */
         static Real parseReal(const String& val, Real defaultValue = 0);
+        /** Converts a String to a number, requiring the whole String to be the number.
+        @remarks
+            Equivalent to isNumber followed by parseReal, but scans the String once.
+        @return
+            false if the String is not a number, leaving ret unchanged.
+        */
+        static bool parseNumber(const String& val, float& ret);
+        /// @overload
+        static bool parseNumber(const String& val, double& ret);
+        /** Locale independent strtod.
+        @remarks
+            Decimal numbers with up to 19 significant digits and a small exponent are
+            converted without the C runtime, others are passed on to strtod_l.
+        */
+        static double _strtod(const char* str, char** end);
         /** Converts a String to a Angle. 
         @return
             0.0 if the value could not be parsed, otherwise the Angle version of the String.
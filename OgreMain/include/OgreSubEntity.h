@@ -107,6 +107,8 @@ namespace Ogre {
 #endif
         /// Blend buffer details for dedicated geometry
         VertexData* mSkelAnimVertexData;
+        /// Copy of the dedicated geometry skinned on the GPU instead, see GpuSkinningBatch
+        GpuSkinnedVertexData* mGpuSkinnedVertexData;
         /// Quick lookup of buffers
         TempBlendedBufferInfo mTempSkelAnimInfo;
         /// Temp buffer details for software Vertex anim geometry
@@ -117,6 +119,8 @@ namespace Ogre {
         /// - separate since we need to s/w anim for shadows whilst still altering
         ///   the vertex data for hardware morphing (pos2 binding)
         VertexData* mHardwareVertexAnimVertexData;
+        /// Vertex data with the LOD morph target bound, see SubMesh::mLodMorphTargets
+        VertexData* mLodMorphVertexData;
         /// Have we applied any vertex animation to geometry?
         bool mVertexAnimationAppliedThisFrame;
         /// Number of hardware blended poses supported by material
@@ -128,6 +132,9 @@ namespace Ogre {
 
         /** Internal method for preparing this Entity for use in animation. */
         void prepareTempBlendBuffers(void);
+        /** Internal method returning the vertex data with the morph target of the
+            LOD after lodIndex bound, or the original vertex data if there is none. */
+        VertexData* getLodMorphVertexData(VertexData* original, ushort lodIndex);
 
     public:
         /** Gets the name of the Material in use by this instance.
@@ -111,6 +111,25 @@ namespace Ogre {
         typedef vector<IndexData*>::type LODFaceList;
         LODFaceList mLodFaceList;
 
+        /** Morph targets of the generated LOD levels (optional).
+            @remarks
+                Entry k holds, for each vertex of the vertex data used by this SubMesh,
+                the position it has collapsed to at LOD level k + 1, as one float3 per
+                vertex; it is null for manual LOD levels. Entities use them to blend
+                smoothly into the next LOD, see Entity::setLodMorphRange. Submeshes
+                using the shared vertices share the same buffers.
+            @par
+                They are generated by the MeshLodGenerator on request and are not
+                serialised with the mesh.
+        */
+        typedef vector<HardwareVertexBufferSharedPtr>::type LODMorphTargetList;
+        LODMorphTargetList mLodMorphTargets;
+
+        /// Texture coordinate set the morph target of the next LOD is bound to
+        static const unsigned short LOD_MORPH_TEXCOORD;
+        /// Index of the Renderable custom parameter holding the LOD morph factor in x
+        static const size_t LOD_MORPH_CUSTOM_PARAMETER;
+
         /** A list of extreme points on the submesh (optional).
             @remarks
                 These points are some arbitrary points on the mesh that are used
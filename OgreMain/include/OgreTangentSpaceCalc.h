@@ -209,6 +209,26 @@ namespace Ogre
         typedef vector<VertexInfo>::type VertexInfoArray;
         VertexInfoArray mVertexArray;
 
+        /// A face and its tangent space, which only depends on the vertex data
+        struct FaceInfo
+        {
+            size_t indexSet;
+            size_t faceIndex;
+            size_t vertInd[3];
+            /// U and V are weighted by UV area, N is normalised
+            Vector3 tsU;
+            Vector3 tsV;
+            Vector3 tsN;
+            int parity;
+            /// Weight of the face for each of its vertices
+            Real angleWeight[3];
+        };
+        typedef vector<FaceInfo>::type FaceInfoArray;
+        /// Calculates the tangent space of faces, see processFaces
+        struct FaceTangentSpaceCalculator;
+        /// Normalises and orthogonalises vertices, see normaliseVertices
+        struct VertexNormaliser;
+
         void extendBuffers(VertexSplits& splits);
         void insertTangents(Result& res,
             VertexElementSemantic targetSemantic, 
@@ -220,8 +240,7 @@ namespace Ogre
         void calculateFaceTangentSpace(const size_t* vertInd, Vector3& tsU, Vector3& tsV, Vector3& tsN);
         Real calculateAngleWeight(size_t v0, size_t v1, size_t v2);
         int calculateParity(const Vector3& u, const Vector3& v, const Vector3& n);
-        void addFaceTangentSpaceToVertices(size_t indexSet, size_t faceIndex, size_t *localVertInd, 
-            const Vector3& faceTsU, const Vector3& faceTsV, const Vector3& faceNorm, Result& result);
+        void addFaceTangentSpaceToVertices(const FaceInfo& face, Result& result);
         void normaliseVertices();
         void remapIndexes(Result& res);
         template <typename T>
@@ -67,6 +67,9 @@ namespace Ogre {
         TU_RENDERTARGET = 32,
         /// Hint, that could be combined with TU_RENDERTARGET to remove possible limitations on some hardware
         TU_NOTSHADERRESOURCE = 64,
+        /** The texture can be written by compute programs through Texture::createShaderAccessPoint.
+            Required on D3D11 for unordered access views, may be combined with TU_RENDERTARGET */
+        TU_UNORDERED_ACCESS = 128,
         /// Default to automatic mipmap generation static textures
         TU_DEFAULT = TU_AUTOMIPMAP | TU_STATIC_WRITE_ONLY
     };
@@ -144,6 +147,83 @@ namespace Ogre {
         */
         virtual void setNumMipmaps(uint32 num) {mNumRequestedMipmaps = mNumMipmaps = num;}
 
+        /** Sets the number of the largest mipmaps of the source images which are not
+            loaded, so that the texture is smaller.
+        @remarks
+            Only applies to images which contain mipmaps, e.g. from DDS, KTX or PVR
+            files, and at least the smallest mipmap is always loaded. Takes effect
+            on the next load, the number actually skipped is returned by
+            getMipmapSkip once loaded.
+        */
+        void setMipmapSkip(uint8 skip) { mMipmapSkip = skip; }
+
+        /** Gets the number of the largest mipmaps of the source images which are not
+            loaded.
+        */
+        uint8 getMipmapSkip(void) const { return mMipmapSkip; }
+
+        /** Gets the number of the largest mipmaps of the source images which can
+            be skipped, so the texture can't get any smaller beyond that.
+        @remarks
+            Only valid once loaded. Streamed textures can't get smaller than
+            TextureManager::getMipmapStreamingInitialSize.
+        */
+        uint8 getMaxMipmapSkip(void) const { return mMaxMipmapSkip; }
+
+        /** Sets whether the mipmaps of this texture are streamed in by the TextureManager.
+        @remarks
+            A streamed texture first loads its smallest mipmaps only, up to
+            TextureManager::getMipmapStreamingInitialSize. The TextureManager then
+            reloads it with more or less mipmaps towards the desired mipmap skip,
+            within its budget, see TextureManager::setMipmapStreamingBudget.
+            Must be set before load().
+        */
+        void setMipmapStreamed(bool streamed);
+
+        /** Gets whether the mipmaps of this texture are streamed in by the TextureManager.
+        */
+        bool isMipmapStreamed(void) const { return mMipmapStreamed; }
+
+        /** Sets the number of the largest mipmaps a streamed texture can do without.
+        @remarks
+            Compute it from the density of the texels on screen, i.e. a texture of
+            1024 texels which covers at most 200 pixels can skip 2 mipmaps. Once
+            the RenderQueue reported a screen size with _notifyScreenSize, the
+            TextureManager computes it each frame instead.
+        */
+        void setDesiredMipmapSkip(uint8 skip) { mDesiredMipmapSkip = skip; }
+
+        /** Gets the number of the largest mipmaps a streamed texture can do without.
+        */
+        uint8 getDesiredMipmapSkip(void) const { return mDesiredMipmapSkip; }
+
+        /** Records that the texture is bound for rendering in the given frame.
+        @note Called by the RenderSystem when binding texture units
+        */
+        void _notifyUsed(unsigned long frame) { mLastUsedFrame = frame; }
+
+        /** Gets the number of the last frame the texture was bound for rendering in.
+        @see Root::getNextFrameNumber
+        */
+        unsigned long getLastUsedFrame(void) const { return mLastUsedFrame; }
+
+        /** Records the size in pixels of an object on screen which is rendered
+            with the texture, for mipmap streaming.
+        @remarks
+            The largest size reported since the last _updateDesiredMipmapSkip is kept.
+        @note Called by the RenderQueue for streamed textures
+        */
+        void _notifyScreenSize(Real pixels) { mScreenSize = std::max(mScreenSize, pixels); }
+
+        /** Sets the desired mipmap skip from the screen sizes reported since the
+            last call, if any were ever reported.
+        @remarks
+            The texture is assumed to span each object once, so the mipmaps with
+            more texels than the object has pixels are not needed.
+        @note Called by the TextureManager once per frame
+        */
+        void _updateDesiredMipmapSkip(void);
+
         /** Are mipmaps hardware generated?
         @remarks
             Will only be accurate after texture load, or createInternalResources
@@ -441,6 +521,16 @@ namespace Ogre {
         bool mTreatLuminanceAsAlpha;
 
         bool mInternalResourcesCreated;
+        /// Bytes of the internal resources counted by MemoryStats
+        size_t mInternalResourcesSize;
+
+        uint8 mMipmapSkip;
+        uint8 mMaxMipmapSkip;
+        uint8 mDesiredMipmapSkip;
+        bool mMipmapStreamed;
+        unsigned long mLastUsedFrame;
+        /// Largest size on screen reported since the last update, negative if none ever was
+        Real mScreenSize;
 
         /// @copydoc Resource::calculateSize
         size_t calculateSize(void) const;
@@ -462,6 +552,17 @@ namespace Ogre {
         */
         String getSourceFileType() const;
 
+        /** Reads the runtime compression of the texture file from the cache.
+        @return Whether the cache is newer than the texture file and matches the image
+        */
+        bool readCompressionCache(const String& cacheName, const Image& source,
+            PixelFormat format, Image& cached) const;
+
+        /** Writes the runtime compression of the texture file to the cache, if the
+            resource group has a writable location.
+        */
+        void writeCompressionCache(const String& cacheName, Image& compressed) const;
+
         static const char* CUBEMAP_SUFFIXES[6];
     };
     /** @} */
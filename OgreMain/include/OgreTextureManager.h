@@ -38,6 +38,8 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+    class ParallelJob;
+
     /** \addtogroup Core
     *  @{
     */
@@ -444,6 +446,102 @@ namespace Ogre {
             return mDefaultNumMipmaps;
         }
 
+        /** Sets the memory which streamed textures may take up together, in bytes.
+        @remarks
+            When they take up more, the largest mipmaps of those which need them
+            least are dropped, and larger mipmaps are only streamed in while
+            there is room. 0 means no limit.
+        @see Texture::setMipmapStreamed
+        */
+        void setMipmapStreamingBudget(size_t bytes) { mMipmapStreamingBudget = bytes; }
+
+        /** Gets the memory which streamed textures may take up together, in bytes.
+        */
+        size_t getMipmapStreamingBudget(void) const { return mMipmapStreamingBudget; }
+
+        /** Sets the size in texels which streamed textures are first loaded with.
+        */
+        void setMipmapStreamingInitialSize(size_t size) { mMipmapStreamingInitialSize = size; }
+
+        /** Gets the size in texels which streamed textures are first loaded with.
+        */
+        size_t getMipmapStreamingInitialSize(void) const { return mMipmapStreamingInitialSize; }
+
+        /** Sets the number of streamed textures which may be reloaded per frame.
+        */
+        void setMipmapStreamingReloadsPerFrame(size_t count) { mMipmapStreamingReloadsPerFrame = count; }
+
+        /** Gets the number of streamed textures which may be reloaded per frame.
+        */
+        size_t getMipmapStreamingReloadsPerFrame(void) const { return mMipmapStreamingReloadsPerFrame; }
+
+        /** Sets the number of frames after which a streamed texture which is not
+            rendered counts as unused.
+        @remarks
+            Unused textures are the first to lose their largest mipmaps when over
+            budget, down to the initial size, and no mipmaps are streamed in for
+            them. 0 only goes by the desired mipmap skip.
+        @see Texture::getLastUsedFrame
+        */
+        void setMipmapStreamingIdleFrames(unsigned long frames) { mMipmapStreamingIdleFrames = frames; }
+
+        /** Gets the number of frames after which a streamed texture which is not
+            rendered counts as unused.
+        */
+        unsigned long getMipmapStreamingIdleFrames(void) const { return mMipmapStreamingIdleFrames; }
+
+        /** Moves the loaded streamed textures one mipmap towards their desired
+            mipmap skip each, within the budget.
+        @remarks
+            The images of textures getting more or less mipmaps are read on the
+            worker threads. The texture is reloaded from the image in a later
+            call, so it keeps its current mipmaps until then. Textures which
+            can't get any smaller are left alone when over budget.
+        @note Called by Root once per frame
+        */
+        void _updateMipmapStreaming(void);
+
+        /** Gets the number of loaded streamed textures as of the last
+            _updateMipmapStreaming, so that screen sizes are only reported when needed.
+        */
+        size_t _getNumMipmapStreamedTextures(void) const { return mNumMipmapStreamedTextures; }
+
+        /** Sets whether uncompressed images are block compressed when textures are loaded.
+        @remarks
+            Applies to 2D textures and cube maps which are not render targets or
+            dynamic, have no desired format or gamma, and a size which is a multiple
+            of 4. Mipmaps are generated before compressing if requested. The format
+            is chosen by getRuntimeCompressionFormat. Off by default.
+        @see Image::compress
+        */
+        void setRuntimeCompression(bool compress) { mRuntimeCompression = compress; }
+
+        /** Gets whether uncompressed images are block compressed when textures are loaded.
+        */
+        bool getRuntimeCompression(void) const { return mRuntimeCompression; }
+
+        /** Sets whether runtime compressed textures are cached next to their image file.
+        @remarks
+            The cache is a DDS file named after the texture with a ".dxt1.dds" or
+            ".dxt5.dds" suffix, written to the first writable location of the
+            resource group. It is used while it is newer than the image file and
+            matches its size and mipmaps. ETC compressed textures are not cached,
+            as there is no encoder for a container holding them. Off by default.
+        */
+        void setRuntimeCompressionCache(bool cache) { mRuntimeCompressionCache = cache; }
+
+        /** Gets whether runtime compressed textures are cached next to their image file.
+        */
+        bool getRuntimeCompressionCache(void) const { return mRuntimeCompressionCache; }
+
+        /** Gets the format images are compressed to when textures are loaded.
+        @remarks
+            DXT1, or DXT5 for images with alpha, if the render system supports DXT.
+            Otherwise ETC2 or ETC1 for images without alpha, if supported.
+        @return PF_UNKNOWN if no supported format keeps the alpha of the image
+        */
+        PixelFormat getRuntimeCompressionFormat(bool hasAlpha) const;
+
         /// @copydoc Singleton::getSingleton()
         static TextureManager& getSingleton(void);
         /// @copydoc Singleton::getSingleton()
@@ -454,6 +552,31 @@ namespace Ogre {
         ushort mPreferredIntegerBitDepth;
         ushort mPreferredFloatBitDepth;
         uint32 mDefaultNumMipmaps;
+        size_t mMipmapStreamingBudget;
+        size_t mMipmapStreamingInitialSize;
+        size_t mMipmapStreamingReloadsPerFrame;
+        unsigned long mMipmapStreamingIdleFrames;
+        size_t mNumMipmapStreamedTextures;
+        bool mRuntimeCompression;
+        bool mRuntimeCompressionCache;
+
+        /** Reloads the texture with another mipmap skip, reading its image on the worker threads.
+        @return Whether the texture was reloaded right away instead
+        */
+        bool streamMipmaps(Texture* texture, uint8 skip, unsigned long frame);
+
+        /// A texture getting more or less mipmaps, whose image is read on the worker threads
+        struct MipmapStream
+        {
+            TexturePtr texture;
+            /// The mipmap skip to reload the texture with
+            uint8 skip;
+            /// The frame the job was started in
+            unsigned long frame;
+            SharedPtr<ParallelJob> job;
+        };
+        typedef vector<MipmapStream>::type MipmapStreamList;
+        MipmapStreamList mMipmapStreams;
     };
     /** @} */
     /** @} */
@@ -0,0 +1,87 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __TraceProfileSessionListener_H__
+#define __TraceProfileSessionListener_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreProfiler.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** ProfileSessionListener which streams the recorded profiles to a file in
+        the Chrome trace event format
+        @remarks
+            The file can be loaded in chrome://tracing or ui.perfetto.dev to see
+            the timeline of each thread, including the GPU event regions. The
+            file is written from the moment the Profiler is enabled until it is 
+            disabled or destroyed.
+    */
+    class _OgreExport TraceProfileSessionListener : public ProfileSessionListener, public ProfilerAlloc
+    {
+    public:
+        TraceProfileSessionListener(const String& fileName);
+        virtual ~TraceProfileSessionListener();
+
+        /// @copydoc ProfileSessionListener::initializeSession
+        virtual void initializeSession();
+
+        /// @copydoc ProfileSessionListener::finializeSession
+        virtual void finializeSession();
+
+        /// @copydoc ProfileSessionListener::profileRecorded
+        virtual void profileRecorded(const String& profileName, const String& threadName,
+                                     ulong startTime, ulong endTime);
+
+        /// Gets the name of the file the trace is written to
+        const String& getFileName() const { return mFileName; }
+
+    protected:
+        typedef map<String, uint>::type ThreadIDMap;
+
+        /// Writes a string as a JSON string
+        void writeString(const String& str);
+
+        String mFileName;
+        std::ofstream mFile;
+        /// The trace IDs of the threads seen in this session
+        ThreadIDMap mThreadIDs;
+        bool mFirstEvent;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -55,6 +55,9 @@ namespace Ogre {
         VertexData& operator=(const VertexData& rhs); /* do not use */
 
         HardwareBufferManagerBase* mMgr;
+        /// Manager the buffers were sub-allocated from, if pooled
+        HardwareBufferManagerBase* mPoolMgr;
+        friend class HardwareBufferManagerBase;
     public:
         /** Constructor.
         @note 
@@ -89,6 +92,10 @@ namespace Ogre {
         /// The number of vertices used in this operation
         size_t vertexCount;
 
+        /** Whether the buffers are ranges of a pool.
+        @see HardwareBufferManagerBase::createPooledVertexData
+        */
+        bool isPooled(void) const { return mPoolMgr != 0; }
 
         /// Struct used to hold hardware morph / pose vertex data information
         struct HardwareAnimationData
@@ -216,6 +223,25 @@ namespace Ogre {
         */
         void convertPackedColour(VertexElementType srcType, VertexElementType destType);
 
+        /** Convert the float positions, normals and texture coordinates to more
+            compact types, to save vertex memory and bandwidth.
+        @remarks
+            Positions become VET_HALF4, normals, binormals and tangents
+            VET_SHORT4_NORM, and texture coordinates VET_HALF2 or VET_HALF4. The
+            GPU decodes these types when fetching the vertices, so vertex programs
+            read them as floats as before. Code that reads the vertices on the CPU
+            as floats, such as software skinning and morphing, edge list building
+            and tangent generation, cannot be used on the packed elements.
+        @par
+            Half floats have 11 bits of precision, so positions are best packed
+            for meshes modelled around the origin, and texture coordinates for
+            textures of up to about 2048 texels.
+        @param positions Whether to pack the positions
+        @param normals Whether to pack the normals, binormals and tangents
+        @param texCoords Whether to pack the texture coordinates
+        */
+        void packElements(bool positions = true, bool normals = true, bool texCoords = true);
+
 
         /** Allocate elements to serve a holder of morph / pose target data 
             for hardware morphing / pose blending.
@@ -246,6 +272,10 @@ namespace Ogre {
         IndexData(const IndexData& rhs); /* do nothing, should not use */
         /// Protected operator=, to prevent misuse
         IndexData& operator=(const IndexData& rhs); /* do not use */
+
+        /// Manager the buffer was sub-allocated from, if pooled
+        HardwareBufferManagerBase* mPoolMgr;
+        friend class HardwareBufferManagerBase;
     public:
         IndexData();
         ~IndexData();
@@ -258,6 +288,11 @@ namespace Ogre {
         /// The number of indexes to use from the buffer
         size_t indexCount;
 
+        /** Whether the buffer is a range of a pool.
+        @see HardwareBufferManagerBase::createPooledIndexData
+        */
+        bool isPooled(void) const { return mPoolMgr != 0; }
+
         /** Clones this index data, potentially including replicating the index buffer.
         @param copyData Whether to create new buffers too or just reference the existing ones
         @param mgr If supplied, the buffer manager through which copies should be made
@@ -271,7 +306,9 @@ namespace Ogre {
         @remarks
             Can only be used for index data which consists of triangle lists.
             It would in fact be pointless to use it on triangle strips or fans
-            in any case.
+            in any case. Uses Tom Forsyth's linear-time algorithm, which scores
+            vertices by their position in a simulated 32 entry LRU cache and by
+            the number of triangles still using them.
         */
         void optimiseVertexCacheTriList(void);
     
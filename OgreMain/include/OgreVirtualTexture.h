@@ -0,0 +1,236 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __VirtualTexture_H__
+#define __VirtualTexture_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreTexture.h"
+#include "OgreVector4.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    class ParallelJob;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** A texture much larger than fits in video memory, of which only the pages
+        seen on screen are kept in a cache texture.
+    @remarks
+        The virtual texture is split into square pages, with a mip chain of pages
+        down to the size of one page. The pages are produced on demand by a
+        PageProvider, e.g. read from tiles on disk or generated from terrain
+        layers, on the worker threads of the WorkQueue. They are uploaded into
+        the cache texture, and evicted least recently used first once it is full.
+        The pages of the smallest mip level always stay resident.
+    @par
+        Shaders find the texels through the page table texture, which has a
+        texel per page and the same mip chain. Sampled with point filtering at
+        the mip level of the virtual texture coordinates, a texel holds the cache
+        position of the page in red and green and its mip level in blue, all as
+        bytes. Pages which are not resident point to their nearest resident
+        ancestor, so there is always a lower detail fallback. With the page
+        table parameters (widthInPages, heightInPages, pageSize, border) and
+        cache parameters (widthInPages, heightInPages, 1/width, 1/height), the
+        cache coordinates are
+        <pre>
+        pages = pageTableParams.xy / exp2(entry.b * 255)
+        inPage = fract(uv * pages) * pageSize + border
+        cacheUV = (entry.rg * 255 * (pageSize + 2 * border) + inPage) * cacheParams.zw
+        </pre>
+        sampled with bilinear filtering, which the border texels keep seamless.
+    @par
+        Which pages are needed is found from a feedback render target. Render
+        the scene into it at low resolution with a material scheme whose
+        shaders write the page each pixel needs as bytes: page x in red, page y
+        in green, the high four bits of x and y in the low and high half of
+        blue, the mip level in alpha, and an alpha of 255 for no page. It is
+        read back asynchronously by update.
+    */
+    class _OgreExport VirtualTexture : public ResourceAlloc
+    {
+    public:
+        /** Supplies the texels of the pages.
+        @remarks
+            Called from worker threads, several pages may be loaded at once.
+        */
+        class _OgreExport PageProvider
+        {
+        public:
+            virtual ~PageProvider() {}
+
+            /** Fill in the texels of a page.
+            @param x, y Position of the page in its mip level, in pages
+            @param mip Mip level of the page, 0 being the full resolution
+            @param dest The texels to fill in, the page with its border on
+                every side, in the format of the virtual texture
+            @return Whether the page could be loaded
+            */
+            virtual bool loadPage(uint32 x, uint32 y, uint8 mip, const PixelBox& dest) = 0;
+        };
+
+        /** Create the page table and cache textures.
+        @param name Name of the virtual texture, the textures are named after it
+        @param widthInPages, heightInPages Size of the virtual texture in pages,
+            powers of two up to 4096
+        @param pageSize Size of a page in texels, without the border
+        @param border Texels added on every side of a page for filtering
+        @param cacheWidthInPages, cacheHeightInPages Size of the cache in
+            pages, up to 256
+        @param format Format of the texels
+        @param provider Supplies the texels of the pages, must outlive this
+        @param group Resource group of the textures
+        */
+        VirtualTexture(const String& name, uint32 widthInPages, uint32 heightInPages,
+            uint32 pageSize, uint32 border, uint32 cacheWidthInPages, uint32 cacheHeightInPages,
+            PixelFormat format, PageProvider* provider,
+            const String& group = ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+        ~VirtualTexture();
+
+        /// The page table, to be point sampled
+        const TexturePtr& getPageTable(void) const { return mPageTable; }
+        /// The cache of resident pages
+        const TexturePtr& getCache(void) const { return mCache; }
+        /// (widthInPages, heightInPages, pageSize, border) for the shaders
+        Vector4 getPageTableParameters(void) const;
+        /// (widthInPages, heightInPages, 1/width, 1/height) of the cache for the shaders
+        Vector4 getCacheParameters(void) const;
+
+        /** Sets the render target whose feedback is read back on update, see
+            the class description. 0 to request pages with requestPage only.
+        */
+        void setFeedbackTarget(RenderTarget* target);
+        /// Gets the render target whose feedback is read back on update
+        RenderTarget* getFeedbackTarget(void) const { return mFeedbackTarget; }
+
+        /** Sets the maximum number of pages loaded at once, and thus uploaded per frame.
+        */
+        void setMaxPagesPerUpdate(size_t count) { mMaxPagesPerUpdate = count; }
+        /// Gets the maximum number of pages loaded at once
+        size_t getMaxPagesPerUpdate(void) const { return mMaxPagesPerUpdate; }
+
+        /** Marks a page as needed in this frame, loading it if it is not resident.
+        @remarks
+            Coordinates outside of the mip level are clamped.
+        */
+        void requestPage(uint32 x, uint32 y, uint8 mip);
+
+        /** Requests the pages of feedback pixels, encoded as described in the
+            class description. Called by update for the feedback target.
+        */
+        void processFeedback(const PixelBox& feedback);
+
+        /** Uploads the pages loaded since the last call, starts loading the
+            pages requested since, and reads back the feedback target.
+            Call once per frame, before rendering.
+        */
+        void update(void);
+
+        /// Returns whether a page is in the cache
+        bool isPageResident(uint32 x, uint32 y, uint8 mip) const;
+        /// Gets the number of mip levels below the full resolution
+        uint8 getNumMipmaps(void) const { return mNumMipmaps; }
+
+    protected:
+        typedef map<uint64, uint32>::type PageMap;
+        typedef set<uint64>::type PageSet;
+
+        /// A page of the cache
+        struct Slot
+        {
+            /// The page in the slot, INVALID_PAGE if empty
+            uint64 page;
+            /// The last update the page was needed in
+            unsigned long lastUsed;
+        };
+        typedef vector<Slot>::type SlotList;
+
+        static const uint64 INVALID_PAGE = ~uint64(0);
+
+        static uint64 makePage(uint32 x, uint32 y, uint8 mip)
+        { return (uint64(mip) << 48) | (uint64(y) << 24) | x; }
+        static uint32 getPageX(uint64 page) { return uint32(page & 0xFFFFFF); }
+        static uint32 getPageY(uint64 page) { return uint32((page >> 24) & 0xFFFFFF); }
+        static uint8 getPageMip(uint64 page) { return uint8(page >> 48); }
+
+        /// Size of a mip level in pages
+        uint32 getWidthInPages(uint8 mip) const { return std::max<uint32>(mWidthInPages >> mip, 1); }
+        uint32 getHeightInPages(uint8 mip) const { return std::max<uint32>(mHeightInPages >> mip, 1); }
+
+        /// Starts loading up to mMaxPagesPerUpdate of the requested pages
+        void startLoading(void);
+        /// Uploads the pages which have been loaded
+        void finishLoading(void);
+        /// Finds a slot for a page, evicting the least recently used one
+        uint32 acquireSlot(void);
+        /// Uploads the page table after the resident pages changed
+        void updatePageTable(void);
+
+        String mName;
+        uint32 mWidthInPages;
+        uint32 mHeightInPages;
+        uint32 mPageSize;
+        uint32 mBorder;
+        uint32 mCacheWidthInPages;
+        uint32 mCacheHeightInPages;
+        PixelFormat mFormat;
+        uint8 mNumMipmaps;
+        PageProvider* mProvider;
+
+        TexturePtr mPageTable;
+        TexturePtr mCache;
+
+        SlotList mSlots;
+        /// Slot of each resident page
+        PageMap mResident;
+        /// Pages requested in this update, and being loaded
+        PageSet mRequested;
+        PageSet mLoading;
+        SharedPtr<ParallelJob> mLoadJob;
+        /// The update mLoadJob was started in
+        unsigned long mLoadFrame;
+        size_t mMaxPagesPerUpdate;
+        unsigned long mFrame;
+        bool mPageTableDirty;
+
+        RenderTarget* mFeedbackTarget;
+        AsyncReadbackPtr mFeedbackReadback;
+        vector<uint8>::type mFeedbackPixels;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
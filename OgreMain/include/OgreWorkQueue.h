@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreSharedPtr.h"
 #include "OgreCommon.h"
 #include "Threading/OgreThreadHeaders.h"
+#include "Threading/OgreParallel.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre
@@ -81,9 +82,10 @@ namespace Ogre
 
         /** General purpose request structure. 
         */
-        class _OgreExport Request : public UtilityAlloc
+        class _OgreExport Request : public WorkQueueAlloc
         {
             friend class WorkQueue;
+            friend class DefaultWorkQueueBase;
         protected:
             /// The request channel, as an integer 
             uint16 mChannel;
@@ -97,6 +99,8 @@ namespace Ogre
             RequestID mID;
             /// Abort Flag
             mutable bool mAborted;
+            /// Time the request entered the queue in microseconds, for the statistics
+            unsigned long mQueueTime;
 
         public:
             /// Constructor 
@@ -120,7 +124,7 @@ namespace Ogre
 
         /** General purpose response structure. 
         */
-        struct _OgreExport Response : public UtilityAlloc
+        struct _OgreExport Response : public WorkQueueAlloc
         {
             /// Pointer to the request that this response is in relation to
             const Request* mRequest;
@@ -217,6 +221,18 @@ namespace Ogre
             @param srcQ The work queue that this request originated from
             */
             virtual void handleResponse(const Response* res, const WorkQueue* srcQ) = 0;
+
+            /** Return whether responses may be handled on the worker thread.
+            @remarks
+            Defaults to false. A handler which doesn't need the render thread
+            can return true to have its responses handled by the worker which
+            ran the request, straight after it, instead of waiting for the
+            next processResponses call in the main thread. This only happens
+            when every response handler of the channel returns true. As the
+            workers read the handlers without a lock, they must be added
+            before requests are posted to the channel.
+            */
+            virtual bool handlesResponsesOnWorker() const { return false; }
         };
 
         WorkQueue() : mNextChannel(0) {}
@@ -280,6 +296,15 @@ namespace Ogre
         */
         virtual void abortRequest(RequestID id) = 0;
 
+        /** Move a request which is still waiting ahead of the others.
+        @remarks
+            Call this when a thread is about to wait for the outcome of a request,
+            so it doesn't wait behind less urgent work. Does nothing if the request
+            is already being processed or the queue doesn't order its requests.
+        @param id The ID of the previously issued request.
+        */
+        virtual void promoteRequest(RequestID id) { (void)id; }
+
         /** Abort all previously issued requests in a given channel.
         Any requests still waiting to be processed of the given channel, will be 
         removed from the queue.
@@ -354,13 +379,61 @@ namespace Ogre
         */
         virtual uint16 getChannel(const String& channelName);
 
+        /** Process a parallel job on the calling thread and the worker threads,
+            returns once all its items are processed.
+        @remarks
+            This is what ParallelJob::run uses, call that instead. The default
+            implementation processes the job on the calling thread alone;
+            implementations with worker threads let them help.
+        */
+        virtual void _processParallelJob(const ParallelJobPtr& job);
+
+        /** Let the worker threads start on a parallel job, returns at once.
+        @remarks
+            This is what ParallelJob::start uses, call that instead. The default
+            implementation does nothing, leaving the job to ParallelJob::complete.
+        */
+        virtual void _startParallelJob(const ParallelJobPtr& job) {}
+
     };
 
     /** Base for a general purpose request / response style background work queue.
+    @remarks
+        Requests are processed by the priority of their channel first, see
+        setChannelPriority, and the number of workers a channel may occupy
+        at once can be limited with setChannelWorkerLimit, so long running
+        requests of one channel don't hold up urgent ones of another.
     */
     class _OgreExport DefaultWorkQueueBase : public WorkQueue
     {
     public:
+        /// Priorities of request channels, requests of higher priority are processed first
+        enum Priority
+        {
+            PRIORITY_HIGH,
+            PRIORITY_NORMAL,
+            PRIORITY_LOW,
+            PRIORITY_COUNT
+        };
+
+        /// Statistics of the requests of a channel, see getChannelStatistics
+        struct ChannelStatistics
+        {
+            /// Requests waiting in the queue
+            size_t pending;
+            /// Requests being processed
+            size_t active;
+            /// Requests processed since the statistics were last reset
+            size_t processed;
+            /// Total and longest time processed requests waited in the queue, in microseconds
+            uint64 totalWaitTime;
+            unsigned long maxWaitTime;
+            /// Total time spent processing the requests, in microseconds
+            uint64 totalProcessTime;
+
+            ChannelStatistics() : pending(0), active(0), processed(0), 
+                totalWaitTime(0), maxWaitTime(0), totalProcessTime(0) {}
+        };
 
         /** Constructor.
             Call startup() to initialise.
@@ -442,6 +515,44 @@ namespace Ogre
         virtual void abortPendingRequestsByChannel(uint16 channel);
         /// @copydoc WorkQueue::abortAllRequests
         virtual void abortAllRequests();
+        /// @copydoc WorkQueue::promoteRequest
+        virtual void promoteRequest(RequestID id);
+
+        /** Set the priority of the requests of a channel (default PRIORITY_NORMAL).
+        @remarks
+            Only affects requests added afterwards. Requests on the idle thread are
+            processed in order regardless of their priority.
+        */
+        void setChannelPriority(uint16 channel, Priority priority);
+        /// Get the priority of the requests of a channel
+        Priority getChannelPriority(uint16 channel) const;
+
+        /** Set the number of workers which may process requests of a channel at
+            the same time (default 0, no limit).
+        @remarks
+            Keeps some workers free for other channels, e.g. limit the channels
+            doing heavy computations so the workers can't all be taken while
+            loading requests pile up. Requests of a channel at its limit wait
+            while requests of other channels are processed.
+        @note
+            Only applies to the queue of DefaultWorkQueue. WorkStealingQueue
+            spreads its requests over the queues of its workers and ignores the limit.
+        */
+        void setChannelWorkerLimit(uint16 channel, size_t limit);
+        /// Get the number of workers which may process requests of a channel at the same time
+        size_t getChannelWorkerLimit(uint16 channel) const;
+
+        /** Get the queue depth and timings of a channel, to tune its priority and 
+            worker limit.
+        @remarks
+            Covers the requests going through the queue of the workers, not the
+            synchronous and idle thread requests. Only DefaultWorkQueue keeps
+            statistics, they stay zero on a WorkStealingQueue.
+        */
+        ChannelStatistics getChannelStatistics(uint16 channel) const;
+        /// Reset the processed counts and timings of all channels
+        void resetChannelStatistics();
+
         /// @copydoc WorkQueue::setPaused
         virtual void setPaused(bool pause);
         /// @copydoc WorkQueue::isPaused
@@ -456,6 +567,10 @@ namespace Ogre
         virtual unsigned long getResponseProcessingTimeLimit() const { return mResposeTimeLimitMS; }
         /// @copydoc WorkQueue::setResponseProcessingTimeLimit
         virtual void setResponseProcessingTimeLimit(unsigned long ms) { mResposeTimeLimitMS = ms; }
+        /// @copydoc WorkQueue::_processParallelJob
+        virtual void _processParallelJob(const ParallelJobPtr& job);
+        /// @copydoc WorkQueue::_startParallelJob
+        virtual void _startParallelJob(const ParallelJobPtr& job);
     protected:
         String mName;
         size_t mWorkerThreadCount;
@@ -465,7 +580,7 @@ namespace Ogre
 
         typedef deque<Request*>::type RequestQueue;
         typedef deque<Response*>::type ResponseQueue;
-        RequestQueue mRequestQueue; // Guarded by mRequestMutex
+        RequestQueue mRequestQueues[PRIORITY_COUNT]; // Guarded by mRequestMutex
         RequestQueue mProcessQueue; // Guarded by mProcessMutex
         ResponseQueue mResponseQueue; // Guarded by mResponseMutex
 
@@ -541,6 +656,21 @@ namespace Ogre
 
         RequestHandlerListByChannel mRequestHandlers;
         ResponseHandlerListByChannel mResponseHandlers;
+
+        typedef map<uint16, Priority>::type ChannelPriorityMap;
+        ChannelPriorityMap mChannelPriorities;
+        OGRE_WQ_RW_MUTEX(mChannelPriorityMutex);
+
+        /// Worker limit and statistics of a channel
+        struct ChannelState
+        {
+            size_t workerLimit;
+            ChannelStatistics stats;
+            ChannelState() : workerLimit(0) {}
+        };
+        typedef map<uint16, ChannelState>::type ChannelStateMap;
+        ChannelStateMap mChannelStates; // Guarded by mRequestMutex
+
         RequestID mRequestCount; // Guarded by mRequestMutex
         bool mPaused;
         bool mAcceptRequests;
@@ -555,9 +685,22 @@ namespace Ogre
         OGRE_WQ_MUTEX(mProcessMutex);
         OGRE_WQ_MUTEX(mResponseMutex);
         OGRE_WQ_RW_MUTEX(mRequestHandlerMutex);
+        /// Guards mResponseHandlers, which workers read for responses handled on the worker
+        OGRE_WQ_RW_MUTEX(mResponseHandlerMutex);
 
 
+        /// Put a request on the queue of its priority, with mRequestMutex locked
+        void pushRequest(Request* r);
+        /// Take the next request whose channel is below its worker limit, with mRequestMutex locked
+        Request* popRequest();
+        /// Whether a request could be taken by popRequest, with mRequestMutex locked
+        bool hasRunnableRequest() const;
+        /// Whether a channel has as many requests in process as it may, with mRequestMutex locked
+        bool isChannelAtLimit(uint16 channel) const;
+
         void processRequestResponse(Request* r, bool synchronous);
+        /// Whether all response handlers of the channel of a response let it be handled on the worker
+        bool canProcessResponseOnWorker(const Response* r) const;
         Response* processRequest(Request* r);
         void processResponse(Response* r);
         /// Notify workers about a new request. 
@@ -571,6 +714,11 @@ namespace Ogre
         
 
         bool processIdleRequests();
+
+        class ParallelJobHandler;
+        /// Processes parallel jobs posted to mParallelJobChannel
+        ParallelJobHandler* mParallelJobHandler;
+        uint16 mParallelJobChannel;
     };
 
 
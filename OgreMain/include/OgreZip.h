@@ -108,6 +108,90 @@ namespace Ogre {
         time_t getModifiedTime(const String& filename) const;
     };
 
+    /** Specialisation of ZipArchive which reads the archive without zziplib.
+    @remarks
+        The whole archive is mapped into memory and a hash index of its central
+        directory is built on load, so opening a file is a single lookup.
+        Stored (uncompressed) entries are returned as views of the mapped archive
+        without any copy. Inflated entries are kept in a size bounded LRU cache
+        which is shared by all opens, so files which are opened again are not
+        inflated again.
+    @par
+        Only stored and deflated entries are supported, encrypted and Zip64
+        archives are not.
+    */
+    class _OgreExport IndexedZipArchive : public ZipArchive
+    {
+    protected:
+        /// Location of the data of an entry in the mapped archive
+        struct Entry
+        {
+            size_t dataOffset;
+            size_t compressedSize;
+            size_t uncompressedSize;
+            uint16 method;
+            bool encrypted;
+        };
+        typedef vector<Entry>::type EntryList;
+        /// Maps file names to indices into mEntries
+        typedef OGRE_HashMap<String, size_t> EntryIndex;
+
+        typedef Ogre::list<String>::type CacheLRUList;
+        struct CachedEntry
+        {
+            MemoryDataStreamPtr data;
+            CacheLRUList::iterator lru;
+        };
+        typedef map<String, CachedEntry>::type CachedEntryMap;
+
+        /// The mapped archive
+        MemoryDataStreamPtr mArchiveData;
+        /// Entries, in the same order as mFileList
+        EntryList mEntries;
+        EntryIndex mEntryIndex;
+
+        /// Inflated entries, most recently used at the front of mCacheLRU
+        mutable CachedEntryMap mCache;
+        mutable CacheLRUList mCacheLRU;
+        mutable size_t mCacheSize;
+        size_t mCacheBudget;
+        /** Guards the index and the cache. Resources are opened from the WorkQueue
+            threads, so this is a real mutex whatever OGRE_THREAD_SUPPORT is.
+        */
+        OGRE_WQ_MUTEX(mIndexMutex);
+
+        /// Build mFileList, mEntries and mEntryIndex from the central directory
+        void readCentralDirectory();
+        /// Inflate an entry of the mapped archive into a new buffer
+        MemoryDataStreamPtr inflateEntry(const String& filename, const Entry& entry,
+            const MemoryDataStreamPtr& archiveData) const;
+        /// Drop least recently used entries until the cache fits in the given size
+        void trimCache(size_t size) const;
+    public:
+        IndexedZipArchive(const String& name, const String& archType);
+        ~IndexedZipArchive();
+
+        /// @copydoc Archive::load
+        void load();
+        /// @copydoc Archive::unload
+        void unload();
+
+        /// @copydoc Archive::open
+        DataStreamPtr open(const String& filename, bool readOnly = true) const;
+
+        /// @copydoc Archive::exists
+        bool exists(const String& filename) const;
+
+        /** Set the maximum amount of memory used to keep inflated entries, 
+            default 16 MiB. Entries bigger than this are never cached.
+        */
+        void setCacheBudget(size_t bytes);
+        /// Get the maximum amount of memory used to keep inflated entries
+        size_t getCacheBudget() const { return mCacheBudget; }
+        /// Get the amount of memory currently used by inflated entries
+        size_t getCacheSize() const { return mCacheSize; }
+    };
+
     /** Specialisation of ArchiveFactory for Zip files. */
     class _OgrePrivate ZipArchiveFactory : public ArchiveFactory
     {
@@ -127,6 +211,25 @@ namespace Ogre {
         void destroyInstance( Archive* ptr) { OGRE_DELETE ptr; }
     };
 
+    /** Specialisation of ArchiveFactory for Zip files read by IndexedZipArchive. */
+    class _OgrePrivate IndexedZipArchiveFactory : public ArchiveFactory
+    {
+    public:
+        virtual ~IndexedZipArchiveFactory() {}
+        /// @copydoc FactoryObj::getType
+        const String& getType(void) const;
+        /// @copydoc FactoryObj::createInstance
+        Archive *createInstance( const String& name, bool readOnly ) 
+        {
+            if(!readOnly)
+                return NULL;
+
+            return OGRE_NEW IndexedZipArchive(name, "IndexedZip");
+        }
+        /// @copydoc FactoryObj::destroyInstance
+        void destroyInstance( Archive* ptr) { OGRE_DELETE ptr; }
+    };
+
     /** Specialisation of ZipArchiveFactory for embedded Zip files. */
     class _OgreExport EmbeddedZipArchiveFactory : public ZipArchiveFactory
     {
@@ -0,0 +1,203 @@
+/*-------------------------------------------------------------------------
+This source file is a part of OGRE
+(Object-oriented Graphics Rendering Engine)
+
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+-------------------------------------------------------------------------*/
+#ifndef __OgreParallel_H__
+#define __OgreParallel_H__
+
+#include "../OgrePrerequisites.h"
+#include "../OgreAtomicScalar.h"
+#include "../OgreSharedPtr.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Work split into items which can be processed in any order, from any thread.
+    @remarks
+        Threads working on the job claim chunks of grainSize consecutive items until
+        none are left, so the load balances itself as long as there are several
+        chunks per thread. Subclass it and implement execute, then call run, or use
+        parallelFor for loops over a plain functor.
+    */
+    class _OgreExport ParallelJob : public UtilityAlloc
+    {
+    public:
+        ParallelJob(size_t count = 0, size_t grainSize = 1);
+        virtual ~ParallelJob() {}
+
+        /// Process the items [begin, end), called from any thread
+        virtual void execute(size_t begin, size_t end) = 0;
+
+        /// Set the number of items, only before the job is run
+        void setCount(size_t count) { mCount = count; }
+        /// Get the number of items
+        size_t getCount() const { return mCount; }
+        /// Set the number of items claimed at once, only before the job is run
+        void setGrainSize(size_t grainSize) { mGrainSize = grainSize ? grainSize : 1; }
+        /// Get the number of items claimed at once
+        size_t getGrainSize() const { return mGrainSize; }
+        /// Get the number of chunks the items are claimed in
+        size_t getChunkCount() const { return (mCount + mGrainSize - 1) / mGrainSize; }
+
+        /// Process chunks until there are none left to claim
+        void process();
+        /// Wait until the chunks claimed by other threads are processed
+        void wait();
+        /// Returns whether all items have been processed
+        bool isComplete() const { return mDone.load() == mCount; }
+
+        /** Process the job on the calling thread and the worker threads of the
+            Root WorkQueue, returns once all items are processed.
+        @remarks
+            The job is processed on the calling thread alone without
+            OGRE_THREAD_SUPPORT, or if there is no Root. It may be run from a thread
+            processing another job.
+        */
+        static void run(const SharedPtr<ParallelJob>& job);
+
+        /** Hand the job to the worker threads of the Root WorkQueue and return at once.
+        @remarks
+            Call complete before using the results. Whatever the workers have not
+            claimed by then is processed on the thread calling it, so without
+            OGRE_THREAD_SUPPORT or a Root the whole job runs there.
+        */
+        static void start(const SharedPtr<ParallelJob>& job);
+
+        /// Process the chunks not claimed yet and wait for the others, see start
+        void complete() { process(); wait(); }
+
+    protected:
+        size_t mCount;
+        size_t mGrainSize;
+        /// Index of the next item to be claimed
+        AtomicScalar<size_t> mNext;
+        /// Number of items processed
+        AtomicScalar<size_t> mDone;
+    };
+    typedef SharedPtr<ParallelJob> ParallelJobPtr;
+
+    /// ParallelJob calling a functor for each item, see parallelFor
+    template <typename Func>
+    class ParallelForJob : public ParallelJob
+    {
+    public:
+        ParallelForJob(size_t begin, size_t end, const Func& func, size_t grainSize)
+            : ParallelJob(end - begin, grainSize), mBegin(begin), mFunc(func) {}
+
+        void execute(size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                mFunc(mBegin + i);
+        }
+
+    protected:
+        size_t mBegin;
+        Func mFunc;
+    };
+
+    /** Calls func(i) for each i in [begin, end), spread over the calling thread and
+        the worker threads of the Root WorkQueue.
+    @remarks
+        Returns once all calls have completed. The functor is copied once and called
+        concurrently from several threads, so it must only read shared state, or
+        write to state separate for each index. Use a grainSize which makes the work
+        of a chunk outweigh claiming it, i.e. larger for cheap calls.
+    */
+    template <typename Func>
+    void parallelFor(size_t begin, size_t end, const Func& func, size_t grainSize = 1)
+    {
+        if (end <= begin)
+            return;
+        ParallelJob::run(ParallelJobPtr(OGRE_NEW ParallelForJob<Func>(begin, end, func, grainSize)));
+    }
+
+    /** Set of tasks with dependencies between them, run in parallel where the
+        dependencies allow.
+    @remarks
+        The graph holds no results, tasks pass data through their own members. It can
+        be run any number of times, and is meant to be built once and run each frame.
+    */
+    class _OgreExport TaskGraph : public UtilityAlloc
+    {
+    public:
+        /// A node of the graph
+        class _OgreExport Task
+        {
+        public:
+            virtual ~Task() {}
+            /// Do the work, called from any thread once all dependencies have completed
+            virtual void execute() = 0;
+        };
+        typedef size_t TaskID;
+
+        TaskGraph();
+        ~TaskGraph();
+
+        /// Add a task to the graph, which does not take ownership of it
+        TaskID addTask(Task* task);
+        /// Make a task wait for another one, both must have been added
+        void addDependency(TaskID task, TaskID dependency);
+        /// Get the number of tasks
+        size_t getTaskCount() const { return mTasks.size(); }
+        /// Remove all tasks
+        void clear();
+
+        /** Run all tasks, returns once they have completed.
+        @remarks
+            Throws an exception if the dependencies form a cycle. Without
+            OGRE_THREAD_SUPPORT, the tasks are run one after another in an order
+            satisfying the dependencies.
+        */
+        void run();
+
+    protected:
+        struct Node
+        {
+            Task* task;
+            /// Tasks waiting for this one
+            vector<TaskID>::type dependents;
+            /// Number of tasks this one waits for
+            size_t dependencyCount;
+
+            Node(Task* t) : task(t), dependencyCount(0) {}
+        };
+        typedef vector<Node>::type NodeList;
+        NodeList mTasks;
+
+        /// Returns the tasks in an order satisfying the dependencies, or throws on cycles
+        void sortTasks(vector<TaskID>::type& order) const;
+    };
+
+    /** @} */
+    /** @} */
+
+}
+
+#endif
@@ -34,6 +34,8 @@ THE SOFTWARE
 #define OGRE_THREAD_CREATE(name, worker) boost::thread* name = OGRE_NEW_T(boost::thread, MEMCATEGORY_GENERAL)(worker)
 #define OGRE_THREAD_DESTROY(name) OGRE_DELETE_T(name, thread, MEMCATEGORY_GENERAL)
 #define OGRE_THREAD_CURRENT_ID boost::this_thread::get_id()
+#define OGRE_WQ_THREAD_ID_TYPE boost::thread::id
+#define OGRE_WQ_THREAD_YIELD boost::this_thread::yield()
 #define OGRE_THREAD_HARDWARE_CONCURRENCY boost::thread::hardware_concurrency()
 #define OGRE_THREAD_WORKER_INHERIT
 
@@ -45,17 +47,29 @@ THE SOFTWARE
 #define OGRE_WQ_RW_MUTEX(name) mutable boost::shared_mutex name
 #define OGRE_WQ_LOCK_RW_MUTEX_READ(name) boost::shared_lock<boost::shared_mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
 #define OGRE_WQ_LOCK_RW_MUTEX_WRITE(name) boost::unique_lock<boost::shared_mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
+#define OGRE_WQ_SHARED_MUTEX(name) OGRE_WQ_RW_MUTEX(name)
+#define OGRE_WQ_LOCK_SHARED_MUTEX_READ(name) OGRE_WQ_LOCK_RW_MUTEX_READ(name)
+#define OGRE_WQ_LOCK_SHARED_MUTEX_WRITE(name) OGRE_WQ_LOCK_RW_MUTEX_WRITE(name)
 
 #define OGRE_WQ_MUTEX(name) mutable boost::recursive_mutex name
 #if BOOST_THREAD_VERSION < 4
 #define OGRE_WQ_LOCK_MUTEX(name) boost::recursive_mutex::scoped_lock OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
 #define OGRE_WQ_LOCK_MUTEX_NAMED(mutexName, lockName) boost::recursive_mutex::scoped_lock lockName(mutexName)
 #define OGRE_WQ_THREAD_SYNCHRONISER(sync) boost::condition sync
+#define OGRE_WQ_THREAD_SLEEP(ms) boost::this_thread::sleep(boost::posix_time::millisec(ms))
 #else
 #define OGRE_WQ_LOCK_MUTEX(name) boost::unique_lock<boost::recursive_mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
 #define OGRE_WQ_LOCK_MUTEX_NAMED(mutexName, lockName) boost::unique_lock<boost::recursive_mutex> lockName(mutexName)
 #define OGRE_WQ_THREAD_SYNCHRONISER(sync) boost::condition_variable_any sync
+#define OGRE_WQ_THREAD_SLEEP(ms) boost::this_thread::sleep_for(boost::chrono::milliseconds(ms))
 #endif
+#define OGRE_WQ_STATIC_MUTEX(name) static boost::recursive_mutex name
+
+// Thread-local pointer, also available when only the work queue is threaded
+#define OGRE_WQ_THREAD_POINTER_VAR(T, var) boost::thread_specific_ptr<T> var (&deletePtr<T>)
+#define OGRE_WQ_THREAD_POINTER_SET(var, expr) var.reset(expr)
+#define OGRE_WQ_THREAD_POINTER_GET(var) var.get()
+#define OGRE_WQ_THREAD_POINTER_DELETE(var) var.reset(0)
 
 #if OGRE_THREAD_SUPPORT != 3
 #if BOOST_THREAD_VERSION < 4
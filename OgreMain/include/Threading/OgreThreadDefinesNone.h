@@ -30,6 +30,8 @@ THE SOFTWARE
 #define OGRE_THREAD_HARDWARE_CONCURRENCY 1
 #define OGRE_THREAD_CURRENT_ID "main"
 #define OGRE_THREAD_WORKER_INHERIT
+#define OGRE_WQ_THREAD_YIELD
+#define OGRE_WQ_THREAD_SLEEP(ms)
 
 // will be defined by the respective thread provider
 #define OGRE_WQ_MUTEX(name)
@@ -39,10 +41,19 @@ THE SOFTWARE
 #define OGRE_WQ_RW_MUTEX(name)
 #define OGRE_WQ_LOCK_RW_MUTEX_READ(name)
 #define OGRE_WQ_LOCK_RW_MUTEX_WRITE(name)
+#define OGRE_WQ_SHARED_MUTEX(name)
+#define OGRE_WQ_LOCK_SHARED_MUTEX_READ(name)
+#define OGRE_WQ_LOCK_SHARED_MUTEX_WRITE(name)
 
 #define OGRE_WQ_THREAD_SYNCHRONISER(sync)
 #define OGRE_THREAD_NOTIFY_ONE(sync)
 #define OGRE_THREAD_NOTIFY_ALL(sync)
+#define OGRE_WQ_STATIC_MUTEX(name)
+
+#define OGRE_WQ_THREAD_POINTER_VAR(T, var) T* var = 0
+#define OGRE_WQ_THREAD_POINTER_SET(var, expr) var = expr
+#define OGRE_WQ_THREAD_POINTER_GET(var) var
+#define OGRE_WQ_THREAD_POINTER_DELETE(var) do { OGRE_DELETE var; var = 0; } while (0)
 #endif
 
 #define OGRE_AUTO_MUTEX
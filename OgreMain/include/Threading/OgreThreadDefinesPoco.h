@@ -35,6 +35,9 @@ THE SOFTWARE
 #define OGRE_THREAD_DESTROY(name) OGRE_DELETE_T(name, Thread, MEMCATEGORY_GENERAL)
 #define OGRE_THREAD_HARDWARE_CONCURRENCY Poco::Environment::processorCount()
 #define OGRE_THREAD_CURRENT_ID (size_t)Poco::Thread::current()
+#define OGRE_WQ_THREAD_ID_TYPE size_t
+#define OGRE_WQ_THREAD_YIELD Poco::Thread::yield()
+#define OGRE_WQ_THREAD_SLEEP(ms) Poco::Thread::sleep(ms)
 #define OGRE_THREAD_WORKER_INHERIT : public Poco::Runnable
 
 #define OGRE_WQ_MUTEX(name) mutable Poco::Mutex name
@@ -45,11 +48,21 @@ THE SOFTWARE
 #define OGRE_WQ_RW_MUTEX(name) mutable Poco::RWLock name
 #define OGRE_WQ_LOCK_RW_MUTEX_READ(name) Poco::RWLock::ScopedLock OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name, false)
 #define OGRE_WQ_LOCK_RW_MUTEX_WRITE(name) Poco::RWLock::ScopedLock OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name, true)
+#define OGRE_WQ_SHARED_MUTEX(name) OGRE_WQ_RW_MUTEX(name)
+#define OGRE_WQ_LOCK_SHARED_MUTEX_READ(name) OGRE_WQ_LOCK_RW_MUTEX_READ(name)
+#define OGRE_WQ_LOCK_SHARED_MUTEX_WRITE(name) OGRE_WQ_LOCK_RW_MUTEX_WRITE(name)
 
 #define OGRE_WQ_THREAD_SYNCHRONISER(sync) Poco::Condition sync
 #define OGRE_THREAD_WAIT(sync, mutex, lock) sync.wait(mutex)
 #define OGRE_THREAD_NOTIFY_ONE(sync) sync.signal()
 #define OGRE_THREAD_NOTIFY_ALL(sync) sync.broadcast()
+#define OGRE_WQ_STATIC_MUTEX(name) static Poco::Mutex name
+
+// Thread-local pointer, also available when only the work queue is threaded
+#define OGRE_WQ_THREAD_POINTER_VAR(T, var) Poco::ThreadLocal<SharedPtr<T> > var
+#define OGRE_WQ_THREAD_POINTER_GET(var) var.get().get()
+#define OGRE_WQ_THREAD_POINTER_SET(var, expr) do { var.get().reset(); var.get().bind(expr); } while (0)
+#define OGRE_WQ_THREAD_POINTER_DELETE(var) var.get().reset()
 
 #if OGRE_THREAD_SUPPORT != 3
 #define OGRE_AUTO_MUTEX mutable Poco::Mutex OGRE_AUTO_MUTEX_NAME
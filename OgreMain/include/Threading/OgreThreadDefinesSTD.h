@@ -35,23 +35,37 @@ THE SOFTWARE
 #define OGRE_THREAD_DESTROY(name) OGRE_DELETE_T(name, thread, MEMCATEGORY_GENERAL)
 #define OGRE_THREAD_HARDWARE_CONCURRENCY std::thread::hardware_concurrency()
 #define OGRE_THREAD_CURRENT_ID std::this_thread::get_id()
+#define OGRE_WQ_THREAD_ID_TYPE std::thread::id
+#define OGRE_WQ_THREAD_YIELD std::this_thread::yield()
+#define OGRE_WQ_THREAD_SLEEP(ms) std::this_thread::sleep_for(std::chrono::milliseconds(ms))
 #define OGRE_THREAD_WORKER_INHERIT
 
 #define OGRE_WQ_MUTEX(name) mutable std::recursive_mutex name
 #define OGRE_WQ_LOCK_MUTEX(name) std::unique_lock<std::recursive_mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
 #define OGRE_WQ_LOCK_MUTEX_NAMED(mutexName, lockName) std::unique_lock<std::recursive_mutex> lockName(mutexName)
 
-// Read-write mutex
 #define OGRE_WQ_RW_MUTEX(name) mutable std::recursive_mutex name
 #define OGRE_WQ_LOCK_RW_MUTEX_READ(name) std::unique_lock<std::recursive_mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
 #define OGRE_WQ_LOCK_RW_MUTEX_WRITE(name) std::unique_lock<std::recursive_mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
 
+// Shared mutex, readers only share it from C++14 on. Never recursive, not even for the writer
+#if __cplusplus >= 201402L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+#define OGRE_WQ_SHARED_MUTEX(name) mutable std::shared_timed_mutex name
+#define OGRE_WQ_LOCK_SHARED_MUTEX_READ(name) std::shared_lock<std::shared_timed_mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
+#define OGRE_WQ_LOCK_SHARED_MUTEX_WRITE(name) std::unique_lock<std::shared_timed_mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
+#else
+#define OGRE_WQ_SHARED_MUTEX(name) mutable std::mutex name
+#define OGRE_WQ_LOCK_SHARED_MUTEX_READ(name) std::unique_lock<std::mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
+#define OGRE_WQ_LOCK_SHARED_MUTEX_WRITE(name) std::unique_lock<std::mutex> OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name)
+#endif
+
 #define OGRE_WQ_THREAD_SYNCHRONISER(sync) std::condition_variable_any sync
 #define OGRE_THREAD_WAIT(sync, mutex, lock) sync.wait(lock)
 #define OGRE_THREAD_NOTIFY_ONE(sync) sync.notify_one()
 #define OGRE_THREAD_NOTIFY_ALL(sync) sync.notify_all()
 
-#if OGRE_THREAD_SUPPORT != 3
+#define OGRE_WQ_STATIC_MUTEX(name) static std::recursive_mutex name
+
 namespace Ogre
 {
     /// wrapper around `thread_local std::unique_ptr<T>`
@@ -86,6 +100,9 @@ namespace Ogre
 
         inline T* get() const
         {
+            // threads which never set this pointer have no slot for it yet
+            if (_getVect().size() <= m_LocalID)
+                return 0;
             return _get().get();
         }
 
@@ -107,6 +124,13 @@ namespace Ogre
     thread_local std::size_t ThreadLocalPtr<T>::m_VarCounter = 0;
 }
 
+// Thread-local pointer, also available when only the work queue is threaded
+#define OGRE_WQ_THREAD_POINTER_VAR(T, var) Ogre::ThreadLocalPtr<T> var
+#define OGRE_WQ_THREAD_POINTER_SET(var, expr) var.reset(expr)
+#define OGRE_WQ_THREAD_POINTER_GET(var) var.get()
+#define OGRE_WQ_THREAD_POINTER_DELETE(var) var.reset(0)
+
+#if OGRE_THREAD_SUPPORT != 3
 #define OGRE_LOCK_AUTO_MUTEX std::unique_lock<std::recursive_mutex> ogreAutoMutexLock(OGRE_AUTO_MUTEX_NAME)
 #define OGRE_THREAD_SLEEP(ms) std::this_thread::sleep_for(std::chrono::milliseconds(ms))
 
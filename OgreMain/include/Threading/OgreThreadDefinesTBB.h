@@ -31,6 +31,9 @@ THE SOFTWARE
 
 #define OGRE_THREAD_HARDWARE_CONCURRENCY tbb::task_scheduler_init::default_num_threads()
 #define OGRE_THREAD_CURRENT_ID tbb::this_tbb_thread::get_id()
+#define OGRE_WQ_THREAD_ID_TYPE tbb::tbb_thread::id
+#define OGRE_WQ_THREAD_YIELD tbb::this_tbb_thread::yield()
+#define OGRE_WQ_THREAD_SLEEP(ms) tbb::this_tbb_thread::sleep(tbb::tick_count::interval_t(double(ms)/1000))
 #define OGRE_THREAD_WORKER_INHERIT
 
 #define OGRE_WQ_MUTEX(name) mutable tbb::recursive_mutex name
@@ -41,6 +44,16 @@ THE SOFTWARE
 #define OGRE_WQ_RW_MUTEX(name) mutable tbb::queuing_rw_mutex name
 #define OGRE_WQ_LOCK_RW_MUTEX_READ(name) tbb::queuing_rw_mutex::scoped_lock OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name, false)
 #define OGRE_WQ_LOCK_RW_MUTEX_WRITE(name) tbb::queuing_rw_mutex::scoped_lock OGRE_TOKEN_PASTE_EXTRA(ogrenameLock, __LINE__) (name, true)
+#define OGRE_WQ_SHARED_MUTEX(name) OGRE_WQ_RW_MUTEX(name)
+#define OGRE_WQ_LOCK_SHARED_MUTEX_READ(name) OGRE_WQ_LOCK_RW_MUTEX_READ(name)
+#define OGRE_WQ_LOCK_SHARED_MUTEX_WRITE(name) OGRE_WQ_LOCK_RW_MUTEX_WRITE(name)
+#define OGRE_WQ_STATIC_MUTEX(name) static tbb::recursive_mutex name
+
+// Thread-local pointer, also available when only the work queue is threaded
+#define OGRE_WQ_THREAD_POINTER_VAR(T, var) tbb::enumerable_thread_specific<SharedPtr<T> > var
+#define OGRE_WQ_THREAD_POINTER_GET(var) var.local().get()
+#define OGRE_WQ_THREAD_POINTER_SET(var, expr) do { var.local().reset(); var.local().bind(expr); } while (0)
+#define OGRE_WQ_THREAD_POINTER_DELETE(var) var.local().reset()
 
 #if OGRE_THREAD_SUPPORT != 3
 #define OGRE_AUTO_MUTEX mutable tbb::recursive_mutex OGRE_AUTO_MUTEX_NAME
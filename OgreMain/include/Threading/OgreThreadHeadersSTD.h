@@ -30,5 +30,8 @@ THE SOFTWARE
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#if __cplusplus >= 201402L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+#include <shared_mutex>
+#endif
 
 #endif
@@ -0,0 +1,218 @@
+/*-------------------------------------------------------------------------
+This source file is a part of OGRE
+(Object-oriented Graphics Rendering Engine)
+
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+-------------------------------------------------------------------------*/
+#ifndef __OgreWorkStealingQueue_H__
+#define __OgreWorkStealingQueue_H__
+
+#include "../OgreWorkQueue.h"
+#include "../OgreAtomicScalar.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Work queue which schedules requests over per-worker queues with work stealing.
+    @remarks
+        DefaultWorkQueue passes every request through one shared, locked queue,
+        which the workers and all posting threads contend on. This queue gives each
+        worker thread its own queues instead: requests posted from a worker thread
+        go to its own queues, requests from other threads are spread over the
+        workers in turn, and a worker which runs out of work steals from the
+        others. Requests are picked by the priority of their channel first, see
+        setChannelPriority. Channel worker limits and statistics are not
+        supported, they would need the shared queue this class avoids.
+    @par
+        On top of requests, the queue runs lightweight Task objects through fork
+        and join, for fine grained fork / join parallelism which does not need the
+        channel, handler and response machinery. Threads waiting in join process
+        queued tasks meanwhile, so tasks may fork and join further tasks.
+    @par
+        Install it with Root::setWorkQueue. Without OGRE_THREAD_SUPPORT, requests
+        are processed synchronously and forked tasks run immediately, like
+        DefaultWorkQueue does.
+    */
+    class _OgreExport WorkStealingQueue : public DefaultWorkQueueBase
+    {
+    public:
+        /** A unit of work run through fork and join.
+        @remarks
+            Unlike requests, tasks have no channel, handler or response; the thread
+            joining the task group picks up the results.
+        */
+        class _OgreExport Task
+        {
+        public:
+            virtual ~Task() {}
+            /// Do the work, called on a worker thread or on a thread waiting in join
+            virtual void execute() = 0;
+        };
+
+        /// Set of forked tasks waited for together by join
+        class _OgreExport TaskGroup
+        {
+            friend class WorkStealingQueue;
+            AtomicScalar<size_t> mPending;
+        public:
+            TaskGroup() : mPending(0) {}
+            /// Returns whether all tasks forked into this group have completed
+            bool isComplete() const { return mPending.load() == 0; }
+        };
+
+        WorkStealingQueue(const String& name = BLANKSTRING);
+        virtual ~WorkStealingQueue();
+
+        /// Main function for each thread spawned.
+        virtual void _threadMain();
+
+        /// @copydoc WorkQueue::shutdown
+        virtual void shutdown();
+
+        /// @copydoc WorkQueue::startup
+        virtual void startup(bool forceRestart = true);
+
+        /// @copydoc WorkQueue::addRequest
+        virtual RequestID addRequest(uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount = 0, 
+            bool forceSynchronous = false, bool idleThread = false);
+        /// @copydoc WorkQueue::abortRequest
+        virtual void abortRequest(RequestID id);
+        /// @copydoc WorkQueue::abortRequestsByChannel
+        virtual void abortRequestsByChannel(uint16 channel);
+        /// @copydoc WorkQueue::abortPendingRequestsByChannel
+        virtual void abortPendingRequestsByChannel(uint16 channel);
+        /// @copydoc WorkQueue::abortAllRequests
+        virtual void abortAllRequests();
+        /// @copydoc WorkQueue::promoteRequest
+        virtual void promoteRequest(RequestID id);
+        /// @copydoc WorkQueue::_processParallelJob
+        virtual void _processParallelJob(const ParallelJobPtr& job);
+
+        /** Queue a task for asynchronous execution as part of the given group.
+        @remarks
+            The task must stay alive until join returns for the group. Forking from a
+            worker thread queues the task on that worker, so it is likely to run
+            while the data it works on is still in cache. If the queue is not
+            running, the task is executed immediately.
+        */
+        void fork(Task* task, TaskGroup& group);
+
+        /** Wait until all tasks of the group have completed.
+        @remarks
+            The calling thread executes queued tasks, of any group, while it waits.
+            It never processes requests, so joining from the main thread does not
+            make it run long background work.
+        */
+        void join(TaskGroup& group);
+
+        /** Returns the queue installed in Root, if it is a WorkStealingQueue.
+        @remarks
+            Allows engine code to use fork and join when available, and fall back to
+            serial execution otherwise.
+        */
+        static WorkStealingQueue* getRootQueue();
+
+    protected:
+        typedef std::pair<Task*, TaskGroup*> QueuedTask;
+        typedef deque<QueuedTask>::type TaskDeque;
+
+        /// Queues of one worker, guarded by its mutex
+        struct Worker : public UtilityAlloc
+        {
+            OGRE_WQ_MUTEX(mutex);
+            /// Forked tasks, the owner takes from the back and thieves from the front
+            TaskDeque tasks;
+            /// Requests for each priority, taken in order
+            RequestQueue requests[PRIORITY_COUNT];
+            /// Request being processed, so it can be aborted
+            Request* current;
+#if OGRE_THREAD_SUPPORT
+            OGRE_WQ_THREAD_ID_TYPE threadId;
+            OGRE_THREAD_TYPE* thread;
+#endif
+            Worker() : current(0) {}
+        };
+        typedef vector<Worker*>::type WorkerList;
+        WorkerList mWorkers;
+
+        /// Number of requests and tasks in the worker queues
+        AtomicScalar<size_t> mPendingCount;
+        /// Wake-ups for the queues of the base class (idle requests and retries)
+        AtomicScalar<size_t> mBaseSignals;
+        /// Number of workers blocked waiting for work
+        AtomicScalar<size_t> mSleepingCount;
+        /// Worker which receives the next request or task from a non-worker thread
+        AtomicScalar<size_t> mNextWorker;
+        /// Index handed out to the next worker thread starting up
+        AtomicScalar<size_t> mNextWorkerIndex;
+        /// Identifier of the next request
+        AtomicScalar<RequestID> mNextRequestID;
+
+        OGRE_WQ_MUTEX(mWakeMutex);
+        OGRE_WQ_THREAD_SYNCHRONISER(mWakeCondition);
+
+        /// Number of workers which have started and registered with the render system if needed
+        size_t mNumThreadsRegistered;
+        OGRE_WQ_MUTEX(mInitMutex);
+        OGRE_WQ_THREAD_SYNCHRONISER(mInitSync);
+
+        /// Returns the worker running on the calling thread, or null
+        Worker* getCurrentWorker() const;
+        /// Returns the worker new items from the calling thread go to
+        Worker* getTargetWorker();
+
+        /// Queue a request on a worker and wake a sleeping worker
+        void queueRequest(Request* r);
+        /// Wake a worker if one is sleeping, after adding work
+        void wakeWorker();
+
+        /// Take a task, from the given worker's own queue first if not null
+        bool takeTask(Worker* self, QueuedTask& task);
+        /// Take a request by priority, from the given worker's own queues first
+        Request* takeRequest(Worker* self);
+        /// Sleep until there may be work, returns false when shutting down
+        bool waitForWork();
+
+        /// Processes a request taken from a worker queue
+        void processWorkerRequest(Worker* worker, Request* r);
+        /// Runs a task and signals its group
+        void runTask(const QueuedTask& task);
+
+        /// Abort the queued and current requests of the workers matching the given test
+        template <typename Pred> void abortWorkerRequests(Pred pred);
+
+        /// @copydoc DefaultWorkQueueBase::notifyWorkers
+        virtual void notifyWorkers();
+    };
+
+    /** @} */
+    /** @} */
+
+}
+
+#endif
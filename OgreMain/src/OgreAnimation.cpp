@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreSkeleton.h"
 #include "OgreBone.h"
 #include "OgreMesh.h"
+#include "OgreOptimisedUtil.h"
 
 #include "OgreSubEntity.h"
 
@@ -48,6 +49,7 @@ namespace Ogre {
         , mInterpolationMode(msDefaultInterpolationMode)
         , mRotationInterpolationMode(msDefaultRotationInterpolationMode)
         , mKeyFrameTimesDirty(false)
+        , mBatchedNodeTracksDirty(true)
         , mUseBaseKeyFrame(false)
         , mBaseKeyFrameTime(0.0f)
         , mBaseKeyFrameAnimationName(BLANKSTRING)
@@ -348,12 +350,18 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void Animation::apply(Skeleton* skel, Real timePos, Real weight, 
-        Real scale)
+        Real scale, uint* keyFrameIndexHint)
     {
         _applyBaseKeyFrame();
 
         // Calculate time index for fast keyframe search
-        TimeIndex timeIndex = _getTimeIndex(timePos);
+        TimeIndex timeIndex = _getTimeIndex(timePos, keyFrameIndexHint);
+
+        if (canApplyBatchedNodeTracks())
+        {
+            applyBatchedNodeTracks(skel, timeIndex, weight, 0, scale);
+            return;
+        }
 
         NodeTrackList::iterator i;
         for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
@@ -367,12 +375,18 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void Animation::apply(Skeleton* skel, Real timePos, float weight,
-      const AnimationState::BoneBlendMask* blendMask, Real scale)
+      const AnimationState::BoneBlendMask* blendMask, Real scale, uint* keyFrameIndexHint)
     {
         _applyBaseKeyFrame();
 
         // Calculate time index for fast keyframe search
-      TimeIndex timeIndex = _getTimeIndex(timePos);
+      TimeIndex timeIndex = _getTimeIndex(timePos, keyFrameIndexHint);
+
+      if (canApplyBatchedNodeTracks())
+      {
+        applyBatchedNodeTracks(skel, timeIndex, weight, blendMask, scale);
+        return;
+      }
 
       NodeTrackList::iterator i;
       for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
@@ -525,6 +539,19 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    size_t Animation::reduceKeyFrames(Real positionTolerance, const Radian& orientationTolerance,
+        Real scaleTolerance)
+    {
+        size_t removed = 0;
+        NodeTrackList::iterator i, iend;
+        iend = mNodeTrackList.end();
+        for (i = mNodeTrackList.begin(); i != iend; ++i)
+        {
+            removed += i->second->reduceKeyFrames(positionTolerance, orientationTolerance, scaleTolerance);
+        }
+        return removed;
+    }
+    //-----------------------------------------------------------------------
     void Animation::_collectIdentityNodeTracks(TrackHandleList& tracks) const
     {
         NodeTrackList::const_iterator i, iend;
@@ -634,7 +661,7 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
-    TimeIndex Animation::_getTimeIndex(Real timePos) const
+    TimeIndex Animation::_getTimeIndex(Real timePos, uint* keyIndexHint) const
     {
         // Uncomment following statement for work as previous
         //return timePos;
@@ -651,11 +678,31 @@ namespace Ogre {
         if( timePos > totalAnimationLength && totalAnimationLength > 0.0f )
             timePos = fmod( timePos, totalAnimationLength );
 
+        // Check the hint and the following index first, the time usually advances
+        // only slightly between the evaluations of an animation state
+        if (keyIndexHint)
+        {
+            uint numKeyFrameTimes = static_cast<uint>(mKeyFrameTimes.size());
+            for (uint index = *keyIndexHint; index <= numKeyFrameTimes && index <= *keyIndexHint + 1; ++index)
+            {
+                if ((index == numKeyFrameTimes || timePos <= mKeyFrameTimes[index]) &&
+                    (index == 0 || mKeyFrameTimes[index - 1] < timePos))
+                {
+                    *keyIndexHint = index;
+                    return TimeIndex(timePos, index);
+                }
+            }
+        }
+
         // Search for global index
         KeyFrameTimeList::iterator it =
             std::lower_bound(mKeyFrameTimes.begin(), mKeyFrameTimes.end(), timePos);
+        uint keyIndex = static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it));
+
+        if (keyIndexHint)
+            *keyIndexHint = keyIndex;
 
-        return TimeIndex(timePos, static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it)));
+        return TimeIndex(timePos, keyIndex);
     }
     //-----------------------------------------------------------------------
     void Animation::buildKeyFrameTimeList(void) const
@@ -699,6 +746,192 @@ namespace Ogre {
         mKeyFrameTimesDirty = false;
     }
     //-----------------------------------------------------------------------
+    void Animation::buildBatchedNodeTracks(void) const
+    {
+        mBatchedNodeTracks.clear();
+        mBatchedKeyFrames.clear();
+        mBatchedKeyFrameIndexMap.clear();
+
+        size_t numKeyFrameTimes = mKeyFrameTimes.size();
+        NodeTrackList::const_iterator i;
+        for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        {
+            NodeAnimationTrack* track = i->second;
+            unsigned short numKeyFrames = track->getNumKeyFrames();
+            // Tracks without keyframes have no effect
+            if (!numKeyFrames)
+                continue;
+
+            BatchedNodeTrack batched;
+            batched.track = track;
+            batched.handle = i->first;
+            batched.numKeyFrames = numKeyFrames;
+            batched.useShortestRotationPath = track->getUseShortestRotationPath();
+            batched.keyFrameOffset = mBatchedKeyFrames.size();
+            batched.keyFrameIndexMapOffset = mBatchedKeyFrameIndexMap.size();
+            mBatchedNodeTracks.push_back(batched);
+
+            // Pack keyframes in the layout of OptimisedUtil::blendTransformKeyFrames
+            mBatchedKeyFrames.resize(batched.keyFrameOffset + numKeyFrames * 12);
+            float* dest = &mBatchedKeyFrames[batched.keyFrameOffset];
+            for (unsigned short k = 0; k < numKeyFrames; ++k, dest += 12)
+            {
+                const TransformKeyFrame* kf = track->getNodeKeyFrame(k);
+                const Quaternion& rotation = kf->getRotation();
+                const Vector3& translate = kf->getTranslate();
+                const Vector3& scale = kf->getScale();
+                dest[0] = rotation.w;
+                dest[1] = rotation.x;
+                dest[2] = rotation.y;
+                dest[3] = rotation.z;
+                dest[4] = translate.x;
+                dest[5] = translate.y;
+                dest[6] = translate.z;
+                dest[7] = kf->getTime();
+                dest[8] = scale.x;
+                dest[9] = scale.y;
+                dest[10] = scale.z;
+                dest[11] = 0;
+            }
+
+            // Global to local keyframe index map, same as AnimationTrack::_buildKeyFrameIndexMap
+            size_t k = 0, j = 0;
+            while (j <= numKeyFrameTimes)
+            {
+                mBatchedKeyFrameIndexMap.push_back(static_cast<ushort>(k));
+                while (k < numKeyFrames && track->getNodeKeyFrame(static_cast<ushort>(k))->getTime() <= mKeyFrameTimes[j])
+                    ++k;
+                ++j;
+            }
+        }
+
+        mBatchedNodeTracksDirty = false;
+    }
+    //-----------------------------------------------------------------------
+    bool Animation::canApplyBatchedNodeTracks(void) const
+    {
+        // Only linear interpolation with normalised linear rotation blending
+        // maps exactly onto the batched kernel
+        return mInterpolationMode == IM_LINEAR && mRotationInterpolationMode == RIM_LINEAR;
+    }
+    //-----------------------------------------------------------------------
+    /** Applies the transforms computed by OptimisedUtil::blendTransformKeyFrames
+        to the bones, the same way NodeAnimationTrack::applyToNode does.
+    */
+    static void _applyBlendedTransforms(Bone* const* bones, const float* transforms, size_t numTransforms)
+    {
+        for (size_t i = 0; i < numTransforms; ++i, transforms += 12)
+        {
+            Bone* bone = bones[i];
+            bone->translate(Vector3(transforms[4], transforms[5], transforms[6]));
+            bone->rotate(Quaternion(transforms[0], transforms[1], transforms[2], transforms[3]));
+            bone->scale(Vector3(transforms[8], transforms[9], transforms[10]));
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Animation::applyBatchedNodeTracks(Skeleton* skel, const TimeIndex& timeIndex, float weight,
+        const AnimationState::BoneBlendMask* blendMask, Real scale)
+    {
+        if (mBatchedNodeTracksDirty)
+        {
+            buildBatchedNodeTracks();
+        }
+
+        // Bones are blended in batches, kept on the stack since several
+        // skeletons may be animated concurrently
+        static const size_t BATCH_SIZE = 64;
+        Bone* bones[BATCH_SIZE];
+        const float* keyFrames1[BATCH_SIZE];
+        const float* keyFrames2[BATCH_SIZE];
+        float interpolations[BATCH_SIZE];
+        float weights[BATCH_SIZE];
+        float transforms[BATCH_SIZE * 12];
+        size_t numBatched = 0;
+        bool useShortestRotationPath = true;
+
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        Real timePos = timeIndex.getTimePos();
+        uint keyIndex = timeIndex.getKeyIndex();
+
+        BatchedNodeTrackList::const_iterator i, iend = mBatchedNodeTracks.end();
+        for (i = mBatchedNodeTracks.begin(); i != iend; ++i)
+        {
+            const BatchedNodeTrack& batched = *i;
+            Bone* b = skel->getBone(batched.handle);
+            float boneWeight = blendMask ? (*blendMask)[b->getHandle()] * weight : weight;
+            if (!boneWeight)
+                continue;
+
+            // Listeners may override the keyframes, use the regular path
+            if (batched.track->getListener())
+            {
+                batched.track->applyToNode(b, timeIndex, boneWeight, scale);
+                continue;
+            }
+
+            // Flush the batch when full or when the rotation path option changes
+            if (numBatched == BATCH_SIZE ||
+                (numBatched && batched.useShortestRotationPath != useShortestRotationPath))
+            {
+                util->blendTransformKeyFrames(keyFrames1, keyFrames2, interpolations, weights,
+                    scale, useShortestRotationPath, transforms, numBatched);
+                _applyBlendedTransforms(bones, transforms, numBatched);
+                numBatched = 0;
+            }
+            useShortestRotationPath = batched.useShortestRotationPath;
+
+            // Find the keyframes, same as AnimationTrack::getKeyFramesAtTime
+            const float* keyFrames = &mBatchedKeyFrames[batched.keyFrameOffset];
+            size_t k = mBatchedKeyFrameIndexMap[batched.keyFrameIndexMapOffset + keyIndex];
+            const float* k1;
+            const float* k2;
+            Real t1, t2;
+            if (k == batched.numKeyFrames)
+            {
+                // There is no keyframe after this time, wrap back to first
+                k2 = keyFrames;
+                t2 = mLength + k2[7];
+
+                // Use last keyframe as previous keyframe
+                --k;
+            }
+            else
+            {
+                k2 = keyFrames + k * 12;
+                t2 = k2[7];
+
+                // Find last keyframe before or on current time
+                if (k != 0 && timePos < t2)
+                    --k;
+            }
+            k1 = keyFrames + k * 12;
+            t1 = k1[7];
+
+            bones[numBatched] = b;
+            keyFrames1[numBatched] = k1;
+            if (t1 == t2)
+            {
+                // Same KeyFrame (only one)
+                keyFrames2[numBatched] = k1;
+                interpolations[numBatched] = 0;
+            }
+            else
+            {
+                keyFrames2[numBatched] = k2;
+                interpolations[numBatched] = static_cast<float>((timePos - t1) / (t2 - t1));
+            }
+            weights[numBatched] = boneWeight;
+            ++numBatched;
+        }
+
+        if (numBatched)
+        {
+            util->blendTransformKeyFrames(keyFrames1, keyFrames2, interpolations, weights,
+                scale, useShortestRotationPath, transforms, numBatched);
+            _applyBlendedTransforms(bones, transforms, numBatched);
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::setUseBaseKeyFrame(bool useBaseKeyFrame, Real keyframeTime, const String& baseAnimName)
     {
         if (useBaseKeyFrame != mUseBaseKeyFrame ||
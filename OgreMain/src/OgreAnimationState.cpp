@@ -43,6 +43,7 @@ namespace Ogre
         , mWeight(rhs.mWeight)
         , mEnabled(rhs.mEnabled)
         , mLoop(rhs.mLoop)
+        , mKeyFrameIndexHint(0)
   {
         mParent->_notifyDirty();
     }
@@ -58,6 +59,7 @@ namespace Ogre
         , mWeight(weight)
         , mEnabled(enabled)
         , mLoop(true)
+        , mKeyFrameIndexHint(0)
     {
         mParent->_notifyDirty();
     }
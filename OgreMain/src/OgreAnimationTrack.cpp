@@ -558,6 +558,7 @@ namespace Ogre {
     void NodeAnimationTrack::setUseShortestRotationPath(bool useShortestPath)
     {
         mUseShortestRotationPath = useShortestPath ;
+        mParent->_keyFrameDataChanged();
     }
 
     //---------------------------------------------------------------------
@@ -569,6 +570,7 @@ namespace Ogre {
     void NodeAnimationTrack::_keyFrameDataChanged(void) const
     {
         mSplineBuildNeeded = true;
+        mParent->_keyFrameDataChanged();
     }
     //---------------------------------------------------------------------
     bool NodeAnimationTrack::hasNonZeroKeyFrames(void) const
@@ -653,6 +655,82 @@ namespace Ogre {
         }
 
 
+    }
+    //--------------------------------------------------------------------------
+    size_t NodeAnimationTrack::reduceKeyFrames(Real positionTolerance,
+        const Radian& orientationTolerance, Real scaleTolerance)
+    {
+        size_t count = mKeyFrames.size();
+        if (count < 3)
+            return 0;
+
+        // rotations within the angle have a dot product of at least the cosine of half of it
+        Real orientationDotTolerance = Math::Cos(orientationTolerance * 0.5f);
+
+        // extend each segment from the last kept keyframe as far as possible
+        vector<bool>::type keep(count, false);
+        keep[0] = true;
+        size_t first = 0;
+        while (first < count - 1)
+        {
+            size_t last = first + 1;
+            while (last + 1 < count && isInterpolatable(first, last + 1,
+                positionTolerance, orientationDotTolerance, scaleTolerance))
+            {
+                ++last;
+            }
+            keep[last] = true;
+            first = last;
+        }
+
+        KeyFrameList kept;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (keep[i])
+                kept.push_back(mKeyFrames[i]);
+            else
+                OGRE_DELETE mKeyFrames[i];
+        }
+
+        size_t removed = count - kept.size();
+        if (removed)
+        {
+            mKeyFrames.swap(kept);
+            _keyFrameDataChanged();
+            mParent->_keyFrameListChanged();
+        }
+        return removed;
+    }
+    //--------------------------------------------------------------------------
+    bool NodeAnimationTrack::isInterpolatable(size_t first, size_t last, Real positionTolerance,
+        Real orientationDotTolerance, Real scaleTolerance) const
+    {
+        const TransformKeyFrame* k1 = static_cast<const TransformKeyFrame*>(mKeyFrames[first]);
+        const TransformKeyFrame* k2 = static_cast<const TransformKeyFrame*>(mKeyFrames[last]);
+        Real duration = k2->getTime() - k1->getTime();
+        bool spherical = mParent->getRotationInterpolationMode() == Animation::RIM_SPHERICAL;
+
+        for (size_t i = first + 1; i < last; ++i)
+        {
+            const TransformKeyFrame* k = static_cast<const TransformKeyFrame*>(mKeyFrames[i]);
+            Real t = duration > 0 ? (k->getTime() - k1->getTime()) / duration : 0;
+
+            Vector3 translate = k1->getTranslate() + (k2->getTranslate() - k1->getTranslate()) * t;
+            if (translate.squaredDistance(k->getTranslate()) > positionTolerance * positionTolerance)
+                return false;
+
+            Vector3 scale = k1->getScale() + (k2->getScale() - k1->getScale()) * t;
+            if (scale.squaredDistance(k->getScale()) > scaleTolerance * scaleTolerance)
+                return false;
+
+            Quaternion rotation = spherical ?
+                Quaternion::Slerp(t, k1->getRotation(), k2->getRotation(), mUseShortestRotationPath) :
+                Quaternion::nlerp(t, k1->getRotation(), k2->getRotation(), mUseShortestRotationPath);
+            // q and -q are the same rotation
+            if (Math::Abs(rotation.Dot(k->getRotation())) < orientationDotTolerance)
+                return false;
+        }
+        return true;
     }
     //--------------------------------------------------------------------------
     KeyFrame* NodeAnimationTrack::createKeyFrameImpl(Real time)
@@ -976,7 +1054,7 @@ namespace Ogre {
         else
         {
             // Software
-            Mesh::softwareVertexPoseBlend(influence, pose->getVertexOffsets(), pose->getNormals(), data);
+            Mesh::softwareVertexPoseBlend(influence, pose, data);
         }
 
     }
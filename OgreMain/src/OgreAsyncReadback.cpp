@@ -0,0 +1,65 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreAsyncReadback.h"
+#include "OgreImage.h"
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    void AsyncReadback::copyPixels(const PixelBox& src, const PixelBox& dst)
+    {
+        if (src.getWidth() != dst.getWidth() || src.getHeight() != dst.getHeight() ||
+            src.getDepth() != dst.getDepth())
+        {
+            Image::scale(src, dst, Image::FILTER_BILINEAR);
+        }
+        else
+        {
+            PixelUtil::bulkPixelConversion(src, dst);
+        }
+    }
+    //-----------------------------------------------------------------------
+    MemoryAsyncReadback::MemoryAsyncReadback(uint32 width, uint32 height, uint32 depth,
+        PixelFormat format)
+        : AsyncReadback(width, height, depth, format)
+        , mPixels(width, height, depth, format)
+    {
+        mPixels.data = OGRE_ALLOC_T(uchar, mPixels.getConsecutiveSize(), MEMCATEGORY_GENERAL);
+    }
+    //-----------------------------------------------------------------------
+    MemoryAsyncReadback::~MemoryAsyncReadback()
+    {
+        OGRE_FREE(mPixels.data, MEMCATEGORY_GENERAL);
+    }
+    //-----------------------------------------------------------------------
+    void MemoryAsyncReadback::fetch(const PixelBox& dst)
+    {
+        copyPixels(mPixels, dst);
+    }
+}
@@ -77,8 +77,13 @@ namespace Ogre {
          mCurrentViewport(0), 
          mCurrentSceneManager(0),
          mMainCamBoundsInfo(0),
-         mCurrentPass(0)
+         mCurrentPass(0),
+         mUseIdentityView(false),
+         mUseIdentityProjection(false),
+         mNumAutoConstantsUpdated(0),
+         mNumAutoConstantsSkipped(0)
     {
+        mVariabilityVersions[0] = mVariabilityVersions[1] = mVariabilityVersions[2] = 0;
         mBlankLight.setDiffuseColour(ColourValue::Black);
         mBlankLight.setSpecularColour(ColourValue::Black);
         mBlankLight.setAttenuation(0,1,0,0);
@@ -89,10 +94,37 @@ namespace Ogre {
             mSpotlightViewProjMatrixDirty[i] = true;
             mSpotlightWorldViewProjMatrixDirty[i] = true;
             mCurrentTextureProjector[i] = 0;
+            mTextureProjectorRegion[i] = Vector4(0, 0, 1, 1);
             mShadowCamDepthRangesDirty[i] = false;
         }
 
     }
+    //-----------------------------------------------------------------------------
+    void AutoParamDataSource::markChanged(uint16 variability)
+    {
+        if (variability & GPV_GLOBAL)
+            ++mVariabilityVersions[0];
+        if (variability & GPV_PER_OBJECT)
+            ++mVariabilityVersions[1];
+        if (variability & GPV_LIGHTS)
+            ++mVariabilityVersions[2];
+    }
+    //-----------------------------------------------------------------------------
+    uint32 AutoParamDataSource::getVariabilityVersion(GpuParamVariability variability) const
+    {
+        switch (variability)
+        {
+        case GPV_GLOBAL:
+            return mVariabilityVersions[0];
+        case GPV_PER_OBJECT:
+            return mVariabilityVersions[1];
+        case GPV_LIGHTS:
+            return mVariabilityVersions[2];
+        default:
+            assert(false && "Only GPV_GLOBAL, GPV_PER_OBJECT and GPV_LIGHTS are versioned");
+            return 0;
+        }
+    }
     //-----------------------------------------------------------------------------
 	const Camera* AutoParamDataSource::getCurrentCamera() const
 	{
@@ -134,6 +166,19 @@ namespace Ogre {
             mSpotlightWorldViewProjMatrixDirty[i] = true;
         }
 
+        // The view and projection matrices depend on the renderable too
+        bool useIdentityView = rend && rend->getUseIdentityView();
+        bool useIdentityProjection = rend && rend->getUseIdentityProjection();
+        if (useIdentityView != mUseIdentityView || useIdentityProjection != mUseIdentityProjection)
+        {
+            mUseIdentityView = useIdentityView;
+            mUseIdentityProjection = useIdentityProjection;
+            markChanged(GPV_ALL);
+        }
+        else
+        {
+            markChanged(GPV_PER_OBJECT);
+        }
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentCamera(const Camera* cam, bool useCameraRelative)
@@ -153,6 +198,7 @@ namespace Ogre {
         mCameraPositionDirty = true;
         mLodCameraPositionObjectSpaceDirty = true;
         mLodCameraPositionDirty = true;
+        markChanged(GPV_ALL);
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentLightList(const LightList* ll)
@@ -163,7 +209,7 @@ namespace Ogre {
             mSpotlightViewProjMatrixDirty[i] = true;
             mSpotlightWorldViewProjMatrixDirty[i] = true;
         }
-
+        markChanged(GPV_LIGHTS);
     }
     //---------------------------------------------------------------------
     float AutoParamDataSource::getLightNumber(size_t index) const
@@ -263,11 +309,13 @@ namespace Ogre {
     {
         mMainCamBoundsInfo = info;
         mSceneDepthRangeDirty = true;
+        markChanged(GPV_ALL);
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentSceneManager(const SceneManager* sm)
     {
         mCurrentSceneManager = sm;
+        markChanged(GPV_ALL);
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setWorldMatrices(const Matrix4* m, size_t count)
@@ -275,6 +323,7 @@ namespace Ogre {
         mWorldMatrixArray = m;
         mWorldMatrixCount = count;
         mWorldMatrixDirty = false;
+        markChanged(GPV_PER_OBJECT);
     }
     //-----------------------------------------------------------------------------
     const Matrix4& AutoParamDataSource::getWorldMatrix(void) const
@@ -518,6 +567,7 @@ namespace Ogre {
     void AutoParamDataSource::setAmbientLightColour(const ColourValue& ambient)
     {
         mAmbientLight = ambient;
+        markChanged(GPV_GLOBAL);
     }
     //---------------------------------------------------------------------
     float AutoParamDataSource::getLightCount() const
@@ -538,6 +588,9 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentPass(const Pass* pass)
     {
+        // Derived light colours depend on the pass too
+        if (pass != mCurrentPass)
+            markChanged(GPV_ALL);
         mCurrentPass = pass;
     }
     //-----------------------------------------------------------------------------
@@ -628,6 +681,7 @@ namespace Ogre {
         mFogParams.y = linearStart;
         mFogParams.z = linearEnd;
         mFogParams.w = linearEnd != linearStart ? 1 / (linearEnd - linearStart) : 0;
+        markChanged(GPV_GLOBAL);
     }
     //-----------------------------------------------------------------------------
     const ColourValue& AutoParamDataSource::getFogColour(void) const
@@ -645,11 +699,29 @@ namespace Ogre {
         if (index < OGRE_MAX_SIMULTANEOUS_LIGHTS)
         {
             mCurrentTextureProjector[index] = frust;
+            mTextureProjectorRegion[index] = Vector4(0, 0, 1, 1);
             mTextureViewProjMatrixDirty[index] = true;
             mTextureWorldViewProjMatrixDirty[index] = true;
             mShadowCamDepthRangesDirty[index] = true;
+            markChanged(GPV_ALL);
         }
-
+    }
+    //-----------------------------------------------------------------------------
+    void AutoParamDataSource::setTextureProjectorRegion(const Vector4& region, size_t index)
+    {
+        if (index < OGRE_MAX_SIMULTANEOUS_LIGHTS && mTextureProjectorRegion[index] != region)
+        {
+            mTextureProjectorRegion[index] = region;
+            mTextureViewProjMatrixDirty[index] = true;
+            mTextureWorldViewProjMatrixDirty[index] = true;
+            markChanged(GPV_ALL);
+        }
+    }
+    //-----------------------------------------------------------------------------
+    const Vector4& AutoParamDataSource::getTextureProjectorRegion(size_t index) const
+    {
+        static const Vector4 wholeTexture(0, 0, 1, 1);
+        return index < OGRE_MAX_SIMULTANEOUS_LIGHTS ? mTextureProjectorRegion[index] : wholeTexture;
     }
     //-----------------------------------------------------------------------------
     const Matrix4& AutoParamDataSource::getTextureViewProjMatrix(size_t index) const
@@ -677,6 +749,17 @@ namespace Ogre {
                         mCurrentTextureProjector[index]->getProjectionMatrixWithRSDepth() * 
                         mCurrentTextureProjector[index]->getViewMatrix();
                 }
+                const Vector4& region = mTextureProjectorRegion[index];
+                if (region != Vector4(0, 0, 1, 1))
+                {
+                    // squeeze the texture coordinates into the region, before the divide by w
+                    Matrix4 toRegion(
+                        region.z - region.x, 0, 0, region.x,
+                        0, region.w - region.y, 0, region.y,
+                        0, 0, 1, 0,
+                        0, 0, 0, 1);
+                    mTextureViewProjMatrix[index] = toRegion * mTextureViewProjMatrix[index];
+                }
                 mTextureViewProjMatrixDirty[index] = false;
             }
             return mTextureViewProjMatrix[index];
@@ -798,6 +881,7 @@ namespace Ogre {
     void AutoParamDataSource::setCurrentRenderTarget(const RenderTarget* target)
     {
         mCurrentRenderTarget = target;
+        markChanged(GPV_ALL);
     }
     //-----------------------------------------------------------------------------
     const RenderTarget* AutoParamDataSource::getCurrentRenderTarget(void) const
@@ -808,11 +892,13 @@ namespace Ogre {
     void AutoParamDataSource::setCurrentViewport(const Viewport* viewport)
     {
         mCurrentViewport = viewport;
+        markChanged(GPV_ALL);
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setShadowDirLightExtrusionDistance(Real dist)
     {
         mDirLightExtrusionDistance = dist;
+        markChanged(GPV_ALL);
     }
     //-----------------------------------------------------------------------------
     Real AutoParamDataSource::getShadowExtrusionDistance(void) const
@@ -1053,11 +1139,13 @@ namespace Ogre {
     void AutoParamDataSource::setPassNumber(const int passNumber)
     {
         mPassNumber = passNumber;
+        markChanged(GPV_GLOBAL);
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::incPassNumber(void)
     {
         ++mPassNumber;
+        markChanged(GPV_GLOBAL);
     }
     //-----------------------------------------------------------------------------
     const Vector4& AutoParamDataSource::getSceneDepthRange() const
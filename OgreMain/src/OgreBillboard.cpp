@@ -38,6 +38,7 @@ namespace Ogre {
         mOwnDimensions(false),
         mUseTexcoordRect(false),
         mTexcoordIndex(0),
+        mIndex(0),
         mPosition(Vector3::ZERO),
         mDirection(Vector3::ZERO),        
         mParentSet(0),
@@ -54,6 +55,7 @@ namespace Ogre {
         : mOwnDimensions(false)
         , mUseTexcoordRect(false)
         , mTexcoordIndex(0)
+        , mIndex(0)
         , mPosition(position)
         , mDirection(Vector3::ZERO)
         , mParentSet(owner)
@@ -67,11 +69,15 @@ namespace Ogre {
         mRotation = rotation;
         if (mRotation != Radian(0))
             mParentSet->_notifyBillboardRotated();
+        if (mParentSet)
+            mParentSet->_notifyBillboardChanged(mIndex);
     }
     //-----------------------------------------------------------------------
     void Billboard::setPosition(const Vector3& position)
     {
         mPosition = position;
+        if (mParentSet)
+            mParentSet->_notifyBillboardChanged(mIndex);
     }
     //-----------------------------------------------------------------------
     void Billboard::setPosition(Real x, Real y, Real z)
@@ -79,6 +85,8 @@ namespace Ogre {
         mPosition.x = x;
         mPosition.y = y;
         mPosition.z = z;
+        if (mParentSet)
+            mParentSet->_notifyBillboardChanged(mIndex);
     }
     //-----------------------------------------------------------------------
     const Vector3& Billboard::getPosition(void) const
@@ -92,6 +100,14 @@ namespace Ogre {
         mWidth = width;
         mHeight = height;
         mParentSet->_notifyBillboardResized();
+        mParentSet->_notifyBillboardChanged(mIndex);
+    }
+    //-----------------------------------------------------------------------
+    void Billboard::resetDimensions(void)
+    {
+        mOwnDimensions = false;
+        if (mParentSet)
+            mParentSet->_notifyBillboardChanged(mIndex);
     }
     //-----------------------------------------------------------------------
     bool Billboard::hasOwnDimensions(void) const
@@ -107,6 +123,8 @@ namespace Ogre {
     void Billboard::setColour(const ColourValue& colour)
     {
         mColour = colour;
+        if (mParentSet)
+            mParentSet->_notifyBillboardChanged(mIndex);
     }
     //-----------------------------------------------------------------------
     const ColourValue& Billboard::getColour(void) const
@@ -128,12 +146,16 @@ namespace Ogre {
     {
         mTexcoordIndex = texcoordIndex;
         mUseTexcoordRect = false;
+        if (mParentSet)
+            mParentSet->_notifyBillboardChanged(mIndex);
     }
     //-----------------------------------------------------------------------
     void Billboard::setTexcoordRect(const FloatRect& texcoordRect)
     {
         mTexcoordRect = texcoordRect;
         mUseTexcoordRect = true;
+        if (mParentSet)
+            mParentSet->_notifyBillboardChanged(mIndex);
     }
     //-----------------------------------------------------------------------
     void Billboard::setTexcoordRect(Real u0, Real v0, Real u1, Real v1)
@@ -39,6 +39,8 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreLogManager.h"
 #include "OgreViewport.h"
+#include "OgreSceneManager.h"
+#include "OgreBillboardChainBatcher.h"
 
 #include <limits>
 
@@ -98,6 +100,9 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     BillboardChain::~BillboardChain()
     {
+        BillboardChainBatcher* batcher = mManager ? mManager->_getBillboardChainBatcher() : 0;
+        if (batcher)
+            batcher->_removeChain(this);
         OGRE_DELETE mVertexData;
         OGRE_DELETE mIndexData;
     }
@@ -498,11 +503,22 @@ namespace Ogre {
         const Vector3& camPos = cam->getDerivedPosition();
         Vector3 eyePos = mParentNode->convertWorldToLocalPosition(camPos);
 
+        writeVertices(static_cast<char*>(pBufferStart), pBuffer->getVertexSize(), eyePos, 0);
+
+        pBuffer->unlock();
+        mVertexCameraUsed = cam;
+        mVertexContentDirty = false;
+
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChain::writeVertices(char* pBufferStart, size_t vertexSize,
+        const Vector3& eyePos, const Matrix4* worldTransform) const
+    {
         Vector3 chainTangent;
-        for (ChainSegmentList::iterator segi = mChainSegmentList.begin();
+        for (ChainSegmentList::const_iterator segi = mChainSegmentList.begin();
             segi != mChainSegmentList.end(); ++segi)
         {
-            ChainSegment& seg = *segi;
+            const ChainSegment& seg = *segi;
 
             // Skip 0 or 1 element segment counts
             if (seg.head != SEGMENT_EMPTY && seg.head != seg.tail)
@@ -514,14 +530,11 @@ namespace Ogre {
                     if (e == mMaxElementsPerChain)
                         e = 0;
 
-                    Element& elem = mChainElementList[e + seg.start];
-                    assert (((e + seg.start) * 2) < 65536 && "Too many elements!");
-                    uint16 baseIdx = static_cast<uint16>((e + seg.start) * 2);
+                    const Element& elem = mChainElementList[e + seg.start];
+                    size_t baseIdx = (e + seg.start) * 2;
 
                     // Determine base pointer to vertex #1
-                    void* pBase = static_cast<void*>(
-                        static_cast<char*>(pBufferStart) +
-                            pBuffer->getVertexSize() * baseIdx);
+                    void* pBase = static_cast<void*>(pBufferStart + vertexSize * baseIdx);
 
                     // Get index of next item
                     size_t nexte = e + 1;
@@ -558,6 +571,11 @@ namespace Ogre {
 
                     Vector3 pos0 = elem.position - vPerpendicular;
                     Vector3 pos1 = elem.position + vPerpendicular;
+                    if (worldTransform)
+                    {
+                        pos0 = worldTransform->transformAffine(pos0);
+                        pos1 = worldTransform->transformAffine(pos1);
+                    }
 
                     float* pFloat = static_cast<float*>(pBase);
                     // pos1
@@ -630,14 +648,50 @@ namespace Ogre {
             } // segment valid?
 
         } // each segment
+    }
+    //-----------------------------------------------------------------------
+    template<typename T>
+    size_t BillboardChain::writeIndexes(T* pIndex, size_t baseVertex) const
+    {
+        T* pStart = pIndex;
+        for (ChainSegmentList::const_iterator segi = mChainSegmentList.begin();
+            segi != mChainSegmentList.end(); ++segi)
+        {
+            const ChainSegment& seg = *segi;
 
+            // Skip 0 or 1 element segment counts
+            if (seg.head != SEGMENT_EMPTY && seg.head != seg.tail)
+            {
+                // Start from head + 1 since it's only useful in pairs
+                size_t laste = seg.head;
+                while(1) // until break
+                {
+                    size_t e = laste + 1;
+                    // Wrap forwards
+                    if (e == mMaxElementsPerChain)
+                        e = 0;
+                    // indexes of this element are (e * 2) and (e * 2) + 1
+                    // indexes of the last element are the same, -2
+                    T baseIdx = static_cast<T>(baseVertex + (e + seg.start) * 2);
+                    T lastBaseIdx = static_cast<T>(baseVertex + (laste + seg.start) * 2);
+                    *pIndex++ = lastBaseIdx;
+                    *pIndex++ = lastBaseIdx + 1;
+                    *pIndex++ = baseIdx;
+                    *pIndex++ = lastBaseIdx + 1;
+                    *pIndex++ = baseIdx + 1;
+                    *pIndex++ = baseIdx;
 
+                    if (e == seg.tail)
+                        break; // last one
 
-        pBuffer->unlock();
-        mVertexCameraUsed = cam;
-        mVertexContentDirty = false;
-
+                    laste = e;
+                }
+            }
+        }
+        return pIndex - pStart;
     }
+    template size_t BillboardChain::writeIndexes(uint32* pIndex, size_t baseVertex) const;
+    template size_t BillboardChain::writeIndexes(uint16* pIndex, size_t baseVertex) const;
     //-----------------------------------------------------------------------
     void BillboardChain::updateIndexBuffer(void)
     {
@@ -646,50 +700,10 @@ namespace Ogre {
         if (mIndexContentDirty)
         {
 
+            assert(mChainElementList.size() * 2 <= 65536 && "Too many elements!");
             uint16* pShort = static_cast<uint16*>(
                 mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
-            mIndexData->indexCount = 0;
-            // indexes
-            for (ChainSegmentList::iterator segi = mChainSegmentList.begin();
-                segi != mChainSegmentList.end(); ++segi)
-            {
-                ChainSegment& seg = *segi;
-
-                // Skip 0 or 1 element segment counts
-                if (seg.head != SEGMENT_EMPTY && seg.head != seg.tail)
-                {
-                    // Start from head + 1 since it's only useful in pairs
-                    size_t laste = seg.head;
-                    while(1) // until break
-                    {
-                        size_t e = laste + 1;
-                        // Wrap forwards
-                        if (e == mMaxElementsPerChain)
-                            e = 0;
-                        // indexes of this element are (e * 2) and (e * 2) + 1
-                        // indexes of the last element are the same, -2
-                        assert (((e + seg.start) * 2) < 65536 && "Too many elements!");
-                        uint16 baseIdx = static_cast<uint16>((e + seg.start) * 2);
-                        uint16 lastBaseIdx = static_cast<uint16>((laste + seg.start) * 2);
-                        *pShort++ = lastBaseIdx;
-                        *pShort++ = lastBaseIdx + 1;
-                        *pShort++ = baseIdx;
-                        *pShort++ = lastBaseIdx + 1;
-                        *pShort++ = baseIdx + 1;
-                        *pShort++ = baseIdx;
-
-                        mIndexData->indexCount += 6;
-
-
-                        if (e == seg.tail)
-                            break; // last one
-
-                        laste = e;
-
-                    }
-                }
-
-            }
+            mIndexData->indexCount = writeIndexes(pShort, 0);
             mIndexData->indexBuffer->unlock();
 
             mIndexContentDirty = false;
@@ -747,6 +761,13 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void BillboardChain::_updateRenderQueue(RenderQueue* queue)
     {
+        BillboardChainBatcher* batcher = mManager ? mManager->_getBillboardChainBatcher() : 0;
+        if (batcher)
+        {
+            batcher->_addChain(this, queue);
+            return;
+        }
+
         updateIndexBuffer();
 
         if (mIndexData->indexCount > 0)
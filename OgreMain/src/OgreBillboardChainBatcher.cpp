@@ -0,0 +1,363 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreBillboardChainBatcher.h"
+
+#include "OgreBillboardChain.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreRenderQueue.h"
+#include "OgreSceneManager.h"
+#include "OgreViewport.h"
+#include "OgreCamera.h"
+#include "OgreBitwise.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    bool BillboardChainBatcher::BatchKey::operator<(const BatchKey& rhs) const
+    {
+        if (material != rhs.material)
+            return material < rhs.material;
+        if (queueID != rhs.queueID)
+            return queueID < rhs.queueID;
+        if (priority != rhs.priority)
+            return priority < rhs.priority;
+        if (useTexCoords != rhs.useTexCoords)
+            return useTexCoords < rhs.useTexCoords;
+        return useVertexColour < rhs.useVertexColour;
+    }
+    //-----------------------------------------------------------------------
+    BillboardChainBatcher::BillboardChainBatcher()
+    {
+    }
+    //-----------------------------------------------------------------------
+    BillboardChainBatcher::~BillboardChainBatcher()
+    {
+        for (BatchMap::iterator i = mBatches.begin(); i != mBatches.end(); ++i)
+            OGRE_DELETE i->second;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatcher::_addChain(BillboardChain* chain, RenderQueue* queue)
+    {
+        // Nothing to draw unless a segment has two elements
+        bool hasSegment = false;
+        for (BillboardChain::ChainSegmentList::const_iterator segi = chain->mChainSegmentList.begin();
+            segi != chain->mChainSegmentList.end() && !hasSegment; ++segi)
+        {
+            hasSegment = segi->head != BillboardChain::SEGMENT_EMPTY && segi->head != segi->tail;
+        }
+        if (!hasSegment)
+            return;
+
+        BatchKey key;
+        key.material = chain->getMaterial().get();
+        key.queueID = chain->mRenderQueueIDSet ?
+            chain->mRenderQueueID : queue->getDefaultQueueGroup();
+        key.priority = chain->mRenderQueuePrioritySet ?
+            chain->mRenderQueuePriority : queue->getDefaultRenderablePriority();
+        key.useTexCoords = chain->mUseTexCoords;
+        key.useVertexColour = chain->mUseVertexColour;
+
+        BatchMap::iterator bi = mBatches.find(key);
+        if (bi == mBatches.end())
+        {
+            Batch* batch = OGRE_NEW Batch(chain->getMaterial(), key.useTexCoords, key.useVertexColour);
+            bi = mBatches.insert(BatchMap::value_type(key, batch)).first;
+        }
+        Batch* batch = bi->second;
+
+        // The material or queue of the chain may have changed since the last render
+        ChainBatchMap::iterator ci = mChainBatches.find(chain);
+        if (ci != mChainBatches.end() && ci->second != batch)
+        {
+            releaseChain(ci);
+            ci = mChainBatches.end();
+        }
+        if (ci == mChainBatches.end())
+            mChainBatches[chain] = batch;
+
+        if (batch->addVisibleChain(chain))
+        {
+            queue->addRenderable(batch, key.queueID, key.priority);
+            mQueuedBatches.push_back(batch);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatcher::_removeChain(BillboardChain* chain)
+    {
+        ChainBatchMap::iterator ci = mChainBatches.find(chain);
+        if (ci != mChainBatches.end())
+            releaseChain(ci);
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatcher::releaseChain(ChainBatchMap::iterator it)
+    {
+        Batch* batch = it->second;
+        batch->removeChain(it->first);
+        mChainBatches.erase(it);
+
+        // Batches still queued in this render are destroyed by the next _beginScene
+        if (batch->isEmpty() &&
+            std::find(mQueuedBatches.begin(), mQueuedBatches.end(), batch) == mQueuedBatches.end())
+        {
+            for (BatchMap::iterator i = mBatches.begin(); i != mBatches.end(); ++i)
+            {
+                if (i->second == batch)
+                {
+                    mBatches.erase(i);
+                    break;
+                }
+            }
+            OGRE_DELETE batch;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatcher::_beginScene(void)
+    {
+        for (vector<Batch*>::type::iterator i = mQueuedBatches.begin(); i != mQueuedBatches.end(); ++i)
+            (*i)->clearVisibleChains();
+        mQueuedBatches.clear();
+
+        BatchMap::iterator i = mBatches.begin();
+        while (i != mBatches.end())
+        {
+            if (i->second->isEmpty())
+            {
+                OGRE_DELETE i->second;
+                mBatches.erase(i++);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    BillboardChainBatcher::Batch::Batch(const MaterialPtr& material,
+        bool useTexCoords, bool useVertexColour)
+        : mMaterial(material), mVertexData(OGRE_NEW VertexData()),
+        mIndexData(OGRE_NEW IndexData()), mVertexEnd(0)
+    {
+        // Same layout as BillboardChain::setupVertexDeclaration
+        VertexDeclaration* decl = mVertexData->vertexDeclaration;
+        size_t offset = 0;
+        decl->addElement(0, offset, VET_FLOAT3, VES_POSITION);
+        offset += VertexElement::getTypeSize(VET_FLOAT3);
+        if (useVertexColour)
+        {
+            decl->addElement(0, offset, VET_COLOUR, VES_DIFFUSE);
+            offset += VertexElement::getTypeSize(VET_COLOUR);
+        }
+        if (useTexCoords)
+        {
+            decl->addElement(0, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES);
+        }
+        mVertexData->vertexStart = 0;
+        mVertexData->vertexCount = 0;
+        mIndexData->indexStart = 0;
+        mIndexData->indexCount = 0;
+    }
+    //-----------------------------------------------------------------------
+    BillboardChainBatcher::Batch::~Batch()
+    {
+        OGRE_DELETE mVertexData;
+        OGRE_DELETE mIndexData;
+    }
+    //-----------------------------------------------------------------------
+    bool BillboardChainBatcher::Batch::addVisibleChain(BillboardChain* chain)
+    {
+        SlotMap::iterator it = mSlots.find(chain);
+        if (it == mSlots.end())
+        {
+            Slot slot;
+            slot.start = slot.count = 0;
+            slot.camera = 0;
+            slot.valid = false;
+            it = mSlots.insert(SlotMap::value_type(chain, slot)).first;
+        }
+
+        // A new slot is needed when the number of elements changed too
+        size_t count = chain->mChainElementList.size() * 2;
+        if (it->second.count != count)
+        {
+            it->second.count = 0;
+            allocateSlot(it->second, count);
+        }
+
+        bool first = mVisibleChains.empty();
+        mVisibleChains.push_back(chain);
+        mWorldAABB.merge(chain->getWorldBoundingBox(true));
+        return first;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatcher::Batch::removeChain(BillboardChain* chain)
+    {
+        mSlots.erase(chain);
+        ChainList::iterator i = std::find(mVisibleChains.begin(), mVisibleChains.end(), chain);
+        if (i != mVisibleChains.end())
+            mVisibleChains.erase(i);
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatcher::Batch::allocateSlot(Slot& slot, size_t count)
+    {
+        if (mVertexEnd + count > mVertexData->vertexCount)
+            compact(count);
+
+        slot.start = mVertexEnd;
+        slot.count = count;
+        slot.valid = false;
+        mVertexEnd += count;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatcher::Batch::compact(size_t extraVertices)
+    {
+        size_t live = 0;
+        for (SlotMap::iterator i = mSlots.begin(); i != mSlots.end(); ++i)
+        {
+            i->second.start = live;
+            i->second.valid = false;
+            live += i->second.count;
+        }
+        mVertexEnd = live;
+
+        size_t needed = live + extraVertices;
+        if (needed > mVertexData->vertexCount)
+        {
+            size_t vertexCount = Bitwise::firstPO2From(static_cast<uint32>(needed));
+            HardwareVertexBufferSharedPtr vbuf =
+                HardwareBufferManager::getSingleton().createVertexBuffer(
+                    mVertexData->vertexDeclaration->getVertexSize(0), vertexCount,
+                    HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+            mVertexData->vertexBufferBinding->setBinding(0, vbuf);
+            mVertexData->vertexCount = vertexCount;
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool BillboardChainBatcher::Batch::preRender(SceneManager* sm, RenderSystem* rsys)
+    {
+        Viewport* vp = sm->getCurrentViewport();
+        if (!vp || mVisibleChains.empty())
+            return false;
+
+        const Camera* cam = vp->getCamera();
+        const Vector3& camPos = cam->getDerivedPosition();
+
+        // Find the range spanning the slots to rewrite
+        size_t dirtyStart = mVertexEnd;
+        size_t dirtyEnd = 0;
+        size_t maxIndexes = 0;
+        for (ChainList::iterator i = mVisibleChains.begin(); i != mVisibleChains.end(); ++i)
+        {
+            BillboardChain* chain = *i;
+            Slot& slot = mSlots[chain];
+            if (!slot.valid || chain->mVertexContentDirty ||
+                (chain->mFaceCamera && slot.camera != cam) ||
+                slot.transform != chain->_getParentNodeFullTransform())
+            {
+                slot.valid = false;
+                dirtyStart = std::min(dirtyStart, slot.start);
+                dirtyEnd = std::max(dirtyEnd, slot.start + slot.count);
+            }
+            maxIndexes += chain->mChainElementList.size() * 6;
+        }
+
+        if (dirtyStart < dirtyEnd)
+        {
+            HardwareVertexBufferSharedPtr vbuf = mVertexData->vertexBufferBinding->getBuffer(0);
+            size_t vertexSize = vbuf->getVertexSize();
+            // Other slots in the range are still in use, so they can't be discarded
+            char* pLocked = static_cast<char*>(vbuf->lock(dirtyStart * vertexSize,
+                (dirtyEnd - dirtyStart) * vertexSize, HardwareBuffer::HBL_NORMAL));
+
+            for (ChainList::iterator i = mVisibleChains.begin(); i != mVisibleChains.end(); ++i)
+            {
+                BillboardChain* chain = *i;
+                Slot& slot = mSlots[chain];
+                if (slot.valid)
+                    continue;
+
+                slot.transform = chain->_getParentNodeFullTransform();
+                slot.camera = cam;
+                slot.valid = true;
+
+                Vector3 eyePos = chain->getParentNode()->convertWorldToLocalPosition(camPos);
+                chain->writeVertices(pLocked + (slot.start - dirtyStart) * vertexSize,
+                    vertexSize, eyePos, &slot.transform);
+
+                // The own buffer of the chain is out of date now, should batching stop
+                chain->mVertexContentDirty = false;
+                chain->mVertexCameraUsed = 0;
+            }
+            vbuf->unlock();
+        }
+
+        // The indexes of all visible chains are rebuilt, they are cheap compared to the vertices
+        HardwareIndexBuffer::IndexType indexType = mVertexData->vertexCount > 65536 ?
+            HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT;
+        if (!mIndexData->indexBuffer ||
+            mIndexData->indexBuffer->getType() != indexType ||
+            mIndexData->indexBuffer->getNumIndexes() < maxIndexes)
+        {
+            mIndexData->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+                indexType, Bitwise::firstPO2From(static_cast<uint32>(maxIndexes)),
+                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        }
+
+        void* pIndex = mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD);
+        size_t indexCount = 0;
+        for (ChainList::iterator i = mVisibleChains.begin(); i != mVisibleChains.end(); ++i)
+        {
+            size_t baseVertex = mSlots[*i].start;
+            if (indexType == HardwareIndexBuffer::IT_32BIT)
+                indexCount += (*i)->writeIndexes(static_cast<uint32*>(pIndex) + indexCount, baseVertex);
+            else
+                indexCount += (*i)->writeIndexes(static_cast<uint16*>(pIndex) + indexCount, baseVertex);
+        }
+        mIndexData->indexBuffer->unlock();
+        mIndexData->indexCount = indexCount;
+
+        return indexCount > 0;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatcher::Batch::getRenderOperation(RenderOperation& op)
+    {
+        op.indexData = mIndexData;
+        op.operationType = RenderOperation::OT_TRIANGLE_LIST;
+        op.srcRenderable = this;
+        op.useIndexes = true;
+        op.vertexData = mVertexData;
+    }
+    //-----------------------------------------------------------------------
+    Real BillboardChainBatcher::Batch::getSquaredViewDepth(const Camera* cam) const
+    {
+        if (mWorldAABB.isNull())
+            return 0;
+        return cam->getDerivedPosition().squaredDistance(mWorldAABB.getCenter());
+    }
+
+}
@@ -44,6 +44,7 @@ namespace Ogre {
     BillboardParticleRenderer::CmdCommonUpVector BillboardParticleRenderer::msCommonUpVectorCmd;
     BillboardParticleRenderer::CmdPointRendering BillboardParticleRenderer::msPointRenderingCmd;
     BillboardParticleRenderer::CmdAccurateFacing BillboardParticleRenderer::msAccurateFacingCmd;
+    BillboardParticleRenderer::CmdInstancing BillboardParticleRenderer::msInstancingCmd;
     //-----------------------------------------------------------------------
     BillboardParticleRenderer::BillboardParticleRenderer()
     {
@@ -103,6 +104,13 @@ namespace Ogre {
                 "Cannot be combined with point rendering.",
                 PT_BOOL),
                 &msAccurateFacingCmd);
+            dict->addParameter(ParameterDef("instancing",
+                "Set whether or not particles will be expanded to quads by "
+                "the vertex program of the material using hardware instancing, "
+                "rather than generated on the CPU. The material must provide "
+                "such a vertex program. Possible values are 'true' or 'false'.",
+                PT_BOOL),
+                &msInstancingCmd);
         }
 
         // Create billboard set
@@ -126,7 +134,7 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     void BillboardParticleRenderer::_updateRenderQueue(RenderQueue* queue, 
-        list<Particle*>::type& currentParticles, bool cullIndividually)
+        vector<Particle*>::type& currentParticles, bool cullIndividually)
     {
         mBillboardSet->setCullIndividually(cullIndividually);
 
@@ -141,7 +149,7 @@ namespace Ogre {
         if (mBillboardSet->getBillboardsInWorldSpace() && mBillboardSet->getParentSceneNode())
             invWorld = mBillboardSet->getParentSceneNode()->_getFullTransform().inverse();
 
-        for (list<Particle*>::type::iterator i = currentParticles.begin();
+        for (vector<Particle*>::type::iterator i = currentParticles.begin();
             i != currentParticles.end(); ++i)
         {
             Particle* p = *i;
@@ -307,6 +315,16 @@ namespace Ogre {
         return mBillboardSet->isPointRenderingEnabled();
     }
     //-----------------------------------------------------------------------
+    void BillboardParticleRenderer::setInstancingEnabled(bool enabled)
+    {
+        mBillboardSet->setInstancingEnabled(enabled);
+    }
+    //-----------------------------------------------------------------------
+    bool BillboardParticleRenderer::isInstancingEnabled(void) const
+    {
+        return mBillboardSet->isInstancingEnabled();
+    }
+    //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     const String& BillboardParticleRendererFactory::getType() const
@@ -513,6 +531,17 @@ namespace Ogre {
         static_cast<BillboardParticleRenderer*>(target)->setUseAccurateFacing(
             StringConverter::parseBool(val));
     }
+    //-----------------------------------------------------------------------
+    String BillboardParticleRenderer::CmdInstancing::doGet(const void* target) const
+    {
+        return StringConverter::toString(
+            static_cast<const BillboardParticleRenderer*>(target)->isInstancingEnabled() );
+    }
+    void BillboardParticleRenderer::CmdInstancing::doSet(void* target, const String& val)
+    {
+        static_cast<BillboardParticleRenderer*>(target)->setInstancingEnabled(
+            StringConverter::parseBool(val));
+    }
 
 }
 
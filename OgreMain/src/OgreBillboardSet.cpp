@@ -44,7 +44,7 @@ THE SOFTWARE.
 
 namespace Ogre {
     // Init statics
-    RadixSort<BillboardSet::ActiveBillboardList, Billboard*, float> BillboardSet::mRadixSorter;
+    RadixSort<BillboardSet::BillboardIndexList, uint32, float> BillboardSet::mRadixSorter;
 
     //-----------------------------------------------------------------------
     BillboardSet::BillboardSet() :
@@ -64,11 +64,15 @@ namespace Ogre {
         mCommonDirection(Ogre::Vector3::UNIT_Z),
         mCommonUpVector(Vector3::UNIT_Y),
         mPointRendering(false),
+        mInstancing(false),
         mBuffersCreated(false),
         mPoolSize(0),
         mExternalData(false),
         mAutoUpdate(true),
-        mBillboardDataChanged(true)
+        mBillboardDataChanged(true),
+        mDirtyBegin(std::numeric_limits<size_t>::max()),
+        mDirtyEnd(0),
+        mInstancedBuffers(false)
     {
         setDefaultDimensions( 100, 100 );
         mMaterial = MaterialManager::getSingleton().getDefaultMaterial();
@@ -99,11 +103,15 @@ namespace Ogre {
         mCommonDirection(Ogre::Vector3::UNIT_Z),
         mCommonUpVector(Vector3::UNIT_Y),
         mPointRendering(false),
+        mInstancing(false),
         mBuffersCreated(false),
         mPoolSize(poolSize),
         mExternalData(externalData),
         mAutoUpdate(true),
-        mBillboardDataChanged(true)
+        mBillboardDataChanged(true),
+        mDirtyBegin(std::numeric_limits<size_t>::max()),
+        mDirtyEnd(0),
+        mInstancedBuffers(false)
     {
         setDefaultDimensions( 100, 100 );
         mMaterial = MaterialManager::getSingleton().getDefaultMaterial();
@@ -116,10 +124,10 @@ namespace Ogre {
     BillboardSet::~BillboardSet()
     {
         // Free pool items
-        BillboardPool::iterator i;
-        for (i = mBillboardPool.begin(); i != mBillboardPool.end(); ++i)
+        BillboardBlockList::iterator i;
+        for (i = mBillboardBlocks.begin(); i != mBillboardBlocks.end(); ++i)
         {
-            OGRE_DELETE *i;
+            OGRE_DELETE [] *i;
         }
 
         // Delete shared buffers
@@ -142,10 +150,13 @@ namespace Ogre {
             }
         }
 
-        // Get a new billboard
-        Billboard* newBill = mFreeBillboards.front();
-        mActiveBillboards.splice(
-            mActiveBillboards.end(), mFreeBillboards, mFreeBillboards.begin());
+        // Get a new billboard, it takes the slot after the last active one
+        Billboard* newBill = mFreeBillboards.back();
+        mFreeBillboards.pop_back();
+        newBill->mIndex = mActiveBillboards.size();
+        mActiveBillboards.push_back(newBill);
+        _notifyBillboardChanged(newBill->mIndex);
+
         newBill->setPosition(position);
         newBill->setColour(colour);
         newBill->mDirection = Vector3::ZERO;
@@ -185,8 +196,17 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void BillboardSet::clear()
     {
-        // Move actives to free list
-        mFreeBillboards.splice(mFreeBillboards.end(), mActiveBillboards);
+        if (mActiveBillboards.empty())
+            return;
+
+        // The buffer only needs to shrink
+        _notifyBillboardChanged(0);
+        _notifyBillboardChanged(mActiveBillboards.size() - 1);
+
+        // Move actives to the free stack
+        mFreeBillboards.insert(mFreeBillboards.end(),
+            mActiveBillboards.rbegin(), mActiveBillboards.rend());
+        mActiveBillboards.clear();
     }
 
     //-----------------------------------------------------------------------
@@ -196,22 +216,7 @@ namespace Ogre {
             index < mActiveBillboards.size() &&
             "Billboard index out of bounds." );
 
-        /* We can't access it directly, so we check whether it's in the first
-           or the second half, then we start either from the beginning or the
-           end of the list
-        */
-        ActiveBillboardList::const_iterator it;
-        if( index >= ( mActiveBillboards.size() >> 1 ) )
-        {
-            index = static_cast<unsigned int>(mActiveBillboards.size()) - index;
-            for( it = mActiveBillboards.end(); index; --index, --it );
-        }
-        else
-        {
-            for( it = mActiveBillboards.begin(); index; --index, ++it );
-        }
-
-        return *it;
+        return mActiveBillboards[index];
     }
 
     //-----------------------------------------------------------------------
@@ -221,36 +226,29 @@ namespace Ogre {
             index < mActiveBillboards.size() &&
             "Billboard index out of bounds." );
 
-        /* We can't access it directly, so we check whether it's in the first
-           or the second half, then we start either from the beginning or the
-           end of the list.
-           We then remove the billboard form the 'used' list and add it to
-           the 'free' list.
+        /* The billboards after the removed one move down a slot to keep
+           their order, so they have to be written again up to the old end.
         */
-        ActiveBillboardList::iterator it;
-        if( index >= ( mActiveBillboards.size() >> 1 ) )
-        {
-            index = static_cast<unsigned int>(mActiveBillboards.size()) - index;
-            for( it = mActiveBillboards.end(); index; --index, --it );
-        }
-        else
+        _notifyBillboardChanged(index);
+        _notifyBillboardChanged(mActiveBillboards.size() - 1);
+
+        mFreeBillboards.push_back(mActiveBillboards[index]);
+        mActiveBillboards.erase(mActiveBillboards.begin() + index);
+        for (size_t i = index; i < mActiveBillboards.size(); ++i)
         {
-            for( it = mActiveBillboards.begin(); index; --index, ++it );
+            mActiveBillboards[i]->mIndex = i;
         }
-
-        mFreeBillboards.splice(mFreeBillboards.end(), mActiveBillboards, it);
     }
 
     //-----------------------------------------------------------------------
     void BillboardSet::removeBillboard( Billboard* pBill )
     {
-        ActiveBillboardList::iterator it =
-            std::find(mActiveBillboards.begin(), mActiveBillboards.end(), pBill);
         assert(
-            it != mActiveBillboards.end() &&
+            pBill->mIndex < mActiveBillboards.size() &&
+            mActiveBillboards[pBill->mIndex] == pBill &&
             "Billboard isn't in the active list." );
 
-        mFreeBillboards.splice(mFreeBillboards.end(), mActiveBillboards, it);
+        removeBillboard(static_cast<unsigned int>(pBill->mIndex));
     }
 
     //-----------------------------------------------------------------------
@@ -325,32 +323,42 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void BillboardSet::_sortBillboards( Camera* cam)
     {
+        // Sort indices rather than the billboards, so the active billboards
+        // keep their order and the index they are known by
+        mSortedBillboards.resize(mActiveBillboards.size());
+        for (size_t i = 0; i < mSortedBillboards.size(); ++i)
+        {
+            mSortedBillboards[i] = static_cast<uint32>(i);
+        }
+
         switch (_getSortMode())
         {
         case SM_DIRECTION:
-            mRadixSorter.sort(mActiveBillboards, SortByDirectionFunctor(-mCamDir));
+            mRadixSorter.sort(mSortedBillboards, SortByDirectionFunctor(-mCamDir, mActiveBillboards));
             break;
         case SM_DISTANCE:
-            mRadixSorter.sort(mActiveBillboards, SortByDistanceFunctor(mCamPos));
+            mRadixSorter.sort(mSortedBillboards, SortByDistanceFunctor(mCamPos, mActiveBillboards));
             break;
         }
     }
-    BillboardSet::SortByDirectionFunctor::SortByDirectionFunctor(const Vector3& dir)
-        : sortDir(dir)
+    BillboardSet::SortByDirectionFunctor::SortByDirectionFunctor(const Vector3& dir,
+        const ActiveBillboardList& bills)
+        : sortDir(dir), billboards(bills)
     {
     }
-    float BillboardSet::SortByDirectionFunctor::operator()(Billboard* bill) const
+    float BillboardSet::SortByDirectionFunctor::operator()(uint32 index) const
     {
-        return sortDir.dotProduct(bill->getPosition());
+        return sortDir.dotProduct(billboards[index]->mPosition);
     }
-    BillboardSet::SortByDistanceFunctor::SortByDistanceFunctor(const Vector3& pos)
-        : sortPos(pos)
+    BillboardSet::SortByDistanceFunctor::SortByDistanceFunctor(const Vector3& pos,
+        const ActiveBillboardList& bills)
+        : sortPos(pos), billboards(bills)
     {
     }
-    float BillboardSet::SortByDistanceFunctor::operator()(Billboard* bill) const
+    float BillboardSet::SortByDistanceFunctor::operator()(uint32 index) const
     {
         // Sort descending by squared distance
-        return - (sortPos - bill->getPosition()).squaredLength();
+        return - (sortPos - billboards[index]->mPosition).squaredLength();
     }
     //-----------------------------------------------------------------------
     SortMode BillboardSet::_getSortMode(void) const
@@ -391,6 +399,36 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     void BillboardSet::beginBillboards(size_t numBillboards)
+    {
+        prepareBillboards();
+
+        // Init num visible
+        mNumVisibleBillboards = 0;
+
+        // Lock the buffer
+        if (numBillboards) // optimal lock
+        {
+            // clamp to max
+            numBillboards = std::min(mPoolSize, numBillboards);
+
+            size_t billboardSize = getBillboardSize();
+            assert (numBillboards * billboardSize <= mMainBuf->getSizeInBytes());
+
+            mLockPtr = static_cast<float*>(
+                mMainBuf->lock(0, numBillboards * billboardSize, 
+                mMainBuf->getUsage() & HardwareBuffer::HBU_DYNAMIC ?
+                HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL,
+                mAutoUpdate ? Root::getSingleton().getFreqUpdatedBuffersUploadOption() : HardwareBuffer::HBU_DEFAULT) );
+        }
+        else // lock the entire thing
+            mLockPtr = static_cast<float*>(
+            mMainBuf->lock(mMainBuf->getUsage() & HardwareBuffer::HBU_DYNAMIC ?
+            HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL,
+            mAutoUpdate ? Root::getSingleton().getFreqUpdatedBuffersUploadOption() : HardwareBuffer::HBU_DEFAULT) );
+
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::prepareBillboards(void)
     {
         /* Generate the vertices for all the billboards relative to the camera
            Also take the opportunity to update the vertex colours
@@ -412,6 +450,11 @@ namespace Ogre {
            use hardware TnL if it is available.
         */
 
+        // recreate the buffers when the billboard type or facing no longer
+        // allow instancing, or allow it again
+        if (mBuffersCreated && mInstancedBuffers != canUseInstancing())
+            _destroyBuffers();
+
         // create vertex and index buffers if they haven't already been
         if(!mBuffersCreated)
             _createBuffers();
@@ -438,42 +481,30 @@ namespace Ogre {
                     mDefaultWidth, mDefaultHeight, mCamX, mCamY, mVOffset);
 
             }
-        }
 
-        // Init num visible
-        mNumVisibleBillboards = 0;
-
-        // Lock the buffer
-        if (numBillboards) // optimal lock
-        {
-            // clamp to max
-            numBillboards = std::min(mPoolSize, numBillboards);
-
-            size_t billboardSize;
-            if (mPointRendering)
+            // The vertex program expands the quads from these
+            if (mInstancedBuffers)
             {
-                // just one vertex per billboard (this also excludes texcoords)
-                billboardSize = mMainBuf->getVertexSize();
+                setCustomParameter(0, Vector4(mCamX.x, mCamX.y, mCamX.z, 0));
+                setCustomParameter(1, Vector4(mCamY.x, mCamY.y, mCamY.z, 0));
+                setCustomParameter(2, Vector4(mLeftOff, mRightOff, mTopOff, mBottomOff));
+                setCustomParameter(3, Vector4(mRotationType == BBR_VERTEX ? 1.0f : 0.0f, 0, 0, 0));
             }
-            else
-            {
-                // 4 corners
-                billboardSize = mMainBuf->getVertexSize() * 4;
-            }
-            assert (numBillboards * billboardSize <= mMainBuf->getSizeInBytes());
-
-            mLockPtr = static_cast<float*>(
-                mMainBuf->lock(0, numBillboards * billboardSize, 
-                mMainBuf->getUsage() & HardwareBuffer::HBU_DYNAMIC ?
-                HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL,
-                mAutoUpdate ? Root::getSingleton().getFreqUpdatedBuffersUploadOption() : HardwareBuffer::HBU_DEFAULT) );
         }
-        else // lock the entire thing
-            mLockPtr = static_cast<float*>(
-            mMainBuf->lock(mMainBuf->getUsage() & HardwareBuffer::HBU_DYNAMIC ?
-            HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL,
-            mAutoUpdate ? Root::getSingleton().getFreqUpdatedBuffersUploadOption() : HardwareBuffer::HBU_DEFAULT) );
-
+    }
+    //-----------------------------------------------------------------------
+    size_t BillboardSet::getBillboardSize(void) const
+    {
+        if (mPointRendering || mInstancedBuffers)
+        {
+            // just one vertex or instance record per billboard
+            return mMainBuf->getVertexSize();
+        }
+        else
+        {
+            // 4 corners
+            return mMainBuf->getVertexSize() * 4;
+        }
     }
     //-----------------------------------------------------------------------
     void BillboardSet::injectBillboard(const Billboard& bb)
@@ -484,6 +515,13 @@ namespace Ogre {
         // Skip if not visible (NB always true if not bounds checking individual billboards)
         if (!billboardVisible(mCurrentCamera, bb)) return;
 
+        if (mInstancedBuffers)
+        {
+            genInstance(bb);
+            mNumVisibleBillboards++;
+            return;
+        }
+
         if (!mPointRendering &&
             (mBillboardType == BBT_ORIENTED_SELF ||
             mBillboardType == BBT_PERPENDICULAR_SELF ||
@@ -540,6 +578,33 @@ namespace Ogre {
         mMainBuf->unlock();
     }
     //-----------------------------------------------------------------------
+    void BillboardSet::_updateDirtyBillboards(void)
+    {
+        size_t numBillboards = std::min(mActiveBillboards.size(), mPoolSize);
+        size_t begin = mDirtyBegin;
+        size_t end = std::min(mDirtyEnd, numBillboards);
+
+        // Nothing to write when billboards were only removed from the end
+        if (begin < end)
+        {
+            prepareBillboards();
+
+            size_t billboardSize = getBillboardSize();
+            mLockPtr = static_cast<float*>(
+                mMainBuf->lock(begin * billboardSize, (end - begin) * billboardSize,
+                HardwareBuffer::HBL_NORMAL));
+
+            mNumVisibleBillboards = static_cast<unsigned short>(begin);
+            for (size_t i = begin; i < end; ++i)
+            {
+                injectBillboard(*mActiveBillboards[i]);
+            }
+            endBillboards();
+        }
+
+        mNumVisibleBillboards = static_cast<unsigned short>(numBillboards);
+    }
+    //-----------------------------------------------------------------------
     void BillboardSet::setBounds(const AxisAlignedBox& box, Real radius)
     {
         mAABB = box;
@@ -603,23 +668,53 @@ namespace Ogre {
     void BillboardSet::_updateRenderQueue(RenderQueue* queue)
     {
         // If we're driving this from our own data, update geometry if need to.
-        if (!mExternalData && (mAutoUpdate || mBillboardDataChanged || !mBuffersCreated))
+        if (!mExternalData)
         {
-            if (mSortingEnabled)
+            /* Without auto update the billboards stay in the buffer slot of
+               their index, so only the changed ones need to be written. Sorted
+               or individually culled billboards are packed in another order.
+            */
+            if (!mAutoUpdate && !mBillboardDataChanged && mBuffersCreated &&
+                !mSortingEnabled && !mCullIndividual &&
+                mInstancedBuffers == canUseInstancing())
             {
-                _sortBillboards(mCurrentCamera);
+                if (mDirtyBegin < mDirtyEnd)
+                    _updateDirtyBillboards();
             }
-
-            beginBillboards(mActiveBillboards.size());
-            ActiveBillboardList::iterator it;
-            for(it = mActiveBillboards.begin();
-                it != mActiveBillboards.end();
-                ++it )
+            else if (mAutoUpdate || mBillboardDataChanged || !mBuffersCreated ||
+                mDirtyBegin < mDirtyEnd)
             {
-                injectBillboard(*(*it));
+                if (mSortingEnabled)
+                {
+                    _sortBillboards(mCurrentCamera);
+                }
+
+                beginBillboards(mActiveBillboards.size());
+                if (mSortingEnabled)
+                {
+                    BillboardIndexList::iterator it;
+                    for(it = mSortedBillboards.begin();
+                        it != mSortedBillboards.end();
+                        ++it )
+                    {
+                        injectBillboard(*mActiveBillboards[*it]);
+                    }
+                }
+                else
+                {
+                    ActiveBillboardList::iterator it;
+                    for(it = mActiveBillboards.begin();
+                        it != mActiveBillboards.end();
+                        ++it )
+                    {
+                        injectBillboard(*(*it));
+                    }
+                }
+                endBillboards();
+                mBillboardDataChanged = false;
             }
-            endBillboards();
-            mBillboardDataChanged = false;
+            mDirtyBegin = std::numeric_limits<size_t>::max();
+            mDirtyEnd = 0;
         }
 
         //only set the render queue group if it has been explicitly set.
@@ -675,6 +770,20 @@ namespace Ogre {
             op.indexData = 0;
             op.vertexData->vertexCount = mNumVisibleBillboards;
         }
+        else if (mInstancedBuffers)
+        {
+            // one quad, drawn once per billboard
+            op.operationType = RenderOperation::OT_TRIANGLE_LIST;
+            op.useIndexes = true;
+            op.useGlobalInstancingVertexBufferIsAvailable = false;
+            op.numberOfInstances = mNumVisibleBillboards;
+
+            op.vertexData->vertexCount = 4;
+
+            op.indexData = mIndexData;
+            op.indexData->indexCount = 6;
+            op.indexData->indexStart = 0;
+        }
         else
         {
             op.operationType = RenderOperation::OT_TRIANGLE_LIST;
@@ -738,10 +847,10 @@ namespace Ogre {
 
             this->increasePool(size);
 
-            for( size_t i = currSize; i < size; ++i )
+            // Add new items to the stack, backwards so the first one is used first
+            for( size_t i = size; i > currSize; --i )
             {
-                // Add new items to the queue
-                mFreeBillboards.push_back( mBillboardPool[i] );
+                mFreeBillboards.push_back( mBillboardPool[i - 1] );
             }
         }
 
@@ -775,6 +884,19 @@ namespace Ogre {
                 "expect.", LML_CRITICAL);
         }
 
+        mInstancedBuffers = canUseInstancing();
+        if (mInstancedBuffers)
+        {
+            _createInstancedBuffers();
+            return;
+        }
+        if (mInstancing && !mPointRendering)
+        {
+            LogManager::getSingleton().logMessage("Warning: BillboardSet " +
+                mName + " has instancing enabled but its billboards don't share "
+                "their axes, generating the quads on the CPU instead.");
+        }
+
         mVertexData = OGRE_NEW VertexData();
         if (mPointRendering)
             mVertexData->vertexCount = mPoolSize;
@@ -859,6 +981,65 @@ namespace Ogre {
         mBuffersCreated = true;
     }
     //-----------------------------------------------------------------------
+    void BillboardSet::_createInstancedBuffers(void)
+    {
+        /* Stream 0 is a single quad, stream 1 one record per billboard:
+           position & rotation (float4), colour, size (float2) and
+           texture coordinate rect (ushort4 normalised)
+        */
+        mVertexData = OGRE_NEW VertexData();
+        mVertexData->vertexCount = 4;
+        mVertexData->vertexStart = 0;
+
+        VertexDeclaration* decl = mVertexData->vertexDeclaration;
+        VertexBufferBinding* binding = mVertexData->vertexBufferBinding;
+
+        decl->addElement(0, 0, VET_FLOAT2, VES_TEXTURE_COORDINATES, 0);
+        size_t offset = 0;
+        offset += decl->addElement(1, offset, VET_FLOAT4, VES_POSITION).getSize();
+        offset += decl->addElement(1, offset, VET_COLOUR, VES_DIFFUSE).getSize();
+        offset += decl->addElement(1, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES, 1).getSize();
+        decl->addElement(1, offset, VET_USHORT4_NORM, VES_TEXTURE_COORDINATES, 2);
+
+        // Corners in the same layout as the generated quads
+        HardwareVertexBufferSharedPtr cornerBuf =
+            HardwareBufferManager::getSingleton().createVertexBuffer(
+                decl->getVertexSize(0), 4, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        const float corners[] = { 0, 0,  1, 0,  0, 1,  1, 1 };
+        cornerBuf->writeData(0, sizeof(corners), corners, true);
+        binding->setBinding(0, cornerBuf);
+
+        mMainBuf =
+            HardwareBufferManager::getSingleton().createVertexBuffer(
+                decl->getVertexSize(1),
+                mPoolSize,
+                mAutoUpdate ? HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE : 
+                HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        mMainBuf->setIsInstanceData(true);
+        mMainBuf->setInstanceDataStepRate(1);
+        binding->setBinding(1, mMainBuf);
+
+        mIndexData = OGRE_NEW IndexData();
+        mIndexData->indexStart = 0;
+        mIndexData->indexCount = 6;
+        mIndexData->indexBuffer = HardwareBufferManager::getSingleton().
+            createIndexBuffer(HardwareIndexBuffer::IT_16BIT, 6,
+                HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        const ushort indexes[] = { 0, 2, 1, 1, 2, 3 };
+        mIndexData->indexBuffer->writeData(0, sizeof(indexes), indexes, true);
+
+        mBuffersCreated = true;
+    }
+    //-----------------------------------------------------------------------
+    bool BillboardSet::canUseInstancing(void) const
+    {
+        // Same condition as for generating axes per billboard in injectBillboard
+        return mInstancing && !mPointRendering &&
+            mBillboardType != BBT_ORIENTED_SELF &&
+            mBillboardType != BBT_PERPENDICULAR_SELF &&
+            !(mAccurateFacing && mBillboardType != BBT_PERPENDICULAR_COMMON);
+    }
+    //-----------------------------------------------------------------------
     void BillboardSet::_destroyBuffers(void)
     {
         if (mVertexData)
@@ -1010,9 +1191,14 @@ namespace Ogre {
         mBillboardPool.reserve(size);
         mBillboardPool.resize(size);
 
-        // Create new billboards
-        for( size_t i = oldSize; i < size; ++i )
-            mBillboardPool[i] = OGRE_NEW Billboard();
+        // Create new billboards, contiguously so that updating them is cache friendly
+        if (size > oldSize)
+        {
+            Billboard* block = OGRE_NEW Billboard[size - oldSize];
+            mBillboardBlocks.push_back(block);
+            for( size_t i = oldSize; i < size; ++i )
+                mBillboardPool[i] = block + (i - oldSize);
+        }
 
     }
     //-----------------------------------------------------------------------
@@ -1361,6 +1547,42 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void BillboardSet::genInstance(const Billboard& bb)
+    {
+        assert( bb.mUseTexcoordRect || bb.mTexcoordIndex < mTextureCoords.size() );
+        const Ogre::FloatRect & r =
+            bb.mUseTexcoordRect ? bb.mTexcoordRect : mTextureCoords[bb.mTexcoordIndex];
+
+        // Position & rotation
+        *mLockPtr++ = bb.mPosition.x;
+        *mLockPtr++ = bb.mPosition.y;
+        *mLockPtr++ = bb.mPosition.z;
+        *mLockPtr++ = mAllDefaultRotation ? 0.0f : bb.mRotation.valueRadians();
+        // Colour
+        // Convert float* to RGBA*
+        RGBA* pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+        Root::getSingleton().convertColourValue(bb.mColour, pCol++);
+        mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+        // Size
+        if (!mAllDefaultSize && bb.mOwnDimensions)
+        {
+            *mLockPtr++ = bb.mWidth;
+            *mLockPtr++ = bb.mHeight;
+        }
+        else
+        {
+            *mLockPtr++ = mDefaultWidth;
+            *mLockPtr++ = mDefaultHeight;
+        }
+        // Texture coords
+        uint16* pTex = static_cast<uint16*>(static_cast<void*>(mLockPtr));
+        *pTex++ = static_cast<uint16>(Math::saturate(r.left) * 65535 + 0.5f);
+        *pTex++ = static_cast<uint16>(Math::saturate(r.top) * 65535 + 0.5f);
+        *pTex++ = static_cast<uint16>(Math::saturate(r.right) * 65535 + 0.5f);
+        *pTex++ = static_cast<uint16>(Math::saturate(r.bottom) * 65535 + 0.5f);
+        mLockPtr = static_cast<float*>(static_cast<void*>(pTex));
+    }
+    //-----------------------------------------------------------------------
     void BillboardSet::genVertOffsets(Real inleft, Real inright, Real intop, Real inbottom,
         Real width, Real height, const Vector3& x, const Vector3& y, Vector3* pDestVec)
     {
@@ -1478,6 +1700,22 @@ namespace Ogre {
         }
     }
 
+    //-----------------------------------------------------------------------
+    void BillboardSet::setInstancingEnabled(bool enabled)
+    {
+        // Override instancing if not supported
+        if (enabled && !Root::getSingleton().getRenderSystem()->getCapabilities()->hasCapability(RSC_VERTEX_BUFFER_INSTANCE_DATA))
+        {
+            enabled = false;
+        }
+
+        if (enabled != mInstancing)
+        {
+            mInstancing = enabled;
+            // Different buffer structure (4 verts or 1 instance per billboard)
+            _destroyBuffers();
+        }
+    }
     //-----------------------------------------------------------------------
     void BillboardSet::setAutoUpdate(bool autoUpdate)
     {
@@ -903,6 +903,18 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Camera::isVisible(const float* bounds, size_t numBoxes, uint32* visibility) const
+    {
+        if (mCullFrustum)
+        {
+            mCullFrustum->isVisible(bounds, numBoxes, visibility);
+        }
+        else
+        {
+            Frustum::isVisible(bounds, numBoxes, visibility);
+        }
+    }
+    //-----------------------------------------------------------------------
     const Vector3* Camera::getWorldSpaceCorners(void) const
     {
         if (mCullFrustum)
@@ -44,6 +44,7 @@ CompositionPass::CompositionPass(CompositionTargetPass *parent):
     mAutomaticColour(false),
     mClearDepth(1.0f),
     mClearStencil(0),
+    mThreadGroupSize(Vector3::ZERO),
     mStencilCheck(false),
     mStencilFunc(CMPF_ALWAYS_PASS),
     mStencilRefValue(0),
@@ -163,6 +164,47 @@ void CompositionPass::clearAllInputs()
     }
 }
 //-----------------------------------------------------------------------
+void CompositionPass::setImage(size_t id, const String &image, size_t mrtIndex, TextureAccess access)
+{
+    assert(id<OGRE_MAX_TEXTURE_LAYERS);
+    mImages[id] = ImageTex(image, mrtIndex, access);
+}
+//-----------------------------------------------------------------------
+const CompositionPass::ImageTex &CompositionPass::getImage(size_t id) const
+{
+    assert(id<OGRE_MAX_TEXTURE_LAYERS);
+    return mImages[id];
+}
+//-----------------------------------------------------------------------
+size_t CompositionPass::getNumImages() const
+{
+    size_t count = 0;
+    for(size_t x=0; x<OGRE_MAX_TEXTURE_LAYERS; ++x)
+    {
+        if(!mImages[x].name.empty())
+            count = x+1;
+    }
+    return count;
+}
+//-----------------------------------------------------------------------
+void CompositionPass::clearAllImages()
+{
+    for(size_t x=0; x<OGRE_MAX_TEXTURE_LAYERS; ++x)
+    {
+        mImages[x].name.clear();
+    }
+}
+//-----------------------------------------------------------------------
+void CompositionPass::setThreadGroupSize(const Vector3& size)
+{
+    mThreadGroupSize = size;
+}
+//-----------------------------------------------------------------------
+const Vector3& CompositionPass::getThreadGroupSize() const
+{
+    return mThreadGroupSize;
+}
+//-----------------------------------------------------------------------
 CompositionTargetPass *CompositionPass::getParent()
 {
     return mParent;
@@ -332,7 +374,7 @@ bool CompositionPass::_isSupported(void)
 {
     // A pass is supported if material referenced have a supported technique
 
-    if (mType == PT_RENDERQUAD)
+    if (mType == PT_RENDERQUAD || mType == PT_COMPUTE)
     {
         if (!mMaterial)
         {
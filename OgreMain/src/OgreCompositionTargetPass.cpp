@@ -40,7 +40,9 @@ CompositionTargetPass::CompositionTargetPass(CompositionTechnique *parent):
     mVisibilityMask(0xFFFFFFFF),
     mLodBias(1.0f),
     mMaterialScheme(MaterialManager::DEFAULT_SCHEME_NAME), 
-    mShadowsEnabled(true)
+    mShadowsEnabled(true),
+    mDontCareBuffers(0),
+    mDiscardBuffers(0)
 {
     if (Root::getSingleton().getRenderSystem())
     {
@@ -123,6 +125,22 @@ bool CompositionTargetPass::getShadowsEnabled(void) const
     return mShadowsEnabled;
 }
 //-----------------------------------------------------------------------
+void CompositionTargetPass::setLoadAction(RenderTarget::LoadAction action, unsigned int buffers)
+{
+    if (action == RenderTarget::LA_DONT_CARE)
+        mDontCareBuffers |= buffers;
+    else
+        mDontCareBuffers &= ~buffers;
+}
+//-----------------------------------------------------------------------
+void CompositionTargetPass::setStoreAction(RenderTarget::StoreAction action, unsigned int buffers)
+{
+    if (action == RenderTarget::SA_DISCARD)
+        mDiscardBuffers |= buffers;
+    else
+        mDiscardBuffers &= ~buffers;
+}
+//-----------------------------------------------------------------------
 CompositionPass *CompositionTargetPass::createPass()
 {
     CompositionPass *t = OGRE_NEW CompositionPass(this);
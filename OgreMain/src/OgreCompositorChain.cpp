@@ -38,6 +38,10 @@ THE SOFTWARE.
 #include "OgreRenderTarget.h"
 #include "OgreLogManager.h"
 #include "OgreMaterialManager.h"
+#include "OgreProfiler.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+#include "OgreTimer.h"
 
 namespace Ogre {
 CompositorChain::CompositorChain(Viewport *vp):
@@ -45,7 +49,11 @@ CompositorChain::CompositorChain(Viewport *vp):
     mOriginalScene(0),
     mDirty(true),
     mAnyCompositorsEnabled(false),
-    mOldLodBias(1.0f)
+    mOldLodBias(1.0f),
+    mResolutionScale(1.0f),
+    mTargetFrameTime(0.0f),
+    mMinResolutionScale(0.5f),
+    mLastUpdateTime(0)
 {
     assert(vp);
     mOldClearEveryFrameBuffers = vp->getClearBuffers();
@@ -308,6 +316,12 @@ void CompositorChain::preRenderTargetUpdate(const RenderTargetEvent& evt)
         cam->getSceneManager()->_setActiveCompositorChain(this);
     }
 
+    OgreProfileScopeGroup("_renderCompositorTargets", OGREPROF_RENDERING);
+
+    updateResolutionScale();
+
+    RenderSystem* rs = Root::getSingleton().getRenderSystem();
+
     /// Iterate over compiled state
     CompositorInstance::CompiledState::iterator i;
     for(i=mCompiledState.begin(); i!=mCompiledState.end(); ++i)
@@ -316,13 +330,53 @@ void CompositorChain::preRenderTargetUpdate(const RenderTargetEvent& evt)
         if(i->onlyInitial && i->hasBeenRendered)
             continue;
         i->hasBeenRendered = true;
+        /// Dynamic resolution targets are scaled through their viewport
+        Viewport* vp = i->target->getViewport(0);
+        if(i->dynamicResolution && vp->getWidth() != mResolutionScale)
+            vp->setDimensions(0, 0, mResolutionScale, mResolutionScale);
         /// Setup and render
         preTargetOperation(*i, i->target->getViewport(0), cam);
+        OgreProfileBeginGPUTimer("Compositor target: " + i->target->getName());
+        if(i->dontCareBuffers)
+            rs->_discardRenderTarget(i->target, i->dontCareBuffers);
         i->target->update();
+        if(i->discardBuffers)
+            rs->_discardRenderTarget(i->target, i->discardBuffers);
+        OgreProfileEndGPUTimer();
         postTargetOperation(*i, i->target->getViewport(0), cam);
     }
 }
 //-----------------------------------------------------------------------
+void CompositorChain::setResolutionScale(Real scale)
+{
+    mResolutionScale = Math::Clamp(scale, Real(0.01f), Real(1.0f));
+}
+//-----------------------------------------------------------------------
+void CompositorChain::setDynamicResolution(Real targetFrameTime, Real minScale)
+{
+    mTargetFrameTime = targetFrameTime;
+    mMinResolutionScale = Math::Clamp(minScale, Real(0.01f), Real(1.0f));
+    mLastUpdateTime = 0;
+}
+//-----------------------------------------------------------------------
+void CompositorChain::updateResolutionScale()
+{
+    if(mTargetFrameTime <= 0)
+        return;
+
+    unsigned long now = Root::getSingleton().getTimer()->getMicroseconds();
+    if(mLastUpdateTime != 0 && now > mLastUpdateTime)
+    {
+        Real frameTime = (now - mLastUpdateTime) * 0.000001f;
+        /// The area, so the cost, goes with the square of the scale. Only move part
+        /// of the way each frame to ride out single slow frames.
+        Real wanted = mResolutionScale * Math::Sqrt(mTargetFrameTime / frameTime);
+        wanted = Math::Clamp(wanted, mMinResolutionScale, Real(1.0f));
+        mResolutionScale += (wanted - mResolutionScale) * 0.1f;
+    }
+    mLastUpdateTime = now;
+}
+//-----------------------------------------------------------------------
 void CompositorChain::postRenderTargetUpdate(const RenderTargetEvent& evt)
 {
     Camera *cam = mViewport->getCamera();
@@ -466,8 +520,81 @@ void CompositorChain::clearCompiledState()
 
 }
 //-----------------------------------------------------------------------
+void CompositorChain::optimiseCompiledState()
+{
+    typedef CompositorInstance::TargetOperation::RenderTargetSet RenderTargetSet;
+    CompositorInstance::CompiledState::iterator i;
+
+    if (CompositorManager::getSingleton().getCullUnusedTargetPasses())
+    {
+        /// Targets read before they are rendered carry their content to the next frame
+        RenderTargetSet persistent;
+        RenderTargetSet read;
+        for (i = mCompiledState.begin(); i != mCompiledState.end(); ++i)
+        {
+            read.insert(i->inputTargets.begin(), i->inputTargets.end());
+            if (read.find(i->target) != read.end())
+                persistent.insert(i->target);
+        }
+
+        /// Walk back from the output, dropping the operations nobody reads
+        RenderTargetSet needed = mOutputOperation.inputTargets;
+        for (size_t n = mCompiledState.size(); n-- > 0; )
+        {
+            CompositorInstance::TargetOperation& op = mCompiledState[n];
+            if (op.localOutput && !op.onlyInitial && needed.find(op.target) == needed.end() &&
+                persistent.find(op.target) == persistent.end())
+            {
+                mCompiledState.erase(mCompiledState.begin() + n);
+            }
+            else
+            {
+                needed.insert(op.inputTargets.begin(), op.inputTargets.end());
+            }
+        }
+    }
+
+    /// An operation which doesn't render the scene nor read the target can follow
+    /// the previous one on the same target as if they were one target pass
+    i = mCompiledState.begin();
+    while (i != mCompiledState.end())
+    {
+        CompositorInstance::CompiledState::iterator next = i + 1;
+        if (next == mCompiledState.end())
+            break;
+
+        if (next->target != i->target || i->onlyInitial || next->onlyInitial ||
+            next->findVisibleObjects || next->renderQueues.any() ||
+            next->materialScheme != i->materialScheme || next->shadowsEnabled != i->shadowsEnabled ||
+            next->inputTargets.find(i->target) != next->inputTargets.end())
+        {
+            i = next;
+            continue;
+        }
+
+        /// The operations are flushed in queue order, so keep them after ours
+        int queueGroupID = i->currentQueueGroupID;
+        CompositorInstance::RenderSystemOpPairs::iterator op;
+        for (op = i->renderSystemOperations.begin(); op != i->renderSystemOperations.end(); ++op)
+            queueGroupID = std::max(queueGroupID, op->first);
+        for (op = next->renderSystemOperations.begin(); op != next->renderSystemOperations.end(); ++op)
+        {
+            i->renderSystemOperations.push_back(CompositorInstance::RenderSystemOpPair(
+                std::max(queueGroupID, op->first), op->second));
+        }
+        i->currentQueueGroupID = std::max(queueGroupID, next->currentQueueGroupID);
+        i->inputTargets.insert(next->inputTargets.begin(), next->inputTargets.end());
+        i->localOutput = i->localOutput && next->localOutput;
+        i->discardBuffers = next->discardBuffers;
+
+        mCompiledState.erase(next);
+    }
+}
+//-----------------------------------------------------------------------
 void CompositorChain::_compile()
 {
+    OgreProfileScopeGroup("_compileCompositorChain", OGREPROF_GENERAL);
+
     // remove original scene if it has the wrong material scheme
     if( mOriginalSceneScheme != mViewport->getMaterialScheme() )
     {
@@ -509,6 +636,8 @@ void CompositorChain::_compile()
     mOutputOperation.renderSystemOperations.clear();
     lastComposition->_compileOutputOperation(mOutputOperation);
 
+    optimiseCompiledState();
+
     // Deal with viewport settings
     if (compositorsEnabled != mAnyCompositorsEnabled)
     {
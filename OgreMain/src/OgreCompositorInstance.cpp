@@ -175,6 +175,7 @@ class RSQuadOperation: public CompositorInstance::RenderSystemOperation
 public:
     RSQuadOperation(CompositorInstance *inInstance, uint32 inPass_id, MaterialPtr inMat):
       mat(inMat), instance(inInstance), pass_id(inPass_id),
+      mScaledInputs(false),
       mQuadCornerModified(false),
       mQuadFarCorners(false),
       mQuadFarCornersViewSpace(false),
@@ -193,6 +194,8 @@ public:
     CompositorInstance *instance;
     uint32 pass_id;
 
+    /// The inputs are rendered at the resolution scale of the chain
+    bool mScaledInputs;
     bool mQuadCornerModified, mQuadFarCorners, mQuadFarCornersViewSpace;
     Real mQuadLeft;
     Real mQuadTop;
@@ -220,7 +223,8 @@ public:
         instance->_fireNotifyMaterialRender(pass_id, mat);
 
         Viewport* vp = rs->_getViewport();
-        Rectangle2D *rect = static_cast<Rectangle2D*>(CompositorManager::getSingleton()._getTexturedRectangle2D());
+        Real uvScale = mScaledInputs ? instance->getChain()->getResolutionScale() : 1.0f;
+        Rectangle2D *rect = static_cast<Rectangle2D*>(CompositorManager::getSingleton()._getTexturedRectangle2D(uvScale));
 
         if (mQuadCornerModified)
         {
@@ -257,6 +261,79 @@ public:
     }
 };
 
+/** "Dispatch compute program" RenderSystem operation
+ */
+class RSComputeOperation: public CompositorInstance::RenderSystemOperation
+{
+public:
+    RSComputeOperation(CompositorInstance *inInstance, uint32 inPass_id, MaterialPtr inMat,
+        const Vector3& inThreadGroupSize):
+      mat(inMat), instance(inInstance), pass_id(inPass_id), threadGroupSize(inThreadGroupSize)
+    {
+        mat->load();
+        instance->_fireNotifyMaterialSetup(pass_id, mat);
+        technique = mat->getTechnique(0);
+        assert(technique);
+    }
+    MaterialPtr mat;
+    Technique *technique;
+    CompositorInstance *instance;
+    uint32 pass_id;
+    Vector3 threadGroupSize;
+
+    /// Textures bound for load and store, by binding point
+    struct Image
+    {
+        uint bindPoint;
+        TexturePtr texture;
+        TextureAccess access;
+    };
+    vector<Image>::type images;
+
+    void addImage(uint bindPoint, const TexturePtr& texture, TextureAccess access)
+    {
+        Image image;
+        image.bindPoint = bindPoint;
+        image.texture = texture;
+        image.access = access;
+        images.push_back(image);
+    }
+
+    virtual void execute(SceneManager *sm, RenderSystem *rs)
+    {
+        // Fire listener
+        instance->_fireNotifyMaterialRender(pass_id, mat);
+
+        Viewport* vp = rs->_getViewport();
+        Renderable* rect = CompositorManager::getSingleton()._getTexturedRectangle2D();
+
+        Technique::Passes::const_iterator i;
+        for(i = technique->getPasses().begin(); i != technique->getPasses().end(); ++i)
+        {
+            if (!(*i)->hasComputeProgram())
+                continue;
+
+            for (vector<Image>::type::iterator im = images.begin(); im != images.end(); ++im)
+                im->texture->createShaderAccessPoint(im->bindPoint, im->access);
+
+            /// Cover the target with groups, or launch the groups set on the program
+            Vector3 workgroupDim;
+            if (threadGroupSize.x > 0 && threadGroupSize.y > 0)
+            {
+                workgroupDim.x = Math::Ceil(vp->getActualWidth() / threadGroupSize.x);
+                workgroupDim.y = Math::Ceil(vp->getActualHeight() / threadGroupSize.y);
+                workgroupDim.z = 1;
+            }
+            else
+            {
+                workgroupDim = (*i)->getComputeProgram()->getComputeGroupDimensions();
+            }
+
+            sm->_dispatchComputeWithPass(*i, rect, workgroupDim);
+        }
+    }
+};
+
 /** "Set material scheme" RenderSystem operation
  */
 class RSSetSchemeOperation: public CompositorInstance::RenderSystemOperation
@@ -310,6 +387,15 @@ void CompositorInstance::collectPasses(TargetOperation &finalState, CompositionT
     while(it.hasMoreElements())
     {
         CompositionPass *pass = it.getNext();
+
+        /// Record the inputs, the chain culls targets which are never read
+        for(size_t x=0; x<pass->getNumInputs(); ++x)
+        {
+            const CompositionPass::InputTex& inp = pass->getInput(x);
+            if(!inp.name.empty())
+                finalState.inputTargets.insert(getTargetForTex(inp.name));
+        }
+
         switch(pass->getType())
         {
         case CompositionPass::PT_CLEAR:
@@ -418,6 +504,11 @@ void CompositorInstance::collectPasses(TargetOperation &finalState, CompositionT
             }
 
             RSQuadOperation * rsQuadOperation = OGRE_NEW RSQuadOperation(this,pass->getIdentifier(),localMat);
+            for(size_t x=0; x<pass->getNumInputs(); ++x)
+            {
+                if(isDynamicResolution(pass->getInput(x).name))
+                    rsQuadOperation->mScaledInputs = true;
+            }
             Real left,top,right,bottom;
             if (pass->getQuadCorners(left,top,right,bottom))
                 rsQuadOperation->setQuadCorners(left,top,right,bottom);
@@ -426,6 +517,76 @@ void CompositorInstance::collectPasses(TargetOperation &finalState, CompositionT
             queueRenderSystemOp(finalState,rsQuadOperation);
             }
             break;
+        case CompositionPass::PT_COMPUTE: {
+            srcmat = pass->getMaterial();
+            if(!srcmat)
+            {
+                /// No material -- warn user
+                LogManager::getSingleton().logMessage("Warning in compilation of Compositor "
+                    +mCompositor->getName()+": No material defined for composition pass", LML_CRITICAL);
+                break;
+            }
+            srcmat->load();
+            if(srcmat->getSupportedTechniques().empty())
+            {
+                /// No supported techniques -- warn user
+                LogManager::getSingleton().logMessage("Warning in compilation of Compositor "
+                    +mCompositor->getName()+": material "+srcmat->getName()+" has no supported techniques", LML_CRITICAL);
+                break;
+            }
+            srctech = srcmat->getBestTechnique(0);
+            /// Create local material
+            MaterialPtr localMat = createLocalMaterial(srcmat->getName());
+            /// Copy and adapt passes from source material
+            Technique::Passes::const_iterator i;
+            for(i = srctech->getPasses().begin(); i != srctech->getPasses().end(); ++i)
+            {
+                Pass *srcpass = *i;
+                if(!srcpass->hasComputeProgram())
+                {
+                    LogManager::getSingleton().logMessage("Warning in compilation of Compositor "
+                        +mCompositor->getName()+": material "+srcmat->getName()+" pass "
+                        +StringConverter::toString(srcpass->getIndex())+" has no compute program", LML_CRITICAL);
+                }
+                /// Create new target pass
+                targetpass = localMat->getTechnique(0)->createPass();
+                (*targetpass) = (*srcpass);
+                /// Set up inputs
+                for(size_t x=0; x<pass->getNumInputs(); ++x)
+                {
+                    const CompositionPass::InputTex& inp = pass->getInput(x);
+                    if(!inp.name.empty() && x < targetpass->getNumTextureUnitStates())
+                    {
+                        targetpass->getTextureUnitState((ushort)x)->setTextureName(getSourceForTex(inp.name, inp.mrtIndex));
+                    }
+                }
+            }
+
+            RSComputeOperation * rsComputeOperation = OGRE_NEW RSComputeOperation(this,pass->getIdentifier(),
+                localMat, pass->getThreadGroupSize());
+            /// Set up images, which are read like inputs and written beside the target
+            for(size_t x=0; x<pass->getNumImages(); ++x)
+            {
+                const CompositionPass::ImageTex& img = pass->getImage(x);
+                if(img.name.empty())
+                    continue;
+
+                TexturePtr tex = TextureManager::getSingleton().getByName(getSourceForTex(img.name, img.mrtIndex));
+                if(!tex)
+                {
+                    LogManager::getSingleton().logMessage("Warning in compilation of Compositor "
+                        +mCompositor->getName()+": image "+img.name+" not found", LML_CRITICAL);
+                    continue;
+                }
+                rsComputeOperation->addImage((uint)x, tex, img.access);
+                finalState.inputTargets.insert(getTargetForTex(img.name));
+                if(img.access != TA_READ)
+                    finalState.localOutput = false;
+            }
+
+            queueRenderSystemOp(finalState,rsComputeOperation);
+            }
+            break;
         case CompositionPass::PT_RENDERCUSTOM:
 		
 			finalState.currentQueueGroupID = pass->getFirstRenderQueue();
@@ -456,6 +617,18 @@ void CompositorInstance::_compileTargetOperations(CompiledState &compiledState)
         ts.lodBias = target->getLodBias();
         ts.shadowsEnabled = target->getShadowsEnabled();
         ts.materialScheme = target->getMaterialScheme();
+        CompositionTechnique::TextureDefinition* def = mTechnique->getTextureDefinition(target->getOutputName());
+        ts.localOutput = def && def->refCompName.empty() && def->scope == CompositionTechnique::TS_LOCAL;
+        ts.dynamicResolution = isDynamicResolution(target->getOutputName());
+        ts.dontCareBuffers = target->getDontCareBuffers();
+        ts.discardBuffers = target->getDiscardBuffers();
+        /// Buffers cleared before anything else is drawn don't need their old contents,
+        /// unless only part of the texture is cleared at a lower resolution
+        if(target->getInputMode() == CompositionTargetPass::IM_NONE && !ts.dynamicResolution &&
+           target->getNumPasses() && target->getPass(0)->getType() == CompositionPass::PT_CLEAR)
+        {
+            ts.dontCareBuffers |= target->getPass(0)->getClearBuffers();
+        }
         /// Check for input mode previous
         if(target->getInputMode() == CompositionTargetPass::IM_PREVIOUS)
         {
@@ -515,7 +688,7 @@ void CompositorInstance::setTechnique(CompositionTechnique* tech, bool reuseText
             while(it.hasMoreElements())
             {
                 CompositionTechnique::TextureDefinition *def = it.getNext();
-                if (def->pooled)
+                if (isPooled(def))
                 {
                     LocalTextureMap::iterator i = mLocalTextures.find(def->name);
                     if (i != mLocalTextures.end())
@@ -616,8 +789,26 @@ void CompositorInstance::createResources(bool forResizeOnly)
     /// In principle, temporary textures could be shared between multiple viewports
     /// (CompositorChains). This will save a lot of memory in case more viewports
     /// are composited.
+    /// Within this instance, pooled textures are shared between definitions which
+    /// are not used by the same target passes.
+    TextureLifetimeMap lifetimes;
+    computeTextureLifetimes(lifetimes);
+
+    typedef vector<std::pair<Texture*, TextureLifetime> >::type AssignedTextureList;
+    AssignedTextureList assigned;
+
+    // Textures kept over a resize are still in use
+    for (LocalTextureMap::iterator t = mLocalTextures.begin(); t != mLocalTextures.end(); ++t)
+    {
+        // MRT surfaces are named after their definition
+        TextureLifetimeMap::iterator l = lifetimes.find(t->first);
+        if (l == lifetimes.end())
+            l = lifetimes.find(t->first.substr(0, t->first.find_last_of('/')));
+        if (l != lifetimes.end())
+            assigned.push_back(std::make_pair(t->second.get(), l->second));
+    }
+
     CompositionTechnique::TextureDefinitionIterator it = mTechnique->getTextureDefinitionIterator();
-    CompositorManager::UniqueTextureSet assignedTextures;
     while(it.hasMoreElements())
     {
         CompositionTechnique::TextureDefinition *def = it.getNext();
@@ -626,6 +817,16 @@ void CompositorInstance::createResources(bool forResizeOnly)
             //This is a reference, isn't created in this compositor
             continue;
         }
+
+        const TextureLifetime& lifetime = lifetimes[def->name];
+
+        // The pool must not hand out textures in use during our lifetime
+        CompositorManager::UniqueTextureSet assignedTextures;
+        for (AssignedTextureList::iterator t = assigned.begin(); t != assigned.end(); ++t)
+        {
+            if (t->second.first <= lifetime.last && lifetime.first <= t->second.last)
+                assignedTextures.insert(t->first);
+        }
         
         RenderTarget* rendTarget;
         if (def->scope == CompositionTechnique::TS_GLOBAL) {
@@ -664,8 +865,15 @@ void CompositorInstance::createResources(bool forResizeOnly)
             // from the target size
             if (forResizeOnly && width != 0 && height != 0)
                 continue;
+
+            if (def->scope == CompositionTechnique::TS_LOCAL && !lifetime.persistent &&
+                CompositorManager::getSingleton().getPoolTransientTextures())
+            {
+                mPooledTextureDefs.insert(def);
+            }
             
             deriveTextureRenderTargetOptions(def->name, &hwGamma, &fsaa, &fsaaHint);
+            int usage = deriveTextureUsage(def->name);
             
             if(width == 0)
                 width = static_cast<size_t>(
@@ -700,21 +908,21 @@ void CompositorInstance::createResources(bool forResizeOnly)
                     String texname = MRTbaseName + "/" + StringConverter::toString(atch);
                     String mrtLocalName = getMRTTexLocalName(def->name, atch);
                     TexturePtr tex;
-                    if (def->pooled)
+                    if (isPooled(def))
                     {
                         // get / create pooled texture
                         tex = CompositorManager::getSingleton().getPooledTexture(texname,
                                                                                  mrtLocalName, 
                                                                                  width, height, *p, fsaa, fsaaHint,  
                                                                                  hwGamma && !PixelUtil::isFloatingPoint(*p), 
-                                                                                 assignedTextures, this, def->scope);
+                                                                                 assignedTextures, this, def->scope, usage);
                     }
                     else
                     {
                         tex = TextureManager::getSingleton().createManual(
                                                                           texname, 
                                                                           ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, TEX_TYPE_2D, 
-                                                                          (uint)width, (uint)height, 0, *p, TU_RENDERTARGET, 0, 
+                                                                          (uint)width, (uint)height, 0, *p, usage, 0, 
                                                                           hwGamma && !PixelUtil::isFloatingPoint(*p), fsaa, fsaaHint ); 
                     }
                     
@@ -724,6 +932,7 @@ void CompositorInstance::createResources(bool forResizeOnly)
                     
                     // Also add to local textures so we can look up
                     mLocalTextures[mrtLocalName] = tex;
+                    assigned.push_back(std::make_pair(tex.get(), lifetime));
                     
                 }
                 
@@ -739,25 +948,26 @@ void CompositorInstance::createResources(bool forResizeOnly)
                 std::replace( texName.begin(), texName.end(), ' ', '_' ); 
                 
                 TexturePtr tex;
-                if (def->pooled)
+                if (isPooled(def))
                 {
                     // get / create pooled texture
                     tex = CompositorManager::getSingleton().getPooledTexture(texName, 
                                                                              def->name, width, height, def->formatList[0], fsaa, fsaaHint,
                                                                              hwGamma && !PixelUtil::isFloatingPoint(def->formatList[0]), assignedTextures, 
-                                                                             this, def->scope);
+                                                                             this, def->scope, usage);
                 }
                 else
                 {
                     tex = TextureManager::getSingleton().createManual(
                                                                       texName, 
                                                                       ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, TEX_TYPE_2D, 
-                                                                      (uint)width, (uint)height, 0, def->formatList[0], TU_RENDERTARGET, 0,
+                                                                      (uint)width, (uint)height, 0, def->formatList[0], usage, 0,
                                                                       hwGamma && !PixelUtil::isFloatingPoint(def->formatList[0]), fsaa, fsaaHint); 
                 }
                 
                 rendTarget = tex->getBuffer()->getRenderTarget();
                 mLocalTextures[def->name] = tex;
+                assigned.push_back(std::make_pair(tex.get(), lifetime));
             }
         }
         
@@ -801,6 +1011,118 @@ void CompositorInstance::createResources(bool forResizeOnly)
     _fireNotifyResourcesCreated(forResizeOnly);
 }
 //---------------------------------------------------------------------
+void CompositorInstance::computeTextureLifetimes(TextureLifetimeMap& lifetimes)
+{
+    // The target passes are compiled in order, followed by the output target pass
+    const size_t frameEnd = mTechnique->getNumTargetPasses();
+
+    for (size_t index = 0; index <= frameEnd; ++index)
+    {
+        CompositionTargetPass* tp = index < frameEnd ?
+            mTechnique->getTargetPass(index) : mTechnique->getOutputTargetPass();
+
+        CompositionTargetPass::PassIterator pit = tp->getPassIterator();
+        bool overwrites = tp->getInputMode() == CompositionTargetPass::IM_PREVIOUS;
+        bool firstPass = true;
+        while (pit.hasMoreElements())
+        {
+            CompositionPass* pass = pit.getNext();
+            if (firstPass)
+            {
+                // A full screen quad or a colour clear replaces whatever was there
+                overwrites = overwrites || pass->getType() == CompositionPass::PT_RENDERQUAD ||
+                    (pass->getType() == CompositionPass::PT_CLEAR && (pass->getClearBuffers() & FBT_COLOUR));
+                firstPass = false;
+            }
+
+            for (size_t i = 0; i < pass->getNumInputs(); ++i)
+            {
+                const String& name = pass->getInput(i).name;
+                if (name.empty())
+                    continue;
+
+                TextureLifetimeMap::iterator l = lifetimes.find(name);
+                if (l == lifetimes.end())
+                {
+                    // read before written this frame
+                    TextureLifetime lifetime = { index, index, true };
+                    lifetimes[name] = lifetime;
+                }
+                else
+                    l->second.last = index;
+            }
+        }
+
+        if (index == frameEnd)
+            break;
+
+        const String& name = tp->getOutputName();
+        TextureLifetimeMap::iterator l = lifetimes.find(name);
+        if (l == lifetimes.end())
+        {
+            TextureLifetime lifetime = { index, index, !overwrites || tp->getOnlyInitial() };
+            lifetimes[name] = lifetime;
+        }
+        else
+        {
+            l->second.last = index;
+            l->second.persistent = l->second.persistent || tp->getOnlyInitial();
+        }
+    }
+
+    CompositionTechnique::TextureDefinitionIterator it = mTechnique->getTextureDefinitionIterator();
+    while (it.hasMoreElements())
+    {
+        CompositionTechnique::TextureDefinition* def = it.getNext();
+        TextureLifetimeMap::iterator l = lifetimes.find(def->name);
+        if (l == lifetimes.end())
+        {
+            // not referenced by the technique, maybe by a listener or logic
+            TextureLifetime lifetime = { 0, frameEnd, true };
+            lifetimes[def->name] = lifetime;
+        }
+        else if (l->second.persistent)
+        {
+            l->second.first = 0;
+            l->second.last = frameEnd;
+        }
+    }
+}
+//---------------------------------------------------------------------
+bool CompositorInstance::isPooled(CompositionTechnique::TextureDefinition* def) const
+{
+    return def->pooled || mPooledTextureDefs.find(def) != mPooledTextureDefs.end();
+}
+//---------------------------------------------------------------------
+bool CompositorInstance::isDynamicResolution(const String& texname) const
+{
+    CompositionTechnique::TextureDefinition* def = mTechnique->getTextureDefinition(texname);
+    return def && def->dynamicResolution && def->refCompName.empty() &&
+        def->width == 0 && def->height == 0;
+}
+//---------------------------------------------------------------------
+int CompositorInstance::deriveTextureUsage(const String& texname) const
+{
+    CompositionTechnique::TargetPassIterator it = mTechnique->getTargetPassIterator();
+    while (it.hasMoreElements())
+    {
+        CompositionTargetPass::PassIterator pit = it.getNext()->getPassIterator();
+        while (pit.hasMoreElements())
+        {
+            CompositionPass* pass = pit.getNext();
+            if (pass->getType() != CompositionPass::PT_COMPUTE)
+                continue;
+
+            for (size_t x = 0; x < pass->getNumImages(); ++x)
+            {
+                if (pass->getImage(x).name == texname)
+                    return TU_RENDERTARGET | TU_UNORDERED_ACCESS;
+            }
+        }
+    }
+    return TU_RENDERTARGET;
+}
+//---------------------------------------------------------------------
 void CompositorInstance::deriveTextureRenderTargetOptions(
     const String& texname, bool *hwGammaWrite, uint *fsaa, String* fsaaHint)
 {
@@ -913,7 +1235,7 @@ void CompositorInstance::freeResources(bool forResizeOnly, bool clearReserveText
                 LocalTextureMap::iterator i = mLocalTextures.find(texName);
                 if (i != mLocalTextures.end())
                 {
-                    if (!def->pooled && def->scope != CompositionTechnique::TS_GLOBAL)
+                    if (!isPooled(def) && def->scope != CompositionTechnique::TS_GLOBAL)
                     {
                         // remove myself from central only if not pooled and not global
                         TextureManager::getSingleton().remove(i->second);
@@ -943,9 +1265,13 @@ void CompositorInstance::freeResources(bool forResizeOnly, bool clearReserveText
 
             }
 
+
         } // not for resize or width/height 0
     }
 
+    if (!forResizeOnly)
+        mPooledTextureDefs.clear();
+
     if (clearReserveTextures)
     {
         if (forResizeOnly)
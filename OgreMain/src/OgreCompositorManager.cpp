@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgreTextureManager.h"
 #include "OgreRectangle2D.h"
 #include "OgreRenderTarget.h"
+#include "OgreHiZPyramid.h"
 
 namespace Ogre {
 
@@ -50,10 +51,13 @@ CompositorManager& CompositorManager::getSingleton(void)
     assert( msSingleton );  return ( *msSingleton );  
 }//-----------------------------------------------------------------------
 CompositorManager::CompositorManager():
-    mRectangle(0)
+    mRectangle(0), mHiZPass(0), mRectangleUVScale(1.0f), mPoolTransientTextures(false), mCullUnusedTargetPasses(false)
 {
     initialise();
 
+    mHiZPass = OGRE_NEW HiZCompositionPass();
+    registerCustomCompositionPass("HiZ", mHiZPass);
+
     // Loading order (just after materials)
     mLoadOrder = 110.0f;
 
@@ -70,6 +74,7 @@ CompositorManager::~CompositorManager()
     freeChains();
     freePooledTextures(false);
     OGRE_DELETE mRectangle;
+    OGRE_DELETE mHiZPass;
 
     // Resources cleared by superclass
     // Unregister with resource group manager
@@ -151,7 +156,7 @@ void CompositorManager::freeChains()
     mChains.clear();
 }
 //-----------------------------------------------------------------------
-Renderable *CompositorManager::_getTexturedRectangle2D()
+Renderable *CompositorManager::_getTexturedRectangle2D(Real uvScale)
 {
     if(!mRectangle)
     {
@@ -163,6 +168,11 @@ Renderable *CompositorManager::_getTexturedRectangle2D()
     Real hOffset = rs->getHorizontalTexelOffset() / (0.5f * vp->getActualWidth());
     Real vOffset = rs->getVerticalTexelOffset() / (0.5f * vp->getActualHeight());
     mRectangle->setCorners(-1 + hOffset, 1 - vOffset, 1 + hOffset, -1 - vOffset);
+    if (uvScale != mRectangleUVScale)
+    {
+        mRectangle->setUVs(Vector2::ZERO, Vector2(0, uvScale), Vector2(uvScale, 0), Vector2(uvScale, uvScale));
+        mRectangleUVScale = uvScale;
+    }
     return mRectangle;
 }
 //-----------------------------------------------------------------------
@@ -227,6 +237,7 @@ void CompositorManager::_reconstructAllCompositorResources()
     //UVs are lost, and will never be reconstructed unless we do them again, now
     if( mRectangle )
         mRectangle->setDefaultUVs();
+    mRectangleUVScale = 1.0f;
 
     for (InstVec::iterator i = instancesToReenable.begin(); i != instancesToReenable.end(); ++i)
     {
@@ -239,7 +250,7 @@ TexturePtr CompositorManager::getPooledTexture(const String& name,
     const String& localName,
     size_t w, size_t h, PixelFormat f, uint aa, const String& aaHint, bool srgb, 
     CompositorManager::UniqueTextureSet& texturesAssigned, 
-    CompositorInstance* inst, CompositionTechnique::TextureScope scope)
+    CompositorInstance* inst, CompositionTechnique::TextureScope scope, int usage)
 {
     if (scope == CompositionTechnique::TS_GLOBAL) 
     {
@@ -248,7 +259,7 @@ TexturePtr CompositorManager::getPooledTexture(const String& name,
             "CompositorManager::getPooledTexture");
     }
 
-    TextureDef def(w, h, f, aa, aaHint, srgb);
+    TextureDef def(w, h, f, aa, aaHint, srgb, usage);
 
     if (scope == CompositionTechnique::TS_CHAIN)
     {
@@ -263,7 +274,7 @@ TexturePtr CompositorManager::getPooledTexture(const String& name,
         TexturePtr newTex = TextureManager::getSingleton().createManual(
             name, 
             ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, TEX_TYPE_2D, 
-            (uint)w, (uint)h, 0, f, TU_RENDERTARGET, 0,
+            (uint)w, (uint)h, 0, f, usage, 0,
             srgb, aa, aaHint);
         defMap.insert(TextureDefMap::value_type(def, newTex));
         return newTex;
@@ -325,7 +336,7 @@ TexturePtr CompositorManager::getPooledTexture(const String& name,
         ret = TextureManager::getSingleton().createManual(
             name, 
             ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, TEX_TYPE_2D, 
-            (uint)w, (uint)h, 0, f, TU_RENDERTARGET, 0,
+            (uint)w, (uint)h, 0, f, usage, 0,
             srgb, aa, aaHint); 
 
         texList->push_back(ret);
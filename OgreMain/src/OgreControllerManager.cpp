@@ -30,8 +30,48 @@ THE SOFTWARE.
 
 #include "OgreRoot.h"
 #include "OgrePredefinedControllers.h"
+#include "Threading/OgreParallel.h"
 
 namespace Ogre {
+    namespace
+    {
+        /// Number of controllers updated in one piece, serially or on a worker
+        const size_t CONTROLLER_GRAIN_SIZE = 1024;
+
+        /// Update a range of controllers, reading the frame time source only once
+        void updateControllers(Controller<Real>* const* controllers, size_t count,
+            const ControllerValue<Real>* frameTimeSource, Real frameTime)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                Controller<Real>* c = controllers[i];
+                if (!c->getEnabled())
+                    continue;
+
+                const ControllerValue<Real>* src = c->getSource().get();
+                Real value = src == frameTimeSource ? frameTime : src->getValue();
+                c->getDestination()->setValue(c->getFunction()->calculate(value));
+            }
+        }
+
+        /// Updates the controllers on the worker threads
+        struct ControllerUpdateJob : public ParallelJob
+        {
+            Controller<Real>* const* controllers;
+            const ControllerValue<Real>* frameTimeSource;
+            Real frameTime;
+
+            ControllerUpdateJob(Controller<Real>* const* c, size_t count,
+                const ControllerValue<Real>* source, Real time)
+                : ParallelJob(count, CONTROLLER_GRAIN_SIZE), controllers(c),
+                  frameTimeSource(source), frameTime(time) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                updateControllers(controllers + begin, end - begin, frameTimeSource, frameTime);
+            }
+        };
+    }
     //-----------------------------------------------------------------------
     template<> ControllerManager* Singleton<ControllerManager>::msSingleton = 0;
     ControllerManager* ControllerManager::getSingletonPtr(void)
@@ -46,6 +86,7 @@ namespace Ogre {
     ControllerManager::ControllerManager()
         : mFrameTimeController(OGRE_NEW FrameTimeControllerValue())
         , mPassthroughFunction(OGRE_NEW PassthroughControllerFunction())
+        , mParallelUpdate(false)
         , mLastFrameNumber(0)
     {
 
@@ -62,7 +103,8 @@ namespace Ogre {
     {
         Controller<Real>* c = OGRE_NEW Controller<Real>(src, dest, func);
 
-        mControllers.insert(c);
+        mControllerIndices[c] = mControllers.size();
+        mControllers.push_back(c);
         return c;
     }
     //-----------------------------------------------------------------------
@@ -78,10 +120,20 @@ namespace Ogre {
         unsigned long thisFrameNumber = Root::getSingleton().getNextFrameNumber();
         if (thisFrameNumber != mLastFrameNumber)
         {
-            ControllerList::const_iterator ci;
-            for (ci = mControllers.begin(); ci != mControllers.end(); ++ci)
+            if (!mControllers.empty())
             {
-                (*ci)->update();
+                const ControllerValue<Real>* frameTimeSource = mFrameTimeController.get();
+                Real frameTime = frameTimeSource->getValue();
+
+                if (mParallelUpdate && mControllers.size() > CONTROLLER_GRAIN_SIZE)
+                {
+                    ParallelJob::run(ParallelJobPtr(OGRE_NEW ControllerUpdateJob(
+                        &mControllers[0], mControllers.size(), frameTimeSource, frameTime)));
+                }
+                else
+                {
+                    updateControllers(&mControllers[0], mControllers.size(), frameTimeSource, frameTime);
+                }
             }
             mLastFrameNumber = thisFrameNumber;
         }
@@ -95,6 +147,7 @@ namespace Ogre {
             OGRE_DELETE *ci;
         }
         mControllers.clear();
+        mControllerIndices.clear();
     }
     //-----------------------------------------------------------------------
     const ControllerValueRealPtr& ControllerManager::getFrameTimeSource(void) const
@@ -219,10 +272,18 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ControllerManager::destroyController(Controller<Real>* controller)
     {
-        ControllerList::iterator i = mControllers.find(controller);
-        if (i != mControllers.end())
+        ControllerIndexMap::iterator i = mControllerIndices.find(controller);
+        if (i != mControllerIndices.end())
         {
-            mControllers.erase(i);
+            // move the last controller into the gap
+            size_t index = i->second;
+            mControllerIndices.erase(i);
+            if (index != mControllers.size() - 1)
+            {
+                mControllers[index] = mControllers.back();
+                mControllerIndices[mControllers[index]] = index;
+            }
+            mControllers.pop_back();
             OGRE_DELETE controller;
         }
     }
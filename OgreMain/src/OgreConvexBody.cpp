@@ -374,7 +374,8 @@ namespace Ogre
         // Erase all polygons facing towards the point. For all edges that
         // are not removed twice (once in AB and once BA direction) build a
         // convex polygon (triangle) with the point.
-        Polygon::EdgeMap edgeMap;
+        Polygon::EdgeList& edges = mEdges;
+        edges.clear();
 
         for ( size_t i = 0; i < getPolygonCount(); ++i )
         {
@@ -389,7 +390,13 @@ namespace Ogre
             {
                 // store edges (copy them because if the polygon is deleted
                 // its vertices are also deleted)
-                storeEdgesOfPolygon( i, &edgeMap );
+                const Polygon& p = getPolygon( i );
+                const size_t vertexCount = p.getVertexCount();
+                for ( size_t iVertex = 0; iVertex < vertexCount; ++iVertex )
+                {
+                    edges.push_back( Polygon::Edge( p.getVertex( iVertex ),
+                        p.getVertex( ( iVertex + 1 ) % vertexCount ) ) );
+                }
 
                 // remove polygon
                 deletePolygon( i );
@@ -400,64 +407,50 @@ namespace Ogre
         }
 
         // point is already a part of the hull (point lies inside)
-        if ( edgeMap.empty() )
+        if ( edges.empty() )
             return;
 
         // remove the edges that are twice in the list (once from each side: AB,BA)
-
-        Polygon::EdgeMap::iterator it;
-        // iterate from first to the element before the last one
-        for (Polygon::EdgeMap::iterator itStart = edgeMap.begin(); 
-            itStart != edgeMap.end(); )
+        // the order of the edges does not matter, so erase by moving the last one in
+        for ( size_t iStart = 0; iStart < edges.size(); )
         {
-            // compare with iterator + 1 to end
-            // don't need to skip last entry in itStart since omitted in inner loop
-            it = itStart;
-            ++it;
-
             bool erased = false;
-            // iterate from itStart+1 to the element before the last one
-            for ( ; it != edgeMap.end(); ++it )
-            {   
-                if (itStart->first.positionEquals(it->second) &&
-                     itStart->second.positionEquals(it->first))
+            for ( size_t i = iStart + 1; i < edges.size(); ++i )
+            {
+                if (edges[iStart].first.positionEquals(edges[i].second) &&
+                    edges[iStart].second.positionEquals(edges[i].first))
                 {
-                    edgeMap.erase(it);
-                    // increment itStart before deletion (iterator invalidation)
-                    Polygon::EdgeMap::iterator delistart = itStart++;
-                    edgeMap.erase(delistart);
+                    // erase the later one first, so that iStart stays valid
+                    edges[i] = edges.back();
+                    edges.pop_back();
+                    edges[iStart] = edges.back();
+                    edges.pop_back();
                     erased = true;
 
                     break; // found and erased
                 }
             }
-            // increment itStart if we didn't do it when erasing
+            // the moved in edge is compared next if we erased
             if (!erased)
-                ++itStart;
-
+                ++iStart;
         }
 
         // use the remaining edges to build triangles with the point
         // the vertices of the edges are in ccw order (edgePtA-edgePtB-point
         // to form a ccw polygon)
-        while ( !edgeMap.empty() )
+        for ( size_t i = 0; i < edges.size(); ++i )
         {
-            Polygon::EdgeMap::iterator mapIt = edgeMap.begin();
-
             // build polygon it.first, it.second, point
             Polygon *p = allocatePolygon();
 
-            p->insertVertex(mapIt->first);
-            p->insertVertex(mapIt->second);
+            p->insertVertex(edges[i].first);
+            p->insertVertex(edges[i].second);
 
             p->insertVertex( pt );
             // attach polygon to body
             insertPolygon( p );
-
-            // erase the vertices from the list
-            // pointers are now held by the polygon
-            edgeMap.erase( mapIt );
         }
+        edges.clear();
     }
     //-----------------------------------------------------------------------
     void ConvexBody::reset( void )
@@ -911,29 +904,34 @@ namespace Ogre
         if ( getPolygonCount() == 0 )
             return;
 
-        // current will be used as the reference body
-        ConvexBody current;
-        current.moveDataFromBody(*this);
+        // the current polygons will be used as the reference body, the
+        // scratch list swapped in keeps its space from the last clip
+        PolygonList& current = mClipPolygons;
+        current.swap(mPolygons);
+        mPolygons.clear();
         
-        OgreAssert( this->getPolygonCount() == 0, "Body not empty!" );
-        OgreAssert( current.getPolygonCount() != 0, "Body empty!" );
+        OgreAssert( current.size() != 0, "Body empty!" );
 
         // holds all intersection edges for the different polygons
-        Polygon::EdgeMap intersectionEdges;
+        Polygon::EdgeList& intersectionEdges = mEdges;
+        intersectionEdges.clear();
+
+        // the sides of the vertices, on the stack unless it is a large polygon
+        Plane::Side sideBuffer[16];
 
         // clip all polygons by the intersection plane
         // add only valid or intersected polygons to *this
-        for ( size_t iPoly = 0; iPoly < current.getPolygonCount(); ++iPoly )
+        for ( size_t iPoly = 0; iPoly < current.size(); ++iPoly )
         {
 
             // fetch vertex count and ignore polygons with less than three vertices
             // the polygon is not valid and won't be added
-            const size_t vertexCount = current.getVertexCount( iPoly );
+            const size_t vertexCount = current[ iPoly ]->getVertexCount();
             if ( vertexCount < 3 )
                 continue;
 
             // current polygon
-            const Polygon& p = current.getPolygon( iPoly );
+            const Polygon& p = *current[ iPoly ];
 
             // the polygon to assemble
             Polygon *pNew = allocatePolygon();
@@ -948,7 +946,8 @@ namespace Ogre
             // - side is clipSide: vertex will be clipped
             // - side is !clipSide: vertex will be untouched
             // - side is NOSIDE:   vertex will be untouched
-            Plane::Side *side = OGRE_ALLOC_T(Plane::Side, vertexCount, MEMCATEGORY_SCENE_CONTROL);
+            Plane::Side *side = vertexCount <= 16 ? sideBuffer :
+                OGRE_ALLOC_T(Plane::Side, vertexCount, MEMCATEGORY_SCENE_CONTROL);
             for ( size_t iVertex = 0; iVertex < vertexCount; ++iVertex )
             {
                 side[ iVertex ] = pl.getSide( p.getVertex( iVertex ) );
@@ -1063,8 +1062,8 @@ namespace Ogre
             // insert intersection polygon only, if there are two vertices present
             if ( pIntersect->getVertexCount() == 2 )
             {
-                intersectionEdges.insert( Polygon::Edge( pIntersect->getVertex( 0 ),
-                                                          pIntersect->getVertex( 1 ) ) );
+                intersectionEdges.push_back( Polygon::Edge( pIntersect->getVertex( 0 ),
+                                                             pIntersect->getVertex( 1 ) ) );
             }
 
             // delete intersection polygon
@@ -1073,10 +1072,16 @@ namespace Ogre
             pIntersect = 0;
 
             // delete side info
-            OGRE_FREE(side, MEMCATEGORY_SCENE_CONTROL);
+            if ( side != sideBuffer )
+                OGRE_FREE(side, MEMCATEGORY_SCENE_CONTROL);
             side = 0;
         }
 
+        // release the reference body
+        for ( size_t iPoly = 0; iPoly < current.size(); ++iPoly )
+            freePolygon( current[ iPoly ] );
+        current.clear();
+
         // if the polygon was partially clipped, close it
         // at least three edges are needed for a polygon
         if ( intersectionEdges.size() >= 3 )
@@ -1087,14 +1092,12 @@ namespace Ogre
             // Each point is twice in the list because of the fact that we have a convex body
             // with convex polygons. All we have to do is order the edges (an even-odd pair)
             // in a ccw order. The plane normal shows us the direction.
-            Polygon::EdgeMap::iterator it = intersectionEdges.begin();
-
             // check the cross product of the first two edges
-            Vector3 vFirst  = it->first;
-            Vector3 vSecond = it->second;
+            Vector3 vFirst  = intersectionEdges.back().first;
+            Vector3 vSecond = intersectionEdges.back().second;
 
             // remove inserted edge
-            intersectionEdges.erase( it );
+            intersectionEdges.pop_back();
 
             Vector3 vNext;
 
@@ -1181,17 +1184,18 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------
     bool ConvexBody::findAndEraseEdgePair(const Vector3& vec, 
-        Polygon::EdgeMap& intersectionEdges, Vector3& vNext ) const
+        Polygon::EdgeList& intersectionEdges, Vector3& vNext ) const
     {
-        for (Polygon::EdgeMap::iterator it = intersectionEdges.begin(); 
+        for (Polygon::EdgeList::iterator it = intersectionEdges.begin(); 
             it != intersectionEdges.end(); ++it)
         {
             if (it->first.positionEquals(vec))
             {
                 vNext = it->second;
 
-                // erase found edge
-                intersectionEdges.erase( it );
+                // erase found edge, the order does not matter
+                *it = intersectionEdges.back();
+                intersectionEdges.pop_back();
 
                 return true; // found!
             }
@@ -1199,8 +1203,9 @@ namespace Ogre
             {
                 vNext = it->first;
 
-                // erase found edge
-                intersectionEdges.erase( it );
+                // erase found edge, the order does not matter
+                *it = intersectionEdges.back();
+                intersectionEdges.pop_back();
 
                 return true; // found!
             }
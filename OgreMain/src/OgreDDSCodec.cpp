@@ -200,14 +200,6 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     DataStreamPtr DDSCodec::encode(MemoryDataStreamPtr& input, Codec::CodecDataPtr& pData) const
-    {        
-        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
-            "DDS encoding not supported",
-            "DDSCodec::encode" ) ;
-    }
-    //---------------------------------------------------------------------
-    void DDSCodec::encodeToFile(MemoryDataStreamPtr& input,
-        const String& outFileName, Codec::CodecDataPtr& pData) const
     {
         // Unwrap codecDataPtr - data is cleaned by calling function
         ImageData* imgData = static_cast<ImageData* >(pData.get());  
@@ -223,6 +215,7 @@ namespace Ogre {
         bool isFloat32r = (imgData->format == PF_FLOAT32_R);
         bool isFloat16 = (imgData->format == PF_FLOAT16_RGBA);
         bool isFloat32 = (imgData->format == PF_FLOAT32_RGBA);
+        bool isDXT = (imgData->format == PF_DXT1 || imgData->format == PF_DXT5);
         bool notImplemented = false;
         String notImplementedString = "";
 
@@ -257,6 +250,8 @@ namespace Ogre {
         case PF_FLOAT32_R:
         case PF_FLOAT16_RGBA:
         case PF_FLOAT32_RGBA:
+        case PF_DXT1:
+        case PF_DXT5:
             break;
         default:
             // No crazy FOURCC or 565 et al. file formats at this stage
@@ -272,11 +267,11 @@ namespace Ogre {
         {
             OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
                 "DDS encoding for" + notImplementedString + " not supported",
-                "DDSCodec::encodeToFile" ) ;
+                "DDSCodec::encode" ) ;
         }
         else
         {
-            // Build header and write to disk
+            // Build header and write to memory
 
             // Variables for some DDS header flags
             bool hasAlpha = false;
@@ -322,6 +317,9 @@ namespace Ogre {
                 ddsHeaderRgbBits = 32 * 4;
                 hasAlpha = true;
                 break;
+            case PF_DXT5:
+                hasAlpha = true;
+                break;
             default:
                 ddsHeaderRgbBits = 0;
                 break;
@@ -329,6 +327,12 @@ namespace Ogre {
 
             // Initalise the SizeOrPitch flags (power two textures for now)
             ddsHeaderSizeOrPitch = static_cast<uint32>(ddsHeaderRgbBits * imgData->width);
+            if (isDXT)
+            {
+                // linear size of the top level for compressed formats
+                ddsHeaderSizeOrPitch = static_cast<uint32>(PixelUtil::getMemorySize(
+                    imgData->width, imgData->height, 1, imgData->format));
+            }
 
             // Initalise the caps flags
             ddsHeaderCaps1 = (isVolume||isCubeMap) ? DDSCAPS_COMPLEX|DDSCAPS_TEXTURE : DDSCAPS_TEXTURE;
@@ -365,8 +369,12 @@ namespace Ogre {
 
             ddsHeader.pixelFormat.size = DDS_PIXELFORMAT_SIZE;
             ddsHeader.pixelFormat.flags = (hasAlpha) ? DDPF_RGB|DDPF_ALPHAPIXELS : DDPF_RGB;
-            ddsHeader.pixelFormat.flags = (isFloat32r || isFloat16 || isFloat32) ? DDPF_FOURCC : ddsHeader.pixelFormat.flags;
-            if (isFloat32r) {
+            ddsHeader.pixelFormat.flags = (isFloat32r || isFloat16 || isFloat32 || isDXT) ? DDPF_FOURCC : ddsHeader.pixelFormat.flags;
+            if (isDXT) {
+                ddsHeader.pixelFormat.fourCC = (imgData->format == PF_DXT1) ?
+                    FOURCC('D', 'X', 'T', '1') : FOURCC('D', 'X', 'T', '5');
+            }
+            else if (isFloat32r) {
                 ddsHeader.pixelFormat.fourCC = D3DFMT_R32F;
             }
             else if (isFloat16) {
@@ -385,14 +393,19 @@ namespace Ogre {
             ddsHeader.pixelFormat.redMask   = (isFloat32r) ? 0xFFFFFFFF :0x00FF0000;
             ddsHeader.pixelFormat.greenMask = (isFloat32r) ? 0x00000000 :0x0000FF00;
             ddsHeader.pixelFormat.blueMask  = (isFloat32r) ? 0x00000000 :0x000000FF;
+            if (isDXT)
+            {
+                ddsHeader.pixelFormat.alphaMask = ddsHeader.pixelFormat.redMask = 0;
+                ddsHeader.pixelFormat.greenMask = ddsHeader.pixelFormat.blueMask = 0;
+            }
 
             if( flipRgbMasks )
                 std::swap( ddsHeader.pixelFormat.redMask, ddsHeader.pixelFormat.blueMask );
 
             ddsHeader.caps.caps1 = ddsHeaderCaps1;
             ddsHeader.caps.caps2 = ddsHeaderCaps2;
-//          ddsHeader.caps.reserved[0] = 0;
-//          ddsHeader.caps.reserved[1] = 0;
+            ddsHeader.caps.caps3 = 0;
+            ddsHeader.caps.caps4 = 0;
 
             // Swap endian
             flipEndian(&ddsMagic, sizeof(uint32));
@@ -412,24 +425,35 @@ namespace Ogre {
                 dataPtr = tmpData;
             }
 
-            try
-            {
-                // Write the file
-                std::ofstream of;
-                of.open(outFileName.c_str(), std::ios_base::binary|std::ios_base::out);
-                of.write((const char *)&ddsMagic, sizeof(uint32));
-                of.write((const char *)&ddsHeader, DDS_HEADER_SIZE);
-                // XXX flipEndian on each pixel chunk written unless isFloat32r ?
-                of.write(dataPtr, (uint32)imgData->size);
-                of.close();
-            }
-            catch(...)
-            {
-                delete [] tmpData;
-            }
+            MemoryDataStreamPtr output(OGRE_NEW MemoryDataStream(
+                sizeof(uint32) + DDS_HEADER_SIZE + imgData->size));
+            output->write(&ddsMagic, sizeof(uint32));
+            output->write(&ddsHeader, DDS_HEADER_SIZE);
+            // XXX flipEndian on each pixel chunk written unless isFloat32r ?
+            output->write(dataPtr, imgData->size);
+            output->seek(0);
+
+            delete [] tmpData;
+            return output;
         }
     }
     //---------------------------------------------------------------------
+    void DDSCodec::encodeToFile(MemoryDataStreamPtr& input,
+        const String& outFileName, Codec::CodecDataPtr& pData) const
+    {
+        MemoryDataStreamPtr data = static_pointer_cast<MemoryDataStream>(encode(input, pData));
+        std::ofstream of(outFileName.c_str(), std::ios_base::binary|std::ios_base::out);
+
+        if (!of.is_open())
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "could not open file " + outFileName,
+                "DDSCodec::encodeToFile" ) ;
+        }
+
+        of.write((const char*)data->getPtr(), data->size());
+    }
+    //---------------------------------------------------------------------
     PixelFormat DDSCodec::convertDXToOgreFormat(uint32 dxfmt) const
     {
         switch (dxfmt) {
@@ -30,6 +30,18 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreException.h"
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  if !defined(NOMINMAX) && defined(_MSC_VER)
+#   define NOMINMAX // required to stop windows.h messing up std::min
+#  endif
+#  include <windows.h>
+#elif OGRE_PLATFORM != OGRE_PLATFORM_WINRT
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
 namespace Ogre {
 
     //-----------------------------------------------------------------------
@@ -470,6 +482,73 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    MappedFileDataStream::MappedFileDataStream(const String& name, const String& path, size_t size)
+        : MemoryDataStream(name, 0, 0, false, true)
+    {
+        assert(size > 0 && "Empty files can not be mapped");
+        void* data = 0;
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        mMappingHandle = 0;
+        mFileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, NULL);
+        if (mFileHandle == INVALID_HANDLE_VALUE)
+        {
+            mFileHandle = 0;
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "Cannot open file: " + path,
+                        "MappedFileDataStream::MappedFileDataStream");
+        }
+        mMappingHandle = CreateFileMappingA(mFileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mMappingHandle)
+            data = MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, size);
+        if (!data)
+        {
+            if (mMappingHandle)
+                CloseHandle(mMappingHandle);
+            CloseHandle(mFileHandle);
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "Cannot map file: " + path,
+                        "MappedFileDataStream::MappedFileDataStream");
+        }
+#elif OGRE_PLATFORM != OGRE_PLATFORM_WINRT
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "Cannot open file: " + path,
+                        "MappedFileDataStream::MappedFileDataStream");
+        data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping keeps the file referenced
+        ::close(fd);
+        if (data == MAP_FAILED)
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "Cannot map file: " + path,
+                        "MappedFileDataStream::MappedFileDataStream");
+#else
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "Files can not be mapped on this platform",
+                    "MappedFileDataStream::MappedFileDataStream");
+#endif
+        mData = mPos = static_cast<uchar*>(data);
+        mSize = size;
+        mEnd = mData + mSize;
+    }
+    //-----------------------------------------------------------------------
+    MappedFileDataStream::~MappedFileDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    void MappedFileDataStream::close(void)
+    {
+        if (!mData)
+            return;
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        UnmapViewOfFile(mData);
+        CloseHandle(mMappingHandle);
+        CloseHandle(mFileHandle);
+#elif OGRE_PLATFORM != OGRE_PLATFORM_WINRT
+        munmap(mData, mSize);
+#endif
+        mData = mPos = mEnd = 0;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     FileStreamDataStream::FileStreamDataStream(std::ifstream* s, bool freeOnClose)
         : DataStream(), mInStream(s), mFStreamRO(s), mFStream(0), mFreeOnClose(freeOnClose)
     {
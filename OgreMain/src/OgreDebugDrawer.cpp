@@ -0,0 +1,227 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreDebugDrawer.h"
+
+#include "OgreHardwareBufferManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreRenderQueue.h"
+#include "OgreSphere.h"
+#include "OgreRoot.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    DebugDrawer::DebugDrawer()
+        : mSceneStart(0), mFrameNumber(0)
+    {
+        mRenderOp.vertexData = 0;
+        mRenderOp.indexData = 0;
+        mRenderOp.operationType = RenderOperation::OT_LINE_LIST;
+        mRenderOp.useIndexes = false;
+        mRenderOp.useGlobalInstancingVertexBufferIsAvailable = false;
+    }
+    //-----------------------------------------------------------------------
+    DebugDrawer::~DebugDrawer()
+    {
+        OGRE_DELETE mRenderOp.vertexData;
+    }
+    //-----------------------------------------------------------------------
+    void DebugDrawer::checkFrame(void)
+    {
+        Root* root = Root::getSingletonPtr();
+        unsigned long frameNumber = root ? root->getNextFrameNumber() : 0;
+        if (frameNumber != mFrameNumber)
+        {
+            mFrameNumber = frameNumber;
+            mVertices.clear();
+            mSceneStart = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void DebugDrawer::addVertex(const Vector3& position, const ColourValue& colour)
+    {
+        mVertices.push_back(Vertex());
+        mVertices.back().position = position;
+        mVertices.back().colour = colour;
+    }
+    //-----------------------------------------------------------------------
+    void DebugDrawer::drawLine(const Vector3& start, const Vector3& end, const ColourValue& colour)
+    {
+        checkFrame();
+        addVertex(start, colour);
+        addVertex(end, colour);
+    }
+    //-----------------------------------------------------------------------
+    void DebugDrawer::drawBox(const AxisAlignedBox& box, const ColourValue& colour)
+    {
+        if (!box.isFinite())
+            return;
+
+        checkFrame();
+        const Vector3* corners = box.getAllCorners();
+
+        // See getAllCorners for the order, the back face, the front face and the edges between
+        static const uint8 edges[12][2] = {
+            { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 },
+            { 4, 5 }, { 5, 6 }, { 6, 7 }, { 7, 4 },
+            { 0, 6 }, { 1, 5 }, { 2, 4 }, { 3, 7 } };
+
+        for (int i = 0; i < 12; ++i)
+        {
+            addVertex(corners[edges[i][0]], colour);
+            addVertex(corners[edges[i][1]], colour);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void DebugDrawer::drawSphere(const Sphere& sphere, const ColourValue& colour, unsigned int segments)
+    {
+        checkFrame();
+        const Vector3& centre = sphere.getCenter();
+        Real radius = sphere.getRadius();
+        segments = std::max(segments, 3u);
+
+        Vector3 prev[3];
+        for (unsigned int s = 0; s <= segments; ++s)
+        {
+            Radian angle(Math::TWO_PI * s / segments);
+            Real c = Math::Cos(angle) * radius;
+            Real d = Math::Sin(angle) * radius;
+            Vector3 points[3] = {
+                centre + Vector3(c, d, 0),
+                centre + Vector3(0, c, d),
+                centre + Vector3(d, 0, c) };
+
+            for (int i = 0; i < 3; ++i)
+            {
+                if (s > 0)
+                {
+                    addVertex(prev[i], colour);
+                    addVertex(points[i], colour);
+                }
+                prev[i] = points[i];
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void DebugDrawer::clear(void)
+    {
+        mVertices.clear();
+        mSceneStart = 0;
+    }
+    //-----------------------------------------------------------------------
+    void DebugDrawer::_beginScene(void)
+    {
+        checkFrame();
+        mSceneStart = mVertices.size();
+    }
+    //-----------------------------------------------------------------------
+    void DebugDrawer::_endScene(void)
+    {
+        mVertices.resize(mSceneStart);
+    }
+    //-----------------------------------------------------------------------
+    void DebugDrawer::createResources(void)
+    {
+        mRenderOp.vertexData = OGRE_NEW VertexData();
+        mRenderOp.vertexData->vertexStart = 0;
+        mRenderOp.vertexData->vertexCount = 0;
+        VertexDeclaration* decl = mRenderOp.vertexData->vertexDeclaration;
+        decl->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+        decl->addElement(0, VertexElement::getTypeSize(VET_FLOAT3),
+            VertexElement::getBestColourVertexElementType(), VES_DIFFUSE);
+
+        // Unlit, coloured by the vertices, shared by all scene managers
+        MaterialManager& matMgr = MaterialManager::getSingleton();
+        mMaterial = matMgr.getByName("Ogre/DebugDrawer", ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+        if (!mMaterial)
+        {
+            mMaterial = matMgr.getDefaultMaterial(false)->clone("Ogre/DebugDrawer");
+            mMaterial->getTechnique(0)->getPass(0)->setVertexColourTracking(TVC_DIFFUSE);
+        }
+        mMaterial->load();
+    }
+    //-----------------------------------------------------------------------
+    void DebugDrawer::_queueForRendering(RenderQueue* queue)
+    {
+        if (mVertices.empty())
+            return;
+
+        if (!mRenderOp.vertexData)
+            createResources();
+
+        VertexData* vertexData = mRenderOp.vertexData;
+        const VertexElement* colourElem = vertexData->vertexDeclaration->findElementBySemantic(VES_DIFFUSE);
+        size_t vertexSize = vertexData->vertexDeclaration->getVertexSize(0);
+
+        // Grow the buffer to the next power of two, so it settles after a few frames
+        HardwareVertexBufferSharedPtr vbuf;
+        if (vertexData->vertexBufferBinding->isBufferBound(0))
+            vbuf = vertexData->vertexBufferBinding->getBuffer(0);
+        if (!vbuf || vbuf->getNumVertices() < mVertices.size())
+        {
+            vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(vertexSize,
+                Bitwise::firstPO2From(static_cast<uint32>(mVertices.size())),
+                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+            vertexData->vertexBufferBinding->setBinding(0, vbuf);
+        }
+
+        char* pBase = static_cast<char*>(vbuf->lock(0, mVertices.size() * vertexSize,
+            HardwareBuffer::HBL_DISCARD));
+        for (VertexList::const_iterator i = mVertices.begin(); i != mVertices.end(); ++i)
+        {
+            float* pFloat = reinterpret_cast<float*>(pBase);
+            *pFloat++ = i->position.x;
+            *pFloat++ = i->position.y;
+            *pFloat++ = i->position.z;
+            uint32* pColour;
+            colourElem->baseVertexPointerToElement(pBase, &pColour);
+            *pColour = VertexElement::convertColourValue(i->colour, colourElem->getType());
+            pBase += vertexSize;
+        }
+        vbuf->unlock();
+        vertexData->vertexCount = mVertices.size();
+
+        queue->addRenderable(this);
+    }
+    //-----------------------------------------------------------------------
+    void DebugDrawer::getWorldTransforms(Matrix4* xform) const
+    {
+        // The primitives are in world space
+        *xform = Matrix4::IDENTITY;
+    }
+    //-----------------------------------------------------------------------
+    const LightList& DebugDrawer::getLights(void) const
+    {
+        // Unlit, no lights needed
+        static LightList ll;
+        return ll;
+    }
+
+}
@@ -334,6 +334,38 @@ namespace Ogre
                         
     }
     //---------------------------------------------------------------------
+    void DeflateStream::compressData(const void* data, size_t size, vector<uint8>::type& compressed)
+    {
+        z_stream zStream;
+        memset(&zStream, 0, sizeof(z_stream));
+        zStream.zalloc = OgreZalloc;
+        zStream.zfree = OgreZfree;
+
+        if (deflateInit(&zStream, Z_DEFAULT_COMPRESSION) != Z_OK)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+                        "Error initialising deflate compressed stream!",
+                        "DeflateStream::compressData");
+        }
+
+        // all in one go, the bound leaves room for data which does not compress
+        compressed.resize(deflateBound(&zStream, (uLong)size));
+        zStream.next_in = const_cast<Bytef*>(static_cast<const Bytef*>(data));
+        zStream.avail_in = (uInt)size;
+        zStream.next_out = (Bytef*)&compressed[0];
+        zStream.avail_out = (uInt)compressed.size();
+        int ret = deflate(&zStream, Z_FINISH);
+        compressed.resize(compressed.size() - zStream.avail_out);
+        deflateEnd(&zStream);
+
+        if (ret != Z_STREAM_END)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+                        "Error compressing data!",
+                        "DeflateStream::compressData");
+        }
+    }
+    //---------------------------------------------------------------------
     void DeflateStream::skip(long count)
     {
         if (!mIsCompressedValid)
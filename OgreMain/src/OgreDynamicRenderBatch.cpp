@@ -0,0 +1,396 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreDynamicRenderBatch.h"
+#include "OgrePass.h"
+#include "OgreHardwareBufferManager.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        /// Whether a buffer can be read back without stalling on the GPU
+        bool isReadable(const HardwareBuffer* buf)
+        {
+            return buf->isSystemMemory() || buf->hasShadowBuffer();
+        }
+        /// Transform a direction by a 3x3 matrix and renormalise it
+        void transformDirection(const Matrix3& m, const float* src, float* dst)
+        {
+            Vector3 v = m * Vector3(src[0], src[1], src[2]);
+            v.normalise();
+            dst[0] = static_cast<float>(v.x);
+            dst[1] = static_cast<float>(v.y);
+            dst[2] = static_cast<float>(v.z);
+        }
+    }
+    //-----------------------------------------------------------------------
+    DynamicRenderBatch::DynamicRenderBatch()
+        : mVertexLimit(300)
+        , mNumVertices(0)
+        , mNumIndices(0)
+        , mPass(0)
+        , mScissoring(false)
+        , mAutoLights(false)
+        , mManualLightList(0)
+        , mPolygonModeOverrideable(true)
+        , mVertexData(OGRE_NEW VertexData())
+        , mIndexData(OGRE_NEW IndexData())
+        , mTransform(Matrix4::IDENTITY)
+    {
+        mRenderOp.operationType = RenderOperation::OT_TRIANGLE_LIST;
+        mRenderOp.useIndexes = true;
+        mRenderOp.vertexData = mVertexData;
+        mRenderOp.indexData = mIndexData;
+        mRenderOp.srcRenderable = this;
+    }
+    //-----------------------------------------------------------------------
+    DynamicRenderBatch::~DynamicRenderBatch()
+    {
+        OGRE_DELETE mVertexData;
+        OGRE_DELETE mIndexData;
+    }
+    //-----------------------------------------------------------------------
+    bool DynamicRenderBatch::isBatchable(Renderable* rend, const Pass* pass, RenderOperation& op) const
+    {
+        if (!pass->getDynamicBatchingEnabled() || pass->getIteratePerLight())
+            return false;
+
+        if (rend->getNumWorldTransforms() != 1 || rend->getUseIdentityProjection() ||
+            rend->getUseIdentityView() || !rend->getTextureOverrides().empty() ||
+            rend->hasCustomParameters())
+            return false;
+
+        rend->getRenderOperation(op);
+        if (op.operationType != RenderOperation::OT_TRIANGLE_LIST || op.numberOfInstances > 1 ||
+            !op.vertexData || op.vertexData->hwAnimDataItemsUsed > 0 ||
+            op.vertexData->vertexCount > std::min<size_t>(mVertexLimit, 0x10000))
+            return false;
+
+        if (op.useIndexes && (!op.indexData || !op.indexData->indexBuffer ||
+            !isReadable(op.indexData->indexBuffer.get())))
+            return false;
+
+        bool hasPosition = false;
+        const VertexDeclaration::VertexElementList& elems = op.vertexData->vertexDeclaration->getElements();
+        for (VertexDeclaration::VertexElementList::const_iterator i = elems.begin(); i != elems.end(); ++i)
+        {
+            if (!op.vertexData->vertexBufferBinding->isBufferBound(i->getSource()))
+                return false;
+            const HardwareVertexBufferSharedPtr& buf =
+                op.vertexData->vertexBufferBinding->getBuffer(i->getSource());
+            if (buf->getIsInstanceData() || !isReadable(buf.get()))
+                return false;
+
+            switch (i->getSemantic())
+            {
+            case VES_POSITION:
+                if (i->getType() != VET_FLOAT3)
+                    return false;
+                hasPosition = true;
+                break;
+            case VES_NORMAL:
+            case VES_BINORMAL:
+                if (i->getType() != VET_FLOAT3)
+                    return false;
+                break;
+            case VES_TANGENT:
+                if (i->getType() != VET_FLOAT3 && i->getType() != VET_FLOAT4)
+                    return false;
+                break;
+            default:
+                break;
+            }
+        }
+
+        return hasPosition;
+    }
+    //-----------------------------------------------------------------------
+    bool DynamicRenderBatch::isCompatible(Renderable* rend, const RenderOperation& op, const Pass* pass,
+        bool scissoring, bool autoLights, const LightList* manualLightList) const
+    {
+        if (mEntries.empty())
+            return true;
+
+        if (pass != mPass || scissoring != mScissoring || autoLights != mAutoLights ||
+            manualLightList != mManualLightList ||
+            rend->getPolygonModeOverrideable() != mPolygonModeOverrideable)
+            return false;
+
+        if (mNumVertices + op.vertexData->vertexCount > 0x10000 ||
+            !(*op.vertexData->vertexDeclaration == *mEntries.front().op.vertexData->vertexDeclaration))
+            return false;
+
+        // The renderables' own lights are only used without a manual list
+        if (!manualLightList && (pass->getLightingEnabled() || pass->isProgrammable()))
+        {
+            const LightList& lights = rend->getLights();
+            if (lights.size() != mLights.size() ||
+                !std::equal(lights.begin(), lights.end(), mLights.begin()))
+                return false;
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void DynamicRenderBatch::add(Renderable* rend, const RenderOperation& op, const Pass* pass,
+        bool scissoring, bool autoLights, const LightList* manualLightList)
+    {
+        if (mEntries.empty())
+        {
+            mPass = pass;
+            mScissoring = scissoring;
+            mAutoLights = autoLights;
+            mManualLightList = manualLightList;
+            mPolygonModeOverrideable = rend->getPolygonModeOverrideable();
+            mLights = rend->getLights();
+        }
+
+        mEntries.push_back(Entry());
+        Entry& entry = mEntries.back();
+        entry.renderable = rend;
+        entry.op = op;
+        rend->getWorldTransforms(&entry.transform);
+
+        mNumVertices += op.vertexData->vertexCount;
+        mNumIndices += op.useIndexes ? op.indexData->indexCount : op.vertexData->vertexCount;
+    }
+    //-----------------------------------------------------------------------
+    void DynamicRenderBatch::clear(void)
+    {
+        mEntries.clear();
+        mNumVertices = 0;
+        mNumIndices = 0;
+        mPass = 0;
+        mManualLightList = 0;
+        mLights.clear();
+    }
+    //-----------------------------------------------------------------------
+    void DynamicRenderBatch::updateDeclaration(const VertexDeclaration* decl)
+    {
+        // The shared buffer holds the same elements, interleaved in one source
+        VertexDeclaration* dest = mVertexData->vertexDeclaration;
+        const VertexDeclaration::VertexElementList& srcElems = decl->getElements();
+        const VertexDeclaration::VertexElementList& destElems = dest->getElements();
+
+        bool same = srcElems.size() == destElems.size();
+        VertexDeclaration::VertexElementList::const_iterator s = srcElems.begin();
+        VertexDeclaration::VertexElementList::const_iterator d = destElems.begin();
+        for (; same && s != srcElems.end(); ++s, ++d)
+        {
+            same = s->getSemantic() == d->getSemantic() && s->getType() == d->getType() &&
+                s->getIndex() == d->getIndex();
+        }
+        if (same)
+            return;
+
+        dest->removeAllElements();
+        size_t offset = 0;
+        for (s = srcElems.begin(); s != srcElems.end(); ++s)
+        {
+            offset += dest->addElement(0, offset, s->getType(), s->getSemantic(), s->getIndex()).getSize();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void DynamicRenderBatch::build(const Vector3& origin, bool flipNegativeScale)
+    {
+        if (mEntries.empty())
+            return;
+
+        updateDeclaration(mEntries.front().op.vertexData->vertexDeclaration);
+        const VertexDeclaration::VertexElementList& elems =
+            mEntries.front().op.vertexData->vertexDeclaration->getElements();
+        const VertexDeclaration::VertexElementList& destElems =
+            mVertexData->vertexDeclaration->getElements();
+        size_t vertexSize = mVertexData->vertexDeclaration->getVertexSize(0);
+
+        // Grow the shared buffers in steps, so a changing batch doesn't recreate them every frame
+        VertexBufferBinding* binding = mVertexData->vertexBufferBinding;
+        HardwareVertexBufferSharedPtr vbuf;
+        if (binding->isBufferBound(0))
+            vbuf = binding->getBuffer(0);
+        if (!vbuf || vbuf->getVertexSize() != vertexSize || vbuf->getNumVertices() < mNumVertices)
+        {
+            size_t count = mNumVertices;
+            if (vbuf && vbuf->getVertexSize() == vertexSize)
+                count = std::max(count, vbuf->getNumVertices() * 2);
+            vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+                vertexSize, count, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+            binding->setBinding(0, vbuf);
+        }
+        HardwareIndexBufferSharedPtr& ibuf = mIndexData->indexBuffer;
+        if (!ibuf || ibuf->getNumIndexes() < mNumIndices)
+        {
+            size_t count = mNumIndices;
+            if (ibuf)
+                count = std::max(count, ibuf->getNumIndexes() * 2);
+            ibuf = HardwareBufferManager::getSingleton().createIndexBuffer(
+                HardwareIndexBuffer::IT_16BIT, count, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        }
+
+        uchar* pDest = static_cast<uchar*>(vbuf->lock(0, mNumVertices * vertexSize, HardwareBuffer::HBL_DISCARD));
+        uint16* pIndex = static_cast<uint16*>(ibuf->lock(0, mNumIndices * sizeof(uint16), HardwareBuffer::HBL_DISCARD));
+        size_t baseVertex = 0;
+
+        vector<const uchar*>::type sources;
+        vector<size_t>::type strides;
+        for (EntryList::iterator e = mEntries.begin(); e != mEntries.end(); ++e)
+        {
+            const VertexData* vertexData = e->op.vertexData;
+
+            // Write the vertices relative to the origin, which is the translation of the batch
+            Matrix4 xform = e->transform;
+            xform.setTrans(xform.getTrans() - origin);
+            Matrix3 rotation, normalRotation;
+            xform.extract3x3Matrix(rotation);
+            xform.inverseAffine().transpose().extract3x3Matrix(normalRotation);
+
+            sources.assign(vertexData->vertexDeclaration->getMaxSource() + 1, 0);
+            strides.resize(sources.size());
+            for (VertexDeclaration::VertexElementList::const_iterator i = elems.begin(); i != elems.end(); ++i)
+            {
+                unsigned short source = i->getSource();
+                if (!sources[source])
+                {
+                    const HardwareVertexBufferSharedPtr& buf = vertexData->vertexBufferBinding->getBuffer(source);
+                    strides[source] = buf->getVertexSize();
+                    sources[source] = static_cast<const uchar*>(buf->lock(HardwareBuffer::HBL_READ_ONLY)) +
+                        vertexData->vertexStart * strides[source];
+                }
+            }
+
+            for (size_t v = 0; v < vertexData->vertexCount; ++v)
+            {
+                VertexDeclaration::VertexElementList::const_iterator d = destElems.begin();
+                for (VertexDeclaration::VertexElementList::const_iterator i = elems.begin();
+                     i != elems.end(); ++i, ++d)
+                {
+                    const uchar* pSrc = sources[i->getSource()] + v * strides[i->getSource()] + i->getOffset();
+                    float* pDstFloat = reinterpret_cast<float*>(pDest + d->getOffset());
+                    const float* pSrcFloat = reinterpret_cast<const float*>(pSrc);
+
+                    switch (i->getSemantic())
+                    {
+                    case VES_POSITION:
+                        {
+                            Vector3 pos = xform.transformAffine(Vector3(pSrcFloat[0], pSrcFloat[1], pSrcFloat[2]));
+                            pDstFloat[0] = static_cast<float>(pos.x);
+                            pDstFloat[1] = static_cast<float>(pos.y);
+                            pDstFloat[2] = static_cast<float>(pos.z);
+                        }
+                        break;
+                    case VES_NORMAL:
+                        transformDirection(normalRotation, pSrcFloat, pDstFloat);
+                        break;
+                    case VES_TANGENT:
+                    case VES_BINORMAL:
+                        transformDirection(rotation, pSrcFloat, pDstFloat);
+                        if (i->getType() == VET_FLOAT4)
+                            pDstFloat[3] = pSrcFloat[3];
+                        break;
+                    default:
+                        memcpy(pDest + d->getOffset(), pSrc, i->getSize());
+                        break;
+                    }
+                }
+                pDest += vertexSize;
+            }
+
+            for (size_t s = 0; s < sources.size(); ++s)
+            {
+                if (sources[s])
+                    vertexData->vertexBufferBinding->getBuffer(static_cast<unsigned short>(s))->unlock();
+            }
+
+            // The batch is culled as a whole, so mirrored renderables get their winding flipped
+            bool flip = flipNegativeScale && xform.hasNegativeScale();
+            uint16* pFirst = pIndex;
+            if (e->op.useIndexes)
+            {
+                const IndexData* indexData = e->op.indexData;
+                const HardwareIndexBufferSharedPtr& src = indexData->indexBuffer;
+                const void* pSrc = src->lock(indexData->indexStart * src->getIndexSize(),
+                    indexData->indexCount * src->getIndexSize(), HardwareBuffer::HBL_READ_ONLY);
+                if (src->getType() == HardwareIndexBuffer::IT_32BIT)
+                {
+                    const uint32* pSrc32 = static_cast<const uint32*>(pSrc);
+                    for (size_t i = 0; i < indexData->indexCount; ++i)
+                        *pIndex++ = static_cast<uint16>(baseVertex + pSrc32[i]);
+                }
+                else
+                {
+                    const uint16* pSrc16 = static_cast<const uint16*>(pSrc);
+                    for (size_t i = 0; i < indexData->indexCount; ++i)
+                        *pIndex++ = static_cast<uint16>(baseVertex + pSrc16[i]);
+                }
+                src->unlock();
+            }
+            else
+            {
+                for (size_t i = 0; i < vertexData->vertexCount; ++i)
+                    *pIndex++ = static_cast<uint16>(baseVertex + i);
+            }
+            if (flip)
+            {
+                for (uint16* p = pFirst; p + 2 < pIndex; p += 3)
+                    std::swap(p[1], p[2]);
+            }
+
+            baseVertex += vertexData->vertexCount;
+        }
+
+        ibuf->unlock();
+        vbuf->unlock();
+
+        mVertexData->vertexStart = 0;
+        mVertexData->vertexCount = mNumVertices;
+        mIndexData->indexStart = 0;
+        mIndexData->indexCount = mNumIndices;
+        mTransform.makeTrans(origin);
+    }
+    //-----------------------------------------------------------------------
+    const MaterialPtr& DynamicRenderBatch::getMaterial(void) const
+    {
+        return mEntries.front().renderable->getMaterial();
+    }
+    //-----------------------------------------------------------------------
+    void DynamicRenderBatch::getRenderOperation(RenderOperation& op)
+    {
+        op = mRenderOp;
+    }
+    //-----------------------------------------------------------------------
+    void DynamicRenderBatch::getWorldTransforms(Matrix4* xform) const
+    {
+        *xform = mTransform;
+    }
+    //-----------------------------------------------------------------------
+    const LightList& DynamicRenderBatch::getLights(void) const
+    {
+        return mLights;
+    }
+}
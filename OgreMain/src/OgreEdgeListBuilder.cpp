@@ -30,9 +30,70 @@ THE SOFTWARE.
 #include "OgreVertexIndexData.h"
 #include "OgreException.h"
 #include "OgreOptimisedUtil.h"
+#include "Threading/OgreParallel.h"
 
 namespace Ogre {
+    namespace {
+        /// Triangles handled per call of the optimised utility functions
+        const size_t TRIANGLE_CHUNK_SIZE = 4096;
 
+        /// Calculates the face normals of triangles from their positions and indices
+        struct FaceNormalCalculator
+        {
+            const unsigned char* base;
+            size_t vertexSize;
+            const uint32* indices;
+            Vector4* faceNormals;
+
+            void operator()(size_t t) const
+            {
+                Vector3 v[3];
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    const float* pFloat = reinterpret_cast<const float*>(base + indices[t * 3 + i] * vertexSize);
+                    v[i].x = pFloat[0];
+                    v[i].y = pFloat[1];
+                    v[i].z = pFloat[2];
+                }
+                faceNormals[t] = Math::calculateFaceNormalWithoutNormalize(v[0], v[1], v[2]);
+            }
+        };
+
+        /// Updates the light facing flags of a chunk of triangles
+        struct LightFacingUpdater
+        {
+            const Vector4* lightPos;
+            const Vector4* faceNormals;
+            char* lightFacings;
+            size_t numFaces;
+
+            void operator()(size_t chunk) const
+            {
+                size_t start = chunk * TRIANGLE_CHUNK_SIZE;
+                OptimisedUtil::getImplementation()->calculateLightFacing(*lightPos,
+                    faceNormals + start, lightFacings + start,
+                    std::min(TRIANGLE_CHUNK_SIZE, numFaces - start));
+            }
+        };
+
+        /// Updates the face normals of a chunk of triangles
+        struct FaceNormalUpdater
+        {
+            const float* positions;
+            const EdgeData::Triangle* triangles;
+            Vector4* faceNormals;
+            size_t numTriangles;
+
+            void operator()(size_t chunk) const
+            {
+                size_t start = chunk * TRIANGLE_CHUNK_SIZE;
+                OptimisedUtil::getImplementation()->calculateFaceNormals(positions,
+                    triangles + start, faceNormals + start,
+                    std::min(TRIANGLE_CHUNK_SIZE, numTriangles - start));
+            }
+        };
+    }
+    //---------------------------------------------------------------------
     EdgeData::EdgeData() : isClosed(false){}
     
     void EdgeData::log(Log* l)
@@ -76,7 +137,7 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     EdgeListBuilder::EdgeListBuilder()
-        : mEdgeData(0)
+        : mGeometryRead(false), mEdgeData(0)
     {
     }
     //---------------------------------------------------------------------
@@ -166,9 +227,9 @@ namespace Ogre {
         the mesh, not the valid hull for the mesh.
         */
 
-        // Sort the geometries in the order of vertex set, so we can grouping
-        // triangles by vertex set easy.
-        std::sort(mGeometryList.begin(), mGeometryList.end(), geometryLess());
+        if (!mGeometryRead)
+            readGeometry();
+
         // Initialize edge data
         mEdgeData = OGRE_NEW EdgeData();
         // resize the edge group list to equal the number of vertex sets
@@ -194,15 +255,54 @@ namespace Ogre {
         mEdgeData->triangleLightFacings.resize(mEdgeData->triangles.size());
 
         // Record closed, ie the mesh is manifold
-        mEdgeData->isClosed = mEdgeMap.empty();
+        mEdgeData->isClosed = mEdgeMap.empty() && mEdgeOverflowMap.empty();
 
         return mEdgeData;
     }
     //---------------------------------------------------------------------
-    void EdgeListBuilder::buildTrianglesEdges(const Geometry &geometry)
+    void EdgeListBuilder::readGeometry(void)
+    {
+        // Sort the geometries in the order of vertex set, so we can grouping
+        // triangles by vertex set easy.
+        std::sort(mGeometryList.begin(), mGeometryList.end(), geometryLess());
+
+        mPositions.resize(mVertexDataList.size());
+        for (size_t vSet = 0; vSet < mVertexDataList.size(); ++vSet)
+        {
+            // locate position element & the buffer to go with it
+            const VertexData* vertexData = mVertexDataList[vSet];
+            const VertexElement* posElem = vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+            HardwareVertexBufferSharedPtr vbuf =
+                vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+
+            vector<float>::type& positions = mPositions[vSet];
+            positions.resize(vbuf->getNumVertices() * 3);
+            unsigned char* pVertex = static_cast<unsigned char*>(
+                vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+            for (size_t v = 0; v < vbuf->getNumVertices(); ++v)
+            {
+                float* pFloat;
+                posElem->baseVertexPointerToElement(pVertex, &pFloat);
+                positions[v * 3] = pFloat[0];
+                positions[v * 3 + 1] = pFloat[1];
+                positions[v * 3 + 2] = pFloat[2];
+                pVertex += vbuf->getVertexSize();
+            }
+            vbuf->unlock();
+        }
+
+        GeometryList::iterator i, iend;
+        iend = mGeometryList.end();
+        for (i = mGeometryList.begin(); i != iend; ++i)
+        {
+            readIndexes(*i);
+        }
+
+        mGeometryRead = true;
+    }
+    //---------------------------------------------------------------------
+    void EdgeListBuilder::readIndexes(Geometry& geometry)
     {
-        size_t indexSet = geometry.indexSet;
-        size_t vertexSet = geometry.vertexSet;
         const IndexData* indexData = geometry.indexData;
         RenderOperation::OperationType opType = geometry.opType;
 
@@ -221,18 +321,6 @@ namespace Ogre {
             return; // Just in case
         };
 
-        // The edge group now we are dealing with.
-        EdgeData::EdgeGroup& eg = mEdgeData->edgeGroups[vertexSet];
-
-        // locate position element & the buffer to go with it
-        const VertexData* vertexData = mVertexDataList[vertexSet];
-        const VertexElement* posElem = vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
-        HardwareVertexBufferSharedPtr vbuf = 
-            vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
-        // lock the buffer for reading
-        unsigned char* pBaseVertex = static_cast<unsigned char*>(
-            vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
-
         // Get the indexes ready for reading
         bool idx32bit = (indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_32BIT);
         size_t indexSize = idx32bit ? sizeof(uint32) : sizeof(uint16);
@@ -254,26 +342,12 @@ namespace Ogre {
             static_cast<char*>(pIndex) + indexData->indexStart * indexSize);
 #endif
 
-        // Iterate over all the groups of 3 indexes
-        unsigned int index[3];
-        // Get the triangle start, if we have more than one index set then this
-        // will not be zero
-        size_t triangleIndex = mEdgeData->triangles.size();
-        // If it's first time dealing with the edge group, setup triStart for it.
-        // Note that we are assume geometries sorted by vertex set.
-        if (!eg.triCount)
-        {
-            eg.triStart = triangleIndex;
-        }
-        // Pre-reserve memory for less thrashing
-        mEdgeData->triangles.reserve(triangleIndex + iterations);
-        mEdgeData->triangleFaceNormals.reserve(triangleIndex + iterations);
+        // Read all the groups of 3 indexes
+        vector<uint32>::type& triIndices = geometry.indexes;
+        triIndices.resize(iterations * 3);
+        uint32 index[3];
         for (size_t t = 0; t < iterations; ++t)
         {
-            EdgeData::Triangle tri;
-            tri.indexSet = indexSet;
-            tri.vertexSet = vertexSet;
-
             if (opType == RenderOperation::OT_TRIANGLE_LIST || t == 0)
             {
                 // Standard 3-index read for tri list or first tri in strip / fan
@@ -307,23 +381,76 @@ namespace Ogre {
                 else
                     index[2] = *p16Idx++;
             }
+            triIndices[t * 3] = index[0];
+            triIndices[t * 3 + 1] = index[1];
+            triIndices[t * 3 + 2] = index[2];
+        }
+        indexData->indexBuffer->unlock();
+    }
+    //---------------------------------------------------------------------
+    void EdgeListBuilder::buildTrianglesEdges(const Geometry &geometry)
+    {
+        size_t indexSet = geometry.indexSet;
+        size_t vertexSet = geometry.vertexSet;
+        const vector<uint32>::type& triIndices = geometry.indexes;
+        size_t iterations = triIndices.size() / 3;
+
+        // The edge group now we are dealing with.
+        EdgeData::EdgeGroup& eg = mEdgeData->edgeGroups[vertexSet];
+
+        // The positions of the vertex set, as read by readGeometry
+        const vector<float>::type& positions = mPositions[vertexSet];
+
+        // Calculate triangle normals (NB will require recalculation for
+        // skeletally animated meshes), independent of each other so in parallel
+        vector<Vector4>::type faceNormals(iterations);
+        if (iterations)
+        {
+            FaceNormalCalculator calculator;
+            calculator.base = reinterpret_cast<const unsigned char*>(&positions[0]);
+            calculator.vertexSize = sizeof(float) * 3;
+            calculator.indices = &triIndices[0];
+            calculator.faceNormals = &faceNormals[0];
+            parallelFor(0, iterations, calculator, TRIANGLE_CHUNK_SIZE);
+        }
+
+        // Common vertex of each vertex in the buffer, so every vertex is looked up once
+        vector<size_t>::type sharedIndices(positions.size() / 3, static_cast<size_t>(~0));
+
+        // Get the triangle start, if we have more than one index set then this
+        // will not be zero
+        size_t triangleIndex = mEdgeData->triangles.size();
+        // If it's first time dealing with the edge group, setup triStart for it.
+        // Note that we are assume geometries sorted by vertex set.
+        if (!eg.triCount)
+        {
+            eg.triStart = triangleIndex;
+        }
+        // Pre-reserve memory for less thrashing
+        mEdgeData->triangles.reserve(triangleIndex + iterations);
+        mEdgeData->triangleFaceNormals.reserve(triangleIndex + iterations);
+        for (size_t t = 0; t < iterations; ++t)
+        {
+            EdgeData::Triangle tri;
+            tri.indexSet = indexSet;
+            tri.vertexSet = vertexSet;
 
-            Vector3 v[3];
             for (size_t i = 0; i < 3; ++i)
             {
                 // Populate tri original vertex index
-                tri.vertIndex[i] = index[i];
+                uint32 vertIndex = triIndices[t * 3 + i];
+                tri.vertIndex[i] = vertIndex;
 
-                // Retrieve the vertex position
-                unsigned char* pVertex = pBaseVertex + (index[i] * vbuf->getVertexSize());
-                float* pFloat;
-                posElem->baseVertexPointerToElement(pVertex, &pFloat);
-                v[i].x = *pFloat++;
-                v[i].y = *pFloat++;
-                v[i].z = *pFloat++;
-                // find this vertex in the existing vertex map, or create it
-                tri.sharedVertIndex[i] = 
-                    findOrCreateCommonVertex(v[i], vertexSet, indexSet, index[i]);
+                if (sharedIndices[vertIndex] == static_cast<size_t>(~0))
+                {
+                    // Retrieve the vertex position
+                    const float* pFloat = &positions[vertIndex * 3];
+                    Vector3 v(pFloat[0], pFloat[1], pFloat[2]);
+                    // find this vertex in the existing vertex map, or create it
+                    sharedIndices[vertIndex] =
+                        findOrCreateCommonVertex(v, vertexSet, indexSet, vertIndex);
+                }
+                tri.sharedVertIndex[i] = sharedIndices[vertIndex];
             }
 
             // Ignore degenerate triangle
@@ -331,10 +458,7 @@ namespace Ogre {
                 tri.sharedVertIndex[1] != tri.sharedVertIndex[2] &&
                 tri.sharedVertIndex[2] != tri.sharedVertIndex[0])
             {
-                // Calculate triangle normal (NB will require recalculation for 
-                // skeletally animated meshes)
-                mEdgeData->triangleFaceNormals.push_back(
-                    Math::calculateFaceNormalWithoutNormalize(v[0], v[1], v[2]));
+                mEdgeData->triangleFaceNormals.push_back(faceNormals[t]);
                 // Add triangle to list
                 mEdgeData->triangles.push_back(tri);
                 // Connect or create edges from common list
@@ -354,9 +478,6 @@ namespace Ogre {
         // Update triCount for the edge group. Note that we are assume
         // geometries sorted by vertex set.
         eg.triCount = triangleIndex - eg.triStart;
-
-        indexData->indexBuffer->unlock();
-        vbuf->unlock();
     }
     //---------------------------------------------------------------------
     void EdgeListBuilder::connectOrCreateEdge(size_t vertexSet, size_t triangleIndex, 
@@ -364,7 +485,8 @@ namespace Ogre {
         size_t sharedVertIndex1)
     {
         // Find the existing edge (should be reversed order) on shared vertices
-        EdgeMap::iterator emi = mEdgeMap.find(std::pair<size_t, size_t>(sharedVertIndex1, sharedVertIndex0));
+        std::pair<size_t, size_t> reversed(sharedVertIndex1, sharedVertIndex0);
+        EdgeMap::iterator emi = mEdgeMap.find(reversed);
         if (emi != mEdgeMap.end())
         {
             // The edge already exist, connect it
@@ -373,15 +495,27 @@ namespace Ogre {
             e.triIndex[1] = triangleIndex;
             e.degenerate = false;
 
-            // Remove from the edge map, so we never supplied to connect edge again
-            mEdgeMap.erase(emi);
+            // Remove from the edge map, so we never supplied to connect edge again.
+            // The next open edge on the same vertices, if any, takes its place
+            EdgeOverflowMap::iterator eoi = mEdgeOverflowMap.empty() ?
+                mEdgeOverflowMap.end() : mEdgeOverflowMap.lower_bound(reversed);
+            if (eoi != mEdgeOverflowMap.end() && eoi->first == reversed)
+            {
+                emi->second = eoi->second;
+                mEdgeOverflowMap.erase(eoi);
+            }
+            else
+            {
+                mEdgeMap.erase(emi);
+            }
         }
         else
         {
             // Not found, create new edge
-            mEdgeMap.insert(EdgeMap::value_type(
-                std::pair<size_t, size_t>(sharedVertIndex0, sharedVertIndex1),
-                std::pair<size_t, size_t>(vertexSet, mEdgeData->edgeGroups[vertexSet].edges.size())));
+            std::pair<size_t, size_t> key(sharedVertIndex0, sharedVertIndex1);
+            std::pair<size_t, size_t> value(vertexSet, mEdgeData->edgeGroups[vertexSet].edges.size());
+            if (!mEdgeMap.insert(EdgeMap::value_type(key, value)).second)
+                mEdgeOverflowMap.insert(EdgeOverflowMap::value_type(key, value));
             EdgeData::Edge e;
             e.degenerate = true; // initialise as degenerate
 
@@ -427,13 +561,24 @@ namespace Ogre {
         assert(triangleFaceNormals.size() == triangleLightFacings.size());
 
         // Use optimised util to determine if triangle's face normal are light facing
-        if(!triangleFaceNormals.empty())
+        // Large meshes are split in chunks updated in parallel
+        size_t numFaces = triangleLightFacings.size();
+        if (numFaces > TRIANGLE_CHUNK_SIZE)
+        {
+            LightFacingUpdater updater;
+            updater.lightPos = &lightPos;
+            updater.faceNormals = &triangleFaceNormals.front();
+            updater.lightFacings = &triangleLightFacings.front();
+            updater.numFaces = numFaces;
+            parallelFor(0, (numFaces + TRIANGLE_CHUNK_SIZE - 1) / TRIANGLE_CHUNK_SIZE, updater);
+        }
+        else if (numFaces)
         {
             OptimisedUtil::getImplementation()->calculateLightFacing(
                 lightPos,
                 &triangleFaceNormals.front(),
                 &triangleLightFacings.front(),
-                triangleLightFacings.size());
+                numFaces);
         }
     }
     //---------------------------------------------------------------------
@@ -452,7 +597,17 @@ namespace Ogre {
 
         // Calculate triangles which are using this vertex set
         const EdgeData::EdgeGroup& eg = edgeGroups[vertexSet];
-        if (eg.triCount != 0) 
+        if (eg.triCount > TRIANGLE_CHUNK_SIZE)
+        {
+            // Large meshes are split in chunks updated in parallel
+            FaceNormalUpdater updater;
+            updater.positions = pVert;
+            updater.triangles = &triangles[eg.triStart];
+            updater.faceNormals = &triangleFaceNormals[eg.triStart];
+            updater.numTriangles = eg.triCount;
+            parallelFor(0, (eg.triCount + TRIANGLE_CHUNK_SIZE - 1) / TRIANGLE_CHUNK_SIZE, updater);
+        }
+        else if (eg.triCount != 0)
         {
             OptimisedUtil::getImplementation()->calculateFaceNormals(
                 pVert,
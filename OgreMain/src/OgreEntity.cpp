@@ -46,17 +46,40 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgrePass.h"
 #include "OgreSkeletonInstance.h"
 #include "OgreOptimisedUtil.h"
+#include "OgreSoftwareSkinningBatch.h"
+#include "OgreGpuSkinningBatch.h"
+#include "OgreSkeletonAnimationCache.h"
 #include "OgreSceneNode.h"
 #include "OgreLodStrategy.h"
 #include "OgreLodListener.h"
 #include "OgreMaterialManager.h"
+#include "OgreAnimation.h"
+#include "OgreImpostor.h"
+#include "OgreImpostorBatcher.h"
 
 namespace Ogre {
+    namespace {
+        /// Poses sampled per animation for the off-screen bounds
+        const size_t ANIMATED_BOUNDS_SAMPLES = 16;
+
+        /** Get the copy of vertex data skinned on the GPU, creating it on first use.
+        @return false if the vertex data is to be skinned in software
+        */
+        bool prepareGpuSkinnedVertexData(GpuSkinnedVertexData*& data, const VertexData* source,
+            const VertexData* skelAnimVertexData, size_t numMatrices)
+        {
+            if (!data && GpuSkinningBatch::isSupported(source, numMatrices))
+                data = OGRE_NEW GpuSkinnedVertexData(source, skelAnimVertexData);
+            return data != 0;
+        }
+    }
     //-----------------------------------------------------------------------
     Entity::Entity ()
         : mAnimationState(NULL),
           mTempSkelAnimInfo(),
           mSkelAnimVertexData(0),
+          mGpuSkinnedVertexData(0),
+          mGpuSkinned(false),
           mTempVertexAnimInfo(),
           mSoftwareVertexAnimVertexData(0),
           mHardwareVertexAnimVertexData(0),
@@ -77,6 +100,16 @@ namespace Ogre {
         mSkipAnimStateUpdates(false),
         mAlwaysUpdateMainSkeleton(false),
           mUpdateBoundingBoxFromSkeleton(false),
+        mOffscreenAnimationInterval(1),
+        mFrameLastVisible(0),
+        mFrameOffscreenAnimated(0),
+        mAnimatedBoundsDirty(true),
+        mSkeletonAnimationCache(0),
+        mImpostor(0),
+        mImpostorLodValue(0),
+        mImpostorActive(false),
+        mLodMorphRange(0),
+        mLodMorphFactor(0),
         mMeshLodIndex(0),
         mMeshLodFactorTransformed(1.0f),
         mMinMeshLodIndex(99),
@@ -98,6 +131,8 @@ namespace Ogre {
         mMesh(mesh),
         mAnimationState(NULL),
         mSkelAnimVertexData(0),
+        mGpuSkinnedVertexData(0),
+        mGpuSkinned(false),
         mSoftwareVertexAnimVertexData(0),
         mHardwareVertexAnimVertexData(0),
         mVertexAnimationAppliedThisFrame(false),
@@ -116,6 +151,16 @@ namespace Ogre {
         mSkipAnimStateUpdates(false),
         mAlwaysUpdateMainSkeleton(false),
         mUpdateBoundingBoxFromSkeleton(false),
+        mOffscreenAnimationInterval(1),
+        mFrameLastVisible(0),
+        mFrameOffscreenAnimated(0),
+        mAnimatedBoundsDirty(true),
+        mSkeletonAnimationCache(0),
+        mImpostor(0),
+        mImpostorLodValue(0),
+        mImpostorActive(false),
+        mLodMorphRange(0),
+        mLodMorphFactor(0),
         mMeshLodIndex(0),
         mMeshLodFactorTransformed(1.0f),
         mMinMeshLodIndex(99),
@@ -170,6 +215,7 @@ namespace Ogre {
         {
             mSkeletonInstance = OGRE_NEW SkeletonInstance(mMesh->getSkeleton());
             mSkeletonInstance->load();
+            mAnimatedBoundsDirty = true;
             // if mUpdateBoundingBoxFromSkeleton was turned on before the mesh was loaded, and mesh hasn't computed the boneBoundingRadius yet,
             if ( mUpdateBoundingBoxFromSkeleton && mMesh->getBoneBoundingRadius() == Real(0))
             {
@@ -270,6 +316,7 @@ namespace Ogre {
 #endif
         // Delete shadow renderables
         clearShadowRenderableList(mShadowRenderables);
+        mShadowVolumeCaches.clear();
 
         // Detach all child objects, do this manually to avoid needUpdate() call
         // which can fail because of deleted items
@@ -312,6 +359,7 @@ namespace Ogre {
         }
 
         OGRE_DELETE mSkelAnimVertexData; mSkelAnimVertexData = 0;
+        OGRE_DELETE mGpuSkinnedVertexData; mGpuSkinnedVertexData = 0;
         OGRE_DELETE mSoftwareVertexAnimVertexData; mSoftwareVertexAnimVertexData = 0;
         OGRE_DELETE mHardwareVertexAnimVertexData; mHardwareVertexAnimVertexData = 0;
 
@@ -328,6 +376,7 @@ namespace Ogre {
     void Entity::_releaseManualHardwareResources()
     {
         clearShadowRenderableList(mShadowRenderables);
+        mShadowVolumeCaches.clear();
     }
     //-----------------------------------------------------------------------
     void Entity::_restoreManualHardwareResources()
@@ -432,7 +481,7 @@ namespace Ogre {
 
 
             // Get the index at this biased depth
-            ushort newMeshLodIndex = mMesh->getLodIndex(biasedMeshLodValue);
+            ushort newMeshLodIndex = meshStrategy->getMeshLodIndex(biasedMeshLodValue, mMesh.get(), mMeshLodIndex);
             // Apply maximum detail restriction (remember lower = higher detail)
             newMeshLodIndex = std::max<ushort>(mMaxMeshLodIndex, newMeshLodIndex);
             // Apply minimum detail restriction (remember higher = lower detail)
@@ -452,10 +501,34 @@ namespace Ogre {
             // Change LOD index
             mMeshLodIndex = evt.newLodIndex;
 
+            // Blend towards the next LOD over the end of the current one
+            mLodMorphFactor = 0;
+            if (mLodMorphRange > 0 && mMeshLodIndex < mMinMeshLodIndex &&
+                mMeshLodIndex + 1 < mMesh->getNumLodLevels())
+            {
+                Real start = mMesh->getLodLevel(mMeshLodIndex).value;
+                Real end = mMesh->getLodLevel(mMeshLodIndex + 1).value;
+                // The full detail level starts at the base value of the strategy, which
+                // is unbounded for decreasing strategies, so compare ratios there
+                Real t = (mMeshLodIndex == 0 && start > end) ?
+                    end / biasedMeshLodValue : (biasedMeshLodValue - start) / (end - start);
+                mLodMorphFactor = Math::Clamp((t - 1 + mLodMorphRange) / mLodMorphRange, Real(0), Real(1));
+            }
+
             // Now do material LOD
             lodValue *= mMaterialLodFactorTransformed;
 #endif
 
+            // Switch to the impostor beyond its LOD value, biased like the mesh LOD
+            mImpostorActive = false;
+            if (mImpostor)
+            {
+                const LodStrategy* impostorStrategy = mMesh->getLodStrategy();
+                Mesh::LodValueList values;
+                values.push_back(mImpostorLodValue);
+                values.push_back(impostorStrategy->getValue(this, cam) * mMeshLodFactorTransformed);
+                mImpostorActive = impostorStrategy->isSorted(values);
+            }
 
             SubEntityList::iterator i, iend;
             iend = mSubEntityList.end();
@@ -495,6 +568,13 @@ namespace Ogre {
 
                 // Change LOD index
                 (*i)->mMaterialLodIndex = subEntEvt.newLodIndex;
+
+                // Pass the morph factor on to the geomorphing shaders
+                if (!(*i)->mSubMesh->mLodMorphTargets.empty())
+                {
+                    (*i)->setCustomParameter(SubMesh::LOD_MORPH_CUSTOM_PARAMETER,
+                        Vector4(mLodMorphFactor, 0, 0, 0));
+                }
 #endif
                 // Also invalidate any camera distance cache
                 (*i)->_invalidateCameraCache ();
@@ -511,6 +591,17 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Entity::setImpostor(Impostor* impostor, Real lodValue)
+    {
+        mImpostor = impostor;
+        mImpostorActive = false;
+        if (impostor)
+        {
+            impostor->generate();
+            mImpostorLodValue = mMesh->getLodStrategy()->transformUserValue(lodValue);
+        }
+    }
+    //-----------------------------------------------------------------------
     void Entity::setUpdateBoundingBoxFromSkeleton(bool update)
     {
         mUpdateBoundingBoxFromSkeleton = update;
@@ -525,7 +616,21 @@ namespace Ogre {
         // Get from Mesh
         if (mMesh->isLoaded())
         {
-            if ( mUpdateBoundingBoxFromSkeleton && hasSkeleton() )
+            if ( mUpdateBoundingBoxFromSkeleton && hasSkeleton() && isOffscreen() &&
+                !mSkeletonInstance->hasManualBones() )
+            {
+                // The bones are not kept up to date off-screen, enclose every animation instead
+                if (mAnimatedBoundsDirty)
+                    updateAnimatedBounds();
+                AxisAlignedBox bbox = mAnimatedBounds;
+                bbox.merge(getChildObjectsBoundingBox());
+                if (bbox != mFullBoundingBox)
+                {
+                    mFullBoundingBox = bbox;
+                    Node::queueNeedUpdate( mParentNode );
+                }
+            }
+            else if ( mUpdateBoundingBoxFromSkeleton && hasSkeleton() )
             {
                 // get from skeleton
                 // self bounding box without children
@@ -673,6 +778,16 @@ namespace Ogre {
             _initialise(true);
         }
 
+        // Far away entities are drawn together as impostors instead
+        if (mImpostorActive)
+        {
+            uint8 queueID = mRenderQueueIDSet ? mRenderQueueID : queue->getDefaultQueueGroup();
+            ushort priority = mRenderQueuePrioritySet ?
+                mRenderQueuePriority : queue->getDefaultRenderablePriority();
+            mManager->_getImpostorBatcher()->_addEntity(this, mImpostor, queueID, priority, queue);
+            return;
+        }
+
         Entity* displayEntity = this;
 #if !OGRE_NO_MESHLOD
         // Check we're not using a manual LOD
@@ -746,11 +861,20 @@ namespace Ogre {
             }
         }
 #endif
+        // Renders into shadow textures don't count as being seen by the camera
+        bool offscreen = mManager &&
+            mManager->_getCurrentRenderStage() == SceneManager::IRS_RENDER_TO_TEXTURE;
+        if (!offscreen)
+        {
+            mFrameLastVisible = Root::getSingleton().getNextFrameNumber();
+            displayEntity->mFrameLastVisible = mFrameLastVisible;
+        }
+
         // Since we know we're going to be rendered, take this opportunity to
         // update the animation
         if (displayEntity->hasSkeleton() || displayEntity->hasVertexAnimation())
         {
-            displayEntity->updateAnimation();
+            displayEntity->updateAnimation(offscreen);
 
             //--- pass this point,  we are sure that the transformation matrix of each bone and tagPoint have been updated
             ChildObjectList::iterator child_itr = mChildObjectList.begin();
@@ -856,7 +980,8 @@ namespace Ogre {
     bool Entity::tempSkelAnimBuffersBound(bool requestNormals) const
     {
         // Do we still have temp buffers for software skeleton animation bound?
-        if (mSkelAnimVertexData)
+        // Skinning on the GPU needs none, its output stays
+        if (mSkelAnimVertexData && !(mGpuSkinned && mGpuSkinnedVertexData))
         {
             if (!mTempSkelAnimInfo.buffersCheckedOut(true, requestNormals))
                 return false;
@@ -865,7 +990,8 @@ namespace Ogre {
              i != mSubEntityList.end(); ++i)
         {
             SubEntity* sub = *i;
-            if (sub->isVisible() && sub->mSkelAnimVertexData)
+            if (sub->isVisible() && sub->mSkelAnimVertexData &&
+                !(mGpuSkinned && sub->mGpuSkinnedVertexData))
             {
                 if (!sub->mTempSkelAnimInfo.buffersCheckedOut(true, requestNormals))
                     return false;
@@ -874,12 +1000,82 @@ namespace Ogre {
         return true;
     }
     //-----------------------------------------------------------------------
-    void Entity::updateAnimation(void)
+    bool Entity::isOffscreen(void) const
+    {
+        // Being visible in the last frame counts as well, since shadows are rendered
+        // before the camera finds the entity visible again
+        return mOffscreenAnimationInterval != 1 &&
+            mFrameLastVisible + 1 < Root::getSingleton().getNextFrameNumber();
+    }
+    //-----------------------------------------------------------------------
+    bool Entity::isOffscreenPoseDue(void)
+    {
+        if (!isOffscreen() || mFrameAnimationLastUpdated == std::numeric_limits<unsigned long>::max())
+            return true;
+        if (mOffscreenAnimationInterval == 0)
+            return false;
+
+        unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+        if (frameNumber == mFrameOffscreenAnimated)
+            return true;
+        if (frameNumber - mFrameOffscreenAnimated < mOffscreenAnimationInterval)
+            return false;
+        mFrameOffscreenAnimated = frameNumber;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void Entity::updateAnimatedBounds(void) const
+    {
+        // Sample a separate instance, the pose of the entity is left alone
+        SkeletonInstance skeleton(mMesh->getSkeleton());
+        skeleton.load();
+
+        AxisAlignedBox bbox;
+        Real maxScale = 0;
+        unsigned short numAnimations = skeleton.getNumAnimations();
+        // sample 0 of animation numAnimations is the binding pose
+        for (unsigned short a = 0; a <= numAnimations; ++a)
+        {
+            Animation* anim = a < numAnimations ? skeleton.getAnimation(a) : 0;
+            size_t numSamples = anim ? ANIMATED_BOUNDS_SAMPLES : 1;
+            for (size_t s = 0; s < numSamples; ++s)
+            {
+                skeleton.reset(true);
+                if (anim)
+                    anim->apply(&skeleton, anim->getLength() * s / (ANIMATED_BOUNDS_SAMPLES - 1));
+
+                for (unsigned short b = 0; b < skeleton.getNumBones(); ++b)
+                {
+                    const Bone* bone = skeleton.getBone(b);
+                    const Vector3& scaleVec = bone->_getDerivedScale();
+                    Real scale = std::max(std::max(Math::Abs(scaleVec.x), Math::Abs(scaleVec.y)), Math::Abs(scaleVec.z));
+                    maxScale = std::max(maxScale, scale);
+                    bbox.merge(bone->_getDerivedPosition());
+                }
+            }
+        }
+
+        if (!bbox.isNull())
+        {
+            Real r = mMesh->getBoneBoundingRadius() * maxScale;
+            Vector3 expansion(r, r, r);
+            bbox.setExtents(bbox.getMinimum() - expansion, bbox.getMaximum() + expansion);
+        }
+        bbox.merge(mMesh->getBounds());
+
+        mAnimatedBounds = bbox;
+        mAnimatedBoundsDirty = false;
+    }
+    //-----------------------------------------------------------------------
+    void Entity::updateAnimation(bool offscreen)
     {
         // Do nothing if not initialised yet
         if (!mInitialised)
             return;
 
+        // Off-screen, the last pose may be reused rather than evaluating the skeleton
+        bool freezePose = offscreen && !isOffscreenPoseDue();
+
         Root& root = Root::getSingleton();
         bool hwAnimation = isHardwareAnimationEnabled();
         bool isNeedUpdateHardwareAnim = hwAnimation && !mCurrentHWAnimationState;
@@ -893,9 +1089,9 @@ namespace Ogre {
         // since shadows only require positions
         bool blendNormals = !hwAnimation || forcedNormals;
         // Animation dirty if animation state modified or manual bones modified
-        bool animationDirty =
-            (mFrameAnimationLastUpdated != mAnimationState->getDirtyFrameNumber()) ||
-            (hasSkeleton() && getSkeleton()->getManualBonesDirty());
+        bool animationDirty = !freezePose &&
+            ((mFrameAnimationLastUpdated != mAnimationState->getDirtyFrameNumber()) ||
+            (hasSkeleton() && getSkeleton()->getManualBonesDirty()));
         
         //update the current hardware animation state
         mCurrentHWAnimationState = hwAnimation;
@@ -945,34 +1141,58 @@ namespace Ogre {
 
             if (hasSkeleton())
             {
-                cacheBoneMatrices();
+                if (!freezePose)
+                    cacheBoneMatrices();
 
                 // Software blend?
                 if (softwareAnimation)
                 {
                     const Matrix4* blendMatrices[256];
+                    // The blended buffers are only read back for shadows or by whoever
+                    // requested software animation, otherwise they need no shadow buffer
+                    bool shadowBlendBuffers = hwAnimation || stencilShadows || forcedSwAnimation;
+                    // Skin later along with the other visible entities, if the scene manager batches
+                    SoftwareSkinningBatch* batch = mManager ? mManager->_getSoftwareSkinningBatch() : 0;
+                    // Or skin on the GPU, if nothing reads the blended buffers on the CPU
+                    // and the source isn't morphed in software first
+                    GpuSkinningBatch* gpuBatch = (mManager && !shadowBlendBuffers && !hasVertexAnimation()) ?
+                        mManager->_getGpuSkinningBatch() : 0;
+                    mGpuSkinned = gpuBatch != 0;
 
                     // Ok, we need to do a software blend
                     // Firstly, check out working vertex buffers
-                    if (mSkelAnimVertexData)
+                    if (mSkelAnimVertexData && gpuBatch &&
+                        prepareGpuSkinnedVertexData(mGpuSkinnedVertexData, mMesh->sharedVertexData,
+                            mSkelAnimVertexData, mMesh->sharedBlendIndexToBoneIndexMap.size()))
+                    {
+                        Mesh::prepareMatricesForVertexBlend(blendMatrices,
+                                                            mBoneMatrices, mMesh->sharedBlendIndexToBoneIndexMap);
+                        gpuBatch->addSkin(mGpuSkinnedVertexData, blendMatrices,
+                            mMesh->sharedBlendIndexToBoneIndexMap.size());
+                    }
+                    else if (mSkelAnimVertexData)
                     {
                         // Blend shared geometry
                         // NB we suppress hardware upload while doing blend if we're
                         // hardware animation, because the only reason for doing this
                         // is for shadow, which need only be uploaded then
-                        mTempSkelAnimInfo.checkoutTempCopies(true, blendNormals);
+                        mTempSkelAnimInfo.checkoutTempCopies(true, blendNormals, shadowBlendBuffers);
                         mTempSkelAnimInfo.bindTempCopies(mSkelAnimVertexData,
                                                          hwAnimation);
                         // Prepare blend matrices, TODO: Move out of here
                         Mesh::prepareMatricesForVertexBlend(blendMatrices,
                                                             mBoneMatrices, mMesh->sharedBlendIndexToBoneIndexMap);
                         // Blend, taking source from either mesh data or morph data
-                        Mesh::softwareVertexBlend(
+                        const VertexData* source =
                             (mMesh->getSharedVertexDataAnimationType() != VAT_NONE) ?
-                            mSoftwareVertexAnimVertexData : mMesh->sharedVertexData,
-                            mSkelAnimVertexData,
-                            blendMatrices, mMesh->sharedBlendIndexToBoneIndexMap.size(),
-                            blendNormals);
+                            mSoftwareVertexAnimVertexData : mMesh->sharedVertexData;
+                        if (batch)
+                            batch->addBlend(source, mSkelAnimVertexData, blendMatrices,
+                                mMesh->sharedBlendIndexToBoneIndexMap.size(), blendNormals);
+                        else
+                            Mesh::softwareVertexBlend(source, mSkelAnimVertexData,
+                                blendMatrices, mMesh->sharedBlendIndexToBoneIndexMap.size(),
+                                blendNormals);
                     }
                     SubEntityList::iterator i, iend;
                     iend = mSubEntityList.end();
@@ -980,21 +1200,34 @@ namespace Ogre {
                     {
                         // Blend dedicated geometry
                         SubEntity* se = *i;
-                        if (se->isVisible() && se->mSkelAnimVertexData)
+                        if (se->isVisible() && se->mSkelAnimVertexData && gpuBatch &&
+                            prepareGpuSkinnedVertexData(se->mGpuSkinnedVertexData, se->mSubMesh->vertexData,
+                                se->mSkelAnimVertexData, se->mSubMesh->blendIndexToBoneIndexMap.size()))
                         {
-                            se->mTempSkelAnimInfo.checkoutTempCopies(true, blendNormals);
+                            Mesh::prepareMatricesForVertexBlend(blendMatrices,
+                                                                mBoneMatrices, se->mSubMesh->blendIndexToBoneIndexMap);
+                            gpuBatch->addSkin(se->mGpuSkinnedVertexData, blendMatrices,
+                                se->mSubMesh->blendIndexToBoneIndexMap.size());
+                        }
+                        else if (se->isVisible() && se->mSkelAnimVertexData)
+                        {
+                            se->mTempSkelAnimInfo.checkoutTempCopies(true, blendNormals, shadowBlendBuffers);
                             se->mTempSkelAnimInfo.bindTempCopies(se->mSkelAnimVertexData,
                                                                  hwAnimation);
                             // Prepare blend matrices, TODO: Move out of here
                             Mesh::prepareMatricesForVertexBlend(blendMatrices,
                                                                 mBoneMatrices, se->mSubMesh->blendIndexToBoneIndexMap);
                             // Blend, taking source from either mesh data or morph data
-                            Mesh::softwareVertexBlend(
+                            const VertexData* source =
                                 (se->getSubMesh()->getVertexAnimationType() != VAT_NONE)?
-                                se->mSoftwareVertexAnimVertexData : se->mSubMesh->vertexData,
-                                se->mSkelAnimVertexData,
-                                blendMatrices, se->mSubMesh->blendIndexToBoneIndexMap.size(),
-                                blendNormals);
+                                se->mSoftwareVertexAnimVertexData : se->mSubMesh->vertexData;
+                            if (batch)
+                                batch->addBlend(source, se->mSkelAnimVertexData, blendMatrices,
+                                    se->mSubMesh->blendIndexToBoneIndexMap.size(), blendNormals);
+                            else
+                                Mesh::softwareVertexBlend(source, se->mSkelAnimVertexData,
+                                    blendMatrices, se->mSubMesh->blendIndexToBoneIndexMap.size(),
+                                    blendNormals);
                         }
 
                     }
@@ -1463,9 +1696,20 @@ namespace Ogre {
         if ((*mFrameBonesLastUpdated != currentFrameNumber) ||
             (hasSkeleton() && getSkeleton()->getManualBonesDirty()))
         {
-            if ((!mSkipAnimStateUpdates) && (*mFrameBonesLastUpdated != currentFrameNumber))
-                mSkeletonInstance->setAnimationState(*mAnimationState);
-            mSkeletonInstance->_getBoneMatrices(mBoneMatrices);
+            if (mSkeletonAnimationCache && !mSkipAnimStateUpdates &&
+                (*mFrameBonesLastUpdated != currentFrameNumber) && !mSkeletonInstance->hasManualBones() &&
+                mChildObjectList.empty() && !mDisplaySkeleton && !mUpdateBoundingBoxFromSkeleton)
+            {
+                // Share the pose with the other entities of the cache
+                mSkeletonAnimationCache->_getBoneMatrices(mMesh->getSkeleton().get(), mSkeletonInstance,
+                    *mAnimationState, mBoneMatrices, currentFrameNumber);
+            }
+            else
+            {
+                if ((!mSkipAnimStateUpdates) && (*mFrameBonesLastUpdated != currentFrameNumber))
+                    mSkeletonInstance->setAnimationState(*mAnimationState);
+                mSkeletonInstance->_getBoneMatrices(mBoneMatrices);
+            }
             *mFrameBonesLastUpdated  = currentFrameNumber;
 
             return true;
@@ -1513,6 +1757,12 @@ namespace Ogre {
         mMinMeshLodIndex = minDetailIndex;
     }
     //-----------------------------------------------------------------------
+    void Entity::setLodMorphRange(Real range)
+    {
+        mLodMorphRange = Math::Clamp(range, Real(0), Real(1));
+        mLodMorphFactor = 0;
+    }
+    //-----------------------------------------------------------------------
     void Entity::setMaterialLodBias(Real factor, ushort maxDetailIndex, ushort minDetailIndex)
     {
         mMaterialLodFactor = factor;
@@ -1685,6 +1935,11 @@ namespace Ogre {
             OGRE_DELETE mSkelAnimVertexData;
             mSkelAnimVertexData = 0;
         }
+        if (mGpuSkinnedVertexData)
+        {
+            OGRE_DELETE mGpuSkinnedVertexData;
+            mGpuSkinnedVertexData = 0;
+        }
         if (mSoftwareVertexAnimVertexData)
         {
             OGRE_DELETE mSoftwareVertexAnimVertexData;
@@ -2029,7 +2284,7 @@ namespace Ogre {
         // Update any animation
         if (hasAnimation)
         {
-            updateAnimation();
+            updateAnimation(isOffscreen());
         }
 
         // Calculate the object space light details
@@ -2138,12 +2393,21 @@ namespace Ogre {
             esrPositionBuffer->suppressHardwareUpdate(false);
 
         }
-        // Calc triangle light facing
-        updateEdgeListLightFacing(edgeList, lightPos);
+        if (hasAnimation)
+        {
+            // Calc triangle light facing
+            updateEdgeListLightFacing(edgeList, lightPos);
 
-        // Generate indexes and update renderables
-        generateShadowVolume(edgeList, *indexBuffer, *indexBufferUsedSize,
-            light, mShadowRenderables, flags);
+            // Generate indexes and update renderables
+            generateShadowVolume(edgeList, *indexBuffer, *indexBufferUsedSize,
+                light, mShadowRenderables, flags);
+        }
+        else
+        {
+            // Reuse the indexes while neither the light nor the entity moves
+            generateShadowVolume(mShadowVolumeCaches, lightPos, edgeList, *indexBuffer,
+                *indexBufferUsedSize, light, mShadowRenderables, flags);
+        }
 
 
         return ShadowRenderableListIterator(mShadowRenderables.begin(), mShadowRenderables.end());
@@ -2482,6 +2746,8 @@ namespace Ogre {
         case BIND_SOFTWARE_MORPH:
             return mSoftwareVertexAnimVertexData;
         case BIND_SOFTWARE_SKELETAL:
+            if (mGpuSkinned && mGpuSkinnedVertexData && mGpuSkinnedVertexData->isSkinned())
+                return mGpuSkinnedVertexData->getVertexData();
             return mSkelAnimVertexData;
         };
         // keep compiler happy
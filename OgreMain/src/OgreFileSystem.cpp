@@ -54,6 +54,7 @@ THE SOFTWARE.
 namespace Ogre {
 
     bool FileSystemArchive::msIgnoreHidden = true;
+    size_t FileSystemArchive::msMemoryMapThreshold = 1024 * 1024;
 
     //-----------------------------------------------------------------------
     FileSystemArchive::FileSystemArchive(const String& name, const String& archType, bool readOnly )
@@ -224,6 +225,15 @@ namespace Ogre {
                         "FileSystemArchive::open");
         }
 
+#if OGRE_PLATFORM != OGRE_PLATFORM_WINRT
+        // Large files are read straight from the page cache instead
+        if (readOnly && msMemoryMapThreshold && (size_t)tagStat.st_size >= msMemoryMapThreshold)
+        {
+            return DataStreamPtr(OGRE_NEW MappedFileDataStream(filename, full_path,
+                                                               (size_t)tagStat.st_size));
+        }
+#endif
+
         if (!readOnly)
         {
             mode |= std::ios::out;
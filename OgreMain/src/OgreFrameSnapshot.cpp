@@ -0,0 +1,98 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreFrameSnapshot.h"
+#include "OgreNode.h"
+#include "OgreMovableObject.h"
+#include "OgreRenderable.h"
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    void FrameSnapshot::setTransform(Node* node, const Vector3& position,
+        const Quaternion& orientation, const Vector3& scale)
+    {
+        NodeTransform t;
+        t.node = node;
+        t.position = position;
+        t.orientation = orientation;
+        t.scale = scale;
+        mTransforms.push_back(t);
+    }
+    //-----------------------------------------------------------------------
+    void FrameSnapshot::setVisible(MovableObject* object, bool visible)
+    {
+        ObjectVisibility v;
+        v.object = object;
+        v.visible = visible;
+        mVisibilities.push_back(v);
+    }
+    //-----------------------------------------------------------------------
+    void FrameSnapshot::setCustomParameter(Renderable* renderable, size_t index, const Vector4& value)
+    {
+        CustomParameter p;
+        p.renderable = renderable;
+        p.index = index;
+        p.value = value;
+        mParameters.push_back(p);
+    }
+    //-----------------------------------------------------------------------
+    void FrameSnapshot::apply()
+    {
+        for (vector<NodeTransform>::type::iterator i = mTransforms.begin(); i != mTransforms.end(); ++i)
+        {
+            i->node->setPosition(i->position);
+            i->node->setOrientation(i->orientation);
+            i->node->setScale(i->scale);
+        }
+        for (vector<ObjectVisibility>::type::iterator i = mVisibilities.begin(); i != mVisibilities.end(); ++i)
+            i->object->setVisible(i->visible);
+        for (vector<CustomParameter>::type::iterator i = mParameters.begin(); i != mParameters.end(); ++i)
+            i->renderable->setCustomParameter(i->index, i->value);
+    }
+    //-----------------------------------------------------------------------
+    void FrameSnapshot::clear()
+    {
+        // Keep the capacity, the snapshots are refilled every frame
+        mTransforms.clear();
+        mVisibilities.clear();
+        mParameters.clear();
+    }
+    //-----------------------------------------------------------------------
+    bool FrameSnapshot::isEmpty() const
+    {
+        return mTransforms.empty() && mVisibilities.empty() && mParameters.empty();
+    }
+    //-----------------------------------------------------------------------
+    void FrameSnapshot::swap(FrameSnapshot& other)
+    {
+        mTransforms.swap(other.mTransforms);
+        mVisibilities.swap(other.mVisibilities);
+        mParameters.swap(other.mParameters);
+    }
+}
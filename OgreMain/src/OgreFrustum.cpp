@@ -39,6 +39,7 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreRenderSystem.h"
 #include "OgreMovablePlane.h"
+#include "OgreOptimisedUtil.h"
 
 namespace Ogre {
 
@@ -286,6 +287,59 @@ namespace Ogre {
         return true;
     }
     //-----------------------------------------------------------------------
+    void Frustum::isVisible(const float* bounds, size_t numBoxes, uint32* visibility) const
+    {
+        // Make any pending updates to the calculated frustum planes
+        updateFrustumPlanes();
+
+        float planes[6 * 4];
+        float* dest = planes;
+        for (int plane = 0; plane < 6; ++plane)
+        {
+            // Skip far plane if infinite view frustum
+            if (plane == FRUSTUM_PLANE_FAR && mFarDist == 0)
+                continue;
+
+            const Plane& p = mFrustumPlanes[plane];
+            *dest++ = static_cast<float>(p.normal.x);
+            *dest++ = static_cast<float>(p.normal.y);
+            *dest++ = static_cast<float>(p.normal.z);
+            *dest++ = static_cast<float>(p.d);
+        }
+
+        OptimisedUtil::getImplementation()->calculateBoxVisibility(
+            planes, (dest - planes) / 4, bounds, visibility, numBoxes);
+    }
+    //-----------------------------------------------------------------------
+    void Frustum::packBounds(const AxisAlignedBox& box, size_t index, float* bounds)
+    {
+        Vector3 centre, halfSize;
+        if (box.isNull())
+        {
+            // Negative extents put the box on the negative side of every plane
+            centre = Vector3::ZERO;
+            halfSize = Vector3(-std::numeric_limits<float>::max());
+        }
+        else if (box.isInfinite())
+        {
+            centre = Vector3::ZERO;
+            halfSize = Vector3(std::numeric_limits<float>::max());
+        }
+        else
+        {
+            centre = box.getCenter();
+            halfSize = box.getHalfSize();
+        }
+
+        float* group = bounds + (index / 4) * 24 + (index & 3);
+        group[0] = static_cast<float>(centre.x);
+        group[4] = static_cast<float>(centre.y);
+        group[8] = static_cast<float>(centre.z);
+        group[12] = static_cast<float>(halfSize.x);
+        group[16] = static_cast<float>(halfSize.y);
+        group[20] = static_cast<float>(halfSize.z);
+    }
+    //-----------------------------------------------------------------------
     bool Frustum::isVisible(const Sphere& sphere, FrustumPlane* culledBy) const
     {
         // Make any pending updates to the calculated frustum planes
@@ -207,6 +207,12 @@ namespace Ogre {
         return mSharedParametersMap;
     }
     //---------------------------------------------------------------------
+    void GpuProgramManager::_releaseSharedParametersBuffers(void)
+    {
+        for (SharedParametersMap::iterator i = mSharedParametersMap.begin(); i != mSharedParametersMap.end(); ++i)
+            i->second->_setHardwareBuffer(HardwareUniformBufferSharedPtr());
+    }
+    //---------------------------------------------------------------------
     bool GpuProgramManager::getSaveMicrocodesToCache()
     {
         return mSaveMicrocodesToCache;
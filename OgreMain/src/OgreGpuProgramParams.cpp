@@ -28,6 +28,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreStableHeaders.h"
 #include "OgreGpuProgramParams.h"
 #include "OgreGpuProgramManager.h"
+#include "OgreHardwareUniformBuffer.h"
 #include "OgreVector3.h"
 #include "OgreVector4.h"
 #include "OgreDualQuaternion.h"
@@ -36,6 +37,47 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 
 namespace Ogre
 {
+    namespace
+    {
+        // Collects constant lists by their values, to share the storage of identical ones
+        template <typename T> class ConstantListPool
+        {
+        public:
+            ConstantListPool() : mFreedBytes(0) {}
+
+            void add(SharedConstantList<T>& list)
+            {
+                const typename SharedConstantList<T>::List& values = list.get();
+                if (values.empty())
+                    return;
+
+                size_t bytes = sizeof(T) * values.size();
+                uint32 hash = FastHash(reinterpret_cast<const char*>(&values[0]), bytes);
+                bool owned = !list.isShared();
+                std::pair<typename ListMap::iterator, typename ListMap::iterator> range = mLists.equal_range(hash);
+                for (typename ListMap::iterator i = range.first; i != range.second; ++i)
+                {
+                    if (list.sharesWith(*i->second))
+                        return;
+                    if (list.shareWith(*i->second))
+                    {
+                        // The storage is only freed if no other list used it
+                        if (owned)
+                            mFreedBytes += bytes;
+                        return;
+                    }
+                }
+                mLists.insert(std::make_pair(hash, &list));
+            }
+
+            size_t getFreedBytes() const { return mFreedBytes; }
+
+        private:
+            typedef typename multimap<uint32, SharedConstantList<T>*>::type ListMap;
+            ListMap mLists;
+            size_t mFreedBytes;
+        };
+    }
 
     //---------------------------------------------------------------------
     GpuProgramParameters::AutoConstantDefinition GpuProgramParameters::AutoConstantDictionary[] = {
@@ -184,7 +226,8 @@ namespace Ogre
         AutoConstantDefinition(ACT_TEXTURE_MATRIX,  "texture_matrix", 16, ET_REAL, ACDT_INT),
         AutoConstantDefinition(ACT_LOD_CAMERA_POSITION,               "lod_camera_position",              3, ET_REAL, ACDT_NONE),
         AutoConstantDefinition(ACT_LOD_CAMERA_POSITION_OBJECT_SPACE,  "lod_camera_position_object_space", 3, ET_REAL, ACDT_NONE),
-        AutoConstantDefinition(ACT_LIGHT_CUSTOM,        "light_custom", 4, ET_REAL, ACDT_INT)
+        AutoConstantDefinition(ACT_LIGHT_CUSTOM,        "light_custom", 4, ET_REAL, ACDT_INT),
+        AutoConstantDefinition(ACT_TEXTURE_VIEWPORT_RECT,       "texture_viewport_rect",          4, ET_REAL, ACDT_INT)
     };
 
     bool GpuNamedConstants::msGenerateAllConstantDefinitionArrayEntries = false;
@@ -609,28 +652,96 @@ namespace Ogre
     }
     //---------------------------------------------------------------------
     void GpuSharedParameters::setNamedConstant(const String& name, const float *val, size_t count)
+    {
+        setNamedConstant(getConstantHandle(name), val, count);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const String& name, const double *val, size_t count)
+    {
+        setNamedConstant(getConstantHandle(name), val, count);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const String& name, const int *val, size_t count)
+    {
+        setNamedConstant(getConstantHandle(name), val, count);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const String& name, const uint *val, size_t count)
+    {
+        setNamedConstant(getConstantHandle(name), val, count);
+    }
+    //---------------------------------------------------------------------
+    GpuConstantHandle GpuSharedParameters::getConstantHandle(const String& name) const
     {
         GpuConstantDefinitionMap::const_iterator i = mNamedConstants.map.find(name);
-        if (i != mNamedConstants.map.end())
+        if (i == mNamedConstants.map.end())
+            return GpuConstantHandle();
+        return GpuConstantHandle(i->second);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, Real val)
+    {
+        setNamedConstant(handle, &val, 1);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, int val)
+    {
+        setNamedConstant(handle, &val, 1);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, uint val)
+    {
+        setNamedConstant(handle, &val, 1);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, const Vector4& vec)
+    {
+        setNamedConstant(handle, vec.ptr(), 4);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, const Vector3& vec)
+    {
+        setNamedConstant(handle, vec.ptr(), 3);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, const Vector2& vec)
+    {
+        setNamedConstant(handle, vec.ptr(), 2);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, const Matrix4& m)
+    {
+        setNamedConstant(handle, m[0], 16);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, const Matrix4* m, size_t numEntries)
+    {
+        setNamedConstant(handle, m[0][0], 16 * numEntries);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, const ColourValue& colour)
+    {
+        setNamedConstant(handle, colour.ptr(), 4);
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, const float *val, size_t count)
+    {
+        if (handle.isValid())
         {
-            const GpuConstantDefinition& def = i->second;
-            memcpy(&mFloatConstants[def.physicalIndex], val,
-                   sizeof(float) * std::min(count, def.elementSize * def.arraySize));
+            memcpy(&mFloatConstants[handle.physicalIndex], val,
+                   sizeof(float) * std::min(count, handle.elementSize * handle.arraySize));
         }
 
         _markDirty();
     }
     //---------------------------------------------------------------------
-    void GpuSharedParameters::setNamedConstant(const String& name, const double *val, size_t count)
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, const double *val, size_t count)
     {
-        GpuConstantDefinitionMap::const_iterator i = mNamedConstants.map.find(name);
-        if (i != mNamedConstants.map.end())
+        if (handle.isValid())
         {
-            const GpuConstantDefinition& def = i->second;
-
-            count = std::min(count, def.elementSize * def.arraySize);
+            count = std::min(count, handle.elementSize * handle.arraySize);
             const double* src = val;
-            double* dst = &mDoubleConstants[def.physicalIndex];
+            double* dst = &mDoubleConstants[handle.physicalIndex];
             for (size_t v = 0; v < count; ++v)
             {
                 *dst++ = static_cast<double>(*src++);
@@ -640,27 +751,23 @@ namespace Ogre
         _markDirty();
     }
     //---------------------------------------------------------------------
-    void GpuSharedParameters::setNamedConstant(const String& name, const int *val, size_t count)
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, const int *val, size_t count)
     {
-        GpuConstantDefinitionMap::const_iterator i = mNamedConstants.map.find(name);
-        if (i != mNamedConstants.map.end())
+        if (handle.isValid())
         {
-            const GpuConstantDefinition& def = i->second;
-            memcpy(&mIntConstants[def.physicalIndex], val,
-                   sizeof(int) * std::min(count, def.elementSize * def.arraySize));
+            memcpy(&mIntConstants[handle.physicalIndex], val,
+                   sizeof(int) * std::min(count, handle.elementSize * handle.arraySize));
         }
 
         _markDirty();
     }
     //---------------------------------------------------------------------
-    void GpuSharedParameters::setNamedConstant(const String& name, const uint *val, size_t count)
+    void GpuSharedParameters::setNamedConstant(const GpuConstantHandle& handle, const uint *val, size_t count)
     {
-        GpuConstantDefinitionMap::const_iterator i = mNamedConstants.map.find(name);
-        if (i != mNamedConstants.map.end())
+        if (handle.isValid())
         {
-            const GpuConstantDefinition& def = i->second;
-            memcpy(&mUnsignedIntConstants[def.physicalIndex], val,
-                   sizeof(uint) * std::min(count, def.elementSize * def.arraySize));
+            memcpy(&mUnsignedIntConstants[handle.physicalIndex], val,
+                   sizeof(uint) * std::min(count, handle.elementSize * handle.arraySize));
         }
 
         _markDirty();
@@ -689,6 +796,83 @@ namespace Ogre
         mFrameLastUpdated = Root::getSingleton().getNextFrameNumber();
         mDirty = true;
     }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::_setHardwareBuffer(const HardwareUniformBufferSharedPtr& buffer)
+    {
+        mHardwareBuffer = buffer;
+        mHardwareBufferLayout.clear();
+        mHardwareBufferData.clear();
+
+        // The new buffer holds nothing yet
+        if (mHardwareBuffer)
+        {
+            mHardwareBufferData.resize(mHardwareBuffer->getSizeInBytes());
+            _markDirty();
+        }
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::_setHardwareBufferOffset(const String& name, size_t offset, size_t arrayStride)
+    {
+        HardwareBufferEntry entry;
+        entry.name = name;
+        entry.offset = offset;
+        entry.arrayStride = arrayStride;
+        mHardwareBufferLayout.push_back(entry);
+        _markDirty();
+    }
+    //---------------------------------------------------------------------
+    void GpuSharedParameters::_updateHardwareBuffer()
+    {
+        if (!mDirty || !mHardwareBuffer)
+            return;
+
+        size_t bufferSize = mHardwareBufferData.size();
+        for (HardwareBufferLayout::const_iterator i = mHardwareBufferLayout.begin();
+             i != mHardwareBufferLayout.end(); ++i)
+        {
+            // Definitions may have been removed since the buffer was laid out
+            GpuConstantDefinitionMap::const_iterator defi = mNamedConstants.map.find(i->name);
+            if (defi == mNamedConstants.map.end())
+                continue;
+
+            const GpuConstantDefinition& def = defi->second;
+            const uchar* src;
+            size_t elementBytes;
+            if (def.isFloat())
+            {
+                src = reinterpret_cast<const uchar*>(&mFloatConstants[def.physicalIndex]);
+                elementBytes = def.elementSize * sizeof(float);
+            }
+            else if (def.isDouble())
+            {
+                src = reinterpret_cast<const uchar*>(&mDoubleConstants[def.physicalIndex]);
+                elementBytes = def.elementSize * sizeof(double);
+            }
+            else if (def.isInt() || def.isSampler() || def.isSubroutine())
+            {
+                src = reinterpret_cast<const uchar*>(&mIntConstants[def.physicalIndex]);
+                elementBytes = def.elementSize * sizeof(int);
+            }
+            else
+            {
+                src = reinterpret_cast<const uchar*>(&mUnsignedIntConstants[def.physicalIndex]);
+                elementBytes = def.elementSize * sizeof(uint);
+            }
+
+            size_t stride = i->arrayStride ? i->arrayStride : elementBytes;
+            for (size_t e = 0; e < def.arraySize; ++e)
+            {
+                size_t offset = i->offset + e * stride;
+                if (offset + elementBytes > bufferSize)
+                    break;
+                memcpy(&mHardwareBufferData[offset], src + e * elementBytes, elementBytes);
+            }
+        }
+
+        // Every value is written, so the previous contents can be discarded
+        mHardwareBuffer->writeData(0, bufferSize, &mHardwareBufferData[0], true);
+        _markClean();
+    }
     
 
     //-----------------------------------------------------------------------------
@@ -927,6 +1111,7 @@ namespace Ogre
         , mTransposeMatrices(false)
         , mIgnoreMissingParams(false)
         , mActivePassIterationIndex(std::numeric_limits<size_t>::max())
+        , mAutoParamSource(0)
     {
     }
     //-----------------------------------------------------------------------------
@@ -959,6 +1144,7 @@ namespace Ogre
         mTransposeMatrices = oth.mTransposeMatrices;
         mIgnoreMissingParams  = oth.mIgnoreMissingParams;
         mActivePassIterationIndex = oth.mActivePassIterationIndex;
+        mAutoParamSource = 0;
 
         return *this;
     }
@@ -1017,22 +1203,22 @@ namespace Ogre
         // Size and reset buffer (fill with zero to make comparison later ok)
         if (namedConstants->floatBufferSize > mFloatConstants.size())
         {
-            mFloatConstants.insert(mFloatConstants.end(),
+            mFloatConstants.edit().insert(mFloatConstants.edit().end(),
                                    namedConstants->floatBufferSize - mFloatConstants.size(), 0.0f);
         }
         if (namedConstants->doubleBufferSize > mDoubleConstants.size())
         {
-            mDoubleConstants.insert(mDoubleConstants.end(),
+            mDoubleConstants.edit().insert(mDoubleConstants.edit().end(),
                                    namedConstants->doubleBufferSize - mDoubleConstants.size(), 0.0f);
         }
         if (namedConstants->intBufferSize > mIntConstants.size())
         {
-            mIntConstants.insert(mIntConstants.end(),
+            mIntConstants.edit().insert(mIntConstants.edit().end(),
                                  namedConstants->intBufferSize - mIntConstants.size(), 0);
         }
         if (namedConstants->uintBufferSize > mUnsignedIntConstants.size())
         {
-            mUnsignedIntConstants.insert(mUnsignedIntConstants.end(),
+            mUnsignedIntConstants.edit().insert(mUnsignedIntConstants.edit().end(),
                                  namedConstants->uintBufferSize - mUnsignedIntConstants.size(), 0);
         }
         // if (namedConstants->boolBufferSize > mBoolConstants.size())
@@ -1063,22 +1249,22 @@ namespace Ogre
         // Size and reset buffer (fill with zero to make comparison later ok)
         if (floatIndexMap && floatIndexMap->bufferSize > mFloatConstants.size())
         {
-            mFloatConstants.insert(mFloatConstants.end(),
+            mFloatConstants.edit().insert(mFloatConstants.edit().end(),
                                    floatIndexMap->bufferSize - mFloatConstants.size(), 0.0f);
         }
         if (doubleIndexMap && doubleIndexMap->bufferSize > mDoubleConstants.size())
         {
-            mDoubleConstants.insert(mDoubleConstants.end(),
+            mDoubleConstants.edit().insert(mDoubleConstants.edit().end(),
                                     doubleIndexMap->bufferSize - mDoubleConstants.size(), 0.0f);
         }
         if (intIndexMap &&  intIndexMap->bufferSize > mIntConstants.size())
         {
-            mIntConstants.insert(mIntConstants.end(),
+            mIntConstants.edit().insert(mIntConstants.edit().end(),
                                  intIndexMap->bufferSize - mIntConstants.size(), 0);
         }
         if (uintIndexMap &&  uintIndexMap->bufferSize > mUnsignedIntConstants.size())
         {
-            mUnsignedIntConstants.insert(mUnsignedIntConstants.end(),
+            mUnsignedIntConstants.edit().insert(mUnsignedIntConstants.edit().end(),
                                  uintIndexMap->bufferSize - mUnsignedIntConstants.size(), 0);
         }
         // if (boolIndexMap &&  boolIndexMap->bufferSize > mBoolConstants.size())
@@ -1172,9 +1358,10 @@ namespace Ogre
         size_t physicalIndex = _getFloatConstantPhysicalIndex(index, rawCount, GPV_GLOBAL);
         assert(physicalIndex + rawCount <= mFloatConstants.size());
         // Copy manually since cast required
+        FloatConstantList& constants = mFloatConstants.edit();
         for (size_t i = 0; i < rawCount; ++i)
         {
-            mFloatConstants[physicalIndex + i] =
+            constants[physicalIndex + i] =
                 static_cast<float>(val[i]);
         }
 
@@ -1305,28 +1492,29 @@ namespace Ogre
     void GpuProgramParameters::_writeRawConstants(size_t physicalIndex, const double* val, size_t count)
     {
         assert(physicalIndex + count <= mFloatConstants.size());
+        FloatConstantList& constants = mFloatConstants.edit();
         for (size_t i = 0; i < count; ++i)
         {
-            mFloatConstants[physicalIndex+i] = static_cast<float>(val[i]);
+            constants[physicalIndex+i] = static_cast<float>(val[i]);
         }
     }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::_writeRawConstants(size_t physicalIndex, const float* val, size_t count)
     {
         assert(physicalIndex + count <= mFloatConstants.size());
-        memcpy(&mFloatConstants[physicalIndex], val, sizeof(float) * count);
+        memcpy(&mFloatConstants.edit()[physicalIndex], val, sizeof(float) * count);
     }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::_writeRawConstants(size_t physicalIndex, const int* val, size_t count)
     {
         assert(physicalIndex + count <= mIntConstants.size());
-        memcpy(&mIntConstants[physicalIndex], val, sizeof(int) * count);
+        memcpy(&mIntConstants.edit()[physicalIndex], val, sizeof(int) * count);
     }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::_writeRawConstants(size_t physicalIndex, const uint* val, size_t count)
     {
         assert(physicalIndex + count <= mUnsignedIntConstants.size());
-        memcpy(&mUnsignedIntConstants[physicalIndex], val, sizeof(uint) * count);
+        memcpy(&mUnsignedIntConstants.edit()[physicalIndex], val, sizeof(uint) * count);
     }
     //-----------------------------------------------------------------------------
     // void GpuProgramParameters::_writeRawConstants(size_t physicalIndex, const bool* val, size_t count)
@@ -1338,13 +1526,13 @@ namespace Ogre
     void GpuProgramParameters::_readRawConstants(size_t physicalIndex, size_t count, float* dest)
     {
         assert(physicalIndex + count <= mFloatConstants.size());
-        memcpy(dest, &mFloatConstants[physicalIndex], sizeof(float) * count);
+        memcpy(dest, &mFloatConstants.get()[physicalIndex], sizeof(float) * count);
     }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::_readRawConstants(size_t physicalIndex, size_t count, int* dest)
     {
         assert(physicalIndex + count <= mIntConstants.size());
-        memcpy(dest, &mIntConstants[physicalIndex], sizeof(int) * count);
+        memcpy(dest, &mIntConstants.get()[physicalIndex], sizeof(int) * count);
     }
     //---------------------------------------------------------------------
     uint16 GpuProgramParameters::deriveVariability(GpuProgramParameters::AutoConstantType act)
@@ -1489,6 +1677,7 @@ namespace Ogre
         case ACT_SPOTLIGHT_VIEWPROJ_MATRIX:
         case ACT_SPOTLIGHT_VIEWPROJ_MATRIX_ARRAY:
         case ACT_LIGHT_CUSTOM:
+        case ACT_TEXTURE_VIEWPORT_RECT:
 
             return (uint16)GPV_LIGHTS;
 
@@ -1526,7 +1715,7 @@ namespace Ogre
                 size_t physicalIndex = mFloatConstants.size();
 
                 // Expand at buffer end
-                mFloatConstants.insert(mFloatConstants.end(), requestedSize, 0.0f);
+                mFloatConstants.edit().insert(mFloatConstants.edit().end(), requestedSize, 0.0f);
 
                 // Record extended size for future GPU params re-using this information
                 mFloatLogicalToPhysical->bufferSize = mFloatConstants.size();
@@ -1573,9 +1762,9 @@ namespace Ogre
                 // of the original use, or perhaps a variable length we can't predict
                 // until first actual runtime use e.g. world matrix array
                 size_t insertCount = requestedSize - logi->second.currentSize;
-                FloatConstantList::iterator insertPos = mFloatConstants.begin();
+                FloatConstantList::iterator insertPos = mFloatConstants.edit().begin();
                 std::advance(insertPos, physicalIndex);
-                mFloatConstants.insert(insertPos, insertCount, 0.0f);
+                mFloatConstants.edit().insert(insertPos, insertCount, 0.0f);
                 // shift all physical positions after this one
                 for (GpuLogicalIndexUseMap::iterator i = mFloatLogicalToPhysical->map.begin();
                      i != mFloatLogicalToPhysical->map.end(); ++i)
@@ -1633,7 +1822,7 @@ namespace Ogre
                 size_t physicalIndex = mDoubleConstants.size();
 
                 // Expand at buffer end
-                mDoubleConstants.insert(mDoubleConstants.end(), requestedSize, 0.0f);
+                mDoubleConstants.edit().insert(mDoubleConstants.edit().end(), requestedSize, 0.0f);
 
                 // Record extended size for future GPU params re-using this information
                 mDoubleLogicalToPhysical->bufferSize = mDoubleConstants.size();
@@ -1680,9 +1869,9 @@ namespace Ogre
                 // of the original use, or perhaps a variable length we can't predict
                 // until first actual runtime use e.g. world matrix array
                 size_t insertCount = requestedSize - logi->second.currentSize;
-                DoubleConstantList::iterator insertPos = mDoubleConstants.begin();
+                DoubleConstantList::iterator insertPos = mDoubleConstants.edit().begin();
                 std::advance(insertPos, physicalIndex);
-                mDoubleConstants.insert(insertPos, insertCount, 0.0f);
+                mDoubleConstants.edit().insert(insertPos, insertCount, 0.0f);
                 // shift all physical positions after this one
                 for (GpuLogicalIndexUseMap::iterator i = mDoubleLogicalToPhysical->map.begin();
                      i != mDoubleLogicalToPhysical->map.end(); ++i)
@@ -1741,7 +1930,7 @@ namespace Ogre
                 size_t physicalIndex = mIntConstants.size();
 
                 // Expand at buffer end
-                mIntConstants.insert(mIntConstants.end(), requestedSize, 0);
+                mIntConstants.edit().insert(mIntConstants.edit().end(), requestedSize, 0);
 
                 // Record extended size for future GPU params re-using this information
                 mIntLogicalToPhysical->bufferSize = mIntConstants.size();
@@ -1787,9 +1976,9 @@ namespace Ogre
                 // of the original use, or perhaps a variable length we can't predict
                 // until first actual runtime use e.g. world matrix array
                 size_t insertCount = requestedSize - logi->second.currentSize;
-                IntConstantList::iterator insertPos = mIntConstants.begin();
+                IntConstantList::iterator insertPos = mIntConstants.edit().begin();
                 std::advance(insertPos, physicalIndex);
-                mIntConstants.insert(insertPos, insertCount, 0);
+                mIntConstants.edit().insert(insertPos, insertCount, 0);
                 // shift all physical positions after this one
                 for (GpuLogicalIndexUseMap::iterator i = mIntLogicalToPhysical->map.begin();
                      i != mIntLogicalToPhysical->map.end(); ++i)
@@ -1849,7 +2038,7 @@ namespace Ogre
                 size_t physicalIndex = mUnsignedIntConstants.size();
 
                 // Expand at buffer end
-                mUnsignedIntConstants.insert(mUnsignedIntConstants.end(), requestedSize, 0);
+                mUnsignedIntConstants.edit().insert(mUnsignedIntConstants.edit().end(), requestedSize, 0);
 
                 // Record extended size for future GPU params re-using this information
                 mUnsignedIntLogicalToPhysical->bufferSize = mUnsignedIntConstants.size();
@@ -1895,9 +2084,9 @@ namespace Ogre
                 // of the original use, or perhaps a variable length we can't predict
                 // until first actual runtime use e.g. world matrix array
                 size_t insertCount = requestedSize - logi->second.currentSize;
-                UnsignedIntConstantList::iterator insertPos = mUnsignedIntConstants.begin();
+                UnsignedIntConstantList::iterator insertPos = mUnsignedIntConstants.edit().begin();
                 std::advance(insertPos, physicalIndex);
-                mUnsignedIntConstants.insert(insertPos, insertCount, 0);
+                mUnsignedIntConstants.edit().insert(insertPos, insertCount, 0);
                 // shift all physical positions after this one
                 for (GpuLogicalIndexUseMap::iterator i = mUnsignedIntLogicalToPhysical->map.begin();
                      i != mUnsignedIntLogicalToPhysical->map.end(); ++i)
@@ -2264,6 +2453,7 @@ namespace Ogre
             mAutoConstants.push_back(AutoConstantEntry(acType, physicalIndex, extraInfo, variability, elementSize));
 
         mCombinedVariability |= variability;
+        mAutoParamSource = 0;
 
 
     }
@@ -2314,6 +2504,7 @@ namespace Ogre
             mAutoConstants.push_back(AutoConstantEntry(acType, physicalIndex, rData, variability, elementSize));
 
         mCombinedVariability |= variability;
+        mAutoParamSource = 0;
     }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::clearAutoConstant(size_t index)
@@ -2363,6 +2554,7 @@ namespace Ogre
     {
         mAutoConstants.clear();
         mCombinedVariability = GPV_GLOBAL;
+        mAutoParamSource = 0;
     }
     //-----------------------------------------------------------------------------
     GpuProgramParameters::AutoConstantIterator GpuProgramParameters::getAutoConstantIterator(void) const
@@ -2402,6 +2594,28 @@ namespace Ogre
         if (!(mask & mCombinedVariability))
             return;
 
+        // Only evaluate the classes of autos whose source changed since the last update
+        static const GpuParamVariability versioned[3] = { GPV_GLOBAL, GPV_PER_OBJECT, GPV_LIGHTS };
+        uint16 changed = mask;
+        for (int v = 0; v < 3; ++v)
+        {
+            uint32 version = source->getVariabilityVersion(versioned[v]);
+            if (mask & versioned[v])
+            {
+                if (source == mAutoParamSource && version == mAutoParamVersions[v])
+                    changed &= ~versioned[v];
+                mAutoParamVersions[v] = version;
+            }
+            else if (source != mAutoParamSource)
+            {
+                // Not updated now, so not up to date with this source
+                mAutoParamVersions[v] = ~version;
+            }
+        }
+        mAutoParamSource = source;
+        size_t numUpdated = 0;
+        size_t numSkipped = 0;
+
         size_t index;
         size_t numMatrices;
         const Matrix4* pMatrix;
@@ -2418,8 +2632,9 @@ namespace Ogre
         for (AutoConstantList::const_iterator i = mAutoConstants.begin(); i != mAutoConstants.end(); ++i)
         {
             // Only update needed slots
-            if (i->variability & mask)
+            if (i->variability & changed)
             {
+                ++numUpdated;
 
                 switch(i->paramType)
                 {
@@ -3025,6 +3240,9 @@ namespace Ogre
                                           source->getTextureViewProjMatrix(l),i->elementCount);
                     }
                     break;
+                case ACT_TEXTURE_VIEWPORT_RECT:
+                    _writeRawConstant(i->physicalIndex, source->getTextureProjectorRegion(i->data), i->elementCount);
+                    break;
                 case ACT_SPOTLIGHT_VIEWPROJ_MATRIX:
                     _writeRawConstant(i->physicalIndex, source->getSpotlightViewProjMatrix(i->data),i->elementCount);
                     break;
@@ -3041,8 +3259,13 @@ namespace Ogre
                     break;
                 };
             }
+            else if (i->variability & mask)
+            {
+                ++numSkipped;
+            }
         }
 
+        source->_recordAutoConstantUpdate(numUpdated, numSkipped);
     }
     //---------------------------------------------------------------------------
     void GpuProgramParameters::setNamedConstant(const String& name, Real val)
@@ -3190,6 +3413,99 @@ namespace Ogre
     //     if (def)
     //         _writeRawConstants(def->physicalIndex, val, rawCount);
     // }
+    //---------------------------------------------------------------------------
+    GpuConstantHandle GpuProgramParameters::getConstantHandle(const String& name) const
+    {
+        // look up, and throw an exception if we're not ignoring missing
+        const GpuConstantDefinition* def =
+            _findNamedConstantDefinition(name, !mIgnoreMissingParams);
+        if (def)
+            return GpuConstantHandle(*def);
+        return GpuConstantHandle();
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, Real val)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, val);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, int val)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, val);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, uint val)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, val);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const Vector4& vec)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, vec, handle.elementSize);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const Vector3& vec)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, vec);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const Vector2& vec)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, vec);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const Matrix4& m)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, m, handle.elementSize);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const Matrix4* m,
+                                                size_t numEntries)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, m, numEntries);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const ColourValue& colour)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, colour, handle.elementSize);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle,
+                                                const float *val, size_t count, size_t multiple)
+    {
+        if (handle.isValid())
+            _writeRawConstants(handle.physicalIndex, val, count * multiple);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle,
+                                                const double *val, size_t count, size_t multiple)
+    {
+        if (handle.isValid())
+            _writeRawConstants(handle.physicalIndex, val, count * multiple);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle,
+                                                const int *val, size_t count, size_t multiple)
+    {
+        if (handle.isValid())
+            _writeRawConstants(handle.physicalIndex, val, count * multiple);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle,
+                                                const uint *val, size_t count, size_t multiple)
+    {
+        if (handle.isValid())
+            _writeRawConstants(handle.physicalIndex, val, count * multiple);
+    }
     //---------------------------------------------------------------------
     void GpuProgramParameters::setNamedSubroutine(const String& subroutineSlot, const String& subroutine)
     {
@@ -3423,17 +3739,34 @@ namespace Ogre
     //---------------------------------------------------------------------------
     void GpuProgramParameters::copyConstantsFrom(const GpuProgramParameters& source)
     {
-        // Pull buffers & auto constant list over directly
-        mFloatConstants = source.getFloatConstantList();
-        mDoubleConstants = source.getDoubleConstantList();
-        mIntConstants = source.getIntConstantList();
-        mUnsignedIntConstants = source.getUnsignedIntConstantList();
+        // Share the buffers until either side changes them & pull auto constant list over directly
+        mFloatConstants = source.mFloatConstants;
+        mDoubleConstants = source.mDoubleConstants;
+        mIntConstants = source.mIntConstants;
+        mUnsignedIntConstants = source.mUnsignedIntConstants;
         // mBoolConstants = source.getBoolConstantList();
         mAutoConstants = source.getAutoConstantList();
         mCombinedVariability = source.mCombinedVariability;
+        mAutoParamSource = 0;
         copySharedParamSetUsage(source.mSharedParamSets);
     }
     //---------------------------------------------------------------------
+    size_t GpuProgramParameters::shareIdenticalConstants(const vector<GpuProgramParameters*>::type& params)
+    {
+        ConstantListPool<float> floats;
+        ConstantListPool<double> doubles;
+        ConstantListPool<int> ints;
+        ConstantListPool<uint> uints;
+        for (vector<GpuProgramParameters*>::type::const_iterator i = params.begin(); i != params.end(); ++i)
+        {
+            floats.add((*i)->mFloatConstants);
+            doubles.add((*i)->mDoubleConstants);
+            ints.add((*i)->mIntConstants);
+            uints.add((*i)->mUnsignedIntConstants);
+        }
+        return floats.getFreedBytes() + doubles.getFreedBytes() + ints.getFreedBytes() + uints.getFreedBytes();
+    }
+    //---------------------------------------------------------------------
     void GpuProgramParameters::copyMatchingNamedConstantsFrom(const GpuProgramParameters& source)
     {
         if (mNamedConstants && source.mNamedConstants)
@@ -3578,7 +3911,7 @@ namespace Ogre
         if (mActivePassIterationIndex != std::numeric_limits<size_t>::max())
         {
             // This is a physical index
-            ++mFloatConstants[mActivePassIterationIndex];
+            ++mFloatConstants.edit()[mActivePassIterationIndex];
         }
     }
     //---------------------------------------------------------------------
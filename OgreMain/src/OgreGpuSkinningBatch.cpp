@@ -0,0 +1,243 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreGpuSkinningBatch.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreGpuProgramManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+
+namespace Ogre {
+    namespace
+    {
+        /// Number of GpuSkinnedVertexData created, for unique material names
+        uint32 sSkinnedVertexDataCount = 0;
+
+        /// Get the skinning program for a number of weights per vertex, creating it on first use
+        HighLevelGpuProgramPtr getSkinningProgram(unsigned short numWeights, bool normals)
+        {
+            const String name = "Ogre/GpuSkinning/" + StringConverter::toString(numWeights) +
+                (normals ? "N" : "");
+            HighLevelGpuProgramManager& mgr = HighLevelGpuProgramManager::getSingleton();
+            HighLevelGpuProgramPtr program = mgr.getByName(name, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+            if (program)
+                return program;
+
+            // the same transform as Mesh::softwareVertexBlend, rows of 3x4 matrices
+            StringStream source;
+            source <<
+                "#version 150\n"
+                "in vec4 vertex;\n"
+                "in vec4 blendIndices;\n"
+                "in vec4 blendWeights;\n"
+                "uniform vec4 blendMatrices[" << GpuSkinningBatch::MAX_BLEND_MATRICES * 3 << "];\n"
+                "out vec3 oPos;\n";
+            if (normals)
+                source <<
+                    "in vec3 normal;\n"
+                    "out vec3 oNormal;\n";
+            source <<
+                "void main()\n"
+                "{\n"
+                "    vec3 pos = vec3(0.0);\n"
+                "    vec3 norm = vec3(0.0);\n"
+                "    for (int i = 0; i < " << numWeights << "; ++i)\n"
+                "    {\n"
+                "        int m = int(blendIndices[i]) * 3;\n"
+                "        float w = blendWeights[i];\n"
+                "        pos += w * vec3(dot(blendMatrices[m], vertex),\n"
+                "            dot(blendMatrices[m + 1], vertex), dot(blendMatrices[m + 2], vertex));\n";
+            if (normals)
+                source <<
+                    "        norm += w * vec3(dot(blendMatrices[m].xyz, normal),\n"
+                    "            dot(blendMatrices[m + 1].xyz, normal), dot(blendMatrices[m + 2].xyz, normal));\n";
+            source <<
+                "    }\n"
+                "    oPos = pos;\n";
+            if (normals)
+                source << "    oNormal = normalize(norm);\n";
+            source <<
+                "    gl_Position = vec4(pos, 1.0);\n"
+                "}\n";
+
+            program = mgr.createProgram(name, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME,
+                "glsl", GPT_VERTEX_PROGRAM);
+            program->setSource(source.str());
+            program->load();
+            return program;
+        }
+    }
+    //-----------------------------------------------------------------------
+    GpuSkinnedVertexData::GpuSkinnedVertexData(const VertexData* sourceVertexData,
+        const VertexData* renderVertexData)
+        : mSourceVertexData(sourceVertexData)
+        , mVertexData(0)
+        , mOutputSource(0)
+        , mSkinned(false)
+    {
+        const VertexDeclaration* sourceDecl = sourceVertexData->vertexDeclaration;
+        const VertexElement* weights = sourceDecl->findElementBySemantic(VES_BLEND_WEIGHTS);
+        bool normals = sourceDecl->findElementBySemantic(VES_NORMAL) &&
+            renderVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
+
+        mMaterial = MaterialManager::getSingleton().create(
+            "Ogre/GpuSkinning/" + StringConverter::toString(sSkinnedVertexDataCount++),
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+        Pass* pass = mMaterial->getTechnique(0)->getPass(0);
+        pass->setVertexProgram(getSkinningProgram(VertexElement::getTypeCount(weights->getType()),
+            normals)->getName());
+        pass->getVertexProgramParameters()->setIgnoreMissingParams(true);
+
+        // one vertex out for every vertex in
+        mBuffer = HardwareBufferManager::getSingleton().createRenderToVertexBuffer();
+        VertexDeclaration* outputDecl = mBuffer->getVertexDeclaration();
+        outputDecl->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+        if (normals)
+            outputDecl->addElement(0, VertexElement::getTypeSize(VET_FLOAT3), VET_FLOAT3, VES_NORMAL);
+        mBuffer->setOperationType(RenderOperation::OT_POINT_LIST);
+        mBuffer->setMaxVertexCount(static_cast<unsigned int>(sourceVertexData->vertexCount));
+        mBuffer->setResetsEveryUpdate(true);
+        mBuffer->setRenderToBufferMaterialName(mMaterial->getName());
+        mBuffer->setSourceRenderable(this);
+
+        // draw the other elements from the software skinning copy, positions and
+        // normals from the output, keeping the order of the elements
+        mVertexData = renderVertexData->clone(false);
+        mOutputSource = mVertexData->vertexBufferBinding->getNextIndex();
+        VertexDeclaration* decl = mVertexData->vertexDeclaration;
+        for (unsigned short i = 0; i < decl->getElementCount(); ++i)
+        {
+            const VertexElement* elem = decl->getElement(i);
+            if (elem->getSemantic() == VES_POSITION)
+                decl->modifyElement(i, mOutputSource, 0, VET_FLOAT3, VES_POSITION);
+            else if (elem->getSemantic() == VES_NORMAL)
+                decl->modifyElement(i, mOutputSource, VertexElement::getTypeSize(VET_FLOAT3),
+                    VET_FLOAT3, VES_NORMAL);
+        }
+    }
+    //-----------------------------------------------------------------------
+    GpuSkinnedVertexData::~GpuSkinnedVertexData()
+    {
+        mBuffer.reset();
+        OGRE_DELETE mVertexData;
+        if (mMaterial && MaterialManager::getSingletonPtr())
+            MaterialManager::getSingleton().remove(mMaterial);
+    }
+    //-----------------------------------------------------------------------
+    void GpuSkinnedVertexData::update(SceneManager* sceneMgr)
+    {
+        GpuProgramParametersSharedPtr params =
+            mMaterial->getTechnique(0)->getPass(0)->getVertexProgramParameters();
+        params->setNamedConstant("blendMatrices", &mMatrices[0], mMatrices.size() / 4);
+        mBuffer->update(sceneMgr);
+
+        // the buffer written to changes with every update
+        RenderOperation op;
+        mBuffer->getRenderOperation(op);
+        mVertexData->vertexBufferBinding->setBinding(mOutputSource,
+            op.vertexData->vertexBufferBinding->getBuffer(0));
+        mSkinned = true;
+    }
+    //-----------------------------------------------------------------------
+    void GpuSkinnedVertexData::getRenderOperation(RenderOperation& op)
+    {
+        op.operationType = RenderOperation::OT_POINT_LIST;
+        op.useIndexes = false;
+        op.indexData = 0;
+        op.vertexData = const_cast<VertexData*>(mSourceVertexData);
+        op.srcRenderable = this;
+    }
+    //-----------------------------------------------------------------------
+    void GpuSkinnedVertexData::getWorldTransforms(Matrix4* xform) const
+    {
+        *xform = Matrix4::IDENTITY;
+    }
+    //-----------------------------------------------------------------------
+    const LightList& GpuSkinnedVertexData::getLights(void) const
+    {
+        static LightList noLights;
+        return noLights;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    GpuSkinningBatch::GpuSkinningBatch()
+    {
+    }
+    //-----------------------------------------------------------------------
+    GpuSkinningBatch::~GpuSkinningBatch()
+    {
+    }
+    //-----------------------------------------------------------------------
+    bool GpuSkinningBatch::isSupported(const VertexData* sourceVertexData, size_t numMatrices)
+    {
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        const RenderSystemCapabilities* caps = rs ? rs->getCapabilities() : 0;
+        if (!caps || !caps->hasCapability(RSC_HWRENDER_TO_VERTEX_BUFFER) ||
+            !GpuProgramManager::getSingleton().isSyntaxSupported("glsl150"))
+            return false;
+
+        // the output is written from the first vertex of the buffer on
+        const VertexDeclaration* decl = sourceVertexData->vertexDeclaration;
+        return numMatrices <= MAX_BLEND_MATRICES && sourceVertexData->vertexStart == 0 &&
+            decl->findElementBySemantic(VES_POSITION) &&
+            decl->findElementBySemantic(VES_BLEND_INDICES) &&
+            decl->findElementBySemantic(VES_BLEND_WEIGHTS);
+    }
+    //-----------------------------------------------------------------------
+    void GpuSkinningBatch::addSkin(GpuSkinnedVertexData* data, const Matrix4* const* blendMatrices,
+        size_t numMatrices)
+    {
+        data->mMatrices.resize(numMatrices * 12);
+        float* dest = data->mMatrices.empty() ? 0 : &data->mMatrices[0];
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const Matrix4& m = *blendMatrices[i];
+            for (size_t row = 0; row < 3; ++row)
+            {
+                for (size_t col = 0; col < 4; ++col)
+                    *dest++ = static_cast<float>(m[row][col]);
+            }
+        }
+        mPending.push_back(data);
+    }
+    //-----------------------------------------------------------------------
+    void GpuSkinningBatch::flush(SceneManager* sceneMgr)
+    {
+        for (SkinnedVertexDataList::iterator i = mPending.begin(); i != mPending.end(); ++i)
+        {
+            if (!(*i)->mMatrices.empty())
+                (*i)->update(sceneMgr);
+        }
+        mPending.clear();
+    }
+}
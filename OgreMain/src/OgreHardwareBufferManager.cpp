@@ -33,6 +33,16 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+    //-----------------------------------------------------------------------
+    AtomicScalar<size_t> HardwareBuffer::msLockedBytes[HardwareBuffer::LU_COUNT];
+    //-----------------------------------------------------------------------
+    size_t HardwareBuffer::_takeLockedBytes(LockUsage usage)
+    {
+        // leave what is added meanwhile for the next call
+        const size_t bytes = msLockedBytes[usage].load();
+        msLockedBytes[usage] -= bytes;
+        return bytes;
+    }
     //-----------------------------------------------------------------------
     template<> HardwareBufferManager* Singleton<HardwareBufferManager>::msSingleton = 0;
     HardwareBufferManager* HardwareBufferManager::getSingletonPtr(void)
@@ -61,7 +71,7 @@ namespace Ogre {
     const size_t HardwareBufferManagerBase::EXPIRED_DELAY_FRAME_THRESHOLD = 5;
     //-----------------------------------------------------------------------
     HardwareBufferManagerBase::HardwareBufferManagerBase()
-        : mUnderUsedFrameCount(0)
+        : mUnderUsedFrameCount(0), mPoolPageSize(0)
     {
     }
     //-----------------------------------------------------------------------
@@ -75,6 +85,7 @@ namespace Ogre {
         mCounterBuffers.clear();
 
         // Destroy everything
+        destroyAllPools();
         destroyAllDeclarations();
         destroyAllBindings();
         // No need to destroy main buffers - they will be destroyed by removal of bindings
@@ -168,7 +179,7 @@ namespace Ogre {
     HardwareBufferManagerBase::allocateVertexBufferCopy(
         const HardwareVertexBufferSharedPtr& sourceBuffer, 
         BufferLicenseType licenseType, HardwareBufferLicensee* licensee,
-        bool copyData)
+        bool copyData, bool useShadowBuffer)
     {
         // pre-lock the mVertexBuffers mutex, which would usually get locked in
         //  makeBufferCopy / createVertexBuffer
@@ -179,16 +190,20 @@ namespace Ogre {
                     OGRE_LOCK_MUTEX(mTempBuffersMutex);
             HardwareVertexBufferSharedPtr vbuf;
 
-            // Locate existing buffer copy in temporary vertex buffers
-            FreeTemporaryVertexBufferMap::iterator i = 
-                mFreeTempVertexBufferMap.find(sourceBuffer.get());
-            if (i == mFreeTempVertexBufferMap.end())
+            // Locate existing buffer copy in temporary vertex buffers, with the
+            // same shadowing
+            std::pair<FreeTemporaryVertexBufferMap::iterator, FreeTemporaryVertexBufferMap::iterator>
+                range = mFreeTempVertexBufferMap.equal_range(sourceBuffer.get());
+            FreeTemporaryVertexBufferMap::iterator i = range.first;
+            while (i != range.second && i->second->hasShadowBuffer() != useShadowBuffer)
+                ++i;
+            if (i == range.second)
             {
-                // copy buffer, use shadow buffer and make dynamic
+                // copy buffer and make dynamic
                 vbuf = makeBufferCopy(
                     sourceBuffer, 
                     HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, 
-                    true);
+                    useShadowBuffer);
             }
             else
             {
@@ -423,6 +438,205 @@ namespace Ogre {
     {
     }
     //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::setPoolPageSize(size_t bytes)
+    {
+        OGRE_LOCK_MUTEX(mPoolsMutex);
+        // Existing pages keep their size, the new size applies to pages added from now on
+        mPoolPageSize = bytes;
+    }
+    //-----------------------------------------------------------------------
+    bool HardwareBufferManagerBase::createPooledVertexData(VertexData* vertexData,
+        HardwareBuffer::Usage usage, bool useShadowBuffer)
+    {
+        if (mPoolPageSize == 0 || vertexData->vertexCount == 0 ||
+            vertexData->vertexDeclaration->getElementCount() == 0)
+            return false;
+
+        if (vertexData->mPoolMgr)
+            vertexData->mPoolMgr->_releasePooledVertexData(vertexData);
+
+        // The layout of the pool, all sources share the same range of vertices
+        const VertexDeclaration* decl = vertexData->vertexDeclaration;
+        unsigned short numSources = decl->getMaxSource() + 1;
+        vector<size_t>::type key;
+        size_t vertexSize = 0;
+        for (unsigned short s = 0; s < numSources; ++s)
+        {
+            key.push_back(decl->getVertexSize(s));
+            vertexSize += key.back();
+        }
+        key.push_back(usage);
+        key.push_back(useShadowBuffer);
+
+        OGRE_LOCK_MUTEX(mPoolsMutex);
+        size_t start;
+        PoolPage* page = allocatePoolRange(mVertexPools[key], vertexData->vertexCount, vertexSize, start);
+        if (page->vertexBuffers.empty())
+        {
+            page->vertexBuffers.resize(numSources);
+            for (unsigned short s = 0; s < numSources; ++s)
+            {
+                if (key[s] == 0)
+                    continue;
+                page->vertexBuffers[s] = createVertexBuffer(key[s], page->size, usage, useShadowBuffer);
+                mPoolPageOwners[page->vertexBuffers[s].get()] = page;
+            }
+        }
+
+        for (unsigned short s = 0; s < numSources; ++s)
+        {
+            if (page->vertexBuffers[s])
+                vertexData->vertexBufferBinding->setBinding(s, page->vertexBuffers[s]);
+        }
+        vertexData->vertexStart = start;
+        vertexData->mPoolMgr = this;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    bool HardwareBufferManagerBase::createPooledIndexData(IndexData* indexData,
+        HardwareIndexBuffer::IndexType itype, HardwareBuffer::Usage usage, bool useShadowBuffer)
+    {
+        if (mPoolPageSize == 0 || indexData->indexCount == 0)
+            return false;
+
+        if (indexData->mPoolMgr)
+            indexData->mPoolMgr->_releasePooledIndexData(indexData);
+
+        vector<size_t>::type key;
+        key.push_back(itype);
+        key.push_back(usage);
+        key.push_back(useShadowBuffer);
+        size_t indexSize = itype == HardwareIndexBuffer::IT_32BIT ? sizeof(uint32) : sizeof(uint16);
+
+        OGRE_LOCK_MUTEX(mPoolsMutex);
+        size_t start;
+        PoolPage* page = allocatePoolRange(mIndexPools[key], indexData->indexCount, indexSize, start);
+        if (!page->indexBuffer)
+        {
+            page->indexBuffer = createIndexBuffer(itype, page->size, usage, useShadowBuffer);
+            mPoolPageOwners[page->indexBuffer.get()] = page;
+        }
+
+        indexData->indexBuffer = page->indexBuffer;
+        indexData->indexStart = start;
+        indexData->mPoolMgr = this;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::_releasePooledVertexData(VertexData* vertexData)
+    {
+        OGRE_LOCK_MUTEX(mPoolsMutex);
+        const VertexBufferBinding::VertexBufferBindingMap& bindings =
+            vertexData->vertexBufferBinding->getBindings();
+        VertexBufferBinding::VertexBufferBindingMap::const_iterator i;
+        for (i = bindings.begin(); i != bindings.end(); ++i)
+        {
+            PoolPageOwnerMap::iterator owner = mPoolPageOwners.find(i->second.get());
+            if (owner != mPoolPageOwners.end())
+            {
+                releasePoolRange(owner->second, vertexData->vertexStart);
+                break;
+            }
+        }
+        vertexData->mPoolMgr = 0;
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::_releasePooledIndexData(IndexData* indexData)
+    {
+        OGRE_LOCK_MUTEX(mPoolsMutex);
+        PoolPageOwnerMap::iterator owner = mPoolPageOwners.find(indexData->indexBuffer.get());
+        if (owner != mPoolPageOwners.end())
+            releasePoolRange(owner->second, indexData->indexStart);
+        indexData->mPoolMgr = 0;
+    }
+    //-----------------------------------------------------------------------
+    HardwareBufferManagerBase::PoolPage* HardwareBufferManagerBase::allocatePoolRange(
+        PoolPageList& pool, size_t count, size_t unitSize, size_t& start)
+    {
+        // First fit, pages are few and their free ranges get merged on release
+        for (PoolPageList::iterator p = pool.begin(); p != pool.end(); ++p)
+        {
+            PoolRangeMap& freeRanges = (*p)->freeRanges;
+            for (PoolRangeMap::iterator r = freeRanges.begin(); r != freeRanges.end(); ++r)
+            {
+                if (r->second < count)
+                    continue;
+
+                start = r->first;
+                if (r->second > count)
+                    freeRanges[start + count] = r->second - count;
+                freeRanges.erase(r);
+                (*p)->usedRanges[start] = count;
+                return *p;
+            }
+        }
+
+        // No page has room, the caller creates the buffers of the new one
+        PoolPage* page = OGRE_NEW PoolPage();
+        page->pool = &pool;
+        page->size = std::max(count, mPoolPageSize / unitSize);
+        if (page->size > count)
+            page->freeRanges[count] = page->size - count;
+        page->usedRanges[0] = count;
+        pool.push_back(page);
+        start = 0;
+        return page;
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::releasePoolRange(PoolPage* page, size_t start)
+    {
+        PoolRangeMap::iterator used = page->usedRanges.find(start);
+        if (used == page->usedRanges.end())
+            return;
+        size_t count = used->second;
+        page->usedRanges.erase(used);
+
+        if (page->usedRanges.empty())
+        {
+            for (size_t i = 0; i < page->vertexBuffers.size(); ++i)
+                mPoolPageOwners.erase(page->vertexBuffers[i].get());
+            mPoolPageOwners.erase(page->indexBuffer.get());
+            page->pool->remove(page);
+            OGRE_DELETE page;
+            return;
+        }
+
+        // Merge with the free ranges on either side
+        PoolRangeMap::iterator next = page->freeRanges.lower_bound(start);
+        if (next != page->freeRanges.end() && next->first == start + count)
+        {
+            count += next->second;
+            page->freeRanges.erase(next);
+        }
+        PoolRangeMap::iterator prev = page->freeRanges.lower_bound(start);
+        if (prev != page->freeRanges.begin())
+        {
+            --prev;
+            if (prev->first + prev->second == start)
+            {
+                prev->second += count;
+                return;
+            }
+        }
+        page->freeRanges[start] = count;
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::destroyAllPools(void)
+    {
+        OGRE_LOCK_MUTEX(mPoolsMutex);
+        PoolMap* pools[2] = { &mVertexPools, &mIndexPools };
+        for (int i = 0; i < 2; ++i)
+        {
+            for (PoolMap::iterator p = pools[i]->begin(); p != pools[i]->end(); ++p)
+            {
+                for (PoolPageList::iterator page = p->second.begin(); page != p->second.end(); ++page)
+                    OGRE_DELETE *page;
+            }
+            pools[i]->clear();
+        }
+        mPoolPageOwners.clear();
+    }
+    //-----------------------------------------------------------------------
     HardwareVertexBufferSharedPtr 
     HardwareBufferManagerBase::makeBufferCopy(
         const HardwareVertexBufferSharedPtr& source,
@@ -474,6 +688,7 @@ namespace Ogre {
         {
             posNormalShareBuffer = false;
             srcNormalBuffer.reset();
+            blendedElementsOnly = srcPositionBuffer->getVertexSize() == posElem->getSize();
         }
         else
         {
@@ -482,29 +697,44 @@ namespace Ogre {
             {
                 posNormalShareBuffer = true;
                 srcNormalBuffer.reset();
+                blendedElementsOnly =
+                    srcPositionBuffer->getVertexSize() == posElem->getSize() + normElem->getSize();
             }
             else
             {
                 posNormalShareBuffer = false;
                 srcNormalBuffer = bind->getBuffer(normBindIndex);
+                blendedElementsOnly = srcPositionBuffer->getVertexSize() == posElem->getSize() &&
+                    srcNormalBuffer->getVertexSize() == normElem->getSize();
             }
         }
     }
     //-----------------------------------------------------------------------------
-    void TempBlendedBufferInfo::checkoutTempCopies(bool positions, bool normals)
+    void TempBlendedBufferInfo::checkoutTempCopies(bool positions, bool normals, bool useShadowBuffer)
     {
         bindPositions = positions;
         bindNormals = normals;
 
+        // Blending into part of a vertex keeps the rest of it, which has to be read back
+        if (!blendedElementsOnly || (posNormalShareBuffer && !normals))
+            useShadowBuffer = true;
+
+        // Copies without a shadow buffer cannot be read back, so give them up if
+        // that is needed now (releasing them clears the pointers through licenseExpired)
+        if (useShadowBuffer && destPositionBuffer && !destPositionBuffer->hasShadowBuffer())
+            destPositionBuffer->getManager()->releaseVertexBufferCopy(destPositionBuffer);
+        if (useShadowBuffer && destNormalBuffer && !destNormalBuffer->hasShadowBuffer())
+            destNormalBuffer->getManager()->releaseVertexBufferCopy(destNormalBuffer);
+
         if (positions && !destPositionBuffer)
         {
             destPositionBuffer = srcPositionBuffer->getManager()->allocateVertexBufferCopy(srcPositionBuffer, 
-                HardwareBufferManagerBase::BLT_AUTOMATIC_RELEASE, this);
+                HardwareBufferManagerBase::BLT_AUTOMATIC_RELEASE, this, false, useShadowBuffer);
         }
         if (normals && !posNormalShareBuffer && srcNormalBuffer && !destNormalBuffer)
         {
             destNormalBuffer = srcNormalBuffer->getManager()->allocateVertexBufferCopy(srcNormalBuffer, 
-                HardwareBufferManagerBase::BLT_AUTOMATIC_RELEASE, this);
+                HardwareBufferManagerBase::BLT_AUTOMATIC_RELEASE, this, false, useShadowBuffer);
         }
     }
     //-----------------------------------------------------------------------------
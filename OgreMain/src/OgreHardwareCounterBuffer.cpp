@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "OgreHardwareCounterBuffer.h"
 #include "OgreHardwareBufferManager.h"
 #include "OgreDefaultHardwareBufferManager.h"
+#include "OgreMemoryStats.h"
 
 namespace Ogre {
 
@@ -40,6 +41,7 @@ namespace Ogre {
     {
         // Calculate the size of the vertices
         mSizeInBytes = sizeBytes;
+        MemoryStats::_recordAlloc(MemoryStats::POOL_HARDWARE_BUFFERS, mSizeInBytes, mSystemMemory);
 
         // Create a shadow buffer if required
         if (mUseShadowBuffer)
@@ -50,6 +52,7 @@ namespace Ogre {
     
     HardwareCounterBuffer::~HardwareCounterBuffer()
     {
+        MemoryStats::_recordDealloc(MemoryStats::POOL_HARDWARE_BUFFERS, mSizeInBytes, mSystemMemory);
         if (mMgr)
         {
             mMgr->_notifyCounterBufferDestroyed(this);
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreHardwareIndexBuffer.h"
 #include "OgreHardwareBufferManager.h"
 #include "OgreDefaultHardwareBufferManager.h"
+#include "OgreMemoryStats.h"
 
 
 namespace Ogre {
@@ -53,6 +54,7 @@ namespace Ogre {
             break;
         }
         mSizeInBytes = mIndexSize * mNumIndexes;
+        MemoryStats::_recordAlloc(MemoryStats::POOL_HARDWARE_BUFFERS, mSizeInBytes, mSystemMemory);
 
         // Create a shadow buffer if required
         if (mUseShadowBuffer)
@@ -66,6 +68,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     HardwareIndexBuffer::~HardwareIndexBuffer()
     {
+        MemoryStats::_recordDealloc(MemoryStats::POOL_HARDWARE_BUFFERS, mSizeInBytes, mSystemMemory);
         if (mMgr)
         {
             mMgr->_notifyIndexBufferDestroyed(this);
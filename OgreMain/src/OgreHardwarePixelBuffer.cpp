@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreHardwarePixelBuffer.h"
+#include "OgreAsyncReadback.h"
 #include "OgreImage.h"
 #include "OgreException.h"
 
@@ -154,6 +155,15 @@ namespace Ogre
         );
     }
     //-----------------------------------------------------------------------------    
+    AsyncReadbackPtr HardwarePixelBuffer::blitToMemoryAsync(const Box &srcBox)
+    {
+        MemoryAsyncReadback* readback = OGRE_NEW MemoryAsyncReadback(
+            srcBox.getWidth(), srcBox.getHeight(), srcBox.getDepth(), mFormat);
+        AsyncReadbackPtr ticket(readback);
+        blitToMemory(srcBox, readback->getPixelBox());
+        return ticket;
+    }
+    //-----------------------------------------------------------------------------    
     void HardwarePixelBuffer::readData(size_t offset, size_t length, void* pDest)
     {
         // TODO
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "OgreHardwareUniformBuffer.h"
 #include "OgreHardwareBufferManager.h"
 #include "OgreDefaultHardwareBufferManager.h"
+#include "OgreMemoryStats.h"
 
 namespace Ogre {
 
@@ -41,6 +42,7 @@ namespace Ogre {
     {
         // Calculate the size of the vertices
         mSizeInBytes = sizeBytes;
+        MemoryStats::_recordAlloc(MemoryStats::POOL_HARDWARE_BUFFERS, mSizeInBytes, mSystemMemory);
 
         // Create a shadow buffer if required
         if (mUseShadowBuffer)
@@ -51,6 +53,7 @@ namespace Ogre {
     
     HardwareUniformBuffer::~HardwareUniformBuffer()
     {
+        MemoryStats::_recordDealloc(MemoryStats::POOL_HARDWARE_BUFFERS, mSizeInBytes, mSystemMemory);
         if (mMgr)
         {
             mMgr->_notifyUniformBufferDestroyed(this);
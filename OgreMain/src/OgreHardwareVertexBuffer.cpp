@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgreHardwareBufferManager.h"
 #include "OgreDefaultHardwareBufferManager.h"
+#include "OgreMemoryStats.h"
 #include "OgreRoot.h"
 #include "OgreRenderSystem.h"
 
@@ -49,6 +50,7 @@ namespace Ogre {
     {
         // Calculate the size of the vertices
         mSizeInBytes = mVertexSize * numVertices;
+        MemoryStats::_recordAlloc(MemoryStats::POOL_HARDWARE_BUFFERS, mSizeInBytes, mSystemMemory);
 
         // Create a shadow buffer if required
         if (mUseShadowBuffer)
@@ -61,6 +63,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     HardwareVertexBuffer::~HardwareVertexBuffer()
     {
+        MemoryStats::_recordDealloc(MemoryStats::POOL_HARDWARE_BUFFERS, mSizeInBytes, mSystemMemory);
         if (mMgr)
         {
             mMgr->_notifyVertexBufferDestroyed(this);
@@ -155,6 +158,7 @@ namespace Ogre {
         case VET_SHORT2_NORM:
         case VET_USHORT2:
         case VET_USHORT2_NORM:
+        case VET_HALF2:
             return sizeof( short ) * 2;
         case VET_SHORT3:
         case VET_USHORT3:
@@ -163,6 +167,7 @@ namespace Ogre {
         case VET_SHORT4_NORM:
         case VET_USHORT4:
         case VET_USHORT4_NORM:
+        case VET_HALF4:
             return sizeof( short ) * 4;
         case VET_INT1:
         case VET_UINT1:
@@ -204,6 +209,7 @@ namespace Ogre {
         case VET_SHORT2_NORM:
         case VET_USHORT2:
         case VET_USHORT2_NORM:
+        case VET_HALF2:
         case VET_UINT2:
         case VET_INT2:
         case VET_DOUBLE2:
@@ -220,6 +226,7 @@ namespace Ogre {
         case VET_SHORT4_NORM:
         case VET_USHORT4:
         case VET_USHORT4_NORM:
+        case VET_HALF4:
         case VET_UINT4:
         case VET_INT4:
         case VET_DOUBLE4:
@@ -277,6 +284,13 @@ namespace Ogre {
             }
             return VET_USHORT4_NORM;
 
+        case VET_HALF2:
+            if ( count <= 2 )
+            {
+                return VET_HALF2;
+            }
+            return VET_HALF4;
+
         case VET_BYTE4:
         case VET_BYTE4_NORM:
         case VET_UBYTE4:
@@ -386,6 +400,9 @@ namespace Ogre {
             case VET_USHORT2_NORM:
             case VET_USHORT4_NORM:
                 return VET_USHORT2_NORM;
+            case VET_HALF2:
+            case VET_HALF4:
+                return VET_HALF2;
             case VET_BYTE4:
                 return VET_BYTE4;
             case VET_BYTE4_NORM:
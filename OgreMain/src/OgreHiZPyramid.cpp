@@ -0,0 +1,239 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreHiZPyramid.h"
+#include "OgreAsyncReadback.h"
+#include "OgreCompositorManager.h"
+#include "OgreGpuProgramManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreMaterialManager.h"
+#include "OgrePass.h"
+#include "OgreRenderTexture.h"
+#include "OgreSceneManager.h"
+#include "OgreTechnique.h"
+#include "OgreTextureManager.h"
+#include "OgreViewport.h"
+
+namespace Ogre {
+    namespace
+    {
+        /// Get a program of the pyramid, creating it on first use
+        const String& getPyramidProgram(const String& name, GpuProgramType type, const char* source)
+        {
+            HighLevelGpuProgramManager& mgr = HighLevelGpuProgramManager::getSingleton();
+            HighLevelGpuProgramPtr program = mgr.getByName(name, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+            if (!program)
+            {
+                program = mgr.createProgram(name, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME,
+                    "glsl", type);
+                program->setSource(source);
+                program->load();
+            }
+            return program->getName();
+        }
+
+        const char* sQuadSource =
+            "#version 150\n"
+            "in vec4 vertex;\n"
+            "void main()\n"
+            "{\n"
+            "    gl_Position = vertex;\n"
+            "}\n";
+
+        const char* sCopySource =
+            "#version 150\n"
+            "uniform sampler2D src;\n"
+            "out vec4 fragColour;\n"
+            "void main()\n"
+            "{\n"
+            "    fragColour = vec4(texelFetch(src, ivec2(gl_FragCoord.xy), 0).r);\n"
+            "}\n";
+
+        // every texel takes the 2x2 texels above it, with an odd size the last
+        // texels take the row or column left over as well
+        const char* sReduceSource =
+            "#version 150\n"
+            "uniform sampler2D src;\n"
+            "out vec4 fragColour;\n"
+            "float fetch(ivec2 p, ivec2 last)\n"
+            "{\n"
+            "    return texelFetch(src, min(p, last), 0).r;\n"
+            "}\n"
+            "void main()\n"
+            "{\n"
+            "    ivec2 last = textureSize(src, 0) - 1;\n"
+            "    ivec2 p = ivec2(gl_FragCoord.xy) * 2;\n"
+            "    float d = max(max(fetch(p, last), fetch(p + ivec2(1, 0), last)),\n"
+            "        max(fetch(p + ivec2(0, 1), last), fetch(p + ivec2(1, 1), last)));\n"
+            "    bool extraX = p.x + 2 == last.x;\n"
+            "    bool extraY = p.y + 2 == last.y;\n"
+            "    if (extraX)\n"
+            "        d = max(d, max(fetch(p + ivec2(2, 0), last), fetch(p + ivec2(2, 1), last)));\n"
+            "    if (extraY)\n"
+            "        d = max(d, max(fetch(p + ivec2(0, 2), last), fetch(p + ivec2(1, 2), last)));\n"
+            "    if (extraX && extraY)\n"
+            "        d = max(d, fetch(p + ivec2(2, 2), last));\n"
+            "    fragColour = vec4(d);\n"
+            "}\n";
+
+        /// Updates the pyramid of a compositor texture
+        class RSHiZOperation : public CompositorInstance::RenderSystemOperation
+        {
+        public:
+            RSHiZOperation(const String& name, const TexturePtr& depth) : mPyramid(name, depth) {}
+
+            virtual void execute(SceneManager* sm, RenderSystem* rs)
+            {
+                mPyramid.update(sm);
+            }
+
+        protected:
+            HiZPyramid mPyramid;
+        };
+    }
+    //-----------------------------------------------------------------------
+    HiZPyramid::HiZPyramid(const String& name, const TexturePtr& depth)
+        : mName(name)
+        , mSource(depth)
+    {
+        if (!isSupported())
+        {
+            OGRE_EXCEPT(Exception::ERR_RENDERINGAPI_ERROR,
+                "Hi-Z pyramids need GLSL 1.50 support", "HiZPyramid::HiZPyramid");
+        }
+
+        const String& quadProgram = getPyramidProgram("Ogre/HiZ/QuadVP", GPT_VERTEX_PROGRAM, sQuadSource);
+        const String& copyProgram = getPyramidProgram("Ogre/HiZ/CopyFP", GPT_FRAGMENT_PROGRAM, sCopySource);
+        const String& reduceProgram = getPyramidProgram("Ogre/HiZ/ReduceFP", GPT_FRAGMENT_PROGRAM, sReduceSource);
+
+        uint32 width = depth->getWidth();
+        uint32 height = depth->getHeight();
+        TexturePtr above = depth;
+        while (true)
+        {
+            const String levelName = mName + "/" + StringConverter::toString(mLevels.size());
+            TexturePtr level = TextureManager::getSingleton().createManual(levelName,
+                ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, TEX_TYPE_2D,
+                width, height, 0, PF_FLOAT32_R, TU_RENDERTARGET);
+
+            // only rendered to by update
+            RenderTarget* target = level->getBuffer()->getRenderTarget();
+            target->setAutoUpdated(false);
+            Viewport* vp = target->addViewport(0);
+            vp->setClearEveryFrame(false);
+
+            MaterialPtr mat = MaterialManager::getSingleton().create(levelName,
+                ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+            Pass* pass = mat->getTechnique(0)->getPass(0);
+            pass->setCullingMode(CULL_NONE);
+            pass->setDepthCheckEnabled(false);
+            pass->setDepthWriteEnabled(false);
+            pass->setLightingEnabled(false);
+            pass->setVertexProgram(quadProgram);
+            pass->setFragmentProgram(mLevels.empty() ? copyProgram : reduceProgram);
+            TextureUnitState* tus = pass->createTextureUnitState();
+            tus->setTexture(above);
+            tus->setTextureFiltering(TFO_NONE);
+            tus->setTextureAddressingMode(TextureUnitState::TAM_CLAMP);
+            mat->load();
+
+            mLevels.push_back(level);
+            mViewports.push_back(vp);
+            mMaterials.push_back(mat);
+
+            if (width == 1 && height == 1)
+                break;
+            width = std::max<uint32>(1, width / 2);
+            height = std::max<uint32>(1, height / 2);
+            above = level;
+        }
+    }
+    //-----------------------------------------------------------------------
+    HiZPyramid::~HiZPyramid()
+    {
+        for (size_t i = 0; i < mLevels.size(); ++i)
+        {
+            MaterialManager::getSingleton().remove(mMaterials[i]);
+            TextureManager::getSingleton().remove(mLevels[i]);
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool HiZPyramid::isSupported(void)
+    {
+        return GpuProgramManager::getSingleton().isSyntaxSupported("glsl150");
+    }
+    //-----------------------------------------------------------------------
+    const TexturePtr& HiZPyramid::getLevel(size_t level) const
+    {
+        if (level >= mLevels.size())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Level index out of bounds", "HiZPyramid::getLevel");
+        }
+        return mLevels[level];
+    }
+    //-----------------------------------------------------------------------
+    void HiZPyramid::update(SceneManager* sceneMgr)
+    {
+        RenderSystem* rs = sceneMgr->getDestinationRenderSystem();
+        Viewport* previous = rs->_getViewport();
+
+        for (size_t i = 0; i < mLevels.size(); ++i)
+        {
+            rs->_setViewport(mViewports[i]);
+            Renderable* rect = CompositorManager::getSingleton()._getTexturedRectangle2D();
+            sceneMgr->_injectRenderWithPass(mMaterials[i]->getTechnique(0)->getPass(0), rect, false);
+        }
+
+        rs->_setViewport(previous);
+    }
+    //-----------------------------------------------------------------------
+    AsyncReadbackPtr HiZPyramid::requestReadback(size_t level) const
+    {
+        const TexturePtr& tex = getLevel(level);
+        return tex->getBuffer()->blitToMemoryAsync(Box(0, 0, tex->getWidth(), tex->getHeight()));
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    CompositorInstance::RenderSystemOperation* HiZCompositionPass::createOperation(
+        CompositorInstance* instance, const CompositionPass* pass)
+    {
+        if (pass->getNumInputs() == 0 || pass->getInput(0).name.empty())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "The HiZ pass needs the depth texture as input 0", "HiZCompositionPass::createOperation");
+        }
+
+        const CompositionPass::InputTex& input = pass->getInput(0);
+        const String& texName = instance->getTextureInstanceName(input.name, input.mrtIndex);
+        return OGRE_NEW RSHiZOperation(texName + "/HiZ",
+            TextureManager::getSingleton().getByName(texName));
+    }
+}
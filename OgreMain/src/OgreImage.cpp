@@ -32,12 +32,63 @@ THE SOFTWARE.
 #include "OgreColourValue.h"
 #include "OgreMath.h"
 #include "OgreImageResampler.h"
+#include "OgreImageCompressor.h"
 #include "OgreResourceGroupManager.h"
+#include "Threading/OgreParallel.h"
 
 namespace Ogre {
     ImageCodec::~ImageCodec() {
     }
 
+    namespace {
+        /// Resamples bands of destination rows on separate threads
+        template<typename Resampler> class ResampleJob : public ParallelJob
+        {
+            PixelBox mSrc;
+            PixelBox mDst;
+        public:
+            ResampleJob(const PixelBox& src, const PixelBox& dst, size_t grainSize)
+                : ParallelJob(dst.getHeight(), grainSize), mSrc(src), mDst(dst) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                Resampler::scale(mSrc, mDst, begin, end);
+            }
+        };
+
+        /// Rows resampled per chunk are chosen to give each chunk at least this many pixels
+        const size_t RESAMPLE_PIXELS_PER_CHUNK = 16384;
+
+        template<typename Resampler> void resample(const PixelBox& src, const PixelBox& dst)
+        {
+            size_t rowPixels = dst.getWidth() * dst.getDepth();
+            size_t grainSize = (RESAMPLE_PIXELS_PER_CHUNK + rowPixels - 1) / rowPixels;
+            if (grainSize >= dst.getHeight())
+            {
+                // too small to be worth spreading over threads
+                Resampler::scale(src, dst);
+                return;
+            }
+            ParallelJob::run(ParallelJobPtr(OGRE_NEW ResampleJob<Resampler>(src, dst, grainSize)));
+        }
+
+        /// Compresses rows of blocks on separate threads
+        class CompressJob : public ParallelJob
+        {
+            PixelBox mSrc;
+            PixelBox mDst;
+        public:
+            CompressJob(const PixelBox& src, const PixelBox& dst)
+                : ParallelJob((src.getHeight() + 3) / 4, std::max<size_t>(1, 256 / ((src.getWidth() + 3) / 4))),
+                  mSrc(src), mDst(dst) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                BlockCompressor::compress(mSrc, mDst, begin, end);
+            }
+        };
+    }
+
     //-----------------------------------------------------------------------------
     Image::Image()
         : mWidth(0),
@@ -556,6 +607,88 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------------
+    Image& Image::generateMipmaps(uint32 numMipmaps, Filter filter)
+    {
+        if (PixelUtil::isCompressed(mFormat))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Can not generate mipmaps of compressed images", "Image::generateMipmaps");
+        }
+
+        uint32 maxMipmaps = 0;
+        for (uint32 size = std::max(std::max(mWidth, mHeight), mDepth); size > 1; size /= 2)
+            ++maxMipmaps;
+        numMipmaps = std::min(numMipmaps, maxMipmaps);
+        if (numMipmaps <= mNumMipmaps)
+            return *this;
+
+        size_t faces = getNumFaces();
+        size_t size = calculateSize(numMipmaps, faces, mWidth, mHeight, mDepth, mFormat);
+        uchar* data = OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL);
+
+        Image result;
+        result.loadDynamicImage(data, mWidth, mHeight, mDepth, mFormat, false, faces, numMipmaps);
+        for (size_t face = 0; face < faces; ++face)
+        {
+            for (uint32 mip = 0; mip <= numMipmaps; ++mip)
+            {
+                if (mip <= mNumMipmaps)
+                    PixelUtil::bulkPixelConversion(getPixelBox(face, mip), result.getPixelBox(face, mip));
+                else
+                    scale(result.getPixelBox(face, mip - 1), result.getPixelBox(face, mip), filter);
+            }
+        }
+
+        return loadDynamicImage(data, mWidth, mHeight, mDepth, mFormat, true, faces, numMipmaps);
+    }
+    //-----------------------------------------------------------------------------
+    bool Image::isCompressionSupported(PixelFormat format)
+    {
+        return format == PF_DXT1 || format == PF_DXT5 ||
+               format == PF_ETC1_RGB8 || format == PF_ETC2_RGB8;
+    }
+    //-----------------------------------------------------------------------------
+    Image& Image::compress(PixelFormat format)
+    {
+        if (!isCompressionSupported(format))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Can not compress to " + PixelUtil::getFormatName(format), "Image::compress");
+        }
+        if (PixelUtil::isCompressed(mFormat) || mDepth > 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Only uncompressed 2D images and cube maps can be compressed", "Image::compress");
+        }
+
+        size_t faces = getNumFaces();
+        size_t size = calculateSize(mNumMipmaps, faces, mWidth, mHeight, 1, format);
+        uchar* data = OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL);
+
+        Image result;
+        result.loadDynamicImage(data, mWidth, mHeight, 1, format, false, faces, mNumMipmaps);
+        for (size_t face = 0; face < faces; ++face)
+        {
+            for (uint32 mip = 0; mip <= mNumMipmaps; ++mip)
+            {
+                PixelBox src = getPixelBox(face, mip);
+                MemoryDataStreamPtr buf;
+                if (src.format != PF_BYTE_RGBA)
+                {
+                    // the encoders read bytes in RGBA order
+                    PixelBox rgba(src.getWidth(), src.getHeight(), 1, PF_BYTE_RGBA);
+                    buf.reset(OGRE_NEW MemoryDataStream(rgba.getConsecutiveSize()));
+                    rgba.data = buf->getPtr();
+                    PixelUtil::bulkPixelConversion(src, rgba);
+                    src = rgba;
+                }
+                ParallelJob::run(ParallelJobPtr(OGRE_NEW CompressJob(src, result.getPixelBox(face, mip))));
+            }
+        }
+
+        return loadDynamicImage(data, mWidth, mHeight, 1, format, true, faces, mNumMipmaps);
+    }
+    //-----------------------------------------------------------------------------
     void Image::resize(ushort width, ushort height, Filter filter)
     {
         // resizing dynamic images is not supported
@@ -603,14 +736,14 @@ namespace Ogre {
             // super-optimized: no conversion
             switch (PixelUtil::getNumElemBytes(src.format)) 
             {
-            case 1: NearestResampler<1>::scale(src, temp); break;
-            case 2: NearestResampler<2>::scale(src, temp); break;
-            case 3: NearestResampler<3>::scale(src, temp); break;
-            case 4: NearestResampler<4>::scale(src, temp); break;
-            case 6: NearestResampler<6>::scale(src, temp); break;
-            case 8: NearestResampler<8>::scale(src, temp); break;
-            case 12: NearestResampler<12>::scale(src, temp); break;
-            case 16: NearestResampler<16>::scale(src, temp); break;
+            case 1: resample<NearestResampler<1> >(src, temp); break;
+            case 2: resample<NearestResampler<2> >(src, temp); break;
+            case 3: resample<NearestResampler<3> >(src, temp); break;
+            case 4: resample<NearestResampler<4> >(src, temp); break;
+            case 6: resample<NearestResampler<6> >(src, temp); break;
+            case 8: resample<NearestResampler<8> >(src, temp); break;
+            case 12: resample<NearestResampler<12> >(src, temp); break;
+            case 16: resample<NearestResampler<16> >(src, temp); break;
             default:
                 // never reached
                 assert(false);
@@ -646,10 +779,10 @@ namespace Ogre {
                 // super-optimized: byte-oriented math, no conversion
                 switch (PixelUtil::getNumElemBytes(src.format)) 
                 {
-                case 1: LinearResampler_Byte<1>::scale(src, temp); break;
-                case 2: LinearResampler_Byte<2>::scale(src, temp); break;
-                case 3: LinearResampler_Byte<3>::scale(src, temp); break;
-                case 4: LinearResampler_Byte<4>::scale(src, temp); break;
+                case 1: resample<LinearResampler_Byte<1> >(src, temp); break;
+                case 2: resample<LinearResampler_Byte<2> >(src, temp); break;
+                case 3: resample<LinearResampler_Byte<3> >(src, temp); break;
+                case 4: resample<LinearResampler_Byte<4> >(src, temp); break;
                 default:
                     // never reached
                     assert(false);
@@ -665,13 +798,13 @@ namespace Ogre {
                 if (scaled.format == PF_FLOAT32_RGB || scaled.format == PF_FLOAT32_RGBA)
                 {
                     // float32 to float32, avoid unpack/repack overhead
-                    LinearResampler_Float32::scale(src, scaled);
+                    resample<LinearResampler_Float32>(src, scaled);
                     break;
                 }
                 // else, fall through
             default:
                 // non-optimized: floating-point math, performs conversion but always works
-                LinearResampler::scale(src, scaled);
+                resample<LinearResampler>(src, scaled);
             }
             break;
         }
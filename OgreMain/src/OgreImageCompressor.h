@@ -0,0 +1,282 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef OGREIMAGECOMPRESSOR_H
+#define OGREIMAGECOMPRESSOR_H
+
+#include <algorithm>
+#include <climits>
+
+// this file is inlined into OgreImage.cpp!
+// do not include anywhere else.
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Image
+    *  @{
+    */
+
+// block encoders, all take the 16 texels of a 4x4 block in row major order
+// as bytes in PF_BYTE_RGBA order, and write one block of the target format.
+// they aim for speed rather than the best possible quality.
+
+// pack a colour to 5:6:5 and expand it back to 8 bits per channel
+inline uint16 packRGB565(const int* rgb) {
+    return static_cast<uint16>(((rgb[0] * 31 + 127) / 255) << 11 |
+                               ((rgb[1] * 63 + 127) / 255) << 5 |
+                               ((rgb[2] * 31 + 127) / 255));
+}
+inline void unpackRGB565(uint16 c, int* rgb) {
+    int r = c >> 11, g = (c >> 5) & 0x3F, b = c & 0x1F;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+// BC1 colour block. endpoints are the extremes of the texels along the
+// principal axis of their colours, indices pick the closest palette entry
+inline void encodeBC1Colour(const uchar* texels, uchar* block) {
+    // mean and covariance of the colours
+    float mean[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < 3; ++c)
+            mean[c] += texels[i * 4 + c];
+    for (int c = 0; c < 3; ++c)
+        mean[c] /= 16.0f;
+
+    float cov[6] = { 0, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < 16; ++i) {
+        float r = texels[i * 4] - mean[0], g = texels[i * 4 + 1] - mean[1], b = texels[i * 4 + 2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    // principal axis by power iteration
+    float axis[3] = { 1, 1, 1 };
+    for (int iter = 0; iter < 4; ++iter) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float len = std::max(std::max(std::abs(x), std::abs(y)), std::abs(z));
+        if (len == 0)
+            break;
+        axis[0] = x / len; axis[1] = y / len; axis[2] = z / len;
+    }
+
+    // extremes along the axis
+    int minIdx = 0, maxIdx = 0;
+    float minDot = 1e30f, maxDot = -1e30f;
+    for (int i = 0; i < 16; ++i) {
+        float d = texels[i * 4] * axis[0] + texels[i * 4 + 1] * axis[1] + texels[i * 4 + 2] * axis[2];
+        if (d < minDot) { minDot = d; minIdx = i; }
+        if (d > maxDot) { maxDot = d; maxIdx = i; }
+    }
+
+    int end0[3], end1[3];
+    for (int c = 0; c < 3; ++c) {
+        end0[c] = texels[maxIdx * 4 + c];
+        end1[c] = texels[minIdx * 4 + c];
+    }
+    uint16 c0 = packRGB565(end0), c1 = packRGB565(end1);
+    // c0 > c1 selects the 4 colour mode, which also applies to BC2/BC3
+    if (c0 < c1)
+        std::swap(c0, c1);
+
+    uint32 indices = 0;
+    if (c0 != c1) {
+        int palette[4][3];
+        unpackRGB565(c0, palette[0]);
+        unpackRGB565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestErr = INT_MAX;
+            for (int p = 0; p < 4; ++p) {
+                int dr = texels[i * 4] - palette[p][0];
+                int dg = texels[i * 4 + 1] - palette[p][1];
+                int db = texels[i * 4 + 2] - palette[p][2];
+                int err = dr * dr + dg * dg + db * db;
+                if (err < bestErr) { bestErr = err; best = p; }
+            }
+            indices |= uint32(best) << (i * 2);
+        }
+    }
+
+    // little endian
+    block[0] = static_cast<uchar>(c0); block[1] = static_cast<uchar>(c0 >> 8);
+    block[2] = static_cast<uchar>(c1); block[3] = static_cast<uchar>(c1 >> 8);
+    for (int b = 0; b < 4; ++b)
+        block[4 + b] = static_cast<uchar>(indices >> (b * 8));
+}
+
+// BC3 alpha block, in the 8 alpha mode between the alpha extremes
+inline void encodeBC3Alpha(const uchar* texels, uchar* block) {
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i) {
+        a0 = std::max<int>(a0, texels[i * 4 + 3]);
+        a1 = std::min<int>(a1, texels[i * 4 + 3]);
+    }
+
+    uint64 indices = 0;
+    if (a0 != a1) {
+        int palette[8];
+        palette[0] = a0;
+        palette[1] = a1;
+        for (int p = 1; p < 7; ++p)
+            palette[p + 1] = ((7 - p) * a0 + p * a1) / 7;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestErr = INT_MAX;
+            for (int p = 0; p < 8; ++p) {
+                int err = std::abs(texels[i * 4 + 3] - palette[p]);
+                if (err < bestErr) { bestErr = err; best = p; }
+            }
+            indices |= uint64(best) << (i * 3);
+        }
+    }
+
+    block[0] = static_cast<uchar>(a0);
+    block[1] = static_cast<uchar>(a1);
+    for (int b = 0; b < 6; ++b)
+        block[2 + b] = static_cast<uchar>(indices >> (b * 8));
+}
+
+// ETC1 block in individual mode, which ETC2 RGB decodes identically.
+// both orientations and all modifier tables are tried for each half block
+inline void encodeETC1(const uchar* texels, uchar* block) {
+    static const int modifiers[8][2] = {
+        { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 },
+        { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+    };
+
+    uint64 bestBits = 0;
+    int bestFlipErr = INT_MAX;
+    for (int flip = 0; flip < 2; ++flip) {
+        uint64 bits = uint64(flip) << 32;
+        int flipErr = 0;
+        for (int half = 0; half < 2; ++half) {
+            // texel coordinates of the half block
+            int xs[8], ys[8];
+            for (int i = 0; i < 8; ++i) {
+                xs[i] = flip ? (i & 3) : half * 2 + (i & 1);
+                ys[i] = flip ? half * 2 + (i >> 2) : (i >> 1);
+            }
+
+            // base colour is the average at 4 bits per channel
+            int base[3];
+            for (int c = 0; c < 3; ++c) {
+                int sum = 0;
+                for (int i = 0; i < 8; ++i)
+                    sum += texels[(ys[i] * 4 + xs[i]) * 4 + c];
+                int c4 = (sum * 15 + 8 * 255 / 2) / (8 * 255);
+                bits |= uint64(c4) << (60 - c * 8 - half * 4);
+                base[c] = (c4 << 4) | c4;
+            }
+
+            int bestTable = 0, bestErr = INT_MAX;
+            uint32 bestIndices = 0;
+            for (int table = 0; table < 8; ++table) {
+                int err = 0;
+                uint32 indices = 0;
+                for (int i = 0; i < 8; ++i) {
+                    const uchar* t = &texels[(ys[i] * 4 + xs[i]) * 4];
+                    int bestIdx = 0, bestIdxErr = INT_MAX;
+                    for (int idx = 0; idx < 4; ++idx) {
+                        // index bits msb:lsb select +a, +b, -a, -b
+                        int m = (idx & 2) ? -modifiers[table][idx & 1] : modifiers[table][idx & 1];
+                        int e = 0;
+                        for (int c = 0; c < 3; ++c) {
+                            int d = t[c] - std::min(255, std::max(0, base[c] + m));
+                            e += d * d;
+                        }
+                        if (e < bestIdxErr) { bestIdxErr = e; bestIdx = idx; }
+                    }
+                    err += bestIdxErr;
+                    // pixels are numbered in column major order
+                    int p = xs[i] * 4 + ys[i];
+                    indices |= uint32(bestIdx >> 1) << (16 + p) | uint32(bestIdx & 1) << p;
+                }
+                if (err < bestErr) { bestErr = err; bestTable = table; bestIndices = indices; }
+            }
+            bits |= uint64(bestTable) << (37 - half * 3);
+            bits |= bestIndices;
+            flipErr += bestErr;
+        }
+        if (flipErr < bestFlipErr) { bestFlipErr = flipErr; bestBits = bits; }
+    }
+
+    // big endian
+    for (int b = 0; b < 8; ++b)
+        block[b] = static_cast<uchar>(bestBits >> (56 - b * 8));
+}
+
+// compresses rows of blocks of a 2D PF_BYTE_RGBA box, edge blocks repeat
+// the last row and column of texels
+struct BlockCompressor {
+    static void compress(const PixelBox& src, const PixelBox& dst,
+                         size_t rowBegin = 0, size_t rowEnd = ~(size_t)0) {
+        size_t width = src.getWidth(), height = src.getHeight();
+        size_t blocksX = (width + 3) / 4;
+        size_t blockSize = (dst.format == PF_DXT5) ? 16 : 8;
+        rowEnd = std::min<size_t>(rowEnd, (height + 3) / 4);
+
+        const uchar* srcdata = (const uchar*)src.getTopLeftFrontPixelPtr();
+        uchar* pdst = (uchar*)dst.data + rowBegin * blocksX * blockSize;
+        uchar texels[16 * 4];
+        for (size_t by = rowBegin; by < rowEnd; by++) {
+            for (size_t bx = 0; bx < blocksX; bx++) {
+                for (size_t i = 0; i < 16; i++) {
+                    size_t x = std::min(bx * 4 + (i & 3), width - 1);
+                    size_t y = std::min(by * 4 + (i >> 2), height - 1);
+                    memcpy(&texels[i * 4], srcdata + (y * src.rowPitch + x) * 4, 4);
+                }
+
+                switch (dst.format) {
+                case PF_DXT1:
+                    encodeBC1Colour(texels, pdst);
+                    break;
+                case PF_DXT5:
+                    encodeBC3Alpha(texels, pdst);
+                    encodeBC1Colour(texels, pdst + 8);
+                    break;
+                default: // PF_ETC1_RGB8, PF_ETC2_RGB8
+                    encodeETC1(texels, pdst);
+                    break;
+                }
+                pdst += blockSize;
+            }
+        }
+    }
+};
+/** @} */
+/** @} */
+
+}
+
+#endif
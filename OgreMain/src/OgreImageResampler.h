@@ -47,17 +47,22 @@ namespace Ogre {
 // sx2 = upper-bound integer x-position in source
 // sxf = fractional weight between sx1 and sx2
 // x,y,z = location of output pixel in destination
+//
+// the resamplers only write the destination rows [rowBegin, rowEnd) of each
+// slice, so that bands of rows can be resampled on separate threads
 
 // nearest-neighbor resampler, does not convert formats.
 // templated on bytes-per-pixel to allow compiler optimizations, such
 // as simplifying memcpy() and replacing multiplies with bitshifts
 template<unsigned int elemsize> struct NearestResampler {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst,
+                      size_t rowBegin = 0, size_t rowEnd = ~(size_t)0) {
         // assert(src.format == dst.format);
+        rowEnd = std::min<size_t>(rowEnd, dst.getHeight());
 
-        // srcdata stays at beginning, pdst is a moving pointer
+        // srcdata and dstdata stay at beginning, pdst is a moving pointer
         uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        uchar* dstdata = (uchar*)dst.getTopLeftFrontPixelPtr();
 
         // sx_48,sy_48,sz_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
@@ -71,9 +76,11 @@ template<unsigned int elemsize> struct NearestResampler {
         for (size_t z = dst.front; z < dst.back; z++, sz_48 += stepz) {
             size_t srczoff = (size_t)(sz_48 >> 48) * src.slicePitch;
             
-            uint64 sy_48 = (stepy >> 1) - 1;
-            for (size_t y = dst.top; y < dst.bottom; y++, sy_48 += stepy) {
+            uint64 sy_48 = (stepy >> 1) - 1 + stepy * rowBegin;
+            for (size_t y = rowBegin; y < rowEnd; y++, sy_48 += stepy) {
                 size_t srcyoff = (size_t)(sy_48 >> 48) * src.rowPitch;
+                uchar* pdst = dstdata +
+                    elemsize*((z - dst.front)*dst.slicePitch + y*dst.rowPitch);
             
                 uint64 sx_48 = (stepx >> 1) - 1;
                 for (size_t x = dst.left; x < dst.right; x++, sx_48 += stepx) {
@@ -82,9 +89,7 @@ template<unsigned int elemsize> struct NearestResampler {
                     memcpy(pdst, psrc, elemsize);
                     pdst += elemsize;
                 }
-                pdst += elemsize*dst.getRowSkip();
             }
-            pdst += elemsize*dst.getSliceSkip();
         }
     }
 };
@@ -92,13 +97,15 @@ template<unsigned int elemsize> struct NearestResampler {
 
 // default floating-point linear resampler, does format conversion
 struct LinearResampler {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst,
+                      size_t rowBegin = 0, size_t rowEnd = ~(size_t)0) {
         size_t srcelemsize = PixelUtil::getNumElemBytes(src.format);
         size_t dstelemsize = PixelUtil::getNumElemBytes(dst.format);
+        rowEnd = std::min<size_t>(rowEnd, dst.getHeight());
 
-        // srcdata stays at beginning, pdst is a moving pointer
+        // srcdata and dstdata stay at beginning, pdst is a moving pointer
         uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        uchar* dstdata = (uchar*)dst.getTopLeftFrontPixelPtr();
         
         // sx_48,sy_48,sz_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
@@ -121,13 +128,15 @@ struct LinearResampler {
             uint32 sz2 = std::min(sz1+1,src.getDepth()-1);// src z, sample #2
             float szf = (temp & 0xFFFF) / 65536.f; // weight of sample #2
 
-            uint64 sy_48 = (stepy >> 1) - 1;
-            for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+            uint64 sy_48 = (stepy >> 1) - 1 + stepy * rowBegin;
+            for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
                 temp = static_cast<unsigned int>(sy_48 >> 32);
                 temp = (temp > 0x8000)? temp - 0x8000 : 0;
                 uint32 sy1 = temp >> 16;                    // src y #1
                 uint32 sy2 = std::min(sy1+1,src.getHeight()-1);// src y #2
                 float syf = (temp & 0xFFFF) / 65536.f; // weight of #2
+                uchar* pdst = dstdata +
+                    dstelemsize*((z - dst.front)*dst.slicePitch + y*dst.rowPitch);
                 
                 uint64 sx_48 = (stepx >> 1) - 1;
                 for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
@@ -163,9 +172,7 @@ struct LinearResampler {
 
                     pdst += dstelemsize;
                 }
-                pdst += dstelemsize*dst.getRowSkip();
             }
-            pdst += dstelemsize*dst.getSliceSkip();
         }
     }
 };
@@ -174,15 +181,17 @@ struct LinearResampler {
 // float32 linear resampler, converts FLOAT32_RGB/FLOAT32_RGBA only.
 // avoids overhead of pixel unpack/repack function calls
 struct LinearResampler_Float32 {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst,
+                      size_t rowBegin = 0, size_t rowEnd = ~(size_t)0) {
         size_t srcchannels = PixelUtil::getNumElemBytes(src.format) / sizeof(float);
         size_t dstchannels = PixelUtil::getNumElemBytes(dst.format) / sizeof(float);
         // assert(srcchannels == 3 || srcchannels == 4);
         // assert(dstchannels == 3 || dstchannels == 4);
+        rowEnd = std::min<size_t>(rowEnd, dst.getHeight());
 
-        // srcdata stays at beginning, pdst is a moving pointer
+        // srcdata and dstdata stay at beginning, pdst is a moving pointer
         float* srcdata = (float*)src.getTopLeftFrontPixelPtr();
-        float* pdst = (float*)dst.getTopLeftFrontPixelPtr();
+        float* dstdata = (float*)dst.getTopLeftFrontPixelPtr();
         
         // sx_48,sy_48,sz_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
@@ -205,13 +214,15 @@ struct LinearResampler_Float32 {
             uint32 sz2 = std::min(sz1+1,src.getDepth()-1);// src z, sample #2
             float szf = (temp & 0xFFFF) / 65536.f; // weight of sample #2
 
-            uint64 sy_48 = (stepy >> 1) - 1;
-            for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+            uint64 sy_48 = (stepy >> 1) - 1 + stepy * rowBegin;
+            for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
                 temp = static_cast<unsigned int>(sy_48 >> 32);
                 temp = (temp > 0x8000)? temp - 0x8000 : 0;
                 uint32 sy1 = temp >> 16;                    // src y #1
                 uint32 sy2 = std::min(sy1+1,src.getHeight()-1);// src y #2
                 float syf = (temp & 0xFFFF) / 65536.f; // weight of #2
+                float* pdst = dstdata +
+                    dstchannels*((z - dst.front)*dst.slicePitch + y*dst.rowPitch);
                 
                 uint64 sx_48 = (stepx >> 1) - 1;
                 for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
@@ -266,9 +277,7 @@ struct LinearResampler_Float32 {
 
                     pdst += dstchannels;
                 }
-                pdst += dstchannels*dst.getRowSkip();
             }
-            pdst += dstchannels*dst.getSliceSkip();
         }
     }
 };
@@ -281,26 +290,28 @@ struct LinearResampler_Float32 {
 // templated on bytes-per-pixel to allow compiler optimizations, such
 // as unrolling loops and replacing multiplies with bitshifts
 template<unsigned int channels> struct LinearResampler_Byte {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst,
+                      size_t rowBegin = 0, size_t rowEnd = ~(size_t)0) {
         // assert(src.format == dst.format);
 
         // only optimized for 2D
         if (src.getDepth() > 1 || dst.getDepth() > 1) {
-            LinearResampler::scale(src, dst);
+            LinearResampler::scale(src, dst, rowBegin, rowEnd);
             return;
         }
+        rowEnd = std::min<size_t>(rowEnd, dst.getHeight());
 
-        // srcdata stays at beginning of slice, pdst is a moving pointer
+        // srcdata and dstdata stay at beginning of slice, pdst is a moving pointer
         uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        uchar* dstdata = (uchar*)dst.getTopLeftFrontPixelPtr();
 
         // sx_48,sy_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
         uint64 stepx = ((uint64)src.getWidth() << 48) / dst.getWidth();
         uint64 stepy = ((uint64)src.getHeight() << 48) / dst.getHeight();
         
-        uint64 sy_48 = (stepy >> 1) - 1;
-        for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+        uint64 sy_48 = (stepy >> 1) - 1 + stepy * rowBegin;
+        for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
             // bottom 28 bits of temp are 16/12 bit fixed precision, used to
             // adjust a source coordinate backwards by half a pixel so that the
             // integer bits represent the first sample (eg, sx1) and the
@@ -312,6 +323,7 @@ template<unsigned int channels> struct LinearResampler_Byte {
             uint32 sy2 = std::min(sy1+1, src.bottom-src.top-1);
             size_t syoff1 = sy1 * src.rowPitch;
             size_t syoff2 = sy2 * src.rowPitch;
+            uchar* pdst = dstdata + channels*y*dst.rowPitch;
 
             uint64 sx_48 = (stepx >> 1) - 1;
             for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
@@ -333,7 +345,6 @@ template<unsigned int channels> struct LinearResampler_Byte {
                     *pdst++ = static_cast<uchar>((accum + 0x800000) >> 24);
                 }
             }
-            pdst += channels*dst.getRowSkip();
         }
     }
 };
@@ -0,0 +1,169 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreImpostor.h"
+
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreEntity.h"
+#include "OgreMesh.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreViewport.h"
+#include "OgreRenderTexture.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreTextureManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreTextureUnitState.h"
+#include "OgreNameGenerator.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        NameGenerator gImpostorNameGenerator("Ogre/Impostor");
+    }
+    //-----------------------------------------------------------------------
+    Impostor::Impostor(const MeshPtr& mesh, uint16 yawViews, uint16 pitchViews, uint32 viewSize)
+        : mMesh(mesh)
+        , mYawViews(std::max<uint16>(yawViews, 1))
+        , mPitchViews(std::max<uint16>(pitchViews, 1))
+        , mViewSize(viewSize)
+        , mCentre(Vector3::ZERO)
+        , mRadius(0)
+        , mColour(ColourValue::White)
+    {
+    }
+    //-----------------------------------------------------------------------
+    Impostor::~Impostor()
+    {
+        if (mMaterial)
+            MaterialManager::getSingleton().remove(mMaterial);
+        if (mTexture)
+            TextureManager::getSingleton().remove(mTexture);
+    }
+    //-----------------------------------------------------------------------
+    Radian Impostor::getPitch(uint16 row) const
+    {
+        // Rows are spread from the horizon to just below the top view
+        if (mPitchViews == 1)
+            return Radian(0);
+        return Radian(Math::HALF_PI * row / mPitchViews);
+    }
+    //-----------------------------------------------------------------------
+    void Impostor::generate(void)
+    {
+        if (isGenerated())
+            return;
+
+        mMesh->load();
+        const AxisAlignedBox& bounds = mMesh->getBounds();
+        mCentre = bounds.getCenter();
+        mRadius = bounds.getHalfSize().length();
+
+        String name = gImpostorNameGenerator.generate();
+        mTexture = TextureManager::getSingleton().createManual(name,
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, TEX_TYPE_2D,
+            mViewSize * mYawViews, mViewSize * mPitchViews, MIP_UNLIMITED, PF_BYTE_RGBA,
+            TU_RENDERTARGET | TU_AUTOMIPMAP);
+        RenderTarget* rt = mTexture->getBuffer()->getRenderTarget();
+        rt->setAutoUpdated(false);
+
+        // Picture the mesh on its own, unlit
+        Root& root = Root::getSingleton();
+        SceneManager* sm = root.createSceneManager(ST_GENERIC, name);
+        sm->setAmbientLight(ColourValue::White);
+        sm->getRootSceneNode()->attachObject(sm->createEntity(mMesh));
+
+        for (uint16 row = 0; row < mPitchViews; ++row)
+        {
+            Real cosPitch = Math::Cos(getPitch(row));
+            Real sinPitch = Math::Sin(getPitch(row));
+            for (uint16 col = 0; col < mYawViews; ++col)
+            {
+                Radian yaw(Math::TWO_PI * col / mYawViews);
+                Vector3 dir(Math::Sin(yaw) * cosPitch, sinPitch, Math::Cos(yaw) * cosPitch);
+
+                Camera* cam = sm->createCamera(name + "/" + StringConverter::toString(row * mYawViews + col));
+                cam->setProjectionType(PT_ORTHOGRAPHIC);
+                cam->setAspectRatio(1);
+                cam->setOrthoWindow(mRadius * 2, mRadius * 2);
+                cam->setNearClipDistance(mRadius * 0.5f);
+                cam->setFarClipDistance(mRadius * 4);
+                cam->setPosition(mCentre + dir * mRadius * 2);
+                cam->lookAt(mCentre);
+
+                Viewport* vp = rt->addViewport(cam, row * mYawViews + col,
+                    float(col) / mYawViews, float(row) / mPitchViews,
+                    1.0f / mYawViews, 1.0f / mPitchViews);
+                vp->setBackgroundColour(ColourValue::ZERO);
+                vp->setOverlaysEnabled(false);
+                vp->setSkiesEnabled(false);
+                vp->setShadowsEnabled(false);
+            }
+        }
+
+        rt->update();
+        rt->removeAllViewports();
+        root.destroySceneManager(sm);
+
+        mMaterial = MaterialManager::getSingleton().create(name,
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+        Pass* pass = mMaterial->getTechnique(0)->getPass(0);
+        pass->setLightingEnabled(false);
+        pass->setCullingMode(CULL_NONE);
+        pass->setAlphaRejectSettings(CMPF_GREATER_EQUAL, 128);
+        TextureUnitState* tus = pass->createTextureUnitState();
+        tus->setTexture(mTexture);
+        tus->setTextureAddressingMode(TextureUnitState::TAM_CLAMP);
+        mMaterial->load();
+    }
+    //-----------------------------------------------------------------------
+    void Impostor::getViewTexCoords(const Vector3& direction, FloatRect& texCoords) const
+    {
+        Real yaw = Math::ATan2(direction.x, direction.z).valueRadians();
+        int col = static_cast<int>(Math::Floor(yaw / Math::TWO_PI * mYawViews + 0.5f));
+        col = (col % mYawViews + mYawViews) % mYawViews;
+
+        int row = 0;
+        Real length = direction.length();
+        if (mPitchViews > 1 && length > 0)
+        {
+            Real pitch = Math::ASin(direction.y / length).valueRadians();
+            row = static_cast<int>(Math::Floor(pitch / Math::HALF_PI * mPitchViews + 0.5f));
+            row = Math::Clamp(row, 0, mPitchViews - 1);
+        }
+
+        texCoords.left = float(col) / mYawViews;
+        texCoords.right = float(col + 1) / mYawViews;
+        texCoords.top = float(row) / mPitchViews;
+        texCoords.bottom = float(row + 1) / mPitchViews;
+    }
+}
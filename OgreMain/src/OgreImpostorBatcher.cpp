@@ -0,0 +1,254 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreImpostorBatcher.h"
+
+#include "OgreImpostor.h"
+#include "OgreEntity.h"
+#include "OgreSceneNode.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreRenderQueue.h"
+#include "OgreSceneManager.h"
+#include "OgreViewport.h"
+#include "OgreCamera.h"
+#include "OgreRoot.h"
+#include "OgreBitwise.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    bool ImpostorBatcher::BatchKey::operator<(const BatchKey& rhs) const
+    {
+        if (impostor != rhs.impostor)
+            return impostor < rhs.impostor;
+        if (queueID != rhs.queueID)
+            return queueID < rhs.queueID;
+        return priority < rhs.priority;
+    }
+    //-----------------------------------------------------------------------
+    ImpostorBatcher::ImpostorBatcher()
+    {
+    }
+    //-----------------------------------------------------------------------
+    ImpostorBatcher::~ImpostorBatcher()
+    {
+        for (BatchMap::iterator i = mBatches.begin(); i != mBatches.end(); ++i)
+            OGRE_DELETE i->second;
+    }
+    //-----------------------------------------------------------------------
+    void ImpostorBatcher::_addEntity(Entity* entity, Impostor* impostor, uint8 queueID,
+        ushort priority, RenderQueue* queue)
+    {
+        BatchKey key;
+        key.impostor = impostor;
+        key.queueID = queueID;
+        key.priority = priority;
+
+        BatchMap::iterator bi = mBatches.find(key);
+        if (bi == mBatches.end())
+            bi = mBatches.insert(BatchMap::value_type(key, OGRE_NEW Batch(impostor))).first;
+        Batch* batch = bi->second;
+
+        const Node* node = entity->getParentNode();
+        const Vector3& scale = node->_getDerivedScale();
+        if (batch->addInstance(node->_getDerivedPosition(), node->_getDerivedOrientation(),
+            std::max(std::max(Math::Abs(scale.x), Math::Abs(scale.y)), Math::Abs(scale.z))))
+        {
+            queue->addRenderable(batch, queueID, priority);
+            mQueuedBatches.push_back(batch);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ImpostorBatcher::_beginScene(void)
+    {
+        for (vector<Batch*>::type::iterator i = mQueuedBatches.begin(); i != mQueuedBatches.end(); ++i)
+            (*i)->clearInstances();
+        mQueuedBatches.clear();
+
+        // Batches unused since the last frame are dropped, their impostor may be gone
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        BatchMap::iterator i = mBatches.begin();
+        while (i != mBatches.end())
+        {
+            if (i->second->getLastUsedFrame() + 1 < frame)
+            {
+                OGRE_DELETE i->second;
+                mBatches.erase(i++);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    ImpostorBatcher::Batch::Batch(Impostor* impostor)
+        : mImpostor(impostor), mMaterial(impostor->getMaterial()),
+        mVertexData(OGRE_NEW VertexData()), mIndexData(OGRE_NEW IndexData()),
+        mLastUsedFrame(Root::getSingleton().getNextFrameNumber())
+    {
+        VertexDeclaration* decl = mVertexData->vertexDeclaration;
+        size_t offset = 0;
+        decl->addElement(0, offset, VET_FLOAT3, VES_POSITION);
+        offset += VertexElement::getTypeSize(VET_FLOAT3);
+        decl->addElement(0, offset, VET_COLOUR, VES_DIFFUSE);
+        offset += VertexElement::getTypeSize(VET_COLOUR);
+        decl->addElement(0, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES);
+        mVertexData->vertexStart = 0;
+        mVertexData->vertexCount = 0;
+        mIndexData->indexStart = 0;
+        mIndexData->indexCount = 0;
+    }
+    //-----------------------------------------------------------------------
+    ImpostorBatcher::Batch::~Batch()
+    {
+        OGRE_DELETE mVertexData;
+        OGRE_DELETE mIndexData;
+    }
+    //-----------------------------------------------------------------------
+    bool ImpostorBatcher::Batch::addInstance(const Vector3& position,
+        const Quaternion& orientation, Real scale)
+    {
+        Instance instance;
+        instance.position = position;
+        instance.orientation = orientation;
+        instance.scale = scale;
+        mInstances.push_back(instance);
+        mLastUsedFrame = Root::getSingleton().getNextFrameNumber();
+        return mInstances.size() == 1;
+    }
+    //-----------------------------------------------------------------------
+    void ImpostorBatcher::Batch::reserve(size_t quads)
+    {
+        HardwareVertexBufferSharedPtr vbuf;
+        if (mVertexData->vertexBufferBinding->isBufferBound(0))
+            vbuf = mVertexData->vertexBufferBinding->getBuffer(0);
+        if (vbuf && vbuf->getNumVertices() >= quads * 4)
+            return;
+
+        size_t capacity = Bitwise::firstPO2From(static_cast<uint32>(quads));
+        vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+            mVertexData->vertexDeclaration->getVertexSize(0), capacity * 4,
+            HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        mVertexData->vertexBufferBinding->setBinding(0, vbuf);
+
+        // The indexes of the quads never change
+        HardwareIndexBuffer::IndexType indexType = capacity * 4 > 65536 ?
+            HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT;
+        mIndexData->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+            indexType, capacity * 6, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        void* pIndex = mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD);
+        for (size_t q = 0; q < capacity; ++q)
+        {
+            uint32 v = static_cast<uint32>(q * 4);
+            uint32 quad[6] = { v, v + 2, v + 1, v + 1, v + 2, v + 3 };
+            for (size_t i = 0; i < 6; ++i)
+            {
+                if (indexType == HardwareIndexBuffer::IT_32BIT)
+                    static_cast<uint32*>(pIndex)[q * 6 + i] = quad[i];
+                else
+                    static_cast<uint16*>(pIndex)[q * 6 + i] = static_cast<uint16>(quad[i]);
+            }
+        }
+        mIndexData->indexBuffer->unlock();
+    }
+    //-----------------------------------------------------------------------
+    bool ImpostorBatcher::Batch::preRender(SceneManager* sm, RenderSystem* rsys)
+    {
+        Viewport* vp = sm->getCurrentViewport();
+        if (!vp || mInstances.empty())
+            return false;
+
+        const Camera* cam = vp->getCamera();
+        const Vector3& camPos = cam->getDerivedPosition();
+        bool orthographic = cam->getProjectionType() == PT_ORTHOGRAPHIC;
+        bool turnFreely = mImpostor->getPitchViews() > 1;
+        const Vector3& centre = mImpostor->getCentre();
+        Real radius = mImpostor->getRadius();
+
+        reserve(mInstances.size());
+        HardwareVertexBufferSharedPtr vbuf = mVertexData->vertexBufferBinding->getBuffer(0);
+        float* pFloat = static_cast<float*>(vbuf->lock(0,
+            mInstances.size() * 4 * vbuf->getVertexSize(), HardwareBuffer::HBL_DISCARD));
+
+        RGBA colour;
+        Root::getSingleton().convertColourValue(mImpostor->getColour(), &colour);
+
+        for (InstanceList::iterator i = mInstances.begin(); i != mInstances.end(); ++i)
+        {
+            Vector3 pos = i->position + i->orientation * (centre * i->scale);
+            Vector3 toCam = orthographic ? -cam->getDerivedDirection() : camPos - pos;
+
+            FloatRect texCoords;
+            mImpostor->getViewTexCoords(i->orientation.Inverse() * toCam, texCoords);
+
+            Vector3 up = i->orientation * Vector3::UNIT_Y;
+            Vector3 right = up.crossProduct(toCam);
+            if (right.isZeroLength())
+                right = i->orientation * Vector3::UNIT_X;
+            right.normalise();
+            if (turnFreely)
+                up = toCam.crossProduct(right).normalisedCopy();
+            right *= radius * i->scale;
+            up *= radius * i->scale;
+
+            const Vector3 corners[4] = { pos - right + up, pos + right + up,
+                                         pos - right - up, pos + right - up };
+            const float u[4] = { texCoords.left, texCoords.right, texCoords.left, texCoords.right };
+            const float v[4] = { texCoords.top, texCoords.top, texCoords.bottom, texCoords.bottom };
+            for (int c = 0; c < 4; ++c)
+            {
+                *pFloat++ = static_cast<float>(corners[c].x);
+                *pFloat++ = static_cast<float>(corners[c].y);
+                *pFloat++ = static_cast<float>(corners[c].z);
+                *reinterpret_cast<RGBA*>(pFloat++) = colour;
+                *pFloat++ = u[c];
+                *pFloat++ = v[c];
+            }
+        }
+        vbuf->unlock();
+
+        mVertexData->vertexCount = mInstances.size() * 4;
+        mIndexData->indexCount = mInstances.size() * 6;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void ImpostorBatcher::Batch::getRenderOperation(RenderOperation& op)
+    {
+        op.indexData = mIndexData;
+        op.operationType = RenderOperation::OT_TRIANGLE_LIST;
+        op.srcRenderable = this;
+        op.useIndexes = true;
+        op.vertexData = mVertexData;
+    }
+    //-----------------------------------------------------------------------
+    void ImpostorBatcher::Batch::getWorldTransforms(Matrix4* xform) const
+    {
+        *xform = Matrix4::IDENTITY;
+    }
+}
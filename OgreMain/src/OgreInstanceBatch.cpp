@@ -441,6 +441,7 @@ namespace Ogre
         {
             (*itor)->mInstanceId = instanceId++;
             (*itor)->mBatchOwner = this;
+            (*itor)->mNeedBatchDataUpdate = true;
             ++itor;
         }
 
@@ -32,15 +32,97 @@ THE SOFTWARE.
 #include "OgreHardwareBufferManager.h"
 #include "OgreInstancedEntity.h"
 #include "OgreRoot.h"
+#include "OgreCamera.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreLogManager.h"
 
 namespace Ogre
 {
+    namespace
+    {
+        /// Create a GLSL program unless it exists already
+        void createCullProgram( const String &name, GpuProgramType type, const String &source )
+        {
+            HighLevelGpuProgramManager &mgr = HighLevelGpuProgramManager::getSingleton();
+            if( !mgr.getByName( name, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME ) )
+            {
+                HighLevelGpuProgramPtr program = mgr.createProgram( name,
+                                                    ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME,
+                                                    "glsl", type );
+                program->setSource( source );
+                program->load();
+            }
+        }
+
+        /** Material copying the instance records (numRows vec4s each) whose bounding sphere
+            is inside the frustum, shared by all batches with the same record size */
+        MaterialPtr getCullMaterial( size_t numRows )
+        {
+            const String name = "InstanceBatchHW/Cull/" + StringConverter::toString( numRows );
+            MaterialPtr material = MaterialManager::getSingleton().getByName( name,
+                                                    ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME );
+            if( material )
+                return material;
+
+            StringStream vs, gs;
+            vs << "#version 150\n";
+            gs << "#version 150\n"
+                  "layout(points) in;\n"
+                  "layout(points, max_vertices = 1) out;\n"
+                  "uniform vec4 frustumPlanes[6];\n"
+                  "uniform float meshRadius;\n";
+            for( size_t i=0; i<numRows; ++i )
+            {
+                vs << "in vec4 uv" << i << ";\nout vec4 vUv" << i << ";\n";
+                gs << "in vec4 vUv" << i << "[];\nout vec4 oUv" << i << ";\n";
+            }
+            vs << "void main()\n{\n";
+            for( size_t i=0; i<numRows; ++i )
+                vs << "    vUv" << i << " = uv" << i << ";\n";
+            vs << "}\n";
+
+            //The first three rows are the 3x4 world matrix, scale the radius by its largest axis
+            gs << "void main()\n"
+                  "{\n"
+                  "    vec3 centre = vec3(vUv0[0].w, vUv1[0].w, vUv2[0].w);\n"
+                  "    vec3 axes = vUv0[0].xyz * vUv0[0].xyz + vUv1[0].xyz * vUv1[0].xyz + vUv2[0].xyz * vUv2[0].xyz;\n"
+                  "    float radius = meshRadius * sqrt(max(axes.x, max(axes.y, axes.z)));\n"
+                  "    for (int i = 0; i < 6; ++i)\n"
+                  "    {\n"
+                  "        if (dot(frustumPlanes[i].xyz, centre) + frustumPlanes[i].w < -radius)\n"
+                  "            return;\n"
+                  "    }\n";
+            for( size_t i=0; i<numRows; ++i )
+                gs << "    oUv" << i << " = vUv" << i << "[0];\n";
+            gs << "    EmitVertex();\n"
+                  "    EndPrimitive();\n"
+                  "}\n";
+
+            createCullProgram( name + "VS", GPT_VERTEX_PROGRAM, vs.str() );
+            createCullProgram( name + "GS", GPT_GEOMETRY_PROGRAM, gs.str() );
+
+            material = MaterialManager::getSingleton().create( name,
+                                                    ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME );
+            Pass *pass = material->getTechnique(0)->getPass(0);
+            pass->setVertexProgram( name + "VS" );
+            pass->setGeometryProgram( name + "GS" );
+            return material;
+        }
+    }
+
     InstanceBatchHW::InstanceBatchHW( InstanceManager *creator, MeshPtr &meshReference,
                                         const MaterialPtr &material, size_t instancesPerBatch,
                                         const Mesh::IndexMap *indexToBoneMap, const String &batchName ) :
                 InstanceBatch( creator, meshReference, material, instancesPerBatch,
                                 indexToBoneMap, batchName ),
-                mKeepStatic( false )
+                mKeepStatic( false ),
+                mGpuCulling( false ),
+                mCullRenderable( this ),
+                mNumInstanceRecords( 0 )
     {
         //Override defaults, so that InstancedEntities don't create a skeleton instance
         mTechnSupportsSkeletal = false;
@@ -84,6 +166,7 @@ namespace Ogre
         thisVertexData->vertexBufferBinding->setBinding( lastSource, vertexBuffer );
         vertexBuffer->setIsInstanceData( true );
         vertexBuffer->setInstanceDataStepRate( 1 );
+        mInstanceBuffer = vertexBuffer;
     }
     //-----------------------------------------------------------------------
     void InstanceBatchHW::setupVertices( const SubMesh* baseSubMesh )
@@ -116,6 +199,7 @@ namespace Ogre
         thisVertexData->vertexBufferBinding->setBinding( newSource, vertexBuffer );
         vertexBuffer->setIsInstanceData( true );
         vertexBuffer->setInstanceDataStepRate( 1 );
+        mInstanceBuffer = vertexBuffer;
     }
     //-----------------------------------------------------------------------
     void InstanceBatchHW::setupIndices( const SubMesh* baseSubMesh )
@@ -183,9 +267,7 @@ namespace Ogre
         size_t retVal = 0;
 
         //Now lock the vertex buffer and copy the 4x3 matrices, only those who need it!
-        const ushort bufferIdx = ushort(mRenderOperation.vertexData->vertexBufferBinding->getBufferCount()-1);
-        float *pDest = static_cast<float*>(mRenderOperation.vertexData->vertexBufferBinding->
-                                            getBuffer(bufferIdx)->lock( HardwareBuffer::HBL_DISCARD ));
+        float *pDest = static_cast<float*>(mInstanceBuffer->lock( HardwareBuffer::HBL_DISCARD ));
 
         InstancedEntityVec::const_iterator itor = mInstancedEntities.begin();
         InstancedEntityVec::const_iterator end  = mInstancedEntities.end();
@@ -222,11 +304,117 @@ namespace Ogre
             customParamIdx += numCustomParams;
         }
 
-        mRenderOperation.vertexData->vertexBufferBinding->getBuffer(bufferIdx)->unlock();
+        mInstanceBuffer->unlock();
 
+        mNumInstanceRecords = retVal;
         return retVal;
     }
     //-----------------------------------------------------------------------
+    void InstanceBatchHW::createCullBuffer(void)
+    {
+        const size_t numRows = 3 + mCreator->getNumCustomParams();
+        mCullMaterial = getCullMaterial( numRows );
+
+        //Same layout as the instance records, written to oUv0, oUv1...
+        mCullBuffer = HardwareBufferManager::getSingleton().createRenderToVertexBuffer();
+        VertexDeclaration *decl = mCullBuffer->getVertexDeclaration();
+        for( unsigned short i=0; i<numRows; ++i )
+            decl->addElement( 0, i * sizeof(float) * 4, VET_FLOAT4, VES_TEXTURE_COORDINATES, i );
+        mCullBuffer->setOperationType( RenderOperation::OT_POINT_LIST );
+        mCullBuffer->setMaxVertexCount( static_cast<unsigned int>(mInstancesPerBatch) );
+        mCullBuffer->setResetsEveryUpdate( true );
+        mCullBuffer->setRenderToBufferMaterialName( mCullMaterial->getName() );
+
+        mCullRenderable.create( mInstanceBuffer, mNumInstanceRecords );
+        mCullBuffer->setSourceRenderable( &mCullRenderable );
+    }
+    //-----------------------------------------------------------------------
+    size_t InstanceBatchHW::cullOnGpu( Camera *currentCamera )
+    {
+        if( !mNumInstanceRecords )
+            return 0;
+
+        //Test against the same frustum as InstancedEntity::findVisible would
+        const Frustum *frustum = currentCamera->getCullingFrustum() ?
+                                    currentCamera->getCullingFrustum() : currentCamera;
+        const Plane *planes = frustum->getFrustumPlanes();
+
+        //Camera relative records need the planes moved along
+        Vector3 origin = Vector3::ZERO;
+        if( mManager->getCameraRelativeRendering() )
+            origin = currentCamera->getDerivedPosition();
+
+        float planeData[6 * 4];
+        for( size_t i=0; i<6; ++i )
+        {
+            //Infinite far plane never culls
+            const bool skip = i == FRUSTUM_PLANE_FAR && frustum->getFarClipDistance() == 0;
+            planeData[i*4+0] = skip ? 0.0f : planes[i].normal.x;
+            planeData[i*4+1] = skip ? 0.0f : planes[i].normal.y;
+            planeData[i*4+2] = skip ? 0.0f : planes[i].normal.z;
+            planeData[i*4+3] = skip ? 1.0f : planes[i].d + planes[i].normal.dotProduct( origin );
+        }
+
+        GpuProgramParametersSharedPtr params = mCullMaterial->getTechnique(0)->getPass(0)->
+                                                    getGeometryProgramParameters();
+        params->setNamedConstant( "frustumPlanes", planeData, 6 );
+        params->setNamedConstant( "meshRadius", mMeshReference->getBoundingSphereRadius() );
+
+        mCullRenderable.setNumRecords( mNumInstanceRecords );
+        mCullBuffer->update( mManager );
+
+        //Draw the visible records from where the culling wrote them
+        RenderOperation cullOp;
+        mCullBuffer->getRenderOperation( cullOp );
+        HardwareVertexBufferSharedPtr visibleBuffer = cullOp.vertexData->vertexBufferBinding->getBuffer( 0 );
+        visibleBuffer->setIsInstanceData( true );
+        visibleBuffer->setInstanceDataStepRate( 1 );
+
+        const ushort bufferIdx = ushort(mRenderOperation.vertexData->vertexBufferBinding->getBufferCount()-1);
+        mRenderOperation.vertexData->vertexBufferBinding->setBinding( bufferIdx, visibleBuffer );
+
+        return cullOp.vertexData->vertexCount;
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW::setGpuCulling( bool enabled )
+    {
+        if( enabled == mGpuCulling )
+            return;
+
+        if( enabled )
+        {
+            const RenderSystemCapabilities *caps = Root::getSingleton().getRenderSystem()->getCapabilities();
+            if( !caps->hasCapability( RSC_HWRENDER_TO_VERTEX_BUFFER ) ||
+                !caps->hasCapability( RSC_GEOMETRY_PROGRAM ) ||
+                !HighLevelGpuProgramManager::getSingleton().isLanguageSupported( "glsl" ) )
+            {
+                LogManager::getSingleton().logMessage( "WARNING: InstanceBatchHW: GPU culling needs render "
+                    "to vertex buffer and GLSL geometry program support, " + mName +
+                    " is culled on the CPU" );
+                return;
+            }
+
+            createCullBuffer();
+
+            //The culling reads the records as vertices
+            mInstanceBuffer->setIsInstanceData( false );
+        }
+        else
+        {
+            mCullBuffer.reset();
+            mCullMaterial.reset();
+
+            //Draw straight from the records again
+            mInstanceBuffer->setIsInstanceData( true );
+            mInstanceBuffer->setInstanceDataStepRate( 1 );
+            const ushort bufferIdx = ushort(mRenderOperation.vertexData->vertexBufferBinding->getBufferCount()-1);
+            mRenderOperation.vertexData->vertexBufferBinding->setBinding( bufferIdx, mInstanceBuffer );
+            mRenderOperation.numberOfInstances = mNumInstanceRecords;
+        }
+
+        mGpuCulling = enabled;
+    }
+    //-----------------------------------------------------------------------
     void InstanceBatchHW::_boundsDirty(void)
     {
         //Don't update if we're static, but still mark we're dirty
@@ -268,7 +456,18 @@ namespace Ogre
         {
             //Completely override base functionality, since we don't cull on an "all-or-nothing" basis
             //and we don't support skeletal animation
-            if( (mRenderOperation.numberOfInstances = updateVertexBuffer( mCurrentCamera )) )
+            if( mGpuCulling )
+            {
+                //Write every instance, the GPU keeps those in view
+                updateVertexBuffer( 0 );
+                mRenderOperation.numberOfInstances = cullOnGpu( mCurrentCamera );
+            }
+            else
+            {
+                mRenderOperation.numberOfInstances = updateVertexBuffer( mCurrentCamera );
+            }
+
+            if( mRenderOperation.numberOfInstances )
                 queue->addRenderable( this, mRenderQueueID, mRenderQueuePriority );
         }
         else
@@ -280,9 +479,41 @@ namespace Ogre
                     "InstanceBatch::_updateRenderQueue");
             }
 
-            //Don't update when we're static
+            //Don't update when we're static, only find which instances are in view
+            if( mGpuCulling )
+                mRenderOperation.numberOfInstances = cullOnGpu( mCurrentCamera );
+
             if( mRenderOperation.numberOfInstances )
                 queue->addRenderable( this, mRenderQueueID, mRenderQueuePriority );
         }
     }
+    //-----------------------------------------------------------------------
+    InstanceBatchHW::CullRenderable::~CullRenderable()
+    {
+        OGRE_DELETE mVertexData;
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW::CullRenderable::create( const HardwareVertexBufferSharedPtr &instanceBuffer,
+                                                  size_t numRecords )
+    {
+        OGRE_DELETE mVertexData;
+        mVertexData = OGRE_NEW VertexData();
+        mVertexData->vertexCount = numRecords;
+
+        //Read the rows of each record as uv0, uv1...
+        const size_t numRows = instanceBuffer->getVertexSize() / (sizeof(float) * 4);
+        for( unsigned short i=0; i<numRows; ++i )
+        {
+            mVertexData->vertexDeclaration->addElement( 0, i * sizeof(float) * 4, VET_FLOAT4,
+                                                        VES_TEXTURE_COORDINATES, i );
+        }
+        mVertexData->vertexBufferBinding->setBinding( 0, instanceBuffer );
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW::CullRenderable::getRenderOperation( RenderOperation& op )
+    {
+        op.operationType = RenderOperation::OT_POINT_LIST;
+        op.useIndexes = false;
+        op.vertexData = mVertexData;
+    }
 }
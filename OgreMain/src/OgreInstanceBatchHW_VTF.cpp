@@ -246,11 +246,11 @@ namespace Ogre
 
         }
 
-        //Create our own vertex buffer
+        //Create our own vertex buffer. It is rewritten whenever the set of drawn instances changes
         mInstanceVertexBuffer = HardwareBufferManager::getSingleton().createVertexBuffer(
                                         thisVertexData->vertexDeclaration->getVertexSize(newSource),
                                         mInstancesPerBatch,
-                                        HardwareBuffer::HBU_STATIC_WRITE_ONLY );
+                                        HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE );
         thisVertexData->vertexBufferBinding->setBinding( newSource, mInstanceVertexBuffer );
 
         //Mark this buffer as instanced
@@ -270,20 +270,8 @@ namespace Ogre
             //update the mTransformLookupNumber value in the entities if needed 
             updateSharedLookupIndexes();
 
-            const float texWidth  = static_cast<float>(mMatrixTexture->getWidth());
-            const float texHeight = static_cast<float>(mMatrixTexture->getHeight());
-
-            //Calculate the texel offsets to correct them offline
-            //Awkwardly enough, the offset is needed in OpenGL too
-            Vector2 texelOffsets;
-            //RenderSystem *renderSystem = Root::getSingleton().getRenderSystem();
-            texelOffsets.x = /*renderSystem->getHorizontalTexelOffset()*/ -0.5f / texWidth;
-            texelOffsets.y = /*renderSystem->getHorizontalTexelOffset()*/ -0.5f / texHeight;
-
             float *thisVec = static_cast<float*>(mInstanceVertexBuffer->lock(HardwareBuffer::HBL_DISCARD));
 
-            const size_t maxPixelsPerLine = std::min( static_cast<size_t>(mMatrixTexture->getWidth()), mMaxFloatsPerLine >> 2 );
-
             //Calculate UV offsets, which change per instance
             for( size_t i=0; i<mInstancesPerBatch; ++i )
             {
@@ -295,10 +283,9 @@ namespace Ogre
                     //and static mode).
                     (entity->findVisible(currentCamera)))
                 {
-                    size_t matrixIndex = useMatrixLookup ? entity->mTransformLookupNumber : i;
-                    size_t instanceIdx = matrixIndex * mMatricesPerInstance * mRowLength;
-                    *thisVec = ((instanceIdx % maxPixelsPerLine) / texWidth) - (float)(texelOffsets.x);
-                    *(thisVec + 1) = ((instanceIdx / maxPixelsPerLine) / texHeight) - (float)(texelOffsets.y);
+                    size_t matrixIndex = !useMatrixLookup ? i : useBakedAnimation() ?
+                                            getBakedPalette( entity ) : entity->mTransformLookupNumber;
+                    writeInstanceUV( matrixIndex, thisVec );
                     thisVec += 2;
 
                     if (useMatrixLookup)
@@ -337,6 +324,25 @@ namespace Ogre
         }
         return visibleEntityCount;
     }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_VTF::writeInstanceUV( size_t matrixIndex, float *pDest ) const
+    {
+        const float texWidth  = static_cast<float>(mMatrixTexture->getWidth());
+        const float texHeight = static_cast<float>(mMatrixTexture->getHeight());
+
+        //Calculate the texel offsets to correct them offline
+        //Awkwardly enough, the offset is needed in OpenGL too
+        Vector2 texelOffsets;
+        //RenderSystem *renderSystem = Root::getSingleton().getRenderSystem();
+        texelOffsets.x = /*renderSystem->getHorizontalTexelOffset()*/ -0.5f / texWidth;
+        texelOffsets.y = /*renderSystem->getHorizontalTexelOffset()*/ -0.5f / texHeight;
+
+        const size_t maxPixelsPerLine = std::min( static_cast<size_t>(mMatrixTexture->getWidth()), mMaxFloatsPerLine >> 2 );
+
+        size_t instanceIdx = matrixIndex * mMatricesPerInstance * mRowLength;
+        *pDest = ((instanceIdx % maxPixelsPerLine) / texWidth) - (float)(texelOffsets.x);
+        *(pDest + 1) = ((instanceIdx / maxPixelsPerLine) / texHeight) - (float)(texelOffsets.y);
+    }
     
     //-----------------------------------------------------------------------
     bool InstanceBatchHW_VTF::checkSubMeshCompatibility( const SubMesh* baseSubMesh )
@@ -379,7 +385,8 @@ namespace Ogre
             //See InstanceBatchHW::calculateMaxNumInstances for the 65535
             retVal = std::min<size_t>( 65535, maxUsableWidth * c_maxTexHeightHW / mRowLength / numBones );
 
-            if( flags & IM_VTFBESTFIT )
+            //Baked animations don't grow with the number of instances
+            if( (flags & IM_VTFBESTFIT) && !(flags & IM_VTFBAKEDANIMATION) )
             {
                 size_t numUsedSkeletons = mInstancesPerBatch;
                 if (flags & IM_VTFBONEMATRIXLOOKUP)
@@ -403,101 +410,181 @@ namespace Ogre
     //-----------------------------------------------------------------------
     size_t InstanceBatchHW_VTF::updateVertexTexture( Camera *currentCamera )
     {
-        size_t renderedInstances = 0;
-        bool useMatrixLookup = useBoneMatrixLookup();
-        if (useMatrixLookup)
-        {
-            //if we are using bone matrix look up we have to update the instance buffer for the 
-            //vertex texture to be relevant
+        //Without bone matrix lookup every entity has its own texels, only write the ones that changed
+        if( !useBoneMatrixLookup() )
+            return updateDirtyInstances( currentCamera );
 
-            //also note that in this case the number of instances to render comes directly from the 
-            //updateInstanceDataBuffer() function, not from this function.
-            renderedInstances = updateInstanceDataBuffer(false, currentCamera);
-        }
+        //With bone matrix lookup we have to update the instance buffer for the
+        //vertex texture to be relevant
+
+        //also note that in this case the number of instances to render comes directly from the 
+        //updateInstanceDataBuffer() function, not from this function.
+        size_t renderedInstances = updateInstanceDataBuffer(false, currentCamera);
 
-        
         mDirtyAnimation = false;
 
+        //Baked animations are already in the texture
+        if( useBakedAnimation() )
+            return renderedInstances;
+
         //Now lock the texture and copy the 4x3 matrices!
         mMatrixTexture->getBuffer()->lock( HardwareBuffer::HBL_DISCARD );
         const PixelBox &pixelBox = mMatrixTexture->getBuffer()->getCurrentLock();
 
         float *pSource = static_cast<float*>(pixelBox.data);
         
-        InstancedEntityVec::const_iterator itor = mInstancedEntities.begin();
-        
-        vector<bool>::type writtenPositions(getMaxLookupTableInstances(), false);
+        frame_vector<bool>::type writtenPositions(getMaxLookupTableInstances(), false);
 
-        size_t floatPerEntity = mMatricesPerInstance * mRowLength * 4;
-        size_t entitiesPerPadding = (size_t)(mMaxFloatsPerLine / floatPerEntity);
-        
         size_t instanceCount = mInstancedEntities.size();
-        size_t updatedInstances = 0;
 
-        float* transforms = NULL;
-        //If using dual quaternions, write 3x4 matrices to a temporary buffer, then convert to dual quaternions
-        if(mUseBoneDualQuaternions)
-        {
-            transforms = mTempTransformsArray3x4;
-        }
-        
         for(size_t i = 0 ; i < instanceCount ; ++i)
         {
             InstancedEntity* entity = mInstancedEntities[i];
-            size_t textureLookupPosition = updatedInstances;
-            if (useMatrixLookup)
-            {
-                textureLookupPosition = entity->mTransformLookupNumber;
-            }
-            //Check that we are not using a lookup matrix or that we have not already written
-            //The bone data
-            if (((!useMatrixLookup) || !writtenPositions[entity->mTransformLookupNumber]) &&
+            //Check that we have not already written the bone data
+            if (!writtenPositions[entity->mTransformLookupNumber] &&
                 //Cull on an individual basis, the less entities are visible, the less instances we draw.
                 //No need to use null matrices at all!
                 (entity->findVisible( currentCamera )))
             {
-                float* pDest = pSource + floatPerEntity * textureLookupPosition + 
-                    (size_t)(textureLookupPosition / entitiesPerPadding) * mWidthFloatsPadding;
-
-                if(!mUseBoneDualQuaternions)
-                {
-                    transforms = pDest;
-                }
-                
                 if( mMeshReference->hasSkeleton() )
                     mDirtyAnimation |= entity->_updateAnimation();
 
-                size_t floatsWritten = entity->getTransforms3x4( transforms );
+                writeEntityTexels( entity, pSource + getSlotOffset( entity->mTransformLookupNumber ) );
 
-                if( !useMatrixLookup && mManager->getCameraRelativeRendering() )
-                    makeMatrixCameraRelative3x4( transforms, floatsWritten );
+                writtenPositions[entity->mTransformLookupNumber] = true;
+            }
+        }
 
-                if(mUseBoneDualQuaternions)
-                {
-                    convert3x4MatricesToDualQuaternions(transforms, floatsWritten / 12, pDest);
-                }
+        mMatrixTexture->getBuffer()->unlock();
 
-                if (useMatrixLookup)
-                {
-                    writtenPositions[entity->mTransformLookupNumber] = true;
-                }
-                else
-                {
-                    ++updatedInstances;
-                }
+        return renderedInstances;
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatchHW_VTF::writeEntityTexels( InstancedEntity *entity, float *pDest )
+    {
+        //If using dual quaternions, write 3x4 matrices to a temporary buffer, then convert to dual quaternions
+        float *transforms = mUseBoneDualQuaternions ? mTempTransformsArray3x4 : pDest;
+
+        size_t floatsWritten = entity->getTransforms3x4( transforms );
+
+        if( !useBoneMatrixLookup() && mManager->getCameraRelativeRendering() )
+            makeMatrixCameraRelative3x4( transforms, floatsWritten );
+
+        if(mUseBoneDualQuaternions)
+            convert3x4MatricesToDualQuaternions(transforms, floatsWritten / 12, pDest);
+    }
+    //-----------------------------------------------------------------------
+    size_t InstanceBatchHW_VTF::updateDirtyInstances( Camera *currentCamera )
+    {
+        mDirtyAnimation = false;
+
+        const bool hasSkeleton = mMeshReference->hasSkeleton();
+        const size_t instanceCount = mInstancedEntities.size();
+
+        //Gather the drawn entities, counting those whose texels are out of date
+        mDrawnSlots.clear();
+        size_t numDirty = 0;
+        for( size_t i=0; i<instanceCount; ++i )
+        {
+            InstancedEntity *entity = mInstancedEntities[i];
+
+            //Static entities are drawn whenever the batch is
+            if( !entity->findVisible( entity->mKeepStatic ? 0 : currentCamera ) )
+                continue;
+
+            //Static entities only need their skeleton updated after they moved
+            if( hasSkeleton && (!entity->mKeepStatic || entity->mNeedBatchDataUpdate) )
+            {
+                const bool animated = entity->_updateAnimation();
+                mDirtyAnimation |= animated;
+                //Slaves can't tell whether their master was animated by someone else first
+                if( animated || entity->mSharedTransformEntity )
+                    entity->mNeedBatchDataUpdate = true;
             }
 
-            ++itor;
+            mDrawnSlots.push_back( static_cast<uint32>( i ) );
+            if( entity->mNeedBatchDataUpdate )
+                ++numDirty;
         }
 
-        if (!useMatrixLookup)
+        HardwarePixelBufferSharedPtr pixelBuffer = mMatrixTexture->getBuffer();
+
+        if( mManager->getCameraRelativeRendering() || numDirty * 2 > mDrawnSlots.size() )
+        {
+            //Most of it changed (camera relative transforms change with the camera).
+            //Rewrite the texture, losing the texels of the entities not drawn
+            for( size_t i=0; i<instanceCount; ++i )
+                mInstancedEntities[i]->mNeedBatchDataUpdate = true;
+
+            pixelBuffer->lock( HardwareBuffer::HBL_DISCARD );
+            float *pSource = static_cast<float*>( pixelBuffer->getCurrentLock().data );
+
+            SlotVec::const_iterator itor = mDrawnSlots.begin();
+            SlotVec::const_iterator end  = mDrawnSlots.end();
+            while( itor != end )
+            {
+                InstancedEntity *entity = mInstancedEntities[*itor];
+                writeEntityTexels( entity, pSource + getSlotOffset( *itor ) );
+                entity->mNeedBatchDataUpdate = false;
+                ++itor;
+            }
+
+            pixelBuffer->unlock();
+        }
+        else if( numDirty )
         {
-            renderedInstances = updatedInstances;
+            //Upload the few entities that changed on their own
+            const size_t pixelsPerEntity = mMatricesPerInstance * mRowLength;
+            mEntityTexels.resize( pixelsPerEntity * 4 );
+
+            SlotVec::const_iterator itor = mDrawnSlots.begin();
+            SlotVec::const_iterator end  = mDrawnSlots.end();
+            while( itor != end )
+            {
+                InstancedEntity *entity = mInstancedEntities[*itor];
+                if( entity->mNeedBatchDataUpdate )
+                {
+                    writeEntityTexels( entity, &mEntityTexels[0] );
+                    entity->mNeedBatchDataUpdate = false;
+
+                    //All the matrices of an entity are in the same row
+                    const size_t pixelOffset = getSlotOffset( *itor ) >> 2;
+                    const size_t x = pixelOffset % mMatrixTexture->getWidth();
+                    const size_t y = pixelOffset / mMatrixTexture->getWidth();
+                    pixelBuffer->blitFromMemory(
+                        PixelBox( pixelsPerEntity, 1, 1, PF_FLOAT32_RGBA, &mEntityTexels[0] ),
+                        Box( x, y, x + pixelsPerEntity, y + 1 ) );
+                }
+                ++itor;
+            }
         }
 
-        mMatrixTexture->getBuffer()->unlock();
+        //Point the instances at the texels of the drawn entities, if they aren't already
+        if( mDrawnSlots != mLastDrawnSlots )
+        {
+            float *thisVec = static_cast<float*>(mInstanceVertexBuffer->lock(HardwareBuffer::HBL_DISCARD));
 
-        return renderedInstances;
+            SlotVec::const_iterator itor = mDrawnSlots.begin();
+            SlotVec::const_iterator end  = mDrawnSlots.end();
+            while( itor != end )
+            {
+                writeInstanceUV( *itor, thisVec );
+                thisVec += 2;
+                ++itor;
+            }
+
+            mInstanceVertexBuffer->unlock();
+            mLastDrawnSlots.swap( mDrawnSlots );
+        }
+
+        return mLastDrawnSlots.size();
+    }
+    //-----------------------------------------------------------------------
+    TextureUsage InstanceBatchHW_VTF::getVertexTextureUsage(void) const
+    {
+        if( useBakedAnimation() )
+            return TU_STATIC_WRITE_ONLY;
+        return useBoneMatrixLookup() ? TU_DYNAMIC_WRITE_ONLY_DISCARDABLE : TU_DYNAMIC_WRITE_ONLY;
     }
     //-----------------------------------------------------------------------
     void InstanceBatchHW_VTF::_boundsDirty(void)
@@ -37,6 +37,8 @@ THE SOFTWARE.
 #include "OgreTextureManager.h"
 #include "OgreRoot.h"
 #include "OgreDualQuaternion.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreAnimation.h"
 
 namespace Ogre
 {
@@ -59,7 +61,9 @@ namespace Ogre
                 mMaxLookupTableInstances(16),
                 mUseBoneDualQuaternions(false),
                 mForceOneWeight(false),
-                mUseOneWeight(false)
+                mUseOneWeight(false),
+                mBakedAnimationFrameRate(0),
+                mNumBakedPalettes(0)
     {
         cloneMaterial( mMaterial );
     }
@@ -79,8 +83,8 @@ namespace Ogre
         //Remove cloned material
         MaterialManager::getSingleton().remove( mMaterial );
 
-        //Remove the VTF texture
-        if( mMatrixTexture )
+        //Remove the VTF texture. The baked one is shared, our InstanceManager removes it
+        if( mMatrixTexture && !useBakedAnimation() )
             TextureManager::getSingleton().remove( mMatrixTexture );
 
         OGRE_FREE(mTempTransformsArray3x4, MEMCATEGORY_GENERAL);
@@ -246,7 +250,12 @@ namespace Ogre
         Currently assuming it's 4096x4096, which is a safe bet for any hardware with decent VTF*/
         
         size_t uniqueAnimations = mInstancesPerBatch;
-        if (useBoneMatrixLookup())
+        if (useBakedAnimation())
+        {
+            createBakedAnimationLayout();
+            uniqueAnimations = mNumBakedPalettes;
+        }
+        else if (useBoneMatrixLookup())
         {
             uniqueAnimations = std::min<size_t>(getMaxLookupTableInstances(), uniqueAnimations);
         }
@@ -291,15 +300,165 @@ namespace Ogre
         //TextureType texType = texHeight == 1 ? TEX_TYPE_1D : TEX_TYPE_2D;
         TextureType texType = TEX_TYPE_2D;
 
-        mMatrixTexture = TextureManager::getSingleton().createManual(
+        if( useBakedAnimation() )
+        {
+            if( texHeight > c_maxTexHeight )
+            {
+                OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, "The baked animations of " +
+                            mMeshReference->getName() + " don't fit in a vertex texture. Lower the"
+                            " baked animation frame rate", "BaseInstanceBatchVTF::createVertexTexture" );
+            }
+
+            //All batches of our creator share the same baked texture
+            const String bakedName = mCreator->getName() + "/BakedAnimation";
+            mMatrixTexture = TextureManager::getSingleton().getByName( bakedName, mMeshReference->getGroup() );
+            if( !mMatrixTexture )
+            {
+                mMatrixTexture = TextureManager::getSingleton().createManual(
+                                        bakedName, mMeshReference->getGroup(), texType,
+                                        (uint)texWidth, (uint)texHeight,
+                                        0, PF_FLOAT32_RGBA, getVertexTextureUsage() );
+                bakeAnimations();
+            }
+        }
+        else
+        {
+            mMatrixTexture = TextureManager::getSingleton().createManual(
                                         mName + "/VTF", mMeshReference->getGroup(), texType,
                                         (uint)texWidth, (uint)texHeight,
-                                        0, PF_FLOAT32_RGBA, TU_DYNAMIC_WRITE_ONLY_DISCARDABLE );
+                                        0, PF_FLOAT32_RGBA, getVertexTextureUsage() );
+        }
 
         //Set our cloned material to use this custom texture!
         setupMaterialToUseVTF( texType, mMaterial );
     }
 
+    //-----------------------------------------------------------------------
+    size_t BaseInstanceBatchVTF::getSlotOffset( size_t slot ) const
+    {
+        const size_t floatPerEntity = mMatricesPerInstance * mRowLength * 4;
+        const size_t entitiesPerPadding = (size_t)(mMaxFloatsPerLine / floatPerEntity);
+        return floatPerEntity * slot + (size_t)(slot / entitiesPerPadding) * mWidthFloatsPadding;
+    }
+    //-----------------------------------------------------------------------
+    void BaseInstanceBatchVTF::createBakedAnimationLayout(void)
+    {
+        mBakedAnimations.clear();
+        mNumBakedPalettes = 1; //The binding pose
+
+        const SkeletonPtr &skeleton = mMeshReference->getSkeleton();
+        if( !skeleton )
+            return;
+
+        for( unsigned short i=0; i<skeleton->getNumAnimations(); ++i )
+        {
+            const Animation *animation = skeleton->getAnimation( i );
+            //Include both ends, so that non looping animations stop at their last pose
+            const size_t numFrames = static_cast<size_t>(
+                    Math::Ceil( animation->getLength() * mBakedAnimationFrameRate ) ) + 1;
+            mBakedAnimations[animation->getName()] = std::make_pair( mNumBakedPalettes, numFrames );
+            mNumBakedPalettes += numFrames;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BaseInstanceBatchVTF::bakeAnimations(void)
+    {
+        mMatrixTexture->getBuffer()->lock( HardwareBuffer::HBL_DISCARD );
+        const PixelBox &pixelBox = mMatrixTexture->getBuffer()->getCurrentLock();
+        float *pSource = static_cast<float*>(pixelBox.data);
+
+        SkeletonInstance *skeleton = 0;
+        AnimationStateSet animationStates;
+        Matrix4Vec boneMatrices;
+        if( mMeshReference->getSkeleton() )
+        {
+            skeleton = OGRE_NEW SkeletonInstance( mMeshReference->getSkeleton() );
+            skeleton->load();
+            skeleton->_initAnimationState( &animationStates );
+            boneMatrices.resize( skeleton->getNumBones() );
+        }
+
+        for( size_t palette=0; palette<mNumBakedPalettes; ++palette )
+        {
+            float *pDest = pSource + getSlotOffset( palette );
+            float *transforms = mUseBoneDualQuaternions ? mTempTransformsArray3x4 : pDest;
+
+            if( skeleton )
+            {
+                //Find the animation & frame of this palette, the first one is the binding pose
+                BakedAnimationMap::const_iterator itor = mBakedAnimations.begin();
+                BakedAnimationMap::const_iterator end  = mBakedAnimations.end();
+                while( itor != end && (palette < itor->second.first ||
+                                       palette >= itor->second.first + itor->second.second) )
+                    ++itor;
+
+                AnimationState *state = 0;
+                if( itor != end )
+                {
+                    state = animationStates.getAnimationState( itor->first );
+                    state->setLoop( false );
+                    state->setEnabled( true );
+                    state->setWeight( 1.0f );
+                    state->setTimePosition( std::min( state->getLength(),
+                            (palette - itor->second.first) / mBakedAnimationFrameRate ) );
+                }
+
+                skeleton->setAnimationState( animationStates );
+                skeleton->_getBoneMatrices( &boneMatrices[0] );
+
+                if( state )
+                    state->setEnabled( false );
+            }
+
+            //Without bones, a single identity matrix just like InstancedEntity::getTransforms3x4
+            float *xform = transforms;
+            for( size_t m=0; m<mMatricesPerInstance; ++m )
+            {
+                const Matrix4 &mat = skeleton && !mIndexToBoneMap->empty() ?
+                                        boneMatrices[(*mIndexToBoneMap)[m]] : Matrix4::IDENTITY;
+                for( int i=0; i<3; ++i )
+                {
+                    Real const *row = mat[i];
+                    for( int j=0; j<4; ++j )
+                        *xform++ = static_cast<float>( *row++ );
+                }
+            }
+
+            if( mUseBoneDualQuaternions )
+                convert3x4MatricesToDualQuaternions( transforms, mMatricesPerInstance, pDest );
+        }
+
+        OGRE_DELETE skeleton;
+
+        mMatrixTexture->getBuffer()->unlock();
+    }
+    //-----------------------------------------------------------------------
+    void BaseInstanceBatchVTF::setBakedAnimation( Real frameRate )
+    {
+        assert( mInstancedEntities.empty() );
+        mBakedAnimationFrameRate = frameRate;
+        //The palettes are in object space, the world transform of each instance is looked up
+        if( useBakedAnimation() )
+            mUseBoneMatrixLookup = true;
+    }
+    //-----------------------------------------------------------------------
+    size_t BaseInstanceBatchVTF::getBakedPalette( const InstancedEntity *entity ) const
+    {
+        const AnimationStateSet *animationStates = entity->getAllAnimationStates();
+        if( animationStates && animationStates->hasEnabledAnimationState() )
+        {
+            const AnimationState *state = animationStates->getEnabledAnimationStates().front();
+            BakedAnimationMap::const_iterator itor = mBakedAnimations.find( state->getAnimationName() );
+            if( itor != mBakedAnimations.end() )
+            {
+                const size_t frame = static_cast<size_t>(
+                                        state->getTimePosition() * mBakedAnimationFrameRate + 0.5f );
+                return itor->second.first + std::min( frame, itor->second.second - 1 );
+            }
+        }
+
+        return 0;
+    }
     //-----------------------------------------------------------------------
     size_t BaseInstanceBatchVTF::convert3x4MatricesToDualQuaternions(float* matrices, size_t numOfMatrices, float* outDualQuaternions)
     {
@@ -389,7 +548,8 @@ namespace Ogre
     {
         if (mTransformSharingDirty)
         {
-            if (useBoneMatrixLookup())
+            //Baked animations are looked up by their own palette, not by shared transforms
+            if (useBoneMatrixLookup() && !useBakedAnimation())
             {
                 //In each entity update the "transform lookup number" so that:
                 // 1. All entities sharing the same transformation will share the same unique number
@@ -432,7 +592,7 @@ namespace Ogre
     InstancedEntity* BaseInstanceBatchVTF::generateInstancedEntity(size_t num)
     {
         InstancedEntity* sharedTransformEntity = NULL;
-        if ((useBoneMatrixLookup()) && (num >= getMaxLookupTableInstances()))
+        if ((useBoneMatrixLookup()) && !useBakedAnimation() && (num >= getMaxLookupTableInstances()))
         {
             sharedTransformEntity = mInstancedEntities[num % getMaxLookupTableInstances()];
             if (sharedTransformEntity->mSharedTransformEntity)
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "OgreSubMesh.h"
 #include "OgreMeshManager.h"
 #include "OgreMaterialManager.h"
+#include "OgreTextureManager.h"
 #include "OgreSceneManager.h"
 #include "OgreHardwareBufferManager.h"
 #include "OgreSceneNode.h"
@@ -54,6 +55,7 @@ namespace Ogre
                 mSubMeshIdx( subMeshIdx ),
                 mSceneManager( sceneManager ),
                 mMaxLookupTableInstances(16),
+                mBakedAnimationFrameRate(30),
                 mNumCustomParams( 0 )
     {
         mMeshReference = MeshManager::getSingleton().load( meshName, groupName );
@@ -81,6 +83,11 @@ namespace Ogre
 
             ++itor;
         }
+
+        //The baked animation texture is shared by all our batches
+        const String bakedName = mName + "/BakedAnimation";
+        if( TextureManager::getSingleton().resourceExists( bakedName, mMeshReference->getGroup() ) )
+            TextureManager::getSingleton().remove( bakedName, mMeshReference->getGroup() );
     }
     //----------------------------------------------------------------------
     void InstanceManager::setInstancesPerBatch( size_t instancesPerBatch )
@@ -105,6 +112,17 @@ namespace Ogre
 
         mMaxLookupTableInstances = maxLookupTableInstances;
     }
+    //----------------------------------------------------------------------
+    void InstanceManager::setBakedAnimationFrameRate( Real frameRate )
+    {
+        if( !mInstanceBatches.empty() )
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "Baked animation frame rate can only be changed"
+                " before building the batch.", "InstanceManager::setBakedAnimationFrameRate");
+        }
+
+        mBakedAnimationFrameRate = frameRate;
+    }
     
     //----------------------------------------------------------------------
     void InstanceManager::setNumCustomParams( unsigned char numCustomParams )
@@ -151,6 +169,7 @@ namespace Ogre
             batch = OGRE_NEW InstanceBatchHW_VTF( this, mMeshReference, mat, suggestedSize,
                                                     0, mName + "/TempBatch" );
             static_cast<InstanceBatchHW_VTF*>(batch)->setBoneMatrixLookup((mInstancingFlags & IM_VTFBONEMATRIXLOOKUP) != 0, mMaxLookupTableInstances);
+            static_cast<InstanceBatchHW_VTF*>(batch)->setBakedAnimation((mInstancingFlags & IM_VTFBAKEDANIMATION) ? mBakedAnimationFrameRate : 0);
             static_cast<InstanceBatchHW_VTF*>(batch)->setBoneDualQuaternions((mInstancingFlags & IM_USEBONEDUALQUATERNIONS) != 0);
             static_cast<InstanceBatchHW_VTF*>(batch)->setUseOneWeight((mInstancingFlags & IM_USEONEWEIGHT) != 0);
             static_cast<InstanceBatchHW_VTF*>(batch)->setForceOneWeight((mInstancingFlags & IM_FORCEONEWEIGHT) != 0);
@@ -240,6 +259,7 @@ namespace Ogre
                                                     &idxMap, mName + "/InstanceBatch_" +
                                                     StringConverter::toString(mIdCount++) );
             static_cast<InstanceBatchHW_VTF*>(batch)->setBoneMatrixLookup((mInstancingFlags & IM_VTFBONEMATRIXLOOKUP) != 0, mMaxLookupTableInstances);
+            static_cast<InstanceBatchHW_VTF*>(batch)->setBakedAnimation((mInstancingFlags & IM_VTFBAKEDANIMATION) ? mBakedAnimationFrameRate : 0);
             static_cast<InstanceBatchHW_VTF*>(batch)->setBoneDualQuaternions((mInstancingFlags & IM_USEBONEDUALQUATERNIONS) != 0);
             static_cast<InstanceBatchHW_VTF*>(batch)->setUseOneWeight((mInstancingFlags & IM_USEONEWEIGHT) != 0);
             static_cast<InstanceBatchHW_VTF*>(batch)->setForceOneWeight((mInstancingFlags & IM_FORCEONEWEIGHT) != 0);
@@ -277,6 +297,7 @@ namespace Ogre
 
         const BatchSettings &batchSettings = mBatchSettings[materialName];
         batch->setCastShadows( batchSettings.setting[CAST_SHADOWS] );
+        batch->setGpuCulling( batchSettings.setting[GPU_CULLING] );
 
         //Batches need to be part of a scene node so that their renderable can be rendered
         SceneNode *sceneNode = mSceneManager->getRootSceneNode()->createChildSceneNode();
@@ -462,6 +483,9 @@ namespace Ogre
             case SHOW_BOUNDINGBOX:
                 (*itor)->getParentSceneNode()->showBoundingBox( value );
                 break;
+            case GPU_CULLING:
+                (*itor)->setGpuCulling( value );
+                break;
             default:
                 break;
             }
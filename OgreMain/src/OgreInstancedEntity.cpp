@@ -58,7 +58,9 @@ namespace Ogre
                 mMaxScaleLocal(1),
                 mNeedTransformUpdate(true),
                 mNeedAnimTransformUpdate(true),
-                mUseLocalTransform(false)
+                mUseLocalTransform(false),
+                mNeedBatchDataUpdate(true),
+                mKeepStatic(false)
 
     
     {
@@ -443,6 +445,7 @@ namespace Ogre
     {
         mNeedTransformUpdate = true;
         mNeedAnimTransformUpdate = true; 
+        mNeedBatchDataUpdate = true;
         mBatchOwner->_boundsDirty();
     }
 
@@ -519,6 +522,8 @@ namespace Ogre
         mInUse = used;
         //Remove the use of local transform if the object is deleted
         mUseLocalTransform &= used;
+        //Our slot in the batch may hold data of a previous life
+        mNeedBatchDataUpdate |= used;
     }
     //---------------------------------------------------------------------------
     void InstancedEntity::setCustomParam( unsigned char idx, const Vector4 &newParam )
@@ -0,0 +1,314 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreLightClusters.h"
+#include "OgreCamera.h"
+#include "OgreLight.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "Threading/OgreParallel.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    struct LightClusters::SliceBinner
+    {
+        LightClusters* clusters;
+        SliceBinner(LightClusters* c) : clusters(c) {}
+        void operator()(size_t slice) const { clusters->binSlice(slice); }
+    };
+    //-----------------------------------------------------------------------
+    namespace
+    {
+        struct LightNearer
+        {
+            Vector3 position;
+            LightNearer(const Vector3& p) : position(p) {}
+            bool operator()(const Light* a, const Light* b) const
+            {
+                return a->getDerivedPosition().squaredDistance(position) <
+                    b->getDerivedPosition().squaredDistance(position);
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
+    LightClusters::LightClusters(const String& name)
+        : mName(name)
+        , mDirectionalLightCount(0)
+        , mNearDistance(1)
+        , mFarDistance(2)
+        , mGridParams(Vector4::ZERO)
+    {
+        setGrid(16, 8, 24);
+    }
+    //-----------------------------------------------------------------------
+    LightClusters::~LightClusters()
+    {
+        if (mTexture)
+            TextureManager::getSingleton().remove(mTexture->getHandle());
+    }
+    //-----------------------------------------------------------------------
+    void LightClusters::setGrid(uint16 tilesX, uint16 tilesY, uint16 slices,
+        uint16 maxLightsPerCluster, uint16 maxLights)
+    {
+        if (!tilesX || !tilesY || !slices || !maxLightsPerCluster || !maxLights)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "The light cluster grid must not be empty", "LightClusters::setGrid");
+        }
+        mTilesX = tilesX;
+        mTilesY = tilesY;
+        mSlices = slices;
+        mMaxLightsPerCluster = maxLightsPerCluster;
+        mMaxLights = maxLights;
+
+        mClusterLights.resize(getClusterCount() * mMaxLightsPerCluster);
+        mClusterLightCounts.assign(getClusterCount(), 0);
+        mLights.clear();
+        mLightSpheres.clear();
+        mLightSlices.clear();
+        mDirectionalLightCount = 0;
+
+        // sized on the next upload
+        if (mTexture)
+        {
+            TextureManager::getSingleton().remove(mTexture->getHandle());
+            mTexture.reset();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void LightClusters::build(const Camera* cam, const LightList& lights)
+    {
+        build(cam->getViewMatrix(true), cam->getProjectionMatrix(),
+            cam->getNearClipDistance(), cam->getFarClipDistance(), lights);
+    }
+    //-----------------------------------------------------------------------
+    void LightClusters::build(const Matrix4& viewMatrix, const Matrix4& projMatrix,
+        Real nearDistance, Real farDistance, const LightList& lights)
+    {
+        mViewMatrix = viewMatrix;
+        mProjMatrix = projMatrix;
+        mNearDistance = nearDistance;
+        mFarDistance = farDistance;
+
+        // directional lights first, then the nearest of the others
+        mLights.clear();
+        LightList others;
+        for (LightList::const_iterator i = lights.begin(); i != lights.end(); ++i)
+        {
+            if ((*i)->getType() == Light::LT_DIRECTIONAL)
+            {
+                if (mLights.size() < mMaxLights)
+                    mLights.push_back(*i);
+            }
+            else
+                others.push_back(*i);
+        }
+        mDirectionalLightCount = mLights.size();
+        size_t room = mMaxLights - mDirectionalLightCount;
+        if (others.size() > room)
+        {
+            std::partial_sort(others.begin(), others.begin() + room, others.end(),
+                LightNearer(mViewMatrix.inverseAffine().getTrans()));
+            others.resize(room);
+        }
+
+        // bounding spheres and depth ranges in view space, the spot cones are bounded
+        // by the sphere of their range
+        mLightSpheres.clear();
+        Real farthest = mNearDistance * 2;
+        for (LightList::iterator i = others.begin(); i != others.end(); ++i)
+        {
+            Vector3 centre = mViewMatrix.transformAffine((*i)->getDerivedPosition());
+            Real range = (*i)->getAttenuationRange();
+            if (-centre.z + range < mNearDistance)
+                continue;
+            mLights.push_back(*i);
+            mLightSpheres.push_back(Vector4(centre.x, centre.y, centre.z, range));
+            farthest = std::max(farthest, -centre.z + range);
+        }
+
+        // exponential slices up to the far plane, or the farthest light if infinite
+        if (mFarDistance == 0 || mFarDistance > farthest)
+            mFarDistance = farthest;
+        Real scale = mSlices / Math::Log(mFarDistance / mNearDistance);
+        mGridParams = Vector4(mTilesX, mTilesY, scale, -Math::Log(mNearDistance) * scale);
+
+        mLightSlices.resize(mLightSpheres.size());
+        for (size_t i = 0; i < mLightSpheres.size(); ++i)
+        {
+            const Vector4& sphere = mLightSpheres[i];
+            mLightSlices[i].first = getSlice(-sphere.z - sphere.w);
+            mLightSlices[i].second = getSlice(-sphere.z + sphere.w);
+        }
+
+        std::fill(mClusterLightCounts.begin(), mClusterLightCounts.end(), 0);
+        parallelFor(0, mSlices, SliceBinner(this));
+    }
+    //-----------------------------------------------------------------------
+    size_t LightClusters::getSlice(Real depth) const
+    {
+        if (depth <= mNearDistance)
+            return 0;
+        Real slice = Math::Floor(Math::Log(depth) * mGridParams.z + mGridParams.w);
+        return static_cast<size_t>(Math::Clamp<Real>(slice, 0, mSlices - 1));
+    }
+    //-----------------------------------------------------------------------
+    void LightClusters::binSlice(size_t slice)
+    {
+        // depth range of the slice
+        Real sliceNear = Math::Exp((slice - mGridParams.w) / mGridParams.z);
+        Real sliceFar = Math::Exp((slice + 1 - mGridParams.w) / mGridParams.z);
+
+        for (size_t i = 0; i < mLightSpheres.size(); ++i)
+        {
+            if (slice < mLightSlices[i].first || slice > mLightSlices[i].second)
+                continue;
+
+            // project the box around the part of the sphere inside the slice
+            const Vector4& sphere = mLightSpheres[i];
+            Real depthNear = std::max(std::max(sliceNear, -sphere.z - sphere.w), mNearDistance);
+            Real depthFar = std::min(sliceFar, -sphere.z + sphere.w);
+            if (depthFar < depthNear)
+                continue;
+            Real minX = Math::POS_INFINITY, maxX = Math::NEG_INFINITY;
+            Real minY = Math::POS_INFINITY, maxY = Math::NEG_INFINITY;
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                Vector4 clip = mProjMatrix * Vector4(
+                    sphere.x + (corner & 1 ? sphere.w : -sphere.w),
+                    sphere.y + (corner & 2 ? sphere.w : -sphere.w),
+                    corner & 4 ? -depthFar : -depthNear, 1);
+                minX = std::min(minX, clip.x / clip.w);
+                maxX = std::max(maxX, clip.x / clip.w);
+                minY = std::min(minY, clip.y / clip.w);
+                maxY = std::max(maxY, clip.y / clip.w);
+            }
+            if (maxX < -1 || minX > 1 || maxY < -1 || minY > 1)
+                continue;
+
+            size_t x0 = static_cast<size_t>(Math::Clamp<Real>(Math::Floor((minX * 0.5f + 0.5f) * mTilesX), 0, mTilesX - 1));
+            size_t x1 = static_cast<size_t>(Math::Clamp<Real>(Math::Floor((maxX * 0.5f + 0.5f) * mTilesX), 0, mTilesX - 1));
+            size_t y0 = static_cast<size_t>(Math::Clamp<Real>(Math::Floor((minY * 0.5f + 0.5f) * mTilesY), 0, mTilesY - 1));
+            size_t y1 = static_cast<size_t>(Math::Clamp<Real>(Math::Floor((maxY * 0.5f + 0.5f) * mTilesY), 0, mTilesY - 1));
+            uint16 lightIndex = static_cast<uint16>(mDirectionalLightCount + i);
+            for (size_t y = y0; y <= y1; ++y)
+            {
+                for (size_t x = x0; x <= x1; ++x)
+                {
+                    size_t cluster = x + (y + slice * mTilesY) * mTilesX;
+                    uint16& count = mClusterLightCounts[cluster];
+                    if (count < mMaxLightsPerCluster)
+                        mClusterLights[cluster * mMaxLightsPerCluster + count++] = lightIndex;
+                }
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    size_t LightClusters::getClusterLightCount(size_t x, size_t y, size_t slice) const
+    {
+        assert(x < mTilesX && y < mTilesY && slice < mSlices);
+        return mClusterLightCounts[x + (y + slice * mTilesY) * mTilesX];
+    }
+    //-----------------------------------------------------------------------
+    const uint16* LightClusters::getClusterLights(size_t x, size_t y, size_t slice) const
+    {
+        assert(x < mTilesX && y < mTilesY && slice < mSlices);
+        return &mClusterLights[(x + (y + slice * mTilesY) * mTilesX) * mMaxLightsPerCluster];
+    }
+    //-----------------------------------------------------------------------
+    void LightClusters::_updateTexture(void)
+    {
+        size_t clusterCount = getClusterCount();
+        size_t indexCount = 0;
+        for (size_t c = 0; c < clusterCount; ++c)
+            indexCount += mClusterLightCounts[c];
+
+        size_t texelCount = getIndexStart() + indexCount;
+        size_t rows = (texelCount + TEXTURE_WIDTH - 1) / TEXTURE_WIDTH;
+        mTexels.assign(rows * TEXTURE_WIDTH * 4, 0.0f);
+
+        // headers and compacted light indices
+        size_t index = getIndexStart();
+        for (size_t c = 0; c < clusterCount; ++c)
+        {
+            float* header = &mTexels[c * 4];
+            header[0] = static_cast<float>(index);
+            header[1] = mClusterLightCounts[c];
+            const uint16* lights = &mClusterLights[c * mMaxLightsPerCluster];
+            for (uint16 l = 0; l < mClusterLightCounts[c]; ++l)
+                mTexels[(index++) * 4] = lights[l];
+        }
+
+        // lights in view space
+        Matrix3 viewRotation;
+        mViewMatrix.extract3x3Matrix(viewRotation);
+        for (size_t l = 0; l < mLights.size(); ++l)
+        {
+            const Light* light = mLights[l];
+            float* texel = &mTexels[(getLightStart() + l * LIGHT_TEXELS) * 4];
+
+            Vector3 position = mViewMatrix.transformAffine(light->getDerivedPosition());
+            Vector3 direction = -(viewRotation * light->getDerivedDirection());
+            direction.normalise();
+            ColourValue diffuse = light->getDiffuseColour() * light->getPowerScale();
+            ColourValue specular = light->getSpecularColour() * light->getPowerScale();
+            float type = light->getType() == Light::LT_POINT ? 0.0f :
+                light->getType() == Light::LT_DIRECTIONAL ? 1.0f : 2.0f;
+
+            const float values[LIGHT_TEXELS * 4] = {
+                position.x, position.y, position.z, type,
+                direction.x, direction.y, direction.z, 0,
+                diffuse.r, diffuse.g, diffuse.b, 0,
+                specular.r, specular.g, specular.b, 0,
+                light->getAttenuationRange(), light->getAttenuationConstant(),
+                light->getAttenuationLinear(), light->getAttenuationQuadric(),
+                Math::Cos(light->getSpotlightInnerAngle().valueRadians() * 0.5f),
+                Math::Cos(light->getSpotlightOuterAngle().valueRadians() * 0.5f),
+                light->getSpotlightFalloff(), 0 };
+            std::copy(values, values + LIGHT_TEXELS * 4, texel);
+        }
+
+        PixelBox src(TEXTURE_WIDTH, rows, 1, PF_FLOAT32_RGBA, &mTexels[0]);
+        getTexture()->getBuffer()->blitFromMemory(src, Box(0, 0, TEXTURE_WIDTH, rows));
+    }
+    //-----------------------------------------------------------------------
+    const TexturePtr& LightClusters::getTexture(void)
+    {
+        if (!mTexture)
+        {
+            // sized for full clusters
+            size_t height = (getIndexStart() + getClusterCount() * mMaxLightsPerCluster +
+                TEXTURE_WIDTH - 1) / TEXTURE_WIDTH;
+            mTexture = TextureManager::getSingleton().createManual(mName,
+                ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, TEX_TYPE_2D,
+                TEXTURE_WIDTH, static_cast<uint>(height), 0, PF_FLOAT32_RGBA,
+                TU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        }
+        return mTexture;
+    }
+}
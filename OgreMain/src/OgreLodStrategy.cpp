@@ -52,6 +52,11 @@ namespace Ogre {
         return getValueImpl(movableObject, camera->getLodCamera());
     }
     //-----------------------------------------------------------------------
+    ushort LodStrategy::getMeshLodIndex(Real value, const Mesh* mesh, ushort previousIndex) const
+    {
+        return mesh->getLodIndex(value);
+    }
+    //-----------------------------------------------------------------------
     void LodStrategy::assertSorted(const Mesh::LodValueList &values) const
     {
         assert(isSorted(values) && "The LOD values must be sorted");
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgreDistanceLodStrategy.h"
 #include "OgrePixelCountLodStrategy.h"
+#include "OgreScreenSpaceErrorLodStrategy.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -61,6 +62,10 @@ namespace Ogre {
         addStrategy(strategy);
         strategy = OGRE_NEW ScreenRatioPixelCountLodStrategy();
         addStrategy(strategy);
+
+        // Add strategy based on the geometric error of the levels
+        strategy = OGRE_NEW ScreenSpaceErrorLodStrategy();
+        addStrategy(strategy);
     }
     //-----------------------------------------------------------------------
     LodStrategyManager::~LodStrategyManager()
@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "OgreSubMesh.h"
 #include "OgreLogManager.h"
 #include "OgreTechnique.h"
+#include "OgreSceneManager.h"
 
 namespace Ogre {
 
@@ -45,10 +46,12 @@ namespace Ogre {
 #define TEMP_VERTEXSIZE_GUESS sizeof(float) * 12
 #define TEMP_INITIAL_VERTEX_SIZE TEMP_VERTEXSIZE_GUESS * TEMP_INITIAL_SIZE
 #define TEMP_INITIAL_INDEX_SIZE sizeof(uint32) * TEMP_INITIAL_SIZE
+#define DIRECT_UPDATE_RING_SIZE 3
     //-----------------------------------------------------------------------------
     ManualObject::ManualObject(const String& name)
         : MovableObject(name),
-          mDynamic(false), mCurrentSection(0), mCurrentUpdating(false), mFirstVertex(true),
+          mDynamic(false), mCurrentSection(0), mCurrentUpdating(false), mCurrentDirectUpdating(false),
+          mFirstVertex(true),
           mTempVertexPending(false),
           mTempVertexBuffer(0), mTempVertexSize(TEMP_INITIAL_VERTEX_SIZE),
           mTempIndexBuffer(0), mTempIndexSize(TEMP_INITIAL_INDEX_SIZE),
@@ -206,9 +209,150 @@ namespace Ogre {
         if (rop->indexData)
             rop->indexData->indexCount = 0;
         rop->useIndexes = false;
+        // Direct updates may have moved on in the buffers, start over
+        if (!rop->vertexData->isPooled())
+        {
+            rop->vertexData->vertexStart = 0;
+            if (rop->indexData)
+                rop->indexData->indexStart = 0;
+        }
         mDeclSize = rop->vertexData->vertexDeclaration->getVertexSize(0);
     }
     //-----------------------------------------------------------------------------
+    ManualObject::DirectUpdate ManualObject::beginDirectUpdate(size_t sectionIndex,
+        size_t vertexCount, size_t indexCount)
+    {
+        if (mCurrentSection)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "You cannot call beginDirectUpdate() until after you call end()",
+                "ManualObject::beginDirectUpdate");
+        }
+        if (sectionIndex >= mSectionList.size())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Invalid section index - out of range.",
+                "ManualObject::beginDirectUpdate");
+        }
+
+        ManualObjectSection* section = mSectionList[sectionIndex];
+        RenderOperation* rop = section->getRenderOperation();
+        VertexData* vertexData = rop->vertexData;
+        HardwareBufferManager& mgr = HardwareBufferManager::getSingleton();
+        HardwareBuffer::Usage usage = mDynamic ?
+            HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE : HardwareBuffer::HBU_STATIC_WRITE_ONLY;
+
+        // Pooled ranges can't be moved around, use buffers of our own
+        if (vertexData->isPooled())
+        {
+            mgr._releasePooledVertexData(vertexData);
+            vertexData->vertexStart = 0;
+            vertexData->vertexCount = 0;
+            if (rop->indexData && rop->indexData->isPooled())
+            {
+                mgr._releasePooledIndexData(rop->indexData);
+                rop->indexData->indexStart = 0;
+                rop->indexData->indexCount = 0;
+            }
+        }
+
+        DirectUpdate result;
+        result.vertexSize = vertexData->vertexDeclaration->getVertexSize(0);
+        result.vertexCount = vertexCount;
+        result.vertices = 0;
+        result.indexCount = indexCount;
+        result.indices = 0;
+        result.indices32Bit = false;
+
+        // Take the range after the last one, or start over with a discarded buffer
+        HardwareVertexBufferSharedPtr vbuf;
+        if (vertexData->vertexBufferBinding->isBufferBound(0))
+            vbuf = vertexData->vertexBufferBinding->getBuffer(0);
+        size_t vertexStart = vertexData->vertexStart + vertexData->vertexCount;
+        HardwareBuffer::LockOptions lockOptions = HardwareBuffer::HBL_NO_OVERWRITE;
+        if (!vbuf || vbuf->getNumVertices() < vertexCount)
+        {
+            vbuf = mgr.createVertexBuffer(result.vertexSize,
+                std::max(vertexCount * DIRECT_UPDATE_RING_SIZE, mEstVertexCount), usage);
+            vertexData->vertexBufferBinding->setBinding(0, vbuf);
+            vertexStart = 0;
+        }
+        else if (vertexStart + vertexCount > vbuf->getNumVertices())
+        {
+            vertexStart = 0;
+            lockOptions = HardwareBuffer::HBL_DISCARD;
+        }
+        vertexData->vertexStart = vertexStart;
+        vertexData->vertexCount = vertexCount;
+        if (vertexCount > 0)
+            result.vertices = vbuf->lock(vertexStart * result.vertexSize,
+                vertexCount * result.vertexSize, lockOptions);
+
+        rop->useIndexes = indexCount > 0;
+        if (rop->useIndexes)
+        {
+            if (!rop->indexData)
+                rop->indexData = OGRE_NEW IndexData();
+            IndexData* indexData = rop->indexData;
+            HardwareIndexBufferSharedPtr& ibuf = indexData->indexBuffer;
+
+            if (vertexCount > 65536)
+                section->set32BitIndices(true);
+            HardwareIndexBuffer::IndexType indexType = section->get32BitIndices() ?
+                HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT;
+
+            size_t indexStart = indexData->indexStart + indexData->indexCount;
+            lockOptions = HardwareBuffer::HBL_NO_OVERWRITE;
+            if (!ibuf || ibuf->getNumIndexes() < indexCount || ibuf->getType() != indexType)
+            {
+                ibuf = mgr.createIndexBuffer(indexType,
+                    std::max(indexCount * DIRECT_UPDATE_RING_SIZE, mEstIndexCount), usage);
+                indexStart = 0;
+            }
+            else if (indexStart + indexCount > ibuf->getNumIndexes())
+            {
+                indexStart = 0;
+                lockOptions = HardwareBuffer::HBL_DISCARD;
+            }
+            indexData->indexStart = indexStart;
+            indexData->indexCount = indexCount;
+            result.indices = ibuf->lock(indexStart * ibuf->getIndexSize(),
+                indexCount * ibuf->getIndexSize(), lockOptions);
+            result.indices32Bit = indexType == HardwareIndexBuffer::IT_32BIT;
+            mAnyIndexed = true;
+        }
+
+        mCurrentSection = section;
+        mCurrentDirectUpdating = true;
+        return result;
+    }
+    //-----------------------------------------------------------------------------
+    void ManualObject::endDirectUpdate(void)
+    {
+        if (!mCurrentDirectUpdating)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "You cannot call endDirectUpdate() until after you call beginDirectUpdate()",
+                "ManualObject::endDirectUpdate");
+        }
+
+        RenderOperation* rop = mCurrentSection->getRenderOperation();
+        HardwareVertexBufferSharedPtr vbuf = rop->vertexData->vertexBufferBinding->getBuffer(0);
+        if (vbuf->isLocked())
+            vbuf->unlock();
+        if (rop->useIndexes && rop->indexData->indexBuffer->isLocked())
+            rop->indexData->indexBuffer->unlock();
+
+        mCurrentSection = 0;
+        mCurrentDirectUpdating = false;
+
+        // Tell parent if present
+        if (mParentNode)
+        {
+            mParentNode->needUpdate();
+        }
+    }
+    //-----------------------------------------------------------------------------
     void ManualObject::position(const Vector3& pos)
     {
         position(pos.x, pos.y, pos.z);
@@ -623,6 +767,12 @@ namespace Ogre {
                 "You cannot call end() until after you call begin()",
                 "ManualObject::end");
         }
+        if (mCurrentDirectUpdating)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "You must call endDirectUpdate() to finish a direct update",
+                "ManualObject::end");
+        }
         if (mTempVertexPending)
         {
             // bake current vertex
@@ -666,7 +816,32 @@ namespace Ogre {
             // Work out if we require 16 or 32-bit index buffers
             HardwareIndexBuffer::IndexType indexType = mCurrentSection->get32BitIndices()?  
                 HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT;
-            if (mCurrentUpdating)
+            // Static sections take ranges of the buffer pools when enabled, unless
+            // they need an edge list for stencil shadows, which wants a vertex start of 0
+            HardwareBufferManager& mgr = HardwareBufferManager::getSingleton();
+            bool pooled = !mDynamic && mgr.getPoolPageSize() > 0 &&
+                !(mCastShadows && mManager && mManager->isShadowTechniqueStencilBased());
+            if (pooled)
+            {
+                mgr.createPooledVertexData(rop->vertexData, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+                vbuf = rop->vertexData->vertexBufferBinding->getBuffer(0);
+                if (rop->useIndexes)
+                    mgr.createPooledIndexData(rop->indexData, indexType, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+                vbufNeedsCreating = false;
+                ibufNeedsCreating = false;
+            }
+            else if (rop->vertexData->isPooled())
+            {
+                // Was pooled before, give the ranges back and create buffers of our own
+                mgr._releasePooledVertexData(rop->vertexData);
+                rop->vertexData->vertexStart = 0;
+                if (rop->indexData && rop->indexData->isPooled())
+                {
+                    mgr._releasePooledIndexData(rop->indexData);
+                    rop->indexData->indexStart = 0;
+                }
+            }
+            else if (mCurrentUpdating)
             {
                 // May be able to reuse buffers, check sizes
                 vbuf = rop->vertexData->vertexBufferBinding->getBuffer(0);
@@ -708,25 +883,28 @@ namespace Ogre {
                         mDynamic? HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY : 
                             HardwareBuffer::HBU_STATIC_WRITE_ONLY);
             }
-            // Write vertex data
+            // Write vertex data, pooled buffers only at our range
             vbuf->writeData(
-                0, rop->vertexData->vertexCount * vbuf->getVertexSize(), 
-                mTempVertexBuffer, true);
+                rop->vertexData->vertexStart * vbuf->getVertexSize(),
+                rop->vertexData->vertexCount * vbuf->getVertexSize(), 
+                mTempVertexBuffer, !pooled);
             // Write index data
             if(rop->useIndexes)
             {
+                size_t indexSize = rop->indexData->indexBuffer->getIndexSize();
                 if (HardwareIndexBuffer::IT_32BIT == indexType)
                 {
                     // direct copy from the mTempIndexBuffer
                     rop->indexData->indexBuffer->writeData(
-                        0, 
-                        rop->indexData->indexCount 
-                            * rop->indexData->indexBuffer->getIndexSize(),
-                        mTempIndexBuffer, true);
+                        rop->indexData->indexStart * indexSize,
+                        rop->indexData->indexCount * indexSize,
+                        mTempIndexBuffer, !pooled);
                 }
                 else //(HardwareIndexBuffer::IT_16BIT == indexType)
                 {
-                    uint16* pIdx = static_cast<uint16*>(rop->indexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+                    uint16* pIdx = static_cast<uint16*>(rop->indexData->indexBuffer->lock(
+                        rop->indexData->indexStart * indexSize, rop->indexData->indexCount * indexSize,
+                        pooled ? HardwareBuffer::HBL_NORMAL : HardwareBuffer::HBL_DISCARD));
                     uint32* pSrc = mTempIndexBuffer;
                     for (size_t i = 0; i < rop->indexData->indexCount; i++)
                     {
@@ -743,7 +921,9 @@ namespace Ogre {
         } // empty section check
 
         mCurrentSection = 0;
-        resetTempAreas();
+        // Dynamic objects are built again and again, keep the temp areas for next time
+        if (!mDynamic)
+            resetTempAreas();
 
         // Tell parent if present
         if (mParentNode)
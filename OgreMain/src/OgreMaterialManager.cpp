@@ -277,6 +277,46 @@ namespace Ogre {
         mListenerMap[schemeName].remove(l);
     }
     //---------------------------------------------------------------------
+    size_t MaterialManager::shareIdenticalProgramConstants(void)
+    {
+        vector<GpuProgramParameters*>::type params;
+        ResourceMapIterator it = getResourceIterator();
+        while (it.hasMoreElements())
+        {
+            Material* mat = static_cast<Material*>(it.getNext().get());
+            for (unsigned short t = 0; t < mat->getNumTechniques(); ++t)
+            {
+                Technique* tech = mat->getTechnique(t);
+                for (unsigned short p = 0; p < tech->getNumPasses(); ++p)
+                {
+                    Pass* pass = tech->getPass(p);
+                    if (pass->hasVertexProgram())
+                        params.push_back(pass->getVertexProgramParameters().get());
+                    if (pass->hasFragmentProgram())
+                        params.push_back(pass->getFragmentProgramParameters().get());
+                    if (pass->hasGeometryProgram())
+                        params.push_back(pass->getGeometryProgramParameters().get());
+                    if (pass->hasTessellationHullProgram())
+                        params.push_back(pass->getTessellationHullProgramParameters().get());
+                    if (pass->hasTessellationDomainProgram())
+                        params.push_back(pass->getTessellationDomainProgramParameters().get());
+                    if (pass->hasComputeProgram())
+                        params.push_back(pass->getComputeProgramParameters().get());
+                    if (pass->hasShadowCasterVertexProgram())
+                        params.push_back(pass->getShadowCasterVertexProgramParameters().get());
+                    if (pass->hasShadowCasterFragmentProgram())
+                        params.push_back(pass->getShadowCasterFragmentProgramParameters().get());
+                    if (pass->hasShadowReceiverVertexProgram())
+                        params.push_back(pass->getShadowReceiverVertexProgramParameters().get());
+                    if (pass->hasShadowReceiverFragmentProgram())
+                        params.push_back(pass->getShadowReceiverFragmentProgramParameters().get());
+                }
+            }
+        }
+
+        return GpuProgramParameters::shareIdenticalConstants(params);
+    }
+    //---------------------------------------------------------------------
     Technique* MaterialManager::_arbitrateMissingTechniqueForActiveScheme(
         Material* mat, unsigned short lodIndex, const Renderable* rend)
     {
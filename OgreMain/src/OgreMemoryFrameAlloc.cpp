@@ -0,0 +1,185 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgrePrerequisites.h"
+#include "OgreMemoryFrameAlloc.h"
+#include "OgreAlignedAllocator.h"
+#include "OgreAtomicScalar.h"
+
+namespace Ogre
+{
+	namespace
+	{
+		/// Size of the blocks the arenas are made of
+		const size_t FRAME_ARENA_BLOCK_SIZE = 256 * 1024;
+		/// Alignment of FrameAllocPolicy allocations
+		const size_t FRAME_ARENA_ALIGNMENT = 16;
+
+		/// The double buffered arena of a thread
+		class FrameArena : public GeneralAllocatedObject
+		{
+		public:
+			FrameArena(uint32 frame) : mCurrent(0), mFrame(frame) {}
+
+			~FrameArena()
+			{
+				for (size_t i = 0; i < 2; ++i)
+				{
+					for (size_t b = 0; b < mBuffers[i].blocks.size(); ++b)
+						AlignedMemory::deallocate(mBuffers[i].blocks[b].data);
+				}
+			}
+
+			void* allocate(size_t count, size_t alignment, uint32 frame)
+			{
+				if (frame != mFrame)
+				{
+					// The buffer of two frames ago is free again, unless this
+					// thread skipped frames in which case both are
+					if (frame - mFrame > 1)
+						reset(mBuffers[mCurrent]);
+					mCurrent ^= 1;
+					reset(mBuffers[mCurrent]);
+					mFrame = frame;
+				}
+
+				Buffer& buffer = mBuffers[mCurrent];
+				while (buffer.block < buffer.blocks.size())
+				{
+					void* ptr = allocateFromBlock(buffer, count, alignment);
+					if (ptr)
+						return ptr;
+
+					++buffer.block;
+					buffer.offset = 0;
+				}
+
+				// Out of space, chain a block big enough for this allocation
+				Block block;
+				block.size = std::max(FRAME_ARENA_BLOCK_SIZE, count + alignment);
+				block.data = static_cast<uchar*>(
+					AlignedMemory::allocate(block.size, FRAME_ARENA_ALIGNMENT));
+				buffer.blocks.push_back(block);
+				buffer.block = buffer.blocks.size() - 1;
+				buffer.offset = 0;
+
+				return allocateFromBlock(buffer, count, alignment);
+			}
+
+		private:
+			struct Block
+			{
+				uchar* data;
+				size_t size;
+			};
+
+			struct Buffer
+			{
+				vector<Block>::type blocks;
+				/// Block and offset of the next allocation
+				size_t block;
+				size_t offset;
+
+				Buffer() : block(0), offset(0) {}
+			};
+
+			Buffer mBuffers[2];
+			/// Buffer allocated from this frame
+			uint32 mCurrent;
+			/// Frame mCurrent belongs to
+			uint32 mFrame;
+
+			static void* allocateFromBlock(Buffer& buffer, size_t count, size_t alignment)
+			{
+				Block& block = buffer.blocks[buffer.block];
+				size_t start = (reinterpret_cast<size_t>(block.data) + buffer.offset + alignment - 1)
+					& ~(alignment - 1);
+				start -= reinterpret_cast<size_t>(block.data);
+
+				if (start + count > block.size)
+					return 0;
+
+				buffer.offset = start + count;
+				return block.data + start;
+			}
+
+			static void reset(Buffer& buffer)
+			{
+				// Merge chained blocks, so the next frames fit in one
+				if (buffer.blocks.size() > 1)
+				{
+					size_t size = 0;
+					for (size_t b = 0; b < buffer.blocks.size(); ++b)
+					{
+						size += buffer.blocks[b].size;
+						AlignedMemory::deallocate(buffer.blocks[b].data);
+					}
+					buffer.blocks.resize(1);
+					buffer.blocks[0].size = size;
+					buffer.blocks[0].data = static_cast<uchar*>(
+						AlignedMemory::allocate(size, FRAME_ARENA_ALIGNMENT));
+				}
+
+				buffer.block = 0;
+				buffer.offset = 0;
+			}
+		};
+
+		AtomicScalar<uint32> sFrameNumber(0);
+		OGRE_WQ_THREAD_POINTER_VAR(FrameArena, sFrameArena);
+	}
+	//---------------------------------------------------------------------
+	void* FrameAllocPolicy::allocateBytes(size_t count, const char*, int, const char*)
+	{
+		return allocateAlignedBytes(count, FRAME_ARENA_ALIGNMENT);
+	}
+	//---------------------------------------------------------------------
+	void* FrameAllocPolicy::allocateAlignedBytes(size_t count, size_t alignment)
+	{
+		FrameArena* arena = OGRE_WQ_THREAD_POINTER_GET(sFrameArena);
+		uint32 frame = sFrameNumber.load();
+
+		if (!arena)
+		{
+			arena = OGRE_NEW FrameArena(frame);
+			OGRE_WQ_THREAD_POINTER_SET(sFrameArena, arena);
+		}
+
+		return arena->allocate(count, std::max(alignment, FRAME_ARENA_ALIGNMENT), frame);
+	}
+	//---------------------------------------------------------------------
+	void FrameAllocPolicy::_nextFrame()
+	{
+		++sFrameNumber;
+	}
+	//---------------------------------------------------------------------
+	void FrameAllocPolicy::_releaseThreadArena()
+	{
+		OGRE_WQ_THREAD_POINTER_DELETE(sFrameArena);
+	}
+}
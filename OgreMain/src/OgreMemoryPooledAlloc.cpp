@@ -0,0 +1,245 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgrePrerequisites.h"
+#include "OgreMemoryPooledAlloc.h"
+#include "OgreAlignedAllocator.h"
+#include "OgreAtomicScalar.h"
+#include "OgreMemoryTracker.h"
+
+namespace Ogre
+{
+	namespace
+	{
+		/// Requests up to 256 bytes are pooled at a 16 byte granularity, larger
+		/// ones at a 64 byte granularity
+		const size_t SMALL_CLASS_LIMIT = 256;
+		const size_t SMALL_CLASS_COUNT = SMALL_CLASS_LIMIT / 16;
+		const size_t CLASS_COUNT = SMALL_CLASS_COUNT + 
+			(PooledAllocImpl::MAX_POOLED_SIZE - SMALL_CLASS_LIMIT) / 64;
+		/// Size of the slabs blocks are carved from
+		const size_t SLAB_SIZE = 64 * 1024;
+
+		size_t classFromSize(size_t size)
+		{
+			if (size <= SMALL_CLASS_LIMIT)
+				return (size - 1) >> 4;
+			return SMALL_CLASS_COUNT + ((size - SMALL_CLASS_LIMIT - 1) >> 6);
+		}
+
+		size_t sizeFromClass(size_t sizeClass)
+		{
+			if (sizeClass < SMALL_CLASS_COUNT)
+				return (sizeClass + 1) << 4;
+			return SMALL_CLASS_LIMIT + ((sizeClass - SMALL_CLASS_COUNT + 1) << 6);
+		}
+
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+
+		/// The pools of one thread
+		class ThreadPools : public GeneralAllocatedObject
+		{
+		public:
+			struct Pool
+			{
+				/// Blocks freed by the owning thread
+				FreeBlock* freeList;
+				/// Blocks freed by other threads, pushed without locking
+				AtomicScalar<size_t> remoteFreeList;
+				/// Unused part of the current slab
+				uchar* slabPos;
+				uchar* slabEnd;
+			};
+
+			ThreadPools()
+			{
+				for (size_t i = 0; i < MEMCATEGORY_COUNT * CLASS_COUNT; ++i)
+				{
+					mPools[i].freeList = 0;
+					mPools[i].remoteFreeList.store(0);
+					mPools[i].slabPos = 0;
+					mPools[i].slabEnd = 0;
+				}
+			}
+
+			void* allocate(size_t index)
+			{
+				Pool& pool = mPools[index];
+				FreeBlock* block = pool.freeList;
+
+				if (!block)
+				{
+					// Take over everything other threads gave back
+					size_t head = pool.remoteFreeList.load();
+					while (head && !pool.remoteFreeList.compare_exchange_strong(head, 0))
+						head = pool.remoteFreeList.load();
+					block = reinterpret_cast<FreeBlock*>(head);
+				}
+
+				if (block)
+				{
+					pool.freeList = block->next;
+					return block;
+				}
+
+				size_t blockSize = sizeFromClass(index % CLASS_COUNT);
+				if (pool.slabPos + blockSize > pool.slabEnd)
+				{
+					pool.slabPos = static_cast<uchar*>(
+						AlignedMemory::allocate(SLAB_SIZE, PooledAllocImpl::HEADER_SIZE));
+					pool.slabEnd = pool.slabPos + SLAB_SIZE;
+					mSlabs.push_back(pool.slabPos);
+				}
+
+				void* ptr = pool.slabPos;
+				pool.slabPos += blockSize;
+				return ptr;
+			}
+
+			void deallocate(size_t index, void* ptr, bool owner)
+			{
+				Pool& pool = mPools[index];
+				FreeBlock* block = static_cast<FreeBlock*>(ptr);
+
+				if (owner)
+				{
+					block->next = pool.freeList;
+					pool.freeList = block;
+					return;
+				}
+
+				for (;;)
+				{
+					size_t head = pool.remoteFreeList.load();
+					block->next = reinterpret_cast<FreeBlock*>(head);
+					if (pool.remoteFreeList.compare_exchange_strong(head, reinterpret_cast<size_t>(block)))
+						break;
+				}
+			}
+
+		private:
+			Pool mPools[MEMCATEGORY_COUNT * CLASS_COUNT];
+			/// Slabs are only released with the process, blocks may still be
+			/// handed back after the owning thread is gone
+			vector<uchar*>::type mSlabs;
+		};
+
+		/// Pools of finished threads, waiting for a new thread
+		vector<ThreadPools*>::type sFreeThreadPools;
+		OGRE_WQ_STATIC_MUTEX(sFreeThreadPoolsMutex);
+
+		/// Thread local owner of the pools of a thread, handing them back 
+		/// when the thread finishes
+		class ThreadPoolsHandle : public GeneralAllocatedObject
+		{
+		public:
+			ThreadPools* pools;
+
+			ThreadPoolsHandle()
+			{
+				OGRE_WQ_LOCK_MUTEX(sFreeThreadPoolsMutex);
+				if (sFreeThreadPools.empty())
+				{
+					pools = OGRE_NEW ThreadPools();
+				}
+				else
+				{
+					pools = sFreeThreadPools.back();
+					sFreeThreadPools.pop_back();
+				}
+			}
+
+			~ThreadPoolsHandle()
+			{
+				OGRE_WQ_LOCK_MUTEX(sFreeThreadPoolsMutex);
+				sFreeThreadPools.push_back(pools);
+			}
+		};
+
+		OGRE_WQ_THREAD_POINTER_VAR(ThreadPoolsHandle, sThreadPools);
+
+		ThreadPools* getThreadPools()
+		{
+			ThreadPoolsHandle* handle = OGRE_WQ_THREAD_POINTER_GET(sThreadPools);
+			if (!handle)
+			{
+				handle = OGRE_NEW ThreadPoolsHandle();
+				OGRE_WQ_THREAD_POINTER_SET(sThreadPools, handle);
+			}
+			return handle->pools;
+		}
+	}
+	//---------------------------------------------------------------------
+	void* PooledAllocImpl::allocBytes(size_t count, MemoryCategory category,
+		const char* file, int line, const char* func)
+	{
+		ThreadPools* pools = getThreadPools();
+		size_t index = category * CLASS_COUNT + classFromSize(count + HEADER_SIZE);
+
+		// The header holds the owning pools and the pool index
+		uchar* block = static_cast<uchar*>(pools->allocate(index));
+		reinterpret_cast<ThreadPools**>(block)[0] = pools;
+		reinterpret_cast<size_t*>(block)[1] = index;
+
+		void* ptr = block + HEADER_SIZE;
+#if OGRE_MEMORY_STATS
+		MemoryStatsImpl::recordAlloc(category, sizeFromClass(index % CLASS_COUNT));
+#endif
+#if OGRE_MEMORY_TRACKER
+		MemoryTracker::get()._recordAlloc(ptr, count, 0, file, line, func);
+#else
+		// avoid unused params warning
+		(void)file;
+		(void)line;
+		(void)func;
+#endif
+		return ptr;
+	}
+	//---------------------------------------------------------------------
+	void PooledAllocImpl::deallocBytes(void* ptr)
+	{
+		// deal with null
+		if (!ptr)
+			return;
+#if OGRE_MEMORY_TRACKER
+		MemoryTracker::get()._recordDealloc(ptr);
+#endif
+		uchar* block = static_cast<uchar*>(ptr) - HEADER_SIZE;
+		ThreadPools* owner = reinterpret_cast<ThreadPools**>(block)[0];
+		size_t index = reinterpret_cast<size_t*>(block)[1];
+#if OGRE_MEMORY_STATS
+		MemoryStatsImpl::recordDealloc(static_cast<MemoryCategory>(index / CLASS_COUNT), sizeFromClass(index % CLASS_COUNT));
+#endif
+
+		ThreadPoolsHandle* handle = OGRE_WQ_THREAD_POINTER_GET(sThreadPools);
+		owner->deallocate(index, block, handle && handle->pools == owner);
+	}
+}
@@ -0,0 +1,215 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreMemoryStats.h"
+#include "OgreAtomicScalar.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        AtomicScalar<size_t> sCategoryBytes[MEMCATEGORY_COUNT];
+        AtomicScalar<size_t> sCategoryCount[MEMCATEGORY_COUNT];
+        AtomicScalar<size_t> sPoolCpuBytes[MemoryStats::POOL_COUNT];
+        AtomicScalar<size_t> sPoolGpuBytes[MemoryStats::POOL_COUNT];
+        AtomicScalar<size_t> sPoolCount[MemoryStats::POOL_COUNT];
+
+        /// Budgets and whether they were exceeded, categories then pools
+        size_t sBudgets[MEMCATEGORY_COUNT + MemoryStats::POOL_COUNT] = { 0 };
+        bool sExceeded[MEMCATEGORY_COUNT + MemoryStats::POOL_COUNT] = { false };
+        MemoryStats::Listener* sListener = 0;
+
+        String toMegabytes(size_t bytes)
+        {
+            return StringConverter::toString(bytes / (1024.0f * 1024.0f), 2, 0, ' ', std::ios::fixed) + " MB";
+        }
+
+        void checkBudget(size_t index, const String& name, const MemoryStats::Usage& usage, size_t bytes)
+        {
+            if (!sBudgets[index] || bytes <= sBudgets[index])
+            {
+                sExceeded[index] = false;
+                return;
+            }
+
+            if (sExceeded[index])
+                return;
+            sExceeded[index] = true;
+
+            LogManager::getSingleton().logMessage("WARNING: " + name + " memory budget exceeded, " +
+                toMegabytes(bytes) + " used of " + toMegabytes(sBudgets[index]), LML_CRITICAL);
+
+            if (sListener)
+                sListener->budgetExceeded(name, usage, sBudgets[index]);
+        }
+    }
+    //---------------------------------------------------------------------
+    void MemoryStatsImpl::recordAlloc(MemoryCategory category, size_t count)
+    {
+        sCategoryBytes[category] += count;
+        ++sCategoryCount[category];
+    }
+    //---------------------------------------------------------------------
+    void MemoryStatsImpl::recordDealloc(MemoryCategory category, size_t count)
+    {
+        sCategoryBytes[category] -= count;
+        --sCategoryCount[category];
+    }
+    //---------------------------------------------------------------------
+    void MemoryStats::_recordAlloc(Pool pool, size_t bytes, bool systemMemory)
+    {
+        if (systemMemory)
+            sPoolCpuBytes[pool] += bytes;
+        else
+            sPoolGpuBytes[pool] += bytes;
+        ++sPoolCount[pool];
+    }
+    //---------------------------------------------------------------------
+    void MemoryStats::_recordDealloc(Pool pool, size_t bytes, bool systemMemory)
+    {
+        if (systemMemory)
+            sPoolCpuBytes[pool] -= bytes;
+        else
+            sPoolGpuBytes[pool] -= bytes;
+        --sPoolCount[pool];
+    }
+    //---------------------------------------------------------------------
+    MemoryStats::Usage MemoryStats::getUsage(MemoryCategory category)
+    {
+        Usage usage;
+        usage.cpuBytes = sCategoryBytes[category].load();
+        usage.count = sCategoryCount[category].load();
+        return usage;
+    }
+    //---------------------------------------------------------------------
+    MemoryStats::Usage MemoryStats::getUsage(Pool pool)
+    {
+        Usage usage;
+        usage.cpuBytes = sPoolCpuBytes[pool].load();
+        usage.gpuBytes = sPoolGpuBytes[pool].load();
+        usage.count = sPoolCount[pool].load();
+        return usage;
+    }
+    //---------------------------------------------------------------------
+    const String& MemoryStats::getName(MemoryCategory category)
+    {
+        static const String names[MEMCATEGORY_COUNT] = {
+            "General", "Geometry", "Animation", "SceneControl", "SceneObjects",
+            "Resource", "Scripting", "RenderSystem", "Frame"
+        };
+        return names[category];
+    }
+    //---------------------------------------------------------------------
+    const String& MemoryStats::getName(Pool pool)
+    {
+        static const String names[POOL_COUNT] = { "HardwareBuffers", "Textures" };
+        return names[pool];
+    }
+    //---------------------------------------------------------------------
+    void MemoryStats::setBudget(MemoryCategory category, size_t bytes)
+    {
+        sBudgets[category] = bytes;
+    }
+    //---------------------------------------------------------------------
+    void MemoryStats::setBudget(Pool pool, size_t bytes)
+    {
+        sBudgets[MEMCATEGORY_COUNT + pool] = bytes;
+    }
+    //---------------------------------------------------------------------
+    size_t MemoryStats::getBudget(MemoryCategory category)
+    {
+        return sBudgets[category];
+    }
+    //---------------------------------------------------------------------
+    size_t MemoryStats::getBudget(Pool pool)
+    {
+        return sBudgets[MEMCATEGORY_COUNT + pool];
+    }
+    //---------------------------------------------------------------------
+    void MemoryStats::setListener(Listener* listener)
+    {
+        sListener = listener;
+    }
+    //---------------------------------------------------------------------
+    MemoryStats::Listener* MemoryStats::getListener(void)
+    {
+        return sListener;
+    }
+    //---------------------------------------------------------------------
+    String MemoryStats::getReport(void)
+    {
+        StringStream report;
+
+        for (int i = 0; i < MEMCATEGORY_COUNT; ++i)
+        {
+            Usage usage = getUsage(static_cast<MemoryCategory>(i));
+            if (usage.count)
+            {
+                report << getName(static_cast<MemoryCategory>(i)) << ": " << toMegabytes(usage.cpuBytes)
+                    << " in " << usage.count << " allocations\n";
+            }
+        }
+
+        for (int i = 0; i < POOL_COUNT; ++i)
+        {
+            Usage usage = getUsage(static_cast<Pool>(i));
+            if (usage.count)
+            {
+                report << getName(static_cast<Pool>(i)) << ": " << toMegabytes(usage.gpuBytes) << " GPU, "
+                    << toMegabytes(usage.cpuBytes) << " CPU in " << usage.count << " objects\n";
+            }
+        }
+
+        return report.str();
+    }
+    //---------------------------------------------------------------------
+    void MemoryStats::_checkBudgets(void)
+    {
+        for (int i = 0; i < MEMCATEGORY_COUNT; ++i)
+        {
+            if (sBudgets[i])
+            {
+                MemoryCategory category = static_cast<MemoryCategory>(i);
+                Usage usage = getUsage(category);
+                checkBudget(i, getName(category), usage, usage.cpuBytes);
+            }
+        }
+
+        for (int i = 0; i < POOL_COUNT; ++i)
+        {
+            if (sBudgets[MEMCATEGORY_COUNT + i])
+            {
+                Pool pool = static_cast<Pool>(i);
+                Usage usage = getUsage(pool);
+                checkBudget(MEMCATEGORY_COUNT + i, getName(pool), usage, usage.getTotalBytes());
+            }
+        }
+    }
+}
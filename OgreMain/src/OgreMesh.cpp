@@ -46,6 +46,8 @@ THE SOFTWARE.
 #include "OgreTangentSpaceCalc.h"
 #include "OgreLodStrategyManager.h"
 #include "OgrePixelCountLodStrategy.h"
+#include "OgreSoftwareSkinningBatch.h"
+#include "Threading/OgreParallel.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -217,8 +219,9 @@ namespace Ogre {
             ResourceGroupManager::getSingleton().openResource(
                 mName, mGroup, this);
  
-        // fully prebuffer into host RAM
-        mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+        // fully prebuffer into host RAM, unless the file is mapped into it already
+        if (!dynamic_cast<MemoryDataStream*>(mFreshFromDisk.get()))
+            mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
     }
     //-----------------------------------------------------------------------
     void Mesh::unprepareImpl()
@@ -1214,6 +1217,8 @@ namespace Ogre {
         for (SubMeshList::iterator i = mSubMeshList.begin(); i != mSubMeshList.end(); ++i)
         {
             (*i)->mLodFaceList.resize(numLevels - 1);
+            if (!(*i)->mLodMorphTargets.empty())
+                (*i)->mLodMorphTargets.resize(numLevels - 1);
         }
     }
     //---------------------------------------------------------------------
@@ -1491,17 +1496,18 @@ namespace Ogre {
                 // If any vertex splitting happened, we have to give them bone assignments
                 if (getSkeletonName() != BLANKSTRING)
                 {
-                    for (TangentSpaceCalc::IndexRemapList::iterator r = res.indexesRemapped.begin(); 
-                        r != res.indexesRemapped.end(); ++r)
+                    // Go through the splits rather than the remapped indexes, which list
+                    // a split vertex once for every face using it
+                    for (TangentSpaceCalc::VertexSplits::iterator s = res.vertexSplits.begin();
+                        s != res.vertexSplits.end(); ++s)
                     {
-                        TangentSpaceCalc::IndexRemap& remap = *r;
                         // Copy all bone assignments from the split vertex
-                        VertexBoneAssignmentList::iterator vbstart = mBoneAssignments.lower_bound(remap.splitVertex.first);
-                        VertexBoneAssignmentList::iterator vbend = mBoneAssignments.upper_bound(remap.splitVertex.first);
+                        VertexBoneAssignmentList::iterator vbstart = mBoneAssignments.lower_bound(s->first);
+                        VertexBoneAssignmentList::iterator vbend = mBoneAssignments.upper_bound(s->first);
                         for (VertexBoneAssignmentList::iterator vba = vbstart; vba != vbend; ++vba)
                         {
                             VertexBoneAssignment newAsgn = vba->second;
-                            newAsgn.vertexIndex = static_cast<unsigned int>(remap.splitVertex.second);
+                            newAsgn.vertexIndex = static_cast<unsigned int>(s->second);
                             // multimap insert doesn't invalidate iterators
                             addBoneAssignment(newAsgn);
                         }
@@ -1550,19 +1556,18 @@ namespace Ogre {
                 // If any vertex splitting happened, we have to give them bone assignments
                 if (getSkeletonName() != BLANKSTRING)
                 {
-                    for (TangentSpaceCalc::IndexRemapList::iterator r = res.indexesRemapped.begin(); 
-                        r != res.indexesRemapped.end(); ++r)
+                    for (TangentSpaceCalc::VertexSplits::iterator s = res.vertexSplits.begin();
+                        s != res.vertexSplits.end(); ++s)
                     {
-                        TangentSpaceCalc::IndexRemap& remap = *r;
                         // Copy all bone assignments from the split vertex
                         VertexBoneAssignmentList::const_iterator vbstart = 
-                            sm->getBoneAssignments().lower_bound(remap.splitVertex.first);
+                            sm->getBoneAssignments().lower_bound(s->first);
                         VertexBoneAssignmentList::const_iterator vbend = 
-                            sm->getBoneAssignments().upper_bound(remap.splitVertex.first);
+                            sm->getBoneAssignments().upper_bound(s->first);
                         for (VertexBoneAssignmentList::const_iterator vba = vbstart; vba != vbend; ++vba)
                         {
                             VertexBoneAssignment newAsgn = vba->second;
-                            newAsgn.vertexIndex = static_cast<unsigned int>(remap.splitVertex.second);
+                            newAsgn.vertexIndex = static_cast<unsigned int>(s->second);
                             // multimap insert doesn't invalidate iterators
                             sm->addBoneAssignment(newAsgn);
                         }
@@ -1691,13 +1696,39 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /// Builds the edge lists of the LOD levels flagged, see Mesh::buildEdgeList
+        struct EdgeListBuildCaller
+        {
+            EdgeListBuilder* builders;
+            EdgeData** edgeLists;
+            const vector<bool>::type* build;
+
+            EdgeListBuildCaller(EdgeListBuilder* b, EdgeData** e, const vector<bool>::type& flags)
+                : builders(b), edgeLists(e), build(&flags) {}
+
+            void operator()(size_t lodIndex) const
+            {
+                if ((*build)[lodIndex])
+                    edgeLists[lodIndex] = builders[lodIndex].build();
+            }
+        };
+    }
+    //---------------------------------------------------------------------
     void Mesh::buildEdgeList(void)
     {
         if (mEdgeListsBuilt)
             return;
 #if !OGRE_NO_MESHLOD
+        // The builders read the buffers here, then build the LOD levels in parallel
+        unsigned short lodCount = (unsigned short)mMeshLodUsageList.size();
+        vector<EdgeListBuilder>::type builders(lodCount);
+        vector<EdgeData*>::type edgeLists(lodCount, (EdgeData*)0);
+        vector<bool>::type build(lodCount, false);
+
         // Loop over LODs
-        for (unsigned short lodIndex = 0; lodIndex < (unsigned short)mMeshLodUsageList.size(); ++lodIndex)
+        for (unsigned short lodIndex = 0; lodIndex < lodCount; ++lodIndex)
         {
             // use getLodLevel to enforce loading of manual mesh lods
             MeshLodUsage& usage = const_cast<MeshLodUsage&>(getLodLevel(lodIndex));
@@ -1714,7 +1745,7 @@ namespace Ogre {
             else
             {
                 // Build
-                EdgeListBuilder eb;
+                EdgeListBuilder& eb = builders[lodIndex];
                 size_t vertexSetCount = 0;
                 bool atLeastOneIndexSet = false;
 
@@ -1772,25 +1803,41 @@ namespace Ogre {
 
                 if (atLeastOneIndexSet)
                 {
-                    usage.edgeData = eb.build();
-
-                #if OGRE_DEBUG_MODE
-                    // Override default log
-                    Log* log = LogManager::getSingleton().createLog(
-                        mName + "_lod" + StringConverter::toString(lodIndex) +
-                        "_prepshadow.log", false, false);
-                    usage.edgeData->log(log);
-                    // clean up log & close file handle
-                    LogManager::getSingleton().destroyLog(log);
-                #endif
-                }
-                else
-                {
-                    // create empty edge data
-                    usage.edgeData = OGRE_NEW EdgeData();
+                    // Locking the buffers has to happen on this thread
+                    eb.readGeometry();
+                    build[lodIndex] = true;
                 }
             }
         }
+
+        parallelFor(0, lodCount, EdgeListBuildCaller(&builders[0], &edgeLists[0], build), 1);
+
+        for (unsigned short lodIndex = 0; lodIndex < lodCount; ++lodIndex)
+        {
+            MeshLodUsage& usage = mMeshLodUsageList[lodIndex];
+            if (!usage.manualName.empty() && lodIndex != 0)
+                continue;
+
+            if (build[lodIndex])
+            {
+                usage.edgeData = edgeLists[lodIndex];
+
+            #if OGRE_DEBUG_MODE
+                // Override default log
+                Log* log = LogManager::getSingleton().createLog(
+                    mName + "_lod" + StringConverter::toString(lodIndex) +
+                    "_prepshadow.log", false, false);
+                usage.edgeData->log(log);
+                // clean up log & close file handle
+                LogManager::getSingleton().destroyLog(log);
+            #endif
+            }
+            else
+            {
+                // create empty edge data
+                usage.edgeData = OGRE_NEW EdgeData();
+            }
+        }
 #else
         // Build
         EdgeListBuilder eb;
@@ -1842,6 +1889,407 @@ namespace Ogre {
         mEdgeListsBuilt = true;
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        const uint32 NOT_REMAPPED = 0xffffffff;
+        typedef vector<uint32>::type VertexRemap;
+
+        /// Gives the vertices used by indexData, which aren't remapped yet, the next new indexes
+        void collectFirstUse(const IndexData* indexData, VertexRemap& remap, uint32& next)
+        {
+            if (indexData->indexCount == 0)
+                return;
+
+            const HardwareIndexBufferSharedPtr& ibuf = indexData->indexBuffer;
+            bool use32Bit = ibuf->getType() == HardwareIndexBuffer::IT_32BIT;
+            void* data = ibuf->lock(indexData->indexStart * ibuf->getIndexSize(),
+                indexData->indexCount * ibuf->getIndexSize(), HardwareBuffer::HBL_READ_ONLY);
+            for (size_t i = 0; i < indexData->indexCount; ++i)
+            {
+                uint32 v = use32Bit ? static_cast<uint32*>(data)[i] : static_cast<uint16*>(data)[i];
+                if (v < remap.size() && remap[v] == NOT_REMAPPED)
+                    remap[v] = next++;
+            }
+            ibuf->unlock();
+        }
+
+        /// Reorders the vertices of vertexData in first-use order and fixes up everything referring to them
+        void remapVertexOrder(VertexData* vertexData, const vector<IndexData*>::type& indexDataList,
+            Mesh::VertexBoneAssignmentList& boneAssignments)
+        {
+            size_t vertexCount = vertexData->vertexCount;
+            if (vertexCount == 0)
+                return;
+
+            VertexRemap remap(vertexCount, NOT_REMAPPED);
+            uint32 next = 0;
+            for (size_t i = 0; i < indexDataList.size(); ++i)
+                collectFirstUse(indexDataList[i], remap, next);
+            for (size_t v = 0; v < vertexCount; ++v)
+            {
+                if (remap[v] == NOT_REMAPPED)
+                    remap[v] = next++;
+            }
+
+            // Vertex buffers
+            const VertexBufferBinding::VertexBufferBindingMap& bindings =
+                vertexData->vertexBufferBinding->getBindings();
+            set<HardwareVertexBuffer*>::type doneVertexBuffers;
+            for (VertexBufferBinding::VertexBufferBindingMap::const_iterator i = bindings.begin();
+                i != bindings.end(); ++i)
+            {
+                const HardwareVertexBufferSharedPtr& vbuf = i->second;
+                if (!doneVertexBuffers.insert(vbuf.get()).second)
+                    continue;
+
+                size_t vertexSize = vbuf->getVertexSize();
+                char* data = static_cast<char*>(vbuf->lock(vertexData->vertexStart * vertexSize,
+                    vertexCount * vertexSize, HardwareBuffer::HBL_NORMAL));
+                vector<char>::type copy(data, data + vertexCount * vertexSize);
+                for (size_t v = 0; v < vertexCount; ++v)
+                    memcpy(data + remap[v] * vertexSize, &copy[v * vertexSize], vertexSize);
+                vbuf->unlock();
+            }
+
+            // Index buffers, each one once since LOD levels may share one with overlapping ranges
+            for (size_t i = 0; i < indexDataList.size(); ++i)
+            {
+                const HardwareIndexBufferSharedPtr& ibuf = indexDataList[i]->indexBuffer;
+                bool seen = false;
+                for (size_t j = 0; j < i && !seen; ++j)
+                    seen = indexDataList[j]->indexBuffer == ibuf;
+                if (seen)
+                    continue;
+
+                bool use32Bit = ibuf->getType() == HardwareIndexBuffer::IT_32BIT;
+                void* data = ibuf->lock(HardwareBuffer::HBL_NORMAL);
+                vector<bool>::type remapped(ibuf->getNumIndexes(), false);
+                for (size_t j = i; j < indexDataList.size(); ++j)
+                {
+                    const IndexData* indexData = indexDataList[j];
+                    if (indexData->indexBuffer != ibuf)
+                        continue;
+
+                    size_t end = indexData->indexStart + indexData->indexCount;
+                    for (size_t k = indexData->indexStart; k < end; ++k)
+                    {
+                        if (remapped[k])
+                            continue;
+                        remapped[k] = true;
+                        if (use32Bit)
+                            static_cast<uint32*>(data)[k] = remap[static_cast<uint32*>(data)[k]];
+                        else
+                            static_cast<uint16*>(data)[k] =
+                                static_cast<uint16>(remap[static_cast<uint16*>(data)[k]]);
+                    }
+                }
+                ibuf->unlock();
+            }
+
+            // Bone assignments are keyed by vertex index
+            Mesh::VertexBoneAssignmentList remappedAssignments;
+            for (Mesh::VertexBoneAssignmentList::const_iterator i = boneAssignments.begin();
+                i != boneAssignments.end(); ++i)
+            {
+                VertexBoneAssignment vba = i->second;
+                if (vba.vertexIndex < vertexCount)
+                    vba.vertexIndex = remap[vba.vertexIndex];
+                remappedAssignments.insert(Mesh::VertexBoneAssignmentList::value_type(vba.vertexIndex, vba));
+            }
+            boneAssignments.swap(remappedAssignments);
+        }
+    }
+    //---------------------------------------------------------------------
+    void Mesh::optimiseVertexCache(bool reorderVertices)
+    {
+        // Faces first, the vertex order follows from them
+        for (SubMeshList::iterator i = mSubMeshList.begin(); i != mSubMeshList.end(); ++i)
+        {
+            SubMesh* sm = *i;
+            if (sm->operationType != RenderOperation::OT_TRIANGLE_LIST || !sm->indexData)
+                continue;
+
+            sm->indexData->optimiseVertexCacheTriList();
+#if !OGRE_NO_MESHLOD
+            // Generated LOD levels may be packed into one buffer with overlapping ranges
+            const SubMesh::LODFaceList& lodFaces = sm->mLodFaceList;
+            for (size_t l = 0; l < lodFaces.size(); ++l)
+            {
+                const HardwareIndexBufferSharedPtr& ibuf = lodFaces[l]->indexBuffer;
+                bool shared = ibuf == sm->indexData->indexBuffer;
+                for (size_t o = 0; o < lodFaces.size() && !shared; ++o)
+                    shared = o != l && lodFaces[o]->indexBuffer == ibuf;
+                if (!shared)
+                    lodFaces[l]->optimiseVertexCacheTriList();
+            }
+#endif
+        }
+
+        if (!reorderVertices)
+            return;
+
+        if (!mPoseList.empty() || hasVertexAnimation() || mPreparedForShadowVolumes)
+        {
+            LogManager::getSingleton().logMessage("Mesh " + mName +
+                ": not reordering vertices, since poses, vertex animation or shadow volumes depend on their order");
+            return;
+        }
+
+        vector<IndexData*>::type sharedIndexData;
+        for (SubMeshList::iterator i = mSubMeshList.begin(); i != mSubMeshList.end(); ++i)
+        {
+            SubMesh* sm = *i;
+            if (!sm->indexData)
+                continue;
+
+            // Every index data using a vertex data has to be remapped along with it
+            vector<IndexData*>::type dedicatedIndexData;
+            vector<IndexData*>::type& indexDataList =
+                sm->useSharedVertices ? sharedIndexData : dedicatedIndexData;
+            indexDataList.push_back(sm->indexData);
+#if !OGRE_NO_MESHLOD
+            indexDataList.insert(indexDataList.end(), sm->mLodFaceList.begin(), sm->mLodFaceList.end());
+#endif
+            if (!sm->useSharedVertices && sm->vertexData)
+                remapVertexOrder(sm->vertexData, dedicatedIndexData, sm->mBoneAssignments);
+        }
+        if (sharedVertexData)
+            remapVertexOrder(sharedVertexData, sharedIndexData, mBoneAssignments);
+
+        if (mEdgeListsBuilt)
+        {
+            freeEdgeList();
+            buildEdgeList();
+        }
+    }
+    //---------------------------------------------------------------------
+    namespace
+    {
+        typedef set<unsigned short>::type BoneSet;
+
+        /// Faces of a SubMesh grouped to stay within a number of bones
+        struct BonePartition
+        {
+            BoneSet bones;
+            vector<uint32>::type indexes;
+        };
+
+        /// Copies the given vertices of source into new dedicated vertex data
+        VertexData* copyVertices(const VertexData* source, const vector<uint32>::type& vertices,
+            HardwareBufferManagerBase* mgr, HardwareBuffer::Usage usage, bool shadowBuffer)
+        {
+            VertexData* dest = OGRE_NEW VertexData(mgr);
+            dest->vertexStart = 0;
+            dest->vertexCount = vertices.size();
+
+            const VertexDeclaration::VertexElementList& elems = source->vertexDeclaration->getElements();
+            for (VertexDeclaration::VertexElementList::const_iterator i = elems.begin(); i != elems.end(); ++i)
+            {
+                dest->vertexDeclaration->addElement(i->getSource(), i->getOffset(), i->getType(),
+                    i->getSemantic(), i->getIndex());
+            }
+
+            const VertexBufferBinding::VertexBufferBindingMap& bindings =
+                source->vertexBufferBinding->getBindings();
+            for (VertexBufferBinding::VertexBufferBindingMap::const_iterator i = bindings.begin();
+                i != bindings.end(); ++i)
+            {
+                const HardwareVertexBufferSharedPtr& srcBuf = i->second;
+                size_t vertexSize = srcBuf->getVertexSize();
+                HardwareVertexBufferSharedPtr destBuf = mgr->createVertexBuffer(
+                    vertexSize, vertices.size(), usage, shadowBuffer);
+
+                const char* src = static_cast<const char*>(srcBuf->lock(
+                    source->vertexStart * vertexSize, source->vertexCount * vertexSize,
+                    HardwareBuffer::HBL_READ_ONLY));
+                char* dst = static_cast<char*>(destBuf->lock(HardwareBuffer::HBL_DISCARD));
+                for (size_t v = 0; v < vertices.size(); ++v)
+                    memcpy(dst + v * vertexSize, src + vertices[v] * vertexSize, vertexSize);
+                destBuf->unlock();
+                srcBuf->unlock();
+
+                dest->vertexBufferBinding->setBinding(i->first, destBuf);
+            }
+            return dest;
+        }
+    }
+    //---------------------------------------------------------------------
+    bool Mesh::splitSubMeshesByBones(size_t maxBones)
+    {
+        if (maxBones < 12)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "At least 12 bones are needed to fit any triangle",
+                "Mesh::splitSubMeshesByBones");
+        }
+
+        if (!mPoseList.empty() || hasVertexAnimation() || mPreparedForShadowVolumes)
+        {
+            LogManager::getSingleton().logMessage("Mesh " + mName +
+                ": not splitting by bones, since poses, vertex animation or shadow volumes depend on the vertex order");
+            return false;
+        }
+
+        // Bones of the shared geometry, all of them are in the palette of every SubMesh using it
+        BoneSet sharedBones;
+        for (VertexBoneAssignmentList::const_iterator i = mBoneAssignments.begin();
+            i != mBoneAssignments.end(); ++i)
+        {
+            sharedBones.insert(i->second.boneIndex);
+        }
+
+        bool split = false;
+        const size_t numSubMeshes = mSubMeshList.size();
+        for (size_t s = 0; s < numSubMeshes; ++s)
+        {
+            SubMesh* sm = mSubMeshList[s];
+            const VertexBoneAssignmentList& assignments =
+                sm->useSharedVertices ? mBoneAssignments : sm->mBoneAssignments;
+            const VertexData* vertexData = sm->useSharedVertices ? sharedVertexData : sm->vertexData;
+            if (sm->operationType != RenderOperation::OT_TRIANGLE_LIST || !sm->indexData ||
+                sm->indexData->indexCount == 0 || !vertexData || assignments.empty())
+                continue;
+
+            size_t numBones = sharedBones.size();
+            if (!sm->useSharedVertices)
+            {
+                BoneSet bones;
+                for (VertexBoneAssignmentList::const_iterator i = assignments.begin(); i != assignments.end(); ++i)
+                    bones.insert(i->second.boneIndex);
+                numBones = bones.size();
+            }
+            if (numBones <= maxBones)
+                continue;
+
+            // Group the faces, each into the first partition it fits in
+            vector<BonePartition>::type partitions;
+            {
+                const IndexData* indexData = sm->indexData;
+                const HardwareIndexBufferSharedPtr& ibuf = indexData->indexBuffer;
+                bool use32Bit = ibuf->getType() == HardwareIndexBuffer::IT_32BIT;
+                const void* data = ibuf->lock(indexData->indexStart * ibuf->getIndexSize(),
+                    indexData->indexCount * ibuf->getIndexSize(), HardwareBuffer::HBL_READ_ONLY);
+                BoneSet faceBones;
+                for (size_t f = 0; f + 2 < indexData->indexCount; f += 3)
+                {
+                    uint32 face[3];
+                    faceBones.clear();
+                    for (size_t c = 0; c < 3; ++c)
+                    {
+                        face[c] = use32Bit ? static_cast<const uint32*>(data)[f + c] :
+                            static_cast<const uint16*>(data)[f + c];
+                        std::pair<VertexBoneAssignmentList::const_iterator,
+                            VertexBoneAssignmentList::const_iterator> range = assignments.equal_range(face[c]);
+                        for (VertexBoneAssignmentList::const_iterator i = range.first; i != range.second; ++i)
+                            faceBones.insert(i->second.boneIndex);
+                    }
+
+                    size_t p = 0;
+                    for (; p < partitions.size(); ++p)
+                    {
+                        size_t added = 0;
+                        for (BoneSet::const_iterator b = faceBones.begin(); b != faceBones.end(); ++b)
+                            added += partitions[p].bones.count(*b) ? 0 : 1;
+                        if (partitions[p].bones.size() + added <= maxBones)
+                            break;
+                    }
+                    if (p == partitions.size())
+                        partitions.push_back(BonePartition());
+                    partitions[p].bones.insert(faceBones.begin(), faceBones.end());
+                    partitions[p].indexes.insert(partitions[p].indexes.end(), face, face + 3);
+                }
+                ibuf->unlock();
+            }
+
+            if (!split)
+            {
+                // The LOD face lists index the vertices being replaced
+                removeLodLevels();
+                split = true;
+            }
+            LogManager::getSingleton().logMessage("Mesh " + mName + ": splitting a SubMesh using " +
+                StringConverter::toString(numBones) + " bones into " +
+                StringConverter::toString(partitions.size()) + " SubMeshes");
+
+            // Keep a copy, the first partition replaces the assignments being read
+            VertexBoneAssignmentList sourceAssignments = assignments;
+            VertexData* ownedVertexData = sm->useSharedVertices ? 0 : sm->vertexData;
+            sm->vertexData = 0;
+            for (size_t p = 0; p < partitions.size(); ++p)
+            {
+                BonePartition& partition = partitions[p];
+
+                // Renumber the vertices the faces use, in first use order
+                map<uint32, uint32>::type remap;
+                vector<uint32>::type vertices;
+                for (size_t i = 0; i < partition.indexes.size(); ++i)
+                {
+                    std::pair<map<uint32, uint32>::type::iterator, bool> res = remap.insert(
+                        std::make_pair(partition.indexes[i], static_cast<uint32>(vertices.size())));
+                    if (res.second)
+                        vertices.push_back(partition.indexes[i]);
+                    partition.indexes[i] = res.first->second;
+                }
+
+                SubMesh* target = sm;
+                if (p > 0)
+                {
+                    target = createSubMesh();
+                    target->setMaterialName(sm->getMaterialName());
+                    target->operationType = sm->operationType;
+                    target->setBuildEdgesEnabled(sm->isBuildEdgesEnabled());
+                }
+                target->vertexData = copyVertices(vertexData, vertices,
+                    getHardwareBufferManager(), mVertexBufferUsage, mVertexBufferShadowBuffer);
+
+                HardwareIndexBuffer::IndexType indexType = vertices.size() > 0xffff ?
+                    HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT;
+                HardwareIndexBufferSharedPtr ibuf = getHardwareBufferManager()->createIndexBuffer(
+                    indexType, partition.indexes.size(), mIndexBufferUsage, mIndexBufferShadowBuffer);
+                void* data = ibuf->lock(HardwareBuffer::HBL_DISCARD);
+                for (size_t i = 0; i < partition.indexes.size(); ++i)
+                {
+                    if (indexType == HardwareIndexBuffer::IT_32BIT)
+                        static_cast<uint32*>(data)[i] = partition.indexes[i];
+                    else
+                        static_cast<uint16*>(data)[i] = static_cast<uint16>(partition.indexes[i]);
+                }
+                ibuf->unlock();
+                target->indexData->indexBuffer = ibuf;
+                target->indexData->indexStart = 0;
+                target->indexData->indexCount = partition.indexes.size();
+
+                target->useSharedVertices = false;
+                target->extremityPoints.clear();
+                target->clearBoneAssignments();
+                for (size_t v = 0; v < vertices.size(); ++v)
+                {
+                    std::pair<VertexBoneAssignmentList::const_iterator,
+                        VertexBoneAssignmentList::const_iterator> range =
+                        sourceAssignments.equal_range(vertices[v]);
+                    for (VertexBoneAssignmentList::const_iterator i = range.first; i != range.second; ++i)
+                    {
+                        VertexBoneAssignment vba = i->second;
+                        vba.vertexIndex = static_cast<unsigned int>(v);
+                        target->addBoneAssignment(vba);
+                    }
+                }
+            }
+            OGRE_DELETE ownedVertexData;
+        }
+
+        if (!split)
+            return false;
+
+        _updateCompiledBoneAssignments();
+        if (mEdgeListsBuilt)
+        {
+            freeEdgeList();
+            buildEdgeList();
+        }
+        return true;
+    }
+    //---------------------------------------------------------------------
     void Mesh::freeEdgeList(void)
     {
         if (!mEdgeListsBuilt)
@@ -1937,143 +2385,10 @@ namespace Ogre {
         const Matrix4* const* blendMatrices, size_t numMatrices,
         bool blendNormals)
     {
-        float *pSrcPos = 0;
-        float *pSrcNorm = 0;
-        float *pDestPos = 0;
-        float *pDestNorm = 0;
-        float *pBlendWeight = 0;
-        unsigned char* pBlendIdx = 0;
-        size_t srcPosStride = 0;
-        size_t srcNormStride = 0;
-        size_t destPosStride = 0;
-        size_t destNormStride = 0;
-        size_t blendWeightStride = 0;
-        size_t blendIdxStride = 0;
-
-
-        // Get elements for source
-        const VertexElement* srcElemPos =
-            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
-        const VertexElement* srcElemNorm =
-            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
-        const VertexElement* srcElemBlendIndices =
-            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_BLEND_INDICES);
-        const VertexElement* srcElemBlendWeights =
-            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_BLEND_WEIGHTS);
-        OgreAssert(srcElemPos && srcElemBlendIndices && srcElemBlendWeights,
-            "You must supply at least positions, blend indices and blend weights");
-        // Get elements for target
-        const VertexElement* destElemPos =
-            targetVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
-        const VertexElement* destElemNorm =
-            targetVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
-
-        // Do we have normals and want to blend them?
-        bool includeNormals = blendNormals && (srcElemNorm != NULL) && (destElemNorm != NULL);
-
-
-        // Get buffers for source
-        HardwareVertexBufferSharedPtr srcPosBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemPos->getSource());
-        HardwareVertexBufferSharedPtr srcIdxBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendIndices->getSource());
-        HardwareVertexBufferSharedPtr srcWeightBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendWeights->getSource());
-        HardwareVertexBufferSharedPtr srcNormBuf;
-
-        srcPosStride = srcPosBuf->getVertexSize();
-        
-        blendIdxStride = srcIdxBuf->getVertexSize();
-        
-        blendWeightStride = srcWeightBuf->getVertexSize();
-        if (includeNormals)
-        {
-            srcNormBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemNorm->getSource());
-            srcNormStride = srcNormBuf->getVertexSize();
-        }
-        // Get buffers for target
-        HardwareVertexBufferSharedPtr destPosBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemPos->getSource());
-        HardwareVertexBufferSharedPtr destNormBuf;
-        destPosStride = destPosBuf->getVertexSize();
-        if (includeNormals)
-        {
-            destNormBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemNorm->getSource());
-            destNormStride = destNormBuf->getVertexSize();
-        }
-
-        void* pBuffer;
-
-        // Lock source buffers for reading
-        pBuffer = srcPosBuf->lock(HardwareBuffer::HBL_READ_ONLY);
-        srcElemPos->baseVertexPointerToElement(pBuffer, &pSrcPos);
-        if (includeNormals)
-        {
-            if (srcNormBuf != srcPosBuf)
-            {
-                // Different buffer
-                pBuffer = srcNormBuf->lock(HardwareBuffer::HBL_READ_ONLY);
-            }
-            srcElemNorm->baseVertexPointerToElement(pBuffer, &pSrcNorm);
-        }
-
-        // Indices must be 4 bytes
-        assert(srcElemBlendIndices->getType() == VET_UBYTE4 &&
-               "Blend indices must be VET_UBYTE4");
-        pBuffer = srcIdxBuf->lock(HardwareBuffer::HBL_READ_ONLY);
-        srcElemBlendIndices->baseVertexPointerToElement(pBuffer, &pBlendIdx);
-        if (srcWeightBuf != srcIdxBuf)
-        {
-            // Lock buffer
-            pBuffer = srcWeightBuf->lock(HardwareBuffer::HBL_READ_ONLY);
-        }
-        srcElemBlendWeights->baseVertexPointerToElement(pBuffer, &pBlendWeight);
-        unsigned short numWeightsPerVertex =
-            VertexElement::getTypeCount(srcElemBlendWeights->getType());
-
-
-        // Lock destination buffers for writing
-        pBuffer = destPosBuf->lock(
-            (destNormBuf != destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize()) ||
-            (destNormBuf == destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize() + destElemNorm->getSize()) ?
-            HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL);
-        destElemPos->baseVertexPointerToElement(pBuffer, &pDestPos);
-        if (includeNormals)
-        {
-            if (destNormBuf != destPosBuf)
-            {
-                pBuffer = destNormBuf->lock(
-                    destNormBuf->getVertexSize() == destElemNorm->getSize() ?
-                    HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL);
-            }
-            destElemNorm->baseVertexPointerToElement(pBuffer, &pDestNorm);
-        }
-
-        OptimisedUtil::getImplementation()->softwareVertexSkinning(
-            pSrcPos, pDestPos,
-            pSrcNorm, pDestNorm,
-            pBlendWeight, pBlendIdx,
-            blendMatrices,
-            srcPosStride, destPosStride,
-            srcNormStride, destNormStride,
-            blendWeightStride, blendIdxStride,
-            numWeightsPerVertex,
-            targetVertexData->vertexCount);
-
-        // Unlock source buffers
-        srcPosBuf->unlock();
-        srcIdxBuf->unlock();
-        if (srcWeightBuf != srcIdxBuf)
-        {
-            srcWeightBuf->unlock();
-        }
-        if (includeNormals && srcNormBuf != srcPosBuf)
-        {
-            srcNormBuf->unlock();
-        }
-        // Unlock destination buffers
-        destPosBuf->unlock();
-        if (includeNormals && destNormBuf != destPosBuf)
-        {
-            destNormBuf->unlock();
-        }
-
+        SoftwareSkinningBatch::Blend blend;
+        blend.lock(sourceVertexData, targetVertexData, blendNormals);
+        blend.skin(blendMatrices, 0, blend.vertexCount);
+        blend.unlock();
     }
     //---------------------------------------------------------------------
     void Mesh::softwareVertexMorph(Real t,
@@ -2191,6 +2506,79 @@ namespace Ogre {
         destBuf->unlock();
     }
     //---------------------------------------------------------------------
+    namespace {
+        /// Vertices of a pose blended by one parallel job
+        const size_t POSE_BLEND_CHUNK = 4096;
+
+        /// Accumulates one chunk of the packed offsets and normals of a pose
+        struct PoseBlendCaller
+        {
+            Real weight;
+            const Pose* pose;
+            float* pos;
+            float* norm;
+            size_t stride;
+
+            PoseBlendCaller(Real w, const Pose* p, float* pPos, float* pNorm, size_t s)
+                : weight(w), pose(p), pos(pPos), norm(pNorm), stride(s) {}
+
+            void operator()(size_t chunk) const
+            {
+                const vector<uint32>::type& indexes = pose->_getPackedIndexes();
+                size_t first = chunk * POSE_BLEND_CHUNK;
+                size_t count = std::min(POSE_BLEND_CHUNK, indexes.size() - first);
+                OptimisedUtil* util = OptimisedUtil::getImplementation();
+
+                util->accumulateVertexOffsets(weight, &pose->_getPackedOffsets()[first * 3],
+                    &indexes[first], pos, stride, count);
+                if (norm)
+                    util->accumulateVertexOffsets(weight, &pose->_getPackedNormals()[first * 3],
+                        &indexes[first], norm, stride, count);
+            }
+        };
+    }
+    //---------------------------------------------------------------------
+    void Mesh::softwareVertexPoseBlend(Real weight, const Pose* pose,
+        VertexData* targetVertexData)
+    {
+        // Do nothing if no weight
+        if (weight == 0.0f)
+            return;
+
+        // Pack before the jobs run so they only read the pose
+        const vector<uint32>::type& indexes = pose->_getPackedIndexes();
+        if (indexes.empty())
+            return;
+
+        const VertexElement* posElem =
+            targetVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        const VertexElement* normElem =
+            targetVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
+        assert(posElem);
+        // Support normals if they're in the same buffer as positions and pose includes them
+        bool normals = normElem && !pose->_getPackedNormals().empty() &&
+            posElem->getSource() == normElem->getSource();
+        HardwareVertexBufferSharedPtr destBuf =
+            targetVertexData->vertexBufferBinding->getBuffer(
+            posElem->getSource());
+
+        size_t stride = destBuf->getVertexSize();
+
+        // Have to lock in normal mode since this is incremental
+        void* pBase = destBuf->lock(HardwareBuffer::HBL_NORMAL);
+        float* pPos;
+        float* pNorm = 0;
+        posElem->baseVertexPointerToElement(pBase, &pPos);
+        if (normals)
+            normElem->baseVertexPointerToElement(pBase, &pNorm);
+
+        // Each vertex appears once in a pose, so the chunks never write the same data
+        size_t chunks = (indexes.size() + POSE_BLEND_CHUNK - 1) / POSE_BLEND_CHUNK;
+        parallelFor(0, chunks, PoseBlendCaller(weight, pose, pPos, pNorm, stride), 1);
+
+        destBuf->unlock();
+    }
+    //---------------------------------------------------------------------
     size_t Mesh::calculateSize(void) const
     {
         // calculate GPU size
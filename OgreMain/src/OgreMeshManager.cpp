@@ -928,7 +928,7 @@ namespace Ogre
             size_t uMaxSubdivisionLevel, size_t vMaxSubdivisionLevel,
             PatchSurface::VisibleSide visibleSide, 
             HardwareBuffer::Usage vbUsage, HardwareBuffer::Usage ibUsage,
-            bool vbUseShadow, bool ibUseShadow)
+            bool vbUseShadow, bool ibUseShadow, bool hardwareTessellation)
     {
         if (width < 3 || height < 3)
         {
@@ -946,7 +946,7 @@ namespace Ogre
         PatchMesh* pm = OGRE_NEW PatchMesh(this, name, getNextHandle(), groupName);
         pm->define(controlPointBuffer, declaration, width, height,
             uMaxSubdivisionLevel, vMaxSubdivisionLevel, visibleSide, vbUsage, ibUsage,
-            vbUseShadow, ibUseShadow);
+            vbUseShadow, ibUseShadow, hardwareTessellation);
         pm->load();
         ResourcePtr res(pm);
         addImpl(res);
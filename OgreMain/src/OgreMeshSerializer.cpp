@@ -45,11 +45,15 @@ namespace Ogre {
         
         // Note MUST be added in reverse order so latest is first in the list
 
+        mVersionData.push_back(OGRE_NEW MeshVersionData(
+            MESH_VERSION_1_11, "[MeshSerializer_v1.110]",
+            OGRE_NEW MeshSerializerImpl()));
+
         // This one is a little ugly, 1.10 is used for version 1.1 legacy meshes.
         // So bump up to 1.100
         mVersionData.push_back(OGRE_NEW MeshVersionData(
             MESH_VERSION_1_10, "[MeshSerializer_v1.100]", 
-            OGRE_NEW MeshSerializerImpl()));
+            OGRE_NEW MeshSerializerImpl_v1_10()));
 
         mVersionData.push_back(OGRE_NEW MeshVersionData(
             MESH_VERSION_1_8, "[MeshSerializer_v1.8]", 
@@ -152,6 +156,8 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void MeshSerializer::importMesh(DataStreamPtr& stream, Mesh* pDest)
     {
+        // The mesh may be embedded in a larger stream
+        size_t start = stream->tell();
         determineEndianness(stream);
 
         // Read header and determine the version
@@ -168,7 +174,7 @@ namespace Ogre {
         // Read version
         String ver = readString(stream);
         // Jump back to start
-        stream->seek(0);
+        stream->seek(start);
 
         // Find the implementation to use
         MeshSerializerImpl* impl = 0;
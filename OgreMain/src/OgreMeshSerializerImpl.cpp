@@ -52,11 +52,14 @@ namespace Ogre {
 
     /// stream overhead = ID + size
     const long MSTREAM_OVERHEAD_SIZE = sizeof(uint16) + sizeof(uint32);
+    /// alignment of buffer data in the file, so that it can be copied from mapped files efficiently
+    const size_t MESH_DATA_ALIGNMENT = 16;
     //---------------------------------------------------------------------
     MeshSerializerImpl::MeshSerializerImpl()
+        : mStartPosition(0)
     {
         // Version number
-        mVersion = "[MeshSerializer_v1.100]";
+        mVersion = "[MeshSerializer_v1.110]";
     }
     //---------------------------------------------------------------------
     MeshSerializerImpl::~MeshSerializerImpl()
@@ -86,6 +89,8 @@ namespace Ogre {
                 "MeshSerializerImpl::exportMesh");
         }
 
+        // The mesh may be written into a larger stream at any position
+        mStartPosition = mStream->tell();
         writeFileHeader();
         LogManager::getSingleton().logMessage("File header written.");
 
@@ -101,6 +106,8 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void MeshSerializerImpl::importMesh(DataStreamPtr& stream, Mesh* pMesh, MeshSerializerListener *listener)
     {
+        mStartPosition = stream->tell();
+
         // Determine endianness (must be the first thing we do!)
         determineEndianness(stream);
 
@@ -263,6 +270,7 @@ namespace Ogre {
 
         if (indexCount > 0)
         {
+            size_t alignment = writeDataAlignment();
             // unsigned short* faceVertexIndices ((indexCount)
             HardwareIndexBufferSharedPtr ibuf = s->indexData->indexBuffer;
             void* pIdx = ibuf->lock(HardwareBuffer::HBL_READ_ONLY);
@@ -277,6 +285,7 @@ namespace Ogre {
                 writeShorts(pIdx16, s->indexData->indexCount);
             }
             ibuf->unlock();
+            writeDataAlignmentEnd(alignment);
         }
 
         pushInnerChunk(mStream);
@@ -460,7 +469,7 @@ namespace Ogre {
         {
             const HardwareVertexBufferSharedPtr& vbuf = vbi->second;
             size_t vbufSizeInBytes = vbuf->getVertexSize() * vertexData->vertexCount; // vbuf->getSizeInBytes() is too large for meshes prepared for shadow volumes
-            size = (MSTREAM_OVERHEAD_SIZE * 2) + (sizeof(unsigned short) * 2) + vbufSizeInBytes;
+            size = (MSTREAM_OVERHEAD_SIZE * 2) + (sizeof(unsigned short) * 2) + vbufSizeInBytes + calcDataAlignmentSize();
             writeChunkHeader(M_GEOMETRY_VERTEX_BUFFER,  size);
             // unsigned short bindIndex;    // Index to bind this buffer to
                 unsigned short tmp = vbi->first;
@@ -471,8 +480,9 @@ namespace Ogre {
                 pushInnerChunk(mStream);
                 {
             // Data
-            size = MSTREAM_OVERHEAD_SIZE + vbufSizeInBytes;
+            size = MSTREAM_OVERHEAD_SIZE + vbufSizeInBytes + calcDataAlignmentSize();
             writeChunkHeader(M_GEOMETRY_VERTEX_BUFFER_DATA, size);
+            size_t alignment = writeDataAlignment();
             void* pBuf = vbuf->lock(HardwareBuffer::HBL_READ_ONLY);
 
             if (mFlipEndian)
@@ -494,6 +504,7 @@ namespace Ogre {
                 writeData(pBuf, vbuf->getVertexSize(), vertexData->vertexCount);
             }
             vbuf->unlock();
+            writeDataAlignmentEnd(alignment);
         }
                 popInnerChunk(mStream);
             }
@@ -602,6 +613,8 @@ namespace Ogre {
             size += sizeof(unsigned int) * pSub->indexData->indexCount;
         else
             size += sizeof(unsigned short) * pSub->indexData->indexCount;
+        if (pSub->indexData->indexCount > 0)
+            size += calcDataAlignmentSize();
 
         // Geometry
         if (!pSub->useSharedVertices)
@@ -670,6 +683,7 @@ namespace Ogre {
         {
             const HardwareVertexBufferSharedPtr& vbuf = vbi->second;
             size += vbuf->getVertexSize() * vertexData->vertexCount; // vbuf->getSizeInBytes() is too large for meshes prepared for shadow volumes
+            size += calcDataAlignmentSize();
         }
         return size;
     }
@@ -822,8 +836,10 @@ namespace Ogre {
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
             pMesh->mVertexBufferShadowBuffer);
+        size_t alignment = readDataAlignment(stream);
         void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
         stream->read(pBuf, dest->vertexCount * vertexSize);
+        readDataAlignmentEnd(stream, alignment);
 
         // endian conversion for OSX
         flipFromLittleEndian(
@@ -1011,6 +1027,7 @@ namespace Ogre {
         readBools(stream, &idx32bit, 1);
         if (indexCount > 0)
         {
+            size_t alignment = readDataAlignment(stream);
             if (idx32bit)
             {
                 ibuf = pMesh->getHardwareBufferManager()->createIndexBuffer(
@@ -1040,6 +1057,7 @@ namespace Ogre {
                 readShorts(stream, pIdx, sm->indexData->indexCount);
                 ibuf->unlock();
             }
+            readDataAlignmentEnd(stream, alignment);
         }
         sm->indexData->indexBuffer = ibuf;
 
@@ -1633,6 +1651,43 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::writeDataAlignment()
+    {
+        static const uint8 zeros[MESH_DATA_ALIGNMENT] = {0};
+        size_t position = mStream->tell() - mStartPosition;
+        size_t alignment = (MESH_DATA_ALIGNMENT - position % MESH_DATA_ALIGNMENT) % MESH_DATA_ALIGNMENT;
+        if (alignment)
+            writeData(zeros, 1, alignment);
+        return alignment;
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeDataAlignmentEnd(size_t alignment)
+    {
+        static const uint8 zeros[MESH_DATA_ALIGNMENT] = {0};
+        // pad the remainder so that the chunk size does not depend on the file position
+        size_t remainder = calcDataAlignmentSize() - alignment;
+        if (remainder)
+            writeData(zeros, 1, remainder);
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcDataAlignmentSize()
+    {
+        return MESH_DATA_ALIGNMENT - 1;
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::readDataAlignment(DataStreamPtr& stream)
+    {
+        size_t position = stream->tell() - mStartPosition;
+        size_t alignment = (MESH_DATA_ALIGNMENT - position % MESH_DATA_ALIGNMENT) % MESH_DATA_ALIGNMENT;
+        stream->skip(alignment);
+        return alignment;
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::readDataAlignmentEnd(DataStreamPtr& stream, size_t alignment)
+    {
+        stream->skip(calcDataAlignmentSize() - alignment);
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::flipEndian(void* pData, size_t vertexCount,
         size_t vertexSize, const VertexDeclaration::VertexElementList& elems)
     {
@@ -1660,6 +1715,9 @@ namespace Ogre {
                         typeSize = sizeof(short);
                         break;
                     case VET_USHORT1:
+                    case VET_SHORT2_NORM:
+                    case VET_USHORT2_NORM:
+                    case VET_HALF2:
                         typeSize = sizeof(unsigned short);
                         break;
                     case VET_INT1:
@@ -2754,6 +2812,42 @@ namespace Ogre {
     }
 
 
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_v1_10::MeshSerializerImpl_v1_10()
+    {
+        // Version number
+        mVersion = "[MeshSerializer_v1.100]";
+    }
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_v1_10::~MeshSerializerImpl_v1_10()
+    {
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_v1_10::writeDataAlignment()
+    {
+        // buffer data is not aligned before v1.11
+        return 0;
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v1_10::writeDataAlignmentEnd(size_t alignment)
+    {
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_v1_10::calcDataAlignmentSize()
+    {
+        return 0;
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_v1_10::readDataAlignment(DataStreamPtr& stream)
+    {
+        return 0;
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v1_10::readDataAlignmentEnd(DataStreamPtr& stream, size_t alignment)
+    {
+    }
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
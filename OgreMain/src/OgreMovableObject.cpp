@@ -62,6 +62,8 @@ namespace Ogre {
         , mQueryFlags(msDefaultQueryFlags)
         , mVisibilityFlags(msDefaultVisibilityFlags)
         , mCastShadows(true)
+        , mOccluder(false)
+        , mStaticShadowCaster(false)
         , mRenderingDisabled(false)
         , mListener(0)
         , mLightListUpdated(0)
@@ -90,6 +92,8 @@ namespace Ogre {
         , mQueryFlags(msDefaultQueryFlags)
         , mVisibilityFlags(msDefaultVisibilityFlags)
         , mCastShadows(true)
+        , mOccluder(false)
+        , mStaticShadowCaster(false)
         , mRenderingDisabled(false)
         , mListener(0)
         , mLightListUpdated(0)
@@ -138,6 +142,9 @@ namespace Ogre {
         // counter by one for minimise overhead
         --mLightListUpdated;
 
+        if (mStaticShadowCaster && mManager && different)
+            mManager->invalidateShadowTextureCache();
+
         // Call listener (note, only called if there's something to do)
         if (mListener && different)
         {
@@ -205,6 +212,9 @@ namespace Ogre {
         // counter by one for minimise overhead
         --mLightListUpdated;
 
+        if (mStaticShadowCaster && mManager)
+            mManager->invalidateShadowTextureCache();
+
         // Notify listener if exists
         if (mListener)
         {
@@ -212,6 +222,13 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void MovableObject::setStaticShadowCaster(bool isStatic)
+    {
+        if (mStaticShadowCaster != isStatic && mManager)
+            mManager->invalidateShadowTextureCache();
+        mStaticShadowCaster = isStatic;
+    }
+    //-----------------------------------------------------------------------
     bool MovableObject::isVisible(void) const
     {
         if (!mVisible || mBeyondFarDistance || mRenderingDisabled)
@@ -40,6 +40,7 @@ THE SOFTWARE.
 #include "OgreManualObject.h"
 #include "OgreNameGenerator.h"
 #include "OgreMesh.h"
+#include "OgreNodeTransformPool.h"
 
 namespace Ogre {
 
@@ -60,6 +61,12 @@ namespace Ogre {
         mDerivedOrientation(Quaternion::IDENTITY),
         mDerivedPosition(Vector3::ZERO),
         mDerivedScale(Vector3::UNIT_SCALE),
+        mDerivedOrientationPtr(&mDerivedOrientation),
+        mDerivedPositionPtr(&mDerivedPosition),
+        mDerivedScalePtr(&mDerivedScale),
+        mTransformPool(0),
+        mTransformPoolDepth(0),
+        mTransformPoolIndex(0),
         mInitialPosition(Vector3::ZERO),
         mInitialOrientation(Quaternion::IDENTITY),
         mInitialScale(Vector3::UNIT_SCALE),
@@ -92,6 +99,12 @@ namespace Ogre {
         mDerivedOrientation(Quaternion::IDENTITY),
         mDerivedPosition(Vector3::ZERO),
         mDerivedScale(Vector3::UNIT_SCALE),
+        mDerivedOrientationPtr(&mDerivedOrientation),
+        mDerivedPositionPtr(&mDerivedPosition),
+        mDerivedScalePtr(&mDerivedScale),
+        mTransformPool(0),
+        mTransformPoolDepth(0),
+        mTransformPoolIndex(0),
         mInitialPosition(Vector3::ZERO),
         mInitialOrientation(Quaternion::IDENTITY),
         mInitialScale(Vector3::UNIT_SCALE),
@@ -108,6 +121,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     Node::~Node()
     {
+        if (mTransformPool)
+            mTransformPool->detach(this);
         OGRE_DELETE mDebug;
         mDebug = 0;
 
@@ -249,6 +264,55 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Node::_updateToDepth(bool parentHasChanged, size_t maxDepth,
+        PendingUpdateList& subtrees, NodeList& updated)
+    {
+        assert(maxDepth > 0 && "Use _update for the last level");
+
+        mParentNotified = false;
+
+        if (mNeedParentUpdate || parentHasChanged)
+        {
+            _updateFromParent();
+        }
+
+        if (mNeedChildUpdate || parentHasChanged)
+        {
+            ChildNodeMap::iterator it, itend;
+            itend = mChildren.end();
+            for (it = mChildren.begin(); it != itend; ++it)
+            {
+#if OGRE_NODE_STORAGE_LEGACY
+                Node* child = it->second;
+#else
+                Node* child = *it;
+#endif
+                if (maxDepth == 1)
+                    subtrees.push_back(PendingUpdate(child, true));
+                else
+                    child->_updateToDepth(true, maxDepth - 1, subtrees, updated);
+            }
+        }
+        else
+        {
+            ChildUpdateSet::iterator it, itend;
+            itend = mChildrenToUpdate.end();
+            for(it = mChildrenToUpdate.begin(); it != itend; ++it)
+            {
+                Node* child = *it;
+                if (maxDepth == 1)
+                    subtrees.push_back(PendingUpdate(child, false));
+                else
+                    child->_updateToDepth(false, maxDepth - 1, subtrees, updated);
+            }
+        }
+
+        mChildrenToUpdate.clear();
+        mNeedChildUpdate = false;
+
+        updated.push_back(this);
+    }
+    //-----------------------------------------------------------------------
     void Node::_updateFromParent(void) const
     {
         updateFromParentImpl();
@@ -264,23 +328,27 @@ namespace Ogre {
     {
         mCachedTransformOutOfDate = true;
 
+        Quaternion& derivedOrientation = *mDerivedOrientationPtr;
+        Vector3& derivedPosition = *mDerivedPositionPtr;
+        Vector3& derivedScale = *mDerivedScalePtr;
+
         if (mParent)
         {
 #if OGRE_NODE_INHERIT_TRANSFORM
             // Decompose full transform to position, orientation and scale, shear is lost here.
-            _getFullTransform().decomposition(mDerivedPosition, mDerivedScale, mDerivedOrientation);
+            _getFullTransform().decomposition(derivedPosition, derivedScale, derivedOrientation);
 #else
             // Update orientation
             const Quaternion& parentOrientation = mParent->_getDerivedOrientation();
             if (mInheritOrientation)
             {
                 // Combine orientation with that of parent
-                mDerivedOrientation = parentOrientation * mOrientation;
+                derivedOrientation = parentOrientation * mOrientation;
             }
             else
             {
                 // No inheritance
-                mDerivedOrientation = mOrientation;
+                derivedOrientation = mOrientation;
             }
 
             // Update scale
@@ -289,27 +357,27 @@ namespace Ogre {
             {
                 // Scale own position by parent scale, NB just combine
                 // as equivalent axes, no shearing
-                mDerivedScale = parentScale * mScale;
+                derivedScale = parentScale * mScale;
             }
             else
             {
                 // No inheritance
-                mDerivedScale = mScale;
+                derivedScale = mScale;
             }
 
             // Change position vector based on parent's orientation & scale
-            mDerivedPosition = parentOrientation * (parentScale * mPosition);
+            derivedPosition = parentOrientation * (parentScale * mPosition);
 
             // Add altered position vector to parents
-            mDerivedPosition += mParent->_getDerivedPosition();
+            derivedPosition += mParent->_getDerivedPosition();
 #endif
         }
         else
         {
             // Root node, no parent
-            mDerivedOrientation = mOrientation;
-            mDerivedPosition = mPosition;
-            mDerivedScale = mScale;
+            derivedOrientation = mOrientation;
+            derivedPosition = mPosition;
+            derivedScale = mScale;
         }
 
         mNeedParentUpdate = false;
@@ -604,7 +672,7 @@ namespace Ogre {
         {
             _updateFromParent();
         }
-        return mDerivedOrientation;
+        return *mDerivedOrientationPtr;
     }
     //-----------------------------------------------------------------------
     const Vector3 & Node::_getDerivedPosition(void) const
@@ -613,7 +681,7 @@ namespace Ogre {
         {
             _updateFromParent();
         }
-        return mDerivedPosition;
+        return *mDerivedPositionPtr;
     }
     //-----------------------------------------------------------------------
     const Vector3 & Node::_getDerivedScale(void) const
@@ -622,7 +690,7 @@ namespace Ogre {
         {
             _updateFromParent();
         }
-        return mDerivedScale;
+        return *mDerivedScalePtr;
     }
     //-----------------------------------------------------------------------
     Vector3 Node::convertWorldToLocalPosition( const Vector3 &worldPos )
@@ -634,7 +702,7 @@ namespace Ogre {
 #if OGRE_NODE_INHERIT_TRANSFORM
         return _getFullTransform().inverseAffine().transformAffine(worldPos);
 #else
-        return mDerivedOrientation.Inverse() * (worldPos - mDerivedPosition) / mDerivedScale;
+        return mDerivedOrientationPtr->Inverse() * (worldPos - *mDerivedPositionPtr) / *mDerivedScalePtr;
 #endif
     }
     //-----------------------------------------------------------------------
@@ -657,10 +725,10 @@ namespace Ogre {
         return useScale ? 
 #if OGRE_NODE_INHERIT_TRANSFORM
             _getFullTransform().inverseAffine().transformDirectionAffine(worldDir) :
-            mDerivedOrientation.Inverse() * worldDir;
+            mDerivedOrientationPtr->Inverse() * worldDir;
 #else
-            mDerivedOrientation.Inverse() * worldDir / mDerivedScale :
-            mDerivedOrientation.Inverse() * worldDir;
+            mDerivedOrientationPtr->Inverse() * worldDir / *mDerivedScalePtr :
+            mDerivedOrientationPtr->Inverse() * worldDir;
 #endif
     }
     //-----------------------------------------------------------------------
@@ -672,7 +740,7 @@ namespace Ogre {
         }
         return useScale ? 
             _getFullTransform().transformDirectionAffine(localDir) :
-            mDerivedOrientation * localDir;
+            *mDerivedOrientationPtr * localDir;
     }
     //-----------------------------------------------------------------------
     Quaternion Node::convertWorldToLocalOrientation( const Quaternion &worldOrientation )
@@ -681,7 +749,7 @@ namespace Ogre {
         {
             _updateFromParent();
         }
-        return mDerivedOrientation.Inverse() * worldOrientation;
+        return mDerivedOrientationPtr->Inverse() * worldOrientation;
     }
     //-----------------------------------------------------------------------
     Quaternion Node::convertLocalToWorldOrientation( const Quaternion &localOrientation )
@@ -690,7 +758,7 @@ namespace Ogre {
         {
             _updateFromParent();
         }
-        return mDerivedOrientation * localOrientation;
+        return *mDerivedOrientationPtr * localOrientation;
 
     }
     //-----------------------------------------------------------------------
@@ -0,0 +1,203 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreNodeTransformPool.h"
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    NodeTransformPool::NodeTransformPool()
+    {
+    }
+    //-----------------------------------------------------------------------
+    NodeTransformPool::~NodeTransformPool()
+    {
+        for (LevelList::iterator i = mLevels.begin(); i != mLevels.end(); ++i)
+        {
+            Level* level = *i;
+            for (size_t slot = 0; slot < level->usedSlots; ++slot)
+            {
+                Node* node = level->chunks[slot / CHUNK_SIZE]->nodes[slot % CHUNK_SIZE];
+                if (node)
+                {
+                    detach(node);
+                }
+            }
+            for (ChunkList::iterator c = level->chunks.begin(); c != level->chunks.end(); ++c)
+            {
+                OGRE_DELETE *c;
+            }
+            OGRE_DELETE level;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformPool::attach(Node* node, size_t depth)
+    {
+        assert(!node->mTransformPool && "Node is already attached to a pool");
+
+        while (mLevels.size() <= depth)
+        {
+            mLevels.push_back(OGRE_NEW Level());
+        }
+
+        Level& level = *mLevels[depth];
+        size_t index;
+        if (!level.freeSlots.empty())
+        {
+            index = level.freeSlots.back();
+            level.freeSlots.pop_back();
+        }
+        else
+        {
+            index = level.usedSlots++;
+            if (index / CHUNK_SIZE == level.chunks.size())
+            {
+                level.chunks.push_back(OGRE_NEW Chunk());
+            }
+        }
+        ++level.nodeCount;
+
+        Chunk& chunk = *level.chunks[index / CHUNK_SIZE];
+        size_t slot = index % CHUNK_SIZE;
+        chunk.orientations[slot] = *node->mDerivedOrientationPtr;
+        chunk.positions[slot] = *node->mDerivedPositionPtr;
+        chunk.scales[slot] = *node->mDerivedScalePtr;
+        chunk.nodes[slot] = node;
+
+        node->mDerivedOrientationPtr = &chunk.orientations[slot];
+        node->mDerivedPositionPtr = &chunk.positions[slot];
+        node->mDerivedScalePtr = &chunk.scales[slot];
+        node->mTransformPool = this;
+        node->mTransformPoolDepth = depth;
+        node->mTransformPoolIndex = index;
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformPool::detach(Node* node)
+    {
+        assert(node->mTransformPool == this && "Node is not attached to this pool");
+
+        Level& level = *mLevels[node->mTransformPoolDepth];
+        size_t index = node->mTransformPoolIndex;
+        Chunk& chunk = *level.chunks[index / CHUNK_SIZE];
+        size_t slot = index % CHUNK_SIZE;
+
+        node->mDerivedOrientation = chunk.orientations[slot];
+        node->mDerivedPosition = chunk.positions[slot];
+        node->mDerivedScale = chunk.scales[slot];
+        node->mDerivedOrientationPtr = &node->mDerivedOrientation;
+        node->mDerivedPositionPtr = &node->mDerivedPosition;
+        node->mDerivedScalePtr = &node->mDerivedScale;
+        node->mTransformPool = 0;
+
+        // the other nodes keep their slots, this one is reused later
+        chunk.nodes[slot] = 0;
+        level.freeSlots.push_back(index);
+        --level.nodeCount;
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformPool::attachHierarchy(Node* node, size_t depth)
+    {
+        if (!node->mTransformPool)
+        {
+            attach(node, depth);
+        }
+
+        Node::ChildNodeMap::iterator it, itend;
+        itend = node->mChildren.end();
+        for (it = node->mChildren.begin(); it != itend; ++it)
+        {
+#if OGRE_NODE_STORAGE_LEGACY
+            attachHierarchy(it->second, depth + 1);
+#else
+            attachHierarchy(*it, depth + 1);
+#endif
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformPool::update(Node* root, Node::NodeList& updated)
+    {
+        mPending.clear();
+        mPending.push_back(Node::PendingUpdate(root, false));
+
+        size_t begin = 0;
+        while (begin < mPending.size())
+        {
+            size_t end = mPending.size();
+
+            // the whole level first, all parents are up to date by now
+            for (size_t i = begin; i < end; ++i)
+            {
+                Node* node = mPending[i].first;
+                node->mParentNotified = false;
+                if (node->mNeedParentUpdate || mPending[i].second)
+                {
+                    node->_updateFromParent();
+                }
+                updated.push_back(node);
+            }
+
+            // then collect the children that make up the next level
+            for (size_t i = begin; i < end; ++i)
+            {
+                Node* node = mPending[i].first;
+                if (node->mNeedChildUpdate || mPending[i].second)
+                {
+                    Node::ChildNodeMap::iterator it, itend;
+                    itend = node->mChildren.end();
+                    for (it = node->mChildren.begin(); it != itend; ++it)
+                    {
+#if OGRE_NODE_STORAGE_LEGACY
+                        mPending.push_back(Node::PendingUpdate(it->second, true));
+#else
+                        mPending.push_back(Node::PendingUpdate(*it, true));
+#endif
+                    }
+                }
+                else
+                {
+                    Node::ChildUpdateSet::iterator it, itend;
+                    itend = node->mChildrenToUpdate.end();
+                    for (it = node->mChildrenToUpdate.begin(); it != itend; ++it)
+                    {
+                        mPending.push_back(Node::PendingUpdate(*it, false));
+                    }
+                }
+
+                node->mChildrenToUpdate.clear();
+                node->mNeedChildUpdate = false;
+            }
+
+            begin = end;
+        }
+    }
+    //-----------------------------------------------------------------------
+    size_t NodeTransformPool::getNodeCount(size_t depth) const
+    {
+        return depth < mLevels.size() ? mLevels[depth]->nodeCount : 0;
+    }
+}
@@ -43,15 +43,29 @@ namespace Ogre {
     extern OptimisedUtil* _getOptimisedUtilGeneral(void);
 #if __OGRE_HAVE_SSE
     extern OptimisedUtil* _getOptimisedUtilSSE(void);
-//#elif __OGRE_HAVE_NEON
-//    extern OptimisedUtil* _getOptimisedUtilNEON(void);
+#elif __OGRE_HAVE_NEON
+    extern OptimisedUtil* _getOptimisedUtilNEON(void);
 //#elif __OGRE_HAVE_VFP
 //    extern OptimisedUtil* _getOptimisedUtilVFP(void);
 #endif
+#if __OGRE_HAVE_AVX2
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void);
+#endif
 #if __OGRE_HAVE_DIRECTXMATH
     extern OptimisedUtil* _getOptimisedUtilDirectXMath(void);
 #endif
 
+#if __OGRE_HAVE_AVX2
+    //---------------------------------------------------------------------
+    // The AVX2 implementation uses FMA throughout, and the SSE one for the rest.
+    static bool _hasAVX2(void)
+    {
+        const uint required = PlatformInformation::CPU_FEATURE_SSE |
+            PlatformInformation::CPU_FEATURE_AVX2 | PlatformInformation::CPU_FEATURE_FMA;
+        return (PlatformInformation::getCpuFeatures() & required) == required;
+    }
+#endif
+
 #ifdef __DO_PROFILE__
     //---------------------------------------------------------------------
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
@@ -86,10 +100,13 @@ namespace Ogre {
             IMPL_DEFAULT,
 #if __OGRE_HAVE_SSE
             IMPL_SSE,
-//#elif __OGRE_HAVE_NEON
-//            IMPL_NEON,
+#elif __OGRE_HAVE_NEON
+            IMPL_NEON,
 //#elif __OGRE_HAVE_VFP
 //            IMPL_VFP,
+#endif
+#if __OGRE_HAVE_AVX2
+            IMPL_AVX2,
 #endif
             IMPL_COUNT
         };
@@ -142,11 +159,17 @@ namespace Ogre {
 //            {
 //                mOptimisedUtils.push_back(_getOptimisedUtilVFP());
 //            }
-//#elif __OGRE_HAVE_NEON
-//            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
-//            {
-//                mOptimisedUtils.push_back(_getOptimisedUtilNEON());
-//            }
+#elif __OGRE_HAVE_NEON
+            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
+            {
+                mOptimisedUtils.push_back(_getOptimisedUtilNEON());
+            }
+#endif
+#if __OGRE_HAVE_AVX2
+            if (_hasAVX2())
+            {
+                mOptimisedUtils.push_back(_getOptimisedUtilAVX2());
+            }
 #endif
         }
 
@@ -348,6 +371,95 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        virtual void calculateBoxVisibility(
+            const float* planes,
+            size_t numPlanes,
+            const float* bounds,
+            uint32* visibility,
+            size_t numBoxes)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->calculateBoxVisibility(
+                planes,
+                numPlanes,
+                bounds,
+                visibility,
+                numBoxes);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void blendTransformKeyFrames(
+            const float* const* keyFrames1,
+            const float* const* keyFrames2,
+            const float* interpolations,
+            const float* weights,
+            Real scale,
+            bool shortestPath,
+            float* transforms,
+            size_t numTransforms)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->blendTransformKeyFrames(
+                keyFrames1,
+                keyFrames2,
+                interpolations,
+                weights,
+                scale,
+                shortestPath,
+                transforms,
+                numTransforms);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void accumulateVertexOffsets(
+            Real weight,
+            const float* offsets,
+            const uint32* indexes,
+            float* dest,
+            size_t destStride,
+            size_t numOffsets)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->accumulateVertexOffsets(
+                weight,
+                offsets,
+                indexes,
+                dest,
+                destStride,
+                numOffsets);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
     };
 #endif // __DO_PROFILE__
 
@@ -401,6 +513,13 @@ namespace Ogre {
 
 #else   // !__DO_PROFILE__
 
+#if __OGRE_HAVE_AVX2
+        if (_hasAVX2())
+        {
+            return _getOptimisedUtilAVX2();
+        }
+        else
+#endif  // __OGRE_HAVE_AVX2
 #if __OGRE_HAVE_SSE
         if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
         {
@@ -413,12 +532,12 @@ namespace Ogre {
 //            return _getOptimisedUtilVFP();
 //        }
 //        else
-//#elif __OGRE_HAVE_NEON
-//        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
-//        {
-//            return _getOptimisedUtilNEON();
-//        }
-//        else
+#elif __OGRE_HAVE_NEON
+        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
+        {
+            return _getOptimisedUtilNEON();
+        }
+        else
 #endif  // __OGRE_HAVE_SSE
         {
 #if __OGRE_HAVE_DIRECTXMATH
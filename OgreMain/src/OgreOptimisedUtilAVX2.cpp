@@ -0,0 +1,583 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreOptimisedUtil.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_AVX2
+
+#include "OgreVector3.h"
+#include "OgreMatrix4.h"
+
+#include "OgreSIMDHelper.h"
+#include <immintrin.h>
+
+//-------------------------------------------------------------------------
+//
+// Unlike the SSE implementation, which relies on SSE being enabled for
+// the whole file, the rest of OgreMain must keep running on CPUs without
+// AVX. So the routines here are compiled for AVX2/FMA function by function
+// (gcc/clang 'target' attribute, MSVC accepts the intrinsics anyway) and
+// OptimisedUtil only picks this implementation when the CPU and OS report
+// support for both at runtime.
+//
+// Don't put any code without the __OGRE_AVX2_TARGET attribute in here that
+// uses the intrinsics, gcc refuses to inline them into such functions.
+//
+//-------------------------------------------------------------------------
+
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC
+#define __OGRE_AVX2_TARGET
+#else
+#define __OGRE_AVX2_TARGET  __attribute__((target("avx2,fma")))
+#endif
+
+namespace Ogre {
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** AVX2 implementation of OptimisedUtil.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilAVX2 : public OptimisedUtil
+    {
+    protected:
+        /// Implementation used for the routines without an AVX2 version
+        OptimisedUtil* mFallback;
+
+    public:
+        /// Constructor
+        OptimisedUtilAVX2(OptimisedUtil* fallback);
+
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Matrix4* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET softwareVertexMorph(
+            Real t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+            size_t numVertices,
+            bool morphNormals);
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET concatenateAffineMatrices(
+            const Matrix4& baseMatrix,
+            const Matrix4* srcMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices);
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles);
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces);
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::calculateBoxVisibility
+        virtual void calculateBoxVisibility(
+            const float* planes,
+            size_t numPlanes,
+            const float* bounds,
+            uint32* visibility,
+            size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::blendTransformKeyFrames
+        virtual void blendTransformKeyFrames(
+            const float* const* keyFrames1,
+            const float* const* keyFrames2,
+            const float* interpolations,
+            const float* weights,
+            Real scale,
+            bool shortestPath,
+            float* transforms,
+            size_t numTransforms);
+
+        /// @copydoc OptimisedUtil::accumulateVertexOffsets
+        virtual void accumulateVertexOffsets(
+            Real weight,
+            const float* offsets,
+            const uint32* indexes,
+            float* dest,
+            size_t destStride,
+            size_t numOffsets);
+    };
+    //---------------------------------------------------------------------
+    // Local helpers
+    //---------------------------------------------------------------------
+    // Mask selecting x, y and z, masked load/store never touch the fourth
+    // float, so packed and interleaved buffers can be read and written in
+    // place without over-running the end of the buffer.
+    static __OGRE_AVX2_TARGET inline __m128i __avx2Vector3Mask(void)
+    {
+        return _mm_setr_epi32(-1, -1, -1, 0);
+    }
+    //---------------------------------------------------------------------
+    static __OGRE_AVX2_TARGET inline __m128 __avx2LoadVector3(const float* p)
+    {
+        return _mm_maskload_ps(p, __avx2Vector3Mask());
+    }
+    //---------------------------------------------------------------------
+    static __OGRE_AVX2_TARGET inline void __avx2StoreVector3(float* p, __m128 v)
+    {
+        _mm_maskstore_ps(p, __avx2Vector3Mask(), v);
+    }
+    //---------------------------------------------------------------------
+    // Same semantic as Vector3::normalise, zero length vectors are unchanged.
+    static __OGRE_AVX2_TARGET inline __m128 __avx2NormaliseVector3(__m128 v)
+    {
+        __m128 length = _mm_sqrt_ps(_mm_dp_ps(v, v, 0x7F));
+        __m128 normalised = _mm_mul_ps(v, _mm_div_ps(_mm_set1_ps(1.0f), length));
+        return _mm_blendv_ps(v, normalised, _mm_cmpgt_ps(length, _mm_setzero_ps()));
+    }
+    //---------------------------------------------------------------------
+    static __OGRE_AVX2_TARGET inline __m256 __avx2Duplicate(__m128 v)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(v), v, 1);
+    }
+    //---------------------------------------------------------------------
+    static __OGRE_AVX2_TARGET inline __m256 __avx2Combine(__m128 lo, __m128 hi)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+    }
+    //---------------------------------------------------------------------
+    // Cross product of the xyz parts in each 128-bit lane, w will be zero.
+    static __OGRE_AVX2_TARGET inline __m256 __avx2CrossProduct(__m256 a, __m256 b)
+    {
+        __m256 a_yzx = _mm256_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        __m256 b_yzx = _mm256_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        __m256 a_zxy = _mm256_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+        __m256 b_zxy = _mm256_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+        return _mm256_sub_ps(_mm256_mul_ps(a_yzx, b_zxy), _mm256_mul_ps(a_zxy, b_yzx));
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    OptimisedUtilAVX2::OptimisedUtilAVX2(OptimisedUtil* fallback)
+        : mFallback(fallback)
+    {
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Matrix4* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        for (size_t vertIdx = 0; vertIdx < numVertices; ++vertIdx)
+        {
+            // Blend the 3x4 matrices first, then transform once
+            __m128 row0 = zero, row1 = zero, row2 = zero;
+            for (size_t blendIdx = 0; blendIdx < numWeightsPerVertex; ++blendIdx)
+            {
+                // NB weights must be normalised!!
+                Real weight = pBlendWeight[blendIdx];
+                if (weight)
+                {
+                    const Matrix4& mat = *blendMatrices[pBlendIndex[blendIdx]];
+                    __m128 w = _mm_set1_ps(weight);
+                    row0 = _mm_fmadd_ps(_mm_loadu_ps(mat[0]), w, row0);
+                    row1 = _mm_fmadd_ps(_mm_loadu_ps(mat[1]), w, row1);
+                    row2 = _mm_fmadd_ps(_mm_loadu_ps(mat[2]), w, row2);
+                }
+            }
+
+            // Position with w = 1 picks up the translation
+            __m128 pos = _mm_blend_ps(__avx2LoadVector3(pSrcPos), one, 0x8);
+
+            if (pSrcNorm)
+            {
+                // Position in the low lane, normal (w = 0, rotation only) in the high lane,
+                // so both are transformed by the same three dot products.
+                __m256 posNorm = __avx2Combine(pos, __avx2LoadVector3(pSrcNorm));
+                __m256 p0 = _mm256_mul_ps(__avx2Duplicate(row0), posNorm);
+                __m256 p1 = _mm256_mul_ps(__avx2Duplicate(row1), posNorm);
+                __m256 p2 = _mm256_mul_ps(__avx2Duplicate(row2), posNorm);
+                __m256 result = _mm256_hadd_ps(
+                    _mm256_hadd_ps(p0, p1), _mm256_hadd_ps(p2, _mm256_setzero_ps()));
+
+                __avx2StoreVector3(pDestPos, _mm256_castps256_ps128(result));
+                __avx2StoreVector3(pDestNorm,
+                    __avx2NormaliseVector3(_mm256_extractf128_ps(result, 1)));
+
+                advanceRawPointer(pSrcNorm, srcNormStride);
+                advanceRawPointer(pDestNorm, destNormStride);
+            }
+            else
+            {
+                __m128 p0 = _mm_mul_ps(row0, pos);
+                __m128 p1 = _mm_mul_ps(row1, pos);
+                __m128 p2 = _mm_mul_ps(row2, pos);
+                __avx2StoreVector3(pDestPos,
+                    _mm_hadd_ps(_mm_hadd_ps(p0, p1), _mm_hadd_ps(p2, zero)));
+            }
+
+            advanceRawPointer(pSrcPos, srcPosStride);
+            advanceRawPointer(pDestPos, destPosStride);
+            advanceRawPointer(pBlendWeight, blendWeightStride);
+            advanceRawPointer(pBlendIndex, blendIndexStride);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::softwareVertexMorph(
+        Real t,
+        const float *pSrc1, const float *pSrc2,
+        float *pDst,
+        size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+        size_t numVertices,
+        bool morphNormals)
+    {
+        const size_t packedVSize = 3 * sizeof(float);
+        if (!morphNormals &&
+            pos1VSize == packedVSize && pos2VSize == packedVSize && dstVSize == packedVSize)
+        {
+            // Packed positions, simply interpolate the whole float stream
+            const __m256 t8 = _mm256_set1_ps(t);
+            size_t numFloats = numVertices * 3;
+            size_t i = 0;
+            for (; i + 8 <= numFloats; i += 8)
+            {
+                __m256 a = _mm256_loadu_ps(pSrc1 + i);
+                __m256 b = _mm256_loadu_ps(pSrc2 + i);
+                _mm256_storeu_ps(pDst + i, _mm256_fmadd_ps(_mm256_sub_ps(b, a), t8, a));
+            }
+            for (; i < numFloats; ++i)
+            {
+                pDst[i] = pSrc1[i] + t * (pSrc2[i] - pSrc1[i]);
+            }
+            return;
+        }
+
+        const __m128 t4 = _mm_set1_ps(t);
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            __m128 a = __avx2LoadVector3(pSrc1);
+            __m128 b = __avx2LoadVector3(pSrc2);
+            __avx2StoreVector3(pDst, _mm_fmadd_ps(_mm_sub_ps(b, a), t4, a));
+
+            if (morphNormals)
+            {
+                // normals must be in the same buffer as pos, perform an nlerp
+                a = __avx2LoadVector3(pSrc1 + 3);
+                b = __avx2LoadVector3(pSrc2 + 3);
+                __avx2StoreVector3(pDst + 3,
+                    __avx2NormaliseVector3(_mm_fmadd_ps(_mm_sub_ps(b, a), t4, a)));
+            }
+
+            advanceRawPointer(pSrc1, pos1VSize);
+            advanceRawPointer(pSrc2, pos2VSize);
+            advanceRawPointer(pDst, dstVSize);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::concatenateAffineMatrices(
+        const Matrix4& baseMatrix,
+        const Matrix4* pSrcMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        const Matrix4& m = baseMatrix;
+
+        // Rows 0 and 1 of the result are computed together in one 256-bit register,
+        // each lane being a broadcast base matrix element times a source row.
+        const __m256 m01_0 = __avx2Combine(_mm_set1_ps(m[0][0]), _mm_set1_ps(m[1][0]));
+        const __m256 m01_1 = __avx2Combine(_mm_set1_ps(m[0][1]), _mm_set1_ps(m[1][1]));
+        const __m256 m01_2 = __avx2Combine(_mm_set1_ps(m[0][2]), _mm_set1_ps(m[1][2]));
+        const __m256 m01_3 = __avx2Combine(
+            _mm_setr_ps(0, 0, 0, m[0][3]), _mm_setr_ps(0, 0, 0, m[1][3]));
+        const __m128 m2_0 = _mm_set1_ps(m[2][0]);
+        const __m128 m2_1 = _mm_set1_ps(m[2][1]);
+        const __m128 m2_2 = _mm_set1_ps(m[2][2]);
+        const __m128 m2_3 = _mm_setr_ps(0, 0, 0, m[2][3]);
+        const __m128 row3 = _mm_setr_ps(0, 0, 0, 1);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const Matrix4& s = *pSrcMat;
+            Matrix4& d = *pDstMat;
+
+            __m128 s0 = _mm_loadu_ps(s[0]);
+            __m128 s1 = _mm_loadu_ps(s[1]);
+            __m128 s2 = _mm_loadu_ps(s[2]);
+
+            __m256 d01 = _mm256_fmadd_ps(m01_0, __avx2Duplicate(s0),
+                _mm256_fmadd_ps(m01_1, __avx2Duplicate(s1),
+                    _mm256_fmadd_ps(m01_2, __avx2Duplicate(s2), m01_3)));
+            __m128 d2 = _mm_fmadd_ps(m2_0, s0,
+                _mm_fmadd_ps(m2_1, s1,
+                    _mm_fmadd_ps(m2_2, s2, m2_3)));
+
+            // Matrix4 rows are contiguous
+            _mm256_storeu_ps(d[0], d01);
+            _mm_storeu_ps(d[2], d2);
+            _mm_storeu_ps(d[3], row3);
+
+            ++pSrcMat;
+            ++pDstMat;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        // Two triangles per iteration, one in each 128-bit lane
+        for ( ; numTriangles >= 2; numTriangles -= 2)
+        {
+            const EdgeData::Triangle& t0 = triangles[0];
+            const EdgeData::Triangle& t1 = triangles[1];
+
+            __m256 v1 = __avx2Combine(
+                __avx2LoadVector3(positions + t0.vertIndex[0] * 3),
+                __avx2LoadVector3(positions + t1.vertIndex[0] * 3));
+            __m256 v2 = __avx2Combine(
+                __avx2LoadVector3(positions + t0.vertIndex[1] * 3),
+                __avx2LoadVector3(positions + t1.vertIndex[1] * 3));
+            __m256 v3 = __avx2Combine(
+                __avx2LoadVector3(positions + t0.vertIndex[2] * 3),
+                __avx2LoadVector3(positions + t1.vertIndex[2] * 3));
+
+            __m256 normal = __avx2CrossProduct(_mm256_sub_ps(v2, v1), _mm256_sub_ps(v3, v1));
+            // w = -(normal . v1)
+            __m256 dist = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_dp_ps(normal, v1, 0x7F));
+            _mm256_storeu_ps(faceNormals->ptr(), _mm256_blend_ps(normal, dist, 0x88));
+
+            triangles += 2;
+            faceNormals += 2;
+        }
+
+        if (numTriangles)
+        {
+            const EdgeData::Triangle& t = *triangles;
+
+            __m128 v1 = __avx2LoadVector3(positions + t.vertIndex[0] * 3);
+            __m128 v2 = __avx2LoadVector3(positions + t.vertIndex[1] * 3);
+            __m128 v3 = __avx2LoadVector3(positions + t.vertIndex[2] * 3);
+
+            __m128 normal = _mm256_castps256_ps128(__avx2CrossProduct(
+                _mm256_castps128_ps256(_mm_sub_ps(v2, v1)),
+                _mm256_castps128_ps256(_mm_sub_ps(v3, v1))));
+            __m128 dist = _mm_sub_ps(_mm_setzero_ps(), _mm_dp_ps(normal, v1, 0x7F));
+            _mm_storeu_ps(faceNormals->ptr(), _mm_blend_ps(normal, dist, 0x8));
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        const __m256 light = __avx2Duplicate(_mm_loadu_ps(lightPos.ptr()));
+        const __m256 zero = _mm256_setzero_ps();
+        // The horizontal adds below leave the dot products of faces
+        // 0 2 4 6 in the low lane and 1 3 5 7 in the high lane
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        // Eight faces per iteration
+        for ( ; numFaces >= 8; numFaces -= 8)
+        {
+            const float* n = faceNormals->ptr();
+            __m256 p0 = _mm256_mul_ps(_mm256_loadu_ps(n +  0), light);
+            __m256 p1 = _mm256_mul_ps(_mm256_loadu_ps(n +  8), light);
+            __m256 p2 = _mm256_mul_ps(_mm256_loadu_ps(n + 16), light);
+            __m256 p3 = _mm256_mul_ps(_mm256_loadu_ps(n + 24), light);
+            __m256 dots = _mm256_permutevar8x32_ps(
+                _mm256_hadd_ps(_mm256_hadd_ps(p0, p1), _mm256_hadd_ps(p2, p3)), order);
+
+            int mask = _mm256_movemask_ps(_mm256_cmp_ps(dots, zero, _CMP_GT_OQ));
+            for (int j = 0; j < 8; ++j)
+            {
+                lightFacings[j] = (mask >> j) & 1;
+            }
+
+            faceNormals += 8;
+            lightFacings += 8;
+        }
+
+        const __m128 light4 = _mm256_castps256_ps128(light);
+        for ( ; numFaces; --numFaces)
+        {
+            __m128 dot = _mm_dp_ps(_mm_loadu_ps(faceNormals->ptr()), light4, 0xF1);
+            *lightFacings++ = _mm_comigt_ss(dot, _mm_setzero_ps()) != 0;
+            ++faceNormals;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, extrusion is along light direction
+
+            Vector3 extrusionDir(
+                -lightPos.x,
+                -lightPos.y,
+                -lightPos.z);
+            extrusionDir.normalise();
+            extrusionDir *= extrudeDist;
+
+            const float x = extrusionDir.x, y = extrusionDir.y, z = extrusionDir.z;
+
+            // Eight vertices are 24 floats, i.e. three registers with a repeating
+            // pattern of the extrusion vector
+            const __m256 dir0 = _mm256_setr_ps(x, y, z, x, y, z, x, y);
+            const __m256 dir1 = _mm256_setr_ps(z, x, y, z, x, y, z, x);
+            const __m256 dir2 = _mm256_setr_ps(y, z, x, y, z, x, y, z);
+
+            size_t vert = 0;
+            for (; vert + 8 <= numVertices; vert += 8)
+            {
+                _mm256_storeu_ps(pDestPos +  0, _mm256_add_ps(_mm256_loadu_ps(pSrcPos +  0), dir0));
+                _mm256_storeu_ps(pDestPos +  8, _mm256_add_ps(_mm256_loadu_ps(pSrcPos +  8), dir1));
+                _mm256_storeu_ps(pDestPos + 16, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 16), dir2));
+                pSrcPos += 24;
+                pDestPos += 24;
+            }
+
+            for (; vert < numVertices; ++vert)
+            {
+                *pDestPos++ = *pSrcPos++ + x;
+                *pDestPos++ = *pSrcPos++ + y;
+                *pDestPos++ = *pSrcPos++ + z;
+            }
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            const __m128 light = __avx2LoadVector3(lightPos.ptr());
+            const __m128 dist = _mm_set1_ps(extrudeDist);
+
+            for (size_t vert = 0; vert < numVertices; ++vert)
+            {
+                __m128 pos = __avx2LoadVector3(pSrcPos);
+                __m128 extrusionDir = __avx2NormaliseVector3(_mm_sub_ps(pos, light));
+                __avx2StoreVector3(pDestPos, _mm_fmadd_ps(extrusionDir, dist, pos));
+
+                pSrcPos += 3;
+                pDestPos += 3;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::calculateBoxVisibility(
+        const float* planes,
+        size_t numPlanes,
+        const float* bounds,
+        uint32* visibility,
+        size_t numBoxes)
+    {
+        // Already processes four boxes per instruction, memory bound rather than ALU bound
+        mFallback->calculateBoxVisibility(planes, numPlanes, bounds, visibility, numBoxes);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::blendTransformKeyFrames(
+        const float* const* keyFrames1,
+        const float* const* keyFrames2,
+        const float* interpolations,
+        const float* weights,
+        Real scale,
+        bool shortestPath,
+        float* transforms,
+        size_t numTransforms)
+    {
+        mFallback->blendTransformKeyFrames(keyFrames1, keyFrames2, interpolations, weights,
+            scale, shortestPath, transforms, numTransforms);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::accumulateVertexOffsets(
+        Real weight,
+        const float* offsets,
+        const uint32* indexes,
+        float* dest,
+        size_t destStride,
+        size_t numOffsets)
+    {
+        // Bound by the scattered writes, wider registers don't help
+        mFallback->accumulateVertexOffsets(weight, offsets, indexes, dest, destStride, numOffsets);
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilSSE(void);
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void)
+    {
+        static OptimisedUtilAVX2 msOptimisedUtilAVX2(_getOptimisedUtilSSE());
+        return &msOptimisedUtilAVX2;
+    }
+
+}
+
+#endif // __OGRE_HAVE_AVX2
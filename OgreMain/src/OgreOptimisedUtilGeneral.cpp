@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include "OgreVector3.h"
 #include "OgreMatrix4.h"
+#include "OgreQuaternion.h"
 
 namespace Ogre {
 
@@ -94,6 +95,34 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::calculateBoxVisibility
+        virtual void calculateBoxVisibility(
+            const float* planes,
+            size_t numPlanes,
+            const float* bounds,
+            uint32* visibility,
+            size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::blendTransformKeyFrames
+        virtual void blendTransformKeyFrames(
+            const float* const* keyFrames1,
+            const float* const* keyFrames2,
+            const float* interpolations,
+            const float* weights,
+            Real scale,
+            bool shortestPath,
+            float* transforms,
+            size_t numTransforms);
+
+        /// @copydoc OptimisedUtil::accumulateVertexOffsets
+        virtual void accumulateVertexOffsets(
+            Real weight,
+            const float* offsets,
+            const uint32* indexes,
+            float* dest,
+            size_t destStride,
+            size_t numOffsets);
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -392,6 +421,105 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::calculateBoxVisibility(
+        const float* planes,
+        size_t numPlanes,
+        const float* bounds,
+        uint32* visibility,
+        size_t numBoxes)
+    {
+        memset(visibility, 0, ((numBoxes + 31) / 32) * sizeof(uint32));
+
+        for (size_t box = 0; box < numBoxes; ++box)
+        {
+            // Locate the box in its group of four
+            const float* group = bounds + (box / 4) * 24 + (box & 3);
+            float cx = group[0], cy = group[4], cz = group[8];
+            float hx = group[12], hy = group[16], hz = group[20];
+
+            bool visible = true;
+            const float* plane = planes;
+            for (size_t p = 0; p < numPlanes; ++p, plane += 4)
+            {
+                float dist = plane[0] * cx + plane[1] * cy + plane[2] * cz + plane[3];
+                float maxAbsDist = Math::Abs(plane[0]) * hx + Math::Abs(plane[1]) * hy +
+                    Math::Abs(plane[2]) * hz;
+                if (dist < -maxAbsDist)
+                {
+                    visible = false;
+                    break;
+                }
+            }
+
+            if (visible)
+                visibility[box / 32] |= 1u << (box % 32);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::blendTransformKeyFrames(
+        const float* const* keyFrames1,
+        const float* const* keyFrames2,
+        const float* interpolations,
+        const float* weights,
+        Real scale,
+        bool shortestPath,
+        float* transforms,
+        size_t numTransforms)
+    {
+        for (size_t i = 0; i < numTransforms; ++i)
+        {
+            const float* k1 = keyFrames1[i];
+            const float* k2 = keyFrames2[i];
+            Real t = interpolations[i];
+            Real weight = weights[i];
+
+            // Interpolate between the keyframes
+            Quaternion rotation = Quaternion::nlerp(t,
+                Quaternion(k1[0], k1[1], k1[2], k1[3]),
+                Quaternion(k2[0], k2[1], k2[2], k2[3]), shortestPath);
+            Vector3 base(k1[4], k1[5], k1[6]);
+            Vector3 translate = base + (Vector3(k2[4], k2[5], k2[6]) - base) * t;
+            base = Vector3(k1[8], k1[9], k1[10]);
+            Vector3 scl = base + (Vector3(k2[8], k2[9], k2[10]) - base) * t;
+
+            // Weight it, as NodeAnimationTrack::applyToNode does
+            rotation = Quaternion::nlerp(weight, Quaternion::IDENTITY, rotation, shortestPath);
+            translate *= weight * scale;
+            scl = Vector3::UNIT_SCALE + (scl - Vector3::UNIT_SCALE) * (scale != 1.0f ? scale : weight);
+
+            transforms[0] = rotation.w;
+            transforms[1] = rotation.x;
+            transforms[2] = rotation.y;
+            transforms[3] = rotation.z;
+            transforms[4] = translate.x;
+            transforms[5] = translate.y;
+            transforms[6] = translate.z;
+            transforms[7] = 0;
+            transforms[8] = scl.x;
+            transforms[9] = scl.y;
+            transforms[10] = scl.z;
+            transforms[11] = 0;
+            transforms += 12;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::accumulateVertexOffsets(
+        Real weight,
+        const float* offsets,
+        const uint32* indexes,
+        float* dest,
+        size_t destStride,
+        size_t numOffsets)
+    {
+        for (size_t i = 0; i < numOffsets; ++i, offsets += 3)
+        {
+            float* pDest = rawOffsetPointer(dest, indexes[i] * destStride);
+            pDest[0] += offsets[0] * weight;
+            pDest[1] += offsets[1] * weight;
+            pDest[2] += offsets[2] * weight;
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilGeneral(void)
@@ -0,0 +1,588 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreOptimisedUtil.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_NEON
+
+#include "OgreVector3.h"
+#include "OgreMatrix4.h"
+
+#include <arm_neon.h>
+
+//-------------------------------------------------------------------------
+//
+// Only intrinsics available on both ARMv7 NEON and AArch64 Advanced SIMD
+// are used here, so the file works for 32 and 64-bit builds alike. The
+// structure loads/stores (vld3/vld4, vst3/vst4) deinterleave the packed
+// xyz / xyzw streams, which lets most routines work on four vertices or
+// faces at once.
+//
+//-------------------------------------------------------------------------
+
+namespace Ogre {
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** NEON implementation of OptimisedUtil.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilNEON : public OptimisedUtil
+    {
+    protected:
+        /// Implementation used for the routines without a NEON version
+        OptimisedUtil* mFallback;
+
+    public:
+        /// Constructor
+        OptimisedUtilNEON(OptimisedUtil* fallback);
+
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        virtual void softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Matrix4* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        virtual void softwareVertexMorph(
+            Real t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+            size_t numVertices,
+            bool morphNormals);
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        virtual void concatenateAffineMatrices(
+            const Matrix4& baseMatrix,
+            const Matrix4* srcMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices);
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        virtual void calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles);
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        virtual void calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces);
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        virtual void extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::calculateBoxVisibility
+        virtual void calculateBoxVisibility(
+            const float* planes,
+            size_t numPlanes,
+            const float* bounds,
+            uint32* visibility,
+            size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::blendTransformKeyFrames
+        virtual void blendTransformKeyFrames(
+            const float* const* keyFrames1,
+            const float* const* keyFrames2,
+            const float* interpolations,
+            const float* weights,
+            Real scale,
+            bool shortestPath,
+            float* transforms,
+            size_t numTransforms);
+
+        /// @copydoc OptimisedUtil::accumulateVertexOffsets
+        virtual void accumulateVertexOffsets(
+            Real weight,
+            const float* offsets,
+            const uint32* indexes,
+            float* dest,
+            size_t destStride,
+            size_t numOffsets);
+    };
+    //---------------------------------------------------------------------
+    // Local helpers
+    //---------------------------------------------------------------------
+    // Loads x, y, z without reading past the third float, w is zero.
+    static OGRE_FORCE_INLINE float32x4_t __neonLoadVector3(const float* p)
+    {
+        return vcombine_f32(vld1_f32(p), vld1_lane_f32(p + 2, vdup_n_f32(0), 0));
+    }
+    //---------------------------------------------------------------------
+    static OGRE_FORCE_INLINE void __neonStoreVector3(float* p, float32x4_t v)
+    {
+        vst1_f32(p, vget_low_f32(v));
+        vst1q_lane_f32(p + 2, v, 2);
+    }
+    //---------------------------------------------------------------------
+    static OGRE_FORCE_INLINE float __neonHorizontalSum(float32x4_t v)
+    {
+        float32x2_t s = vpadd_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(vpadd_f32(s, s), 0);
+    }
+    //---------------------------------------------------------------------
+    // Same semantic as Vector3::normalise, zero length vectors are unchanged.
+    static OGRE_FORCE_INLINE float32x4_t __neonNormaliseVector3(float32x4_t v)
+    {
+        Real length = Math::Sqrt(__neonHorizontalSum(vmulq_f32(v, v)));
+        if (length > Real(0.0f))
+        {
+            v = vmulq_n_f32(v, 1.0f / length);
+        }
+        return v;
+    }
+    //---------------------------------------------------------------------
+    // Reciprocal square root, refined by two Newton-Raphson steps.
+    static OGRE_FORCE_INLINE float32x4_t __neonRSqrt(float32x4_t x)
+    {
+        float32x4_t e = vrsqrteq_f32(x);
+        e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(x, e), e));
+        e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(x, e), e));
+        return e;
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    OptimisedUtilNEON::OptimisedUtilNEON(OptimisedUtil* fallback)
+        : mFallback(fallback)
+    {
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Matrix4* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        const float32x4_t zero = vdupq_n_f32(0);
+
+        for (size_t vertIdx = 0; vertIdx < numVertices; ++vertIdx)
+        {
+            // Blend the 3x4 matrices first, then transform once
+            float32x4_t row0 = zero, row1 = zero, row2 = zero;
+            for (size_t blendIdx = 0; blendIdx < numWeightsPerVertex; ++blendIdx)
+            {
+                // NB weights must be normalised!!
+                Real weight = pBlendWeight[blendIdx];
+                if (weight)
+                {
+                    const Matrix4& mat = *blendMatrices[pBlendIndex[blendIdx]];
+                    row0 = vmlaq_n_f32(row0, vld1q_f32(mat[0]), weight);
+                    row1 = vmlaq_n_f32(row1, vld1q_f32(mat[1]), weight);
+                    row2 = vmlaq_n_f32(row2, vld1q_f32(mat[2]), weight);
+                }
+            }
+
+            // Position with w = 1 picks up the translation
+            float32x4_t pos = vsetq_lane_f32(1.0f, __neonLoadVector3(pSrcPos), 3);
+            float32x4_t p0 = vmulq_f32(row0, pos);
+            float32x4_t p1 = vmulq_f32(row1, pos);
+            float32x4_t p2 = vmulq_f32(row2, pos);
+            float32x2_t xy = vpadd_f32(
+                vpadd_f32(vget_low_f32(p0), vget_high_f32(p0)),
+                vpadd_f32(vget_low_f32(p1), vget_high_f32(p1)));
+            vst1_f32(pDestPos, xy);
+            pDestPos[2] = __neonHorizontalSum(p2);
+
+            if (pSrcNorm)
+            {
+                // Rotation only, the normal has w = 0
+                float32x4_t norm = __neonLoadVector3(pSrcNorm);
+                float32x4_t n = vsetq_lane_f32(__neonHorizontalSum(vmulq_f32(row0, norm)), zero, 0);
+                n = vsetq_lane_f32(__neonHorizontalSum(vmulq_f32(row1, norm)), n, 1);
+                n = vsetq_lane_f32(__neonHorizontalSum(vmulq_f32(row2, norm)), n, 2);
+                __neonStoreVector3(pDestNorm, __neonNormaliseVector3(n));
+
+                advanceRawPointer(pSrcNorm, srcNormStride);
+                advanceRawPointer(pDestNorm, destNormStride);
+            }
+
+            advanceRawPointer(pSrcPos, srcPosStride);
+            advanceRawPointer(pDestPos, destPosStride);
+            advanceRawPointer(pBlendWeight, blendWeightStride);
+            advanceRawPointer(pBlendIndex, blendIndexStride);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::softwareVertexMorph(
+        Real t,
+        const float *pSrc1, const float *pSrc2,
+        float *pDst,
+        size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+        size_t numVertices,
+        bool morphNormals)
+    {
+        const size_t packedVSize = 3 * sizeof(float);
+        if (!morphNormals &&
+            pos1VSize == packedVSize && pos2VSize == packedVSize && dstVSize == packedVSize)
+        {
+            // Packed positions, simply interpolate the whole float stream
+            size_t numFloats = numVertices * 3;
+            size_t i = 0;
+            for (; i + 4 <= numFloats; i += 4)
+            {
+                float32x4_t a = vld1q_f32(pSrc1 + i);
+                float32x4_t b = vld1q_f32(pSrc2 + i);
+                vst1q_f32(pDst + i, vmlaq_n_f32(a, vsubq_f32(b, a), t));
+            }
+            for (; i < numFloats; ++i)
+            {
+                pDst[i] = pSrc1[i] + t * (pSrc2[i] - pSrc1[i]);
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            float32x4_t a = __neonLoadVector3(pSrc1);
+            float32x4_t b = __neonLoadVector3(pSrc2);
+            __neonStoreVector3(pDst, vmlaq_n_f32(a, vsubq_f32(b, a), t));
+
+            if (morphNormals)
+            {
+                // normals must be in the same buffer as pos, perform an nlerp
+                a = __neonLoadVector3(pSrc1 + 3);
+                b = __neonLoadVector3(pSrc2 + 3);
+                __neonStoreVector3(pDst + 3,
+                    __neonNormaliseVector3(vmlaq_n_f32(a, vsubq_f32(b, a), t)));
+            }
+
+            advanceRawPointer(pSrc1, pos1VSize);
+            advanceRawPointer(pSrc2, pos2VSize);
+            advanceRawPointer(pDst, dstVSize);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::concatenateAffineMatrices(
+        const Matrix4& baseMatrix,
+        const Matrix4* pSrcMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        const Matrix4& m = baseMatrix;
+        const float32x4_t zero = vdupq_n_f32(0);
+        const float32x4_t t0 = vsetq_lane_f32(m[0][3], zero, 3);
+        const float32x4_t t1 = vsetq_lane_f32(m[1][3], zero, 3);
+        const float32x4_t t2 = vsetq_lane_f32(m[2][3], zero, 3);
+        const float32x4_t row3 = vsetq_lane_f32(1.0f, zero, 3);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const Matrix4& s = *pSrcMat;
+            Matrix4& d = *pDstMat;
+
+            float32x4_t s0 = vld1q_f32(s[0]);
+            float32x4_t s1 = vld1q_f32(s[1]);
+            float32x4_t s2 = vld1q_f32(s[2]);
+
+            vst1q_f32(d[0], vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(t0, s0, m[0][0]), s1, m[0][1]), s2, m[0][2]));
+            vst1q_f32(d[1], vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(t1, s0, m[1][0]), s1, m[1][1]), s2, m[1][2]));
+            vst1q_f32(d[2], vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(t2, s0, m[2][0]), s1, m[2][1]), s2, m[2][2]));
+            vst1q_f32(d[3], row3);
+
+            ++pSrcMat;
+            ++pDstMat;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        const float32x4_t zero = vdupq_n_f32(0);
+
+        // Four triangles per iteration, gathered into one lane each
+        for ( ; numTriangles >= 4; numTriangles -= 4)
+        {
+            float32x4_t v[3][3];
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                const float* p0 = positions + triangles[0].vertIndex[corner] * 3;
+                const float* p1 = positions + triangles[1].vertIndex[corner] * 3;
+                const float* p2 = positions + triangles[2].vertIndex[corner] * 3;
+                const float* p3 = positions + triangles[3].vertIndex[corner] * 3;
+                for (int c = 0; c < 3; ++c)
+                {
+                    float32x4_t r = vld1q_lane_f32(p0 + c, zero, 0);
+                    r = vld1q_lane_f32(p1 + c, r, 1);
+                    r = vld1q_lane_f32(p2 + c, r, 2);
+                    v[corner][c] = vld1q_lane_f32(p3 + c, r, 3);
+                }
+            }
+
+            float32x4_t ax = vsubq_f32(v[1][0], v[0][0]);
+            float32x4_t ay = vsubq_f32(v[1][1], v[0][1]);
+            float32x4_t az = vsubq_f32(v[1][2], v[0][2]);
+            float32x4_t bx = vsubq_f32(v[2][0], v[0][0]);
+            float32x4_t by = vsubq_f32(v[2][1], v[0][1]);
+            float32x4_t bz = vsubq_f32(v[2][2], v[0][2]);
+
+            float32x4x4_t n;
+            n.val[0] = vmlsq_f32(vmulq_f32(ay, bz), az, by);
+            n.val[1] = vmlsq_f32(vmulq_f32(az, bx), ax, bz);
+            n.val[2] = vmlsq_f32(vmulq_f32(ax, by), ay, bx);
+            // w = -(normal . v1)
+            n.val[3] = vnegq_f32(vmlaq_f32(vmlaq_f32(
+                vmulq_f32(n.val[0], v[0][0]), n.val[1], v[0][1]), n.val[2], v[0][2]));
+
+            // Interleave back into four Vector4
+            vst4q_f32(faceNormals->ptr(), n);
+
+            triangles += 4;
+            faceNormals += 4;
+        }
+
+        for ( ; numTriangles; --numTriangles)
+        {
+            const EdgeData::Triangle& t = *triangles++;
+            const float* p0 = positions + t.vertIndex[0] * 3;
+            const float* p1 = positions + t.vertIndex[1] * 3;
+            const float* p2 = positions + t.vertIndex[2] * 3;
+
+            *faceNormals++ = Math::calculateFaceNormalWithoutNormalize(
+                Vector3(p0[0], p0[1], p0[2]),
+                Vector3(p1[0], p1[1], p1[2]),
+                Vector3(p2[0], p2[1], p2[2]));
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        const float32x4_t zero = vdupq_n_f32(0);
+
+        // Four faces per iteration, deinterleaved into x, y, z, w
+        for ( ; numFaces >= 4; numFaces -= 4)
+        {
+            float32x4x4_t n = vld4q_f32(faceNormals->ptr());
+            float32x4_t dot = vmulq_n_f32(n.val[0], lightPos.x);
+            dot = vmlaq_n_f32(dot, n.val[1], lightPos.y);
+            dot = vmlaq_n_f32(dot, n.val[2], lightPos.z);
+            dot = vmlaq_n_f32(dot, n.val[3], lightPos.w);
+
+            uint32x4_t facing = vcgtq_f32(dot, zero);
+            lightFacings[0] = vgetq_lane_u32(facing, 0) != 0;
+            lightFacings[1] = vgetq_lane_u32(facing, 1) != 0;
+            lightFacings[2] = vgetq_lane_u32(facing, 2) != 0;
+            lightFacings[3] = vgetq_lane_u32(facing, 3) != 0;
+
+            faceNormals += 4;
+            lightFacings += 4;
+        }
+
+        for ( ; numFaces; --numFaces)
+        {
+            *lightFacings++ = (lightPos.dotProduct(*faceNormals++) > 0);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        size_t vert = 0;
+
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, extrusion is along light direction
+
+            Vector3 extrusionDir(
+                -lightPos.x,
+                -lightPos.y,
+                -lightPos.z);
+            extrusionDir.normalise();
+            extrusionDir *= extrudeDist;
+
+            const float32x4_t dirX = vdupq_n_f32(extrusionDir.x);
+            const float32x4_t dirY = vdupq_n_f32(extrusionDir.y);
+            const float32x4_t dirZ = vdupq_n_f32(extrusionDir.z);
+
+            for (; vert + 4 <= numVertices; vert += 4)
+            {
+                float32x4x3_t p = vld3q_f32(pSrcPos);
+                p.val[0] = vaddq_f32(p.val[0], dirX);
+                p.val[1] = vaddq_f32(p.val[1], dirY);
+                p.val[2] = vaddq_f32(p.val[2], dirZ);
+                vst3q_f32(pDestPos, p);
+
+                pSrcPos += 12;
+                pDestPos += 12;
+            }
+
+            for (; vert < numVertices; ++vert)
+            {
+                *pDestPos++ = *pSrcPos++ + extrusionDir.x;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.y;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.z;
+            }
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            const float32x4_t zero = vdupq_n_f32(0);
+            const float32x4_t lightX = vdupq_n_f32(lightPos.x);
+            const float32x4_t lightY = vdupq_n_f32(lightPos.y);
+            const float32x4_t lightZ = vdupq_n_f32(lightPos.z);
+
+            for (; vert + 4 <= numVertices; vert += 4)
+            {
+                float32x4x3_t p = vld3q_f32(pSrcPos);
+                float32x4_t dx = vsubq_f32(p.val[0], lightX);
+                float32x4_t dy = vsubq_f32(p.val[1], lightY);
+                float32x4_t dz = vsubq_f32(p.val[2], lightZ);
+
+                float32x4_t sqLength = vmlaq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy), dz, dz);
+                // Zero length directions are left unchanged, as Vector3::normalise does
+                float32x4_t scale = vbslq_f32(vcgtq_f32(sqLength, zero),
+                    vmulq_n_f32(__neonRSqrt(sqLength), extrudeDist), vdupq_n_f32(extrudeDist));
+
+                p.val[0] = vmlaq_f32(p.val[0], dx, scale);
+                p.val[1] = vmlaq_f32(p.val[1], dy, scale);
+                p.val[2] = vmlaq_f32(p.val[2], dz, scale);
+                vst3q_f32(pDestPos, p);
+
+                pSrcPos += 12;
+                pDestPos += 12;
+            }
+
+            for (; vert < numVertices; ++vert)
+            {
+                Vector3 extrusionDir(
+                    pSrcPos[0] - lightPos.x,
+                    pSrcPos[1] - lightPos.y,
+                    pSrcPos[2] - lightPos.z);
+                extrusionDir.normalise();
+                extrusionDir *= extrudeDist;
+
+                *pDestPos++ = *pSrcPos++ + extrusionDir.x;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.y;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.z;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculateBoxVisibility(
+        const float* planes,
+        size_t numPlanes,
+        const float* bounds,
+        uint32* visibility,
+        size_t numBoxes)
+    {
+        mFallback->calculateBoxVisibility(planes, numPlanes, bounds, visibility, numBoxes);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::blendTransformKeyFrames(
+        const float* const* keyFrames1,
+        const float* const* keyFrames2,
+        const float* interpolations,
+        const float* weights,
+        Real scale,
+        bool shortestPath,
+        float* transforms,
+        size_t numTransforms)
+    {
+        mFallback->blendTransformKeyFrames(keyFrames1, keyFrames2, interpolations, weights,
+            scale, shortestPath, transforms, numTransforms);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::accumulateVertexOffsets(
+        Real weight,
+        const float* offsets,
+        const uint32* indexes,
+        float* dest,
+        size_t destStride,
+        size_t numOffsets)
+    {
+        float weighted[12];
+        size_t i = 0;
+        // Weight four offsets per-iteration, they are packed in three vectors
+        for (; i + 4 <= numOffsets; i += 4, offsets += 12)
+        {
+            vst1q_f32(weighted + 0, vmulq_n_f32(vld1q_f32(offsets + 0), weight));
+            vst1q_f32(weighted + 4, vmulq_n_f32(vld1q_f32(offsets + 4), weight));
+            vst1q_f32(weighted + 8, vmulq_n_f32(vld1q_f32(offsets + 8), weight));
+            for (size_t j = 0; j < 4; ++j)
+            {
+                float* pDest = rawOffsetPointer(dest, indexes[i + j] * destStride);
+                pDest[0] += weighted[j * 3 + 0];
+                pDest[1] += weighted[j * 3 + 1];
+                pDest[2] += weighted[j * 3 + 2];
+            }
+        }
+
+        mFallback->accumulateVertexOffsets(weight, offsets, indexes + i, dest, destStride, numOffsets - i);
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilNEON(void)
+    {
+        static OptimisedUtilNEON msOptimisedUtilNEON(_getOptimisedUtilGeneral());
+        return &msOptimisedUtilNEON;
+    }
+
+}
+
+#endif // __OGRE_HAVE_NEON
@@ -132,6 +132,34 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::calculateBoxVisibility
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE calculateBoxVisibility(
+            const float* planes,
+            size_t numPlanes,
+            const float* bounds,
+            uint32* visibility,
+            size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::blendTransformKeyFrames
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE blendTransformKeyFrames(
+            const float* const* keyFrames1,
+            const float* const* keyFrames2,
+            const float* interpolations,
+            const float* weights,
+            Real scale,
+            bool shortestPath,
+            float* transforms,
+            size_t numTransforms);
+
+        /// @copydoc OptimisedUtil::accumulateVertexOffsets
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE accumulateVertexOffsets(
+            Real weight,
+            const float* offsets,
+            const uint32* indexes,
+            float* dest,
+            size_t destStride,
+            size_t numOffsets);
     };
 
 #if defined(__OGRE_SIMD_ALIGN_STACK)
@@ -271,6 +299,68 @@ namespace Ogre {
                 destPositions,
                 numVertices);
         }
+
+        /// @copydoc OptimisedUtil::calculateBoxVisibility
+        virtual void calculateBoxVisibility(
+            const float* planes,
+            size_t numPlanes,
+            const float* bounds,
+            uint32* visibility,
+            size_t numBoxes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->calculateBoxVisibility(
+                planes,
+                numPlanes,
+                bounds,
+                visibility,
+                numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::blendTransformKeyFrames
+        virtual void blendTransformKeyFrames(
+            const float* const* keyFrames1,
+            const float* const* keyFrames2,
+            const float* interpolations,
+            const float* weights,
+            Real scale,
+            bool shortestPath,
+            float* transforms,
+            size_t numTransforms)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->blendTransformKeyFrames(
+                keyFrames1,
+                keyFrames2,
+                interpolations,
+                weights,
+                scale,
+                shortestPath,
+                transforms,
+                numTransforms);
+        }
+
+        /// @copydoc OptimisedUtil::accumulateVertexOffsets
+        virtual void accumulateVertexOffsets(
+            Real weight,
+            const float* offsets,
+            const uint32* indexes,
+            float* dest,
+            size_t destStride,
+            size_t numOffsets)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->accumulateVertexOffsets(
+                weight,
+                offsets,
+                indexes,
+                dest,
+                destStride,
+                numOffsets);
+        }
     };
 #endif  // !defined(__OGRE_SIMD_ALIGN_STACK)
 
@@ -1497,17 +1587,18 @@ namespace Ogre {
                 
                 // Fill a 4-vec with vector length
                 // square
-                __m128 tmp = _mm_mul_ps(norm, norm);
+                __m128 sq = _mm_mul_ps(norm, norm);
                 // Add - for this we want this effect:
                 // orig   3 | 2 | 1 | 0
                 // add1   0 | 0 | 0 | 2
                 // add2   2 | 3 | 0 | 3
                 // This way elements 0, 2 and 3 have the sum of all entries (except 1 which is unused)
+                // Both adds must take the original squares, or element 0 gets added twice
                 
-                tmp = _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(0,0,0,2)));
+                __m128 tmp = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(0,0,0,2)));
                 // Add final combination & sqrt 
                 // bottom 3 elements of l will have length, we don't care about 4
-                tmp = _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(2,3,0,3)));
+                tmp = _mm_add_ps(tmp, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2,3,0,3)));
                 // Then divide to normalise
                 norm = _mm_div_ps(norm, _mm_sqrt_ps(tmp));
                 
@@ -2136,6 +2227,236 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilSSE::calculateBoxVisibility(
+        const float* planes,
+        size_t numPlanes,
+        const float* bounds,
+        uint32* visibility,
+        size_t numBoxes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        assert(_isAlignedForSSE(bounds));
+
+        memset(visibility, 0, ((numBoxes + 31) / 32) * sizeof(uint32));
+
+        // Clearing the sign bit gives the absolute value
+        __m128 signMask = _mm_set_ps1(-0.0f);
+        __m128 zero = _mm_setzero_ps();
+
+        size_t numGroups = (numBoxes + 3) / 4;
+
+        // Four boxes per-iteration
+        for (size_t group = 0; group < numGroups; ++group, bounds += 24)
+        {
+            // Load centres and half sizes, aligned
+            __m128 cx = __MM_LOAD_PS(bounds + 0);
+            __m128 cy = __MM_LOAD_PS(bounds + 4);
+            __m128 cz = __MM_LOAD_PS(bounds + 8);
+            __m128 hx = __MM_LOAD_PS(bounds + 12);
+            __m128 hy = __MM_LOAD_PS(bounds + 16);
+            __m128 hz = __MM_LOAD_PS(bounds + 20);
+
+            __m128 outside = zero;
+            const float* plane = planes;
+            for (size_t p = 0; p < numPlanes; ++p, plane += 4)
+            {
+                __m128 nx = _mm_load_ps1(plane + 0);
+                __m128 ny = _mm_load_ps1(plane + 1);
+                __m128 nz = _mm_load_ps1(plane + 2);
+
+                // Signed distance of the centres
+                __m128 dist = __MM_DOT3x3_PS(nx, ny, nz, cx, cy, cz);
+                dist = _mm_add_ps(dist, _mm_load_ps1(plane + 3));
+
+                // Largest distance of the corners from the centres along the normal
+                __m128 maxAbsDist = __MM_DOT3x3_PS(
+                    _mm_andnot_ps(signMask, nx),
+                    _mm_andnot_ps(signMask, ny),
+                    _mm_andnot_ps(signMask, nz),
+                    hx, hy, hz);
+
+                // Completely on the negative side if dist < -maxAbsDist
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, maxAbsDist), zero));
+                if (_mm_movemask_ps(outside) == 0xF)
+                    break;
+            }
+
+            uint32 bitmask = ~_mm_movemask_ps(outside) & 0xF;
+            visibility[group / 8] |= bitmask << ((group % 8) * 4);
+        }
+
+        // Clear the bits of the padding boxes
+        if (numBoxes % 32)
+        {
+            visibility[numBoxes / 32] &= (1u << (numBoxes % 32)) - 1;
+        }
+    }
+    //---------------------------------------------------------------------
+    // Normalised linear interpolation of four quaternions stored in SoA form,
+    // the results are returned in w1, x1, y1 and z1.
+    static OGRE_FORCE_INLINE void __MM_NLERP4_PS(
+        const __m128& t, bool shortestPath,
+        __m128& w1, __m128& x1, __m128& y1, __m128& z1,
+        __m128 w2, __m128 x2, __m128 y2, __m128 z2)
+    {
+        if (shortestPath)
+        {
+            // Negate the target of the rotations whose dot product is negative
+            __m128 dot = __MM_DOT4x4_PS(w1, x1, y1, z1, w2, x2, y2, z2);
+            __m128 sign = _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), _mm_set_ps1(-0.0f));
+            w2 = _mm_xor_ps(w2, sign);
+            x2 = _mm_xor_ps(x2, sign);
+            y2 = _mm_xor_ps(y2, sign);
+            z2 = _mm_xor_ps(z2, sign);
+        }
+
+        w1 = __MM_LERP_PS(t, w1, w2);
+        x1 = __MM_LERP_PS(t, x1, x2);
+        y1 = __MM_LERP_PS(t, y1, y2);
+        z1 = __MM_LERP_PS(t, z1, z2);
+
+        // Exact normalise here, errors would accumulate along the bone hierarchy
+        __m128 factor = _mm_div_ps(_mm_set_ps1(1.0f),
+            _mm_sqrt_ps(__MM_DOT4x4_PS(w1, x1, y1, z1, w1, x1, y1, z1)));
+        w1 = _mm_mul_ps(w1, factor);
+        x1 = _mm_mul_ps(x1, factor);
+        y1 = _mm_mul_ps(y1, factor);
+        z1 = _mm_mul_ps(z1, factor);
+    }
+    //---------------------------------------------------------------------
+    // Blend four transforms, the results are stored continuously.
+    static OGRE_FORCE_INLINE void _blendTransformKeyFrames4(
+        const float* const* keyFrames1,
+        const float* const* keyFrames2,
+        const float* interpolations,
+        const float* weights,
+        Real scale,
+        bool shortestPath,
+        float* transforms)
+    {
+        __m128 t = _mm_loadu_ps(interpolations);
+        __m128 weight = _mm_loadu_ps(weights);
+
+        // Rotations, transposed to w, x, y, z of the four transforms
+        __m128 w1 = _mm_loadu_ps(keyFrames1[0]);
+        __m128 x1 = _mm_loadu_ps(keyFrames1[1]);
+        __m128 y1 = _mm_loadu_ps(keyFrames1[2]);
+        __m128 z1 = _mm_loadu_ps(keyFrames1[3]);
+        __MM_TRANSPOSE4x4_PS(w1, x1, y1, z1);
+        __m128 w2 = _mm_loadu_ps(keyFrames2[0]);
+        __m128 x2 = _mm_loadu_ps(keyFrames2[1]);
+        __m128 y2 = _mm_loadu_ps(keyFrames2[2]);
+        __m128 z2 = _mm_loadu_ps(keyFrames2[3]);
+        __MM_TRANSPOSE4x4_PS(w2, x2, y2, z2);
+
+        __MM_NLERP4_PS(t, shortestPath, w1, x1, y1, z1, w2, x2, y2, z2);
+
+        // Weight from the identity rotation
+        __m128 zero = _mm_setzero_ps();
+        __m128 w0 = _mm_set_ps1(1.0f), x0 = zero, y0 = zero, z0 = zero;
+        __MM_NLERP4_PS(weight, shortestPath, w0, x0, y0, z0, w1, x1, y1, z1);
+        __MM_TRANSPOSE4x4_PS(w0, x0, y0, z0);
+        _mm_storeu_ps(transforms + 0, w0);
+        _mm_storeu_ps(transforms + 12, x0);
+        _mm_storeu_ps(transforms + 24, y0);
+        _mm_storeu_ps(transforms + 36, z0);
+
+        // Translations and scales, one transform at a time
+        const __m128 one = _mm_set_ps1(1.0f);
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const float* k1 = keyFrames1[i];
+            const float* k2 = keyFrames2[i];
+            __m128 ti = _mm_set_ps1(interpolations[i]);
+
+            __m128 translate = __MM_LERP_PS(ti, _mm_loadu_ps(k1 + 4), _mm_loadu_ps(k2 + 4));
+            _mm_storeu_ps(transforms + 4, _mm_mul_ps(translate, _mm_set_ps1(weights[i] * scale)));
+
+            __m128 scl = __MM_LERP_PS(ti, _mm_loadu_ps(k1 + 8), _mm_loadu_ps(k2 + 8));
+            __m128 factor = _mm_set_ps1(scale != 1.0f ? scale : weights[i]);
+            _mm_storeu_ps(transforms + 8, __MM_MADD_PS(_mm_sub_ps(scl, one), factor, one));
+
+            transforms += 12;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::blendTransformKeyFrames(
+        const float* const* keyFrames1,
+        const float* const* keyFrames2,
+        const float* interpolations,
+        const float* weights,
+        Real scale,
+        bool shortestPath,
+        float* transforms,
+        size_t numTransforms)
+    {
+        // Four transforms per-iteration
+        size_t i = 0;
+        for (; i + 4 <= numTransforms; i += 4)
+        {
+            _blendTransformKeyFrames4(keyFrames1 + i, keyFrames2 + i,
+                interpolations + i, weights + i, scale, shortestPath, transforms + i * 12);
+        }
+
+        if (i < numTransforms)
+        {
+            // Pad the remaining transforms by repeating the last one
+            const float* k1[4];
+            const float* k2[4];
+            float t[4], w[4];
+            float results[4 * 12];
+            for (size_t j = 0; j < 4; ++j)
+            {
+                size_t src = std::min(i + j, numTransforms - 1);
+                k1[j] = keyFrames1[src];
+                k2[j] = keyFrames2[src];
+                t[j] = interpolations[src];
+                w[j] = weights[src];
+            }
+
+            _blendTransformKeyFrames4(k1, k2, t, w, scale, shortestPath, results);
+            memcpy(transforms + i * 12, results, (numTransforms - i) * 12 * sizeof(float));
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::accumulateVertexOffsets(
+        Real weight,
+        const float* offsets,
+        const uint32* indexes,
+        float* dest,
+        size_t destStride,
+        size_t numOffsets)
+    {
+        __m128 w = _mm_set_ps1(weight);
+        OGRE_SIMD_ALIGNED_DECL(float, weighted[12]);
+
+        size_t i = 0;
+        // Weight four offsets per-iteration, they are packed in three vectors
+        for (; i + 4 <= numOffsets; i += 4, offsets += 12)
+        {
+            _mm_store_ps(weighted + 0, _mm_mul_ps(_mm_loadu_ps(offsets + 0), w));
+            _mm_store_ps(weighted + 4, _mm_mul_ps(_mm_loadu_ps(offsets + 4), w));
+            _mm_store_ps(weighted + 8, _mm_mul_ps(_mm_loadu_ps(offsets + 8), w));
+            for (size_t j = 0; j < 4; ++j)
+            {
+                float* pDest = rawOffsetPointer(dest, indexes[i + j] * destStride);
+                pDest[0] += weighted[j * 3 + 0];
+                pDest[1] += weighted[j * 3 + 1];
+                pDest[2] += weighted[j * 3 + 2];
+            }
+        }
+
+        // Left over offsets
+        for (; i < numOffsets; ++i, offsets += 3)
+        {
+            float* pDest = rawOffsetPointer(dest, indexes[i] * destStride);
+            pDest[0] += offsets[0] * weight;
+            pDest[1] += offsets[1] * weight;
+            pDest[2] += offsets[2] * weight;
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilSSE(void)
@@ -29,9 +29,29 @@ THE SOFTWARE.
 
 #include "OgreParticleEmitter.h"
 #include "OgreParticleEmitterFactory.h"
+#include "OgreParticleSystem.h"
 
 namespace Ogre
 {
+    namespace
+    {
+        /// Vector3::randomDeviant drawing from the random sequence of the system
+        Vector3 randomDeviant(ParticleSystem* system, const Vector3& dir, const Radian& angle,
+            const Vector3& up = Vector3::ZERO)
+        {
+            Vector3 newUp = up == Vector3::ZERO ? dir.perpendicular() : up;
+
+            // Rotate up vector by random amount around dir
+            Quaternion q;
+            q.FromAngleAxis(Radian(system->_unitRandom() * Math::TWO_PI), dir);
+            newUp = q * newUp;
+
+            // Finally rotate dir by given angle around randomised up
+            q.FromAngleAxis(angle, newUp);
+            return q * dir;
+        }
+    }
+
     // Define static members
     EmitterCommands::CmdAngle ParticleEmitter::msAngleCmd;
     EmitterCommands::CmdColour ParticleEmitter::msColourCmd;
@@ -239,10 +259,10 @@ namespace Ogre
             if (mAngle != Radian(0))
             {
                 // Randomise angle
-                Radian angle = Math::UnitRandom() * mAngle;
+                Radian angle = mParent->_unitRandom() * mAngle;
 
                 // Randomise direction
-                destVector = particleDir.randomDeviant( angle );
+                destVector = randomDeviant(mParent, particleDir, angle);
             }
             else
             {
@@ -255,10 +275,10 @@ namespace Ogre
             if (mAngle != Radian(0))
             {
                 // Randomise angle
-                Radian angle = Math::UnitRandom() * mAngle;
+                Radian angle = mParent->_unitRandom() * mAngle;
 
                 // Randomise direction
-                destVector = mDirection.randomDeviant(angle, mUp);
+                destVector = randomDeviant(mParent, mDirection, angle, mUp);
             }
             else
             {
@@ -276,7 +296,7 @@ namespace Ogre
         Real scalar;
         if (mMinSpeed != mMaxSpeed)
         {
-            scalar = mMinSpeed + (Math::UnitRandom() * (mMaxSpeed - mMinSpeed));
+            scalar = mMinSpeed + (mParent->_unitRandom() * (mMaxSpeed - mMinSpeed));
         }
         else
         {
@@ -290,7 +310,7 @@ namespace Ogre
     {
         if (mMaxTTL != mMinTTL)
         {
-            return mMinTTL + (Math::UnitRandom() * (mMaxTTL - mMinTTL));
+            return mMinTTL + (mParent->_unitRandom() * (mMaxTTL - mMinTTL));
         }
         else
         {
@@ -351,10 +371,10 @@ namespace Ogre
         {
             // Randomise
             //Real t = Math::UnitRandom();
-            destColour.r = mColourRangeStart.r + (Math::UnitRandom() * (mColourRangeEnd.r - mColourRangeStart.r));
-            destColour.g = mColourRangeStart.g + (Math::UnitRandom() * (mColourRangeEnd.g - mColourRangeStart.g));
-            destColour.b = mColourRangeStart.b + (Math::UnitRandom() * (mColourRangeEnd.b - mColourRangeStart.b));
-            destColour.a = mColourRangeStart.a + (Math::UnitRandom() * (mColourRangeEnd.a - mColourRangeStart.a));
+            destColour.r = mColourRangeStart.r + (mParent->_unitRandom() * (mColourRangeEnd.r - mColourRangeStart.r));
+            destColour.g = mColourRangeStart.g + (mParent->_unitRandom() * (mColourRangeEnd.g - mColourRangeStart.g));
+            destColour.b = mColourRangeStart.b + (mParent->_unitRandom() * (mColourRangeEnd.b - mColourRangeStart.b));
+            destColour.a = mColourRangeStart.a + (mParent->_unitRandom() * (mColourRangeEnd.a - mColourRangeStart.a));
         }
         else
         {
@@ -598,7 +618,7 @@ namespace Ogre
             }
             else
             {
-                mDurationRemain = Math::RangeRandom(mDurationMin, mDurationMax);
+                mDurationRemain = mParent->_rangeRandom(mDurationMin, mDurationMax);
             }
         }
         else
@@ -610,7 +630,7 @@ namespace Ogre
             }
             else
             {
-                mRepeatDelayRemain = Math::RangeRandom(mRepeatDelayMax, mRepeatDelayMin);
+                mRepeatDelayRemain = mParent->_rangeRandom(mRepeatDelayMax, mRepeatDelayMin);
             }
 
         }
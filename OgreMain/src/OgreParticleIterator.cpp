@@ -32,8 +32,8 @@ THE SOFTWARE.
 namespace Ogre {
 
     //-----------------------------------------------------------------------
-    ParticleIterator::ParticleIterator(list<Particle*>::type::iterator start, 
-        list<Particle*>::type::iterator last)
+    ParticleIterator::ParticleIterator(vector<Particle*>::type::iterator start, 
+        vector<Particle*>::type::iterator last)
     {
         mStart = mPos = start;
         mEnd = last;
@@ -39,7 +39,6 @@ THE SOFTWARE.
 #include "OgreParticleSystemRenderer.h"
 #include "OgreMaterialManager.h"
 #include "OgreSceneManager.h"
-#include "OgreControllerManager.h"
 #include "OgreRoot.h"
 
 namespace Ogre {
@@ -61,20 +60,6 @@ namespace Ogre {
     Real ParticleSystem::msDefaultIterationInterval = 0;
     Real ParticleSystem::msDefaultNonvisibleTimeout = 0;
 
-    //-----------------------------------------------------------------------
-    // Local class for updating based on time
-    class ParticleSystemUpdateValue : public ControllerValue<Real>
-    {
-    protected:
-        ParticleSystem* mTarget;
-    public:
-        ParticleSystemUpdateValue(ParticleSystem* target) : mTarget(target) {}
-
-        Real getValue(void) const { return 0; } // N/A
-
-        void setValue(Real value) { mTarget->_update(value); }
-
-    };
     //-----------------------------------------------------------------------
     ParticleSystem::ParticleSystem() 
       : mAABB(),
@@ -93,7 +78,9 @@ namespace Ogre {
         mNonvisibleTimeoutSet(false),
         mTimeSinceLastVisible(0),
         mLastVisibleFrame(0),
-        mTimeController(0),
+        mUpdateRegistered(false),
+        mRandomSeed(0),
+        mRandomState(0),
         mEmittedEmitterPoolInitialised(false),
         mIsEmitting(true),
         mRenderer(0),
@@ -102,6 +89,7 @@ namespace Ogre {
         mEmittedEmitterPoolSize(0)
     {
         initParameters();
+        setRandomSeed(0);
 
         // Default to billboard renderer
         setRenderer("billboard");
@@ -126,7 +114,9 @@ namespace Ogre {
         mNonvisibleTimeoutSet(false),
         mTimeSinceLastVisible(0),
         mLastVisibleFrame(Root::getSingleton().getNextFrameNumber()),
-        mTimeController(0),
+        mUpdateRegistered(false),
+        mRandomSeed(0),
+        mRandomState(0),
         mEmittedEmitterPoolInitialised(false),
         mIsEmitting(true),
         mRenderer(0), 
@@ -140,6 +130,7 @@ namespace Ogre {
         setParticleQuota( 10 );
         setEmittedEmitterQuota( 3 );
         initParameters();
+        setRandomSeed(FastHash(name.c_str(), name.size()));
 
         // Default to billboard renderer
         setRenderer("billboard");
@@ -147,11 +138,10 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     ParticleSystem::~ParticleSystem()
     {
-        if (mTimeController)
+        if (mUpdateRegistered)
         {
-            // Destroy controller
-            ControllerManager::getSingleton().destroyController(mTimeController);
-            mTimeController = 0;
+            ParticleSystemManager::getSingleton()._removeUpdatedSystem(this);
+            mUpdateRegistered = false;
         }
 
         // Arrange for the deletion of emitters & affectors
@@ -162,10 +152,10 @@ namespace Ogre {
         // Deallocate all particles
         destroyVisualParticles(0, mParticlePool.size());
         // Free pool items
-        ParticlePool::iterator i;
-        for (i = mParticlePool.begin(); i != mParticlePool.end(); ++i)
+        ParticleBlockList::iterator i;
+        for (i = mParticleBlocks.begin(); i != mParticleBlocks.end(); ++i)
         {
-            OGRE_DELETE *i;
+            OGRE_DELETE [] *i;
         }
 
         if (mRenderer)
@@ -366,10 +356,19 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_update(Real timeElapsed)
+    {
+        if (_prepareUpdate(timeElapsed))
+        {
+            _simulate(timeElapsed);
+            _updateBounds();
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::_prepareUpdate(Real& timeElapsed)
     {
         // Only update if attached to a node
         if (!mParentNode)
-            return;
+            return false;
 
         Real nonvisibleTimeout = mNonvisibleTimeoutSet ?
             mNonvisibleTimeout : msDefaultNonvisibleTimeout;
@@ -385,7 +384,7 @@ namespace Ogre {
                 if (mTimeSinceLastVisible >= nonvisibleTimeout)
                 {
                     // No update
-                    return;
+                    return false;
                 }
             }
         }
@@ -399,6 +398,24 @@ namespace Ogre {
         // Initialise emitted emitters list if not done already
         initialiseEmittedEmitters();
 
+        // The derived transform is computed on demand, make sure that
+        // _simulate only reads it
+        mParentNode->_getDerivedPosition();
+        mParentNode->_getFullTransform();
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_simulate(Real timeElapsed)
+    {
+        // Renderers keeping the particles on the GPU simulate them on their own
+        if (mRenderer && mRenderer->_simulateParticles(this, timeElapsed))
+        {
+            if (!mBoundsAutoUpdate && mBoundsUpdateTime > 0.0f)
+                mBoundsUpdateTime -= timeElapsed; // count down 
+            return;
+        }
+
         Real iterationInterval = mIterationIntervalSet ? 
             mIterationInterval : msDefaultIterationInterval;
         if (iterationInterval > 0)
@@ -437,21 +454,30 @@ namespace Ogre {
 
         if (!mBoundsAutoUpdate && mBoundsUpdateTime > 0.0f)
             mBoundsUpdateTime -= timeElapsed; // count down 
-        _updateBounds();
-
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::setRandomSeed(uint32 seed)
+    {
+        mRandomSeed = seed;
+        // Scramble the seed so that close seeds give unrelated sequences,
+        // xorshift must not start from 0
+        uint32 h = seed;
+        h ^= h >> 16;
+        h *= 0x85ebca6b;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35;
+        h ^= h >> 16;
+        mRandomState = h ? h : 0x9e3779b9;
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_expire(Real timeElapsed)
     {
-        ActiveParticleList::iterator i, itEnd;
         Particle* pParticle;
         ParticleEmitter* pParticleEmitter;
 
-        itEnd = mActiveParticles.end();
-
-        for (i = mActiveParticles.begin(); i != itEnd; )
+        for (size_t i = 0; i < mActiveParticles.size(); )
         {
-            pParticle = static_cast<Particle*>(*i);
+            pParticle = mActiveParticles[i];
             if (pParticle->mTimeToLive < timeElapsed)
             {
                 // Notify renderer
@@ -461,21 +487,22 @@ namespace Ogre {
                 if (pParticle->mParticleType == Particle::Visual)
                 {
                     // Destroy this one
-                    mFreeParticles.splice(mFreeParticles.end(), mActiveParticles, i++);
+                    mFreeParticles.push_back(pParticle);
                 }
                 else
                 {
                     // For now, it can only be an emitted emitter
-                    pParticleEmitter = static_cast<ParticleEmitter*>(*i);
+                    pParticleEmitter = static_cast<ParticleEmitter*>(pParticle);
                     list<ParticleEmitter*>::type* fee = findFreeEmittedEmitter(pParticleEmitter->getName());
                     fee->push_back(pParticleEmitter);
 
                     // Also erase from mActiveEmittedEmitters
                     removeFromActiveEmittedEmitters (pParticleEmitter);
-
-                    // And erase from mActiveParticles
-                    i = mActiveParticles.erase( i );
                 }
+
+                // Swap-remove from mActiveParticles, the moved particle is checked next
+                mActiveParticles[i] = mActiveParticles.back();
+                mActiveParticles.pop_back();
             }
             else
             {
@@ -623,14 +650,13 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ParticleSystem::_applyMotion(Real timeElapsed)
     {
-        ActiveParticleList::iterator i, itEnd;
         Particle* pParticle;
         ParticleEmitter* pParticleEmitter;
 
-        itEnd = mActiveParticles.end();
-        for (i = mActiveParticles.begin(); i != itEnd; ++i)
+        size_t count = mActiveParticles.size();
+        for (size_t i = 0; i < count; ++i)
         {
-            pParticle = static_cast<Particle*>(*i);
+            pParticle = mActiveParticles[i];
             pParticle->mPosition += (pParticle->mDirection * timeElapsed);
 
             if (pParticle->mParticleType == Particle::Emitter)
@@ -638,7 +664,7 @@ namespace Ogre {
                 // If it is an emitter, the emitter position must also be updated
                 // Note, that position of the emitter becomes a position in worldspace if mLocalSpace is set 
                 // to false (will this become a problem?)
-                pParticleEmitter = static_cast<ParticleEmitter*>(*i);
+                pParticleEmitter = static_cast<ParticleEmitter*>(pParticle);
                 pParticleEmitter->setPosition(pParticle->mPosition);
             }
         }
@@ -667,10 +693,15 @@ namespace Ogre {
         mParticlePool.reserve(size);
         mParticlePool.resize(size);
 
-        // Create new particles
-        for( size_t i = oldSize; i < size; i++ )
+        // Create new particles, contiguously so that updating them is cache friendly
+        if (size > oldSize)
         {
-            mParticlePool[i] = OGRE_NEW Particle();
+            Particle* block = OGRE_NEW Particle[size - oldSize];
+            mParticleBlocks.push_back(block);
+            for( size_t i = oldSize; i < size; i++ )
+            {
+                mParticlePool[i] = block + (i - oldSize);
+            }
         }
 
         if (mIsRendererConfigured)
@@ -689,9 +720,7 @@ namespace Ogre {
     Particle* ParticleSystem::getParticle(size_t index) 
     {
         assert (index < mActiveParticles.size() && "Index out of bounds!");
-        ActiveParticleList::iterator i = mActiveParticles.begin();
-        std::advance(i, index);
-        return *i;
+        return mActiveParticles[index];
     }
     //-----------------------------------------------------------------------
     Particle* ParticleSystem::createParticle(void)
@@ -700,8 +729,9 @@ namespace Ogre {
         if (!mFreeParticles.empty())
         {
             // Fast creation (don't use superclass since emitter will init)
-            p = mFreeParticles.front();
-            mActiveParticles.splice(mActiveParticles.end(), mFreeParticles, mFreeParticles.begin());
+            p = mFreeParticles.back();
+            mFreeParticles.pop_back();
+            mActiveParticles.push_back(p);
 
             p->_notifyOwner(this);
         }
@@ -1004,22 +1034,20 @@ namespace Ogre {
             mRenderer->_notifyAttached(parent, isTagPoint);
         }
 
-        if (parent && !mTimeController)
+        if (parent && !mUpdateRegistered)
         {
             // Assume visible
             mTimeSinceLastVisible = 0;
             mLastVisibleFrame = Root::getSingleton().getNextFrameNumber();
 
-            // Create time controller when attached
-            ControllerManager& mgr = ControllerManager::getSingleton(); 
-            ControllerValueRealPtr updValue(OGRE_NEW ParticleSystemUpdateValue(this));
-            mTimeController = mgr.createFrameTimePassthroughController(updValue);
+            // Updated every frame by the manager while attached
+            ParticleSystemManager::getSingleton()._addUpdatedSystem(this);
+            mUpdateRegistered = true;
         }
-        else if (!parent && mTimeController)
+        else if (!parent && mUpdateRegistered)
         {
-            // Destroy controller
-            ControllerManager::getSingleton().destroyController(mTimeController);
-            mTimeController = 0;
+            ParticleSystemManager::getSingleton()._removeUpdatedSystem(this);
+            mUpdateRegistered = false;
         }
     }
     //-----------------------------------------------------------------------
@@ -1046,8 +1074,13 @@ namespace Ogre {
             mRenderer->_notifyParticleCleared(mActiveParticles);
         }
 
-        // Move actives to free list
-        mFreeParticles.splice(mFreeParticles.end(), mActiveParticles);
+        // Move visual actives to free list, emitted emitters are freed below
+        for (ActiveParticleList::iterator i = mActiveParticles.begin(); i != mActiveParticles.end(); ++i)
+        {
+            if ((*i)->mParticleType == Particle::Visual)
+                mFreeParticles.push_back(*i);
+        }
+        mActiveParticles.clear();
 
         // Add active emitted emitters to free list
         addActiveEmittedEmittersToFreeList();
@@ -1085,10 +1118,10 @@ namespace Ogre {
         {
             this->increasePool(size);
 
-            for( size_t i = currSize; i < size; ++i )
+            for( size_t i = size; i > currSize; --i )
             {
-                // Add new items to the queue
-                mFreeParticles.push_back( mParticlePool[i] );
+                // Add new items to the stack, so that they are handed out in memory order
+                mFreeParticles.push_back( mParticlePool[i - 1] );
             }
 
             // Tell the renderer, if already configured
@@ -1611,6 +1644,11 @@ namespace Ogre {
     {
     }
     //-----------------------------------------------------------------------
+    void ParticleAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    {
+        _affectParticleSpan(pSystem, timeElapsed, pSystem->_getActiveParticles(), pSystem->getNumParticles());
+    }
+    //-----------------------------------------------------------------------
     ParticleAffectorFactory::~ParticleAffectorFactory() 
     {
         // Destroy all affectors
@@ -37,12 +37,40 @@ THE SOFTWARE.
 #include "OgreBillboardParticleRenderer.h"
 #include "OgreScriptCompiler.h"
 #include "OgreParticleSystem.h"
+#include "OgreControllerManager.h"
+#include "Threading/OgreParallel.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
     // Shortcut to set up billboard particle renderer
     BillboardParticleRendererFactory* mBillboardRendererFactory = 0;
     //-----------------------------------------------------------------------
+    /** Updates the attached particle systems every frame
+    */
+    class ParticleSystemManagerUpdateValue : public ControllerValue<Real>
+    {
+    protected:
+        ParticleSystemManager* mTarget;
+    public:
+        ParticleSystemManagerUpdateValue(ParticleSystemManager* target) : mTarget(target) {}
+
+        Real getValue(void) const { return 0; } // N/A
+
+        void setValue(Real value) { mTarget->_updateSystems(value); }
+
+    };
+    //-----------------------------------------------------------------------
+    /// Simulates the systems prepared by ParticleSystemManager::_updateSystems
+    struct ParticleSystemSimulator
+    {
+        ParticleSystem* const* systems;
+        const Real* times;
+
+        ParticleSystemSimulator(ParticleSystem* const* s, const Real* t) : systems(s), times(t) {}
+
+        void operator()(size_t i) const { systems[i]->_simulate(times[i]); }
+    };
+    //-----------------------------------------------------------------------
     template<> ParticleSystemManager* Singleton<ParticleSystemManager>::msSingleton = 0;
     ParticleSystemManager* ParticleSystemManager::getSingletonPtr(void)
     {
@@ -54,6 +82,7 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     ParticleSystemManager::ParticleSystemManager()
+        : mUpdateController(0), mParallelUpdate(false)
     {
         OGRE_LOCK_AUTO_MUTEX;
         mFactory = OGRE_NEW ParticleSystemFactory();
@@ -64,6 +93,12 @@ namespace Ogre {
     {
         OGRE_LOCK_AUTO_MUTEX;
 
+        if (mUpdateController && ControllerManager::getSingletonPtr())
+        {
+            ControllerManager::getSingleton().destroyController(mUpdateController);
+            mUpdateController = 0;
+        }
+
         // Destroy all templates
         ParticleTemplateMap::iterator t;
         for (t = mSystemTemplates.begin(); t != mSystemTemplates.end(); ++t)
@@ -89,6 +124,63 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ParticleSystemManager::_updateSystems(Real timeElapsed)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+
+        if (!mParallelUpdate)
+        {
+            for (size_t i = 0; i < mUpdatedSystems.size(); ++i)
+                mUpdatedSystems[i]->_update(timeElapsed);
+            return;
+        }
+
+        // Renderer setup and node transforms are not thread safe, prepare here
+        mSimulatedSystems.clear();
+        mSimulatedTimes.clear();
+        for (size_t i = 0; i < mUpdatedSystems.size(); ++i)
+        {
+            Real systemTime = timeElapsed;
+            if (mUpdatedSystems[i]->_prepareUpdate(systemTime))
+            {
+                mSimulatedSystems.push_back(mUpdatedSystems[i]);
+                mSimulatedTimes.push_back(systemTime);
+            }
+        }
+
+        if (mSimulatedSystems.empty())
+            return;
+
+        // Systems are small, claim a few at a time
+        parallelFor(0, mSimulatedSystems.size(), 
+            ParticleSystemSimulator(&mSimulatedSystems[0], &mSimulatedTimes[0]), 8);
+
+        // Bounds notify the scene graph
+        for (size_t i = 0; i < mSimulatedSystems.size(); ++i)
+            mSimulatedSystems[i]->_updateBounds();
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_addUpdatedSystem(ParticleSystem* sys)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+
+        if (!mUpdateController)
+        {
+            ControllerValueRealPtr updValue(OGRE_NEW ParticleSystemManagerUpdateValue(this));
+            mUpdateController = ControllerManager::getSingleton().createFrameTimePassthroughController(updValue);
+        }
+        mUpdatedSystems.push_back(sys);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_removeUpdatedSystem(ParticleSystem* sys)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+
+        ParticleSystemList::iterator i = std::find(mUpdatedSystems.begin(), mUpdatedSystems.end(), sys);
+        if (i != mUpdatedSystems.end())
+            mUpdatedSystems.erase(i);
+    }
+    //-----------------------------------------------------------------------
     const StringVector& ParticleSystemManager::getScriptPatterns(void) const
     {
         return mScriptPatterns;
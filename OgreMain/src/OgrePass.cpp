@@ -97,6 +97,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     Pass::PassSet Pass::msDirtyHashList;
     Pass::PassSet Pass::msPassGraveyard;
+    uint32 Pass::msPassSetGeneration = 0;
     OGRE_STATIC_MUTEX_INSTANCE(Pass::msDirtyHashListMutex);
     OGRE_STATIC_MUTEX_INSTANCE(Pass::msPassGraveyardMutex);
 
@@ -203,6 +204,8 @@ namespace Ogre {
         , mContentTypeLookupBuilt(false)
         , mLightScissoring(false)
         , mLightClipPlanes(false)
+        , mDrawBatching(false)
+        , mDynamicBatching(true)
         , mIlluminationStage(IS_UNKNOWN)
     {
         mPointAttenuationCoeffs[0] = 1.0f;
@@ -213,6 +216,11 @@ namespace Ogre {
 
         // init the hash inline
         _recalculateHash();
+
+        {
+                OGRE_LOCK_MUTEX(msDirtyHashListMutex);
+            ++msPassSetGeneration;
+        }
    }
 
     //-----------------------------------------------------------------------------
@@ -229,6 +237,11 @@ namespace Ogre {
 
         // init the hash inline
         _recalculateHash();
+
+        {
+                OGRE_LOCK_MUTEX(msDirtyHashListMutex);
+            ++msPassSetGeneration;
+        }
     }
     //-----------------------------------------------------------------------------
     Pass::~Pass()
@@ -311,6 +324,8 @@ namespace Ogre {
         mContentTypeLookupBuilt = oth.mContentTypeLookupBuilt;
         mLightScissoring = oth.mLightScissoring;
         mLightClipPlanes = oth.mLightClipPlanes;
+        mDrawBatching = oth.mDrawBatching;
+        mDynamicBatching = oth.mDynamicBatching;
         mIlluminationStage = oth.mIlluminationStage;
         mLightMask = oth.mLightMask;
 
@@ -1885,6 +1900,7 @@ namespace Ogre {
                     OGRE_LOCK_MUTEX(msDirtyHashListMutex);
             // Mark this hash as for follow up
             msDirtyHashList.insert(this);
+            ++msPassSetGeneration;
             mHashDirtyQueued = false;
         }
         else
@@ -1994,6 +2010,12 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    uint32 Pass::getPassSetGeneration(void)
+    {
+            OGRE_LOCK_MUTEX(msDirtyHashListMutex);
+        return msPassSetGeneration;
+    }
+    //-----------------------------------------------------------------------
     void Pass::queueForDeletion(void)
     {
         mQueuedForDeletion = true;
@@ -2053,6 +2075,7 @@ namespace Ogre {
         {
                     OGRE_LOCK_MUTEX(msDirtyHashListMutex);
             msDirtyHashList.erase(this);
+            ++msPassSetGeneration;
         }
         {
                     OGRE_LOCK_MUTEX(msPassGraveyardMutex);
@@ -35,7 +35,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     PatchMesh::PatchMesh(ResourceManager* creator, const String& name, ResourceHandle handle,
         const String& group)
-        : Mesh(creator, name, handle, group, false, 0), mDeclaration(0)
+        : Mesh(creator, name, handle, group, false, 0), mDeclaration(0), mHardwareTessellation(false)
     {
     }
     //-----------------------------------------------------------------------
@@ -44,8 +44,9 @@ namespace Ogre {
             size_t uMaxSubdivisionLevel, size_t vMaxSubdivisionLevel,
             PatchSurface::VisibleSide visibleSide, HardwareBuffer::Usage vbUsage, 
             HardwareBuffer::Usage ibUsage,
-            bool vbUseShadow, bool ibUseShadow) 
+            bool vbUseShadow, bool ibUseShadow, bool hardwareTessellation) 
     {
+        mHardwareTessellation = hardwareTessellation;
         mVertexBufferUsage = vbUsage;
         mVertexBufferShadowBuffer = vbUseShadow;
         mIndexBufferUsage = ibUsage;
@@ -71,24 +72,74 @@ namespace Ogre {
         const Ogre::VertexElement* posElem = vertex_data->vertexDeclaration->findElementBySemantic(Ogre::VES_POSITION);
         Ogre::HardwareVertexBufferSharedPtr vbuf = vertex_data->vertexBufferBinding->getBuffer(posElem->getSource());
 
+        if (mHardwareTessellation)
+        {
+            // Only the control points change, the patches stay the same
+            writeControlPoints();
+            return;
+        }
+
         // Build patch with new control points
         mSurface.build(vbuf, 0, sm->indexData->indexBuffer, 0);
     }
     //-----------------------------------------------------------------------
     void PatchMesh::setSubdivision(Real factor)
     {
+        if (mHardwareTessellation)
+            return;
+
         mSurface.setSubdivisionFactor(factor);
         SubMesh* sm = this->getSubMesh(0);
         sm->indexData->indexCount = mSurface.getCurrentIndexCount();
         
     }
     //-----------------------------------------------------------------------
+    void PatchMesh::writeControlPoints(void)
+    {
+        SubMesh* sm = this->getSubMesh(0);
+        HardwareVertexBufferSharedPtr vbuf = sm->vertexData->vertexBufferBinding->getBuffer(0);
+        vbuf->writeData(0, mSurface.getControlPointCount() * mDeclaration->getVertexSize(0),
+            mSurface.getControlPointBuffer(), true);
+    }
+    //-----------------------------------------------------------------------
     void PatchMesh::loadImpl(void)
     {
         SubMesh* sm = this->createSubMesh();
         sm->vertexData = OGRE_NEW VertexData();
         sm->useSharedVertices = false;
 
+        if (mHardwareTessellation)
+        {
+            // The control points as they are, drawn as patches to be subdivided on the GPU
+            sm->operationType = RenderOperation::OT_PATCH_9_CONTROL_POINT;
+            sm->vertexData->vertexStart = 0;
+            sm->vertexData->vertexCount = mSurface.getControlPointCount();
+            sm->vertexData->vertexDeclaration = mDeclaration;
+            HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().
+                createVertexBuffer(
+                    mDeclaration->getVertexSize(0), 
+                    sm->vertexData->vertexCount, 
+                    mVertexBufferUsage, 
+                    mVertexBufferShadowBuffer);
+            sm->vertexData->vertexBufferBinding->setBinding(0, vbuf);
+            writeControlPoints();
+
+            sm->indexData->indexStart = 0;
+            sm->indexData->indexCount = mSurface.getRequiredPatchIndexCount();
+            sm->indexData->indexBuffer = HardwareBufferManager::getSingleton().
+                createIndexBuffer(
+                    HardwareIndexBuffer::IT_16BIT,
+                    sm->indexData->indexCount,
+                    mIndexBufferUsage, 
+                    mIndexBufferShadowBuffer);
+            mSurface.buildPatchIndexes(sm->indexData->indexBuffer, 0);
+
+            // The surface stays within the convex hull of its control points
+            this->_setBounds(mSurface.getBounds(), true);
+            this->_setBoundingSphereRadius(mSurface.getBoundingSphereRadius());
+            return;
+        }
+
         // Set up vertex buffer
         sm->vertexData->vertexStart = 0;
         sm->vertexData->vertexCount = mSurface.getRequiredVertexCount();
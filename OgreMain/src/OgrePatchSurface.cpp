@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include "OgrePatchSurface.h"
 #include "OgreException.h"
+#include "Threading/OgreParallel.h"
 
 #define LEVEL_WIDTH(lvl) ((1 << (lvl+1)) + 1)
 
@@ -36,8 +37,54 @@ namespace Ogre {
 
     // TODO: make this deal with specular colours and more than 2 texture coords
 
+    //-----------------------------------------------------------------------
+    class PatchSurface::CurveSubdivider
+    {
+    public:
+        CurveSubdivider(PatchSurface* surface, void* lockedBuffer, bool rows)
+            : mSurface(surface), mLockedBuffer(lockedBuffer), mRows(rows) {}
+
+        /// Subdivides a row in u, or a column in v, of the mesh
+        void operator()(size_t i) const
+        {
+            PatchSurface* s = mSurface;
+            size_t vStep = 1 << s->mMaxVLevel;
+            size_t uStep = 1 << s->mMaxULevel;
+            if (mRows)
+                s->subdivideCurve(mLockedBuffer, i * vStep * s->mMeshWidth, uStep, s->mMeshWidth / uStep, s->mULevel);
+            else
+                s->subdivideCurve(mLockedBuffer, i, vStep * s->mMeshWidth, s->mMeshHeight / vStep, s->mVLevel);
+        }
+
+    private:
+        PatchSurface* mSurface;
+        void* mLockedBuffer;
+        bool mRows;
+    };
+    //-----------------------------------------------------------------------
+    class PatchSurface::SurfaceSubdivider
+    {
+    public:
+        SurfaceSubdivider(const vector<PatchSurface*>::type* surfaces, unsigned char* lockedBuffer,
+            size_t vertexStart, size_t vertexSize)
+            : mSurfaces(surfaces), mLockedBuffer(lockedBuffer), mVertexStart(vertexStart), mVertexSize(vertexSize) {}
+
+        void operator()(size_t i) const
+        {
+            PatchSurface* s = (*mSurfaces)[i];
+            s->tessellate(mLockedBuffer + (s->mVertexOffset - mVertexStart) * mVertexSize, false);
+        }
+
+    private:
+        const vector<PatchSurface*>::type* mSurfaces;
+        unsigned char* mLockedBuffer;
+        size_t mVertexStart;
+        size_t mVertexSize;
+    };
     //-----------------------------------------------------------------------
     PatchSurface::PatchSurface()
+        : mDeclaration(0), mVertexSize(0), mElemPos(0), mElemNorm(0), mElemDiffuse(0),
+          mElemTex0(0), mElemTex1(0), mControlPointBuffer(0), mCtlCount(0)
     {
         mType = PST_BEZIER;
     }
@@ -60,18 +107,22 @@ namespace Ogre {
         mCtlCount = width * height;
         mControlPointBuffer = controlPointBuffer;
         mDeclaration = declaration;
+        mVertexSize = declaration->getVertexSize(0);
+        mElemPos = declaration->findElementBySemantic(VES_POSITION);
+        mElemNorm = declaration->findElementBySemantic(VES_NORMAL);
+        mElemDiffuse = declaration->findElementBySemantic(VES_DIFFUSE);
+        mElemTex0 = declaration->findElementBySemantic(VES_TEXTURE_COORDINATES, 0);
+        mElemTex1 = declaration->findElementBySemantic(VES_TEXTURE_COORDINATES, 1);
 
         // Copy positions into Vector3 vector
         mVecCtlPoints.clear();
-        const VertexElement* elem = declaration->findElementBySemantic(VES_POSITION);
-        size_t vertSize = declaration->getVertexSize(0);
         const unsigned char *pVert = static_cast<const unsigned char*>(controlPointBuffer);
         float* pFloat;
         for (size_t i = 0; i < mCtlCount; ++i)
         {
-            elem->baseVertexPointerToElement(const_cast<unsigned char*>(pVert), &pFloat);
+            mElemPos->baseVertexPointerToElement(const_cast<unsigned char*>(pVert), &pFloat);
             mVecCtlPoints.push_back(Vector3(pFloat[0], pFloat[1], pFloat[2]));
-            pVert += vertSize;
+            pVert += mVertexSize;
         }
 
         mVSide = visibleSide;
@@ -169,36 +220,138 @@ namespace Ogre {
 
         // Lock just the region we are interested in 
         void* lockedBuffer = mVertexBuffer->lock(
-            mVertexOffset * mDeclaration->getVertexSize(0), 
-            mRequiredVertexCount * mDeclaration->getVertexSize(0),
+            mVertexOffset * mVertexSize, 
+            mRequiredVertexCount * mVertexSize,
             HardwareBuffer::HBL_NO_OVERWRITE);
 
-        distributeControlPoints(lockedBuffer);
+        tessellate(lockedBuffer, mRequiredVertexCount >= PARALLEL_VERTEX_COUNT);
 
-        // Subdivide the curve to the MAX :)
-        // Do u direction first, so need to step over v levels not done yet
-        size_t vStep = 1 << mMaxVLevel;
-        size_t uStep = 1 << mMaxULevel;
+        mVertexBuffer->unlock();
 
-        size_t v, u;
-        for (v = 0; v < mMeshHeight; v += vStep)
+        // Make triangles from mesh at this current level of detail
+        makeTriangles();
+
+    }
+    //-----------------------------------------------------------------------
+    void PatchSurface::buildSurfaces(const vector<PatchSurface*>::type& surfaces,
+        HardwareVertexBufferSharedPtr destVertexBuffer, size_t vertexStart,
+        HardwareIndexBufferSharedPtr destIndexBuffer, size_t indexStart)
+    {
+        // Place the surfaces one after another
+        vector<PatchSurface*>::type defined;
+        size_t vertexCount = 0;
+        size_t indexOffset = indexStart;
+        for (vector<PatchSurface*>::type::const_iterator i = surfaces.begin(); i != surfaces.end(); ++i)
         {
-            // subdivide this row in u
-            subdivideCurve(lockedBuffer, v*mMeshWidth, uStep, mMeshWidth / uStep, mULevel);
+            PatchSurface* s = *i;
+            if (s->mVecCtlPoints.empty())
+                continue;
+
+            assert(defined.empty() || s->mVertexSize == defined.front()->mVertexSize);
+            s->mVertexBuffer = destVertexBuffer;
+            s->mVertexOffset = vertexStart + vertexCount;
+            s->mIndexBuffer = destIndexBuffer;
+            s->mIndexOffset = indexOffset;
+            vertexCount += s->mRequiredVertexCount;
+            indexOffset += s->mRequiredIndexCount;
+            defined.push_back(s);
         }
 
-        // Now subdivide in v direction, this time all the u direction points are there so no step
-        for (u = 0; u < mMeshWidth; ++u)
+        if (defined.empty())
+            return;
+
+        // The surfaces are small as a rule, so split the work by surface rather than by curve
+        size_t vertexSize = defined.front()->mVertexSize;
+        unsigned char* lockedBuffer = static_cast<unsigned char*>(destVertexBuffer->lock(
+            vertexStart * vertexSize, vertexCount * vertexSize, HardwareBuffer::HBL_NO_OVERWRITE));
+
+        parallelFor(0, defined.size(), SurfaceSubdivider(&defined, lockedBuffer, vertexStart, vertexSize));
+
+        destVertexBuffer->unlock();
+
+        for (vector<PatchSurface*>::type::iterator i = defined.begin(); i != defined.end(); ++i)
+            (*i)->makeTriangles();
+    }
+    //-----------------------------------------------------------------------
+    size_t PatchSurface::getRequiredPatchIndexCount(void) const
+    {
+        size_t iterations = (mVSide == VS_BOTH)? 2 : 1;
+        return ((mCtlWidth - 1) / 2) * ((mCtlHeight - 1) / 2) * 9 * iterations;
+    }
+    //-----------------------------------------------------------------------
+    void PatchSurface::buildPatchIndexes(HardwareIndexBufferSharedPtr destIndexBuffer, size_t indexStart)
+    {
+        if (mVecCtlPoints.empty())
+            return;
+
+        size_t indexCount = getRequiredPatchIndexCount();
+        bool use32bitindexes = (destIndexBuffer->getType() == HardwareIndexBuffer::IT_32BIT);
+        size_t indexSize = destIndexBuffer->getIndexSize();
+        unsigned short* p16 = 0;
+        unsigned int* p32 = 0;
+        void* pIndexes = destIndexBuffer->lock(indexStart * indexSize, indexCount * indexSize,
+            HardwareBuffer::HBL_NO_OVERWRITE);
+        if (use32bitindexes)
+            p32 = static_cast<unsigned int*>(pIndexes);
+        else
+            p16 = static_cast<unsigned short*>(pIndexes);
+
+        // The front side lists the rows of each patch with increasing v, the back side reversed
+        bool sides[2] = { mVSide != VS_BACK, mVSide != VS_FRONT };
+        for (int side = 0; side < 2; ++side)
         {
-            subdivideCurve(lockedBuffer, u, vStep*mMeshWidth, mMeshHeight / vStep, mVLevel);
+            if (!sides[side])
+                continue;
+
+            for (size_t v = 0; v + 2 < mCtlHeight; v += 2)
+            {
+                for (size_t u = 0; u + 2 < mCtlWidth; u += 2)
+                {
+                    for (size_t row = 0; row < 3; ++row)
+                    {
+                        size_t base = (v + (side ? 2 - row : row)) * mCtlWidth + u;
+                        for (size_t col = 0; col < 3; ++col)
+                        {
+                            if (use32bitindexes)
+                                *p32++ = static_cast<unsigned int>(base + col);
+                            else
+                                *p16++ = static_cast<unsigned short>(base + col);
+                        }
+                    }
+                }
+            }
         }
-        
 
-        mVertexBuffer->unlock();
+        destIndexBuffer->unlock();
+    }
+    //-----------------------------------------------------------------------
+    void PatchSurface::tessellate(void* lockedBuffer, bool parallel)
+    {
+        distributeControlPoints(lockedBuffer);
 
-        // Make triangles from mesh at this current level of detail
-        makeTriangles();
+        // Subdivide the curve to the MAX :)
+        // Do u direction first, so need to step over v levels not done yet.
+        // Every row, and then every column, is independent of the others.
+        size_t vStep = 1 << mMaxVLevel;
+        size_t rowCount = (mMeshHeight - 1) / vStep + 1;
+        CurveSubdivider rows(this, lockedBuffer, true);
+        // Now subdivide in v direction, this time all the u direction points are there so no step
+        CurveSubdivider columns(this, lockedBuffer, false);
 
+        if (parallel)
+        {
+            // Claim a few hundred vertices at once
+            size_t grainSize = std::max<size_t>(1, 256 / mMeshWidth);
+            parallelFor(0, rowCount, rows, grainSize);
+            parallelFor(0, mMeshWidth, columns, std::max<size_t>(1, 256 / mMeshHeight));
+        }
+        else
+        {
+            for (size_t v = 0; v < rowCount; ++v)
+                rows(v);
+            for (size_t u = 0; u < mMeshWidth; ++u)
+                columns(u);
+        }
     }
     //-----------------------------------------------------------------------
     size_t PatchSurface::getAutoULevel(bool forMax)
@@ -387,14 +540,14 @@ namespace Ogre {
         size_t vStep = 1 << mVLevel;
 
         void* pSrc = mControlPointBuffer;
-        size_t vertexSize = mDeclaration->getVertexSize(0);
+        size_t vertexSize = mVertexSize;
         float *pSrcReal, *pDestReal;
         RGBA *pSrcRGBA, *pDestRGBA;
-        const VertexElement* elemPos = mDeclaration->findElementBySemantic(VES_POSITION);
-        const VertexElement* elemNorm = mDeclaration->findElementBySemantic(VES_NORMAL);
-        const VertexElement* elemTex0 = mDeclaration->findElementBySemantic(VES_TEXTURE_COORDINATES, 0);
-        const VertexElement* elemTex1 = mDeclaration->findElementBySemantic(VES_TEXTURE_COORDINATES, 1);
-        const VertexElement* elemDiffuse = mDeclaration->findElementBySemantic(VES_DIFFUSE);
+        const VertexElement* elemPos = mElemPos;
+        const VertexElement* elemNorm = mElemNorm;
+        const VertexElement* elemTex0 = mElemTex0;
+        const VertexElement* elemTex1 = mElemTex1;
+        const VertexElement* elemDiffuse = mElemDiffuse;
         for (size_t v = 0; v < mMeshHeight; v += vStep)
         {
             // set dest by v from base
@@ -628,12 +781,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void PatchSurface::interpolateVertexData(void* lockedBuffer, size_t leftIdx, size_t rightIdx, size_t destIdx)
     {
-        size_t vertexSize = mDeclaration->getVertexSize(0);
-        const VertexElement* elemPos = mDeclaration->findElementBySemantic(VES_POSITION);
-        const VertexElement* elemNorm = mDeclaration->findElementBySemantic(VES_NORMAL);
-        const VertexElement* elemDiffuse = mDeclaration->findElementBySemantic(VES_DIFFUSE);
-        const VertexElement* elemTex0 = mDeclaration->findElementBySemantic(VES_TEXTURE_COORDINATES, 0);
-        const VertexElement* elemTex1 = mDeclaration->findElementBySemantic(VES_TEXTURE_COORDINATES, 1);
+        size_t vertexSize = mVertexSize;
+        const VertexElement* elemPos = mElemPos;
+        const VertexElement* elemNorm = mElemNorm;
+        const VertexElement* elemDiffuse = mElemDiffuse;
+        const VertexElement* elemTex0 = mElemTex0;
+        const VertexElement* elemTex1 = mElemTex1;
 
         float *pDestReal, *pLeftReal, *pRightReal;
         unsigned char *pDestChar, *pLeftChar, *pRightChar;
@@ -32,6 +32,16 @@ THE SOFTWARE.
 #if OGRE_COMPILER != OGRE_COMPILER_MSVC || OGRE_COMP_VER >= 1300
 
 #define FMTCONVERTERID(from,to) (((from)<<8)|(to))
+
+// SIMD row kernels assume the byte order of a little endian uint32
+#if __OGRE_HAVE_SSE && OGRE_ENDIAN == OGRE_ENDIAN_LITTLE && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   define OGRE_PIXELCONVERSION_SSE2 1
+#   include <emmintrin.h>
+#elif __OGRE_HAVE_NEON && OGRE_ENDIAN == OGRE_ENDIAN_LITTLE
+#   define OGRE_PIXELCONVERSION_NEON 1
+#   include <arm_neon.h>
+#endif
 /** \addtogroup Core
 *  @{
 */
@@ -77,6 +87,42 @@ template <class U> struct PixelBoxConverter
     }
 };
 
+/**
+ * Like PixelBoxConverter, but hands whole rows to the policy class so it can
+ * convert several pixels at once.
+ *
+ * @remarks The policy class has a static method rowConvert(const SrcType*, DstType*, size_t count)
+ *    that converts count pixels.
+ */
+template <class U> struct PixelBoxRowConverter
+{
+    static const int ID = U::ID;
+    static void conversion(const Ogre::PixelBox &src, const Ogre::PixelBox &dst)
+    {
+        const size_t srcPixelSize = Ogre::PixelUtil::getNumElemBytes(src.format);
+        const size_t dstPixelSize = Ogre::PixelUtil::getNumElemBytes(dst.format);
+        const Ogre::uint8 *srcptr = static_cast<const Ogre::uint8*>(src.data)
+            + (src.left + src.top * src.rowPitch + src.front * src.slicePitch) * srcPixelSize;
+        Ogre::uint8 *dstptr = static_cast<Ogre::uint8*>(dst.data)
+            + (dst.left + dst.top * dst.rowPitch + dst.front * dst.slicePitch) * dstPixelSize;
+        const size_t srcSliceSkip = src.getSliceSkip() * srcPixelSize;
+        const size_t dstSliceSkip = dst.getSliceSkip() * dstPixelSize;
+        const size_t k = src.right - src.left;
+        for(size_t z=src.front; z<src.back; z++)
+        {
+            for(size_t y=src.top; y<src.bottom; y++)
+            {
+                U::rowConvert(reinterpret_cast<const typename U::SrcType*>(srcptr),
+                              reinterpret_cast<typename U::DstType*>(dstptr), k);
+                srcptr += src.rowPitch * srcPixelSize;
+                dstptr += dst.rowPitch * dstPixelSize;
+            }
+            srcptr += srcSliceSkip;
+            dstptr += dstSliceSkip;
+        }
+    }
+};
+
 template <typename T, typename U, int id> struct PixelConverter {
     static const int ID = id;
     typedef T SrcType;
@@ -378,40 +424,333 @@ struct X8B8G8R8toR8G8B8A8: public PixelConverter <Ogre::uint32, Ogre::uint32, FM
     }
 };
 
+struct L8toR8G8B8A8: public PixelConverter <Ogre::uint8, Ogre::uint32, FMTCONVERTERID(Ogre::PF_L8, Ogre::PF_R8G8B8A8)>
+{
+    inline static DstType pixelConvert(SrcType inp)
+    {
+        return 0x000000FF|(((unsigned int)inp)<<8)|(((unsigned int)inp)<<16)|(((unsigned int)inp)<<24);
+    }
+};
+
+// Alpha only formats expand to black
+struct A8toA8R8G8B8: public PixelConverter <Ogre::uint8, Ogre::uint32, FMTCONVERTERID(Ogre::PF_A8, Ogre::PF_A8R8G8B8)>
+{
+    inline static DstType pixelConvert(SrcType inp)
+    {
+        return ((unsigned int)inp)<<24;
+    }
+};
+struct A8toA8B8G8R8: public PixelConverter <Ogre::uint8, Ogre::uint32, FMTCONVERTERID(Ogre::PF_A8, Ogre::PF_A8B8G8R8)>
+{
+    inline static DstType pixelConvert(SrcType inp)
+    {
+        return ((unsigned int)inp)<<24;
+    }
+};
+struct A8toB8G8R8A8: public PixelConverter <Ogre::uint8, Ogre::uint32, FMTCONVERTERID(Ogre::PF_A8, Ogre::PF_B8G8R8A8)>
+{
+    inline static DstType pixelConvert(SrcType inp)
+    {
+        return inp;
+    }
+};
+struct A8toR8G8B8A8: public PixelConverter <Ogre::uint8, Ogre::uint32, FMTCONVERTERID(Ogre::PF_A8, Ogre::PF_R8G8B8A8)>
+{
+    inline static DstType pixelConvert(SrcType inp)
+    {
+        return inp;
+    }
+};
+
+/**
+ * Swaps bytes 0,2 and 1,3 of each 32 bit pixel, keeping those in keepMask.
+ * Covers the R/B swizzles between the 8 bit RGBA and BGRA formats.
+ */
+template <class U, Ogre::uint32 keepMask> struct SwapBytePairsRow: public U
+{
+    static void rowConvert(const Ogre::uint32 *src, Ogre::uint32 *dst, size_t count)
+    {
+        size_t x = 0;
+#if OGRE_PIXELCONVERSION_SSE2
+        const __m128i keep = _mm_set1_epi32((int)keepMask);
+        for(; x + 4 <= count; x += 4)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+            __m128i r = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+            _mm_storeu_si128((__m128i*)(dst + x), _mm_or_si128(_mm_and_si128(keep, v), _mm_andnot_si128(keep, r)));
+        }
+#elif OGRE_PIXELCONVERSION_NEON
+        const uint32x4_t keep = vdupq_n_u32(keepMask);
+        for(; x + 4 <= count; x += 4)
+        {
+            uint32x4_t v = vld1q_u32(src + x);
+            uint32x4_t r = vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(v)));
+            vst1q_u32(dst + x, vbslq_u32(keep, v, r));
+        }
+#endif
+        for(; x < count; x++)
+        {
+            dst[x] = U::pixelConvert(src[x]);
+        }
+    }
+};
+
+/**
+ * Replicates a single byte into the lanes of lumMask and sets constBits.
+ * Covers expanding luminance and alpha only formats to 32 bit colour.
+ */
+template <class U, Ogre::uint32 lumMask, Ogre::uint32 constBits> struct ExpandByteRow: public U
+{
+    static void rowConvert(const Ogre::uint8 *src, Ogre::uint32 *dst, size_t count)
+    {
+        size_t x = 0;
+#if OGRE_PIXELCONVERSION_SSE2
+        const __m128i mask = _mm_set1_epi32((int)lumMask);
+        const __m128i bits = _mm_set1_epi32((int)constBits);
+        for(; x + 16 <= count; x += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+            __m128i lo = _mm_unpacklo_epi8(v, v);
+            __m128i hi = _mm_unpackhi_epi8(v, v);
+            __m128i p[4] = { _mm_unpacklo_epi16(lo, lo), _mm_unpackhi_epi16(lo, lo),
+                             _mm_unpacklo_epi16(hi, hi), _mm_unpackhi_epi16(hi, hi) };
+            for(int i = 0; i < 4; i++)
+            {
+                _mm_storeu_si128((__m128i*)(dst + x + i * 4), _mm_or_si128(_mm_and_si128(p[i], mask), bits));
+            }
+        }
+#elif OGRE_PIXELCONVERSION_NEON
+        const uint32x4_t mask = vdupq_n_u32(lumMask);
+        const uint32x4_t bits = vdupq_n_u32(constBits);
+        for(; x + 16 <= count; x += 16)
+        {
+            uint8x16_t v = vld1q_u8(src + x);
+            uint8x16x2_t b = vzipq_u8(v, v);
+            uint16x8x2_t lo = vzipq_u16(vreinterpretq_u16_u8(b.val[0]), vreinterpretq_u16_u8(b.val[0]));
+            uint16x8x2_t hi = vzipq_u16(vreinterpretq_u16_u8(b.val[1]), vreinterpretq_u16_u8(b.val[1]));
+            uint16x8_t p[4] = { lo.val[0], lo.val[1], hi.val[0], hi.val[1] };
+            for(int i = 0; i < 4; i++)
+            {
+                vst1q_u32(dst + x + i * 4, vorrq_u32(vandq_u32(vreinterpretq_u32_u16(p[i]), mask), bits));
+            }
+        }
+#endif
+        for(; x < count; x++)
+        {
+            dst[x] = U::pixelConvert(src[x]);
+        }
+    }
+};
+
+/**
+ * Expands 24 bit pixels to 32 bit ones with the alpha in the last byte in
+ * memory, optionally swapping the first and third byte.
+ */
+template <class U, bool swap> struct Col3bExpandRow: public U
+{
+    static void rowConvert(const Col3b *src, Ogre::uint32 *dst, size_t count)
+    {
+        size_t x = 0;
+#if OGRE_PIXELCONVERSION_SSE2
+        const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+        const __m128i keep = _mm_set1_epi32((int)0xFF00FF00);
+        // one mask per pixel lane, the loads read 16 bytes for 12 bytes of pixels
+        const __m128i lane0 = _mm_set_epi32(0, 0, 0, 0x00FFFFFF);
+        const __m128i lane1 = _mm_set_epi32(0, 0, 0x00FFFFFF, 0);
+        const __m128i lane2 = _mm_set_epi32(0, 0x00FFFFFF, 0, 0);
+        const __m128i lane3 = _mm_set_epi32(0x00FFFFFF, 0, 0, 0);
+        for(; x + 6 <= count; x += 4)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+            __m128i p = _mm_or_si128(
+                _mm_or_si128(_mm_and_si128(v, lane0), _mm_and_si128(_mm_slli_si128(v, 1), lane1)),
+                _mm_or_si128(_mm_and_si128(_mm_slli_si128(v, 2), lane2), _mm_and_si128(_mm_slli_si128(v, 3), lane3)));
+            p = _mm_or_si128(p, alpha);
+            if(swap)
+            {
+                __m128i r = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+                p = _mm_or_si128(_mm_and_si128(keep, p), _mm_andnot_si128(keep, r));
+            }
+            _mm_storeu_si128((__m128i*)(dst + x), p);
+        }
+#elif OGRE_PIXELCONVERSION_NEON
+        for(; x + 16 <= count; x += 16)
+        {
+            uint8x16x3_t v = vld3q_u8((const Ogre::uint8*)(src + x));
+            uint8x16x4_t p;
+            p.val[0] = swap ? v.val[2] : v.val[0];
+            p.val[1] = v.val[1];
+            p.val[2] = swap ? v.val[0] : v.val[2];
+            p.val[3] = vdupq_n_u8(0xFF);
+            vst4q_u8((Ogre::uint8*)(dst + x), p);
+        }
+#endif
+        for(; x < count; x++)
+        {
+            dst[x] = U::pixelConvert(src[x]);
+        }
+    }
+};
+
+/**
+ * Converts float32 to float16 formats with the same channels, giving the
+ * same results as Bitwise::floatToHalf. Groups containing values that
+ * become half denormals are converted one by one.
+ */
+template <int id, int components> struct Float32toFloat16Row:
+    public PixelConverter <float, Ogre::uint16, id>
+{
+    static void rowConvert(const float *src, Ogre::uint16 *dst, size_t count)
+    {
+        const size_t n = count * components;
+        size_t i = 0;
+#if OGRE_PIXELCONVERSION_SSE2
+        for(; i + 8 <= n; i += 8)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 4));
+            __m128i denormA, denormB;
+            a = floatToHalf4(a, denormA);
+            b = floatToHalf4(b, denormB);
+            if(_mm_movemask_epi8(_mm_or_si128(denormA, denormB)))
+            {
+                for(size_t j = i; j < i + 8; j++)
+                    dst[j] = Ogre::Bitwise::floatToHalf(src[j]);
+                continue;
+            }
+            // sign extend so the saturating pack keeps the low 16 bits
+            a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+            b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+        }
+#elif OGRE_PIXELCONVERSION_NEON
+        for(; i + 4 <= n; i += 4)
+        {
+            uint32x4_t v = vld1q_u32((const Ogre::uint32*)(src + i));
+            uint32x4_t fe = vandq_u32(vshrq_n_u32(v, 23), vdupq_n_u32(0xFF));
+            uint32x4_t denorm = vandq_u32(vcgtq_u32(fe, vdupq_n_u32(101)), vcltq_u32(fe, vdupq_n_u32(113)));
+            uint32x2_t any = vorr_u32(vget_low_u32(denorm), vget_high_u32(denorm));
+            if(vget_lane_u32(any, 0) | vget_lane_u32(any, 1))
+            {
+                for(size_t j = i; j < i + 4; j++)
+                    dst[j] = Ogre::Bitwise::floatToHalf(src[j]);
+                continue;
+            }
+            uint32x4_t s = vandq_u32(vshrq_n_u32(v, 16), vdupq_n_u32(0x8000));
+            uint32x4_t m = vandq_u32(v, vdupq_n_u32(0x007FFFFF));
+            uint32x4_t mh = vshrq_n_u32(m, 13);
+            uint32x4_t h = vorrq_u32(s, vsubq_u32(vshrq_n_u32(vandq_u32(v, vdupq_n_u32(0x7FFFFFFF)), 13), vdupq_n_u32(112 << 10)));
+            // NaNs that lose their mantissa bits must stay NaN
+            uint32x4_t quiet = vandq_u32(vbicq_u32(vceqq_u32(mh, vdupq_n_u32(0)), vceqq_u32(m, vdupq_n_u32(0))), vdupq_n_u32(1));
+            uint32x4_t nan = vandq_u32(vceqq_u32(fe, vdupq_n_u32(0xFF)), vorrq_u32(mh, quiet));
+            uint32x4_t inf = vorrq_u32(vorrq_u32(s, vdupq_n_u32(0x7C00)), nan);
+            h = vbslq_u32(vcgtq_u32(fe, vdupq_n_u32(142)), inf, h);
+            h = vbicq_u32(h, vcltq_u32(fe, vdupq_n_u32(102)));
+            vst1_u16(dst + i, vmovn_u32(h));
+        }
+#endif
+        for(; i < n; i++)
+        {
+            dst[i] = Ogre::Bitwise::floatToHalf(src[i]);
+        }
+    }
+
+#if OGRE_PIXELCONVERSION_SSE2
+    static inline __m128i floatToHalf4(__m128i v, __m128i &denorm)
+    {
+        const __m128i fe = _mm_and_si128(_mm_srli_epi32(v, 23), _mm_set1_epi32(0xFF));
+        denorm = _mm_and_si128(_mm_cmpgt_epi32(fe, _mm_set1_epi32(101)), _mm_cmplt_epi32(fe, _mm_set1_epi32(113)));
+        const __m128i s = _mm_and_si128(_mm_srli_epi32(v, 16), _mm_set1_epi32(0x8000));
+        const __m128i m = _mm_and_si128(v, _mm_set1_epi32(0x007FFFFF));
+        const __m128i mh = _mm_srli_epi32(m, 13);
+        __m128i h = _mm_or_si128(s, _mm_sub_epi32(
+            _mm_srli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x7FFFFFFF)), 13), _mm_set1_epi32(112 << 10)));
+        // NaNs that lose their mantissa bits must stay NaN
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i quiet = _mm_and_si128(_mm_andnot_si128(_mm_cmpeq_epi32(m, zero), _mm_cmpeq_epi32(mh, zero)),
+                                            _mm_set1_epi32(1));
+        const __m128i nan = _mm_and_si128(_mm_cmpeq_epi32(fe, _mm_set1_epi32(0xFF)), _mm_or_si128(mh, quiet));
+        const __m128i inf = _mm_or_si128(_mm_or_si128(s, _mm_set1_epi32(0x7C00)), nan);
+        const __m128i big = _mm_cmpgt_epi32(fe, _mm_set1_epi32(142));
+        h = _mm_or_si128(_mm_and_si128(big, inf), _mm_andnot_si128(big, h));
+        return _mm_andnot_si128(_mm_cmplt_epi32(fe, _mm_set1_epi32(102)), h);
+    }
+#endif
+};
+
+struct A8R8G8B8toA8B8G8R8Row: public SwapBytePairsRow<A8R8G8B8toA8B8G8R8, 0xFF00FF00> { };
+struct A8B8G8R8toA8R8G8B8Row: public SwapBytePairsRow<A8B8G8R8toA8R8G8B8, 0xFF00FF00> { };
+struct B8G8R8A8toR8G8B8A8Row: public SwapBytePairsRow<B8G8R8A8toR8G8B8A8, 0x00FF00FF> { };
+struct R8G8B8A8toB8G8R8A8Row: public SwapBytePairsRow<R8G8B8A8toB8G8R8A8, 0x00FF00FF> { };
+
+struct L8toA8B8G8R8Row: public ExpandByteRow<L8toA8B8G8R8, 0x00FFFFFF, 0xFF000000> { };
+struct L8toA8R8G8B8Row: public ExpandByteRow<L8toA8R8G8B8, 0x00FFFFFF, 0xFF000000> { };
+struct L8toB8G8R8A8Row: public ExpandByteRow<L8toB8G8R8A8, 0xFFFFFF00, 0x000000FF> { };
+struct L8toR8G8B8A8Row: public ExpandByteRow<L8toR8G8B8A8, 0xFFFFFF00, 0x000000FF> { };
+struct A8toA8R8G8B8Row: public ExpandByteRow<A8toA8R8G8B8, 0xFF000000, 0> { };
+struct A8toA8B8G8R8Row: public ExpandByteRow<A8toA8B8G8R8, 0xFF000000, 0> { };
+struct A8toB8G8R8A8Row: public ExpandByteRow<A8toB8G8R8A8, 0x000000FF, 0> { };
+struct A8toR8G8B8A8Row: public ExpandByteRow<A8toR8G8B8A8, 0x000000FF, 0> { };
+
+#if OGRE_ENDIAN == OGRE_ENDIAN_LITTLE
+// PF_BYTE_RGB to PF_BYTE_RGBA and so on
+struct R8G8B8toA8R8G8B8Row: public Col3bExpandRow<R8G8B8toA8R8G8B8, false> { };
+struct B8G8R8toA8B8G8R8Row: public Col3bExpandRow<B8G8R8toA8B8G8R8, false> { };
+struct B8G8R8toA8R8G8B8Row: public Col3bExpandRow<B8G8R8toA8R8G8B8, true> { };
+struct R8G8B8toA8B8G8R8Row: public Col3bExpandRow<R8G8B8toA8B8G8R8, true> { };
+#endif
+
+struct FLOAT32_RtoFLOAT16_R: public Float32toFloat16Row<FMTCONVERTERID(Ogre::PF_FLOAT32_R, Ogre::PF_FLOAT16_R), 1> { };
+struct FLOAT32_GRtoFLOAT16_GR: public Float32toFloat16Row<FMTCONVERTERID(Ogre::PF_FLOAT32_GR, Ogre::PF_FLOAT16_GR), 2> { };
+struct FLOAT32_RGBtoFLOAT16_RGB: public Float32toFloat16Row<FMTCONVERTERID(Ogre::PF_FLOAT32_RGB, Ogre::PF_FLOAT16_RGB), 3> { };
+struct FLOAT32_RGBAtoFLOAT16_RGBA: public Float32toFloat16Row<FMTCONVERTERID(Ogre::PF_FLOAT32_RGBA, Ogre::PF_FLOAT16_RGBA), 4> { };
 
 #define CASECONVERTER(type) case type::ID : PixelBoxConverter<type>::conversion(src, dst); return 1;
+#define CASEROWCONVERTER(type) case type::ID : PixelBoxRowConverter<type>::conversion(src, dst); return 1;
 
 inline int doOptimizedConversion(const Ogre::PixelBox &src, const Ogre::PixelBox &dst)
 {;
     switch(FMTCONVERTERID(src.format, dst.format))
     {
         // Register converters here
-        CASECONVERTER(A8R8G8B8toA8B8G8R8);
+        CASEROWCONVERTER(A8R8G8B8toA8B8G8R8Row);
         CASECONVERTER(A8R8G8B8toB8G8R8A8);
         CASECONVERTER(A8R8G8B8toR8G8B8A8);
-        CASECONVERTER(A8B8G8R8toA8R8G8B8);
+        CASEROWCONVERTER(A8B8G8R8toA8R8G8B8Row);
         CASECONVERTER(A8B8G8R8toB8G8R8A8);
         CASECONVERTER(A8B8G8R8toR8G8B8A8);
         CASECONVERTER(B8G8R8A8toA8R8G8B8);
         CASECONVERTER(B8G8R8A8toA8B8G8R8);
-        CASECONVERTER(B8G8R8A8toR8G8B8A8);
+        CASEROWCONVERTER(B8G8R8A8toR8G8B8A8Row);
         CASECONVERTER(R8G8B8A8toA8R8G8B8);
         CASECONVERTER(R8G8B8A8toA8B8G8R8);
-        CASECONVERTER(R8G8B8A8toB8G8R8A8);
+        CASEROWCONVERTER(R8G8B8A8toB8G8R8A8Row);
         CASECONVERTER(A8B8G8R8toL8);
-        CASECONVERTER(L8toA8B8G8R8);
+        CASEROWCONVERTER(L8toA8B8G8R8Row);
         CASECONVERTER(A8R8G8B8toL8);
-        CASECONVERTER(L8toA8R8G8B8);
+        CASEROWCONVERTER(L8toA8R8G8B8Row);
         CASECONVERTER(B8G8R8A8toL8);
-        CASECONVERTER(L8toB8G8R8A8);
+        CASEROWCONVERTER(L8toB8G8R8A8Row);
+        CASEROWCONVERTER(L8toR8G8B8A8Row);
+        CASEROWCONVERTER(A8toA8R8G8B8Row);
+        CASEROWCONVERTER(A8toA8B8G8R8Row);
+        CASEROWCONVERTER(A8toB8G8R8A8Row);
+        CASEROWCONVERTER(A8toR8G8B8A8Row);
         CASECONVERTER(L8toL16);
         CASECONVERTER(L16toL8);
         CASECONVERTER(B8G8R8toR8G8B8);
         CASECONVERTER(R8G8B8toB8G8R8);
+#if OGRE_ENDIAN == OGRE_ENDIAN_LITTLE
+        CASEROWCONVERTER(R8G8B8toA8R8G8B8Row);
+        CASEROWCONVERTER(B8G8R8toA8R8G8B8Row);
+        CASEROWCONVERTER(R8G8B8toA8B8G8R8Row);
+        CASEROWCONVERTER(B8G8R8toA8B8G8R8Row);
+#else
         CASECONVERTER(R8G8B8toA8R8G8B8);
         CASECONVERTER(B8G8R8toA8R8G8B8);
         CASECONVERTER(R8G8B8toA8B8G8R8);
         CASECONVERTER(B8G8R8toA8B8G8R8);
+#endif
         CASECONVERTER(R8G8B8toB8G8R8A8);
         CASECONVERTER(B8G8R8toB8G8R8A8);
         CASECONVERTER(A8R8G8B8toR8G8B8);
@@ -424,12 +763,17 @@ inline int doOptimizedConversion(const Ogre::PixelBox &src, const Ogre::PixelBox
         CASECONVERTER(X8B8G8R8toA8B8G8R8);
         CASECONVERTER(X8B8G8R8toB8G8R8A8);
         CASECONVERTER(X8B8G8R8toR8G8B8A8);
+        CASEROWCONVERTER(FLOAT32_RtoFLOAT16_R);
+        CASEROWCONVERTER(FLOAT32_GRtoFLOAT16_GR);
+        CASEROWCONVERTER(FLOAT32_RGBtoFLOAT16_RGB);
+        CASEROWCONVERTER(FLOAT32_RGBAtoFLOAT16_RGBA);
 
         default:
             return 0;
     }
 }
 #undef CASECONVERTER
+#undef CASEROWCONVERTER
 /** @} */
 /** @} */
 
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreColourValue.h"
 #include "OgreException.h"
 #include "OgrePixelFormatDescriptions.h"
+#include "OgrePlatformInformation.h"
 
 namespace {
 #include "OgrePixelConversions.h"
@@ -683,6 +684,126 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    /* Bit moves turning the pixels of one native endian format into another,
+       for the pairs where every destination channel has the same number of
+       bits as its source channel, so no rounding is involved.
+    */
+    struct ChannelShuffle
+    {
+        uint32 mask[4];
+        int shift[4];
+        uint32 fill;
+    };
+    //-----------------------------------------------------------------------
+    static inline uint32 moveBits(uint32 value, int shift)
+    {
+        return shift >= 0 ? value << shift : value >> -shift;
+    }
+    //-----------------------------------------------------------------------
+    static bool buildChannelShuffle(const PixelFormatDescription &sdes,
+        const PixelFormatDescription &ddes, ChannelShuffle &shuffle)
+    {
+        const uint32 excluded = PFF_COMPRESSED | PFF_FLOAT | PFF_DEPTH;
+        if(!(sdes.flags & ddes.flags & PFF_NATIVEENDIAN) || ((sdes.flags | ddes.flags) & excluded) ||
+           sdes.elemBytes > 4 || ddes.elemBytes > 4)
+            return false;
+
+        const unsigned char sbits[4] = {sdes.rbits, sdes.gbits, sdes.bbits, sdes.abits};
+        const unsigned char dbits[4] = {ddes.rbits, ddes.gbits, ddes.bbits, ddes.abits};
+        const uint64 smask[4] = {sdes.rmask, sdes.gmask, sdes.bmask, sdes.amask};
+        const uint64 dmask[4] = {ddes.rmask, ddes.gmask, ddes.bmask, ddes.amask};
+        const int sshift[4] = {sdes.rshift, sdes.gshift, sdes.bshift, sdes.ashift};
+        const int dshift[4] = {ddes.rshift, ddes.gshift, ddes.bshift, ddes.ashift};
+
+        shuffle.fill = 0;
+        for(int c = 0; c < 4; ++c)
+        {
+            shuffle.mask[c] = 0;
+            shuffle.shift[c] = 0;
+            if(dbits[c] == 0)
+                continue;
+
+            // Like unpackColour, luminance feeds red, green and blue and a
+            // missing alpha is opaque
+            const int sc = (c < 3 && (sdes.flags & PFF_LUMINANCE)) ? 0 : c;
+            if(c == 3 && !(sdes.flags & PFF_HASALPHA))
+            {
+                shuffle.fill |= (uint32)dmask[3];
+                continue;
+            }
+            if(sbits[sc] != dbits[c])
+                return false;
+
+            // Bits that would fall outside the destination mask are dropped,
+            // as packColour does
+            shuffle.shift[c] = dshift[c] - sshift[sc];
+            shuffle.mask[c] = (uint32)smask[sc] & moveBits((uint32)dmask[c], -shuffle.shift[c]);
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    /* Shuffle loop with the element sizes known at compile time, so reading
+       and writing the pixels comes down to plain loads and stores.
+    */
+    template <int srcBytes, int dstBytes>
+    static void shuffleChannels(const PixelBox &src, const PixelBox &dst, const ChannelShuffle &shuffle)
+    {
+        const uint8 *srcptr = static_cast<const uint8*>(src.data)
+            + (src.left + src.top * src.rowPitch + src.front * src.slicePitch) * srcBytes;
+        uint8 *dstptr = static_cast<uint8*>(dst.data)
+            + (dst.left + dst.top * dst.rowPitch + dst.front * dst.slicePitch) * dstBytes;
+        const size_t srcRowSkipBytes = src.getRowSkip()*srcBytes;
+        const size_t srcSliceSkipBytes = src.getSliceSkip()*srcBytes;
+        const size_t dstRowSkipBytes = dst.getRowSkip()*dstBytes;
+        const size_t dstSliceSkipBytes = dst.getSliceSkip()*dstBytes;
+        const size_t width = src.getWidth();
+
+        for(size_t z=src.front; z<src.back; z++)
+        {
+            for(size_t y=src.top; y<src.bottom; y++)
+            {
+                for(size_t x=0; x<width; x++)
+                {
+                    const uint32 value = Bitwise::intRead(srcptr, srcBytes);
+                    const uint32 result = shuffle.fill |
+                        moveBits(value & shuffle.mask[0], shuffle.shift[0]) |
+                        moveBits(value & shuffle.mask[1], shuffle.shift[1]) |
+                        moveBits(value & shuffle.mask[2], shuffle.shift[2]) |
+                        moveBits(value & shuffle.mask[3], shuffle.shift[3]);
+                    Bitwise::intWrite(dstptr, dstBytes, result);
+                    srcptr += srcBytes;
+                    dstptr += dstBytes;
+                }
+                srcptr += srcRowSkipBytes;
+                dstptr += dstRowSkipBytes;
+            }
+            srcptr += srcSliceSkipBytes;
+            dstptr += dstSliceSkipBytes;
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool PixelUtil::_shuffleConversion(const PixelBox &src, const PixelBox &dst)
+    {
+        ChannelShuffle shuffle;
+        const PixelFormatDescription &sdes = getDescriptionFor(src.format);
+        const PixelFormatDescription &ddes = getDescriptionFor(dst.format);
+        if(!buildChannelShuffle(sdes, ddes, shuffle))
+            return false;
+
+#define SHUFFLECASE(s, d) case (s)*8+(d): shuffleChannels<s, d>(src, dst, shuffle); return true;
+#define SHUFFLECASES(s) SHUFFLECASE(s, 1) SHUFFLECASE(s, 2) SHUFFLECASE(s, 3) SHUFFLECASE(s, 4)
+        switch(sdes.elemBytes*8 + ddes.elemBytes)
+        {
+            SHUFFLECASES(1)
+            SHUFFLECASES(2)
+            SHUFFLECASES(3)
+            SHUFFLECASES(4)
+        }
+#undef SHUFFLECASES
+#undef SHUFFLECASE
+        return false;
+    }
+    //-----------------------------------------------------------------------
     /* Convert pixels from one format to another */
     void PixelUtil::bulkPixelConversion(void *srcp, PixelFormat srcFormat,
         void *destp, PixelFormat dstFormat, unsigned int count)
@@ -793,6 +914,10 @@ namespace Ogre {
         }
 #endif
 
+        // Can the channels be moved without rescaling?
+        if(_shuffleConversion(src, dst))
+            return;
+
         const size_t srcPixelSize = PixelUtil::getNumElemBytes(src.format);
         const size_t dstPixelSize = PixelUtil::getNumElemBytes(dst.format);
         uint8 *srcptr = static_cast<uint8*>(src.data)
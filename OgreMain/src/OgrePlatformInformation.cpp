@@ -150,12 +150,22 @@ namespace Ogre {
     }
 
     //---------------------------------------------------------------------
-    // Performs CPUID instruction with 'query', fill the results, and return value of eax.
-    static uint _performCpuid(int query, CpuidResult& result)
+    // Performs CPUID instruction with 'query' (and 'subquery' in ecx, used by
+    // leaves such as 0x7), fill the results, and return value of eax.
+    static uint _performCpuid(int query, CpuidResult& result, int subquery = 0)
     {
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
-    #if _MSC_VER >= 1400 
+    #if _MSC_VER >= 1500
         int CPUInfo[4];
+        __cpuidex(CPUInfo, query, subquery);
+        result._eax = CPUInfo[0];
+        result._ebx = CPUInfo[1];
+        result._ecx = CPUInfo[2];
+        result._edx = CPUInfo[3];
+        return result._eax;
+    #elif _MSC_VER >= 1400
+        int CPUInfo[4];
+        (void)subquery; // Not supported by __cpuid, leaf 0x7 isn't queried on such old compilers
         __cpuid(CPUInfo, query);
         result._eax = CPUInfo[0];
         result._ebx = CPUInfo[1];
@@ -167,6 +177,7 @@ namespace Ogre {
         {
             mov     edi, result
             mov     eax, query
+            mov     ecx, subquery
             cpuid
             mov     [edi]._eax, eax
             mov     [edi]._ebx, ebx
@@ -179,7 +190,7 @@ namespace Ogre {
         #if OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64
         __asm__
         (
-            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query)
+            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query), "c" (subquery)
         );
         #else
         __asm__
@@ -189,11 +200,37 @@ namespace Ogre {
             "movl   %%ebx, %%edi    \n\t"
             "popl   %%ebx           \n\t"
             : "=a" (result._eax), "=D" (result._ebx), "=c" (result._ecx), "=d" (result._edx)
-            : "a" (query)
+            : "a" (query), "c" (subquery)
         );
        #endif // OGRE_ARCHITECTURE_64
         return result._eax;
 
+#else
+        // TODO: Supports other compiler
+        return 0;
+#endif
+    }
+
+    //---------------------------------------------------------------------
+    // Reads extended control register 0 (XCR0), only valid when CPUID reports OSXSAVE.
+    static uint _readExtendedControlRegister(void)
+    {
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC
+    #if _MSC_VER >= 1600
+        return static_cast<uint>(_xgetbv(0));
+    #else
+        // Compiler doesn't know the instruction, assume the OS doesn't save YMM state
+        return 0;
+    #endif
+#elif (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && OGRE_PLATFORM != OGRE_PLATFORM_NACL && OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
+        uint xcrLow, xcrHigh;
+        // Emit the opcode of xgetbv directly for the sake of old assemblers
+        __asm__ __volatile__
+        (
+            ".byte 0x0f, 0x01, 0xd0" : "=a" (xcrLow), "=d" (xcrHigh) : "c" (0)
+        );
+        (void)xcrHigh;
+        return xcrLow;
 #else
         // TODO: Supports other compiler
         return 0;
@@ -312,6 +349,16 @@ namespace Ogre {
 
 #define CPUID_APM_INVARIANT_TSC     (1<<8)      // EDX[8] - Bit 8 of function 0x80000007 indicates support for invariant TSC.
 
+#define CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES 0x7
+
+#define CPUID_STD_FMA               (1<<12)     // ECX[12] - Bit 12 of standard function 1 indicate FMA3 supported
+#define CPUID_STD_OSXSAVE           (1<<27)     // ECX[27] - Bit 27 of standard function 1 indicate XGETBV enabled by the OS
+#define CPUID_STD_AVX               (1<<28)     // ECX[28] - Bit 28 of standard function 1 indicate AVX supported
+
+#define CPUID_SEF_AVX2              (1<<5)      // EBX[5]  - Bit 5 of function 0x7 (subleaf 0) indicate AVX2 supported
+
+#define XCR0_SSE_AVX_STATE          0x6         // XCR0[2:1] - OS saves both XMM and YMM registers on context switch
+
         uint features = 0;
 
         // Supports CPUID instruction ?
@@ -320,7 +367,8 @@ namespace Ogre {
             CpuidResult result;
 
             // Has standard feature ?
-            if (_performCpuid(CPUID_FUNC_VENDOR_ID, result))
+            const uint maxStandardFunctionSupport = _performCpuid(CPUID_FUNC_VENDOR_ID, result);
+            if (maxStandardFunctionSupport)
             {
                 // Check vendor strings
                 if (memcmp(&result._ebx, "GenuineIntel", 12) == 0)
@@ -416,6 +464,26 @@ namespace Ogre {
                             features |= PlatformInformation::CPU_FEATURE_INVARIANT_TSC;
                     }
                 }
+
+                // AVX family, vendor independent. The YMM state must be saved by
+                // the OS too, otherwise any AVX instruction raises #UD.
+                _performCpuid(CPUID_FUNC_STANDARD_FEATURES, result);
+                if ((result._ecx & CPUID_STD_OSXSAVE) && (result._ecx & CPUID_STD_AVX) &&
+                    (_readExtendedControlRegister() & XCR0_SSE_AVX_STATE) == XCR0_SSE_AVX_STATE)
+                {
+                    features |= PlatformInformation::CPU_FEATURE_AVX;
+
+                    if (result._ecx & CPUID_STD_FMA)
+                        features |= PlatformInformation::CPU_FEATURE_FMA;
+
+                    if (maxStandardFunctionSupport >= CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES)
+                    {
+                        _performCpuid(CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES, result, 0);
+
+                        if (result._ebx & CPUID_SEF_AVX2)
+                            features |= PlatformInformation::CPU_FEATURE_AVX2;
+                    }
+                }
             }
         }
 
@@ -431,7 +499,10 @@ namespace Ogre {
             | PlatformInformation::CPU_FEATURE_SSE2
             | PlatformInformation::CPU_FEATURE_SSE3
             | PlatformInformation::CPU_FEATURE_SSE41
-            | PlatformInformation::CPU_FEATURE_SSE42;
+            | PlatformInformation::CPU_FEATURE_SSE42
+            | PlatformInformation::CPU_FEATURE_AVX
+            | PlatformInformation::CPU_FEATURE_AVX2
+            | PlatformInformation::CPU_FEATURE_FMA;
 
         if ((features & sse_features) && !_checkOperatingSystemSupportSSE())
         {
@@ -575,7 +646,7 @@ namespace Ogre {
     {
         // Use preprocessor definitions to determine architecture and CPU features
         uint features = 0;
-#if defined(__ARM_NEON__)
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
         int hasNEON;
         size_t len = sizeof(size_t);
@@ -725,6 +796,12 @@ namespace Ogre {
                 " *          PRO: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_PRO), true));
             pLog->logMessage(
                 " *           HT: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_HTT), true));
+            pLog->logMessage(
+                " *          AVX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX), true));
+            pLog->logMessage(
+                " *         AVX2: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX2), true));
+            pLog->logMessage(
+                " *          FMA: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_FMA), true));
         }
 #elif OGRE_CPU == OGRE_CPU_ARM || OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
         pLog->logMessage(
@@ -32,7 +32,7 @@ THE SOFTWARE.
 namespace Ogre {
     //---------------------------------------------------------------------
     Pose::Pose(ushort target, const String& name)
-        : mTarget(target), mName(name)
+        : mTarget(target), mName(name), mPackedDirty(true)
     {
     }
     //---------------------------------------------------------------------
@@ -50,6 +50,7 @@ namespace Ogre {
 
         mVertexOffsetMap[index] = offset;
         mBuffer.reset();
+        mPackedDirty = true;
     }
     //---------------------------------------------------------------------
     void Pose::addVertex(size_t index, const Vector3& offset, const Vector3& normal)
@@ -67,6 +68,7 @@ namespace Ogre {
         mVertexOffsetMap[index] = offset;
         mNormalsMap[index] = normal;
         mBuffer.reset();
+        mPackedDirty = true;
     }
     //---------------------------------------------------------------------
     void Pose::removeVertex(size_t index)
@@ -76,6 +78,7 @@ namespace Ogre {
         {
             mVertexOffsetMap.erase(i);
             mBuffer.reset();
+            mPackedDirty = true;
         }
         NormalsMap::iterator j = mNormalsMap.find(index);
         if (j != mNormalsMap.end())
@@ -89,6 +92,7 @@ namespace Ogre {
         mVertexOffsetMap.clear();
         mNormalsMap.clear();
         mBuffer.reset();
+        mPackedDirty = true;
     }
     //---------------------------------------------------------------------
     Pose::ConstVertexOffsetIterator 
@@ -100,6 +104,8 @@ namespace Ogre {
     Pose::VertexOffsetIterator 
         Pose::getVertexOffsetIterator(void)
     {
+        // The offsets may be modified through the iterator
+        mPackedDirty = true;
         return VertexOffsetIterator(mVertexOffsetMap.begin(), mVertexOffsetMap.end());
     }
     //---------------------------------------------------------------------
@@ -110,6 +116,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     Pose::NormalsIterator Pose::getNormalsIterator(void)
     {
+        mPackedDirty = true;
         return NormalsIterator(mNormalsMap.begin(), mNormalsMap.end());
     }
     //---------------------------------------------------------------------
@@ -187,6 +194,54 @@ namespace Ogre {
         return mBuffer;
     }
     //---------------------------------------------------------------------
+    void Pose::packVertices(void) const
+    {
+        mPackedIndexes.clear();
+        mPackedOffsets.clear();
+        mPackedNormals.clear();
+        mPackedIndexes.reserve(mVertexOffsetMap.size());
+        mPackedOffsets.reserve(mVertexOffsetMap.size() * 3);
+        mPackedNormals.reserve(mNormalsMap.size() * 3);
+
+        // Both maps hold the same vertices, if there are normals
+        for (VertexOffsetMap::const_iterator v = mVertexOffsetMap.begin();
+            v != mVertexOffsetMap.end(); ++v)
+        {
+            mPackedIndexes.push_back(static_cast<uint32>(v->first));
+            mPackedOffsets.push_back(v->second.x);
+            mPackedOffsets.push_back(v->second.y);
+            mPackedOffsets.push_back(v->second.z);
+        }
+        for (NormalsMap::const_iterator n = mNormalsMap.begin(); n != mNormalsMap.end(); ++n)
+        {
+            mPackedNormals.push_back(n->second.x);
+            mPackedNormals.push_back(n->second.y);
+            mPackedNormals.push_back(n->second.z);
+        }
+        mPackedDirty = false;
+    }
+    //---------------------------------------------------------------------
+    const vector<uint32>::type& Pose::_getPackedIndexes(void) const
+    {
+        if (mPackedDirty)
+            packVertices();
+        return mPackedIndexes;
+    }
+    //---------------------------------------------------------------------
+    const vector<float>::type& Pose::_getPackedOffsets(void) const
+    {
+        if (mPackedDirty)
+            packVertices();
+        return mPackedOffsets;
+    }
+    //---------------------------------------------------------------------
+    const vector<float>::type& Pose::_getPackedNormals(void) const
+    {
+        if (mPackedDirty)
+            packVertices();
+        return mPackedNormals;
+    }
+    //---------------------------------------------------------------------
     Pose* Pose::clone(void) const
     {
         Pose* newPose = OGRE_NEW Pose(mTarget, mName);
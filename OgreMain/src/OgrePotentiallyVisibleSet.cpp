@@ -0,0 +1,282 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgrePotentiallyVisibleSet.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    PotentiallyVisibleSet::PotentiallyVisibleSet()
+        : mGrid(false)
+        , mCellCount(0)
+        , mCellSize(Vector3::ZERO)
+        , mRowWords(0)
+    {
+        mDivisions[0] = mDivisions[1] = mDivisions[2] = 0;
+    }
+    //-----------------------------------------------------------------------
+    void PotentiallyVisibleSet::setGrid(const AxisAlignedBox& bounds, uint32 divisionsX,
+        uint32 divisionsY, uint32 divisionsZ)
+    {
+        if (!bounds.isFinite() || !divisionsX || !divisionsY || !divisionsZ)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "The grid needs finite bounds and at least one cell along each axis",
+                "PotentiallyVisibleSet::setGrid");
+        }
+
+        mGrid = true;
+        mBounds = bounds;
+        mDivisions[0] = divisionsX;
+        mDivisions[1] = divisionsY;
+        mDivisions[2] = divisionsZ;
+        mCellSize = bounds.getSize() / Vector3(Real(divisionsX), Real(divisionsY), Real(divisionsZ));
+        mCellCount = size_t(divisionsX) * divisionsY * divisionsZ;
+        mNames.clear();
+        resetVisibility();
+    }
+    //-----------------------------------------------------------------------
+    void PotentiallyVisibleSet::setCellNames(const StringVector& names)
+    {
+        mGrid = false;
+        mBounds.setNull();
+        mDivisions[0] = mDivisions[1] = mDivisions[2] = 0;
+        mCellSize = Vector3::ZERO;
+        mNames = names;
+        mCellCount = names.size();
+        resetVisibility();
+    }
+    //-----------------------------------------------------------------------
+    void PotentiallyVisibleSet::clear(void)
+    {
+        setCellNames(StringVector());
+    }
+    //-----------------------------------------------------------------------
+    void PotentiallyVisibleSet::resetVisibility(void)
+    {
+        mRowWords = (mCellCount + 31) / 32;
+        mBits.assign(mCellCount * mRowWords, 0);
+        for (size_t i = 0; i < mCellCount; ++i)
+            setVisible(i, i);
+    }
+    //-----------------------------------------------------------------------
+    AxisAlignedBox PotentiallyVisibleSet::getCellBounds(size_t cell) const
+    {
+        assert(mGrid && cell < mCellCount);
+        size_t x = cell % mDivisions[0];
+        size_t y = (cell / mDivisions[0]) % mDivisions[1];
+        size_t z = cell / (size_t(mDivisions[0]) * mDivisions[1]);
+        Vector3 minimum = mBounds.getMinimum() + mCellSize * Vector3(Real(x), Real(y), Real(z));
+        return AxisAlignedBox(minimum, minimum + mCellSize);
+    }
+    //-----------------------------------------------------------------------
+    const String& PotentiallyVisibleSet::getCellName(size_t cell) const
+    {
+        return cell < mNames.size() ? mNames[cell] : BLANKSTRING;
+    }
+    //-----------------------------------------------------------------------
+    size_t PotentiallyVisibleSet::getCell(const Vector3& position) const
+    {
+        if (!mGrid || !mBounds.contains(position))
+            return NO_CELL;
+
+        size_t index[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            Real offset = (position[axis] - mBounds.getMinimum()[axis]) / mCellSize[axis];
+            // Points on the maximum side belong to the last cell
+            index[axis] = std::min(static_cast<size_t>(offset), size_t(mDivisions[axis] - 1));
+        }
+        return index[0] + (index[1] + index[2] * mDivisions[1]) * mDivisions[0];
+    }
+    //-----------------------------------------------------------------------
+    size_t PotentiallyVisibleSet::getCell(const String& name) const
+    {
+        StringVector::const_iterator it = std::find(mNames.begin(), mNames.end(), name);
+        return it != mNames.end() ? static_cast<size_t>(it - mNames.begin()) : NO_CELL;
+    }
+    //-----------------------------------------------------------------------
+    void PotentiallyVisibleSet::setVisible(size_t from, size_t to, bool visible)
+    {
+        assert(from < mCellCount && to < mCellCount);
+        uint32& word = mBits[from * mRowWords + (to >> 5)];
+        if (visible)
+            word |= 1u << (to & 31);
+        else
+            word &= ~(1u << (to & 31));
+    }
+    //-----------------------------------------------------------------------
+    bool PotentiallyVisibleSet::isVisible(size_t from, const AxisAlignedBox& box) const
+    {
+        if (box.isNull())
+            return false;
+        if (!mGrid || !mBounds.contains(box))
+            return true;
+
+        size_t first[3], last[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            Real minimum = (box.getMinimum()[axis] - mBounds.getMinimum()[axis]) / mCellSize[axis];
+            Real maximum = (box.getMaximum()[axis] - mBounds.getMinimum()[axis]) / mCellSize[axis];
+            first[axis] = std::min(static_cast<size_t>(minimum), size_t(mDivisions[axis] - 1));
+            last[axis] = std::min(static_cast<size_t>(maximum), size_t(mDivisions[axis] - 1));
+        }
+
+        const uint32* row = &mBits[from * mRowWords];
+        for (size_t z = first[2]; z <= last[2]; ++z)
+        {
+            for (size_t y = first[1]; y <= last[1]; ++y)
+            {
+                size_t cell = (y + z * mDivisions[1]) * mDivisions[0];
+                for (size_t x = first[0]; x <= last[0]; ++x)
+                {
+                    if (row[(cell + x) >> 5] & (1u << ((cell + x) & 31)))
+                        return true;
+                }
+            }
+        }
+        return false;
+    }
+    //-----------------------------------------------------------------------
+    size_t PotentiallyVisibleSet::getVisibleCount(size_t from) const
+    {
+        size_t count = 0;
+        for (size_t to = 0; to < mCellCount; ++to)
+            count += isVisible(from, to);
+        return count;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    PotentiallyVisibleSetSerializer::PotentiallyVisibleSetSerializer()
+    {
+        mVersion = "[PotentiallyVisibleSetSerializer_v1.00]";
+    }
+    //-----------------------------------------------------------------------
+    void PotentiallyVisibleSetSerializer::exportPVS(const PotentiallyVisibleSet* pvs,
+        const String& filename, Endian endianMode)
+    {
+        std::fstream *f = OGRE_NEW_T(std::fstream, MEMCATEGORY_GENERAL)();
+        f->open(filename.c_str(), std::ios::binary | std::ios::out);
+        DataStreamPtr stream(OGRE_NEW FileStreamDataStream(f));
+
+        exportPVS(pvs, stream, endianMode);
+
+        stream->close();
+    }
+    //-----------------------------------------------------------------------
+    void PotentiallyVisibleSetSerializer::exportPVS(const PotentiallyVisibleSet* pvs,
+        DataStreamPtr stream, Endian endianMode)
+    {
+        determineEndianness(endianMode);
+
+        mStream = stream;
+        if (!stream->isWriteable())
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Unable to write to stream " + stream->getName(),
+                "PotentiallyVisibleSetSerializer::exportPVS");
+        }
+
+        writeFileHeader();
+
+        uint32 cellCount = static_cast<uint32>(pvs->getCellCount());
+        writeInts(&cellCount, 1);
+        bool grid = pvs->isGrid();
+        writeBools(&grid, 1);
+        if (grid)
+        {
+            writeObject(pvs->getGridBounds().getMinimum());
+            writeObject(pvs->getGridBounds().getMaximum());
+            uint32 divisions[3] = { pvs->getGridDivisions(0), pvs->getGridDivisions(1),
+                pvs->getGridDivisions(2) };
+            writeInts(divisions, 3);
+        }
+        else
+        {
+            for (size_t i = 0; i < cellCount; ++i)
+                writeString(pvs->getCellName(i));
+        }
+
+        // One row of bits per cell
+        vector<uint32>::type row((cellCount + 31) / 32);
+        for (size_t from = 0; from < cellCount; ++from)
+        {
+            std::fill(row.begin(), row.end(), 0);
+            for (size_t to = 0; to < cellCount; ++to)
+            {
+                if (pvs->isVisible(from, to))
+                    row[to >> 5] |= 1u << (to & 31);
+            }
+            if (!row.empty())
+                writeInts(&row[0], row.size());
+        }
+
+    }
+    //-----------------------------------------------------------------------
+    void PotentiallyVisibleSetSerializer::importPVS(DataStreamPtr& stream, PotentiallyVisibleSet* pDest)
+    {
+        // Determine endianness (must be the first thing we do!)
+        determineEndianness(stream);
+        readFileHeader(stream);
+
+        uint32 cellCount;
+        readInts(stream, &cellCount, 1);
+        bool grid;
+        readBools(stream, &grid, 1);
+        if (grid)
+        {
+            Vector3 minimum, maximum;
+            readObject(stream, minimum);
+            readObject(stream, maximum);
+            uint32 divisions[3];
+            readInts(stream, divisions, 3);
+            pDest->setGrid(AxisAlignedBox(minimum, maximum), divisions[0], divisions[1], divisions[2]);
+            if (pDest->getCellCount() != cellCount)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "The grid of " + stream->getName() + " does not match its cell count",
+                    "PotentiallyVisibleSetSerializer::importPVS");
+            }
+        }
+        else
+        {
+            StringVector names(cellCount);
+            for (size_t i = 0; i < cellCount; ++i)
+                names[i] = readString(stream);
+            pDest->setCellNames(names);
+        }
+
+        vector<uint32>::type row((cellCount + 31) / 32);
+        for (size_t from = 0; from < cellCount; ++from)
+        {
+            if (!row.empty())
+                readInts(stream, &row[0], row.size());
+            for (size_t to = 0; to < cellCount; ++to)
+                pDest->setVisible(from, to, (row[to >> 5] & (1u << (to & 31))) != 0);
+        }
+    }
+}
@@ -44,12 +44,194 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #include "OgreLogManager.h"
 #include "OgreRoot.h"
 #include "OgreRenderSystem.h"
+#include "OgreHardwareTimerQuery.h"
+#include "OgreStringConverter.h"
 
 namespace Ogre {
+    namespace
+    {
+        /// The beginning or the end of a profile
+        struct ProfileEvent
+        {
+            ulong time;
+            uint32 markerID;
+            bool end;
+        };
+
+        /// Parent index of GPU timers not nested in another timer
+        const size_t NO_PARENT = ~size_t(0);
+        /// The number of frames GPU timers wait for their results before we stall for them
+        const size_t GPU_TIMER_LATENCY = 4;
+
+        /// A profile opened in the profile tree, waiting for its end
+        struct OpenProfile
+        {
+            /// The instance of the profile, null if it is disabled
+            ProfileInstance* instance;
+            /// The instance nested profiles are added to
+            ProfileInstance* current;
+            ulong startTime;
+        };
+
+        /// The events of one thread, written by that thread and read by the 
+        /// Profiler when the frame ends
+        class ProfileEventBuffer : public ProfilerAlloc
+        {
+        public:
+            static const size_t CAPACITY = 16384;
+
+            vector<ProfileEvent>::type events;
+            AtomicScalar<size_t> head;
+            AtomicScalar<size_t> tail;
+            /// Profiles recorded and skipped by the thread but not yet ended
+            size_t openCount;
+            size_t skipCount;
+
+            /// The profiles of the thread open in the profile tree
+            vector<OpenProfile>::type openProfiles;
+            /// The profile collecting the profiles of the thread
+            String name;
+
+            ProfileEventBuffer(const String& threadName)
+                : events(CAPACITY)
+                , head(0)
+                , tail(0)
+                , openCount(0)
+                , skipCount(0)
+                , name(threadName)
+            {
+            }
+
+            void record(uint32 markerID, bool end, ulong time)
+            {
+                const size_t used = head.load() - tail.load();
+                if (!end)
+                {
+                    // keep room for the ends of all open profiles, when the buffer
+                    // is full whole profiles are dropped
+                    if (skipCount || used + openCount + 2 > CAPACITY)
+                    {
+                        ++skipCount;
+                        return;
+                    }
+                    ++openCount;
+                }
+                else if (skipCount)
+                {
+                    --skipCount;
+                    return;
+                }
+                else if (openCount)
+                {
+                    --openCount;
+                }
+                else if (used >= CAPACITY)
+                {
+                    return;
+                }
+
+                const size_t index = head.load();
+                ProfileEvent& event = events[index % CAPACITY];
+                event.time = time;
+                event.markerID = markerID;
+                event.end = end;
+                head.store(index + 1);
+            }
+
+            /// Drops the recorded events, called by the Profiler
+            void discard()
+            {
+                tail.store(head.load());
+                openProfiles.clear();
+            }
+        };
+
+        /// All buffers, buffers of finished threads are handed to new threads
+        vector<ProfileEventBuffer*>::type sEventBuffers;
+        vector<ProfileEventBuffer*>::type sFreeEventBuffers;
+        OGRE_WQ_STATIC_MUTEX(sEventBuffersMutex);
+
+        /// The buffer of the thread which created the Profiler
+        ProfileEventBuffer* sMainEventBuffer = 0;
+
+        /// Thread local owner of the buffer of a thread, handing it back 
+        /// when the thread finishes
+        class ProfileEventBufferHandle : public ProfilerAlloc
+        {
+        public:
+            ProfileEventBuffer* buffer;
+
+            ProfileEventBufferHandle()
+            {
+                OGRE_WQ_LOCK_MUTEX(sEventBuffersMutex);
+                if (sFreeEventBuffers.empty())
+                {
+                    buffer = OGRE_NEW ProfileEventBuffer(
+                        "Thread " + StringConverter::toString(sEventBuffers.size()));
+                    sEventBuffers.push_back(buffer);
+                }
+                else
+                {
+                    buffer = sFreeEventBuffers.back();
+                    sFreeEventBuffers.pop_back();
+                }
+            }
+
+            ~ProfileEventBufferHandle()
+            {
+                OGRE_WQ_LOCK_MUTEX(sEventBuffersMutex);
+                sFreeEventBuffers.push_back(buffer);
+            }
+        };
+
+        OGRE_WQ_THREAD_POINTER_VAR(ProfileEventBufferHandle, sEventBuffer);
+
+        ProfileEventBuffer* getEventBuffer()
+        {
+            ProfileEventBufferHandle* handle = OGRE_WQ_THREAD_POINTER_GET(sEventBuffer);
+            if (!handle)
+            {
+                handle = OGRE_NEW ProfileEventBufferHandle();
+                OGRE_WQ_THREAD_POINTER_SET(sEventBuffer, handle);
+            }
+            return handle->buffer;
+        }
+
+        /// The names of the markers, indexed by their ID
+        struct MarkerRegistry
+        {
+            vector<String>::type names;
+            map<String, uint32>::type ids;
+            OGRE_WQ_MUTEX(mutex);
+        };
+
+        MarkerRegistry& getMarkerRegistry()
+        {
+            // constructed on first use, markers are static objects themselves
+            static MarkerRegistry registry;
+            return registry;
+        }
+
+        uint32 registerMarker(const String& name)
+        {
+            MarkerRegistry& registry = getMarkerRegistry();
+            OGRE_WQ_LOCK_MUTEX(registry.mutex);
+
+            map<String, uint32>::type::iterator it = registry.ids.find(name);
+            if (it != registry.ids.end())
+                return it->second;
+
+            const uint32 id = static_cast<uint32>(registry.names.size());
+            registry.names.push_back(name);
+            registry.ids[name] = id;
+            return id;
+        }
+    }
     //-----------------------------------------------------------------------
     // PROFILE DEFINITIONS
     //-----------------------------------------------------------------------
     template<> Profiler* Singleton<Profiler>::msSingleton = 0;
+    AtomicScalar<uint32> Profiler::msRecordMask(0);
     Profiler* Profiler::getSingletonPtr(void)
     {
         return msSingleton;
@@ -71,17 +253,25 @@ namespace Ogre {
         Ogre::Profiler::getSingleton().endProfile(mName, mGroupID);
     }
     //-----------------------------------------------------------------------
+    ProfileMarker::ProfileMarker(const char* name, uint32 groupID)
+        : mID(registerMarker(name))
+        , mGroupID(groupID)
+    {
+        // empty string is reserved for the root
+        assert (name[0] && "Profile name can't be an empty string");
+    }
+    //-----------------------------------------------------------------------
 
 
     //-----------------------------------------------------------------------
     // PROFILER DEFINITIONS
     //-----------------------------------------------------------------------
     Profiler::Profiler() 
-        : mCurrent(&mRoot)
-        , mLast(NULL)
-        , mRoot()
+        : mRoot()
+        , mGPUTimersSupported(true)
         , mInitialized(false)
         , mUpdateDisplayFrequency(10)
+        , mFrameDepth(0)
         , mCurrentFrame(0)
         , mTimer(0)
         , mTotalFrameTime(0)
@@ -93,6 +283,7 @@ namespace Ogre {
         , mResetExtents(false)
     {
         mRoot.hierarchicalLvl = 0 - 1;
+        sMainEventBuffer = getEventBuffer();
     }
     //-----------------------------------------------------------------------
     ProfileInstance::ProfileInstance(void)
@@ -127,12 +318,29 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     Profiler::~Profiler()
     {
+        msRecordMask.store(0);
+
         if (!mRoot.children.empty()) 
         {
             // log the results of our profiling before we quit
             logResults();
         }
 
+        // the open profiles point into our tree, buffers of finished threads can go
+        {
+            OGRE_WQ_LOCK_MUTEX(sEventBuffersMutex);
+            for (size_t i = 0; i < sFreeEventBuffers.size(); ++i)
+            {
+                sEventBuffers.erase(std::find(sEventBuffers.begin(), sEventBuffers.end(), sFreeEventBuffers[i]));
+                OGRE_DELETE sFreeEventBuffers[i];
+            }
+            sFreeEventBuffers.clear();
+
+            for (size_t i = 0; i < sEventBuffers.size(); ++i)
+                sEventBuffers[i]->discard();
+        }
+        sMainEventBuffer = 0;
+
         // clear all our lists
         mDisabledProfiles.clear();
     }
@@ -164,6 +372,7 @@ namespace Ogre {
 
             mInitialized = false;
             mEnabled = false;
+            msRecordMask.store(0);
         }
         // We store this enable/disable request until the frame ends
         // (don't want to screw up any open profiles!)
@@ -180,7 +389,25 @@ namespace Ogre {
         for( TProfileSessionListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
             (*i)->changeEnableState(mNewEnableState);
 
+        if (mNewEnableState)
+        {
+            // drop what was left over from the last time we were enabled
+            OGRE_WQ_LOCK_MUTEX(sEventBuffersMutex);
+            for (size_t i = 0; i < sEventBuffers.size(); ++i)
+                sEventBuffers[i]->discard();
+            mGPUEvents.clear();
+            discardGPUTimers();
+        }
+
         mEnabled = mNewEnableState;
+        msRecordMask.store(mEnabled ? mProfileMask : 0);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::setProfileGroupMask(uint32 mask)
+    {
+        mProfileMask = mask;
+        if (mEnabled)
+            msRecordMask.store(mask);
     }
     //-----------------------------------------------------------------------
     void Profiler::disableProfile(const String& profileName)
@@ -194,11 +421,30 @@ namespace Ogre {
         mDisabledProfiles.erase(profileName);
     }
     //-----------------------------------------------------------------------
+    uint32 Profiler::getMarkerID(const String& profileName)
+    {
+        MarkerIDMap::iterator it = mMarkerIDs.find(profileName);
+        if (it == mMarkerIDs.end())
+            it = mMarkerIDs.insert(MarkerIDMap::value_type(profileName, registerMarker(profileName))).first;
+        return it->second;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::_recordEvent(uint32 markerID, bool end)
+    {
+        ProfileEventBuffer* buffer = getEventBuffer();
+
+        // need a timer to profile!
+        assert (msSingleton && msSingleton->mTimer && "Timer not set!");
+
+        buffer->record(markerID, end, msSingleton->mTimer->getMicroseconds());
+    }
+    //-----------------------------------------------------------------------
     void Profiler::beginProfile(const String& profileName, uint32 groupID) 
     {
-        // regardless of whether or not we are enabled, we need the application's root profile (ie the first profile started each frame)
-        // we need this so bogus profiles don't show up when users enable profiling mid frame
-        // so we check
+        // regardless of whether or not we are enabled, we keep track of the application's
+        // root profile (ie the first profile started each frame), so enabling or disabling
+        // the profiler only takes effect between frames
+        ++mFrameDepth;
 
         // if the profiler is enabled
         if (!mEnabled) 
@@ -208,175 +454,337 @@ namespace Ogre {
         if ((groupID & mProfileMask) == 0)
             return;
 
-        // we only process this profile if isn't disabled
-        if (mDisabledProfiles.find(profileName) != mDisabledProfiles.end()) 
-            return;
-
         // empty string is reserved for the root
         // not really fatal anymore, however one shouldn't name one's profile as an empty string anyway.
         assert ((profileName != "") && ("Profile name can't be an empty string"));
 
-        // this would be an internal error.
-        assert (mCurrent);
-
-        // need a timer to profile!
-        assert (mTimer && "Timer not set!");
+        _recordEvent(getMarkerID(profileName), false);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::endProfile(const String& profileName, uint32 groupID) 
+    {
+        if (mEnabled && (groupID & mProfileMask) != 0)
+        {
+            // empty string is reserved for designating an empty parent
+            assert ((profileName != "") && ("Profile name can't be an empty string"));
 
-        ProfileInstance*& instance = mCurrent->children[profileName];
-        if(instance)
-        {   // found existing child.
+            _recordEvent(getMarkerID(profileName), true);
+        }
 
-            // Sanity check.
-            assert(instance->name == profileName);
+        if (mFrameDepth == 0 || --mFrameDepth > 0)
+            return;
 
-            if(instance->frameNumber != mCurrentFrame)
-            {   // new frame, reset stats
-                instance->frame.calls = 0;
-                instance->frame.frameTime = 0;
-                instance->frameNumber = mCurrentFrame;
-            }
-        }
-        else
-        {   // new child!
-            instance = OGRE_NEW ProfileInstance();
-            instance->name = profileName;
-            instance->parent = mCurrent;
-            instance->hierarchicalLvl = mCurrent->hierarchicalLvl + 1;
-        }
+        // the stack is empty and all the profiles have been completed
+        // we have reached the end of the frame so process the frame statistics
+        if (mEnabled)
+        {
+            processEvents();
+            processGPUTimers();
 
-        instance->frameNumber = mCurrentFrame;
+            // we got all the information we need, so process the profiles
+            // for this frame
+            processFrameStats();
 
-        mCurrent = instance;
+            // we display everything to the screen
+            displayResults();
+        }
 
-        // we do this at the very end of the function to get the most
-        // accurate timing results
-        mCurrent->currTime = mTimer->getMicroseconds();
+        // if the profiler received a request to be enabled or disabled
+        if (mNewEnableState != mEnabled)
+            changeEnableState();
     }
     //-----------------------------------------------------------------------
-    void Profiler::endProfile(const String& profileName, uint32 groupID) 
+    void Profiler::processEvents(void)
     {
-        if(!mEnabled) 
-        {
-            // if the profiler received a request to be enabled or disabled
-            if(mNewEnableState != mEnabled) 
-            {   // note mNewEnableState == true to reach this.
-                changeEnableState();
-
-                // NOTE we will be in an 'error' state until the next begin. ie endProfile will likely get invoked using a profileName that was never started.
-                // even then, we can't be sure that the next beginProfile will be the true start of a new frame
-            }
+        OGRE_WQ_LOCK_MUTEX(sEventBuffersMutex);
+        MarkerRegistry& registry = getMarkerRegistry();
+        OGRE_WQ_LOCK_MUTEX(registry.mutex);
 
-            return;
-        }
-        else
+        for (size_t i = 0; i < sEventBuffers.size(); ++i)
         {
-            if(mNewEnableState != mEnabled) 
-            {   // note mNewEnableState == false to reach this.
-                changeEnableState();
+            ProfileEventBuffer* buffer = sEventBuffers[i];
+            vector<OpenProfile>::type& openProfiles = buffer->openProfiles;
+            // profiles of other threads are collected under one profile per thread
+            ProfileInstance* threadRoot = buffer == sMainEventBuffer ? &mRoot : 0;
 
-                // unwind the hierarchy, should be easy enough
-                mCurrent = &mRoot;
-                mLast = NULL;
-            }
-
-            if(&mRoot == mCurrent && mLast)
-            {   // profiler was enabled this frame, but the first subsequent beginProfile was NOT the beinging of a new frame as we had hoped.
-                // we have a bogus ProfileInstance in our hierarchy, we will need to remove it, then update the overlays so as not to confuse ze user
+            const size_t head = buffer->head.load();
+            for (size_t tail = buffer->tail.load(); tail != head; ++tail)
+            {
+                const ProfileEvent& event = buffer->events[tail % ProfileEventBuffer::CAPACITY];
 
-                // we could use mRoot.children.find() instead of this, except we'd be compairing strings instead of a pointer.
-                // the string way could be faster, but i don't believe it would.
-                ProfileChildren::iterator it = mRoot.children.begin(), endit = mRoot.children.end();
-                for(;it != endit; ++it)
+                if (!event.end)
                 {
-                    if(mLast == it->second)
+                    OpenProfile open;
+                    open.instance = 0;
+                    open.startTime = event.time;
+
+                    if (openProfiles.empty())
                     {
-                        mRoot.children.erase(it);
-                        break;
+                        if (!threadRoot)
+                            threadRoot = getChild(&mRoot, buffer->name);
+                        open.current = threadRoot;
                     }
+                    else
+                    {
+                        open.current = openProfiles.back().current;
+                    }
+
+                    // we only process this profile if isn't disabled
+                    const String& name = registry.names[event.markerID];
+                    if (mDisabledProfiles.find(name) == mDisabledProfiles.end())
+                        open.instance = open.current = getChild(open.current, name);
+
+                    openProfiles.push_back(open);
                 }
+                else if (!openProfiles.empty())
+                {
+                    const OpenProfile open = openProfiles.back();
+                    openProfiles.pop_back();
+
+                    if (!open.instance)
+                        continue;
+
+                    // calculate the elapsed time of this profile
+                    const ulong timeElapsed = event.time - open.startTime;
+                    ProfileInstance* parent = open.instance->parent;
 
-                // with mLast == NULL we won't reach this code, in case this isn't the end of the top level profile
-                ProfileInstance* last = mLast;
-                mLast = NULL;
-                OGRE_DELETE last;
+                    notifyProfileRecorded(open.instance->name, 
+                        buffer == sMainEventBuffer ? "Main" : buffer->name, open.startTime, event.time);
 
-                processFrameStats();
-                displayResults();
+                    addFrameTime(open.instance, timeElapsed);
+
+                    if (parent != &mRoot)
+                    {
+                        // add this profile's time to the parent's accumlator
+                        parent->accum += timeElapsed;
+                    }
+
+                    if (openProfiles.empty())
+                    {
+                        if (parent == &mRoot)
+                        {
+                            // we know that the time elapsed of the main loop is the total time the frame took
+                            mTotalFrameTime = timeElapsed;
+
+                            if(timeElapsed > mMaxTotalFrameTime)
+                                mMaxTotalFrameTime = timeElapsed;
+                        }
+                        else
+                        {
+                            // the thread profile sums up the time of its profiles
+                            addFrameTime(parent, timeElapsed);
+                        }
+                    }
+                }
             }
+            buffer->tail.store(head);
+
+            // profiles of the main thread all end with the frame, other threads
+            // may be in the middle of a profile
+            if (buffer == sMainEventBuffer)
+                openProfiles.clear();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::notifyProfileRecorded(const String& profileName, const String& threadName,
+                                         ulong startTime, ulong endTime)
+    {
+        for (TProfileSessionListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i)
+            (*i)->profileRecorded(profileName, threadName, startTime, endTime);
+    }
+    //-----------------------------------------------------------------------
+    ProfileInstance* Profiler::getChild(ProfileInstance* parent, const String& profileName)
+    {
+        ProfileInstance*& instance = parent->children[profileName];
+        if (!instance)
+        {   // new child!
+            instance = OGRE_NEW ProfileInstance();
+            instance->name = profileName;
+            instance->parent = parent;
+            instance->hierarchicalLvl = parent->hierarchicalLvl + 1;
+        }
+        return instance;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::addFrameTime(ProfileInstance* instance, ulong timeElapsed)
+    {
+        if (instance->frameNumber != mCurrentFrame)
+        {   // new frame, reset stats
+            instance->frame.calls = 0;
+            instance->frame.frameTime = 0;
+            instance->frameNumber = mCurrentFrame;
         }
 
-        if(&mRoot == mCurrent)
-            return;
+        instance->frame.frameTime += timeElapsed;
+        ++instance->frame.calls;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::beginGPUEvent(const String& event)
+    {
+        Root::getSingleton().getRenderSystem()->beginProfileEvent(event);
 
-        // mask groups
-        if ((groupID & mProfileMask) == 0)
-            return;
+        // keep track of the region for the listeners recording timelines
+        if (_isRecording(OGREPROF_RENDERING))
+            mGPUEvents.push_back(GPUEventStack::value_type(event, mTimer->getMicroseconds()));
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::endGPUEvent(const String& event)
+    {
+        Root::getSingleton().getRenderSystem()->endProfileEvent();
 
-        // need a timer to profile!
-        assert (mTimer && "Timer not set!");
+        if (!mGPUEvents.empty())
+        {
+            notifyProfileRecorded(mGPUEvents.back().first, "GPU events", 
+                mGPUEvents.back().second, mTimer->getMicroseconds());
+            mGPUEvents.pop_back();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::markGPUEvent(const String& event)
+    {
+        Root::getSingleton().getRenderSystem()->markProfileEvent(event);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::beginGPUTimer(const String& timerName)
+    {
+        HardwareTimerQuery* query = getGPUTimer();
+        if (!query)
+            return;
 
-        // get the end time of this profile
-        // we do this as close the beginning of this function as possible
-        // to get more accurate timing results
-        const ulong endTime = mTimer->getMicroseconds();
+        if (mGPUTimerFrames.empty())
+            mGPUTimerFrames.push_back(GPUTimerFrame());
+        GPUTimerFrame& frame = mGPUTimerFrames.back();
 
-        // empty string is reserved for designating an empty parent
-        assert ((profileName != "") && ("Profile name can't be an empty string"));
+        GPUTimerSample sample;
+        sample.name = timerName;
+        sample.parent = mGPUTimerStack.empty() ? NO_PARENT : mGPUTimerStack.back();
+        sample.begin = query;
+        sample.end = 0;
 
-        // we only process this profile if isn't disabled
-        // we check the current instance name against the provided profileName as a guard against disabling a profile name /after/ said profile began
-        if(mCurrent->name != profileName && mDisabledProfiles.find(profileName) != mDisabledProfiles.end()) 
+        query->queryTimestamp();
+        mGPUTimerStack.push_back(frame.size());
+        frame.push_back(sample);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::endGPUTimer(void)
+    {
+        if (mGPUTimerStack.empty())
             return;
 
-        // calculate the elapsed time of this profile
-        const ulong timeElapsed = endTime - mCurrent->currTime;
-
-        // update parent's accumulator if it isn't the root
-        if (&mRoot != mCurrent->parent) 
+        HardwareTimerQuery* query = getGPUTimer();
+        if (query)
+        {
+            query->queryTimestamp();
+            mGPUTimerFrames.back()[mGPUTimerStack.back()].end = query;
+        }
+        mGPUTimerStack.pop_back();
+    }
+    //-----------------------------------------------------------------------
+    HardwareTimerQuery* Profiler::getGPUTimer(void)
+    {
+        if (!mFreeGPUTimers.empty())
         {
-            // add this profile's time to the parent's accumlator
-            mCurrent->parent->accum += timeElapsed;
+            HardwareTimerQuery* query = mFreeGPUTimers.back();
+            mFreeGPUTimers.pop_back();
+            return query;
         }
 
-        mCurrent->frame.frameTime += timeElapsed;
-        ++mCurrent->frame.calls;
+        if (!mGPUTimersSupported)
+            return 0;
+
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        HardwareTimerQuery* query = rs ? rs->createHardwareTimerQuery() : 0;
+        mGPUTimersSupported = query != 0;
+        return query;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::processGPUTimers(void)
+    {
+        if (mGPUTimerFrames.empty())
+            return;
 
-        mLast = mCurrent;
-        mCurrent = mCurrent->parent;
+        // timers left open are dropped with their end
+        mGPUTimerStack.clear();
+        mGPUTimerFrames.push_back(GPUTimerFrame());
 
-        if (&mRoot == mCurrent) 
+        // read back the frames the GPU is done with, oldest first
+        while (mGPUTimerFrames.size() > 1)
         {
-            // the stack is empty and all the profiles have been completed
-            // we have reached the end of the frame so process the frame statistics
+            GPUTimerFrame& frame = mGPUTimerFrames.front();
 
-            // we know that the time elapsed of the main loop is the total time the frame took
-            mTotalFrameTime = timeElapsed;
+            // once a frame is too old we rather wait than let the queries pile up
+            bool outstanding = false;
+            for (size_t i = 0; i < frame.size() && mGPUTimerFrames.size() <= GPU_TIMER_LATENCY + 1; ++i)
+            {
+                if (frame[i].begin->isStillOutstanding() || (frame[i].end && frame[i].end->isStillOutstanding()))
+                {
+                    outstanding = true;
+                    break;
+                }
+            }
+            if (outstanding)
+                break;
 
-            if(timeElapsed > mMaxTotalFrameTime)
-                mMaxTotalFrameTime = timeElapsed;
+            ProfileInstance* gpuRoot = getChild(&mRoot, "GPU");
+            vector<ProfileInstance*>::type instances(frame.size(), 0);
 
-            // we got all the information we need, so process the profiles
-            // for this frame
-            processFrameStats();
+            for (size_t i = 0; i < frame.size(); ++i)
+            {
+                const GPUTimerSample& sample = frame[i];
+                ProfileInstance* parent = sample.parent == NO_PARENT ? gpuRoot : instances[sample.parent];
 
-            // we display everything to the screen
-            displayResults();
+                uint64 begin = 0, end = 0;
+                if (parent && sample.end &&
+                    sample.begin->pullTimestamp(&begin) && sample.end->pullTimestamp(&end) && end >= begin)
+                {
+                    // disabled timers pass their nested timers on to their parent
+                    if (mDisabledProfiles.find(sample.name) != mDisabledProfiles.end())
+                    {
+                        instances[i] = parent;
+                    }
+                    else
+                    {
+                        const ulong timeElapsed = ulong((end - begin) / 1000);
+                        instances[i] = getChild(parent, sample.name);
+                        addFrameTime(instances[i], timeElapsed);
+
+                        // the GPU profile sums up the time of the outermost timers
+                        if (parent == gpuRoot)
+                            addFrameTime(gpuRoot, timeElapsed);
+                    }
+                }
+
+                mFreeGPUTimers.push_back(sample.begin);
+                if (sample.end)
+                    mFreeGPUTimers.push_back(sample.end);
+            }
+
+            mGPUTimerFrames.pop_front();
         }
     }
     //-----------------------------------------------------------------------
-    void Profiler::beginGPUEvent(const String& event)
+    void Profiler::discardGPUTimers(void)
     {
-        Root::getSingleton().getRenderSystem()->beginProfileEvent(event);
-    }
-    //-----------------------------------------------------------------------
-    void Profiler::endGPUEvent(const String& event)
-    {
-        Root::getSingleton().getRenderSystem()->endProfileEvent();
+        for (size_t f = 0; f < mGPUTimerFrames.size(); ++f)
+        {
+            const GPUTimerFrame& frame = mGPUTimerFrames[f];
+            for (size_t i = 0; i < frame.size(); ++i)
+            {
+                mFreeGPUTimers.push_back(frame[i].begin);
+                if (frame[i].end)
+                    mFreeGPUTimers.push_back(frame[i].end);
+            }
+        }
+        mGPUTimerFrames.clear();
+        mGPUTimerStack.clear();
     }
     //-----------------------------------------------------------------------
-    void Profiler::markGPUEvent(const String& event)
+    void Profiler::_releaseGPUTimers(void)
     {
-        Root::getSingleton().getRenderSystem()->markProfileEvent(event);
+        // the render system deletes the queries, a new one may support them again
+        discardGPUTimers();
+        mFreeGPUTimers.clear();
+        mGPUTimersSupported = true;
     }
     //-----------------------------------------------------------------------
     void Profiler::processFrameStats(ProfileInstance* instance, Real& maxFrameTime)
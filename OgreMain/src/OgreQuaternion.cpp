@@ -36,6 +36,11 @@ THE SOFTWARE.
 
 #include "OgreQuaternion.h"
 #include "OgreMatrix3.h"
+#include "OgrePlatformInformation.h"
+
+#if OGRE_SIMD_MATH && __OGRE_HAVE_SSE
+#   include <xmmintrin.h>
+#endif
 
 
 namespace Ogre {
@@ -279,6 +284,26 @@ namespace Ogre {
         // NOTE:  Multiplication is not generally commutative, so in most
         // cases p*q != q*p.
 
+#if OGRE_SIMD_MATH && __OGRE_HAVE_SSE
+        // lanes hold w, x, y, z; each term multiplies one component of this
+        // quaternion with a shuffle of rkQ, the signs applied through a mask
+        const __m128 q = _mm_loadu_ps(&rkQ.w);
+        const __m128 signX = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+        const __m128 signY = _mm_set_ps(-0.0f, 0.0f, 0.0f, -0.0f);
+        const __m128 signZ = _mm_set_ps(0.0f, 0.0f, -0.0f, -0.0f);
+
+        __m128 r = _mm_mul_ps(_mm_set1_ps(w), q);
+        r = _mm_add_ps(r, _mm_xor_ps(_mm_mul_ps(_mm_set1_ps(x),
+            _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 3, 0, 1))), signX));
+        r = _mm_add_ps(r, _mm_xor_ps(_mm_mul_ps(_mm_set1_ps(y),
+            _mm_shuffle_ps(q, q, _MM_SHUFFLE(1, 0, 3, 2))), signY));
+        r = _mm_add_ps(r, _mm_xor_ps(_mm_mul_ps(_mm_set1_ps(z),
+            _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 1, 2, 3))), signZ));
+
+        Quaternion result;
+        _mm_storeu_ps(&result.w, r);
+        return result;
+#else
         return Quaternion
         (
             w * rkQ.w - x * rkQ.x - y * rkQ.y - z * rkQ.z,
@@ -286,6 +311,7 @@ namespace Ogre {
             w * rkQ.y + y * rkQ.w + z * rkQ.x - x * rkQ.z,
             w * rkQ.z + z * rkQ.w + x * rkQ.y - y * rkQ.x
         );
+#endif
     }
     //-----------------------------------------------------------------------
     Quaternion Quaternion::operator* (Real fScalar) const
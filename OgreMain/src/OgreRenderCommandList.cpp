@@ -0,0 +1,113 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreRenderCommandList.h"
+#include "OgrePass.h"
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    RenderCommandList::RenderCommandList()
+        : mContentHash(0)
+        , mPassSetGeneration(0)
+        , mValid(false)
+        , mRecording(false)
+    {
+    }
+    //-----------------------------------------------------------------------
+    RenderCommandList::~RenderCommandList()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::beginRecording(uint32 contentHash)
+    {
+        mCommands.clear();
+        mContentHash = contentHash;
+        mPassSetGeneration = Pass::getPassSetGeneration();
+        mValid = false;
+        mRecording = true;
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::endRecording(void)
+    {
+        if (mRecording)
+        {
+            mRecording = false;
+            // A pass may have changed while we were recording
+            mValid = mPassSetGeneration == Pass::getPassSetGeneration();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::abortRecording(void)
+    {
+        mCommands.clear();
+        mRecording = false;
+        mValid = false;
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::recordPass(const Pass* pass)
+    {
+        if (!mRecording)
+            return;
+
+        Command cmd;
+        cmd.pass = pass;
+        cmd.renderable = 0;
+        cmd.manualLightList = 0;
+        cmd.scissoring = false;
+        cmd.autoLights = false;
+        mCommands.push_back(cmd);
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::recordRenderable(Renderable* rend, bool scissoring,
+        bool autoLights, const LightList* manualLightList)
+    {
+        if (!mRecording)
+            return;
+
+        Command cmd;
+        cmd.pass = 0;
+        cmd.renderable = rend;
+        cmd.manualLightList = manualLightList;
+        cmd.scissoring = scissoring;
+        cmd.autoLights = autoLights;
+        mCommands.push_back(cmd);
+    }
+    //-----------------------------------------------------------------------
+    bool RenderCommandList::isValidFor(uint32 contentHash) const
+    {
+        return mValid && !mRecording && mContentHash == contentHash &&
+            mPassSetGeneration == Pass::getPassSetGeneration();
+    }
+    //-----------------------------------------------------------------------
+    void RenderCommandList::invalidate(void)
+    {
+        mValid = false;
+    }
+
+}
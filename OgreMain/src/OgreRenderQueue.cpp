@@ -37,6 +37,10 @@ THE SOFTWARE.
 #include "OgreMovableObject.h"
 #include "OgreSceneManagerEnumerator.h"
 #include "OgreTechnique.h"
+#include "OgreCamera.h"
+#include "OgreViewport.h"
+#include "OgreTextureManager.h"
+#include "Threading/OgreParallel.h"
 
 
 namespace Ogre {
@@ -46,7 +50,9 @@ namespace Ogre {
         : mSplitPassesByLightingType(false)
         , mSplitNoShadowPasses(false)
         , mShadowCastersCannotBeReceivers(false)
+        , mShadowCasterFilter(SCF_ALL)
         , mRenderableListener(0)
+        , mScreenSize(0)
     {
         // Create the 'main' queue up-front since we'll always need that
         mGroups.insert(
@@ -118,6 +124,9 @@ namespace Ogre {
             // tell material it's been used (incase changed)
             pTech->getParent()->touch();
         }
+
+        if (mScreenSize > 0)
+            notifyScreenSize(pTech);
         
         pGroup->addRenderable(pRend, pTech, priority);
 
@@ -290,6 +299,61 @@ namespace Ogre {
         }
     }
 
+    //---------------------------------------------------------------------
+    namespace
+    {
+        /// Sorts one priority group per index, see parallelFor
+        struct PriorityGroupSorter
+        {
+            const vector<RenderPriorityGroup*>::type* groups;
+            const Camera* camera;
+
+            void operator()(size_t i) const { (*groups)[i]->sort(camera, true); }
+        };
+    }
+    //---------------------------------------------------------------------
+    void RenderQueue::sort(const Camera* cam, bool parallel)
+    {
+        vector<RenderPriorityGroup*>::type groups;
+        for (RenderQueueGroupMap::iterator g = mGroups.begin(); g != mGroups.end(); ++g)
+        {
+            RenderQueueGroup::PriorityMapIterator it = g->second->getIterator();
+            while (it.hasMoreElements())
+                groups.push_back(it.getNext());
+        }
+
+        // Bring the camera up to date here, the workers must only read it
+        if (cam)
+        {
+            cam->getDerivedPosition();
+            cam->getDerivedOrientation();
+        }
+
+        if (parallel && groups.size() > 1)
+        {
+            PriorityGroupSorter sorter = { &groups, cam };
+            parallelFor(0, groups.size(), sorter);
+        }
+        else
+        {
+            for (size_t i = 0; i < groups.size(); ++i)
+                groups[i]->sort(cam, parallel);
+        }
+    }
+    //---------------------------------------------------------------------
+    bool RenderQueue::isShadowCasterIncluded(const MovableObject* mo) const
+    {
+        switch (mShadowCasterFilter)
+        {
+        case SCF_STATIC:
+            return mo->isStaticShadowCaster();
+        case SCF_DYNAMIC:
+            return !mo->isStaticShadowCaster();
+        default:
+            return true;
+        }
+    }
+
     //---------------------------------------------------------------------
     void RenderQueue::processVisibleObject(MovableObject* mo, 
         Camera* cam, 
@@ -304,7 +368,16 @@ namespace Ogre {
 
             if (!onlyShadowCasters || mo->getCastShadows())
             {
-                mo -> _updateRenderQueue( this );
+                // filtered out casters still count for the bounds, their
+                // shadows are cached
+                if (!onlyShadowCasters || isShadowCasterIncluded(mo))
+                {
+                    // Shadow casters don't tell how much of their textures is seen
+                    if (!onlyShadowCasters)
+                        mScreenSize = calculateScreenSize(mo, cam);
+                    mo -> _updateRenderQueue( this );
+                    mScreenSize = 0;
+                }
                 if (visibleBounds)
                 {
                     visibleBounds->merge(mo->getWorldBoundingBox(true), 
@@ -322,6 +395,40 @@ namespace Ogre {
         }
 
     }
-
+    //-----------------------------------------------------------------------
+    Real RenderQueue::calculateScreenSize(MovableObject* mo, const Camera* cam) const
+    {
+        TextureManager* textureManager = TextureManager::getSingletonPtr();
+        if (!textureManager || !textureManager->_getNumMipmapStreamedTextures())
+            return 0;
+        Viewport* vp = cam->getViewport();
+        if (!vp)
+            return 0;
+
+        const Sphere& sphere = mo->getWorldBoundingSphere(true);
+        Real height = Real(vp->getActualHeight());
+        if (cam->getProjectionType() == PT_ORTHOGRAPHIC)
+            return height * sphere.getRadius() * 2 / cam->getOrthoWindowHeight();
+
+        // The diameter over the height of the frustum at the nearest point of the sphere
+        Real distance = cam->getDerivedPosition().distance(sphere.getCenter()) - sphere.getRadius();
+        distance = std::max(distance, cam->getNearClipDistance());
+        return height * sphere.getRadius() / (distance * Math::Tan(cam->getFOVy() * 0.5));
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::notifyScreenSize(Technique* pTech) const
+    {
+        const Technique::Passes& passes = pTech->getPasses();
+        for (Technique::Passes::const_iterator p = passes.begin(); p != passes.end(); ++p)
+        {
+            const Pass::TextureUnitStates& units = (*p)->getTextureUnitStates();
+            for (Pass::TextureUnitStates::const_iterator t = units.begin(); t != units.end(); ++t)
+            {
+                const TexturePtr& tex = (*t)->_getTexturePtr();
+                if (tex && tex->isMipmapStreamed())
+                    tex->_notifyScreenSize(mScreenSize);
+            }
+        }
+    }
 }
 
@@ -29,15 +29,9 @@ THE SOFTWARE.
 #include "OgreRenderQueueSortingGrouping.h"
 #include "OgreException.h"
 #include "OgreTechnique.h"
+#include "OgreCamera.h"
 
 namespace Ogre {
-    // Init statics
-    RadixSort<QueuedRenderableCollection::RenderablePassList,
-        RenderablePass, uint32> QueuedRenderableCollection::msRadixSorter1;
-    RadixSort<QueuedRenderableCollection::RenderablePassList,
-        RenderablePass, float> QueuedRenderableCollection::msRadixSorter2;
-
-
     //-----------------------------------------------------------------------
     RenderPriorityGroup::RenderPriorityGroup(RenderQueueGroup* parent, 
             bool splitPassesByLightingType,
@@ -253,14 +247,14 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
-    void RenderPriorityGroup::sort(const Camera* cam)
+    void RenderPriorityGroup::sort(const Camera* cam, bool parallel)
     {
-        mSolidsBasic.sort(cam);
-        mSolidsDecal.sort(cam);
-        mSolidsDiffuseSpecular.sort(cam);
-        mSolidsNoShadowReceive.sort(cam);
-        mTransparentsUnsorted.sort(cam);
-        mTransparents.sort(cam);
+        mSolidsBasic.sort(cam, parallel);
+        mSolidsDecal.sort(cam, parallel);
+        mSolidsDiffuseSpecular.sort(cam, parallel);
+        mSolidsNoShadowReceive.sort(cam, parallel);
+        mTransparentsUnsorted.sort(cam, parallel);
+        mTransparents.sort(cam, parallel);
     }
     //-----------------------------------------------------------------------
     void RenderPriorityGroup::merge( const RenderPriorityGroup* rhs )
@@ -274,8 +268,20 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     QueuedRenderableCollection::QueuedRenderableCollection(void)
-        :mOrganisationMode(0)
+        :mRadixSorters(0), mSortedCamera(0), mOrganisationMode(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    QueuedRenderableCollection::~QueuedRenderableCollection(void)
+    {
+        OGRE_DELETE mRadixSorters;
+    }
+    //-----------------------------------------------------------------------
+    QueuedRenderableCollection::RadixSorters* QueuedRenderableCollection::getRadixSorters(void)
     {
+        if (!mRadixSorters)
+            mRadixSorters = OGRE_NEW RadixSorters();
+        return mRadixSorters;
     }
 
     //-----------------------------------------------------------------------
@@ -289,8 +295,10 @@ namespace Ogre {
             i->second.clear();
         }
 
-        // Clear sorted list
+        // Clear sorted lists
         mSortedDescending.clear();
+        mSortedByKey.clear();
+        mSortedCamera = 0;
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::removePassGroup(Pass* p)
@@ -303,10 +311,41 @@ namespace Ogre {
             // erase from map
             mGrouped.erase(i);
         }
+        mSortedCamera = 0;
+
+        // The keyed list is rebuilt every frame but must not keep the pass meanwhile
+        KeyedRenderablePassList::iterator dst = mSortedByKey.begin();
+        for (KeyedRenderablePassList::iterator k = mSortedByKey.begin(); k != mSortedByKey.end(); ++k)
+        {
+            if (k->renderablePass.pass != p)
+                *dst++ = *k;
+        }
+        mSortedByKey.erase(dst, mSortedByKey.end());
+    }
+    //-----------------------------------------------------------------------
+    uint64 QueuedRenderableCollection::_getSortKey(const Pass* pass, Real squaredViewDepth)
+    {
+        // Passes with the same hash are kept apart by a hash of their address
+        uint64 passBits = FastHash((const char*)&pass, sizeof(pass)) & 0xFF;
+
+        // The bits of a positive float sort like an integer
+        float depth = std::max(static_cast<float>(squaredViewDepth), 0.0f);
+        uint32 depthBits;
+        memcpy(&depthBits, &depth, sizeof(depthBits));
+
+        return (static_cast<uint64>(pass->getHash()) << 32) | (passBits << 24) | (depthBits >> 7);
     }
     //-----------------------------------------------------------------------
-    void QueuedRenderableCollection::sort(const Camera* cam)
+    void QueuedRenderableCollection::sort(const Camera* cam, bool parallel)
     {
+        // Nothing changed since the last sort, e.g. for a repeated queue or
+        // a pre-sorted render queue
+        if (cam && cam == mSortedCamera && cam->getDerivedPosition() == mSortedPosition &&
+            cam->getDerivedOrientation() == mSortedOrientation)
+        {
+            return;
+        }
+
         // ascending and descending sort both set bit 1
         // We always sort descending, because the only difference is in the
         // acceptVisitor method, where we iterate in reverse in ascending mode
@@ -322,14 +361,24 @@ namespace Ogre {
             // Since stable_sort has a worst-case performance of O(N(logN)^2)
             // the performance tipping point is from about 1500 items, but in
             // stable_sorts best-case scenario O(NlogN) it would be much higher.
-            // Take a stab at 2000 items.
+            // Take a stab at 2000 items. Large collections can also spread
+            // the radix sort over the worker threads.
             
             if (mSortedDescending.size() > 2000)
             {
-                // sort by pass
-                msRadixSorter1.sort(mSortedDescending, RadixSortFunctorPass());
-                // sort by depth
-                msRadixSorter2.sort(mSortedDescending, RadixSortFunctorDistance(cam));
+                RadixSorters* sorters = getRadixSorters();
+                if (parallel)
+                {
+                    sorters->pass.sortParallel(mSortedDescending, RadixSortFunctorPass());
+                    sorters->distance.sortParallel(mSortedDescending, RadixSortFunctorDistance(cam));
+                }
+                else
+                {
+                    // sort by pass
+                    sorters->pass.sort(mSortedDescending, RadixSortFunctorPass());
+                    // sort by depth
+                    sorters->distance.sort(mSortedDescending, RadixSortFunctorDistance(cam));
+                }
             }
             else
             {
@@ -339,12 +388,39 @@ namespace Ogre {
             }
         }
 
+        if (mOrganisationMode & OM_SORT_KEY)
+        {
+            KeyedRenderablePassList::iterator i, iend = mSortedByKey.end();
+            for (i = mSortedByKey.begin(); i != iend; ++i)
+            {
+                i->key = _getSortKey(i->renderablePass.pass,
+                    i->renderablePass.renderable->getSquaredViewDepth(cam));
+            }
+
+            // Same tipping point as above, a single radix sort over the 64bit
+            // keys replaces the two 32bit ones
+            if (mSortedByKey.size() > 2000 && parallel)
+                getRadixSorters()->key.sortParallel(mSortedByKey, RadixSortFunctorKey());
+            else if (mSortedByKey.size() > 2000)
+                getRadixSorters()->key.sort(mSortedByKey, RadixSortFunctorKey());
+            else
+                std::sort(mSortedByKey.begin(), mSortedByKey.end(), KeyLess());
+        }
+
         // Nothing needs to be done for pass groups, they auto-organise
 
+        mSortedCamera = cam;
+        if (cam)
+        {
+            mSortedPosition = cam->getDerivedPosition();
+            mSortedOrientation = cam->getDerivedOrientation();
+        }
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::addRenderable(Pass* pass, Renderable* rend)
     {
+        mSortedCamera = 0;
+
         // ascending and descending sort both set bit 1
         if (mOrganisationMode & OM_SORT_DESCENDING)
         {
@@ -371,6 +447,12 @@ namespace Ogre {
             i->second.push_back(rend);
             
         }
+
+        if (mOrganisationMode & OM_SORT_KEY)
+        {
+            // Keys are computed when sorting, since they depend on the camera
+            mSortedByKey.push_back(KeyedRenderablePass(rend, pass));
+        }
         
     }
     //-----------------------------------------------------------------------
@@ -382,6 +464,8 @@ namespace Ogre {
             // try to fall back
             if (OM_PASS_GROUP & mOrganisationMode)
                 om = OM_PASS_GROUP;
+            else if (OM_SORT_KEY & mOrganisationMode)
+                om = OM_SORT_KEY;
             else if (OM_SORT_ASCENDING & mOrganisationMode)
                 om = OM_SORT_ASCENDING;
             else if (OM_SORT_DESCENDING & mOrganisationMode)
@@ -404,6 +488,9 @@ namespace Ogre {
         case OM_SORT_ASCENDING:
             acceptVisitorAscending(visitor);
             break;
+        case OM_SORT_KEY:
+            acceptVisitorSortKey(visitor);
+            break;
         }
         
     }
@@ -461,9 +548,35 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::acceptVisitorSortKey(
+        QueuedRenderableVisitor* visitor) const
+    {
+        // Same visits as a pass group, the pass changes between runs of items
+        const Pass* currentPass = 0;
+        bool skipPass = false;
+
+        KeyedRenderablePassList::const_iterator i, iend;
+        iend = mSortedByKey.end();
+        for (i = mSortedByKey.begin(); i != iend; ++i)
+        {
+            const RenderablePass& rp = i->renderablePass;
+            if (rp.pass != currentPass)
+            {
+                // Visit Pass - allow skip
+                currentPass = rp.pass;
+                skipPass = !visitor->visit(currentPass);
+            }
+
+            if (!skipPass)
+                visitor->visit(rp.renderable);
+        }
+    }
+    //-----------------------------------------------------------------------
     void QueuedRenderableCollection::merge( const QueuedRenderableCollection& rhs )
     {
+        mSortedCamera = 0;
         mSortedDescending.insert( mSortedDescending.end(), rhs.mSortedDescending.begin(), rhs.mSortedDescending.end() );
+        mSortedByKey.insert( mSortedByKey.end(), rhs.mSortedByKey.begin(), rhs.mSortedByKey.end() );
 
         PassGroupRenderableMap::const_iterator srcGroup;
         for( srcGroup = rhs.mGrouped.begin(); srcGroup != rhs.mGrouped.end(); ++srcGroup )
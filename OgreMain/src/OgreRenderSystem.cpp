@@ -42,6 +42,11 @@ THE SOFTWARE.
 #include "OgreTextureManager.h"
 #include "OgreMaterialManager.h"
 #include "OgreHardwareOcclusionQuery.h"
+#include "OgreHardwareTimerQuery.h"
+#include "OgreProfiler.h"
+#include "OgreRenderQueue.h"
+#include "OgreRoot.h"
+#include "OgreTimer.h"
 
 namespace Ogre {
 
@@ -61,6 +66,7 @@ namespace Ogre {
         , mBatchCount(0)
         , mFaceCount(0)
         , mVertexCount(0)
+        , mCurrentRenderQueue(RENDER_QUEUE_MAIN)
         , mInvertVertexWinding(false)
         , mDisabledTexUnitsFrom(0)
         , mCurrentPassIterationCount(0)
@@ -72,6 +78,7 @@ namespace Ogre {
         , mGlobalInstanceVertexBufferVertexDeclaration(NULL)
         , mGlobalNumberOfInstances(1)
         , mEnableFixedPipeline(true)
+        , mRenderTargetUpdateBudget(0)
         , mVertexProgramBound(false)
         , mGeometryProgramBound(false)
         , mFragmentProgramBound(false)
@@ -117,13 +124,86 @@ namespace Ogre {
     {
         // Update all in order of priority
         // This ensures render-to-texture targets get updated before render windows
+        const unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        unsigned long spent = 0;
         RenderTargetPriorityMap::iterator itarg, itargend;
         itargend = mPrioritisedRenderTargets.end();
         for( itarg = mPrioritisedRenderTargets.begin(); itarg != itargend; ++itarg )
         {
-            if( itarg->second->isActive() && itarg->second->isAutoUpdated())
-                itarg->second->update(swapBuffers);
+            RenderTarget* target = itarg->second;
+            if( !target->isActive() || !target->isAutoUpdated())
+                continue;
+
+            if (!target->_isUpdateDue(frame))
+            {
+                ++mRenderStats.renderTargetsSkipped;
+                continue;
+            }
+
+            if (mRenderTargetUpdateBudget && target->getPriority() < OGRE_DEFAULT_RT_GROUP)
+            {
+                if (!updateBudgetedRenderTarget(target, swapBuffers, frame, spent))
+                {
+                    ++mRenderStats.renderTargetsSkipped;
+                    continue;
+                }
+            }
+            else
+            {
+                target->update(swapBuffers);
+            }
+            ++mRenderStats.renderTargetUpdates;
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool RenderSystem::updateBudgetedRenderTarget(RenderTarget* target, bool swapBuffers,
+                                                  unsigned long frame, unsigned long& spent)
+    {
+        RenderTargetTiming& timing = mRenderTargetTimings[target];
+
+        // Collect the GPU time of an earlier update, without waiting for it
+        uint64 begin, end;
+        if (timing.pending && !timing.begin->isStillOutstanding() && !timing.end->isStillOutstanding())
+        {
+            if (timing.begin->pullTimestamp(&begin) && timing.end->pullTimestamp(&end) && end >= begin)
+                timing.cost = static_cast<unsigned long>((end - begin) / 1000);
+            timing.pending = false;
+        }
+
+        if (spent + timing.cost > mRenderTargetUpdateBudget &&
+            target->_getUpdateDelay(frame) < target->getUpdateInterval())
+            return false;
+
+        if (!timing.created)
+        {
+            timing.begin = createHardwareTimerQuery();
+            timing.end = timing.begin ? createHardwareTimerQuery() : 0;
+            timing.created = true;
+        }
+
+        if (timing.end)
+        {
+            // Queries still in flight keep their result, the previous cost stays in use
+            const bool measure = !timing.pending;
+            if (measure)
+                timing.begin->queryTimestamp();
+            target->update(swapBuffers);
+            if (measure)
+            {
+                timing.end->queryTimestamp();
+                timing.pending = true;
+            }
         }
+        else
+        {
+            Timer* timer = Root::getSingleton().getTimer();
+            const unsigned long start = timer->getMicroseconds();
+            target->update(swapBuffers);
+            timing.cost = timer->getMicroseconds() - start;
+        }
+
+        spent += timing.cost;
+        return true;
     }
     //-----------------------------------------------------------------------
     void RenderSystem::_swapAllRenderTargetBuffers()
@@ -132,11 +212,20 @@ namespace Ogre {
         // This ensures render-to-texture targets get updated before render windows
         RenderTargetPriorityMap::iterator itarg, itargend;
         itargend = mPrioritisedRenderTargets.end();
+        const unsigned long frame = Root::getSingleton().getNextFrameNumber();
         for( itarg = mPrioritisedRenderTargets.begin(); itarg != itargend; ++itarg )
         {
-            if( itarg->second->isActive() && itarg->second->isAutoUpdated())
+            // Skipped targets have nothing new to present
+            if( itarg->second->isActive() && itarg->second->isAutoUpdated() &&
+                itarg->second->_isUpdatedInFrame(frame))
                 itarg->second->swapBuffers();
         }
+
+        // the frame is complete
+        for (int i = 0; i < HardwareBuffer::LU_COUNT; ++i)
+            mRenderStats.bufferLockBytes[i] += HardwareBuffer::_takeLockedBytes(HardwareBuffer::LockUsage(i));
+        mLastRenderStats = mRenderStats;
+        mRenderStats.reset();
     }
     //-----------------------------------------------------------------------
     RenderWindow* RenderSystem::_initialise(bool autoCreateWindow, const String& windowTitle)
@@ -298,6 +387,16 @@ namespace Ogre {
             }
 
             mRenderTargets.erase( it );
+
+            RenderTargetTimingMap::iterator timing = mRenderTargetTimings.find(ret);
+            if (timing != mRenderTargetTimings.end())
+            {
+                if (timing->second.begin)
+                    destroyHardwareTimerQuery(timing->second.begin);
+                if (timing->second.end)
+                    destroyHardwareTimerQuery(timing->second.end);
+                mRenderTargetTimings.erase(timing);
+            }
         }
         /// If detached render target is the active render target, reset active render target
         if(ret == mActiveRenderTarget)
@@ -318,6 +417,10 @@ namespace Ogre {
 
         const TexturePtr& tex = tl._getTexturePtr();
         bool isValidBinding = false;
+
+        // Texture streaming keeps the textures in use resident
+        if (tex)
+            tex->_notifyUsed(Root::getSingleton().getNextFrameNumber());
         
         if (mCurrentCapabilities->hasCapability(RSC_COMPLETE_TEXTURE_BINDING))
             _setBindingType(tl.getBindingType());
@@ -341,6 +444,7 @@ namespace Ogre {
                 _setVertexTexture(texUnit, sNullTexPtr);
                 _setTexture(texUnit, true, tex);
             }
+            ++mRenderStats.textureBinds;
         }
 
         if (mCurrentCapabilities->hasCapability(RSC_GEOMETRY_PROGRAM))
@@ -697,6 +801,17 @@ namespace Ogre {
         }
         mHwOcclusionQueries.clear();
 
+        // Remove timer queries, the profiler keeps a pool of them
+        if (Profiler* profiler = Profiler::getSingletonPtr())
+            profiler->_releaseGPUTimers();
+        for (HardwareTimerQueryList::iterator i = mHwTimerQueries.begin();
+            i != mHwTimerQueries.end(); ++i)
+        {
+            OGRE_DELETE *i;
+        }
+        mHwTimerQueries.clear();
+        mRenderTargetTimings.clear();
+
         _cleanupDepthBuffers();
 
         // Remove all the render targets.
@@ -818,6 +933,8 @@ namespace Ogre {
 
         mVertexCount += op.vertexData->vertexCount * trueInstanceNum;
         mBatchCount += mCurrentPassIterationCount;
+        mRenderStats.drawCalls += mCurrentPassIterationCount;
+        mRenderStats.drawCallsByQueue[mCurrentRenderQueue] += mCurrentPassIterationCount;
 
         // sort out clip planes
         // have to do it here in case of matrix issues
@@ -827,6 +944,13 @@ namespace Ogre {
             mClipPlanesDirty = false;
         }
     }
+    //-----------------------------------------------------------------------
+    void RenderSystem::_dispatchCompute(const Vector3& workgroupDim)
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+            "This rendersystem does not support dispatching compute programs",
+            "RenderSystem::_dispatchCompute");
+    }
     void RenderSystem::_renderUsingReadBackAsTexture(unsigned int secondPass,Ogre::String variableName,unsigned int StartSlot)
     {
         OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, 
@@ -971,8 +1095,21 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void RenderSystem::destroyHardwareTimerQuery( HardwareTimerQuery *tq)
+    {
+        HardwareTimerQueryList::iterator i =
+            std::find(mHwTimerQueries.begin(), mHwTimerQueries.end(), tq);
+        if (i != mHwTimerQueries.end())
+        {
+            mHwTimerQueries.erase(i);
+            OGRE_DELETE tq;
+        }
+    }
+    //-----------------------------------------------------------------------
     void RenderSystem::bindGpuProgram(GpuProgram* prg)
     {
+        ++mRenderStats.programBinds;
+
         switch(prg->getType())
         {
         case GPT_VERTEX_PROGRAM:
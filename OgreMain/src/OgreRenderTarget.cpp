@@ -27,15 +27,18 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreRenderTarget.h"
+#include "OgreAsyncReadback.h"
 
 #include "OgreViewport.h"
 #include "OgreException.h"
 #include "OgreLogManager.h"
 #include "OgreRenderTargetListener.h"
 #include "OgreRoot.h"
+#include "OgreRenderSystem.h"
 #include "OgreDepthBuffer.h"
 #include "OgreProfiler.h"
 #include "OgreTimer.h"
+#include "OgreTexture.h"
 #include <iomanip>
 
 namespace Ogre {
@@ -53,6 +56,12 @@ namespace Ogre {
 #else
 		, mStereoEnabled(false)
 #endif
+        , mDontCareBuffers(0)
+        , mDiscardBuffers(0)
+        , mUpdateInterval(1)
+        , mLastUpdateFrame(0)
+        , mNextUpdateFrame(0)
+        , mUpdateUsageTexture(0)
     {
         mTimer = Root::getSingleton().getTimer();
         resetStatistics();
@@ -169,6 +178,9 @@ namespace Ogre {
         // notify listeners (pre)
         firePreUpdate();
 
+        if (mDontCareBuffers)
+            Root::getSingleton().getRenderSystem()->_discardRenderTarget(this, mDontCareBuffers);
+
         mStats.triangleCount = 0;
         mStats.batchCount = 0;
     }
@@ -194,10 +206,29 @@ namespace Ogre {
          // notify listeners (post)
         firePostUpdate();
 
+        if (mDiscardBuffers)
+            Root::getSingleton().getRenderSystem()->_discardRenderTarget(this, mDiscardBuffers);
+
         // Update statistics (always on top)
         updateStats();
     }
 
+    void RenderTarget::setLoadAction(LoadAction action, unsigned int buffers)
+    {
+        if (action == LA_DONT_CARE)
+            mDontCareBuffers |= buffers;
+        else
+            mDontCareBuffers &= ~buffers;
+    }
+
+    void RenderTarget::setStoreAction(StoreAction action, unsigned int buffers)
+    {
+        if (action == SA_DISCARD)
+            mDiscardBuffers |= buffers;
+        else
+            mDiscardBuffers &= ~buffers;
+    }
+
     void RenderTarget::_updateViewport(Viewport* viewport, bool updateStatistics)
     {
         assert(viewport->getTarget() == this &&
@@ -564,6 +595,16 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    AsyncReadbackPtr RenderTarget::copyContentsToMemoryAsync(const Box& src, FrameBuffer buffer)
+    {
+        // Without asynchronous readback, copy at once into a ready ticket
+        MemoryAsyncReadback* readback = OGRE_NEW MemoryAsyncReadback(
+            src.getWidth(), src.getHeight(), src.getDepth(), suggestPixelFormat());
+        AsyncReadbackPtr ticket(readback);
+        copyContentsToMemory(src, readback->getPixelBox(), buffer);
+        return ticket;
+    }
+    //-----------------------------------------------------------------------
     void RenderTarget::writeContentsToFile(const String& filename)
     {
         PixelFormat pf = suggestPixelFormat();
@@ -603,6 +644,20 @@ namespace Ogre {
         return mAutoUpdate;
     }
     //-----------------------------------------------------------------------
+    void RenderTarget::setUpdateInterval(uint32 interval, uint32 offset)
+    {
+        mUpdateInterval = std::max<uint32>(interval, 1);
+        mNextUpdateFrame = Root::getSingleton().getNextFrameNumber() + offset;
+    }
+    //-----------------------------------------------------------------------
+    bool RenderTarget::_isUpdateDue(unsigned long frame) const
+    {
+        // Unused in the previous frame, nothing shows the contents
+        if (mUpdateUsageTexture && mUpdateUsageTexture->getLastUsedFrame() + 1 < frame)
+            return false;
+        return frame >= mNextUpdateFrame;
+    }
+    //-----------------------------------------------------------------------
     bool RenderTarget::isPrimary(void) const
     {
         // RenderWindow will override and return true for the primary window
@@ -622,6 +677,8 @@ namespace Ogre {
     void RenderTarget::update(bool swap)
     {
         OgreProfileBeginGPUEvent("RenderTarget: " + getName());
+        mLastUpdateFrame = Root::getSingleton().getNextFrameNumber();
+        mNextUpdateFrame = mLastUpdateFrame + mUpdateInterval;
         // call implementation
         updateImpl();
 
@@ -62,6 +62,19 @@ namespace Ogre
         mBuffer->blitToMemory(src, dst);
     }
     //---------------------------------------------------------------------
+    AsyncReadbackPtr RenderTexture::copyContentsToMemoryAsync(const Box& src, FrameBuffer buffer)
+    {
+        if (buffer == FB_AUTO) buffer = FB_FRONT;
+        if (buffer != FB_FRONT)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                        "Invalid buffer.",
+                        "RenderTexture::copyContentsToMemoryAsync" );
+        }
+
+        return mBuffer->blitToMemoryAsync(src);
+    }
+    //---------------------------------------------------------------------
     PixelFormat RenderTexture::suggestPixelFormat() const
     {
         return mBuffer->getFormat();
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreScriptLoader.h"
 #include "OgreSceneManager.h"
 #include "OgreResourceManager.h"
+#include "Threading/OgreParallel.h"
 
 namespace Ogre {
 
@@ -61,7 +62,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mCurrentGroup(0), mArchiveListingsChanged(false)
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME, true); // the "General" group is synonymous to global pool
@@ -75,6 +76,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     ResourceGroupManager::~ResourceGroupManager()
     {
+        saveLocationIndexCache();
+
         // delete all resource groups
         ResourceGroupMap::iterator i, iend;
         iend = mResourceGroupMap.end();
@@ -159,6 +162,9 @@ namespace Ogre {
                 mCurrentGroup = 0;
             }
         }
+
+        // All locations have been listed by now
+        saveLocationIndexCache();
     }
     //-----------------------------------------------------------------------
     void ResourceGroupManager::prepareResourceGroup(const String& name, 
@@ -542,7 +548,7 @@ namespace Ogre {
         ResourceLocation* loc = OGRE_NEW_T(ResourceLocation, MEMCATEGORY_RESOURCE);
         loc->archive = pArch;
         loc->recursive = recursive;
-        StringVectorPtr vec = pArch->find("*", recursive);
+        StringVectorPtr vec = listResourceLocation(pArch, recursive);
 
         ResourceGroup* grp = getResourceGroup(resGroup);
         if (!grp)
@@ -567,6 +573,114 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    StringVectorPtr ResourceGroupManager::listResourceLocation(Archive* arch, bool recursive)
+    {
+        // Archives without a modification time can't be cached
+        time_t modifiedTime = mLocationIndexCachePath.empty() ? 0 : arch->getModifiedTime(".");
+        if (!modifiedTime)
+            return arch->find("*", recursive);
+
+        OGRE_LOCK_AUTO_MUTEX;
+        String key = arch->getType() + ':' + arch->getName() + (recursive ? ":recursive" : "");
+        ArchiveListingMap::iterator i = mArchiveListings.find(key);
+        if (i == mArchiveListings.end() || i->second.modifiedTime != modifiedTime)
+        {
+            StringVectorPtr files = arch->find("*", recursive);
+            ArchiveListing& listing = mArchiveListings[key];
+            listing.archiveName = arch->getName();
+            listing.modifiedTime = modifiedTime;
+            listing.files.swap(*files);
+            mArchiveListingsChanged = true;
+            i = mArchiveListings.find(key);
+        }
+
+        return StringVectorPtr(OGRE_NEW_T(StringVector, MEMCATEGORY_GENERAL)(i->second.files), SPFM_DELETE_T);
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::setLocationIndexCache(const String& path)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        saveLocationIndexCache();
+
+        mLocationIndexCachePath = path;
+        mArchiveListings.clear();
+        mArchiveListingsChanged = false;
+        if (path.empty())
+            return;
+
+        // A header line, then per archive its key, name, modification time,
+        // number of files and the files, all on lines of their own
+        std::ifstream file(path.c_str());
+        String line;
+        if (!std::getline(file, line) || line != "OGRE location index 1")
+            return;
+
+        String key, archiveName;
+        while (std::getline(file, key) && std::getline(file, archiveName))
+        {
+            long long modifiedTime = 0;
+            size_t count = 0;
+            if (!(file >> modifiedTime >> count))
+                break;
+            std::getline(file, line);
+
+            StringVector files(count);
+            for (size_t i = 0; i < count && file; ++i)
+                std::getline(file, files[i]);
+            if (!file)
+                break;
+
+            ArchiveListing& listing = mArchiveListings[key];
+            listing.archiveName = archiveName;
+            listing.modifiedTime = static_cast<time_t>(modifiedTime);
+            listing.files.swap(files);
+        }
+        LogManager::getSingleton().logMessage("Read the listings of " +
+            StringConverter::toString(mArchiveListings.size()) + " archives from " + path);
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::saveLocationIndexCache(void)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        if (!mArchiveListingsChanged || mLocationIndexCachePath.empty())
+            return;
+
+        std::ofstream file(mLocationIndexCachePath.c_str(), std::ios::out | std::ios::trunc);
+        file << "OGRE location index 1\n";
+        for (ArchiveListingMap::const_iterator i = mArchiveListings.begin(); i != mArchiveListings.end(); ++i)
+        {
+            const ArchiveListing& listing = i->second;
+            file << i->first << '\n' << listing.archiveName << '\n' << (long long)listing.modifiedTime << '\n'
+                 << listing.files.size() << '\n';
+            for (StringVector::const_iterator f = listing.files.begin(); f != listing.files.end(); ++f)
+                file << *f << '\n';
+        }
+
+        if (!file)
+        {
+            LogManager::getSingleton().logMessage("Could not write the location index cache " +
+                mLocationIndexCachePath, LML_CRITICAL);
+        }
+        mArchiveListingsChanged = false;
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::invalidateLocationIndexCache(const String& archiveName)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        for (ArchiveListingMap::iterator i = mArchiveListings.begin(); i != mArchiveListings.end();)
+        {
+            if (i->second.archiveName == archiveName)
+            {
+                mArchiveListings.erase(i++);
+                mArchiveListingsChanged = true;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::removeResourceLocation(const String& name, 
         const String& resGroup)
     {
@@ -959,6 +1073,38 @@ namespace Ogre {
         return 0; // No loader was found
     }
     //-----------------------------------------------------------------------
+    namespace
+    {
+        /// A script to parse, along with its stream and preparation once read ahead
+        struct ScriptEntry
+        {
+            ScriptLoader* loader;
+            const FileInfo* fileInfo;
+            DataStreamPtr stream;
+            PreparedScriptPtr prepared;
+        };
+        typedef vector<ScriptEntry>::type ScriptEntryList;
+
+        /// Bytes of script text read ahead and prepared at once
+        const size_t SCRIPT_READ_AHEAD_SIZE = 4 * 1024 * 1024;
+
+        /// Calls ScriptLoader::prepareScript for a range of scripts
+        struct ScriptPrepareJob : public ParallelJob
+        {
+            ScriptEntry* scripts;
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    ScriptEntry& script = scripts[i];
+                    if (script.stream)
+                        script.prepared = script.loader->prepareScript(script.stream);
+                }
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::parseResourceGroupScripts(ResourceGroup* grp) const
     {
 
@@ -995,46 +1141,97 @@ namespace Ogre {
         // Fire scripting event
         fireResourceGroupScriptingStarted(grp->name, scriptCount);
 
-        // Iterate over scripts and parse
         // Note we respect original ordering
+        ScriptEntryList scripts;
+        scripts.reserve(scriptCount);
         for (ScriptLoaderFileList::iterator slfli = scriptLoaderFileList.begin();
             slfli != scriptLoaderFileList.end(); ++slfli)
         {
-            ScriptLoader* su = slfli->first;
             // Iterate over each list
             for (FileListList::iterator flli = slfli->second->begin(); flli != slfli->second->end(); ++flli)
             {
                 // Iterate over each item in the list
                 for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii)
                 {
-                    bool skipScript = false;
-                    fireScriptStarted(fii->filename, skipScript);
-                    if(skipScript)
-                    {
-                        LogManager::getSingleton().logMessage(
-                            "Skipping script " + fii->filename);
-                    }
-                    else
+                    ScriptEntry script;
+                    script.loader = slfli->first;
+                    script.fileInfo = &*fii;
+                    scripts.push_back(script);
+                }
+            }
+        }
+
+        // Scripts are read ahead in windows of limited size and lexed and parsed on
+        // the worker threads, only the rest of the parsing is done in order. With a
+        // loading listener, which may replace each stream once it is opened, the
+        // scripts are opened one by one after their script started event as before.
+        size_t next = 0;
+        while (next < scripts.size())
+        {
+            size_t end = next + 1;
+            if (!mLoadingListener)
+            {
+                size_t readAhead = 0;
+                for (end = next; end < scripts.size() && readAhead < SCRIPT_READ_AHEAD_SIZE; ++end)
+                {
+                    ScriptEntry& script = scripts[end];
+                    script.stream = script.fileInfo->archive->open(script.fileInfo->filename);
+                    // Streams are read by the worker threads, so read them into
+                    // memory here unless they already are
+                    if (script.stream && !dynamic_cast<MemoryDataStream*>(script.stream.get()))
+                        script.stream.reset(OGRE_NEW MemoryDataStream(script.stream->getName(), script.stream));
+                    if (script.stream)
+                        readAhead += script.stream->size();
+                }
+
+                ScriptPrepareJob* job = OGRE_NEW ScriptPrepareJob();
+                ParallelJobPtr jobPtr(job);
+                job->scripts = &scripts[next];
+                job->setCount(end - next);
+                ParallelJob::run(jobPtr);
+            }
+
+            for (; next < end; ++next)
+            {
+                ScriptEntry& script = scripts[next];
+                const FileInfo* fi = script.fileInfo;
+                bool skipScript = false;
+                fireScriptStarted(fi->filename, skipScript);
+                if(skipScript)
+                {
+                    LogManager::getSingleton().logMessage(
+                        "Skipping script " + fi->filename);
+                }
+                else
+                {
+                    LogManager::getSingleton().logMessage(
+                        "Parsing script " + fi->filename);
+                    if (mLoadingListener)
                     {
-                        LogManager::getSingleton().logMessage(
-                            "Parsing script " + fii->filename);
-                        DataStreamPtr stream = fii->archive->open(fii->filename);
+                        DataStreamPtr stream = fi->archive->open(fi->filename);
                         if (stream)
                         {
-                            if (mLoadingListener)
-                                mLoadingListener->resourceStreamOpened(fii->filename, grp->name, 0, stream);
+                            mLoadingListener->resourceStreamOpened(fi->filename, grp->name, 0, stream);
 
-                            if(fii->archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024)
+                            if(fi->archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024)
                             {
                                 DataStreamPtr cachedCopy(OGRE_NEW MemoryDataStream(stream->getName(), stream));
-                                su->parseScript(cachedCopy, grp->name);
+                                script.loader->parseScript(cachedCopy, grp->name);
                             }
                             else
-                                su->parseScript(stream, grp->name);
+                                script.loader->parseScript(stream, grp->name);
                         }
                     }
-                    fireScriptEnded(fii->filename, skipScript);
+                    else if (script.stream)
+                    {
+                        script.stream->seek(0);
+                        script.loader->parsePreparedScript(script.stream, grp->name, script.prepared);
+                    }
                 }
+                // Release the script as soon as it is parsed
+                script.stream.reset();
+                script.prepared.reset();
+                fireScriptEnded(fi->filename, skipScript);
             }
         }
 
@@ -108,29 +108,12 @@ namespace Ogre {
     {
             OGRE_LOCK_AUTO_MUTEX;
 
-            std::pair<ResourceMap::iterator, bool> result;
-        if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
-        {
-            result = mResources.insert( ResourceMap::value_type( res->getName(), res ) );
-        }
-        else
-        {
-            ResourceWithGroupMap::iterator itGroup = mResourcesWithGroup.find(res->getGroup());
-
-            // we will create the group if it doesn't exists in our list
-            if( itGroup == mResourcesWithGroup.end())
-            {
-                ResourceMap dummy;
-                mResourcesWithGroup.insert( ResourceWithGroupMap::value_type( res->getGroup(), dummy ) );
-                itGroup = mResourcesWithGroup.find(res->getGroup());
-            }
-            result = itGroup->second.insert( ResourceMap::value_type( res->getName(), res ) );
-
-        }
+        bool isGlobal = ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup());
+        bool inserted = insertResource(res, isGlobal);
 
         // Attempt to resolve the collision
         ResourceLoadingListener* listener = ResourceGroupManager::getSingleton().getLoadingListener();
-        if (!result.second && listener)
+        if (!inserted && listener)
         {
             if(listener->resourceCollision(res.get(), this) == false)
             {
@@ -139,26 +122,21 @@ namespace Ogre {
             }
 
             // Try to do the addition again, no seconds attempts to resolve collisions are allowed
-            if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
-            {
-                result = mResources.insert( ResourceMap::value_type( res->getName(), res ) );
-            }
-            else
-            {
-                ResourceWithGroupMap::iterator itGroup = mResourcesWithGroup.find(res->getGroup());
-                result = itGroup->second.insert( ResourceMap::value_type( res->getName(), res ) );
-            }
+            inserted = insertResource(res, isGlobal);
         }
 
-        if (!result.second)
+        if (!inserted)
         {
             OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, "Resource with the name " + res->getName() +
                 " already exists.", "ResourceManager::add");
         }
 
         // Insert the handle
-        std::pair<ResourceHandleMap::iterator, bool> resultHandle =
-            mResourcesByHandle.insert( ResourceHandleMap::value_type( res->getHandle(), res ) );
+        std::pair<ResourceHandleMap::iterator, bool> resultHandle;
+        {
+            OGRE_WQ_LOCK_SHARED_MUTEX_WRITE(mResourceIndexMutex);
+            resultHandle = mResourcesByHandle.insert( ResourceHandleMap::value_type( res->getHandle(), res ) );
+        }
         if (!resultHandle.second)
         {
             OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, "Resource with the handle " +
@@ -167,42 +145,61 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    bool ResourceManager::insertResource(const ResourcePtr& res, bool isGlobal)
+    {
+        OGRE_WQ_LOCK_SHARED_MUTEX_WRITE(mResourceIndexMutex);
+
+        if (isGlobal)
+        {
+            return mResources.insert( ResourceMap::value_type( res->getName(), res ) ).second;
+        }
+
+        // we will create the group if it doesn't exists in our list
+        ResourceMap& group = mResourcesWithGroup[res->getGroup()];
+        return group.insert( ResourceMap::value_type( res->getName(), res ) ).second;
+    }
+    //-----------------------------------------------------------------------
     void ResourceManager::removeImpl(const ResourcePtr& res )
     {
         OgreAssert(res, "attempting to remove nullptr");
 
         OGRE_LOCK_AUTO_MUTEX;
 
-        if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
+        bool isGlobal = ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup());
         {
-            ResourceMap::iterator nameIt = mResources.find(res->getName());
-            if (nameIt != mResources.end())
+            OGRE_WQ_LOCK_SHARED_MUTEX_WRITE(mResourceIndexMutex);
+
+            if(isGlobal)
             {
-                mResources.erase(nameIt);
+                ResourceMap::iterator nameIt = mResources.find(res->getName());
+                if (nameIt != mResources.end())
+                {
+                    mResources.erase(nameIt);
+                }
             }
-        }
-        else
-        {
-            ResourceWithGroupMap::iterator groupIt = mResourcesWithGroup.find(res->getGroup());
-            if (groupIt != mResourcesWithGroup.end())
+            else
             {
-                ResourceMap::iterator nameIt = groupIt->second.find(res->getName());
-                if (nameIt != groupIt->second.end())
+                ResourceWithGroupMap::iterator groupIt = mResourcesWithGroup.find(res->getGroup());
+                if (groupIt != mResourcesWithGroup.end())
                 {
-                    groupIt->second.erase(nameIt);
-                }
+                    ResourceMap::iterator nameIt = groupIt->second.find(res->getName());
+                    if (nameIt != groupIt->second.end())
+                    {
+                        groupIt->second.erase(nameIt);
+                    }
 
-                if (groupIt->second.empty())
-                {
-                    mResourcesWithGroup.erase(groupIt);
+                    if (groupIt->second.empty())
+                    {
+                        mResourcesWithGroup.erase(groupIt);
+                    }
                 }
             }
-        }
 
-        ResourceHandleMap::iterator handleIt = mResourcesByHandle.find(res->getHandle());
-        if (handleIt != mResourcesByHandle.end())
-        {
-            mResourcesByHandle.erase(handleIt);
+            ResourceHandleMap::iterator handleIt = mResourcesByHandle.find(res->getHandle());
+            if (handleIt != mResourcesByHandle.end())
+            {
+                mResourcesByHandle.erase(handleIt);
+            }
         }
         // Tell resource group manager
         ResourceGroupManager::getSingleton()._notifyResourceRemoved(res);
@@ -333,9 +330,12 @@ namespace Ogre {
     {
             OGRE_LOCK_AUTO_MUTEX;
 
-        mResources.clear();
-        mResourcesWithGroup.clear();
-        mResourcesByHandle.clear();
+        {
+            OGRE_WQ_LOCK_SHARED_MUTEX_WRITE(mResourceIndexMutex);
+            mResources.clear();
+            mResourcesWithGroup.clear();
+            mResourcesByHandle.clear();
+        }
         // Notify resource group manager
         ResourceGroupManager::getSingleton()._notifyAllResourcesRemoved(this);
     }
@@ -367,11 +367,11 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     ResourcePtr ResourceManager::getResourceByName(const String& name, const String& groupName /* = ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME */)
     {
-        OGRE_LOCK_AUTO_MUTEX;
-
         // resource should be in global pool
         bool isGlobal = ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(groupName);
 
+        OGRE_WQ_LOCK_SHARED_MUTEX_READ(mResourceIndexMutex);
+
         if(isGlobal)
         {
             ResourceMap::iterator it = mResources.find(name);
@@ -425,7 +425,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     ResourcePtr ResourceManager::getByHandle(ResourceHandle handle)
     {
-        OGRE_LOCK_AUTO_MUTEX;
+        OGRE_WQ_LOCK_SHARED_MUTEX_READ(mResourceIndexMutex);
         ResourceHandleMap::iterator it = mResourcesByHandle.find(handle);
         return it == mResourcesByHandle.end() ? ResourcePtr() : it->second;
     }
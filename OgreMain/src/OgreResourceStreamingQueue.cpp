@@ -0,0 +1,398 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreResourceStreamingQueue.h"
+#include "OgreResourceManager.h"
+#include "OgreRoot.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        struct PriorityLess
+        {
+            template <typename T>
+            bool operator()(const T* a, const T* b) const
+            {
+                if (a->priority != b->priority)
+                    return a->priority < b->priority;
+                return a->distance < b->distance;
+            }
+        };
+    }
+    //------------------------------------------------------------------------
+    void ResourceStreamingQueue::StreamedResource::updatePriority()
+    {
+        priority = PC_LOW;
+        distance = std::numeric_limits<Real>::max();
+        for (RequestList::const_iterator i = requests.begin(); i != requests.end(); ++i)
+        {
+            if (i->priority < priority || (i->priority == priority && i->distance < distance))
+            {
+                priority = i->priority;
+                distance = i->distance;
+            }
+        }
+    }
+    //------------------------------------------------------------------------
+    ResourceStreamingQueue::ResourceStreamingQueue()
+        : mNextTicket(1), mMaxRequestsInFlight(4), mNumRequestsInFlight(0), mBandwidthLimit(0),
+        mBandwidthBudget(0), mFrameTimeBudget(2000)
+    {
+        Root::getSingleton().addFrameListener(this);
+    }
+    //------------------------------------------------------------------------
+    ResourceStreamingQueue::~ResourceStreamingQueue()
+    {
+        Root::getSingleton().removeFrameListener(this);
+
+        // Background requests would call back once we are gone
+        ResourceBackgroundQueue* queue = ResourceBackgroundQueue::getSingletonPtr();
+        for (StreamedResourceMap::iterator i = mResources.begin(); i != mResources.end(); ++i)
+        {
+            if (i->second->state == RS_PREPARING && queue)
+                queue->abortRequest(i->second->backgroundTicket);
+            OGRE_DELETE i->second;
+        }
+    }
+    //------------------------------------------------------------------------
+    BackgroundProcessTicket ResourceStreamingQueue::request(const String& resType, const String& name,
+        const String& group, PriorityClass priority, Real distance,
+        ResourceBackgroundQueue::Listener* listener)
+    {
+        String key = resType + ":" + group + ":" + name;
+        StreamedResource*& res = mResources[key];
+        if (!res)
+        {
+            BackgroundProcessResult result;
+            ResourceManager* rm = 0;
+            try
+            {
+                rm = ResourceGroupManager::getSingleton()._getResourceManager(resType);
+            }
+            catch (Exception& e)
+            {
+                result.message = e.getFullDescription();
+            }
+
+            // Resources already loaded need no streaming, unknown types can't be streamed
+            ResourcePtr resource;
+            if (rm)
+                resource = rm->getResourceByName(name, group);
+            else
+                result.error = true;
+            if (!rm || (resource && resource->isLoaded()))
+            {
+                mResources.erase(key);
+                BackgroundProcessTicket ticket = mNextTicket++;
+                if (listener)
+                    listener->operationCompleted(ticket, result);
+                return ticket;
+            }
+
+            res = OGRE_NEW StreamedResource();
+            res->resourceType = resType;
+            res->name = name;
+            res->group = group;
+            res->key = key;
+            res->state = RS_PENDING;
+            res->backgroundTicket = 0;
+        }
+
+        // Coalesce with any other request for the resource
+        Request req;
+        req.ticket = mNextTicket++;
+        req.listener = listener;
+        req.priority = priority;
+        req.distance = distance;
+        res->requests.push_back(req);
+        res->updatePriority();
+        mTickets[req.ticket] = res;
+        return req.ticket;
+    }
+    //------------------------------------------------------------------------
+    void ResourceStreamingQueue::setPriority(BackgroundProcessTicket ticket, PriorityClass priority,
+        Real distance)
+    {
+        TicketMap::iterator t = mTickets.find(ticket);
+        if (t == mTickets.end())
+            return;
+
+        StreamedResource* res = t->second;
+        for (RequestList::iterator i = res->requests.begin(); i != res->requests.end(); ++i)
+        {
+            if (i->ticket == ticket)
+            {
+                i->priority = priority;
+                i->distance = distance;
+            }
+        }
+        res->updatePriority();
+    }
+    //------------------------------------------------------------------------
+    void ResourceStreamingQueue::cancel(BackgroundProcessTicket ticket)
+    {
+        TicketMap::iterator t = mTickets.find(ticket);
+        if (t == mTickets.end())
+            return;
+
+        StreamedResource* res = t->second;
+        mTickets.erase(t);
+        for (RequestList::iterator i = res->requests.begin(); i != res->requests.end(); ++i)
+        {
+            if (i->ticket == ticket)
+            {
+                res->requests.erase(i);
+                break;
+            }
+        }
+
+        if (res->requests.empty())
+        {
+            if (res->state == RS_PREPARING)
+            {
+                ResourceBackgroundQueue::getSingleton().abortRequest(res->backgroundTicket);
+                mBackgroundTickets.erase(res->backgroundTicket);
+                --mNumRequestsInFlight;
+            }
+            remove(res);
+        }
+        else
+        {
+            res->updatePriority();
+        }
+    }
+    //------------------------------------------------------------------------
+    void ResourceStreamingQueue::cancelBeyond(Real distance, PriorityClass priority)
+    {
+        vector<BackgroundProcessTicket>::type cancelled;
+        for (StreamedResourceMap::iterator r = mResources.begin(); r != mResources.end(); ++r)
+        {
+            const RequestList& requests = r->second->requests;
+            for (RequestList::const_iterator i = requests.begin(); i != requests.end(); ++i)
+            {
+                if (i->priority >= priority && i->distance > distance)
+                    cancelled.push_back(i->ticket);
+            }
+        }
+
+        for (size_t i = 0; i < cancelled.size(); ++i)
+            cancel(cancelled[i]);
+    }
+    //------------------------------------------------------------------------
+    bool ResourceStreamingQueue::isComplete(BackgroundProcessTicket ticket) const
+    {
+        return mTickets.find(ticket) == mTickets.end();
+    }
+    //------------------------------------------------------------------------
+    void ResourceStreamingQueue::setBandwidthLimit(size_t bytesPerSecond)
+    {
+        mBandwidthLimit = bytesPerSecond;
+        mBandwidthBudget = 0;
+    }
+    //------------------------------------------------------------------------
+    bool ResourceStreamingQueue::frameStarted(const FrameEvent& evt)
+    {
+        update(evt.timeSinceLastFrame);
+        return true;
+    }
+    //------------------------------------------------------------------------
+    void ResourceStreamingQueue::update(Real timeSinceLastUpdate)
+    {
+        // The budget may accumulate for a second at most
+        if (mBandwidthLimit)
+        {
+            mBandwidthBudget = std::min(mBandwidthBudget + mBandwidthLimit * timeSinceLastUpdate,
+                double(mBandwidthLimit));
+        }
+
+        // Listeners called by startPreparing and loadPrepared may cancel or
+        // complete further resources, so look each up again before using it
+        StringVector keys;
+        getResources(RS_PENDING, keys);
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            if (mMaxRequestsInFlight && mNumRequestsInFlight >= mMaxRequestsInFlight)
+                break;
+            StreamedResource* res = findResource(keys[i], RS_PENDING);
+            if (!res)
+                continue;
+            if (mBandwidthLimit)
+            {
+                if (mBandwidthBudget < 0)
+                    break;
+                mBandwidthBudget -= double(estimateSize(res));
+            }
+            startPreparing(res);
+        }
+
+        // Load as many prepared resources as the time budget allows, at least one
+        keys.clear();
+        getResources(RS_PREPARED, keys);
+        unsigned long start = mTimer.getMicroseconds();
+        bool loaded = false;
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            if (loaded && mTimer.getMicroseconds() - start >= mFrameTimeBudget)
+                break;
+            StreamedResource* res = findResource(keys[i], RS_PREPARED);
+            if (!res)
+                continue;
+            loadPrepared(res);
+            loaded = true;
+        }
+    }
+    //------------------------------------------------------------------------
+    void ResourceStreamingQueue::getResources(State state, StringVector& keys) const
+    {
+        vector<StreamedResource*>::type resources;
+        for (StreamedResourceMap::const_iterator i = mResources.begin(); i != mResources.end(); ++i)
+        {
+            if (i->second->state == state)
+                resources.push_back(i->second);
+        }
+        std::sort(resources.begin(), resources.end(), PriorityLess());
+
+        keys.reserve(resources.size());
+        for (size_t i = 0; i < resources.size(); ++i)
+            keys.push_back(resources[i]->key);
+    }
+    //------------------------------------------------------------------------
+    ResourceStreamingQueue::StreamedResource* ResourceStreamingQueue::findResource(const String& key,
+        State state) const
+    {
+        StreamedResourceMap::const_iterator i = mResources.find(key);
+        if (i == mResources.end() || i->second->state != state)
+            return 0;
+        return i->second;
+    }
+    //------------------------------------------------------------------------
+    void ResourceStreamingQueue::startPreparing(StreamedResource* res)
+    {
+        BackgroundProcessTicket ticket = 0;
+        try
+        {
+            ticket = ResourceBackgroundQueue::getSingleton().prepare(
+                res->resourceType, res->name, res->group, false, 0, 0, this);
+        }
+        catch (Exception& e)
+        {
+            // Without thread support the resource is prepared right away
+            BackgroundProcessResult result;
+            result.error = true;
+            result.message = e.getFullDescription();
+            complete(res, result);
+            return;
+        }
+
+        if (ticket)
+        {
+            res->state = RS_PREPARING;
+            res->backgroundTicket = ticket;
+            mBackgroundTickets[ticket] = res;
+            ++mNumRequestsInFlight;
+        }
+        else
+        {
+            res->state = RS_PREPARED;
+        }
+    }
+    //------------------------------------------------------------------------
+    void ResourceStreamingQueue::operationCompleted(BackgroundProcessTicket ticket,
+        const BackgroundProcessResult& result)
+    {
+        TicketMap::iterator t = mBackgroundTickets.find(ticket);
+        if (t == mBackgroundTickets.end())
+            return;
+
+        StreamedResource* res = t->second;
+        mBackgroundTickets.erase(t);
+        --mNumRequestsInFlight;
+
+        if (result.error)
+            complete(res, result);
+        else
+            res->state = RS_PREPARED;
+    }
+    //------------------------------------------------------------------------
+    void ResourceStreamingQueue::loadPrepared(StreamedResource* res)
+    {
+        BackgroundProcessResult result;
+        try
+        {
+            ResourceManager* rm = ResourceGroupManager::getSingleton()._getResourceManager(res->resourceType);
+            rm->load(res->name, res->group);
+        }
+        catch (Exception& e)
+        {
+            result.error = true;
+            result.message = e.getFullDescription();
+        }
+        complete(res, result);
+    }
+    //------------------------------------------------------------------------
+    void ResourceStreamingQueue::complete(StreamedResource* res, const BackgroundProcessResult& result)
+    {
+        // Listeners may request or cancel in turn, so forget about the resource first
+        RequestList requests;
+        requests.swap(res->requests);
+        for (RequestList::iterator i = requests.begin(); i != requests.end(); ++i)
+            mTickets.erase(i->ticket);
+        remove(res);
+
+        for (RequestList::iterator i = requests.begin(); i != requests.end(); ++i)
+        {
+            if (i->listener)
+                i->listener->operationCompleted(i->ticket, result);
+        }
+    }
+    //------------------------------------------------------------------------
+    void ResourceStreamingQueue::remove(StreamedResource* res)
+    {
+        mResources.erase(res->key);
+        OGRE_DELETE res;
+    }
+    //------------------------------------------------------------------------
+    size_t ResourceStreamingQueue::estimateSize(const StreamedResource* res) const
+    {
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        try
+        {
+            String group = res->group;
+            if (group == ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME)
+                group = rgm.findGroupContainingResource(res->name);
+            FileInfoListPtr files = rgm.findResourceFileInfo(group, res->name);
+            if (!files->empty())
+                return files->front().compressedSize;
+        }
+        catch (Exception&)
+        {
+        }
+        return 0;
+    }
+}
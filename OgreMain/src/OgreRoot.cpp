@@ -85,6 +85,8 @@ THE SOFTWARE.
 #include "OgreCompositorManager.h"
 #include "OgreScriptCompiler.h"
 #include "OgreWindowEventUtilities.h"
+#include "OgreMemoryStats.h"
+#include "Threading/OgreParallel.h"
 
 #if OGRE_NO_PVRTC_CODEC == 0
 #  include "OgrePVRTCCodec.h"
@@ -105,6 +107,26 @@ namespace Ogre {
         assert( msSingleton );  return ( *msSingleton );
     }
 
+    namespace {
+        /// Runs a FrameSimulation as a single item job
+        class FrameSimulationJob : public ParallelJob
+        {
+        public:
+            FrameSimulationJob(FrameSimulation* simulation, const FrameEvent& evt, FrameSnapshot& snapshot)
+                : ParallelJob(1), mSimulation(simulation), mEvent(evt), mSnapshot(snapshot) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                mSimulation->simulate(mEvent, mSnapshot);
+            }
+
+        protected:
+            FrameSimulation* mSimulation;
+            FrameEvent mEvent;
+            FrameSnapshot& mSnapshot;
+        };
+    }
+
 #if OGRE_PLATFORM != OGRE_PLATFORM_NACL
     typedef void (*DLL_START_PLUGIN)(void);
     typedef void (*DLL_STOP_PLUGIN)(void);
@@ -123,6 +145,13 @@ namespace Ogre {
       , mFreqUpdatedBuffersUploadOption(HardwareBuffer::HBU_DEFAULT)
       , mNextMovableObjectTypeFlag(1)
       , mIsInitialised(false)
+      , mFrameSimulation(0)
+      , mLastFrameSimulationTime(0)
+      , mMaxFramesInFlight(0)
+      , mTargetFrameTime(0)
+      , mLastFrameStartTime(0)
+      , mInputTime(0)
+      , mInputLatency(0)
       , mIsBlendIndicesGpuRedundant(true)
       , mIsBlendWeightsGpuRedundant(true)
     {
@@ -222,6 +251,8 @@ namespace Ogre {
         ArchiveManager::getSingleton().addArchiveFactory( mZipArchiveFactory );
         mEmbeddedZipArchiveFactory = OGRE_NEW EmbeddedZipArchiveFactory();
         ArchiveManager::getSingleton().addArchiveFactory( mEmbeddedZipArchiveFactory );
+        mIndexedZipArchiveFactory = OGRE_NEW IndexedZipArchiveFactory();
+        ArchiveManager::getSingleton().addArchiveFactory( mIndexedZipArchiveFactory );
 #   endif
 
 #if OGRE_NO_DDS_CODEC == 0
@@ -316,6 +347,7 @@ namespace Ogre {
 #   if OGRE_NO_ZIP_ARCHIVE == 0
         OGRE_DELETE mZipArchiveFactory;
         OGRE_DELETE mEmbeddedZipArchiveFactory;
+        OGRE_DELETE mIndexedZipArchiveFactory;
 #   endif
         OGRE_DELETE mFileSystemArchiveFactory;
 
@@ -831,6 +863,9 @@ namespace Ogre {
         OgreProfileBeginGroup("Frame", OGREPROF_GENERAL);
         _syncAddedRemovedFrameListeners();
 
+        if (TextureManager* textureManager = TextureManager::getSingletonPtr())
+            textureManager->_updateMipmapStreaming();
+
         // Tell all listeners
         for (set<FrameListener*>::type::iterator i = mFrameListeners.begin(); i != mFrameListeners.end(); ++i)
         {
@@ -879,6 +914,11 @@ namespace Ogre {
         // Tell the queue to process responses
         mWorkQueue->processResponses();
 
+        // Frame memory of the frame before this one may now be reused
+        FrameAllocPolicy::_nextFrame();
+
+        MemoryStats::_checkBudgets();
+
         OgreProfileEndGroup("Frame", OGREPROF_GENERAL);
 
         return ret;
@@ -981,6 +1021,16 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     bool Root::renderOneFrame(void)
     {
+        paceFrame();
+
+        if (mFrameSimulation)
+        {
+            unsigned long now = mTimer->getMicroseconds();
+            Real elapsed = mFrameSimulationJob ? (now - mLastFrameSimulationTime) * 0.000001f : 0;
+            mLastFrameSimulationTime = now;
+            advanceFrameSimulation(elapsed);
+        }
+
         if(!_fireFrameStarted())
             return false;
 
@@ -992,12 +1042,17 @@ namespace Ogre {
     //---------------------------------------------------------------------
     bool Root::renderOneFrame(Real timeSinceLastFrame)
     {
+        paceFrame();
+
         FrameEvent evt;
         evt.timeSinceLastFrame = timeSinceLastFrame;
 
         unsigned long now = mTimer->getMilliseconds();
         evt.timeSinceLastEvent = calculateEventTime(now, FETT_ANY);
 
+        if (mFrameSimulation)
+            advanceFrameSimulation(timeSinceLastFrame);
+
         if(!_fireFrameStarted(evt))
             return false;
 
@@ -1010,11 +1065,107 @@ namespace Ogre {
         return _fireFrameEnded(evt);
     }
     //-----------------------------------------------------------------------
+    void Root::setFrameSimulation(FrameSimulation* simulation)
+    {
+        if (simulation == mFrameSimulation)
+            return;
+        stopFrameSimulation();
+        mFrameSimulation = simulation;
+    }
+    //-----------------------------------------------------------------------
+    void Root::advanceFrameSimulation(Real timeSinceLastFrame)
+    {
+        // The frame simulated while the previous one rendered becomes the one to apply
+        if (mFrameSimulationJob)
+        {
+            mFrameSimulationJob->complete();
+            mFrameSnapshots[0].swap(mFrameSnapshots[1]);
+        }
+
+        FrameEvent evt;
+        evt.timeSinceLastEvent = timeSinceLastFrame;
+        evt.timeSinceLastFrame = timeSinceLastFrame;
+        mFrameSnapshots[1].clear();
+        mFrameSimulationJob = ParallelJobPtr(OGRE_NEW FrameSimulationJob(mFrameSimulation, evt, mFrameSnapshots[1]));
+        ParallelJob::start(mFrameSimulationJob);
+
+        // Applied while the next frame is simulated, before anything reads the scene
+        mFrameSnapshots[0].apply();
+        mFrameSnapshots[0].clear();
+    }
+    //-----------------------------------------------------------------------
+    void Root::stopFrameSimulation(void)
+    {
+        if (mFrameSimulationJob)
+        {
+            mFrameSimulationJob->complete();
+            mFrameSimulationJob.reset();
+        }
+        mFrameSnapshots[0].clear();
+        mFrameSnapshots[1].clear();
+    }
+    //-----------------------------------------------------------------------
+    void Root::setMaxFramesInFlight(size_t frames)
+    {
+        mMaxFramesInFlight = frames;
+        // Without a limit the pending fences would never be released
+        if (!frames && mActiveRenderer)
+            mActiveRenderer->_waitFrameFences(0);
+    }
+    //-----------------------------------------------------------------------
+    void Root::setTargetFrameTime(Real seconds)
+    {
+        mTargetFrameTime = seconds > 0 ? static_cast<unsigned long>(seconds * 1000000) : 0;
+    }
+    //-----------------------------------------------------------------------
+    void Root::markInputSampled(void)
+    {
+        mInputTime = mTimer->getMicroseconds();
+    }
+    //-----------------------------------------------------------------------
+    void Root::paceFrame(void)
+    {
+        if (mMaxFramesInFlight && mActiveRenderer)
+            mActiveRenderer->_waitFrameFences(mMaxFramesInFlight - 1);
+
+        unsigned long now = mTimer->getMicroseconds();
+        if (mTargetFrameTime && mLastFrameStartTime)
+        {
+            unsigned long target = mLastFrameStartTime + mTargetFrameTime;
+            // Sleeping may oversleep by a scheduler tick, so spin the last 2ms
+            while (now < target)
+            {
+                if (target - now > 2000)
+                    OGRE_WQ_THREAD_SLEEP(1);
+                now = mTimer->getMicroseconds();
+            }
+            // Keep to the target unless the frame ran late
+            if (now - target < mTargetFrameTime)
+                now = target;
+        }
+        mLastFrameStartTime = now;
+    }
+    //-----------------------------------------------------------------------
+    void Root::framePresented(void)
+    {
+        if (mMaxFramesInFlight)
+            mActiveRenderer->_insertFrameFence();
+
+        if (mInputTime)
+        {
+            mInputLatency = (mTimer->getMicroseconds() - mInputTime) * 0.000001f;
+            mInputTime = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
     void Root::shutdown(void)
     {
         if(mActiveRenderer)
             mActiveRenderer->_setViewport(NULL);
 
+        // The simulation runs on the work queue and refers to the scene
+        stopFrameSimulation();
+
         // Since background thread might be access resources,
         // ensure shutdown before destroying resource manager.
         mResourceBackgroundQueue->shutdown();
@@ -1035,6 +1186,7 @@ namespace Ogre {
 
         // Destroy pools
         ConvexBody::_destroyPool();
+        FrameAllocPolicy::_releaseThreadArena();
 
 
         mIsInitialised = false;
@@ -1177,6 +1329,45 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void Root::replaceFile(const String& tempFilename, const String& filename,
+        const String& groupName)
+    {
+        String tempPath = tempFilename;
+        String path = filename;
+
+        // no path elements, find the location the resource system created it in
+        String dir, basename;
+        StringUtil::splitFilename(tempFilename, basename, dir);
+        if (dir.empty())
+        {
+            try
+            {
+                FileInfoListPtr files = ResourceGroupManager::getSingleton().findResourceFileInfo(
+                    groupName, tempFilename);
+                for (FileInfoList::iterator i = files->begin(); i != files->end(); ++i)
+                {
+                    if (i->archive && i->archive->getType() == "FileSystem")
+                    {
+                        tempPath = i->archive->getName() + "/" + i->filename;
+                        path = i->archive->getName() + "/" + filename;
+                        break;
+                    }
+                }
+            }
+            catch (...) {}
+        }
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+        // rename does not replace an existing file here
+        std::remove(path.c_str());
+#endif
+        if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Can't replace " + filename + " with " + tempFilename, "Root::replaceFile");
+        }
+    }
+    //---------------------------------------------------------------------
     DataStreamPtr Root::openFileStream(const String& filename, const String& groupName,
         const String& locationPattern)
     {
@@ -1434,6 +1625,7 @@ namespace Ogre {
         bool ret = _fireFrameRenderingQueued();
         // block for final swap
         mActiveRenderer->_swapAllRenderTargetBuffers();
+        framePresented();
 
         // This belongs here, as all render targets must be updated before events are
         // triggered, otherwise targets could be mismatched.  This could produce artifacts,
@@ -1452,6 +1644,7 @@ namespace Ogre {
         bool ret = _fireFrameRenderingQueued(evt);
         // block for final swap
         mActiveRenderer->_swapAllRenderTargetBuffers();
+        framePresented();
 
         // This belongs here, as all render targets must be updated before events are
         // triggered, otherwise targets could be mismatched.  This could produce artifacts,
@@ -64,6 +64,16 @@ THE SOFTWARE.
 #include "OgreLodListener.h"
 #include "OgreInstancedGeometry.h"
 #include "OgreUnifiedHighLevelGpuProgram.h"
+#include "Threading/OgreParallel.h"
+#include "OgreNodeTransformPool.h"
+#include "OgreSoftwareSkinningBatch.h"
+#include "OgreGpuSkinningBatch.h"
+#include "OgreBillboardChainBatcher.h"
+#include "OgreRenderCommandList.h"
+#include "OgreDynamicRenderBatch.h"
+#include "OgreImpostorBatcher.h"
+#include "OgreLightClusters.h"
+#include "OgreDebugDrawer.h"
 
 // This class implements the most basic scene manager
 
@@ -114,12 +124,18 @@ mResetIdentityView(false),
 mResetIdentityProj(false),
 mNormaliseNormalsOnScale(true),
 mFlipCullingOnNegativeScale(true),
+mPassStateValid(0),
+mPassStateChangesApplied(0),
+mPassStateChangesSkipped(0),
+mDrawBatchOpen(false),
+mTextureOverrideUnits(0),
 mLightsDirtyCounter(0),
 mMovableNameGenerator("Ogre/MO"),
 mShadowCasterPlainBlackPass(0),
 mShadowReceiverPass(0),
 mDisplayNodes(false),
 mShowBoundingBoxes(false),
+mDebugDrawer(OGRE_NEW DebugDrawer()),
 mActiveCompositorChain(0),
 mLateMaterialResolving(false),
 mShadowTechnique(SHADOWTYPE_NONE),
@@ -135,6 +151,11 @@ mFullScreenQuad(0),
 mShadowDirLightExtrudeDist(10000),
 mIlluminationStage(IRS_NONE),
 mShadowTextureConfigDirty(true),
+mShadowTextureCaching(false),
+mShadowTextureCacheTexelTolerance(8),
+mStaticShadowCasterStateCount(1),
+mShadowCasterMinBlending(false),
+mShadowAtlasEnabled(false),
 mShadowUseInfiniteFarPlane(true),
 mShadowCasterRenderBackFaces(true),
 mShadowAdditiveLightClip(false),
@@ -151,6 +172,20 @@ mShadowTextureCustomCasterPass(0),
 mShadowTextureCustomReceiverPass(0),
 mVisibilityMask(0xFFFFFFFF),
 mFindVisibleObjects(true),
+mParallelUpdateDepth(0),
+mParallelCullingDepth(0),
+mTransformPool(0),
+mSoftwareSkinningBatch(0),
+mSoftwareSkinningBatchActive(false),
+mGpuSkinningBatch(0),
+mGpuSkinningBatchActive(false),
+mBillboardChainBatcher(0),
+mImpostorBatcher(0),
+mDynamicBatch(0),
+mDynamicBatchVertexLimit(300),
+mLightClusters(0),
+mParallelSorting(false),
+mSharedCulling(false),
 mSuppressRenderStateChanges(false),
 mSuppressShadows(false),
 mCameraRelativeRendering(false),
@@ -159,6 +194,7 @@ mLastLightLimit(0),
 mLastLightHashGpuProgram(0),
 mGpuParamsDirty((uint16)GPV_ALL)
 {
+    mSharedCullingState.frustum = 0;
 
     // init sky
     for (size_t i = 0; i < 5; ++i)
@@ -195,8 +231,21 @@ SceneManager::~SceneManager()
 {
     fireSceneManagerDestroyed();
     destroyShadowTextures();
+    // give the nodes their derived transforms back before destroying them
+    OGRE_DELETE mTransformPool;
+    mTransformPool = 0;
+    OGRE_DELETE mSoftwareSkinningBatch;
+    OGRE_DELETE mGpuSkinningBatch;
+    OGRE_DELETE mLightClusters;
+    OGRE_DELETE mDebugDrawer;
+    // chains destroyed with the scene no longer need to leave their batches
+    OGRE_DELETE mBillboardChainBatcher;
+    mBillboardChainBatcher = 0;
+    OGRE_DELETE mImpostorBatcher;
+    OGRE_DELETE mDynamicBatch;
     clearScene();
     destroyAllCameras();
+    destroyRenderCommandLists(0);
 
     // clear down movable object collection map
     {
@@ -348,6 +397,8 @@ void SceneManager::destroyCamera(const String& name)
         if ( camLightIt != mShadowCamLightMapping.end() )
             mShadowCamLightMapping.erase( camLightIt );
 
+        destroyRenderCommandLists(i->second);
+
         // Notify render system
         mDestRenderSystem->_notifyCameraRemoved(i->second);
         OGRE_DELETE i->second;
@@ -428,6 +479,19 @@ const LightList& SceneManager::_getLightsAffectingFrustum(void) const
     return mLightsAffectingFrustum;
 }
 //-----------------------------------------------------------------------
+void SceneManager::setLightClustering(bool enabled)
+{
+    if (enabled && !mLightClusters)
+    {
+        mLightClusters = OGRE_NEW LightClusters(mName + "/LightClusters");
+    }
+    else if (!enabled)
+    {
+        OGRE_DELETE mLightClusters;
+        mLightClusters = 0;
+    }
+}
+//-----------------------------------------------------------------------
 bool SceneManager::lightLess::operator()(const Light* a, const Light* b) const
 {
     return a->tempSquareDist < b->tempSquareDist;
@@ -827,15 +891,21 @@ SceneNode* SceneManager::createSceneNodeImpl(const String& name)
 {
     return OGRE_NEW SceneNode(this, name);
 }//-----------------------------------------------------------------------
-SceneNode* SceneManager::createSceneNode(void)
+void SceneManager::addSceneNode(SceneNode* sn)
 {
-    SceneNode* sn = createSceneNodeImpl();
 #if OGRE_NODE_STORAGE_LEGACY
     assert(mSceneNodes.find(sn->getName()) == mSceneNodes.end());
     mSceneNodes[sn->getName()] = sn;
 #else
+    sn->_setGlobalIndex(mSceneNodes.size());
     mSceneNodes.push_back(sn);
 #endif
+}
+//-----------------------------------------------------------------------
+SceneNode* SceneManager::createSceneNode(void)
+{
+    SceneNode* sn = createSceneNodeImpl();
+    addSceneNode(sn);
     return sn;
 }
 //-----------------------------------------------------------------------
@@ -851,11 +921,7 @@ SceneNode* SceneManager::createSceneNode(const String& name)
     }
 
     SceneNode* sn = createSceneNodeImpl(name);
-#if OGRE_NODE_STORAGE_LEGACY
-    mSceneNodes[sn->getName()] = sn;
-#else
-    mSceneNodes.push_back(sn);
-#endif
+    addSceneNode(sn);
     return sn;
 }
 //-----------------------------------------------------------------------
@@ -883,7 +949,7 @@ void SceneManager::_destroySceneNode(SceneNodeList::iterator i)
 
     if (i == mSceneNodes.end())
     {
-        OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "SceneNode '" + ITER_VAL(i)->getName() + "' not found.",
+        OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "SceneNode not found.",
             "SceneManager::destroySceneNode");
     }
 
@@ -920,7 +986,9 @@ void SceneManager::_destroySceneNode(SceneNodeList::iterator i)
 #if OGRE_NODE_STORAGE_LEGACY
     mSceneNodes.erase(i);
 #else
-    std::swap(*i, mSceneNodes.back());
+    // Move the last node into the gap
+    *i = mSceneNodes.back();
+    (*i)->_setGlobalIndex(i - mSceneNodes.begin());
     mSceneNodes.pop_back();
 #endif
 }
@@ -933,7 +1001,11 @@ void SceneManager::destroySceneNode(SceneNode* sn)
 #if OGRE_NODE_STORAGE_LEGACY
     destroySceneNode(sn->getName());
 #else
-    _destroySceneNode(std::find(mSceneNodes.begin(), mSceneNodes.end(), sn));
+    size_t index = sn->_getGlobalIndex();
+    if (index < mSceneNodes.size() && mSceneNodes[index] == sn)
+        _destroySceneNode(mSceneNodes.begin() + index);
+    else
+        _destroySceneNode(mSceneNodes.end());
 #endif
 }
 //-----------------------------------------------------------------------
@@ -985,6 +1057,10 @@ bool SceneManager::hasSceneNode(const String& name) const
 const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed, 
                                    bool shadowDerivation)
 {
+    // Draws batched for the previous pass must be submitted with its state
+    flushDynamicBatch();
+    endDrawBatch();
+
     //If using late material resolving, swap now.
     if (isLateMaterialResolving()) 
     {
@@ -1105,19 +1181,37 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         if (passSurfaceAndLightParams)
         {
             // Set surface reflectance properties, only valid if lighting is enabled
-            if (pass->getLightingEnabled())
+            if (pass->getLightingEnabled() &&
+                !isPassStateCurrent(PSG_SURFACE,
+                    mPassState.ambient == pass->getAmbient() &&
+                    mPassState.diffuse == pass->getDiffuse() &&
+                    mPassState.specular == pass->getSpecular() &&
+                    mPassState.selfIllumination == pass->getSelfIllumination() &&
+                    mPassState.shininess == pass->getShininess() &&
+                    mPassState.vertexColourTracking == pass->getVertexColourTracking()))
             {
+                mPassState.ambient = pass->getAmbient();
+                mPassState.diffuse = pass->getDiffuse();
+                mPassState.specular = pass->getSpecular();
+                mPassState.selfIllumination = pass->getSelfIllumination();
+                mPassState.shininess = pass->getShininess();
+                mPassState.vertexColourTracking = pass->getVertexColourTracking();
                 mDestRenderSystem->_setSurfaceParams( 
-                    pass->getAmbient(), 
-                    pass->getDiffuse(), 
-                    pass->getSpecular(), 
-                    pass->getSelfIllumination(), 
-                    pass->getShininess(),
-            pass->getVertexColourTracking() );
+                    mPassState.ambient, 
+                    mPassState.diffuse, 
+                    mPassState.specular, 
+                    mPassState.selfIllumination, 
+                    mPassState.shininess,
+                    mPassState.vertexColourTracking );
             }
 
             // Dynamic lighting enabled?
-            mDestRenderSystem->setLightingEnabled(pass->getLightingEnabled());
+            if (!isPassStateCurrent(PSG_LIGHTING,
+                    mPassState.lightingEnabled == pass->getLightingEnabled()))
+            {
+                mPassState.lightingEnabled = pass->getLightingEnabled();
+                mDestRenderSystem->setLightingEnabled(mPassState.lightingEnabled);
+            }
         }
 
         // Using a fragment program?
@@ -1177,8 +1271,21 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
             fragment program, and in other ways, them maybe access by gpu program via
             "state.fog.XXX".
             */
-            mDestRenderSystem->_setFog(
-                newFogMode, newFogColour, newFogDensity, newFogStart, newFogEnd);
+            if (!isPassStateCurrent(PSG_FOG,
+                    mPassState.fogMode == newFogMode &&
+                    mPassState.fogColour == newFogColour &&
+                    mPassState.fogDensity == newFogDensity &&
+                    mPassState.fogStart == newFogStart &&
+                    mPassState.fogEnd == newFogEnd))
+            {
+                mPassState.fogMode = newFogMode;
+                mPassState.fogColour = newFogColour;
+                mPassState.fogDensity = newFogDensity;
+                mPassState.fogStart = newFogStart;
+                mPassState.fogEnd = newFogEnd;
+                mDestRenderSystem->_setFog(
+                    newFogMode, newFogColour, newFogDensity, newFogStart, newFogEnd);
+            }
         }
         // Tell params about ORIGINAL fog
         // Need to be able to override fixed function fog, but still have
@@ -1189,44 +1296,105 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         // The rest of the settings are the same no matter whether we use programs or not
 
         // Set scene blending
+        SceneBlendFactor sourceBlendFactor = pass->getSourceBlendFactor();
+        SceneBlendFactor destBlendFactor = pass->getDestBlendFactor();
+        SceneBlendFactor sourceBlendFactorAlpha = sourceBlendFactor;
+        SceneBlendFactor destBlendFactorAlpha = destBlendFactor;
+        SceneBlendOperation blendOperation = pass->getSceneBlendingOperation();
+        SceneBlendOperation blendOperationAlpha = blendOperation;
+        bool separateBlending = false;
         if ( pass->hasSeparateSceneBlending( ) )
         {
-            mDestRenderSystem->_setSeparateSceneBlending(
-                pass->getSourceBlendFactor(), pass->getDestBlendFactor(),
-                pass->getSourceBlendFactorAlpha(), pass->getDestBlendFactorAlpha(),
-                pass->getSceneBlendingOperation(), 
-                pass->hasSeparateSceneBlendingOperations() ? pass->getSceneBlendingOperation() : pass->getSceneBlendingOperationAlpha() );
-        }
-        else
-        {
-            if(pass->hasSeparateSceneBlendingOperations( ) )
+            sourceBlendFactorAlpha = pass->getSourceBlendFactorAlpha();
+            destBlendFactorAlpha = pass->getDestBlendFactorAlpha();
+            if (!pass->hasSeparateSceneBlendingOperations())
+                blendOperationAlpha = pass->getSceneBlendingOperationAlpha();
+            separateBlending = true;
+        }
+        else if (pass->hasSeparateSceneBlendingOperations( ) )
+        {
+            blendOperationAlpha = pass->getSceneBlendingOperationAlpha();
+            separateBlending = true;
+        }
+        // Casters merged into a cached shadow texture keep the nearest value
+        if (mShadowCasterMinBlending && mIlluminationStage == IRS_RENDER_TO_TEXTURE)
+        {
+            sourceBlendFactor = sourceBlendFactorAlpha = SBF_ONE;
+            destBlendFactor = destBlendFactorAlpha = SBF_ONE;
+            blendOperation = blendOperationAlpha = SBO_MIN;
+            separateBlending = false;
+        }
+        if (!isPassStateCurrent(PSG_BLENDING,
+                mPassState.sourceBlendFactor == sourceBlendFactor &&
+                mPassState.destBlendFactor == destBlendFactor &&
+                mPassState.sourceBlendFactorAlpha == sourceBlendFactorAlpha &&
+                mPassState.destBlendFactorAlpha == destBlendFactorAlpha &&
+                mPassState.blendOperation == blendOperation &&
+                mPassState.blendOperationAlpha == blendOperationAlpha &&
+                mPassState.separateBlending == separateBlending))
+        {
+            mPassState.sourceBlendFactor = sourceBlendFactor;
+            mPassState.destBlendFactor = destBlendFactor;
+            mPassState.sourceBlendFactorAlpha = sourceBlendFactorAlpha;
+            mPassState.destBlendFactorAlpha = destBlendFactorAlpha;
+            mPassState.blendOperation = blendOperation;
+            mPassState.blendOperationAlpha = blendOperationAlpha;
+            mPassState.separateBlending = separateBlending;
+            if (separateBlending)
             {
                 mDestRenderSystem->_setSeparateSceneBlending(
-                    pass->getSourceBlendFactor(), pass->getDestBlendFactor(),
-                    pass->getSourceBlendFactor(), pass->getDestBlendFactor(),
-                    pass->getSceneBlendingOperation(), pass->getSceneBlendingOperationAlpha() );
+                    sourceBlendFactor, destBlendFactor,
+                    sourceBlendFactorAlpha, destBlendFactorAlpha,
+                    blendOperation, blendOperationAlpha );
             }
             else
             {
                 mDestRenderSystem->_setSceneBlending(
-                    pass->getSourceBlendFactor(), pass->getDestBlendFactor(), pass->getSceneBlendingOperation() );
+                    sourceBlendFactor, destBlendFactor, blendOperation );
             }
         }
 
         // Set point parameters
-        mDestRenderSystem->_setPointParameters(
-            pass->getPointSize(),
-            pass->isPointAttenuationEnabled(), 
-            pass->getPointAttenuationConstant(), 
-            pass->getPointAttenuationLinear(), 
-            pass->getPointAttenuationQuadratic(), 
-            pass->getPointMinSize(), 
-            pass->getPointMaxSize());
-
-        if (mDestRenderSystem->getCapabilities()->hasCapability(RSC_POINT_SPRITES))
-            mDestRenderSystem->_setPointSpritesEnabled(pass->getPointSpritesEnabled());
-
-        // Texture unit settings
+        if (!isPassStateCurrent(PSG_POINT,
+                mPassState.pointSize == pass->getPointSize() &&
+                mPassState.pointAttenuationEnabled == pass->isPointAttenuationEnabled() &&
+                mPassState.pointAttenuationConstant == pass->getPointAttenuationConstant() &&
+                mPassState.pointAttenuationLinear == pass->getPointAttenuationLinear() &&
+                mPassState.pointAttenuationQuadratic == pass->getPointAttenuationQuadratic() &&
+                mPassState.pointMinSize == pass->getPointMinSize() &&
+                mPassState.pointMaxSize == pass->getPointMaxSize()))
+        {
+            mPassState.pointSize = pass->getPointSize();
+            mPassState.pointAttenuationEnabled = pass->isPointAttenuationEnabled();
+            mPassState.pointAttenuationConstant = pass->getPointAttenuationConstant();
+            mPassState.pointAttenuationLinear = pass->getPointAttenuationLinear();
+            mPassState.pointAttenuationQuadratic = pass->getPointAttenuationQuadratic();
+            mPassState.pointMinSize = pass->getPointMinSize();
+            mPassState.pointMaxSize = pass->getPointMaxSize();
+            mDestRenderSystem->_setPointParameters(
+                mPassState.pointSize,
+                mPassState.pointAttenuationEnabled, 
+                mPassState.pointAttenuationConstant, 
+                mPassState.pointAttenuationLinear, 
+                mPassState.pointAttenuationQuadratic, 
+                mPassState.pointMinSize, 
+                mPassState.pointMaxSize);
+        }
+
+        if (mDestRenderSystem->getCapabilities()->hasCapability(RSC_POINT_SPRITES) &&
+            !isPassStateCurrent(PSG_POINT_SPRITES,
+                mPassState.pointSpritesEnabled == pass->getPointSpritesEnabled()))
+        {
+            mPassState.pointSpritesEnabled = pass->getPointSpritesEnabled();
+            mDestRenderSystem->_setPointSpritesEnabled(mPassState.pointSpritesEnabled);
+        }
+
+        // Texture unit settings, which only stay the same with the same pass since
+        // the texture units themselves are not compared. Shadow passes are derived
+        // into the same pass objects, so they are always set
+        bool setTextureUnits = !isPassStateCurrent(PSG_TEXTURE_UNITS,
+            mPassState.texturePass == pass && mIlluminationStage == IRS_NONE);
+        mPassState.texturePass = pass;
         size_t unit = 0;
         // Reset the shadow texture index for each pass
         size_t startLightIndex = pass->getStartLight();
@@ -1258,11 +1426,11 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
                 {
                     shadowTex = getShadowTexture(shadowTexIndex);
                     // Hook up projection frustum
-                    Camera *cam = shadowTex->getBuffer()->getRenderTarget()->getViewport(0)->getCamera();
+                    Camera *cam = mShadowTextureCameras[shadowTexIndex];
                     // Enable projective texturing if fixed-function, but also need to
                     // disable it explicitly for program pipeline.
                     pTex->setProjectiveTexturing(!pass->hasVertexProgram(), cam);
-                    mAutoParamDataSource->setTextureProjector(cam, shadowTexUnitIndex);
+                    setShadowTextureProjector(shadowTexIndex, shadowTexUnitIndex);
                 }
                 else
                 {
@@ -1316,26 +1484,66 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
                 }
                 pTex->_setTexturePtr(refTex);
             }
-            mDestRenderSystem->_setTextureUnitSettings(unit, *pTex);
+            if (setTextureUnits)
+                mDestRenderSystem->_setTextureUnitSettings(unit, *pTex);
             ++unit;
         }
         // Disable remaining texture units
-        mDestRenderSystem->_disableTextureUnitsFrom(pass->getNumTextureUnitStates());
+        if (setTextureUnits)
+        {
+            mDestRenderSystem->_disableTextureUnitsFrom(pass->getNumTextureUnitStates());
+            mTextureOverrideUnits = 0;
+        }
 
         // Set up non-texture related material settings
         // Depth buffer settings
-        mDestRenderSystem->_setDepthBufferFunction(pass->getDepthFunction());
-        mDestRenderSystem->_setDepthBufferCheckEnabled(pass->getDepthCheckEnabled());
-        mDestRenderSystem->_setDepthBufferWriteEnabled(pass->getDepthWriteEnabled());
-        mDestRenderSystem->_setDepthBias(pass->getDepthBiasConstant(), 
-            pass->getDepthBiasSlopeScale());
+        if (!isPassStateCurrent(PSG_DEPTH_FUNCTION,
+                mPassState.depthFunction == pass->getDepthFunction()))
+        {
+            mPassState.depthFunction = pass->getDepthFunction();
+            mDestRenderSystem->_setDepthBufferFunction(mPassState.depthFunction);
+        }
+        if (!isPassStateCurrent(PSG_DEPTH_CHECK,
+                mPassState.depthCheck == pass->getDepthCheckEnabled()))
+        {
+            mPassState.depthCheck = pass->getDepthCheckEnabled();
+            mDestRenderSystem->_setDepthBufferCheckEnabled(mPassState.depthCheck);
+        }
+        if (!isPassStateCurrent(PSG_DEPTH_WRITE,
+                mPassState.depthWrite == pass->getDepthWriteEnabled()))
+        {
+            mPassState.depthWrite = pass->getDepthWriteEnabled();
+            mDestRenderSystem->_setDepthBufferWriteEnabled(mPassState.depthWrite);
+        }
+        if (!isPassStateCurrent(PSG_DEPTH_BIAS,
+                mPassState.depthBiasConstant == pass->getDepthBiasConstant() &&
+                mPassState.depthBiasSlopeScale == pass->getDepthBiasSlopeScale()))
+        {
+            mPassState.depthBiasConstant = pass->getDepthBiasConstant();
+            mPassState.depthBiasSlopeScale = pass->getDepthBiasSlopeScale();
+            mDestRenderSystem->_setDepthBias(mPassState.depthBiasConstant, 
+                mPassState.depthBiasSlopeScale);
+        }
         // Alpha-reject settings
-        mDestRenderSystem->_setAlphaRejectSettings(
-            pass->getAlphaRejectFunction(), pass->getAlphaRejectValue(), pass->isAlphaToCoverageEnabled());
+        if (!isPassStateCurrent(PSG_ALPHA_REJECT,
+                mPassState.alphaRejectFunction == pass->getAlphaRejectFunction() &&
+                mPassState.alphaRejectValue == pass->getAlphaRejectValue() &&
+                mPassState.alphaToCoverage == pass->isAlphaToCoverageEnabled()))
+        {
+            mPassState.alphaRejectFunction = pass->getAlphaRejectFunction();
+            mPassState.alphaRejectValue = pass->getAlphaRejectValue();
+            mPassState.alphaToCoverage = pass->isAlphaToCoverageEnabled();
+            mDestRenderSystem->_setAlphaRejectSettings(mPassState.alphaRejectFunction,
+                mPassState.alphaRejectValue, mPassState.alphaToCoverage);
+        }
         // Set colour write mode
         // Right now we only use on/off, not per-channel
         bool colWrite = pass->getColourWriteEnabled();
-        mDestRenderSystem->_setColourBufferWriteEnabled(colWrite, colWrite, colWrite, colWrite);
+        if (!isPassStateCurrent(PSG_COLOUR_WRITE, mPassState.colourWrite == colWrite))
+        {
+            mPassState.colourWrite = colWrite;
+            mDestRenderSystem->_setColourBufferWriteEnabled(colWrite, colWrite, colWrite, colWrite);
+        }
         // Culling mode
         if (isShadowTechniqueTextureBased() 
             && mIlluminationStage == IRS_RENDER_TO_TEXTURE
@@ -1349,12 +1557,24 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         {
             mPassCullingMode = pass->getCullingMode();
         }
-        mDestRenderSystem->_setCullingMode(mPassCullingMode);
+        if (!isPassStateCurrent(PSG_CULLING, mPassState.cullingMode == mPassCullingMode))
+        {
+            mPassState.cullingMode = mPassCullingMode;
+            mDestRenderSystem->_setCullingMode(mPassCullingMode);
+        }
         
         // Shading
-        mDestRenderSystem->setShadingType(pass->getShadingMode());
+        if (!isPassStateCurrent(PSG_SHADING, mPassState.shadingMode == pass->getShadingMode()))
+        {
+            mPassState.shadingMode = pass->getShadingMode();
+            mDestRenderSystem->setShadingType(mPassState.shadingMode);
+        }
         // Polygon mode
-        mDestRenderSystem->_setPolygonMode(pass->getPolygonMode());
+        if (!isPassStateCurrent(PSG_POLYGON_MODE, mPassState.polygonMode == pass->getPolygonMode()))
+        {
+            mPassState.polygonMode = pass->getPolygonMode();
+            mDestRenderSystem->_setPolygonMode(mPassState.polygonMode);
+        }
 
         // set pass number
         mAutoParamDataSource->setPassNumber( pass->getIndex() );
@@ -1362,6 +1582,14 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         // mark global params as dirty
         mGpuParamsDirty |= (uint16)GPV_GLOBAL;
 
+        // Let the RenderSystem gather the renderables of this pass, unless
+        // they need state or parameters changed between them
+        if (pass->getDrawBatchingEnabled() && mIlluminationStage == IRS_NONE &&
+            !pass->getIteratePerLight() && pass->getPassIterationCount() == 1 &&
+            !pass->getLightScissoringEnabled() && !pass->getLightClipPlanesEnabled())
+        {
+            mDrawBatchOpen = mDestRenderSystem->_beginDrawBatch();
+        }
     }
 
     return pass;
@@ -1433,7 +1661,7 @@ void SceneManager::prepareRenderQueue(void)
 //-----------------------------------------------------------------------
 void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverlays)
 {
-    OgreProfileGroup("_renderScene", OGREPROF_GENERAL);
+    OgreProfileScopeGroup("_renderScene", OGREPROF_GENERAL);
 
     Root::getSingleton()._pushCurrentSceneManager(this);
     mActiveQueuedRenderableVisitor->targetSceneMgr = this;
@@ -1482,16 +1710,25 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
         // Update animations
         _applySceneAnimations();
         updateDirtyInstanceManagers();
+        mPassStateChangesApplied = 0;
+        mPassStateChangesSkipped = 0;
+        mAutoParamDataSource->_resetAutoConstantCounters();
         mLastFrameNumber = thisFrameNumber;
     }
 
+    // Render the queue built for a previous camera with the same culling frustum
+    // again, anything rendered in between has replaced it though
+    bool reuseQueue = canReuseRenderQueue(camera, vp);
+    if (!reuseQueue)
+        mSharedCullingState.frustum = 0;
+
     {
         // Lock scene graph mutex, no more changes until we're ready to render
             OGRE_LOCK_MUTEX(sceneGraphMutex);
 
         // Update scene graph for this camera (can happen multiple times per frame)
         {
-            OgreProfileGroup("_updateSceneGraph", OGREPROF_GENERAL);
+            OgreProfileScopeGroup("_updateSceneGraph", OGREPROF_GENERAL);
             _updateSceneGraph(camera);
 
             // Auto-track nodes
@@ -1508,16 +1745,24 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
         if (mIlluminationStage != IRS_RENDER_TO_TEXTURE && mFindVisibleObjects)
         {
             // Locate any lights which could be affecting the frustum
-            findLightsAffectingFrustum(camera);
+            if (!reuseQueue)
+                findLightsAffectingFrustum(camera);
 
-            // Are we using any shadows at all?
-            if (isShadowTechniqueInUse() && vp->getShadowsEnabled())
+            if (mLightClusters)
+            {
+                OgreProfileScopeGroup("buildLightClusters", OGREPROF_GENERAL);
+                mLightClusters->build(camera, mLightsAffectingFrustum);
+                mLightClusters->_updateTexture();
+            }
+
+            // Are we using any shadows at all? A reused queue keeps its shadow textures
+            if (!reuseQueue && isShadowTechniqueInUse() && vp->getShadowsEnabled())
             {
                 // Prepare shadow textures if texture shadow based shadowing
                 // technique in use
                 if (isShadowTechniqueTextureBased())
                 {
-                    OgreProfileGroup("prepareShadowTextures", OGREPROF_GENERAL);
+                    OgreProfileScopeGroup("prepareShadowTextures", OGREPROF_GENERAL);
 
                     // *******
                     // WARNING
@@ -1575,14 +1820,21 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
         }
 
         // Prepare render queue for receiving new objects
+        if (!reuseQueue)
         {
-            OgreProfileGroup("prepareRenderQueue", OGREPROF_GENERAL);
+            OgreProfileScopeGroup("prepareRenderQueue", OGREPROF_GENERAL);
             prepareRenderQueue();
         }
 
-        if (mFindVisibleObjects)
+        if (reuseQueue)
+        {
+            VisibleObjectsBoundsInfo& visibleBounds = mCamVisibleObjectsMap[camera];
+            visibleBounds = mSharedCullingState.visibleBounds;
+            mAutoParamDataSource->setMainCamBoundsInfo(&visibleBounds);
+        }
+        else if (mFindVisibleObjects)
         {
-            OgreProfileGroup("_findVisibleObjects", OGREPROF_CULLING);
+            OgreProfileScopeGroup("_findVisibleObjects", OGREPROF_CULLING);
 
             // Assemble an AAB on the fly which contains the scene elements visible
             // by the camera.
@@ -1596,20 +1848,66 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
             camVisObjIt->second.reset();
 
             // Parse the scene and tag visibles
+            mDebugDrawer->_beginScene();
+            if (mBillboardChainBatcher)
+                mBillboardChainBatcher->_beginScene();
+            if (mImpostorBatcher)
+                mImpostorBatcher->_beginScene();
             firePreFindVisibleObjects(vp);
-            _findVisibleObjects(camera, &(camVisObjIt->second),
-                mIlluminationStage == IRS_RENDER_TO_TEXTURE? true : false);
+            {
+                // entities queue their software skinning in the batch meanwhile,
+                // nested renders flush it as well since they may use the buffers
+                bool skinningBatchActive = mSoftwareSkinningBatchActive;
+                bool gpuSkinningBatchActive = mGpuSkinningBatchActive;
+                mSoftwareSkinningBatchActive = mSoftwareSkinningBatch != 0;
+                mGpuSkinningBatchActive = mGpuSkinningBatch != 0;
+                _findVisibleObjects(camera, &(camVisObjIt->second),
+                    mIlluminationStage == IRS_RENDER_TO_TEXTURE? true : false);
+                if (mSoftwareSkinningBatch)
+                    mSoftwareSkinningBatch->flush();
+                if (mGpuSkinningBatch)
+                    mGpuSkinningBatch->flush(this);
+                mSoftwareSkinningBatchActive = skinningBatchActive;
+                mGpuSkinningBatchActive = gpuSkinningBatchActive;
+            }
             firePostFindVisibleObjects(vp);
 
+            // Draw the debug primitives at once, not into shadow textures though
+            if (mIlluminationStage != IRS_RENDER_TO_TEXTURE)
+                mDebugDrawer->_queueForRendering(getRenderQueue());
+            mDebugDrawer->_endScene();
+
             mAutoParamDataSource->setMainCamBoundsInfo(&(camVisObjIt->second));
         }
         // Queue skies, if viewport seems it
-        if (vp->getSkiesEnabled() && mFindVisibleObjects && mIlluminationStage != IRS_RENDER_TO_TEXTURE)
+        if (vp->getSkiesEnabled() && mFindVisibleObjects && mIlluminationStage != IRS_RENDER_TO_TEXTURE &&
+            !reuseQueue)
         {
             _queueSkiesForRendering(camera);
         }
+
+        // Let the following cameras sharing the culling frustum reuse the queue
+        if (mSharedCulling && !reuseQueue && camera->getCullingFrustum() && mFindVisibleObjects &&
+            mIlluminationStage != IRS_RENDER_TO_TEXTURE)
+        {
+            mSharedCullingState.frustum = camera->getCullingFrustum();
+            mSharedCullingState.frame = thisFrameNumber;
+            mSharedCullingState.visibilityMask = vp->getVisibilityMask();
+            mSharedCullingState.materialScheme = vp->getMaterialScheme();
+            mSharedCullingState.invocationSequence = vp->_getRenderQueueInvocationSequence();
+            mSharedCullingState.shadowsEnabled = vp->getShadowsEnabled();
+            mSharedCullingState.skiesEnabled = vp->getSkiesEnabled();
+            mSharedCullingState.visibleBounds = mCamVisibleObjectsMap[camera];
+        }
     } // end lock on scene graph mutex
 
+    // Sort all queue groups at once, rendering them then skips the sorting
+    if (mParallelSorting)
+    {
+        OgreProfileScopeGroup("sortRenderQueue", OGREPROF_GENERAL);
+        getRenderQueue()->sort(camera, true);
+    }
+
     mDestRenderSystem->_beginGeometryCount();
     // Clear the viewport if required
     if (mCurrentViewport->getClearEveryFrame())
@@ -1621,6 +1919,8 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     }        
     // Begin the frame
     mDestRenderSystem->_beginFrame();
+    // Anything may have changed the render state since the last viewport
+    _invalidatePassState();
 
     // Set rasterisation mode
     mDestRenderSystem->_setPolygonMode(camera->getPolygonMode());
@@ -1642,7 +1942,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     // Render scene content
     {
-        OgreProfileGroup("_renderVisibleObjects", OGREPROF_RENDERING);
+        OgreProfileScopeGroup("_renderVisibleObjects", OGREPROF_RENDERING);
         _renderVisibleObjects();
     }
 
@@ -1658,6 +1958,19 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     Root::getSingleton()._popCurrentSceneManager(this);
 }
 //-----------------------------------------------------------------------
+bool SceneManager::canReuseRenderQueue(Camera* camera, Viewport* vp) const
+{
+    const SharedCullingState& state = mSharedCullingState;
+    return mSharedCulling && state.frustum && state.frustum == camera->getCullingFrustum() &&
+        state.frame == Root::getSingleton().getNextFrameNumber() &&
+        mFindVisibleObjects && mIlluminationStage != IRS_RENDER_TO_TEXTURE &&
+        state.visibilityMask == vp->getVisibilityMask() &&
+        state.materialScheme == vp->getMaterialScheme() &&
+        state.invocationSequence == vp->_getRenderQueueInvocationSequence() &&
+        state.shadowsEnabled == vp->getShadowsEnabled() &&
+        state.skiesEnabled == vp->getSkiesEnabled();
+}
+//-----------------------------------------------------------------------
 void SceneManager::_setDestinationRenderSystem(RenderSystem* sys)
 {
     mDestRenderSystem = sys;
@@ -2361,14 +2674,430 @@ void SceneManager::_updateSceneGraph(Camera* cam)
     // In this implementation, just update from the root
     // Smarter SceneManager subclasses may choose to update only
     //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+    if (mTransformPool)
+        updateSceneGraphPooled();
+    else if (mParallelUpdateDepth)
+        updateSceneGraphParallel();
+    else
+        getRootSceneNode()->_update(true, false);
 
     firePostUpdateSceneGraph(cam);
 }
 //-----------------------------------------------------------------------
+namespace
+{
+    /// Updates the subtrees of the scene graph below the parallel update depth
+    struct SceneGraphUpdateJob : public ParallelJob
+    {
+        Node::PendingUpdateList subtrees;
+
+        void execute(size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                subtrees[i].first->_update(true, subtrees[i].second);
+        }
+    };
+
+    /** Culls the subtrees of the scene graph below the parallel culling depth.
+    @remarks
+        Each item is a node with a flag telling whether its whole subtree is culled, or
+        the node alone which was already found visible by the calling thread. Items of
+        several cameras may be culled at once, each item tells which camera it is for.
+    */
+    struct VisibleNodesJob : public ParallelJob
+    {
+        struct Item
+        {
+            SceneNode* node;
+            bool cull;
+            size_t camera;
+
+            Item(SceneNode* n, bool c, size_t cam) : node(n), cull(c), camera(cam) {}
+        };
+
+        vector<const Camera*>::type cameras;
+        vector<Item>::type items;
+        vector<Node::NodeList>::type results;
+
+        void execute(size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (items[i].cull)
+                    items[i].node->_findVisibleNodes(cameras[items[i].camera], results[i]);
+                else
+                    results[i].push_back(items[i].node);
+            }
+        }
+
+        /// Cull the levels down to the given depth, collecting the subtrees below
+        void split(SceneNode* node, size_t depth, size_t camera)
+        {
+            if (!depth)
+            {
+                items.push_back(Item(node, true, camera));
+                return;
+            }
+
+            if (!cameras[camera]->isVisible(node->_getWorldAABB()))
+                return;
+
+            items.push_back(Item(node, false, camera));
+
+            SceneNode::ChildNodeIterator it = node->getChildIterator();
+            while (it.hasMoreElements())
+            {
+                split(static_cast<SceneNode*>(it.getNext()), depth - 1, camera);
+            }
+        }
+    };
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateSceneGraphParallel(void)
+{
+    SceneGraphUpdateJob* job = OGRE_NEW SceneGraphUpdateJob();
+    ParallelJobPtr jobPtr(job);
+    Node::NodeList updated;
+    getRootSceneNode()->_updateToDepth(false, mParallelUpdateDepth, job->subtrees, updated);
+    job->setCount(job->subtrees.size());
+
+    ParallelJob::run(jobPtr);
+
+    // bounds of the upper levels depend on their children, which come first in the list
+    for (Node::NodeList::iterator i = updated.begin(); i != updated.end(); ++i)
+    {
+        static_cast<SceneNode*>(*i)->_updateBounds();
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::findVisibleObjectsParallel(
+    Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+{
+    // Bring the frustum planes up to date here, the worker threads must only read them.
+    // Any finite box does, null and infinite boxes are decided without the planes.
+    cam->isVisible(AxisAlignedBox(Vector3::ZERO, Vector3::ZERO));
+
+    VisibleNodesJob* job = OGRE_NEW VisibleNodesJob();
+    ParallelJobPtr jobPtr(job);
+    job->cameras.push_back(cam);
+    job->split(getRootSceneNode(), mParallelCullingDepth, 0);
+    job->setCount(job->items.size());
+    job->results.resize(job->items.size());
+
+    ParallelJob::run(jobPtr);
+
+    RenderQueue* queue = getRenderQueue();
+    for (size_t i = 0; i < job->results.size(); ++i)
+    {
+        const Node::NodeList& nodes = job->results[i];
+        for (Node::NodeList::const_iterator n = nodes.begin(); n != nodes.end(); ++n)
+        {
+            static_cast<SceneNode*>(*n)->_addVisibleObjects(cam, queue, visibleBounds,
+                mDisplayNodes, onlyShadowCasters);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::cullShadowCastersParallel(const vector<Camera*>::type& cameras)
+{
+    VisibleNodesJob* job = OGRE_NEW VisibleNodesJob();
+    ParallelJobPtr jobPtr(job);
+    mCulledShadowCasters.resize(cameras.size());
+    for (size_t c = 0; c < cameras.size(); ++c)
+    {
+        Camera* cam = cameras[c];
+        // The worker threads must only read the frustum planes
+        cam->isVisible(AxisAlignedBox(Vector3::ZERO, Vector3::ZERO));
+
+        CulledShadowCasters& culled = mCulledShadowCasters[c];
+        culled.camera = cam;
+        culled.viewMatrix = cam->getViewMatrix(true);
+        culled.projMatrix = cam->getProjectionMatrix();
+        culled.nodes.clear();
+
+        job->cameras.push_back(cam);
+        job->split(getRootSceneNode(), mParallelCullingDepth, c);
+    }
+    job->setCount(job->items.size());
+    job->results.resize(job->items.size());
+
+    ParallelJob::run(jobPtr);
+
+    // the items of each camera are in scene graph order, as when culled one by one
+    for (size_t i = 0; i < job->items.size(); ++i)
+    {
+        Node::NodeList& nodes = mCulledShadowCasters[job->items[i].camera].nodes;
+        nodes.insert(nodes.end(), job->results[i].begin(), job->results[i].end());
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::clearCulledShadowCasters(void)
+{
+    // keep the node lists allocated for the next frame
+    for (CulledShadowCastersList::iterator i = mCulledShadowCasters.begin();
+        i != mCulledShadowCasters.end(); ++i)
+    {
+        i->camera = 0;
+        i->nodes.clear();
+    }
+}
+//-----------------------------------------------------------------------
+bool SceneManager::addCulledShadowCasters(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds)
+{
+    for (CulledShadowCastersList::iterator i = mCulledShadowCasters.begin();
+        i != mCulledShadowCasters.end(); ++i)
+    {
+        if (i->camera != cam)
+            continue;
+
+        // a listener may have moved the camera since
+        if (i->viewMatrix != cam->getViewMatrix(true) || i->projMatrix != cam->getProjectionMatrix())
+            return false;
+
+        RenderQueue* queue = getRenderQueue();
+        for (Node::NodeList::iterator n = i->nodes.begin(); n != i->nodes.end(); ++n)
+        {
+            static_cast<SceneNode*>(*n)->_addVisibleObjects(cam, queue, visibleBounds,
+                mDisplayNodes, true);
+        }
+        return true;
+    }
+    return false;
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateSceneGraphPooled(void)
+{
+    Node::NodeList updated;
+    mTransformPool->update(getRootSceneNode(), updated);
+
+    // bounds depend on the children, which come after their parents in the list
+    for (Node::NodeList::reverse_iterator i = updated.rbegin(); i != updated.rend(); ++i)
+    {
+        static_cast<SceneNode*>(*i)->_updateBounds();
+    }
+}
+//-----------------------------------------------------------------------
+bool SceneManager::setOption( const String& strKey, const void* pValue )
+{
+    if (strKey == "ParallelUpdateDepth" && isParallelUpdateSafe())
+    {
+        mParallelUpdateDepth = *static_cast<const size_t*>(pValue);
+        return true;
+    }
+
+    if (strKey == "ParallelCullingDepth" && isParallelUpdateSafe())
+    {
+        mParallelCullingDepth = *static_cast<const size_t*>(pValue);
+        return true;
+    }
+
+    if (strKey == "TransformPool" && isParallelUpdateSafe())
+    {
+        bool enable = *static_cast<const bool*>(pValue);
+        if (enable && !mTransformPool)
+        {
+            mTransformPool = OGRE_NEW NodeTransformPool();
+            mTransformPool->attachHierarchy(getRootSceneNode(), 0);
+        }
+        else if (!enable && mTransformPool)
+        {
+            OGRE_DELETE mTransformPool;
+            mTransformPool = 0;
+        }
+        return true;
+    }
+
+    if (strKey == "ParallelSoftwareSkinning")
+    {
+        bool enable = *static_cast<const bool*>(pValue);
+        if (enable && !mSoftwareSkinningBatch)
+        {
+            mSoftwareSkinningBatch = OGRE_NEW SoftwareSkinningBatch();
+        }
+        else if (!enable && mSoftwareSkinningBatch && !mSoftwareSkinningBatchActive)
+        {
+            OGRE_DELETE mSoftwareSkinningBatch;
+            mSoftwareSkinningBatch = 0;
+        }
+        return true;
+    }
+
+    if (strKey == "GpuSkinning")
+    {
+        bool enable = *static_cast<const bool*>(pValue);
+        if (enable && !mGpuSkinningBatch)
+        {
+            mGpuSkinningBatch = OGRE_NEW GpuSkinningBatch();
+        }
+        else if (!enable && mGpuSkinningBatch && !mGpuSkinningBatchActive)
+        {
+            OGRE_DELETE mGpuSkinningBatch;
+            mGpuSkinningBatch = 0;
+        }
+        return true;
+    }
+
+    if (strKey == "BatchBillboardChains")
+    {
+        bool enable = *static_cast<const bool*>(pValue);
+        if (enable && !mBillboardChainBatcher)
+        {
+            mBillboardChainBatcher = OGRE_NEW BillboardChainBatcher();
+        }
+        else if (!enable && mBillboardChainBatcher)
+        {
+            OGRE_DELETE mBillboardChainBatcher;
+            mBillboardChainBatcher = 0;
+        }
+        return true;
+    }
+
+    if (strKey == "DynamicBatching")
+    {
+        bool enable = *static_cast<const bool*>(pValue);
+        if (enable && !mDynamicBatch)
+        {
+            mDynamicBatch = OGRE_NEW DynamicRenderBatch();
+            mDynamicBatch->setVertexLimit(mDynamicBatchVertexLimit);
+        }
+        else if (!enable && mDynamicBatch)
+        {
+            OGRE_DELETE mDynamicBatch;
+            mDynamicBatch = 0;
+        }
+        return true;
+    }
+
+    if (strKey == "DynamicBatchVertexLimit")
+    {
+        mDynamicBatchVertexLimit = *static_cast<const size_t*>(pValue);
+        if (mDynamicBatch)
+            mDynamicBatch->setVertexLimit(mDynamicBatchVertexLimit);
+        return true;
+    }
+
+    if (strKey == "SharedCulling")
+    {
+        mSharedCulling = *static_cast<const bool*>(pValue);
+        mSharedCullingState.frustum = 0;
+        return true;
+    }
+
+    if (strKey == "ParallelSorting")
+    {
+        mParallelSorting = *static_cast<const bool*>(pValue);
+        return true;
+    }
+
+    return false;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::getOption( const String& strKey, void* pDestValue )
+{
+    if (strKey == "ParallelUpdateDepth" && isParallelUpdateSafe())
+    {
+        *static_cast<size_t*>(pDestValue) = mParallelUpdateDepth;
+        return true;
+    }
+
+    if (strKey == "ParallelCullingDepth" && isParallelUpdateSafe())
+    {
+        *static_cast<size_t*>(pDestValue) = mParallelCullingDepth;
+        return true;
+    }
+
+    if (strKey == "TransformPool" && isParallelUpdateSafe())
+    {
+        *static_cast<bool*>(pDestValue) = mTransformPool != 0;
+        return true;
+    }
+
+    if (strKey == "ParallelSoftwareSkinning")
+    {
+        *static_cast<bool*>(pDestValue) = mSoftwareSkinningBatch != 0;
+        return true;
+    }
+
+    if (strKey == "GpuSkinning")
+    {
+        *static_cast<bool*>(pDestValue) = mGpuSkinningBatch != 0;
+        return true;
+    }
+
+    if (strKey == "BatchBillboardChains")
+    {
+        *static_cast<bool*>(pDestValue) = mBillboardChainBatcher != 0;
+        return true;
+    }
+
+    if (strKey == "DynamicBatching")
+    {
+        *static_cast<bool*>(pDestValue) = mDynamicBatch != 0;
+        return true;
+    }
+
+    if (strKey == "DynamicBatchVertexLimit")
+    {
+        *static_cast<size_t*>(pDestValue) = mDynamicBatchVertexLimit;
+        return true;
+    }
+
+    if (strKey == "SharedCulling")
+    {
+        *static_cast<bool*>(pDestValue) = mSharedCulling;
+        return true;
+    }
+
+    if (strKey == "ParallelSorting")
+    {
+        *static_cast<bool*>(pDestValue) = mParallelSorting;
+        return true;
+    }
+
+    return false;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::hasOption( const String& strKey ) const
+{
+    return strKey == "ParallelSoftwareSkinning" || strKey == "GpuSkinning" ||
+        strKey == "BatchBillboardChains" ||
+        strKey == "DynamicBatching" || strKey == "DynamicBatchVertexLimit" ||
+        strKey == "SharedCulling" || strKey == "ParallelSorting" || ((strKey == "ParallelUpdateDepth" || strKey == "TransformPool" ||
+        strKey == "ParallelCullingDepth") && isParallelUpdateSafe());
+}
+//-----------------------------------------------------------------------
+bool SceneManager::getOptionKeys( StringVector& refKeys )
+{
+    refKeys.push_back("ParallelSoftwareSkinning");
+    refKeys.push_back("GpuSkinning");
+    refKeys.push_back("BatchBillboardChains");
+    refKeys.push_back("DynamicBatching");
+    refKeys.push_back("DynamicBatchVertexLimit");
+    refKeys.push_back("SharedCulling");
+    refKeys.push_back("ParallelSorting");
+    if (isParallelUpdateSafe())
+    {
+        refKeys.push_back("ParallelUpdateDepth");
+        refKeys.push_back("TransformPool");
+        refKeys.push_back("ParallelCullingDepth");
+    }
+    return true;
+}
+//-----------------------------------------------------------------------
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
+    // shadow cameras are culled all at once by prepareShadowTextures
+    if (onlyShadowCasters && mIlluminationStage == IRS_RENDER_TO_TEXTURE &&
+        addCulledShadowCasters(cam, visibleBounds))
+        return;
+
+    if (mParallelCullingDepth)
+    {
+        findVisibleObjectsParallel(cam, visibleBounds, onlyShadowCasters);
+        return;
+    }
+
     // Tell nodes to find, cascade down all nodes
     getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
         mDisplayNodes, onlyShadowCasters);
@@ -2419,6 +3148,7 @@ void SceneManager::renderVisibleObjectsCustomSequence(RenderQueueInvocationSeque
             }
 
             // Invoke it
+            mDestRenderSystem->_setCurrentRenderQueue(qId);
             invocation->invoke(queueGroup, this);
 
             // Fire queue ended event
@@ -2472,7 +3202,10 @@ void SceneManager::renderVisibleObjectsDefaultSequence(void)
                 break;
             }
 
+            OgreProfileBeginGPUTimer("RenderQueue " + StringConverter::toString(qId));
+            mDestRenderSystem->_setCurrentRenderQueue(qId);
             _renderQueueGroupObjects(pGroup, QueuedRenderableCollection::OM_PASS_GROUP);
+            OgreProfileEndGPUTimer();
 
             // Fire queue ended event
             if (fireRenderQueueEnded(qId, 
@@ -2560,6 +3293,7 @@ void SceneManager::renderAdditiveStencilShadowedQueueGroupObjects(
             mDestRenderSystem->setStencilBufferParams();
             mDestRenderSystem->setStencilCheckEnabled(false);
             mDestRenderSystem->_setDepthBufferParams();
+            _invalidatePassState(PSG_DEPTH_FUNCTION | PSG_DEPTH_CHECK | PSG_DEPTH_WRITE);
 
             if (scissored == CLIPPED_SOME)
                 resetScissor();
@@ -2644,6 +3378,7 @@ void SceneManager::renderModulativeStencilShadowedQueueGroupObjects(
             mDestRenderSystem->setStencilBufferParams();
             mDestRenderSystem->setStencilCheckEnabled(false);
             mDestRenderSystem->_setDepthBufferParams();
+            _invalidatePassState(PSG_DEPTH_FUNCTION | PSG_DEPTH_CHECK | PSG_DEPTH_WRITE);
         }
 
     }// for each light
@@ -2781,7 +3516,8 @@ void SceneManager::renderModulativeTextureShadowedQueueGroupObjects(
             // Store current shadow texture
             mCurrentShadowTexture = si->get();
             // Get camera for current shadow texture
-            Camera *cam = mCurrentShadowTexture->getBuffer()->getRenderTarget()->getViewport(0)->getCamera();
+            size_t shadowIndex = si - mShadowTextures.begin();
+            Camera *cam = mShadowTextureCameras[shadowIndex];
             // Hook up receiver texture
             Pass* targetPass = mShadowTextureCustomReceiverPass ?
                 mShadowTextureCustomReceiverPass : mShadowReceiverPass;
@@ -2795,7 +3531,7 @@ void SceneManager::renderModulativeTextureShadowedQueueGroupObjects(
             texUnit->setTextureAddressingMode(TextureUnitState::TAM_BORDER);
             texUnit->setTextureBorderColour(ColourValue::White);
 
-            mAutoParamDataSource->setTextureProjector(cam, 0);
+            setShadowTextureProjector(shadowIndex, 0);
             // if this light is a spotlight, we need to add the spot fader layer
             // BUT not if using a custom projection matrix, since then it will be
             // inappropriately shaped most likely
@@ -2914,7 +3650,8 @@ void SceneManager::renderAdditiveTextureShadowedQueueGroupObjects(
                     // Store current shadow texture
                     mCurrentShadowTexture = si->get();
                     // Get camera for current shadow texture
-                    Camera *cam = mCurrentShadowTexture->getBuffer()->getRenderTarget()->getViewport(0)->getCamera();
+                    size_t shadowIndex = si - mShadowTextures.begin();
+                    Camera *cam = mShadowTextureCameras[shadowIndex];
                     // Hook up receiver texture
                     Pass* targetPass = mShadowTextureCustomReceiverPass ?
                         mShadowTextureCustomReceiverPass : mShadowReceiverPass;
@@ -2927,7 +3664,7 @@ void SceneManager::renderAdditiveTextureShadowedQueueGroupObjects(
                     // clamp to border colour in case this is a custom material
                     texUnit->setTextureAddressingMode(TextureUnitState::TAM_BORDER);
                     texUnit->setTextureBorderColour(ColourValue::White);
-                    mAutoParamDataSource->setTextureProjector(cam, 0);
+                    setShadowTextureProjector(shadowIndex, 0);
                     // Remove any spot fader layer
                     if (targetPass->getNumTextureUnitStates() > 1 && 
                         targetPass->getTextureUnitState(1)->getTextureName() 
@@ -3038,8 +3775,15 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::visit(Renderable* r)
     // Give SM a chance to eliminate
     if (targetSceneMgr->validateRenderableForRendering(mUsedPass, r))
     {
+        // Recorded lists replay the renderables themselves, so don't merge them
+        if (!commandList && targetSceneMgr->addToDynamicBatch(r, mUsedPass, scissoring,
+                autoLights, manualLightList))
+            return;
+
         // Render a single object, this will set up auto params if required
         targetSceneMgr->renderSingleObject(r, mUsedPass, scissoring, autoLights, manualLightList);
+        if (commandList)
+            commandList->recordRenderable(r, scissoring, autoLights, manualLightList);
     }
 }
 //-----------------------------------------------------------------------
@@ -3051,6 +3795,8 @@ bool SceneManager::SceneMgrQueuedRenderableVisitor::visit(const Pass* p)
 
     // Set pass, store the actual one used
     mUsedPass = targetSceneMgr->_setPass(p);
+    if (commandList)
+        commandList->recordPass(p);
 
 
     return true;
@@ -3071,6 +3817,12 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::visit(RenderablePass* rp)
         mUsedPass = targetSceneMgr->_setPass(rp->pass);
         targetSceneMgr->renderSingleObject(rp->renderable, mUsedPass, scissoring, 
             autoLights, manualLightList);
+        if (commandList)
+        {
+            commandList->recordPass(rp->pass);
+            commandList->recordRenderable(rp->renderable, scissoring, 
+                autoLights, manualLightList);
+        }
     }
 }
 //-----------------------------------------------------------------------
@@ -3141,6 +3893,8 @@ void SceneManager::renderObjects(const QueuedRenderableCollection& objs,
     mActiveQueuedRenderableVisitor->scissoring = lightScissoringClipping;
     // Use visitor
     objs.acceptVisitor(mActiveQueuedRenderableVisitor, om);
+    flushDynamicBatch();
+    endDrawBatch();
 }
 //-----------------------------------------------------------------------
 void SceneManager::_renderQueueGroupObjects(RenderQueueGroup* pGroup, 
@@ -3206,6 +3960,34 @@ void SceneManager::_renderQueueGroupObjects(RenderQueueGroup* pGroup,
 void SceneManager::renderBasicQueueGroupObjects(RenderQueueGroup* pGroup, 
                                                 QueuedRenderableCollection::OrganisationMode om)
 {
+    // Replay or record the group if it allows it. Only the pass grouped order
+    // does not depend on the camera position, and a custom visitor or late
+    // material resolving may render something other than what was queued
+    RenderCommandList* commandList = 0;
+    if (pGroup->getCommandListEnabled() && 
+        om == QueuedRenderableCollection::OM_PASS_GROUP &&
+        mActiveQueuedRenderableVisitor == &mDefaultQueuedRenderableVisitor &&
+        !isLateMaterialResolving() && mIlluminationStage == IRS_NONE &&
+        !mSuppressRenderStateChanges)
+    {
+        RenderCommandListKey key(mCameraInProgress, pGroup);
+        RenderCommandListMap::iterator i = mRenderCommandLists.find(key);
+        if (i == mRenderCommandLists.end())
+        {
+            i = mRenderCommandLists.insert(RenderCommandListMap::value_type(
+                key, OGRE_NEW RenderCommandList())).first;
+        }
+        commandList = i->second;
+
+        if (commandList->isValidFor(pGroup->getContentHash()))
+        {
+            renderCommandList(*commandList);
+            return;
+        }
+        commandList->beginRecording(pGroup->getContentHash());
+    }
+    mActiveQueuedRenderableVisitor->commandList = commandList;
+
     // Basic render loop
     // Iterate through priorities
     RenderQueueGroup::PriorityMapIterator groupIt = pGroup->getIterator();
@@ -3217,16 +3999,73 @@ void SceneManager::renderBasicQueueGroupObjects(RenderQueueGroup* pGroup,
         // Sort the queue first
         pPriorityGrp->sort(mCameraInProgress);
 
+        if (commandList && commandList->isRecording() &&
+            (!pPriorityGrp->getSolidsBasic().hasOrganisationMode(om) ||
+             !pPriorityGrp->getTransparentsUnsorted().hasOrganisationMode(om)))
+        {
+            commandList->abortRecording();
+        }
+
         // Do solids
         renderObjects(pPriorityGrp->getSolidsBasic(), om, true, true);
         // Do unsorted transparents
         renderObjects(pPriorityGrp->getTransparentsUnsorted(), om, true, true);
         // Do transparents (always descending)
+        size_t numCommands = commandList ? commandList->getCommands().size() : 0;
         renderObjects(pPriorityGrp->getTransparents(), 
             QueuedRenderableCollection::OM_SORT_DESCENDING, true, true);
+        // Their order depends on the camera position, so they cannot be replayed
+        if (commandList && commandList->getCommands().size() != numCommands)
+            commandList->abortRecording();
 
 
     }// for each priority
+
+    if (commandList)
+    {
+        commandList->endRecording();
+        mActiveQueuedRenderableVisitor->commandList = 0;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::renderCommandList(const RenderCommandList& commandList)
+{
+    const RenderCommandList::CommandList& commands = commandList.getCommands();
+    const Pass* usedPass = 0;
+    RenderCommandList::CommandList::const_iterator i, iend = commands.end();
+    for (i = commands.begin(); i != iend; ++i)
+    {
+        if (i->pass)
+            usedPass = _setPass(i->pass);
+        else
+            renderSingleObject(i->renderable, usedPass, i->scissoring, 
+                i->autoLights, i->manualLightList);
+    }
+    endDrawBatch();
+}
+//-----------------------------------------------------------------------
+void SceneManager::destroyRenderCommandLists(const Camera* cam)
+{
+    RenderCommandListMap::iterator i = mRenderCommandLists.begin();
+    while (i != mRenderCommandLists.end())
+    {
+        if (!cam || i->first.first == cam)
+        {
+            OGRE_DELETE i->second;
+            mRenderCommandLists.erase(i++);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::invalidateRenderCommandLists(void)
+{
+    RenderCommandListMap::iterator i, iend = mRenderCommandLists.end();
+    for (i = mRenderCommandLists.begin(); i != iend; ++i)
+        i->second->invalidate();
 }
 //-----------------------------------------------------------------------
 void SceneManager::renderTransparentShadowCasterObjects(
@@ -3326,6 +4165,9 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
             ++unit;
         }
 
+        if (mTextureOverrideUnits || !rend->getTextureOverrides().empty())
+            setTextureOverrides(rend, pass);
+
         // Sort out normalisation
         // Assume first world matrix representative - shaders that use multiple
         // matrices should control renormalisation themselves
@@ -3360,6 +4202,8 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
             // for same pass
             if (cullMode != mDestRenderSystem->_getCullingMode())
                 mDestRenderSystem->_setCullingMode(cullMode);
+            if (cullMode != mPassState.cullingMode)
+                _invalidatePassState(PSG_CULLING);
         }
 
         // Set up the solid / wireframe override
@@ -3377,6 +4221,8 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
             }
         }
         mDestRenderSystem->_setPolygonMode(reqMode);
+        if (reqMode != mPassState.polygonMode)
+            _invalidatePassState(PSG_POLYGON_MODE);
 
         if (doLightIteration)
         {
@@ -3466,14 +4312,15 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
                                         pass->getTextureUnitState(tuindex));
                                 const TexturePtr& shadowTex = mShadowTextures[shadowTexIndex];
                                 tu->_setTexturePtr(shadowTex);
-                                Camera *cam = shadowTex->getBuffer()->getRenderTarget()->getViewport(0)->getCamera();
+                                Camera *cam = mShadowTextureCameras[shadowTexIndex];
                                 tu->setProjectiveTexturing(!pass->hasVertexProgram(), cam);
-                                mAutoParamDataSource->setTextureProjector(cam, numShadowTextureLights);
+                                setShadowTextureProjector(shadowTexIndex, numShadowTextureLights);
                                 ++numShadowTextureLights;
                                 ++shadowTexIndex;
                                 // Have to set TU on rendersystem right now, although
                                 // autoparams will be set later
                                 mDestRenderSystem->_setTextureUnitSettings(tuindex, *tu);
+                                _invalidatePassState(PSG_TEXTURE_UNITS);
                             }
                         }
 
@@ -3592,6 +4439,7 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
 
                     // Set modified depth bias right away
                     mDestRenderSystem->_setDepthBias(depthBiasBase, pass->getDepthBiasSlopeScale());
+                    _invalidatePassState(PSG_DEPTH_BIAS);
 
                     // Set to increment internally too if rendersystem iterates
                     mDestRenderSystem->setDeriveDepthBias(true, 
@@ -3963,6 +4811,7 @@ void SceneManager::manualRender(RenderOperation* rend,
         updateGpuProgramParameters(pass);
     }
     mDestRenderSystem->_render(*rend);
+    endDrawBatch();
 
     if (doBeginEndFrame)
         mDestRenderSystem->_endFrame();
@@ -4007,13 +4856,47 @@ void SceneManager::manualRender(Renderable* rend, const Pass* pass, Viewport* vp
     if (vp)
         mCurrentViewport = vp;
     renderSingleObject(rend, pass, lightScissoringClipping, doLightIteration, manualLightList);
-
+    endDrawBatch();
 
     if (doBeginEndFrame)
         mDestRenderSystem->_endFrame();
 
 }
 //---------------------------------------------------------------------
+void SceneManager::setTextureOverrides(const Renderable* rend, const Pass* pass)
+{
+    uint32 overridden = 0;
+    const Renderable::TextureOverrideMap& overrides = rend->getTextureOverrides();
+    for (Renderable::TextureOverrideMap::const_iterator i = overrides.begin(); i != overrides.end(); ++i)
+    {
+        const TextureUnitState* tus = pass->getTextureUnitState(i->first);
+        if (!tus)
+            continue;
+
+        unsigned short unit = pass->getTextureUnitStateIndex(tus);
+        if (unit >= 32)
+            continue;
+
+        mDestRenderSystem->_setTexture(unit, true, i->second);
+        overridden |= 1u << unit;
+    }
+
+    // Units overridden by the previous renderable of this pass get their own texture back
+    uint32 restore = mTextureOverrideUnits & ~overridden;
+    for (unsigned short unit = 0; restore && unit < pass->getNumTextureUnitStates(); ++unit)
+    {
+        if (restore & (1u << unit))
+        {
+            mDestRenderSystem->_setTextureUnitSettings(unit, *pass->getTextureUnitStates()[unit]);
+            restore &= ~(1u << unit);
+        }
+    }
+
+    mTextureOverrideUnits = overridden;
+    // The next pass must bind its texture units, even if it is this one
+    _invalidatePassState(PSG_TEXTURE_UNITS);
+}
+//---------------------------------------------------------------------
 void SceneManager::useRenderableViewProjMode(const Renderable* pRend, bool fixedFunction)
 {
     // Check view matrix
@@ -5832,6 +6715,8 @@ void SceneManager::renderShadowVolumesToStencil(const Light* light,
     mDestRenderSystem->_setDepthBufferParams();
 
     mDestRenderSystem->setStencilCheckEnabled(false);
+    // The volumes were rendered without going through _setPass
+    _invalidatePassState();
 
     mDestRenderSystem->unbindGpuProgram(GPT_VERTEX_PROGRAM);
 
@@ -5979,6 +6864,7 @@ void SceneManager::setShadowVolumeStencilState(bool secondpass, bool zfail, bool
             );
     }
     mDestRenderSystem->_setCullingMode(mPassCullingMode);
+    _invalidatePassState(PSG_CULLING | PSG_DEPTH_FUNCTION);
 
 }
 //---------------------------------------------------------------------
@@ -6306,8 +7192,26 @@ void SceneManager::ensureShadowTexturesCreated()
     if (mShadowTextureConfigDirty)
     {
         destroyShadowTextures();
-        ShadowTextureManager::getSingleton().getShadowTextures(
-            mShadowTextureConfigList, mShadowTextures);
+        if (mShadowAtlasEnabled && !mShadowTextureConfigList.empty())
+        {
+            if (mShadowTextureConfigList.size() > mShadowAtlasAllocator.getMaxRegions())
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "The shadow atlas is too small for a minimum size region per shadow texture",
+                    "SceneManager::ensureShadowTexturesCreated");
+            }
+            // every shadow texture refers to the atlas
+            ShadowTextureConfig atlasConfig = mShadowTextureConfigList[0];
+            atlasConfig.width = atlasConfig.height = mShadowAtlasAllocator.getAtlasSize();
+            mShadowTextures.assign(mShadowTextureConfigList.size(),
+                ShadowTextureManager::getSingleton().getShadowAtlas(atlasConfig));
+        }
+        else
+        {
+            ShadowTextureManager::getSingleton().getShadowTextures(
+                mShadowTextureConfigList, mShadowTextures);
+        }
+        mShadowTextureRegions.assign(mShadowTextures.size(), Vector4(0, 0, 1, 1));
 
         // clear shadow cam - light mapping
         mShadowCamLightMapping.clear();
@@ -6325,11 +7229,17 @@ void SceneManager::ensureShadowTexturesCreated()
             String camName = shadowTex->getName() + "Cam";
             // Material names are global to SM, make specific
             String matName = shadowTex->getName() + "Mat" + getName();
+            if (mShadowAtlasEnabled)
+            {
+                // the atlas is shared by all shadow textures
+                camName += StringConverter::toString(__i);
+                matName += StringConverter::toString(__i);
+            }
 
             RenderTexture *shadowRTT = shadowTex->getBuffer()->getRenderTarget();
 
             //Set appropriate depth buffer
-            shadowRTT->setDepthBufferPool( mShadowTextureConfigList[__i].depthBufferPoolId );
+            shadowRTT->setDepthBufferPool( mShadowTextureConfigList[mShadowAtlasEnabled ? 0 : __i].depthBufferPoolId );
 
             // Create camera for this texture, but note that we have to rebind
             // in prepareShadowTextures to coexist with multiple SMs
@@ -6338,7 +7248,11 @@ void SceneManager::ensureShadowTexturesCreated()
             mShadowTextureCameras.push_back(cam);
 
             // Create a viewport, if not there already
-            if (shadowRTT->getNumViewports() == 0)
+            if (mShadowAtlasEnabled)
+            {
+                getShadowTextureViewport(__i);
+            }
+            else if (shadowRTT->getNumViewports() == 0)
             {
                 // Note camera assignment is transient when multiple SMs
                 Viewport *v = shadowRTT->addViewport(cam);
@@ -6398,7 +7312,9 @@ void SceneManager::ensureShadowTexturesCreated()
 //---------------------------------------------------------------------
 void SceneManager::destroyShadowTextures(void)
 {
-    
+    // the cache viewports refer to the texture cameras
+    destroyShadowTextureCaches();
+
     ShadowTextureList::iterator i, iend;
     iend = mShadowTextures.end();
     for (i = mShadowTextures.begin(); i != iend; ++i)
@@ -6407,6 +7323,15 @@ void SceneManager::destroyShadowTextures(void)
 
         // Cleanup material that references this texture
         String matName = shadowTex->getName() + "Mat" + getName();
+        if (mShadowAtlasEnabled)
+        {
+            size_t index = i - mShadowTextures.begin();
+            matName += StringConverter::toString(index);
+            // the region viewports refer to the cameras destroyed below
+            RenderTarget* shadowRTT = shadowTex->getBuffer()->getRenderTarget();
+            if (shadowRTT->hasViewportWithZOrder(static_cast<int>(index)))
+                shadowRTT->removeViewport(static_cast<int>(index));
+        }
         MaterialPtr mat = MaterialManager::getSingleton().getByName(matName);
         if (mat)
         {
@@ -6426,6 +7351,7 @@ void SceneManager::destroyShadowTextures(void)
     }
     mShadowTextures.clear();
     mShadowTextureCameras.clear();
+    mShadowTextureUpdates.clear();
 
     // Will destroy if no other scene managers referencing
     ShadowTextureManager::getSingleton().clearUnused();
@@ -6487,6 +7413,12 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
         ci = mShadowTextureCameras.begin();
         mShadowTextureIndexLightList.clear();
         size_t shadowTextureIndex = 0;
+
+        // Set up the cameras of all textures first, so that their casters
+        // can be culled at once. The light and iteration of each texture.
+        frame_vector<std::pair<Light*, size_t> >::type textureLights;
+        mShadowTextureUpdates.resize(mShadowTextures.size());
+        unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
         for (i = lightList->begin(), si = mShadowTextures.begin();
             i != iend && si != siend; ++i)
         {
@@ -6496,19 +7428,12 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
             if (!light->getCastShadows())
                 continue;
 
-            if (mShadowTextureCurrentCasterLightList.empty())
-                mShadowTextureCurrentCasterLightList.push_back(light);
-            else
-                mShadowTextureCurrentCasterLightList[0] = light;
-
-
             // texture iteration per light.
             size_t textureCountPerLight = mShadowTextureCountPerType[light->getType()];
             for (size_t j = 0; j < textureCountPerLight && si != siend; ++j)
             {
                 TexturePtr &shadowTex = *si;
-                RenderTarget *shadowRTT = shadowTex->getBuffer()->getRenderTarget();
-                Viewport *shadowView = shadowRTT->getViewport(0);
+                Viewport *shadowView = getShadowTextureViewport(si - mShadowTextures.begin());
                 Camera *texCam = *ci;
                 // rebind camera, incase another SM in use which has switched to its cam
                 shadowView->setCamera(texCam);
@@ -6530,20 +7455,51 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
                 assert(camLightIt != mShadowCamLightMapping.end());
                 camLightIt->second = light;
 
-                if (!light->getCustomShadowCameraSetup())
-                    mDefaultShadowCameraSetup->getShadowCamera(this, cam, vp, light, texCam, j);
+                // let the camera setup start from the light again if the
+                // cached frustum was kept last time
+                size_t cacheIndex = si - mShadowTextures.begin();
+                if (cacheIndex < mShadowTextureCaches.size() &&
+                    mShadowTextureCaches[cacheIndex].cameraOverridden)
+                {
+                    texCam->setCustomViewMatrix(false);
+                    texCam->setCustomProjectionMatrix(false);
+                    mShadowTextureCaches[cacheIndex].cameraOverridden = false;
+                }
+                ShadowTextureUpdate& update = mShadowTextureUpdates[cacheIndex];
+                if (update.skipped)
+                {
+                    texCam->setCustomViewMatrix(false);
+                    texCam->setCustomProjectionMatrix(false);
+                    update.skipped = false;
+                }
+
+                const ShadowCameraSetup* cameraSetup = light->getCustomShadowCameraSetup() ?
+                    light->getCustomShadowCameraSetup().get() : mDefaultShadowCameraSetup.get();
+                if (!mShadowAtlasEnabled && update.texture == shadowTex.get() &&
+                    update.light == light && update.camera == cam &&
+                    !cameraSetup->isShadowCameraUpdateDue(j, mShadowTextureIndexLightList.size(), frameNumber))
+                {
+                    // keep the texture, and the frustum it was rendered with for the receivers
+                    texCam->setCustomViewMatrix(true, update.viewMatrix);
+                    texCam->setCustomProjectionMatrix(true, update.projMatrix);
+                    update.skipped = true;
+                }
                 else
-                    light->getCustomShadowCameraSetup()->getShadowCamera(this, cam, vp, light, texCam, j);
+                {
+                    cameraSetup->getShadowCamera(this, cam, vp, light, texCam, j);
+
+                    // keep the cached frustum now already, so it is the one culled
+                    if (cacheIndex < mShadowTextureCaches.size() && mShadowTextureCaches[cacheIndex].texture &&
+                        isShadowTextureCacheValid(mShadowTextureCaches[cacheIndex], shadowTex, light, texCam))
+                    {
+                        keepShadowTextureCacheCamera(mShadowTextureCaches[cacheIndex], texCam);
+                    }
+                }
 
                 // Setup background colour
                 shadowView->setBackgroundColour(ColourValue::White);
 
-                // Fire shadow caster update, callee can alter camera settings
-                fireShadowTexturesPreCaster(light, texCam, j);
-
-                // Update target
-                shadowRTT->update();
-
+                textureLights.push_back(std::make_pair(light, j));
                 ++si; // next shadow texture
                 ++ci; // next camera
             }
@@ -6552,11 +7508,74 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
             mShadowTextureIndexLightList.push_back(shadowTextureIndex);
             shadowTextureIndex += textureCountPerLight;
         }
+
+        if (mShadowAtlasEnabled && !textureLights.empty())
+            allocateShadowAtlasRegions(cam, textureLights);
+
+        if (mParallelCullingDepth && !textureLights.empty())
+        {
+            ShadowTextureCameraList cameras;
+            for (size_t t = 0; t < textureLights.size(); ++t)
+            {
+                if (!mShadowTextureUpdates[t].skipped)
+                    cameras.push_back(mShadowTextureCameras[t]);
+            }
+            if (!cameras.empty())
+                cullShadowCastersParallel(cameras);
+        }
+
+        // Render the textures in order
+        for (size_t t = 0; t < textureLights.size(); ++t)
+        {
+            Light* light = textureLights[t].first;
+            Camera* texCam = mShadowTextureCameras[t];
+            ShadowTextureUpdate& update = mShadowTextureUpdates[t];
+            if (update.skipped)
+                continue;
+
+            if (mShadowTextureCurrentCasterLightList.empty())
+                mShadowTextureCurrentCasterLightList.push_back(light);
+            else
+                mShadowTextureCurrentCasterLightList[0] = light;
+
+            // Fire shadow caster update, callee can alter camera settings
+            fireShadowTexturesPreCaster(light, texCam, textureLights[t].second);
+
+            // Update target
+            OgreProfileBeginGPUTimer("Shadow texture " + StringConverter::toString(t));
+            if (mShadowAtlasEnabled)
+            {
+                // only the region of this texture
+                Viewport* shadowView = getShadowTextureViewport(t);
+                if (shadowView->getActualWidth() != 0)
+                {
+                    RenderTarget* shadowRTT = shadowView->getTarget();
+                    shadowRTT->_beginUpdate();
+                    shadowRTT->_updateViewport(shadowView);
+                    shadowRTT->_endUpdate();
+                }
+            }
+            else if (mShadowTextureCaching)
+                renderCachedShadowTexture(t, light, texCam);
+            else
+                mShadowTextures[t]->getBuffer()->getRenderTarget()->update();
+            OgreProfileEndGPUTimer();
+
+            update.texture = mShadowTextures[t].get();
+            update.light = light;
+            update.camera = cam;
+            update.viewMatrix = texCam->getViewMatrix(true);
+            update.projMatrix = texCam->getProjectionMatrix();
+        }
+        clearCulledShadowCasters();
     }
     catch (Exception&) 
     {
         // we must reset the illumination stage if an exception occurs
         mIlluminationStage = savedStage;
+        clearCulledShadowCasters();
+        mShadowCasterMinBlending = false;
+        getRenderQueue()->setShadowCasterFilter(RenderQueue::SCF_ALL);
         throw;
     }
     // Set the illumination stage, prevents recursive calls
@@ -6569,6 +7588,223 @@ void SceneManager::prepareShadowTextures(Camera* cam, Viewport* vp, const LightL
 
 }
 //---------------------------------------------------------------------
+Viewport* SceneManager::getShadowTextureViewport(size_t index)
+{
+    RenderTarget* shadowRTT = mShadowTextures[index]->getBuffer()->getRenderTarget();
+    if (!mShadowAtlasEnabled)
+        return shadowRTT->getViewport(0);
+
+    // a viewport per shadow texture, the atlas may have been shared and cleared
+    int zorder = static_cast<int>(index);
+    if (shadowRTT->hasViewportWithZOrder(zorder))
+        return shadowRTT->getViewportByZOrder(zorder);
+
+    const Vector4& region = mShadowTextureRegions[index];
+    Viewport* v = shadowRTT->addViewport(mShadowTextureCameras[index], zorder,
+        region.x, region.y, region.z - region.x, region.w - region.y);
+    v->setClearEveryFrame(true);
+    v->setOverlaysEnabled(false);
+    return v;
+}
+//---------------------------------------------------------------------
+void SceneManager::allocateShadowAtlasRegions(const Camera* cam,
+    const frame_vector<std::pair<Light*, size_t> >::type& textureLights)
+{
+    vector<uint32>::type sizes(textureLights.size());
+    for (size_t t = 0; t < textureLights.size(); ++t)
+    {
+        const Light* light = textureLights[t].first;
+        const ShadowTextureConfig& config = mShadowTextureConfigList[t];
+        uint32 maxSize = std::max(config.width, config.height);
+
+        // the share of the view height the range of the light covers
+        Real coverage = 1;
+        if (light->getType() != Light::LT_DIRECTIONAL)
+        {
+            Real range = light->getAttenuationRange();
+            Real distance = light->getDerivedPosition().distance(cam->getDerivedPosition());
+            if (cam->getProjectionType() == PT_ORTHOGRAPHIC)
+                coverage = range * 2 / cam->getOrthoWindowHeight();
+            else if (distance > range)
+                coverage = Math::ASin(range / distance).valueRadians() /
+                    (cam->getFOVy().valueRadians() * 0.5f);
+        }
+        coverage = std::min(coverage, Real(1));
+        sizes[t] = static_cast<uint32>(maxSize * coverage);
+    }
+
+    vector<Rect>::type regions;
+    mShadowAtlasAllocator.allocate(sizes, regions);
+
+    Real atlasSize = static_cast<Real>(mShadowAtlasAllocator.getAtlasSize());
+    for (size_t t = 0; t < regions.size(); ++t)
+    {
+        const Rect& r = regions[t];
+        Vector4 region(r.left / atlasSize, r.top / atlasSize, r.right / atlasSize, r.bottom / atlasSize);
+        mShadowTextureRegions[t] = region;
+        getShadowTextureViewport(t)->setDimensions(
+            region.x, region.y, region.z - region.x, region.w - region.y);
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::setShadowTextureProjector(size_t shadowIndex, size_t projectorIndex)
+{
+    mAutoParamDataSource->setTextureProjector(mShadowTextureCameras[shadowIndex], projectorIndex);
+    if (mShadowAtlasEnabled)
+        mAutoParamDataSource->setTextureProjectorRegion(mShadowTextureRegions[shadowIndex], projectorIndex);
+}
+//---------------------------------------------------------------------
+void SceneManager::setShadowTextureAtlas(bool enabled, uint32 size, uint32 minRegionSize)
+{
+    // the textures are named and laid out differently in atlas mode
+    destroyShadowTextures();
+    mShadowAtlasEnabled = enabled;
+    mShadowAtlasAllocator.setAtlasSize(size);
+    mShadowAtlasAllocator.setMinRegionSize(minRegionSize);
+}
+//---------------------------------------------------------------------
+const Vector4& SceneManager::getShadowTextureRegion(size_t shadowIndex) const
+{
+    if (shadowIndex >= mShadowTextureRegions.size())
+    {
+        OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
+            "shadowIndex out of bounds",
+            "SceneManager::getShadowTextureRegion");
+    }
+    return mShadowTextureRegions[shadowIndex];
+}
+//---------------------------------------------------------------------
+void SceneManager::setShadowTextureCaching(bool enabled, Real texelTolerance)
+{
+    mShadowTextureCaching = enabled;
+    mShadowTextureCacheTexelTolerance = texelTolerance;
+    if (!enabled)
+        destroyShadowTextureCaches();
+}
+//---------------------------------------------------------------------
+void SceneManager::destroyShadowTextureCaches(void)
+{
+    for (ShadowTextureCacheList::iterator i = mShadowTextureCaches.begin();
+        i != mShadowTextureCaches.end(); ++i)
+    {
+        if (i->texture)
+            TextureManager::getSingleton().remove(i->texture->getHandle());
+    }
+    mShadowTextureCaches.clear();
+}
+//---------------------------------------------------------------------
+bool SceneManager::isShadowTextureCacheValid(const ShadowTextureCache& cache,
+    const TexturePtr& shadowTex, const Light* light, const Camera* texCam) const
+{
+    if (cache.stateCount != mStaticShadowCasterStateCount.load() || cache.light != light)
+        return false;
+
+    const Matrix4& view = texCam->getViewMatrix(true);
+    const Matrix4& proj = texCam->getProjectionMatrix();
+    const Real epsilon = 1e-5f;
+    for (int r = 0; r < 4; ++r)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            if (!Math::RealEqual(proj[r][c], cache.projMatrix[r][c], epsilon))
+                return false;
+            // only the orientation for now, the position is checked below
+            if (c < 3 && r < 3 && !Math::RealEqual(view[r][c], cache.viewMatrix[r][c], epsilon))
+                return false;
+        }
+    }
+
+    Vector3 shift = view.getTrans() - cache.viewMatrix.getTrans();
+    if (!proj.isAffine())
+    {
+        // a perspective frustum has to stay in place
+        return shift.squaredLength() <= epsilon * epsilon;
+    }
+
+    // an orthographic frustum may slide by a few texels, the depth range by as much
+    Matrix3 linear;
+    proj.extract3x3Matrix(linear);
+    Vector3 ndc = linear * shift;
+    Real tolerance = mShadowTextureCacheTexelTolerance;
+    return Math::Abs(ndc.x) * shadowTex->getWidth() * 0.5f <= tolerance &&
+        Math::Abs(ndc.y) * shadowTex->getHeight() * 0.5f <= tolerance &&
+        Math::Abs(ndc.z) * shadowTex->getWidth() * 0.5f <= tolerance;
+}
+//---------------------------------------------------------------------
+void SceneManager::keepShadowTextureCacheCamera(ShadowTextureCache& cache, Camera* texCam)
+{
+    // keep the frustum the static casters were rendered with
+    texCam->setCustomViewMatrix(true, cache.viewMatrix);
+    texCam->setCustomProjectionMatrix(true, cache.projMatrix);
+    cache.cameraOverridden = true;
+}
+//---------------------------------------------------------------------
+void SceneManager::renderCachedShadowTexture(size_t index, Light* light, Camera* texCam)
+{
+    const TexturePtr& shadowTex = mShadowTextures[index];
+    RenderTexture* shadowRTT = shadowTex->getBuffer()->getRenderTarget();
+    Viewport* shadowView = shadowRTT->getViewport(0);
+
+    if (mShadowTextureCaches.size() < mShadowTextures.size())
+        mShadowTextureCaches.resize(mShadowTextures.size());
+    ShadowTextureCache& cache = mShadowTextureCaches[index];
+
+    // the cache is private to this scene manager, unlike the shadow textures
+    if (!cache.texture || cache.texture->getWidth() != shadowTex->getWidth() ||
+        cache.texture->getHeight() != shadowTex->getHeight() ||
+        cache.texture->getFormat() != shadowTex->getFormat())
+    {
+        if (cache.texture)
+            TextureManager::getSingleton().remove(cache.texture->getHandle());
+        cache = ShadowTextureCache();
+        cache.texture = TextureManager::getSingleton().createManual(
+            shadowTex->getName() + "Cache" + getName(),
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, TEX_TYPE_2D,
+            shadowTex->getWidth(), shadowTex->getHeight(), 0, shadowTex->getFormat(),
+            TU_RENDERTARGET, 0, false, shadowTex->getFSAA(), shadowTex->getFSAAHint());
+
+        RenderTexture* cacheRTT = cache.texture->getBuffer()->getRenderTarget();
+        cacheRTT->setDepthBufferPool(shadowRTT->getDepthBufferPool());
+        Viewport* v = cacheRTT->addViewport(texCam);
+        v->setClearEveryFrame(true);
+        v->setOverlaysEnabled(false);
+        v->setBackgroundColour(ColourValue::White);
+        cacheRTT->setAutoUpdated(false);
+    }
+
+    RenderQueue* queue = getRenderQueue();
+    if (isShadowTextureCacheValid(cache, shadowTex, light, texCam))
+    {
+        keepShadowTextureCacheCamera(cache, texCam);
+    }
+    else
+    {
+        cache.light = light;
+        cache.viewMatrix = texCam->getViewMatrix(true);
+        cache.projMatrix = texCam->getProjectionMatrix();
+        cache.stateCount = mStaticShadowCasterStateCount.load();
+
+        RenderTexture* cacheRTT = cache.texture->getBuffer()->getRenderTarget();
+        Viewport* cacheView = cacheRTT->getViewport(0);
+        cacheView->setCamera(texCam);
+        cacheView->setMaterialScheme(shadowView->getMaterialScheme());
+        queue->setShadowCasterFilter(RenderQueue::SCF_STATIC);
+        cacheRTT->update();
+    }
+
+    // start from the static casters and add the dynamic ones, keeping the nearest
+    shadowTex->getBuffer()->blit(cache.texture->getBuffer());
+    shadowView->setClearEveryFrame(true, FBT_DEPTH);
+    queue->setShadowCasterFilter(RenderQueue::SCF_DYNAMIC);
+    mShadowCasterMinBlending = true;
+
+    shadowRTT->update();
+
+    mShadowCasterMinBlending = false;
+    queue->setShadowCasterFilter(RenderQueue::SCF_ALL);
+    shadowView->setClearEveryFrame(true);
+}
+//---------------------------------------------------------------------
 SceneManager::RenderContext* SceneManager::_pauseRendering()
 {
     RenderContext* context = new RenderContext;
@@ -6620,6 +7856,7 @@ void SceneManager::_resumeRendering(SceneManager::RenderContext* context)
     }
     mCameraInProgress = context->camera;
     mDestRenderSystem->_resumeFrame(context->rsContext);
+    _invalidatePassState();
 
     // Set rasterisation mode
     mDestRenderSystem->_setPolygonMode(mCameraInProgress->getPolygonMode());
@@ -7217,6 +8454,23 @@ void SceneManager::_injectRenderWithPass(Pass *pass, Renderable *rend, bool shad
     // render something as if it came from the current queue
     const Pass *usedPass = _setPass(pass, false, shadowDerivation);
     renderSingleObject(rend, usedPass, false, doLightIteration, manualLightList);
+    endDrawBatch();
+}
+//---------------------------------------------------------------------
+void SceneManager::_dispatchComputeWithPass(Pass *pass, Renderable *rend, const Vector3& workgroupDim)
+{
+    const Pass *usedPass = _setPass(pass, false, false);
+
+    // No render operation is issued, so the compute parameters are bound here
+    mAutoParamDataSource->setCurrentRenderable(rend);
+    usedPass->_updateAutoParams(mAutoParamDataSource, GPV_ALL);
+    if (usedPass->hasComputeProgram())
+    {
+        mDestRenderSystem->bindGpuProgramParameters(GPT_COMPUTE_PROGRAM,
+            usedPass->getComputeProgramParameters(), GPV_ALL);
+    }
+
+    mDestRenderSystem->_dispatchCompute(workgroupDim);
 }
 //---------------------------------------------------------------------
 RenderSystem *SceneManager::getDestinationRenderSystem()
@@ -7477,6 +8731,56 @@ void SceneManager::updateGpuProgramParameters(const Pass* pass)
 
 }
 //---------------------------------------------------------------------
+bool SceneManager::addToDynamicBatch(Renderable* rend, const Pass* pass, bool scissoring,
+                                     bool autoLights, const LightList* manualLightList)
+{
+    if (!mDynamicBatch || mIlluminationStage != IRS_NONE || mSuppressRenderStateChanges)
+        return false;
+
+    RenderOperation op;
+    if (!mDynamicBatch->isBatchable(rend, pass, op))
+        return false;
+
+    if (!mDynamicBatch->isCompatible(rend, op, pass, scissoring, autoLights, manualLightList))
+        flushDynamicBatch();
+    mDynamicBatch->add(rend, op, pass, scissoring, autoLights, manualLightList);
+    return true;
+}
+//---------------------------------------------------------------------
+void SceneManager::flushDynamicBatch(void)
+{
+    if (!mDynamicBatch || mDynamicBatch->getNumRenderables() == 0)
+        return;
+
+    // Detach the batch while drawing it, so nothing drawn adds to or flushes it again
+    DynamicRenderBatch* batch = mDynamicBatch;
+    mDynamicBatch = 0;
+
+    if (batch->getNumRenderables() == 1)
+    {
+        // Nothing to merge, draw the renderable itself
+        renderSingleObject(batch->getRenderable(0), batch->getPass(), batch->getScissoring(),
+            batch->getAutoLights(), batch->getManualLightList());
+    }
+    else
+    {
+        batch->build(mCameraRelativeRendering ? mCameraRelativePosition : Vector3::ZERO,
+            mFlipCullingOnNegativeScale);
+        renderSingleObject(batch, batch->getPass(), batch->getScissoring(),
+            batch->getAutoLights(), batch->getManualLightList());
+    }
+
+    batch->clear();
+    mDynamicBatch = batch;
+}
+//---------------------------------------------------------------------
+ImpostorBatcher* SceneManager::_getImpostorBatcher(void)
+{
+    if (!mImpostorBatcher)
+        mImpostorBatcher = OGRE_NEW ImpostorBatcher();
+    return mImpostorBatcher;
+}
+//---------------------------------------------------------------------
 void SceneManager::_issueRenderOp(Renderable* rend, const Pass* pass)
 {
     if(rend->preRender(this, mDestRenderSystem))
@@ -33,7 +33,8 @@ THE SOFTWARE.
 #include "OgreMath.h"
 #include "OgreSceneManager.h"
 #include "OgreMovableObject.h"
-#include "OgreWireBoundingBox.h"
+#include "OgreDebugDrawer.h"
+#include "OgreNodeTransformPool.h"
 
 #if OGRE_NODE_STORAGE_LEGACY
 #define ITER_VAL(it) it->second
@@ -45,26 +46,26 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     SceneNode::SceneNode(SceneManager* creator)
         : Node()
-        , mWireBoundingBox(0)
         , mShowBoundingBox(false)
         , mHideBoundingBox(false)
         , mCreator(creator)
         , mYawFixed(false)
         , mAutoTrackTarget(0)
         , mIsInSceneGraph(false)
+        , mGlobalIndex(-1)
     {
         needUpdate();
     }
     //-----------------------------------------------------------------------
     SceneNode::SceneNode(SceneManager* creator, const String& name)
         : Node(name)
-        , mWireBoundingBox(0)
         , mShowBoundingBox(false)
         , mHideBoundingBox(false)
         , mCreator(creator)
         , mYawFixed(false)
         , mAutoTrackTarget(0)
         , mIsInSceneGraph(false)
+        , mGlobalIndex(-1)
     {
         needUpdate();
     }
@@ -80,8 +81,6 @@ namespace Ogre {
             ret->_notifyAttached((SceneNode*)0);
         }
         mObjectsByName.clear();
-
-        OGRE_DELETE mWireBoundingBox;
     }
     //-----------------------------------------------------------------------
     void SceneNode::_update(bool updateChildren, bool parentHasChanged)
@@ -110,6 +109,21 @@ namespace Ogre {
         if (inGraph != mIsInSceneGraph)
         {
             mIsInSceneGraph = inGraph;
+
+            // Move the derived transform in or out of the scene's pool, parents come first
+            NodeTransformPool* pool = mCreator ? mCreator->_getTransformPool() : 0;
+            if (pool && inGraph)
+            {
+                size_t depth = 0;
+                for (Node* n = mParent; n; n = n->getParent())
+                    ++depth;
+                pool->attach(this, depth);
+            }
+            else if (mTransformPool && !inGraph)
+            {
+                mTransformPool->detach(this);
+            }
+
             // Tell children
             ChildNodeMap::iterator child;
             for (child = mChildren.begin(); child != mChildren.end(); ++child)
@@ -371,6 +385,44 @@ namespace Ogre {
 
     }
 
+    //-----------------------------------------------------------------------
+    void SceneNode::_findVisibleNodes(const Camera* cam, NodeList& nodes)
+    {
+        if (!cam->isVisible(mWorldAABB))
+            return;
+
+        nodes.push_back(this);
+
+        ChildNodeMap::iterator child, childend;
+        childend = mChildren.end();
+        for (child = mChildren.begin(); child != childend; ++child)
+        {
+            static_cast<SceneNode*>(ITER_VAL(child))->_findVisibleNodes(cam, nodes);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::_addVisibleObjects(Camera* cam, RenderQueue* queue,
+        VisibleObjectsBoundsInfo* visibleBounds, bool displayNodes, bool onlyShadowCasters)
+    {
+        ObjectMap::iterator iobj;
+        ObjectMap::iterator iobjend = mObjectsByName.end();
+        for (iobj = mObjectsByName.begin(); iobj != iobjend; ++iobj)
+        {
+            queue->processVisibleObject(ITER_VAL(iobj), cam, onlyShadowCasters, visibleBounds);
+        }
+
+        if (displayNodes)
+        {
+            queue->addRenderable(getDebugRenderable());
+        }
+
+        if ( !mHideBoundingBox &&
+             (mShowBoundingBox || (mCreator && mCreator->getShowBoundingBoxes())) )
+        { 
+            _addBoundingBoxToQueue(queue);
+        }
+    }
+    //-----------------------------------------------------------------------
     Node::DebugRenderable* SceneNode::getDebugRenderable()
     {
         Vector3 hs = mWorldAABB.getHalfSize();
@@ -382,12 +434,9 @@ namespace Ogre {
 
 
     void SceneNode::_addBoundingBoxToQueue(RenderQueue* queue) {
-        // Create a WireBoundingBox if needed.
-        if (mWireBoundingBox == NULL) {
-            mWireBoundingBox = OGRE_NEW WireBoundingBox();
-        }
-        mWireBoundingBox->setupBoundingBox(mWorldAABB);
-        queue->addRenderable(mWireBoundingBox);
+        // The debug drawer queues all boxes at once
+        if (mCreator)
+            mCreator->getDebugDrawer()->drawBox(mWorldAABB);
     }
 
     //-----------------------------------------------------------------------
@@ -31,6 +31,54 @@ THE SOFTWARE.
 #include "OgreSceneManager.h"
 
 namespace Ogre {
+    namespace
+    {
+        /// Adds the movable objects found by a region query to a buffer
+        class MovableVectorListener : public SceneQueryListener
+        {
+        public:
+            MovableVectorListener(SceneQueryResultMovableVector& results) : mResults(results) {}
+
+            bool queryResult(MovableObject* object)
+            {
+                mResults.push_back(object);
+                return true;
+            }
+            bool queryResult(SceneQuery::WorldFragment* fragment) { return true; }
+
+        private:
+            SceneQueryResultMovableVector& mResults;
+        };
+
+        /// Adds the results of a ray query to a buffer
+        class RayResultListener : public RaySceneQueryListener
+        {
+        public:
+            RayResultListener(RaySceneQueryResult& results) : mResults(results) {}
+
+            bool queryResult(MovableObject* obj, Real distance)
+            {
+                RaySceneQueryResultEntry entry;
+                entry.distance = distance;
+                entry.movable = obj;
+                entry.worldFragment = NULL;
+                mResults.push_back(entry);
+                return true;
+            }
+            bool queryResult(SceneQuery::WorldFragment* fragment, Real distance)
+            {
+                RaySceneQueryResultEntry entry;
+                entry.distance = distance;
+                entry.movable = NULL;
+                entry.worldFragment = fragment;
+                mResults.push_back(entry);
+                return true;
+            }
+
+        private:
+            RaySceneQueryResult& mResults;
+        };
+    }
 
     //-----------------------------------------------------------------------
     SceneQuery::SceneQuery(SceneManager* mgr)
@@ -116,6 +164,18 @@ namespace Ogre {
         return *mLastResult;
     }
     //---------------------------------------------------------------------
+    void RegionSceneQuery::execute(SceneQueryResultMovableVector& results)
+    {
+        results.clear();
+        appendResults(results);
+    }
+    //---------------------------------------------------------------------
+    void RegionSceneQuery::appendResults(SceneQueryResultMovableVector& results)
+    {
+        MovableVectorListener listener(results);
+        execute(&listener);
+    }
+    //---------------------------------------------------------------------
     bool RegionSceneQuery::
         queryResult(MovableObject* obj)
     {
@@ -152,6 +212,22 @@ namespace Ogre {
         return mAABB;
     }
     //-----------------------------------------------------------------------
+    void AxisAlignedBoxSceneQuery::executeBatch(const AxisAlignedBox* boxes, size_t count,
+        SceneQueryResultMovableVector& results, SceneQueryBatchOffsets& offsets)
+    {
+        AxisAlignedBox box = mAABB;
+        results.clear();
+        offsets.resize(count + 1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            offsets[i] = results.size();
+            mAABB = boxes[i];
+            appendResults(results);
+        }
+        offsets[count] = results.size();
+        mAABB = box;
+    }
+    //-----------------------------------------------------------------------
     SphereSceneQuery::SphereSceneQuery(SceneManager* mgr)
         : RegionSceneQuery(mgr)
     {
@@ -170,6 +246,22 @@ namespace Ogre {
     {
         return mSphere;
     }
+    //-----------------------------------------------------------------------
+    void SphereSceneQuery::executeBatch(const Sphere* spheres, size_t count,
+        SceneQueryResultMovableVector& results, SceneQueryBatchOffsets& offsets)
+    {
+        Sphere sphere = mSphere;
+        results.clear();
+        offsets.resize(count + 1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            offsets[i] = results.size();
+            mSphere = spheres[i];
+            appendResults(results);
+        }
+        offsets[count] = results.size();
+        mSphere = sphere;
+    }
 
     //-----------------------------------------------------------------------
     PlaneBoundedVolumeListSceneQuery::PlaneBoundedVolumeListSceneQuery(SceneManager* mgr)
@@ -235,23 +327,58 @@ namespace Ogre {
         
         // Call callback version with self as listener
         this->execute(this);
+        sortResults(mResult, 0);
 
-        if (mSortByDistance)
+        return mResult;
+    }
+    //-----------------------------------------------------------------------
+    void RaySceneQuery::execute(RaySceneQueryResult& results)
+    {
+        results.clear();
+        appendResults(results);
+    }
+    //-----------------------------------------------------------------------
+    void RaySceneQuery::executeBatch(const Ray* rays, size_t count,
+        RaySceneQueryResult& results, SceneQueryBatchOffsets& offsets)
+    {
+        Ray ray = mRay;
+        results.clear();
+        offsets.resize(count + 1);
+        for (size_t i = 0; i < count; ++i)
         {
-            if (mMaxResults != 0 && mMaxResults < mResult.size())
-            {
-                // Partially sort the N smallest elements, discard others
-                std::partial_sort(mResult.begin(), mResult.begin()+mMaxResults, mResult.end());
-                mResult.resize(mMaxResults);
-            }
-            else
-            {
-                // Sort entire result array
-                std::sort(mResult.begin(), mResult.end());
-            }
+            offsets[i] = results.size();
+            setRay(rays[i]);
+            appendResults(results);
         }
+        offsets[count] = results.size();
+        setRay(ray);
+    }
+    //-----------------------------------------------------------------------
+    void RaySceneQuery::appendResults(RaySceneQueryResult& results)
+    {
+        size_t first = results.size();
+        RayResultListener listener(results);
+        execute(&listener);
+        sortResults(results, first);
+    }
+    //-----------------------------------------------------------------------
+    void RaySceneQuery::sortResults(RaySceneQueryResult& results, size_t first) const
+    {
+        if (!mSortByDistance)
+            return;
 
-        return mResult;
+        RaySceneQueryResult::iterator begin = results.begin() + first;
+        if (mMaxResults != 0 && mMaxResults < results.size() - first)
+        {
+            // Partially sort the N smallest elements, discard others
+            std::partial_sort(begin, begin + mMaxResults, results.end());
+            results.resize(first + mMaxResults);
+        }
+        else
+        {
+            // Sort entire result array
+            std::sort(begin, results.end());
+        }
     }
     //-----------------------------------------------------------------------
     RaySceneQueryResult& RaySceneQuery::getLastResults(void)
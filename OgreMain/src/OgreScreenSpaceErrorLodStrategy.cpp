@@ -0,0 +1,217 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+#include "OgreScreenSpaceErrorLodStrategy.h"
+
+#include "OgreViewport.h"
+#include "OgreCamera.h"
+#include "OgreRoot.h"
+#include "OgreSubMesh.h"
+
+#include <limits>
+
+namespace Ogre {
+    namespace {
+        /// Number of triangles drawn by a mesh at a LOD level
+        size_t getLodTriangleCount(const Mesh* mesh, ushort lodIndex)
+        {
+            if (lodIndex > 0 && mesh->hasManualLodLevel())
+            {
+                const MeshLodUsage& usage = mesh->getLodLevel(lodIndex);
+                if (!usage.manualMesh)
+                    return 0;
+                mesh = usage.manualMesh.get();
+                lodIndex = 0;
+            }
+
+            size_t triangles = 0;
+            for (ushort i = 0; i < mesh->getNumSubMeshes(); ++i)
+            {
+                const SubMesh* subMesh = mesh->getSubMesh(i);
+                const IndexData* indexData = subMesh->indexData;
+                if (lodIndex > 0 && lodIndex <= subMesh->mLodFaceList.size())
+                    indexData = subMesh->mLodFaceList[lodIndex - 1];
+                triangles += indexData->indexCount / 3;
+            }
+            return triangles;
+        }
+    }
+    //-----------------------------------------------------------------------
+    template<> ScreenSpaceErrorLodStrategy* Singleton<ScreenSpaceErrorLodStrategy>::msSingleton = 0;
+    ScreenSpaceErrorLodStrategy* ScreenSpaceErrorLodStrategy::getSingletonPtr(void)
+    {
+        return msSingleton;
+    }
+    ScreenSpaceErrorLodStrategy& ScreenSpaceErrorLodStrategy::getSingleton(void)
+    {
+        assert( msSingleton );  return ( *msSingleton );
+    }
+    //-----------------------------------------------------------------------
+    ScreenSpaceErrorLodStrategy::ScreenSpaceErrorLodStrategy()
+        : LodStrategy("screen_space_error")
+        , mPixelTolerance(1)
+        , mHysteresis(0.1f)
+        , mTriangleBudget(0)
+        , mBudgetBias(1)
+        , mFrameTriangles(0)
+        , mFrameNumber(0)
+    { }
+    //-----------------------------------------------------------------------
+    Real ScreenSpaceErrorLodStrategy::getValueImpl(const MovableObject *movableObject, const Ogre::Camera *camera) const
+    {
+        updateBudget();
+
+        // Get viewport height
+        const Viewport *viewport = camera->getViewport();
+        if (!viewport || viewport->getActualHeight() <= 0)
+            return getBaseValue();
+        Real viewportHeight = static_cast<Real>(viewport->getActualHeight());
+
+        // The error is measured in object space, so take the scale into account
+        const Vector3& scl = movableObject->getParentNode()->_getDerivedScale();
+        Real factor = std::max(std::max(scl.x, scl.y), scl.z);
+        if (factor <= std::numeric_limits<Real>::epsilon())
+            return getBaseValue();
+
+        // Get the size of a pixel at the object
+        Real pixelSize;
+        switch (camera->getProjectionType())
+        {
+        case PT_PERSPECTIVE:
+            {
+                // Use the front of the bounding sphere, where the error looks largest
+                Real distance = Math::Sqrt(movableObject->getParentNode()->getSquaredViewDepth(camera)) -
+                    movableObject->getBoundingRadius() * factor;
+
+                // Full detail when the camera is inside the bounds
+                if (distance <= std::numeric_limits<Real>::epsilon())
+                    return getBaseValue();
+
+                // Get projection matrix (this is done to avoid computation of tan(FOV / 2))
+                const Matrix4& projectionMatrix = camera->getProjectionMatrix();
+                pixelSize = 2 * distance / (projectionMatrix[1][1] * viewportHeight);
+                break;
+            }
+        case PT_ORTHOGRAPHIC:
+            pixelSize = camera->getOrthoWindowHeight() / viewportHeight;
+            break;
+        default:
+            {
+                // This case is not covered for obvious reasons
+                throw;
+            }
+        }
+
+        // Object space error which is tolerated
+        return mPixelTolerance * mBudgetBias * pixelSize / factor;
+    }
+    //---------------------------------------------------------------------
+    Real ScreenSpaceErrorLodStrategy::getBaseValue() const
+    {
+        // Full detail has no error
+        return 0;
+    }
+    //---------------------------------------------------------------------
+    Real ScreenSpaceErrorLodStrategy::transformBias(Real factor) const
+    {
+        assert(factor > 0.0f && "Bias factor must be > 0!");
+        return 1.0f / factor;
+    }
+    //---------------------------------------------------------------------
+    ushort ScreenSpaceErrorLodStrategy::getIndex(Real value, const Mesh::MeshLodUsageList& meshLodUsageList) const
+    {
+        // Values are ascending
+        return getIndexAscending(value, meshLodUsageList);
+    }
+    //---------------------------------------------------------------------
+    ushort ScreenSpaceErrorLodStrategy::getIndex(Real value, const Material::LodValueList& materialLodValueList) const
+    {
+        // Values are ascending
+        return getIndexAscending(value, materialLodValueList);
+    }
+    //---------------------------------------------------------------------
+    ushort ScreenSpaceErrorLodStrategy::getMeshLodIndex(Real value, const Mesh* mesh, ushort previousIndex) const
+    {
+        ushort index = mesh->getLodIndex(value);
+
+        // Only leave the previous level once the error is off by more than the hysteresis
+        if (mHysteresis > 0 && previousIndex < mesh->getNumLodLevels())
+        {
+            if (index > previousIndex)
+                index = std::max(previousIndex, mesh->getLodIndex(value / (1 + mHysteresis)));
+            else if (index < previousIndex)
+                index = std::min(previousIndex, mesh->getLodIndex(value * (1 + mHysteresis)));
+        }
+
+        if (mTriangleBudget)
+            mFrameTriangles += getLodTriangleCount(mesh, index);
+
+        return index;
+    }
+    //---------------------------------------------------------------------
+    void ScreenSpaceErrorLodStrategy::sort(Mesh::MeshLodUsageList& meshLodUsageList) const
+    {
+        // Sort ascending
+        sortAscending(meshLodUsageList);
+    }
+    //---------------------------------------------------------------------
+    bool ScreenSpaceErrorLodStrategy::isSorted(const Mesh::LodValueList& values) const
+    {
+        // Check if values are sorted ascending
+        return isSortedAscending(values);
+    }
+    //---------------------------------------------------------------------
+    void ScreenSpaceErrorLodStrategy::setTriangleBudget(size_t triangles)
+    {
+        mTriangleBudget = triangles;
+        mFrameTriangles = 0;
+        mBudgetBias = 1;
+    }
+    //---------------------------------------------------------------------
+    void ScreenSpaceErrorLodStrategy::updateBudget() const
+    {
+        Root* root = Root::getSingletonPtr();
+        unsigned long frameNumber = root ? root->getNextFrameNumber() : 0;
+        if (frameNumber == mFrameNumber)
+            return;
+        mFrameNumber = frameNumber;
+
+        if (mTriangleBudget && mFrameTriangles)
+        {
+            // The triangle count goes roughly with the inverse square of the tolerated error.
+            // Limit the change per frame, so the bias settles instead of oscillating.
+            Real ratio = Math::Sqrt(Real(mFrameTriangles) / Real(mTriangleBudget));
+            ratio = Math::Clamp<Real>(ratio, 0.5f, 2.0f);
+            // Give up at some point when even the coarsest levels exceed the budget.
+            mBudgetBias = Math::Clamp<Real>(mBudgetBias * ratio, 1.0f, 1024.0f);
+        }
+        mFrameTriangles = 0;
+    }
+
+} // namespace
@@ -32,6 +32,10 @@ THE SOFTWARE.
 #include "OgreScriptTranslator.h"
 #include "OgreLogManager.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreGpuProgramManager.h"
 
 namespace Ogre
 {
@@ -275,11 +279,257 @@ namespace Ogre
     }
 
     ScriptCompiler::ScriptCompiler()
-        :mListener(0)
+        :mListener(0), mReloading(false)
     {
         initWordMap();
     }
 
+    namespace
+    {
+        // Helpers for serialising processed ASTs, values are written in native byte order
+        void writeValue(String &buffer, uint32 value)
+        {
+            buffer.append((const char*)&value, sizeof(value));
+        }
+
+        void writeString(String &buffer, const String &str)
+        {
+            writeValue(buffer, static_cast<uint32>(str.size()));
+            buffer.append(str);
+        }
+
+        bool readValue(DataStream &stream, uint32 &value)
+        {
+            return stream.read(&value, sizeof(value)) == sizeof(value);
+        }
+
+        bool readString(DataStream &stream, String &str)
+        {
+            uint32 size;
+            if(!readValue(stream, size) || size > stream.size() - stream.tell())
+                return false;
+            str.resize(size);
+            return size == 0 || stream.read(&str[0], size) == size;
+        }
+
+        bool writeNodes(String &buffer, const AbstractNodeList &nodes, const AbstractNode *parent,
+            bool positions = true);
+
+        // Without the positions the buffer only serves as a fingerprint, it can not be read back
+        bool writeNode(String &buffer, const AbstractNode &node, const AbstractNode *parent,
+            bool positions = true)
+        {
+            writeValue(buffer, node.type);
+            if(positions)
+            {
+                writeValue(buffer, node.line);
+                // Most nodes are in the same file as their parent
+                bool sameFile = parent && parent->file == node.file;
+                writeValue(buffer, sameFile);
+                if(!sameFile)
+                    writeString(buffer, node.file);
+            }
+
+            switch(node.type)
+            {
+            case ANT_ATOM:
+                writeString(buffer, static_cast<const AtomAbstractNode&>(node).value);
+                return true;
+            case ANT_OBJECT:
+                {
+                    const ObjectAbstractNode &obj = static_cast<const ObjectAbstractNode&>(node);
+                    writeString(buffer, obj.name);
+                    writeString(buffer, obj.cls);
+                    writeValue(buffer, obj.abstract);
+                    writeValue(buffer, static_cast<uint32>(obj.bases.size()));
+                    for(vector<String>::type::const_iterator i = obj.bases.begin(); i != obj.bases.end(); ++i)
+                        writeString(buffer, *i);
+                    const map<String,String>::type &vars = obj.getVariables();
+                    writeValue(buffer, static_cast<uint32>(vars.size()));
+                    for(map<String,String>::type::const_iterator i = vars.begin(); i != vars.end(); ++i)
+                    {
+                        writeString(buffer, i->first);
+                        writeString(buffer, i->second);
+                    }
+                    return writeNodes(buffer, obj.children, &obj, positions) &&
+                        writeNodes(buffer, obj.values, &obj, positions) &&
+                        writeNodes(buffer, obj.overrides, &obj, positions);
+                }
+            case ANT_PROPERTY:
+                {
+                    const PropertyAbstractNode &prop = static_cast<const PropertyAbstractNode&>(node);
+                    writeString(buffer, prop.name);
+                    return writeNodes(buffer, prop.values, &prop, positions);
+                }
+            case ANT_IMPORT:
+                {
+                    const ImportAbstractNode &import = static_cast<const ImportAbstractNode&>(node);
+                    writeString(buffer, import.target);
+                    writeString(buffer, import.source);
+                    return true;
+                }
+            case ANT_VARIABLE_ACCESS:
+                writeString(buffer, static_cast<const VariableAccessAbstractNode&>(node).name);
+                return true;
+            default:
+                // Nodes of custom types can not be serialised
+                return false;
+            }
+        }
+
+        bool writeNodes(String &buffer, const AbstractNodeList &nodes, const AbstractNode *parent,
+            bool positions)
+        {
+            writeValue(buffer, static_cast<uint32>(nodes.size()));
+            for(AbstractNodeList::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
+            {
+                if(!writeNode(buffer, **i, parent, positions))
+                    return false;
+            }
+            return true;
+        }
+
+        // Whether objects of this class can be updated in place by ScriptCompilerManager::reloadScript
+        bool isReloadableObject(uint32 id)
+        {
+            switch(id)
+            {
+            case ID_MATERIAL:
+            case ID_VERTEX_PROGRAM:
+            case ID_GEOMETRY_PROGRAM:
+            case ID_FRAGMENT_PROGRAM:
+            case ID_TESSELLATION_HULL_PROGRAM:
+            case ID_TESSELLATION_DOMAIN_PROGRAM:
+            case ID_COMPUTE_PROGRAM:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // The settings of a program which require it to be compiled again when they change
+        String getProgramSignature(const GpuProgram *prog)
+        {
+            String signature = prog->getSourceFile() + "\n" + prog->getSyntaxCode();
+            const ParameterList &params = prog->getParameters();
+            for(ParameterList::const_iterator i = params.begin(); i != params.end(); ++i)
+                signature += "\n" + i->name + " " + prog->getParameter(i->name);
+            return signature;
+        }
+    }
+
+    bool ScriptCompiler::readNodes(DataStream &stream, AbstractNodeList &nodes, AbstractNode *parent)
+    {
+        uint32 count;
+        if(!readValue(stream, count))
+            return false;
+        for(uint32 n = 0; n < count; ++n)
+        {
+            uint32 type, line, sameFile;
+            if(!readValue(stream, type) || !readValue(stream, line) || !readValue(stream, sameFile))
+                return false;
+            String file;
+            if(sameFile)
+            {
+                if(!parent)
+                    return false;
+                file = parent->file;
+            }
+            else if(!readString(stream, file))
+                return false;
+
+            AbstractNodePtr node;
+            IdMap::const_iterator id;
+            switch(type)
+            {
+            case ANT_ATOM:
+                {
+                    AtomAbstractNode *impl = OGRE_NEW AtomAbstractNode(parent);
+                    node = AbstractNodePtr(impl);
+                    if(!readString(stream, impl->value))
+                        return false;
+                    id = mIds.find(impl->value);
+                    if(id != mIds.end())
+                        impl->id = id->second;
+                }
+                break;
+            case ANT_OBJECT:
+                {
+                    ObjectAbstractNode *impl = OGRE_NEW ObjectAbstractNode(parent);
+                    node = AbstractNodePtr(impl);
+                    uint32 abstract, size;
+                    if(!readString(stream, impl->name) || !readString(stream, impl->cls) ||
+                        !readValue(stream, abstract) || !readValue(stream, size))
+                        return false;
+                    impl->abstract = abstract != 0;
+                    impl->bases.resize(size);
+                    for(uint32 i = 0; i < size; ++i)
+                    {
+                        if(!readString(stream, impl->bases[i]))
+                            return false;
+                    }
+                    if(!readValue(stream, size))
+                        return false;
+                    for(uint32 i = 0; i < size; ++i)
+                    {
+                        String name, value;
+                        if(!readString(stream, name) || !readString(stream, value))
+                            return false;
+                        impl->setVariable(name, value);
+                    }
+                    impl->file = file;
+                    if(!readNodes(stream, impl->children, impl) || !readNodes(stream, impl->values, impl) ||
+                        !readNodes(stream, impl->overrides, impl))
+                        return false;
+
+                    // The class must be known, as it was when the tree was cached
+                    id = mIds.find(impl->cls);
+                    if(id == mIds.end())
+                        return false;
+                    impl->id = id->second;
+                }
+                break;
+            case ANT_PROPERTY:
+                {
+                    PropertyAbstractNode *impl = OGRE_NEW PropertyAbstractNode(parent);
+                    node = AbstractNodePtr(impl);
+                    if(!readString(stream, impl->name))
+                        return false;
+                    impl->file = file;
+                    if(!readNodes(stream, impl->values, impl))
+                        return false;
+                    id = mIds.find(impl->name);
+                    if(id != mIds.end())
+                        impl->id = id->second;
+                }
+                break;
+            case ANT_IMPORT:
+                {
+                    ImportAbstractNode *impl = OGRE_NEW ImportAbstractNode();
+                    impl->parent = parent;
+                    node = AbstractNodePtr(impl);
+                    if(!readString(stream, impl->target) || !readString(stream, impl->source))
+                        return false;
+                }
+                break;
+            case ANT_VARIABLE_ACCESS:
+                {
+                    VariableAccessAbstractNode *impl = OGRE_NEW VariableAccessAbstractNode(parent);
+                    node = AbstractNodePtr(impl);
+                    if(!readString(stream, impl->name))
+                        return false;
+                }
+                break;
+            default:
+                return false;
+            }
+            node->file = file;
+            node->line = line;
+            nodes.push_back(node);
+        }
+        return true;
+    }
+
     bool ScriptCompiler::compile(const String &str, const String &source, const String &group)
     {
         ConcreteNodeListPtr nodes = ScriptParser::parse(ScriptLexer::tokenize(str, source));
@@ -339,6 +589,115 @@ namespace Ogre
 //  }
 
     bool ScriptCompiler::compile(const ConcreteNodeListPtr &nodes, const String &group)
+    {
+        return translate(processConcreteNodes(nodes, group));
+    }
+
+    MemoryDataStreamPtr ScriptCompiler::_compileAndSerialiseAST(const ConcreteNodeListPtr &nodes, const String &group)
+    {
+        MemoryDataStreamPtr serialised;
+        AbstractNodeListPtr ast = processConcreteNodes(nodes, group);
+
+        // Scripts depending on imported ones can not be cached by their own text
+        if(mErrors.empty() && mImportRequests.empty())
+        {
+            String buffer;
+            if(writeNodes(buffer, *ast, 0))
+            {
+                serialised.reset(OGRE_NEW MemoryDataStream(buffer.size()));
+                memcpy(serialised->getPtr(), buffer.data(), buffer.size());
+            }
+        }
+
+        translate(ast);
+        return serialised;
+    }
+
+    bool ScriptCompiler::_compileSerialisedAST(const MemoryDataStreamPtr &ast, const String &group)
+    {
+        // Read through a separate stream, the serialised tree may be shared between threads
+        MemoryDataStream stream(ast->getPtr(), ast->size(), false, true);
+        AbstractNodeListPtr nodes(OGRE_NEW_T(AbstractNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+        if(!readNodes(stream, *nodes, 0))
+            return false;
+
+        // Set up the compilation context
+        mGroup = group;
+        mErrors.clear();
+        mEnv.clear();
+        mReloading = false;
+
+        translate(nodes);
+        return true;
+    }
+
+    size_t ScriptCompiler::_compileChangedObjects(const ConcreteNodeListPtr &nodes, const String &group,
+        ObjectHashMap &hashes, bool reload)
+    {
+        AbstractNodeListPtr ast = processConcreteNodes(nodes, group);
+
+        // Allows early bail-out through the listener
+        if(mListener && !mListener->postConversion(this, ast))
+            return 0;
+
+        ObjectHashMap objectHashes;
+        size_t count = 0;
+        mReloading = reload;
+        for(AbstractNodeList::iterator i = ast->begin(); i != ast->end(); ++i)
+        {
+            ScriptTranslator *translator = ScriptCompilerManager::getSingleton().getTranslator(*i);
+            if((*i)->type != ANT_OBJECT)
+            {
+                // Only objects can be matched with those compiled before
+                if(translator && !reload)
+                {
+                    translator->translate(this, *i);
+                    ++count;
+                }
+                continue;
+            }
+
+            ObjectAbstractNode *obj = static_cast<ObjectAbstractNode*>((*i).get());
+            if(obj->abstract)
+                continue;
+
+            // Leave out the positions, so that editing an object does not change the ones after it.
+            // Objects with nodes which can not be written are always seen as changed.
+            String key = obj->cls + " " + obj->name, buffer;
+            if(writeNode(buffer, *obj, 0, false))
+            {
+                uint32 hash = FastHash(buffer.data(), buffer.size());
+                objectHashes[key] = hash;
+                ObjectHashMap::const_iterator old = hashes.find(key);
+                if(reload && old != hashes.end() && old->second == hash)
+                    continue;
+            }
+
+            if(reload && !isReloadableObject(obj->id))
+            {
+                LogManager::getSingleton().logMessage("ScriptCompiler - " + key + " in " + obj->file +
+                    " changed, it is only updated when its resource group is reloaded");
+                continue;
+            }
+
+            if(translator)
+            {
+                translator->translate(this, *i);
+                ++count;
+            }
+            reloadReusedResources();
+        }
+        mReloading = false;
+
+        mImports.clear();
+        mImportRequests.clear();
+        mImportTable.clear();
+
+        hashes.swap(objectHashes);
+        return count;
+    }
+
+    AbstractNodeListPtr ScriptCompiler::processConcreteNodes(const ConcreteNodeListPtr &nodes, const String &group)
     {
         // Set up the compilation context
         mGroup = group;
@@ -349,6 +708,11 @@ namespace Ogre
         // Clear the environment
         mEnv.clear();
 
+        // Resources are only reused while reloading
+        mReloading = false;
+        mReusedMaterials.clear();
+        mReusedPrograms.clear();
+
         if(mListener)
             mListener->preConversion(this, nodes);
 
@@ -361,6 +725,11 @@ namespace Ogre
         // Process variable expansion
         processVariables(ast.get());
 
+        return ast;
+    }
+
+    bool ScriptCompiler::translate(const AbstractNodeListPtr &ast)
+    {
         // Allows early bail-out through the listener
         if(mListener && !mListener->postConversion(this, ast))
             return mErrors.empty();
@@ -419,6 +788,8 @@ namespace Ogre
         // Clear the environment
         mEnv.clear();
 
+        mReloading = false;
+
         // Processes the imports for this script
         if(doImports)
             processImports(nodes);
@@ -485,11 +856,91 @@ namespace Ogre
 
     bool ScriptCompiler::_fireEvent(ScriptCompilerEvent *evt, void *retval)
     {
-        if(mListener)
-            return mListener->handleEvent(this, evt, retval);
+        if(mListener && mListener->handleEvent(this, evt, retval))
+            return true;
+        return mReloading && reuseResource(evt, retval);
+    }
+
+    bool ScriptCompiler::reuseResource(ScriptCompilerEvent *evt, void *retval)
+    {
+        if(evt->mType == CreateMaterialScriptCompilerEvent::eventType)
+        {
+            CreateMaterialScriptCompilerEvent *create = static_cast<CreateMaterialScriptCompilerEvent*>(evt);
+            MaterialPtr material = MaterialManager::getSingleton().getByName(create->mName, create->mResourceGroup);
+            if(!material)
+                return false;
+
+            // The translator rebuilds the techniques, they are compiled by reloading it
+            if(material->isLoaded())
+                mReusedMaterials.push_back(material.get());
+            *static_cast<Material**>(retval) = material.get();
+            return true;
+        }
+        else if(evt->mType == CreateHighLevelGpuProgramScriptCompilerEvent::eventType)
+        {
+            CreateHighLevelGpuProgramScriptCompilerEvent *create = static_cast<CreateHighLevelGpuProgramScriptCompilerEvent*>(evt);
+            HighLevelGpuProgramManager &manager = HighLevelGpuProgramManager::getSingleton();
+            HighLevelGpuProgramPtr prog = manager.getByName(create->mName, create->mResourceGroup);
+            if(!prog)
+                return false;
+
+            if(prog->getLanguage() != create->mLanguage || prog->getType() != create->mProgramType)
+            {
+                // A program can not turn into another kind, so it is replaced
+                LogManager::getSingleton().logMessage("ScriptCompiler - replacing GPU program " + create->mName +
+                    ", the materials using it keep the old one until they are reloaded");
+                manager.remove(prog);
+                return false;
+            }
+
+            mReusedPrograms.push_back(std::make_pair(static_cast<GpuProgram*>(prog.get()), getProgramSignature(prog.get())));
+            // Unified programs have no source
+            if(!create->mSource.empty())
+                prog->setSourceFile(create->mSource);
+            *static_cast<HighLevelGpuProgram**>(retval) = prog.get();
+            return true;
+        }
+        else if(evt->mType == CreateGpuProgramScriptCompilerEvent::eventType)
+        {
+            CreateGpuProgramScriptCompilerEvent *create = static_cast<CreateGpuProgramScriptCompilerEvent*>(evt);
+            GpuProgramManager &manager = GpuProgramManager::getSingleton();
+            GpuProgramPtr prog = manager.getByName(create->mName, create->mResourceGroup, false);
+            if(!prog)
+                return false;
+
+            if(prog->getLanguage() != "asm" || prog->getType() != create->mProgramType)
+            {
+                LogManager::getSingleton().logMessage("ScriptCompiler - replacing GPU program " + create->mName +
+                    ", the materials using it keep the old one until they are reloaded");
+                ResourceManager *owner = prog->getCreator();
+                owner->remove(prog);
+                return false;
+            }
+
+            mReusedPrograms.push_back(std::make_pair(prog.get(), getProgramSignature(prog.get())));
+            prog->setSyntaxCode(create->mSyntax);
+            prog->setSourceFile(create->mSource);
+            *static_cast<GpuProgram**>(retval) = prog.get();
+            return true;
+        }
         return false;
     }
 
+    void ScriptCompiler::reloadReusedResources()
+    {
+        // Programs first, so that the materials are compiled against their new state
+        for(ReusedProgramList::iterator i = mReusedPrograms.begin(); i != mReusedPrograms.end(); ++i)
+        {
+            if(i->first->isLoaded() && getProgramSignature(i->first) != i->second)
+                i->first->reload();
+        }
+        for(vector<Material*>::type::iterator i = mReusedMaterials.begin(); i != mReusedMaterials.end(); ++i)
+            (*i)->reload();
+
+        mReusedPrograms.clear();
+        mReusedMaterials.clear();
+    }
+
     AbstractNodeListPtr ScriptCompiler::convertToAST(const Ogre::ConcreteNodeListPtr &nodes)
     {
         AbstractTreeBuilder builder(this);
@@ -1280,6 +1731,17 @@ namespace Ogre
 
         mIds["subroutine"] = ID_SUBROUTINE;
 
+        mIds["image"] = ID_IMAGE;
+        mIds["thread_group_size"] = ID_THREAD_GROUP_SIZE;
+        mIds["dynamic_resolution"] = ID_DYNAMIC_RESOLUTION;
+
+        mIds["load_action"] = ID_LOAD_ACTION;
+        mIds["store_action"] = ID_STORE_ACTION;
+        mIds["load"] = ID_LOAD;
+        mIds["dont_care"] = ID_DONT_CARE;
+        mIds["store"] = ID_STORE;
+        mIds["discard"] = ID_DISCARD;
+
 		mLargestRegisteredWordId = ID_END_BUILTIN_IDS;
 	}
 
@@ -1570,6 +2032,8 @@ namespace Ogre
 
     // ScriptCompilerManager
     template<> ScriptCompilerManager *Singleton<ScriptCompilerManager>::msSingleton = 0;
+    // Changes whenever the format of serialised ASTs does
+    static const uint32 SCRIPT_CACHE_VERSION = 1;
     
     ScriptCompilerManager* ScriptCompilerManager::getSingletonPtr(void)
     {
@@ -1582,7 +2046,8 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------
     ScriptCompilerManager::ScriptCompilerManager()
-        :mListener(0), OGRE_THREAD_POINTER_INIT(mScriptCompiler)
+        :mListener(0), OGRE_THREAD_POINTER_INIT(mScriptCompiler),
+        mSaveCompiledScriptsToCache(false), mScriptCacheDirty(false), mScriptReloadingEnabled(false)
     {
             OGRE_LOCK_AUTO_MUTEX;
         mScriptPatterns.push_back("*.program");
@@ -1678,7 +2143,7 @@ namespace Ogre
         return 90.0f;
     }
     //-----------------------------------------------------------------------
-    void ScriptCompilerManager::parseScript(DataStreamPtr& stream, const String& groupName)
+    ScriptCompiler* ScriptCompilerManager::getThreadCompiler()
     {
 #if OGRE_THREAD_SUPPORT
         // check we have an instance for this thread (should always have one for main thread)
@@ -1691,10 +2156,228 @@ namespace Ogre
 #endif
         // Set the listener on the compiler before we continue
         {
-                    OGRE_LOCK_AUTO_MUTEX;
+            OGRE_LOCK_AUTO_MUTEX;
             OGRE_THREAD_POINTER_GET(mScriptCompiler)->setListener(mListener);
         }
-        OGRE_THREAD_POINTER_GET(mScriptCompiler)->compile(stream->getAsString(), stream->getName(), groupName);
+        return OGRE_THREAD_POINTER_GET(mScriptCompiler);
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::parseScript(DataStreamPtr& stream, const String& groupName)
+    {
+        if (!mSaveCompiledScriptsToCache && !mScriptReloadingEnabled)
+        {
+            getThreadCompiler()->compile(stream->getAsString(), stream->getName(), groupName);
+            return;
+        }
+
+        String str = stream->getAsString();
+        uint32 hash = FastHash(str.data(), str.size());
+        compileScript(stream->getName(), hash, getCachedAST(stream->getName(), hash),
+            ScriptParser::parse(ScriptLexer::tokenize(str, stream->getName())), stream, groupName);
+    }
+    //-----------------------------------------------------------------------
+    PreparedScriptPtr ScriptCompilerManager::prepareScript(DataStreamPtr& stream)
+    {
+        // Lexing and parsing only depend on the text. On errors nothing is prepared,
+        // so that they are reported when the script is parsed in order.
+        try
+        {
+            String str = stream->getAsString();
+            PreparedNodes* prepared = OGRE_NEW PreparedNodes();
+            PreparedScriptPtr preparedPtr(prepared);
+            prepared->hash = 0;
+            if (mSaveCompiledScriptsToCache && !mScriptReloadingEnabled)
+            {
+                prepared->hash = FastHash(str.data(), str.size());
+                prepared->cachedAST = getCachedAST(stream->getName(), prepared->hash);
+            }
+            if (!prepared->cachedAST)
+                prepared->nodes = ScriptParser::parse(ScriptLexer::tokenize(str, stream->getName()));
+            return preparedPtr;
+        }
+        catch (Exception&)
+        {
+            return PreparedScriptPtr();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::parsePreparedScript(DataStreamPtr& stream, const String& groupName,
+        const PreparedScriptPtr& prepared)
+    {
+        if (!prepared)
+        {
+            parseScript(stream, groupName);
+            return;
+        }
+        const PreparedNodes& script = static_cast<const PreparedNodes&>(*prepared);
+        compileScript(stream->getName(), script.hash, script.cachedAST, script.nodes, stream, groupName);
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::compileScript(const String& name, uint32 hash,
+        const MemoryDataStreamPtr& cachedAST, ConcreteNodeListPtr nodes, DataStreamPtr& stream,
+        const String& groupName)
+    {
+        ScriptCompiler* compiler = getThreadCompiler();
+        if (cachedAST && !mScriptReloadingEnabled && compiler->_compileSerialisedAST(cachedAST, groupName))
+            return;
+
+        if (!nodes)
+            nodes = ScriptParser::parse(ScriptLexer::tokenize(stream->getAsString(), name));
+        if (mScriptReloadingEnabled)
+        {
+            ScriptCompiler::ObjectHashMap hashes;
+            compiler->_compileChangedObjects(nodes, groupName, hashes, false);
+            OGRE_LOCK_AUTO_MUTEX;
+            mObjectHashes[name].swap(hashes);
+            return;
+        }
+        if (!mSaveCompiledScriptsToCache)
+        {
+            compiler->compile(nodes, groupName);
+            return;
+        }
+
+        MemoryDataStreamPtr ast = compiler->_compileAndSerialiseAST(nodes, groupName);
+        if (ast)
+        {
+            OGRE_WQ_LOCK_MUTEX(mScriptCacheMutex);
+            CachedScript& cached = mScriptCache[name];
+            cached.hash = hash;
+            cached.ast = ast;
+            mScriptCacheDirty = true;
+        }
+    }
+    //-----------------------------------------------------------------------
+    MemoryDataStreamPtr ScriptCompilerManager::getCachedAST(const String& name, uint32 hash)
+    {
+        OGRE_WQ_LOCK_MUTEX(mScriptCacheMutex);
+        ScriptCacheMap::const_iterator i = mScriptCache.find(name);
+        if (i != mScriptCache.end() && i->second.hash == hash)
+            return i->second.ast;
+        return MemoryDataStreamPtr();
+    }
+    //-----------------------------------------------------------------------
+    bool ScriptCompilerManager::getSaveCompiledScriptsToCache() const
+    {
+        return mSaveCompiledScriptsToCache;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::setSaveCompiledScriptsToCache(bool val)
+    {
+        mSaveCompiledScriptsToCache = val;
+    }
+    //-----------------------------------------------------------------------
+    bool ScriptCompilerManager::getScriptReloadingEnabled() const
+    {
+        return mScriptReloadingEnabled;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::setScriptReloadingEnabled(bool val)
+    {
+        mScriptReloadingEnabled = val;
+    }
+    //-----------------------------------------------------------------------
+    size_t ScriptCompilerManager::reloadScript(DataStreamPtr& stream, const String& groupName)
+    {
+        const String& name = stream->getName();
+        ConcreteNodeListPtr nodes = ScriptParser::parse(ScriptLexer::tokenize(stream->getAsString(), name));
+
+        ScriptCompiler::ObjectHashMap hashes;
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            ObjectHashesMap::const_iterator i = mObjectHashes.find(name);
+            if (i != mObjectHashes.end())
+                hashes = i->second;
+        }
+
+        size_t count = getThreadCompiler()->_compileChangedObjects(nodes, groupName, hashes, true);
+        LogManager::getSingleton().logMessage("Reloaded " + StringConverter::toString(count) +
+            " objects of script " + name);
+
+        if (mScriptReloadingEnabled)
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            mObjectHashes[name].swap(hashes);
+        }
+        return count;
+    }
+    //-----------------------------------------------------------------------
+    bool ScriptCompilerManager::isScriptCacheDirty() const
+    {
+        return mScriptCacheDirty;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::saveScriptCache(DataStreamPtr stream) const
+    {
+        if (!mScriptCacheDirty)
+            return;
+
+        if (!stream->isWriteable())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Unable to write to stream " + stream->getName(),
+                "ScriptCompilerManager::saveScriptCache");
+        }
+
+        OGRE_WQ_LOCK_MUTEX(mScriptCacheMutex);
+        uint32 version = SCRIPT_CACHE_VERSION;
+        stream->write(&version, sizeof(uint32));
+        uint32 count = static_cast<uint32>(mScriptCache.size());
+        stream->write(&count, sizeof(uint32));
+
+        for (ScriptCacheMap::const_iterator i = mScriptCache.begin(); i != mScriptCache.end(); ++i)
+        {
+            uint32 nameLength = static_cast<uint32>(i->first.size());
+            stream->write(&nameLength, sizeof(uint32));
+            stream->write(i->first.data(), nameLength);
+            stream->write(&i->second.hash, sizeof(uint32));
+            uint32 astLength = static_cast<uint32>(i->second.ast->size());
+            stream->write(&astLength, sizeof(uint32));
+            stream->write(i->second.ast->getPtr(), astLength);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::loadScriptCache(DataStreamPtr stream)
+    {
+        OGRE_WQ_LOCK_MUTEX(mScriptCacheMutex);
+        mScriptCache.clear();
+        mScriptCacheDirty = false;
+
+        // Caches of other versions are ignored, and rewritten on save
+        uint32 version = 0, count = 0;
+        if (!readValue(*stream, version) || version != SCRIPT_CACHE_VERSION)
+        {
+            mScriptCacheDirty = true;
+            return;
+        }
+
+        // Every length is checked against the data left, so a truncated or corrupt
+        // cache is dropped as a whole instead of allocating or reading past its end
+        ScriptCacheMap cache;
+        bool valid = readValue(*stream, count);
+        for (uint32 i = 0; valid && i < count; ++i)
+        {
+            String name;
+            CachedScript cached;
+            uint32 astLength = 0;
+            valid = readString(*stream, name) && readValue(*stream, cached.hash) &&
+                readValue(*stream, astLength) && astLength <= stream->size() - stream->tell();
+            if (valid)
+            {
+                cached.ast.reset(OGRE_NEW MemoryDataStream(name, astLength));
+                valid = astLength == 0 || stream->read(cached.ast->getPtr(), astLength) == astLength;
+                cache[name] = cached;
+            }
+        }
+
+        if (!valid)
+        {
+            LogManager::getSingleton().logMessage("Script cache " + stream->getName() +
+                " is truncated or corrupt, it is ignored", LML_CRITICAL);
+            mScriptCacheDirty = true;
+            return;
+        }
+        mScriptCache.swap(cache);
     }
 
     //-------------------------------------------------------------------------
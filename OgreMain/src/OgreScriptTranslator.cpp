@@ -137,7 +137,7 @@ namespace Ogre{
 
         AtomAbstractNode *atom = (AtomAbstractNode*)node.get();
         char* end;
-        *result = (float)strtod_l(atom->value.c_str(), &end, StringConverter::_numLocale);
+        *result = (float)StringConverter::_strtod(atom->value.c_str(), &end);
         return atom->value.c_str() != end;
     }
     //-------------------------------------------------------------------------
@@ -148,7 +148,7 @@ namespace Ogre{
 
         AtomAbstractNode *atom = (AtomAbstractNode*)node.get();
         char* end;
-        *result = strtod_l(atom->value.c_str(), &end, StringConverter::_numLocale);
+        *result = StringConverter::_strtod(atom->value.c_str(), &end);
         return atom->value.c_str() != end;
     }
     //-------------------------------------------------------------------------
@@ -2346,9 +2346,7 @@ namespace Ogre{
                                     if(i1 != prop->values.end() && (*i1)->type == ANT_ATOM)
                                     {
                                         AtomAbstractNode *atom = (AtomAbstractNode*)(*i1).get();
-                                        if(StringConverter::isNumber(atom->value))
-                                            constant = StringConverter::parseReal(atom->value);
-                                        else
+                                        if(!StringConverter::parseNumber(atom->value, constant))
                                             compiler->addError(ScriptCompiler::CE_INVALIDPARAMETERS, prop->file, prop->line);
                                     }
                                     else
@@ -2360,9 +2358,7 @@ namespace Ogre{
                                     if(i2 != prop->values.end() && (*i2)->type == ANT_ATOM)
                                     {
                                         AtomAbstractNode *atom = (AtomAbstractNode*)(*i2).get();
-                                        if(StringConverter::isNumber(atom->value))
-                                            linear = StringConverter::parseReal(atom->value);
-                                        else
+                                        if(!StringConverter::parseNumber(atom->value, linear))
                                             compiler->addError(ScriptCompiler::CE_INVALIDPARAMETERS, prop->file, prop->line);
                                     }
                                     else
@@ -2374,9 +2370,7 @@ namespace Ogre{
                                     if(i3 != prop->values.end() && (*i3)->type == ANT_ATOM)
                                     {
                                         AtomAbstractNode *atom = (AtomAbstractNode*)(*i3).get();
-                                        if(StringConverter::isNumber(atom->value))
-                                            quadratic = StringConverter::parseReal(atom->value);
-                                        else
+                                        if(!StringConverter::parseNumber(atom->value, quadratic))
                                             compiler->addError(ScriptCompiler::CE_INVALIDPARAMETERS, prop->file, prop->line);
                                     }
                                     else
@@ -4547,6 +4541,10 @@ namespace Ogre{
         for(list<std::pair<String,String> >::type::iterator i = customParameters.begin(); i != customParameters.end(); ++i)
             prog->setParameter(i->first, i->second);
 
+        // Give the render system a chance to start compiling while the scripts are parsed
+        if(prog->isSupported())
+            prog->prepare();
+
         // Set up default parameters
         if(prog->isSupported() && params)
         {
@@ -5902,6 +5900,7 @@ namespace Ogre{
                         float widthFactor = 1.0f, heightFactor = 1.0f;
                         bool widthSet = false, heightSet = false, formatSet = false;
                         bool pooled = false;
+                        bool dynamicResolution = false;
                         bool hwGammaWrite = false;
                         bool fsaa = true;
                         uint16 depthBufferId = DepthBuffer::POOL_DEFAULT;
@@ -5969,6 +5968,9 @@ namespace Ogre{
                             case ID_POOLED:
                                 pooled = true;
                                 break;
+                            case ID_DYNAMIC_RESOLUTION:
+                                dynamicResolution = true;
+                                break;
                             case ID_SCOPE_LOCAL:
                                 scope = CompositionTechnique::TS_LOCAL;
                                 break;
@@ -6056,6 +6058,7 @@ namespace Ogre{
                         def->depthBufferId = depthBufferId;
                         def->pooled = pooled;
                         def->scope = scope;
+                        def->dynamicResolution = dynamicResolution;
                     }
                     break;
                 case ID_TEXTURE_REF:
@@ -6338,6 +6341,42 @@ namespace Ogre{
                         }
                     }
                     break;
+                case ID_LOAD_ACTION:
+                case ID_STORE_ACTION:
+                    if(prop->values.empty())
+                    {
+                        compiler->addError(ScriptCompiler::CE_STRINGEXPECTED, prop->file, prop->line);
+                        return;
+                    }
+                    else
+                    {
+                        /// The action, followed by the buffers it applies to, all buffers if none are given
+                        AbstractNodeList::const_iterator k = prop->values.begin();
+                        uint32 action = (*k)->type == ANT_ATOM ? ((AtomAbstractNode*)(*k).get())->id : 0;
+                        uint32 buffers = 0;
+                        for(++k; k != prop->values.end(); ++k)
+                        {
+                            uint32 id = (*k)->type == ANT_ATOM ? ((AtomAbstractNode*)(*k).get())->id : 0;
+                            if(id == ID_COLOUR)
+                                buffers |= FBT_COLOUR;
+                            else if(id == ID_DEPTH)
+                                buffers |= FBT_DEPTH;
+                            else if(id == ID_STENCIL)
+                                buffers |= FBT_STENCIL;
+                            else
+                                compiler->addError(ScriptCompiler::CE_INVALIDPARAMETERS, prop->file, prop->line);
+                        }
+                        if(!buffers)
+                            buffers = FBT_COLOUR | FBT_DEPTH | FBT_STENCIL;
+
+                        if(prop->id == ID_LOAD_ACTION && (action == ID_LOAD || action == ID_DONT_CARE))
+                            mTarget->setLoadAction(action == ID_LOAD ? RenderTarget::LA_LOAD : RenderTarget::LA_DONT_CARE, buffers);
+                        else if(prop->id == ID_STORE_ACTION && (action == ID_STORE || action == ID_DISCARD))
+                            mTarget->setStoreAction(action == ID_STORE ? RenderTarget::SA_STORE : RenderTarget::SA_DISCARD, buffers);
+                        else
+                            compiler->addError(ScriptCompiler::CE_INVALIDPARAMETERS, prop->file, prop->line);
+                    }
+                    break;
                 default:
                     compiler->addError(ScriptCompiler::CE_UNEXPECTEDTOKEN, prop->file, prop->line,
                                        "token \"" + prop->name + "\" is not recognized");
@@ -6383,6 +6422,8 @@ namespace Ogre{
             mPass->setType(CompositionPass::PT_RENDERQUAD);
         else if(type == "render_scene")
             mPass->setType(CompositionPass::PT_RENDERSCENE);
+        else if(type == "compute")
+            mPass->setType(CompositionPass::PT_COMPUTE);
         else if(type == "render_custom") {
             mPass->setType(CompositionPass::PT_RENDERCUSTOM);
             String customType;
@@ -6397,7 +6438,7 @@ namespace Ogre{
         else
         {
             compiler->addError(ScriptCompiler::CE_INVALIDPARAMETERS, obj->file, obj->line,
-                               "pass types must be \"clear\", \"stencil\", \"render_quad\", \"render_scene\" or \"render_custom\".");
+                               "pass types must be \"clear\", \"stencil\", \"render_quad\", \"render_scene\", \"compute\" or \"render_custom\".");
             return;
         }
 
@@ -6670,6 +6711,86 @@ namespace Ogre{
                         }
                     }
                     break;
+                case ID_IMAGE:
+                    if(prop->values.size() < 2)
+                    {
+                        compiler->addError(ScriptCompiler::CE_STRINGEXPECTED, prop->file, prop->line);
+                        return;
+                    }
+                    else if (prop->values.size() > 4)
+                    {
+                        compiler->addError(ScriptCompiler::CE_FEWERPARAMETERSEXPECTED, prop->file, prop->line);
+                        return;
+                    }
+                    else
+                    {
+                        AbstractNodeList::const_iterator i0 = getNodeAt(prop->values, 0), i1 = getNodeAt(prop->values, 1);
+                        uint32 id;
+                        String name;
+                        if(!getUInt(*i0, &id) || !getString(*i1, &name))
+                        {
+                            compiler->addError(ScriptCompiler::CE_INVALIDPARAMETERS, prop->file, prop->line);
+                            return;
+                        }
+
+                        // Optional MRT index, then optional access
+                        uint32 index = 0;
+                        TextureAccess access = TA_READ_WRITE;
+                        AbstractNodeList::const_iterator it = getNodeAt(prop->values, 2);
+                        if(it != prop->values.end() && getUInt(*it, &index))
+                            ++it;
+                        if(it != prop->values.end())
+                        {
+                            String accessName;
+                            getString(*it, &accessName);
+                            if(accessName == "read")
+                                access = TA_READ;
+                            else if(accessName == "write")
+                                access = TA_WRITE;
+                            else if(accessName == "read_write")
+                                access = TA_READ_WRITE;
+                            else
+                            {
+                                compiler->addError(ScriptCompiler::CE_INVALIDPARAMETERS, prop->file, prop->line,
+                                    "image access must be \"read\", \"write\" or \"read_write\"");
+                                return;
+                            }
+                            if(++it != prop->values.end())
+                            {
+                                compiler->addError(ScriptCompiler::CE_FEWERPARAMETERSEXPECTED, prop->file, prop->line);
+                                return;
+                            }
+                        }
+
+                        mPass->setImage(id, name, index, access);
+                    }
+                    break;
+                case ID_THREAD_GROUP_SIZE:
+                    if(prop->values.size() < 2)
+                    {
+                        compiler->addError(ScriptCompiler::CE_NUMBEREXPECTED, prop->file, prop->line);
+                        return;
+                    }
+                    else if (prop->values.size() > 3)
+                    {
+                        compiler->addError(ScriptCompiler::CE_FEWERPARAMETERSEXPECTED, prop->file, prop->line);
+                        return;
+                    }
+                    else
+                    {
+                        AbstractNodeList::const_iterator i0 = getNodeAt(prop->values, 0), i1 = getNodeAt(prop->values, 1), i2 = getNodeAt(prop->values, 2);
+                        uint32 x, y, z = 1;
+                        if(getUInt(*i0, &x) && getUInt(*i1, &y) &&
+                           (i2 == prop->values.end() || getUInt(*i2, &z)))
+                        {
+                            mPass->setThreadGroupSize(Vector3(Real(x), Real(y), Real(z)));
+                        }
+                        else
+                        {
+                            compiler->addError(ScriptCompiler::CE_NUMBEREXPECTED, prop->file, prop->line);
+                        }
+                    }
+                    break;
                 case ID_IDENTIFIER:
                     if(prop->values.empty())
                     {
@@ -276,7 +276,7 @@ namespace Ogre
     void FocusedShadowCameraSetup::calculateLVS(const SceneManager& sm, const Camera& cam, 
         const Light& light, const AxisAlignedBox& sceneBB, PointListBody *out_LVS) const
     {
-        ConvexBody bodyLVS;
+        ConvexBody& bodyLVS = mBodyLVS;
 
         // init body with view frustum
         bodyLVS.define(cam);
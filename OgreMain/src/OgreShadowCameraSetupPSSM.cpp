@@ -30,12 +30,15 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreShadowCameraSetupPSSM.h"
 #include "OgreCamera.h"
+#include "OgreLight.h"
+#include "OgreSceneManager.h"
+#include "OgreViewport.h"
 
 namespace Ogre
 {
     //---------------------------------------------------------------------
     PSSMShadowCameraSetup::PSSMShadowCameraSetup()
-        : mSplitPadding(1.0f), mCurrentIteration(0)
+        : mSplitPadding(1.0f), mStableCascades(false), mCurrentIteration(0)
     {
         calculateSplitPoints(3, 100, 100000);
         setOptimalAdjustFactor(0, 5);
@@ -57,6 +60,7 @@ namespace Ogre
 
         mSplitPoints.resize(splitCount + 1);
         mOptimalAdjustFactors.resize(splitCount);
+        mSplitUpdateIntervals.resize(splitCount, 1);
         mSplitCount = splitCount;
 
         mSplitPoints[0] = nearDist;
@@ -80,6 +84,7 @@ namespace Ogre
         mSplitCount = static_cast<uint>(newSplitPoints.size() - 1);
         mSplitPoints = newSplitPoints;
         mOptimalAdjustFactors.resize(mSplitCount);
+        mSplitUpdateIntervals.resize(mSplitCount, 1);
     }
     //---------------------------------------------------------------------
     void PSSMShadowCameraSetup::setOptimalAdjustFactor(size_t splitIndex, Real factor)
@@ -91,6 +96,25 @@ namespace Ogre
         
     }
     //---------------------------------------------------------------------
+    void PSSMShadowCameraSetup::setSplitUpdateInterval(size_t splitIndex, uint32 frames)
+    {
+        if (splitIndex >= mSplitUpdateIntervals.size())
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Split index out of range", 
+            "PSSMShadowCameraSetup::setSplitUpdateInterval");
+        mSplitUpdateIntervals[splitIndex] = std::max(frames, uint32(1));
+    }
+    //---------------------------------------------------------------------
+    bool PSSMShadowCameraSetup::isShadowCameraUpdateDue(size_t iteration, size_t lightIndex,
+        unsigned long frameNumber) const
+    {
+        if (iteration >= mSplitUpdateIntervals.size())
+            return true;
+
+        // offset by split and light, so that they take turns
+        uint32 interval = mSplitUpdateIntervals[iteration];
+        return (frameNumber + iteration + lightIndex) % interval == 0;
+    }
+    //---------------------------------------------------------------------
     Real PSSMShadowCameraSetup::getOptimalAdjustFactor() const
     {
         // simplifies the overriding of the LiSPSM opt adjust factor use
@@ -124,7 +148,10 @@ namespace Ogre
         _cam->setNearClipDistance(nearDist);
         _cam->setFarClipDistance(farDist);
 
-        LiSPSMShadowCameraSetup::getShadowCamera(sm, cam, vp, light, texCam, iteration);
+        if (mStableCascades && light->getType() == Light::LT_DIRECTIONAL)
+            getStableShadowCamera(sm, cam, light, texCam);
+        else
+            LiSPSMShadowCameraSetup::getShadowCamera(sm, cam, vp, light, texCam, iteration);
 
         // restore near/far
         _cam->setNearClipDistance(oldNear);
@@ -132,4 +159,57 @@ namespace Ogre
 
 
     }
+    //---------------------------------------------------------------------
+    void PSSMShadowCameraSetup::getStableShadowCamera(const SceneManager *sm, const Camera *cam,
+        const Light *light, Camera *texCam) const
+    {
+        // bounding sphere of the split, its size does not change as the view turns
+        const Vector3* corners = cam->getWorldSpaceCorners();
+        Vector3 centre = Vector3::ZERO;
+        for (int i = 0; i < 8; ++i)
+            centre += corners[i];
+        centre /= 8;
+        Real radius = 0;
+        for (int i = 0; i < 8; ++i)
+            radius = std::max(radius, centre.distance(corners[i]));
+        // round up, so that precision errors do not change the size either
+        radius = Math::Ceil(radius);
+
+        // light space, with an up vector which does not follow the view
+        Vector3 dir = light->getDerivedDirection();
+        dir.normalise();
+        Vector3 up = Math::Abs(dir.y) < 0.99f ? Vector3::UNIT_Y : Vector3::UNIT_Z;
+        Vector3 zAxis = -dir;
+        Vector3 xAxis = up.crossProduct(zAxis);
+        xAxis.normalise();
+        Vector3 yAxis = zAxis.crossProduct(xAxis);
+        Quaternion orientation(xAxis, yAxis, zAxis);
+
+        // move by whole texels only, so that the casters are rasterised the same way
+        const Viewport* shadowView = texCam->getViewport();
+        int texels = shadowView ? shadowView->getActualWidth() : 0;
+        if (texels > 0)
+        {
+            Real texelSize = radius * 2 / texels;
+            Vector3 lightCentre = orientation.Inverse() * centre;
+            lightCentre.x = Math::Floor(lightCentre.x / texelSize) * texelSize;
+            lightCentre.y = Math::Floor(lightCentre.y / texelSize) * texelSize;
+            centre = orientation * lightCentre;
+        }
+
+        // pull back to take in the casters between the light and the split
+        Real backDist = radius + sm->getShadowDirectionalLightExtrusionDistance();
+        Real farDist = backDist + radius;
+        Matrix4 view = Math::makeViewMatrix(centre - dir * backDist, orientation);
+
+        Matrix4 proj = Matrix4::ZERO;
+        proj[0][0] = 1 / radius;
+        proj[1][1] = 1 / radius;
+        proj[2][2] = -2 / farDist;
+        proj[2][3] = -1;
+        proj[3][3] = 1;
+
+        texCam->setCustomViewMatrix(true, view);
+        texCam->setCustomProjectionMatrix(true, proj);
+    }
 }
@@ -57,263 +57,288 @@ namespace Ogre {
         edgeData->updateTriangleLightFacing(lightPos);
     }
     // ------------------------------------------------------------------------
-    void ShadowCaster::generateShadowVolume(EdgeData* edgeData, 
-        const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize, 
-        const Light* light, ShadowRenderableList& shadowRenderables, unsigned long flags)
-    {
-        // Edge groups should be 1:1 with shadow renderables
-        assert(edgeData->edgeGroups.size() == shadowRenderables.size());
-
-        Light::LightTypes lightType = light->getType();
-
-        // Whether to use the McGuire method, a triangle fan covering all silhouette
-        // This won't work properly with multiple separate edge groups (should be one fan per group, not implemented)
-        // or when light position is inside light cap bound as extrusion could be in opposite directions
-        // and McGuire cap could intersect near clip plane of camera frustum without being noticed.
-        bool useMcGuire = edgeData->edgeGroups.size() <= 1 && 
-            (lightType == Light::LT_DIRECTIONAL || !getLightCapBounds().contains(light->getDerivedPosition()));
-        EdgeData::EdgeGroupList::const_iterator egi, egiend;
-        ShadowRenderableList::const_iterator si;
-
-        // pre-count the size of index data we need since it makes a big perf difference
-        // to GL in particular if we lock a smaller area of the index buffer
-        size_t preCountIndexes = 0;
-
-        si = shadowRenderables.begin();
-        egiend = edgeData->edgeGroups.end();
-        for (egi = edgeData->edgeGroups.begin(); egi != egiend; ++egi, ++si)
+    namespace {
+        /// Number of indexes the shadow volume of the edge data takes
+        size_t countShadowVolumeIndexes(const EdgeData* edgeData,
+            Light::LightTypes lightType, bool useMcGuire, unsigned long flags)
         {
-            const EdgeData::EdgeGroup& eg = *egi;
-            bool  firstDarkCapTri = true;
+            size_t preCountIndexes = 0;
 
-            EdgeData::EdgeList::const_iterator i, iend;
-            iend = eg.edges.end();
-            for (i = eg.edges.begin(); i != iend; ++i)
+            EdgeData::EdgeGroupList::const_iterator egi, egiend;
+            egiend = edgeData->edgeGroups.end();
+            for (egi = edgeData->edgeGroups.begin(); egi != egiend; ++egi)
             {
-                const EdgeData::Edge& edge = *i;
+                const EdgeData::EdgeGroup& eg = *egi;
+                bool  firstDarkCapTri = true;
 
-                // Silhouette edge, when two tris has opposite light facing, or
-                // degenerate edge where only tri 1 is valid and the tri light facing
-                char lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
-                if ((edge.degenerate && lightFacing) ||
-                    (!edge.degenerate && (lightFacing != edgeData->triangleLightFacings[edge.triIndex[1]])))
+                EdgeData::EdgeList::const_iterator i, iend;
+                iend = eg.edges.end();
+                for (i = eg.edges.begin(); i != iend; ++i)
                 {
+                    const EdgeData::Edge& edge = *i;
 
-                    preCountIndexes += 3;
-
-                    // Are we extruding to infinity?
-                    if (!(lightType == Light::LT_DIRECTIONAL &&
-                        flags & SRF_EXTRUDE_TO_INFINITY))
+                    // Silhouette edge, when two tris has opposite light facing, or
+                    // degenerate edge where only tri 1 is valid and the tri light facing
+                    char lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
+                    if ((edge.degenerate && lightFacing) ||
+                        (!edge.degenerate && (lightFacing != edgeData->triangleLightFacings[edge.triIndex[1]])))
                     {
+
                         preCountIndexes += 3;
-                    }
 
-                    if(useMcGuire)
-                    {
-                        // Do dark cap tri
-                        // Use McGuire et al method, a triangle fan covering all silhouette
-                        // edges and one point (taken from the initial tri)
-                        if (flags & SRF_INCLUDE_DARK_CAP)
+                        // Are we extruding to infinity?
+                        if (!(lightType == Light::LT_DIRECTIONAL &&
+                            flags & SRF_EXTRUDE_TO_INFINITY))
                         {
-                            if (firstDarkCapTri)
-                            {
-                                firstDarkCapTri = false;
-                            }
-                            else
+                            preCountIndexes += 3;
+                        }
+
+                        if(useMcGuire)
+                        {
+                            // Do dark cap tri
+                            // Use McGuire et al method, a triangle fan covering all silhouette
+                            // edges and one point (taken from the initial tri)
+                            if (flags & SRF_INCLUDE_DARK_CAP)
                             {
-                                preCountIndexes += 3;
+                                if (firstDarkCapTri)
+                                {
+                                    firstDarkCapTri = false;
+                                }
+                                else
+                                {
+                                    preCountIndexes += 3;
+                                }
                             }
                         }
                     }
-                }
 
-            }
+                }
 
-            if(useMcGuire)
-            {
-                // Do light cap
-                if (flags & SRF_INCLUDE_LIGHT_CAP) 
+                if(useMcGuire)
                 {
-                    // Iterate over the triangles which are using this vertex set
-                    EdgeData::TriangleList::const_iterator ti, tiend;
-                    EdgeData::TriangleLightFacingList::const_iterator lfi;
-                    ti = edgeData->triangles.begin() + eg.triStart;
-                    tiend = ti + eg.triCount;
-                    lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                    for ( ; ti != tiend; ++ti, ++lfi)
+                    // Do light cap
+                    if (flags & SRF_INCLUDE_LIGHT_CAP) 
                     {
-                        assert(ti->vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
+                        // Iterate over the triangles which are using this vertex set
+                        EdgeData::TriangleList::const_iterator ti, tiend;
+                        EdgeData::TriangleLightFacingList::const_iterator lfi;
+                        ti = edgeData->triangles.begin() + eg.triStart;
+                        tiend = ti + eg.triCount;
+                        lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
+                        for ( ; ti != tiend; ++ti, ++lfi)
                         {
-                            preCountIndexes += 3;
+                            assert(ti->vertexSet == eg.vertexSet);
+                            // Check it's light facing
+                            if (*lfi)
+                            {
+                                preCountIndexes += 3;
+                            }
                         }
-                    }
 
+                    }
                 }
-            }
-            else
-            {
-                // Do both caps
-                int increment = ((flags & SRF_INCLUDE_DARK_CAP) ? 3 : 0) + ((flags & SRF_INCLUDE_LIGHT_CAP) ? 3 : 0);
-                if(increment != 0)
+                else
                 {
-                    // Iterate over the triangles which are using this vertex set
-                    EdgeData::TriangleList::const_iterator ti, tiend;
-                    EdgeData::TriangleLightFacingList::const_iterator lfi;
-                    ti = edgeData->triangles.begin() + eg.triStart;
-                    tiend = ti + eg.triCount;
-                    lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                    for ( ; ti != tiend; ++ti, ++lfi)
+                    // Do both caps
+                    int increment = ((flags & SRF_INCLUDE_DARK_CAP) ? 3 : 0) + ((flags & SRF_INCLUDE_LIGHT_CAP) ? 3 : 0);
+                    if(increment != 0)
                     {
-                        assert(ti->vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
-                            preCountIndexes += increment;
+                        // Iterate over the triangles which are using this vertex set
+                        EdgeData::TriangleList::const_iterator ti, tiend;
+                        EdgeData::TriangleLightFacingList::const_iterator lfi;
+                        ti = edgeData->triangles.begin() + eg.triStart;
+                        tiend = ti + eg.triCount;
+                        lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
+                        for ( ; ti != tiend; ++ti, ++lfi)
+                        {
+                            assert(ti->vertexSet == eg.vertexSet);
+                            // Check it's light facing
+                            if (*lfi)
+                                preCountIndexes += increment;
+                        }
                     }
                 }
             }
+
+            return preCountIndexes;
         }
-        // End pre-count
-        
-        //Check if index buffer is to small 
-        if (preCountIndexes > indexBuffer->getNumIndexes())
+        //---------------------------------------------------------------------
+        /// Lock the part of the index buffer the next shadow volume goes to
+        unsigned short* lockShadowIndexBuffer(const HardwareIndexBufferSharedPtr& indexBuffer,
+            size_t& indexBufferUsedSize, size_t preCountIndexes)
         {
-            LogManager::getSingleton().logMessage(LML_CRITICAL, 
-                String("Warning: shadow index buffer size to small. Auto increasing buffer size to") + 
-                StringConverter::toString(sizeof(unsigned short) * preCountIndexes));
-            
-            SceneManager* pManager = Root::getSingleton()._getCurrentSceneManager();
-            if (pManager)
+            //Check if index buffer is to small 
+            if (preCountIndexes > indexBuffer->getNumIndexes())
             {
-                pManager->setShadowIndexBufferSize(preCountIndexes);
-            }
+                LogManager::getSingleton().logMessage(LML_CRITICAL, 
+                    String("Warning: shadow index buffer size to small. Auto increasing buffer size to") + 
+                    StringConverter::toString(sizeof(unsigned short) * preCountIndexes));
             
-            //Check that the index buffer size has actually increased
-            if (preCountIndexes > indexBuffer->getNumIndexes())
+                SceneManager* pManager = Root::getSingleton()._getCurrentSceneManager();
+                if (pManager)
+                {
+                    pManager->setShadowIndexBufferSize(preCountIndexes);
+                }
+            
+                //Check that the index buffer size has actually increased
+                if (preCountIndexes > indexBuffer->getNumIndexes())
+                {
+                    //increasing index buffer size has failed
+                    OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                        "Lock request out of bounds.",
+                        "ShadowCaster::generateShadowVolume");
+                }
+            }
+            else if(indexBufferUsedSize + preCountIndexes > indexBuffer->getNumIndexes())
             {
-                //increasing index buffer size has failed
-                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
-                    "Lock request out of bounds.",
-                    "ShadowCaster::generateShadowVolume");
+                indexBufferUsedSize = 0;
             }
-        }
-        else if(indexBufferUsedSize + preCountIndexes > indexBuffer->getNumIndexes())
-        {
-            indexBufferUsedSize = 0;
-        }
 
-        // Lock index buffer for writing, just enough length as we need
-        unsigned short* pIdx = static_cast<unsigned short*>(
-            indexBuffer->lock(sizeof(unsigned short) * indexBufferUsedSize, sizeof(unsigned short) * preCountIndexes,
-            indexBufferUsedSize == 0 ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NO_OVERWRITE));
-        size_t numIndices = indexBufferUsedSize;
-        
-        // Iterate over the groups and form renderables for each based on their
-        // lightFacing
-        si = shadowRenderables.begin();
-        egiend = edgeData->edgeGroups.end();
-        for (egi = edgeData->edgeGroups.begin(); egi != egiend; ++egi, ++si)
+            // Lock index buffer for writing, just enough length as we need
+            return static_cast<unsigned short*>(
+                indexBuffer->lock(sizeof(unsigned short) * indexBufferUsedSize, sizeof(unsigned short) * preCountIndexes,
+                indexBufferUsedSize == 0 ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NO_OVERWRITE));
+        }
+        //---------------------------------------------------------------------
+        /** Write the indexes of the shadow volume, along with the number of indexes
+            of each shadow renderable and of its light cap, see ShadowVolumeCache.
+            The light cap of a renderable follows the rest of its indexes, whether
+            it is separate or not.
+        */
+        size_t writeShadowVolumeIndexes(const EdgeData* edgeData, Light::LightTypes lightType,
+            bool useMcGuire, unsigned long flags,
+            const ShadowCaster::ShadowRenderableList& shadowRenderables,
+            unsigned short* pIdx, vector<size_t>::type& indexCounts)
         {
-            const EdgeData::EdgeGroup& eg = *egi;
-            // Initialise the index start for this shadow renderable
-            IndexData* indexData = (*si)->getRenderOperationForUpdate()->indexData;
-
-            if (indexData->indexBuffer != indexBuffer)
+            // Iterate over the groups and form renderables for each based on their
+            // lightFacing
+            size_t numIndices = 0;
+            EdgeData::EdgeGroupList::const_iterator egi, egiend;
+            ShadowCaster::ShadowRenderableList::const_iterator si = shadowRenderables.begin();
+            egiend = edgeData->edgeGroups.end();
+            for (egi = edgeData->edgeGroups.begin(); egi != egiend; ++egi, ++si)
             {
-                (*si)->rebindIndexBuffer(indexBuffer);
-                indexData = (*si)->getRenderOperationForUpdate()->indexData;
-            }
+                const EdgeData::EdgeGroup& eg = *egi;
+                // Where the indexes of this shadow renderable start
+                size_t indexStart = numIndices;
+                // original number of verts (without extruded copy)
+                size_t originalVertexCount = eg.vertexData->vertexCount;
+                bool  firstDarkCapTri = true;
+                unsigned short darkCapStart = 0;
+
+                EdgeData::EdgeList::const_iterator i, iend;
+                iend = eg.edges.end();
+                for (i = eg.edges.begin(); i != iend; ++i)
+                {
+                    const EdgeData::Edge& edge = *i;
+
+                    // Silhouette edge, when two tris has opposite light facing, or
+                    // degenerate edge where only tri 1 is valid and the tri light facing
+                    char lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
+                    if ((edge.degenerate && lightFacing) ||
+                        (!edge.degenerate && (lightFacing != edgeData->triangleLightFacings[edge.triIndex[1]])))
+                    {
+                        size_t v0 = edge.vertIndex[0];
+                        size_t v1 = edge.vertIndex[1];
+                        if (!lightFacing)
+                        {
+                            // Inverse edge indexes when t1 is light away
+                            std::swap(v0, v1);
+                        }
 
-            indexData->indexStart = numIndices;
-            // original number of verts (without extruded copy)
-            size_t originalVertexCount = eg.vertexData->vertexCount;
-            bool  firstDarkCapTri = true;
-            unsigned short darkCapStart = 0;
+                        /* Note edge(v0, v1) run anticlockwise along the edge from
+                        the light facing tri so to point shadow volume tris outward,
+                        light cap indexes have to be backwards
 
-            EdgeData::EdgeList::const_iterator i, iend;
-            iend = eg.edges.end();
-            for (i = eg.edges.begin(); i != iend; ++i)
-            {
-                const EdgeData::Edge& edge = *i;
+                        We emit 2 tris if light is a point light, 1 if light 
+                        is directional, because directional lights cause all
+                        points to converge to a single point at infinity.
 
-                // Silhouette edge, when two tris has opposite light facing, or
-                // degenerate edge where only tri 1 is valid and the tri light facing
-                char lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
-                if ((edge.degenerate && lightFacing) ||
-                    (!edge.degenerate && (lightFacing != edgeData->triangleLightFacings[edge.triIndex[1]])))
-                {
-                    size_t v0 = edge.vertIndex[0];
-                    size_t v1 = edge.vertIndex[1];
-                    if (!lightFacing)
-                    {
-                        // Inverse edge indexes when t1 is light away
-                        std::swap(v0, v1);
-                    }
+                        First side tri = near1, near0, far0
+                        Second tri = far0, far1, near1
 
-                    /* Note edge(v0, v1) run anticlockwise along the edge from
-                    the light facing tri so to point shadow volume tris outward,
-                    light cap indexes have to be backwards
-
-                    We emit 2 tris if light is a point light, 1 if light 
-                    is directional, because directional lights cause all
-                    points to converge to a single point at infinity.
-
-                    First side tri = near1, near0, far0
-                    Second tri = far0, far1, near1
-
-                    'far' indexes are 'near' index + originalVertexCount
-                    because 'far' verts are in the second half of the 
-                    buffer
-                    */
-                    assert(v1 < 65536 && v0 < 65536 && (v0 + originalVertexCount) < 65536 &&
-                        "Vertex count exceeds 16-bit index limit!");
-                    *pIdx++ = static_cast<unsigned short>(v1);
-                    *pIdx++ = static_cast<unsigned short>(v0);
-                    *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                    numIndices += 3;
-
-                    // Are we extruding to infinity?
-                    if (!(lightType == Light::LT_DIRECTIONAL &&
-                        flags & SRF_EXTRUDE_TO_INFINITY))
-                    {
-                        // additional tri to make quad
-                        *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                        *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
+                        'far' indexes are 'near' index + originalVertexCount
+                        because 'far' verts are in the second half of the 
+                        buffer
+                        */
+                        assert(v1 < 65536 && v0 < 65536 && (v0 + originalVertexCount) < 65536 &&
+                            "Vertex count exceeds 16-bit index limit!");
                         *pIdx++ = static_cast<unsigned short>(v1);
+                        *pIdx++ = static_cast<unsigned short>(v0);
+                        *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
                         numIndices += 3;
-                    }
 
-                    if(useMcGuire)
-                    {
-                        // Do dark cap tri
-                        // Use McGuire et al method, a triangle fan covering all silhouette
-                        // edges and one point (taken from the initial tri)
-                        if (flags & SRF_INCLUDE_DARK_CAP)
+                        // Are we extruding to infinity?
+                        if (!(lightType == Light::LT_DIRECTIONAL &&
+                            flags & SRF_EXTRUDE_TO_INFINITY))
+                        {
+                            // additional tri to make quad
+                            *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
+                            *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
+                            *pIdx++ = static_cast<unsigned short>(v1);
+                            numIndices += 3;
+                        }
+
+                        if(useMcGuire)
                         {
-                            if (firstDarkCapTri)
+                            // Do dark cap tri
+                            // Use McGuire et al method, a triangle fan covering all silhouette
+                            // edges and one point (taken from the initial tri)
+                            if (flags & SRF_INCLUDE_DARK_CAP)
                             {
-                                darkCapStart = static_cast<unsigned short>(v0 + originalVertexCount);
-                                firstDarkCapTri = false;
+                                if (firstDarkCapTri)
+                                {
+                                    darkCapStart = static_cast<unsigned short>(v0 + originalVertexCount);
+                                    firstDarkCapTri = false;
+                                }
+                                else
+                                {
+                                    *pIdx++ = darkCapStart;
+                                    *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
+                                    *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
+                                    numIndices += 3;
+                                }
+
                             }
-                            else
+                        }
+                    }
+
+                }
+
+                if(!useMcGuire)
+                {
+                    // Do dark cap
+                    if (flags & SRF_INCLUDE_DARK_CAP) 
+                    {
+                        // Iterate over the triangles which are using this vertex set
+                        EdgeData::TriangleList::const_iterator ti, tiend;
+                        EdgeData::TriangleLightFacingList::const_iterator lfi;
+                        ti = edgeData->triangles.begin() + eg.triStart;
+                        tiend = ti + eg.triCount;
+                        lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
+                        for ( ; ti != tiend; ++ti, ++lfi)
+                        {
+                            const EdgeData::Triangle& t = *ti;
+                            assert(t.vertexSet == eg.vertexSet);
+                            // Check it's light facing
+                            if (*lfi)
                             {
-                                *pIdx++ = darkCapStart;
-                                *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
-                                *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
+                                assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
+                                    t.vertIndex[2] < 65536 && 
+                                    "16-bit index limit exceeded!");
+                                *pIdx++ = static_cast<unsigned short>(t.vertIndex[1] + originalVertexCount);
+                                *pIdx++ = static_cast<unsigned short>(t.vertIndex[0] + originalVertexCount);
+                                *pIdx++ = static_cast<unsigned short>(t.vertIndex[2] + originalVertexCount);
                                 numIndices += 3;
                             }
-
                         }
+
                     }
                 }
 
-            }
-
-            if(!useMcGuire)
-            {
-                // Do dark cap
-                if (flags & SRF_INCLUDE_DARK_CAP) 
+                // Do light cap, its indexes come last so it can be separate
+                size_t lightCapStart = numIndices;
+                if (flags & SRF_INCLUDE_LIGHT_CAP) 
                 {
                     // Iterate over the triangles which are using this vertex set
                     EdgeData::TriangleList::const_iterator ti, tiend;
@@ -331,71 +356,154 @@ namespace Ogre {
                             assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
                                 t.vertIndex[2] < 65536 && 
                                 "16-bit index limit exceeded!");
-                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[1] + originalVertexCount);
-                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[0] + originalVertexCount);
-                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[2] + originalVertexCount);
+                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[0]);
+                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[1]);
+                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[2]);
                             numIndices += 3;
                         }
                     }
 
                 }
+
+                indexCounts.push_back(lightCapStart - indexStart);
+                indexCounts.push_back(numIndices - lightCapStart);
             }
 
-            // Do light cap
-            if (flags & SRF_INCLUDE_LIGHT_CAP) 
+            return numIndices;
+
+        }
+        //---------------------------------------------------------------------
+        /// Point the shadow renderables to their indexes in the index buffer
+        void setShadowVolumeRanges(const ShadowCaster::ShadowRenderableList& shadowRenderables,
+            const HardwareIndexBufferSharedPtr& indexBuffer, size_t indexStart,
+            const vector<size_t>::type& indexCounts, unsigned long flags)
+        {
+            for (size_t i = 0; i < shadowRenderables.size(); ++i)
             {
-                // separate light cap?
-                if ((*si)->isLightCapSeparate())
-                {
-                    // update index count for this shadow renderable
-                    indexData->indexCount = numIndices - indexData->indexStart;
+                ShadowRenderable* sr = shadowRenderables[i];
+                IndexData* indexData = sr->getRenderOperationForUpdate()->indexData;
 
-                    // get light cap index data for update
-                    indexData = (*si)->getLightCapRenderable()->getRenderOperationForUpdate()->indexData;
-                    // start indexes after the current total
-                    indexData->indexStart = numIndices;
+                if (indexData->indexBuffer != indexBuffer)
+                {
+                    sr->rebindIndexBuffer(indexBuffer);
+                    indexData = sr->getRenderOperationForUpdate()->indexData;
                 }
 
-                // Iterate over the triangles which are using this vertex set
-                EdgeData::TriangleList::const_iterator ti, tiend;
-                EdgeData::TriangleLightFacingList::const_iterator lfi;
-                ti = edgeData->triangles.begin() + eg.triStart;
-                tiend = ti + eg.triCount;
-                lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                for ( ; ti != tiend; ++ti, ++lfi)
+                size_t indexCount = indexCounts[i * 2];
+                size_t lightCapIndexCount = indexCounts[i * 2 + 1];
+                indexData->indexStart = indexStart;
+
+                if ((flags & SRF_INCLUDE_LIGHT_CAP) && sr->isLightCapSeparate())
                 {
-                    const EdgeData::Triangle& t = *ti;
-                    assert(t.vertexSet == eg.vertexSet);
-                    // Check it's light facing
-                    if (*lfi)
-                    {
-                        assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
-                            t.vertIndex[2] < 65536 && 
-                            "16-bit index limit exceeded!");
-                        *pIdx++ = static_cast<unsigned short>(t.vertIndex[0]);
-                        *pIdx++ = static_cast<unsigned short>(t.vertIndex[1]);
-                        *pIdx++ = static_cast<unsigned short>(t.vertIndex[2]);
-                        numIndices += 3;
-                    }
-                }
+                    indexData->indexCount = indexCount;
 
+                    indexData = sr->getLightCapRenderable()->getRenderOperationForUpdate()->indexData;
+                    indexData->indexStart = indexStart + indexCount;
+                    indexData->indexCount = lightCapIndexCount;
+                }
+                else
+                {
+                    indexData->indexCount = indexCount + lightCapIndexCount;
+                }
+                indexStart += indexCount + lightCapIndexCount;
             }
+        }
+        //---------------------------------------------------------------------
+        /** Whether to use the McGuire method, a triangle fan covering all silhouette edges.
+            This won't work properly with multiple separate edge groups (should be one fan per group, not implemented)
+            or when light position is inside light cap bound as extrusion could be in opposite directions
+            and McGuire cap could intersect near clip plane of camera frustum without being noticed.
+        */
+        bool useMcGuireCap(const EdgeData* edgeData, const Light* light, const AxisAlignedBox& lightCapBounds)
+        {
+            return edgeData->edgeGroups.size() <= 1 &&
+                (light->getType() == Light::LT_DIRECTIONAL || !lightCapBounds.contains(light->getDerivedPosition()));
+        }
+        //---------------------------------------------------------------------
+        /// Number of lights whose shadow volumes a caster keeps
+        const size_t MAX_CACHED_SHADOW_VOLUMES = 8;
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::generateShadowVolume(EdgeData* edgeData, 
+        const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize, 
+        const Light* light, ShadowRenderableList& shadowRenderables, unsigned long flags)
+    {
+        // Edge groups should be 1:1 with shadow renderables
+        assert(edgeData->edgeGroups.size() == shadowRenderables.size());
 
-            // update index count for current index data (either this shadow renderable or its light cap)
-            indexData->indexCount = numIndices - indexData->indexStart;
+        Light::LightTypes lightType = light->getType();
+        bool useMcGuire = useMcGuireCap(edgeData, light, getLightCapBounds());
 
-        }
+        // pre-count the size of index data we need since it makes a big perf difference
+        // to GL in particular if we lock a smaller area of the index buffer
+        size_t preCountIndexes = countShadowVolumeIndexes(edgeData, lightType, useMcGuire, flags);
+
+        unsigned short* pIdx = lockShadowIndexBuffer(indexBuffer, indexBufferUsedSize, preCountIndexes);
+
+        vector<size_t>::type indexCounts;
+        indexCounts.reserve(shadowRenderables.size() * 2);
+        size_t numIndices = writeShadowVolumeIndexes(edgeData, lightType, useMcGuire, flags,
+            shadowRenderables, pIdx, indexCounts);
 
         // Unlock index buffer
         indexBuffer->unlock();
 
         // In debug mode, check we didn't overrun the index buffer
-        assert(numIndices == indexBufferUsedSize + preCountIndexes);
-        assert(numIndices <= indexBuffer->getNumIndexes() &&
+        assert(numIndices == preCountIndexes);
+        assert(indexBufferUsedSize + numIndices <= indexBuffer->getNumIndexes() &&
             "Index buffer overrun while generating shadow volume!! "
             "You must increase the size of the shadow index buffer.");
 
-        indexBufferUsedSize = numIndices;
+        setShadowVolumeRanges(shadowRenderables, indexBuffer, indexBufferUsedSize, indexCounts, flags);
+        indexBufferUsedSize += numIndices;
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::generateShadowVolume(ShadowVolumeCacheMap& caches, const Vector4& lightPos,
+        EdgeData* edgeData, const HardwareIndexBufferSharedPtr& indexBuffer,
+        size_t& indexBufferUsedSize, const Light* light,
+        ShadowRenderableList& shadowRenderables, unsigned long flags)
+    {
+        // Edge groups should be 1:1 with shadow renderables
+        assert(edgeData->edgeGroups.size() == shadowRenderables.size());
+
+        Light::LightTypes lightType = light->getType();
+        bool useMcGuire = useMcGuireCap(edgeData, light, getLightCapBounds());
+
+        ShadowVolumeCacheMap::iterator ci = caches.find(light);
+        if (ci == caches.end())
+        {
+            // Lights come and go, don't let the volumes of old ones pile up
+            if (caches.size() >= MAX_CACHED_SHADOW_VOLUMES)
+                caches.clear();
+            ci = caches.insert(ShadowVolumeCacheMap::value_type(light, ShadowVolumeCache())).first;
+        }
+
+        ShadowVolumeCache& cache = ci->second;
+        if (cache.edgeData != edgeData || cache.lightPos != lightPos ||
+            cache.flags != flags || cache.useMcGuire != useMcGuire)
+        {
+            // Something moved, generate the volume again
+            updateEdgeListLightFacing(edgeData, lightPos);
+
+            cache.indexes.resize(countShadowVolumeIndexes(edgeData, lightType, useMcGuire, flags));
+            cache.indexCounts.clear();
+            writeShadowVolumeIndexes(edgeData, lightType, useMcGuire, flags, shadowRenderables,
+                cache.indexes.empty() ? 0 : &cache.indexes[0], cache.indexCounts);
+
+            cache.edgeData = edgeData;
+            cache.lightPos = lightPos;
+            cache.flags = flags;
+            cache.useMcGuire = useMcGuire;
+        }
+
+        size_t numIndices = cache.indexes.size();
+        unsigned short* pIdx = lockShadowIndexBuffer(indexBuffer, indexBufferUsedSize, numIndices);
+        if (numIndices)
+            memcpy(pIdx, &cache.indexes[0], sizeof(unsigned short) * numIndices);
+        indexBuffer->unlock();
+
+        setShadowVolumeRanges(shadowRenderables, indexBuffer, indexBufferUsedSize, cache.indexCounts, flags);
+        indexBufferUsedSize += numIndices;
     }
     // ------------------------------------------------------------------------
     void ShadowCaster::extrudeVertices(
@@ -53,6 +53,107 @@ namespace Ogre
         return !( lhs == rhs );
     }
     //-----------------------------------------------------------------------
+    namespace
+    {
+        uint32 floorPO2(uint32 n)
+        {
+            return n ? 1u << Bitwise::mostSignificantBitSet(n) : 1;
+        }
+        /// The odd or even bits of a Z-order index
+        uint32 compactBits(uint64 index)
+        {
+            uint32 result = 0;
+            for (int bit = 0; bit < 32; ++bit)
+                result |= static_cast<uint32>((index >> (bit * 2)) & 1) << bit;
+            return result;
+        }
+        struct RegionLarger
+        {
+            const vector<uint32>::type& edges;
+            RegionLarger(const vector<uint32>::type& e) : edges(e) {}
+            bool operator()(size_t a, size_t b) const { return edges[a] > edges[b]; }
+        };
+    }
+    //-----------------------------------------------------------------------
+    ShadowAtlasAllocator::ShadowAtlasAllocator(uint32 atlasSize, uint32 minRegionSize)
+    {
+        setAtlasSize(atlasSize);
+        setMinRegionSize(minRegionSize);
+    }
+    //-----------------------------------------------------------------------
+    void ShadowAtlasAllocator::setAtlasSize(uint32 size)
+    {
+        mAtlasSize = floorPO2(size);
+    }
+    //-----------------------------------------------------------------------
+    void ShadowAtlasAllocator::setMinRegionSize(uint32 size)
+    {
+        mMinRegionSize = floorPO2(size);
+    }
+    //-----------------------------------------------------------------------
+    size_t ShadowAtlasAllocator::getMaxRegions(void) const
+    {
+        uint32 perRow = mAtlasSize / std::min(mMinRegionSize, mAtlasSize);
+        return static_cast<size_t>(perRow) * perRow;
+    }
+    //-----------------------------------------------------------------------
+    bool ShadowAtlasAllocator::allocate(const vector<uint32>::type& sizes,
+        vector<Rect>::type& regions) const
+    {
+        regions.assign(sizes.size(), Rect(0, 0, 0, 0));
+
+        const uint32 minSize = std::min(mMinRegionSize, mAtlasSize);
+        const uint64 atlasArea = static_cast<uint64>(mAtlasSize) * mAtlasSize;
+        vector<uint32>::type edges(sizes.size());
+        uint64 area = 0;
+        for (size_t i = 0; i < sizes.size(); ++i)
+        {
+            edges[i] = Math::Clamp(floorPO2(sizes[i]), minSize, mAtlasSize);
+            area += static_cast<uint64>(edges[i]) * edges[i];
+        }
+
+        // shrink the largest regions until all fit by area
+        while (area > atlasArea)
+        {
+            size_t largest = 0;
+            for (size_t i = 1; i < edges.size(); ++i)
+            {
+                if (edges[i] > edges[largest])
+                    largest = i;
+            }
+            if (edges[largest] <= minSize)
+                break;
+            uint64 edge = edges[largest];
+            area -= edge * edge - (edge / 2) * (edge / 2);
+            edges[largest] /= 2;
+        }
+
+        // largest first, every region then starts at a multiple of its own area
+        // along the Z-order curve, which is an aligned square of the atlas
+        vector<size_t>::type order(sizes.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), RegionLarger(edges));
+
+        bool allFit = true;
+        uint64 offset = 0;
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            uint32 edge = edges[order[i]];
+            uint64 regionArea = static_cast<uint64>(edge) * edge;
+            if (offset + regionArea > atlasArea)
+            {
+                allFit = false;
+                continue;
+            }
+            long left = compactBits(offset);
+            long top = compactBits(offset >> 1);
+            regions[order[i]] = Rect(left, top, left + edge, top + edge);
+            offset += regionArea;
+        }
+        return allFit;
+    }
+    //-----------------------------------------------------------------------
     template<> ShadowTextureManager* Singleton<ShadowTextureManager>::msSingleton = 0;
     ShadowTextureManager* ShadowTextureManager::getSingletonPtr(void)
     {
@@ -122,6 +223,30 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    TexturePtr ShadowTextureManager::getShadowAtlas(const ShadowTextureConfig& config)
+    {
+        for (ShadowTextureList::iterator t = mAtlasList.begin(); t != mAtlasList.end(); ++t)
+        {
+            const TexturePtr& tex = *t;
+            if (config.width == tex->getWidth() && config.height == tex->getHeight()
+                && config.format == tex->getFormat() && config.fsaa == tex->getFSAA())
+            {
+                return tex;
+            }
+        }
+
+        static const String baseName = "Ogre/ShadowAtlas";
+        String targName = baseName + StringConverter::toString(mCount++);
+        TexturePtr atlas = TextureManager::getSingleton().createManual(
+            targName, 
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, 
+            TEX_TYPE_2D, config.width, config.height, 0, config.format, 
+            TU_RENDERTARGET, NULL, false, config.fsaa);
+        atlas->load();
+        mAtlasList.push_back(atlas);
+        return atlas;
+    }
+    //---------------------------------------------------------------------
     TexturePtr ShadowTextureManager::getNullShadowTexture(PixelFormat format)
     {
         for (ShadowTextureList::iterator t = mNullTextureList.begin(); t != mNullTextureList.end(); ++t)
@@ -190,6 +315,18 @@ namespace Ogre
                 ++i;
             }
         }
+        for (ShadowTextureList::iterator i = mAtlasList.begin(); i != mAtlasList.end(); )
+        {
+            if ((*i).use_count() == ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS + 1)
+            {
+                TextureManager::getSingleton().remove((*i)->getHandle());
+                i = mAtlasList.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
 
     }
     //---------------------------------------------------------------------
@@ -200,6 +337,11 @@ namespace Ogre
             TextureManager::getSingleton().remove((*i)->getHandle());
         }
         mTextureList.clear();
+        for (ShadowTextureList::iterator i = mAtlasList.begin(); i != mAtlasList.end(); ++i)
+        {
+            TextureManager::getSingleton().remove((*i)->getHandle());
+        }
+        mAtlasList.clear();
 
     }
     //---------------------------------------------------------------------
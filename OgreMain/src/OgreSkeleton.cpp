@@ -247,12 +247,14 @@ namespace Ogre {
               if(animState->hasBlendMask())
               {
                 anim->apply(this, animState->getTimePosition(), animState->getWeight() * weightFactor,
-                  animState->getBlendMask(), linked ? linked->scale : 1.0f);
+                  animState->getBlendMask(), linked ? linked->scale : 1.0f,
+                  animState->_getKeyFrameIndexHint());
               }
               else
               {
                 anim->apply(this, animState->getTimePosition(), 
-                  animState->getWeight() * weightFactor, linked ? linked->scale : 1.0f);
+                  animState->getWeight() * weightFactor, linked ? linked->scale : 1.0f,
+                  animState->_getKeyFrameIndexHint());
               }
             }
         }
@@ -683,6 +685,19 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    size_t Skeleton::reduceAllAnimations(Real positionTolerance, const Radian& orientationTolerance,
+        Real scaleTolerance)
+    {
+        size_t removed = 0;
+        AnimationList::iterator ai, aiend;
+        aiend = mAnimationsList.end();
+        for (ai = mAnimationsList.begin(); ai != aiend; ++ai)
+        {
+            removed += ai->second->reduceKeyFrames(positionTolerance, orientationTolerance, scaleTolerance);
+        }
+        return removed;
+    }
+    //---------------------------------------------------------------------
     void Skeleton::addLinkedSkeletonAnimationSource(const String& skelName, 
         Real scale)
     {
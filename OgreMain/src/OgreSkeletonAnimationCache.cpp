@@ -0,0 +1,149 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSkeletonAnimationCache.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationState.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    template <class T>
+    static void _appendKey(vector<uint32>::type& key, const T& value)
+    {
+        // Raw bits of the value, padded to a whole number of words
+        uint32 words[(sizeof(T) + sizeof(uint32) - 1) / sizeof(uint32)] = { 0 };
+        memcpy(words, &value, sizeof(T));
+        key.insert(key.end(), words, words + sizeof(words) / sizeof(words[0]));
+    }
+    //-----------------------------------------------------------------------
+    SkeletonAnimationCache::SkeletonAnimationCache(Real timeQuantum)
+        : mTimeQuantum(timeQuantum)
+        , mFrameNumber(0)
+        , mNumHits(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    SkeletonAnimationCache::~SkeletonAnimationCache()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void SkeletonAnimationCache::clear(void)
+    {
+        OGRE_WQ_LOCK_MUTEX(mMutex);
+        mEntries.clear();
+        mKeys.clear();
+        mBoneMatrices.clear();
+        mNumHits = 0;
+    }
+    //-----------------------------------------------------------------------
+    void SkeletonAnimationCache::buildKey(const Skeleton* skeleton, SkeletonInstance* instance,
+        const AnimationStateSet& animSet)
+    {
+        mCurrentKey.clear();
+        _appendKey(mCurrentKey, skeleton);
+        _appendKey(mCurrentKey, instance->getNumBones());
+        _appendKey(mCurrentKey, instance->getBlendMode());
+        // The time positions below are only comparable for the same quantum
+        _appendKey(mCurrentKey, mTimeQuantum);
+
+        // Same states as Skeleton::setAnimationState applies
+        EnabledAnimationStateList::const_iterator it, itend = animSet.getEnabledAnimationStates().end();
+        for (it = animSet.getEnabledAnimationStates().begin(); it != itend; ++it)
+        {
+            const AnimationState* animState = *it;
+            Animation* anim = instance->_getAnimationImpl(animState->getAnimationName());
+            if (!anim)
+                continue;
+
+            _appendKey(mCurrentKey, anim);
+            Real timePos = animState->getTimePosition();
+            if (mTimeQuantum > 0)
+                _appendKey(mCurrentKey, static_cast<int32>(Math::Floor(timePos / mTimeQuantum + 0.5f)));
+            else
+                _appendKey(mCurrentKey, timePos);
+            _appendKey(mCurrentKey, animState->getWeight());
+
+            uint32 blendMaskHash = 0;
+            if (animState->hasBlendMask())
+            {
+                const AnimationState::BoneBlendMask& mask = *animState->getBlendMask();
+                blendMaskHash = FastHash((const char*)&mask[0], mask.size() * sizeof(float), 1);
+            }
+            _appendKey(mCurrentKey, blendMaskHash);
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool SkeletonAnimationCache::_getBoneMatrices(const Skeleton* skeleton, SkeletonInstance* instance,
+        const AnimationStateSet& animSet, Matrix4* boneMatrices, unsigned long frameNumber)
+    {
+        OGRE_WQ_LOCK_MUTEX(mMutex);
+
+        // Poses are only shared within a frame
+        if (frameNumber != mFrameNumber)
+        {
+            mEntries.clear();
+            mKeys.clear();
+            mBoneMatrices.clear();
+            mNumHits = 0;
+            mFrameNumber = frameNumber;
+        }
+
+        buildKey(skeleton, instance, animSet);
+        uint32 hash = FastHash((const char*)&mCurrentKey[0], mCurrentKey.size() * sizeof(uint32));
+        size_t numBones = instance->getNumBones();
+
+        EntryList::const_iterator i, iend = mEntries.end();
+        for (i = mEntries.begin(); i != iend; ++i)
+        {
+            if (i->hash == hash && i->keySize == mCurrentKey.size() &&
+                std::equal(mCurrentKey.begin(), mCurrentKey.end(), mKeys.begin() + i->keyOffset))
+            {
+                memcpy(boneMatrices, &mBoneMatrices[i->boneMatrixOffset], numBones * sizeof(Matrix4));
+                ++mNumHits;
+                return true;
+            }
+        }
+
+        // Evaluate the pose, and record it for the other entities
+        instance->setAnimationState(animSet);
+        instance->_getBoneMatrices(boneMatrices);
+
+        Entry entry;
+        entry.hash = hash;
+        entry.keyOffset = mKeys.size();
+        entry.keySize = mCurrentKey.size();
+        entry.boneMatrixOffset = mBoneMatrices.size();
+        mEntries.push_back(entry);
+        mKeys.insert(mKeys.end(), mCurrentKey.begin(), mCurrentKey.end());
+        mBoneMatrices.insert(mBoneMatrices.end(), boneMatrices, boneMatrices + numBones);
+
+        return false;
+    }
+
+}
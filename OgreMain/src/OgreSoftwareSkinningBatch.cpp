@@ -0,0 +1,264 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSoftwareSkinningBatch.h"
+#include "OgreOptimisedUtil.h"
+#include "Threading/OgreParallel.h"
+
+namespace Ogre {
+    namespace
+    {
+        /// Skins the vertex ranges of a batch
+        struct SkinningJob : public ParallelJob
+        {
+            const SoftwareSkinningBatch::Blend* blends;
+            const Matrix4* const* matrices;
+            /// Blend and first vertex of each item
+            vector<std::pair<size_t, size_t> >::type items;
+            size_t verticesPerItem;
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const SoftwareSkinningBatch::Blend& blend = blends[items[i].first];
+                    size_t first = items[i].second;
+                    blend.skin(matrices + blend.matrixOffset, first,
+                        std::min(first + verticesPerItem, blend.vertexCount));
+                }
+            }
+        };
+    }
+    //---------------------------------------------------------------------
+    void SoftwareSkinningBatch::Blend::lockBuffer(const HardwareVertexBufferSharedPtr& buf,
+        HardwareBuffer::LockOptions options, void** pBuffer, SourceLockMap* sourceLocks)
+    {
+        if (sourceLocks && options == HardwareBuffer::HBL_READ_ONLY)
+        {
+            SourceLockMap::iterator i = sourceLocks->find(buf.get());
+            if (i == sourceLocks->end())
+            {
+                i = sourceLocks->insert(SourceLockMap::value_type(buf.get(),
+                    std::make_pair(buf, buf->lock(options)))).first;
+            }
+            *pBuffer = i->second.second;
+            return;
+        }
+        *pBuffer = buf->lock(options);
+        mLocked[mNumLocked++] = buf;
+    }
+    //---------------------------------------------------------------------
+    void SoftwareSkinningBatch::Blend::lock(const VertexData* sourceVertexData,
+        const VertexData* targetVertexData, bool blendNormals, SourceLockMap* sourceLocks)
+    {
+        srcPos = srcNorm = destPos = destNorm = blendWeight = 0;
+        blendIdx = 0;
+        srcNormStride = destNormStride = 0;
+        vertexCount = targetVertexData->vertexCount;
+        matrixOffset = 0;
+        mNumLocked = 0;
+
+        // Get elements for source
+        const VertexElement* srcElemPos =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        const VertexElement* srcElemNorm =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
+        const VertexElement* srcElemBlendIndices =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_BLEND_INDICES);
+        const VertexElement* srcElemBlendWeights =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_BLEND_WEIGHTS);
+        OgreAssert(srcElemPos && srcElemBlendIndices && srcElemBlendWeights,
+            "You must supply at least positions, blend indices and blend weights");
+        // Get elements for target
+        const VertexElement* destElemPos =
+            targetVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        const VertexElement* destElemNorm =
+            targetVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
+
+        // Do we have normals and want to blend them?
+        bool includeNormals = blendNormals && (srcElemNorm != NULL) && (destElemNorm != NULL);
+
+        // Get buffers for source
+        HardwareVertexBufferSharedPtr srcPosBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemPos->getSource());
+        HardwareVertexBufferSharedPtr srcIdxBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendIndices->getSource());
+        HardwareVertexBufferSharedPtr srcWeightBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendWeights->getSource());
+        HardwareVertexBufferSharedPtr srcNormBuf;
+
+        srcPosStride = srcPosBuf->getVertexSize();
+        blendIdxStride = srcIdxBuf->getVertexSize();
+        blendWeightStride = srcWeightBuf->getVertexSize();
+        if (includeNormals)
+        {
+            srcNormBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemNorm->getSource());
+            srcNormStride = srcNormBuf->getVertexSize();
+        }
+        // Get buffers for target
+        HardwareVertexBufferSharedPtr destPosBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemPos->getSource());
+        HardwareVertexBufferSharedPtr destNormBuf;
+        destPosStride = destPosBuf->getVertexSize();
+        if (includeNormals)
+        {
+            destNormBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemNorm->getSource());
+            destNormStride = destNormBuf->getVertexSize();
+        }
+
+        void* pBuffer;
+
+        // Lock source buffers for reading
+        lockBuffer(srcPosBuf, HardwareBuffer::HBL_READ_ONLY, &pBuffer, sourceLocks);
+        srcElemPos->baseVertexPointerToElement(pBuffer, &srcPos);
+        if (includeNormals)
+        {
+            if (srcNormBuf != srcPosBuf)
+            {
+                // Different buffer
+                lockBuffer(srcNormBuf, HardwareBuffer::HBL_READ_ONLY, &pBuffer, sourceLocks);
+            }
+            srcElemNorm->baseVertexPointerToElement(pBuffer, &srcNorm);
+        }
+
+        // Indices must be 4 bytes
+        assert(srcElemBlendIndices->getType() == VET_UBYTE4 &&
+               "Blend indices must be VET_UBYTE4");
+        lockBuffer(srcIdxBuf, HardwareBuffer::HBL_READ_ONLY, &pBuffer, sourceLocks);
+        srcElemBlendIndices->baseVertexPointerToElement(pBuffer, &blendIdx);
+        if (srcWeightBuf != srcIdxBuf)
+        {
+            // Lock buffer
+            lockBuffer(srcWeightBuf, HardwareBuffer::HBL_READ_ONLY, &pBuffer, sourceLocks);
+        }
+        srcElemBlendWeights->baseVertexPointerToElement(pBuffer, &blendWeight);
+        numWeightsPerVertex =
+            VertexElement::getTypeCount(srcElemBlendWeights->getType());
+
+        // Lock destination buffers for writing
+        lockBuffer(destPosBuf,
+            (destNormBuf != destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize()) ||
+            (destNormBuf == destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize() + destElemNorm->getSize()) ?
+            HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL, &pBuffer, sourceLocks);
+        destElemPos->baseVertexPointerToElement(pBuffer, &destPos);
+        if (includeNormals)
+        {
+            if (destNormBuf != destPosBuf)
+            {
+                lockBuffer(destNormBuf,
+                    destNormBuf->getVertexSize() == destElemNorm->getSize() ?
+                    HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL, &pBuffer, sourceLocks);
+            }
+            destElemNorm->baseVertexPointerToElement(pBuffer, &destNorm);
+        }
+    }
+    //---------------------------------------------------------------------
+    void SoftwareSkinningBatch::Blend::skin(const Matrix4* const* blendMatrices,
+        size_t begin, size_t end) const
+    {
+        OptimisedUtil::getImplementation()->softwareVertexSkinning(
+            reinterpret_cast<const float*>(reinterpret_cast<const char*>(srcPos) + begin * srcPosStride),
+            reinterpret_cast<float*>(reinterpret_cast<char*>(destPos) + begin * destPosStride),
+            srcNorm ? reinterpret_cast<const float*>(reinterpret_cast<const char*>(srcNorm) + begin * srcNormStride) : 0,
+            destNorm ? reinterpret_cast<float*>(reinterpret_cast<char*>(destNorm) + begin * destNormStride) : 0,
+            reinterpret_cast<const float*>(reinterpret_cast<const char*>(blendWeight) + begin * blendWeightStride),
+            blendIdx + begin * blendIdxStride,
+            blendMatrices,
+            srcPosStride, destPosStride,
+            srcNormStride, destNormStride,
+            blendWeightStride, blendIdxStride,
+            numWeightsPerVertex,
+            end - begin);
+    }
+    //---------------------------------------------------------------------
+    void SoftwareSkinningBatch::Blend::unlock()
+    {
+        for (size_t i = 0; i < mNumLocked; ++i)
+        {
+            mLocked[i]->unlock();
+            mLocked[i].reset();
+        }
+        mNumLocked = 0;
+    }
+    //---------------------------------------------------------------------
+    SoftwareSkinningBatch::SoftwareSkinningBatch()
+        : mVertexCount(0)
+        , mVerticesPerItem(256)
+    {
+    }
+    //---------------------------------------------------------------------
+    SoftwareSkinningBatch::~SoftwareSkinningBatch()
+    {
+        flush();
+    }
+    //---------------------------------------------------------------------
+    void SoftwareSkinningBatch::addBlend(const VertexData* sourceVertexData,
+        const VertexData* targetVertexData, const Matrix4* const* blendMatrices,
+        size_t numMatrices, bool blendNormals)
+    {
+        mBlends.push_back(Blend());
+        Blend& blend = mBlends.back();
+        blend.lock(sourceVertexData, targetVertexData, blendNormals, &mSourceLocks);
+
+        // the caller reuses its array of blend matrices
+        blend.matrixOffset = mMatrices.size();
+        mMatrices.insert(mMatrices.end(), blendMatrices, blendMatrices + numMatrices);
+        mVertexCount += blend.vertexCount;
+    }
+    //---------------------------------------------------------------------
+    void SoftwareSkinningBatch::flush()
+    {
+        if (mBlends.empty())
+            return;
+
+        SkinningJob* job = OGRE_NEW SkinningJob();
+        ParallelJobPtr jobPtr(job);
+        job->blends = &mBlends[0];
+        job->matrices = mMatrices.empty() ? 0 : &mMatrices[0];
+        job->verticesPerItem = mVerticesPerItem;
+        job->items.reserve(mVertexCount / mVerticesPerItem + mBlends.size());
+        for (size_t b = 0; b < mBlends.size(); ++b)
+        {
+            for (size_t v = 0; v < mBlends[b].vertexCount; v += mVerticesPerItem)
+                job->items.push_back(std::make_pair(b, v));
+        }
+        job->setCount(job->items.size());
+
+        ParallelJob::run(jobPtr);
+
+        // buffers are unlocked on the calling thread again
+        for (BlendList::iterator i = mBlends.begin(); i != mBlends.end(); ++i)
+        {
+            i->unlock();
+        }
+        for (SourceLockMap::iterator i = mSourceLocks.begin(); i != mSourceLocks.end(); ++i)
+        {
+            i->second.first->unlock();
+        }
+        mSourceLocks.clear();
+        mBlends.clear();
+        mMatrices.clear();
+        mVertexCount = 0;
+    }
+}
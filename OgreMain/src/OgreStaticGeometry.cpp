@@ -43,6 +43,7 @@ THE SOFTWARE.
 #include "OgreTechnique.h"
 #include "OgreLodStrategy.h"
 #include "OgreIteratorWrappers.h"
+#include "Threading/OgreParallel.h"
 
 namespace Ogre {
 
@@ -51,6 +52,19 @@ namespace Ogre {
     #define REGION_MAX_INDEX 511
     #define REGION_MIN_INDEX -512
 
+    //--------------------------------------------------------------------------
+    /// Fills the geometry buckets of StaticGeometry::fillGeometryBuckets
+    struct GeometryBucketFiller
+    {
+        StaticGeometry::GeometryBucket* const* buckets;
+        const StaticGeometry::SourceLockMap* locks;
+
+        GeometryBucketFiller(StaticGeometry::GeometryBucket* const* b,
+            const StaticGeometry::SourceLockMap* l) : buckets(b), locks(l) {}
+
+        void operator()(size_t i) const { buckets[i]->_copyGeometry(*locks); }
+    };
+
     //--------------------------------------------------------------------------
     StaticGeometry::StaticGeometry(SceneManager* owner, const String& name):
         mOwner(owner),
@@ -314,8 +328,43 @@ namespace Ogre {
             q->worldBounds = calculateBounds(
                 (*q->geometryLodList)[0].vertexData,
                     position, orientation, scale);
+            q->source = ent;
 
             mQueuedSubMeshes.push_back(q);
+
+            // Already built, only the region this lands in needs rebuilding
+            if (mBuilt)
+            {
+                Region* region = getRegion(q->worldBounds, true);
+                region->assign(q);
+                mDirtyRegions.insert(region->getID());
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::removeEntity(const Entity* ent, const Vector3& position)
+    {
+        QueuedSubMeshList::iterator qi = mQueuedSubMeshes.begin();
+        while (qi != mQueuedSubMeshes.end())
+        {
+            QueuedSubMesh* qsm = *qi;
+            if (qsm->source != ent || qsm->position != position)
+            {
+                ++qi;
+                continue;
+            }
+
+            if (mBuilt)
+            {
+                Region* region = getRegion(qsm->worldBounds, false);
+                if (region)
+                {
+                    region->_unassign(qsm);
+                    mDirtyRegions.insert(region->getID());
+                }
+            }
+            OGRE_DELETE qsm;
+            qi = mQueuedSubMeshes.erase(qi);
         }
     }
     //--------------------------------------------------------------------------
@@ -559,22 +608,104 @@ namespace Ogre {
             Region* region = getRegion(qsm->worldBounds, true);
             region->assign(qsm);
         }
+
+        // Now build all the regions
+        vector<Region*>::type regions;
+        regions.reserve(mRegionMap.size());
+        for (RegionMap::iterator ri = mRegionMap.begin();
+            ri != mRegionMap.end(); ++ri)
+        {
+            regions.push_back(ri->second);
+        }
+        buildRegions(regions);
+
+        mBuilt = true;
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::rebuildDirtyRegions(void)
+    {
+        if (!mBuilt)
+        {
+            build();
+            return;
+        }
+
+        vector<Region*>::type regions;
+        for (set<uint32>::type::iterator di = mDirtyRegions.begin();
+            di != mDirtyRegions.end(); ++di)
+        {
+            RegionMap::iterator ri = mRegionMap.find(*di);
+            if (ri == mRegionMap.end())
+                continue;
+
+            Region* region = ri->second;
+            if (!region->hasQueuedSubMeshes())
+            {
+                // Nothing left in here
+                mOwner->extractMovableObject(region);
+                OGRE_DELETE region;
+                mRegionMap.erase(ri);
+                continue;
+            }
+
+            region->_clearBuild();
+            regions.push_back(region);
+        }
+        mDirtyRegions.clear();
+
+        buildRegions(regions);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::buildRegions(const vector<Region*>::type& regions)
+    {
         bool stencilShadows = false;
         if (mCastShadows && mOwner->isShadowTechniqueStencilBased())
         {
             stencilShadows = true;
         }
 
-        // Now tell each region to build itself
-        for (RegionMap::iterator ri = mRegionMap.begin();
-            ri != mRegionMap.end(); ++ri)
+        // Buffers & materials must be created on this thread
+        MaterialBucket::GeometryBucketList buckets;
+        for (size_t i = 0; i < regions.size(); ++i)
         {
-            ri->second->build(stencilShadows);
-            
+            regions[i]->_prepareBuild(stencilShadows, buckets);
+        }
+
+        fillGeometryBuckets(buckets, stencilShadows);
+
+        for (size_t i = 0; i < regions.size(); ++i)
+        {
+            regions[i]->_finishBuild(stencilShadows);
+
             // Set the visibility flags on these regions
-            ri->second->setVisibilityFlags(mVisibilityFlags);
+            regions[i]->setVisibilityFlags(mVisibilityFlags);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::fillGeometryBuckets(
+        const MaterialBucket::GeometryBucketList& buckets, bool stencilShadows)
+    {
+        if (buckets.empty())
+            return;
+
+        // Geometry is shared between many buckets, so lock each source once
+        SourceLockMap locks;
+        for (size_t i = 0; i < buckets.size(); ++i)
+        {
+            buckets[i]->_lockSources(locks);
         }
 
+        // Buckets are large, claim one at a time
+        parallelFor(0, buckets.size(), GeometryBucketFiller(&buckets[0], &locks));
+
+        for (SourceLockMap::iterator li = locks.begin(); li != locks.end(); ++li)
+        {
+            li->first->unlock();
+        }
+        for (size_t i = 0; i < buckets.size(); ++i)
+        {
+            buckets[i]->_finishBuild(stencilShadows);
+        }
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::destroy(void)
@@ -587,6 +718,8 @@ namespace Ogre {
             OGRE_DELETE i->second;
         }
         mRegionMap.clear();
+        mDirtyRegions.clear();
+        mBuilt = false;
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::reset(void)
@@ -624,6 +757,7 @@ namespace Ogre {
         {
             ri->second->setVisible(visible);
         }
+        mOwner->invalidateShadowTextureCache();
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::setCastShadows(bool castShadows)
@@ -635,7 +769,7 @@ namespace Ogre {
         {
             ri->second->setCastShadows(castShadows);
         }
-
+        mOwner->invalidateShadowTextureCache();
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::setRenderQueueGroup(uint8 queueID)
@@ -718,6 +852,8 @@ namespace Ogre {
         mRegionID(regionID), mCentre(centre), mBoundingRadius(0.0f),
         mCurrentLod(0), mLodStrategy(0), mCamera(0), mSquaredViewDepth(0)
     {
+        // built geometry never moves, so its shadows may be cached
+        mStaticShadowCaster = true;
     }
     //--------------------------------------------------------------------------
     StaticGeometry::Region::~Region()
@@ -739,6 +875,43 @@ namespace Ogre {
         // no need to delete queued meshes, these are managed in StaticGeometry
 
     }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::_clearBuild(void)
+    {
+        if (mNode)
+        {
+            mNode->getParentSceneNode()->removeChild(mNode);
+            mSceneMgr->destroySceneNode(mNode->getName());
+            mNode = 0;
+        }
+        for (LODBucketList::iterator i = mLodBucketList.begin();
+            i != mLodBucketList.end(); ++i)
+        {
+            OGRE_DELETE *i;
+        }
+        mLodBucketList.clear();
+        mCurrentLod = 0;
+
+        // Meshes may have been removed, gather the LODs & bounds again
+        QueuedSubMeshList queued;
+        queued.swap(mQueuedSubMeshes);
+        mLodValues.clear();
+        mLodStrategy = 0;
+        mAABB.setNull();
+        mBoundingRadius = 0;
+        for (QueuedSubMeshList::iterator qi = queued.begin(); qi != queued.end(); ++qi)
+        {
+            assign(*qi);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::_unassign(QueuedSubMesh* qmesh)
+    {
+        QueuedSubMeshList::iterator qi =
+            std::find(mQueuedSubMeshes.begin(), mQueuedSubMeshes.end(), qmesh);
+        if (qi != mQueuedSubMeshes.end())
+            mQueuedSubMeshes.erase(qi);
+    }
     //-----------------------------------------------------------------------
     void StaticGeometry::Region::_releaseManualHardwareResources()
     {
@@ -806,6 +979,15 @@ namespace Ogre {
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::Region::build(bool stencilShadows)
+    {
+        MaterialBucket::GeometryBucketList buckets;
+        _prepareBuild(stencilShadows, buckets);
+        StaticGeometry::fillGeometryBuckets(buckets, stencilShadows);
+        _finishBuild(stencilShadows);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::_prepareBuild(bool stencilShadows,
+        MaterialBucket::GeometryBucketList& buckets)
     {
         // Create a node
         mNode = mSceneMgr->getRootSceneNode()->createChildSceneNode(mName,
@@ -826,12 +1008,18 @@ namespace Ogre {
             {
                 lodBucket->assign(*qi, lod);
             }
-            // now build
-            lodBucket->build(stencilShadows);
+            // now prepare the build, the geometry is filled afterwards
+            lodBucket->_prepareBuild(stencilShadows, buckets);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::_finishBuild(bool stencilShadows)
+    {
+        for (LODBucketList::iterator i = mLodBucketList.begin();
+            i != mLodBucketList.end(); ++i)
+        {
+            (*i)->_finishBuild(stencilShadows);
         }
-
-
-
     }
     //--------------------------------------------------------------------------
     const String& StaticGeometry::Region::getMovableType(void) const
@@ -930,12 +1118,9 @@ namespace Ogre {
         EdgeData* edgeList = mLodBucketList[mCurrentLod]->getEdgeList();
         ShadowRenderableList& shadowRendList = mLodBucketList[mCurrentLod]->getShadowRenderableList();
 
-        // Calc triangle light facing
-        updateEdgeListLightFacing(edgeList, lightPos);
-
-        // Generate indexes and update renderables
-        generateShadowVolume(edgeList, *indexBuffer, *indexBufferUsedSize,
-            light, shadowRendList, flags);
+        // Generate indexes and update renderables, reusing them while the light doesn't move
+        generateShadowVolume(mShadowVolumeCaches, lightPos, edgeList, *indexBuffer,
+            *indexBufferUsedSize, light, shadowRendList, flags);
 
 
         return ShadowCaster::ShadowRenderableListIterator(shadowRendList.begin(), shadowRendList.end());
@@ -1104,18 +1289,33 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     void StaticGeometry::LODBucket::build(bool stencilShadows)
     {
-
+        MaterialBucket::GeometryBucketList buckets;
+        _prepareBuild(stencilShadows, buckets);
+        StaticGeometry::fillGeometryBuckets(buckets, stencilShadows);
+        _finishBuild(stencilShadows);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::LODBucket::_prepareBuild(bool stencilShadows,
+        MaterialBucket::GeometryBucketList& buckets)
+    {
+        // Just pass this on to child buckets
+        for (MaterialBucketMap::iterator i = mMaterialBucketMap.begin();
+            i != mMaterialBucketMap.end(); ++i)
+        {
+            i->second->_prepareBuild(stencilShadows, buckets);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::LODBucket::_finishBuild(bool stencilShadows)
+    {
         EdgeListBuilder eb;
         size_t vertexSet = 0;
 
-        // Just pass this on to child buckets
         for (MaterialBucketMap::iterator i = mMaterialBucketMap.begin();
             i != mMaterialBucketMap.end(); ++i)
         {
             MaterialBucket* mat = i->second;
 
-            mat->build(stencilShadows);
-
             if (stencilShadows)
             {
                 MaterialBucket::GeometryIterator geomIt =
@@ -1315,6 +1515,14 @@ namespace Ogre {
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::MaterialBucket::build(bool stencilShadows)
+    {
+        GeometryBucketList buckets;
+        _prepareBuild(stencilShadows, buckets);
+        StaticGeometry::fillGeometryBuckets(buckets, stencilShadows);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::MaterialBucket::_prepareBuild(bool stencilShadows,
+        GeometryBucketList& buckets)
     {
         mTechnique = 0;
         mMaterial = MaterialManager::getSingleton().getByName(mMaterialName);
@@ -1325,11 +1533,12 @@ namespace Ogre {
                 "StaticGeometry::MaterialBucket::build");
         }
         mMaterial->load();
-        // tell the geometry buckets to build
+        // tell the geometry buckets to create their buffers
         for (GeometryBucketList::iterator i = mGeometryBucketList.begin();
             i != mGeometryBucketList.end(); ++i)
         {
-            (*i)->build(stencilShadows);
+            (*i)->_createBuffers(stencilShadows);
+            buckets.push_back(*i);
         }
     }
     //--------------------------------------------------------------------------
@@ -1425,7 +1634,7 @@ namespace Ogre {
     StaticGeometry::GeometryBucket::GeometryBucket(MaterialBucket* parent,
         const String& formatString, const VertexData* vData,
         const IndexData* iData)
-        : Renderable(), mParent(parent), mFormatString(formatString)
+        : Renderable(), mParent(parent), mFormatString(formatString), mIndexLock(0)
     {
         // Clone the structure from the example
         mVertexData = vData->clone(false);
@@ -1543,34 +1752,61 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     void StaticGeometry::GeometryBucket::build(bool stencilShadows)
     {
-        // Ok, here's where we transfer the vertices and indexes to the shared
-        // buffers
+        _createBuffers(stencilShadows);
+        SourceLockMap locks;
+        _lockSources(locks);
+        _copyGeometry(locks);
+        for (SourceLockMap::iterator li = locks.begin(); li != locks.end(); ++li)
+        {
+            li->first->unlock();
+        }
+        _finishBuild(stencilShadows);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_createBuffers(bool stencilShadows)
+    {
+        // Ok, here's where we create the shared buffers the vertices and
+        // indexes are transferred to
         // Shortcuts
         VertexDeclaration* dcl = mVertexData->vertexDeclaration;
         VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
+        HardwareBufferManager& mgr = HardwareBufferManager::getSingleton();
+        ushort b;
 
-        // create index buffer, and lock
-        mIndexData->indexBuffer = HardwareBufferManager::getSingleton()
-            .createIndexBuffer(mIndexType, mIndexData->indexCount,
-                HardwareBuffer::HBU_STATIC_WRITE_ONLY);
-        uint32* p32Dest = 0;
-        uint16* p16Dest = 0;
-        if (mIndexType == HardwareIndexBuffer::IT_32BIT)
-        {
-            p32Dest = static_cast<uint32*>(
-                mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
-        }
-        else
+        mVertexLocks.clear();
+        mBufferElements.clear();
+
+        // Take ranges of the buffer pools when enabled. Shadow volumes need the
+        // positions twice and edge lists a vertex start of 0, so not with those.
+        if (!stencilShadows && mgr.getPoolPageSize() > 0 &&
+            mgr.createPooledVertexData(mVertexData, HardwareBuffer::HBU_STATIC_WRITE_ONLY) &&
+            mgr.createPooledIndexData(mIndexData, mIndexType, HardwareBuffer::HBU_STATIC_WRITE_ONLY))
         {
-            p16Dest = static_cast<uint16*>(
-                mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+            // Only our ranges may be written, other buckets own the rest
+            size_t indexSize = mIndexData->indexBuffer->getIndexSize();
+            mIndexLock = static_cast<uchar*>(mIndexData->indexBuffer->lock(
+                mIndexData->indexStart * indexSize, mIndexData->indexCount * indexSize,
+                HardwareBuffer::HBL_NORMAL));
+            for (b = 0; b < binds->getBufferCount(); ++b)
+            {
+                HardwareVertexBufferSharedPtr vbuf = binds->getBuffer(b);
+                size_t vertexSize = vbuf->getVertexSize();
+                mVertexLocks.push_back(static_cast<uchar*>(vbuf->lock(
+                    mVertexData->vertexStart * vertexSize, mVertexData->vertexCount * vertexSize,
+                    HardwareBuffer::HBL_NORMAL)));
+                mBufferElements.push_back(dcl->findElementsBySource(b));
+            }
+            return;
         }
+
+        // create index buffer, and lock
+        mIndexData->indexBuffer = mgr.createIndexBuffer(mIndexType, mIndexData->indexCount,
+                HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        mIndexLock = static_cast<uchar*>(
+            mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
         // create all vertex buffers, and lock
-        ushort b;
         ushort posBufferIdx = dcl->findElementBySemantic(VES_POSITION)->getSource();
 
-        vector<uchar*>::type destBufferLocks;
-        vector<VertexDeclaration::VertexElementList>::type bufferElements;
         for (b = 0; b < binds->getBufferCount(); ++b)
         {
             size_t vertexCount = mVertexData->vertexCount;
@@ -1591,11 +1827,52 @@ namespace Ogre {
             binds->setBinding(b, vbuf);
             uchar* pLock = static_cast<uchar*>(
                 vbuf->lock(HardwareBuffer::HBL_DISCARD));
-            destBufferLocks.push_back(pLock);
+            mVertexLocks.push_back(pLock);
             // Pre-cache vertex elements per buffer
-            bufferElements.push_back(dcl->findElementsBySource(b));
+            mBufferElements.push_back(dcl->findElementsBySource(b));
         }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_lockSources(SourceLockMap& locks) const
+    {
+        for (QueuedGeometryList::const_iterator gi = mQueuedGeometry.begin();
+            gi != mQueuedGeometry.end(); ++gi)
+        {
+            HardwareBuffer* ibuf = (*gi)->geometry->indexData->indexBuffer.get();
+            if (locks.find(ibuf) == locks.end())
+            {
+                locks[ibuf] = static_cast<uchar*>(ibuf->lock(HardwareBuffer::HBL_READ_ONLY));
+            }
 
+            // we can rely on buffer counts / formats being the same
+            VertexBufferBinding* srcBinds = (*gi)->geometry->vertexData->vertexBufferBinding;
+            for (ushort b = 0; b < mVertexData->vertexBufferBinding->getBufferCount(); ++b)
+            {
+                HardwareBuffer* vbuf = srcBinds->getBuffer(b).get();
+                if (locks.find(vbuf) == locks.end())
+                {
+                    locks[vbuf] = static_cast<uchar*>(vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+                }
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_copyGeometry(const SourceLockMap& locks)
+    {
+        VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
+        uint32* p32Dest = 0;
+        uint16* p16Dest = 0;
+        if (mIndexType == HardwareIndexBuffer::IT_32BIT)
+        {
+            p32Dest = reinterpret_cast<uint32*>(mIndexLock);
+        }
+        else
+        {
+            p16Dest = reinterpret_cast<uint16*>(mIndexLock);
+        }
+        // Destination pointers, advanced as we go
+        vector<uchar*>::type destBufferLocks = mVertexLocks;
+        ushort b;
 
         // Iterate over the geometry items
         size_t indexOffset = 0;
@@ -1607,31 +1884,19 @@ namespace Ogre {
             QueuedGeometry* geom = *gi;
             // Copy indexes across with offset
             IndexData* srcIdxData = geom->geometry->indexData;
+            const uchar* pSrcIdx = locks.find(srcIdxData->indexBuffer.get())->second +
+                srcIdxData->indexStart * srcIdxData->indexBuffer->getIndexSize();
             if (mIndexType == HardwareIndexBuffer::IT_32BIT)
             {
-                // Lock source indexes
-                uint32* pSrc = static_cast<uint32*>(
-                    srcIdxData->indexBuffer->lock(
-                        srcIdxData->indexStart * srcIdxData->indexBuffer->getIndexSize(), 
-                        srcIdxData->indexCount * srcIdxData->indexBuffer->getIndexSize(),
-                        HardwareBuffer::HBL_READ_ONLY));
-
-                copyIndexes(pSrc, p32Dest, srcIdxData->indexCount, indexOffset);
+                copyIndexes(reinterpret_cast<const uint32*>(pSrcIdx), p32Dest,
+                    srcIdxData->indexCount, indexOffset);
                 p32Dest += srcIdxData->indexCount;
-                srcIdxData->indexBuffer->unlock();
             }
             else
             {
-                // Lock source indexes
-                uint16* pSrc = static_cast<uint16*>(
-                    srcIdxData->indexBuffer->lock(
-                    srcIdxData->indexStart * srcIdxData->indexBuffer->getIndexSize(), 
-                    srcIdxData->indexCount * srcIdxData->indexBuffer->getIndexSize(),
-                    HardwareBuffer::HBL_READ_ONLY));
-
-                copyIndexes(pSrc, p16Dest, srcIdxData->indexCount, indexOffset);
+                copyIndexes(reinterpret_cast<const uint16*>(pSrcIdx), p16Dest,
+                    srcIdxData->indexCount, indexOffset);
                 p16Dest += srcIdxData->indexCount;
-                srcIdxData->indexBuffer->unlock();
             }
 
             // Now deal with vertex buffers
@@ -1640,11 +1905,10 @@ namespace Ogre {
             VertexBufferBinding* srcBinds = srcVData->vertexBufferBinding;
             for (b = 0; b < binds->getBufferCount(); ++b)
             {
-                // lock source
-                HardwareVertexBufferSharedPtr srcBuf =
+                // source, locked up front (no shared pointer copies off the main thread)
+                const HardwareVertexBufferSharedPtr& srcBuf =
                     srcBinds->getBuffer(b);
-                uchar* pSrcBase = static_cast<uchar*>(
-                    srcBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+                uchar* pSrcBase = locks.find(srcBuf.get())->second;
                 // Get buffer lock pointer, we'll update this later
                 uchar* pDstBase = destBufferLocks[b];
                 size_t bufInc = srcBuf->getVertexSize();
@@ -1656,7 +1920,7 @@ namespace Ogre {
                 {
                     // Iterate over vertex elements
                     VertexDeclaration::VertexElementList& elems =
-                        bufferElements[b];
+                        mBufferElements[b];
                     VertexDeclaration::VertexElementList::iterator ei;
                     for (ei = elems.begin(); ei != elems.end(); ++ei)
                     {
@@ -1713,11 +1977,18 @@ namespace Ogre {
 
                 // Update pointer
                 destBufferLocks[b] = pDstBase;
-                srcBuf->unlock();
             }
 
             indexOffset += geom->geometry->vertexData->vertexCount;
         }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_finishBuild(bool stencilShadows)
+    {
+        VertexDeclaration* dcl = mVertexData->vertexDeclaration;
+        VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
+        ushort b;
+        ushort posBufferIdx = dcl->findElementBySemantic(VES_POSITION)->getSource();
 
         // Unlock everything
         mIndexData->indexBuffer->unlock();
@@ -1725,6 +1996,9 @@ namespace Ogre {
         {
             binds->getBuffer(b)->unlock();
         }
+        mIndexLock = 0;
+        mVertexLocks.clear();
+        mBufferElements.clear();
 
         // If we're dealing with stencil shadows, copy the position data from
         // the early half of the buffer to the latter part
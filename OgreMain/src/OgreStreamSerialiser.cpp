@@ -109,6 +109,46 @@ namespace Ogre
 #undef OGRE_GET16BITS
     }
 
+    namespace
+    {
+        /// The growing memory a deferred serialiser writes into
+        class DeferredDataStream : public DataStream
+        {
+        public:
+            DeferredDataStream() : DataStream(READ | WRITE), mPos(0) {}
+
+            size_t read(void* buf, size_t count)
+            {
+                count = std::min(count, mData.size() - mPos);
+                if (count)
+                    memcpy(buf, &mData[mPos], count);
+                mPos += count;
+                return count;
+            }
+            size_t write(const void* buf, size_t count)
+            {
+                if (mPos + count > mData.size())
+                    mData.resize(mPos + count);
+                if (count)
+                    memcpy(&mData[mPos], buf, count);
+                mPos += count;
+                mSize = mData.size();
+                return count;
+            }
+            void skip(long count) { seek(mPos + count); }
+            void seek(size_t pos) { mPos = std::min(pos, mData.size()); }
+            size_t tell(void) const { return mPos; }
+            bool eof(void) const { return mPos >= mData.size(); }
+            void close(void) {}
+
+            vector<uint8>::type& getData(void) { return mData; }
+
+        protected:
+            vector<uint8>::type mData;
+            size_t mPos;
+        };
+    }
+
     //---------------------------------------------------------------------
     uint32 StreamSerialiser::HEADER_ID = 0x00000001;
     uint32 StreamSerialiser::REVERSE_HEADER_ID = 0x10000000;
@@ -121,6 +161,7 @@ namespace Ogre
     StreamSerialiser::StreamSerialiser(const DataStreamPtr& stream, Endian endianMode, 
         bool autoHeader, RealStorageFormat realFormat)
         : mStream(stream)
+        , mDeflateDeferred(false)
         , mEndian(endianMode)
         , mFlipEndian(false)
         , mReadWriteHeader(autoHeader)
@@ -874,8 +915,101 @@ namespace Ogre
         return c;
 
     }
+    StreamSerialiser* StreamSerialiser::createDeferred(Endian endianMode, bool autoHeader, 
+        RealStorageFormat realFormat)
+    {
+        StreamSerialiser* ser = OGRE_NEW StreamSerialiser(
+            DataStreamPtr(OGRE_NEW DeferredDataStream()), endianMode, autoHeader, realFormat);
+        ser->mDeflateDeferred = true;
+        return ser;
+    }
+    //---------------------------------------------------------------------
+    void StreamSerialiser::writeDeferred(const DataStreamPtr& stream)
+    {
+#if OGRE_NO_ZIP_ARCHIVE == 0
+        if (!mDeflateDeferred)
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+                "Not a deferred serialiser", "StreamSerialiser::writeDeferred");
+        if (!mChunkStack.empty())
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+                "Chunks remain unterminated", "StreamSerialiser::writeDeferred");
+
+        vector<uint8>::type& data = static_cast<DeferredDataStream*>(mStream.get())->getData();
+
+        // compress all regions first, the chunks around them start before them
+        vector<vector<uint8>::type>::type compressed(mDeferredDeflates.size());
+        for (size_t i = 0; i < mDeferredDeflates.size(); ++i)
+        {
+            const DeferredDeflate& region = mDeferredDeflates[i];
+            size_t size = region.end - region.start;
+            DeflateStream::compressData(size ? &data[region.start] : 0, size, compressed[i]);
+
+            for (size_t c = 0; c < region.chunkOffsets.size(); ++c)
+            {
+                // skip id (32) and version (16) to the length, then the checksum
+                uint8* header = &data[region.chunkOffsets[c]];
+                Chunk chunk;
+                memcpy(&chunk.id, header, sizeof(uint32));
+                memcpy(&chunk.version, header + sizeof(uint32), sizeof(uint16));
+                memcpy(&chunk.length, header + sizeof(uint32) + sizeof(uint16), sizeof(uint32));
+                if (mFlipEndian)
+                {
+                    Bitwise::bswapBuffer(&chunk.id, sizeof(uint32));
+                    Bitwise::bswapBuffer(&chunk.version, sizeof(uint16));
+                    Bitwise::bswapBuffer(&chunk.length, sizeof(uint32));
+                }
+
+                chunk.length = static_cast<uint32>(chunk.length - size + compressed[i].size());
+                uint32 checksum = calculateChecksum(&chunk);
+                if (mFlipEndian)
+                {
+                    Bitwise::bswapBuffer(&chunk.length, sizeof(uint32));
+                    Bitwise::bswapBuffer(&checksum, sizeof(uint32));
+                }
+                memcpy(header + sizeof(uint32) + sizeof(uint16), &chunk.length, sizeof(uint32));
+                memcpy(header + sizeof(uint32) * 2 + sizeof(uint16), &checksum, sizeof(uint32));
+            }
+        }
+
+        // then everything in order, with the regions replaced
+        size_t pos = 0;
+        for (size_t i = 0; i < mDeferredDeflates.size(); ++i)
+        {
+            const DeferredDeflate& region = mDeferredDeflates[i];
+            if (region.start > pos)
+                stream->write(&data[pos], region.start - pos);
+            if (!compressed[i].empty())
+                stream->write(&compressed[i][0], compressed[i].size());
+            pos = region.end;
+        }
+        if (data.size() > pos)
+            stream->write(&data[pos], data.size() - pos);
+
+        // the lengths are patched now, so this can only be done once
+        mDeferredDeflates.clear();
+        data.clear();
+        mStream->seek(0);
+#else
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                    "Ogre was not built with Zip file support!", "StreamSerialiser::writeDeferred");
+#endif
+    }
+    //---------------------------------------------------------------------
     void StreamSerialiser::startDeflate(size_t avail_in)
     {
+        if (mDeflateDeferred)
+        {
+            OgreAssert( mDeferredDeflates.empty() || mDeferredDeflates.back().end,
+                "Don't start (un)compressing twice!" );
+            DeferredDeflate region;
+            region.start = mStream->tell();
+            region.end = 0;
+            for (ChunkStack::iterator i = mChunkStack.begin(); i != mChunkStack.end(); ++i)
+                region.chunkOffsets.push_back((*i)->offset);
+            mDeferredDeflates.push_back(region);
+            return;
+        }
+
 #if OGRE_NO_ZIP_ARCHIVE == 0
         OgreAssert( !mOriginalStream , "Don't start (un)compressing twice!" );
         DataStreamPtr deflateStream(OGRE_NEW DeflateStream(mStream,"",avail_in));
@@ -888,6 +1022,14 @@ namespace Ogre
     }
     void StreamSerialiser::stopDeflate()
     {
+        if (mDeflateDeferred)
+        {
+            OgreAssert( !mDeferredDeflates.empty() && !mDeferredDeflates.back().end,
+                "Must start (un)compressing first!" );
+            mDeferredDeflates.back().end = mStream->tell();
+            return;
+        }
+
 #if OGRE_NO_ZIP_ARCHIVE == 0
         OgreAssert( mOriginalStream , "Must start (un)compressing first!" );
         mStream = mOriginalStream;
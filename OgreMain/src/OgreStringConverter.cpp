@@ -39,12 +39,109 @@ THE SOFTWARE.
 #   define newlocale(cat, loc, base) 0
 #endif
 
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC && OGRE_COMP_VER < 1900
+#   define snprintf _snprintf
+#endif
+
 namespace Ogre {
     locale_t StringConverter::_numLocale = newlocale(LC_NUMERIC_MASK, OGRE_DEFAULT_LOCALE, NULL);
 
+    namespace {
+        /** Appends val as a StringStream with the given precision would, without the
+            stream and regardless of the global locale.
+        @return false if the number did not fit the buffer
+        */
+        bool appendReal(String& out, double val, int precision = 6)
+        {
+            char buf[64];
+            int len = snprintf(buf, sizeof(buf), "%.*g", precision, val);
+            if (len < 0 || len >= (int)sizeof(buf))
+                return false;
+
+            // %g never groups digits, so a comma can only be the decimal point of the C locale
+            for (int i = 0; i < len; ++i)
+            {
+                if (buf[i] == ',')
+                    buf[i] = '.';
+            }
+            out.append(buf, len);
+            return true;
+        }
+
+        /// Formats the values separated by spaces, as StringStream would
+        String formatReals(const Real* vals, size_t count)
+        {
+            String out;
+            out.reserve(count * 8);
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (i)
+                    out += ' ';
+                appendReal(out, vals[i]);
+            }
+            return out;
+        }
+
+        String formatInteger(uint64 val, bool negative)
+        {
+            char buf[24];
+            char* p = buf + sizeof(buf);
+            do
+            {
+                *--p = char('0' + val % 10);
+                val /= 10;
+            } while (val);
+
+            if (negative)
+                *--p = '-';
+            return String(p, buf + sizeof(buf));
+        }
+
+        inline bool isDelimiter(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\n';
+        }
+
+        /** Splits val at whitespace and parses each token, as StringUtil::split followed 
+            by parseReal would, but without allocating.
+        @return The number of tokens, of which at most maxCount are parsed
+        */
+        size_t parseReals(const String& val, Real* ret, const Real* defaults, size_t maxCount)
+        {
+            size_t count = 0;
+            const char* p = val.c_str();
+            while (*p)
+            {
+                if (isDelimiter(*p))
+                {
+                    ++p;
+                    continue;
+                }
+
+                if (count < maxCount)
+                {
+                    char* end;
+                    Real value = (Real)StringConverter::_strtod(p, &end);
+                    ret[count] = end == p ? defaults[count] : value;
+                }
+                ++count;
+
+                while (*p && !isDelimiter(*p))
+                    ++p;
+            }
+            return count;
+        }
+    }
+
     template<typename T>
     String StringConverter::_toString(T val, uint16 width, char fill, std::ios::fmtflags flags)
     {
+        if (width == 0 && !flags)
+        {
+            bool negative = std::numeric_limits<T>::is_signed && val < T(0);
+            return formatInteger(negative ? uint64(0) - uint64(val) : uint64(val), negative);
+        }
+
         StringStream stream;
         stream.width(width);
         stream.fill(fill);
@@ -64,6 +161,10 @@ namespace Ogre {
     String StringConverter::toString(float val, unsigned short precision,
                                      unsigned short width, char fill, std::ios::fmtflags flags)
     {
+        String ret;
+        if (width == 0 && !flags && appendReal(ret, val, precision))
+            return ret;
+
         StringStream stream;
         stream.precision(precision);
         stream.width(width);
@@ -78,6 +179,10 @@ namespace Ogre {
     String StringConverter::toString(double val, unsigned short precision,
                                      unsigned short width, char fill, std::ios::fmtflags flags)
     {
+        String ret;
+        if (width == 0 && !flags && appendReal(ret, val, precision))
+            return ret;
+
         StringStream stream;
         stream.precision(precision);
         stream.width(width);
@@ -132,38 +237,22 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     String StringConverter::toString(const Vector2& val)
     {
-        StringStream stream;
-        stream << val.x << " " << val.y;
-        return stream.str();
+        return formatReals(val.ptr(), 2);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(const Vector3& val)
     {
-        StringStream stream;
-        stream << val.x << " " << val.y << " " << val.z;
-        return stream.str();
+        return formatReals(val.ptr(), 3);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(const Vector4& val)
     {
-        StringStream stream;
-        stream << val.x << " " << val.y << " " << val.z << " " << val.w;
-        return stream.str();
+        return formatReals(val.ptr(), 4);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(const Matrix3& val)
     {
-        StringStream stream;
-        stream << val[0][0] << " "
-            << val[0][1] << " "             
-            << val[0][2] << " "             
-            << val[1][0] << " "             
-            << val[1][1] << " "             
-            << val[1][2] << " "             
-            << val[2][0] << " "             
-            << val[2][1] << " "             
-            << val[2][2];
-        return stream.str();
+        return formatReals(val[0], 9);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(bool val, bool yesNo)
@@ -192,38 +281,18 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     String StringConverter::toString(const Matrix4& val)
     {
-        StringStream stream;
-        stream << val[0][0] << " "
-            << val[0][1] << " "             
-            << val[0][2] << " "             
-            << val[0][3] << " "             
-            << val[1][0] << " "             
-            << val[1][1] << " "             
-            << val[1][2] << " "             
-            << val[1][3] << " "             
-            << val[2][0] << " "             
-            << val[2][1] << " "             
-            << val[2][2] << " "             
-            << val[2][3] << " "             
-            << val[3][0] << " "             
-            << val[3][1] << " "             
-            << val[3][2] << " "             
-            << val[3][3];
-        return stream.str();
+        return formatReals(val[0], 16);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(const Quaternion& val)
     {
-        StringStream stream;
-        stream  << val.w << " " << val.x << " " << val.y << " " << val.z;
-        return stream.str();
+        const Real vals[] = { val.w, val.x, val.y, val.z };
+        return formatReals(vals, 4);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(const ColourValue& val)
     {
-        StringStream stream;
-        stream << val.r << " " << val.g << " " << val.b << " " << val.a;
-        return stream.str();
+        return formatReals(val.ptr(), 4);
     }
     //-----------------------------------------------------------------------
     String StringConverter::toString(const StringVector& val)
@@ -246,10 +315,113 @@ namespace Ogre {
     Real StringConverter::parseReal(const String& val, Real defaultValue)
     {
         char* end;
-        Real ret = (Real)strtod_l(val.c_str(), &end, _numLocale);
+        Real ret = (Real)_strtod(val.c_str(), &end);
         return val.c_str() == end ? defaultValue : ret;
     }
     //-----------------------------------------------------------------------
+    bool StringConverter::parseNumber(const String& val, float& ret)
+    {
+        double value;
+        if (!parseNumber(val, value))
+            return false;
+        ret = (float)value;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    bool StringConverter::parseNumber(const String& val, double& ret)
+    {
+        char* end;
+        double value = _strtod(val.c_str(), &end);
+        if (end == val.c_str() || end != val.c_str() + val.size())
+            return false;
+        ret = value;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    double StringConverter::_strtod(const char* str, char** end)
+    {
+        static const double powersOf10[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+        const char* p = str;
+        while (*p == ' ' || (*p >= '\t' && *p <= '\r'))
+            ++p;
+
+        bool negative = *p == '-';
+        if (*p == '-' || *p == '+')
+            ++p;
+
+        // hex floats go through the C runtime
+        if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+            return strtod_l(str, end, _numLocale);
+
+        // up to 19 significant digits fit the mantissa
+        uint64 mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool anyDigits = false;
+        for (; *p >= '0' && *p <= '9'; ++p)
+        {
+            anyDigits = true;
+            if (mantissa == 0 && *p == '0')
+                continue;
+            if (digits == 19)
+                return strtod_l(str, end, _numLocale);
+            mantissa = mantissa * 10 + (*p - '0');
+            ++digits;
+        }
+        if (*p == '.')
+        {
+            for (++p; *p >= '0' && *p <= '9'; ++p)
+            {
+                anyDigits = true;
+                --exponent;
+                if (mantissa == 0 && *p == '0')
+                    continue;
+                if (digits == 19)
+                    return strtod_l(str, end, _numLocale);
+                mantissa = mantissa * 10 + (*p - '0');
+                ++digits;
+            }
+        }
+
+        // inf, nan or no number at all
+        if (!anyDigits)
+            return strtod_l(str, end, _numLocale);
+
+        if (*p == 'e' || *p == 'E')
+        {
+            const char* e = p + 1;
+            bool negativeExponent = *e == '-';
+            if (*e == '-' || *e == '+')
+                ++e;
+            if (*e >= '0' && *e <= '9')
+            {
+                int value = 0;
+                for (; *e >= '0' && *e <= '9'; ++e)
+                {
+                    if (value < 10000)
+                        value = value * 10 + (*e - '0');
+                }
+                exponent += negativeExponent ? -value : value;
+                p = e;
+            }
+        }
+
+        // when both the mantissa and the power of ten are exact doubles, a single
+        // multiplication or division rounds correctly, as strtod would
+        if (mantissa > (uint64(1) << 53) || exponent < -22 || exponent > 22)
+            return strtod_l(str, end, _numLocale);
+
+        double ret = (double)mantissa;
+        ret = exponent < 0 ? ret / powersOf10[-exponent] : ret * powersOf10[exponent];
+
+        if (end)
+            *end = const_cast<char*>(p);
+        return negative ? -ret : ret;
+    }
+    //-----------------------------------------------------------------------
     int StringConverter::parseInt(const String& val, int defaultValue)
     {
         char* end;
@@ -307,151 +479,51 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     Vector2 StringConverter::parseVector2(const String& val, const Vector2& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 2)
-        {
-            return defaultValue;
-        }
-        else
-        {
-            return Vector2(parseReal(vec[0], defaultValue[0]), parseReal(vec[1], defaultValue[1]));
-        }
+        Vector2 ret;
+        return parseReals(val, ret.ptr(), defaultValue.ptr(), 2) == 2 ? ret : defaultValue;
     }
     //-----------------------------------------------------------------------
     Vector3 StringConverter::parseVector3(const String& val, const Vector3& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 3)
-        {
-            return defaultValue;
-        }
-        else
-        {
-            return Vector3(parseReal(vec[0], defaultValue[0]),
-                           parseReal(vec[1], defaultValue[1]),
-                           parseReal(vec[2], defaultValue[2]));
-        }
+        Vector3 ret;
+        return parseReals(val, ret.ptr(), defaultValue.ptr(), 3) == 3 ? ret : defaultValue;
     }
     //-----------------------------------------------------------------------
     Vector4 StringConverter::parseVector4(const String& val, const Vector4& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 4)
-        {
-            return defaultValue;
-        }
-        else
-        {
-            return Vector4(parseReal(vec[0], defaultValue[0]),
-                           parseReal(vec[1], defaultValue[1]),
-                           parseReal(vec[2], defaultValue[2]),
-                           parseReal(vec[3], defaultValue[3]));
-        }
+        Vector4 ret;
+        return parseReals(val, ret.ptr(), defaultValue.ptr(), 4) == 4 ? ret : defaultValue;
     }
     //-----------------------------------------------------------------------
     Matrix3 StringConverter::parseMatrix3(const String& val, const Matrix3& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 9)
-        {
-            return defaultValue;
-        }
-        else
-        {
-            return Matrix3(parseReal(vec[0], defaultValue[0][0]),
-                           parseReal(vec[1], defaultValue[0][1]),
-                           parseReal(vec[2], defaultValue[0][2]),
-
-                           parseReal(vec[3], defaultValue[1][0]),
-                           parseReal(vec[4], defaultValue[1][1]),
-                           parseReal(vec[5], defaultValue[1][2]),
-
-                           parseReal(vec[6], defaultValue[2][0]),
-                           parseReal(vec[7], defaultValue[2][1]),
-                           parseReal(vec[8], defaultValue[2][2]));
-        }
+        Matrix3 ret;
+        return parseReals(val, ret[0], defaultValue[0], 9) == 9 ? ret : defaultValue;
     }
     //-----------------------------------------------------------------------
     Matrix4 StringConverter::parseMatrix4(const String& val, const Matrix4& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 16)
-        {
-            return defaultValue;
-        }
-        else
-        {
-            return Matrix4(parseReal(vec[0], defaultValue[0][0]),
-                           parseReal(vec[1], defaultValue[0][1]),
-                           parseReal(vec[2], defaultValue[0][2]),
-                           parseReal(vec[3], defaultValue[0][3]),
-                           
-                           parseReal(vec[4], defaultValue[1][0]),
-                           parseReal(vec[5], defaultValue[1][1]),
-                           parseReal(vec[6], defaultValue[1][2]),
-                           parseReal(vec[7], defaultValue[1][3]),
-                           
-                           parseReal(vec[8], defaultValue[2][0]),
-                           parseReal(vec[9], defaultValue[2][1]),
-                           parseReal(vec[10], defaultValue[2][2]),
-                           parseReal(vec[11], defaultValue[2][3]),
-                           
-                           parseReal(vec[12], defaultValue[3][0]),
-                           parseReal(vec[13], defaultValue[3][1]),
-                           parseReal(vec[14], defaultValue[3][2]),
-                           parseReal(vec[15], defaultValue[3][3]));
-        }
+        Matrix4 ret;
+        return parseReals(val, ret[0], defaultValue[0], 16) == 16 ? ret : defaultValue;
     }
     //-----------------------------------------------------------------------
     Quaternion StringConverter::parseQuaternion(const String& val, const Quaternion& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() != 4)
-        {
-            return defaultValue;
-        }
-        else
-        {
-            return Quaternion(parseReal(vec[0], defaultValue[0]),
-                              parseReal(vec[1], defaultValue[1]),
-                              parseReal(vec[2], defaultValue[2]),
-                              parseReal(vec[3], defaultValue[3]));
-        }
+        Quaternion ret;
+        return parseReals(val, ret.ptr(), defaultValue.ptr(), 4) == 4 ? ret : defaultValue;
     }
     //-----------------------------------------------------------------------
     ColourValue StringConverter::parseColourValue(const String& val, const ColourValue& defaultValue)
     {
-        // Split on space
-        vector<String>::type vec = StringUtil::split(val);
-
-        if (vec.size() == 4)
-        {
-            return ColourValue(parseReal(vec[0], defaultValue[0]),
-                               parseReal(vec[1], defaultValue[1]),
-                               parseReal(vec[2], defaultValue[2]),
-                               parseReal(vec[3], defaultValue[3]));
-        }
-        else if (vec.size() == 3)
-        {
-            return ColourValue(parseReal(vec[0], defaultValue[0]),
-                               parseReal(vec[1], defaultValue[1]),
-                               parseReal(vec[2], defaultValue[2]),
-                               1.0f);
-        }
-        else
+        ColourValue ret;
+        switch (parseReals(val, ret.ptr(), defaultValue.ptr(), 4))
         {
+        case 4:
+            return ret;
+        case 3:
+            ret.a = 1.0f;
+            return ret;
+        default:
             return defaultValue;
         }
     }
@@ -465,7 +537,7 @@ namespace Ogre {
     bool StringConverter::isNumber(const String& val)
     {
         char* end;
-        strtod(val.c_str(), &end);
+        _strtod(val.c_str(), &end);
         return end == (val.c_str() + val.size());
     }
 	//-----------------------------------------------------------------------
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreMesh.h"
 #include "OgreException.h"
+#include "OgreGpuSkinningBatch.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -46,9 +47,11 @@ namespace Ogre {
         mRenderQueueIDSet = false;
         mRenderQueuePrioritySet = false;
         mSkelAnimVertexData = 0;
+        mGpuSkinnedVertexData = 0;
         mVertexAnimationAppliedThisFrame = false;
         mSoftwareVertexAnimVertexData = 0;
         mHardwareVertexAnimVertexData = 0;
+        mLodMorphVertexData = 0;
         mHardwarePoseCount = 0;
         mIndexStart = 0;
         mIndexEnd = 0;
@@ -58,8 +61,10 @@ namespace Ogre {
     SubEntity::~SubEntity()
     {
         OGRE_DELETE mSkelAnimVertexData;
+        OGRE_DELETE mGpuSkinnedVertexData;
         OGRE_DELETE mHardwareVertexAnimVertexData;
         OGRE_DELETE mSoftwareVertexAnimVertexData;
+        OGRE_DELETE mLodMorphVertexData;
     }
     //-----------------------------------------------------------------------
     SubMesh* SubEntity::getSubMesh(void)
@@ -126,6 +131,12 @@ namespace Ogre {
         mSubMesh->_getRenderOperation(op, mParentEntity->mMeshLodIndex);
         // Deal with any vertex data overrides
         op.vertexData = getVertexDataForBinding();
+        // Bind the morph target when drawing the original geometry
+        if (!mSubMesh->mLodMorphTargets.empty() && op.vertexData ==
+            (mSubMesh->useSharedVertices ? mSubMesh->parent->sharedVertexData : mSubMesh->vertexData))
+        {
+            op.vertexData = getLodMorphVertexData(op.vertexData, mParentEntity->mMeshLodIndex);
+        }
 
         // If we use custom index position the client is responsible to set meaningful values 
         if(mIndexStart != mIndexEnd)
@@ -135,6 +146,32 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    VertexData* SubEntity::getLodMorphVertexData(VertexData* original, ushort lodIndex)
+    {
+        // The coarsest level binds its own targets, the factor doesn't matter there
+        const SubMesh::LODMorphTargetList& targets = mSubMesh->mLodMorphTargets;
+        const HardwareVertexBufferSharedPtr& target = targets[std::min<size_t>(lodIndex, targets.size() - 1)];
+        if (!target || original->vertexDeclaration->findElementBySemantic(
+            VES_TEXTURE_COORDINATES, SubMesh::LOD_MORPH_TEXCOORD))
+        {
+            return original;
+        }
+
+        if (!mLodMorphVertexData)
+        {
+            // Shares the original buffers, with the target added on a new source
+            mLodMorphVertexData = original->clone(false);
+            unsigned short source = mLodMorphVertexData->vertexBufferBinding->getNextIndex();
+            mLodMorphVertexData->vertexDeclaration->addElement(source, 0, VET_FLOAT3,
+                VES_TEXTURE_COORDINATES, SubMesh::LOD_MORPH_TEXCOORD);
+        }
+
+        unsigned short source = mLodMorphVertexData->vertexDeclaration->findElementBySemantic(
+            VES_TEXTURE_COORDINATES, SubMesh::LOD_MORPH_TEXCOORD)->getSource();
+        mLodMorphVertexData->vertexBufferBinding->setBinding(source, target);
+        return mLodMorphVertexData;
+    }
+    //-----------------------------------------------------------------------
     void SubEntity::setIndexDataStartIndex(size_t start_index)
     {
         if(start_index < mSubMesh->indexData->indexCount)
@@ -183,6 +220,8 @@ namespace Ogre {
             case Entity::BIND_SOFTWARE_MORPH:
                 return mSoftwareVertexAnimVertexData;
             case Entity::BIND_SOFTWARE_SKELETAL:
+                if (mParentEntity->mGpuSkinned && mGpuSkinnedVertexData && mGpuSkinnedVertexData->isSkinned())
+                    return mGpuSkinnedVertexData->getVertexData();
                 return mSkelAnimVertexData;
             };
             // keep compiler happy
@@ -304,6 +343,11 @@ namespace Ogre {
             OGRE_DELETE mSkelAnimVertexData;
             mSkelAnimVertexData = 0;
         }
+        if (mGpuSkinnedVertexData)
+        {
+            OGRE_DELETE mGpuSkinnedVertexData;
+            mGpuSkinnedVertexData = 0;
+        }
         if (mSoftwareVertexAnimVertexData) 
         {
             OGRE_DELETE mSoftwareVertexAnimVertexData;
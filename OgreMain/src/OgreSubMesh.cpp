@@ -48,6 +48,9 @@ namespace Ogre {
         indexData = OGRE_NEW IndexData();
     }
     //-----------------------------------------------------------------------
+    const unsigned short SubMesh::LOD_MORPH_TEXCOORD = 7;
+    const size_t SubMesh::LOD_MORPH_CUSTOM_PARAMETER = 255;
+    //-----------------------------------------------------------------------
     SubMesh::~SubMesh()
     {
         removeLodLevels();
@@ -219,6 +222,7 @@ namespace Ogre {
         }
 
         mLodFaceList.clear();
+        mLodMorphTargets.clear();
 
     }
     //---------------------------------------------------------------------
@@ -498,6 +502,8 @@ namespace Ogre {
             IndexData* newIndexData = (*facei)->clone(true, bufferManager);
             newSub->mLodFaceList.push_back(newIndexData);
         }
+        // Morph targets are never modified, so they can be shared
+        newSub->mLodMorphTargets = this->mLodMorphTargets;
         return newSub;
     }
 }
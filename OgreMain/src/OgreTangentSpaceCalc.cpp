@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "OgreHardwareBufferManager.h"
 #include "OgreLogManager.h"
 #include "OgreException.h"
+#include "Threading/OgreParallel.h"
 
 namespace Ogre
 {
@@ -210,13 +211,15 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
-    void TangentSpaceCalc::normaliseVertices()
+    struct TangentSpaceCalc::VertexNormaliser
     {
-        // Just run through our complete (possibly augmented) list of vertices
-        // Normalise the tangents & binormals
-        for (VertexInfoArray::iterator i = mVertexArray.begin(); i != mVertexArray.end(); ++i)
+        VertexInfo* vertices;
+
+        VertexNormaliser(VertexInfo* v) : vertices(v) {}
+
+        void operator()(size_t i) const
         {
-            VertexInfo& v = *i;
+            VertexInfo& v = vertices[i];
 
             v.tangent.normalise();
             v.binormal.normalise();
@@ -233,10 +236,42 @@ namespace Ogre
             // renormalize 
             v.tangent.normalise();
             v.binormal.normalise();
-
         }
+    };
+    //---------------------------------------------------------------------
+    void TangentSpaceCalc::normaliseVertices()
+    {
+        // Just run through our complete (possibly augmented) list of vertices
+        // Normalise the tangents & binormals, each on its own so in parallel
+        if (!mVertexArray.empty())
+            parallelFor(0, mVertexArray.size(), VertexNormaliser(&mVertexArray[0]), 4096);
     }
     //---------------------------------------------------------------------
+    struct TangentSpaceCalc::FaceTangentSpaceCalculator
+    {
+        TangentSpaceCalc* calc;
+        FaceInfo* faces;
+
+        FaceTangentSpaceCalculator(TangentSpaceCalc* c, FaceInfo* f) : calc(c), faces(f) {}
+
+        void operator()(size_t i) const
+        {
+            FaceInfo& face = faces[i];
+            calc->calculateFaceTangentSpace(face.vertInd, face.tsU, face.tsV, face.tsN);
+            // Calculate parity for this triangle
+            face.parity = calc->calculateParity(face.tsU, face.tsV, face.tsN);
+            for (int v = 0; v < 3; ++v)
+            {
+                // index 0 is vertex we're calculating, 1 and 2 are the others
+
+                // We want to re-weight these by the angle the face makes with the vertex
+                // in order to obtain tessellation-independent results
+                face.angleWeight[v] = calc->calculateAngleWeight(face.vertInd[v],
+                    face.vertInd[(v+1)%3], face.vertInd[(v+2)%3]);
+            }
+        }
+    };
+    //---------------------------------------------------------------------
     void TangentSpaceCalc::processFaces(Result& result)
     {
         // Quick pre-check for triangle strips / fans
@@ -250,6 +285,7 @@ namespace Ogre
             }
         }
 
+        FaceInfoArray faces;
         for (size_t i = 0; i < mIDataList.size(); ++i)
         {
             IndexData* i_in = mIDataList[i];
@@ -327,43 +363,51 @@ namespace Ogre
                 }
 
 
-                // For each triangle
-                //   Calculate tangent & binormal per triangle
-                //   Note these are not normalised, are weighted by UV area
-                Vector3 faceTsU, faceTsV, faceNorm;
-                calculateFaceTangentSpace(localVertInd, faceTsU, faceTsV, faceNorm);
+                FaceInfo face;
+                face.indexSet = i;
+                face.faceIndex = f;
+                face.vertInd[0] = localVertInd[0];
+                face.vertInd[1] = localVertInd[1];
+                face.vertInd[2] = localVertInd[2];
+                faces.push_back(face);
+            }
 
-                // Skip invalid UV space triangles
-                if (faceTsU.isZeroLength() || faceTsV.isZeroLength())
-                    continue;
 
-                addFaceTangentSpaceToVertices(i, f, localVertInd, faceTsU, faceTsV, faceNorm, result);
+            ibuf->unlock();
+        }
 
-            }
+        // For each triangle
+        //   Calculate tangent & binormal per triangle
+        //   Note these are not normalised, are weighted by UV area
+        // This only reads the vertices, so is done for all triangles in parallel
+        if (!faces.empty())
+            parallelFor(0, faces.size(), FaceTangentSpaceCalculator(this, &faces[0]), 1024);
 
+        // Adding them to the vertices may split vertices, so is done in order
+        for (FaceInfoArray::iterator f = faces.begin(); f != faces.end(); ++f)
+        {
+            // Skip invalid UV space triangles
+            if (f->tsU.isZeroLength() || f->tsV.isZeroLength())
+                continue;
 
-            ibuf->unlock();
+            addFaceTangentSpaceToVertices(*f, result);
         }
 
     }
     //---------------------------------------------------------------------
-    void TangentSpaceCalc::addFaceTangentSpaceToVertices(
-        size_t indexSet, size_t faceIndex, size_t *localVertInd, 
-        const Vector3& faceTsU, const Vector3& faceTsV, const Vector3& faceNorm, 
-        Result& result)
+    void TangentSpaceCalc::addFaceTangentSpaceToVertices(const FaceInfo& face, Result& result)
     {
-        // Calculate parity for this triangle
-        int faceParity = calculateParity(faceTsU, faceTsV, faceNorm);
+        size_t indexSet = face.indexSet;
+        size_t faceIndex = face.faceIndex;
+        const size_t* localVertInd = face.vertInd;
+        const Vector3& faceTsU = face.tsU;
+        const Vector3& faceTsV = face.tsV;
+        const Vector3& faceNorm = face.tsN;
+        int faceParity = face.parity;
         // Now add these to each vertex referenced by the face
         for (int v = 0; v < 3; ++v)
         {
-            // index 0 is vertex we're calculating, 1 and 2 are the others
-
-            // We want to re-weight these by the angle the face makes with the vertex
-            // in order to obtain tessellation-independent results
-            Real angleWeight = calculateAngleWeight(localVertInd[v], 
-                localVertInd[(v+1)%3], localVertInd[(v+2)%3]);
-
+            Real angleWeight = face.angleWeight[v];
 
             VertexInfo* vertex = &(mVertexArray[localVertInd[v]]);
 
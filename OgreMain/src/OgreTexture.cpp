@@ -32,6 +32,8 @@ THE SOFTWARE.
 #include "OgreTexture.h"
 #include "OgreException.h"
 #include "OgreTextureManager.h"
+#include "OgreMemoryStats.h"
+#include "OgreResourceGroupManager.h"
 
 namespace Ogre {
     const char* Texture::CUBEMAP_SUFFIXES[] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
@@ -61,7 +63,14 @@ namespace Ogre {
             mDesiredIntegerBitDepth(0),
             mDesiredFloatBitDepth(0),
             mTreatLuminanceAsAlpha(false),
-            mInternalResourcesCreated(false)
+            mInternalResourcesCreated(false),
+            mInternalResourcesSize(0),
+            mMipmapSkip(0),
+            mMaxMipmapSkip(0),
+            mDesiredMipmapSkip(0),
+            mMipmapStreamed(false),
+            mLastUsedFrame(0),
+            mScreenSize(-1)
     {
         if (createParamDictionary("Texture"))
         {
@@ -179,6 +188,83 @@ namespace Ogre {
         return getNumFaces() * PixelUtil::getMemorySize(mWidth, mHeight, mDepth, mFormat);
     }
     //--------------------------------------------------------------------------
+    void Texture::setMipmapStreamed(bool streamed)
+    {
+        mMipmapStreamed = streamed;
+        // Start from the smallest mipmaps
+        if (streamed && !isLoaded())
+            mMipmapSkip = 0xFF;
+    }
+    //--------------------------------------------------------------------------
+    void Texture::_updateDesiredMipmapSkip(void)
+    {
+        // Owners which set the desired skip themselves
+        if (mScreenSize < 0)
+            return;
+
+        // Textures not rendered since the last update need no more than their smallest mipmaps
+        uint32 size = std::max(mSrcWidth, mSrcHeight);
+        uint8 skip = 0;
+        while (skip < mMaxMipmapSkip && Real(size >> (skip + 1)) >= mScreenSize)
+            ++skip;
+        mDesiredMipmapSkip = skip;
+        mScreenSize = 0;
+    }
+    //--------------------------------------------------------------------------
+    bool Texture::readCompressionCache(const String& cacheName, const Image& source,
+        PixelFormat format, Image& cached) const
+    {
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        if (mName.empty() || !rgm.resourceExists(mGroup, mName) || !rgm.resourceExists(mGroup, cacheName) ||
+            rgm.resourceModifiedTime(mGroup, cacheName) < rgm.resourceModifiedTime(mGroup, mName))
+            return false;
+
+        try
+        {
+            cached.load(cacheName, mGroup);
+        }
+        catch (Exception& e)
+        {
+            LogManager::getSingleton().logMessage("Texture: " + mName +
+                ": Ignoring compression cache: " + e.getDescription(), LML_TRIVIAL);
+            return false;
+        }
+
+        // Mipmaps are generated before compressing, the same way _loadImages does
+        uint32 numMipmaps = source.getNumMipmaps();
+        if (numMipmaps == 0 && mNumRequestedMipmaps > 0)
+        {
+            uint32 size = std::max(source.getWidth(), source.getHeight());
+            while (numMipmaps < mNumRequestedMipmaps && (size >> (numMipmaps + 1)) > 0)
+                ++numMipmaps;
+        }
+
+        return cached.getFormat() == format && cached.getWidth() == source.getWidth() &&
+            cached.getHeight() == source.getHeight() && cached.getDepth() == 1 &&
+            cached.getNumFaces() == source.getNumFaces() && cached.getNumMipmaps() == numMipmaps;
+    }
+    //--------------------------------------------------------------------------
+    void Texture::writeCompressionCache(const String& cacheName, Image& compressed) const
+    {
+        if (mName.empty() || !ResourceGroupManager::getSingleton().resourceExists(mGroup, mName))
+            return;
+
+        try
+        {
+            DataStreamPtr encoded = compressed.encode("dds");
+            DataStreamPtr stream =
+                ResourceGroupManager::getSingleton().createResource(cacheName, mGroup, true);
+            stream->write(static_cast<MemoryDataStream*>(encoded.get())->getPtr(), encoded->size());
+            stream->close();
+        }
+        catch (Exception& e)
+        {
+            // Read only archives can't hold a cache
+            LogManager::getSingleton().logMessage("Texture: " + mName +
+                ": Can't write compression cache: " + e.getDescription(), LML_TRIVIAL);
+        }
+    }
+    //--------------------------------------------------------------------------
     size_t Texture::getNumFaces(void) const
     {
         return getTextureType() == TEX_TYPE_CUBE_MAP ? 6 : 1;
@@ -189,11 +275,79 @@ namespace Ogre {
         if(images.size() < 1)
             OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Cannot load empty vector of images",
              "Texture::loadImages");
+
+        // Block compress uncompressed images if requested
+        const Image& first = *images[0];
+        if (TextureManager::getSingleton().getRuntimeCompression() &&
+            (mTextureType == TEX_TYPE_2D || mTextureType == TEX_TYPE_CUBE_MAP) &&
+            !(mUsage & (TU_RENDERTARGET | TU_DYNAMIC)) && mDesiredFormat == PF_UNKNOWN &&
+            mGamma == 1.0f && !mTreatLuminanceAsAlpha && !PixelUtil::isCompressed(first.getFormat()) &&
+            first.getDepth() == 1 && first.getWidth() % 4 == 0 && first.getHeight() % 4 == 0)
+        {
+            PixelFormat format = TextureManager::getSingleton().getRuntimeCompressionFormat(
+                PixelUtil::hasAlpha(first.getFormat()));
+            if (format != PF_UNKNOWN)
+            {
+                // Only DXT can be written back, as DDS
+                String cacheName;
+                if (TextureManager::getSingleton().getRuntimeCompressionCache() &&
+                    images.size() == 1 && (format == PF_DXT1 || format == PF_DXT5))
+                {
+                    cacheName = mName + (format == PF_DXT1 ? ".dxt1.dds" : ".dxt5.dds");
+                    Image cached;
+                    if (readCompressionCache(cacheName, first, format, cached))
+                    {
+                        ConstImagePtrList cachedPtrs(1, &cached);
+                        _loadImages(cachedPtrs);
+                        return;
+                    }
+                }
+
+                vector<Image>::type compressed(images.size());
+                ConstImagePtrList compressedPtrs;
+                for (size_t i = 0; i < images.size(); ++i)
+                {
+                    compressed[i] = *images[i];
+                    // compressed textures can not generate their own mipmaps
+                    if (mNumRequestedMipmaps > 0 && compressed[i].getNumMipmaps() == 0)
+                        compressed[i].generateMipmaps(mNumRequestedMipmaps);
+                    compressed[i].compress(format);
+                    compressedPtrs.push_back(&compressed[i]);
+                }
+                if (!cacheName.empty())
+                    writeCompressionCache(cacheName, compressed[0]);
+                _loadImages(compressedPtrs);
+                return;
+            }
+        }
         
+        // The custom mipmaps in the image have priority over everything
+        uint32 imageMips = images[0]->getNumMipmaps();
+
+        // Leave out the largest custom mipmaps if requested
+        uint32 maxSkip = std::min<uint32>(imageMips, 0xFF);
+        if (mMipmapStreamed)
+        {
+            // Streamed textures are not loaded smaller than the initial size
+            size_t initialSize = TextureManager::getSingleton().getMipmapStreamingInitialSize();
+            size_t size = std::max(images[0]->getWidth(), images[0]->getHeight());
+            maxSkip = 0;
+            while (maxSkip < imageMips && (size >> (maxSkip + 1)) >= initialSize)
+                ++maxSkip;
+        }
+        uint32 skip = std::min<uint32>(mMipmapSkip, maxSkip);
+        mMipmapSkip = static_cast<uint8>(skip);
+        mMaxMipmapSkip = static_cast<uint8>(maxSkip);
+        imageMips -= skip;
+
         // Set desired texture size and properties from images[0]
-        mSrcWidth = mWidth = images[0]->getWidth();
-        mSrcHeight = mHeight = images[0]->getHeight();
-        mSrcDepth = mDepth = images[0]->getDepth();
+        PixelBox top = images[0]->getPixelBox(0, skip);
+        mSrcWidth = images[0]->getWidth();
+        mSrcHeight = images[0]->getHeight();
+        mSrcDepth = images[0]->getDepth();
+        mWidth = static_cast<uint32>(top.getWidth());
+        mHeight = static_cast<uint32>(top.getHeight());
+        mDepth = static_cast<uint32>(top.getDepth());
 
         // Get source image format and adjust if required
         mSrcFormat = images[0]->getFormat();
@@ -213,12 +367,9 @@ namespace Ogre {
             mFormat = PixelUtil::getFormatForBitDepths(mSrcFormat, mDesiredIntegerBitDepth, mDesiredFloatBitDepth);
         }
 
-        // The custom mipmaps in the image have priority over everything
-        uint32 imageMips = images[0]->getNumMipmaps();
-
-        if(imageMips > 0)
+        if(images[0]->getNumMipmaps() > 0)
         {
-            mNumMipmaps = mNumRequestedMipmaps = images[0]->getNumMipmaps();
+            mNumMipmaps = mNumRequestedMipmaps = imageMips;
             // Disable flag for auto mip generation
             mUsage &= ~TU_AUTOMIPMAP;
         }
@@ -293,12 +444,12 @@ namespace Ogre {
                 if(multiImage)
                 {
                     // Load from multiple images
-                    src = images[i]->getPixelBox(0, mip);
+                    src = images[i]->getPixelBox(0, mip + skip);
                 }
                 else
                 {
                     // Load from faces of images[0]
-                    src = images[0]->getPixelBox(i, mip);
+                    src = images[0]->getPixelBox(i, mip + skip);
                 }
     
                 // Sets to treated format in case is difference
@@ -340,6 +491,9 @@ namespace Ogre {
         {
             createInternalResourcesImpl();
             mInternalResourcesCreated = true;
+
+            mInternalResourcesSize = Image::calculateSize(mNumMipmaps, getNumFaces(), mWidth, mHeight, mDepth, mFormat);
+            MemoryStats::_recordAlloc(MemoryStats::POOL_TEXTURES, mInternalResourcesSize, false);
         }
     }
     //-----------------------------------------------------------------------------
@@ -349,6 +503,8 @@ namespace Ogre {
         {
             freeInternalResourcesImpl();
             mInternalResourcesCreated = false;
+
+            MemoryStats::_recordDealloc(MemoryStats::POOL_TEXTURES, mInternalResourcesSize, false);
         }
     }
     //-----------------------------------------------------------------------------
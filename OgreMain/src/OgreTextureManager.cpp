@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "OgrePixelFormat.h"
 #include "OgreRoot.h"
 #include "OgreRenderSystem.h"
+#include "OgreLogManager.h"
+#include "OgreParallel.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -47,6 +49,13 @@ namespace Ogre {
          : mPreferredIntegerBitDepth(0)
          , mPreferredFloatBitDepth(0)
          , mDefaultNumMipmaps(MIP_UNLIMITED)
+         , mMipmapStreamingBudget(0)
+         , mMipmapStreamingInitialSize(64)
+         , mMipmapStreamingReloadsPerFrame(2)
+         , mMipmapStreamingIdleFrames(30)
+         , mNumMipmapStreamedTextures(0)
+         , mRuntimeCompression(false)
+         , mRuntimeCompressionCache(false)
     {
         mResourceType = "Texture";
         mLoadOrder = 75.0f;
@@ -58,6 +67,10 @@ namespace Ogre {
     {
         // subclasses should unregister with resource group manager
 
+        // The workers may still be reading images
+        for (MipmapStreamList::iterator i = mMipmapStreams.begin(); i != mMipmapStreams.end(); ++i)
+            i->job->complete();
+
     }
     //-----------------------------------------------------------------------
     TexturePtr TextureManager::getByName(const String& name, const String& groupName)
@@ -277,6 +290,202 @@ namespace Ogre {
         mDefaultNumMipmaps = num;
     }
     //-----------------------------------------------------------------------
+    namespace
+    {
+        /// Orders textures by how many mipmaps more than desired they have
+        struct MipmapSurplusLess
+        {
+            /// Textures last used before this frame desire no more than the initial size
+            unsigned long idleBefore;
+
+            MipmapSurplusLess(unsigned long idle) : idleBefore(idle) {}
+
+            int surplus(const Texture* t) const
+            {
+                int desired = t->getLastUsedFrame() < idleBefore ? 0xFF : t->getDesiredMipmapSkip();
+                return desired - int(t->getMipmapSkip());
+            }
+            bool operator()(const Texture* a, const Texture* b) const
+            {
+                return surplus(a) < surplus(b);
+            }
+        };
+
+        /// Reads the image of a texture getting more mipmaps
+        class MipmapStreamJob : public ParallelJob
+        {
+        public:
+            MipmapStreamJob(const String& name, const String& group)
+                : ParallelJob(1), mName(name), mGroup(group) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                try
+                {
+                    mImage.load(mName, mGroup);
+                }
+                catch (Exception& e)
+                {
+                    mError = e.getFullDescription();
+                }
+            }
+
+            String mName;
+            String mGroup;
+            Image mImage;
+            String mError;
+        };
+    }
+    //-----------------------------------------------------------------------
+    PixelFormat TextureManager::getRuntimeCompressionFormat(bool hasAlpha) const
+    {
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        if (!rs || !rs->getCapabilities())
+            return PF_UNKNOWN;
+
+        const RenderSystemCapabilities* caps = rs->getCapabilities();
+        if (caps->hasCapability(RSC_TEXTURE_COMPRESSION_DXT))
+            return hasAlpha ? PF_DXT5 : PF_DXT1;
+        if (hasAlpha)
+            return PF_UNKNOWN;
+        if (caps->hasCapability(RSC_TEXTURE_COMPRESSION_ETC2))
+            return PF_ETC2_RGB8;
+        if (caps->hasCapability(RSC_TEXTURE_COMPRESSION_ETC1))
+            return PF_ETC1_RGB8;
+        return PF_UNKNOWN;
+    }
+    //-----------------------------------------------------------------------
+    void TextureManager::_updateMipmapStreaming(void)
+    {
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        size_t reloads = 0;
+
+        // Reload the textures whose images have been read
+        MipmapStreamList::iterator s = mMipmapStreams.begin();
+        while (s != mMipmapStreams.end())
+        {
+            // Read it here if no worker took the job in time, e.g. without threads
+            if (!s->job->isComplete() && s->frame != frame)
+                s->job->process();
+            if (!s->job->isComplete())
+            {
+                ++s;
+                continue;
+            }
+
+            MipmapStreamJob* job = static_cast<MipmapStreamJob*>(s->job.get());
+            Texture* texture = s->texture.get();
+            if (!job->mError.empty())
+            {
+                LogManager::getSingleton().logMessage("Streaming the mipmaps of texture '" +
+                    texture->getName() + "' failed: " + job->mError, LML_CRITICAL);
+            }
+            else if (texture->isLoaded() && texture->getMipmapSkip() != s->skip)
+            {
+                texture->unload();
+                texture->setMipmapSkip(s->skip);
+                texture->loadImage(job->mImage);
+                ++reloads;
+            }
+            s = mMipmapStreams.erase(s);
+        }
+
+        vector<Texture*>::type textures;
+        size_t totalSize = 0;
+        for (ResourceMap::iterator it = mResources.begin(); it != mResources.end(); ++it)
+        {
+            Texture* texture = static_cast<Texture*>(it->second.get());
+            if (texture->isMipmapStreamed() && texture->isLoaded() && texture->isReloadable())
+            {
+                texture->_updateDesiredMipmapSkip();
+                textures.push_back(texture);
+                totalSize += texture->getSize();
+            }
+        }
+        mNumMipmapStreamedTextures = textures.size();
+        if (textures.empty())
+            return;
+
+        // Each mipmap has about four times the size of the next smaller one, so
+        // leave room for those being streamed in and count those being dropped as gone
+        set<Texture*>::type streaming;
+        for (s = mMipmapStreams.begin(); s != mMipmapStreams.end(); ++s)
+        {
+            Texture* texture = s->texture.get();
+            streaming.insert(texture);
+            if (!texture->isLoaded())
+                continue;
+            size_t size = texture->getSize();
+            if (s->skip < texture->getMipmapSkip())
+                totalSize += size * 3;
+            else
+                totalSize -= std::min(totalSize, size - size / 4);
+        }
+
+        // The textures with the most surplus mipmaps come last
+        unsigned long idleBefore = mMipmapStreamingIdleFrames && frame > mMipmapStreamingIdleFrames ?
+            frame - mMipmapStreamingIdleFrames : 0;
+        MipmapSurplusLess less(idleBefore);
+        std::sort(textures.begin(), textures.end(), less);
+
+        // Drop the largest mipmap of those needing it least while over budget, but
+        // not from those already as small as they get, which would not change
+        for (vector<Texture*>::type::reverse_iterator i = textures.rbegin();
+            i != textures.rend() && mMipmapStreamingBudget && totalSize > mMipmapStreamingBudget &&
+            reloads + mMipmapStreams.size() < mMipmapStreamingReloadsPerFrame; ++i)
+        {
+            Texture* texture = *i;
+            uint8 skip = texture->getMipmapSkip();
+            if (skip >= texture->getMaxMipmapSkip() || streaming.count(texture))
+                continue;
+            size_t size = texture->getSize();
+            totalSize -= size - size / 4;
+            if (streamMipmaps(texture, skip + 1, frame))
+                ++reloads;
+            else
+                streaming.insert(texture);
+        }
+
+        // Stream in the next mipmap of those needing it most while there is room
+        for (vector<Texture*>::type::iterator i = textures.begin();
+            i != textures.end() && reloads + mMipmapStreams.size() < mMipmapStreamingReloadsPerFrame; ++i)
+        {
+            Texture* texture = *i;
+            uint8 skip = texture->getMipmapSkip();
+            if (skip == 0 || streaming.count(texture))
+                continue;
+            if (skip <= texture->getDesiredMipmapSkip() || texture->getLastUsedFrame() < idleBefore)
+                continue;
+            size_t size = texture->getSize();
+            if (mMipmapStreamingBudget && totalSize - size + size * 4 > mMipmapStreamingBudget)
+                break;
+            totalSize += size * 3;
+            if (streamMipmaps(texture, skip - 1, frame))
+                ++reloads;
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool TextureManager::streamMipmaps(Texture* texture, uint8 skip, unsigned long frame)
+    {
+        // Cube maps may be made of one image per face, those are reloaded right away
+        if (texture->getTextureType() == TEX_TYPE_CUBE_MAP)
+        {
+            texture->unload();
+            texture->setMipmapSkip(skip);
+            texture->load();
+            return true;
+        }
+
+        MipmapStream stream;
+        stream.texture = static_pointer_cast<Texture>(getByHandle(texture->getHandle()));
+        stream.skip = skip;
+        stream.frame = frame;
+        stream.job.reset(OGRE_NEW MipmapStreamJob(texture->getName(), texture->getGroup()));
+        ParallelJob::start(stream.job);
+        mMipmapStreams.push_back(stream);
+        return false;
+    }
+    //-----------------------------------------------------------------------
     bool TextureManager::isFormatSupported(TextureType ttype, PixelFormat format, int usage)
     {
         return getNativeFormat(ttype, format, usage) == format;
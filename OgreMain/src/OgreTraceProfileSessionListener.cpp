@@ -0,0 +1,111 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreTraceProfileSessionListener.h"
+#include "OgreLogManager.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    TraceProfileSessionListener::TraceProfileSessionListener(const String& fileName)
+        : mFileName(fileName)
+        , mFirstEvent(true)
+    {
+    }
+    //-----------------------------------------------------------------------
+    TraceProfileSessionListener::~TraceProfileSessionListener()
+    {
+        finializeSession();
+    }
+    //-----------------------------------------------------------------------
+    void TraceProfileSessionListener::initializeSession()
+    {
+        mFile.open(mFileName.c_str(), std::ios::out | std::ios::trunc);
+        if (!mFile)
+        {
+            LogManager::getSingleton().logMessage("TraceProfileSessionListener: can't write " + mFileName);
+            return;
+        }
+
+        mFile << "{\"traceEvents\":[";
+        mFirstEvent = true;
+        mThreadIDs.clear();
+    }
+    //-----------------------------------------------------------------------
+    void TraceProfileSessionListener::finializeSession()
+    {
+        if (!mFile.is_open())
+            return;
+
+        // name the thread tracks
+        for (ThreadIDMap::iterator it = mThreadIDs.begin(); it != mThreadIDs.end(); ++it)
+        {
+            mFile << (mFirstEvent ? "\n" : ",\n");
+            mFirstEvent = false;
+            mFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << it->second << ",\"args\":{\"name\":";
+            writeString(it->first);
+            mFile << "}}";
+        }
+
+        mFile << "\n]}\n";
+        mFile.close();
+    }
+    //-----------------------------------------------------------------------
+    void TraceProfileSessionListener::profileRecorded(const String& profileName, const String& threadName,
+                                                      ulong startTime, ulong endTime)
+    {
+        if (!mFile.is_open())
+            return;
+
+        ThreadIDMap::iterator it = mThreadIDs.find(threadName);
+        if (it == mThreadIDs.end())
+            it = mThreadIDs.insert(ThreadIDMap::value_type(threadName, (uint)mThreadIDs.size())).first;
+
+        // complete events, times in microseconds
+        mFile << (mFirstEvent ? "\n" : ",\n");
+        mFirstEvent = false;
+        mFile << "{\"name\":";
+        writeString(profileName);
+        mFile << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << it->second 
+              << ",\"ts\":" << startTime << ",\"dur\":" << (endTime - startTime) << "}";
+    }
+    //-----------------------------------------------------------------------
+    void TraceProfileSessionListener::writeString(const String& str)
+    {
+        mFile << '"';
+        for (String::const_iterator i = str.begin(); i != str.end(); ++i)
+        {
+            if (*i == '"' || *i == '\\')
+                mFile << '\\' << *i;
+            else if ((unsigned char)*i < 0x20)
+                mFile << ' ';
+            else
+                mFile << *i;
+        }
+        mFile << '"';
+    }
+}
@@ -39,6 +39,7 @@ namespace Ogre {
     VertexData::VertexData(HardwareBufferManagerBase* mgr)
     {
         mMgr = mgr ? mgr : HardwareBufferManager::getSingletonPtr();
+        mPoolMgr = 0;
         vertexBufferBinding = mMgr->createVertexBufferBinding();
         vertexDeclaration = mMgr->createVertexDeclaration();
         mDeleteDclBinding = true;
@@ -52,6 +53,7 @@ namespace Ogre {
     {
         // this is a fallback rather than actively used
         mMgr = HardwareBufferManager::getSingletonPtr();
+        mPoolMgr = 0;
         vertexDeclaration = dcl;
         vertexBufferBinding = bind;
         mDeleteDclBinding = false;
@@ -62,6 +64,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     VertexData::~VertexData()
     {
+        if (mPoolMgr)
+            mPoolMgr->_releasePooledVertexData(this);
         if (mDeleteDclBinding)
         {
             mMgr->destroyVertexBufferBinding(vertexBufferBinding);
@@ -86,13 +90,16 @@ namespace Ogre {
             HardwareVertexBufferSharedPtr dstBuf;
             if (copyData)
             {
-                // create new buffer with the same settings
+                // create new buffer with the same settings, pooled data only
+                // owns its range of the buffer
+                size_t numVertices = mPoolMgr ? vertexCount : srcbuf->getNumVertices();
+                size_t srcOffset = mPoolMgr ? vertexStart * srcbuf->getVertexSize() : 0;
                 dstBuf = pManager->createVertexBuffer(
-                        srcbuf->getVertexSize(), srcbuf->getNumVertices(), srcbuf->getUsage(),
+                        srcbuf->getVertexSize(), numVertices, srcbuf->getUsage(),
                         srcbuf->hasShadowBuffer());
 
                 // copy data
-                dstBuf->copyData(*srcbuf, 0, 0, srcbuf->getSizeInBytes(), true);
+                dstBuf->copyData(*srcbuf, srcOffset, 0, dstBuf->getSizeInBytes(), true);
             }
             else
             {
@@ -105,7 +112,7 @@ namespace Ogre {
         }
 
         // Basic vertex info
-        dest->vertexStart = this->vertexStart;
+        dest->vertexStart = (mPoolMgr && copyData) ? 0 : this->vertexStart;
         dest->vertexCount = this->vertexCount;
         // Copy elements
         const VertexDeclaration::VertexElementList elems = 
@@ -665,6 +672,134 @@ namespace Ogre {
         } // each buffer
 
 
+    }
+    //-----------------------------------------------------------------------
+    static VertexElementType getPackedElementType(const VertexElement& elem,
+        bool positions, bool normals, bool texCoords)
+    {
+        if (VertexElement::getBaseType(elem.getType()) != VET_FLOAT1)
+            return elem.getType();
+
+        switch (elem.getSemantic())
+        {
+        case VES_POSITION:
+            return positions ? VET_HALF4 : elem.getType();
+        case VES_NORMAL:
+        case VES_BINORMAL:
+        case VES_TANGENT:
+            return normals ? VET_SHORT4_NORM : elem.getType();
+        case VES_TEXTURE_COORDINATES:
+            if (!texCoords)
+                return elem.getType();
+            return elem.getType() <= VET_FLOAT2 ? VET_HALF2 : VET_HALF4;
+        default:
+            return elem.getType();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void VertexData::packElements(bool positions, bool normals, bool texCoords)
+    {
+        if (isPooled())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Pooled vertex data cannot be packed", "VertexData::packElements");
+        }
+
+        const VertexBufferBinding::VertexBufferBindingMap bindMap = 
+            vertexBufferBinding->getBindings();
+        VertexBufferBinding::VertexBufferBindingMap::const_iterator bindi;
+        for (bindi = bindMap.begin(); bindi != bindMap.end(); ++bindi)
+        {
+            const HardwareVertexBufferSharedPtr& srcBuf = bindi->second;
+            VertexDeclaration::VertexElementList elems = 
+                vertexDeclaration->findElementsBySource(bindi->first);
+
+            // Lay the elements out again in the same order, with their packed sizes
+            vector<VertexElementType>::type newTypes;
+            vector<size_t>::type newOffsets;
+            size_t newVertexSize = 0;
+            bool conversionNeeded = false;
+            VertexDeclaration::VertexElementList::iterator elemi;
+            for (elemi = elems.begin(); elemi != elems.end(); ++elemi)
+            {
+                VertexElementType newType = getPackedElementType(*elemi, positions, normals, texCoords);
+                conversionNeeded = conversionNeeded || newType != elemi->getType();
+                newTypes.push_back(newType);
+                newOffsets.push_back(newVertexSize);
+                newVertexSize += VertexElement::getTypeSize(newType);
+            }
+
+            if (!conversionNeeded)
+                continue;
+
+            HardwareVertexBufferSharedPtr newBuf = mMgr->createVertexBuffer(newVertexSize,
+                srcBuf->getNumVertices(), srcBuf->getUsage(), srcBuf->hasShadowBuffer());
+
+            const unsigned char* pSrc = static_cast<const unsigned char*>(
+                srcBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+            unsigned char* pDest = static_cast<unsigned char*>(
+                newBuf->lock(HardwareBuffer::HBL_DISCARD));
+
+            for (size_t v = 0; v < srcBuf->getNumVertices(); ++v)
+            {
+                size_t e = 0;
+                for (elemi = elems.begin(); elemi != elems.end(); ++elemi, ++e)
+                {
+                    const unsigned char* pSrcElem = pSrc + elemi->getOffset();
+                    unsigned char* pDestElem = pDest + newOffsets[e];
+
+                    if (newTypes[e] == elemi->getType())
+                    {
+                        memcpy(pDestElem, pSrcElem, elemi->getSize());
+                        continue;
+                    }
+
+                    // Missing components default to 0, and w to 1 for positions
+                    float value[4] = {0, 0, 0, elemi->getSemantic() == VES_POSITION ? 1.0f : 0.0f};
+                    memcpy(value, pSrcElem, elemi->getSize());
+
+                    unsigned short count = VertexElement::getTypeCount(newTypes[e]);
+                    uint16* pPacked = reinterpret_cast<uint16*>(pDestElem);
+                    for (unsigned short c = 0; c < count; ++c)
+                    {
+                        if (newTypes[e] == VET_SHORT4_NORM)
+                        {
+                            Real clamped = Math::Clamp(value[c], -1.0f, 1.0f);
+                            pPacked[c] = static_cast<uint16>(static_cast<int16>(
+                                Math::Floor(clamped * 32767 + 0.5f)));
+                        }
+                        else
+                        {
+                            pPacked[c] = Bitwise::floatToHalf(value[c]);
+                        }
+                    }
+                }
+                pSrc += srcBuf->getVertexSize();
+                pDest += newVertexSize;
+            }
+
+            srcBuf->unlock();
+            newBuf->unlock();
+            vertexBufferBinding->setBinding(bindi->first, newBuf);
+
+            // Modify the elements to reflect the new layout
+            const VertexDeclaration::VertexElementList& allelems = 
+                vertexDeclaration->getElements();
+            VertexDeclaration::VertexElementList::const_iterator ai;
+            unsigned short elemIndex = 0;
+            size_t e = 0;
+            for (ai = allelems.begin(); ai != allelems.end(); ++ai, ++elemIndex)
+            {
+                const VertexElement& elem = *ai;
+                if (elem.getSource() == bindi->first)
+                {
+                    vertexDeclaration->modifyElement(elemIndex, 
+                        elem.getSource(), newOffsets[e], newTypes[e], 
+                        elem.getSemantic(), elem.getIndex());
+                    ++e;
+                }
+            }
+        }
     }
     //-----------------------------------------------------------------------
     ushort VertexData::allocateHardwareAnimationElements(ushort count, bool animateNormals)
@@ -699,6 +834,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     IndexData::IndexData()
     {
+        mPoolMgr = 0;
         indexCount = 0;
         indexStart = 0;
         
@@ -706,6 +842,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     IndexData::~IndexData()
     {
+        if (mPoolMgr)
+            mPoolMgr->_releasePooledIndexData(this);
     }
     //-----------------------------------------------------------------------
     IndexData* IndexData::clone(bool copyData, HardwareBufferManagerBase* mgr) const
@@ -716,9 +854,12 @@ namespace Ogre {
         {
             if (copyData)
             {
-                dest->indexBuffer = pManager->createIndexBuffer(indexBuffer->getType(), indexBuffer->getNumIndexes(),
+                // pooled data only owns its range of the buffer
+                size_t numIndexes = mPoolMgr ? indexCount : indexBuffer->getNumIndexes();
+                size_t srcOffset = mPoolMgr ? indexStart * indexBuffer->getIndexSize() : 0;
+                dest->indexBuffer = pManager->createIndexBuffer(indexBuffer->getType(), numIndexes,
                     indexBuffer->getUsage(), indexBuffer->hasShadowBuffer());
-                dest->indexBuffer->copyData(*indexBuffer, 0, 0, indexBuffer->getSizeInBytes(), true);
+                dest->indexBuffer->copyData(*indexBuffer, srcOffset, 0, dest->indexBuffer->getSizeInBytes(), true);
             }
             else
             {
@@ -726,208 +867,213 @@ namespace Ogre {
             }
         }
         dest->indexCount = indexCount;
-        dest->indexStart = indexStart;
+        dest->indexStart = (mPoolMgr && copyData) ? 0 : indexStart;
         return dest;
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
-    // Local Utility class for vertex cache optimizer
-    class Triangle
+    // Vertex cache optimizer, after Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+    namespace
     {
-    public:
-        enum EdgeMatchType {
-            AB, BC, CA, ANY, NONE
-        };
-
-        uint32 a, b, c;     
-
-        inline Triangle()
-        {
-        }
-
-        inline Triangle( uint32 ta, uint32 tb, uint32 tc ) 
-            : a( ta ), b( tb ), c( tc )
-        {
-        }
-
-        inline Triangle( uint32 t[3] )
-            : a( t[0] ), b( t[1] ), c( t[2] )
-        {
-        }
-
-        inline Triangle( const Triangle& t )
-            : a( t.a ), b( t.b ), c( t.c )
-        {
-        }
-
-        inline bool sharesEdge(const Triangle& t) const
-        {
-            return( (a == t.a && b == t.c) ||
-                    (a == t.b && b == t.a) ||
-                    (a == t.c && b == t.b) ||
-                    (b == t.a && c == t.c) ||
-                    (b == t.b && c == t.a) ||
-                    (b == t.c && c == t.b) ||
-                    (c == t.a && a == t.c) ||
-                    (c == t.b && a == t.a) ||
-                    (c == t.c && a == t.b) );
-        }
-
-        inline bool sharesEdge(const uint32 ea, const uint32 eb, const Triangle& t) const
-        {
-            return( (ea == t.a && eb == t.c) ||
-                    (ea == t.b && eb == t.a) ||
-                    (ea == t.c && eb == t.b) ); 
-        }
-
-        inline bool sharesEdge(const EdgeMatchType edge, const Triangle& t) const
-        {
-            if (edge == AB)
-                return sharesEdge(a, b, t);
-            else if (edge == BC)
-                return sharesEdge(b, c, t);
-            else if (edge == CA)
-                return sharesEdge(c, a, t);
-            else
-                return (edge == ANY) == sharesEdge(t);
-        }
+        const int FORSYTH_CACHE_SIZE = 32;
+        const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+        const float FORSYTH_LAST_TRI_SCORE = 0.75f;
+        const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+        const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
 
-        inline EdgeMatchType endoSharedEdge(const Triangle& t) const
+        struct ForsythVertex
         {
-            if (sharesEdge(a, b, t)) return AB;
-            if (sharesEdge(b, c, t)) return BC;
-            if (sharesEdge(c, a, t)) return CA;
-            return NONE;
-        }
+            /// Position in the simulated cache, -1 if not in it
+            int cachePosition;
+            float score;
+            /// Triangles using the vertex which aren't emitted yet
+            uint32 activeTriangles;
+            /// Start of the triangles using the vertex in the adjacency list
+            uint32 firstTriangle;
+        };
 
-        inline EdgeMatchType exoSharedEdge(const Triangle& t) const
+        float forsythVertexScore(const ForsythVertex& v)
         {
-            return t.endoSharedEdge(*this);
-        }
+            if (v.activeTriangles == 0)
+                return -1.0f;
 
-        inline void shiftClockwise()
-        {
-            uint32 t = a;
-            a = c;
-            c = b;
-            b = t;
-        }
-
-        inline void shiftCounterClockwise()
-        {
-            uint32 t = a;
-            a = b;
-            b = c;
-            c = t;
+            float score = 0.0f;
+            if (v.cachePosition >= 0)
+            {
+                if (v.cachePosition < 3)
+                {
+                    // The last triangle's vertices get a fixed score, so that it
+                    // doesn't matter which order they were emitted in
+                    score = FORSYTH_LAST_TRI_SCORE;
+                }
+                else
+                {
+                    float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+                    score = 1.0f - (v.cachePosition - 3) * scaler;
+                    score = Math::Pow(score, FORSYTH_CACHE_DECAY_POWER);
+                }
+            }
+            // Boost vertices with few triangles left, to get rid of lone triangles
+            score += FORSYTH_VALENCE_BOOST_SCALE *
+                Math::Pow((float)v.activeTriangles, -FORSYTH_VALENCE_BOOST_POWER);
+            return score;
         }
-    };
-    //-----------------------------------------------------------------------
-    //-----------------------------------------------------------------------
-    void IndexData::optimiseVertexCacheTriList(void)
-    {
-        if (indexBuffer->isLocked()) return;
 
-        void *buffer = indexBuffer->lock(HardwareBuffer::HBL_NORMAL);
-
-        Triangle* triangles;
-
-        size_t nIndexes = indexCount;
-        size_t nTriangles = nIndexes / 3;
-        size_t i, j;
-        uint16 *source = 0;
-
-        if (indexBuffer->getType() == HardwareIndexBuffer::IT_16BIT)
+        /// Reorders the triangles of a triangle list in place
+        void optimiseForsyth(uint32* indexes, size_t triangleCount)
         {
-            triangles = OGRE_ALLOC_T(Triangle, nTriangles, MEMCATEGORY_GEOMETRY);
-            source = (uint16 *)buffer;
-            uint32 *dest = (uint32 *)triangles;
-            for (i = 0; i < nIndexes; ++i) dest[i] = source[i];
-        }
-        else
-            triangles = static_cast<Triangle*>(buffer);
-
-        // sort triangles based on shared edges
-        uint32 *destlist = OGRE_ALLOC_T(uint32, nTriangles, MEMCATEGORY_GEOMETRY);
-        unsigned char *visited = OGRE_ALLOC_T(unsigned char, nTriangles, MEMCATEGORY_GEOMETRY);
-
-        for (i = 0; i < nTriangles; ++i) visited[i] = 0;
-
-        uint32 start = 0, ti = 0, destcount = 0;
+            size_t indexCount = triangleCount * 3;
+            uint32 vertexCount = 0;
+            for (size_t i = 0; i < indexCount; ++i)
+                vertexCount = std::max(vertexCount, indexes[i] + 1);
 
-        bool found = false;
-        for (i = 0; i < nTriangles; ++i)
-        {
-            if (found)
-                found = false;
-            else
+            vector<ForsythVertex>::type vertices(vertexCount);
+            for (uint32 v = 0; v < vertexCount; ++v)
             {
-                while (visited[start++]);
-                ti = start - 1;
+                vertices[v].cachePosition = -1;
+                vertices[v].activeTriangles = 0;
             }
+            for (size_t i = 0; i < indexCount; ++i)
+                vertices[indexes[i]].activeTriangles++;
 
-            destlist[destcount++] = ti;
-            visited[ti] = 1;
+            // Triangles using each vertex, the active ones are kept at the front
+            uint32 offset = 0;
+            for (uint32 v = 0; v < vertexCount; ++v)
+            {
+                vertices[v].firstTriangle = offset;
+                offset += vertices[v].activeTriangles;
+                vertices[v].score = forsythVertexScore(vertices[v]);
+            }
+            vector<uint32>::type adjacency(indexCount);
+            vector<uint32>::type filled(vertexCount, 0);
+            for (size_t i = 0; i < indexCount; ++i)
+            {
+                uint32 v = indexes[i];
+                adjacency[vertices[v].firstTriangle + filled[v]++] = static_cast<uint32>(i / 3);
+            }
 
-            for (j = start; j < nTriangles; ++j)
+            vector<float>::type triangleScores(triangleCount);
+            vector<bool>::type emitted(triangleCount, false);
+            int bestTriangle = -1;
+            float bestScore = -1.0f;
+            for (size_t t = 0; t < triangleCount; ++t)
             {
-                if (visited[j]) continue;
-                
-                if (triangles[ti].sharesEdge(triangles[j]))
+                triangleScores[t] = vertices[indexes[t * 3]].score +
+                    vertices[indexes[t * 3 + 1]].score + vertices[indexes[t * 3 + 2]].score;
+                if (triangleScores[t] > bestScore)
                 {
-                    found = true;
-                    ti = static_cast<uint32>(j);
-                    break;
+                    bestScore = triangleScores[t];
+                    bestTriangle = static_cast<int>(t);
                 }
             }
-        }
 
-        if (indexBuffer->getType() == HardwareIndexBuffer::IT_16BIT)
-        {
-            // reorder the indexbuffer
-            j = 0;
-            for (i = 0; i < nTriangles; ++i)
+            vector<uint32>::type output(indexCount);
+            uint32 cache[FORSYTH_CACHE_SIZE + 3];
+            int cacheCount = 0;
+            size_t scanPosition = 0;
+
+            for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
             {
-                Triangle *t = &triangles[destlist[i]];
-                if(source)
+                if (bestTriangle < 0)
                 {
-                    source[j++] = (uint16)t->a;
-                    source[j++] = (uint16)t->b;
-                    source[j++] = (uint16)t->c;
+                    // No triangle touches the cache, take the next one not emitted yet
+                    while (emitted[scanPosition])
+                        ++scanPosition;
+                    bestTriangle = static_cast<int>(scanPosition);
                 }
-            }
-            OGRE_FREE(triangles, MEMCATEGORY_GEOMETRY);
-        }
-        else
-        {
-            uint32 *reflist = OGRE_ALLOC_T(uint32, nTriangles, MEMCATEGORY_GEOMETRY);
 
-            // fill the referencebuffer
-            for (i = 0; i < nTriangles; ++i)
-                reflist[destlist[i]] = static_cast<uint32>(i);
-            
-            // reorder the indexbuffer
-            for (i = 0; i < nTriangles; ++i)
-            {
-                j = destlist[i];
-                if (i == j) continue; // do not move triangle
+                size_t t = static_cast<size_t>(bestTriangle);
+                emitted[t] = true;
+                uint32 tri[3] = { indexes[t * 3], indexes[t * 3 + 1], indexes[t * 3 + 2] };
+                output[emittedCount * 3] = tri[0];
+                output[emittedCount * 3 + 1] = tri[1];
+                output[emittedCount * 3 + 2] = tri[2];
 
-                // swap triangles
+                // Remove the triangle from the active lists of its vertices
+                for (int k = 0; k < 3; ++k)
+                {
+                    ForsythVertex& v = vertices[tri[k]];
+                    uint32* list = &adjacency[v.firstTriangle];
+                    for (uint32 n = 0; n < v.activeTriangles; ++n)
+                    {
+                        if (list[n] == t)
+                        {
+                            std::swap(list[n], list[v.activeTriangles - 1]);
+                            break;
+                        }
+                    }
+                    --v.activeTriangles;
+                }
 
-                Triangle t = triangles[i];
-                triangles[i] = triangles[j];
-                triangles[j] = t;
+                // Move the triangle's vertices to the front of the LRU cache
+                uint32 newCache[FORSYTH_CACHE_SIZE + 3];
+                int newCount = 0;
+                for (int k = 0; k < 3; ++k)
+                    newCache[newCount++] = tri[k];
+                for (int c = 0; c < cacheCount; ++c)
+                {
+                    uint32 v = cache[c];
+                    if (v != tri[0] && v != tri[1] && v != tri[2])
+                        newCache[newCount++] = v;
+                }
+                for (int c = 0; c < newCount; ++c)
+                {
+                    ForsythVertex& v = vertices[newCache[c]];
+                    v.cachePosition = c < FORSYTH_CACHE_SIZE ? c : -1;
+                    v.score = forsythVertexScore(v);
+                }
+                cacheCount = std::min(newCount, FORSYTH_CACHE_SIZE);
+                memcpy(cache, newCache, cacheCount * sizeof(uint32));
 
-                // change reference
-                destlist[reflist[i]] = static_cast<uint32>(j);
-                // destlist[i] = i; // not needed, it will not be used
+                // Only the triangles of cached vertices changed their score
+                bestTriangle = -1;
+                bestScore = -1.0f;
+                for (int c = 0; c < newCount; ++c)
+                {
+                    const ForsythVertex& v = vertices[newCache[c]];
+                    for (uint32 n = 0; n < v.activeTriangles; ++n)
+                    {
+                        uint32 other = adjacency[v.firstTriangle + n];
+                        float score = vertices[indexes[other * 3]].score +
+                            vertices[indexes[other * 3 + 1]].score + vertices[indexes[other * 3 + 2]].score;
+                        triangleScores[other] = score;
+                        if (score > bestScore)
+                        {
+                            bestScore = score;
+                            bestTriangle = static_cast<int>(other);
+                        }
+                    }
+                }
             }
 
-            OGRE_FREE(reflist, MEMCATEGORY_GEOMETRY);
+            memcpy(indexes, &output[0], indexCount * sizeof(uint32));
+        }
+    }
+    //-----------------------------------------------------------------------
+    void IndexData::optimiseVertexCacheTriList(void)
+    {
+        if (indexBuffer->isLocked()) return;
+
+        size_t nTriangles = indexCount / 3;
+        if (nTriangles == 0) return;
+
+        bool use16Bit = indexBuffer->getType() == HardwareIndexBuffer::IT_16BIT;
+        void* buffer = indexBuffer->lock(indexStart * indexBuffer->getIndexSize(),
+            nTriangles * 3 * indexBuffer->getIndexSize(), HardwareBuffer::HBL_NORMAL);
+
+        if (use16Bit)
+        {
+            uint16* source = static_cast<uint16*>(buffer);
+            vector<uint32>::type indexes(source, source + nTriangles * 3);
+            optimiseForsyth(&indexes[0], nTriangles);
+            for (size_t i = 0; i < indexes.size(); ++i)
+                source[i] = static_cast<uint16>(indexes[i]);
+        }
+        else
+        {
+            optimiseForsyth(static_cast<uint32*>(buffer), nTriangles);
         }
 
-        OGRE_FREE(destlist, MEMCATEGORY_GEOMETRY);
-        OGRE_FREE(visited, MEMCATEGORY_GEOMETRY);
-                    
         indexBuffer->unlock();
     }
     //-----------------------------------------------------------------------
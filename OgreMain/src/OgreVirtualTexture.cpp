@@ -0,0 +1,411 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreVirtualTexture.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreRenderTarget.h"
+#include "OgreAsyncReadback.h"
+#include "OgreBitwise.h"
+#include "OgreLogManager.h"
+#include "OgreParallel.h"
+
+namespace Ogre {
+
+    namespace {
+        /// A page being loaded by the provider
+        struct PageLoad
+        {
+            uint64 page;
+            uint32 x;
+            uint32 y;
+            uint8 mip;
+            bool loaded;
+            vector<uint8>::type data;
+        };
+
+        class PageLoadJob : public ParallelJob
+        {
+        public:
+            PageLoadJob(VirtualTexture::PageProvider* provider, uint32 size, PixelFormat format)
+                : mProvider(provider), mSize(size), mFormat(format) {}
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    PageLoad& load = mPages[i];
+                    PixelBox dest(mSize, mSize, 1, mFormat, &load.data[0]);
+                    try
+                    {
+                        load.loaded = mProvider->loadPage(load.x, load.y, load.mip, dest);
+                    }
+                    catch (Exception& e)
+                    {
+                        LogManager::getSingleton().logMessage("Loading a virtual texture page failed: " +
+                            e.getFullDescription(), LML_CRITICAL);
+                        load.loaded = false;
+                    }
+                }
+            }
+
+            VirtualTexture::PageProvider* mProvider;
+            uint32 mSize;
+            PixelFormat mFormat;
+            vector<PageLoad>::type mPages;
+        };
+    }
+    //-----------------------------------------------------------------------
+    VirtualTexture::VirtualTexture(const String& name, uint32 widthInPages, uint32 heightInPages,
+        uint32 pageSize, uint32 border, uint32 cacheWidthInPages, uint32 cacheHeightInPages,
+        PixelFormat format, PageProvider* provider, const String& group)
+        : mName(name), mWidthInPages(widthInPages), mHeightInPages(heightInPages),
+          mPageSize(pageSize), mBorder(border), mCacheWidthInPages(cacheWidthInPages),
+          mCacheHeightInPages(cacheHeightInPages), mFormat(format), mNumMipmaps(0),
+          mProvider(provider), mLoadFrame(0), mMaxPagesPerUpdate(8), mFrame(0),
+          mPageTableDirty(false), mFeedbackTarget(0)
+    {
+        if (!provider || !pageSize ||
+            !widthInPages || widthInPages > 4096 || !Bitwise::isPO2(widthInPages) ||
+            !heightInPages || heightInPages > 4096 || !Bitwise::isPO2(heightInPages))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "The size of virtual texture '" + name + "' must be a power of two up to 4096 pages",
+                "VirtualTexture::VirtualTexture");
+        }
+        mNumMipmaps = static_cast<uint8>(Bitwise::mostSignificantBitSet(
+            std::max(widthInPages, heightInPages)));
+
+        // The smallest mip level is locked in the cache, so it needs room for more
+        if (!cacheWidthInPages || cacheWidthInPages > 256 ||
+            !cacheHeightInPages || cacheHeightInPages > 256 ||
+            cacheWidthInPages * cacheHeightInPages < 2)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "The cache of virtual texture '" + name + "' must be 2 to 256 by 256 pages",
+                "VirtualTexture::VirtualTexture");
+        }
+
+        TextureManager& textureManager = TextureManager::getSingleton();
+        mPageTable = textureManager.createManual(name + "/PageTable", group, TEX_TYPE_2D,
+            widthInPages, heightInPages, mNumMipmaps, PF_BYTE_RGBA);
+        const uint32 slotSize = pageSize + 2 * border;
+        mCache = textureManager.createManual(name + "/Cache", group, TEX_TYPE_2D,
+            cacheWidthInPages * slotSize, cacheHeightInPages * slotSize, 0, format);
+
+        Slot empty = { INVALID_PAGE, 0 };
+        mSlots.resize(cacheWidthInPages * cacheHeightInPages, empty);
+
+        // Load the smallest mip level at once, it is the fallback of every other page
+        mRequested.insert(makePage(0, 0, mNumMipmaps));
+        startLoading();
+        if (mLoadJob)
+            mLoadJob->complete();
+        finishLoading();
+        mRequested.clear();
+        updatePageTable();
+    }
+    //-----------------------------------------------------------------------
+    VirtualTexture::~VirtualTexture()
+    {
+        if (mLoadJob)
+            mLoadJob->complete();
+
+        TextureManager& textureManager = TextureManager::getSingleton();
+        textureManager.remove(mPageTable);
+        textureManager.remove(mCache);
+    }
+    //-----------------------------------------------------------------------
+    Vector4 VirtualTexture::getPageTableParameters(void) const
+    {
+        return Vector4(Real(mWidthInPages), Real(mHeightInPages), Real(mPageSize), Real(mBorder));
+    }
+    //-----------------------------------------------------------------------
+    Vector4 VirtualTexture::getCacheParameters(void) const
+    {
+        return Vector4(Real(mCacheWidthInPages), Real(mCacheHeightInPages),
+            Real(1) / mCache->getWidth(), Real(1) / mCache->getHeight());
+    }
+    //-----------------------------------------------------------------------
+    void VirtualTexture::setFeedbackTarget(RenderTarget* target)
+    {
+        mFeedbackTarget = target;
+        mFeedbackReadback.reset();
+    }
+    //-----------------------------------------------------------------------
+    void VirtualTexture::requestPage(uint32 x, uint32 y, uint8 mip)
+    {
+        mip = std::min(mip, mNumMipmaps);
+        x = std::min(x, getWidthInPages(mip) - 1);
+        y = std::min(y, getHeightInPages(mip) - 1);
+
+        // Until the page arrives its nearest resident ancestor is shown instead,
+        // keep that one from being evicted
+        bool requested = false;
+        for (;;)
+        {
+            PageMap::const_iterator i = mResident.find(makePage(x, y, mip));
+            if (i != mResident.end())
+            {
+                mSlots[i->second].lastUsed = mFrame;
+                break;
+            }
+            if (!requested)
+            {
+                mRequested.insert(makePage(x, y, mip));
+                requested = true;
+            }
+            if (mip == mNumMipmaps)
+                break;
+            x >>= 1;
+            y >>= 1;
+            ++mip;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void VirtualTexture::processFeedback(const PixelBox& feedback)
+    {
+        if (feedback.format != PF_BYTE_RGBA)
+        {
+            vector<uint8>::type pixels(feedback.getWidth() * feedback.getHeight() * feedback.getDepth() * 4);
+            PixelBox converted(feedback.getWidth(), feedback.getHeight(), feedback.getDepth(),
+                PF_BYTE_RGBA, &pixels[0]);
+            PixelUtil::bulkPixelConversion(feedback, converted);
+            processFeedback(converted);
+            return;
+        }
+
+        // Neighbouring pixels mostly need the same page, skip the repeats
+        uint32 previous = 0xFFFFFFFF;
+        for (size_t z = 0; z < feedback.getDepth(); ++z)
+        {
+            for (size_t y = 0; y < feedback.getHeight(); ++y)
+            {
+                const uint8* pixel = static_cast<const uint8*>(feedback.data) +
+                    ((feedback.front + z) * feedback.slicePitch +
+                     (feedback.top + y) * feedback.rowPitch + feedback.left) * 4;
+                for (size_t x = 0; x < feedback.getWidth(); ++x, pixel += 4)
+                {
+                    uint32 code;
+                    memcpy(&code, pixel, 4);
+                    if (code == previous)
+                        continue;
+                    previous = code;
+
+                    if (pixel[3] == 255)
+                        continue;
+                    requestPage(pixel[0] | ((pixel[2] & 0xF) << 8),
+                        pixel[1] | ((pixel[2] >> 4) << 8), pixel[3]);
+                }
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void VirtualTexture::update(void)
+    {
+        // Request the pages of the feedback rendered since the readback was started
+        if (mFeedbackReadback && mFeedbackReadback->isReady())
+        {
+            uint32 width = mFeedbackReadback->getWidth();
+            uint32 height = mFeedbackReadback->getHeight();
+            mFeedbackPixels.resize(width * height * 4);
+            PixelBox feedback(width, height, 1, PF_BYTE_RGBA, &mFeedbackPixels[0]);
+            mFeedbackReadback->fetch(feedback);
+            mFeedbackReadback.reset();
+            processFeedback(feedback);
+        }
+        if (mFeedbackTarget && !mFeedbackReadback)
+        {
+            mFeedbackReadback = mFeedbackTarget->copyContentsToMemoryAsync(
+                Box(0, 0, mFeedbackTarget->getWidth(), mFeedbackTarget->getHeight()));
+        }
+
+        finishLoading();
+        startLoading();
+        if (mPageTableDirty)
+            updatePageTable();
+
+        mRequested.clear();
+        ++mFrame;
+    }
+    //-----------------------------------------------------------------------
+    bool VirtualTexture::isPageResident(uint32 x, uint32 y, uint8 mip) const
+    {
+        return mResident.find(makePage(x, y, mip)) != mResident.end();
+    }
+    //-----------------------------------------------------------------------
+    void VirtualTexture::startLoading(void)
+    {
+        if (mLoadJob)
+            return;
+
+        vector<uint64>::type pages;
+        for (PageSet::const_iterator i = mRequested.begin(); i != mRequested.end(); ++i)
+        {
+            if (mResident.find(*i) == mResident.end() && mLoading.find(*i) == mLoading.end())
+                pages.push_back(*i);
+        }
+        if (pages.empty())
+            return;
+
+        // The mip level is in the high bits, so this loads the smaller mip
+        // levels first, which are the fallback of the larger ones
+        std::sort(pages.begin(), pages.end(), std::greater<uint64>());
+        if (pages.size() > mMaxPagesPerUpdate)
+            pages.resize(std::max<size_t>(mMaxPagesPerUpdate, 1));
+
+        const uint32 slotSize = mPageSize + 2 * mBorder;
+        PageLoadJob* job = OGRE_NEW PageLoadJob(mProvider, slotSize, mFormat);
+        job->mPages.resize(pages.size());
+        for (size_t i = 0; i < pages.size(); ++i)
+        {
+            PageLoad& load = job->mPages[i];
+            load.page = pages[i];
+            load.x = getPageX(pages[i]);
+            load.y = getPageY(pages[i]);
+            load.mip = getPageMip(pages[i]);
+            load.loaded = false;
+            load.data.resize(PixelUtil::getMemorySize(slotSize, slotSize, 1, mFormat));
+            mLoading.insert(pages[i]);
+        }
+        job->setCount(pages.size());
+
+        mLoadJob.reset(job);
+        mLoadFrame = mFrame;
+        ParallelJob::start(mLoadJob);
+    }
+    //-----------------------------------------------------------------------
+    void VirtualTexture::finishLoading(void)
+    {
+        if (!mLoadJob)
+            return;
+
+        // Without workers nobody takes the job, so process it one update later
+        if (!mLoadJob->isComplete())
+        {
+            if (mLoadFrame == mFrame)
+                return;
+            mLoadJob->complete();
+        }
+
+        PageLoadJob* job = static_cast<PageLoadJob*>(mLoadJob.get());
+        HardwarePixelBufferSharedPtr cache = mCache->getBuffer();
+        const uint32 slotSize = mPageSize + 2 * mBorder;
+        for (size_t i = 0; i < job->mPages.size(); ++i)
+        {
+            PageLoad& load = job->mPages[i];
+            mLoading.erase(load.page);
+            if (!load.loaded)
+                continue;
+
+            uint32 slot = acquireSlot();
+            if (slot == mSlots.size())
+                continue;
+
+            uint32 left = (slot % mCacheWidthInPages) * slotSize;
+            uint32 top = (slot / mCacheWidthInPages) * slotSize;
+            cache->blitFromMemory(PixelBox(slotSize, slotSize, 1, mFormat, &load.data[0]),
+                Box(left, top, left + slotSize, top + slotSize));
+
+            mSlots[slot].page = load.page;
+            mSlots[slot].lastUsed = mFrame;
+            mResident[load.page] = slot;
+            mPageTableDirty = true;
+        }
+
+        mLoadJob.reset();
+    }
+    //-----------------------------------------------------------------------
+    uint32 VirtualTexture::acquireSlot(void)
+    {
+        uint32 oldest = static_cast<uint32>(mSlots.size());
+        for (uint32 i = 0; i < mSlots.size(); ++i)
+        {
+            const Slot& slot = mSlots[i];
+            if (slot.page == INVALID_PAGE)
+                return i;
+
+            // Never evict the smallest mip level or pages needed in this update
+            if (getPageMip(slot.page) == mNumMipmaps || slot.lastUsed >= mFrame)
+                continue;
+            if (oldest == mSlots.size() || slot.lastUsed < mSlots[oldest].lastUsed)
+                oldest = i;
+        }
+
+        if (oldest != mSlots.size())
+        {
+            mResident.erase(mSlots[oldest].page);
+            mSlots[oldest].page = INVALID_PAGE;
+        }
+        return oldest;
+    }
+    //-----------------------------------------------------------------------
+    void VirtualTexture::updatePageTable(void)
+    {
+        // Fill in the mip levels from the smallest one, so that the pages which
+        // are not resident can copy the entry of their parent
+        vector<uint8>::type parent, level;
+        const size_t numMipmaps = std::min<size_t>(mNumMipmaps, mPageTable->getNumMipmaps());
+        for (int mip = mNumMipmaps; mip >= 0; --mip)
+        {
+            const uint32 width = getWidthInPages(mip);
+            const uint32 height = getHeightInPages(mip);
+            const uint32 parentWidth = getWidthInPages(mip + 1);
+            level.assign(width * height * 4, 0);
+
+            for (uint32 y = 0; y < height; ++y)
+            {
+                for (uint32 x = 0; x < width; ++x)
+                {
+                    uint8* entry = &level[(y * width + x) * 4];
+                    PageMap::const_iterator i = mResident.find(makePage(x, y, mip));
+                    if (i != mResident.end())
+                    {
+                        entry[0] = static_cast<uint8>(i->second % mCacheWidthInPages);
+                        entry[1] = static_cast<uint8>(i->second / mCacheWidthInPages);
+                        entry[2] = static_cast<uint8>(mip);
+                        entry[3] = 255;
+                    }
+                    else if (mip < mNumMipmaps)
+                    {
+                        memcpy(entry, &parent[((y >> 1) * parentWidth + (x >> 1)) * 4], 4);
+                    }
+                }
+            }
+
+            if (static_cast<size_t>(mip) <= numMipmaps)
+            {
+                mPageTable->getBuffer(0, mip)->blitFromMemory(
+                    PixelBox(width, height, 1, PF_BYTE_RGBA, &level[0]));
+            }
+            parent.swap(level);
+        }
+
+        mPageTableDirty = false;
+    }
+}
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreRoot.h"
 #include "OgreTimer.h"
+#include "OgreProfiler.h"
 
 namespace Ogre {
     //---------------------------------------------------------------------
@@ -45,8 +46,13 @@ namespace Ogre {
         return i->second;
     }
     //---------------------------------------------------------------------
+    void WorkQueue::_processParallelJob(const ParallelJobPtr& job)
+    {
+        job->process();
+    }
+    //---------------------------------------------------------------------
     WorkQueue::Request::Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid)
-        : mChannel(channel), mType(rtype), mData(rData), mRetryCount(retry), mID(rid), mAborted(false)
+        : mChannel(channel), mType(rtype), mData(rData), mRetryCount(retry), mID(rid), mAborted(false), mQueueTime(0)
     {
 
     }
@@ -69,6 +75,51 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
+    namespace
+    {
+        /// Whether trivial messages reach the default log, to skip formatting them otherwise
+        bool isTrivialLogged()
+        {
+            LogManager* logMgr = LogManager::getSingletonPtr();
+            Log* log = logMgr ? logMgr->getDefaultLog() : 0;
+            return log && (log->getLogDetail() + LML_TRIVIAL) >= OGRE_LOG_THRESHOLD;
+        }
+
+        /// Current time for the channel statistics, in microseconds
+        unsigned long getCurrentTime()
+        {
+            Root* root = Root::getSingletonPtr();
+            return root ? root->getTimer()->getMicroseconds() : 0;
+        }
+
+        /// Request data of a parallel job, keeps the job alive for requests which start late
+        struct ParallelJobRequest
+        {
+            ParallelJobPtr job;
+
+            ParallelJobRequest(const ParallelJobPtr& j) : job(j) {}
+
+            friend std::ostream& operator<<(std::ostream& o, const ParallelJobRequest& r)
+            { (void)r; return o; }
+        };
+    }
+    //---------------------------------------------------------------------
+    class DefaultWorkQueueBase::ParallelJobHandler : public WorkQueue::RequestHandler,
+        public WorkQueue::ResponseHandler, public UtilityAlloc
+    {
+    public:
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            any_cast<ParallelJobRequest>(req->getData()).job->process();
+            return OGRE_NEW WorkQueue::Response(req, true, Any());
+        }
+
+        void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+        {
+            // nothing to do, the thread running the job waited for it already
+        }
+    };
+    //---------------------------------------------------------------------
     DefaultWorkQueueBase::DefaultWorkQueueBase(const String& name)
         : mName(name)
         , mWorkerThreadCount(1)
@@ -82,7 +133,11 @@ namespace Ogre {
         , mShuttingDown(false)
         , mIdleThreadRunning(false)
         , mIdleProcessed(0)
+        , mParallelJobHandler(OGRE_NEW ParallelJobHandler())
     {
+        mParallelJobChannel = getChannel("Ogre/ParallelJob");
+        addRequestHandler(mParallelJobChannel, mParallelJobHandler);
+        addResponseHandler(mParallelJobChannel, mParallelJobHandler);
     }
     //---------------------------------------------------------------------
     const String& DefaultWorkQueueBase::getName() const
@@ -114,17 +169,24 @@ namespace Ogre {
     {
         //shutdown(); // can't call here; abstract function
 
-        for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
+        for (size_t p = 0; p < PRIORITY_COUNT; ++p)
         {
-            OGRE_DELETE (*i);
+            for (RequestQueue::iterator i = mRequestQueues[p].begin(); i != mRequestQueues[p].end(); ++i)
+            {
+                OGRE_DELETE (*i);
+            }
+            mRequestQueues[p].clear();
         }
-        mRequestQueue.clear();
 
         for (ResponseQueue::iterator i = mResponseQueue.begin(); i != mResponseQueue.end(); ++i)
         {
             OGRE_DELETE (*i);
         }
         mResponseQueue.clear();
+
+        removeRequestHandler(mParallelJobChannel, mParallelJobHandler);
+        removeResponseHandler(mParallelJobChannel, mParallelJobHandler);
+        OGRE_DELETE mParallelJobHandler;
     }
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::addRequestHandler(uint16 channel, RequestHandler* rh)
@@ -176,6 +238,8 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::addResponseHandler(uint16 channel, ResponseHandler* rh)
     {
+        OGRE_WQ_LOCK_RW_MUTEX_WRITE(mResponseHandlerMutex);
+
         ResponseHandlerListByChannel::iterator i = mResponseHandlers.find(channel);
         if (i == mResponseHandlers.end())
             i = mResponseHandlers.insert(ResponseHandlerListByChannel::value_type(channel, ResponseHandlerList())).first;
@@ -187,6 +251,8 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::removeResponseHandler(uint16 channel, ResponseHandler* rh)
     {
+        OGRE_WQ_LOCK_RW_MUTEX_WRITE(mResponseHandlerMutex);
+
         ResponseHandlerListByChannel::iterator i = mResponseHandlers.find(channel);
         if (i != mResponseHandlers.end())
         {
@@ -215,7 +281,8 @@ namespace Ogre {
             rid = ++mRequestCount;
             req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid);
 
-            LogManager::getSingleton().stream(LML_TRIVIAL) << 
+            if (isTrivialLogged())
+                LogManager::getSingleton().stream(LML_TRIVIAL) << 
                 "DefaultWorkQueueBase('" << mName << "') - QUEUED(thread:" <<
                 OGRE_THREAD_CURRENT_ID
                 << "): ID=" << rid
@@ -223,7 +290,7 @@ namespace Ogre {
 #if OGRE_THREAD_SUPPORT
             if (!forceSynchronous&& !idleThread)
             {
-                mRequestQueue.push_back(req);
+                pushRequest(req);
                 notifyWorkers();
                 return rid;
             }
@@ -254,13 +321,14 @@ namespace Ogre {
 
         Request* req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid);
 
-        LogManager::getSingleton().stream(LML_TRIVIAL) << 
+        if (isTrivialLogged())
+            LogManager::getSingleton().stream(LML_TRIVIAL) << 
             "DefaultWorkQueueBase('" << mName << "') - REQUEUED(thread:" <<
             OGRE_THREAD_CURRENT_ID
             << "): ID=" << rid
                    << " channel=" << channel << " requestType=" << requestType;
 #if OGRE_THREAD_SUPPORT
-        mRequestQueue.push_back(req);
+        pushRequest(req);
         notifyWorkers();
 #else
         processRequestResponse(req, true);
@@ -286,12 +354,15 @@ namespace Ogre {
         {
                     OGRE_WQ_LOCK_MUTEX(mRequestMutex);
 
-            for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
+            for (size_t p = 0; p < PRIORITY_COUNT; ++p)
             {
-                if ((*i)->getID() == id)
+                for (RequestQueue::iterator i = mRequestQueues[p].begin(); i != mRequestQueues[p].end(); ++i)
                 {
-                    (*i)->abortRequest();
-                    break;
+                    if ((*i)->getID() == id)
+                    {
+                        (*i)->abortRequest();
+                        break;
+                    }
                 }
             }
         }
@@ -338,11 +409,14 @@ namespace Ogre {
         {
                     OGRE_WQ_LOCK_MUTEX(mRequestMutex);
 
-            for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
+            for (size_t p = 0; p < PRIORITY_COUNT; ++p)
             {
-                if ((*i)->getChannel() == channel)
+                for (RequestQueue::iterator i = mRequestQueues[p].begin(); i != mRequestQueues[p].end(); ++i)
                 {
-                    (*i)->abortRequest();
+                    if ((*i)->getChannel() == channel)
+                    {
+                        (*i)->abortRequest();
+                    }
                 }
             }
         }
@@ -380,11 +454,14 @@ namespace Ogre {
     {
         {
                     OGRE_WQ_LOCK_MUTEX(mRequestMutex);
-            for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
+            for (size_t p = 0; p < PRIORITY_COUNT; ++p)
             {
-                if ((*i)->getChannel() == channel)
+                for (RequestQueue::iterator i = mRequestQueues[p].begin(); i != mRequestQueues[p].end(); ++i)
                 {
-                    (*i)->abortRequest();
+                    if ((*i)->getChannel() == channel)
+                    {
+                        (*i)->abortRequest();
+                    }
                 }
             }
         }
@@ -415,9 +492,12 @@ namespace Ogre {
         {
                     OGRE_WQ_LOCK_MUTEX(mRequestMutex);
 
-            for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
+            for (size_t p = 0; p < PRIORITY_COUNT; ++p)
             {
-                (*i)->abortRequest();
+                for (RequestQueue::iterator i = mRequestQueues[p].begin(); i != mRequestQueues[p].end(); ++i)
+                {
+                    (*i)->abortRequest();
+                }
             }
         }
 
@@ -447,6 +527,131 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::promoteRequest(RequestID id)
+    {
+            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+
+        for (size_t p = 0; p < PRIORITY_COUNT; ++p)
+        {
+            RequestQueue& requests = mRequestQueues[p];
+            for (RequestQueue::iterator i = requests.begin(); i != requests.end(); ++i)
+            {
+                if ((*i)->getID() == id)
+                {
+                    Request* req = *i;
+                    requests.erase(i);
+                    mRequestQueues[PRIORITY_HIGH].push_front(req);
+                    return;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::setChannelPriority(uint16 channel, Priority priority)
+    {
+        OGRE_WQ_LOCK_RW_MUTEX_WRITE(mChannelPriorityMutex);
+        mChannelPriorities[channel] = priority;
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::Priority DefaultWorkQueueBase::getChannelPriority(uint16 channel) const
+    {
+        OGRE_WQ_LOCK_RW_MUTEX_READ(mChannelPriorityMutex);
+        ChannelPriorityMap::const_iterator i = mChannelPriorities.find(channel);
+        return i != mChannelPriorities.end() ? i->second : PRIORITY_NORMAL;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::setChannelWorkerLimit(uint16 channel, size_t limit)
+    {
+        {
+            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+            mChannelStates[channel].workerLimit = limit;
+        }
+        // a raised limit may let held back requests run
+        if (mIsRunning)
+            notifyWorkers();
+    }
+    //---------------------------------------------------------------------
+    size_t DefaultWorkQueueBase::getChannelWorkerLimit(uint16 channel) const
+    {
+        OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+        ChannelStateMap::const_iterator i = mChannelStates.find(channel);
+        return i != mChannelStates.end() ? i->second.workerLimit : 0;
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::ChannelStatistics DefaultWorkQueueBase::getChannelStatistics(uint16 channel) const
+    {
+        OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+        ChannelStateMap::const_iterator i = mChannelStates.find(channel);
+        return i != mChannelStates.end() ? i->second.stats : ChannelStatistics();
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::resetChannelStatistics()
+    {
+        OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+        for (ChannelStateMap::iterator i = mChannelStates.begin(); i != mChannelStates.end(); ++i)
+        {
+            // the queue depths are current, not accumulated
+            ChannelStatistics& stats = i->second.stats;
+            stats.processed = 0;
+            stats.totalWaitTime = 0;
+            stats.maxWaitTime = 0;
+            stats.totalProcessTime = 0;
+        }
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::pushRequest(Request* r)
+    {
+        r->mQueueTime = getCurrentTime();
+        ++mChannelStates[r->getChannel()].stats.pending;
+        mRequestQueues[getChannelPriority(r->getChannel())].push_back(r);
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Request* DefaultWorkQueueBase::popRequest()
+    {
+        for (size_t p = 0; p < PRIORITY_COUNT; ++p)
+        {
+            RequestQueue& requests = mRequestQueues[p];
+            for (RequestQueue::iterator i = requests.begin(); i != requests.end(); ++i)
+            {
+                Request* req = *i;
+                if (isChannelAtLimit(req->getChannel()))
+                    continue;
+
+                requests.erase(i);
+
+                ChannelStatistics& stats = mChannelStates[req->getChannel()].stats;
+                unsigned long waitTime = getCurrentTime() - req->mQueueTime;
+                --stats.pending;
+                ++stats.active;
+                stats.totalWaitTime += waitTime;
+                stats.maxWaitTime = std::max(stats.maxWaitTime, waitTime);
+                return req;
+            }
+        }
+        return 0;
+    }
+    //---------------------------------------------------------------------
+    bool DefaultWorkQueueBase::hasRunnableRequest() const
+    {
+        for (size_t p = 0; p < PRIORITY_COUNT; ++p)
+        {
+            const RequestQueue& requests = mRequestQueues[p];
+            for (RequestQueue::const_iterator i = requests.begin(); i != requests.end(); ++i)
+            {
+                if (!isChannelAtLimit((*i)->getChannel()))
+                    return true;
+            }
+        }
+        return false;
+    }
+    //---------------------------------------------------------------------
+    bool DefaultWorkQueueBase::isChannelAtLimit(uint16 channel) const
+    {
+        ChannelStateMap::const_iterator i = mChannelStates.find(channel);
+        return i != mChannelStates.end() && i->second.workerLimit && 
+            i->second.stats.active >= i->second.workerLimit;
+    }
+    //---------------------------------------------------------------------
     void DefaultWorkQueueBase::setPaused(bool pause)
     {
             OGRE_WQ_LOCK_MUTEX(mRequestMutex);
@@ -484,10 +689,9 @@ namespace Ogre {
             {
                             OGRE_WQ_LOCK_MUTEX(mRequestMutex);
 
-                if (!mRequestQueue.empty())
+                request = popRequest();
+                if (request)
                 {
-                    request = mRequestQueue.front();
-                    mRequestQueue.pop_front();
                     mProcessQueue.push_back( request );
                 }
             }
@@ -495,7 +699,24 @@ namespace Ogre {
 
         if (request)
         {
+            // the request may be gone after processing
+            uint16 channel = request->getChannel();
+            unsigned long start = getCurrentTime();
+
             processRequestResponse(request, false);
+
+            bool limited = false;
+            {
+                OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+                ChannelState& state = mChannelStates[channel];
+                --state.stats.active;
+                ++state.stats.processed;
+                state.stats.totalProcessTime += getCurrentTime() - start;
+                limited = state.workerLimit != 0;
+            }
+            // requests of the channel may have been held back by its limit
+            if (limited)
+                notifyWorkers();
         }
 
 
@@ -540,6 +761,11 @@ namespace Ogre {
                 processResponse(response);
                 OGRE_DELETE response;
             }
+            else if (canProcessResponseOnWorker(response))
+            {
+                processResponse(response);
+                OGRE_DELETE response;
+            }
             else
             {
                 if( response->getRequest()->getAborted() )
@@ -567,6 +793,52 @@ namespace Ogre {
             OGRE_DELETE r;
         }
 
+    }
+    //---------------------------------------------------------------------
+    bool DefaultWorkQueueBase::canProcessResponseOnWorker(const Response* r) const
+    {
+        if (r->getRequest()->getAborted())
+            return false;
+
+        OGRE_WQ_LOCK_RW_MUTEX_READ(mResponseHandlerMutex);
+        ResponseHandlerListByChannel::const_iterator i = mResponseHandlers.find(r->getRequest()->getChannel());
+        if (i == mResponseHandlers.end() || i->second.empty())
+            return false;
+
+        const ResponseHandlerList& handlers = i->second;
+        for (ResponseHandlerList::const_iterator j = handlers.begin(); j != handlers.end(); ++j)
+        {
+            if (!(*j)->handlesResponsesOnWorker())
+                return false;
+        }
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::_processParallelJob(const ParallelJobPtr& job)
+    {
+#if OGRE_THREAD_SUPPORT
+        if (mIsRunning && mAcceptRequests && !mShuttingDown && job->getChunkCount() > 1)
+        {
+            // the calling thread takes a share of the chunks as well
+            size_t helpers = std::min(job->getChunkCount() - 1, mWorkerThreadCount);
+            for (size_t i = 0; i < helpers; ++i)
+                addRequest(mParallelJobChannel, 0, Any(ParallelJobRequest(job)));
+        }
+#endif
+        job->process();
+        job->wait();
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::_startParallelJob(const ParallelJobPtr& job)
+    {
+#if OGRE_THREAD_SUPPORT
+        if (mIsRunning && mAcceptRequests && !mShuttingDown)
+        {
+            size_t helpers = std::min(job->getChunkCount(), mWorkerThreadCount);
+            for (size_t i = 0; i < helpers; ++i)
+                addRequest(mParallelJobChannel, 0, Any(ParallelJobRequest(job)));
+        }
+#endif
     }
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::processResponses() 
@@ -610,43 +882,47 @@ namespace Ogre {
     //---------------------------------------------------------------------
     WorkQueue::Response* DefaultWorkQueueBase::processRequest(Request* r)
     {
-        RequestHandlerListByChannel handlerListCopy;
+        // recorded into the buffer of the worker thread running the request
+        OgreProfileScopeGroup("WorkQueue::processRequest", OGREPROF_GENERAL);
+
+        RequestHandlerList handlers;
         {
-            // lock the list only to make a copy of it, to maximise parallelism
+            // lock the list only to copy the handlers of the channel, to maximise parallelism
                     OGRE_WQ_LOCK_RW_MUTEX_READ(mRequestHandlerMutex);
             
-            handlerListCopy = mRequestHandlers;
-            
+            RequestHandlerListByChannel::iterator i = mRequestHandlers.find(r->getChannel());
+            if (i != mRequestHandlers.end())
+                handlers = i->second;
         }
 
         Response* response = 0;
 
+        bool logged = isTrivialLogged();
         StringStream dbgMsg;
-        dbgMsg <<
-            "main"
-            << "): ID=" << r->getID() << " channel=" << r->getChannel() 
-            << " requestType=" << r->getType();
+        if (logged)
+        {
+            dbgMsg <<
+                "main"
+                << "): ID=" << r->getID() << " channel=" << r->getChannel() 
+                << " requestType=" << r->getType();
 
-        LogManager::getSingleton().stream(LML_TRIVIAL) << 
-            "DefaultWorkQueueBase('" << mName << "') - PROCESS_REQUEST_START(" << dbgMsg.str();
+            LogManager::getSingleton().stream(LML_TRIVIAL) << 
+                "DefaultWorkQueueBase('" << mName << "') - PROCESS_REQUEST_START(" << dbgMsg.str();
+        }
 
-        RequestHandlerListByChannel::iterator i = handlerListCopy.find(r->getChannel());
-        if (i != handlerListCopy.end())
+        for (RequestHandlerList::reverse_iterator j = handlers.rbegin(); j != handlers.rend(); ++j)
         {
-            RequestHandlerList& handlers = i->second;
-            for (RequestHandlerList::reverse_iterator j = handlers.rbegin(); j != handlers.rend(); ++j)
-            {
-                // threadsafe call which tests canHandleRequest and calls it if so 
-                response = (*j)->handleRequest(r, this);
+            // threadsafe call which tests canHandleRequest and calls it if so 
+            response = (*j)->handleRequest(r, this);
 
-                if (response)
-                    break;
-            }
+            if (response)
+                break;
         }
 
-        LogManager::getSingleton().stream(LML_TRIVIAL) << 
-            "DefaultWorkQueueBase('" << mName << "') - PROCESS_REQUEST_END(" << dbgMsg.str()
-            << " processed=" << (response!=0);
+        if (logged)
+            LogManager::getSingleton().stream(LML_TRIVIAL) << 
+                "DefaultWorkQueueBase('" << mName << "') - PROCESS_REQUEST_END(" << dbgMsg.str()
+                << " processed=" << (response!=0);
 
         return response;
 
@@ -654,16 +930,24 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::processResponse(Response* r)
     {
+        OgreProfileScopeGroup("WorkQueue::processResponse", OGREPROF_GENERAL);
+
+        bool logged = isTrivialLogged();
         StringStream dbgMsg;
-        dbgMsg << "thread:" <<
-            OGRE_THREAD_CURRENT_ID
-            << "): ID=" << r->getRequest()->getID()
-            << " success=" << r->succeeded() << " messages=[" << r->getMessages() << "] channel=" 
-            << r->getRequest()->getChannel() << " requestType=" << r->getRequest()->getType();
+        if (logged)
+        {
+            dbgMsg << "thread:" <<
+                OGRE_THREAD_CURRENT_ID
+                << "): ID=" << r->getRequest()->getID()
+                << " success=" << r->succeeded() << " messages=[" << r->getMessages() << "] channel=" 
+                << r->getRequest()->getChannel() << " requestType=" << r->getRequest()->getType();
 
-        LogManager::getSingleton().stream(LML_TRIVIAL) << 
-            "DefaultWorkQueueBase('" << mName << "') - PROCESS_RESPONSE_START(" << dbgMsg.str();
+            LogManager::getSingleton().stream(LML_TRIVIAL) << 
+                "DefaultWorkQueueBase('" << mName << "') - PROCESS_RESPONSE_START(" << dbgMsg.str();
+        }
 
+        // removeResponseHandler waits until no thread is inside one of the handlers
+        OGRE_WQ_LOCK_RW_MUTEX_READ(mResponseHandlerMutex);
         ResponseHandlerListByChannel::iterator i = mResponseHandlers.find(r->getRequest()->getChannel());
         if (i != mResponseHandlers.end())
         {
@@ -676,8 +960,9 @@ namespace Ogre {
                 }
             }
         }
-        LogManager::getSingleton().stream(LML_TRIVIAL) << 
-            "DefaultWorkQueueBase('" << mName << "') - PROCESS_RESPONSE_END(" << dbgMsg.str();
+        if (logged)
+            LogManager::getSingleton().stream(LML_TRIVIAL) << 
+                "DefaultWorkQueueBase('" << mName << "') - PROCESS_RESPONSE_END(" << dbgMsg.str();
 
     }
 
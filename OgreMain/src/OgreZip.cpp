@@ -36,6 +36,7 @@ THE SOFTWARE.
 
 #include <zzip/zzip.h>
 #include <zzip/plugin.h>
+#include <zlib.h>
 
 
 namespace Ogre {
@@ -335,6 +336,328 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    //  IndexedZipArchive
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    namespace {
+        const uint32 ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+        const uint32 ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+        const uint32 ZIP_END_OF_CENTRAL_DIR_SIGNATURE = 0x06054b50;
+        const size_t ZIP_LOCAL_HEADER_SIZE = 30;
+        const size_t ZIP_CENTRAL_HEADER_SIZE = 46;
+        const size_t ZIP_END_OF_CENTRAL_DIR_SIZE = 22;
+        const uint16 ZIP_METHOD_STORE = 0;
+        const uint16 ZIP_METHOD_DEFLATE = 8;
+
+        // zip headers are always little endian
+        uint16 readU16(const uchar* p)
+        {
+            return static_cast<uint16>(p[0] | (p[1] << 8));
+        }
+        uint32 readU32(const uchar* p)
+        {
+            return uint32(p[0]) | (uint32(p[1]) << 8) | (uint32(p[2]) << 16) | (uint32(p[3]) << 24);
+        }
+
+        /** Read-only view of memory owned by another stream, which is kept alive
+            for as long as the view exists.
+        */
+        class ZipEntryDataStream : public MemoryDataStream
+        {
+            DataStreamPtr mSource;
+        public:
+            ZipEntryDataStream(const String& name, const DataStreamPtr& source, uchar* data, size_t size)
+                : MemoryDataStream(name, data, size, false, true), mSource(source)
+            {
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
+    IndexedZipArchive::IndexedZipArchive(const String& name, const String& archType)
+        : ZipArchive(name, archType), mCacheSize(0), mCacheBudget(16 * 1024 * 1024)
+    {
+    }
+    //-----------------------------------------------------------------------
+    IndexedZipArchive::~IndexedZipArchive()
+    {
+        unload();
+    }
+    //-----------------------------------------------------------------------
+    void IndexedZipArchive::load()
+    {
+        OGRE_WQ_LOCK_MUTEX(mIndexMutex);
+        if (mArchiveData)
+            return;
+
+        std::ifstream file(mName.c_str(), std::ios::in | std::ios::binary);
+        if (!file)
+        {
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "Cannot open archive: " + mName,
+                "IndexedZipArchive::load");
+        }
+        file.seekg(0, std::ios::end);
+        size_t size = static_cast<size_t>(file.tellg());
+        if (size < ZIP_END_OF_CENTRAL_DIR_SIZE)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Not a zip archive: " + mName,
+                "IndexedZipArchive::load");
+        }
+#if OGRE_PLATFORM != OGRE_PLATFORM_WINRT
+        file.close();
+        mArchiveData = MemoryDataStreamPtr(OGRE_NEW MappedFileDataStream(mName, mName, size));
+#else
+        file.seekg(0, std::ios::beg);
+        mArchiveData = MemoryDataStreamPtr(OGRE_NEW MemoryDataStream(mName, size, true, true));
+        file.read(reinterpret_cast<char*>(mArchiveData->getPtr()), size);
+#endif
+
+        try
+        {
+            readCentralDirectory();
+        }
+        catch (Exception&)
+        {
+            mArchiveData.reset();
+            mFileList.clear();
+            mEntries.clear();
+            mEntryIndex.clear();
+            throw;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void IndexedZipArchive::readCentralDirectory()
+    {
+        const uchar* data = mArchiveData->getPtr();
+        size_t size = mArchiveData->size();
+
+        // the end of central directory record is followed by a comment of up to 64K
+        size_t eocd = size - ZIP_END_OF_CENTRAL_DIR_SIZE;
+        size_t searchEnd = eocd > 0xFFFF ? eocd - 0xFFFF : 0;
+        while (readU32(data + eocd) != ZIP_END_OF_CENTRAL_DIR_SIGNATURE)
+        {
+            if (eocd == searchEnd)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Not a zip archive: " + mName,
+                    "IndexedZipArchive::readCentralDirectory");
+            }
+            --eocd;
+        }
+
+        size_t numEntries = readU16(data + eocd + 10);
+        size_t dirOffset = readU32(data + eocd + 16);
+        if (numEntries == 0xFFFF || dirOffset == 0xFFFFFFFF)
+        {
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "Zip64 archives are not supported: " + mName,
+                "IndexedZipArchive::readCentralDirectory");
+        }
+
+        mFileList.reserve(numEntries);
+        mEntries.reserve(numEntries);
+        size_t pos = dirOffset;
+        for (size_t i = 0; i < numEntries; ++i)
+        {
+            if (pos + ZIP_CENTRAL_HEADER_SIZE > eocd || readU32(data + pos) != ZIP_CENTRAL_HEADER_SIGNATURE)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Corrupt central directory in " + mName,
+                    "IndexedZipArchive::readCentralDirectory");
+            }
+            const uchar* header = data + pos;
+            size_t nameLength = readU16(header + 28);
+            size_t headerLength = ZIP_CENTRAL_HEADER_SIZE + nameLength + readU16(header + 30) + readU16(header + 32);
+            size_t localOffset = readU32(header + 42);
+            if (pos + headerLength > eocd || localOffset + ZIP_LOCAL_HEADER_SIZE > dirOffset ||
+                readU32(data + localOffset) != ZIP_LOCAL_HEADER_SIGNATURE)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Corrupt central directory in " + mName,
+                    "IndexedZipArchive::readCentralDirectory");
+            }
+
+            Entry entry;
+            entry.method = readU16(header + 10);
+            entry.encrypted = (readU16(header + 8) & 1) != 0;
+            entry.compressedSize = readU32(header + 20);
+            entry.uncompressedSize = readU32(header + 24);
+            // the extra field of the local header may differ from the central one
+            const uchar* localHeader = data + localOffset;
+            entry.dataOffset = localOffset + ZIP_LOCAL_HEADER_SIZE + readU16(localHeader + 26) + readU16(localHeader + 28);
+            if (entry.dataOffset + entry.compressedSize > dirOffset)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Corrupt central directory in " + mName,
+                    "IndexedZipArchive::readCentralDirectory");
+            }
+
+            // same naming as ZipArchive
+            FileInfo info;
+            info.archive = this;
+            String name(reinterpret_cast<const char*>(header + ZIP_CENTRAL_HEADER_SIZE), nameLength);
+            StringUtil::splitFilename(name, info.basename, info.path);
+            info.filename = name;
+            info.compressedSize = entry.compressedSize;
+            info.uncompressedSize = entry.uncompressedSize;
+            // folder entries
+            if (info.basename.empty())
+            {
+                info.filename = info.filename.substr (0, info.filename.length () - 1);
+                StringUtil::splitFilename(info.filename, info.basename, info.path);
+                info.compressedSize = size_t (-1);
+            }
+#if !OGRE_RESOURCEMANAGER_STRICT
+            else
+            {
+                info.filename = info.basename;
+            }
+#endif
+            // the first of several files with the same name wins, as with zziplib
+            mEntryIndex.insert(EntryIndex::value_type(info.filename, mEntries.size()));
+            mFileList.push_back(info);
+            mEntries.push_back(entry);
+
+            pos += headerLength;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void IndexedZipArchive::unload()
+    {
+        OGRE_WQ_LOCK_MUTEX(mIndexMutex);
+        mCache.clear();
+        mCacheLRU.clear();
+        mCacheSize = 0;
+        mEntryIndex.clear();
+        mEntries.clear();
+        mFileList.clear();
+        // streams still open keep their own reference to the mapping
+        mArchiveData.reset();
+    }
+    //-----------------------------------------------------------------------
+    DataStreamPtr IndexedZipArchive::open(const String& filename, bool readOnly) const
+    {
+        String lookUpFileName = filename;
+#if !OGRE_RESOURCEMANAGER_STRICT
+        // names are indexed without their path
+        String path;
+        StringUtil::splitFilename(filename, lookUpFileName, path);
+#endif
+
+        Entry entry;
+        MemoryDataStreamPtr archiveData;
+        {
+            OGRE_WQ_LOCK_MUTEX(mIndexMutex);
+            EntryIndex::const_iterator it = mEntryIndex.find(lookUpFileName);
+            if (it == mEntryIndex.end())
+            {
+                OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                    mName + " Cannot open file: " + filename, "IndexedZipArchive::open");
+            }
+            entry = mEntries[it->second];
+            archiveData = mArchiveData;
+
+            CachedEntryMap::iterator ci = mCache.find(lookUpFileName);
+            if (ci != mCache.end())
+            {
+                mCacheLRU.splice(mCacheLRU.begin(), mCacheLRU, ci->second.lru);
+                const MemoryDataStreamPtr& data = ci->second.data;
+                // evicting the entry later does not invalidate the stream
+                return DataStreamPtr(OGRE_NEW ZipEntryDataStream(lookUpFileName, data,
+                    data->getPtr(), entry.uncompressedSize));
+            }
+        }
+
+        if (entry.encrypted ||
+            (entry.method != ZIP_METHOD_STORE && entry.method != ZIP_METHOD_DEFLATE))
+        {
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                mName + " Unsupported compression or encryption of file: " + filename,
+                "IndexedZipArchive::open");
+        }
+
+        if (entry.method == ZIP_METHOD_STORE)
+        {
+            // zero copy view of the mapped archive
+            return DataStreamPtr(OGRE_NEW ZipEntryDataStream(lookUpFileName, archiveData,
+                archiveData->getPtr() + entry.dataOffset, entry.uncompressedSize));
+        }
+
+        // Other threads may open entries meanwhile, the archive stays mapped for this one
+        MemoryDataStreamPtr data = inflateEntry(lookUpFileName, entry, archiveData);
+        {
+            OGRE_WQ_LOCK_MUTEX(mIndexMutex);
+            // Unless it was inflated by another thread too or the archive was reloaded
+            if (entry.uncompressedSize <= mCacheBudget && mArchiveData == archiveData &&
+                mCache.find(lookUpFileName) == mCache.end())
+            {
+                trimCache(mCacheBudget - entry.uncompressedSize);
+                mCacheLRU.push_front(lookUpFileName);
+                CachedEntry cached;
+                cached.data = data;
+                cached.lru = mCacheLRU.begin();
+                mCache.insert(CachedEntryMap::value_type(lookUpFileName, cached));
+                mCacheSize += entry.uncompressedSize;
+            }
+        }
+
+        // evicting the entry later does not invalidate the stream
+        return DataStreamPtr(OGRE_NEW ZipEntryDataStream(lookUpFileName, data,
+            data->getPtr(), entry.uncompressedSize));
+    }
+    //-----------------------------------------------------------------------
+    MemoryDataStreamPtr IndexedZipArchive::inflateEntry(const String& filename, const Entry& entry,
+        const MemoryDataStreamPtr& archiveData) const
+    {
+        MemoryDataStreamPtr data(OGRE_NEW MemoryDataStream(filename, entry.uncompressedSize, true, true));
+        if (entry.uncompressedSize == 0)
+            return data;
+
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        // raw deflate data, without zlib header
+        int ret = inflateInit2(&zs, -MAX_WBITS);
+        if (ret == Z_OK)
+        {
+            zs.next_in = archiveData->getPtr() + entry.dataOffset;
+            zs.avail_in = static_cast<uInt>(entry.compressedSize);
+            zs.next_out = data->getPtr();
+            zs.avail_out = static_cast<uInt>(entry.uncompressedSize);
+            ret = inflate(&zs, Z_FINISH);
+            inflateEnd(&zs);
+        }
+        if (ret != Z_STREAM_END || zs.total_out != entry.uncompressedSize)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                mName + " Error inflating file: " + filename, "IndexedZipArchive::inflateEntry");
+        }
+        return data;
+    }
+    //-----------------------------------------------------------------------
+    void IndexedZipArchive::trimCache(size_t size) const
+    {
+        while (mCacheSize > size)
+        {
+            CachedEntryMap::iterator ci = mCache.find(mCacheLRU.back());
+            mCacheSize -= ci->second.data->size();
+            mCache.erase(ci);
+            mCacheLRU.pop_back();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void IndexedZipArchive::setCacheBudget(size_t bytes)
+    {
+        OGRE_WQ_LOCK_MUTEX(mIndexMutex);
+        mCacheBudget = bytes;
+        trimCache(mCacheBudget);
+    }
+    //-----------------------------------------------------------------------
+    bool IndexedZipArchive::exists(const String& filename) const
+    {
+        OGRE_WQ_LOCK_MUTEX(mIndexMutex);
+        String cleanName = filename;
+#if !OGRE_RESOURCEMANAGER_STRICT
+        String path;
+        StringUtil::splitFilename(filename, cleanName, path);
+#endif
+        return mEntryIndex.find(cleanName) != mEntryIndex.end();
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ZipDataStream::ZipDataStream(ZZIP_FILE* zzipFile, size_t uncompressedSize)
         : mZzipFile(zzipFile)
@@ -443,6 +766,12 @@ namespace Ogre {
         return name;
     }
     //-----------------------------------------------------------------------
+    const String& IndexedZipArchiveFactory::getType(void) const
+    {
+        static String name = "IndexedZip";
+        return name;
+    }
+    //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     //  EmbeddedZipArchiveFactory
     //-----------------------------------------------------------------------
@@ -0,0 +1,244 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "Threading/OgreParallel.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+
+namespace Ogre
+{
+    //---------------------------------------------------------------------
+    ParallelJob::ParallelJob(size_t count, size_t grainSize)
+        : mCount(count)
+        , mGrainSize(grainSize ? grainSize : 1)
+        , mNext(0)
+        , mDone(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    void ParallelJob::process()
+    {
+        for (size_t begin = (mNext += mGrainSize) - mGrainSize; begin < mCount;
+             begin = (mNext += mGrainSize) - mGrainSize)
+        {
+            size_t end = std::min(begin + mGrainSize, mCount);
+            execute(begin, end);
+            mDone += end - begin;
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParallelJob::wait()
+    {
+        while (!isComplete())
+        {
+            OGRE_WQ_THREAD_YIELD;
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParallelJob::run(const ParallelJobPtr& job)
+    {
+        Root* root = Root::getSingletonPtr();
+        WorkQueue* queue = root ? root->getWorkQueue() : 0;
+        if (queue)
+        {
+            queue->_processParallelJob(job);
+        }
+        else
+        {
+            job->process();
+        }
+    }
+    //---------------------------------------------------------------------
+    void ParallelJob::start(const ParallelJobPtr& job)
+    {
+        Root* root = Root::getSingletonPtr();
+        WorkQueue* queue = root ? root->getWorkQueue() : 0;
+        if (queue)
+        {
+            queue->_startParallelJob(job);
+        }
+    }
+    //---------------------------------------------------------------------
+    namespace
+    {
+        /** Runs the tasks of a graph, one item per task.
+        @remarks
+            An item does not stand for a particular task, the thread claiming it takes
+            the next task whose dependencies are complete, waiting for one if needed.
+            As the graph has no cycles, a task becomes ready whenever all running ones
+            are waiting, so this cannot deadlock.
+        */
+        class TaskGraphJob : public ParallelJob
+        {
+        public:
+            TaskGraphJob(size_t count) : ParallelJob(count) {}
+
+            /// Tasks of the graph and their state
+            vector<TaskGraph::Task*>::type tasks;
+            vector<const vector<TaskGraph::TaskID>::type*>::type dependents;
+            /// Remaining dependencies of each task, guarded by the ready mutex
+            vector<size_t>::type remaining;
+
+            void push(TaskGraph::TaskID id)
+            {
+                OGRE_WQ_LOCK_MUTEX(mReadyMutex);
+                mReady.push_back(id);
+            }
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    TaskGraph::TaskID id = pop();
+                    tasks[id]->execute();
+
+                    const vector<TaskGraph::TaskID>::type& next = *dependents[id];
+                    OGRE_WQ_LOCK_MUTEX(mReadyMutex);
+                    for (size_t d = 0; d < next.size(); ++d)
+                    {
+                        if (--remaining[next[d]] == 0)
+                            mReady.push_back(next[d]);
+                    }
+                }
+            }
+
+        protected:
+            vector<TaskGraph::TaskID>::type mReady;
+            OGRE_WQ_MUTEX(mReadyMutex);
+
+            TaskGraph::TaskID pop()
+            {
+                while (true)
+                {
+                    {
+                        OGRE_WQ_LOCK_MUTEX(mReadyMutex);
+                        if (!mReady.empty())
+                        {
+                            TaskGraph::TaskID id = mReady.back();
+                            mReady.pop_back();
+                            return id;
+                        }
+                    }
+                    OGRE_WQ_THREAD_YIELD;
+                }
+            }
+        };
+    }
+    //---------------------------------------------------------------------
+    TaskGraph::TaskGraph()
+    {
+    }
+    //---------------------------------------------------------------------
+    TaskGraph::~TaskGraph()
+    {
+    }
+    //---------------------------------------------------------------------
+    TaskGraph::TaskID TaskGraph::addTask(Task* task)
+    {
+        mTasks.push_back(Node(task));
+        return mTasks.size() - 1;
+    }
+    //---------------------------------------------------------------------
+    void TaskGraph::addDependency(TaskID task, TaskID dependency)
+    {
+        if (task >= mTasks.size() || dependency >= mTasks.size())
+        {
+            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Unknown task",
+                "TaskGraph::addDependency");
+        }
+        mTasks[dependency].dependents.push_back(task);
+        ++mTasks[task].dependencyCount;
+    }
+    //---------------------------------------------------------------------
+    void TaskGraph::clear()
+    {
+        mTasks.clear();
+    }
+    //---------------------------------------------------------------------
+    void TaskGraph::sortTasks(vector<TaskID>::type& order) const
+    {
+        vector<size_t>::type remaining(mTasks.size());
+        order.clear();
+        order.reserve(mTasks.size());
+        for (TaskID i = 0; i < mTasks.size(); ++i)
+        {
+            remaining[i] = mTasks[i].dependencyCount;
+            if (!remaining[i])
+                order.push_back(i);
+        }
+
+        // the order list doubles as the queue of tasks whose dependencies are sorted
+        for (size_t next = 0; next < order.size(); ++next)
+        {
+            const vector<TaskID>::type& dependents = mTasks[order[next]].dependents;
+            for (size_t d = 0; d < dependents.size(); ++d)
+            {
+                if (--remaining[dependents[d]] == 0)
+                    order.push_back(dependents[d]);
+            }
+        }
+
+        if (order.size() != mTasks.size())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "The task dependencies form a cycle",
+                "TaskGraph::run");
+        }
+    }
+    //---------------------------------------------------------------------
+    void TaskGraph::run()
+    {
+        vector<TaskID>::type order;
+        sortTasks(order);
+
+#if OGRE_THREAD_SUPPORT
+        if (mTasks.size() > 1)
+        {
+            TaskGraphJob* job = OGRE_NEW TaskGraphJob(mTasks.size());
+            ParallelJobPtr jobPtr(job);
+            job->tasks.reserve(mTasks.size());
+            job->dependents.reserve(mTasks.size());
+            job->remaining.resize(mTasks.size());
+            for (TaskID i = 0; i < mTasks.size(); ++i)
+            {
+                job->tasks.push_back(mTasks[i].task);
+                job->dependents.push_back(&mTasks[i].dependents);
+                job->remaining[i] = mTasks[i].dependencyCount;
+                if (!mTasks[i].dependencyCount)
+                    job->push(i);
+            }
+            ParallelJob::run(jobPtr);
+            return;
+        }
+#endif
+
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            mTasks[order[i]].task->execute();
+        }
+    }
+}
@@ -0,0 +1,648 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "Threading/OgreWorkStealingQueue.h"
+#include "OgreLogManager.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Matches requests by ID
+        struct RequestIDIs
+        {
+            WorkQueue::RequestID id;
+            RequestIDIs(WorkQueue::RequestID i) : id(i) {}
+            bool operator()(const WorkQueue::Request* r) const { return r->getID() == id; }
+        };
+
+        /// Matches requests by channel
+        struct RequestChannelIs
+        {
+            uint16 channel;
+            RequestChannelIs(uint16 c) : channel(c) {}
+            bool operator()(const WorkQueue::Request* r) const { return r->getChannel() == channel; }
+        };
+
+        /// Matches all requests
+        struct AnyRequest
+        {
+            bool operator()(const WorkQueue::Request*) const { return true; }
+        };
+
+        /// Helps processing a parallel job, the job outlives it as join waits for it
+        struct ParallelJobTask : public WorkStealingQueue::Task
+        {
+            ParallelJob* job;
+
+            ParallelJobTask(ParallelJob* j) : job(j) {}
+
+            void execute() { job->process(); }
+        };
+    }
+    //---------------------------------------------------------------------
+    WorkStealingQueue::WorkStealingQueue(const String& name)
+        : DefaultWorkQueueBase(name)
+        , mPendingCount(0)
+        , mBaseSignals(0)
+        , mSleepingCount(0)
+        , mNextWorker(0)
+        , mNextWorkerIndex(0)
+        , mNextRequestID(0)
+        , mNumThreadsRegistered(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    WorkStealingQueue::~WorkStealingQueue()
+    {
+        shutdown();
+    }
+    //---------------------------------------------------------------------
+    WorkStealingQueue* WorkStealingQueue::getRootQueue()
+    {
+        Root* root = Root::getSingletonPtr();
+        return root ? dynamic_cast<WorkStealingQueue*>(root->getWorkQueue()) : 0;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::startup(bool forceRestart)
+    {
+        if (mIsRunning)
+        {
+            if (forceRestart)
+                shutdown();
+            else
+                return;
+        }
+
+        mShuttingDown = false;
+
+        mWorkerFunc = OGRE_NEW_T(WorkerFunc(this), MEMCATEGORY_GENERAL);
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingQueue('" << mName << "') initialising on thread " <<
+            OGRE_THREAD_CURRENT_ID
+            << ".";
+
+#if OGRE_THREAD_SUPPORT
+        if (mWorkerRenderSystemAccess)
+            Root::getSingleton().getRenderSystem()->preExtraThreadsStarted();
+
+        // all queues exist before any thread starts, so threads may post to each other
+        for (size_t i = 0; i < mWorkerThreadCount; ++i)
+            mWorkers.push_back(OGRE_NEW Worker());
+
+        mNumThreadsRegistered = 0;
+        mNextWorkerIndex.store(0);
+        for (size_t i = 0; i < mWorkerThreadCount; ++i)
+        {
+            OGRE_THREAD_CREATE(t, *mWorkerFunc);
+            mWorkers[i]->thread = t;
+        }
+
+        {
+            OGRE_WQ_LOCK_MUTEX_NAMED(mInitMutex, initLock);
+            // wait until all threads know their worker, and are registered with the
+            // render system if required
+            while (mNumThreadsRegistered < mWorkerThreadCount)
+                OGRE_THREAD_WAIT(mInitSync, mInitMutex, initLock);
+        }
+
+        if (mWorkerRenderSystemAccess)
+            Root::getSingleton().getRenderSystem()->postExtraThreadsStarted();
+#endif
+
+        mIsRunning = true;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::shutdown()
+    {
+        if( !mIsRunning )
+            return;
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingQueue('" << mName << "') shutting down on thread " <<
+            OGRE_THREAD_CURRENT_ID
+            << ".";
+
+        mShuttingDown = true;
+        abortAllRequests();
+#if OGRE_THREAD_SUPPORT
+        {
+            // wake all threads (they check shutting down as first thing after wait)
+            OGRE_WQ_LOCK_MUTEX(mWakeMutex);
+            OGRE_THREAD_NOTIFY_ALL(mWakeCondition);
+        }
+
+        for (WorkerList::iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
+        {
+            (*i)->thread->join();
+            OGRE_THREAD_DESTROY((*i)->thread);
+        }
+
+        // requests left in the queues were aborted above
+        for (WorkerList::iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
+        {
+            for (size_t p = 0; p < PRIORITY_COUNT; ++p)
+            {
+                RequestQueue& requests = (*i)->requests[p];
+                for (RequestQueue::iterator r = requests.begin(); r != requests.end(); ++r)
+                    OGRE_DELETE *r;
+            }
+            OGRE_DELETE *i;
+        }
+        mWorkers.clear();
+        mPendingCount.store(0);
+#endif
+
+        OGRE_DELETE_T(mWorkerFunc, WorkerFunc, MEMCATEGORY_GENERAL);
+        mWorkerFunc = 0;
+
+        mIsRunning = false;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::_threadMain()
+    {
+#if OGRE_THREAD_SUPPORT
+        Worker* self = mWorkers[mNextWorkerIndex++];
+        self->threadId = OGRE_THREAD_CURRENT_ID;
+
+        LogManager::getSingleton().stream() << 
+            "WorkStealingQueue('" << getName() << "')::WorkerFunc - thread " 
+            << self->threadId << " starting.";
+
+        // Initialise the thread for RS if necessary
+        if (mWorkerRenderSystemAccess)
+            Root::getSingleton().getRenderSystem()->registerThread();
+
+        {
+            OGRE_WQ_LOCK_MUTEX(mInitMutex);
+            ++mNumThreadsRegistered;
+            OGRE_THREAD_NOTIFY_ALL(mInitSync);
+        }
+
+        while (waitForWork())
+        {
+            QueuedTask task;
+            if (takeTask(self, task))
+            {
+                runTask(task);
+                continue;
+            }
+
+            // idle requests and retries are queued by the base class
+            size_t signals = mBaseSignals.load();
+            while (signals && !mBaseSignals.compare_exchange_strong(signals, signals - 1))
+                signals = mBaseSignals.load();
+            if (signals)
+            {
+                DefaultWorkQueueBase::_processNextRequest();
+                continue;
+            }
+
+            if (Request* r = takeRequest(self))
+                processWorkerRequest(self, r);
+        }
+
+        LogManager::getSingleton().stream() << 
+            "WorkStealingQueue('" << getName() << "')::WorkerFunc - thread " 
+            << self->threadId << " stopped.";
+#endif
+    }
+    //---------------------------------------------------------------------
+    bool WorkStealingQueue::waitForWork()
+    {
+#if OGRE_THREAD_SUPPORT
+        if (isShuttingDown())
+            return false;
+        if (mPendingCount.load() || mBaseSignals.load())
+            return true;
+
+        // announce sleeping before checking for work, so a thread adding work
+        // either sees a sleeper to wake, or its work is seen here
+        ++mSleepingCount;
+        {
+            OGRE_WQ_LOCK_MUTEX_NAMED(mWakeMutex, wakeLock);
+            while (!isShuttingDown() && !mPendingCount.load() && !mBaseSignals.load())
+                OGRE_THREAD_WAIT(mWakeCondition, mWakeMutex, wakeLock);
+        }
+        --mSleepingCount;
+
+        return !isShuttingDown();
+#else
+        return false;
+#endif
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::wakeWorker()
+    {
+        if (mSleepingCount.load())
+        {
+            OGRE_WQ_LOCK_MUTEX(mWakeMutex);
+            OGRE_THREAD_NOTIFY_ONE(mWakeCondition);
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::notifyWorkers()
+    {
+        ++mBaseSignals;
+        wakeWorker();
+    }
+    //---------------------------------------------------------------------
+    WorkStealingQueue::Worker* WorkStealingQueue::getCurrentWorker() const
+    {
+#if OGRE_THREAD_SUPPORT
+        OGRE_WQ_THREAD_ID_TYPE id = OGRE_THREAD_CURRENT_ID;
+        for (WorkerList::const_iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
+        {
+            if ((*i)->threadId == id)
+                return *i;
+        }
+#endif
+        return 0;
+    }
+    //---------------------------------------------------------------------
+    WorkStealingQueue::Worker* WorkStealingQueue::getTargetWorker()
+    {
+        Worker* self = getCurrentWorker();
+        return self ? self : mWorkers[mNextWorker++ % mWorkers.size()];
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::RequestID WorkStealingQueue::addRequest(uint16 channel, uint16 requestType, 
+        const Any& rData, uint8 retryCount, bool forceSynchronous, bool idleThread)
+    {
+        if (!mAcceptRequests || mShuttingDown)
+            return 0;
+
+        RequestID rid = ++mNextRequestID;
+        Request* req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid);
+
+#if OGRE_THREAD_SUPPORT
+        if (!mWorkers.empty() && idleThread && !forceSynchronous)
+        {
+            OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+            mIdleRequestQueue.push_back(req);
+            if (!mIdleThreadRunning)
+                notifyWorkers();
+            return rid;
+        }
+
+        if (!mWorkers.empty() && !forceSynchronous)
+        {
+            queueRequest(req);
+            return rid;
+        }
+#endif
+
+        processRequestResponse(req, true);
+        return rid;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::queueRequest(Request* r)
+    {
+        Priority priority = getChannelPriority(r->getChannel());
+        Worker* worker = getTargetWorker();
+        {
+            OGRE_WQ_LOCK_MUTEX(worker->mutex);
+            worker->requests[priority].push_back(r);
+        }
+        ++mPendingCount;
+        wakeWorker();
+    }
+    //---------------------------------------------------------------------
+    bool WorkStealingQueue::takeTask(Worker* self, QueuedTask& task)
+    {
+        if (self)
+        {
+            OGRE_WQ_LOCK_MUTEX(self->mutex);
+            if (!self->tasks.empty())
+            {
+                // newest first, it's likely to share data with the running task
+                task = self->tasks.back();
+                self->tasks.pop_back();
+                --mPendingCount;
+                return true;
+            }
+        }
+
+        // steal starting after our own position, so thieves spread over the victims
+        size_t count = mWorkers.size();
+        size_t start = 0;
+        while (self && start < count && mWorkers[start] != self)
+            ++start;
+        for (size_t i = 1; i <= count; ++i)
+        {
+            Worker* victim = mWorkers[(start + i) % count];
+            if (victim == self)
+                continue;
+
+            OGRE_WQ_LOCK_MUTEX(victim->mutex);
+            if (!victim->tasks.empty())
+            {
+                // oldest first, it's likely to be the largest piece of work left
+                task = victim->tasks.front();
+                victim->tasks.pop_front();
+                --mPendingCount;
+                return true;
+            }
+        }
+        return false;
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Request* WorkStealingQueue::takeRequest(Worker* self)
+    {
+        size_t count = mWorkers.size();
+        for (size_t p = 0; p < PRIORITY_COUNT; ++p)
+        {
+            // own queue first, then the others in order
+            {
+                OGRE_WQ_LOCK_MUTEX(self->mutex);
+                RequestQueue& requests = self->requests[p];
+                if (!requests.empty())
+                {
+                    Request* r = requests.front();
+                    requests.pop_front();
+                    self->current = r;
+                    --mPendingCount;
+                    return r;
+                }
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                Worker* victim = mWorkers[i];
+                if (victim == self)
+                    continue;
+
+                Request* r = 0;
+                {
+                    OGRE_WQ_LOCK_MUTEX(victim->mutex);
+                    RequestQueue& requests = victim->requests[p];
+                    if (!requests.empty())
+                    {
+                        r = requests.front();
+                        requests.pop_front();
+                    }
+                }
+
+                if (r)
+                {
+                    // not locking both workers at once, nobody can abort r in between
+                    // as it's in neither queue; abort flags it once it is current
+                    OGRE_WQ_LOCK_MUTEX(self->mutex);
+                    self->current = r;
+                    --mPendingCount;
+                    return r;
+                }
+            }
+        }
+        return 0;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::processWorkerRequest(Worker* worker, Request* r)
+    {
+        RequestHandlerList handlers;
+        {
+            // copy the handlers of the channel only, to maximise parallelism
+            OGRE_WQ_LOCK_RW_MUTEX_READ(mRequestHandlerMutex);
+            RequestHandlerListByChannel::iterator i = mRequestHandlers.find(r->getChannel());
+            if (i != mRequestHandlers.end())
+                handlers = i->second;
+        }
+
+        Response* response = 0;
+        for (RequestHandlerList::reverse_iterator j = handlers.rbegin(); j != handlers.rend(); ++j)
+        {
+            // threadsafe call which tests canHandleRequest and calls it if so 
+            response = (*j)->handleRequest(r, this);
+
+            if (response)
+                break;
+        }
+
+        if (response && !response->succeeded() && r->getRetryCount())
+        {
+            // retry on this worker, keeping the ID
+            Request* retry = OGRE_NEW Request(r->getChannel(), r->getType(), r->getData(),
+                r->getRetryCount() - 1, r->getID());
+            {
+                OGRE_WQ_LOCK_MUTEX(worker->mutex);
+                worker->current = 0;
+            }
+            // discard response (this also deletes request)
+            OGRE_DELETE response;
+            if (!mShuttingDown)
+                queueRequest(retry);
+            else
+                OGRE_DELETE retry;
+            return;
+        }
+
+        if (response && canProcessResponseOnWorker(response))
+        {
+            // the handlers take the response here, there is nothing left to abort
+            {
+                OGRE_WQ_LOCK_MUTEX(worker->mutex);
+                worker->current = 0;
+            }
+            processResponse(response);
+            OGRE_DELETE response;
+            return;
+        }
+
+        // clear current and queue the response at once, so an abort finds the
+        // request in one of both places
+        OGRE_WQ_LOCK_MUTEX(worker->mutex);
+        worker->current = 0;
+
+        if (response)
+        {
+            if (r->getAborted())
+            {
+                // destroy response user data
+                response->abortRequest();
+            }
+            // Queue response
+            OGRE_WQ_LOCK_MUTEX(mResponseMutex);
+            mResponseQueue.push_back(response);
+        }
+        else
+        {
+            if (!r->getAborted())
+            {
+                LogManager::getSingleton().stream() << 
+                    "WorkStealingQueue('" << mName << "') warning: no handler processed request "
+                    << r->getID() << ", channel " << r->getChannel()
+                    << ", type " << r->getType();
+            }
+            OGRE_DELETE r;
+        }
+    }
+    //---------------------------------------------------------------------
+    template <typename Pred> void WorkStealingQueue::abortWorkerRequests(Pred pred)
+    {
+        for (WorkerList::iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
+        {
+            Worker* worker = *i;
+            OGRE_WQ_LOCK_MUTEX(worker->mutex);
+            if (worker->current && pred(worker->current))
+                worker->current->abortRequest();
+
+            for (size_t p = 0; p < PRIORITY_COUNT; ++p)
+            {
+                RequestQueue& requests = worker->requests[p];
+                for (RequestQueue::iterator r = requests.begin(); r != requests.end(); ++r)
+                {
+                    if (pred(*r))
+                        (*r)->abortRequest();
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::abortRequest(RequestID id)
+    {
+        // the workers come first: a request leaving them is in the response
+        // queue by then, which the base class checks
+        abortWorkerRequests(RequestIDIs(id));
+        DefaultWorkQueueBase::abortRequest(id);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::promoteRequest(RequestID id)
+    {
+        for (WorkerList::iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
+        {
+            Worker* worker = *i;
+            OGRE_WQ_LOCK_MUTEX(worker->mutex);
+            for (size_t p = 0; p < PRIORITY_COUNT; ++p)
+            {
+                RequestQueue& requests = worker->requests[p];
+                for (RequestQueue::iterator r = requests.begin(); r != requests.end(); ++r)
+                {
+                    if ((*r)->getID() == id)
+                    {
+                        Request* req = *r;
+                        requests.erase(r);
+                        worker->requests[PRIORITY_HIGH].push_front(req);
+                        return;
+                    }
+                }
+            }
+        }
+        // the queues of the base class only ever hold idle requests, which are
+        // processed in order
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::abortRequestsByChannel(uint16 channel)
+    {
+        abortWorkerRequests(RequestChannelIs(channel));
+        DefaultWorkQueueBase::abortRequestsByChannel(channel);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::abortPendingRequestsByChannel(uint16 channel)
+    {
+        for (WorkerList::iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
+        {
+            Worker* worker = *i;
+            OGRE_WQ_LOCK_MUTEX(worker->mutex);
+            for (size_t p = 0; p < PRIORITY_COUNT; ++p)
+            {
+                RequestQueue& requests = worker->requests[p];
+                for (RequestQueue::iterator r = requests.begin(); r != requests.end(); ++r)
+                {
+                    if ((*r)->getChannel() == channel)
+                        (*r)->abortRequest();
+                }
+            }
+        }
+        DefaultWorkQueueBase::abortPendingRequestsByChannel(channel);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::abortAllRequests()
+    {
+        abortWorkerRequests(AnyRequest());
+        DefaultWorkQueueBase::abortAllRequests();
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::fork(Task* task, TaskGroup& group)
+    {
+        if (!mIsRunning || mWorkers.empty())
+        {
+            task->execute();
+            return;
+        }
+
+        ++group.mPending;
+        Worker* worker = getTargetWorker();
+        {
+            OGRE_WQ_LOCK_MUTEX(worker->mutex);
+            worker->tasks.push_back(QueuedTask(task, &group));
+        }
+        ++mPendingCount;
+        wakeWorker();
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::join(TaskGroup& group)
+    {
+        Worker* self = getCurrentWorker();
+        while (!group.isComplete())
+        {
+            QueuedTask task;
+            if (takeTask(self, task))
+                runTask(task);
+            else
+                OGRE_WQ_THREAD_YIELD;
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::_processParallelJob(const ParallelJobPtr& job)
+    {
+        size_t chunks = job->getChunkCount();
+        if (!mIsRunning || mWorkers.empty() || chunks < 2)
+        {
+            job->process();
+            return;
+        }
+
+        // the calling thread takes a share of the chunks as well
+        vector<ParallelJobTask>::type helpers(std::min(chunks - 1, mWorkers.size()),
+            ParallelJobTask(job.get()));
+        TaskGroup group;
+        for (size_t i = 0; i < helpers.size(); ++i)
+            fork(&helpers[i], group);
+        job->process();
+        join(group);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::runTask(const QueuedTask& task)
+    {
+        task.first->execute();
+        --task.second->mPending;
+    }
+}
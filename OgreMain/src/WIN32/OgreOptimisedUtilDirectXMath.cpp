@@ -159,6 +159,25 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::calculateBoxVisibility
+        virtual void calculateBoxVisibility(
+            const float* planes,
+            size_t numPlanes,
+            const float* bounds,
+            uint32* visibility,
+            size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::blendTransformKeyFrames
+        virtual void blendTransformKeyFrames(
+            const float* const* keyFrames1,
+            const float* const* keyFrames2,
+            const float* interpolations,
+            const float* weights,
+            Real scale,
+            bool shortestPath,
+            float* transforms,
+            size_t numTransforms);
     };
 
 //---------------------------------------------------------------------
@@ -2032,6 +2051,119 @@ static OGRE_FORCE_INLINE bool _isAlignedForDirectXMath(const void *p)
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilDirectXMath::calculateBoxVisibility(
+        const float* planes,
+        size_t numPlanes,
+        const float* bounds,
+        uint32* visibility,
+        size_t numBoxes)
+    {
+        assert(_isAlignedForDirectXMath(bounds));
+
+        memset(visibility, 0, ((numBoxes + 31) / 32) * sizeof(uint32));
+
+        size_t numGroups = (numBoxes + 3) / 4;
+
+        // Four boxes per-iteration
+        for (size_t group = 0; group < numGroups; ++group, bounds += 24)
+        {
+            // Load centres and half sizes, aligned
+            XMVECTOR cx = __DX_LOAD_PS(bounds + 0);
+            XMVECTOR cy = __DX_LOAD_PS(bounds + 4);
+            XMVECTOR cz = __DX_LOAD_PS(bounds + 8);
+            XMVECTOR hx = __DX_LOAD_PS(bounds + 12);
+            XMVECTOR hy = __DX_LOAD_PS(bounds + 16);
+            XMVECTOR hz = __DX_LOAD_PS(bounds + 20);
+
+            XMVECTOR outside = XMVectorFalseInt();
+            const float* plane = planes;
+            for (size_t p = 0; p < numPlanes; ++p, plane += 4)
+            {
+                XMVECTOR nx = XMVectorReplicatePtr(plane + 0);
+                XMVECTOR ny = XMVectorReplicatePtr(plane + 1);
+                XMVECTOR nz = XMVectorReplicatePtr(plane + 2);
+
+                // Signed distance of the centres
+                XMVECTOR dist = XMVectorMultiplyAdd(nx, cx, XMVectorMultiplyAdd(ny, cy,
+                    XMVectorMultiplyAdd(nz, cz, XMVectorReplicatePtr(plane + 3))));
+
+                // Largest distance of the corners from the centres along the normal
+                XMVECTOR maxAbsDist = XMVectorMultiplyAdd(XMVectorAbs(nx), hx,
+                    XMVectorMultiplyAdd(XMVectorAbs(ny), hy, XMVectorMultiply(XMVectorAbs(nz), hz)));
+
+                // Completely on the negative side if dist < -maxAbsDist
+                outside = XMVectorOrInt(outside, XMVectorLess(XMVectorAdd(dist, maxAbsDist), g_XMZero));
+                if (XMComparisonAllTrue(XMVector4EqualIntR(outside, XMVectorTrueInt())))
+                    break;
+            }
+
+            uint32 bitmask =
+                (XMVectorGetIntX(outside) ? 0 : 1) |
+                (XMVectorGetIntY(outside) ? 0 : 2) |
+                (XMVectorGetIntZ(outside) ? 0 : 4) |
+                (XMVectorGetIntW(outside) ? 0 : 8);
+            visibility[group / 8] |= bitmask << ((group % 8) * 4);
+        }
+
+        // Clear the bits of the padding boxes
+        if (numBoxes % 32)
+        {
+            visibility[numBoxes / 32] &= (1u << (numBoxes % 32)) - 1;
+        }
+    }
+    //---------------------------------------------------------------------
+    static inline XMVECTOR __fastcall _XMQuaternionNlerp(
+        FXMVECTOR q1, FXMVECTOR q2, float t, bool shortestPath)
+    {
+        XMVECTOR target = q2;
+        // Interpolate to the nearest rotation, as Quaternion::nlerp does
+        if (shortestPath && XMVectorGetX(XMVector4Dot(q1, q2)) < 0.0f)
+            target = XMVectorNegate(q2);
+        return XMQuaternionNormalize(XMVectorLerp(q1, target, t));
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilDirectXMath::blendTransformKeyFrames(
+        const float* const* keyFrames1,
+        const float* const* keyFrames2,
+        const float* interpolations,
+        const float* weights,
+        Real scale,
+        bool shortestPath,
+        float* transforms,
+        size_t numTransforms)
+    {
+        const XMVECTOR one = g_XMOne;
+        const XMVECTOR identity = XMQuaternionIdentity();
+
+        for (size_t i = 0; i < numTransforms; ++i, transforms += 12)
+        {
+            const float* k1 = keyFrames1[i];
+            const float* k2 = keyFrames2[i];
+            float t = interpolations[i];
+            float weight = weights[i];
+
+            // Keyframes hold w first, DirectXMath wants it last
+            XMVECTOR r1 = XMVectorSwizzle<1, 2, 3, 0>(XMLoadFloat4((const XMFLOAT4*)(k1 + 0)));
+            XMVECTOR r2 = XMVectorSwizzle<1, 2, 3, 0>(XMLoadFloat4((const XMFLOAT4*)(k2 + 0)));
+            XMVECTOR rotation = _XMQuaternionNlerp(
+                identity, _XMQuaternionNlerp(r1, r2, t, shortestPath), weight, shortestPath);
+
+            XMVECTOR translate = XMVectorScale(XMVectorLerp(
+                XMLoadFloat4((const XMFLOAT4*)(k1 + 4)),
+                XMLoadFloat4((const XMFLOAT4*)(k2 + 4)), t), weight * scale);
+
+            XMVECTOR scl = XMVectorLerp(
+                XMLoadFloat4((const XMFLOAT4*)(k1 + 8)),
+                XMLoadFloat4((const XMFLOAT4*)(k2 + 8)), t);
+            scl = XMVectorMultiplyAdd(XMVectorSubtract(scl, one),
+                XMVectorReplicate(scale != 1.0f ? scale : weight), one);
+
+            XMStoreFloat4((XMFLOAT4*)(transforms + 0), XMVectorSwizzle<3, 0, 1, 2>(rotation));
+            XMStoreFloat4((XMFLOAT4*)(transforms + 4), XMVectorSetW(translate, 0.0f));
+            XMStoreFloat4((XMFLOAT4*)(transforms + 8), XMVectorSetW(scl, 0.0f));
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilDirectXMath(void)
@@ -80,9 +80,23 @@ namespace Ogre {
         // Material -> face group hashmap
         typedef map<Material*, vector<StaticFaceGroup*>::type, materialLess >::type MaterialFaceGroupMap;
         MaterialFaceGroupMap mMatFaceGroupMap;
+        // Face groups (by index) in the order walkTree tagged them
+        typedef vector<int>::type FaceGroupList;
+        FaceGroupList mVisibleFaceGroups;
 
         RenderOperation mRenderOp;
 
+        /// Face groups whose indexes are currently in the index buffer
+        FaceGroupList mCachedFaceGroups;
+        /// Whether the index buffer holds the indexes of mCachedFaceGroups
+        bool mIndexCacheValid;
+        /// Range of the index buffer used by each material, in mMatFaceGroupMap order
+        typedef vector<std::pair<size_t, size_t> >::type IndexRangeList;
+        IndexRangeList mMaterialIndexRanges;
+
+        /// BspSceneNode::_update notifies the level of moved objects
+        bool isParallelUpdateSafe(void) const { return false; }
+
         // Debugging features
         bool mShowNodeAABs;
         RenderOperation mAABGeometry;
@@ -101,6 +115,11 @@ namespace Ogre {
         /** Caches a face group for imminent rendering. */
         unsigned int cacheGeometry(unsigned int* pIndexes, const StaticFaceGroup* faceGroup);
 
+        /** Fills the index buffer with the face groups tagged in walkTree,
+            one range per material, unless it already holds them.
+        */
+        void updateIndexCache(void);
+
         /** Frees up allocated memory for geometry caches. */
         void freeMemory(void);
 
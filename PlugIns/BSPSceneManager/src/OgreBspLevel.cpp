@@ -771,29 +771,26 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void BspLevel::buildQuake3Patches(size_t vertOffset, size_t indexOffset)
     {
-        // Loop through the patches
+        // Build all patches one after another, tessellating them in parallel
         PatchMap::iterator i, iend;
         iend = mPatches.end();
 
-        size_t currVertOffset = vertOffset;
-        size_t currIndexOffset = indexOffset;
+        vector<PatchSurface*>::type surfaces;
+        surfaces.reserve(mPatches.size());
+        for (i = mPatches.begin(); i != iend; ++i)
+            surfaces.push_back(i->second);
 
         HardwareVertexBufferSharedPtr vbuf = mVertexData->vertexBufferBinding->getBuffer(0);
+        PatchSurface::buildSurfaces(surfaces, vbuf, vertOffset, mIndexes, indexOffset);
 
         for (i = mPatches.begin(); i != iend; ++i)
         {
             PatchSurface* ps = i->second;
-            
-            ps->build(vbuf, currVertOffset, mIndexes, currIndexOffset);
 
             // No need for control points anymore
             BspVertex* pCP = static_cast<BspVertex*>(ps->getControlPointBuffer());
             OGRE_FREE(pCP, MEMCATEGORY_GEOMETRY);
             ps->notifyControlPointBufferDeallocated();
-
-            currVertOffset += ps->getRequiredVertexCount();
-            currIndexOffset += ps->getRequiredIndexCount();
-        
         }
     }
     //-----------------------------------------------------------------------
@@ -57,6 +57,8 @@ namespace Ogre {
         // Set features for debugging render
         mShowNodeAABs = false;
 
+        mIndexCacheValid = false;
+
         // No sky by default
         mSkyPlaneEnabled = false;
         mSkyBoxEnabled = false;
@@ -134,7 +136,7 @@ namespace Ogre {
 
         // Init static render operation
         mRenderOp.vertexData = mLevel->mVertexData;
-        // index data is per-frame
+        // index data is refilled when the visible face groups change
         mRenderOp.indexData = OGRE_NEW IndexData();
         mRenderOp.indexData->indexStart = 0;
         mRenderOp.indexData->indexCount = 0;
@@ -143,7 +145,8 @@ namespace Ogre {
             .createIndexBuffer(
                 HardwareIndexBuffer::IT_32BIT, // always 32-bit
                 mLevel->mNumIndexes, 
-                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false);
+                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY, false);
+        mIndexCacheValid = false;
 
         mRenderOp.operationType = RenderOperation::OT_TRIANGLE_LIST;
         mRenderOp.useIndexes = true;
@@ -176,7 +179,7 @@ namespace Ogre {
 
         // Init static render operation
         mRenderOp.vertexData = mLevel->mVertexData;
-        // index data is per-frame
+        // index data is refilled when the visible face groups change
         mRenderOp.indexData = OGRE_NEW IndexData();
         mRenderOp.indexData->indexStart = 0;
         mRenderOp.indexData->indexCount = 0;
@@ -185,7 +188,8 @@ namespace Ogre {
             .createIndexBuffer(
                 HardwareIndexBuffer::IT_32BIT, // always 32-bit
                 mLevel->mNumIndexes, 
-                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false);
+                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY, false);
+        mIndexCacheValid = false;
 
         mRenderOp.operationType = RenderOperation::OT_TRIANGLE_LIST;
         mRenderOp.useIndexes = true;
@@ -228,38 +232,25 @@ namespace Ogre {
             return;
 
         // Cache vertex/face data first
-        vector<StaticFaceGroup*>::type::const_iterator faceGrpi;
-        static RenderOperation patchOp;
-        
+        updateIndexCache();
+
         // no world transform required
         mDestRenderSystem->_setWorldMatrix(Matrix4::IDENTITY);
         // Set view / proj
         setViewMatrix(mCachedViewMatrix);
         mDestRenderSystem->_setProjectionMatrix(mCameraInProgress->getProjectionMatrixRS());
 
-        // For each material in turn, cache rendering data & render
+        // For each material in turn, render its range of the cache
         MaterialFaceGroupMap::const_iterator mati;
+        IndexRangeList::const_iterator rangei = mMaterialIndexRanges.begin();
 
-        for (mati = mMatFaceGroupMap.begin(); mati != mMatFaceGroupMap.end(); ++mati)
+        for (mati = mMatFaceGroupMap.begin(); mati != mMatFaceGroupMap.end(); ++mati, ++rangei)
         {
             // Get Material
             Material* thisMaterial = mati->first;
             thisMaterial->touch();
-            // Empty existing cache
-            mRenderOp.indexData->indexCount = 0;
-            // lock index buffer ready to receive data
-            unsigned int* pIdx = static_cast<unsigned int*>(
-                mRenderOp.indexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
-
-            for (faceGrpi = mati->second.begin(); faceGrpi != mati->second.end(); ++faceGrpi)
-            {
-                // Cache each
-                unsigned int numelems = cacheGeometry(pIdx, *faceGrpi);
-                mRenderOp.indexData->indexCount += numelems;
-                pIdx += numelems;
-            }
-            // Unlock the buffer
-            mRenderOp.indexData->indexBuffer->unlock();
+            mRenderOp.indexData->indexStart = rangei->first;
+            mRenderOp.indexData->indexCount = rangei->second;
 
             // Skip if no faces to process (we're not doing flare types yet)
             if (mRenderOp.indexData->indexCount == 0)
@@ -294,6 +285,42 @@ namespace Ogre {
         */
     }
     //-----------------------------------------------------------------------
+    void BspSceneManager::updateIndexCache(void)
+    {
+        // The walk visits the leaves in a fixed order, so the same visible
+        // set yields the same list and the same material ranges
+        if (mIndexCacheValid && mCachedFaceGroups == mVisibleFaceGroups)
+            return;
+
+        mMaterialIndexRanges.clear();
+        vector<StaticFaceGroup*>::type::const_iterator faceGrpi;
+        MaterialFaceGroupMap::const_iterator mati;
+
+        // lock index buffer ready to receive data
+        unsigned int* pIdx = static_cast<unsigned int*>(
+            mRenderOp.indexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+        size_t indexStart = 0;
+
+        for (mati = mMatFaceGroupMap.begin(); mati != mMatFaceGroupMap.end(); ++mati)
+        {
+            size_t indexCount = 0;
+            for (faceGrpi = mati->second.begin(); faceGrpi != mati->second.end(); ++faceGrpi)
+            {
+                // Cache each
+                unsigned int numelems = cacheGeometry(pIdx, *faceGrpi);
+                indexCount += numelems;
+                pIdx += numelems;
+            }
+            mMaterialIndexRanges.push_back(std::make_pair(indexStart, indexCount));
+            indexStart += indexCount;
+        }
+        // Unlock the buffer
+        mRenderOp.indexData->indexBuffer->unlock();
+
+        mCachedFaceGroups = mVisibleFaceGroups;
+        mIndexCacheValid = true;
+    }
+    //-----------------------------------------------------------------------
     // REMOVE THIS CRAP
     //-----------------------------------------------------------------------
     // Temp debug lines
@@ -312,6 +339,7 @@ namespace Ogre {
 
         mMatFaceGroupMap.clear();
         mFaceGroupSet.clear();
+        mVisibleFaceGroups.clear();
 
         // Scan through all the other leaf nodes looking for visibles
         int i = mLevel->mNumNodes - mLevel->mLeafStart;
@@ -406,6 +434,7 @@ namespace Ogre {
                         continue; // skip
                 }
                 mFaceGroupSet.insert(realIndex);
+                mVisibleFaceGroups.push_back(realIndex);
                 // Try to insert, will find existing if already there
                 std::pair<MaterialFaceGroupMap::iterator, bool> matgrpi;
                 matgrpi = mMatFaceGroupMap.insert(
@@ -497,6 +526,9 @@ namespace Ogre {
         // no need to delete index buffer, will be handled by shared pointer
         OGRE_DELETE mRenderOp.indexData;
         mRenderOp.indexData = 0;
+        mIndexCacheValid = false;
+        mCachedFaceGroups.clear();
+        mMaterialIndexRanges.clear();
     }
     //-----------------------------------------------------------------------
     void BspSceneManager::showNodeBoxes(bool show)
@@ -0,0 +1,93 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHNode_H__
+#define __BVHNode_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreSceneNode.h"
+
+namespace Ogre
+{
+    /** \addtogroup Plugins Plugins
+    *  @{
+    */
+    /** \addtogroup BVH BVHSceneManager
+    * Dynamic bounding volume hierarchy for managing scene nodes.
+    *  @{
+    */
+    /** Specialised SceneNode kept in the BVHTree of a BVHSceneManager.
+    @remarks
+        Like the OctreeNode, the bounds of the node only cover its own attached
+        objects and not its children, since every node has its own leaf.
+    */
+    class _OgreBVHPluginExport BVHNode : public SceneNode
+    {
+    public:
+        BVHNode(SceneManager* creator);
+        BVHNode(SceneManager* creator, const String& name);
+        ~BVHNode();
+
+        /** Overridden from Node to remove the child from the tree */
+        Node* removeChild(unsigned short index);
+        /** Overridden from Node to remove the child from the tree */
+        Node* removeChild(const String& name);
+        /** Overridden from Node to remove the child from the tree */
+        Node* removeChild(Node* child);
+        /** Overridden from Node to remove the children from the tree */
+        void removeAllChildren(void);
+
+        /// Proxy of the node in the BVHTree, -1 when it isn't in the tree
+        int32 getProxy(void) const { return mProxy; }
+        void setProxy(int32 proxy) { mProxy = proxy; }
+
+        /// Whether the node has infinite bounds, and so is kept outside the tree
+        bool isUnbounded(void) const { return mUnbounded; }
+        void setUnbounded(bool unbounded) { mUnbounded = unbounded; }
+
+        /** Adds the attached objects, and the debug renderables if asked, to the queue. */
+        void _addToRenderQueue(Camera* cam, RenderQueue* queue, bool onlyShadowCasters,
+            VisibleObjectsBoundsInfo* visibleBounds, bool displayNodes);
+
+    protected:
+        /** Internal method for updating the bounds for this BVHNode.
+        @remarks
+            The bounds only come from the attached objects, the BVHSceneManager
+            is then told to move the leaf of the node.
+        */
+        void _updateBounds(void);
+
+        void _removeNodeAndChildren(void);
+
+        int32 mProxy;
+        bool mUnbounded;
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
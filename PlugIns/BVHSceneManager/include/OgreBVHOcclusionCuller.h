@@ -0,0 +1,173 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHOcclusionCuller_H__
+#define __BVHOcclusionCuller_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreBVHTree.h"
+#include "OgreRenderable.h"
+
+namespace Ogre
+{
+    /** \addtogroup Plugins Plugins
+    *  @{
+    */
+    /** \addtogroup BVH BVHSceneManager
+    * Dynamic bounding volume hierarchy for managing scene nodes.
+    *  @{
+    */
+    /** Hierarchical occlusion culling of a BVHTree for one camera, in the
+        spirit of coherent hierarchical culling (CHC++).
+    @remarks
+        Every tree node remembers whether it was visible. Tree nodes found
+        occluded are not descended into during findVisible, instead their box
+        is drawn in an occlusion query to find out whether they have become
+        visible again. Visible leaves are only queried every few frames, with
+        a different offset for each so the queries are spread over frames.
+        When both children of a tree node are occluded the node is marked
+        occluded as well, so the large hidden parts of the scene cost a single
+        query, and tree nodes found visible mark their parents visible too.
+    @par
+        All the queries of a frame are issued as one batch after the scene has
+        been rendered, with colour and depth writes off. Their results are
+        only read when available, which usually is the next frame, so the
+        renderer never waits for them; the price is that an object coming out
+        from behind an occluder appears a frame late. Tree nodes which were
+        outside the frustum or containing the camera are taken as visible.
+    */
+    class _OgreBVHPluginExport BVHOcclusionCuller : public BVHTree::Visitor, public NodeAlloc
+    {
+    public:
+        /// Draws the box of a tree node within an occlusion query
+        class ProxyRenderer
+        {
+        public:
+            virtual ~ProxyRenderer() {}
+            virtual void renderOcclusionProxy(const AxisAlignedBox& box) = 0;
+        };
+
+        BVHOcclusionCuller(const BVHTree& tree, RenderSystem* renderSystem);
+        ~BVHOcclusionCuller();
+
+        /** Applies the available query results and prepares for a traversal
+            of the tree from the camera. */
+        void beginFrame(const Camera* cam);
+        /// @copydoc BVHTree::Visitor::visit
+        bool visit(int32 index, bool leaf);
+        /** Issues the queries requested during the traversal of this frame. */
+        void issueQueries(ProxyRenderer* renderer);
+
+        /// Set the number of visible pixels above which a tree node is visible
+        void setVisibilityThreshold(uint32 pixels) { mThreshold = pixels; }
+        uint32 getVisibilityThreshold(void) const { return mThreshold; }
+        /// Set the number of frames between the queries of a visible leaf
+        void setQueryInterval(uint32 frames) { mQueryInterval = std::max<uint32>(frames, 1); }
+        uint32 getQueryInterval(void) const { return mQueryInterval; }
+
+        /// Number of scene nodes found visible by the last traversal
+        size_t getNumVisibleNodes(void) const { return mNumVisible; }
+        /// Number of scene nodes below the tree nodes culled by the last traversal
+        size_t getNumCulledNodes(void) const { return mNumCulled; }
+        /// Number of queries issued by the last frame
+        size_t getNumQueries(void) const { return mNumQueries; }
+        /// Tree nodes culled by the last traversal
+        const vector<int32>::type& getCulledTreeNodes(void) const { return mCulledNodes; }
+
+    protected:
+        struct NodeState
+        {
+            uint32 version;
+            /// Last frame in which the traversal reached the tree node
+            uint32 visitedFrame;
+            /// Frame from which a visible leaf is queried again
+            uint32 nextQueryFrame;
+            bool visible;
+            bool queryPending;
+        };
+
+        struct PendingQuery
+        {
+            int32 index;
+            uint32 version;
+            HardwareOcclusionQuery* query;
+        };
+
+        /// State of a tree node, reset if the tree node has been reused
+        NodeState& getState(int32 index);
+        void requestQuery(int32 index, NodeState& state);
+        /// Mark a tree node visible or occluded, and its parents if needed
+        void setVisible(int32 index, bool visible);
+
+        const BVHTree& mTree;
+        RenderSystem* mRenderSystem;
+        vector<NodeState>::type mStates;
+        vector<PendingQuery>::type mPendingQueries;
+        vector<HardwareOcclusionQuery*>::type mFreeQueries;
+        vector<int32>::type mRequestedNodes;
+        vector<int32>::type mCulledNodes;
+        uint32 mFrame;
+        uint32 mThreshold;
+        uint32 mQueryInterval;
+        /// Camera position and near distance of this frame
+        Vector3 mCameraPosition;
+        Real mNearDistance;
+        size_t mNumVisible;
+        size_t mNumCulled;
+        size_t mNumQueries;
+    };
+
+    /** Unit box drawn for the occlusion queries of the BVHOcclusionCuller. */
+    class _OgreBVHPluginExport BVHOcclusionProxy : public Renderable, public NodeAlloc
+    {
+    public:
+        BVHOcclusionProxy();
+        ~BVHOcclusionProxy();
+
+        /// Set the box drawn by the next render
+        void setBox(const AxisAlignedBox& box);
+
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+        /// The pass used to draw the boxes, colour and depth writes off
+        Pass* getPass(void) const;
+        void getRenderOperation(RenderOperation& op);
+        void getWorldTransforms(Matrix4* xform) const { *xform = mTransform; }
+        Real getSquaredViewDepth(const Camera* cam) const { return 0; }
+        const LightList& getLights(void) const;
+        bool getCastsShadows(void) const { return false; }
+
+    protected:
+        MaterialPtr mMaterial;
+        VertexData* mVertexData;
+        IndexData* mIndexData;
+        Matrix4 mTransform;
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -0,0 +1,211 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHSceneManager_H__
+#define __BVHSceneManager_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreSceneManager.h"
+#include "OgreBVHTree.h"
+#include "OgreBVHOcclusionCuller.h"
+#include "OgreBVHSoftwareOcclusion.h"
+
+namespace Ogre
+{
+    /** \addtogroup Plugins Plugins
+    *  @{
+    */
+    /** \addtogroup BVH BVHSceneManager
+    * Dynamic bounding volume hierarchy for managing scene nodes.
+    *  @{
+    */
+    class BVHNode;
+
+    /** Specialised SceneManager keeping the scene nodes in a dynamic bounding
+        volume hierarchy, for frustum culling and spatial queries.
+    @remarks
+        Unlike the OctreeSceneManager, nodes that move aren't removed and
+        reinserted: their leaf box is updated and the tree is refitted once
+        before it is used, and rebuilt when refitting has made it too loose.
+        See BVHTree. Nodes with infinite bounds are kept outside the tree and
+        always tested against the camera.
+    @par
+        With the "OcclusionCulling" option on, and hardware occlusion queries
+        available, the cameras also skip what is hidden behind other objects,
+        see BVHOcclusionCuller. "SoftwareOcclusion" does the same against the
+        objects marked with MovableObject::setOccluder, drawn on the CPU, see
+        BVHSoftwareOcclusion. Both can be on at once, the hardware queries then
+        only test what the occluders don't hide. Shadow cameras are not
+        occlusion culled.
+    */
+    class _OgreBVHPluginExport BVHSceneManager : public SceneManager,
+        public BVHOcclusionCuller::ProxyRenderer
+    {
+    public:
+        BVHSceneManager(const String& name);
+        ~BVHSceneManager();
+
+        /// @copydoc SceneManager::getTypeName
+        const String& getTypeName(void) const;
+
+        /** Creates a specialised BVHNode */
+        SceneNode* createSceneNodeImpl(void);
+        /** Creates a specialised BVHNode */
+        SceneNode* createSceneNodeImpl(const String& name);
+
+        /** Walks the tree, adding the visible nodes to the render queue. */
+        void _findVisibleObjects(Camera* cam,
+            VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+        /** Renders the queue, then issues the occlusion queries of the camera. */
+        void _renderVisibleObjects(void);
+        /// @copydoc BVHOcclusionCuller::ProxyRenderer::renderOcclusionProxy
+        void renderOcclusionProxy(const AxisAlignedBox& box);
+
+        /** Overridden from SceneManager to drop the occlusion state of the camera */
+        void destroyCamera(Camera* cam);
+        /** Overridden from SceneManager to drop the occlusion state of the camera */
+        void destroyCamera(const String& name);
+
+        /** Inserts the node into the tree or moves its leaf, after its bounds changed. */
+        void _updateBVHNode(BVHNode* node);
+        /** Removes the node from the tree. */
+        void _removeBVHNode(BVHNode* node);
+
+        /** Adds the nodes intersecting the box to the list, except exclude.
+        @remarks
+            The findNodesIn methods, and so the scene queries, may be called
+            from several threads at once while the scene doesn't change.
+        */
+        void findNodesIn(const AxisAlignedBox& box, BVHTree::SceneNodeList& list, SceneNode* exclude = 0);
+        /** Adds the nodes intersecting the sphere to the list, except exclude. */
+        void findNodesIn(const Sphere& sphere, BVHTree::SceneNodeList& list, SceneNode* exclude = 0);
+        /** Adds the nodes intersecting the volume to the list, except exclude. */
+        void findNodesIn(const PlaneBoundedVolume& volume, BVHTree::SceneNodeList& list, SceneNode* exclude = 0);
+        /** Adds the nodes hit by the ray to the list, except exclude. */
+        void findNodesIn(const Ray& ray, BVHTree::SceneNodeList& list, SceneNode* exclude = 0);
+
+        /// Get the tree of the scene nodes
+        const BVHTree& getTree(void) const { return mTree; }
+
+        /** Sets the given option for the SceneManager
+        @remarks
+            Options are:
+            "FatMargin", Real *, see BVHTree::setFatMargin;
+            "RebuildRatio", Real *, see BVHTree::setRebuildRatio;
+            "Rebuild", ignored, rebuilds the tree now;
+            "OcclusionCulling", bool *;
+            "OcclusionThreshold", uint32 *, see BVHOcclusionCuller::setVisibilityThreshold;
+            "OcclusionQueryInterval", uint32 *, see BVHOcclusionCuller::setQueryInterval;
+            "ShowOcclusionCulled", bool *, draws the boxes of the occluded parts of the tree;
+            "SoftwareOcclusion", bool *;
+            "SoftwareOcclusionWidth", uint32 *, see BVHSoftwareOcclusion::setResolution;
+            "SoftwareOcclusionHeight", uint32 *, see BVHSoftwareOcclusion::setResolution;
+            "MaxOccluders", size_t *, see BVHSoftwareOcclusion::setMaxOccluders.
+        */
+        bool setOption(const String& key, const void* val);
+        /** Gets the given option for the Scene Manager.
+        @remarks
+            See setOption, also "NumRebuilds", size_t *; "OcclusionCulledPercentage",
+            Real *, the share of the nodes in the frustum found occluded by the
+            last occlusion culled camera; "OcclusionQueries", size_t *, the
+            number of queries it issued; "NumOccluders", size_t *, and
+            "OccluderTriangles", size_t *, what it drew in software.
+        */
+        bool getOption(const String& key, void* val);
+        bool getOptionKeys(StringVector& refKeys);
+
+        /** Overridden from SceneManager */
+        void clearScene(void);
+
+        AxisAlignedBoxSceneQuery* createAABBQuery(const AxisAlignedBox& box, uint32 mask);
+        SphereSceneQuery* createSphereQuery(const Sphere& sphere, uint32 mask);
+        PlaneBoundedVolumeListSceneQuery* createPlaneBoundedVolumeQuery(const PlaneBoundedVolumeList& volumes, uint32 mask);
+        RaySceneQuery* createRayQuery(const Ray& ray, uint32 mask);
+        IntersectionSceneQuery* createIntersectionQuery(uint32 mask);
+
+    protected:
+        /// BVHNode::_updateBounds changes the shared tree
+        bool isParallelUpdateSafe(void) const { return false; }
+
+        /// Adds the nodes with infinite bounds to the list, since they intersect anything
+        void addUnboundedNodes(BVHTree::SceneNodeList& list, SceneNode* exclude);
+
+        BVHTree mTree;
+        /// Nodes with infinite bounds
+        set<BVHNode*>::type mUnboundedNodes;
+        /// Nodes found visible by _findVisibleObjects
+        BVHTree::SceneNodeList mVisibleNodes;
+        /// Refit the tree if needed, from any thread
+        void updateTree(void);
+        OGRE_WQ_MUTEX(mTreeMutex);
+
+        /// Get the occlusion state of a camera, created on first use
+        BVHOcclusionCuller* getOcclusionCuller(const Camera* cam);
+        void destroyOcclusionCullers(void);
+        /// Get the software occlusion, created on first use
+        BVHSoftwareOcclusion* getSoftwareOcclusion(void);
+        /// Collect the occluders attached to the nodes into mOccluders
+        void findOccluders(const BVHTree::SceneNodeList& nodes);
+        /// Show the boxes of culled tree nodes with the debug drawer
+        void drawCulledBoxes(const vector<int32>::type& culledNodes);
+
+        typedef map<const Camera*, BVHOcclusionCuller*>::type OcclusionCullerMap;
+        OcclusionCullerMap mOcclusionCullers;
+        /// Culler of the camera being rendered, whose queries are still to be issued
+        BVHOcclusionCuller* mActiveCuller;
+        BVHOcclusionProxy* mOcclusionProxy;
+        bool mOcclusionCulling;
+        uint32 mOcclusionThreshold;
+        uint32 mOcclusionQueryInterval;
+        bool mShowOcclusionCulled;
+        /// Created when the "SoftwareOcclusion" option is first set
+        BVHSoftwareOcclusion* mSoftwareOcclusion;
+        bool mSoftwareOcclusionEnabled;
+        /// Occluders in the frustum, passed to mSoftwareOcclusion
+        vector<Entity*>::type mOccluders;
+        Real mOcclusionCulledPercentage;
+        size_t mOcclusionQueries;
+    };
+
+    /// Factory for BVHSceneManager
+    class BVHSceneManagerFactory : public SceneManagerFactory
+    {
+    protected:
+        void initMetaData(void) const;
+    public:
+        BVHSceneManagerFactory() {}
+        ~BVHSceneManagerFactory() {}
+        /// Factory type name
+        static const String FACTORY_TYPE_NAME;
+        SceneManager* createInstance(const String& instanceName);
+        void destroyInstance(SceneManager* instance);
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
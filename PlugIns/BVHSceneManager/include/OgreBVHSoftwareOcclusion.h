@@ -0,0 +1,182 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHSoftwareOcclusion_H__
+#define __BVHSoftwareOcclusion_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreBVHTree.h"
+#include "OgreMatrix4.h"
+#include "OgreMesh.h"
+
+namespace Ogre
+{
+    /** \addtogroup Plugins Plugins
+    *  @{
+    */
+    /** \addtogroup BVH BVHSceneManager
+    * Dynamic bounding volume hierarchy for managing scene nodes.
+    *  @{
+    */
+    /** Occlusion culling of a BVHTree against a depth buffer drawn on the CPU.
+    @remarks
+        The entities marked as occluders (see MovableObject::setOccluder) are
+        rasterised into a small depth buffer, after which findVisible skips
+        the tree nodes whose box is entirely behind it. Unlike hardware
+        occlusion queries there is no latency and no readback, the results
+        are exact for the current frame.
+    @par
+        The depth buffer holds 1 / w, so it is linear in screen space and
+        larger values are nearer. It is split into rows of 8x8 tiles, which
+        are drawn in parallel (see parallelFor) four pixels at a time, and
+        each tile keeps the farthest depth in it so most box tests end at
+        the tile level. Triangles are drawn two sided and clipped against
+        the near plane only.
+    @par
+        Only the mesh of an entity is used, as found in the first level of
+        detail. Animated entities are never occluders, since their bind pose
+        may hide what the animation reveals. Orthographic cameras are not
+        supported, render does nothing for them.
+    */
+    class _OgreBVHPluginExport BVHSoftwareOcclusion : public BVHTree::Visitor, public NodeAlloc
+    {
+    public:
+        BVHSoftwareOcclusion(const BVHTree& tree);
+        ~BVHSoftwareOcclusion();
+
+        /** Draw the occluders into the depth buffer, the largest on screen
+            first up to the maximum number of occluders. */
+        void render(const Camera* cam, const vector<Entity*>::type& occluders);
+        /// Whether a box is entirely behind the depth buffer drawn by render
+        bool isOccluded(const AxisAlignedBox& box) const;
+        /// @copydoc BVHTree::Visitor::visit
+        bool visit(int32 index, bool leaf);
+
+        /** Set the size of the depth buffer, rounded up to whole tiles.
+        @remarks
+            The buffer is stretched over the viewport, so it does not need
+            the same aspect ratio. Small gaps between occluders are lost at
+            low resolutions, along with what is seen through them.
+        */
+        void setResolution(uint32 width, uint32 height);
+        uint32 getWidth(void) const { return mWidth; }
+        uint32 getHeight(void) const { return mHeight; }
+        /// Set the maximum number of occluders drawn per frame
+        void setMaxOccluders(size_t count) { mMaxOccluders = count; }
+        size_t getMaxOccluders(void) const { return mMaxOccluders; }
+        /// Set a visitor to ask about the tree nodes not found occluded, such as a BVHOcclusionCuller
+        void setNextVisitor(BVHTree::Visitor* visitor) { mNextVisitor = visitor; }
+
+        /// Number of occluders drawn by the last render
+        size_t getNumOccluders(void) const { return mOccluders.size(); }
+        /// Number of triangles drawn by the last render, after clipping
+        size_t getNumTriangles(void) const;
+        /// Number of scene nodes found visible by the last traversal
+        size_t getNumVisibleNodes(void) const { return mNumVisible; }
+        /// Number of scene nodes below the tree nodes culled by the last traversal
+        size_t getNumCulledNodes(void) const { return mNumCulled; }
+        /// Tree nodes culled by the last traversal
+        const vector<int32>::type& getCulledTreeNodes(void) const { return mCulledNodes; }
+
+    protected:
+        static const uint32 TILE_SIZE = 8;
+
+        /// Triangles of a mesh in its own space
+        struct OccluderMesh
+        {
+            MeshPtr mesh;
+            /// State of the mesh the triangles were read from
+            size_t stateCount;
+            vector<Vector3>::type positions;
+            vector<uint32>::type indices;
+        };
+
+        /// A triangle in screen space, clipped to the near plane
+        struct ScreenTriangle
+        {
+            float x[3];
+            float y[3];
+            /// 1 / w of each corner
+            float z[3];
+        };
+        typedef vector<ScreenTriangle>::type ScreenTriangleList;
+
+        struct Occluder
+        {
+            const OccluderMesh* mesh;
+            /// From the mesh to clip space
+            Matrix4 transform;
+            /// Projected size, to keep the largest occluders
+            Real size;
+            SceneNode* node;
+
+            bool operator<(const Occluder& rhs) const { return size > rhs.size; }
+        };
+
+        /// Get the triangles of a mesh, reading them the first time
+        const OccluderMesh& getOccluderMesh(const MeshPtr& mesh);
+        /// Clip and project the triangles of an occluder into its triangle list
+        void transformOccluder(size_t index);
+        /// Draw all triangles into one row of tiles
+        void rasteriseTileRow(uint32 row);
+        /// Project a point with the view projection matrix of the frame
+        void project(const Vector3& point, float& x, float& y, float& w) const;
+
+        struct TransformFunc;
+        struct RasteriseFunc;
+
+        const BVHTree& mTree;
+        BVHTree::Visitor* mNextVisitor;
+        uint32 mWidth;
+        uint32 mHeight;
+        size_t mMaxOccluders;
+        typedef map<const Mesh*, OccluderMesh>::type OccluderMeshMap;
+        OccluderMeshMap mOccluderMeshes;
+        vector<Occluder>::type mOccluders;
+        /// Scene nodes of the occluders, sorted, never culled by themselves
+        vector<SceneNode*>::type mOccluderNodes;
+        /// Screen triangles of each occluder
+        vector<ScreenTriangleList>::type mTriangles;
+        /// Clip space x, y and w of the vertices of each occluder
+        vector<vector<Vector3>::type>::type mClipVertices;
+        /// Depth buffer, one row after the other
+        vector<float>::type mDepth;
+        /// Farthest depth of each tile
+        vector<float>::type mTileDepth;
+        /// Whether render drew the depth buffer for the current camera
+        bool mActive;
+        Matrix4 mViewProj;
+        float mNearDistance;
+        size_t mNumVisible;
+        size_t mNumCulled;
+        vector<int32>::type mCulledNodes;
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -0,0 +1,229 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHTree_H__
+#define __BVHTree_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+
+namespace Ogre
+{
+    /** \addtogroup Plugins Plugins
+    *  @{
+    */
+    /** \addtogroup BVH BVHSceneManager
+    * Dynamic bounding volume hierarchy for managing scene nodes.
+    *  @{
+    */
+    /** Dynamic bounding volume hierarchy over scene nodes.
+    @remarks
+        A binary tree of axis aligned boxes stored in a single array, with one
+        scene node per leaf. Leaves get a slightly enlarged (fat) box, so that
+        nodes moving a little don't touch the tree at all. When a node does
+        leave its box only its leaf is changed, the boxes above it are refitted
+        once by the next update() instead of the node being removed and
+        reinserted.
+    @par
+        New nodes are inserted next to the sibling that grows the tree surface
+        area the least. Since inserting and refitting slowly degrade the tree,
+        update() rebuilds it from scratch with a binned surface area heuristic
+        once its cost has grown by the rebuild ratio since the last build.
+    @par
+        Leaves are referred to by proxy ids, which don't change when the tree
+        is rebuilt.
+    */
+    class _OgreBVHPluginExport BVHTree : public NodeAlloc
+    {
+    public:
+        typedef vector<SceneNode*>::type SceneNodeList;
+
+        /** Lets findVisible skip parts of the tree, such as those found occluded. */
+        class Visitor
+        {
+        public:
+            virtual ~Visitor() {}
+            /** Called for every tree node inside the planes, before its
+                subtree or scene node is added.
+            @return false to skip the tree node and everything below it
+            */
+            virtual bool visit(int32 index, bool leaf) = 0;
+        };
+
+        BVHTree();
+        ~BVHTree();
+
+        /// Add a scene node with the given world bounds, returns its proxy id
+        int32 insert(SceneNode* node, const AxisAlignedBox& box);
+        /// Remove a proxy returned by insert
+        void remove(int32 proxy);
+        /// Change the world bounds of a proxy, the tree is refitted by update()
+        void move(int32 proxy, const AxisAlignedBox& box);
+        /// Refit the boxes of moved proxies, and rebuild the tree if it has degraded
+        void update(void);
+        /// Rebuild the whole tree with a binned surface area heuristic
+        void rebuild(void);
+        /// Remove all proxies
+        void clear(void);
+
+        /** Find the nodes whose bounds are at least partially on the positive
+            side of all the planes, such as the planes of a frustum.
+        @remarks
+            Subtrees entirely inside the planes are added without further plane
+            tests. The tree must be up to date, see update().
+        @param visitor Optional visitor to be asked before descending into
+            each tree node inside the planes
+        */
+        void findVisible(const Plane* planes, size_t numPlanes, SceneNodeList& nodes,
+            Visitor* visitor = 0) const;
+        /** Find the nodes intersecting a box, the tree must be up to date.
+        @remarks
+            The nodes are added to the end of the list. Unlike findVisible, the
+            findNodesIn methods may be called from several threads at once.
+        */
+        void findNodesIn(const AxisAlignedBox& box, SceneNodeList& nodes) const;
+        /// Find the nodes intersecting a sphere, the tree must be up to date
+        void findNodesIn(const Sphere& sphere, SceneNodeList& nodes) const;
+        /// Find the nodes intersecting a volume, the tree must be up to date
+        void findNodesIn(const PlaneBoundedVolume& volume, SceneNodeList& nodes) const;
+        /// Find the nodes hit by a ray, the tree must be up to date
+        void findNodesIn(const Ray& ray, SceneNodeList& nodes) const;
+
+        /// Set how much leaf boxes are enlarged, as a fraction of their largest size
+        void setFatMargin(Real margin) { mFatMargin = margin; }
+        Real getFatMargin(void) const { return mFatMargin; }
+        /// Set by how much the cost may grow before update() rebuilds the tree
+        void setRebuildRatio(Real ratio) { mRebuildRatio = ratio; }
+        Real getRebuildRatio(void) const { return mRebuildRatio; }
+
+        /// Number of nodes in the tree
+        size_t getNumProxies(void) const { return mNumProxies; }
+        /// Number of times the tree was rebuilt
+        size_t getNumRebuilds(void) const { return mNumRebuilds; }
+        /// Surface area heuristic cost of the tree, relative to its root box
+        Real getCost(void) const;
+
+        /// Size of the tree node array, an upper bound of the tree node indices
+        size_t getNodeArraySize(void) const { return mNodes.size(); }
+        /// Changes whenever the tree node at the index is reused for something else
+        uint32 getNodeVersion(int32 index) const { return mNodes[index].version; }
+        /// Parent of a tree node, -1 for the root
+        int32 getNodeParent(int32 index) const { return mNodes[index].parent; }
+        /// Child of an inner tree node
+        int32 getNodeChild(int32 index, int child) const { return mNodes[index].children[child]; }
+        /// Number of scene nodes below a tree node
+        uint32 getNodeLeafCount(int32 index) const { return mNodes[index].leafCount; }
+        /// Box of a tree node, enlarged for leaves
+        AxisAlignedBox getNodeBounds(int32 index) const
+        { return AxisAlignedBox(mNodes[index].minimum, mNodes[index].maximum); }
+        /// Scene node of a leaf
+        SceneNode* getLeafSceneNode(int32 index) const { return mProxies[mNodes[index].proxy].node; }
+
+    protected:
+        struct TreeNode
+        {
+            Vector3 minimum;
+            Vector3 maximum;
+            int32 parent;
+            /// Children of an inner node, -1 for a leaf
+            int32 children[2];
+            /// Proxy of a leaf
+            int32 proxy;
+            /// Number of leaves below
+            uint32 leafCount;
+            /// See getNodeVersion
+            uint32 version;
+            /// Whether the box of an inner node has to be refitted
+            bool refit;
+        };
+
+        struct Proxy
+        {
+            /// The node, null for a free proxy
+            SceneNode* node;
+            /// Leaf of the node, next free proxy when free
+            int32 leaf;
+            /// Exact bounds of the node
+            Vector3 minimum;
+            Vector3 maximum;
+        };
+
+        typedef vector<TreeNode>::type TreeNodeList;
+        typedef vector<Proxy>::type ProxyList;
+        typedef vector<int32>::type IndexList;
+
+        TreeNodeList mNodes;
+        ProxyList mProxies;
+        IndexList mFreeNodes;
+        int32 mFreeProxy;
+        int32 mRoot;
+        size_t mNumProxies;
+        /// Sum of the surface areas of the inner nodes
+        Real mInnerArea;
+        /// Cost of the tree right after the last build
+        Real mBuiltCost;
+        bool mNeedsRefit;
+        Real mFatMargin;
+        Real mRebuildRatio;
+        size_t mNumRebuilds;
+        uint32 mNextVersion;
+        /// Traversal scratch space of findVisible
+        mutable IndexList mStack;
+
+        bool isLeaf(int32 index) const { return mNodes[index].children[0] == -1; }
+        int32 allocateNode(void);
+        void freeNode(int32 index);
+        /// Enlarge a proxy box into its leaf box
+        void fatten(const Proxy& proxy, TreeNode& leaf) const;
+        /// Set the box of an inner node to the union of its children
+        void fitToChildren(int32 index);
+        void insertLeaf(int32 leaf);
+        void removeLeaf(int32 leaf);
+        /// Refit the inner nodes flagged by move()
+        void refit(void);
+        /// Split a range of leaves for rebuild, returns the end of the first half
+        size_t partition(size_t begin, size_t end);
+        /// Add all the nodes below an inner node
+        void addSubtree(int32 index, SceneNodeList& nodes) const;
+        template <typename Volume>
+        void findNodes(const Volume& volume, SceneNodeList& nodes) const;
+
+        /// Leaves being rebuilt
+        struct BuildLeaf
+        {
+            Vector3 minimum;
+            Vector3 maximum;
+            int32 proxy;
+        };
+        typedef vector<BuildLeaf>::type BuildLeafList;
+        BuildLeafList mBuildLeaves;
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
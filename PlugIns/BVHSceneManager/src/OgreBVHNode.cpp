@@ -0,0 +1,134 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHNode.h"
+#include "OgreBVHSceneManager.h"
+#include "OgreRenderQueue.h"
+
+#if OGRE_NODE_STORAGE_LEGACY
+#define ITER_VAL(it) it->second
+#else
+#define ITER_VAL(it) (*it)
+#endif
+
+namespace Ogre
+{
+//-----------------------------------------------------------------------
+BVHNode::BVHNode(SceneManager* creator)
+    : SceneNode(creator)
+    , mProxy(-1)
+    , mUnbounded(false)
+{
+}
+//-----------------------------------------------------------------------
+BVHNode::BVHNode(SceneManager* creator, const String& name)
+    : SceneNode(creator, name)
+    , mProxy(-1)
+    , mUnbounded(false)
+{
+}
+//-----------------------------------------------------------------------
+BVHNode::~BVHNode()
+{
+    if (mProxy != -1 || mUnbounded)
+        static_cast<BVHSceneManager*>(mCreator)->_removeBVHNode(this);
+}
+//-----------------------------------------------------------------------
+void BVHNode::_removeNodeAndChildren(void)
+{
+    static_cast<BVHSceneManager*>(mCreator)->_removeBVHNode(this);
+
+    ChildNodeMap::iterator it, itend = mChildren.end();
+    for (it = mChildren.begin(); it != itend; ++it)
+        static_cast<BVHNode*>(ITER_VAL(it))->_removeNodeAndChildren();
+}
+//-----------------------------------------------------------------------
+Node* BVHNode::removeChild(unsigned short index)
+{
+    BVHNode* node = static_cast<BVHNode*>(SceneNode::removeChild(index));
+    node->_removeNodeAndChildren();
+    return node;
+}
+//-----------------------------------------------------------------------
+Node* BVHNode::removeChild(const String& name)
+{
+    BVHNode* node = static_cast<BVHNode*>(SceneNode::removeChild(name));
+    node->_removeNodeAndChildren();
+    return node;
+}
+//-----------------------------------------------------------------------
+Node* BVHNode::removeChild(Node* child)
+{
+    BVHNode* node = static_cast<BVHNode*>(SceneNode::removeChild(child));
+    node->_removeNodeAndChildren();
+    return node;
+}
+//-----------------------------------------------------------------------
+void BVHNode::removeAllChildren(void)
+{
+    ChildNodeMap::iterator it, itend = mChildren.end();
+    for (it = mChildren.begin(); it != itend; ++it)
+    {
+        BVHNode* node = static_cast<BVHNode*>(ITER_VAL(it));
+        node->setParent(0);
+        node->_removeNodeAndChildren();
+    }
+    mChildren.clear();
+    mChildrenToUpdate.clear();
+}
+//-----------------------------------------------------------------------
+void BVHNode::_updateBounds(void)
+{
+    mWorldAABB.setNull();
+
+    // Only the own attached objects, the children have leaves of their own
+    ObjectMap::iterator it, itend = mObjectsByName.end();
+    for (it = mObjectsByName.begin(); it != itend; ++it)
+        mWorldAABB.merge(ITER_VAL(it)->getWorldBoundingBox(true));
+
+    if (mIsInSceneGraph)
+        static_cast<BVHSceneManager*>(mCreator)->_updateBVHNode(this);
+}
+//-----------------------------------------------------------------------
+void BVHNode::_addToRenderQueue(Camera* cam, RenderQueue* queue, bool onlyShadowCasters,
+    VisibleObjectsBoundsInfo* visibleBounds, bool displayNodes)
+{
+    ObjectMap::iterator it, itend = mObjectsByName.end();
+    for (it = mObjectsByName.begin(); it != itend; ++it)
+        queue->processVisibleObject(ITER_VAL(it), cam, onlyShadowCasters, visibleBounds);
+
+    if (displayNodes)
+        queue->addRenderable(getDebugRenderable());
+
+    if (!mHideBoundingBox &&
+        (mShowBoundingBox || (mCreator && mCreator->getShowBoundingBoxes())))
+    {
+        _addBoundingBoxToQueue(queue);
+    }
+}
+
+}
@@ -0,0 +1,312 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHOcclusionCuller.h"
+#include "OgreCamera.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreHardwareOcclusionQuery.h"
+#include "OgreMaterialManager.h"
+#include "OgreRenderSystem.h"
+#include "OgreTechnique.h"
+
+namespace Ogre
+{
+//-----------------------------------------------------------------------
+BVHOcclusionCuller::BVHOcclusionCuller(const BVHTree& tree, RenderSystem* renderSystem)
+    : mTree(tree)
+    , mRenderSystem(renderSystem)
+    , mFrame(1)
+    , mThreshold(0)
+    , mQueryInterval(4)
+    , mCameraPosition(Vector3::ZERO)
+    , mNearDistance(0)
+    , mNumVisible(0)
+    , mNumCulled(0)
+    , mNumQueries(0)
+{
+}
+//-----------------------------------------------------------------------
+BVHOcclusionCuller::~BVHOcclusionCuller()
+{
+    for (size_t i = 0; i < mPendingQueries.size(); ++i)
+        mRenderSystem->destroyHardwareOcclusionQuery(mPendingQueries[i].query);
+    for (size_t i = 0; i < mFreeQueries.size(); ++i)
+        mRenderSystem->destroyHardwareOcclusionQuery(mFreeQueries[i]);
+}
+//-----------------------------------------------------------------------
+BVHOcclusionCuller::NodeState& BVHOcclusionCuller::getState(int32 index)
+{
+    if (static_cast<size_t>(index) >= mStates.size())
+    {
+        NodeState blank = { 0, 0, 0, true, false };
+        mStates.resize(mTree.getNodeArraySize(), blank);
+    }
+
+    NodeState& state = mStates[index];
+    uint32 version = mTree.getNodeVersion(index);
+    if (state.version != version)
+    {
+        state.version = version;
+        state.visitedFrame = 0;
+        state.nextQueryFrame = 0;
+        state.visible = true;
+        state.queryPending = false;
+    }
+    return state;
+}
+//-----------------------------------------------------------------------
+void BVHOcclusionCuller::beginFrame(const Camera* cam)
+{
+    // Requests of a traversal which wasn't followed by a render are dropped
+    for (size_t i = 0; i < mRequestedNodes.size(); ++i)
+    {
+        if (static_cast<size_t>(mRequestedNodes[i]) < mTree.getNodeArraySize())
+            getState(mRequestedNodes[i]).queryPending = false;
+    }
+    mRequestedNodes.clear();
+
+    // Apply the results which are in, without waiting for the others
+    size_t kept = 0;
+    for (size_t i = 0; i < mPendingQueries.size(); ++i)
+    {
+        PendingQuery& pending = mPendingQueries[i];
+        if (pending.query->isStillOutstanding())
+        {
+            mPendingQueries[kept++] = pending;
+            continue;
+        }
+
+        unsigned int pixels = 0;
+        pending.query->pullOcclusionQuery(&pixels);
+        mFreeQueries.push_back(pending.query);
+
+        if (static_cast<size_t>(pending.index) < mTree.getNodeArraySize() &&
+            mTree.getNodeVersion(pending.index) == pending.version)
+        {
+            getState(pending.index).queryPending = false;
+            setVisible(pending.index, pixels > mThreshold);
+        }
+    }
+    mPendingQueries.resize(kept);
+
+    ++mFrame;
+    mCameraPosition = cam->getDerivedPosition();
+    mNearDistance = cam->getNearClipDistance();
+    mCulledNodes.clear();
+    mNumVisible = 0;
+    mNumCulled = 0;
+}
+//-----------------------------------------------------------------------
+void BVHOcclusionCuller::setVisible(int32 index, bool visible)
+{
+    NodeState& state = getState(index);
+    state.visible = visible;
+
+    if (visible)
+    {
+        // Spread the checks of visible leaves over the frames
+        state.nextQueryFrame = mFrame + mQueryInterval + (index * 2654435761u >> 16) % mQueryInterval;
+
+        for (int32 p = mTree.getNodeParent(index); p != -1; p = mTree.getNodeParent(p))
+        {
+            NodeState& parent = getState(p);
+            if (parent.visible)
+                break;
+            parent.visible = true;
+        }
+    }
+    else
+    {
+        // Pull up the occlusion while both children are occluded
+        for (int32 p = mTree.getNodeParent(index); p != -1; p = mTree.getNodeParent(p))
+        {
+            if (getState(mTree.getNodeChild(p, 0)).visible ||
+                getState(mTree.getNodeChild(p, 1)).visible)
+                break;
+            getState(p).visible = false;
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void BVHOcclusionCuller::requestQuery(int32 index, NodeState& state)
+{
+    if (state.queryPending)
+        return;
+    state.queryPending = true;
+    mRequestedNodes.push_back(index);
+}
+//-----------------------------------------------------------------------
+bool BVHOcclusionCuller::visit(int32 index, bool leaf)
+{
+    NodeState& state = getState(index);
+
+    // Outside the frustum last frame, so nothing is known about it
+    if (state.visitedFrame + 1 != mFrame)
+    {
+        state.visible = true;
+        state.nextQueryFrame = mFrame;
+    }
+    state.visitedFrame = mFrame;
+
+    // A box around the camera may be clipped by the near plane, so the query
+    // would find nothing
+    bool queryable = mTree.getNodeBounds(index).distance(mCameraPosition) > mNearDistance * 2;
+    if (!queryable)
+        state.visible = true;
+
+    if (!state.visible)
+    {
+        requestQuery(index, state);
+        mCulledNodes.push_back(index);
+        mNumCulled += mTree.getNodeLeafCount(index);
+        return false;
+    }
+
+    if (leaf)
+    {
+        if (queryable && mFrame >= state.nextQueryFrame)
+            requestQuery(index, state);
+        ++mNumVisible;
+    }
+    return true;
+}
+//-----------------------------------------------------------------------
+void BVHOcclusionCuller::issueQueries(ProxyRenderer* renderer)
+{
+    mNumQueries = mRequestedNodes.size();
+    for (size_t i = 0; i < mRequestedNodes.size(); ++i)
+    {
+        int32 index = mRequestedNodes[i];
+
+        HardwareOcclusionQuery* query;
+        if (mFreeQueries.empty())
+        {
+            query = mRenderSystem->createHardwareOcclusionQuery();
+        }
+        else
+        {
+            query = mFreeQueries.back();
+            mFreeQueries.pop_back();
+        }
+
+        query->beginOcclusionQuery();
+        renderer->renderOcclusionProxy(mTree.getNodeBounds(index));
+        query->endOcclusionQuery();
+
+        PendingQuery pending = { index, mTree.getNodeVersion(index), query };
+        mPendingQueries.push_back(pending);
+    }
+    mRequestedNodes.clear();
+}
+//-----------------------------------------------------------------------
+BVHOcclusionProxy::BVHOcclusionProxy()
+    : mVertexData(0)
+    , mIndexData(0)
+    , mTransform(Matrix4::IDENTITY)
+{
+    const String materialName = "BVH/OcclusionProxy";
+    mMaterial = MaterialManager::getSingleton().getByName(materialName,
+        ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+    if (!mMaterial)
+    {
+        mMaterial = MaterialManager::getSingleton().create(materialName,
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+        Pass* pass = mMaterial->getTechnique(0)->getPass(0);
+        pass->setColourWriteEnabled(false);
+        pass->setDepthWriteEnabled(false);
+        pass->setDepthCheckEnabled(true);
+        pass->setLightingEnabled(false);
+        pass->setFog(true);
+        // Both sides, so a box cut by the near plane still shows its far side
+        pass->setCullingMode(CULL_NONE);
+        pass->setManualCullingMode(MANUAL_CULL_NONE);
+        mMaterial->load();
+    }
+
+    // Unit box around the origin
+    mVertexData = OGRE_NEW VertexData();
+    mVertexData->vertexCount = 8;
+    mVertexData->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+    HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+        3 * sizeof(float), 8, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+    float vertices[24];
+    for (int i = 0; i < 8; ++i)
+    {
+        vertices[i * 3 + 0] = (i & 1) ? 1.0f : -1.0f;
+        vertices[i * 3 + 1] = (i & 2) ? 1.0f : -1.0f;
+        vertices[i * 3 + 2] = (i & 4) ? 1.0f : -1.0f;
+    }
+    vbuf->writeData(0, vbuf->getSizeInBytes(), vertices, true);
+    mVertexData->vertexBufferBinding->setBinding(0, vbuf);
+
+    static const uint16 indices[36] = {
+        0, 2, 1,  1, 2, 3,  // -z
+        4, 5, 6,  5, 7, 6,  // +z
+        0, 1, 4,  1, 5, 4,  // -y
+        2, 6, 3,  3, 6, 7,  // +y
+        0, 4, 2,  2, 4, 6,  // -x
+        1, 3, 5,  3, 7, 5   // +x
+    };
+    mIndexData = OGRE_NEW IndexData();
+    mIndexData->indexCount = 36;
+    mIndexData->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, 36, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+    mIndexData->indexBuffer->writeData(0, mIndexData->indexBuffer->getSizeInBytes(), indices, true);
+}
+//-----------------------------------------------------------------------
+BVHOcclusionProxy::~BVHOcclusionProxy()
+{
+    OGRE_DELETE mVertexData;
+    OGRE_DELETE mIndexData;
+}
+//-----------------------------------------------------------------------
+void BVHOcclusionProxy::setBox(const AxisAlignedBox& box)
+{
+    mTransform.makeTransform(box.getCenter(), box.getHalfSize(), Quaternion::IDENTITY);
+}
+//-----------------------------------------------------------------------
+Pass* BVHOcclusionProxy::getPass(void) const
+{
+    return mMaterial->getBestTechnique()->getPass(0);
+}
+//-----------------------------------------------------------------------
+void BVHOcclusionProxy::getRenderOperation(RenderOperation& op)
+{
+    op.operationType = RenderOperation::OT_TRIANGLE_LIST;
+    op.useIndexes = true;
+    op.vertexData = mVertexData;
+    op.indexData = mIndexData;
+    op.srcRenderable = this;
+}
+//-----------------------------------------------------------------------
+const LightList& BVHOcclusionProxy::getLights(void) const
+{
+    static LightList emptyList;
+    return emptyList;
+}
+
+}
@@ -0,0 +1,608 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHSceneManager.h"
+#include "OgreBVHSceneQuery.h"
+#include "OgreBVHNode.h"
+#include "OgreCamera.h"
+#include "OgreEntity.h"
+#include "OgreRenderSystem.h"
+#include "OgreDebugDrawer.h"
+
+namespace Ogre
+{
+//-----------------------------------------------------------------------
+BVHSceneManager::BVHSceneManager(const String& name)
+    : SceneManager(name)
+    , mActiveCuller(0)
+    , mOcclusionProxy(0)
+    , mOcclusionCulling(false)
+    , mOcclusionThreshold(0)
+    , mOcclusionQueryInterval(4)
+    , mShowOcclusionCulled(false)
+    , mSoftwareOcclusion(0)
+    , mSoftwareOcclusionEnabled(false)
+    , mOcclusionCulledPercentage(0)
+    , mOcclusionQueries(0)
+{
+}
+//-----------------------------------------------------------------------
+BVHSceneManager::~BVHSceneManager()
+{
+    destroyOcclusionCullers();
+    OGRE_DELETE mOcclusionProxy;
+    OGRE_DELETE mSoftwareOcclusion;
+
+    // The nodes take themselves out of the tree when destroyed, which must
+    // happen before the tree goes
+    clearScene();
+}
+//-----------------------------------------------------------------------
+const String& BVHSceneManager::getTypeName(void) const
+{
+    return BVHSceneManagerFactory::FACTORY_TYPE_NAME;
+}
+//-----------------------------------------------------------------------
+SceneNode* BVHSceneManager::createSceneNodeImpl(void)
+{
+    return OGRE_NEW BVHNode(this);
+}
+//-----------------------------------------------------------------------
+SceneNode* BVHSceneManager::createSceneNodeImpl(const String& name)
+{
+    return OGRE_NEW BVHNode(this, name);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::_updateBVHNode(BVHNode* node)
+{
+    const AxisAlignedBox& box = node->_getWorldAABB();
+
+    if (box.isNull() || box.isInfinite())
+    {
+        if (node->getProxy() != -1)
+        {
+            mTree.remove(node->getProxy());
+            node->setProxy(-1);
+        }
+        if (box.isInfinite() && !node->isUnbounded())
+        {
+            mUnboundedNodes.insert(node);
+            node->setUnbounded(true);
+        }
+        else if (box.isNull() && node->isUnbounded())
+        {
+            mUnboundedNodes.erase(node);
+            node->setUnbounded(false);
+        }
+        return;
+    }
+
+    if (node->isUnbounded())
+    {
+        mUnboundedNodes.erase(node);
+        node->setUnbounded(false);
+    }
+
+    if (node->getProxy() == -1)
+        node->setProxy(mTree.insert(node, box));
+    else
+        mTree.move(node->getProxy(), box);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::_removeBVHNode(BVHNode* node)
+{
+    if (node->getProxy() != -1)
+    {
+        mTree.remove(node->getProxy());
+        node->setProxy(-1);
+    }
+    if (node->isUnbounded())
+    {
+        mUnboundedNodes.erase(node);
+        node->setUnbounded(false);
+    }
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::_findVisibleObjects(Camera* cam,
+    VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+{
+    mTree.update();
+
+    // Same planes as Camera::isVisible, without the far one when infinite
+    const Frustum* frustum = cam->getCullingFrustum() ? cam->getCullingFrustum() : cam;
+    const Plane* frustumPlanes = frustum->getFrustumPlanes();
+    Plane planes[6];
+    size_t numPlanes = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        if (i == FRUSTUM_PLANE_FAR && frustum->getFarClipDistance() == 0)
+            continue;
+        planes[numPlanes++] = frustumPlanes[i];
+    }
+
+    // Occlusion cull the cameras the scene is rendered from, not shadow cameras
+    mActiveCuller = 0;
+    if (mOcclusionCulling && !onlyShadowCasters && mIlluminationStage != IRS_RENDER_TO_TEXTURE &&
+        mDestRenderSystem->getCapabilities()->hasCapability(RSC_HWOCCLUSION))
+    {
+        mActiveCuller = getOcclusionCuller(cam);
+        mActiveCuller->setVisibilityThreshold(mOcclusionThreshold);
+        mActiveCuller->setQueryInterval(mOcclusionQueryInterval);
+        mActiveCuller->beginFrame(cam);
+    }
+
+    // The occluders are found by a first walk of the tree without occlusion
+    BVHTree::Visitor* visitor = mActiveCuller;
+    bool softwareOcclusion = mSoftwareOcclusionEnabled && !onlyShadowCasters &&
+        mIlluminationStage != IRS_RENDER_TO_TEXTURE;
+    if (softwareOcclusion)
+    {
+        mVisibleNodes.clear();
+        mTree.findVisible(planes, numPlanes, mVisibleNodes);
+        findOccluders(mVisibleNodes);
+        mSoftwareOcclusion->render(cam, mOccluders);
+        mSoftwareOcclusion->setNextVisitor(mActiveCuller);
+        visitor = mSoftwareOcclusion;
+    }
+
+    mVisibleNodes.clear();
+    mTree.findVisible(planes, numPlanes, mVisibleNodes, visitor);
+    addUnboundedNodes(mVisibleNodes, 0);
+
+    RenderQueue* queue = getRenderQueue();
+    BVHTree::SceneNodeList::iterator it, itend = mVisibleNodes.end();
+    for (it = mVisibleNodes.begin(); it != itend; ++it)
+    {
+        static_cast<BVHNode*>(*it)->_addToRenderQueue(cam, queue, onlyShadowCasters,
+            visibleBounds, mDisplayNodes);
+    }
+
+    if (mActiveCuller || softwareOcclusion)
+    {
+        // With both, the hardware culler only sees what software occlusion let through
+        size_t culled = 0, visible = 0;
+        if (mActiveCuller)
+        {
+            culled += mActiveCuller->getNumCulledNodes();
+            visible = mActiveCuller->getNumVisibleNodes();
+        }
+        if (softwareOcclusion)
+        {
+            culled += mSoftwareOcclusion->getNumCulledNodes();
+            visible = mSoftwareOcclusion->getNumVisibleNodes();
+        }
+        size_t total = culled + visible;
+        mOcclusionCulledPercentage = total ? 100 * Real(culled) / total : 0;
+
+        if (mShowOcclusionCulled)
+        {
+            if (mActiveCuller)
+                drawCulledBoxes(mActiveCuller->getCulledTreeNodes());
+            if (softwareOcclusion)
+                drawCulledBoxes(mSoftwareOcclusion->getCulledTreeNodes());
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::findOccluders(const BVHTree::SceneNodeList& nodes)
+{
+    mOccluders.clear();
+    uint32 visibilityMask = _getCombinedVisibilityMask();
+    BVHTree::SceneNodeList::const_iterator it, itend = nodes.end();
+    for (it = nodes.begin(); it != itend; ++it)
+    {
+        SceneNode::ObjectIterator objects = (*it)->getAttachedObjectIterator();
+        while (objects.hasMoreElements())
+        {
+            MovableObject* object = objects.getNext();
+            if (object->isOccluder() && object->isVisible() &&
+                (object->getVisibilityFlags() & visibilityMask) &&
+                object->getMovableType() == EntityFactory::FACTORY_TYPE_NAME)
+            {
+                mOccluders.push_back(static_cast<Entity*>(object));
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::drawCulledBoxes(const vector<int32>::type& culledNodes)
+{
+    DebugDrawer* drawer = getDebugDrawer();
+    for (size_t i = 0; i < culledNodes.size(); ++i)
+        drawer->drawBox(mTree.getNodeBounds(culledNodes[i]));
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::_renderVisibleObjects(void)
+{
+    SceneManager::_renderVisibleObjects();
+
+    if (!mActiveCuller)
+        return;
+
+    // One batch of queries after the scene is in the depth buffer
+    if (!mOcclusionProxy)
+        mOcclusionProxy = OGRE_NEW BVHOcclusionProxy();
+    _setPass(mOcclusionProxy->getPass(), false, false);
+    mActiveCuller->issueQueries(this);
+    mOcclusionQueries = mActiveCuller->getNumQueries();
+    mActiveCuller = 0;
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::renderOcclusionProxy(const AxisAlignedBox& box)
+{
+    mOcclusionProxy->setBox(box);
+    renderSingleObject(mOcclusionProxy, mOcclusionProxy->getPass(), false, false);
+}
+//-----------------------------------------------------------------------
+BVHOcclusionCuller* BVHSceneManager::getOcclusionCuller(const Camera* cam)
+{
+    OcclusionCullerMap::iterator it = mOcclusionCullers.find(cam);
+    if (it != mOcclusionCullers.end())
+        return it->second;
+
+    BVHOcclusionCuller* culler = OGRE_NEW BVHOcclusionCuller(mTree, mDestRenderSystem);
+    mOcclusionCullers[cam] = culler;
+    return culler;
+}
+//-----------------------------------------------------------------------
+BVHSoftwareOcclusion* BVHSceneManager::getSoftwareOcclusion(void)
+{
+    if (!mSoftwareOcclusion)
+        mSoftwareOcclusion = OGRE_NEW BVHSoftwareOcclusion(mTree);
+    return mSoftwareOcclusion;
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::destroyOcclusionCullers(void)
+{
+    OcclusionCullerMap::iterator it, itend = mOcclusionCullers.end();
+    for (it = mOcclusionCullers.begin(); it != itend; ++it)
+        OGRE_DELETE it->second;
+    mOcclusionCullers.clear();
+    mActiveCuller = 0;
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::destroyCamera(Camera* cam)
+{
+    SceneManager::destroyCamera(cam);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::destroyCamera(const String& name)
+{
+    CameraList::iterator i = mCameras.find(name);
+    if (i != mCameras.end())
+    {
+        OcclusionCullerMap::iterator it = mOcclusionCullers.find(i->second);
+        if (it != mOcclusionCullers.end())
+        {
+            if (mActiveCuller == it->second)
+                mActiveCuller = 0;
+            OGRE_DELETE it->second;
+            mOcclusionCullers.erase(it);
+        }
+    }
+
+    SceneManager::destroyCamera(name);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::addUnboundedNodes(BVHTree::SceneNodeList& list, SceneNode* exclude)
+{
+    set<BVHNode*>::type::iterator it, itend = mUnboundedNodes.end();
+    for (it = mUnboundedNodes.begin(); it != itend; ++it)
+    {
+        if (*it != exclude)
+            list.push_back(*it);
+    }
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::updateTree(void)
+{
+    // Queries may run on several threads, only one of them refits the tree
+    OGRE_WQ_LOCK_MUTEX(mTreeMutex);
+    mTree.update();
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::findNodesIn(const AxisAlignedBox& box, BVHTree::SceneNodeList& list, SceneNode* exclude)
+{
+    if (box.isNull())
+        return;
+
+    updateTree();
+    size_t first = list.size();
+    mTree.findNodesIn(box, list);
+    list.erase(std::remove(list.begin() + first, list.end(), exclude), list.end());
+    addUnboundedNodes(list, exclude);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::findNodesIn(const Sphere& sphere, BVHTree::SceneNodeList& list, SceneNode* exclude)
+{
+    updateTree();
+    size_t first = list.size();
+    mTree.findNodesIn(sphere, list);
+    list.erase(std::remove(list.begin() + first, list.end(), exclude), list.end());
+    addUnboundedNodes(list, exclude);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::findNodesIn(const PlaneBoundedVolume& volume, BVHTree::SceneNodeList& list, SceneNode* exclude)
+{
+    updateTree();
+    size_t first = list.size();
+    mTree.findNodesIn(volume, list);
+    list.erase(std::remove(list.begin() + first, list.end(), exclude), list.end());
+    addUnboundedNodes(list, exclude);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::findNodesIn(const Ray& ray, BVHTree::SceneNodeList& list, SceneNode* exclude)
+{
+    updateTree();
+    size_t first = list.size();
+    mTree.findNodesIn(ray, list);
+    list.erase(std::remove(list.begin() + first, list.end(), exclude), list.end());
+    addUnboundedNodes(list, exclude);
+}
+//-----------------------------------------------------------------------
+bool BVHSceneManager::setOption(const String& key, const void* val)
+{
+    if (key == "FatMargin")
+    {
+        mTree.setFatMargin(*static_cast<const Real*>(val));
+        return true;
+    }
+    else if (key == "RebuildRatio")
+    {
+        mTree.setRebuildRatio(*static_cast<const Real*>(val));
+        return true;
+    }
+    else if (key == "Rebuild")
+    {
+        mTree.rebuild();
+        return true;
+    }
+    else if (key == "OcclusionCulling")
+    {
+        mOcclusionCulling = *static_cast<const bool*>(val);
+        // Start over when turned on again, the old state is meaningless
+        if (!mOcclusionCulling)
+            destroyOcclusionCullers();
+        return true;
+    }
+    else if (key == "OcclusionThreshold")
+    {
+        mOcclusionThreshold = *static_cast<const uint32*>(val);
+        return true;
+    }
+    else if (key == "OcclusionQueryInterval")
+    {
+        mOcclusionQueryInterval = *static_cast<const uint32*>(val);
+        return true;
+    }
+    else if (key == "ShowOcclusionCulled")
+    {
+        mShowOcclusionCulled = *static_cast<const bool*>(val);
+        return true;
+    }
+    else if (key == "SoftwareOcclusion")
+    {
+        mSoftwareOcclusionEnabled = *static_cast<const bool*>(val);
+        if (mSoftwareOcclusionEnabled)
+            getSoftwareOcclusion();
+        return true;
+    }
+    else if (key == "SoftwareOcclusionWidth")
+    {
+        BVHSoftwareOcclusion* occlusion = getSoftwareOcclusion();
+        occlusion->setResolution(*static_cast<const uint32*>(val), occlusion->getHeight());
+        return true;
+    }
+    else if (key == "SoftwareOcclusionHeight")
+    {
+        BVHSoftwareOcclusion* occlusion = getSoftwareOcclusion();
+        occlusion->setResolution(occlusion->getWidth(), *static_cast<const uint32*>(val));
+        return true;
+    }
+    else if (key == "MaxOccluders")
+    {
+        getSoftwareOcclusion()->setMaxOccluders(*static_cast<const size_t*>(val));
+        return true;
+    }
+
+    return SceneManager::setOption(key, val);
+}
+//-----------------------------------------------------------------------
+bool BVHSceneManager::getOption(const String& key, void* val)
+{
+    if (key == "FatMargin")
+    {
+        *static_cast<Real*>(val) = mTree.getFatMargin();
+        return true;
+    }
+    else if (key == "RebuildRatio")
+    {
+        *static_cast<Real*>(val) = mTree.getRebuildRatio();
+        return true;
+    }
+    else if (key == "NumRebuilds")
+    {
+        *static_cast<size_t*>(val) = mTree.getNumRebuilds();
+        return true;
+    }
+    else if (key == "OcclusionCulling")
+    {
+        *static_cast<bool*>(val) = mOcclusionCulling;
+        return true;
+    }
+    else if (key == "OcclusionThreshold")
+    {
+        *static_cast<uint32*>(val) = mOcclusionThreshold;
+        return true;
+    }
+    else if (key == "OcclusionQueryInterval")
+    {
+        *static_cast<uint32*>(val) = mOcclusionQueryInterval;
+        return true;
+    }
+    else if (key == "ShowOcclusionCulled")
+    {
+        *static_cast<bool*>(val) = mShowOcclusionCulled;
+        return true;
+    }
+    else if (key == "OcclusionCulledPercentage")
+    {
+        *static_cast<Real*>(val) = mOcclusionCulledPercentage;
+        return true;
+    }
+    else if (key == "OcclusionQueries")
+    {
+        *static_cast<size_t*>(val) = mOcclusionQueries;
+        return true;
+    }
+    else if (key == "SoftwareOcclusion")
+    {
+        *static_cast<bool*>(val) = mSoftwareOcclusionEnabled;
+        return true;
+    }
+    else if (key == "SoftwareOcclusionWidth")
+    {
+        *static_cast<uint32*>(val) = getSoftwareOcclusion()->getWidth();
+        return true;
+    }
+    else if (key == "SoftwareOcclusionHeight")
+    {
+        *static_cast<uint32*>(val) = getSoftwareOcclusion()->getHeight();
+        return true;
+    }
+    else if (key == "MaxOccluders")
+    {
+        *static_cast<size_t*>(val) = getSoftwareOcclusion()->getMaxOccluders();
+        return true;
+    }
+    else if (key == "NumOccluders")
+    {
+        *static_cast<size_t*>(val) = mSoftwareOcclusion ? mSoftwareOcclusion->getNumOccluders() : 0;
+        return true;
+    }
+    else if (key == "OccluderTriangles")
+    {
+        *static_cast<size_t*>(val) = mSoftwareOcclusion ? mSoftwareOcclusion->getNumTriangles() : 0;
+        return true;
+    }
+
+    return SceneManager::getOption(key, val);
+}
+//-----------------------------------------------------------------------
+bool BVHSceneManager::getOptionKeys(StringVector& refKeys)
+{
+    SceneManager::getOptionKeys(refKeys);
+    refKeys.push_back("FatMargin");
+    refKeys.push_back("RebuildRatio");
+    refKeys.push_back("NumRebuilds");
+    refKeys.push_back("OcclusionCulling");
+    refKeys.push_back("OcclusionThreshold");
+    refKeys.push_back("OcclusionQueryInterval");
+    refKeys.push_back("ShowOcclusionCulled");
+    refKeys.push_back("OcclusionCulledPercentage");
+    refKeys.push_back("OcclusionQueries");
+    refKeys.push_back("SoftwareOcclusion");
+    refKeys.push_back("SoftwareOcclusionWidth");
+    refKeys.push_back("SoftwareOcclusionHeight");
+    refKeys.push_back("MaxOccluders");
+    refKeys.push_back("NumOccluders");
+    refKeys.push_back("OccluderTriangles");
+    return true;
+}
+//-----------------------------------------------------------------------
+void BVHSceneManager::clearScene(void)
+{
+    SceneManager::clearScene();
+    mTree.clear();
+    mUnboundedNodes.clear();
+}
+//-----------------------------------------------------------------------
+AxisAlignedBoxSceneQuery*
+BVHSceneManager::createAABBQuery(const AxisAlignedBox& box, uint32 mask)
+{
+    BVHAxisAlignedBoxSceneQuery* q = OGRE_NEW BVHAxisAlignedBoxSceneQuery(this);
+    q->setBox(box);
+    q->setQueryMask(mask);
+    return q;
+}
+//-----------------------------------------------------------------------
+SphereSceneQuery*
+BVHSceneManager::createSphereQuery(const Sphere& sphere, uint32 mask)
+{
+    BVHSphereSceneQuery* q = OGRE_NEW BVHSphereSceneQuery(this);
+    q->setSphere(sphere);
+    q->setQueryMask(mask);
+    return q;
+}
+//-----------------------------------------------------------------------
+PlaneBoundedVolumeListSceneQuery*
+BVHSceneManager::createPlaneBoundedVolumeQuery(const PlaneBoundedVolumeList& volumes, uint32 mask)
+{
+    BVHPlaneBoundedVolumeListSceneQuery* q = OGRE_NEW BVHPlaneBoundedVolumeListSceneQuery(this);
+    q->setVolumes(volumes);
+    q->setQueryMask(mask);
+    return q;
+}
+//-----------------------------------------------------------------------
+RaySceneQuery*
+BVHSceneManager::createRayQuery(const Ray& ray, uint32 mask)
+{
+    BVHRaySceneQuery* q = OGRE_NEW BVHRaySceneQuery(this);
+    q->setRay(ray);
+    q->setQueryMask(mask);
+    return q;
+}
+//-----------------------------------------------------------------------
+IntersectionSceneQuery*
+BVHSceneManager::createIntersectionQuery(uint32 mask)
+{
+    BVHIntersectionSceneQuery* q = OGRE_NEW BVHIntersectionSceneQuery(this);
+    q->setQueryMask(mask);
+    return q;
+}
+//-----------------------------------------------------------------------
+const String BVHSceneManagerFactory::FACTORY_TYPE_NAME = "BVHSceneManager";
+//-----------------------------------------------------------------------
+void BVHSceneManagerFactory::initMetaData(void) const
+{
+    mMetaData.typeName = FACTORY_TYPE_NAME;
+    mMetaData.description = "Scene manager organising the scene in a dynamic bounding volume hierarchy.";
+    mMetaData.sceneTypeMask = 0xFFFF; // support all types
+    mMetaData.worldGeometrySupported = false;
+}
+//-----------------------------------------------------------------------
+SceneManager* BVHSceneManagerFactory::createInstance(const String& instanceName)
+{
+    return OGRE_NEW BVHSceneManager(instanceName);
+}
+//-----------------------------------------------------------------------
+void BVHSceneManagerFactory::destroyInstance(SceneManager* instance)
+{
+    OGRE_DELETE instance;
+}
+
+}
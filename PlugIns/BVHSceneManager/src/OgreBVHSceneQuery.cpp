@@ -0,0 +1,262 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHSceneQuery.h"
+#include "OgreBVHSceneManager.h"
+#include "OgreRoot.h"
+#include "OgreSceneNode.h"
+#include "OgreEntity.h"
+
+namespace Ogre
+{
+namespace
+{
+    /** Reports the objects of the nodes intersecting the volume, and the
+        objects attached to them if they are entities. */
+    template <typename Volume>
+    void reportObjects(const BVHTree::SceneNodeList& nodes, const Volume& volume,
+        uint32 queryMask, uint32 queryTypeMask, SceneQueryListener* listener)
+    {
+        BVHTree::SceneNodeList::const_iterator it, itend = nodes.end();
+        for (it = nodes.begin(); it != itend; ++it)
+        {
+            SceneNode::ObjectIterator oit = (*it)->getAttachedObjectIterator();
+            while (oit.hasMoreElements())
+            {
+                MovableObject* m = oit.getNext();
+                if (!(m->getQueryFlags() & queryMask) ||
+                    !(m->getTypeFlags() & queryTypeMask) ||
+                    !m->isInScene() ||
+                    !volume.intersects(m->getWorldBoundingBox()))
+                    continue;
+
+                listener->queryResult(m);
+                // deal with attached objects, since they are not directly attached to nodes
+                if (m->getMovableType() == "Entity")
+                {
+                    Entity* e = static_cast<Entity*>(m);
+                    Entity::ChildObjectListIterator childIt = e->getAttachedObjectIterator();
+                    while (childIt.hasMoreElements())
+                    {
+                        MovableObject* c = childIt.getNext();
+                        if ((c->getQueryFlags() & queryMask) &&
+                            volume.intersects(c->getWorldBoundingBox()))
+                        {
+                            listener->queryResult(c);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------
+BVHIntersectionSceneQuery::BVHIntersectionSceneQuery(SceneManager* creator)
+    : DefaultIntersectionSceneQuery(creator)
+{
+}
+//-----------------------------------------------------------------------
+BVHIntersectionSceneQuery::~BVHIntersectionSceneQuery()
+{
+}
+//-----------------------------------------------------------------------
+void BVHIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+{
+    BVHSceneManager* sceneMgr = static_cast<BVHSceneManager*>(mParentSceneMgr);
+
+    // Iterate over all movable types
+    Root::MovableObjectFactoryIterator factIt =
+        Root::getSingleton().getMovableObjectFactoryIterator();
+    while (factIt.hasMoreElements())
+    {
+        SceneManager::MovableObjectIterator it =
+            mParentSceneMgr->getMovableObjectIterator(factIt.getNext()->getType());
+        while (it.hasMoreElements())
+        {
+            MovableObject* a = it.getNext();
+            if (!(a->getQueryFlags() & mQueryMask) ||
+                !(a->getTypeFlags() & mQueryTypeMask) ||
+                !a->isInScene())
+                continue;
+
+            const AxisAlignedBox& box = a->getWorldBoundingBox();
+            mNodes.clear();
+            sceneMgr->findNodesIn(box, mNodes);
+
+            BVHTree::SceneNodeList::iterator nit, nitend = mNodes.end();
+            for (nit = mNodes.begin(); nit != nitend; ++nit)
+            {
+                SceneNode::ObjectIterator oit = (*nit)->getAttachedObjectIterator();
+                while (oit.hasMoreElements())
+                {
+                    MovableObject* b = oit.getNext();
+                    // Every pair is found from both sides, only report it from one
+                    if (b <= a ||
+                        !(b->getQueryFlags() & mQueryMask) ||
+                        !(b->getTypeFlags() & mQueryTypeMask) ||
+                        !b->isInScene() ||
+                        !box.intersects(b->getWorldBoundingBox()))
+                        continue;
+
+                    listener->queryResult(a, b);
+                    // deal with attached objects, since they are not directly attached to nodes
+                    if (b->getMovableType() == "Entity")
+                    {
+                        Entity* e = static_cast<Entity*>(b);
+                        Entity::ChildObjectListIterator childIt = e->getAttachedObjectIterator();
+                        while (childIt.hasMoreElements())
+                        {
+                            MovableObject* c = childIt.getNext();
+                            if ((c->getQueryFlags() & mQueryMask) &&
+                                box.intersects(c->getWorldBoundingBox()))
+                            {
+                                listener->queryResult(a, c);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------
+BVHAxisAlignedBoxSceneQuery::BVHAxisAlignedBoxSceneQuery(SceneManager* creator)
+    : DefaultAxisAlignedBoxSceneQuery(creator)
+{
+}
+//-----------------------------------------------------------------------
+BVHAxisAlignedBoxSceneQuery::~BVHAxisAlignedBoxSceneQuery()
+{
+}
+//-----------------------------------------------------------------------
+void BVHAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
+{
+    mNodes.clear();
+    static_cast<BVHSceneManager*>(mParentSceneMgr)->findNodesIn(mAABB, mNodes);
+    reportObjects(mNodes, mAABB, mQueryMask, mQueryTypeMask, listener);
+}
+//-----------------------------------------------------------------------
+BVHRaySceneQuery::BVHRaySceneQuery(SceneManager* creator)
+    : DefaultRaySceneQuery(creator)
+{
+}
+//-----------------------------------------------------------------------
+BVHRaySceneQuery::~BVHRaySceneQuery()
+{
+}
+//-----------------------------------------------------------------------
+void BVHRaySceneQuery::execute(RaySceneQueryListener* listener)
+{
+    mNodes.clear();
+    static_cast<BVHSceneManager*>(mParentSceneMgr)->findNodesIn(mRay, mNodes);
+
+    BVHTree::SceneNodeList::iterator it, itend = mNodes.end();
+    for (it = mNodes.begin(); it != itend; ++it)
+    {
+        SceneNode::ObjectIterator oit = (*it)->getAttachedObjectIterator();
+        while (oit.hasMoreElements())
+        {
+            MovableObject* m = oit.getNext();
+            if (!(m->getQueryFlags() & mQueryMask) ||
+                !(m->getTypeFlags() & mQueryTypeMask) ||
+                !m->isInScene())
+                continue;
+
+            std::pair<bool, Real> result = mRay.intersects(m->getWorldBoundingBox());
+            if (!result.first)
+                continue;
+
+            listener->queryResult(m, result.second);
+            // deal with attached objects, since they are not directly attached to nodes
+            if (m->getMovableType() == "Entity")
+            {
+                Entity* e = static_cast<Entity*>(m);
+                Entity::ChildObjectListIterator childIt = e->getAttachedObjectIterator();
+                while (childIt.hasMoreElements())
+                {
+                    MovableObject* c = childIt.getNext();
+                    if (c->getQueryFlags() & mQueryMask)
+                    {
+                        result = mRay.intersects(c->getWorldBoundingBox());
+                        if (result.first)
+                            listener->queryResult(c, result.second);
+                    }
+                }
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------
+BVHSphereSceneQuery::BVHSphereSceneQuery(SceneManager* creator)
+    : DefaultSphereSceneQuery(creator)
+{
+}
+//-----------------------------------------------------------------------
+BVHSphereSceneQuery::~BVHSphereSceneQuery()
+{
+}
+//-----------------------------------------------------------------------
+void BVHSphereSceneQuery::execute(SceneQueryListener* listener)
+{
+    mNodes.clear();
+    static_cast<BVHSceneManager*>(mParentSceneMgr)->findNodesIn(mSphere, mNodes);
+    reportObjects(mNodes, mSphere, mQueryMask, mQueryTypeMask, listener);
+}
+//-----------------------------------------------------------------------
+BVHPlaneBoundedVolumeListSceneQuery::BVHPlaneBoundedVolumeListSceneQuery(SceneManager* creator)
+    : DefaultPlaneBoundedVolumeListSceneQuery(creator)
+{
+}
+//-----------------------------------------------------------------------
+BVHPlaneBoundedVolumeListSceneQuery::~BVHPlaneBoundedVolumeListSceneQuery()
+{
+}
+//-----------------------------------------------------------------------
+void BVHPlaneBoundedVolumeListSceneQuery::execute(SceneQueryListener* listener)
+{
+    BVHSceneManager* sceneMgr = static_cast<BVHSceneManager*>(mParentSceneMgr);
+    set<SceneNode*>::type checkedSceneNodes;
+    BVHTree::SceneNodeList unchecked;
+
+    PlaneBoundedVolumeList::iterator pi, piend = mVolumes.end();
+    for (pi = mVolumes.begin(); pi != piend; ++pi)
+    {
+        mNodes.clear();
+        sceneMgr->findNodesIn(*pi, mNodes);
+
+        // avoid double-check same scene node
+        unchecked.clear();
+        for (size_t i = 0; i < mNodes.size(); ++i)
+        {
+            if (checkedSceneNodes.insert(mNodes[i]).second)
+                unchecked.push_back(mNodes[i]);
+        }
+        reportObjects(unchecked, *pi, mQueryMask, mQueryTypeMask, listener);
+    }
+}
+
+}
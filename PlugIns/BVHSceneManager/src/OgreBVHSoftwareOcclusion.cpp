@@ -0,0 +1,526 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHSoftwareOcclusion.h"
+#include "OgreCamera.h"
+#include "OgreEntity.h"
+#include "OgreHardwareIndexBuffer.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreMesh.h"
+#include "OgrePlatformInformation.h"
+#include "OgreSceneNode.h"
+#include "OgreSubMesh.h"
+#include "Threading/OgreParallel.h"
+
+// The plugin has no runtime dispatch, so only use what the compiler targets anyway
+#if __OGRE_HAVE_SSE && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#   define OGRE_BVH_SSE 1
+#   include <xmmintrin.h>
+#elif __OGRE_HAVE_NEON
+#   define OGRE_BVH_NEON 1
+#   include <arm_neon.h>
+#endif
+
+namespace Ogre
+{
+namespace
+{
+    /// Four pixels of a row, the depth buffer is float whatever Real is
+#if OGRE_BVH_SSE
+    typedef __m128 Pixel4;
+
+    inline Pixel4 splat4(float v) { return _mm_set1_ps(v); }
+    inline Pixel4 ramp4(float step) { return _mm_setr_ps(0, step, 2 * step, 3 * step); }
+    inline Pixel4 add4(Pixel4 a, Pixel4 b) { return _mm_add_ps(a, b); }
+    /// Writes max(depth, z) where all edges are non negative, returns false if no pixel was inside
+    inline bool writeDepth4(float* depth, Pixel4 e0, Pixel4 e1, Pixel4 e2, Pixel4 z)
+    {
+        Pixel4 inside = _mm_cmpge_ps(_mm_min_ps(_mm_min_ps(e0, e1), e2), _mm_setzero_ps());
+        if (!_mm_movemask_ps(inside))
+            return false;
+        Pixel4 d = _mm_loadu_ps(depth);
+        Pixel4 nearer = _mm_max_ps(d, z);
+        _mm_storeu_ps(depth, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, d)));
+        return true;
+    }
+#elif OGRE_BVH_NEON
+    typedef float32x4_t Pixel4;
+
+    inline Pixel4 splat4(float v) { return vdupq_n_f32(v); }
+    inline Pixel4 ramp4(float step)
+    {
+        const float v[4] = { 0, step, 2 * step, 3 * step };
+        return vld1q_f32(v);
+    }
+    inline Pixel4 add4(Pixel4 a, Pixel4 b) { return vaddq_f32(a, b); }
+    inline bool writeDepth4(float* depth, Pixel4 e0, Pixel4 e1, Pixel4 e2, Pixel4 z)
+    {
+        uint32x4_t inside = vcgeq_f32(vminq_f32(vminq_f32(e0, e1), e2), vdupq_n_f32(0));
+        uint32x2_t any = vorr_u32(vget_low_u32(inside), vget_high_u32(inside));
+        if (!vget_lane_u32(vpmax_u32(any, any), 0))
+            return false;
+        Pixel4 d = vld1q_f32(depth);
+        vst1q_f32(depth, vbslq_f32(inside, vmaxq_f32(d, z), d));
+        return true;
+    }
+#else
+    struct Pixel4 { float v[4]; };
+
+    inline Pixel4 splat4(float v) { Pixel4 r = { { v, v, v, v } }; return r; }
+    inline Pixel4 ramp4(float step) { Pixel4 r = { { 0, step, 2 * step, 3 * step } }; return r; }
+    inline Pixel4 add4(const Pixel4& a, const Pixel4& b)
+    {
+        Pixel4 r = { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+        return r;
+    }
+    inline bool writeDepth4(float* depth, const Pixel4& e0, const Pixel4& e1, const Pixel4& e2,
+        const Pixel4& z)
+    {
+        bool any = false;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (e0.v[i] >= 0 && e1.v[i] >= 0 && e2.v[i] >= 0)
+            {
+                depth[i] = std::max(depth[i], z.v[i]);
+                any = true;
+            }
+        }
+        return any;
+    }
+#endif
+}
+//-----------------------------------------------------------------------
+struct BVHSoftwareOcclusion::TransformFunc
+{
+    BVHSoftwareOcclusion* occlusion;
+
+    TransformFunc(BVHSoftwareOcclusion* o) : occlusion(o) {}
+    void operator()(size_t index) const { occlusion->transformOccluder(index); }
+};
+//-----------------------------------------------------------------------
+struct BVHSoftwareOcclusion::RasteriseFunc
+{
+    BVHSoftwareOcclusion* occlusion;
+
+    RasteriseFunc(BVHSoftwareOcclusion* o) : occlusion(o) {}
+    void operator()(size_t row) const { occlusion->rasteriseTileRow(static_cast<uint32>(row)); }
+};
+//-----------------------------------------------------------------------
+BVHSoftwareOcclusion::BVHSoftwareOcclusion(const BVHTree& tree)
+    : mTree(tree)
+    , mNextVisitor(0)
+    , mWidth(0)
+    , mHeight(0)
+    , mMaxOccluders(32)
+    , mActive(false)
+    , mViewProj(Matrix4::IDENTITY)
+    , mNearDistance(0)
+    , mNumVisible(0)
+    , mNumCulled(0)
+{
+    setResolution(256, 128);
+}
+//-----------------------------------------------------------------------
+BVHSoftwareOcclusion::~BVHSoftwareOcclusion()
+{
+}
+//-----------------------------------------------------------------------
+void BVHSoftwareOcclusion::setResolution(uint32 width, uint32 height)
+{
+    mWidth = std::max<uint32>((width + TILE_SIZE - 1) / TILE_SIZE, 1) * TILE_SIZE;
+    mHeight = std::max<uint32>((height + TILE_SIZE - 1) / TILE_SIZE, 1) * TILE_SIZE;
+    mDepth.resize(mWidth * mHeight);
+    mTileDepth.resize((mWidth / TILE_SIZE) * (mHeight / TILE_SIZE));
+    mActive = false;
+}
+//-----------------------------------------------------------------------
+size_t BVHSoftwareOcclusion::getNumTriangles(void) const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < mOccluders.size(); ++i)
+        count += mTriangles[i].size();
+    return count;
+}
+//-----------------------------------------------------------------------
+void BVHSoftwareOcclusion::render(const Camera* cam, const vector<Entity*>::type& occluders)
+{
+    mActive = false;
+    mOccluders.clear();
+    mOccluderNodes.clear();
+    mCulledNodes.clear();
+    mNumVisible = 0;
+    mNumCulled = 0;
+
+    if (cam->getProjectionType() != PT_PERSPECTIVE)
+        return;
+
+    mViewProj = cam->getProjectionMatrix() * cam->getViewMatrix(true);
+    mNearDistance = static_cast<float>(cam->getNearClipDistance());
+    const Vector3& camPos = cam->getDerivedPosition();
+    Real minDistSq = cam->getNearClipDistance() * cam->getNearClipDistance();
+
+    for (size_t i = 0; i < occluders.size(); ++i)
+    {
+        Entity* entity = occluders[i];
+        if (entity->hasSkeleton() || entity->hasVertexAnimation())
+            continue;
+        const AxisAlignedBox& box = entity->getWorldBoundingBox(true);
+        if (!box.isFinite())
+            continue;
+
+        Occluder occluder;
+        occluder.mesh = &getOccluderMesh(entity->getMesh());
+        occluder.transform = mViewProj * entity->_getParentNodeFullTransform();
+        occluder.size = box.getHalfSize().squaredLength() /
+            std::max(camPos.squaredDistance(box.getCenter()), minDistSq);
+        occluder.node = entity->getParentSceneNode();
+        mOccluders.push_back(occluder);
+    }
+    if (mOccluders.empty())
+        return;
+
+    std::sort(mOccluders.begin(), mOccluders.end());
+    if (mOccluders.size() > mMaxOccluders)
+        mOccluders.resize(mMaxOccluders);
+    for (size_t i = 0; i < mOccluders.size(); ++i)
+        mOccluderNodes.push_back(mOccluders[i].node);
+    std::sort(mOccluderNodes.begin(), mOccluderNodes.end());
+
+    if (mTriangles.size() < mOccluders.size())
+    {
+        mTriangles.resize(mOccluders.size());
+        mClipVertices.resize(mOccluders.size());
+    }
+    parallelFor(0, mOccluders.size(), TransformFunc(this));
+
+    std::fill(mDepth.begin(), mDepth.end(), 0.0f);
+    parallelFor(0, mHeight / TILE_SIZE, RasteriseFunc(this));
+    mActive = true;
+}
+//-----------------------------------------------------------------------
+const BVHSoftwareOcclusion::OccluderMesh& BVHSoftwareOcclusion::getOccluderMesh(const MeshPtr& mesh)
+{
+    OccluderMesh& occluderMesh = mOccluderMeshes[mesh.get()];
+    if (occluderMesh.mesh == mesh && occluderMesh.stateCount == mesh->getStateCount())
+        return occluderMesh;
+
+    occluderMesh.mesh = mesh;
+    occluderMesh.stateCount = mesh->getStateCount();
+    occluderMesh.positions.clear();
+    occluderMesh.indices.clear();
+
+    // Positions of the shared vertices are only read once
+    size_t sharedBase = ~size_t(0);
+    for (unsigned short s = 0; s < mesh->getNumSubMeshes(); ++s)
+    {
+        SubMesh* sub = mesh->getSubMesh(s);
+        if (sub->operationType != RenderOperation::OT_TRIANGLE_LIST || !sub->indexData->indexCount)
+            continue;
+
+        const VertexData* vertexData = sub->useSharedVertices ? mesh->sharedVertexData : sub->vertexData;
+        size_t base = sub->useSharedVertices ? sharedBase : ~size_t(0);
+        if (base == ~size_t(0))
+        {
+            base = occluderMesh.positions.size();
+            if (sub->useSharedVertices)
+                sharedBase = base;
+
+            const VertexElement* element =
+                vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+            const HardwareVertexBufferSharedPtr& vbuf =
+                vertexData->vertexBufferBinding->getBuffer(element->getSource());
+            HardwareBufferLockGuard<HardwareVertexBufferSharedPtr> lock(vbuf, HardwareBuffer::HBL_READ_ONLY);
+            unsigned char* vertex = static_cast<unsigned char*>(lock.pData) +
+                vertexData->vertexStart * vbuf->getVertexSize();
+            for (size_t v = 0; v < vertexData->vertexCount; ++v, vertex += vbuf->getVertexSize())
+            {
+                float* position;
+                element->baseVertexPointerToElement(vertex, &position);
+                occluderMesh.positions.push_back(Vector3(position[0], position[1], position[2]));
+            }
+        }
+
+        const IndexData* indexData = sub->indexData;
+        const HardwareIndexBufferSharedPtr& ibuf = indexData->indexBuffer;
+        HardwareBufferLockGuard<HardwareIndexBufferSharedPtr> lock(ibuf,
+            indexData->indexStart * ibuf->getIndexSize(), indexData->indexCount * ibuf->getIndexSize(),
+            HardwareBuffer::HBL_READ_ONLY);
+        for (size_t i = 0; i < indexData->indexCount; ++i)
+        {
+            uint32 index = ibuf->getType() == HardwareIndexBuffer::IT_32BIT ?
+                static_cast<const uint32*>(lock.pData)[i] : static_cast<const uint16*>(lock.pData)[i];
+            occluderMesh.indices.push_back(static_cast<uint32>(base + index));
+        }
+    }
+    return occluderMesh;
+}
+//-----------------------------------------------------------------------
+void BVHSoftwareOcclusion::transformOccluder(size_t index)
+{
+    const Occluder& occluder = mOccluders[index];
+    const OccluderMesh& mesh = *occluder.mesh;
+    const Matrix4& m = occluder.transform;
+    ScreenTriangleList& triangles = mTriangles[index];
+    vector<Vector3>::type& clip = mClipVertices[index];
+    triangles.clear();
+
+    // Only x, y and w are needed, 1 / w is the depth
+    clip.resize(mesh.positions.size());
+    for (size_t i = 0; i < mesh.positions.size(); ++i)
+    {
+        const Vector3& p = mesh.positions[i];
+        clip[i].x = m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3];
+        clip[i].y = m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3];
+        clip[i].z = m[3][0] * p.x + m[3][1] * p.y + m[3][2] * p.z + m[3][3];
+    }
+
+    const float width = static_cast<float>(mWidth);
+    const float height = static_cast<float>(mHeight);
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+    {
+        const Vector3* in[3] = { &clip[mesh.indices[i]], &clip[mesh.indices[i + 1]], &clip[mesh.indices[i + 2]] };
+
+        // Clip against the near plane, which leaves up to four corners
+        Vector3 polygon[4];
+        size_t count = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            const Vector3& a = *in[k];
+            const Vector3& b = *in[(k + 1) % 3];
+            bool aInside = a.z >= mNearDistance;
+            bool bInside = b.z >= mNearDistance;
+            if (aInside)
+                polygon[count++] = a;
+            if (aInside != bInside)
+                polygon[count++] = a + (b - a) * ((mNearDistance - a.z) / (b.z - a.z));
+        }
+        if (count < 3)
+            continue;
+
+        float x[4], y[4], z[4];
+        for (size_t k = 0; k < count; ++k)
+        {
+            z[k] = 1.0f / static_cast<float>(polygon[k].z);
+            x[k] = (0.5f + 0.5f * static_cast<float>(polygon[k].x) * z[k]) * width;
+            y[k] = (0.5f - 0.5f * static_cast<float>(polygon[k].y) * z[k]) * height;
+        }
+
+        for (size_t k = 1; k + 1 < count; ++k)
+        {
+            size_t c[3] = { 0, k, k + 1 };
+            // Drawn two sided, so turn every triangle the same way
+            float area = (x[c[1]] - x[0]) * (y[c[2]] - y[0]) - (y[c[1]] - y[0]) * (x[c[2]] - x[0]);
+            if (std::abs(area) < 1e-6f)
+                continue;
+            if (area < 0)
+                std::swap(c[1], c[2]);
+
+            ScreenTriangle tri;
+            for (int j = 0; j < 3; ++j)
+            {
+                tri.x[j] = x[c[j]];
+                tri.y[j] = y[c[j]];
+                tri.z[j] = z[c[j]];
+            }
+            if ((tri.x[0] < 0 && tri.x[1] < 0 && tri.x[2] < 0) ||
+                (tri.x[0] > width && tri.x[1] > width && tri.x[2] > width) ||
+                (tri.y[0] < 0 && tri.y[1] < 0 && tri.y[2] < 0) ||
+                (tri.y[0] > height && tri.y[1] > height && tri.y[2] > height))
+                continue;
+            triangles.push_back(tri);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void BVHSoftwareOcclusion::rasteriseTileRow(uint32 row)
+{
+    const int rowBegin = static_cast<int>(row * TILE_SIZE);
+    const int rowEnd = rowBegin + static_cast<int>(TILE_SIZE);
+    const float lastX = static_cast<float>(mWidth - 1);
+
+    for (size_t o = 0; o < mOccluders.size(); ++o)
+    {
+        const ScreenTriangleList& triangles = mTriangles[o];
+        for (size_t t = 0; t < triangles.size(); ++t)
+        {
+            const ScreenTriangle& tri = triangles[t];
+            float minY = std::min(std::min(tri.y[0], tri.y[1]), tri.y[2]);
+            float maxY = std::max(std::max(tri.y[0], tri.y[1]), tri.y[2]);
+            if (maxY < rowBegin || minY >= rowEnd)
+                continue;
+            float minX = std::max(std::min(std::min(tri.x[0], tri.x[1]), tri.x[2]), 0.0f);
+            float maxX = std::min(std::max(std::max(tri.x[0], tri.x[1]), tri.x[2]), lastX);
+            int x0 = static_cast<int>(minX) & ~3;
+            int x1 = static_cast<int>(maxX);
+            int y0 = static_cast<int>(std::max(minY, static_cast<float>(rowBegin)));
+            int y1 = static_cast<int>(std::min(maxY, static_cast<float>(rowEnd - 1)));
+
+            // Edge k runs from corner k to the next, and is zero on the corner opposite
+            float a[3], b[3], c[3];
+            for (int k = 0; k < 3; ++k)
+            {
+                int n = (k + 1) % 3;
+                a[k] = tri.y[k] - tri.y[n];
+                b[k] = tri.x[n] - tri.x[k];
+                c[k] = -(a[k] * tri.x[k] + b[k] * tri.y[k]);
+            }
+            float invArea = 1.0f / (c[0] + c[1] + c[2]);
+            // Depth as a plane, weighting each corner by the opposite edge
+            float za = (a[1] * tri.z[0] + a[2] * tri.z[1] + a[0] * tri.z[2]) * invArea;
+            float zb = (b[1] * tri.z[0] + b[2] * tri.z[1] + b[0] * tri.z[2]) * invArea;
+            float zc = (c[1] * tri.z[0] + c[2] * tri.z[1] + c[0] * tri.z[2]) * invArea;
+
+            Pixel4 stepE0 = splat4(4 * a[0]), stepE1 = splat4(4 * a[1]), stepE2 = splat4(4 * a[2]);
+            Pixel4 stepZ = splat4(4 * za);
+            Pixel4 rampE0 = ramp4(a[0]), rampE1 = ramp4(a[1]), rampE2 = ramp4(a[2]);
+            Pixel4 rampZ = ramp4(za);
+            float px = x0 + 0.5f;
+
+            for (int y = y0; y <= y1; ++y)
+            {
+                float py = y + 0.5f;
+                Pixel4 e0 = add4(splat4(a[0] * px + b[0] * py + c[0]), rampE0);
+                Pixel4 e1 = add4(splat4(a[1] * px + b[1] * py + c[1]), rampE1);
+                Pixel4 e2 = add4(splat4(a[2] * px + b[2] * py + c[2]), rampE2);
+                Pixel4 z = add4(splat4(za * px + zb * py + zc), rampZ);
+                float* depth = &mDepth[y * mWidth + x0];
+                bool entered = false;
+                for (int x = x0; x <= x1; x += 4, depth += 4)
+                {
+                    // A row of a triangle is a single span, once left it is done
+                    if (writeDepth4(depth, e0, e1, e2, z))
+                        entered = true;
+                    else if (entered)
+                        break;
+                    e0 = add4(e0, stepE0);
+                    e1 = add4(e1, stepE1);
+                    e2 = add4(e2, stepE2);
+                    z = add4(z, stepZ);
+                }
+            }
+        }
+    }
+
+    // Farthest depth of each tile of the row
+    for (uint32 tx = 0; tx < mWidth / TILE_SIZE; ++tx)
+    {
+        float farthest = std::numeric_limits<float>::max();
+        for (int y = rowBegin; y < rowEnd; ++y)
+        {
+            const float* depth = &mDepth[y * mWidth + tx * TILE_SIZE];
+            for (uint32 x = 0; x < TILE_SIZE; ++x)
+                farthest = std::min(farthest, depth[x]);
+        }
+        mTileDepth[row * (mWidth / TILE_SIZE) + tx] = farthest;
+    }
+}
+//-----------------------------------------------------------------------
+void BVHSoftwareOcclusion::project(const Vector3& p, float& x, float& y, float& w) const
+{
+    const Matrix4& m = mViewProj;
+    x = static_cast<float>(m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3]);
+    y = static_cast<float>(m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3]);
+    w = static_cast<float>(m[3][0] * p.x + m[3][1] * p.y + m[3][2] * p.z + m[3][3]);
+}
+//-----------------------------------------------------------------------
+bool BVHSoftwareOcclusion::isOccluded(const AxisAlignedBox& box) const
+{
+    if (!mActive || !box.isFinite())
+        return false;
+
+    // The nearest point of the box is one of its corners
+    const float width = static_cast<float>(mWidth);
+    const float height = static_cast<float>(mHeight);
+    float minX = width, maxX = 0, minY = height, maxY = 0, nearest = 0;
+    const Vector3* corners = box.getAllCorners();
+    for (int i = 0; i < 8; ++i)
+    {
+        float x, y, w;
+        project(corners[i], x, y, w);
+        // Crossing the near plane, so probably in front of any occluder
+        if (w < mNearDistance)
+            return false;
+        float z = 1.0f / w;
+        x = (0.5f + 0.5f * x * z) * width;
+        y = (0.5f - 0.5f * y * z) * height;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        nearest = std::max(nearest, z);
+    }
+    // Off screen, which is for the frustum test to decide
+    if (minX >= width || maxX < 0 || minY >= height || maxY < 0)
+        return false;
+
+    uint32 x0 = static_cast<uint32>(std::max(minX, 0.0f));
+    uint32 x1 = static_cast<uint32>(std::min(maxX, width - 1));
+    uint32 y0 = static_cast<uint32>(std::max(minY, 0.0f));
+    uint32 y1 = static_cast<uint32>(std::min(maxY, height - 1));
+    const uint32 tilesPerRow = mWidth / TILE_SIZE;
+    for (uint32 ty = y0 / TILE_SIZE; ty <= y1 / TILE_SIZE; ++ty)
+    {
+        for (uint32 tx = x0 / TILE_SIZE; tx <= x1 / TILE_SIZE; ++tx)
+        {
+            if (mTileDepth[ty * tilesPerRow + tx] > nearest)
+                continue;
+
+            // Partly covered tile, test the pixels under the box
+            uint32 px0 = std::max(x0, tx * TILE_SIZE), px1 = std::min(x1, tx * TILE_SIZE + TILE_SIZE - 1);
+            uint32 py0 = std::max(y0, ty * TILE_SIZE), py1 = std::min(y1, ty * TILE_SIZE + TILE_SIZE - 1);
+            for (uint32 y = py0; y <= py1; ++y)
+            {
+                const float* depth = &mDepth[y * mWidth];
+                for (uint32 x = px0; x <= px1; ++x)
+                {
+                    if (depth[x] <= nearest)
+                        return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+//-----------------------------------------------------------------------
+bool BVHSoftwareOcclusion::visit(int32 index, bool leaf)
+{
+    // An occluder is not hidden by itself
+    if (mActive && !(leaf && std::binary_search(mOccluderNodes.begin(), mOccluderNodes.end(),
+        mTree.getLeafSceneNode(index))) && isOccluded(mTree.getNodeBounds(index)))
+    {
+        mCulledNodes.push_back(index);
+        mNumCulled += mTree.getNodeLeafCount(index);
+        return false;
+    }
+
+    if (mNextVisitor && !mNextVisitor->visit(index, leaf))
+        return false;
+    if (leaf)
+        ++mNumVisible;
+    return true;
+}
+}
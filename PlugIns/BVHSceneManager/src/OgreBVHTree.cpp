@@ -0,0 +1,805 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHTree.h"
+#include "OgrePlatformInformation.h"
+#include "OgrePlaneBoundedVolume.h"
+#include "OgreRay.h"
+#include "OgreSphere.h"
+
+// The plugin has no runtime dispatch, so only use what the compiler targets anyway
+#if OGRE_DOUBLE_PRECISION == 0 && __OGRE_HAVE_SSE && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#   define OGRE_BVH_SSE 1
+#   include <xmmintrin.h>
+#elif OGRE_DOUBLE_PRECISION == 0 && __OGRE_HAVE_NEON
+#   define OGRE_BVH_NEON 1
+#   include <arm_neon.h>
+#endif
+
+namespace Ogre
+{
+namespace
+{
+    enum Visibility
+    {
+        OUTSIDE,
+        INTERSECT,
+        INSIDE
+    };
+
+    inline Real surfaceArea(const Vector3& minimum, const Vector3& maximum)
+    {
+        Vector3 d = maximum - minimum;
+        return 2 * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    inline Real mergedArea(const Vector3& min1, const Vector3& max1,
+        const Vector3& min2, const Vector3& max2)
+    {
+        Vector3 minimum = min1, maximum = max1;
+        minimum.makeFloor(min2);
+        maximum.makeCeil(max2);
+        return surfaceArea(minimum, maximum);
+    }
+
+    inline bool contains(const Vector3& outerMin, const Vector3& outerMax,
+        const Vector3& minimum, const Vector3& maximum)
+    {
+        return outerMin.x <= minimum.x && outerMin.y <= minimum.y && outerMin.z <= minimum.z &&
+            outerMax.x >= maximum.x && outerMax.y >= maximum.y && outerMax.z >= maximum.z;
+    }
+
+    inline bool overlaps(const AxisAlignedBox& box, const AxisAlignedBox& bounds) { return box.intersects(bounds); }
+    inline bool overlaps(const Sphere& sphere, const AxisAlignedBox& bounds) { return sphere.intersects(bounds); }
+    inline bool overlaps(const PlaneBoundedVolume& volume, const AxisAlignedBox& bounds) { return volume.intersects(bounds); }
+    inline bool overlaps(const Ray& ray, const AxisAlignedBox& bounds) { return ray.intersects(bounds).first; }
+
+    /** Stack of tree nodes kept on the call stack, so that queries allocate
+        nothing and may run on several threads. Spills to the heap for trees
+        deeper than a balanced one ever gets. */
+    class QueryStack
+    {
+    public:
+        QueryStack() : mSize(0) {}
+
+        bool empty(void) const { return mSize == 0; }
+        void push(int32 index)
+        {
+            if (mSize < FIXED_SIZE)
+                mFixed[mSize] = index;
+            else
+                mSpill.push_back(index);
+            ++mSize;
+        }
+        int32 pop(void)
+        {
+            --mSize;
+            if (mSize < FIXED_SIZE)
+                return mFixed[mSize];
+            int32 index = mSpill.back();
+            mSpill.pop_back();
+            return index;
+        }
+
+    private:
+        static const size_t FIXED_SIZE = 64;
+        int32 mFixed[FIXED_SIZE];
+        vector<int32>::type mSpill;
+        size_t mSize;
+    };
+
+    /** Up to eight planes with their normals, absolute normals and distances
+        stored per component, so four planes at a time are tested against a
+        box. The unused planes are set up to never cull anything.
+    */
+    struct PlaneSet
+    {
+        float nx[8], ny[8], nz[8], d[8];
+        float ax[8], ay[8], az[8];
+
+        PlaneSet(const Plane* planes, size_t numPlanes)
+        {
+            for (size_t i = 0; i < 8; ++i)
+            {
+                if (i < numPlanes)
+                {
+                    const Plane& p = planes[i];
+                    nx[i] = p.normal.x; ny[i] = p.normal.y; nz[i] = p.normal.z;
+                    d[i] = p.d;
+                }
+                else
+                {
+                    nx[i] = ny[i] = nz[i] = 0;
+                    d[i] = 1;
+                }
+                ax[i] = Math::Abs(nx[i]); ay[i] = Math::Abs(ny[i]); az[i] = Math::Abs(nz[i]);
+            }
+        }
+
+        /// Whether the box is outside, inside or intersecting the planes
+        Visibility test(const Vector3& minimum, const Vector3& maximum) const
+        {
+            Vector3 c = (minimum + maximum) * 0.5f;
+            Vector3 h = (maximum - minimum) * 0.5f;
+            int outside = 0, straddling = 0;
+#if OGRE_BVH_SSE
+            const __m128 zero = _mm_setzero_ps();
+            __m128 cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+            __m128 hx = _mm_set1_ps(h.x), hy = _mm_set1_ps(h.y), hz = _mm_set1_ps(h.z);
+            for (size_t i = 0; i < 8; i += 4)
+            {
+                // Distance of the centre and projected half size of the box
+                __m128 dist = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(nx + i), cx), _mm_mul_ps(_mm_loadu_ps(ny + i), cy)),
+                    _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(nz + i), cz), _mm_loadu_ps(d + i)));
+                __m128 radius = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(ax + i), hx), _mm_mul_ps(_mm_loadu_ps(ay + i), hy)),
+                    _mm_mul_ps(_mm_loadu_ps(az + i), hz));
+                outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, radius), zero));
+                straddling |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(dist, radius), zero));
+            }
+#elif OGRE_BVH_NEON
+            const float32x4_t zero = vdupq_n_f32(0);
+            float32x4_t cx = vdupq_n_f32(c.x), cy = vdupq_n_f32(c.y), cz = vdupq_n_f32(c.z);
+            float32x4_t hx = vdupq_n_f32(h.x), hy = vdupq_n_f32(h.y), hz = vdupq_n_f32(h.z);
+            for (size_t i = 0; i < 8; i += 4)
+            {
+                float32x4_t dist = vaddq_f32(
+                    vaddq_f32(vmulq_f32(vld1q_f32(nx + i), cx), vmulq_f32(vld1q_f32(ny + i), cy)),
+                    vaddq_f32(vmulq_f32(vld1q_f32(nz + i), cz), vld1q_f32(d + i)));
+                float32x4_t radius = vaddq_f32(
+                    vaddq_f32(vmulq_f32(vld1q_f32(ax + i), hx), vmulq_f32(vld1q_f32(ay + i), hy)),
+                    vmulq_f32(vld1q_f32(az + i), hz));
+                uint32 m[4];
+                vst1q_u32(m, vcltq_f32(vaddq_f32(dist, radius), zero));
+                outside |= m[0] | m[1] | m[2] | m[3];
+                vst1q_u32(m, vcltq_f32(vsubq_f32(dist, radius), zero));
+                straddling |= m[0] | m[1] | m[2] | m[3];
+            }
+#else
+            for (size_t i = 0; i < 8; ++i)
+            {
+                Real dist = nx[i] * c.x + ny[i] * c.y + nz[i] * c.z + d[i];
+                Real radius = ax[i] * h.x + ay[i] * h.y + az[i] * h.z;
+                outside |= dist + radius < 0;
+                straddling |= dist - radius < 0;
+            }
+#endif
+            if (outside)
+                return OUTSIDE;
+            return straddling ? INTERSECT : INSIDE;
+        }
+    };
+
+    /// Centroid bins of the surface area heuristic build
+    const size_t NUM_BINS = 16;
+    /// Below this number of nodes update() doesn't bother rebuilding
+    const size_t MIN_REBUILD_PROXIES = 16;
+}
+//-----------------------------------------------------------------------
+BVHTree::BVHTree()
+    : mFreeProxy(-1)
+    , mRoot(-1)
+    , mNumProxies(0)
+    , mInnerArea(0)
+    , mBuiltCost(0)
+    , mNeedsRefit(false)
+    , mFatMargin(0.1f)
+    , mRebuildRatio(1.5f)
+    , mNumRebuilds(0)
+    , mNextVersion(0)
+{
+}
+//-----------------------------------------------------------------------
+BVHTree::~BVHTree()
+{
+}
+//-----------------------------------------------------------------------
+int32 BVHTree::allocateNode(void)
+{
+    int32 index;
+    if (mFreeNodes.empty())
+    {
+        index = static_cast<int32>(mNodes.size());
+        mNodes.push_back(TreeNode());
+    }
+    else
+    {
+        index = mFreeNodes.back();
+        mFreeNodes.pop_back();
+    }
+
+    TreeNode& node = mNodes[index];
+    node.parent = -1;
+    node.children[0] = node.children[1] = -1;
+    node.proxy = -1;
+    node.leafCount = 1;
+    node.version = ++mNextVersion;
+    node.refit = false;
+    return index;
+}
+//-----------------------------------------------------------------------
+void BVHTree::freeNode(int32 index)
+{
+    mFreeNodes.push_back(index);
+}
+//-----------------------------------------------------------------------
+void BVHTree::fatten(const Proxy& proxy, TreeNode& leaf) const
+{
+    Vector3 size = proxy.maximum - proxy.minimum;
+    Real margin = std::max(size.x, std::max(size.y, size.z)) * mFatMargin;
+    leaf.minimum = proxy.minimum - margin;
+    leaf.maximum = proxy.maximum + margin;
+}
+//-----------------------------------------------------------------------
+void BVHTree::fitToChildren(int32 index)
+{
+    TreeNode& node = mNodes[index];
+    const TreeNode& a = mNodes[node.children[0]];
+    const TreeNode& b = mNodes[node.children[1]];
+
+    mInnerArea -= surfaceArea(node.minimum, node.maximum);
+    node.minimum = a.minimum;
+    node.minimum.makeFloor(b.minimum);
+    node.maximum = a.maximum;
+    node.maximum.makeCeil(b.maximum);
+    mInnerArea += surfaceArea(node.minimum, node.maximum);
+    node.leafCount = a.leafCount + b.leafCount;
+    node.refit = false;
+}
+//-----------------------------------------------------------------------
+int32 BVHTree::insert(SceneNode* node, const AxisAlignedBox& box)
+{
+    int32 proxy;
+    if (mFreeProxy != -1)
+    {
+        proxy = mFreeProxy;
+        mFreeProxy = mProxies[proxy].leaf;
+    }
+    else
+    {
+        proxy = static_cast<int32>(mProxies.size());
+        mProxies.push_back(Proxy());
+    }
+
+    int32 leaf = allocateNode();
+    Proxy& p = mProxies[proxy];
+    p.node = node;
+    p.leaf = leaf;
+    p.minimum = box.getMinimum();
+    p.maximum = box.getMaximum();
+    mNodes[leaf].proxy = proxy;
+    fatten(p, mNodes[leaf]);
+
+    insertLeaf(leaf);
+    ++mNumProxies;
+    return proxy;
+}
+//-----------------------------------------------------------------------
+void BVHTree::remove(int32 proxy)
+{
+    Proxy& p = mProxies[proxy];
+    removeLeaf(p.leaf);
+    freeNode(p.leaf);
+
+    p.node = 0;
+    p.leaf = mFreeProxy;
+    mFreeProxy = proxy;
+    --mNumProxies;
+}
+//-----------------------------------------------------------------------
+void BVHTree::move(int32 proxy, const AxisAlignedBox& box)
+{
+    Proxy& p = mProxies[proxy];
+    p.minimum = box.getMinimum();
+    p.maximum = box.getMaximum();
+
+    TreeNode& leaf = mNodes[p.leaf];
+    if (contains(leaf.minimum, leaf.maximum, p.minimum, p.maximum))
+        return;
+
+    fatten(p, leaf);
+
+    // Flag the path to the root, stopping where it already is flagged
+    for (int32 i = leaf.parent; i != -1 && !mNodes[i].refit; i = mNodes[i].parent)
+        mNodes[i].refit = true;
+    mNeedsRefit = true;
+}
+//-----------------------------------------------------------------------
+void BVHTree::insertLeaf(int32 leaf)
+{
+    if (mRoot == -1)
+    {
+        mRoot = leaf;
+        mNodes[leaf].parent = -1;
+        return;
+    }
+
+    // Walk down to the best sibling, comparing the cost of pairing the leaf
+    // with the current node against the least cost of going further down
+    const Vector3 leafMin = mNodes[leaf].minimum;
+    const Vector3 leafMax = mNodes[leaf].maximum;
+    int32 index = mRoot;
+    while (!isLeaf(index))
+    {
+        const TreeNode& node = mNodes[index];
+        Real area = surfaceArea(node.minimum, node.maximum);
+        Real combinedArea = mergedArea(node.minimum, node.maximum, leafMin, leafMax);
+
+        Real cost = 2 * combinedArea;
+        Real inheritedCost = 2 * (combinedArea - area);
+
+        Real childCost[2];
+        for (int c = 0; c < 2; ++c)
+        {
+            const TreeNode& child = mNodes[node.children[c]];
+            childCost[c] = mergedArea(child.minimum, child.maximum, leafMin, leafMax) + inheritedCost;
+            if (!isLeaf(node.children[c]))
+                childCost[c] -= surfaceArea(child.minimum, child.maximum);
+        }
+
+        if (cost < childCost[0] && cost < childCost[1])
+            break;
+
+        index = childCost[0] < childCost[1] ? node.children[0] : node.children[1];
+    }
+
+    int32 sibling = index;
+    int32 newParent = allocateNode();
+    int32 oldParent = mNodes[sibling].parent;
+
+    TreeNode& parent = mNodes[newParent];
+    parent.parent = oldParent;
+    parent.children[0] = sibling;
+    parent.children[1] = leaf;
+    parent.minimum = parent.maximum = Vector3::ZERO;
+    fitToChildren(newParent);
+    // Keep every ancestor of a flagged node flagged
+    mNodes[newParent].refit = !isLeaf(sibling) && mNodes[sibling].refit;
+
+    mNodes[sibling].parent = newParent;
+    mNodes[leaf].parent = newParent;
+
+    if (oldParent == -1)
+    {
+        mRoot = newParent;
+        return;
+    }
+
+    TreeNode& old = mNodes[oldParent];
+    old.children[old.children[0] == sibling ? 0 : 1] = newParent;
+    for (int32 i = oldParent; i != -1; i = mNodes[i].parent)
+    {
+        bool refit = mNodes[i].refit;
+        fitToChildren(i);
+        mNodes[i].refit = refit;
+    }
+}
+//-----------------------------------------------------------------------
+void BVHTree::removeLeaf(int32 leaf)
+{
+    if (leaf == mRoot)
+    {
+        mRoot = -1;
+        return;
+    }
+
+    int32 parent = mNodes[leaf].parent;
+    int32 grandParent = mNodes[parent].parent;
+    const TreeNode& p = mNodes[parent];
+    int32 sibling = p.children[0] == leaf ? p.children[1] : p.children[0];
+
+    mInnerArea -= surfaceArea(p.minimum, p.maximum);
+    freeNode(parent);
+    mNodes[sibling].parent = grandParent;
+
+    if (grandParent == -1)
+    {
+        mRoot = sibling;
+        return;
+    }
+
+    TreeNode& g = mNodes[grandParent];
+    g.children[g.children[0] == parent ? 0 : 1] = sibling;
+    for (int32 i = grandParent; i != -1; i = mNodes[i].parent)
+    {
+        bool refit = mNodes[i].refit;
+        fitToChildren(i);
+        mNodes[i].refit = refit;
+    }
+}
+//-----------------------------------------------------------------------
+void BVHTree::refit(void)
+{
+    if (mRoot == -1 || isLeaf(mRoot) || !mNodes[mRoot].refit)
+        return;
+
+    // Post order walk over the flagged nodes only
+    mStack.clear();
+    mStack.push_back(mRoot);
+    while (!mStack.empty())
+    {
+        int32 index = mStack.back();
+        bool pending = false;
+        for (int c = 0; c < 2; ++c)
+        {
+            int32 child = mNodes[index].children[c];
+            if (!isLeaf(child) && mNodes[child].refit)
+            {
+                mStack.push_back(child);
+                pending = true;
+            }
+        }
+
+        if (!pending)
+        {
+            mStack.pop_back();
+            fitToChildren(index);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+Real BVHTree::getCost(void) const
+{
+    if (mRoot == -1)
+        return 0;
+
+    Real rootArea = surfaceArea(mNodes[mRoot].minimum, mNodes[mRoot].maximum);
+    return rootArea > 0 ? mInnerArea / rootArea : 0;
+}
+//-----------------------------------------------------------------------
+void BVHTree::update(void)
+{
+    if (mNeedsRefit)
+    {
+        refit();
+        mNeedsRefit = false;
+    }
+
+    if (mNumProxies >= MIN_REBUILD_PROXIES && getCost() > mBuiltCost * mRebuildRatio)
+        rebuild();
+}
+//-----------------------------------------------------------------------
+void BVHTree::rebuild(void)
+{
+    mBuildLeaves.clear();
+    for (size_t i = 0; i < mProxies.size(); ++i)
+    {
+        const Proxy& p = mProxies[i];
+        if (!p.node)
+            continue;
+
+        // Keep the leaf boxes, so the rebuild doesn't cause more refits
+        BuildLeaf leaf;
+        leaf.minimum = mNodes[p.leaf].minimum;
+        leaf.maximum = mNodes[p.leaf].maximum;
+        leaf.proxy = static_cast<int32>(i);
+        mBuildLeaves.push_back(leaf);
+    }
+
+    mNodes.clear();
+    mFreeNodes.clear();
+    mInnerArea = 0;
+    mNeedsRefit = false;
+    mRoot = mBuildLeaves.empty() ? -1 : 0;
+    mNodes.reserve(mBuildLeaves.size() * 2);
+
+    struct BuildTask
+    {
+        size_t begin, end;
+        int32 parent;
+        int slot;
+    };
+    vector<BuildTask>::type tasks;
+    if (!mBuildLeaves.empty())
+    {
+        BuildTask root = { 0, mBuildLeaves.size(), -1, 0 };
+        tasks.push_back(root);
+    }
+
+    // Depth first, so the first child of every inner node directly follows it
+    while (!tasks.empty())
+    {
+        BuildTask task = tasks.back();
+        tasks.pop_back();
+
+        int32 index = allocateNode();
+        mNodes[index].parent = task.parent;
+        if (task.parent != -1)
+            mNodes[task.parent].children[task.slot] = index;
+
+        if (task.end - task.begin == 1)
+        {
+            const BuildLeaf& leaf = mBuildLeaves[task.begin];
+            mNodes[index].minimum = leaf.minimum;
+            mNodes[index].maximum = leaf.maximum;
+            mNodes[index].proxy = leaf.proxy;
+            mProxies[leaf.proxy].leaf = index;
+            continue;
+        }
+
+        TreeNode& node = mNodes[index];
+        node.minimum = mBuildLeaves[task.begin].minimum;
+        node.maximum = mBuildLeaves[task.begin].maximum;
+        for (size_t i = task.begin + 1; i < task.end; ++i)
+        {
+            node.minimum.makeFloor(mBuildLeaves[i].minimum);
+            node.maximum.makeCeil(mBuildLeaves[i].maximum);
+        }
+        mInnerArea += surfaceArea(node.minimum, node.maximum);
+        node.leafCount = static_cast<uint32>(task.end - task.begin);
+
+        size_t mid = partition(task.begin, task.end);
+        BuildTask second = { mid, task.end, index, 1 };
+        BuildTask first = { task.begin, mid, index, 0 };
+        tasks.push_back(second);
+        tasks.push_back(first);
+    }
+
+    mBuiltCost = getCost();
+    ++mNumRebuilds;
+}
+//-----------------------------------------------------------------------
+size_t BVHTree::partition(size_t begin, size_t end)
+{
+    Vector3 centreMin = (mBuildLeaves[begin].minimum + mBuildLeaves[begin].maximum) * 0.5f;
+    Vector3 centreMax = centreMin;
+    for (size_t i = begin + 1; i < end; ++i)
+    {
+        Vector3 centre = (mBuildLeaves[i].minimum + mBuildLeaves[i].maximum) * 0.5f;
+        centreMin.makeFloor(centre);
+        centreMax.makeCeil(centre);
+    }
+    Vector3 extent = centreMax - centreMin;
+
+    struct Bin
+    {
+        size_t count;
+        Vector3 minimum, maximum;
+    };
+
+    Real bestCost = std::numeric_limits<Real>::max();
+    int bestAxis = -1;
+    size_t bestSplit = 0;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (extent[axis] <= 0)
+            continue;
+
+        Bin bins[NUM_BINS];
+        for (size_t b = 0; b < NUM_BINS; ++b)
+        {
+            bins[b].count = 0;
+            bins[b].minimum = Vector3(std::numeric_limits<Real>::max());
+            bins[b].maximum = Vector3(-std::numeric_limits<Real>::max());
+        }
+
+        Real scale = NUM_BINS / extent[axis];
+        for (size_t i = begin; i < end; ++i)
+        {
+            const BuildLeaf& leaf = mBuildLeaves[i];
+            Real centre = (leaf.minimum[axis] + leaf.maximum[axis]) * 0.5f;
+            size_t b = std::min(static_cast<size_t>((centre - centreMin[axis]) * scale), NUM_BINS - 1);
+            ++bins[b].count;
+            bins[b].minimum.makeFloor(leaf.minimum);
+            bins[b].maximum.makeCeil(leaf.maximum);
+        }
+
+        // Sweep from the right to get the cost of the right side of every split
+        Real rightCost[NUM_BINS];
+        Vector3 minimum(std::numeric_limits<Real>::max());
+        Vector3 maximum(-std::numeric_limits<Real>::max());
+        size_t count = 0;
+        for (size_t b = NUM_BINS - 1; b > 0; --b)
+        {
+            minimum.makeFloor(bins[b].minimum);
+            maximum.makeCeil(bins[b].maximum);
+            count += bins[b].count;
+            rightCost[b] = count ? surfaceArea(minimum, maximum) * count : 0;
+        }
+
+        // Then from the left, empty bins leave the bounds as they are
+        minimum = Vector3(std::numeric_limits<Real>::max());
+        maximum = Vector3(-std::numeric_limits<Real>::max());
+        count = 0;
+        for (size_t b = 0; b < NUM_BINS - 1; ++b)
+        {
+            minimum.makeFloor(bins[b].minimum);
+            maximum.makeCeil(bins[b].maximum);
+            count += bins[b].count;
+            if (count == 0 || count == end - begin)
+                continue;
+
+            Real cost = surfaceArea(minimum, maximum) * count + rightCost[b + 1];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = b;
+            }
+        }
+    }
+
+    if (bestAxis != -1)
+    {
+        Real scale = NUM_BINS / extent[bestAxis];
+        BuildLeaf* first = &mBuildLeaves[0] + begin;
+        BuildLeaf* last = &mBuildLeaves[0] + end;
+        BuildLeaf* mid = first;
+        for (BuildLeaf* i = first; i != last; ++i)
+        {
+            Real centre = (i->minimum[bestAxis] + i->maximum[bestAxis]) * 0.5f;
+            size_t b = std::min(static_cast<size_t>((centre - centreMin[bestAxis]) * scale), NUM_BINS - 1);
+            if (b <= bestSplit)
+                std::swap(*i, *mid++);
+        }
+        return begin + (mid - first);
+    }
+
+    // All centres coincide, any split is as good as the other
+    return begin + (end - begin) / 2;
+}
+//-----------------------------------------------------------------------
+void BVHTree::clear(void)
+{
+    mNodes.clear();
+    mProxies.clear();
+    mFreeNodes.clear();
+    mFreeProxy = -1;
+    mRoot = -1;
+    mNumProxies = 0;
+    mInnerArea = 0;
+    mBuiltCost = 0;
+    mNeedsRefit = false;
+}
+//-----------------------------------------------------------------------
+void BVHTree::addSubtree(int32 index, SceneNodeList& nodes) const
+{
+    size_t base = mStack.size();
+    mStack.push_back(index);
+    while (mStack.size() > base)
+    {
+        const TreeNode& node = mNodes[mStack.back()];
+        mStack.pop_back();
+        if (node.children[0] == -1)
+        {
+            nodes.push_back(mProxies[node.proxy].node);
+        }
+        else
+        {
+            mStack.push_back(node.children[1]);
+            mStack.push_back(node.children[0]);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void BVHTree::findVisible(const Plane* planes, size_t numPlanes, SceneNodeList& nodes,
+    Visitor* visitor) const
+{
+    if (mRoot == -1)
+        return;
+
+    assert(numPlanes <= 8 && "Too many planes");
+    PlaneSet planeSet(planes, numPlanes);
+
+    // Tree nodes known to be inside the planes are pushed complemented
+    mStack.clear();
+    mStack.push_back(mRoot);
+    while (!mStack.empty())
+    {
+        int32 entry = mStack.back();
+        mStack.pop_back();
+
+        int32 index = entry < 0 ? ~entry : entry;
+        const TreeNode& node = mNodes[index];
+        Visibility v = entry < 0 ? INSIDE : planeSet.test(node.minimum, node.maximum);
+        if (v == OUTSIDE)
+            continue;
+
+        if (node.children[0] == -1)
+        {
+            // The leaf box is enlarged, test the real one unless it's all in
+            const Proxy& p = mProxies[node.proxy];
+            if (v != INSIDE && planeSet.test(p.minimum, p.maximum) == OUTSIDE)
+                continue;
+            if (!visitor || visitor->visit(index, true))
+                nodes.push_back(p.node);
+        }
+        else if (visitor && !visitor->visit(index, false))
+        {
+            continue;
+        }
+        else if (v == INSIDE)
+        {
+            if (visitor)
+            {
+                mStack.push_back(~node.children[1]);
+                mStack.push_back(~node.children[0]);
+            }
+            else
+            {
+                addSubtree(index, nodes);
+            }
+        }
+        else
+        {
+            mStack.push_back(node.children[1]);
+            mStack.push_back(node.children[0]);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+template <typename Volume>
+void BVHTree::findNodes(const Volume& volume, SceneNodeList& nodes) const
+{
+    if (mRoot == -1)
+        return;
+
+    QueryStack stack;
+    stack.push(mRoot);
+    while (!stack.empty())
+    {
+        const TreeNode& node = mNodes[stack.pop()];
+
+        if (!overlaps(volume, AxisAlignedBox(node.minimum, node.maximum)))
+            continue;
+
+        if (node.children[0] == -1)
+        {
+            const Proxy& p = mProxies[node.proxy];
+            if (overlaps(volume, AxisAlignedBox(p.minimum, p.maximum)))
+                nodes.push_back(p.node);
+        }
+        else
+        {
+            stack.push(node.children[1]);
+            stack.push(node.children[0]);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void BVHTree::findNodesIn(const AxisAlignedBox& box, SceneNodeList& nodes) const
+{
+    findNodes(box, nodes);
+}
+//-----------------------------------------------------------------------
+void BVHTree::findNodesIn(const Sphere& sphere, SceneNodeList& nodes) const
+{
+    findNodes(sphere, nodes);
+}
+//-----------------------------------------------------------------------
+void BVHTree::findNodesIn(const PlaneBoundedVolume& volume, SceneNodeList& nodes) const
+{
+    findNodes(volume, nodes);
+}
+//-----------------------------------------------------------------------
+void BVHTree::findNodesIn(const Ray& ray, SceneNodeList& nodes) const
+{
+    findNodes(ray, nodes);
+}
+
+}
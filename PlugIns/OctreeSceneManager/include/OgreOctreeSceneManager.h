@@ -44,6 +44,7 @@ THE SOFTWARE.
 #include <algorithm>
 
 #include "OgreOctree.h"
+#include "OgrePotentiallyVisibleSet.h"
 
 
 namespace Ogre
@@ -73,7 +74,6 @@ class _OgreOctreePluginExport OctreeSceneManager : public SceneManager
     friend class OctreePlaneBoundedVolumeListSceneQuery;
 
 public:
-    static int intersect_call;
     /** Standard Constructor.  Initializes the octree to -10000,-10000,-10000 to 10000,10000,10000 with a depth of 8. */
     OctreeSceneManager(const String& name);
     /** Standard Constructor */
@@ -151,6 +151,54 @@ public:
       */
     void findNodesIn( const Ray &ray, list< SceneNode * >::type &list, SceneNode *exclude=0 );
 
+    /** Recurses the octree, adding any nodes intersecting with the box to the end of
+    the given vector, which allocates nothing once it has grown.
+    It ignores the exclude scene node. Only reads the octree, so it may be called
+    from several threads while the scene doesn't change.
+    */
+    void findNodesIn( const AxisAlignedBox &box, vector< SceneNode * >::type &nodes, SceneNode *exclude = 0 ) const;
+
+    /** As findNodesIn for a box, for the nodes intersecting with the sphere. */
+    void findNodesIn( const Sphere &sphere, vector< SceneNode * >::type &nodes, SceneNode *exclude = 0 ) const;
+
+    /** As findNodesIn for a box, for the nodes intersecting with the volume. */
+    void findNodesIn( const PlaneBoundedVolume &volume, vector< SceneNode * >::type &nodes, SceneNode *exclude = 0 ) const;
+
+    /** As findNodesIn for a box, for the nodes intersecting with the ray. */
+    void findNodesIn( const Ray &ray, vector< SceneNode * >::type &nodes, SceneNode *exclude = 0 ) const;
+
+    /** Compute which cells of a grid over the octree may be seen from which,
+        for use with setPVS.
+    @remarks
+        Meant to be run offline once the static geometry is in place, with the
+        result saved using PotentiallyVisibleSetSerializer. Only entities
+        flagged with MovableObject::setOccluder hide anything, and only with
+        their mesh triangles. Two cells are hidden from each other when all of
+        a number of lines between random points in them hit an occluder, so
+        the result is only as good as the sampling: raise the number of
+        samples when thin gaps in the occluders matter. Neighbouring cells
+        always see each other.
+    @param pvs The set to fill
+    @param depth The octree is divided 2^depth times along each axis
+    @param samples Number of lines tested between two cells
+    */
+    void computePVS( PotentiallyVisibleSet &pvs, int depth = 3, size_t samples = 16 );
+
+    /** Use precomputed cell visibility when finding the visible objects.
+    @remarks
+        The set is copied and must have been computed on a grid. Octants and
+        nodes lying in cells which can't be seen from the cell of the camera
+        are culled. Cameras outside the grid and orthographic cameras see
+        everything.
+    */
+    void setPVS( const PotentiallyVisibleSet &pvs );
+
+    /** Stop using precomputed cell visibility */
+    void clearPVS( void );
+
+    /** Get the precomputed cell visibility in use, or 0 if there is none */
+    const PotentiallyVisibleSet* getPVS( void ) const { return mPVS; }
+
     /** Sets the box visibility flag */
     void setShowBoxes( bool b )
     {
@@ -187,16 +235,14 @@ public:
     IntersectionSceneQuery* createIntersectionQuery(uint32 mask);
 
 protected:
-
+    /// OctreeNode::_updateBounds relocates nodes within the shared octree
+    bool isParallelUpdateSafe(void) const { return false; }
 
     Octree::NodeList mVisible;
 
     /// The root octree
     Octree *mOctree;
 
-    /// List of boxes to be rendered
-    BoxList mBoxes;
-
     /// Number of rendered objs
     int mNumObjects;
 
@@ -214,6 +260,11 @@ protected:
 
     Matrix4 mScaleFactor;
 
+    /// Precomputed cell visibility, if any
+    PotentiallyVisibleSet* mPVS;
+    /// Cell of the camera being walked, or PotentiallyVisibleSet::NO_CELL
+    size_t mPVSCameraCell;
+
 };
 
 /// Factory for OctreeSceneManager
@@ -58,6 +58,10 @@ public:
 
     /** See IntersectionSceneQuery. */
     void execute(IntersectionSceneQueryListener* listener);
+
+protected:
+    /// Nodes found by the last query, kept to reuse the memory
+    vector< SceneNode * >::type mNodes;
 };
 
 /** Octree implementation of RaySceneQuery. */
@@ -69,6 +73,10 @@ public:
 
     /** See RayScenQuery. */
     void execute(RaySceneQueryListener* listener);
+
+protected:
+    /// Nodes found by the last query, kept to reuse the memory
+    vector< SceneNode * >::type mNodes;
 };
 /** Octree implementation of SphereSceneQuery. */
 class _OgreOctreePluginExport OctreeSphereSceneQuery : public DefaultSphereSceneQuery
@@ -79,6 +87,10 @@ public:
 
     /** See SceneQuery. */
     void execute(SceneQueryListener* listener);
+
+protected:
+    /// Nodes found by the last query, kept to reuse the memory
+    vector< SceneNode * >::type mNodes;
 };
 /** Octree implementation of PlaneBoundedVolumeListSceneQuery. */
 class _OgreOctreePluginExport OctreePlaneBoundedVolumeListSceneQuery : public DefaultPlaneBoundedVolumeListSceneQuery
@@ -89,6 +101,10 @@ public:
 
     /** See SceneQuery. */
     void execute(SceneQueryListener* listener);
+
+protected:
+    /// Nodes found by the last query, kept to reuse the memory
+    vector< SceneNode * >::type mNodes;
 };
 /** Octree implementation of AxisAlignedBoxSceneQuery. */
 class _OgreOctreePluginExport OctreeAxisAlignedBoxSceneQuery : public DefaultAxisAlignedBoxSceneQuery
@@ -99,6 +115,10 @@ public:
 
     /** See RaySceneQuery. */
     void execute(SceneQueryListener* listener);
+
+protected:
+    /// Nodes found by the last query, kept to reuse the memory
+    vector< SceneNode * >::type mNodes;
 };
 
 /** @} */
@@ -38,7 +38,13 @@ email                : janders@users.sf.net
 #include "OgreOctreeSceneQuery.h"
 #include "OgreOctreeNode.h"
 #include "OgreOctreeCamera.h"
-#include "OgreWireBoundingBox.h"
+#include "OgreDebugDrawer.h"
+#include "OgreEntity.h"
+#include "OgreHardwareIndexBuffer.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "Threading/OgreParallel.h"
 
 extern "C"
 {
@@ -66,11 +72,9 @@ enum Intersection
     INSIDE=1,
     INTERSECT=2
 };
-int OctreeSceneManager::intersect_call = 0;
 
 Intersection intersect( const Ray &one, const AxisAlignedBox &two )
 {
-    OctreeSceneManager::intersect_call++;
     // Null box?
     if (two.isNull()) return OUTSIDE;
     // Infinite box?
@@ -141,7 +145,6 @@ Intersection intersect( const Ray &one, const AxisAlignedBox &two )
 */
 Intersection intersect( const PlaneBoundedVolume &one, const AxisAlignedBox &two )
 {
-    OctreeSceneManager::intersect_call++;
     // Null box?
     if (two.isNull()) return OUTSIDE;
     // Infinite box?
@@ -182,7 +185,6 @@ Intersection intersect( const PlaneBoundedVolume &one, const AxisAlignedBox &two
 */
 Intersection intersect( const AxisAlignedBox &one, const AxisAlignedBox &two )
 {
-    OctreeSceneManager::intersect_call++;
     // Null box?
     if (one.isNull() || two.isNull()) return OUTSIDE;
     if (one.isInfinite()) return INSIDE;
@@ -223,7 +225,6 @@ Intersection intersect( const AxisAlignedBox &one, const AxisAlignedBox &two )
 */
 Intersection intersect( const Sphere &one, const AxisAlignedBox &two )
 {
-    OctreeSceneManager::intersect_call++;
     // Null box?
     if (two.isNull()) return OUTSIDE;
     if (two.isInfinite()) return INTERSECT;
@@ -295,6 +296,8 @@ OctreeSceneManager::OctreeSceneManager(const String& name) : SceneManager(name)
     AxisAlignedBox b( -10000, -10000, -10000, 10000, 10000, 10000 );
     int depth = 8; 
     mOctree = 0;
+    mPVS = 0;
+    mPVSCameraCell = PotentiallyVisibleSet::NO_CELL;
     init( b, depth );
 }
 
@@ -302,6 +305,8 @@ OctreeSceneManager::OctreeSceneManager(const String& name, AxisAlignedBox &box,
 : SceneManager(name)
 {
     mOctree = 0;
+    mPVS = 0;
+    mPVSCameraCell = PotentiallyVisibleSet::NO_CELL;
     init( box, max_depth );
 }
 
@@ -356,6 +361,7 @@ OctreeSceneManager::~OctreeSceneManager()
         OGRE_DELETE mOctree;
         mOctree = 0;
     }
+    OGRE_DELETE mPVS;
 }
 
 Camera * OctreeSceneManager::createCamera( const String &name )
@@ -567,23 +573,18 @@ void OctreeSceneManager::_findVisibleObjects(Camera * cam,
 {
 
     getRenderQueue()->clear();
-    mBoxes.clear();
     mVisible.clear();
 
     mNumObjects = 0;
 
+    // the precomputed visibility only holds for points of view inside the grid
+    mPVSCameraCell = PotentiallyVisibleSet::NO_CELL;
+    if ( mPVS && cam->getProjectionType() == PT_PERSPECTIVE )
+        mPVSCameraCell = mPVS->getCell( cam->getDerivedPosition() );
+
     //walk the octree, adding all visible Octreenodes nodes to the render queue.
     walkOctree( static_cast < OctreeCamera * > ( cam ), getRenderQueue(), mOctree, 
                 visibleBounds, false, onlyShadowCasters );
-
-    // Show the octree boxes & cull camera if required
-    if ( mShowBoxes )
-    {
-        for ( BoxList::iterator it = mBoxes.begin(); it != mBoxes.end(); ++it )
-        {
-            getRenderQueue()->addRenderable(*it);
-        }
-    }
 }
 
 void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue, 
@@ -611,6 +612,9 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
     {
         AxisAlignedBox box;
         octant -> _getCullBounds( &box );
+        if ( mPVSCameraCell != PotentiallyVisibleSet::NO_CELL &&
+            !mPVS -> isVisible( mPVSCameraCell, box ) )
+            return ;
         v = camera -> getVisibility( box );
     }
 
@@ -624,7 +628,7 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
 
         if ( mShowBoxes )
         {
-            mBoxes.push_back( octant->getWireBoundingBox() );
+            getDebugDrawer()->drawBox( octant->mBox );
         }
 
         bool vis = true;
@@ -639,6 +643,9 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
             if ( v == OctreeCamera::PARTIAL )
                 vis = camera -> isVisible( sn -> _getWorldAABB() );
 
+            if ( vis && mPVSCameraCell != PotentiallyVisibleSet::NO_CELL )
+                vis = mPVS -> isVisible( mPVSCameraCell, sn -> _getWorldAABB() );
+
             if ( vis )
             {
 
@@ -688,8 +695,11 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
 
 }
 
-// --- non template versions
-void _findNodes( const AxisAlignedBox &t, list< SceneNode * >::type &list, SceneNode *exclude, bool full, Octree *octant )
+/** Recurses the octree, adding the nodes intersecting the volume to a list or
+    vector of scene nodes. Only reads the octree, so it may run on several
+    threads at once. */
+template <typename Volume, typename NodeContainer>
+void _findNodes( const Volume &t, NodeContainer &list, SceneNode *exclude, bool full, Octree *octant )
 {
 
     if ( !full )
@@ -762,244 +772,288 @@ void _findNodes( const AxisAlignedBox &t, list< SceneNode * >::type &list, Scene
 
 }
 
-void _findNodes( const Sphere &t, list< SceneNode * >::type &list, SceneNode *exclude, bool full, Octree *octant )
+void OctreeSceneManager::findNodesIn( const AxisAlignedBox &box, list< SceneNode * >::type &list, SceneNode *exclude )
 {
+    _findNodes( box, list, exclude, false, mOctree );
+}
 
-    if ( !full )
-    {
-        AxisAlignedBox obox;
-        octant -> _getCullBounds( &obox );
+void OctreeSceneManager::findNodesIn( const Sphere &sphere, list< SceneNode * >::type &list, SceneNode *exclude )
+{
+    _findNodes( sphere, list, exclude, false, mOctree );
+}
 
-        Intersection isect = intersect( t, obox );
+void OctreeSceneManager::findNodesIn( const PlaneBoundedVolume &volume, list< SceneNode * >::type &list, SceneNode *exclude )
+{
+    _findNodes( volume, list, exclude, false, mOctree );
+}
 
-        if ( isect == OUTSIDE )
-            return ;
+void OctreeSceneManager::findNodesIn( const Ray &r, list< SceneNode * >::type &list, SceneNode *exclude )
+{
+    _findNodes( r, list, exclude, false, mOctree );
+}
 
-        full = ( isect == INSIDE );
-    }
+void OctreeSceneManager::findNodesIn( const AxisAlignedBox &box, vector< SceneNode * >::type &nodes, SceneNode *exclude ) const
+{
+    _findNodes( box, nodes, exclude, false, mOctree );
+}
 
+void OctreeSceneManager::findNodesIn( const Sphere &sphere, vector< SceneNode * >::type &nodes, SceneNode *exclude ) const
+{
+    _findNodes( sphere, nodes, exclude, false, mOctree );
+}
 
-    Octree::NodeList::iterator it = octant -> mNodes.begin();
+void OctreeSceneManager::findNodesIn( const PlaneBoundedVolume &volume, vector< SceneNode * >::type &nodes, SceneNode *exclude ) const
+{
+    _findNodes( volume, nodes, exclude, false, mOctree );
+}
 
-    while ( it != octant -> mNodes.end() )
+void OctreeSceneManager::findNodesIn( const Ray &r, vector< SceneNode * >::type &nodes, SceneNode *exclude ) const
+{
+    _findNodes( r, nodes, exclude, false, mOctree );
+}
+
+namespace
+{
+    /// An occluder triangle in world space
+    struct PVSTriangle
     {
-        OctreeNode * on = ( *it );
+        Vector3 v[ 3 ];
+    };
 
-        if ( on != exclude )
+    /// Adds the triangles of an occluder entity in world space
+    void addOccluderTriangles( Entity *entity, vector< PVSTriangle >::type &triangles )
+    {
+        const MeshPtr &mesh = entity->getMesh();
+        const Matrix4 &xform = entity->_getParentNodeFullTransform();
+        for ( unsigned short s = 0; s < mesh->getNumSubMeshes(); ++s )
         {
-            if ( full )
+            SubMesh *sub = mesh->getSubMesh( s );
+            if ( sub->operationType != RenderOperation::OT_TRIANGLE_LIST || !sub->indexData->indexCount )
+                continue;
+
+            const VertexData *vertexData = sub->useSharedVertices ? mesh->sharedVertexData : sub->vertexData;
+            const VertexElement *element =
+                vertexData->vertexDeclaration->findElementBySemantic( VES_POSITION );
+            const HardwareVertexBufferSharedPtr &vbuf =
+                vertexData->vertexBufferBinding->getBuffer( element->getSource() );
+            vector< Vector3 >::type positions( vertexData->vertexCount );
             {
-                list.push_back( on );
+                HardwareBufferLockGuard<HardwareVertexBufferSharedPtr> lock( vbuf, HardwareBuffer::HBL_READ_ONLY );
+                unsigned char *vertex = static_cast<unsigned char*>( lock.pData ) +
+                    vertexData->vertexStart * vbuf->getVertexSize();
+                for ( size_t i = 0; i < positions.size(); ++i, vertex += vbuf->getVertexSize() )
+                {
+                    float *p;
+                    element->baseVertexPointerToElement( vertex, &p );
+                    positions[ i ] = xform.transformAffine( Vector3( p[ 0 ], p[ 1 ], p[ 2 ] ) );
+                }
             }
 
-            else
+            const IndexData *indexData = sub->indexData;
+            const HardwareIndexBufferSharedPtr &ibuf = indexData->indexBuffer;
+            HardwareBufferLockGuard<HardwareIndexBufferSharedPtr> lock( ibuf,
+                indexData->indexStart * ibuf->getIndexSize(), indexData->indexCount * ibuf->getIndexSize(),
+                HardwareBuffer::HBL_READ_ONLY );
+            bool use32 = ibuf->getType() == HardwareIndexBuffer::IT_32BIT;
+            for ( size_t i = 0; i + 2 < indexData->indexCount; i += 3 )
             {
-                Intersection nsect = intersect( t, on -> _getWorldAABB() );
-
-                if ( nsect != OUTSIDE )
+                PVSTriangle t;
+                for ( int k = 0; k < 3; ++k )
                 {
-                    list.push_back( on );
+                    uint32 index = use32 ? static_cast<const uint32*>( lock.pData )[ i + k ] :
+                        static_cast<const uint16*>( lock.pData )[ i + k ];
+                    t.v[ k ] = positions[ index ];
                 }
+                triangles.push_back( t );
             }
-
         }
-
-        ++it;
     }
 
-    Octree* child;
-
-    if ( (child=octant -> mChildren[ 0 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 0 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 0 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 0 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-}
-
-
-void _findNodes( const PlaneBoundedVolume &t, list< SceneNode * >::type &list, SceneNode *exclude, bool full, Octree *octant )
-{
-
-    if ( !full )
+    /// Small deterministic random numbers, so the same scene gives the same set
+    struct PVSRandom
     {
-        AxisAlignedBox obox;
-        octant -> _getCullBounds( &obox );
-
-        Intersection isect = intersect( t, obox );
+        uint32 state;
 
-        if ( isect == OUTSIDE )
-            return ;
+        PVSRandom( uint32 seed ) : state( seed * 2654435761u + 1 ) {}
 
-        full = ( isect == INSIDE );
-    }
-
-
-    Octree::NodeList::iterator it = octant -> mNodes.begin();
+        Real next( void )
+        {
+            state = state * 1664525u + 1013904223u;
+            return ( state >> 8 ) / Real( 1 << 24 );
+        }
+    };
 
-    while ( it != octant -> mNodes.end() )
+    /// Finds which cells can be seen from one cell, see OctreeSceneManager::computePVS
+    struct CellVisibilityFunc
     {
-        OctreeNode * on = ( *it );
-
-        if ( on != exclude )
+        const PotentiallyVisibleSet *pvs;
+        const vector< PVSTriangle >::type *triangles;
+        /// Triangles overlapping each cell
+        const vector< vector< uint32 >::type >::type *cellTriangles;
+        size_t samples;
+        /// Cells visible from each cell, only the ones with a higher index
+        vector< vector< size_t >::type >::type *visible;
+
+        CellVisibilityFunc( const PotentiallyVisibleSet *p, const vector< PVSTriangle >::type *t,
+            const vector< vector< uint32 >::type >::type *c, size_t s,
+            vector< vector< size_t >::type >::type *v )
+            : pvs( p ), triangles( t ), cellTriangles( c ), samples( s ), visible( v ) {}
+
+        void cellCoords( size_t cell, int *coords ) const
         {
-            if ( full )
-            {
-                list.push_back( on );
-            }
+            coords[ 0 ] = static_cast<int>( cell % pvs->getGridDivisions( 0 ) );
+            cell /= pvs->getGridDivisions( 0 );
+            coords[ 1 ] = static_cast<int>( cell % pvs->getGridDivisions( 1 ) );
+            coords[ 2 ] = static_cast<int>( cell / pvs->getGridDivisions( 1 ) );
+        }
 
-            else
+        void operator()( size_t a ) const
+        {
+            int ca[ 3 ];
+            cellCoords( a, ca );
+            AxisAlignedBox boundsA = pvs->getCellBounds( a );
+            for ( size_t b = a + 1; b < pvs->getCellCount(); ++b )
             {
-                Intersection nsect = intersect( t, on -> _getWorldAABB() );
-
-                if ( nsect != OUTSIDE )
+                int cb[ 3 ];
+                cellCoords( b, cb );
+                if ( std::abs( ca[ 0 ] - cb[ 0 ] ) <= 1 && std::abs( ca[ 1 ] - cb[ 1 ] ) <= 1 &&
+                    std::abs( ca[ 2 ] - cb[ 2 ] ) <= 1 )
                 {
-                    list.push_back( on );
+                    ( *visible )[ a ].push_back( b );
+                    continue;
                 }
+                if ( canSee( a, ca, boundsA, b, cb ) )
+                    ( *visible )[ a ].push_back( b );
             }
-
         }
 
-        ++it;
-    }
-
-    Octree* child;
-
-    if ( (child=octant -> mChildren[ 0 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 0 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 0 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        bool canSee( size_t a, const int *ca, const AxisAlignedBox &boundsA, size_t b, const int *cb ) const
+        {
+            // a line between the cells stays within the cells spanned by them
+            int lo[ 3 ], hi[ 3 ];
+            for ( int k = 0; k < 3; ++k )
+            {
+                lo[ k ] = std::min( ca[ k ], cb[ k ] );
+                hi[ k ] = std::max( ca[ k ], cb[ k ] );
+            }
 
-    if ( (child=octant -> mChildren[ 0 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+            AxisAlignedBox boundsB = pvs->getCellBounds( b );
+            PVSRandom random( static_cast<uint32>( a * pvs->getCellCount() + b ) );
+            for ( size_t s = 0; s < samples; ++s )
+            {
+                Vector3 from = randomPoint( boundsA, random );
+                Vector3 to = randomPoint( boundsB, random );
+                if ( !isBlocked( from, to, lo, hi ) )
+                    return true;
+            }
+            return false;
+        }
 
-    if ( (child=octant -> mChildren[ 1 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+        Vector3 randomPoint( const AxisAlignedBox &box, PVSRandom &random ) const
+        {
+            const Vector3 &min = box.getMinimum();
+            Vector3 size = box.getSize();
+            return Vector3( min.x + size.x * random.next(), min.y + size.y * random.next(),
+                min.z + size.z * random.next() );
+        }
 
+        bool isBlocked( const Vector3 &from, const Vector3 &to, const int *lo, const int *hi ) const
+        {
+            Ray ray( from, to - from );
+            for ( int z = lo[ 2 ]; z <= hi[ 2 ]; ++z )
+            {
+                for ( int y = lo[ 1 ]; y <= hi[ 1 ]; ++y )
+                {
+                    for ( int x = lo[ 0 ]; x <= hi[ 0 ]; ++x )
+                    {
+                        size_t cell = x + ( y + z * pvs->getGridDivisions( 1 ) ) * pvs->getGridDivisions( 0 );
+                        const vector< uint32 >::type &list = ( *cellTriangles )[ cell ];
+                        for ( size_t i = 0; i < list.size(); ++i )
+                        {
+                            const PVSTriangle &t = ( *triangles )[ list[ i ] ];
+                            // the direction is not normalised, so the distance is
+                            // relative to the length of the line
+                            std::pair< bool, Real > hit = Math::intersects( ray, t.v[ 0 ], t.v[ 1 ], t.v[ 2 ] );
+                            if ( hit.first && hit.second > 0 && hit.second < 1 )
+                                return true;
+                        }
+                    }
+                }
+            }
+            return false;
+        }
+    };
 }
 
-void _findNodes( const Ray &t, list< SceneNode * >::type &list, SceneNode *exclude, bool full, Octree *octant )
+void OctreeSceneManager::computePVS( PotentiallyVisibleSet &pvs, int depth, size_t samples )
 {
+    size_t divisions = size_t( 1 ) << depth;
+    pvs.setGrid( mOctree->mBox, divisions, divisions, divisions );
 
-    if ( !full )
+    vector< PVSTriangle >::type triangles;
+    MovableObjectIterator it = getMovableObjectIterator( EntityFactory::FACTORY_TYPE_NAME );
+    while ( it.hasMoreElements() )
     {
-        AxisAlignedBox obox;
-        octant -> _getCullBounds( &obox );
-
-        Intersection isect = intersect( t, obox );
-
-        if ( isect == OUTSIDE )
-            return ;
-
-        full = ( isect == INSIDE );
+        Entity *entity = static_cast< Entity* >( it.getNext() );
+        if ( entity->isOccluder() && entity->isInScene() )
+            addOccluderTriangles( entity, triangles );
     }
 
-
-    Octree::NodeList::iterator it = octant -> mNodes.begin();
-
-    while ( it != octant -> mNodes.end() )
+    // bucket the triangles into the cells their bounds overlap
+    vector< vector< uint32 >::type >::type cellTriangles( pvs.getCellCount() );
+    const Vector3 &gridMin = pvs.getGridBounds().getMinimum();
+    Vector3 cellSize = pvs.getGridBounds().getSize() / Real( divisions );
+    for ( size_t i = 0; i < triangles.size(); ++i )
     {
-        OctreeNode * on = ( *it );
-
-        if ( on != exclude )
+        AxisAlignedBox bounds;
+        for ( int k = 0; k < 3; ++k )
+            bounds.merge( triangles[ i ].v[ k ] );
+        Vector3 lo = ( bounds.getMinimum() - gridMin ) / cellSize;
+        Vector3 hi = ( bounds.getMaximum() - gridMin ) / cellSize;
+        int range[ 3 ][ 2 ];
+        for ( int k = 0; k < 3; ++k )
         {
-            if ( full )
-            {
-                list.push_back( on );
-            }
-
-            else
-            {
-                Intersection nsect = intersect( t, on -> _getWorldAABB() );
-
-                if ( nsect != OUTSIDE )
-                {
-                    list.push_back( on );
-                }
-            }
-
+            range[ k ][ 0 ] = Math::Clamp( static_cast<int>( Math::Floor( lo[ k ] ) ), 0, int( divisions ) - 1 );
+            range[ k ][ 1 ] = Math::Clamp( static_cast<int>( Math::Floor( hi[ k ] ) ), 0, int( divisions ) - 1 );
         }
-
-        ++it;
+        for ( int z = range[ 2 ][ 0 ]; z <= range[ 2 ][ 1 ]; ++z )
+            for ( int y = range[ 1 ][ 0 ]; y <= range[ 1 ][ 1 ]; ++y )
+                for ( int x = range[ 0 ][ 0 ]; x <= range[ 0 ][ 1 ]; ++x )
+                    cellTriangles[ x + ( y + z * divisions ) * divisions ].push_back( static_cast<uint32>( i ) );
     }
 
-    Octree* child;
-
-    if ( (child=octant -> mChildren[ 0 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 0 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
+    // the lines between two cells are tested once, from the lower cell
+    vector< vector< size_t >::type >::type visible( pvs.getCellCount() );
+    parallelFor( 0, pvs.getCellCount(),
+        CellVisibilityFunc( &pvs, &triangles, &cellTriangles, samples, &visible ) );
 
-    if ( (child=octant -> mChildren[ 0 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 1 ][ 0 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 0 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 0 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 0 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-    if ( (child=octant -> mChildren[ 1 ][ 1 ][ 1 ]) != 0 )
-        _findNodes( t, list, exclude, full, child );
-
-}
-
-void OctreeSceneManager::findNodesIn( const AxisAlignedBox &box, list< SceneNode * >::type &list, SceneNode *exclude )
-{
-    _findNodes( box, list, exclude, false, mOctree );
-}
-
-void OctreeSceneManager::findNodesIn( const Sphere &sphere, list< SceneNode * >::type &list, SceneNode *exclude )
-{
-    _findNodes( sphere, list, exclude, false, mOctree );
+    for ( size_t a = 0; a < visible.size(); ++a )
+    {
+        for ( size_t i = 0; i < visible[ a ].size(); ++i )
+        {
+            pvs.setVisible( a, visible[ a ][ i ] );
+            pvs.setVisible( visible[ a ][ i ], a );
+        }
+    }
 }
 
-void OctreeSceneManager::findNodesIn( const PlaneBoundedVolume &volume, list< SceneNode * >::type &list, SceneNode *exclude )
+void OctreeSceneManager::setPVS( const PotentiallyVisibleSet &pvs )
 {
-    _findNodes( volume, list, exclude, false, mOctree );
+    if ( !pvs.isGrid() )
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+            "The potentially visible set must be computed on a grid",
+            "OctreeSceneManager::setPVS" );
+
+    if ( !mPVS )
+        mPVS = OGRE_NEW PotentiallyVisibleSet();
+    *mPVS = pvs;
 }
 
-void OctreeSceneManager::findNodesIn( const Ray &r, list< SceneNode * >::type &list, SceneNode *exclude )
+void OctreeSceneManager::clearPVS( void )
 {
-    _findNodes( r, list, exclude, false, mOctree );
+    OGRE_DELETE mPVS;
+    mPVS = 0;
+    mPVSCameraCell = PotentiallyVisibleSet::NO_CELL;
 }
 
 void OctreeSceneManager::resize( const AxisAlignedBox &box )
@@ -76,12 +76,12 @@ void OctreeIntersectionSceneQuery::execute(IntersectionSceneQueryListener* liste
 
             MovableObject * e = it.getNext();
 
-            Ogre::list< SceneNode * >::type list;
             //find the nodes that intersect the AAB
-            static_cast<OctreeSceneManager*>( mParentSceneMgr ) -> findNodesIn( e->getWorldBoundingBox(), list, 0 );
+            mNodes.clear();
+            static_cast<OctreeSceneManager*>( mParentSceneMgr ) -> findNodesIn( e->getWorldBoundingBox(), mNodes, 0 );
             //grab all moveables from the node that intersect...
-            Ogre::list< SceneNode * >::type::iterator nit = list.begin();
-            while( nit != list.end() )
+            vector< SceneNode * >::type::iterator nit = mNodes.begin();
+            while( nit != mNodes.end() )
             {
                 SceneNode::ObjectIterator oit = (*nit) -> getAttachedObjectIterator();
                 while( oit.hasMoreElements() )
@@ -134,13 +134,13 @@ OctreeAxisAlignedBoxSceneQuery::~OctreeAxisAlignedBoxSceneQuery()
 /** Finds any entities that intersect the AAB for the query. */
 void OctreeAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
 {
-    list< SceneNode * >::type _list;
     //find the nodes that intersect the AAB
-    static_cast<OctreeSceneManager*>( mParentSceneMgr ) -> findNodesIn( mAABB, _list, 0 );
+    mNodes.clear();
+    static_cast<OctreeSceneManager*>( mParentSceneMgr ) -> findNodesIn( mAABB, mNodes, 0 );
 
     //grab all moveables from the node that intersect...
-    list< SceneNode * >::type::iterator it = _list.begin();
-    while( it != _list.end() )
+    vector< SceneNode * >::type::iterator it = mNodes.begin();
+    while( it != mNodes.end() )
     {
         SceneNode::ObjectIterator oit = (*it) -> getAttachedObjectIterator();
         while( oit.hasMoreElements() )
@@ -185,13 +185,13 @@ OctreeRaySceneQuery::~OctreeRaySceneQuery()
 //---------------------------------------------------------------------
 void OctreeRaySceneQuery::execute(RaySceneQueryListener* listener)
 {
-    list< SceneNode * >::type _list;
     //find the nodes that intersect the AAB
-    static_cast<OctreeSceneManager*>( mParentSceneMgr ) -> findNodesIn( mRay, _list, 0 );
+    mNodes.clear();
+    static_cast<OctreeSceneManager*>( mParentSceneMgr ) -> findNodesIn( mRay, mNodes, 0 );
 
     //grab all moveables from the node that intersect...
-    list< SceneNode * >::type::iterator it = _list.begin();
-    while( it != _list.end() )
+    vector< SceneNode * >::type::iterator it = mNodes.begin();
+    while( it != mNodes.end() )
     {
         SceneNode::ObjectIterator oit = (*it) -> getAttachedObjectIterator();
         while( oit.hasMoreElements() )
@@ -244,13 +244,13 @@ OctreeSphereSceneQuery::~OctreeSphereSceneQuery()
 //---------------------------------------------------------------------
 void OctreeSphereSceneQuery::execute(SceneQueryListener* listener)
 {
-    list< SceneNode * >::type _list;
     //find the nodes that intersect the AAB
-    static_cast<OctreeSceneManager*>( mParentSceneMgr ) -> findNodesIn( mSphere, _list, 0 );
+    mNodes.clear();
+    static_cast<OctreeSceneManager*>( mParentSceneMgr ) -> findNodesIn( mSphere, mNodes, 0 );
 
     //grab all moveables from the node that intersect...
-    list< SceneNode * >::type::iterator it = _list.begin();
-    while( it != _list.end() )
+    vector< SceneNode * >::type::iterator it = mNodes.begin();
+    while( it != mNodes.end() )
     {
         SceneNode::ObjectIterator oit = (*it) -> getAttachedObjectIterator();
         while( oit.hasMoreElements() )
@@ -302,14 +302,14 @@ void OctreePlaneBoundedVolumeListSceneQuery::execute(SceneQueryListener* listene
     piend = mVolumes.end();
     for (pi = mVolumes.begin(); pi != piend; ++pi)
     {
-        list< SceneNode * >::type _list;
         //find the nodes that intersect the AAB
-        static_cast<OctreeSceneManager*>( mParentSceneMgr ) -> findNodesIn( *pi, _list, 0 );
+        mNodes.clear();
+        static_cast<OctreeSceneManager*>( mParentSceneMgr ) -> findNodesIn( *pi, mNodes, 0 );
 
         //grab all moveables from the node that intersect...
-        list< SceneNode * >::type::iterator it, itend;
-        itend = _list.end();
-        for (it = _list.begin(); it != itend; ++it)
+        vector< SceneNode * >::type::iterator it, itend;
+        itend = mNodes.end();
+        for (it = mNodes.begin(); it != itend; ++it)
         {
             // avoid double-check same scene node
             if (!checkedSceneNodes.insert(*it).second)
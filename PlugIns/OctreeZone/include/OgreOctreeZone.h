@@ -125,6 +125,11 @@ namespace Ogre
                                       bool displayNodes,
                                       bool showBoundingBoxes);
 
+        /// @copydoc PCZone::findVisibleNodesInZone
+        virtual void findVisibleNodesInZone(const PCZCamera* camera,
+                                            const PCZFrustum& frustum,
+                                            PCZSceneNodeVector& visibleNodes);
+
         /** Functions for finding Nodes that intersect various shapes */
         virtual void _findNodes(const AxisAlignedBox &t, 
                                 PCZSceneNodeList &list,
@@ -208,6 +213,16 @@ namespace Ogre
                          bool displayNodes,
                          bool showBoundingBoxes);
 
+        /** Walks through the octree, collecting the nodes visible through the frustum.
+        @remarks
+        Only reads the octree, see findVisibleNodesInZone.
+        */
+        void walkOctree( const PCZCamera *,
+                         const PCZFrustum &,
+                         Octree *,
+                         bool foundvisible,
+                         PCZSceneNodeVector & );
+
     protected:
         /// The root octree
         Octree *mOctree;
@@ -584,88 +584,29 @@ namespace Ogre
                    displayNodes,
                    showBoundingBoxes);
 
-        // Here we merge both portal and antiportal visible to the camera into one list.
-        // Then we sort them in the order from nearest to furthest from camera.
-        PortalBaseList sortedPortalList;
-        for (AntiPortalList::iterator iter = mAntiPortals.begin(); iter != mAntiPortals.end(); ++iter)
-        {
-            AntiPortal* portal = *iter;
-            if (camera->isVisible(portal))
-            {
-                sortedPortalList.push_back(portal);
-            }
-        }
-        for (PortalList::iterator iter = mPortals.begin(); iter != mPortals.end(); ++iter)
+        // recurse into the zones behind the visible portals, nearest first
+        PortalList visiblePortals;
+        getVisiblePortals(camera, camera->getExtraCullingFrustum(), visiblePortals);
+        for (PortalList::iterator iter = visiblePortals.begin(); iter != visiblePortals.end(); ++iter)
         {
             Portal* portal = *iter;
-            if (camera->isVisible(portal))
-            {
-                sortedPortalList.push_back(portal);
-            }
-        }
-        const Vector3& cameraOrigin(camera->getDerivedPosition());
-        std::sort(sortedPortalList.begin(), sortedPortalList.end(),
-            PortalSortDistance(cameraOrigin));
-
-        // create a standalone frustum for anti portal use.
-        // we're doing this instead of using camera because we don't need
-        // to do camera frustum check again.
-        PCZFrustum antiPortalFrustum;
-        antiPortalFrustum.setOrigin(cameraOrigin);
-        antiPortalFrustum.setProjectionType(camera->getProjectionType());
-
-        // now we do culling check and remove hidden portals.
-        // whenever we get a portal in the main loop, we can be sure that it is not
-        // occluded by AntiPortal. So we do traversal right there and then.
-        // This is because the portal list has been sorted.
-        size_t sortedPortalListCount = sortedPortalList.size();
-        for (size_t i = 0; i < sortedPortalListCount; ++i)
-        {
-            PortalBase* portalBase = sortedPortalList[i];
-            if (!portalBase) continue; // skip removed portal.
-
-            if (portalBase->getTypeFlags() == PortalFactory::FACTORY_TYPE_FLAG)
-            {
-                Portal* portal = static_cast<Portal*>(portalBase);
-                // portal is visible. Add the portal as extra culling planes to camera
-                int planes_added = camera->addPortalCullingPlanes(portal);
-                // tell target zone it's visible this frame
-                portal->getTargetZone()->setLastVisibleFrame(mLastVisibleFrame);
-                portal->getTargetZone()->setLastVisibleFromCamera(camera);
-                // recurse into the connected zone 
-                portal->getTargetZone()->findVisibleNodes(camera,
-                                                          visibleNodeList,
-                                                          queue,
-                                                          visibleBounds,
-                                                          onlyShadowCasters,
-                                                          displayNodes,
-                                                          showBoundingBoxes);
-                if (planes_added > 0)
-                {
-                    // Then remove the extra culling planes added before going to the next portal in the list.
-                    camera->removePortalCullingPlanes(portal);
-                }
-            }
-            else if (i < sortedPortalListCount) // skip antiportal test if it is the last item in the list.
+            // portal is visible. Add the portal as extra culling planes to camera
+            int planes_added = camera->addPortalCullingPlanes(portal);
+            // tell target zone it's visible this frame
+            portal->getTargetZone()->setLastVisibleFrame(mLastVisibleFrame);
+            portal->getTargetZone()->setLastVisibleFromCamera(camera);
+            // recurse into the connected zone 
+            portal->getTargetZone()->findVisibleNodes(camera,
+                                                      visibleNodeList,
+                                                      queue,
+                                                      visibleBounds,
+                                                      onlyShadowCasters,
+                                                      displayNodes,
+                                                      showBoundingBoxes);
+            if (planes_added > 0)
             {
-                // this is an anti portal. So we use it to test preceding portals in the list.
-                AntiPortal* antiPortal = static_cast<AntiPortal*>(portalBase);
-                int planes_added = antiPortalFrustum.addPortalCullingPlanes(antiPortal);
-
-                for (size_t j = i + 1; j < sortedPortalListCount; ++j)
-                {
-                    PortalBase* otherPortal = sortedPortalList[j];
-                    // Since this is an antiportal, we are doing the inverse of the test.
-                    // Here if the portal is fully visible in the anti portal fustrum, it means it's hidden.
-                    if (otherPortal && antiPortalFrustum.isFullyVisible(otherPortal))
-                        sortedPortalList[j] = NULL;
-                }
-
-                if (planes_added > 0)
-                {
-                    // Then remove the extra culling planes added before going to the next portal in the list.
-                    antiPortalFrustum.removePortalCullingPlanes(antiPortal);
-                }
+                // Then remove the extra culling planes added before going to the next portal in the list.
+                camera->removePortalCullingPlanes(portal);
             }
         }
     }
@@ -779,6 +720,61 @@ namespace Ogre
         }
     }
 
+    void OctreeZone::findVisibleNodesInZone(const PCZCamera* camera,
+                                            const PCZFrustum& frustum,
+                                            PCZSceneNodeVector& visibleNodes)
+    {
+        walkOctree(camera, frustum, mOctree, false, visibleNodes);
+    }
+
+    void OctreeZone::walkOctree(const PCZCamera *camera,
+                                const PCZFrustum &frustum,
+                                Octree *octant,
+                                bool foundvisible,
+                                PCZSceneNodeVector &visibleNodes)
+    {
+        //return immediately if nothing is in the node.
+        if ( octant -> numNodes() == 0 )
+            return ;
+
+        PCZCamera::Visibility v = PCZCamera::NONE;
+
+        if ( foundvisible )
+        {
+            v = PCZCamera::FULL;
+        }
+        else if ( octant == mOctree )
+        {
+            v = PCZCamera::PARTIAL;
+        }
+        else
+        {
+            AxisAlignedBox box;
+            octant -> _getCullBounds( &box );
+            v = camera -> getVisibility( box, frustum );
+        }
+
+        if ( v == PCZCamera::NONE )
+            return;
+
+        // if this octree is partially visible, manually cull all
+        // scene nodes attached directly to this level.
+        PCZSceneNodeList::iterator it;
+        for (it = octant -> mNodes.begin(); it != octant -> mNodes.end(); ++it)
+        {
+            if ( v == PCZCamera::FULL || camera -> isVisible( (*it) -> _getWorldAABB(), frustum ) )
+                visibleNodes.push_back( *it );
+        }
+
+        bool childfoundvisible = (v == PCZCamera::FULL);
+        for (int i = 0; i < 8; ++i)
+        {
+            Octree* child = octant -> mChildren[ i & 1 ][ ( i >> 1 ) & 1 ][ i >> 2 ];
+            if ( child )
+                walkOctree( camera, frustum, child, childfoundvisible, visibleNodes );
+        }
+    }
+
     // --- find nodes which intersect various types of BV's ---
 
     void OctreeZone::_findNodes(const AxisAlignedBox &t, 
@@ -78,6 +78,19 @@ namespace Ogre
         /* isVisible() function for portals */
         bool isVisible(PortalBase* portal, FrustumPlane* culledBy = 0) const;
 
+        /** isVisible function for aabb, using the culling planes of the given
+            frustum instead of the extra culling planes of the camera.
+        @remarks
+            Lets different portal branches be checked from different threads, as
+            long as the frustum planes of the camera are up to date.
+        */
+        bool isVisible( const AxisAlignedBox &bound, const PCZFrustum& portalFrustum,
+            FrustumPlane *culledBy = 0) const;
+
+        /** isVisible() function for portals, using the culling planes of the given frustum */
+        bool isVisible(PortalBase* portal, const PCZFrustum& portalFrustum,
+            FrustumPlane* culledBy = 0) const;
+
         /** Returns the visibility of the box
         */
         bool isVisibile( const AxisAlignedBox &bound );
@@ -86,6 +99,14 @@ namespace Ogre
         */
         PCZCamera::Visibility getVisibility( const AxisAlignedBox &bound );
 
+        /** Returns the detailed visibility of the box, using the culling planes of
+            the given frustum */
+        PCZCamera::Visibility getVisibility( const AxisAlignedBox &bound,
+            const PCZFrustum& portalFrustum ) const;
+
+        /// Get the frustum holding the extra culling planes
+        const PCZFrustum& getExtraCullingFrustum(void) const { return mExtraCullingFrustum; }
+
         /// Sets the type of projection to use (orthographic or perspective).
         void setProjectionType(ProjectionType pt);
 
@@ -79,8 +79,12 @@ namespace Ogre
 
         /** Standard constructor */
         PCZFrustum();
+        /** Copy constructor, the copy gets its own culling planes */
+        PCZFrustum(const PCZFrustum& other);
         /** Standard destructor */
         ~PCZFrustum();
+        /** Assignment, replaces the culling planes with copies of the other ones */
+        PCZFrustum& operator=(const PCZFrustum& other);
 
         /* isVisible function for aabb */
         bool isVisible( const AxisAlignedBox &bound) const;
@@ -95,7 +99,7 @@ namespace Ogre
         /* special function that returns true only when portal fully fits inside the frustum. */
         bool isFullyVisible(const PortalBase* portal) const;
         /* more detailed check for visibility of an AABB */
-        PCZFrustum::Visibility getVisibility(const AxisAlignedBox & bound);
+        PCZFrustum::Visibility getVisibility(const AxisAlignedBox & bound) const;
 
         /** Calculate  culling planes from portal and Frustum
             origin and add to list of culling planes */
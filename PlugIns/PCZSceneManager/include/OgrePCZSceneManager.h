@@ -126,6 +126,9 @@ namespace Ogre
         /** Creates a specialized PCZCamera */
         virtual Camera * createCamera( const String &name );
 
+        /** Overridden to forget the zones the camera saw */
+        virtual void destroyCamera( const String &name );
+
         /** Deletes a scene node by name & corresponding PCZSceneNode */
         virtual void destroySceneNode( const String &name );
 
@@ -233,6 +236,34 @@ namespace Ogre
         /** Destroy an existing zone within the scene */
         void destroyZone(PCZone* zone, bool destroySceneNodes);
 
+        /** Compute which zones may be seen from which, for use with setPVS.
+        @remarks
+            Meant to be run offline once the zones and portals are set up,
+            with the result saved using PotentiallyVisibleSetSerializer. The
+            cells are the zones, by name. A zone may be seen from another one
+            if there is a chain of portals between them where each portal
+            lies at least partly beyond all the previous ones, which is
+            conservative: nothing which may be seen is left out. Disabled
+            portals are followed too, as they may be enabled at runtime.
+        @param pvs The set to fill
+        @param maxPortalDepth Chains of more portals are not followed
+        */
+        void computePVS(PotentiallyVisibleSet& pvs, size_t maxPortalDepth = 16);
+
+        /** Use precomputed zone visibility when finding the visible objects.
+        @remarks
+            The set is copied. Portals to zones which can't be seen from the
+            zone of the camera are not followed, zones without a cell in the
+            set are always followed.
+        */
+        void setPVS(const PotentiallyVisibleSet& pvs);
+
+        /** Stop using precomputed zone visibility */
+        void clearPVS(void);
+
+        /** Get the precomputed zone visibility in use, or 0 if there is none */
+        const PotentiallyVisibleSet* getPVS(void) const { return mPVS; }
+
         /** Make sure the home zone for the PCZSceneNode is up-to-date
         */
         void _updateHomeZone( PCZSceneNode *, bool );
@@ -302,6 +333,9 @@ namespace Ogre
             Options are:
             "ShowPortals", bool *;
             "ShowBoundingBoxes", bool *;
+            "CacheZoneVisibility", bool *; reuse the zones a camera saw
+            in the previous frame while the camera, its zone and the portals
+            are unchanged, true by default.
         */
         virtual bool setOption( const String &, const void * );
         /** Gets the given option for the Scene Manager.
@@ -331,6 +365,9 @@ namespace Ogre
         virtual void prepareShadowTextures(Camera* cam, Viewport* vp, const LightList* lightList = 0);
 
     protected:
+        /// PCZSceneNode::_update tracks movement between zones outside of Node::_update
+        bool isParallelUpdateSafe(void) const { return false; }
+
         /// Type of default zone to be used
         String mDefaultZoneTypeName;
 
@@ -361,12 +398,49 @@ namespace Ogre
         /// Frame counter used in visibility determination
         unsigned long mFrameCount;
 
+        /** Zones a camera saw, reused while the camera, its home zone and the
+            portals are unchanged */
+        struct CameraZoneVisibility
+        {
+            PCZone* homeZone;
+            Matrix4 viewMatrix;
+            Matrix4 projectionMatrix;
+            unsigned long portalStateCount;
+            ZoneVisitList visits;
+
+            CameraZoneVisibility() : homeZone(0), portalStateCount(0) {}
+        };
+        typedef map<const Camera*, CameraZoneVisibility>::type CameraZoneVisibilityMap;
+        CameraZoneVisibilityMap mCameraZoneVisibility;
+
+        /// Whether the zones a camera saw are reused across frames
+        bool mCacheZoneVisibility;
+
+        /// Incremented whenever portals or zones changed, outdating the zones cameras saw
+        unsigned long mPortalStateCount;
+
+        /// Zone visits found behind each visible portal of the camera zone
+        vector<ZoneVisitList>::type mBranchVisits;
+
+        /// Visible nodes found in each zone visit
+        vector<PCZSceneNodeVector>::type mVisitNodes;
+
+        /// Precomputed zone visibility, if any
+        PotentiallyVisibleSet* mPVS;
+
         /// ZoneFactoryManager instance
         PCZoneFactoryManager * mZoneFactoryManager;
 
         /// The zone of the active camera (for shadow texture casting use);
         PCZone* mActiveCameraZone;
 
+        /** Get the zones the camera sees from its home zone.
+        @remarks
+            Reuses the zones of an earlier call if nothing changed since, else
+            follows the portals of the home zone in parallel.
+        */
+        const ZoneVisitList& findVisibleZones(PCZCamera* cam, PCZone* homeZone);
+
         /** Internal method for locating a list of lights which could be affecting the frustum. 
         @remarks
             Custom scene managers are encouraged to override this method to make use of their
@@ -53,6 +53,8 @@ Code Style Update    :
 
 #include "OgrePCZPrerequisites.h"
 #include "OgrePortalBase.h"
+#include "OgrePCZFrustum.h"
+#include "OgrePotentiallyVisibleSet.h"
 
 namespace Ogre
 {
@@ -63,7 +65,6 @@ namespace Ogre
     class PCZLight;
     class PCZone;
     class PCZCamera;
-    class PCZFrustum;
     struct VisibleObjectsBoundsInfo;
 
     typedef map<String, PCZone*>::type ZoneMap;
@@ -74,6 +75,17 @@ namespace Ogre
     typedef vector<SceneNode*>::type NodeList;
     typedef set< PCZSceneNode * >::type PCZSceneNodeList;
     typedef map<String, SceneNode*>::type SceneNodeList;
+    typedef vector<PCZSceneNode*>::type PCZSceneNodeVector;
+
+    /** A zone seen by a camera, with the culling planes of the portals it
+        was seen through.
+    */
+    struct ZoneVisit
+    {
+        PCZone* zone;
+        PCZFrustum frustum;
+    };
+    typedef vector<ZoneVisit>::type ZoneVisitList;
 
     /** Portal-Connected Zone datastructure for managing scene nodes.
     */
@@ -121,6 +133,13 @@ namespace Ogre
         /** Get the lastVisibleFromCamera pointer */
         PCZCamera* getLastVisibleFromCamera() {return mLastVisibleFromCamera;}
 
+        /** Set the cell of this zone in the potentially visible set of the scene manager */
+        void _setPVSCell(size_t cell) {mPVSCell = cell;}
+
+        /** Get the cell of this zone in the potentially visible set, or
+            PotentiallyVisibleSet::NO_CELL if it has none */
+        size_t _getPVSCell(void) const {return mPVSCell;}
+
     public:
         /** Set the enclosure node for this PCZone
         */
@@ -200,6 +219,41 @@ namespace Ogre
                                       bool displayNodes,
                                       bool showBoundingBoxes) = 0;
 
+        /** Find the zones visible to the camera, starting with this one.
+        @remarks
+            Adds a visit of this zone and recurses through the visible portals.
+            The frustum holds the culling planes of the portals passed so far,
+            and is left as it was on return. Unlike findVisibleNodes this only
+            reads the scene, so separate portal branches can be searched from
+            different threads.
+        @param pvs If given, portals to zones which can't be seen from the
+            cell fromCell are not followed
+        */
+        void findVisibleZones(const PCZCamera* camera, PCZFrustum& frustum,
+                              ZoneVisitList& visits,
+                              const PotentiallyVisibleSet* pvs = 0,
+                              size_t fromCell = PotentiallyVisibleSet::NO_CELL);
+
+        /** Get the portals of this zone the camera sees through the frustum,
+            nearest first, leaving out the ones hidden by anti portals.
+        @param pvs If given, also leaves out the portals to zones which can't
+            be seen from the cell fromCell
+        */
+        void getVisiblePortals(const PCZCamera* camera, const PCZFrustum& frustum,
+                               PortalList& portals,
+                               const PotentiallyVisibleSet* pvs = 0,
+                               size_t fromCell = PotentiallyVisibleSet::NO_CELL);
+
+        /** Find the nodes of this zone the camera sees through the frustum.
+        @remarks
+            Includes the visitor nodes, but does not follow portals nor touch
+            the render queue, so several zones can be searched from different
+            threads at once.
+        */
+        virtual void findVisibleNodesInZone(const PCZCamera* camera,
+                                            const PCZFrustum& frustum,
+                                            PCZSceneNodeVector& visibleNodes);
+
         /* Functions for finding Nodes that intersect various shapes */
         virtual void _findNodes( const AxisAlignedBox &t, 
                                  PCZSceneNodeList &list, 
@@ -278,6 +332,8 @@ namespace Ogre
         PCZCamera * mLastVisibleFromCamera;
         /// Flag determining whether or not this zone has sky in it.
         bool mHasSky;
+        /// Cell of this zone in the potentially visible set
+        size_t mPVSCell;
         /// SceneNode which corresponds to the enclosure for this zone
         SceneNode * mEnclosureNode;
         /// List of SceneNodes contained in this particular PCZone
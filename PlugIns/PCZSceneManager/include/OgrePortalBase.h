@@ -153,8 +153,7 @@ namespace Ogre
         /** Adjust the portal so that it is centered and oriented on the given node */
         void adjustNodeToMatch(SceneNode* node);
         /** enable the portal */
-        void setEnabled(bool value)
-        { mEnabled = value; }
+        void setEnabled(bool value);
         /** Check if portal is enabled */
         bool getEnabled() const {return mEnabled;}
         
@@ -56,6 +56,12 @@ namespace Ogre
 
     // this version checks against extra culling planes
     bool PCZCamera::isVisible( const AxisAlignedBox &bound, FrustumPlane *culledBy) const 
+    {
+        return isVisible(bound, mExtraCullingFrustum, culledBy);
+    }
+
+    bool PCZCamera::isVisible( const AxisAlignedBox &bound, const PCZFrustum& portalFrustum,
+        FrustumPlane *culledBy) const
     {
         // Null boxes always invisible
         if ( bound.isNull() )
@@ -66,7 +72,7 @@ namespace Ogre
 
         // check extra culling planes
         bool extraResults;
-        extraResults = mExtraCullingFrustum.isVisible(bound);
+        extraResults = portalFrustum.isVisible(bound);
         if (!extraResults)
         {
             return false;
@@ -89,6 +95,12 @@ namespace Ogre
       none, partial, or full for visibility of the box.  This is useful for 
       stuff like Octree leaf culling */
     PCZCamera::Visibility PCZCamera::getVisibility( const AxisAlignedBox &bound )
+    {
+        return getVisibility(bound, mExtraCullingFrustum);
+    }
+
+    PCZCamera::Visibility PCZCamera::getVisibility( const AxisAlignedBox &bound,
+        const PCZFrustum& portalFrustum ) const
     {
 
         // Null boxes always invisible
@@ -117,7 +129,7 @@ namespace Ogre
                     all_inside = false;
         }
         
-        switch(mExtraCullingFrustum.getVisibility(bound))
+        switch(portalFrustum.getVisibility(bound))
         {
         case PCZFrustum::NONE:
             return NONE;
@@ -138,12 +150,18 @@ namespace Ogre
     // NOTE: Everything needs to be updated spatially before this function is
     //       called including portal corners, frustum planes, etc.
     bool PCZCamera::isVisible(PortalBase* portal, FrustumPlane* culledBy) const
+    {
+        return isVisible(portal, mExtraCullingFrustum, culledBy);
+    }
+
+    bool PCZCamera::isVisible(PortalBase* portal, const PCZFrustum& portalFrustum,
+        FrustumPlane* culledBy) const
     {
         // if portal isn't enabled, it's not visible
         if (!portal->getEnabled()) return false;
 
         // check the extra frustum first
-        if (!mExtraCullingFrustum.isVisible(portal))
+        if (!portalFrustum.isVisible(portal))
         {
             return false;
         }
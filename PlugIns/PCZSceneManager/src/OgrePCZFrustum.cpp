@@ -61,6 +61,38 @@ namespace Ogre
     mUseOriginPlane(false), mProjType(PT_PERSPECTIVE)
     { }
 
+    PCZFrustum::PCZFrustum(const PCZFrustum& other) :
+    mOrigin(other.mOrigin), mOriginPlane(other.mOriginPlane),
+    mUseOriginPlane(other.mUseOriginPlane), mProjType(other.mProjType)
+    {
+        for (PCPlaneList::const_iterator pit = other.mActiveCullingPlanes.begin();
+            pit != other.mActiveCullingPlanes.end(); ++pit)
+        {
+            mActiveCullingPlanes.push_back(OGRE_NEW_T(PCPlane, MEMCATEGORY_SCENE_CONTROL)(**pit));
+        }
+    }
+
+    PCZFrustum& PCZFrustum::operator=(const PCZFrustum& other)
+    {
+        if (this == &other)
+            return *this;
+
+        mOrigin = other.mOrigin;
+        mOriginPlane = other.mOriginPlane;
+        mUseOriginPlane = other.mUseOriginPlane;
+        mProjType = other.mProjType;
+        // reuse the planes we already have where possible
+        removeAllCullingPlanes();
+        for (PCPlaneList::const_iterator pit = other.mActiveCullingPlanes.begin();
+            pit != other.mActiveCullingPlanes.end(); ++pit)
+        {
+            PCPlane * plane = getUnusedCullingPlane();
+            *plane = **pit;
+            mActiveCullingPlanes.push_back(plane);
+        }
+        return *this;
+    }
+
     PCZFrustum::~PCZFrustum()
     {
         removeAllCullingPlanes();
@@ -415,7 +447,7 @@ namespace Ogre
     /* A 'more detailed' check for visibility of an AAB.  This function returns
       none, partial, or full for visibility of the box.  This is useful for 
       stuff like Octree leaf culling */
-    PCZFrustum::Visibility PCZFrustum::getVisibility( const AxisAlignedBox &bound )
+    PCZFrustum::Visibility PCZFrustum::getVisibility( const AxisAlignedBox &bound ) const
     {
 
         // Null boxes always invisible
@@ -446,7 +478,7 @@ namespace Ogre
 
         // For each active culling plane, see if the entire aabb is on the negative side
         // If so, object is not visible
-        PCPlaneList::iterator pit = mActiveCullingPlanes.begin();
+        PCPlaneList::const_iterator pit = mActiveCullingPlanes.begin();
         while ( pit != mActiveCullingPlanes.end() )
         {
             PCPlane * plane = *pit;
@@ -43,6 +43,7 @@ email                : ericc@xenopi.com
 #include "OgrePortal.h"
 #include "OgreLogManager.h"
 #include "OgreRoot.h"
+#include "Threading/OgreParallel.h"
 
 #if OGRE_NODE_STORAGE_LEGACY
 #define ITER_VAL(it) it->second
@@ -52,6 +53,135 @@ email                : ericc@xenopi.com
 
 namespace Ogre
 {
+    namespace
+    {
+        /// Follows one portal of the camera zone, see PCZSceneManager::findVisibleZones
+        struct FindZonesFunc
+        {
+            const PCZCamera* camera;
+            const PCZFrustum* frustum;
+            const vector<Portal*>::type* portals;
+            vector<ZoneVisitList>::type* visits;
+            const PotentiallyVisibleSet* pvs;
+            size_t fromCell;
+
+            FindZonesFunc(const PCZCamera* c, const PCZFrustum* f,
+                const vector<Portal*>::type* p, vector<ZoneVisitList>::type* v,
+                const PotentiallyVisibleSet* s, size_t cell)
+                : camera(c), frustum(f), portals(p), visits(v), pvs(s), fromCell(cell) {}
+
+            void operator()(size_t index) const
+            {
+                Portal* portal = (*portals)[index];
+                ZoneVisitList& branch = (*visits)[index];
+                branch.clear();
+                // each branch adds its culling planes to its own frustum
+                PCZFrustum branchFrustum(*frustum);
+                branchFrustum.addPortalCullingPlanes(portal);
+                portal->getTargetZone()->findVisibleZones(camera, branchFrustum, branch,
+                    pvs, fromCell);
+            }
+        };
+
+        /// Finds the visible nodes of one zone visit
+        struct FindNodesFunc
+        {
+            const PCZCamera* camera;
+            const ZoneVisitList* visits;
+            vector<PCZSceneNodeVector>::type* nodes;
+
+            FindNodesFunc(const PCZCamera* c, const ZoneVisitList* v,
+                vector<PCZSceneNodeVector>::type* n)
+                : camera(c), visits(v), nodes(n) {}
+
+            void operator()(size_t index) const
+            {
+                const ZoneVisit& visit = (*visits)[index];
+                PCZSceneNodeVector& visible = (*nodes)[index];
+                visible.clear();
+                visit.zone->findVisibleNodesInZone(camera, visit.frustum, visible);
+            }
+        };
+
+        /// Returns whether some corner of the quad portal is on the given side of the plane
+        bool hasCornerOnSide(const PortalBase* portal, const Plane& plane, Plane::Side side)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                if (plane.getSide(portal->getDerivedCorner(i)) == side)
+                    return true;
+            }
+            return false;
+        }
+
+        /// Returns whether a line of sight may pass through all portals of the chain and then the portal
+        bool canSeeThrough(const vector<Portal*>::type& chain, const Portal* portal)
+        {
+            if (portal->getType() != PortalBase::PORTAL_TYPE_QUAD)
+                return true;
+            for (size_t i = 0; i < chain.size(); ++i)
+            {
+                const Portal* previous = chain[i];
+                if (previous->getType() != PortalBase::PORTAL_TYPE_QUAD)
+                    continue;
+                // the portal faces the zone it is in, so what lies beyond it
+                // is on the negative side of its plane
+                if (!hasCornerOnSide(portal, previous->getDerivedPlane(), Plane::NEGATIVE_SIDE) ||
+                    !hasCornerOnSide(previous, portal->getDerivedPlane(), Plane::POSITIVE_SIDE))
+                    return false;
+            }
+            return true;
+        }
+
+        /// Computes the zones which may be seen from one zone, see PCZSceneManager::computePVS
+        struct PortalFlowFunc
+        {
+            const vector<PCZone*>::type* zones;
+            const map<PCZone*, size_t>::type* cells;
+            PotentiallyVisibleSet* pvs;
+            size_t maxPortalDepth;
+
+            PortalFlowFunc(const vector<PCZone*>::type* z, const map<PCZone*, size_t>::type* c,
+                PotentiallyVisibleSet* p, size_t depth)
+                : zones(z), cells(c), pvs(p), maxPortalDepth(depth) {}
+
+            void operator()(size_t index) const
+            {
+                vector<Portal*>::type chain;
+                vector<PCZone*>::type path(1, (*zones)[index]);
+                flow(index, chain, path);
+            }
+
+            void flow(size_t from, vector<Portal*>::type& chain, vector<PCZone*>::type& path) const
+            {
+                PCZone* zone = path.back();
+                for (PortalList::iterator it = zone->mPortals.begin(); it != zone->mPortals.end(); ++it)
+                {
+                    Portal* portal = *it;
+                    PCZone* target = portal->getTargetZone();
+                    // don't go back through zones already on the path
+                    if (!target || std::find(path.begin(), path.end(), target) != path.end())
+                        continue;
+                    if (!canSeeThrough(chain, portal))
+                        continue;
+
+                    map<PCZone*, size_t>::type::const_iterator cell = cells->find(target);
+                    if (cell != cells->end())
+                        pvs->setVisible(from, cell->second);
+
+                    if (chain.size() + 1 < maxPortalDepth)
+                    {
+                        chain.push_back(portal);
+                        path.push_back(target);
+                        flow(from, chain, path);
+                        path.pop_back();
+                        chain.pop_back();
+                    }
+                }
+            }
+        };
+    }
+
     PCZSceneManager::PCZSceneManager(const String& name) :
     SceneManager(name),
     mDefaultZoneTypeName("ZoneType_Default"),
@@ -59,6 +189,9 @@ namespace Ogre
     mLastActiveCamera(0),
     mDefaultZone(0),
     mShowPortals(false),
+    mCacheZoneVisibility(true),
+    mPortalStateCount(1),
+    mPVS(0),
     mZoneFactoryManager(0),
     mActiveCameraZone(0)
     { }
@@ -86,6 +219,8 @@ namespace Ogre
         }
         mZones.clear();
         mDefaultZone = 0;
+
+        OGRE_DELETE mPVS;
     }
 
     const String& PCZSceneManager::getTypeName(void) const
@@ -286,6 +421,10 @@ namespace Ogre
         newZone = mZoneFactoryManager->createPCZone(this, zoneTypeName, zoneName);
         // add to the global list of zones
         mZones[newZone->getName()] = newZone;
+        if (mPVS)
+        {
+            newZone->_setPVSCell(mPVS->getCell(newZone->getName()));
+        }
         if (filename != "none")
         {
             // set the zone geometry
@@ -338,11 +477,7 @@ namespace Ogre
     SceneNode * PCZSceneManager::createSceneNode( void )
     {
         SceneNode * on = createSceneNodeImpl();
-#if OGRE_NODE_STORAGE_LEGACY
-        mSceneNodes[ on->getName() ] = on;
-#else
-        mSceneNodes.push_back(on);
-#endif
+        addSceneNode(on);
         // create any zone-specific data necessary
         createZoneSpecificNodeData((PCZSceneNode*)on);
         // return pointer to the node
@@ -360,11 +495,7 @@ namespace Ogre
                 "PCZSceneManager::createSceneNode" );
         }
         SceneNode * on = createSceneNodeImpl( name );
-#if OGRE_NODE_STORAGE_LEGACY
-        mSceneNodes[ on->getName() ] = on;
-#else
-        mSceneNodes.push_back(on);
-#endif
+        addSceneNode(on);
         // create any zone-specific data necessary
         createZoneSpecificNodeData((PCZSceneNode*)on);
         // return pointer to the node
@@ -401,6 +532,17 @@ namespace Ogre
         return c;
     }
 
+    void PCZSceneManager::destroyCamera( const String &name )
+    {
+        CameraList::iterator i = mCameras.find(name);
+        if (i != mCameras.end())
+        {
+            mCameraZoneVisibility.erase(i->second);
+        }
+
+        SceneManager::destroyCamera(name);
+    }
+
     // Destroy a Scene Node by name.
     void PCZSceneManager::destroySceneNode( const String &name )
     {
@@ -453,6 +595,7 @@ namespace Ogre
         }
         mZones.clear();
         mDefaultZone = 0;
+        ++mPortalStateCount;
 
         // Clear animations
         destroyAllAnimations();
@@ -732,6 +875,10 @@ namespace Ogre
         {
             // add to the global list of zones
             mZones[instanceName] = newZone;
+            if (mPVS)
+            {
+                newZone->_setPVSCell(mPVS->getCell(instanceName));
+            }
 
             if (newZone->requiresZoneSpecificNodeData())
             {
@@ -796,6 +943,55 @@ namespace Ogre
             mZones.erase(zone->getName());
         }
         OGRE_DELETE zone;
+        ++mPortalStateCount;
+    }
+
+    void PCZSceneManager::computePVS(PotentiallyVisibleSet& pvs, size_t maxPortalDepth)
+    {
+        StringVector names;
+        vector<PCZone*>::type zones;
+        map<PCZone*, size_t>::type cells;
+        for (ZoneMap::iterator i = mZones.begin(); i != mZones.end(); ++i)
+        {
+            cells[i->second] = zones.size();
+            names.push_back(i->first);
+            zones.push_back(i->second);
+        }
+        pvs.setCellNames(names);
+
+        // make sure the portal corners are in world space
+        for (PortalList::iterator i = mPortals.begin(); i != mPortals.end(); ++i)
+        {
+            (*i)->updateDerivedValues();
+        }
+
+        // each zone only writes its own row of the set
+        parallelFor(0, zones.size(), PortalFlowFunc(&zones, &cells, &pvs, maxPortalDepth));
+    }
+
+    void PCZSceneManager::setPVS(const PotentiallyVisibleSet& pvs)
+    {
+        if (!mPVS)
+            mPVS = OGRE_NEW PotentiallyVisibleSet();
+        *mPVS = pvs;
+
+        for (ZoneMap::iterator i = mZones.begin(); i != mZones.end(); ++i)
+        {
+            i->second->_setPVSCell(mPVS->getCell(i->first));
+        }
+        ++mPortalStateCount;
+    }
+
+    void PCZSceneManager::clearPVS(void)
+    {
+        OGRE_DELETE mPVS;
+        mPVS = 0;
+
+        for (ZoneMap::iterator i = mZones.begin(); i != mZones.end(); ++i)
+        {
+            i->second->_setPVSCell(PotentiallyVisibleSet::NO_CELL);
+        }
+        ++mPortalStateCount;
     }
 
     /* The following function checks if a node has left it's current home zone.
@@ -1232,25 +1428,122 @@ namespace Ogre
         // turn off sky 
         enableSky(false);
 
+        PCZCamera* pczCam = static_cast<PCZCamera*>(cam);
+
         // remove all extra culling planes
-        ((PCZCamera*)cam)->removeAllExtraCullingPlanes();
+        pczCam->removeAllExtraCullingPlanes();
 
         // update the camera
-        ((PCZCamera*)cam)->update();
+        pczCam->update();
+        // bring the lazily updated frustum planes up to date before the
+        // threads below read them
+        pczCam->getFrustumPlanes();
+        if (pczCam->getCullingFrustum())
+            pczCam->getCullingFrustum()->getFrustumPlanes();
 
         // get the home zone of the camera
         PCZone* cameraHomeZone = ((PCZSceneNode*)(cam->getParentSceneNode()))->getHomeZone();
-
-        // walk the zones, starting from the camera home zone,
-        // adding all visible scene nodes to the mVisibles list
         cameraHomeZone->setLastVisibleFrame(mFrameCount);
-        cameraHomeZone->findVisibleNodes((PCZCamera*)cam, 
-                                          mVisible, 
-                                          getRenderQueue(),
-                                          visibleBounds, 
-                                          onlyShadowCasters,
-                                          mDisplayNodes,
-                                          mShowBoundingBoxes);
+
+        // find the zones seen by the camera, then search them all for
+        // visible nodes at once
+        const ZoneVisitList& visits = findVisibleZones(pczCam, cameraHomeZone);
+        if (mVisitNodes.size() < visits.size())
+            mVisitNodes.resize(visits.size());
+        parallelFor(0, visits.size(), FindNodesFunc(pczCam, &visits, &mVisitNodes));
+
+        // add the nodes to the render queue in the order the zones were found,
+        // adding nodes seen from more than one zone only once
+        RenderQueue* queue = getRenderQueue();
+        for (size_t i = 0; i < visits.size(); ++i)
+        {
+            PCZone* zone = visits[i].zone;
+            // tell the zone it's visible this frame
+            zone->setLastVisibleFrame(mFrameCount);
+            zone->setLastVisibleFromCamera(pczCam);
+            // enable sky if called to do so for this zone
+            if (zone->hasSky())
+                enableSky(true);
+
+            const PCZSceneNodeVector& nodes = mVisitNodes[i];
+            for (PCZSceneNodeVector::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+            {
+                PCZSceneNode* pczsn = *it;
+                // if the scene node is already visible, then we can skip it
+                if (pczsn->getLastVisibleFrame() == mFrameCount &&
+                    pczsn->getLastVisibleFromCamera() == pczCam)
+                    continue;
+
+                // add it to the list of visible nodes
+                mVisible.push_back(pczsn);
+                // add the node to the render queue
+                pczsn->_addToRenderQueue(cam, queue, onlyShadowCasters, visibleBounds);
+                // if we are displaying nodes, add the node renderable to the queue
+                if (mDisplayNodes)
+                {
+                    queue->addRenderable(pczsn->getDebugRenderable());
+                }
+                // if the scene manager or the node wants the bounding box shown, add it to the queue
+                if (pczsn->getShowBoundingBox() || mShowBoundingBoxes)
+                {
+                    pczsn->_addBoundingBoxToQueue(queue);
+                }
+                // flag the node as being visible this frame
+                pczsn->setLastVisibleFrame(mFrameCount);
+                pczsn->setLastVisibleFromCamera(pczCam);
+            }
+        }
+    }
+
+    const ZoneVisitList& PCZSceneManager::findVisibleZones(PCZCamera* cam, PCZone* homeZone)
+    {
+        CameraZoneVisibility& visibility = mCameraZoneVisibility[cam];
+        const Matrix4& viewMatrix = cam->getViewMatrix(true);
+        const Matrix4& projectionMatrix = cam->getProjectionMatrix();
+
+        // a custom culling frustum can move without the camera, so don't
+        // trust the cache then
+        if (mCacheZoneVisibility && !cam->getCullingFrustum() &&
+            visibility.homeZone == homeZone &&
+            visibility.portalStateCount == mPortalStateCount &&
+            visibility.viewMatrix == viewMatrix &&
+            visibility.projectionMatrix == projectionMatrix)
+        {
+            return visibility.visits;
+        }
+
+        visibility.homeZone = homeZone;
+        visibility.portalStateCount = mPortalStateCount;
+        visibility.viewMatrix = viewMatrix;
+        visibility.projectionMatrix = projectionMatrix;
+        visibility.visits.clear();
+
+        // the camera zone itself, then the zones behind each of its visible
+        // portals, which are independent of each other
+        const PCZFrustum& frustum = cam->getExtraCullingFrustum();
+        visibility.visits.push_back(ZoneVisit());
+        visibility.visits.back().zone = homeZone;
+        visibility.visits.back().frustum = frustum;
+
+        // skip the zones which the static geometry hides from the camera zone
+        const PotentiallyVisibleSet* pvs = 0;
+        if (mPVS && homeZone->_getPVSCell() != PotentiallyVisibleSet::NO_CELL)
+            pvs = mPVS;
+
+        PortalList portalList;
+        homeZone->getVisiblePortals(cam, frustum, portalList, pvs, homeZone->_getPVSCell());
+        vector<Portal*>::type portals(portalList.begin(), portalList.end());
+        if (mBranchVisits.size() < portals.size())
+            mBranchVisits.resize(portals.size());
+        parallelFor(0, portals.size(), FindZonesFunc(cam, &frustum, &portals, &mBranchVisits,
+            pvs, homeZone->_getPVSCell()));
+
+        for (size_t i = 0; i < portals.size(); ++i)
+        {
+            visibility.visits.insert(visibility.visits.end(),
+                mBranchVisits[i].begin(), mBranchVisits[i].end());
+        }
+        return visibility.visits;
     }
 
     void PCZSceneManager::findNodesIn( const AxisAlignedBox &box, 
@@ -1360,6 +1653,7 @@ namespace Ogre
         SceneManager::getOptionKeys( refKeys );
         refKeys.push_back( "ShowBoundingBoxes" );
         refKeys.push_back( "ShowPortals" );
+        refKeys.push_back( "CacheZoneVisibility" );
 
         return true;
     }
@@ -1377,6 +1671,14 @@ namespace Ogre
             mShowPortals = * static_cast < const bool * > ( val );
             return true;
         }
+
+        else if ( key == "CacheZoneVisibility" )
+        {
+            mCacheZoneVisibility = * static_cast < const bool * > ( val );
+            if (!mCacheZoneVisibility)
+                mCameraZoneVisibility.clear();
+            return true;
+        }
         // send option to each zone
         ZoneMap::iterator i;
         PCZone * zone;
@@ -1409,6 +1711,12 @@ namespace Ogre
             * static_cast < bool * > ( val ) = mShowPortals;
             return true;
         }
+        if ( key == "CacheZoneVisibility" )
+        {
+
+            * static_cast < bool * > ( val ) = mCacheZoneVisibility;
+            return true;
+        }
         return SceneManager::getOption( key, val );
 
     }
@@ -1465,12 +1773,18 @@ namespace Ogre
     void PCZSceneManager::_clearAllZonesPortalUpdateFlag(void)
     {
         ZoneMap::iterator zoneIterator = mZones.begin();
+        bool portalsUpdated = false;
 
         while ( zoneIterator != mZones.end() )
         {
+            portalsUpdated |= (zoneIterator->second)->getPortalsUpdated();
             (zoneIterator->second)->setPortalsUpdated(false);
             zoneIterator++;
         }
+
+        // the zones cameras saw through the portals may have changed
+        if (portalsUpdated)
+            ++mPortalStateCount;
     }
     //---------------------------------------------------------------------
     /// See SceneManager::prepareShadowTextures.
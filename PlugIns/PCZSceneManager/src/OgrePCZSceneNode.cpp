@@ -94,7 +94,7 @@ namespace Ogre
         if (mParent) _updateBounds(); // skip bound update if it's root scene node. Saves a lot of CPU.
 
         mPrevPosition = mNewPosition;
-        mNewPosition = mDerivedPosition;
+        mNewPosition = *mDerivedPositionPtr;
     }
     void PCZSceneNode::updateFromParentImpl() const
     {
@@ -237,7 +237,8 @@ namespace Ogre
             if ( mo->isVisible() &&
                 (!onlyShadowCasters || mo->getCastShadows()))
             {
-                mo -> _updateRenderQueue( queue );
+                if ( !onlyShadowCasters || queue->isShadowCasterIncluded( mo ) )
+                    mo -> _updateRenderQueue( queue );
 
                 if (visibleBounds)
                 {
@@ -36,6 +36,8 @@ email                : ericc@xenopi.com
 #include "OgreSceneNode.h"
 #include "OgreAntiPortal.h"
 #include "OgrePortal.h"
+#include "OgrePCZCamera.h"
+#include "OgrePCZSceneNode.h"
 
 namespace Ogre
 {
@@ -49,6 +51,7 @@ namespace Ogre
         mEnclosureNode = 0;
         mPCZSM = creator;
         mHasSky = false;
+        mPVSCell = PotentiallyVisibleSet::NO_CELL;
     }
 
     PCZone::~PCZone()
@@ -186,6 +189,135 @@ namespace Ogre
         return;
     }
 
+    /* Recursively walk the zones through the visible portals, recording each
+       zone along with the culling planes in effect there */
+    void PCZone::findVisibleZones(const PCZCamera* camera, PCZFrustum& frustum,
+                                  ZoneVisitList& visits,
+                                  const PotentiallyVisibleSet* pvs,
+                                  size_t fromCell)
+    {
+        //return immediately if nothing is in the zone.
+        if (mHomeNodeList.empty() &&
+            mVisitorNodeList.empty() &&
+            mPortals.empty())
+            return ;
+
+        visits.push_back(ZoneVisit());
+        visits.back().zone = this;
+        visits.back().frustum = frustum;
+
+        PortalList portals;
+        getVisiblePortals(camera, frustum, portals, pvs, fromCell);
+        for (PortalList::iterator it = portals.begin(); it != portals.end(); ++it)
+        {
+            Portal* portal = *it;
+            // add the portal as extra culling planes and recurse into the connected zone
+            int planes_added = frustum.addPortalCullingPlanes(portal);
+            portal->getTargetZone()->findVisibleZones(camera, frustum, visits, pvs, fromCell);
+            if (planes_added > 0)
+            {
+                // remove them again before going to the next portal in the list.
+                frustum.removePortalCullingPlanes(portal);
+            }
+        }
+    }
+
+    void PCZone::getVisiblePortals(const PCZCamera* camera, const PCZFrustum& frustum,
+                                   PortalList& portals,
+                                   const PotentiallyVisibleSet* pvs,
+                                   size_t fromCell)
+    {
+        // Here we merge both portal and antiportal visible to the camera into one list.
+        // Then we sort them in the order from nearest to furthest from camera.
+        PortalBaseList sortedPortalList;
+        for (AntiPortalList::iterator iter = mAntiPortals.begin(); iter != mAntiPortals.end(); ++iter)
+        {
+            AntiPortal* portal = *iter;
+            if (camera->isVisible(portal, frustum))
+            {
+                sortedPortalList.push_back(portal);
+            }
+        }
+        for (PortalList::iterator iter = mPortals.begin(); iter != mPortals.end(); ++iter)
+        {
+            Portal* portal = *iter;
+            // skip zones the static geometry hides from the starting cell
+            size_t targetCell = portal->getTargetZone() ?
+                portal->getTargetZone()->_getPVSCell() : PotentiallyVisibleSet::NO_CELL;
+            if (pvs && targetCell != PotentiallyVisibleSet::NO_CELL &&
+                !pvs->isVisible(fromCell, targetCell))
+            {
+                continue;
+            }
+            if (camera->isVisible(portal, frustum))
+            {
+                sortedPortalList.push_back(portal);
+            }
+        }
+        const Vector3& cameraOrigin(camera->getDerivedPosition());
+        std::sort(sortedPortalList.begin(), sortedPortalList.end(),
+            PortalSortDistance(cameraOrigin));
+
+        // create a standalone frustum for anti portal use.
+        // we're doing this instead of using camera because we don't need
+        // to do camera frustum check again.
+        PCZFrustum antiPortalFrustum;
+        antiPortalFrustum.setOrigin(cameraOrigin);
+        antiPortalFrustum.setProjectionType(camera->getProjectionType());
+
+        // now we do culling check and remove hidden portals.
+        // whenever we get a portal in the main loop, we can be sure that it is not
+        // occluded by AntiPortal, since the portal list has been sorted.
+        size_t sortedPortalListCount = sortedPortalList.size();
+        for (size_t i = 0; i < sortedPortalListCount; ++i)
+        {
+            PortalBase* portalBase = sortedPortalList[i];
+            if (!portalBase) continue; // skip removed portal.
+
+            if (portalBase->getTypeFlags() == PortalFactory::FACTORY_TYPE_FLAG)
+            {
+                portals.push_back(static_cast<Portal*>(portalBase));
+            }
+            else
+            {
+                // this is an anti portal. So we use it to test following portals in the list.
+                AntiPortal* antiPortal = static_cast<AntiPortal*>(portalBase);
+                int planes_added = antiPortalFrustum.addPortalCullingPlanes(antiPortal);
+
+                for (size_t j = i + 1; j < sortedPortalListCount; ++j)
+                {
+                    PortalBase* otherPortal = sortedPortalList[j];
+                    // Since this is an antiportal, we are doing the inverse of the test.
+                    // Here if the portal is fully visible in the anti portal fustrum, it means it's hidden.
+                    if (otherPortal && antiPortalFrustum.isFullyVisible(otherPortal))
+                        sortedPortalList[j] = NULL;
+                }
+
+                if (planes_added > 0)
+                {
+                    // Then remove the extra culling planes added before going to the next portal in the list.
+                    antiPortalFrustum.removePortalCullingPlanes(antiPortal);
+                }
+            }
+        }
+    }
+
+    void PCZone::findVisibleNodesInZone(const PCZCamera* camera, const PCZFrustum& frustum,
+                                        PCZSceneNodeVector& visibleNodes)
+    {
+        PCZSceneNodeList::iterator it;
+        for (it = mHomeNodeList.begin(); it != mHomeNodeList.end(); ++it)
+        {
+            if (camera->isVisible((*it)->_getWorldAABB(), frustum))
+                visibleNodes.push_back(*it);
+        }
+        for (it = mVisitorNodeList.begin(); it != mVisitorNodeList.end(); ++it)
+        {
+            if (camera->isVisible((*it)->_getWorldAABB(), frustum))
+                visibleNodes.push_back(*it);
+        }
+    }
+
     /***********************************************************************\
     ZoneData - Zone-specific Data structure for Scene Nodes
     ************************************************************************/
@@ -34,6 +34,7 @@ current TODO's       : none known
 */
 
 #include "OgrePortal.h"
+#include "OgrePCZone.h"
 
 using namespace Ogre;
 
@@ -52,6 +53,9 @@ Portal::~Portal()
 void Portal::setTargetZone(PCZone* zone)
 {
     mTargetZone = zone;
+    // the zones seen through this portal changed
+    if (mCurrentHomeZone)
+        mCurrentHomeZone->setPortalsUpdated(true);
 }
 
 // Set the Portal the Portal connects to
@@ -121,6 +121,17 @@ void PortalBase::setCurrentHomeZone(PCZone* zone)
     mCurrentHomeZone = zone;
 }
 
+// Enable or disable the portal
+void PortalBase::setEnabled(bool value)
+{
+    if (mEnabled != value && mCurrentHomeZone)
+    {
+        // inform home zone the zones seen through its portals changed
+        mCurrentHomeZone->setPortalsUpdated(true);
+    }
+    mEnabled = value;
+}
+
 // Set the zone this portal should be moved to
 void PortalBase::setNewHomeZone(PCZone* zone)
 {
@@ -126,7 +126,7 @@ namespace Ogre {
         ColourFaderAffector2(ParticleSystem* psys);
 
         /** See ParticleAffector. */
-        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
+        void _affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, Particle** particles, size_t count);
 
         /** Sets the colour adjustment to be made per second to particles. 
         @param red, green, blue, alpha
@@ -55,7 +55,7 @@ namespace Ogre {
         void _initParticle(Particle* pParticle);
 
         /** See ParticleAffector. */
-        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
+        void _affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, Particle** particles, size_t count);
 
         void setImageAdjust(String name);
         String getImageAdjust(void) const;
@@ -67,6 +67,8 @@ namespace Ogre {
         Image                   mColourImage;
         bool                    mColourImageLoaded;
         String                  mColourImageName;
+        /// First row of the image as colours, sampled by _affectParticleSpan
+        vector<ColourValue>::type mColours;
 
         /** Internal method to load the image */
         void _loadImage(void);
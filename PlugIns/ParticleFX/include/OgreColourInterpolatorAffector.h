@@ -71,7 +71,7 @@ namespace Ogre {
         ColourInterpolatorAffector(ParticleSystem* psys);
 
         /** See ParticleAffector. */
-        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
+        void _affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, Particle** particles, size_t count);
 
         void setColourAdjust(size_t index, ColourValue colour);
         ColourValue getColourAdjust(size_t index) const;
@@ -79,7 +79,7 @@ namespace Ogre {
         DeflectorPlaneAffector(ParticleSystem* psys);
 
         /** See ParticleAffector. */
-        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
+        void _affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, Particle** particles, size_t count);
 
         /** Sets the plane point of the deflector plane. */
         void setPlanePoint(const Vector3& pos);
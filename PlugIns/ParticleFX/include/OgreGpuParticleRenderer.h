@@ -0,0 +1,215 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __GpuParticleRenderer_H__
+#define __GpuParticleRenderer_H__
+
+#include "OgreParticleFXPrerequisites.h"
+#include "OgreParticleSystemRenderer.h"
+#include "OgreRenderable.h"
+#include "OgreRenderToVertexBuffer.h"
+
+namespace Ogre {
+    /** \addtogroup Plugins
+    *  @{
+    */
+    /** \addtogroup ParticleFX
+    *  @{
+    */
+    /** Renderer which simulates and draws the particles of a system on the GPU.
+    @remarks
+        Selected with 'renderer gpu' in a particle script. The emitters and
+        affectors of the system are set up as usual, but instead of creating
+        particles on the CPU their settings are turned into a vertex program
+        which updates all particles at once through a RenderToVertexBuffer,
+        so the particle quota can be in the millions. The particles are drawn
+        as camera facing quads with a geometry program, using the texture
+        units and blending of the system's material.
+    @par
+        Supported emitters are Point, Box and Ellipsoid, along with the
+        common emitter settings (angle, colour range, velocity, time to live,
+        emission rate, duration and repeat delay). Supported affectors are
+        LinearForce, ColourFader, Scaler and DeflectorPlane. Other emitters
+        are treated as points and other affectors are ignored, both with a
+        warning in the log. Particles live in a ring of quota slots, when
+        the emission outpaces the quota the oldest particles are replaced.
+    @par
+        The programs are GLSL 1.50, so this requires a GL 3 render system
+        with geometry programs and render to vertex buffer support. Being
+        on the GPU, the particles are only updated while the system is
+        visible, and the bounds are estimated from the emitters and forces.
+    */
+    class _OgreParticleFXExport GpuParticleRenderer : public ParticleSystemRenderer
+    {
+    public:
+        GpuParticleRenderer();
+        ~GpuParticleRenderer();
+
+        /// @copydoc ParticleSystemRenderer::getType
+        const String& getType(void) const;
+        /// @copydoc ParticleSystemRenderer::_updateRenderQueue
+        void _updateRenderQueue(RenderQueue* queue,
+            vector<Particle*>::type& currentParticles, bool cullIndividually);
+        /// @copydoc ParticleSystemRenderer::visitRenderables
+        void visitRenderables(Renderable::Visitor* visitor,
+            bool debugRenderables = false);
+        /// @copydoc ParticleSystemRenderer::_setMaterial
+        void _setMaterial(MaterialPtr& mat);
+        /// @copydoc ParticleSystemRenderer::_notifyCurrentCamera
+        void _notifyCurrentCamera(Camera* cam) {}
+        /// @copydoc ParticleSystemRenderer::_notifyAttached
+        void _notifyAttached(Node* parent, bool isTagPoint = false);
+        /// @copydoc ParticleSystemRenderer::_notifyParticleQuota
+        void _notifyParticleQuota(size_t quota) {}
+        /// @copydoc ParticleSystemRenderer::_notifyDefaultDimensions
+        void _notifyDefaultDimensions(Real width, Real height);
+        /// @copydoc ParticleSystemRenderer::setRenderQueueGroup
+        void setRenderQueueGroup(uint8 queueID);
+        /// @copydoc ParticleSystemRenderer::setRenderQueueGroupAndPriority
+        void setRenderQueueGroupAndPriority(uint8 queueID, ushort priority);
+        /// @copydoc ParticleSystemRenderer::setKeepParticlesInLocalSpace
+        void setKeepParticlesInLocalSpace(bool keepLocal) { mLocalSpace = keepLocal; }
+        /// @copydoc ParticleSystemRenderer::_getSortMode
+        SortMode _getSortMode(void) const { return SM_DISTANCE; }
+        /// @copydoc ParticleSystemRenderer::_simulateParticles
+        bool _simulateParticles(ParticleSystem* sys, Real timeElapsed);
+
+    protected:
+        /// Maximum number of emitters handled per system
+        static const size_t MAX_EMITTERS = 8;
+        /// Vec4 constants describing one emitter
+        static const size_t EMITTER_CONSTANTS = 9;
+        /// Vec4 constants describing one affector
+        static const size_t AFFECTOR_CONSTANTS = 2;
+
+        /// The particle buffer, drawn as points expanded to quads
+        class ParticleRenderable : public Renderable, public FXAlloc
+        {
+        public:
+            ParticleRenderable(GpuParticleRenderer* parent) : mParent(parent) {}
+
+            const MaterialPtr& getMaterial(void) const { return mParent->mDisplayMaterial; }
+            void getRenderOperation(RenderOperation& op);
+            void getWorldTransforms(Matrix4* xform) const;
+            Real getSquaredViewDepth(const Camera* cam) const;
+            const LightList& getLights(void) const;
+
+        protected:
+            GpuParticleRenderer* mParent;
+        };
+
+        /// The initial, dead particles fed to the first update
+        class SeedRenderable : public Renderable, public FXAlloc
+        {
+        public:
+            SeedRenderable(GpuParticleRenderer* parent) : mParent(parent), mVertexData(0) {}
+            ~SeedRenderable();
+
+            /// Create the vertex data for a number of particles
+            void create(const VertexDeclaration* decl, size_t count);
+
+            const MaterialPtr& getMaterial(void) const { return mParent->mDisplayMaterial; }
+            void getRenderOperation(RenderOperation& op);
+            void getWorldTransforms(Matrix4* xform) const { *xform = Matrix4::IDENTITY; }
+            Real getSquaredViewDepth(const Camera* cam) const { return 0; }
+            const LightList& getLights(void) const;
+
+        protected:
+            GpuParticleRenderer* mParent;
+            VertexData* mVertexData;
+        };
+
+        /// Settings of the system last seen by _simulateParticles
+        ParticleSystem* mSystem;
+        Node* mParentNode;
+        bool mLocalSpace;
+        Vector2 mDefaultSize;
+
+        /// Emitter and affector types the programs were generated for
+        String mSignature;
+        /// The signature for the next update, set by _simulateParticles
+        String mPendingSignature;
+        /// Time and emissions not yet applied on the GPU
+        Real mPendingTime;
+        size_t mPendingEmissions[MAX_EMITTERS];
+        /// Per update seed of the GPU random numbers
+        uint32 mPendingSeed;
+        /// Emitter and affector constants for the next update, four floats per vec4
+        vector<float>::type mEmitterConstants;
+        vector<float>::type mAffectorConstants;
+        /// Slot the next emitted particle goes to
+        size_t mRingHead;
+        /// Number of particle slots
+        size_t mCapacity;
+        /// Whether the buffer holds particles to draw
+        bool mUpdated;
+
+        RenderToVertexBufferSharedPtr mBuffer;
+        ParticleRenderable mRenderable;
+        SeedRenderable mSeed;
+        MaterialPtr mMaterial;
+        MaterialPtr mDisplayMaterial;
+        MaterialPtr mSimulateMaterial;
+        HighLevelGpuProgramPtr mSimulateProgram;
+        uint8 mQueueID;
+        ushort mQueuePriority;
+        bool mQueuePrioritySet;
+        /// Unique name prefix of the resources of this renderer
+        String mName;
+
+        /// Collect the emitter and affector constants of the system
+        void gatherConstants(ParticleSystem* sys, String& signature);
+        /// Grow the bounds of the system to where particles may travel
+        void updateBounds(ParticleSystem* sys);
+        /// Apply the pending time and emissions on the GPU
+        void updateParticles(void);
+        /// (Re)create the buffer and programs after the signature or quota changed
+        void createResources(void);
+        void destroyResources(void);
+        /// Generate the source of the simulation vertex program
+        String generateSimulateSource(void) const;
+        /// Make the display material out of the system material
+        void createDisplayMaterial(void);
+    };
+
+    /** Factory class for GpuParticleRenderer */
+    class _OgreParticleFXExport GpuParticleRendererFactory : public ParticleSystemRendererFactory
+    {
+    public:
+        /// @copydoc FactoryObj::getType
+        const String& getType() const;
+        /// @copydoc FactoryObj::createInstance
+        ParticleSystemRenderer* createInstance( const String& name );
+        /// @copydoc FactoryObj::destroyInstance
+        void destroyInstance(ParticleSystemRenderer* ptr);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#endif
@@ -83,7 +83,7 @@ namespace Ogre {
         LinearForceAffector(ParticleSystem* psys);
 
         /** See ParticleAffector. */
-        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
+        void _affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, Particle** particles, size_t count);
 
 
         /** Sets the force vector to apply to the particles in a system. */
@@ -59,6 +59,7 @@ namespace Ogre
     protected:
         vector<ParticleEmitterFactory*>::type mEmitterFactories;
         vector<ParticleAffectorFactory*>::type mAffectorFactories;
+        vector<ParticleSystemRendererFactory*>::type mRendererFactories;
 
     };
 }
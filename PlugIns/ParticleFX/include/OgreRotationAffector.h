@@ -88,7 +88,7 @@ namespace Ogre {
         void _initParticle(Particle* pParticle);
 
         /** See ParticleAffector. */
-        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
+        void _affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, Particle** particles, size_t count);
 
 
 
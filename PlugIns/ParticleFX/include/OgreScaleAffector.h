@@ -61,7 +61,7 @@ namespace Ogre {
         ScaleAffector(ParticleSystem* psys);
 
         /** See ParticleAffector. */
-        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
+        void _affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, Particle** particles, size_t count);
 
         /** Sets the scale adjustment to be made per second to particles. 
         @param rate
@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 #include "OgreBoxEmitter.h"
 #include "OgreParticle.h"
+#include "OgreParticleSystem.h"
 #include "OgreException.h"
 #include "OgreStringConverter.h"
 
@@ -49,9 +50,9 @@ namespace Ogre {
         // Call superclass
         ParticleEmitter::_initParticle(pParticle);
 
-        xOff = Math::SymmetricRandom() * mXRange;
-        yOff = Math::SymmetricRandom() * mYRange;
-        zOff = Math::SymmetricRandom() * mZRange;
+        xOff = mParent->_symmetricRandom() * mXRange;
+        yOff = mParent->_symmetricRandom() * mYRange;
+        zOff = mParent->_symmetricRandom() * mZRange;
 
         pParticle->mPosition = mPosition + xOff + yOff + zOff;
         
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleFXSIMD.h"
 
 
 namespace Ogre {
@@ -67,25 +68,19 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
-    void ColourFaderAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    void ColourFaderAffector::_affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, 
+        Particle** particles, size_t count)
     {
-        ParticleIterator pi = pSystem->_getIterator();
-        Particle *p;
-        float dr, dg, db, da;
+        using namespace ParticleFXSIMD;
 
-        // Scale adjustments by time
-        dr = mRedAdj * timeElapsed;
-        dg = mGreenAdj * timeElapsed;
-        db = mBlueAdj * timeElapsed;
-        da = mAlphaAdj * timeElapsed;
+        // Scale adjustments by time, all four channels are faded at once
+        const Float4 adjust = set4(mRedAdj * timeElapsed, mGreenAdj * timeElapsed,
+            mBlueAdj * timeElapsed, mAlphaAdj * timeElapsed);
 
-        while (!pi.end())
+        for (size_t n = 0; n < count; ++n)
         {
-            p = pi.getNext();
-            applyAdjustWithClamp(&p->mColour.r, dr);
-            applyAdjustWithClamp(&p->mColour.g, dg);
-            applyAdjustWithClamp(&p->mColour.b, db);
-            applyAdjustWithClamp(&p->mColour.a, da);
+            float* colour = particles[n]->mColour.ptr();
+            store4(colour, saturate4(add4(load4(colour), adjust)));
         }
 
     }
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleFXSIMD.h"
 
 
 namespace Ogre {
@@ -98,43 +99,23 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
-    void ColourFaderAffector2::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    void ColourFaderAffector2::_affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, 
+        Particle** particles, size_t count)
     {
-        ParticleIterator pi = pSystem->_getIterator();
-        Particle *p;
-        float dr1, dg1, db1, da1;
-        float dr2, dg2, db2, da2;
+        using namespace ParticleFXSIMD;
 
-        // Scale adjustments by time
-        dr1 = mRedAdj1   * timeElapsed;
-        dg1 = mGreenAdj1 * timeElapsed;
-        db1 = mBlueAdj1  * timeElapsed;
-        da1 = mAlphaAdj1 * timeElapsed;
+        // Scale adjustments by time, all four channels are faded at once
+        const Float4 adjust1 = set4(mRedAdj1 * timeElapsed, mGreenAdj1 * timeElapsed,
+            mBlueAdj1 * timeElapsed, mAlphaAdj1 * timeElapsed);
+        const Float4 adjust2 = set4(mRedAdj2 * timeElapsed, mGreenAdj2 * timeElapsed,
+            mBlueAdj2 * timeElapsed, mAlphaAdj2 * timeElapsed);
 
-        // Scale adjustments by time
-        dr2 = mRedAdj2   * timeElapsed;
-        dg2 = mGreenAdj2 * timeElapsed;
-        db2 = mBlueAdj2  * timeElapsed;
-        da2 = mAlphaAdj2 * timeElapsed;
-
-        while (!pi.end())
+        for (size_t n = 0; n < count; ++n)
         {
-            p = pi.getNext();
-
-            if( p->mTimeToLive > StateChangeVal )
-            {
-                applyAdjustWithClamp(&p->mColour.r, dr1);
-                applyAdjustWithClamp(&p->mColour.g, dg1);
-                applyAdjustWithClamp(&p->mColour.b, db1);
-                applyAdjustWithClamp(&p->mColour.a, da1);
-            }
-            else
-            {
-                applyAdjustWithClamp(&p->mColour.r, dr2);
-                applyAdjustWithClamp(&p->mColour.g, dg2);
-                applyAdjustWithClamp(&p->mColour.b, db2);
-                applyAdjustWithClamp(&p->mColour.a, da2);
-            }
+            Particle* p = particles[n];
+            float* colour = p->mColour.ptr();
+            const Float4& adjust = p->mTimeToLive > StateChangeVal ? adjust1 : adjust2;
+            store4(colour, saturate4(add4(load4(colour), adjust)));
         }
 
     }
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleFXSIMD.h"
 #include "OgreException.h"
 #include "OgreResourceGroupManager.h"
 
@@ -59,25 +60,26 @@ namespace Ogre {
             _loadImage();
         }
 
-        pParticle->mColour = mColourImage.getColourAt(0, 0, 0);
+        pParticle->mColour = mColours[0];
     
     }
     //-----------------------------------------------------------------------
-    void ColourImageAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    void ColourImageAffector::_affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, 
+        Particle** particles, size_t count)
     {
-        Particle*           p;
-        ParticleIterator    pi              = pSystem->_getIterator();
+        using namespace ParticleFXSIMD;
 
         if (!mColourImageLoaded)
         {
             _loadImage();
         }
 
-        int                width            = (int)mColourImage.getWidth()  - 1;
+        const int          width            = (int)mColours.size() - 1;
+        const ColourValue* colours          = &mColours[0];
         
-        while (!pi.end())
+        for (size_t n = 0; n < count; ++n)
         {
-            p = pi.getNext();
+            Particle*       p               = particles[n];
             const Real      life_time       = p->mTotalTimeToLive;
             Real            particle_time   = 1.0f - (p->mTimeToLive / life_time);
 
@@ -91,26 +93,17 @@ namespace Ogre {
 
             if(index < 0)
             {
-                p->mColour = mColourImage.getColourAt(0, 0, 0);
+                p->mColour = colours[0];
             }
             else if(index >= width) 
             {
-                p->mColour = mColourImage.getColourAt(width, 0, 0);
+                p->mColour = colours[width];
             }
             else
             {
-                // Linear interpolation
-                const Real      fract       = float_index - (Real)index;
-                const Real      to_colour   = fract;
-                const Real      from_colour = 1.0f - to_colour;
-             
-                ColourValue from=mColourImage.getColourAt(index, 0, 0),
-                            to=mColourImage.getColourAt(index+1, 0, 0);
-
-                p->mColour.r = from.r*from_colour + to.r*to_colour;
-                p->mColour.g = from.g*from_colour + to.g*to_colour;
-                p->mColour.b = from.b*from_colour + to.b*to_colour;
-                p->mColour.a = from.a*from_colour + to.a*to_colour;
+                // Linear interpolation of all four channels at once
+                store4(p->mColour.ptr(), lerp4(load4(colours[index].ptr()),
+                    load4(colours[index + 1].ptr()), float_index - (Real)index));
             }
         }
     }
@@ -134,6 +127,11 @@ namespace Ogre {
                     "ColourImageAffector::_loadImage" );
         }
 
+        // Unpack the first row once, getColourAt converts from the pixel format on every call
+        mColours.resize(mColourImage.getWidth());
+        for (size_t x = 0; x < mColours.size(); ++x)
+            mColours[x] = mColourImage.getColourAt(x, 0, 0);
+
         mColourImageLoaded = true;
     }
     //-----------------------------------------------------------------------
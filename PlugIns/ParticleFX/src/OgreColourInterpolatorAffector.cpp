@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleFXSIMD.h"
 
 
 namespace Ogre {
@@ -74,15 +75,14 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
-    void ColourInterpolatorAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    void ColourInterpolatorAffector::_affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, 
+        Particle** particles, size_t count)
     {
-        Particle*           p;
-        ParticleIterator    pi              = pSystem->_getIterator();
+        using namespace ParticleFXSIMD;
 
-
-        while (!pi.end())
+        for (size_t n = 0; n < count; ++n)
         {
-            p = pi.getNext();
+            Particle* p = particles[n];
             const Real      life_time       = p->mTotalTimeToLive;
             Real            particle_time   = 1.0f - (p->mTimeToLive / life_time);
 
@@ -101,10 +101,9 @@ namespace Ogre {
                     {
                         particle_time -= mTimeAdj[i];
                         particle_time /= (mTimeAdj[i+1]-mTimeAdj[i]);
-                        p->mColour.r = ((mColourAdj[i+1].r * particle_time) + (mColourAdj[i].r * (1.0f - particle_time)));
-                        p->mColour.g = ((mColourAdj[i+1].g * particle_time) + (mColourAdj[i].g * (1.0f - particle_time)));
-                        p->mColour.b = ((mColourAdj[i+1].b * particle_time) + (mColourAdj[i].b * (1.0f - particle_time)));
-                        p->mColour.a = ((mColourAdj[i+1].a * particle_time) + (mColourAdj[i].a * (1.0f - particle_time)));
+                        // all four channels at once
+                        store4(p->mColour.ptr(), lerp4(load4(mColourAdj[i].ptr()),
+                            load4(mColourAdj[i+1].ptr()), particle_time));
                         break;
                     }
                 }
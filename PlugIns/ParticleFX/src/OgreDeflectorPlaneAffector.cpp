@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreDeflectorPlaneAffector.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticle.h"
+#include "OgreParticleFXSIMD.h"
 #include "OgreStringConverter.h"
 
 
@@ -62,21 +63,56 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
-    void DeflectorPlaneAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    void DeflectorPlaneAffector::_affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, 
+        Particle** particles, size_t count)
     {
+        using namespace ParticleFXSIMD;
+
         // precalculate distance of plane from origin
         Real planeDistance = - mPlaneNormal.dotProduct(mPlanePoint) / Math::Sqrt(mPlaneNormal.dotProduct(mPlaneNormal));
         Vector3 directionPart;
 
-        ParticleIterator pi = pSystem->_getIterator();
+        const Float4 t = splat4(timeElapsed);
+        const Float4 normal[3] = { splat4(mPlaneNormal.x), splat4(mPlaneNormal.y), splat4(mPlaneNormal.z) };
+        const Float4 d = splat4(planeDistance);
+        const Float4 zero = splat4(0);
 
-        while (!pi.end())
+        // Test four particles at a time against the plane, only the few which
+        // cross it this frame are bounced one by one
+        for (size_t n = 0; n < count; n += 4)
         {
-            Particle *p = pi.getNext();
+            const size_t lanes = std::min<size_t>(4, count - n);
+            Real pos[3][4] = { { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } };
+            Real dir[3][4] = { { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } };
+            for (size_t i = 0; i < lanes; ++i)
+            {
+                const Particle* p = particles[n + i];
+                for (int c = 0; c < 3; ++c)
+                {
+                    pos[c][i] = p->mPosition[c];
+                    dir[c][i] = p->mDirection[c];
+                }
+            }
 
-            Vector3 direction(p->mDirection * timeElapsed);
-            if (mPlaneNormal.dotProduct(p->mPosition + direction) + planeDistance <= 0.0)
+            // signed distance of the positions the particles would move to
+            Float4 dist = d;
+            for (int c = 0; c < 3; ++c)
             {
+                Float4 next = madd4(set4(dir[c][0], dir[c][1], dir[c][2], dir[c][3]), t,
+                    set4(pos[c][0], pos[c][1], pos[c][2], pos[c][3]));
+                dist = madd4(normal[c], next, dist);
+            }
+            const int hits = lessEqualMask4(dist, zero) & ((1 << lanes) - 1);
+            if (!hits)
+                continue;
+
+            for (size_t i = 0; i < lanes; ++i)
+            {
+                if (!(hits & (1 << i)))
+                    continue;
+
+                Particle *p = particles[n + i];
+                Vector3 direction(p->mDirection * timeElapsed);
                 Real a = mPlaneNormal.dotProduct(p->mPosition) + planeDistance;
                 if (a > 0.0)
                 {
@@ -76,7 +76,7 @@ namespace Ogre {
         while (!pi.end())
         {
             p = pi.getNext();
-            if (mScope > Math::UnitRandom())
+            if (mScope > mParent->_unitRandom())
             {
                 if (!p->mDirection.isZeroLength())
                 {
@@ -85,9 +85,9 @@ namespace Ogre {
                         length = p->mDirection.length();
                     }
 
-                    p->mDirection += Vector3(Math::RangeRandom(-mRandomness, mRandomness) * timeElapsed,
-                        Math::RangeRandom(-mRandomness, mRandomness) * timeElapsed,
-                        Math::RangeRandom(-mRandomness, mRandomness) * timeElapsed);
+                    p->mDirection += Vector3(mParent->_rangeRandom(-mRandomness, mRandomness) * timeElapsed,
+                        mParent->_rangeRandom(-mRandomness, mRandomness) * timeElapsed,
+                        mParent->_rangeRandom(-mRandomness, mRandomness) * timeElapsed);
 
                     if (mKeepVelocity)
                     {
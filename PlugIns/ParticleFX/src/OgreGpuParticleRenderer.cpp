@@ -0,0 +1,832 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreGpuParticleRenderer.h"
+#include "OgreAreaEmitter.h"
+#include "OgreLinearForceAffector.h"
+#include "OgreColourFaderAffector.h"
+#include "OgreScaleAffector.h"
+#include "OgreDeflectorPlaneAffector.h"
+
+#include "OgreParticleSystem.h"
+#include "OgreParticleEmitter.h"
+#include "OgreParticleAffector.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+#include "OgreRenderQueue.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreNode.h"
+#include "OgreCamera.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        const String rendererTypeName = "gpu";
+
+        /// Count of renderers made, for unique resource names
+        uint32 sRendererCount = 0;
+
+        /// Names of the programs drawing the particles, shared by all renderers
+        const String DISPLAY_VS = "ParticleFX/Gpu/DisplayVS";
+        const String DISPLAY_GS = "ParticleFX/Gpu/DisplayGS";
+        const String DISPLAY_FS = "ParticleFX/Gpu/DisplayFS";
+        const String DISPLAY_FS_UNTEXTURED = "ParticleFX/Gpu/DisplayFSUntextured";
+
+        const char* DISPLAY_VS_SOURCE =
+            "#version 150\n"
+            "in vec4 vertex;\n"
+            "in vec4 uv0;\n"
+            "in vec4 uv1;\n"
+            "in vec4 uv2;\n"
+            "out vec4 gsColour;\n"
+            "out vec2 gsSize;\n"
+            "out float gsTimeToLive;\n"
+            "void main()\n"
+            "{\n"
+            "    gl_Position = vertex;\n"
+            "    gsColour = uv1;\n"
+            "    gsSize = uv2.yz;\n"
+            "    gsTimeToLive = uv0.w;\n"
+            "}\n";
+
+        // Dead particles are dropped, live ones become camera facing quads
+        const char* DISPLAY_GS_SOURCE =
+            "#version 150\n"
+            "layout(points) in;\n"
+            "layout(triangle_strip, max_vertices = 4) out;\n"
+            "uniform mat4 worldMatrix;\n"
+            "uniform mat4 viewProjMatrix;\n"
+            "uniform mat4 inverseViewMatrix;\n"
+            "in vec4 gsColour[];\n"
+            "in vec2 gsSize[];\n"
+            "in float gsTimeToLive[];\n"
+            "out vec4 colour;\n"
+            "out vec2 texCoord;\n"
+            "void main()\n"
+            "{\n"
+            "    if (gsTimeToLive[0] <= 0.0)\n"
+            "        return;\n"
+            "    vec3 centre = (worldMatrix * vec4(gl_in[0].gl_Position.xyz, 1.0)).xyz;\n"
+            "    vec3 right = inverseViewMatrix[0].xyz * (0.5 * gsSize[0].x);\n"
+            "    vec3 up = inverseViewMatrix[1].xyz * (0.5 * gsSize[0].y);\n"
+            "    const vec2 corners[4] = vec2[4](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));\n"
+            "    for (int i = 0; i < 4; ++i)\n"
+            "    {\n"
+            "        gl_Position = viewProjMatrix * vec4(centre + corners[i].x * right + corners[i].y * up, 1.0);\n"
+            "        colour = gsColour[0];\n"
+            "        texCoord = corners[i] * vec2(0.5, -0.5) + 0.5;\n"
+            "        EmitVertex();\n"
+            "    }\n"
+            "    EndPrimitive();\n"
+            "}\n";
+
+        const char* DISPLAY_FS_SOURCE =
+            "#version 150\n"
+            "uniform sampler2D diffuseMap;\n"
+            "in vec4 colour;\n"
+            "in vec2 texCoord;\n"
+            "out vec4 fragColour;\n"
+            "void main()\n"
+            "{\n"
+            "    fragColour = texture(diffuseMap, texCoord) * colour;\n"
+            "}\n";
+
+        const char* DISPLAY_FS_UNTEXTURED_SOURCE =
+            "#version 150\n"
+            "in vec4 colour;\n"
+            "in vec2 texCoord;\n"
+            "out vec4 fragColour;\n"
+            "void main()\n"
+            "{\n"
+            "    fragColour = colour;\n"
+            "}\n";
+
+        // Parts of the simulation program which don't depend on the system.
+        // frameParams is (time step, ring head, capacity, seed), emitter
+        // constants are laid out as described in gatherConstants.
+        const char* SIMULATE_HEADER =
+            "#version 150\n"
+            "in vec4 vertex;\n"
+            "in vec4 uv0;\n"
+            "in vec4 uv1;\n"
+            "in vec4 uv2;\n"
+            "out vec3 oPos;\n"
+            "out vec4 oUv0;\n"
+            "out vec4 oUv1;\n"
+            "out vec4 oUv2;\n"
+            "uniform vec4 frameParams;\n"
+            "uniform mat4 emitterTransform;\n"
+            "uniform mat4 emitterRotation;\n"
+            "uniform vec2 defaultSize;\n"
+            "uint hash(uint x)\n"
+            "{\n"
+            "    x ^= x >> 16;\n"
+            "    x *= 0x7feb352dU;\n"
+            "    x ^= x >> 15;\n"
+            "    x *= 0x846ca68bU;\n"
+            "    x ^= x >> 16;\n"
+            "    return x;\n"
+            "}\n"
+            "float unitRandom(inout uint state)\n"
+            "{\n"
+            "    state = hash(state);\n"
+            "    return float(state >> 8) * (1.0 / 16777216.0);\n"
+            "}\n"
+            "void emitParticle(vec4 e[9], vec3 offset, inout uint state,\n"
+            "    out vec3 pos, out vec3 vel, out float ttl, out vec4 colour, out vec4 life)\n"
+            "{\n"
+            "    pos = (emitterTransform * vec4(e[0].xyz + offset, 1.0)).xyz;\n"
+            "    // deviate from the direction by up to the angle, around the up vector\n"
+            "    float angle = unitRandom(state) * e[4].w;\n"
+            "    float phi = unitRandom(state) * 6.28318531;\n"
+            "    vec3 side = cross(e[4].xyz, e[5].xyz);\n"
+            "    vec3 dir = cos(angle) * e[4].xyz + sin(angle) * (cos(phi) * e[5].xyz + sin(phi) * side);\n"
+            "    float speed = mix(e[6].x, e[6].y, unitRandom(state));\n"
+            "    vel = (emitterRotation * vec4(dir * speed, 0.0)).xyz;\n"
+            "    ttl = mix(e[6].z, e[6].w, unitRandom(state));\n"
+            "    colour = mix(e[7], e[8], unitRandom(state));\n"
+            "    life = vec4(ttl, defaultSize, 0.0);\n"
+            "}\n";
+
+        /// Create a GLSL program unless it exists already
+        HighLevelGpuProgramPtr createProgram(const String& name, GpuProgramType type, const String& source)
+        {
+            HighLevelGpuProgramManager& mgr = HighLevelGpuProgramManager::getSingleton();
+            HighLevelGpuProgramPtr program = mgr.getByName(name, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+            if (!program)
+            {
+                program = mgr.createProgram(name, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, "glsl", type);
+                program->setSource(source);
+                program->load();
+            }
+            return program;
+        }
+    }
+    //-----------------------------------------------------------------------
+    GpuParticleRenderer::GpuParticleRenderer()
+        : mSystem(0)
+        , mParentNode(0)
+        , mLocalSpace(false)
+        , mDefaultSize(100, 100)
+        , mPendingTime(0)
+        , mPendingSeed(0)
+        , mRingHead(0)
+        , mCapacity(0)
+        , mUpdated(false)
+        , mRenderable(this)
+        , mSeed(this)
+        , mQueueID(RENDER_QUEUE_MAIN)
+        , mQueuePriority(OGRE_RENDERABLE_DEFAULT_PRIORITY)
+        , mQueuePrioritySet(false)
+    {
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        const RenderSystemCapabilities* caps = rs ? rs->getCapabilities() : 0;
+        if (!caps || !caps->hasCapability(RSC_HWRENDER_TO_VERTEX_BUFFER) ||
+            !caps->hasCapability(RSC_GEOMETRY_PROGRAM) ||
+            !HighLevelGpuProgramManager::getSingleton().isLanguageSupported("glsl"))
+        {
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                "The gpu particle renderer needs render to vertex buffer and GLSL geometry program support",
+                "GpuParticleRenderer::GpuParticleRenderer");
+        }
+
+        mName = "ParticleFX/Gpu/" + StringConverter::toString(sRendererCount++) + "/";
+        std::fill(mPendingEmissions, mPendingEmissions + MAX_EMITTERS, 0);
+    }
+    //-----------------------------------------------------------------------
+    GpuParticleRenderer::~GpuParticleRenderer()
+    {
+        destroyResources();
+        if (mDisplayMaterial)
+            MaterialManager::getSingleton().remove(mDisplayMaterial);
+    }
+    //-----------------------------------------------------------------------
+    const String& GpuParticleRenderer::getType(void) const
+    {
+        return rendererTypeName;
+    }
+    //-----------------------------------------------------------------------
+    bool GpuParticleRenderer::_simulateParticles(ParticleSystem* sys, Real timeElapsed)
+    {
+        mSystem = sys;
+        mPendingTime += timeElapsed;
+        mPendingSeed = static_cast<uint32>(sys->_unitRandom() * 16777215);
+
+        // Emission counts come from the emitters as usual, so that rates,
+        // durations and repeat delays behave as with the other renderers
+        if (sys->getEmitting())
+        {
+            size_t used = 0;
+            for (unsigned short i = 0; i < sys->getNumEmitters() && used < MAX_EMITTERS; ++i)
+            {
+                ParticleEmitter* emitter = sys->getEmitter(i);
+                if (!emitter->isEmitted())
+                    mPendingEmissions[used++] += emitter->_getEmissionCount(timeElapsed);
+            }
+        }
+
+        gatherConstants(sys, mPendingSignature);
+        if (sys->getBoundsAutoUpdated())
+            updateBounds(sys);
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::gatherConstants(ParticleSystem* sys, String& signature)
+    {
+        signature.clear();
+        mEmitterConstants.clear();
+        mAffectorConstants.clear();
+
+        // Nine vec4 per emitter:
+        // [0] position, emission end  [1] x axis, emission start
+        // [2] y axis  [3] z axis  [4] direction, angle  [5] up
+        // [6] min / max velocity, min / max time to live
+        // [7] colour range start  [8] colour range end
+        size_t used = 0;
+        for (unsigned short i = 0; i < sys->getNumEmitters() && used < MAX_EMITTERS; ++i)
+        {
+            ParticleEmitter* emitter = sys->getEmitter(i);
+            if (emitter->isEmitted())
+                continue;
+            ++used;
+
+            const String& type = emitter->getType();
+            Vector3 size = Vector3::ZERO;
+            if (type == "Box" || type == "Ellipsoid")
+            {
+                AreaEmitter* area = static_cast<AreaEmitter*>(emitter);
+                size = Vector3(area->getWidth(), area->getHeight(), area->getDepth()) * 0.5f;
+                signature += type == "Box" ? 'B' : 'E';
+            }
+            else
+            {
+                signature += 'P';
+            }
+
+            const Vector3& dir = emitter->getDirection();
+            const Vector3& up = emitter->getUp();
+            // same axes as AreaEmitter::genAreaAxes
+            Vector3 x = up.crossProduct(dir) * size.x;
+            Vector3 y = up * size.y;
+            Vector3 z = dir * size.z;
+            const Vector3& pos = emitter->getPosition();
+            const ColourValue& c0 = emitter->getColourRangeStart();
+            const ColourValue& c1 = emitter->getColourRangeEnd();
+            const float constants[] = {
+                pos.x, pos.y, pos.z, 0,
+                x.x, x.y, x.z, 0,
+                y.x, y.y, y.z, 0,
+                z.x, z.y, z.z, 0,
+                dir.x, dir.y, dir.z, emitter->getAngle().valueRadians(),
+                up.x, up.y, up.z, 0,
+                emitter->getMinParticleVelocity(), emitter->getMaxParticleVelocity(),
+                emitter->getMinTimeToLive(), emitter->getMaxTimeToLive(),
+                c0.r, c0.g, c0.b, c0.a,
+                c1.r, c1.g, c1.b, c1.a };
+            mEmitterConstants.insert(mEmitterConstants.end(), constants,
+                constants + EMITTER_CONSTANTS * 4);
+        }
+
+        signature += '|';
+        for (unsigned short i = 0; i < sys->getNumAffectors(); ++i)
+        {
+            ParticleAffector* affector = sys->getAffector(i);
+            const String& type = affector->getType();
+            float constants[AFFECTOR_CONSTANTS * 4] = { 0 };
+            if (type == "LinearForce")
+            {
+                LinearForceAffector* force = static_cast<LinearForceAffector*>(affector);
+                Vector3 f = force->getForceVector();
+                constants[0] = f.x;
+                constants[1] = f.y;
+                constants[2] = f.z;
+                signature += force->getForceApplication() == LinearForceAffector::FA_ADD ? 'A' : 'V';
+            }
+            else if (type == "ColourFader")
+            {
+                ColourFaderAffector* fader = static_cast<ColourFaderAffector*>(affector);
+                constants[0] = fader->getRedAdjust();
+                constants[1] = fader->getGreenAdjust();
+                constants[2] = fader->getBlueAdjust();
+                constants[3] = fader->getAlphaAdjust();
+                signature += 'C';
+            }
+            else if (type == "Scaler")
+            {
+                constants[0] = static_cast<ScaleAffector*>(affector)->getAdjust();
+                signature += 'S';
+            }
+            else if (type == "DeflectorPlane")
+            {
+                DeflectorPlaneAffector* deflector = static_cast<DeflectorPlaneAffector*>(affector);
+                Vector3 n = deflector->getPlaneNormal();
+                constants[0] = n.x;
+                constants[1] = n.y;
+                constants[2] = n.z;
+                // same plane distance as DeflectorPlaneAffector
+                constants[3] = -n.dotProduct(deflector->getPlanePoint()) / n.length();
+                constants[4] = deflector->getBounce();
+                signature += 'D';
+            }
+            else
+            {
+                continue;
+            }
+            mAffectorConstants.insert(mAffectorConstants.end(), constants,
+                constants + AFFECTOR_CONSTANTS * 4);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::updateBounds(ParticleSystem* sys)
+    {
+        // The particles can't be read back, so grow the bounds to everywhere
+        // they may travel within their lifetime
+        Vector3 force = Vector3::ZERO;
+        Real averageForce = 0, grow = 0;
+        for (unsigned short i = 0; i < sys->getNumAffectors(); ++i)
+        {
+            ParticleAffector* affector = sys->getAffector(i);
+            if (affector->getType() == "LinearForce")
+            {
+                LinearForceAffector* linear = static_cast<LinearForceAffector*>(affector);
+                if (linear->getForceApplication() == LinearForceAffector::FA_ADD)
+                    force += linear->getForceVector();
+                else
+                    averageForce = std::max(averageForce, linear->getForceVector().length());
+            }
+            else if (affector->getType() == "Scaler")
+            {
+                grow = std::max(grow, static_cast<ScaleAffector*>(affector)->getAdjust());
+            }
+        }
+
+        AxisAlignedBox box = sys->getBoundingBox();
+        size_t used = 0;
+        for (unsigned short i = 0; i < sys->getNumEmitters() && used < MAX_EMITTERS; ++i)
+        {
+            ParticleEmitter* emitter = sys->getEmitter(i);
+            if (emitter->isEmitted())
+                continue;
+            ++used;
+
+            Real ttl = emitter->getMaxTimeToLive();
+            Real reach = std::max(emitter->getMaxParticleVelocity(), averageForce) * ttl +
+                0.5f * force.length() * ttl * ttl;
+            reach += 0.5f * (std::max(mDefaultSize.x, mDefaultSize.y) + grow * ttl);
+            const String& type = emitter->getType();
+            if (type == "Box" || type == "Ellipsoid")
+            {
+                AreaEmitter* area = static_cast<AreaEmitter*>(emitter);
+                reach += 0.5f * Vector3(area->getWidth(), area->getHeight(), area->getDepth()).length();
+            }
+            const Vector3& pos = emitter->getPosition();
+            box.merge(AxisAlignedBox(pos - reach, pos + reach));
+        }
+        sys->setBounds(box);
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::_updateRenderQueue(RenderQueue* queue,
+        vector<Particle*>::type& currentParticles, bool cullIndividually)
+    {
+        if (!mSystem)
+            return;
+
+        if (!mBuffer || mSignature != mPendingSignature || mCapacity != mSystem->getParticleQuota())
+            createResources();
+        if (mPendingTime > 0)
+            updateParticles();
+        if (!mUpdated)
+            return;
+
+        if (mQueuePrioritySet)
+            queue->addRenderable(&mRenderable, mQueueID, mQueuePriority);
+        else
+            queue->addRenderable(&mRenderable, mQueueID);
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::updateParticles(void)
+    {
+        // Hand out the ring slots after the head to the emitters, in order.
+        // When more is emitted than fits, the oldest particles are replaced.
+        size_t emitted = 0;
+        const size_t numEmitters = mEmitterConstants.size() / (EMITTER_CONSTANTS * 4);
+        for (size_t i = 0; i < numEmitters; ++i)
+        {
+            float* e = &mEmitterConstants[i * EMITTER_CONSTANTS * 4];
+            size_t count = std::min(mPendingEmissions[i], mCapacity - emitted);
+            e[7] = static_cast<float>(emitted);
+            emitted += count;
+            e[3] = static_cast<float>(emitted);
+        }
+        std::fill(mPendingEmissions, mPendingEmissions + MAX_EMITTERS, 0);
+
+        Pass* pass = mSimulateMaterial->getTechnique(0)->getPass(0);
+        GpuProgramParametersSharedPtr params = pass->getVertexProgramParameters();
+        const float frame[4] = { static_cast<float>(mPendingTime), static_cast<float>(mRingHead),
+            static_cast<float>(mCapacity), static_cast<float>(mPendingSeed) };
+        params->setNamedConstant("frameParams", frame, 1);
+        const float size[2] = { static_cast<float>(mDefaultSize.x), static_cast<float>(mDefaultSize.y) };
+        params->setNamedConstant("defaultSize", size, 1, 2);
+        if (mLocalSpace || !mParentNode)
+        {
+            params->setNamedConstant("emitterTransform", Matrix4::IDENTITY);
+            params->setNamedConstant("emitterRotation", Matrix4::IDENTITY);
+        }
+        else
+        {
+            // particles live in world space, so emit them there
+            params->setNamedConstant("emitterTransform", mParentNode->_getFullTransform());
+            params->setNamedConstant("emitterRotation", Matrix4(mParentNode->_getDerivedOrientation()));
+        }
+        for (size_t i = 0; i < numEmitters; ++i)
+        {
+            params->setNamedConstant("emitter" + StringConverter::toString(i),
+                &mEmitterConstants[i * EMITTER_CONSTANTS * 4], EMITTER_CONSTANTS);
+        }
+        const size_t numAffectors = mAffectorConstants.size() / (AFFECTOR_CONSTANTS * 4);
+        for (size_t i = 0; i < numAffectors; ++i)
+        {
+            params->setNamedConstant("affector" + StringConverter::toString(i),
+                &mAffectorConstants[i * AFFECTOR_CONSTANTS * 4], AFFECTOR_CONSTANTS);
+        }
+
+        mBuffer->update(Root::getSingleton()._getCurrentSceneManager());
+        mRingHead = (mRingHead + emitted) % mCapacity;
+        mPendingTime = 0;
+        mUpdated = true;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::createResources(void)
+    {
+        destroyResources();
+
+        mSignature = mPendingSignature;
+        mCapacity = std::max<size_t>(1, mSystem->getParticleQuota());
+        mRingHead = 0;
+
+        // Say once what isn't simulated, rather than silently differing
+        // from the same system on another renderer
+        size_t used = 0;
+        for (unsigned short i = 0; i < mSystem->getNumEmitters(); ++i)
+        {
+            ParticleEmitter* emitter = mSystem->getEmitter(i);
+            if (emitter->isEmitted())
+                continue;
+            const String& type = emitter->getType();
+            if (++used > MAX_EMITTERS)
+                LogManager::getSingleton().logMessage("WARNING: GpuParticleRenderer: only the first " +
+                    StringConverter::toString(MAX_EMITTERS) + " emitters of " + mSystem->getName() + " are used");
+            else if (type != "Point" && type != "Box" && type != "Ellipsoid")
+                LogManager::getSingleton().logMessage("WARNING: GpuParticleRenderer: " + type +
+                    " emitter of " + mSystem->getName() + " is treated as a point");
+        }
+        for (unsigned short i = 0; i < mSystem->getNumAffectors(); ++i)
+        {
+            const String& type = mSystem->getAffector(i)->getType();
+            if (type != "LinearForce" && type != "ColourFader" && type != "Scaler" && type != "DeflectorPlane")
+                LogManager::getSingleton().logMessage("WARNING: GpuParticleRenderer: " + type +
+                    " affector of " + mSystem->getName() + " is ignored");
+        }
+
+        mSimulateProgram = HighLevelGpuProgramManager::getSingleton().createProgram(
+            mName + "SimulateVS", ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME,
+            "glsl", GPT_VERTEX_PROGRAM);
+        mSimulateProgram->setSource(generateSimulateSource());
+        mSimulateProgram->load();
+
+        mSimulateMaterial = MaterialManager::getSingleton().create(
+            mName + "Simulate", ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+        Pass* pass = mSimulateMaterial->getTechnique(0)->getPass(0);
+        pass->setVertexProgram(mSimulateProgram->getName());
+        pass->getVertexProgramParameters()->setIgnoreMissingParams(true);
+
+        // position, (velocity, time to live), colour, (total time to live, width, height)
+        mBuffer = HardwareBufferManager::getSingleton().createRenderToVertexBuffer();
+        VertexDeclaration* decl = mBuffer->getVertexDeclaration();
+        size_t offset = 0;
+        offset += decl->addElement(0, offset, VET_FLOAT3, VES_POSITION).getSize();
+        offset += decl->addElement(0, offset, VET_FLOAT4, VES_TEXTURE_COORDINATES, 0).getSize();
+        offset += decl->addElement(0, offset, VET_FLOAT4, VES_TEXTURE_COORDINATES, 1).getSize();
+        decl->addElement(0, offset, VET_FLOAT4, VES_TEXTURE_COORDINATES, 2);
+        mBuffer->setOperationType(RenderOperation::OT_POINT_LIST);
+        mBuffer->setMaxVertexCount(static_cast<unsigned int>(mCapacity));
+        mBuffer->setResetsEveryUpdate(false);
+        mBuffer->setRenderToBufferMaterialName(mSimulateMaterial->getName());
+
+        // the first update reads all particles dead from here
+        mSeed.create(decl, mCapacity);
+        mBuffer->setSourceRenderable(&mSeed);
+        mUpdated = false;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::destroyResources(void)
+    {
+        mBuffer.reset();
+        if (mSimulateMaterial)
+        {
+            MaterialManager::getSingleton().remove(mSimulateMaterial);
+            mSimulateMaterial.reset();
+        }
+        if (mSimulateProgram)
+        {
+            HighLevelGpuProgramManager::getSingleton().remove(mSimulateProgram->getHandle());
+            mSimulateProgram.reset();
+        }
+    }
+    //-----------------------------------------------------------------------
+    String GpuParticleRenderer::generateSimulateSource(void) const
+    {
+        const size_t split = mSignature.find('|');
+        StringStream source;
+        source << SIMULATE_HEADER;
+        for (size_t i = 0; i < split; ++i)
+            source << "uniform vec4 emitter" << i << "[" << EMITTER_CONSTANTS << "];\n";
+        for (size_t i = split + 1; i < mSignature.size(); ++i)
+            source << "uniform vec4 affector" << i - split - 1 << "[" << AFFECTOR_CONSTANTS << "];\n";
+
+        source <<
+            "void main()\n"
+            "{\n"
+            "    float dt = frameParams.x;\n"
+            "    vec3 pos = vertex.xyz;\n"
+            "    vec3 vel = uv0.xyz;\n"
+            "    float ttl = uv0.w - dt;\n"
+            "    vec4 colour = uv1;\n"
+            "    vec4 life = uv2;\n"
+            "    if (ttl > 0.0)\n"
+            "    {\n";
+
+        // affectors in the order of the system, then motion
+        for (size_t i = split + 1; i < mSignature.size(); ++i)
+        {
+            const String a = "affector" + StringConverter::toString(i - split - 1);
+            switch (mSignature[i])
+            {
+            case 'A':
+                source << "        vel += " << a << "[0].xyz * dt;\n";
+                break;
+            case 'V':
+                source << "        vel = (vel + " << a << "[0].xyz) * 0.5;\n";
+                break;
+            case 'C':
+                source << "        colour = clamp(colour + " << a << "[0] * dt, 0.0, 1.0);\n";
+                break;
+            case 'S':
+                source << "        life.yz = max(life.yz + " << a << "[0].x * dt, vec2(0.0));\n";
+                break;
+            case 'D':
+                source <<
+                    "        {\n"
+                    "            vec3 n = " << a << "[0].xyz;\n"
+                    "            vec3 travel = vel * dt;\n"
+                    "            float dist = dot(n, pos) + " << a << "[0].w;\n"
+                    "            if (dist > 0.0 && dot(n, pos + travel) + " << a << "[0].w <= 0.0)\n"
+                    "            {\n"
+                    "                vec3 part = travel * (-dist / dot(travel, n));\n"
+                    "                pos = pos + part + (part - travel) * " << a << "[1].x;\n"
+                    "                vel = (vel - 2.0 * dot(vel, n) * n) * " << a << "[1].x;\n"
+                    "            }\n"
+                    "        }\n";
+                break;
+            }
+        }
+
+        source <<
+            "        pos += vel * dt;\n"
+            "    }\n"
+            "    uint state = hash(uint(gl_VertexID) ^ hash(uint(frameParams.w)));\n"
+            "    float slot = mod(float(gl_VertexID) - frameParams.y + frameParams.z, frameParams.z);\n";
+
+        for (size_t i = 0; i < split; ++i)
+        {
+            const String e = "emitter" + StringConverter::toString(i);
+            source << "    if (slot >= " << e << "[1].w && slot < " << e << "[0].w)\n"
+                "    {\n";
+            switch (mSignature[i])
+            {
+            case 'B':
+                source << "        vec3 r = vec3(unitRandom(state), unitRandom(state), unitRandom(state)) * 2.0 - 1.0;\n";
+                break;
+            case 'E':
+                // rejection sampling, like EllipsoidEmitter
+                source <<
+                    "        vec3 r;\n"
+                    "        for (int i = 0; i < 8; ++i)\n"
+                    "        {\n"
+                    "            r = vec3(unitRandom(state), unitRandom(state), unitRandom(state)) * 2.0 - 1.0;\n"
+                    "            if (dot(r, r) <= 1.0)\n"
+                    "                break;\n"
+                    "        }\n"
+                    "        r /= max(1.0, length(r));\n";
+                break;
+            default:
+                source << "        vec3 r = vec3(0.0);\n";
+                break;
+            }
+            source <<
+                "        emitParticle(" << e << ", " << e << "[1].xyz * r.x + " << e << "[2].xyz * r.y + " <<
+                e << "[3].xyz * r.z, state, pos, vel, ttl, colour, life);\n"
+                "    }\n";
+        }
+
+        source <<
+            "    oPos = pos;\n"
+            "    oUv0 = vec4(vel, ttl);\n"
+            "    oUv1 = colour;\n"
+            "    oUv2 = life;\n"
+            "}\n";
+        return source.str();
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::createDisplayMaterial(void)
+    {
+        if (mDisplayMaterial)
+            MaterialManager::getSingleton().remove(mDisplayMaterial);
+
+        createProgram(DISPLAY_VS, GPT_VERTEX_PROGRAM, DISPLAY_VS_SOURCE);
+        createProgram(DISPLAY_GS, GPT_GEOMETRY_PROGRAM, DISPLAY_GS_SOURCE);
+        createProgram(DISPLAY_FS, GPT_FRAGMENT_PROGRAM, DISPLAY_FS_SOURCE);
+        createProgram(DISPLAY_FS_UNTEXTURED, GPT_FRAGMENT_PROGRAM, DISPLAY_FS_UNTEXTURED_SOURCE);
+
+        // Passes with programs of their own are expected to handle the
+        // particle layout, all others get the quad expanding programs
+        mDisplayMaterial = mMaterial->clone(mName + "Display", true,
+            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+        for (unsigned short t = 0; t < mDisplayMaterial->getNumTechniques(); ++t)
+        {
+            Technique* technique = mDisplayMaterial->getTechnique(t);
+            for (unsigned short p = 0; p < technique->getNumPasses(); ++p)
+            {
+                Pass* pass = technique->getPass(p);
+                if (pass->hasVertexProgram())
+                    continue;
+
+                pass->setVertexProgram(DISPLAY_VS);
+                pass->setGeometryProgram(DISPLAY_GS);
+                GpuProgramParametersSharedPtr params = pass->getGeometryProgramParameters();
+                params->setNamedAutoConstant("worldMatrix", GpuProgramParameters::ACT_WORLD_MATRIX);
+                params->setNamedAutoConstant("viewProjMatrix", GpuProgramParameters::ACT_VIEWPROJ_MATRIX);
+                params->setNamedAutoConstant("inverseViewMatrix", GpuProgramParameters::ACT_INVERSE_VIEW_MATRIX);
+                if (pass->getNumTextureUnitStates() > 0)
+                {
+                    pass->setFragmentProgram(DISPLAY_FS);
+                    pass->getFragmentProgramParameters()->setNamedConstant("diffuseMap", 0);
+                }
+                else
+                {
+                    pass->setFragmentProgram(DISPLAY_FS_UNTEXTURED);
+                }
+            }
+        }
+        mDisplayMaterial->load();
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::visitRenderables(Renderable::Visitor* visitor,
+        bool debugRenderables)
+    {
+        visitor->visit(&mRenderable, 0, false);
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::_setMaterial(MaterialPtr& mat)
+    {
+        mMaterial = mat;
+        createDisplayMaterial();
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::_notifyAttached(Node* parent, bool isTagPoint)
+    {
+        mParentNode = parent;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::_notifyDefaultDimensions(Real width, Real height)
+    {
+        mDefaultSize = Vector2(width, height);
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::setRenderQueueGroup(uint8 queueID)
+    {
+        mQueueID = queueID;
+        mQueuePrioritySet = false;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::setRenderQueueGroupAndPriority(uint8 queueID, ushort priority)
+    {
+        mQueueID = queueID;
+        mQueuePriority = priority;
+        mQueuePrioritySet = true;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::ParticleRenderable::getRenderOperation(RenderOperation& op)
+    {
+        mParent->mBuffer->getRenderOperation(op);
+        op.srcRenderable = this;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::ParticleRenderable::getWorldTransforms(Matrix4* xform) const
+    {
+        // particles kept in world space are emitted there already
+        if (mParent->mLocalSpace && mParent->mParentNode)
+            *xform = mParent->mParentNode->_getFullTransform();
+        else
+            *xform = Matrix4::IDENTITY;
+    }
+    //-----------------------------------------------------------------------
+    Real GpuParticleRenderer::ParticleRenderable::getSquaredViewDepth(const Camera* cam) const
+    {
+        return mParent->mParentNode ? mParent->mParentNode->getSquaredViewDepth(cam) : 0;
+    }
+    //-----------------------------------------------------------------------
+    const LightList& GpuParticleRenderer::ParticleRenderable::getLights(void) const
+    {
+        return mParent->mSystem->queryLights();
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    GpuParticleRenderer::SeedRenderable::~SeedRenderable()
+    {
+        OGRE_DELETE mVertexData;
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::SeedRenderable::create(const VertexDeclaration* decl, size_t count)
+    {
+        OGRE_DELETE mVertexData;
+        mVertexData = OGRE_NEW VertexData();
+        mVertexData->vertexStart = 0;
+        mVertexData->vertexCount = count;
+        mVertexData->vertexDeclaration = decl->clone();
+
+        HardwareVertexBufferSharedPtr buffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+            decl->getVertexSize(0), count, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        // all zero is a dead particle, its time to live is 0
+        void* data = buffer->lock(HardwareBuffer::HBL_DISCARD);
+        memset(data, 0, buffer->getSizeInBytes());
+        buffer->unlock();
+        mVertexData->vertexBufferBinding->setBinding(0, buffer);
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRenderer::SeedRenderable::getRenderOperation(RenderOperation& op)
+    {
+        op.operationType = RenderOperation::OT_POINT_LIST;
+        op.useIndexes = false;
+        op.indexData = 0;
+        op.vertexData = mVertexData;
+        op.srcRenderable = this;
+    }
+    //-----------------------------------------------------------------------
+    const LightList& GpuParticleRenderer::SeedRenderable::getLights(void) const
+    {
+        return mParent->mSystem->queryLights();
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    const String& GpuParticleRendererFactory::getType() const
+    {
+        return rendererTypeName;
+    }
+    //-----------------------------------------------------------------------
+    ParticleSystemRenderer* GpuParticleRendererFactory::createInstance(
+        const String& name )
+    {
+        return OGRE_NEW GpuParticleRenderer();
+    }
+    //-----------------------------------------------------------------------
+    void GpuParticleRendererFactory::destroyInstance(
+        ParticleSystemRenderer* inst)
+    {
+        OGRE_DELETE  inst;
+    }
+}
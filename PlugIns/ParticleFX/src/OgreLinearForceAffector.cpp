@@ -66,9 +66,9 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
-    void LinearForceAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    void LinearForceAffector::_affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, 
+        Particle** particles, size_t count)
     {
-        ParticleIterator pi = pSystem->_getIterator();
         Particle *p;
 
         Vector3 scaledVector = Vector3::ZERO;
@@ -80,9 +80,9 @@ namespace Ogre {
             scaledVector = mForceVector * timeElapsed;
         }
 
-        while (!pi.end())
+        for (size_t n = 0; n < count; ++n)
         {
-            p = pi.getNext();
+            p = particles[n];
             if (mForceApplication == FA_ADD)
             {
                 p->mDirection += scaledVector;
@@ -0,0 +1,139 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+/** Internal include file -- do not use externally */
+#ifndef __ParticleFXSIMD_H__
+#define __ParticleFXSIMD_H__
+
+#include "OgreParticleFXPrerequisites.h"
+#include "OgrePlatformInformation.h"
+
+// The plugin has no runtime dispatch, so only use what the compiler targets anyway
+#if __OGRE_HAVE_SSE && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#   define OGRE_PARTICLEFX_SSE 1
+#   include <xmmintrin.h>
+#elif __OGRE_HAVE_NEON
+#   define OGRE_PARTICLEFX_NEON 1
+#   include <arm_neon.h>
+#endif
+
+namespace Ogre {
+namespace ParticleFXSIMD {
+
+    /** Four lanes, used either for the r, g, b, a of one colour or for the
+        same member of four particles. Without SSE or NEON it falls back to
+        plain Reals, so the affectors only have one code path.
+    */
+#if OGRE_PARTICLEFX_SSE
+    typedef __m128 Float4;
+
+    inline Float4 load4(const float* p) { return _mm_loadu_ps(p); }
+    inline void store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+    inline void extract4(Float4 v, Real* out) { _mm_storeu_ps(out, v); }
+    inline Float4 set4(Real x, Real y, Real z, Real w) { return _mm_setr_ps(x, y, z, w); }
+    inline Float4 splat4(Real v) { return _mm_set1_ps(v); }
+    inline Float4 add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+    inline Float4 sub4(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+    inline Float4 mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+    inline Float4 min4(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+    inline Float4 max4(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+    /// Bit i is set when lane i of a is less than or equal to lane i of b
+    inline int lessEqualMask4(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmple_ps(a, b)); }
+#elif OGRE_PARTICLEFX_NEON
+    typedef float32x4_t Float4;
+
+    inline Float4 load4(const float* p) { return vld1q_f32(p); }
+    inline void store4(float* p, Float4 v) { vst1q_f32(p, v); }
+    inline void extract4(Float4 v, Real* out) { vst1q_f32(out, v); }
+    inline Float4 set4(Real x, Real y, Real z, Real w)
+    {
+        const float v[4] = { x, y, z, w };
+        return vld1q_f32(v);
+    }
+    inline Float4 splat4(Real v) { return vdupq_n_f32(v); }
+    inline Float4 add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+    inline Float4 sub4(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+    inline Float4 mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+    inline Float4 min4(Float4 a, Float4 b) { return vminq_f32(a, b); }
+    inline Float4 max4(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+    /// Bit i is set when lane i of a is less than or equal to lane i of b
+    inline int lessEqualMask4(Float4 a, Float4 b)
+    {
+        uint32 m[4];
+        vst1q_u32(m, vcleq_f32(a, b));
+        return (m[0] & 1) | (m[1] & 2) | (m[2] & 4) | (m[3] & 8);
+    }
+#else
+    struct Float4 { Real v[4]; };
+
+    inline Float4 load4(const float* p) { Float4 r = { { p[0], p[1], p[2], p[3] } }; return r; }
+    inline void store4(float* p, const Float4& a)
+    {
+        for (int i = 0; i < 4; ++i)
+            p[i] = static_cast<float>(a.v[i]);
+    }
+    inline void extract4(const Float4& a, Real* out)
+    {
+        for (int i = 0; i < 4; ++i)
+            out[i] = a.v[i];
+    }
+    inline Float4 set4(Real x, Real y, Real z, Real w) { Float4 r = { { x, y, z, w } }; return r; }
+    inline Float4 splat4(Real v) { return set4(v, v, v, v); }
+    inline Float4 add4(const Float4& a, const Float4& b) { return set4(a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]); }
+    inline Float4 sub4(const Float4& a, const Float4& b) { return set4(a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]); }
+    inline Float4 mul4(const Float4& a, const Float4& b) { return set4(a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]); }
+    inline Float4 min4(const Float4& a, const Float4& b)
+    {
+        return set4(std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3]));
+    }
+    inline Float4 max4(const Float4& a, const Float4& b)
+    {
+        return set4(std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3]));
+    }
+    /// Bit i is set when lane i of a is less than or equal to lane i of b
+    inline int lessEqualMask4(const Float4& a, const Float4& b)
+    {
+        int mask = 0;
+        for (int i = 0; i < 4; ++i)
+            mask |= (a.v[i] <= b.v[i]) << i;
+        return mask;
+    }
+#endif
+
+    /// a * b + c
+    inline Float4 madd4(const Float4& a, const Float4& b, const Float4& c) { return add4(mul4(a, b), c); }
+
+    /// Clamp every lane to [0, 1]
+    inline Float4 saturate4(const Float4& a) { return min4(max4(a, splat4(0)), splat4(1)); }
+
+    /// Linear interpolation from a (t = 0) to b (t = 1)
+    inline Float4 lerp4(const Float4& a, const Float4& b, Real t) { return madd4(sub4(b, a), splat4(t), a); }
+
+}
+}
+
+#endif
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleFXSIMD.h"
 
 
 namespace Ogre {
@@ -77,32 +78,39 @@ namespace Ogre {
     {
         pParticle->setRotation(
             mRotationRangeStart + 
-            (Math::UnitRandom() * 
+            (mParent->_unitRandom() * 
                 (mRotationRangeEnd - mRotationRangeStart)));
         pParticle->mRotationSpeed =
             mRotationSpeedRangeStart + 
-            (Math::UnitRandom() * 
+            (mParent->_unitRandom() * 
                 (mRotationSpeedRangeEnd - mRotationSpeedRangeStart));
         
     }
     //-----------------------------------------------------------------------
-    void RotationAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    void RotationAffector::_affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, 
+        Particle** particles, size_t count)
     {
-        ParticleIterator pi = pSystem->_getIterator();
-        Particle *p;
-        Real ds;
+        using namespace ParticleFXSIMD;
 
         // Rotation adjustments by time
-        ds = timeElapsed;
+        const Float4 ds = splat4(timeElapsed);
 
-        Radian NewRotation;
-
-        while (!pi.end())
+        // Four particles at a time, unused lanes of the last group are ignored
+        for (size_t n = 0; n < count; n += 4)
         {
-            p = pi.getNext();
-
-            NewRotation = p->mRotation + (ds * p->mRotationSpeed);
-            p->setRotation( NewRotation );
+            const size_t lanes = std::min<size_t>(4, count - n);
+            Real rotation[4] = { 0, 0, 0, 0 }, speed[4] = { 0, 0, 0, 0 };
+            for (size_t i = 0; i < lanes; ++i)
+            {
+                rotation[i] = particles[n + i]->mRotation.valueRadians();
+                speed[i] = particles[n + i]->mRotationSpeed.valueRadians();
+            }
+
+            extract4(madd4(set4(speed[0], speed[1], speed[2], speed[3]), ds,
+                set4(rotation[0], rotation[1], rotation[2], rotation[3])), rotation);
+
+            for (size_t i = 0; i < lanes; ++i)
+                particles[n + i]->setRotation(Radian(rotation[i]));
         }
 
     }
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleFXSIMD.h"
 
 
 namespace Ogre {
@@ -54,33 +55,33 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
-    void ScaleAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    void ScaleAffector::_affectParticleSpan(ParticleSystem* pSystem, Real timeElapsed, 
+        Particle** particles, size_t count)
     {
-        ParticleIterator pi = pSystem->_getIterator();
-        Particle *p;
-        Real ds;
+        using namespace ParticleFXSIMD;
 
         // Scale adjustments by time
-        ds = mScaleAdj * timeElapsed;
+        const Float4 ds = splat4(mScaleAdj * timeElapsed);
+        const Real defaultWidth = pSystem->getDefaultWidth();
+        const Real defaultHeight = pSystem->getDefaultHeight();
 
-        Real NewWide, NewHigh;
-
-        while (!pi.end())
+        // Four particles at a time, unused lanes of the last group are ignored
+        for (size_t n = 0; n < count; n += 4)
         {
-            p = pi.getNext();
-
-            if( p->hasOwnDimensions() == false )
+            const size_t lanes = std::min<size_t>(4, count - n);
+            Real width[4] = { 0, 0, 0, 0 }, height[4] = { 0, 0, 0, 0 };
+            for (size_t i = 0; i < lanes; ++i)
             {
-                NewWide = pSystem->getDefaultWidth() + ds;
-                NewHigh = pSystem->getDefaultHeight() + ds;
-
+                Particle* p = particles[n + i];
+                width[i] = p->hasOwnDimensions() ? p->getOwnWidth() : defaultWidth;
+                height[i] = p->hasOwnDimensions() ? p->getOwnHeight() : defaultHeight;
             }
-            else
-            {
-                NewWide = p->getOwnWidth()  + ds;
-                NewHigh = p->getOwnHeight() + ds;
-            }
-            p->setDimensions( NewWide, NewHigh ); 
+
+            extract4(add4(set4(width[0], width[1], width[2], width[3]), ds), width);
+            extract4(add4(set4(height[0], height[1], height[2], height[3]), ds), height);
+
+            for (size_t i = 0; i < lanes; ++i)
+                particles[n + i]->setDimensions(width[i], height[i]);
         }
 
     }
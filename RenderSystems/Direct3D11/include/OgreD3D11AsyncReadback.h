@@ -0,0 +1,65 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __D3D11ASYNCREADBACK_H__
+#define __D3D11ASYNCREADBACK_H__
+
+#include "OgreD3D11Prerequisites.h"
+#include "OgreAsyncReadback.h"
+
+namespace Ogre {
+
+    /** Readback of pixels copied into a staging texture, mapped without
+        waiting until the copy is done.
+    */
+    class _OgreD3D11Export D3D11AsyncReadback : public AsyncReadback
+    {
+    public:
+        /**
+        @param stagingTexture
+            Staging texture with CPU read access the pixels were copied into
+        @param subresource
+            Subresource of the staging texture holding the pixels
+        @param box
+            Region of the subresource holding the pixels
+        */
+        D3D11AsyncReadback(D3D11Device& device, const ComPtr<ID3D11Texture2D>& stagingTexture,
+                           UINT subresource, const D3D11_BOX& box, DXGI_FORMAT format);
+
+        bool isReady(void);
+        void fetch(const PixelBox& dst);
+
+    protected:
+        D3D11Device& mDevice;
+        ComPtr<ID3D11Texture2D> mStagingTexture;
+        UINT mSubresource;
+        D3D11_BOX mBox;
+        DXGI_FORMAT mDXGIFormat;
+    };
+}
+
+#endif
@@ -38,6 +38,7 @@ namespace Ogre
     private:
         ComPtr<ID3D11DeviceN>           mD3D11Device;
         ComPtr<ID3D11DeviceContextN>    mImmediateContext;
+        ComPtr<ID3D11DeviceContextN>    mRecordingContext;
         ComPtr<ID3D11ClassLinkage>      mClassLinkage;
         ComPtr<ID3D11InfoQueue>         mInfoQueue;
         LARGE_INTEGER                   mDriverVersion;
@@ -60,6 +61,16 @@ namespace Ogre
         bool isNull()                                { return !mD3D11Device; }
         ID3D11DeviceN* get()                         { return mD3D11Device.Get(); }
         ID3D11DeviceContextN* GetImmediateContext()  { return mImmediateContext.Get(); }
+        /// Context rendering commands are issued on, the recording context if one is set
+        ID3D11DeviceContextN* GetCurrentContext()    { return mRecordingContext ? mRecordingContext.Get() : mImmediateContext.Get(); }
+        bool IsRecording() const                     { return mRecordingContext.Get() != NULL; }
+        /** Redirects the rendering commands issued through GetCurrentContext to a deferred
+            context, or back to the immediate context if NULL is passed. */
+        void SetRecordingContext(ID3D11DeviceContextN* context) { mRecordingContext = context; }
+        /** Creates a deferred context. Each deferred context may be filled from its own thread,
+            the resulting command lists have to be executed on the immediate context.
+        @return NULL if the device can not create deferred contexts */
+        ComPtr<ID3D11DeviceContextN> CreateDeferredContext();
         ID3D11ClassLinkage* GetClassLinkage()        { return mClassLinkage.Get(); }
         IDXGIFactoryN* GetDXGIFactory()              { return mDXGIFactory.Get(); }
         LARGE_INTEGER GetDriverVersion()             { return mDriverVersion; }
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreD3D11DeviceResource.h"
 #include "OgreHighLevelGpuProgram.h"
 #include "OgreHardwareUniformBuffer.h"
+#include "Threading/OgreParallel.h"
 
 
 namespace Ogre {
@@ -86,6 +87,9 @@ namespace Ogre {
             void doSet(void* target, const String& val);
         };
 
+        /// Constant buffer slots read from the buffer of a shared parameter set
+        typedef vector<std::pair<UINT, GpuSharedParametersPtr> >::type SharedParamsBufferList;
+
     protected:
 
         static CmdEntryPoint msCmdEntryPoint;
@@ -102,6 +106,10 @@ namespace Ogre {
         void createLowLevelImpl(void);
         /// Internal unload implementation, must be implemented by subclasses
         void unloadHighLevelImpl(void);
+        /// Starts compiling the source on the work queue, picked up by loadFromSource
+        void prepareImpl(void);
+        /// Waits for and discards a compile started by prepareImpl
+        void unprepareImpl(void);
         /// Populate the passed parameters with name->index map, must be overridden
         void populateParameterNames(GpuProgramParametersSharedPtr params);
 
@@ -124,6 +132,11 @@ namespace Ogre {
         D3D_SHADER_MACRO* mShaderMacros;
         bool shaderMacroSet;
 
+        /// D3DCompile call with its own copy of the inputs, so it can run on a worker thread
+        class CompileJob;
+        /// Compile started by prepareImpl, if any
+        ParallelJobPtr mCompileJob;
+
         D3D11Device & mDevice;
 
         ComPtr<ID3D11VertexShader> mVertexShader;
@@ -242,6 +255,9 @@ namespace Ogre {
         typedef std::map<String, unsigned int>::const_iterator SlotIterator;
         SlotMap mSlotMap;
 
+        /// Constant buffers named after a shared parameter set, bound from its buffer
+        SharedParamsBufferList mSharedParamsBuffers;
+
         typedef vector<D3D11_SIGNATURE_PARAMETER_DESC>::type D3d11ShaderParameters;
         typedef D3d11ShaderParameters::iterator D3d11ShaderParametersIter; 
 
@@ -288,6 +304,10 @@ namespace Ogre {
         void analizeMicrocode();
         void getMicrocodeFromCache(void);
         void compileMicrocode(void);
+        /// Create the compile job for the current source and settings
+        CompileJob* createCompileJob(void);
+        /// Wait for a compile started by prepareImpl and drop it
+        void discardCompileJob(void);
     public:
         D3D11HLSLProgram(ResourceManager* creator, const String& name, ResourceHandle handle,
             const String& group, bool isManual, ManualResourceLoader* loader, D3D11Device & device);
@@ -332,6 +352,13 @@ namespace Ogre {
 
         ID3D11Buffer* getConstantBuffer(GpuProgramParametersSharedPtr params, uint16 variabilityMask);
 
+        /** Gets the constant buffers declared with the name of a shared parameter
+            set, which the render system binds from the buffer of the set. Their
+            slot is their index among the constant buffers of the program, as
+            for the buffer of the program itself in slot 0.
+        */
+        const SharedParamsBufferList& getSharedParamsBuffers(void) const { return mSharedParamsBuffers; }
+
         void getConstantBuffers(ID3D11Buffer** buffers, unsigned int& numBuffers,
                                 ID3D11ClassInstance** classes, unsigned int& numInstances,
                                 GpuProgramParametersSharedPtr params, uint16 variabilityMask);
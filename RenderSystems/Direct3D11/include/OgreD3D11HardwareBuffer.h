@@ -54,6 +54,10 @@ namespace Ogre {
         BufferType mBufferType;
         D3D11Device & mDevice;
         D3D11_BUFFER_DESC mDesc;
+        /// End of the range written since the buffer was last mapped with D3D11_MAP_WRITE_DISCARD
+        size_t mWrittenSinceDiscard;
+        /// Context the buffer is currently mapped on
+        ID3D11DeviceContextN* mMappedContext;
 
 
 
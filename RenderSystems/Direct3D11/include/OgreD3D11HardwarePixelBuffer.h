@@ -85,6 +85,9 @@ namespace Ogre {
         /// @copydoc HardwarePixelBuffer::blitToMemory
         void blitToMemory(const Box &srcBox, const PixelBox &dst);
 
+        /// @copydoc HardwarePixelBuffer::blitToMemoryAsync
+        AsyncReadbackPtr blitToMemoryAsync(const Box &srcBox);
+
         /// Internal function to update mipmaps on update of level 0
         void _genMipmaps();
 
@@ -0,0 +1,84 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __D3D11HARDWARETIMERQUERY_H__
+#define __D3D11HARDWARETIMERQUERY_H__
+
+#include "OgreD3D11Prerequisites.h"
+#include "OgreHardwareTimerQuery.h"
+#include "OgreD3D11Device.h"
+#include "OgreSharedPtr.h"
+
+namespace Ogre {
+
+    /** The TIMESTAMP_DISJOINT query the timestamps of one frame are issued in
+    @remarks
+        Gives the frequency of the timestamps and tells whether they are reliable. 
+        Begun when the first timestamp of a frame is queried, ended with the frame.
+    */
+    class _OgreD3D11Export D3D11TimestampDisjointQuery : public RenderSysAlloc
+    {
+    public:
+        D3D11TimestampDisjointQuery( D3D11Device & device );
+        ~D3D11TimestampDisjointQuery();
+
+        void end();
+        bool isStillOutstanding(void);
+        /// Ticks per second of the timestamps, 0 if they are not reliable. Waits for the result.
+        UINT64 getFrequency(void);
+
+    private:
+        ComPtr<ID3D11Query> mQuery;
+        D3D11Device &   mDevice;
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT mData;
+        bool mIsQueryResultStillOutstanding;
+    };
+    typedef SharedPtr<D3D11TimestampDisjointQuery> D3D11TimestampDisjointQueryPtr;
+
+    /** D3D11_QUERY_TIMESTAMP query
+    */
+    class _OgreD3D11Export D3D11HardwareTimerQuery : public HardwareTimerQuery
+    {
+    public:
+        D3D11HardwareTimerQuery( D3D11RenderSystem * renderSystem, D3D11Device & device );
+        ~D3D11HardwareTimerQuery();
+
+        void queryTimestamp(void);
+        bool isStillOutstanding(void);
+        bool pullTimestamp(uint64* nanoseconds);
+
+    private:
+        ComPtr<ID3D11Query> mQuery;
+        D3D11RenderSystem * mRenderSystem;
+        D3D11Device &   mDevice;
+        /// The disjoint query of the frame the timestamp was issued in
+        D3D11TimestampDisjointQueryPtr mDisjointQuery;
+    };
+
+}
+
+#endif
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreRenderSystem.h"
 #include "OgreD3D11Device.h"
 #include "OgreD3D11DeviceResource.h"
+#include "OgreD3D11HardwareTimerQuery.h"
 #include "OgreD3D11Driver.h"
 #include "OgreD3D11Mappings.h"
 
@@ -68,6 +69,12 @@ namespace Ogre
 
         /// Direct3D rendering device
         D3D11Device     mDevice;
+
+        /// The disjoint query the timestamps of this frame are issued in
+        D3D11TimestampDisjointQueryPtr mTimestampDisjointQuery;
+
+        /// Event queries ending the frames the GPU may still be working on, oldest first
+        deque<ComPtr<ID3D11Query> >::type mFrameFences;
         
         // Stored options
         ConfigOptionMap mOptions;
@@ -128,6 +135,23 @@ namespace Ogre
         D3D11_DEPTH_STENCIL_DESC    mDepthStencilDesc; 
         bool                        mDepthStencilDescChanged;
 
+        /// Orders state descriptions by their bytes, they are zero initialised so padding compares equal
+        template<typename Desc> struct DescLess
+        {
+            bool operator()(const Desc& a, const Desc& b) const { return memcmp(&a, &b, sizeof(Desc)) < 0; }
+        };
+        /// State objects created so far, so each description is only created once on the device
+        typedef map<D3D11_BLEND_DESC, ComPtr<ID3D11BlendState>, DescLess<D3D11_BLEND_DESC> >::type BlendStateMap;
+        typedef map<D3D11_RASTERIZER_DESC, ComPtr<ID3D11RasterizerState>, DescLess<D3D11_RASTERIZER_DESC> >::type RasterizerStateMap;
+        typedef map<D3D11_DEPTH_STENCIL_DESC, ComPtr<ID3D11DepthStencilState>, DescLess<D3D11_DEPTH_STENCIL_DESC> >::type DepthStencilStateMap;
+        typedef map<D3D11_SAMPLER_DESC, ComPtr<ID3D11SamplerState>, DescLess<D3D11_SAMPLER_DESC> >::type SamplerStateMap;
+        BlendStateMap mBlendStates;
+        RasterizerStateMap mRasterizerStates;
+        DepthStencilStateMap mDepthStencilStates;
+        SamplerStateMap mSamplerStates;
+        /// Release the cached state objects, before the device goes away
+        void clearStateObjects(void);
+
         PolygonMode mPolygonMode;
 
         FilterOptions FilterMinification[OGRE_MAX_TEXTURE_LAYERS];
@@ -158,6 +182,9 @@ namespace Ogre
         ID3D11ShaderResourceView * mBoundTextures[OGRE_MAX_TEXTURE_LAYERS];
         size_t mBoundTexturesCount;
 
+        /// Deferred context rendering is recorded on between begin/endCommandRecording
+        ComPtr<ID3D11DeviceContextN> mDeferredContext;
+
         // List of class instances per shader stage
         ID3D11ClassInstance* mClassInstances[6][8];
 
@@ -214,6 +241,9 @@ namespace Ogre
          */
         void _setRenderTargetViews();
 
+        /// Forgets the cached device state, after switching to a context that is in its default state
+        void _resetBoundState();
+
     public:
         // constructor
         D3D11RenderSystem( );
@@ -268,6 +298,10 @@ namespace Ogre
         void setConfigOption( const String &name, const String &value );
         void reinitialise();
         void shutdown();
+        /// @copydoc RenderSystem::_insertFrameFence
+        void _insertFrameFence(void);
+        /// @copydoc RenderSystem::_waitFrameFences
+        void _waitFrameFences(size_t maxPending);
         void validateDevice(bool forceDeviceElection = false);
         void handleDeviceLost();
         void destroyRenderTarget(const String& name);
@@ -338,12 +372,15 @@ namespace Ogre
         void setVertexBufferBinding(VertexBufferBinding* binding);
         void _renderUsingReadBackAsTexture(unsigned int passNr, Ogre::String variableName,unsigned int StartSlot);
         void _render(const RenderOperation& op);
+        void _dispatchCompute(const Vector3& workgroupDim);
 
         void bindGpuProgram(GpuProgram* prg);
 
         void unbindGpuProgram(GpuProgramType gptype);
 
         void bindGpuProgramParameters(GpuProgramType gptype, GpuProgramParametersSharedPtr params, uint16 mask);
+        /// Uploads the shared parameters the bound program reads from constant buffers and binds them
+        void bindSharedParamsBuffers(GpuProgramType gptype);
 
         void bindGpuProgramPassIterationParameters(GpuProgramType gptype);
 
@@ -352,6 +389,9 @@ namespace Ogre
             const ColourValue& colour = ColourValue::Black, 
             Real depth = 1.0f, unsigned short stencil = 0);
         HardwareOcclusionQuery* createHardwareOcclusionQuery(void);
+        HardwareTimerQuery* createHardwareTimerQuery(void);
+        /// The disjoint query of the current frame, begun on first use
+        const D3D11TimestampDisjointQueryPtr& _getTimestampDisjointQuery(void);
         Real getHorizontalTexelOffset(void);
         Real getVerticalTexelOffset(void);
         Real getMinimumDepthInputValue(void);
@@ -399,6 +439,25 @@ namespace Ogre
 		
 		/// @copydoc RenderSystem::setDrawBuffer
 		virtual bool setDrawBuffer(ColourBufferType colourBuffer);
+
+        /** Records the rendering issued from now on into a command list on a deferred context,
+            instead of submitting it to the GPU.
+        @remarks
+            Only locks with HBL_DISCARD on dynamic buffers are recorded, all other buffer and
+            texture updates still happen immediately.
+        @return false if the device can not create deferred contexts
+        */
+        bool beginCommandRecording();
+
+        /// Stops recording and returns the recorded commands
+        ComPtr<ID3D11CommandList> endCommandRecording();
+
+        /** Submits recorded commands after the ones issued so far.
+        @remarks
+            Command lists filled by other threads on their own D3D11Device::CreateDeferredContext
+            can be executed as well, in the order they have to be rendered.
+        */
+        void executeCommandList(ID3D11CommandList* commandList);
     };
     /** @} */
     /** @} */
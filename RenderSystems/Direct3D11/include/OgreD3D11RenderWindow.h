@@ -67,6 +67,8 @@ namespace Ogre
         void getCustomAttribute( const String& name, void* pData );
         /** Overridden - see RenderTarget. */
         virtual void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer);
+        /** Overridden - see RenderTarget. */
+        virtual AsyncReadbackPtr copyContentsToMemoryAsync(const Box& src, FrameBuffer buffer = FB_AUTO);
         bool requiresTextureFlipping() const                    { return false; }
 
         virtual bool _shouldRebindBackBuffer()                  { return false; }
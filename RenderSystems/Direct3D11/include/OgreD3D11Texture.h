@@ -74,6 +74,11 @@ namespace Ogre {
 
 		bool HasAutoMipMapGenerationEnabled() const { return mAutoMipMapGeneration; }
 
+		/// @copydoc Texture::createShaderAccessPoint
+		/// Binds an unordered access view to the compute stage, the texture needs TU_UNORDERED_ACCESS
+		void createShaderAccessPoint(uint bindPoint, TextureAccess access = TA_READ_WRITE,
+			int mipmapLevel = 0, int textureArrayIndex = 0, PixelFormat* format = NULL);
+
 	protected:
 		TextureUsage _getTextureUsage() { return static_cast<TextureUsage>(mUsage); }
 
@@ -161,6 +166,10 @@ namespace Ogre {
         ComPtr<ID3D11Texture1D> mp1DTex;
         ComPtr<ID3D11Texture2D> mp2DTex;
         ComPtr<ID3D11Texture3D> mp3DTex;
+        ComPtr<ID3D11UnorderedAccessView> mpUnorderedAccessView;
+        DXGI_FORMAT mUnorderedAccessFormat; // format, mip and array slice the view was created for
+        int mUnorderedAccessMip;
+        int mUnorderedAccessSlice;
 
         D3D11_SHADER_RESOURCE_VIEW_DESC mSRVDesc;
         bool mAutoMipMapGeneration;
@@ -0,0 +1,71 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreD3D11AsyncReadback.h"
+#include "OgreD3D11Device.h"
+#include "OgreD3D11Mappings.h"
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------------
+    D3D11AsyncReadback::D3D11AsyncReadback(D3D11Device& device, const ComPtr<ID3D11Texture2D>& stagingTexture,
+                                           UINT subresource, const D3D11_BOX& box, DXGI_FORMAT format)
+        : AsyncReadback(box.right - box.left, box.bottom - box.top, box.back - box.front,
+                        D3D11Mappings::_getPF(format)),
+          mDevice(device), mStagingTexture(stagingTexture), mSubresource(subresource),
+          mBox(box), mDXGIFormat(format)
+    {
+    }
+    //-----------------------------------------------------------------------------
+    bool D3D11AsyncReadback::isReady(void)
+    {
+        // Mapping without waiting fails while the copy is still pending
+        D3D11_MAPPED_SUBRESOURCE mapped = {0};
+        HRESULT hr = mDevice.GetImmediateContext()->Map(mStagingTexture.Get(), mSubresource,
+                                                        D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+        if(hr == DXGI_ERROR_WAS_STILL_DRAWING)
+            return false;
+
+        mDevice.throwIfFailed(hr, "Error while mapping staging texture", "D3D11AsyncReadback::isReady");
+        mDevice.GetImmediateContext()->Unmap(mStagingTexture.Get(), mSubresource);
+        return true;
+    }
+    //-----------------------------------------------------------------------------
+    void D3D11AsyncReadback::fetch(const PixelBox& dst)
+    {
+        // Map the subresource of the staging texture
+        D3D11_MAPPED_SUBRESOURCE mapped = {0};
+        HRESULT hr = mDevice.GetImmediateContext()->Map(mStagingTexture.Get(), mSubresource, D3D11_MAP_READ, 0, &mapped);
+        mDevice.throwIfFailed(hr, "Error while mapping staging texture", "D3D11AsyncReadback::fetch");
+
+        // Read the data out of the texture
+        PixelBox locked = D3D11Mappings::getPixelBoxWithMapping(mBox, mDXGIFormat, mapped);
+        copyPixels(locked, dst);
+
+        mDevice.GetImmediateContext()->Unmap(mStagingTexture.Get(), mSubresource);
+    }
+}
@@ -56,12 +56,27 @@ namespace Ogre
 #endif
         mInfoQueue.Reset();
         mClassLinkage.Reset();
+        mRecordingContext.Reset();
         mImmediateContext.Reset();
         mD3D11Device.Reset();
         mDXGIFactory.Reset();
         mDriverVersion.QuadPart = 0;
     }
     //---------------------------------------------------------------------
+    ComPtr<ID3D11DeviceContextN> D3D11Device::CreateDeferredContext()
+    {
+        ComPtr<ID3D11DeviceContextN> context;
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        HRESULT hr = mD3D11Device->CreateDeferredContext(0, context.GetAddressOf());
+#elif OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+        HRESULT hr = mD3D11Device->CreateDeferredContext1(0, context.GetAddressOf());
+#endif
+        // fails with DXGI_ERROR_INVALID_CALL on devices created with D3D11_CREATE_DEVICE_SINGLETHREADED
+        if (FAILED(hr))
+            context.Reset();
+        return context;
+    }
+    //---------------------------------------------------------------------
     void D3D11Device::TransferOwnership(ID3D11DeviceN* d3d11device)
     {
         assert(mD3D11Device.Get() != d3d11device);
@@ -160,6 +160,46 @@ namespace Ogre {
         Resource* mProgram;
     };
 
+    //-----------------------------------------------------------------------
+    class D3D11HLSLProgram::CompileJob : public ParallelJob
+    {
+    public:
+        CompileJob(D3D11HLSLProgram* program)
+            : ParallelJob(1), mIncludeHandler(program), mDefines(NULL), mFlags(0), mResult(E_FAIL) {}
+
+        void execute(size_t begin, size_t end)
+        {
+            mResult = D3DCompile(
+                mSource.c_str(),      // [in] Pointer to the shader in memory. 
+                mSource.size(),       // [in] Size of the shader in memory.  
+                mFileName.c_str(),    // [in] Optional. You can use this parameter for strings that specify error messages.
+                mDefines,             // [in] Optional. Pointer to a NULL-terminated array of macro definitions. See D3D_SHADER_MACRO. If not used, set this to NULL. 
+                &mIncludeHandler,     // [in] Optional. Pointer to an ID3DInclude Interface interface for handling include files. Setting this to NULL will cause a compile error if a shader contains a #include. 
+                mEntryPoint.c_str(),  // [in] Name of the shader-entrypoint function where shader execution begins. 
+                mTarget.c_str(),      // [in] A string that specifies the shader model; can be any profile in shader model 4 or higher. 
+                mFlags,               // [in] Effect compile flags - no D3DCOMPILE_ENABLE_BACKWARDS_COMPATIBILITY at the first try...
+                NULL,                 // [in] Effect compile flags
+                mMicroCode.GetAddressOf(),// [out] A pointer to an ID3DBlob Interface which contains the compiled shader, as well as any embedded debug and symbol-table information. 
+                mErrors.GetAddressOf() // [out] A pointer to an ID3DBlob Interface which contains a listing of errors and warnings that occurred during compilation. These errors and warnings are identical to the the debug output from a debugger.
+                );
+        }
+
+        HLSLIncludeHandler mIncludeHandler;
+        String mSource;
+        String mFileName;
+        String mEntryPoint;
+        String mTarget;
+        /// Storage of the defines parsed from the preprocessor_defines string
+        String mDefinesBuffer;
+        vector<D3D_SHADER_MACRO>::type mDefinesList;
+        const D3D_SHADER_MACRO* mDefines;
+        UINT mFlags;
+
+        HRESULT mResult;
+        ComPtr<ID3DBlob> mMicroCode;
+        ComPtr<ID3DBlob> mErrors;
+    };
+
     void D3D11HLSLProgram::getDefines(String& stringBuffer, vector<D3D_SHADER_MACRO>::type& defines, const String& definesString)
     {
         // Populate preprocessor defines
@@ -455,34 +495,25 @@ namespace Ogre {
         analizeMicrocode();
     }
     //-----------------------------------------------------------------------
-    void D3D11HLSLProgram::compileMicrocode(void)
+    D3D11HLSLProgram::CompileJob* D3D11HLSLProgram::createCompileJob(void)
     {
-        // If we are running from the cache, we should not be trying to compile/reflect on shaders.
-#if defined(ENABLE_SHADERS_CACHE_LOAD) && (ENABLE_SHADERS_CACHE_LOAD == 1)
-        String message = "Cannot compile/reflect D3D11 shader: " + mName + " in shipping code\n";
-        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, message,
-            "D3D11HLSLProgram::compileMicrocode");
-#else
-#pragma comment(lib, "d3dcompiler.lib")
-
-        // include handler
-        HLSLIncludeHandler includeHandler(this);
+        CompileJob* job = OGRE_NEW CompileJob(this);
+        job->mSource = mSource;
+        job->mFileName = mFilename;
+        job->mEntryPoint = mEntryPoint;
+        job->mTarget = getCompatibleTarget();
 
-        String stringBuffer;
-        vector<D3D_SHADER_MACRO>::type defines;
-        const D3D_SHADER_MACRO* pDefines = NULL;
         if (!shaderMacroSet)
         {
-            getDefines(stringBuffer, defines, mPreprocessorDefines);
-            pDefines = defines.empty() ? NULL : &defines[0];
+            getDefines(job->mDefinesBuffer, job->mDefinesList, mPreprocessorDefines);
+            job->mDefines = job->mDefinesList.empty() ? NULL : &job->mDefinesList[0];
         }
         else
         {
-            pDefines =  mShaderMacros;
+            job->mDefines =  mShaderMacros;
             shaderMacroSet = false;
         }
 
-
         UINT compileFlags=0;
         D3D11RenderSystem* rsys = static_cast<D3D11RenderSystem*>(Root::getSingleton().getRenderSystem());
 #if OGRE_DEBUG_MODE
@@ -507,25 +538,84 @@ namespace Ogre {
         {
             compileFlags |= D3DCOMPILE_ENABLE_BACKWARDS_COMPATIBILITY;
         }
+        job->mFlags = compileFlags;
 
-        const char* target = getCompatibleTarget().c_str();
-
-        ComPtr<ID3DBlob> pMicroCode;
-        ComPtr<ID3DBlob> errors;
-
-        HRESULT hr = D3DCompile(
-            mSource.c_str(),      // [in] Pointer to the shader in memory. 
-            mSource.size(),       // [in] Size of the shader in memory.  
-            mFilename.c_str(),    // [in] Optional. You can use this parameter for strings that specify error messages.
-            pDefines,             // [in] Optional. Pointer to a NULL-terminated array of macro definitions. See D3D_SHADER_MACRO. If not used, set this to NULL. 
-            &includeHandler,      // [in] Optional. Pointer to an ID3DInclude Interface interface for handling include files. Setting this to NULL will cause a compile error if a shader contains a #include. 
-            mEntryPoint.c_str(),  // [in] Name of the shader-entrypoint function where shader execution begins. 
-            target,               // [in] A string that specifies the shader model; can be any profile in shader model 4 or higher. 
-            compileFlags,         // [in] Effect compile flags - no D3DCOMPILE_ENABLE_BACKWARDS_COMPATIBILITY at the first try...
-            NULL,                 // [in] Effect compile flags
-            pMicroCode.GetAddressOf(),// [out] A pointer to an ID3DBlob Interface which contains the compiled shader, as well as any embedded debug and symbol-table information. 
-            errors.GetAddressOf() // [out] A pointer to an ID3DBlob Interface which contains a listing of errors and warnings that occurred during compilation. These errors and warnings are identical to the the debug output from a debugger.
-            );
+        return job;
+    }
+    //-----------------------------------------------------------------------
+    void D3D11HLSLProgram::discardCompileJob(void)
+    {
+        if (mCompileJob)
+        {
+            mCompileJob->complete();
+            mCompileJob.reset();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void D3D11HLSLProgram::prepareImpl(void)
+    {
+        HighLevelGpuProgram::prepareImpl();
+
+#if !defined(ENABLE_SHADERS_CACHE_LOAD) || (ENABLE_SHADERS_CACHE_LOAD == 0)
+        // Macros passed by pointer are owned by the caller, so those compile on load
+        if (mCompileJob || mHighLevelLoaded || shaderMacroSet || !isSupported() ||
+            GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(getNameForMicrocodeCache()))
+        {
+            return;
+        }
+
+        if (mLoadFromFile)
+        {
+            // Leave a missing file for loadHighLevelImpl to report
+            if (!ResourceGroupManager::getSingleton().resourceExists(mGroup, mFilename))
+                return;
+
+            mSource = ResourceGroupManager::getSingleton().openResource(
+                mFilename, mGroup, this)->getAsString();
+        }
+
+        mCompileJob.reset(createCompileJob());
+        ParallelJob::start(mCompileJob);
+#endif
+    }
+    //-----------------------------------------------------------------------
+    void D3D11HLSLProgram::unprepareImpl(void)
+    {
+        discardCompileJob();
+        HighLevelGpuProgram::unprepareImpl();
+    }
+    //-----------------------------------------------------------------------
+    void D3D11HLSLProgram::compileMicrocode(void)
+    {
+        // If we are running from the cache, we should not be trying to compile/reflect on shaders.
+#if defined(ENABLE_SHADERS_CACHE_LOAD) && (ENABLE_SHADERS_CACHE_LOAD == 1)
+        String message = "Cannot compile/reflect D3D11 shader: " + mName + " in shipping code\n";
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, message,
+            "D3D11HLSLProgram::compileMicrocode");
+#else
+#pragma comment(lib, "d3dcompiler.lib")
+
+        // Pick up the compile started by prepareImpl, or compile here
+        ParallelJobPtr jobPtr = mCompileJob;
+        mCompileJob.reset();
+        if (jobPtr)
+        {
+            jobPtr->complete();
+            // The source may have been replaced since the compile was started
+            if (static_cast<CompileJob*>(jobPtr.get())->mSource != mSource)
+                jobPtr.reset();
+        }
+
+        if (!jobPtr)
+        {
+            jobPtr.reset(createCompileJob());
+            jobPtr->process();
+        }
+
+        CompileJob* job = static_cast<CompileJob*>(jobPtr.get());
+        ComPtr<ID3DBlob> pMicroCode = job->mMicroCode;
+        ComPtr<ID3DBlob> errors = job->mErrors;
+        HRESULT hr = job->mResult;
 
 #if 0 // this is how you disassemble
         LPCSTR commentString = NULL;
@@ -642,6 +732,12 @@ namespace Ogre {
                     mD3d11ShaderBufferDescs.push_back(constantBufferDesc);
 
                     mConstantBufferSize += constantBufferDesc.Size;
+
+                    // Variables of a constant buffer named after a shared parameter set are
+                    // read from the buffer of the set, they are not parameters of the program
+                    bool isSharedParamsBuffer =
+                        GpuProgramManager::getSingleton().getAvailableSharedParameters().count(constantBufferDesc.Name) > 0;
+
                     if (v == 0)
                         mD3d11ShaderVariables.resize(constantBufferDesc.Variables);
                     else
@@ -668,7 +764,8 @@ namespace Ogre {
                         varRefType = varRef->GetType();
 
                         // Recursively descend through the structure levels
-                        processParamElement( "", curVar.Name, varRefType);
+                        if (!isSharedParamsBuffer)
+                            processParamElement( "", curVar.Name, varRefType);
                     }
 
                     switch (constantBufferDesc.Type)
@@ -1128,8 +1225,26 @@ namespace Ogre {
                     // Insert buffer info
                     BufferInfoIterator it = mBufferInfoMap.insert(BufferInfo(0, mD3d11ShaderBufferDescs[b].Name)).first;
 
+                    // Constant buffers named after a shared parameter set use the one buffer
+                    // of the set, which is laid out by the first program declaring it
+                    const GpuProgramManager::SharedParametersMap& sharedParamsMap =
+                        GpuProgramManager::getSingleton().getAvailableSharedParameters();
+                    GpuProgramManager::SharedParametersMap::const_iterator sharedParams =
+                        sharedParamsMap.find(mD3d11ShaderBufferDescs[b].Name);
+                    bool layOutSharedParams = false;
+
+                    if (sharedParams != sharedParamsMap.end())
+                    {
+                        mSharedParamsBuffers.push_back(std::make_pair(b, sharedParams->second));
+                        if (!sharedParams->second->_getHardwareBuffer())
+                        {
+                            sharedParams->second->_setHardwareBuffer(HardwareBufferManager::getSingleton().createUniformBuffer(
+                                mD3d11ShaderBufferDescs[b].Size, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false));
+                            layOutSharedParams = true;
+                        }
+                    }
                     // Guard to create uniform buffer only once
-                    if (!it->mUniformBuffer)
+                    else if (!it->mUniformBuffer)
                     {
                         HardwareUniformBufferSharedPtr uBuffer = HardwareBufferManager::getSingleton().createUniformBuffer(mD3d11ShaderBufferDescs[b].Size, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false);
                         it->mUniformBuffer = HardwareUniformBufferSharedPtr(uBuffer);
@@ -1185,6 +1300,16 @@ namespace Ogre {
 
                                     fixVariableNameFromCg(newVar);
                                     it->mShaderVars.push_back(newVar);
+
+                                    if (layOutSharedParams)
+                                    {
+                                        // Array elements start on a new 16 byte register
+                                        const D3D11_SHADER_TYPE_DESC& typeDesc = mD3d11ShaderTypeDescs[typeCount-1];
+                                        UINT registers = typeDesc.Class == D3D_SVC_MATRIX_COLUMNS ? typeDesc.Columns :
+                                            (typeDesc.Class == D3D_SVC_MATRIX_ROWS ? typeDesc.Rows : 1);
+                                        sharedParams->second->_setHardwareBufferOffset(newVar.name, newVar.startOffset,
+                                            typeDesc.Elements > 1 ? registers * 16 : 0);
+                                    }
                                 }
                                 break;
                             };
@@ -1227,8 +1352,11 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void D3D11HLSLProgram::unloadHighLevelImpl(void)
     {
+        discardCompileJob();
+
         mSlotMap.clear();
         mBufferInfoMap.clear();
+        mSharedParamsBuffers.clear();
 
         mVertexShader.Reset();
         mPixelShader.Reset();
@@ -1540,6 +1668,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     D3D11HLSLProgram::~D3D11HLSLProgram()
     {
+        discardCompileJob();
+
         //mConstantBuffer.Reset();
         mBufferInfoMap.clear();
 
@@ -1987,6 +2117,8 @@ namespace Ogre {
                 }
 
                 it->mUniformBuffer->unlock();
+                Root::getSingleton().getRenderSystem()->_getCurrentRenderStats().uniformBytes +=
+                    it->mUniformBuffer->getSizeInBytes();
 
                 return static_cast<D3D11HardwareUniformBuffer*>(it->mUniformBuffer.get())->getD3DConstantBuffer();
             }
@@ -2033,6 +2165,8 @@ namespace Ogre {
                 }
 
                 it->mUniformBuffer->unlock();
+                Root::getSingleton().getRenderSystem()->_getCurrentRenderStats().uniformBytes +=
+                    it->mUniformBuffer->getSizeInBytes();
 
                 // Add buffer to list
                 buffers[numBuffers] = static_cast<D3D11HardwareUniformBuffer*>(it->mUniformBuffer.get())->getD3DConstantBuffer();
@@ -40,8 +40,12 @@ namespace Ogre {
         mpTempStagingBuffer(0),
         mUseTempStagingBuffer(false),
         mBufferType(btype),
-        mDevice(device)
+        mDevice(device),
+        mWrittenSinceDiscard(0),
+        mMappedContext(0)
     {
+        // The typed buffers wrapping this one count their locks already
+        mCountLocks = false;
         mSizeInBytes = sizeBytes;
         mDesc.ByteWidth = static_cast<UINT>(sizeBytes);
         mDesc.CPUAccessFlags = D3D11Mappings::_getAccessFlags(mUsage); 
@@ -139,16 +143,45 @@ namespace Ogre {
 
             // map directly
             D3D11_MAP mapType;
+            mMappedContext = mDevice.GetImmediateContext();
             switch(options)
             {
             case HBL_DISCARD:
                 // To use D3D11_MAP_WRITE_DISCARD resource must have been created with write access and dynamic usage.
-                mapType = mSystemMemory ? D3D11_MAP_WRITE : D3D11_MAP_WRITE_DISCARD;
+                if (mSystemMemory)
+                {
+                    mapType = D3D11_MAP_WRITE;
+                }
+                else if (mDevice.IsRecording())
+                {
+                    // Deferred contexts can only map with D3D11_MAP_WRITE_DISCARD, the new
+                    // contents are then only seen by the draws recorded after this lock
+                    mapType = D3D11_MAP_WRITE_DISCARD;
+                    mMappedContext = mDevice.GetCurrentContext();
+                    mWrittenSinceDiscard = 0;
+                }
+                else if ((mUsage & HBU_DISCARDABLE) && mBufferType != CONSTANT_BUFFER &&
+                         offset >= mWrittenSinceDiscard)
+                {
+                    // Nothing has been written to this range since the last discard, so
+                    // the GPU cannot be using it. Append to the buffer like to a ring
+                    // instead of having the driver rename all of it, and only discard
+                    // again once the locks wrap around. Constant buffers need D3D11.1
+                    // for D3D11_MAP_WRITE_NO_OVERWRITE.
+                    mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+                }
+                else
+                {
+                    mapType = D3D11_MAP_WRITE_DISCARD;
+                    mWrittenSinceDiscard = 0;
+                }
+                mWrittenSinceDiscard = std::max(mWrittenSinceDiscard, offset + length);
                 break;
             case HBL_NO_OVERWRITE:
                 // To use D3D11_MAP_WRITE_NO_OVERWRITE resource must have been created with write access.
                 // TODO: check (mSystemMemory aka D3D11_USAGE_STAGING => D3D11_MAP_WRITE_NO_OVERWRITE) combo - it`s not forbidden by MSDN
                 mapType = mSystemMemory ? D3D11_MAP_WRITE : D3D11_MAP_WRITE_NO_OVERWRITE; 
+                mWrittenSinceDiscard = std::max(mWrittenSinceDiscard, offset + length);
                 break;
             case HBL_NORMAL:
                 mapType = (mDesc.CPUAccessFlags & D3D11_CPU_ACCESS_READ) ? D3D11_MAP_READ_WRITE : D3D11_MAP_WRITE;
@@ -164,7 +197,7 @@ namespace Ogre {
             void * pRet = NULL;
             D3D11_MAPPED_SUBRESOURCE mappedSubResource;
             mappedSubResource.pData = NULL;
-            HRESULT hr = mDevice.GetImmediateContext()->Map(mlpD3DBuffer.Get(), 0, mapType, 0, &mappedSubResource);
+            HRESULT hr = mMappedContext->Map(mlpD3DBuffer.Get(), 0, mapType, 0, &mappedSubResource);
             if (FAILED(hr) || mDevice.isError())
             {
                 String msg = mDevice.getErrorDescription(hr);
@@ -223,7 +256,8 @@ namespace Ogre {
         else
         {
             // unmap
-            mDevice.GetImmediateContext()->Unmap(mlpD3DBuffer.Get(), 0);
+            mMappedContext->Unmap(mlpD3DBuffer.Get(), 0);
+            mMappedContext = 0;
         }
     }
     //---------------------------------------------------------------------
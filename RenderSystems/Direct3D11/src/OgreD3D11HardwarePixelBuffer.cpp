@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "OgreD3D11Texture.h"
 #include "OgreD3D11Device.h"
 #include "OgreD3D11RenderSystem.h"
+#include "OgreD3D11AsyncReadback.h"
 
 #include <algorithm>
 
@@ -401,6 +402,12 @@ namespace Ogre {
     void D3D11HardwarePixelBuffer::blitToMemory(const Box &srcBox, const PixelBox &dst)
     {
         assert(srcBox.getDepth() == 1 && dst.getDepth() == 1);
+        blitToMemoryAsync(srcBox)->fetch(dst);
+    }
+    //-----------------------------------------------------------------------------  
+    AsyncReadbackPtr D3D11HardwarePixelBuffer::blitToMemoryAsync(const Box &srcBox)
+    {
+        assert(srcBox.getDepth() == 1);
 
         //This is a pointer to the texture we're trying to copy
         //Only implemented for 2D at the moment...
@@ -427,10 +434,10 @@ namespace Ogre {
             desc.SampleDesc.Quality = 0;
 
             hr = mDevice->CreateTexture2D(&desc, 0, textureNoMSAA.ReleaseAndGetAddressOf());
-            mDevice.throwIfFailed(hr, "Error creating texture without MSAA", "D3D11HardwarePixelBuffer::blitToMemory");
+            mDevice.throwIfFailed(hr, "Error creating texture without MSAA", "D3D11HardwarePixelBuffer::blitToMemoryAsync");
 
             mDevice.GetImmediateContext()->ResolveSubresource(textureNoMSAA.Get(), srcSubresource, texture, srcSubresource, desc.Format);
-            mDevice.throwIfFailed("Error resolving MSAA subresource", "D3D11HardwarePixelBuffer::blitToMemory");
+            mDevice.throwIfFailed("Error resolving MSAA subresource", "D3D11HardwarePixelBuffer::blitToMemoryAsync");
         }
 
         // Create the staging texture
@@ -446,26 +453,17 @@ namespace Ogre {
             desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
             desc.MiscFlags &= D3D11_RESOURCE_MISC_TEXTURECUBE;
             hr = mDevice->CreateTexture2D(&desc, NULL, stagingTexture.ReleaseAndGetAddressOf());
-            mDevice.throwIfFailed(hr, "Error creating staging texture", "D3D11HardwarePixelBuffer::blitToMemory");
+            mDevice.throwIfFailed(hr, "Error creating staging texture", "D3D11HardwarePixelBuffer::blitToMemoryAsync");
 
             // Copy our texture into the staging texture
             mDevice.GetImmediateContext()->CopySubresourceRegion(
                 stagingTexture.Get(), srcSubresource, srcBoxDx11.left, srcBoxDx11.top, srcBoxDx11.front,
                 textureNoMSAA.Get(), srcSubresource, &srcBoxDx11);
-            mDevice.throwIfFailed("Error while copying to staging texture", "D3D11HardwarePixelBuffer::blitToMemory");
+            mDevice.throwIfFailed("Error while copying to staging texture", "D3D11HardwarePixelBuffer::blitToMemoryAsync");
         }
 
-        // Map the subresource of the staging texture
-        D3D11_MAPPED_SUBRESOURCE mapped = {0};
-        hr = mDevice.GetImmediateContext()->Map(stagingTexture.Get(), srcSubresource, D3D11_MAP_READ, 0, &mapped);
-        mDevice.throwIfFailed(hr, "Error while mapping staging texture", "D3D11HardwarePixelBuffer::blitToMemory");
-        
-        // Read the data out of the texture.
-        PixelBox locked = D3D11Mappings::getPixelBoxWithMapping(srcBoxDx11, desc.Format, mapped);
-        PixelUtil::bulkPixelConversion(locked, dst);
-
-        // Release the staging texture
-        mDevice.GetImmediateContext()->Unmap(stagingTexture.Get(), srcSubresource);
+        // The staging texture is mapped when the data is fetched, by which time the copy is usually done
+        return AsyncReadbackPtr(OGRE_NEW D3D11AsyncReadback(mDevice, stagingTexture, srcSubresource, srcBoxDx11, desc.Format));
     }
 
     //-----------------------------------------------------------------------------  
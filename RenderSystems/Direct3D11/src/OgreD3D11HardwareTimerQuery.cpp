@@ -0,0 +1,147 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreD3D11HardwareTimerQuery.h"
+#include "OgreD3D11RenderSystem.h"
+#include "OgreD3D11Device.h"
+#include "OgreException.h"
+
+namespace Ogre {
+
+    //---------------------------------------------------------------------
+    D3D11TimestampDisjointQuery::D3D11TimestampDisjointQuery( D3D11Device & device ) :
+        mDevice(device),
+        mIsQueryResultStillOutstanding(true)
+    {
+        D3D11_QUERY_DESC queryDesc;
+        queryDesc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+        queryDesc.MiscFlags = 0;
+        const HRESULT hr = mDevice->CreateQuery(&queryDesc, mQuery.ReleaseAndGetAddressOf());
+
+        if (FAILED(hr) || mDevice.isError()) 
+        {   
+            String errorDescription = mDevice.getErrorDescription(hr);
+            OGRE_EXCEPT_EX(Exception::ERR_INTERNAL_ERROR, hr,
+                "Cannot allocate a timestamp disjoint query.\nError Description:" + errorDescription, 
+                "D3D11TimestampDisjointQuery::D3D11TimestampDisjointQuery");
+        }
+
+        mData.Frequency = 0;
+        mData.Disjoint = TRUE;
+        mDevice.GetImmediateContext()->Begin(mQuery.Get());
+    }
+    //---------------------------------------------------------------------
+    D3D11TimestampDisjointQuery::~D3D11TimestampDisjointQuery()
+    {
+    }
+    //---------------------------------------------------------------------
+    void D3D11TimestampDisjointQuery::end()
+    {
+        mDevice.GetImmediateContext()->End(mQuery.Get());
+    }
+    //---------------------------------------------------------------------
+    bool D3D11TimestampDisjointQuery::isStillOutstanding(void)
+    {
+        if (!mIsQueryResultStillOutstanding)
+            return false;
+
+        const HRESULT hr = mDevice.GetImmediateContext()->GetData(mQuery.Get(), &mData, sizeof(mData), 0);
+
+        if (hr == S_FALSE)
+            return true;
+
+        mIsQueryResultStillOutstanding = false;
+        return false;
+    }
+    //---------------------------------------------------------------------
+    UINT64 D3D11TimestampDisjointQuery::getFrequency(void)
+    {
+        // Loop until the data becomes available
+        while (isStillOutstanding())
+            ;
+        return mData.Disjoint ? 0 : mData.Frequency;
+    }
+    //---------------------------------------------------------------------
+    D3D11HardwareTimerQuery::D3D11HardwareTimerQuery( D3D11RenderSystem * renderSystem, D3D11Device & device ) :
+        mRenderSystem(renderSystem),
+        mDevice(device)
+    {
+        D3D11_QUERY_DESC queryDesc;
+        queryDesc.Query = D3D11_QUERY_TIMESTAMP;
+        queryDesc.MiscFlags = 0;
+        const HRESULT hr = mDevice->CreateQuery(&queryDesc, mQuery.ReleaseAndGetAddressOf());
+
+        if (FAILED(hr) || mDevice.isError()) 
+        {   
+            String errorDescription = mDevice.getErrorDescription(hr);
+            OGRE_EXCEPT_EX(Exception::ERR_INTERNAL_ERROR, hr,
+                "Cannot allocate a timestamp query.\nError Description:" + errorDescription, 
+                "D3D11HardwareTimerQuery::D3D11HardwareTimerQuery");
+        }
+    }
+    //---------------------------------------------------------------------
+    D3D11HardwareTimerQuery::~D3D11HardwareTimerQuery()
+    {
+    }
+    //---------------------------------------------------------------------
+    void D3D11HardwareTimerQuery::queryTimestamp(void)
+    {
+        mDisjointQuery = mRenderSystem->_getTimestampDisjointQuery();
+        mDevice.GetImmediateContext()->End(mQuery.Get());
+    }
+    //---------------------------------------------------------------------
+    bool D3D11HardwareTimerQuery::isStillOutstanding(void)
+    {
+        if (mDisjointQuery.isNull())
+            return false;
+
+        UINT64 timestamp;
+        const HRESULT hr = mDevice.GetImmediateContext()->GetData(mQuery.Get(), &timestamp, sizeof(timestamp), 0);
+
+        return hr == S_FALSE || mDisjointQuery->isStillOutstanding();
+    }
+    //---------------------------------------------------------------------
+    bool D3D11HardwareTimerQuery::pullTimestamp(uint64* nanoseconds)
+    {
+        if (mDisjointQuery.isNull())
+            return false;
+
+        // Loop until the data becomes available
+        UINT64 timestamp = 0;
+        while (mDevice.GetImmediateContext()->GetData(mQuery.Get(), &timestamp, sizeof(timestamp), 0) == S_FALSE)
+            ;
+
+        const UINT64 frequency = mDisjointQuery->getFrequency();
+        mDisjointQuery.reset();
+        if (frequency == 0)
+            return false;
+
+        // split up to keep the precision without overflowing
+        *nanoseconds = timestamp / frequency * 1000000000ULL + timestamp % frequency * 1000000000ULL / frequency;
+        return true;
+    }
+}
@@ -295,6 +295,12 @@ namespace Ogre
         case VET_FLOAT4:
             return DXGI_FORMAT_R32G32B32A32_FLOAT;
 
+        // Float16
+        case VET_HALF2:
+            return DXGI_FORMAT_R16G16_FLOAT;
+        case VET_HALF4:
+            return DXGI_FORMAT_R16G16B16A16_FLOAT;
+
         // Signed short
         case VET_SHORT1:
             return DXGI_FORMAT_R16_SINT;
@@ -745,7 +751,8 @@ namespace Ogre
 		}
 
 		return (isRenderTarget ? D3D11_BIND_RENDER_TARGET : 0)
-			| ((usage & TU_NOTSHADERRESOURCE) ? 0 : D3D11_BIND_SHADER_RESOURCE);
+			| ((usage & TU_NOTSHADERRESOURCE) ? 0 : D3D11_BIND_SHADER_RESOURCE)
+			| ((usage & TU_UNORDERED_ACCESS) ? D3D11_BIND_UNORDERED_ACCESS : 0);
 	}
 
     UINT D3D11Mappings::_getTextureMiscFlags(UINT bindflags, TextureType textype, TextureUsage usage)
@@ -46,9 +46,11 @@ THE SOFTWARE.
 #include "OgreD3D11HLSLProgramFactory.h"
 
 #include "OgreD3D11HardwareOcclusionQuery.h"
+#include "OgreD3D11HardwareTimerQuery.h"
 #include "OgreFrustum.h"
 #include "OgreD3D11MultiRenderTarget.h"
 #include "OgreD3D11HLSLProgram.h"
+#include "OgreD3D11HardwareUniformBuffer.h"
 
 #include "OgreD3D11DepthBuffer.h"
 #include "OgreD3D11HardwarePixelBuffer.h"
@@ -831,9 +833,41 @@ namespace Ogre
     //  this->initialise( true );
     }
     //---------------------------------------------------------------------
+    void D3D11RenderSystem::_insertFrameFence(void)
+    {
+        D3D11_QUERY_DESC queryDesc;
+        queryDesc.Query = D3D11_QUERY_EVENT;
+        queryDesc.MiscFlags = 0;
+        ComPtr<ID3D11Query> query;
+        const HRESULT hr = mDevice->CreateQuery(&queryDesc, query.ReleaseAndGetAddressOf());
+        if (FAILED(hr) || mDevice.isError())
+        {
+            String errorDescription = mDevice.getErrorDescription(hr);
+            OGRE_EXCEPT_EX(Exception::ERR_RENDERINGAPI_ERROR, hr,
+                "Cannot create a frame fence query.\nError Description:" + errorDescription,
+                "D3D11RenderSystem::_insertFrameFence");
+        }
+
+        mDevice.GetImmediateContext()->End(query.Get());
+        mFrameFences.push_back(query);
+    }
+    //---------------------------------------------------------------------
+    void D3D11RenderSystem::_waitFrameFences(size_t maxPending)
+    {
+        while (mFrameFences.size() > maxPending)
+        {
+            // Without D3D11_ASYNC_GETDATA_DONOTFLUSH, so the query is sure to be reached
+            while (mDevice.GetImmediateContext()->GetData(mFrameFences.front().Get(), NULL, 0, 0) == S_FALSE)
+                Sleep(0);
+            mFrameFences.pop_front();
+        }
+    }
+    //---------------------------------------------------------------------
     void D3D11RenderSystem::shutdown()
     {
         RenderSystem::shutdown();
+        mTimestampDisjointQuery.reset();
+        mFrameFences.clear();
 
         mRenderSystemWasInited = false;
 
@@ -844,6 +878,8 @@ namespace Ogre
         mDevice.ReleaseAll();
         LogManager::getSingleton().logMessage("D3D11: Shutting down cleanly.");
         SAFE_DELETE( mTextureManager );
+        if (mGpuProgramManager)
+            mGpuProgramManager->_releaseSharedParametersBuffers();
         SAFE_DELETE( mHardwareBufferManager );
         SAFE_DELETE( mGpuProgramManager );
 
@@ -1556,12 +1592,27 @@ namespace Ogre
             }
             */
             // Clean up depth stencil surfaces
+            mDeferredContext.Reset();
+            clearStateObjects();
             mDevice.ReleaseAll();
         }
     }
     //---------------------------------------------------------------------
+    void D3D11RenderSystem::clearStateObjects(void)
+    {
+        mBoundBlendState.Reset();
+        mBoundRasterizer.Reset();
+        mBoundDepthStencilState.Reset();
+        mBlendStates.clear();
+        mRasterizerStates.clear();
+        mDepthStencilStates.clear();
+        mSamplerStates.clear();
+    }
+    //---------------------------------------------------------------------
     void D3D11RenderSystem::createDevice()
     {
+        mDeferredContext.Reset();
+        clearStateObjects();
         mDevice.ReleaseAll();
 
         D3D11Driver* d3dDriver = getDirect3DDrivers(true)->findByName(mDriverName);
@@ -1668,6 +1719,13 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void D3D11RenderSystem::_swapAllRenderTargetBuffers()
     {
+        // the timestamps issued from now on belong to the next frame
+        if (!mTimestampDisjointQuery.isNull())
+        {
+            mTimestampDisjointQuery->end();
+            mTimestampDisjointQuery.reset();
+        }
+
         try
         {
             RenderSystem::_swapAllRenderTargetBuffers();
@@ -2108,11 +2166,14 @@ namespace Ogre
     //---------------------------------------------------------------------
     void D3D11RenderSystem::_setRenderTarget(RenderTarget *target)
     {
+        if (target && target != mActiveRenderTarget)
+            ++mRenderStats.renderTargetSwitches;
+
         mActiveRenderTarget = target;
         if (mActiveRenderTarget)
         {
             // we need to clear the state 
-            mDevice.GetImmediateContext()->ClearState();
+            mDevice.GetCurrentContext()->ClearState();
 
             if (mDevice.isError())
             {
@@ -2155,7 +2216,7 @@ namespace Ogre
             depthBuffer = static_cast<D3D11DepthBuffer*>(target->getDepthBuffer());
 
             // now switch to the new render target
-            mDevice.GetImmediateContext()->OMSetRenderTargets(
+            mDevice.GetCurrentContext()->OMSetRenderTargets(
                 numberOfViews,
                 pRTView,
                 depthBuffer ? depthBuffer->getDepthStencilView() : 0 );
@@ -2206,7 +2267,7 @@ namespace Ogre
             d3dvp.MinDepth = 0.0f;
             d3dvp.MaxDepth = 1.0f;
 
-            mDevice.GetImmediateContext()->RSSetViewports(1, &d3dvp);
+            mDevice.GetCurrentContext()->RSSetViewports(1, &d3dvp);
             if (mDevice.isError())
             {
                 String errorDescription = mDevice.getErrorDescription();
@@ -2273,7 +2334,7 @@ namespace Ogre
             UINT offset = 0; // no stream offset, this is handled in _render instead
             UINT slot = static_cast<UINT>(i->first);
             ID3D11Buffer * pVertexBuffers = d3d11buf->getD3DVertexBuffer();
-            mDevice.GetImmediateContext()->IASetVertexBuffers(
+            mDevice.GetCurrentContext()->IASetVertexBuffers(
                 slot, // The first input slot for binding.
                 1, // The number of vertex buffers in the array.
                 &pVertexBuffers,
@@ -2347,7 +2408,9 @@ namespace Ogre
             mBlendDescChanged = false;
             mBoundBlendState = 0;
 
-            HRESULT hr = mDevice->CreateBlendState(&mBlendDesc, opState->mBlendState.ReleaseAndGetAddressOf()) ;
+            ComPtr<ID3D11BlendState>& blendState = mBlendStates[mBlendDesc];
+            HRESULT hr = blendState ? S_OK : mDevice->CreateBlendState(&mBlendDesc, blendState.ReleaseAndGetAddressOf());
+            opState->mBlendState = blendState;
             if (FAILED(hr))
             {
 				String errorDescription = mDevice.getErrorDescription(hr);
@@ -2366,7 +2429,9 @@ namespace Ogre
 			mRasterizerDescChanged=false;
 			mBoundRasterizer = 0;
 
-            HRESULT hr = mDevice->CreateRasterizerState(&mRasterizerDesc, opState->mRasterizer.ReleaseAndGetAddressOf()) ;
+            ComPtr<ID3D11RasterizerState>& rasterizer = mRasterizerStates[mRasterizerDesc];
+            HRESULT hr = rasterizer ? S_OK : mDevice->CreateRasterizerState(&mRasterizerDesc, rasterizer.ReleaseAndGetAddressOf());
+            opState->mRasterizer = rasterizer;
             if (FAILED(hr))
             {
 				String errorDescription = mDevice.getErrorDescription(hr);
@@ -2385,7 +2450,9 @@ namespace Ogre
 			mBoundDepthStencilState = 0;
 			mDepthStencilDescChanged=false;
 
-            HRESULT hr = mDevice->CreateDepthStencilState(&mDepthStencilDesc, opState->mDepthStencilState.ReleaseAndGetAddressOf()) ;
+            ComPtr<ID3D11DepthStencilState>& depthStencilState = mDepthStencilStates[mDepthStencilDesc];
+            HRESULT hr = depthStencilState ? S_OK : mDevice->CreateDepthStencilState(&mDepthStencilDesc, depthStencilState.ReleaseAndGetAddressOf());
+            opState->mDepthStencilState = depthStencilState;
             if (FAILED(hr))
             {
 				String errorDescription = mDevice.getErrorDescription(hr);
@@ -2422,7 +2489,9 @@ namespace Ogre
                     stage.samplerDesc.MinLOD = -D3D11_FLOAT32_MAX;
                     stage.samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
 
-                    HRESULT hr = mDevice->CreateSamplerState(&stage.samplerDesc, samplerState.ReleaseAndGetAddressOf());
+                    ComPtr<ID3D11SamplerState>& cachedSamplerState = mSamplerStates[stage.samplerDesc];
+                    HRESULT hr = cachedSamplerState ? S_OK : mDevice->CreateSamplerState(&stage.samplerDesc, cachedSamplerState.ReleaseAndGetAddressOf());
+                    samplerState = cachedSamplerState;
                     if (FAILED(hr))
                     {
                         String errorDescription = mDevice.getErrorDescription(hr);
@@ -2444,7 +2513,8 @@ namespace Ogre
         if (opState->mBlendState != mBoundBlendState)
         {
             mBoundBlendState = opState->mBlendState ;
-            mDevice.GetImmediateContext()->OMSetBlendState(opState->mBlendState.Get(), 0, 0xffffffff); // TODO - find out where to get the parameters
+            mDevice.GetCurrentContext()->OMSetBlendState(opState->mBlendState.Get(), 0, 0xffffffff); // TODO - find out where to get the parameters
+            ++mRenderStats.stateChanges;
             if (mDevice.isError())
             {
                 String errorDescription = mDevice.getErrorDescription();
@@ -2455,7 +2525,7 @@ namespace Ogre
             if (mSamplerStatesChanged && mBoundGeometryProgram && mBindingType == TextureUnitState::BT_GEOMETRY)
             {
                 {
-                    mDevice.GetImmediateContext()->GSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
+                    mDevice.GetCurrentContext()->GSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2464,7 +2534,7 @@ namespace Ogre
                             "D3D11RenderSystem::_render");
                     }
                 }
-                mDevice.GetImmediateContext()->GSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
+                mDevice.GetCurrentContext()->GSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -2479,7 +2549,8 @@ namespace Ogre
         {
             mBoundRasterizer = opState->mRasterizer ;
 
-            mDevice.GetImmediateContext()->RSSetState(opState->mRasterizer.Get());
+            mDevice.GetCurrentContext()->RSSetState(opState->mRasterizer.Get());
+            ++mRenderStats.stateChanges;
             if (mDevice.isError())
             {
                 String errorDescription = mDevice.getErrorDescription();
@@ -2494,7 +2565,8 @@ namespace Ogre
         {
             mBoundDepthStencilState = opState->mDepthStencilState ;
 
-            mDevice.GetImmediateContext()->OMSetDepthStencilState(opState->mDepthStencilState.Get(), mStencilRef);
+            mDevice.GetCurrentContext()->OMSetDepthStencilState(opState->mDepthStencilState.Get(), mStencilRef);
+            ++mRenderStats.stateChanges;
             if (mDevice.isError())
             {
                 String errorDescription = mDevice.getErrorDescription();
@@ -2507,10 +2579,11 @@ namespace Ogre
         if (mSamplerStatesChanged && opState->mSamplerStatesCount > 0 ) //  if the NumSamplers is 0, the operation effectively does nothing.
         {
             mSamplerStatesChanged = false; // now it's time to set it to false
+            ++mRenderStats.stateChanges;
             /// Pixel Shader binding
             {
                 {
-                    mDevice.GetImmediateContext()->PSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
+                    mDevice.GetCurrentContext()->PSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2520,7 +2593,7 @@ namespace Ogre
                     }
                 }
 
-                mDevice.GetImmediateContext()->PSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
+                mDevice.GetCurrentContext()->PSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -2535,7 +2608,7 @@ namespace Ogre
             {
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->VSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
+                    mDevice.GetCurrentContext()->VSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2547,7 +2620,7 @@ namespace Ogre
 
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->VSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
+                    mDevice.GetCurrentContext()->VSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2563,7 +2636,7 @@ namespace Ogre
             {
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->CSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
+                    mDevice.GetCurrentContext()->CSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2575,7 +2648,7 @@ namespace Ogre
                 
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->CSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
+                    mDevice.GetCurrentContext()->CSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2591,7 +2664,7 @@ namespace Ogre
             {
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->HSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
+                    mDevice.GetCurrentContext()->HSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2603,7 +2676,7 @@ namespace Ogre
                 
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->HSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
+                    mDevice.GetCurrentContext()->HSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2619,7 +2692,7 @@ namespace Ogre
             {
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->DSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
+                    mDevice.GetCurrentContext()->DSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(opState->mSamplerStatesCount), opState->mSamplerStates[0].GetAddressOf());
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2631,7 +2704,7 @@ namespace Ogre
 
                 if (mFeatureLevel >= D3D_FEATURE_LEVEL_10_0)
                 {
-                    mDevice.GetImmediateContext()->DSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
+                    mDevice.GetCurrentContext()->DSSetShaderResources(static_cast<UINT>(0), static_cast<UINT>(opState->mTexturesCount), &opState->mTextures[0]);
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -2645,7 +2718,7 @@ namespace Ogre
 
         ComPtr<ID3D11Buffer> pSOTarget;
         // Mustn't bind a emulated vertex, pixel shader (see below), if we are rendering to a stream out buffer
-        mDevice.GetImmediateContext()->SOGetTargets(1, pSOTarget.GetAddressOf());
+        mDevice.GetCurrentContext()->SOGetTargets(1, pSOTarget.GetAddressOf());
 
         //check consistency of vertex-fragment shaders
         if (!mBoundVertexProgram ||
@@ -2687,7 +2760,7 @@ namespace Ogre
         // Also, bind shader resources
         if (mBoundVertexProgram)
         {
-            mDevice.GetImmediateContext()->VSSetShader(mBoundVertexProgram->getVertexShader(), 
+            mDevice.GetCurrentContext()->VSSetShader(mBoundVertexProgram->getVertexShader(), 
                                                        mClassInstances[GPT_VERTEX_PROGRAM], 
                                                        mNumClassInstances[GPT_VERTEX_PROGRAM]);
             if (mDevice.isError())
@@ -2700,7 +2773,7 @@ namespace Ogre
         }
         if (mBoundFragmentProgram)
         {
-            mDevice.GetImmediateContext()->PSSetShader(mBoundFragmentProgram->getPixelShader(),
+            mDevice.GetCurrentContext()->PSSetShader(mBoundFragmentProgram->getPixelShader(),
                                                        mClassInstances[GPT_FRAGMENT_PROGRAM], 
                                                        mNumClassInstances[GPT_FRAGMENT_PROGRAM]);
             if (mDevice.isError())
@@ -2713,7 +2786,7 @@ namespace Ogre
         }
         if (mBoundGeometryProgram)
         {
-            mDevice.GetImmediateContext()->GSSetShader(mBoundGeometryProgram->getGeometryShader(),
+            mDevice.GetCurrentContext()->GSSetShader(mBoundGeometryProgram->getGeometryShader(),
                                                        mClassInstances[GPT_GEOMETRY_PROGRAM], 
                                                        mNumClassInstances[GPT_GEOMETRY_PROGRAM]);
             if (mDevice.isError())
@@ -2726,7 +2799,7 @@ namespace Ogre
         }
         if (mBoundTessellationHullProgram)
         {
-            mDevice.GetImmediateContext()->HSSetShader(mBoundTessellationHullProgram->getHullShader(),
+            mDevice.GetCurrentContext()->HSSetShader(mBoundTessellationHullProgram->getHullShader(),
                                                        mClassInstances[GPT_HULL_PROGRAM], 
                                                        mNumClassInstances[GPT_HULL_PROGRAM]);
             if (mDevice.isError())
@@ -2739,7 +2812,7 @@ namespace Ogre
         }
         if (mBoundTessellationDomainProgram)
         {
-            mDevice.GetImmediateContext()->DSSetShader(mBoundTessellationDomainProgram->getDomainShader(),
+            mDevice.GetCurrentContext()->DSSetShader(mBoundTessellationDomainProgram->getDomainShader(),
                                                        mClassInstances[GPT_DOMAIN_PROGRAM], 
                                                        mNumClassInstances[GPT_DOMAIN_PROGRAM]);
             if (mDevice.isError())
@@ -2752,7 +2825,7 @@ namespace Ogre
         }
         if (mBoundComputeProgram)
         {
-            mDevice.GetImmediateContext()->CSSetShader(mBoundComputeProgram->getComputeShader(),
+            mDevice.GetCurrentContext()->CSSetShader(mBoundComputeProgram->getComputeShader(),
                                                        mClassInstances[GPT_COMPUTE_PROGRAM], 
                                                        mNumClassInstances[GPT_COMPUTE_PROGRAM]);
             if (mDevice.isError())
@@ -2777,13 +2850,13 @@ namespace Ogre
         if(mBoundComputeProgram)
         {
             // Bound unordered access views
-            mDevice.GetImmediateContext()->Dispatch(1, 1, 1);
+            mDevice.GetCurrentContext()->Dispatch(1, 1, 1);
 
             ID3D11UnorderedAccessView* views[] = { 0 };
             ID3D11ShaderResourceView* srvs[] = { 0 };
-            mDevice.GetImmediateContext()->CSSetShaderResources( 0, 1, srvs );
-            mDevice.GetImmediateContext()->CSSetUnorderedAccessViews( 0, 1, views, NULL );
-            mDevice.GetImmediateContext()->CSSetShader( NULL, NULL, 0 );
+            mDevice.GetCurrentContext()->CSSetShaderResources( 0, 1, srvs );
+            mDevice.GetCurrentContext()->CSSetUnorderedAccessViews( 0, 1, views, NULL );
+            mDevice.GetCurrentContext()->CSSetShader( NULL, NULL, 0 );
 
             return;
         }
@@ -2860,7 +2933,7 @@ namespace Ogre
             {
                 D3D11HardwareIndexBuffer* d3dIdxBuf = 
                     static_cast<D3D11HardwareIndexBuffer*>(op.indexData->indexBuffer.get());
-                mDevice.GetImmediateContext()->IASetIndexBuffer( d3dIdxBuf->getD3DIndexBuffer(), D3D11Mappings::getFormat(d3dIdxBuf->getType()), 0 );
+                mDevice.GetCurrentContext()->IASetIndexBuffer( d3dIdxBuf->getD3DIndexBuffer(), D3D11Mappings::getFormat(d3dIdxBuf->getType()), 0 );
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -2870,7 +2943,7 @@ namespace Ogre
                 }
             }
 
-            mDevice.GetImmediateContext()->IASetPrimitiveTopology( primType );
+            mDevice.GetCurrentContext()->IASetPrimitiveTopology( primType );
             if (mDevice.isError())
             {
                 String errorDescription = mDevice.getErrorDescription();
@@ -2885,7 +2958,7 @@ namespace Ogre
                 {
                     if(hasInstanceData)
                     {
-                        mDevice.GetImmediateContext()->DrawIndexedInstanced(
+                        mDevice.GetCurrentContext()->DrawIndexedInstanced(
                             static_cast<UINT>(op.indexData->indexCount), 
                             static_cast<UINT>(numberOfInstances), 
                             static_cast<UINT>(op.indexData->indexStart), 
@@ -2894,7 +2967,7 @@ namespace Ogre
                     }
                     else
                     {
-                        mDevice.GetImmediateContext()->DrawIndexed(
+                        mDevice.GetCurrentContext()->DrawIndexed(
                             static_cast<UINT>(op.indexData->indexCount),
                             static_cast<UINT>(op.indexData->indexStart),
                             static_cast<INT>(op.vertexData->vertexStart));
@@ -2904,11 +2977,11 @@ namespace Ogre
                 {
                     if(op.vertexData->vertexCount == -1) // -1 is a sign to use DrawAuto
                     {
-                        mDevice.GetImmediateContext()->DrawAuto();
+                        mDevice.GetCurrentContext()->DrawAuto();
                     }
                     else if(hasInstanceData)
                     {
-                        mDevice.GetImmediateContext()->DrawInstanced(
+                        mDevice.GetCurrentContext()->DrawInstanced(
                             static_cast<UINT>(op.vertexData->vertexCount),
                             static_cast<UINT>(numberOfInstances),
                             static_cast<UINT>(op.vertexData->vertexStart),
@@ -2916,7 +2989,7 @@ namespace Ogre
                     }
                     else
                     {
-                        mDevice.GetImmediateContext()->Draw(
+                        mDevice.GetCurrentContext()->Draw(
                             static_cast<UINT>(op.vertexData->vertexCount),
                             static_cast<UINT>(op.vertexData->vertexStart));
                     }
@@ -2948,9 +3021,9 @@ namespace Ogre
         // Crashy : commented this, 99% sure it's useless but really time consuming
         /*if (true) // for now - clear the render state
         {
-            mDevice.GetImmediateContext()->OMSetBlendState(0, 0, 0xffffffff); 
-            mDevice.GetImmediateContext()->RSSetState(0);
-            mDevice.GetImmediateContext()->OMSetDepthStencilState(0, 0); 
+            mDevice.GetCurrentContext()->OMSetBlendState(0, 0, 0xffffffff); 
+            mDevice.GetCurrentContext()->RSSetState(0);
+            mDevice.GetCurrentContext()->OMSetDepthStencilState(0, 0); 
 //          mDevice->PSSetSamplers(static_cast<UINT>(0), static_cast<UINT>(0), 0);
             
             // Clear class instance storage
@@ -2960,6 +3033,77 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    void D3D11RenderSystem::_dispatchCompute(const Vector3& workgroupDim)
+    {
+        if (!mBoundComputeProgram)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                "A compute program must be bound to dispatch",
+                "D3D11RenderSystem::_dispatchCompute");
+        }
+
+        // Textures sampled by the program, as set up for the pass
+        size_t numberOfSamplers = std::min(mLastTextureUnitState, (size_t)OGRE_MAX_TEXTURE_LAYERS);
+        ID3D11ShaderResourceView* srvs[OGRE_MAX_TEXTURE_LAYERS];
+        ID3D11SamplerState* samplers[OGRE_MAX_TEXTURE_LAYERS];
+        for (size_t n = 0; n < numberOfSamplers; n++)
+        {
+            srvs[n] = NULL;
+            samplers[n] = NULL;
+            sD3DTextureStageDesc & stage = mTexStageDesc[n];
+            if (!stage.used)
+                continue;
+
+            D3D11_SAMPLER_DESC samplerDesc = stage.samplerDesc;
+            samplerDesc.Filter = D3D11Mappings::get(FilterMinification[n], FilterMagnification[n], FilterMips[n], false);
+            samplerDesc.MinLOD = -D3D11_FLOAT32_MAX;
+            samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+
+            ComPtr<ID3D11SamplerState>& cachedSamplerState = mSamplerStates[samplerDesc];
+            HRESULT hr = cachedSamplerState ? S_OK : mDevice->CreateSamplerState(&samplerDesc, cachedSamplerState.ReleaseAndGetAddressOf());
+            if (FAILED(hr))
+            {
+                String errorDescription = mDevice.getErrorDescription(hr);
+                OGRE_EXCEPT_EX(Exception::ERR_RENDERINGAPI_ERROR, hr,
+                    "Failed to create sampler state\nError Description:" + errorDescription,
+                    "D3D11RenderSystem::_dispatchCompute" );
+            }
+            srvs[n] = stage.pTex;
+            samplers[n] = cachedSamplerState.Get();
+        }
+
+        ID3D11DeviceContextN* context = mDevice.GetCurrentContext();
+        if (numberOfSamplers > 0)
+        {
+            context->CSSetSamplers(0, static_cast<UINT>(numberOfSamplers), samplers);
+            context->CSSetShaderResources(0, static_cast<UINT>(numberOfSamplers), srvs);
+        }
+        context->CSSetShader(mBoundComputeProgram->getComputeShader(),
+                             mClassInstances[GPT_COMPUTE_PROGRAM],
+                             mNumClassInstances[GPT_COMPUTE_PROGRAM]);
+
+        // A texture can not be a render target and an unordered access view at once
+        context->OMSetRenderTargets(0, NULL, NULL);
+
+        context->Dispatch(static_cast<UINT>(workgroupDim[0]),
+                          static_cast<UINT>(workgroupDim[1]),
+                          static_cast<UINT>(workgroupDim[2]));
+        if (mDevice.isError())
+        {
+            String errorDescription = mDevice.getErrorDescription();
+            OGRE_EXCEPT(Exception::ERR_RENDERINGAPI_ERROR,
+                "D3D11 device cannot dispatch compute program\nError Description:" + errorDescription,
+                "D3D11RenderSystem::_dispatchCompute");
+        }
+
+        // Free the images and inputs for the draws that follow
+        ID3D11UnorderedAccessView* views[D3D11_PS_CS_UAV_REGISTER_COUNT] = { 0 };
+        ID3D11ShaderResourceView* nullSrvs[OGRE_MAX_TEXTURE_LAYERS] = { 0 };
+        context->CSSetUnorderedAccessViews(0, D3D11_PS_CS_UAV_REGISTER_COUNT, views, NULL);
+        context->CSSetShaderResources(0, OGRE_MAX_TEXTURE_LAYERS, nullSrvs);
+        _setRenderTargetViews();
+    }
+    //---------------------------------------------------------------------
     void D3D11RenderSystem::_renderUsingReadBackAsTexture(unsigned int passNr, Ogre::String variableName, unsigned int StartSlot)
     {
         RenderTarget *target = mActiveRenderTarget;
@@ -2980,7 +3124,7 @@ namespace Ogre
                 D3D11DepthBuffer *depthBuffer = static_cast<D3D11DepthBuffer*>(target->getDepthBuffer());
 
                 // now switch to the new render target
-                mDevice.GetImmediateContext()->OMSetRenderTargets(
+                mDevice.GetCurrentContext()->OMSetRenderTargets(
                     numberOfViews,
                     pRTView,
                     depthBuffer->getDepthStencilView());
@@ -2993,18 +3137,18 @@ namespace Ogre
                         "D3D11RenderSystem::_renderUsingReadBackAsTexture");
                 }
                 
-                mDevice.GetImmediateContext()->ClearDepthStencilView(depthBuffer->getDepthStencilView(), D3D11_CLEAR_DEPTH, 1.0f, 0);
+                mDevice.GetCurrentContext()->ClearDepthStencilView(depthBuffer->getDepthStencilView(), D3D11_CLEAR_DEPTH, 1.0f, 0);
 
                 float ClearColor[4];
                 //D3D11Mappings::get(colour, ClearColor);
                 // Clear all views
                 mActiveRenderTarget->getCustomAttribute( "numberOfViews", &numberOfViews );
                 if( numberOfViews == 1 )
-                    mDevice.GetImmediateContext()->ClearRenderTargetView( pRTView[0], ClearColor );
+                    mDevice.GetCurrentContext()->ClearRenderTargetView( pRTView[0], ClearColor );
                 else
                 {
                     for( uint i = 0; i < numberOfViews; ++i )
-                        mDevice.GetImmediateContext()->ClearRenderTargetView( pRTView[i], ClearColor );
+                        mDevice.GetCurrentContext()->ClearRenderTargetView( pRTView[i], ClearColor );
                 }
 
             }
@@ -3027,12 +3171,12 @@ namespace Ogre
                 D3D11DepthBuffer *depthBuffer = static_cast<D3D11DepthBuffer*>(target->getDepthBuffer());
 
                 // now switch to the new render target
-                mDevice.GetImmediateContext()->OMSetRenderTargets(
+                mDevice.GetCurrentContext()->OMSetRenderTargets(
                     numberOfViews,
                     pRTView,
                     NULL);
 
-                mDevice.GetImmediateContext()->PSSetShaderResources(static_cast<UINT>(StartSlot), 1, mDSTResView.GetAddressOf());
+                mDevice.GetCurrentContext()->PSSetShaderResources(static_cast<UINT>(StartSlot), 1, mDSTResView.GetAddressOf());
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3055,7 +3199,7 @@ namespace Ogre
                 uint numberOfViews;
                 target->getCustomAttribute( "numberOfViews", &numberOfViews );
 
-                mDevice.GetImmediateContext()->PSSetShaderResources(static_cast<UINT>(StartSlot), static_cast<UINT>(numberOfViews), NULL);
+                mDevice.GetCurrentContext()->PSSetShaderResources(static_cast<UINT>(StartSlot), static_cast<UINT>(numberOfViews), NULL);
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3087,7 +3231,7 @@ namespace Ogre
 /*              ID3D11VertexShader * vsShaderToSet = mBoundVertexProgram->getVertexShader();
 
                 // set the shader
-                mDevice.GetImmediateContext()->VSSetShader(vsShaderToSet, NULL, 0);
+                mDevice.GetCurrentContext()->VSSetShader(vsShaderToSet, NULL, 0);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3102,7 +3246,7 @@ namespace Ogre
                 mBoundFragmentProgram = static_cast<D3D11HLSLProgram*>(prg);
 /*              ID3D11PixelShader* psShaderToSet = mBoundFragmentProgram->getPixelShader();
 
-                mDevice.GetImmediateContext()->PSSetShader(psShaderToSet, NULL, 0);
+                mDevice.GetCurrentContext()->PSSetShader(psShaderToSet, NULL, 0);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3117,7 +3261,7 @@ namespace Ogre
                 mBoundGeometryProgram = static_cast<D3D11HLSLProgram*>(prg);
 /*              ID3D11GeometryShader* gsShaderToSet = mBoundGeometryProgram->getGeometryShader();
 
-                mDevice.GetImmediateContext()->GSSetShader(gsShaderToSet, NULL, 0);
+                mDevice.GetCurrentContext()->GSSetShader(gsShaderToSet, NULL, 0);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3133,7 +3277,7 @@ namespace Ogre
                 mBoundTessellationHullProgram = static_cast<D3D11HLSLProgram*>(prg);
 /*              ID3D11HullShader* gsShaderToSet = mBoundTessellationHullProgram->getHullShader();
 
-                mDevice.GetImmediateContext()->HSSetShader(gsShaderToSet, NULL, 0);
+                mDevice.GetCurrentContext()->HSSetShader(gsShaderToSet, NULL, 0);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3149,7 +3293,7 @@ namespace Ogre
                 mBoundTessellationDomainProgram = static_cast<D3D11HLSLProgram*>(prg);
 /*              ID3D11DomainShader* gsShaderToSet = mBoundTessellationDomainProgram->getDomainShader();
 
-                mDevice.GetImmediateContext()->DSSetShader(gsShaderToSet, NULL, 0);
+                mDevice.GetCurrentContext()->DSSetShader(gsShaderToSet, NULL, 0);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3165,7 +3309,7 @@ namespace Ogre
                 mBoundComputeProgram = static_cast<D3D11HLSLProgram*>(prg);
 /*              ID3D11ComputeShader* gsShaderToSet = mBoundComputeProgram->getComputeShader();
 
-                mDevice.GetImmediateContext()->CSSetShader(gsShaderToSet, NULL, 0);
+                mDevice.GetCurrentContext()->CSSetShader(gsShaderToSet, NULL, 0);
                 if (mDevice.isError())
                 {
                     String errorDescription = mDevice.getErrorDescription();
@@ -3191,7 +3335,7 @@ namespace Ogre
                 mActiveVertexGpuProgramParameters.reset();
                 mBoundVertexProgram = NULL;
                 //mDevice->VSSetShader(NULL);
-                mDevice.GetImmediateContext()->VSSetShader(NULL, NULL, 0);
+                mDevice.GetCurrentContext()->VSSetShader(NULL, NULL, 0);
             }
             break;
         case GPT_FRAGMENT_PROGRAM:
@@ -3199,7 +3343,7 @@ namespace Ogre
                 mActiveFragmentGpuProgramParameters.reset();
                 mBoundFragmentProgram = NULL;
                 //mDevice->PSSetShader(NULL);
-                mDevice.GetImmediateContext()->PSSetShader(NULL, NULL, 0);
+                mDevice.GetCurrentContext()->PSSetShader(NULL, NULL, 0);
             }
 
             break;
@@ -3207,28 +3351,28 @@ namespace Ogre
             {
                 mActiveGeometryGpuProgramParameters.reset();
                 mBoundGeometryProgram = NULL;
-                mDevice.GetImmediateContext()->GSSetShader( NULL, NULL, 0 );
+                mDevice.GetCurrentContext()->GSSetShader( NULL, NULL, 0 );
             }
             break;
         case GPT_HULL_PROGRAM:
             {
                 mActiveTessellationHullGpuProgramParameters.reset();
                 mBoundTessellationHullProgram = NULL;
-                mDevice.GetImmediateContext()->HSSetShader( NULL, NULL, 0 );
+                mDevice.GetCurrentContext()->HSSetShader( NULL, NULL, 0 );
             }
             break;
         case GPT_DOMAIN_PROGRAM:
             {
                 mActiveTessellationDomainGpuProgramParameters.reset();
                 mBoundTessellationDomainProgram = NULL;
-                mDevice.GetImmediateContext()->DSSetShader( NULL, NULL, 0 );
+                mDevice.GetCurrentContext()->DSSetShader( NULL, NULL, 0 );
             }
             break;
         case GPT_COMPUTE_PROGRAM:
             {
                 mActiveComputeGpuProgramParameters.reset();
                 mBoundComputeProgram = NULL;
-                mDevice.GetImmediateContext()->CSSetShader( NULL, NULL, 0 );
+                mDevice.GetCurrentContext()->CSSetShader( NULL, NULL, 0 );
             }
             break;
         default:
@@ -3241,9 +3385,8 @@ namespace Ogre
     {
         if (mask & (uint16)GPV_GLOBAL)
         {
-            // TODO: Dx11 supports shared constant buffers, so use them
-            // check the match to constant buffers & use rendersystem data hooks to store
-            // for now, just copy
+            // Shared parameters read from constant buffers of their own are not program
+            // parameters, their buffer is bound below. Only the others are copied here.
             params->_copySharedParams();
         }
 
@@ -3259,7 +3402,7 @@ namespace Ogre
                 if (mBoundVertexProgram)
                 {
                     pBuffers[0] = mBoundVertexProgram->getConstantBuffer(params, mask);
-                    mDevice.GetImmediateContext()->VSSetConstantBuffers( 0, 1, pBuffers );
+                    mDevice.GetCurrentContext()->VSSetConstantBuffers( 0, 1, pBuffers );
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3278,7 +3421,7 @@ namespace Ogre
                 if (mBoundFragmentProgram)
                 {
                     pBuffers[0] = mBoundFragmentProgram->getConstantBuffer(params, mask);
-                    mDevice.GetImmediateContext()->PSSetConstantBuffers( 0, 1, pBuffers );
+                    mDevice.GetCurrentContext()->PSSetConstantBuffers( 0, 1, pBuffers );
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3295,7 +3438,7 @@ namespace Ogre
                 if (mBoundGeometryProgram)
                 {
                     pBuffers[0] = mBoundGeometryProgram->getConstantBuffer(params, mask);
-                    mDevice.GetImmediateContext()->GSSetConstantBuffers( 0, 1, pBuffers );
+                    mDevice.GetCurrentContext()->GSSetConstantBuffers( 0, 1, pBuffers );
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3312,7 +3455,7 @@ namespace Ogre
                 if (mBoundTessellationHullProgram)
                 {
                     pBuffers[0] = mBoundTessellationHullProgram->getConstantBuffer(params, mask);
-                    mDevice.GetImmediateContext()->HSSetConstantBuffers( 0, 1, pBuffers );
+                    mDevice.GetCurrentContext()->HSSetConstantBuffers( 0, 1, pBuffers );
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3329,7 +3472,7 @@ namespace Ogre
                 if (mBoundTessellationDomainProgram)
                 {
                     pBuffers[0] = mBoundTessellationDomainProgram->getConstantBuffer(params, mask);
-                    mDevice.GetImmediateContext()->DSSetConstantBuffers( 0, 1, pBuffers );
+                    mDevice.GetCurrentContext()->DSSetConstantBuffers( 0, 1, pBuffers );
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3346,7 +3489,7 @@ namespace Ogre
                 if (mBoundComputeProgram)
                 {
                     pBuffers[0] = mBoundComputeProgram->getConstantBuffer(params, mask);
-                    mDevice.GetImmediateContext()->CSSetConstantBuffers( 0, 1, pBuffers );
+                    mDevice.GetCurrentContext()->CSSetConstantBuffers( 0, 1, pBuffers );
                     if (mDevice.isError())
                     {
                         String errorDescription = mDevice.getErrorDescription();
@@ -3360,6 +3503,8 @@ namespace Ogre
             break;
         };
 
+        bindSharedParamsBuffers(gptype);
+
         // Now, set class instances
         const GpuProgramParameters::SubroutineMap& subroutineMap = params->getSubroutineMap();
         if (subroutineMap.empty())
@@ -3373,6 +3518,46 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    void D3D11RenderSystem::bindSharedParamsBuffers(GpuProgramType gptype)
+    {
+        D3D11HLSLProgram* program = NULL;
+        switch(gptype)
+        {
+        case GPT_VERTEX_PROGRAM: program = mBoundVertexProgram; break;
+        case GPT_FRAGMENT_PROGRAM: program = mBoundFragmentProgram; break;
+        case GPT_GEOMETRY_PROGRAM: program = mBoundGeometryProgram; break;
+        case GPT_HULL_PROGRAM: program = mBoundTessellationHullProgram; break;
+        case GPT_DOMAIN_PROGRAM: program = mBoundTessellationDomainProgram; break;
+        case GPT_COMPUTE_PROGRAM: program = mBoundComputeProgram; break;
+        }
+        if (!program)
+            return;
+
+        ID3D11DeviceContextN* context = mDevice.GetCurrentContext();
+        const D3D11HLSLProgram::SharedParamsBufferList& sharedParamsBuffers = program->getSharedParamsBuffers();
+        for (D3D11HLSLProgram::SharedParamsBufferList::const_iterator i = sharedParamsBuffers.begin();
+             i != sharedParamsBuffers.end(); ++i)
+        {
+            // Uploaded once per change for every program reading it
+            GpuSharedParameters* sharedParams = i->second.get();
+            if (!sharedParams->_getHardwareBuffer())
+                continue;
+            sharedParams->_updateHardwareBuffer();
+
+            ID3D11Buffer* buffer = static_cast<D3D11HardwareUniformBuffer*>(
+                sharedParams->_getHardwareBuffer().get())->getD3DConstantBuffer();
+            switch(gptype)
+            {
+            case GPT_VERTEX_PROGRAM: context->VSSetConstantBuffers(i->first, 1, &buffer); break;
+            case GPT_FRAGMENT_PROGRAM: context->PSSetConstantBuffers(i->first, 1, &buffer); break;
+            case GPT_GEOMETRY_PROGRAM: context->GSSetConstantBuffers(i->first, 1, &buffer); break;
+            case GPT_HULL_PROGRAM: context->HSSetConstantBuffers(i->first, 1, &buffer); break;
+            case GPT_DOMAIN_PROGRAM: context->DSSetConstantBuffers(i->first, 1, &buffer); break;
+            case GPT_COMPUTE_PROGRAM: context->CSSetConstantBuffers(i->first, 1, &buffer); break;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     void D3D11RenderSystem::bindGpuProgramPassIterationParameters(GpuProgramType gptype)
     {
 
@@ -3506,7 +3691,7 @@ namespace Ogre
         mScissorRect.right = static_cast<LONG>(right);
         mScissorRect.bottom =static_cast<LONG>( bottom);
 
-        mDevice.GetImmediateContext()->RSSetScissorRects(1, &mScissorRect);
+        mDevice.GetCurrentContext()->RSSetScissorRects(1, &mScissorRect);
         if (mDevice.isError())
         {
             String errorDescription = mDevice.getErrorDescription();
@@ -3536,11 +3721,11 @@ namespace Ogre
                 uint numberOfViews;
                 mActiveRenderTarget->getCustomAttribute( "numberOfViews", &numberOfViews );
                 if( numberOfViews == 1 )
-                    mDevice.GetImmediateContext()->ClearRenderTargetView( pRTView[0], ClearColor );
+                    mDevice.GetCurrentContext()->ClearRenderTargetView( pRTView[0], ClearColor );
                 else
                 {
                     for( uint i = 0; i < numberOfViews; ++i )
-                        mDevice.GetImmediateContext()->ClearRenderTargetView( pRTView[i], ClearColor );
+                        mDevice.GetCurrentContext()->ClearRenderTargetView( pRTView[i], ClearColor );
                 }
 
             }
@@ -3560,7 +3745,7 @@ namespace Ogre
                                                                                         getDepthBuffer());
                 if( depthBuffer )
                 {
-                    mDevice.GetImmediateContext()->ClearDepthStencilView(
+                    mDevice.GetCurrentContext()->ClearDepthStencilView(
                                                         depthBuffer->getDepthStencilView(),
                                                         ClearFlags, depth, static_cast<UINT8>(stencil) );
                 }
@@ -3623,6 +3808,20 @@ namespace Ogre
         return ret;
     }
     //---------------------------------------------------------------------
+    HardwareTimerQuery* D3D11RenderSystem::createHardwareTimerQuery(void)
+    {
+        D3D11HardwareTimerQuery* ret = new D3D11HardwareTimerQuery (this, mDevice); 
+        mHwTimerQueries.push_back(ret);
+        return ret;
+    }
+    //---------------------------------------------------------------------
+    const D3D11TimestampDisjointQueryPtr& D3D11RenderSystem::_getTimestampDisjointQuery(void)
+    {
+        if (mTimestampDisjointQuery.isNull())
+            mTimestampDisjointQuery.reset(new D3D11TimestampDisjointQuery(mDevice));
+        return mTimestampDisjointQuery;
+    }
+    //---------------------------------------------------------------------
     Real D3D11RenderSystem::getHorizontalTexelOffset(void)
     {
         // D3D11 is now like GL
@@ -3943,4 +4142,63 @@ namespace Ogre
         }
 #endif
     }
+    //---------------------------------------------------------------------
+    void D3D11RenderSystem::_resetBoundState()
+    {
+        mBoundBlendState.Reset();
+        mBoundRasterizer.Reset();
+        mBoundDepthStencilState.Reset();
+        mBlendDescChanged = true;
+        mRasterizerDescChanged = true;
+        mDepthStencilDescChanged = true;
+        mSamplerStatesChanged = true;
+
+        // render target and viewport are not set again unless they change
+        Viewport* vp = mActiveViewport;
+        mActiveViewport = NULL;
+        if (vp)
+            _setViewport(vp);
+    }
+    //---------------------------------------------------------------------
+    bool D3D11RenderSystem::beginCommandRecording()
+    {
+        assert(!mDevice.IsRecording() && "Command recording already started");
+
+        if (!mDeferredContext)
+        {
+            mDeferredContext = mDevice.CreateDeferredContext();
+            if (!mDeferredContext)
+                return false;
+        }
+
+        mDevice.SetRecordingContext(mDeferredContext.Get());
+        _resetBoundState();
+        return true;
+    }
+    //---------------------------------------------------------------------
+    ComPtr<ID3D11CommandList> D3D11RenderSystem::endCommandRecording()
+    {
+        assert(mDevice.IsRecording() && "Command recording not started");
+
+        ComPtr<ID3D11CommandList> commandList;
+        HRESULT hr = mDeferredContext->FinishCommandList(FALSE, commandList.GetAddressOf());
+        mDevice.SetRecordingContext(NULL);
+        if (FAILED(hr))
+        {
+            String errorDescription = mDevice.getErrorDescription(hr);
+            OGRE_EXCEPT_EX(Exception::ERR_RENDERINGAPI_ERROR, hr,
+                "D3D11 device cannot finish command list\nError Description:" + errorDescription,
+                "D3D11RenderSystem::endCommandRecording");
+        }
+
+        _resetBoundState();
+        return commandList;
+    }
+    //---------------------------------------------------------------------
+    void D3D11RenderSystem::executeCommandList(ID3D11CommandList* commandList)
+    {
+        // the context is left in its default state afterwards
+        mDevice.GetCurrentContext()->ExecuteCommandList(commandList, FALSE);
+        _resetBoundState();
+    }
 }
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "OgreViewport.h"
 #include "OgreLogManager.h"
 #include "OgreHardwarePixelBuffer.h"
+#include "OgreD3D11AsyncReadback.h"
 #if OGRE_NO_QUAD_BUFFER_STEREO == 0
 #include "OgreD3D11StereoDriverBridge.h"
 #endif
@@ -317,14 +318,25 @@ namespace Ogre
     //---------------------------------------------------------------------
     void D3D11RenderWindowBase::copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer)
     {
-        if(src.right > mWidth || src.bottom > mHeight || src.front != 0 || src.back != 1
-        || dst.getWidth() != src.getWidth() || dst.getHeight() != dst.getHeight() || dst.getDepth() != 1)
+        if(dst.getWidth() != src.getWidth() || dst.getHeight() != src.getHeight() || dst.getDepth() != 1)
         {
             OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box.", "D3D11RenderWindowBase::copyContentsToMemory");
         }
 
+        AsyncReadbackPtr readback = copyContentsToMemoryAsync(src, buffer);
+        if(readback)
+            readback->fetch(dst);
+    }
+    //---------------------------------------------------------------------
+    AsyncReadbackPtr D3D11RenderWindowBase::copyContentsToMemoryAsync(const Box& src, FrameBuffer buffer)
+    {
+        if(src.right > mWidth || src.bottom > mHeight || src.front != 0 || src.back != 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box.", "D3D11RenderWindowBase::copyContentsToMemoryAsync");
+        }
+
         if(!mpBackBuffer)
-            return;
+            return AsyncReadbackPtr();
 
         // get the backbuffer desc
         D3D11_TEXTURE2D_DESC BBDesc;
@@ -342,7 +354,7 @@ namespace Ogre
         {
             backbufferNoMSAA = mpBackBufferNoMSAA;
             mDevice.GetImmediateContext()->ResolveSubresource(backbufferNoMSAA.Get(), 0, mpBackBuffer.Get(), 0, BBDesc.Format);
-            mDevice.throwIfFailed("Error resolving MSAA subresource", "D3D11RenderWindowBase::copyContentsToMemory");
+            mDevice.throwIfFailed("Error resolving MSAA subresource", "D3D11RenderWindowBase::copyContentsToMemoryAsync");
         }
         else
         {
@@ -354,10 +366,10 @@ namespace Ogre
             desc.CPUAccessFlags = 0;
 
             HRESULT hr = mDevice->CreateTexture2D(&desc, NULL, backbufferNoMSAA.ReleaseAndGetAddressOf());
-            mDevice.throwIfFailed(hr, "Error creating texture without MSAA", "D3D11RenderWindowBase::copyContentsToMemory");
+            mDevice.throwIfFailed(hr, "Error creating texture without MSAA", "D3D11RenderWindowBase::copyContentsToMemoryAsync");
 
             mDevice.GetImmediateContext()->ResolveSubresource(backbufferNoMSAA.Get(), 0, mpBackBuffer.Get(), 0, BBDesc.Format);
-            mDevice.throwIfFailed("Error resolving MSAA subresource", "D3D11RenderWindowBase::copyContentsToMemory");
+            mDevice.throwIfFailed("Error resolving MSAA subresource", "D3D11RenderWindowBase::copyContentsToMemoryAsync");
         }
 
         // change the parameters of the texture so we can read it
@@ -370,25 +382,16 @@ namespace Ogre
         // Create the staging texture
         ComPtr<ID3D11Texture2D> stagingTexture;
         HRESULT hr = mDevice->CreateTexture2D(&BBDesc, NULL, stagingTexture.ReleaseAndGetAddressOf());
-        mDevice.throwIfFailed(hr, "Error creating staging texture", "D3D11RenderWindowBase::copyContentsToMemory");
+        mDevice.throwIfFailed(hr, "Error creating staging texture", "D3D11RenderWindowBase::copyContentsToMemoryAsync");
 
         // Copy the back buffer into the staging texture
         mDevice.GetImmediateContext()->CopySubresourceRegion(
             stagingTexture.Get(), srcSubresource, srcBoxDx11.left, srcBoxDx11.top, srcBoxDx11.front,
             backbufferNoMSAA.Get(), srcSubresource, &srcBoxDx11);
-        mDevice.throwIfFailed("Error while copying to staging texture", "D3D11RenderWindowBase::copyContentsToMemory");
-
-        // Map the subresource of the staging texture
-        D3D11_MAPPED_SUBRESOURCE mapped = {0};
-        hr = mDevice.GetImmediateContext()->Map(stagingTexture.Get(), srcSubresource, D3D11_MAP_READ, 0, &mapped);
-        mDevice.throwIfFailed(hr, "Error while mapping staging texture", "D3D11RenderWindowBase::copyContentsToMemory");
-
-        // Read the data out of the texture
-        PixelBox locked = D3D11Mappings::getPixelBoxWithMapping(srcBoxDx11, BBDesc.Format, mapped);
-        PixelUtil::bulkPixelConversion(locked, dst);
+        mDevice.throwIfFailed("Error while copying to staging texture", "D3D11RenderWindowBase::copyContentsToMemoryAsync");
 
-        // Release the staging texture
-        mDevice.GetImmediateContext()->Unmap(stagingTexture.Get(), srcSubresource);
+        // The staging texture is mapped when the data is fetched, by which time the copy is usually done
+        return AsyncReadbackPtr(OGRE_NEW D3D11AsyncReadback(mDevice, stagingTexture, srcSubresource, srcBoxDx11, BBDesc.Format));
     }
 	//---------------------------------------------------------------------
 #if OGRE_NO_QUAD_BUFFER_STEREO == 0
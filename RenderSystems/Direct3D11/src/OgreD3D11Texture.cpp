@@ -51,7 +51,10 @@ namespace Ogre
         ManualResourceLoader* loader, D3D11Device & device)
         :Texture(creator, name, handle, group, isManual, loader),
         mDevice(device), 
-        mAutoMipMapGeneration(false)
+        mAutoMipMapGeneration(false),
+        mUnorderedAccessFormat(DXGI_FORMAT_UNKNOWN),
+        mUnorderedAccessMip(0),
+        mUnorderedAccessSlice(0)
     {
         mFSAAType.Count = 1;
         mFSAAType.Quality = 0;
@@ -122,6 +125,68 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    void D3D11Texture::createShaderAccessPoint(uint bindPoint, TextureAccess access,
+        int mipmapLevel, int textureArrayIndex, PixelFormat* format)
+    {
+        if (!(mUsage & TU_UNORDERED_ACCESS))
+        {
+            OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
+                "Texture '" + mName + "' was not created with TU_UNORDERED_ACCESS", 
+                "D3D11Texture::createShaderAccessPoint" );
+        }
+
+        DXGI_FORMAT viewFormat = format ? D3D11Mappings::_getPF(*format) : mSRVDesc.Format;
+
+        // The view is kept until another mip, slice or format is asked for
+        if (!mpUnorderedAccessView || mUnorderedAccessFormat != viewFormat ||
+            mUnorderedAccessMip != mipmapLevel || mUnorderedAccessSlice != textureArrayIndex)
+        {
+            D3D11_UNORDERED_ACCESS_VIEW_DESC desc;
+            ZeroMemory(&desc, sizeof(desc));
+            desc.Format = viewFormat;
+
+            switch (getTextureType())
+            {
+            case TEX_TYPE_1D:
+                desc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE1D;
+                desc.Texture1D.MipSlice = mipmapLevel;
+                break;
+            case TEX_TYPE_3D:
+                desc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE3D;
+                desc.Texture3D.MipSlice = mipmapLevel;
+                desc.Texture3D.FirstWSlice = 0;
+                desc.Texture3D.WSize = static_cast<UINT>(-1);
+                break;
+            case TEX_TYPE_CUBE_MAP:
+            case TEX_TYPE_2D_ARRAY:
+                desc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2DARRAY;
+                desc.Texture2DArray.MipSlice = mipmapLevel;
+                desc.Texture2DArray.FirstArraySlice = textureArrayIndex;
+                desc.Texture2DArray.ArraySize = 1;
+                break;
+            default:
+                desc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
+                desc.Texture2D.MipSlice = mipmapLevel;
+                break;
+            }
+
+            HRESULT hr = mDevice->CreateUnorderedAccessView(mpTex.Get(), &desc, mpUnorderedAccessView.ReleaseAndGetAddressOf());
+            if (FAILED(hr) || mDevice.isError())
+            {
+                String errorDescription = mDevice.getErrorDescription(hr);
+                OGRE_EXCEPT_EX(Exception::ERR_RENDERINGAPI_ERROR, hr,
+                    "D3D11 device cannot create unordered access view\nError Description:" + errorDescription,
+                    "D3D11Texture::createShaderAccessPoint");
+            }
+
+            mUnorderedAccessFormat = viewFormat;
+            mUnorderedAccessMip = mipmapLevel;
+            mUnorderedAccessSlice = textureArrayIndex;
+        }
+
+        mDevice.GetCurrentContext()->CSSetUnorderedAccessViews(bindPoint, 1, mpUnorderedAccessView.GetAddressOf(), NULL);
+    }
+    //---------------------------------------------------------------------
     void D3D11Texture::loadImage( const Image &img )
     {
         // Use OGRE its own codecs
@@ -169,6 +234,7 @@ namespace Ogre
         mSurfaceList.clear();
         mpTex.Reset();
         mpShaderResourceView.Reset();
+        mpUnorderedAccessView.Reset();
         mp1DTex.Reset();
         mp2DTex.Reset();
         mp3DTex.Reset();
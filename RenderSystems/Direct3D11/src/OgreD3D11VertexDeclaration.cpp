@@ -186,7 +186,7 @@ namespace Ogre {
     {
         // Set the input layout
         ID3D11InputLayout*  pVertexLayout = getILayoutByShader(boundVertexProgram, binding);
-        mlpD3DDevice.GetImmediateContext()->IASetInputLayout( pVertexLayout);
+        mlpD3DDevice.GetCurrentContext()->IASetInputLayout( pVertexLayout);
     }   
 }
 
@@ -575,6 +575,12 @@ namespace Ogre
         case VET_USHORT4_NORM:
             // valid only with vertex shaders >= 2.0
             return D3DDECLTYPE_USHORT4N;
+        case VET_HALF2:
+            // valid only with vertex shaders >= 2.0
+            return D3DDECLTYPE_FLOAT16_2;
+        case VET_HALF4:
+            // valid only with vertex shaders >= 2.0
+            return D3DDECLTYPE_FLOAT16_4;
         }
         // to keep compiler happy
         return D3DDECLTYPE_FLOAT3;
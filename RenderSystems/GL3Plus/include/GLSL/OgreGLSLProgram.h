@@ -57,6 +57,46 @@ namespace Ogre {
 
     typedef vector<GLAtomicCounterReference>::type GLAtomicCounterReferenceList;
     typedef GLAtomicCounterReferenceList::iterator GLAtomicCounterReferenceIterator;
+
+    /** Structure used to keep track of the uniforms of the packed uniform
+        block (see GLSLProgramManagerCommon::PACKED_UNIFORM_BLOCK_NAME) in
+        the linked program object.  Same as GLUniformReference, but the
+        uniform is located by its layout in the block instead.
+    */
+    struct GLPackedUniformReference
+    {
+        /// Byte offset of the uniform in the block
+        GLint mOffset;
+        /// Byte distance between array elements
+        GLint mArrayStride;
+        /// Byte distance between the columns, or rows, of a matrix
+        GLint mMatrixStride;
+        /// Whether a matrix is stored by rows in the block
+        bool mRowMajor;
+        /// Which type of program params will this value come from?
+        GpuProgramType mSourceProgType;
+        /// The constant definition it relates to
+        const GpuConstantDefinition* mConstantDef;
+    };
+
+    typedef vector<GLPackedUniformReference>::type GLPackedUniformReferenceList;
+    typedef GLPackedUniformReferenceList::iterator GLPackedUniformReferenceIterator;
+
+    /** Structure used to keep track of a sampler uniform that is assigned
+        texture handles (GL_ARB_bindless_texture) instead of texture units.
+    */
+    struct GLBindlessSamplerReference
+    {
+        /// GL location of the sampler uniform
+        GLint mLocation;
+        /// Texture unit the params assign to the sampler, or -1 if not yet known
+        GLint mUnit;
+        /// Handle last assigned to the uniform
+        GLuint64 mHandle;
+    };
+
+    typedef vector<GLBindlessSamplerReference>::type GLBindlessSamplerReferenceList;
+    typedef GLBindlessSamplerReferenceList::iterator GLBindlessSamplerReferenceIterator;
     typedef map<GpuSharedParametersPtr, HardwareUniformBufferSharedPtr>::type SharedParamsBufferMap;
     typedef vector<HardwareCounterBufferSharedPtr>::type GLCounterBufferList;
     typedef GLCounterBufferList::iterator GLCounterBufferIterator;
@@ -85,10 +125,42 @@ namespace Ogre {
         GLSLShader* getComputeShader() const { return mComputeShader; }
 
         void setTransformFeedbackVaryings(const std::vector<String>& nameStrings);
+
+        /// Whether the program has a packed uniform block
+        bool hasPackedUniforms(void) const { return !mPackedUniformData.empty(); }
+        /// Whether the packed uniforms changed since they were last bound
+        bool _getPackedUniformsDirty(void) const { return mPackedUniformsDirty; }
+        /** Uploads the packed uniform block, if it changed or another program
+            bound its own since, and binds its buffer range. Called by the
+            render system just before drawing.
+        */
+        void _bindPackedUniforms(void);
+
+        /// Whether the samplers of the program are declared with layout(bindless_sampler)
+        bool hasBindlessSamplers(void) const { return !mGLBindlessSamplerReferences.empty(); }
+        /// Whether any sampler would be assigned another handle by _bindBindlessSamplers
+        bool _getBindlessSamplersDirty(const GLuint64* unitHandles) const;
+        /** Assigns each sampler the handle of the texture of its unit.
+        @param unitHandles Texture handle per texture unit, 0 for none
+        */
+        void _bindBindlessSamplers(const GLuint64* unitHandles);
     protected:
         /// Container of atomic counter uniform references that are active in the program object
         GLAtomicCounterReferenceList mGLAtomicCounterReferences;
-        /// Map of shared parameter blocks to uniform buffer references
+        /// Container of uniform references that are packed into the packed uniform block
+        GLPackedUniformReferenceList mGLPackedUniformReferences;
+        /// Contents of the packed uniform block, uploaded in one piece when they change
+        vector<uint8>::type mPackedUniformData;
+        bool mPackedUniformsDirty;
+        /// Buffer the packed uniforms are uploaded to without a ring buffer to allocate from
+        GLuint mPackedUniformBuffer;
+        /// Program whose packed uniforms are currently bound
+        static GLSLProgram* msPackedUniformsProgram;
+        /// Container of the sampler uniforms which take texture handles
+        GLBindlessSamplerReferenceList mGLBindlessSamplerReferences;
+        /** Map of shared parameter blocks to their buffers. Uniform blocks use
+            the buffer of the shared parameters, shared by all programs.
+        */
         SharedParamsBufferMap mSharedParamsBufferMap;
         /// Container of counter buffer references that are active in the program object
         GLCounterBufferList mGLCounterBufferReferences;
@@ -105,6 +177,31 @@ namespace Ogre {
         GLSLShader* mComputeShader;
 
         Ogre::String getCombinedName(void);
+        /** Name of the linked binary in the microcode cache.
+        @remarks
+            Made of a hash of the shader sources and the driver strings, so
+            a cached binary is not used once either of them changes.
+        @param shader Only take this shader into account, for separable programs
+        */
+        String getBinaryCacheName(GLSLShader* shader = NULL);
+        /** Copies the values of the packed uniforms which come from the
+            given program type into the packed uniform block.
+        @param transpose Whether matrices are stored by rows in params
+        */
+        void updatePackedUniforms(GpuProgramParametersSharedPtr params, uint16 mask,
+                                  GpuProgramType fromProgType, bool transpose);
+        /// Copies the pass iteration number into the packed uniform block, if it is in it
+        bool updatePackedPassIterationUniform(GpuProgramParametersSharedPtr params);
+        /** Uploads the shared parameters the uniform and shader storage blocks
+            of the program read from, if they changed, and binds their buffers.
+        */
+        void updateSharedParamsBuffers(void);
+        /** Adds the sampler uniforms to the bindless samplers, if any shader
+            of the program declares its samplers with layout(bindless_sampler)
+        */
+        void buildBindlessSamplerReferences(void);
+        /// Records the texture unit of a bindless sampler, returns false if it is not one
+        bool setBindlessSamplerUnit(GLint location, GLint unit);
         /// Get the the binary data of a program from the microcode cache
         void getMicrocodeFromCache(void);
     };
@@ -49,6 +49,9 @@ namespace Ogre {
 
         GL3PlusRenderSystem* mRenderSystem;
 
+        /// Uniform buffer binding points given to shared parameters so far
+        GLuint mSharedParamsBindings;
+
         /**  Convert GL uniform size and type to OGRE constant types
              and associate uniform definitions together. */
         void convertGLUniformtoOgreType(GLenum gltype,
@@ -83,6 +86,15 @@ namespace Ogre {
             //GLShaderStorageBufferList& shaderStorageBufferList,
             GLCounterBufferList& counterBufferList);
 
+        /** Populate a list of the uniforms of the packed uniform block based
+            on an OpenGL program object, and bind the block.
+            @return The size of the block, or 0 if the program has none.
+        */
+        size_t extractPackedUniformsFromProgram(
+            GLuint programObject,
+            const GpuConstantDefinitionMap* (&constantDefs)[6],
+            GLPackedUniformReferenceList& packedUniformList);
+
         GL3PlusStateCacheManager* getStateCacheManager();
     };
 
@@ -87,6 +87,19 @@ namespace Ogre {
         /// Compile source into shader object
         bool compile( bool checkErrors = false);
 
+        /** Start compiling the source without waiting for the result.
+        @remarks
+            Called when loading if the driver compiles in the background. compile
+            then only waits for what is left of the work and checks the result.
+        */
+        void submitCompile(void);
+
+        /** Whether a submitted compilation has finished, so compile would not block.
+        @remarks
+            Always true unless the driver supports GL_KHR_parallel_shader_compile.
+        */
+        bool isCompileComplete(void);
+
 
         /// Bind the shader in OpenGL.
         void bind(void);
@@ -126,6 +139,9 @@ namespace Ogre {
         */
         void checkAndFixInvalidDefaultPrecisionError( String &message );
 
+        /// Preprocess the source and submit its compilation
+        void loadFromSource(void);
+
 
         // /// @copydoc Resource::loadImpl
         // void loadImpl(void) {}
@@ -135,6 +151,8 @@ namespace Ogre {
         GLuint mGLShaderHandle;
         /// GL handle for program object the shader is bound to.
         GLuint mGLProgramHandle;
+        /// Whether glCompileShader was called and its status not checked yet
+        bool mCompileSubmitted;
     };
 }
 
@@ -0,0 +1,71 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __GL3PlusASYNCREADBACK_H__
+#define __GL3PlusASYNCREADBACK_H__
+
+#include "OgreGL3PlusPrerequisites.h"
+#include "OgreAsyncReadback.h"
+
+namespace Ogre {
+
+    /** Readback of pixels into a pixel pack buffer, fenced so that fetching
+        them only waits if the GPU has not got to them yet.
+    */
+    class _OgreGL3PlusExport GL3PlusAsyncReadback : public AsyncReadback
+    {
+    public:
+        /** Creates the buffer and binds it to GL_PIXEL_PACK_BUFFER, for the
+            pixels to be read into at offset 0 before calling fence.
+        @param layout
+            Size and format of the pixels read into the buffer
+        @param box
+            Region of the pixels read that is fetched
+        @param flip
+            Whether the rows are read bottom up, as from the default framebuffer
+        */
+        GL3PlusAsyncReadback(GL3PlusRenderSystem* renderSystem, const PixelBox& layout,
+                             const Box& box, bool flip);
+        ~GL3PlusAsyncReadback();
+
+        /// Fences the reads issued into the buffer and unbinds it
+        void fence(void);
+
+        bool isReady(void);
+        void fetch(const PixelBox& dst);
+
+    protected:
+        GL3PlusRenderSystem* mRenderSystem;
+        GLuint mBufferId;
+        GLsync mSync;
+        PixelBox mLayout;
+        Box mBox;
+        bool mFlip;
+    };
+}
+
+#endif
@@ -42,8 +42,22 @@ namespace Ogre {
         GLuint mBufferId;
         GL3PlusRenderSystem* mRenderSystem;
 
+        /// Whether the current lock is staged in the render system's ring buffer
+        bool mLockStaged;
+        /// Offset of the current lock in the buffer and in the ring buffer
+        size_t mLockOffset;
+        size_t mStagingOffset;
+
         /// Utility function to get the correct GL usage based on HBU's
         static GLenum getGLUsage(uint32 usage);
+
+        /** Returns the ring buffer to stage an update of length bytes in, or
+            NULL if it is to be written to the buffer directly.
+        */
+        GL3PlusRingBuffer* getStagingRingBuffer(size_t length) const;
+        /// Has the GPU copy data staged in the ring buffer into this buffer
+        void copyFromRingBuffer(GL3PlusRingBuffer* ringBuffer, size_t stagingOffset,
+                                size_t offset, size_t length);
     public:
         void* lockImpl(size_t offset, size_t length, HardwareBuffer::LockOptions options);
         void unlockImpl(size_t lockSize);
@@ -47,6 +47,7 @@ namespace Ogre {
     class GL3PlusHardwarePixelBuffer;
     class GL3PlusRenderBuffer;
     class GL3PlusDepthBuffer;
+    class GL3PlusRingBuffer;
     
     class GLSLShader;
 
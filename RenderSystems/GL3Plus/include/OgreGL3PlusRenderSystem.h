@@ -49,6 +49,8 @@ namespace Ogre {
     class GLSLShaderFactory;
     class GLSLProgram;
     class HardwareBufferManager;
+    class GLVertexArrayObject;
+    class GL3PlusHardwareBuffer;
 
     /**
        Implementation of GL 3 as a rendering system.
@@ -68,8 +70,57 @@ namespace Ogre {
         /// Holds texture type settings for every stage
         GLenum mTextureTypes[OGRE_MAX_TEXTURE_LAYERS];
 
+        /// Sampling state of a stage, the key of the sampler object cache
+        struct SamplerDesc
+        {
+            GLint minFilter; // FilterOptions, combined with mipFilter when created
+            GLint magFilter;
+            GLint mipFilter;
+            GLint wrap[3];
+            GLfloat borderColour[4];
+            GLfloat mipmapBias;
+            GLint maxAnisotropy;
+            GLint compareMode;
+            GLint compareFunction;
+        };
+        /// Orders sampler descriptions by their bytes, they have no padding
+        struct SamplerDescLess
+        {
+            bool operator()(const SamplerDesc& a, const SamplerDesc& b) const
+            {
+                return memcmp(&a, &b, sizeof(SamplerDesc)) < 0;
+            }
+        };
+        typedef map<SamplerDesc, GLuint, SamplerDescLess>::type SamplerMap;
+
+        /// Whether GL_ARB_sampler_objects is available
+        bool mHasSamplerObjects;
+        /// Sampler objects created so far, shared by all stages with the same state
+        SamplerMap mSamplers;
+        /// Sampling state set for every stage
+        SamplerDesc mSamplerDescs[OGRE_MAX_TEXTURE_LAYERS];
+        /// Sampler object bound to every stage, ~0 if unknown
+        GLuint mBoundSamplers[OGRE_MAX_TEXTURE_LAYERS];
+        /// Whether the sampling state of any stage changed since the last bindSamplers
+        bool mSamplersDirty;
+
+        /// Whether GL_ARB_bindless_texture is available
+        bool mHasBindlessTexture;
+        /// Whether textures are passed to bindless samplers by handle
+        bool mBindlessTexturesEnabled;
+        /// Handle of the texture of every stage, 0 until it is created
+        GLuint64 mBindlessHandles[OGRE_MAX_TEXTURE_LAYERS];
+        /// Texture of every stage whose handle is created when drawing
+        GL3PlusTexture* mBindlessPendingTextures[OGRE_MAX_TEXTURE_LAYERS];
+        /// Texture of every stage which is passed by handle and not bound to its unit
+        GLuint mUnboundTextures[OGRE_MAX_TEXTURE_LAYERS];
+        GLuint64 mWarningTextureHandle;
+
         GLint mLargestSupportedAnisotropy;
 
+        /// Fences of the frames the GPU may still be working on, oldest first
+        deque<GLsync>::type mFrameFences;
+
         void initConfigOptions(void);
 
         /// Store last colour write state
@@ -118,12 +169,28 @@ namespace Ogre {
         /// Check if the GL system has already been initialised
         bool mGLInitialised;
 
+        /// Persistently mapped buffer dynamic buffer updates are staged in, if supported
+        GL3PlusRingBuffer* mRingBuffer;
+        /// Uniform buffer binding of the packed uniform block of programs
+        GLuint mPackedUniformBinding;
+        /// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+        GLint mUniformBufferOffsetAlignment;
+
 #if OGRE_NO_QUAD_BUFFER_STEREO == 0
 		/// @copydoc RenderSystem::setDrawBuffer
 		virtual bool setDrawBuffer(ColourBufferType colourBuffer);
 #endif
 
-        GLint getCombinedMinMipFilter(void) const;
+        GLint getCombinedMinMipFilter(FilterOptions minFilter, FilterOptions mipFilter) const;
+
+        /** Whether the sampling state of the stages is kept in sampler objects.
+            Bindless texture handles take it from the texture, so they use texture parameters.
+        */
+        bool useSamplerObjects(void) const { return mHasSamplerObjects && !mBindlessTexturesEnabled; }
+        /// Binds the sampler object matching the sampling state of each stage, creating it if needed
+        void bindSamplers(void);
+        /// Deletes the cached sampler objects
+        void destroySamplers(void);
 
         GLSLShader* mCurrentVertexShader;
         GLSLShader* mCurrentFragmentShader;
@@ -138,6 +205,47 @@ namespace Ogre {
         void bindVertexElementToGpu(const VertexElement& elem,
                                     const HardwareVertexBufferSharedPtr& vertexBuffer,
                                     const size_t vertexStart);
+        void bindVertexElementFormatToGpu(const VertexElement& elem, uint32 bindingIndex);
+        void bindVertexBufferToGpu(uint32 bindingIndex,
+                                   const HardwareVertexBufferSharedPtr& vertexBuffer,
+                                   const size_t vertexStart);
+
+        /// Whether glVertexAttribFormat and glBindVertexBuffer are available
+        bool mHasVertexAttribBinding;
+
+        /// Whether glMultiDraw*Indirect and shader storage buffers are available
+        bool mHasMultiDrawIndirect;
+        /// Whether the driver compiles and links on its own threads (GL_KHR_parallel_shader_compile)
+        bool mHasParallelShaderCompile;
+        /// Whether we are between _beginDrawBatch and _endDrawBatch
+        bool mDrawBatchOpen;
+        /// Shader storage buffer binding of the per-draw data of batched draws
+        GLuint mDrawBatchDataBinding;
+        /// Vertex array, index buffer and primitive type shared by the pending draws
+        GLVertexArrayObject* mDrawBatchVao;
+        GLuint mDrawBatchIndexBuffer;
+        /// Index type of the pending draws, or 0 if they are not indexed
+        GLenum mDrawBatchIndexType;
+        GLenum mDrawBatchPrimType;
+        /// Whether the pending draws are of pooled vertex data, and the buffers bound to each source
+        bool mDrawBatchPooled;
+        vector<std::pair<unsigned short, HardwareVertexBuffer*> >::type mDrawBatchVertexBuffers;
+        /// Indirect commands of the pending draws, laid out as GL expects them
+        vector<GLuint>::type mDrawBatchCommands;
+        /// Per-draw data of the pending draws: the column-major world matrix of each
+        vector<float>::type mDrawBatchData;
+        /// World matrix last set, to be recorded with the next batched draw
+        Matrix4 mDrawBatchWorldMatrix;
+        GL3PlusHardwareBuffer* mDrawIndirectBuffer;
+        size_t mDrawIndirectBufferSize;
+        HardwareUniformBufferSharedPtr mDrawDataBuffer;
+
+        /** Adds the operation to the pending draws of the batch, submitting them
+            first if they cannot be drawn together with it.
+        */
+        void addToDrawBatch(const RenderOperation& op, GLVertexArrayObject* vao, GLenum primType);
+        /// Submits the pending draws of the batch with a single indirect multi-draw
+        void flushDrawBatch(void);
 
     public:
         // Default constructor / destructor
@@ -166,6 +274,13 @@ namespace Ogre {
 
         void shutdown(void);
 
+        /// @copydoc RenderSystem::_insertFrameFence
+        void _insertFrameFence(void);
+        /// @copydoc RenderSystem::_waitFrameFences
+        void _waitFrameFences(size_t maxPending);
+        /// @copydoc RenderSystem::_discardRenderTarget
+        void _discardRenderTarget(RenderTarget* target, unsigned int buffers);
+
         /// @copydoc RenderSystem::_createRenderWindow
         RenderWindow* _createRenderWindow(const String &name, unsigned int width, unsigned int height,
                                           bool fullScreen, const NameValuePairList *miscParams = 0);
@@ -272,12 +387,41 @@ namespace Ogre {
 
         void _render(const RenderOperation& op);
 
+        /** See
+            RenderSystem.
+        @remarks
+            Issues a memory barrier after the dispatch, so that texture fetches,
+            image accesses and framebuffer writes that follow see the results.
+        */
+        void _dispatchCompute(const Vector3& workgroupDim);
+
+        /** See
+            RenderSystem.
+        @remarks
+            Batched draws are submitted with glMultiDrawElementsIndirect or
+            glMultiDrawArraysIndirect. The world matrix of each draw is stored as
+            a column-major mat4 in a shader storage buffer bound to the binding set
+            with setDrawBatchDataBinding, for the vertex program to index with
+            gl_DrawIDARB (GL_ARB_shader_draw_parameters), e.g.
+            <tt>layout(std430, binding = 0) buffer DrawData { mat4 worldMatrix[]; };</tt>
+            Draws are gathered while they share their vertex array, index buffer
+            and primitive type, and are not instanced or tessellated. Requires
+            OpenGL 4.3 or GL_ARB_multi_draw_indirect with
+            GL_ARB_shader_storage_buffer_object.
+        */
+        bool _beginDrawBatch(void);
+
+        void _endDrawBatch(void);
+
+        void _setWorldMatrix(const Matrix4 &m);
+
         void setScissorTest(bool enabled, size_t left = 0, size_t top = 0, size_t right = 800, size_t bottom = 600);
 
         void clearFrameBuffer(unsigned int buffers,
                               const ColourValue& colour = ColourValue::Black,
                               Real depth = 1.0f, unsigned short stencil = 0);
         HardwareOcclusionQuery* createHardwareOcclusionQuery(void);
+        HardwareTimerQuery* createHardwareTimerQuery(void);
         OGRE_MUTEX(mThreadInitMutex);
         void registerThread();
         void unregisterThread();
@@ -295,6 +439,19 @@ namespace Ogre {
 
         GL3PlusStateCacheManager * _getStateCacheManager() { return mStateCacheManager; }
 
+        /** Gets the ring buffer which updates of HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE
+            buffers are staged in, or NULL without GL_ARB_buffer_storage. */
+        GL3PlusRingBuffer* _getRingBuffer() const { return mRingBuffer; }
+
+        /// Gets the alignment of buffer ranges bound as uniform blocks
+        size_t _getUniformBufferOffsetAlignment() const { return mUniformBufferOffsetAlignment; }
+
+        bool _hasSeparateVertexFormat() const { return mHasVertexAttribBinding; }
+
+        /** Whether shaders compile in the background of the driver, so their
+            completion can be polled with GL_COMPLETION_STATUS_KHR. */
+        bool _hasParallelShaderCompile() const { return mHasParallelShaderCompile; }
+
         /** Create VAO on current context */
         uint32 _createVao();
         /** Bind VAO, context should be equal to current context, as VAOs are not shared  */
@@ -317,6 +474,34 @@ namespace Ogre {
             only need to be set once, like the LightingModel can be defined here.
         */
         void _oneTimeContextInitialization();
+
+        /** Sets the shader storage buffer binding which the per-draw data of
+            batched draws is bound to (0 by default).
+        */
+        void setDrawBatchDataBinding(GLuint binding) { mDrawBatchDataBinding = binding; }
+        /// Gets the shader storage buffer binding of the per-draw data of batched draws
+        GLuint getDrawBatchDataBinding(void) const { return mDrawBatchDataBinding; }
+
+        /** Sets the uniform buffer binding which the packed uniform block of
+            programs is bound to (the last one by default). Only affects
+            programs linked afterwards.
+        @see GLSLProgramManagerCommon::PACKED_UNIFORM_BLOCK_NAME
+        */
+        void setPackedUniformBinding(GLuint binding) { mPackedUniformBinding = binding; }
+        /// Gets the uniform buffer binding of the packed uniform block of programs
+        GLuint getPackedUniformBinding(void) const { return mPackedUniformBinding; }
+
+        /** Passes textures to programs whose samplers are declared with
+            layout(bindless_sampler) as GL_ARB_bindless_texture handles, instead
+            of binding them to texture units. Passes that only differ in their
+            textures can then be drawn without texture binds, and batched.
+        @note The filtering and addressing of a texture are baked into its handle
+            when it is first drawn with, and are fixed from then on.
+            Has no effect without GL_ARB_bindless_texture.
+        */
+        void setBindlessTexturesEnabled(bool enabled);
+        /// Whether textures are passed to bindless samplers by handle
+        bool getBindlessTexturesEnabled(void) const { return mBindlessTexturesEnabled; }
         void initialiseContext(RenderWindow* primary);
         /**
          * Set current render target to target, enabling its GL context if needed
@@ -356,6 +541,8 @@ namespace Ogre {
 
         /** @copydoc RenderTarget::copyContentsToMemory */
         void _copyContentsToMemory(Viewport* vp, const Box& src, const PixelBox &dst, RenderWindow::FrameBuffer buffer);
+        /** @copydoc GLRenderSystemCommon::_copyContentsToMemoryAsync */
+        AsyncReadbackPtr _copyContentsToMemoryAsync(Viewport* vp, const Box& src, RenderWindow::FrameBuffer buffer);
     };
     /** @} */
     /** @} */
@@ -0,0 +1,95 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __GL3PlusRINGBUFFER_H__
+#define __GL3PlusRINGBUFFER_H__
+
+#include "OgreGL3PlusPrerequisites.h"
+
+namespace Ogre {
+
+    /** Persistently mapped buffer which updates of dynamic buffers are staged in.
+    @remarks
+        Instead of mapping and unmapping the destination buffer on every lock,
+        GL3PlusHardwareBuffer writes into space allocated here and has the GPU
+        copy it into place on unlock. This is done for writeData and for
+        HBL_DISCARD and HBL_NO_OVERWRITE locks, which do not need the previous
+        contents of the locked range to survive. The buffer is created with
+        GL_ARB_buffer_storage as persistent and coherent, so it is mapped once
+        for its whole lifetime. Space is handed out in a ring; the allocations
+        of each frame are retired by a fence, which is only waited on when the
+        ring has wrapped around onto space the GPU may still be copying from.
+    */
+    class GL3PlusRingBuffer
+    {
+    private:
+        struct Fence
+        {
+            GLsync sync;
+            /// Ring position up to which the fenced allocations reach
+            uint64 end;
+        };
+        typedef deque<Fence>::type FenceList;
+
+        GLuint mBufferId;
+        uint8* mMappedData;
+        size_t mSizeInBytes;
+        /// Positions of the next allocation and of the oldest one still in use.
+        /// They only ever grow; the offset in the buffer is the position modulo its size.
+        uint64 mHead;
+        uint64 mTail;
+        /// Position at the last fence
+        uint64 mFencedHead;
+        FenceList mFences;
+
+        /// Waits for the oldest fence and frees the space it covers
+        void retireOldest(void);
+    public:
+        /// Alignment of the allocations, suitable for SIMD copies
+        static const size_t ALIGNMENT = 16;
+
+        explicit GL3PlusRingBuffer(size_t sizeInBytes);
+        ~GL3PlusRingBuffer();
+
+        /** Allocates length bytes, waiting for the GPU if the ring is full.
+        @param alignment Alignment of the allocation, which must be a power of two
+        @return Offset of the allocation in the buffer, to be written through
+            getMappedData and copied from, or bound as, getGLBufferId.
+        */
+        size_t allocate(size_t length, size_t alignment = ALIGNMENT);
+
+        /** Fences the allocations made since the last call, and retires those
+            which the GPU has finished with. Call once per frame.
+        */
+        void fence(void);
+
+        GLuint getGLBufferId(void) const { return mBufferId; }
+        void* getMappedData(size_t offset) const { return mMappedData + offset; }
+        size_t getSizeInBytes(void) const { return mSizeInBytes; }
+    };
+}
+#endif // __GL3PlusRINGBUFFER_H__
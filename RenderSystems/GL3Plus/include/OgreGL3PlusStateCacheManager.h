@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreGLStateCacheManagerCommon.h"
 #include "OgreStdHeaders.h"
 #include "OgreIteratorWrappers.h"
+#include "OgreRenderSystem.h"
 
 namespace Ogre
 {
@@ -81,8 +82,15 @@ namespace Ogre
         GLuint mActiveProgramPipeline;
 
         GLfloat mPointSize;
+
+        /// The statistics state changes are counted in, if any
+        RenderSystem::RenderStats* mRenderStats;
+        void countStateChange() { if (mRenderStats) ++mRenderStats->stateChanges; }
     public:
         GL3PlusStateCacheManager(void);
+
+        /// Sets the statistics state changes and vertex array binds are counted in
+        void _setRenderStats(RenderSystem::RenderStats* stats) { mRenderStats = stats; }
         
         /// See GL3PlusStateCacheManager.initializeCache.
         void initializeCache();
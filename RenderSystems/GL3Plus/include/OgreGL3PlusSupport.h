@@ -99,6 +99,14 @@ namespace Ogre
                 return mVersion;
             }
 
+            /**
+            * Get the vendor, renderer and version strings of the driver
+            */
+            const String& getGLDriverString(void) const
+            {
+                return mDriverString;
+            }
+
             /**
             * Get shader cache path
             */
@@ -176,6 +184,7 @@ namespace Ogre
             DriverVersion mVersion;
 
             String mVendor;
+            String mDriverString;
             String mShaderCachePath;
             String mShaderLibraryPath;
 
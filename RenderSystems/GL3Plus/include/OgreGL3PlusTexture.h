@@ -52,6 +52,15 @@ namespace Ogre {
         void createShaderAccessPoint(uint bindPoint, TextureAccess access = TA_READ_WRITE,
                                      int mipmapLevel = 0, int textureArrayIndex = 0,
                                      PixelFormat* format = NULL);
+
+        /** Gets a resident GL_ARB_bindless_texture handle of the texture, creating it
+            on the first call.
+        @note The filtering and addressing the texture has then are baked into the
+            handle, they can not be changed anymore afterwards.
+        */
+        GLuint64 getBindlessHandle(void);
+        /// Whether getBindlessHandle already created the handle
+        bool hasBindlessHandle(void) const { return mBindlessHandle != 0; }
     protected:
         /// @copydoc Texture::createInternalResourcesImpl
         void createInternalResourcesImpl(void);
@@ -69,6 +78,7 @@ namespace Ogre {
 
     private:
         GL3PlusRenderSystem* mRenderSystem;
+        GLuint64 mBindlessHandle;
     };
 }
 
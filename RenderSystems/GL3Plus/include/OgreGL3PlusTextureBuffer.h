@@ -54,6 +54,9 @@ namespace Ogre {
         /// Download a box of pixels from the card.
         virtual void download(const PixelBox &data);
 
+        /// Download the entire buffer into a pixel pack buffer, fetched later.
+        AsyncReadbackPtr blitToMemoryAsync(const Box &srcBox);
+
         /// Hardware implementation of blitFromMemory.
         virtual void blitFromMemory(const PixelBox &src_orig, const Box &dstBox);
 
@@ -31,6 +31,7 @@
 #include "OgreGLSLShader.h"
 #include "OgreGLSLMonolithicProgramManager.h"
 #include "OgreGL3PlusRenderSystem.h"
+#include "OgreRoot.h"
 #include "OgreStringVector.h"
 #include "OgreLogManager.h"
 #include "OgreGpuProgramManager.h"
@@ -66,9 +67,11 @@ namespace Ogre {
             OGRE_CHECK_GL_ERROR(mGLProgramHandle = glCreateProgram());
 
             if ( GpuProgramManager::getSingleton().canGetCompiledShaderBuffer() &&
-                 GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(getCombinedName()) )
+                 GpuProgramManager::getSingleton().isMicrocodeAvailableInCache(getBinaryCacheName()) )
             {
                 getMicrocodeFromCache();
+                if (mVertexShader)
+                    setSkeletalAnimationIncluded(mVertexShader->isSkeletalAnimationIncluded());
             }
             else
             {
@@ -157,6 +160,11 @@ namespace Ogre {
 
         bindFixedAttributes(mGLProgramHandle);
 
+        if ( GpuProgramManager::getSingleton().getSaveMicrocodesToCache() )
+        {
+            OGRE_CHECK_GL_ERROR(glProgramParameteri(mGLProgramHandle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+        }
+
         // the link
         OGRE_CHECK_GL_ERROR(glLinkProgram( mGLProgramHandle ));
         OGRE_CHECK_GL_ERROR(glGetProgramiv( mGLProgramHandle, GL_LINK_STATUS, &mLinked ));
@@ -176,8 +184,7 @@ namespace Ogre {
             if ( GpuProgramManager::getSingleton().getSaveMicrocodesToCache() )
             {
                 // add to the microcode to the cache
-                String name;
-                name = getCombinedName();
+                String name = getBinaryCacheName();
 
                 // get buffer size
                 GLint binaryLength = 0;
@@ -220,6 +227,11 @@ namespace Ogre {
         GLSLMonolithicProgramManager::getSingleton().extractUniformsFromProgram(
             mGLProgramHandle, params, mGLUniformReferences, mGLAtomicCounterReferences,
             mGLUniformBufferReferences, mSharedParamsBufferMap, mGLCounterBufferReferences);
+        size_t packedUniformBlockSize = GLSLMonolithicProgramManager::getSingleton().extractPackedUniformsFromProgram(
+            mGLProgramHandle, params, mGLPackedUniformReferences);
+        mPackedUniformData.resize(packedUniformBlockSize);
+
+        buildBindlessSamplerReferences();
 
         mUniformRefsBuilt = true;
     }
@@ -244,6 +256,7 @@ namespace Ogre {
             transpose = GL_FALSE;
         }
 
+        size_t uniformBytes = 0;
         for (;currentUniform != endUniform; ++currentUniform)
         {
             // Only pull values from buffer it's supposed to be in (vertex or fragment)
@@ -255,6 +268,8 @@ namespace Ogre {
                 if (def->variability & mask)
                 {
                     GLsizei glArraySize = (GLsizei)def->arraySize;
+                    uniformBytes += def->elementSize * def->arraySize *
+                        (def->isDouble() ? sizeof(double) : sizeof(float));
 
                     // Get the index in the parameter real list
                     switch (def->constType)
@@ -408,6 +423,10 @@ namespace Ogre {
                     case GCT_SAMPLER3D:
                     case GCT_SAMPLERCUBE:
                     case GCT_SAMPLERRECT:
+                        // Bindless samplers get the handle of the texture in the unit when drawing
+                        if (setBindlessSamplerUnit(currentUniform->mLocation,
+                                                   *params->getIntPointer(def->physicalIndex)))
+                            break;
                         // Samplers handled like 1-element ints
                         OGRE_CHECK_GL_ERROR(glUniform1iv(currentUniform->mLocation, 1,
                                                          (GLint*)params->getIntPointer(def->physicalIndex)));
@@ -421,34 +440,18 @@ namespace Ogre {
             } // fromProgType == currentUniform->mSourceProgType
 
         } // End for
+
+        Root::getSingleton().getRenderSystem()->_getCurrentRenderStats().uniformBytes += uniformBytes;
+
+        if (!mGLPackedUniformReferences.empty())
+            updatePackedUniforms(params, mask, fromProgType, transpose == GL_TRUE);
     }
 
 
     void GLSLMonolithicProgram::updateUniformBlocks(GpuProgramParametersSharedPtr params,
                                                     uint16 mask, GpuProgramType fromProgType)
     {
-        // Iterate through the list of uniform buffers and update them as needed
-        GLUniformBufferIterator currentBuffer = mGLUniformBufferReferences.begin();
-        GLUniformBufferIterator endBuffer = mGLUniformBufferReferences.end();
-
-        const GpuProgramParameters::GpuSharedParamUsageList& sharedParams = params->getSharedParameters();
-
-        GpuProgramParameters::GpuSharedParamUsageList::const_iterator it, end = sharedParams.end();
-        for (it = sharedParams.begin(); it != end; ++it)
-        {
-            for (;currentBuffer != endBuffer; ++currentBuffer)
-            {
-                GL3PlusHardwareUniformBuffer* hwGlBuffer = static_cast<GL3PlusHardwareUniformBuffer*>(currentBuffer->get());
-                GpuSharedParametersPtr paramsPtr = it->getSharedParams();
-
-                // Block name is stored in mSharedParams->mName of GpuSharedParamUsageList items
-                GLint UniformTransform;
-                OGRE_CHECK_GL_ERROR(UniformTransform = glGetUniformBlockIndex(mGLProgramHandle, it->getName().c_str()));
-                OGRE_CHECK_GL_ERROR(glUniformBlockBinding(mGLProgramHandle, UniformTransform, hwGlBuffer->getGLBufferBinding()));
-
-                hwGlBuffer->writeData(0, hwGlBuffer->getSizeInBytes(), &paramsPtr->getFloatConstantList().front());
-            }
-        }
+        updateSharedParamsBuffers();
     }
 
 
@@ -456,6 +459,9 @@ namespace Ogre {
     {
         if (params->hasPassIterationNumber())
         {
+            if (updatePackedPassIterationUniform(params))
+                return;
+
             size_t index = params->getPassIterationNumberIndex();
 
             GLUniformReferenceIterator currentUniform = mGLUniformReferences.begin();
@@ -32,9 +32,62 @@
 #include "OgreGLSLShader.h"
 #include "OgreRoot.h"
 #include "OgreGLSLExtSupport.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusSupport.h"
+#include "OgreGL3PlusRingBuffer.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusHardwareUniformBuffer.h"
 
 namespace Ogre {
 
+    GLSLProgram* GLSLProgram::msPackedUniformsProgram = 0;
+
+    /// Gets the columns and rows of matrix constant types, as in glUniformMatrix{cols}x{rows}
+    static bool getMatrixSize(GpuConstantType type, size_t& cols, size_t& rows)
+    {
+        switch (type)
+        {
+        case GCT_MATRIX_2X2:
+        case GCT_MATRIX_DOUBLE_2X2:
+            cols = 2; rows = 2;
+            return true;
+        case GCT_MATRIX_2X3:
+        case GCT_MATRIX_DOUBLE_2X3:
+            cols = 2; rows = 3;
+            return true;
+        case GCT_MATRIX_2X4:
+        case GCT_MATRIX_DOUBLE_2X4:
+            cols = 2; rows = 4;
+            return true;
+        case GCT_MATRIX_3X2:
+        case GCT_MATRIX_DOUBLE_3X2:
+            cols = 3; rows = 2;
+            return true;
+        case GCT_MATRIX_3X3:
+        case GCT_MATRIX_DOUBLE_3X3:
+            cols = 3; rows = 3;
+            return true;
+        case GCT_MATRIX_3X4:
+        case GCT_MATRIX_DOUBLE_3X4:
+            cols = 3; rows = 4;
+            return true;
+        case GCT_MATRIX_4X2:
+        case GCT_MATRIX_DOUBLE_4X2:
+            cols = 4; rows = 2;
+            return true;
+        case GCT_MATRIX_4X3:
+        case GCT_MATRIX_DOUBLE_4X3:
+            cols = 4; rows = 3;
+            return true;
+        case GCT_MATRIX_4X4:
+        case GCT_MATRIX_DOUBLE_4X4:
+            cols = 4; rows = 4;
+            return true;
+        default:
+            return false;
+        }
+    }
+
     GLSLProgram::GLSLProgram(GLSLShader* vertexShader,
                              GLSLShader* hullShader,
                              GLSLShader* domainShader,
@@ -42,6 +95,8 @@ namespace Ogre {
                              GLSLShader* fragmentShader,
                              GLSLShader* computeShader)
         : GLSLProgramCommon(vertexShader)
+        , mPackedUniformsDirty(true)
+        , mPackedUniformBuffer(0)
         , mHullShader(hullShader)
         , mDomainShader(domainShader)
         , mGeometryShader(geometryShader)
@@ -54,6 +109,15 @@ namespace Ogre {
     GLSLProgram::~GLSLProgram(void)
     {
         OGRE_CHECK_GL_ERROR(glDeleteProgram(mGLProgramHandle));
+
+        GL3PlusStateCacheManager* stateCacheManager = static_cast<GL3PlusRenderSystem*>(
+            Root::getSingleton().getRenderSystem())->_getStateCacheManager();
+        if (mPackedUniformBuffer && stateCacheManager)
+        {
+            stateCacheManager->deleteGLBuffer(GL_UNIFORM_BUFFER, mPackedUniformBuffer);
+        }
+        if (msPackedUniformsProgram == this)
+            msPackedUniformsProgram = 0;
     }
 
 
@@ -100,6 +164,28 @@ namespace Ogre {
         return name;
     }
 
+    String GLSLProgram::getBinaryCacheName(GLSLShader* shader)
+    {
+        GL3PlusRenderSystem* rs = static_cast<GL3PlusRenderSystem*>(Root::getSingleton().getRenderSystem());
+        const String& driver = rs->getGLSupportRef()->getGLDriverString();
+        uint32 hash = FastHash(driver.c_str(), driver.size());
+
+        GLSLShader* shaders[6] = {getVertexShader(), mHullShader, mDomainShader, mGeometryShader, mFragmentShader, mComputeShader};
+        for (int i = 0; i < 6; i++)
+        {
+            if (!shaders[i] || (shader && shaders[i] != shader))
+                continue;
+
+            const String& source = shaders[i]->getSource();
+            const String& defines = shaders[i]->getPreprocessorDefines();
+            hash = HashCombine(hash, i);
+            hash = FastHash(source.c_str(), source.size(), hash);
+            hash = FastHash(defines.c_str(), defines.size(), hash);
+        }
+
+        return "GLSL program binary " + StringConverter::toString(hash);
+    }
+
     void GLSLProgram::bindFixedAttributes(GLuint program)
     {
         GLint max_vertex_attribs = 16;
@@ -131,7 +217,7 @@ namespace Ogre {
             programId = glslGpuProgram->getGLProgramHandle();
 
             // force re-link
-            GpuProgramManager::getSingleton().removeMicrocodeFromCache(glslGpuProgram->getName());
+            GpuProgramManager::getSingleton().removeMicrocodeFromCache(getBinaryCacheName(glslGpuProgram));
             glslGpuProgram->setLinked(false);
         }
         else
@@ -139,7 +225,7 @@ namespace Ogre {
             programId = getGLProgramHandle();
 
             // force re-link
-            GpuProgramManager::getSingleton().removeMicrocodeFromCache(getCombinedName());
+            GpuProgramManager::getSingleton().removeMicrocodeFromCache(getBinaryCacheName());
         }
         mLinked = false;
 
@@ -176,8 +262,9 @@ namespace Ogre {
 
     void GLSLProgram::getMicrocodeFromCache(void)
     {
+        String name = getBinaryCacheName();
         GpuProgramManager::Microcode cacheMicrocode =
-            GpuProgramManager::getSingleton().getMicrocodeFromCache(getCombinedName());
+            GpuProgramManager::getSingleton().getMicrocodeFromCache(name);
 
         cacheMicrocode->seek(0);
 
@@ -191,7 +278,7 @@ namespace Ogre {
         // Load binary.
         OGRE_CHECK_GL_ERROR(glProgramBinary(mGLProgramHandle,
                                             binaryFormat,
-                                            cacheMicrocode->getPtr(),
+                                            cacheMicrocode->getPtr() + sizeof(GLenum),
                                             binaryLength));
 
         GLint success = 0;
@@ -201,7 +288,307 @@ namespace Ogre {
             // Something must have changed since the program binaries
             // were cached away. Fallback to source shader loading path,
             // and then retrieve and cache new program binaries once again.
+            logObjectInfo("Could not use cached binary " + name, mGLProgramHandle);
+            GpuProgramManager::getSingleton().removeMicrocodeFromCache(name);
             compileAndLink();
+            return;
+        }
+
+        mLinked = success;
+        mTriedToLinkAndFailed = false;
+    }
+
+
+    void GLSLProgram::updatePackedUniforms(GpuProgramParametersSharedPtr params, uint16 mask,
+                                           GpuProgramType fromProgType, bool transpose)
+    {
+        GLPackedUniformReferenceIterator currentUniform = mGLPackedUniformReferences.begin();
+        GLPackedUniformReferenceIterator endUniform = mGLPackedUniformReferences.end();
+
+        for (;currentUniform != endUniform; ++currentUniform)
+        {
+            const GpuConstantDefinition* def = currentUniform->mConstantDef;
+            if (fromProgType != currentUniform->mSourceProgType || !(def->variability & mask))
+                continue;
+
+            const uint8* src;
+            size_t componentSize = sizeof(float);
+            if (def->isFloat())
+            {
+                src = reinterpret_cast<const uint8*>(params->getFloatPointer(def->physicalIndex));
+            }
+            else if (def->isDouble())
+            {
+                src = reinterpret_cast<const uint8*>(params->getDoublePointer(def->physicalIndex));
+                componentSize = sizeof(double);
+            }
+            else if (def->isInt())
+            {
+                src = reinterpret_cast<const uint8*>(params->getIntPointer(def->physicalIndex));
+            }
+            else if (def->isUnsignedInt() || def->isBool())
+            {
+                src = reinterpret_cast<const uint8*>(params->getUnsignedIntPointer(def->physicalIndex));
+            }
+            else
+            {
+                // Samplers cannot be in uniform blocks
+                continue;
+            }
+
+            size_t cols = 0, rows = 0;
+            bool isMatrix = getMatrixSize(def->constType, cols, rows);
+            size_t elementBytes = def->elementSize * componentSize;
+            uint8* dst = &mPackedUniformData[currentUniform->mOffset];
+
+            for (size_t e = 0; e < def->arraySize; ++e)
+            {
+                uint8* elementDst = dst + e * currentUniform->mArrayStride;
+                const uint8* elementSrc = src + e * elementBytes;
+
+                if (!isMatrix)
+                {
+                    memcpy(elementDst, elementSrc, elementBytes);
+                }
+                else if (transpose == currentUniform->mRowMajor)
+                {
+                    // Same order on both sides, only the stride between vectors differs
+                    size_t vectorCount = transpose ? rows : cols;
+                    size_t vectorBytes = (transpose ? cols : rows) * componentSize;
+                    for (size_t v = 0; v < vectorCount; ++v)
+                        memcpy(elementDst + v * currentUniform->mMatrixStride,
+                               elementSrc + v * vectorBytes, vectorBytes);
+                }
+                else
+                {
+                    for (size_t r = 0; r < rows; ++r)
+                    {
+                        for (size_t c = 0; c < cols; ++c)
+                        {
+                            size_t srcIndex = transpose ? r * cols + c : c * rows + r;
+                            size_t dstOffset = currentUniform->mRowMajor ?
+                                r * currentUniform->mMatrixStride + c * componentSize :
+                                c * currentUniform->mMatrixStride + r * componentSize;
+                            memcpy(elementDst + dstOffset, elementSrc + srcIndex * componentSize,
+                                   componentSize);
+                        }
+                    }
+                }
+            }
+
+            mPackedUniformsDirty = true;
+        }
+    }
+
+    bool GLSLProgram::updatePackedPassIterationUniform(GpuProgramParametersSharedPtr params)
+    {
+        size_t index = params->getPassIterationNumberIndex();
+
+        GLPackedUniformReferenceIterator currentUniform = mGLPackedUniformReferences.begin();
+        GLPackedUniformReferenceIterator endUniform = mGLPackedUniformReferences.end();
+
+        for (;currentUniform != endUniform; ++currentUniform)
+        {
+            if (index == currentUniform->mConstantDef->physicalIndex)
+            {
+                memcpy(&mPackedUniformData[currentUniform->mOffset], params->getFloatPointer(index),
+                       sizeof(float));
+                mPackedUniformsDirty = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void GLSLProgram::_bindPackedUniforms(void)
+    {
+        if (!mPackedUniformsDirty && msPackedUniformsProgram == this)
+            return;
+
+        GL3PlusRenderSystem* renderSystem =
+            static_cast<GL3PlusRenderSystem*>(Root::getSingleton().getRenderSystem());
+        GL3PlusStateCacheManager* stateCacheManager = renderSystem->_getStateCacheManager();
+        GL3PlusRingBuffer* ringBuffer = renderSystem->_getRingBuffer();
+        GLuint binding = renderSystem->getPackedUniformBinding();
+        size_t size = mPackedUniformData.size();
+        renderSystem->_getCurrentRenderStats().uniformBytes += size;
+
+        if (ringBuffer)
+        {
+            // Every upload gets a range of its own, so draws still in flight keep theirs.
+            // Binding a range also binds the generic target, keep the cache in sync.
+            size_t offset = ringBuffer->allocate(size, renderSystem->_getUniformBufferOffsetAlignment());
+            memcpy(ringBuffer->getMappedData(offset), &mPackedUniformData[0], size);
+            stateCacheManager->bindGLBuffer(GL_UNIFORM_BUFFER, ringBuffer->getGLBufferId());
+            OGRE_CHECK_GL_ERROR(glBindBufferRange(GL_UNIFORM_BUFFER, binding, ringBuffer->getGLBufferId(),
+                                                  offset, size));
+        }
+        else
+        {
+            if (!mPackedUniformBuffer)
+                OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mPackedUniformBuffer));
+
+            // Respecify the whole buffer so the driver can orphan the previous storage
+            stateCacheManager->bindGLBuffer(GL_UNIFORM_BUFFER, mPackedUniformBuffer);
+            OGRE_CHECK_GL_ERROR(glBufferData(GL_UNIFORM_BUFFER, size, &mPackedUniformData[0],
+                                             GL_STREAM_DRAW));
+            OGRE_CHECK_GL_ERROR(glBindBufferBase(GL_UNIFORM_BUFFER, binding, mPackedUniformBuffer));
+        }
+
+        mPackedUniformsDirty = false;
+        msPackedUniformsProgram = this;
+    }
+
+    void GLSLProgram::updateSharedParamsBuffers(void)
+    {
+        GL3PlusStateCacheManager* stateCacheManager = static_cast<GL3PlusRenderSystem*>(
+            Root::getSingleton().getRenderSystem())->_getStateCacheManager();
+
+        SharedParamsBufferMap::const_iterator currentPair = mSharedParamsBufferMap.begin();
+        SharedParamsBufferMap::const_iterator endPair = mSharedParamsBufferMap.end();
+        for (; currentPair != endPair; ++currentPair)
+        {
+            GpuSharedParameters* sharedParams = currentPair->first.get();
+
+            if (currentPair->second == sharedParams->_getHardwareBuffer())
+            {
+                // Uniform block, uploaded once per change for every program reading it.
+                // Binding the base also binds the generic target, keep the cache in sync.
+                sharedParams->_updateHardwareBuffer();
+                GL3PlusHardwareUniformBuffer* hwGlBuffer =
+                    static_cast<GL3PlusHardwareUniformBuffer*>(currentPair->second.get());
+                stateCacheManager->bindGLBuffer(GL_UNIFORM_BUFFER, hwGlBuffer->getGLBufferId());
+                OGRE_CHECK_GL_ERROR(glBindBufferBase(GL_UNIFORM_BUFFER, hwGlBuffer->getGLBufferBinding(),
+                                                     hwGlBuffer->getGLBufferId()));
+                continue;
+            }
+
+            // Shader storage block, the offsets are stored in the logical indices
+            // force const call to get*Pointer
+            const GpuSharedParameters* paramsPtr = sharedParams;
+            HardwareUniformBuffer* hwGlBuffer = currentPair->second.get();
+
+            if (!paramsPtr->isDirty()) continue;
+
+            GpuConstantDefinitionIterator parami = paramsPtr->getConstantDefinitionIterator();
+
+            for (; parami.current() != parami.end(); parami.moveNext())
+            {
+                const GpuConstantDefinition* param = &parami.current()->second;
+
+                BaseConstantType baseType = GpuConstantDefinition::getBaseType(param->constType);
+
+                const void* dataPtr;
+
+                // NOTE: the naming is backward. this is the logical index
+                size_t index =  param->physicalIndex;
+
+                switch (baseType)
+                {
+                case BCT_FLOAT:
+                    dataPtr = paramsPtr->getFloatPointer(index);
+                    break;
+                case BCT_INT:
+                    dataPtr = paramsPtr->getIntPointer(index);
+                    break;
+                case BCT_DOUBLE:
+                    dataPtr = paramsPtr->getDoublePointer(index);
+                    break;
+                case BCT_UINT:
+                case BCT_BOOL:
+                    dataPtr = paramsPtr->getUnsignedIntPointer(index);
+                    break;
+                case BCT_SAMPLER:
+                case BCT_SUBROUTINE:
+                    //TODO implement me!
+                default:
+                    //TODO error handling
+                    continue;
+                }
+
+                // in bytes
+                size_t length = param->arraySize * param->elementSize * 4;
+
+                // NOTE: the naming is backward. this is the physical offset in bytes
+                size_t offset = param->logicalIndex;
+                hwGlBuffer->writeData(offset, length, dataPtr);
+            }
+        }
+    }
+
+    void GLSLProgram::buildBindlessSamplerReferences(void)
+    {
+        mGLBindlessSamplerReferences.clear();
+
+        GLSLShader* shaders[6] = {getVertexShader(), mFragmentShader, mGeometryShader, mDomainShader, mHullShader, mComputeShader};
+        bool bindless = false;
+        for (int i = 0; i < 6; i++)
+        {
+            if (shaders[i] && shaders[i]->getSource().find("bindless_sampler") != String::npos)
+                bindless = true;
+        }
+        if (!bindless)
+            return;
+
+        GLUniformReferenceIterator currentUniform = mGLUniformReferences.begin();
+        GLUniformReferenceIterator endUniform = mGLUniformReferences.end();
+        for (;currentUniform != endUniform; ++currentUniform)
+        {
+            if (!currentUniform->mConstantDef->isSampler())
+                continue;
+
+            GLBindlessSamplerReference sampler;
+            sampler.mLocation = currentUniform->mLocation;
+            sampler.mUnit = -1;
+            sampler.mHandle = 0;
+            mGLBindlessSamplerReferences.push_back(sampler);
+        }
+    }
+
+    bool GLSLProgram::setBindlessSamplerUnit(GLint location, GLint unit)
+    {
+        GLBindlessSamplerReferenceIterator currentSampler = mGLBindlessSamplerReferences.begin();
+        GLBindlessSamplerReferenceIterator endSampler = mGLBindlessSamplerReferences.end();
+        for (;currentSampler != endSampler; ++currentSampler)
+        {
+            if (currentSampler->mLocation == location)
+            {
+                currentSampler->mUnit = unit;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool GLSLProgram::_getBindlessSamplersDirty(const GLuint64* unitHandles) const
+    {
+        GLBindlessSamplerReferenceList::const_iterator currentSampler = mGLBindlessSamplerReferences.begin();
+        GLBindlessSamplerReferenceList::const_iterator endSampler = mGLBindlessSamplerReferences.end();
+        for (;currentSampler != endSampler; ++currentSampler)
+        {
+            if (currentSampler->mUnit >= 0 && currentSampler->mUnit < OGRE_MAX_TEXTURE_LAYERS &&
+                unitHandles[currentSampler->mUnit] &&
+                unitHandles[currentSampler->mUnit] != currentSampler->mHandle)
+                return true;
+        }
+        return false;
+    }
+
+    void GLSLProgram::_bindBindlessSamplers(const GLuint64* unitHandles)
+    {
+        GLBindlessSamplerReferenceIterator currentSampler = mGLBindlessSamplerReferences.begin();
+        GLBindlessSamplerReferenceIterator endSampler = mGLBindlessSamplerReferences.end();
+        for (;currentSampler != endSampler; ++currentSampler)
+        {
+            // Samplers of units without a texture keep their last handle
+            if (currentSampler->mUnit < 0 || currentSampler->mUnit >= OGRE_MAX_TEXTURE_LAYERS)
+                continue;
+            GLuint64 handle = unitHandles[currentSampler->mUnit];
+            if (handle && handle != currentSampler->mHandle)
+            {
+                OGRE_CHECK_GL_ERROR(glUniformHandleui64ARB(currentSampler->mLocation, handle));
+                currentSampler->mHandle = handle;
+            }
         }
     }
 
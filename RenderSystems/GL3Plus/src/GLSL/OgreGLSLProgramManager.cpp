@@ -47,7 +47,8 @@ namespace Ogre {
         mActiveGeometryShader(NULL),
         mActiveFragmentShader(NULL),
         mActiveComputeShader(NULL),
-        mRenderSystem(renderSystem)
+        mRenderSystem(renderSystem),
+        mSharedParamsBindings(0)
     {
         // Fill in the relationship between type names and enums
         mTypeEnumMap.insert(StringToEnumMap::value_type("float", GL_FLOAT));
@@ -547,13 +548,6 @@ namespace Ogre {
         } // end for
 
 
-        //FIXME uniform buffers need to be created during material script parsing of shared params
-        // HardwareUniformBufferSharedPtr newUniformBuffer = HardwareBufferManager::getSingleton().createUniformBuffer(blockSize, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false, uniformName);
-        // GL3PlusHardwareUniformBuffer* hwGlBuffer = static_cast<GL3PlusHardwareUniformBuffer*>(newUniformBuffer.get());
-        // hwGlBuffer->setGLBufferBinding(blockBinding);
-        // GpuSharedParametersPtr blockSharedParams = GpuProgramManager::getSingleton().getSharedParameters(uniformName);
-        // uniformBufferList.push_back(uniformBuffer);
-
         //FIXME Ogre materials need a new shared param that is associated with an entity.
         // This could be impemented as a switch-like statement inside shared_params:
 
@@ -567,33 +561,41 @@ namespace Ogre {
         {
             OGRE_CHECK_GL_ERROR(glGetActiveUniformBlockName(programObject, index, uniformLength, NULL, uniformName));
 
+            // The packed uniform block is not a shared parameter block, see extractPackedUniformsFromProgram
+            if (PACKED_UNIFORM_BLOCK_NAME == uniformName)
+                continue;
+
             // Map uniform block to binding point of GL buffer of
             // shared param bearing the same name.
-
-            GpuSharedParametersPtr blockSharedParams = GpuProgramManager::getSingleton().getSharedParameters(uniformName);
-            //TODO error handling for when buffer has no associated shared parameter?
-            //if (bufferi == mSharedParamGLBufferMap.end()) continue;
-
-            GL3PlusHardwareUniformBuffer* hwGlBuffer;
-            SharedParamsBufferMap::const_iterator bufferMapi = sharedParamsBufferMap.find(blockSharedParams);
-            if (bufferMapi != sharedParamsBufferMap.end())
+            const GpuProgramManager::SharedParametersMap& sharedParamsMap =
+                GpuProgramManager::getSingleton().getAvailableSharedParameters();
+            GpuProgramManager::SharedParametersMap::const_iterator sharedParamsi = sharedParamsMap.find(uniformName);
+            if (sharedParamsi == sharedParamsMap.end())
             {
-                hwGlBuffer = static_cast<GL3PlusHardwareUniformBuffer*>(bufferMapi->second.get());
+                LogManager::getSingleton().logMessage("Uniform block '" + String(uniformName) +
+                                                      "' has no shared parameters of the same name");
+                continue;
             }
-            else
+            GpuSharedParametersPtr blockSharedParams = sharedParamsi->second;
+
+            // Every program reads the block from the one buffer of the shared parameters,
+            // so their values are uploaded once whenever they change.
+            if (!blockSharedParams->_getHardwareBuffer())
             {
-                // Create buffer and add entry to buffer map.
+                if (mSharedParamsBindings >= mRenderSystem->getPackedUniformBinding())
+                {
+                    LogManager::getSingleton().logMessage("No uniform buffer binding left for the shared parameters '" +
+                                                          String(uniformName) + "'");
+                    continue;
+                }
+
                 GLint blockSize;
                 OGRE_CHECK_GL_ERROR(glGetActiveUniformBlockiv(programObject, index, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize));
                 HardwareUniformBufferSharedPtr newUniformBuffer = HardwareBufferManager::getSingleton().createUniformBuffer(blockSize, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false, uniformName);
-                // bufferMapi->second() = newUniformBuffer;
-                hwGlBuffer = static_cast<GL3PlusHardwareUniformBuffer*>(newUniformBuffer.get());
-                GLint bufferBinding = sharedParamsBufferMap.size();
-                hwGlBuffer->setGLBufferBinding(bufferBinding);
-                std::pair<GpuSharedParametersPtr, HardwareUniformBufferSharedPtr> newPair (blockSharedParams, newUniformBuffer);
-                sharedParamsBufferMap.insert(newPair);
+                static_cast<GL3PlusHardwareUniformBuffer*>(newUniformBuffer.get())->setGLBufferBinding(mSharedParamsBindings++);
+                blockSharedParams->_setHardwareBuffer(newUniformBuffer);
 
-                // Get active block parameter properties.
+                // The block layout is the same in every program, so record it once.
                 GpuConstantDefinitionIterator sharedParamDef = blockSharedParams->getConstantDefinitionIterator();
                 std::vector<const char*> sharedParamNames;
                 for (; sharedParamDef.current() != sharedParamDef.end(); sharedParamDef.moveNext())
@@ -601,30 +603,29 @@ namespace Ogre {
                     sharedParamNames.push_back(sharedParamDef.current()->first.c_str());
                 }
 
-                std::vector<GLuint> uniformParamIndices(sharedParamNames.size());
-                std::vector<GLint> uniformParamOffsets(sharedParamNames.size());
-
-                OGRE_CHECK_GL_ERROR(glGetUniformIndices(programObject, sharedParamNames.size(), &sharedParamNames[0], &uniformParamIndices[0]));
-                //FIXME debug this (see stdout)
-                OGRE_CHECK_GL_ERROR(glGetActiveUniformsiv(programObject, uniformParamIndices.size(), &uniformParamIndices[0], GL_UNIFORM_OFFSET, &uniformParamOffsets[0]));
-                //TODO handle uniform arrays
-                //GL_UNIFORM_ARRAY_STRIDE
-                //TODO handle matrices
-                //GL_UNIFORM_MATRIX_STRIDE
-
-                GpuNamedConstants& consts = const_cast<GpuNamedConstants&>(blockSharedParams->getConstantDefinitions());
-                MapIterator<GpuConstantDefinitionMap> sharedParamDefMut(consts.map);
-                for (size_t i = 0; sharedParamDefMut.current() != sharedParamDefMut.end(); sharedParamDefMut.moveNext(), i++)
+                if (!sharedParamNames.empty())
                 {
-                    // NOTE: the naming in GL3Plus is backward. logicalIndex is actually the physical index of the parameter
-                    // while the physicalIndex is the logical array offset..
-                    sharedParamDefMut.current()->second.logicalIndex = uniformParamOffsets[i];
+                    std::vector<GLuint> uniformParamIndices(sharedParamNames.size());
+                    std::vector<GLint> uniformParamOffsets(sharedParamNames.size());
+                    std::vector<GLint> uniformParamArrayStrides(sharedParamNames.size());
+
+                    OGRE_CHECK_GL_ERROR(glGetUniformIndices(programObject, sharedParamNames.size(), &sharedParamNames[0], &uniformParamIndices[0]));
+                    for (size_t i = 0; i < uniformParamIndices.size(); ++i)
+                    {
+                        // Declared in the shared parameters but not in the block
+                        if (uniformParamIndices[i] == GL_INVALID_INDEX)
+                            continue;
+
+                        OGRE_CHECK_GL_ERROR(glGetActiveUniformsiv(programObject, 1, &uniformParamIndices[i], GL_UNIFORM_OFFSET, &uniformParamOffsets[i]));
+                        OGRE_CHECK_GL_ERROR(glGetActiveUniformsiv(programObject, 1, &uniformParamIndices[i], GL_UNIFORM_ARRAY_STRIDE, &uniformParamArrayStrides[i]));
+                        blockSharedParams->_setHardwareBufferOffset(sharedParamNames[i], uniformParamOffsets[i], uniformParamArrayStrides[i]);
+                    }
                 }
             }
 
-            GLint bufferBinding = hwGlBuffer->getGLBufferBinding();
-
-            //OGRE_CHECK_GL_ERROR(glGetActiveUniformBlockiv(programObject, index, GL_UNIFORM_BLOCK_BINDING, &blockBinding));
+            const HardwareUniformBufferSharedPtr& uniformBuffer = blockSharedParams->_getHardwareBuffer();
+            sharedParamsBufferMap[blockSharedParams] = uniformBuffer;
+            GLint bufferBinding = static_cast<GL3PlusHardwareUniformBuffer*>(uniformBuffer.get())->getGLBufferBinding();
 
             OGRE_CHECK_GL_ERROR(glUniformBlockBinding(programObject, index, bufferBinding));
         }
@@ -728,4 +729,64 @@ namespace Ogre {
             }
         }
     }
+
+
+    size_t GLSLProgramManager::extractPackedUniformsFromProgram(
+        GLuint programObject,
+        const GpuConstantDefinitionMap* (&constantDefs)[6],
+        GLPackedUniformReferenceList& packedUniformList)
+    {
+        GLuint blockIndex;
+        OGRE_CHECK_GL_ERROR(blockIndex = glGetUniformBlockIndex(programObject, PACKED_UNIFORM_BLOCK_NAME.c_str()));
+        if (blockIndex == GL_INVALID_INDEX)
+            return 0;
+
+        GLint blockSize = 0, uniformCount = 0;
+        OGRE_CHECK_GL_ERROR(glGetActiveUniformBlockiv(programObject, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize));
+        OGRE_CHECK_GL_ERROR(glGetActiveUniformBlockiv(programObject, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &uniformCount));
+        if (uniformCount == 0)
+            return 0;
+
+        vector<GLint>::type uniformIndices(uniformCount);
+        OGRE_CHECK_GL_ERROR(glGetActiveUniformBlockiv(programObject, blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES,
+                                                      &uniformIndices[0]));
+        OGRE_CHECK_GL_ERROR(glUniformBlockBinding(programObject, blockIndex, mRenderSystem->getPackedUniformBinding()));
+
+        char uniformName[uniformLength];
+        for (GLint i = 0; i < uniformCount; i++)
+        {
+            GLuint index = uniformIndices[i];
+            OGRE_CHECK_GL_ERROR(glGetActiveUniformName(programObject, index, uniformLength, NULL, uniformName));
+
+            // Members of a block with an instance name are prefixed with the block name
+            String paramName = String(uniformName);
+            String::size_type dotPos = paramName.find(".");
+            if (dotPos != String::npos)
+                paramName = paramName.substr(dotPos + 1);
+            // Arrays are listed once, as their first element
+            String::size_type arrayStart = paramName.find("[");
+            if (arrayStart != String::npos)
+                paramName = paramName.substr(0, arrayStart);
+
+            GLUniformReference uniformReference;
+            if (!findUniformDataSource(paramName, constantDefs, uniformReference))
+                continue;
+
+            GLPackedUniformReference newGLPackedUniformReference;
+            GLint rowMajor;
+            OGRE_CHECK_GL_ERROR(glGetActiveUniformsiv(programObject, 1, &index, GL_UNIFORM_OFFSET,
+                                                      &newGLPackedUniformReference.mOffset));
+            OGRE_CHECK_GL_ERROR(glGetActiveUniformsiv(programObject, 1, &index, GL_UNIFORM_ARRAY_STRIDE,
+                                                      &newGLPackedUniformReference.mArrayStride));
+            OGRE_CHECK_GL_ERROR(glGetActiveUniformsiv(programObject, 1, &index, GL_UNIFORM_MATRIX_STRIDE,
+                                                      &newGLPackedUniformReference.mMatrixStride));
+            OGRE_CHECK_GL_ERROR(glGetActiveUniformsiv(programObject, 1, &index, GL_UNIFORM_IS_ROW_MAJOR, &rowMajor));
+            newGLPackedUniformReference.mRowMajor = rowMajor != 0;
+            newGLPackedUniformReference.mSourceProgType = uniformReference.mSourceProgType;
+            newGLPackedUniformReference.mConstantDef = uniformReference.mConstantDef;
+            packedUniformList.push_back(newGLPackedUniformReference);
+        }
+
+        return blockSize;
+    }
 }
@@ -30,6 +30,7 @@
 #include "OgreStringConverter.h"
 #include "OgreGLSLShader.h"
 #include "OgreGLSLSeparableProgramManager.h"
+#include "OgreRoot.h"
 #include "OgreGpuProgramManager.h"
 #include "OgreGLUtil.h"
 #include "OgreLogManager.h"
@@ -141,7 +142,7 @@ namespace Ogre
             {
                 GLint linkStatus = 0;
 
-                String programName = program->getName();
+                String programName = getBinaryCacheName(program);
 
                 GLuint programHandle = program->getGLProgramHandle();
 
@@ -169,7 +170,10 @@ namespace Ogre
 
                     OGRE_CHECK_GL_ERROR(glGetProgramiv(programHandle, GL_LINK_STATUS, &linkStatus));
                     if (!linkStatus)
+                    {
                         logObjectInfo("Could not use cached binary " + programName, programHandle);
+                        GpuProgramManager::getSingleton().removeMicrocodeFromCache(programName);
+                    }
                 }
 
                 // Compilation needed if precompiled program is
@@ -339,6 +343,7 @@ namespace Ogre
         // Iterate through uniform reference list and update uniform values
         GLUniformReferenceIterator currentUniform = mGLUniformReferences.begin();
         GLUniformReferenceIterator endUniform = mGLUniformReferences.end();
+        size_t uniformBytes = 0;
         for (; currentUniform != endUniform; ++currentUniform)
         {
             // Only pull values from buffer it's supposed to be in (vertex or fragment)
@@ -380,6 +385,8 @@ namespace Ogre
                     {
                         continue;
                     }
+                    uniformBytes += def->elementSize * def->arraySize *
+                        (def->isDouble() ? sizeof(double) : sizeof(float));
 
                     // Get the index in the parameter real list
                     switch (def->constType)
@@ -545,6 +552,8 @@ namespace Ogre
             } // fromProgType == currentUniform->mSourceProgType
 
         } // End for
+
+        Root::getSingleton().getRenderSystem()->_getCurrentRenderStats().uniformBytes += uniformBytes;
     }
 
 
@@ -604,78 +613,7 @@ namespace Ogre
     void GLSLSeparableProgram::updateUniformBlocks(GpuProgramParametersSharedPtr params,
                                                    uint16 mask, GpuProgramType fromProgType)
     {
-        //TODO Support uniform block arrays - need to figure how to do this via material.
-
-        // Iterate through the list of uniform blocks and update them as needed.
-        SharedParamsBufferMap::const_iterator currentPair = mSharedParamsBufferMap.begin();
-        SharedParamsBufferMap::const_iterator endPair = mSharedParamsBufferMap.end();
-
-        // const GpuProgramParameters::GpuSharedParamUsageList& sharedParams = params->getSharedParameters();
-
-        // const GpuProgramParameters::GpuSharedParamUsageList& sharedParams = params->getSharedParameters();
-        // GpuProgramParameters::GpuSharedParamUsageList::const_iterator it, end = sharedParams.end();
-
-        for (; currentPair != endPair; ++currentPair)
-        {
-            // force const call to get*Pointer
-            const GpuSharedParameters* paramsPtr = currentPair->first.get();
-
-            //FIXME Possible buffer does not exist if no associated uniform block.
-            HardwareUniformBuffer* hwGlBuffer = currentPair->second.get();
-
-            if (!paramsPtr->isDirty()) continue;
-
-            //FIXME does not check if current progrtype, or if shared param is active
-
-            GpuConstantDefinitionIterator parami = paramsPtr->getConstantDefinitionIterator();
-
-            for (int i = 0; parami.current() != parami.end(); parami.moveNext(), i++)
-            {
-                //String name = parami->;
-                //GpuConstantDefinition * param = GpuConstantConstantDefinition(name);
-
-                //const String* name = &parami.current()->first;
-                const GpuConstantDefinition* param = &parami.current()->second;
-
-                BaseConstantType baseType = GpuConstantDefinition::getBaseType(param->constType);
-
-                const void* dataPtr;
-
-                // NOTE: the naming is backward. this is the logical index
-                size_t index =  param->physicalIndex;
-
-                //TODO Maybe move to GpuSharedParams?  Otherwise create bool buffer.
-                switch (baseType)
-                {
-                case BCT_FLOAT:
-                    dataPtr = paramsPtr->getFloatPointer(index);
-                    break;
-                case BCT_INT:
-                    dataPtr = paramsPtr->getIntPointer(index);
-                    break;
-                case BCT_DOUBLE:
-                    dataPtr = paramsPtr->getDoublePointer(index);
-                    break;
-                case BCT_UINT:
-                case BCT_BOOL:
-                    dataPtr = paramsPtr->getUnsignedIntPointer(index);
-                    break;
-                case BCT_SAMPLER:
-                case BCT_SUBROUTINE:
-                    //TODO implement me!
-                default:
-                    //TODO error handling
-                    continue;
-                }
-
-                // in bytes
-                size_t length = param->arraySize * param->elementSize * 4;
-
-                // NOTE: the naming is backward. this is the physical offset in bytes
-                size_t offset = param->logicalIndex;
-                hwGlBuffer->writeData(offset, length, dataPtr);
-            }
-        }
+        updateSharedParamsBuffers();
     }
 
 
@@ -39,6 +39,11 @@
 #include "OgreGLSLSeparableProgramManager.h"
 #include "OgreGLUtil.h"
 #include "OgreGLUniformCache.h"
+#include "OgreGL3PlusRenderSystem.h"
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
 
 namespace Ogre {
     GLSLShader::GLSLShader(
@@ -48,6 +53,7 @@ namespace Ogre {
         : GLSLShaderCommon(creator, name, handle, group, isManual, loader)
         , mGLShaderHandle(0)
         , mGLProgramHandle(0)
+        , mCompileSubmitted(false)
     {
         if (createParamDictionary("GLSLShader"))
         {
@@ -106,11 +112,22 @@ namespace Ogre {
         }
     }
 
-    bool GLSLShader::compile(bool checkErrors)
+    void GLSLShader::loadFromSource(void)
     {
-        if (mCompiled == 1)
+        GLSLShaderCommon::loadFromSource();
+
+        // Start compiling right away, so the driver threads work on it until the
+        // shader is linked
+        if (static_cast<GL3PlusRenderSystem*>(Root::getSingleton().getRenderSystem())->_hasParallelShaderCompile())
+            submitCompile();
+    }
+
+
+    void GLSLShader::submitCompile(void)
+    {
+        if (mCompileSubmitted || mCompiled == 1)
         {
-            return true;
+            return;
         }
 
         // Create shader object.
@@ -182,6 +199,34 @@ namespace Ogre {
         }
 
         OGRE_CHECK_GL_ERROR(glCompileShader(mGLShaderHandle));
+        mCompileSubmitted = true;
+    }
+
+
+    bool GLSLShader::isCompileComplete(void)
+    {
+        if (!mCompileSubmitted ||
+            !static_cast<GL3PlusRenderSystem*>(Root::getSingleton().getRenderSystem())->_hasParallelShaderCompile())
+        {
+            return true;
+        }
+
+        GLint complete = GL_TRUE;
+        OGRE_CHECK_GL_ERROR(glGetShaderiv(mGLShaderHandle, GL_COMPLETION_STATUS_KHR, &complete));
+        return complete == GL_TRUE;
+    }
+
+
+    bool GLSLShader::compile(bool checkErrors)
+    {
+        if (mCompiled == 1)
+        {
+            return true;
+        }
+
+        // Submit unless that was done when loading, the status query waits for the driver
+        submitCompile();
+        mCompileSubmitted = false;
 
         // Check for compile errors
         OGRE_CHECK_GL_ERROR(glGetShaderiv(mGLShaderHandle, GL_COMPILE_STATUS, &mCompiled));
@@ -219,6 +264,7 @@ namespace Ogre {
         mGLShaderHandle = 0;
         mGLProgramHandle = 0;
         mCompiled = 0;
+        mCompileSubmitted = false;
     }
 
     void GLSLShader::buildConstantDefinitions() const
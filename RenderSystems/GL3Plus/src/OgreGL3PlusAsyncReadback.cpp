@@ -0,0 +1,101 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreGL3PlusAsyncReadback.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
+
+namespace Ogre {
+
+    GL3PlusAsyncReadback::GL3PlusAsyncReadback(GL3PlusRenderSystem* renderSystem,
+                                               const PixelBox& layout, const Box& box, bool flip)
+        : AsyncReadback(box.getWidth(), box.getHeight(), box.getDepth(), layout.format),
+          mRenderSystem(renderSystem), mBufferId(0), mSync(0), mLayout(layout), mBox(box), mFlip(flip)
+    {
+        OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mBufferId));
+        mRenderSystem->_getStateCacheManager()->bindGLBuffer(GL_PIXEL_PACK_BUFFER, mBufferId);
+        OGRE_CHECK_GL_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER, mLayout.getConsecutiveSize(), NULL,
+                                         GL_STREAM_READ));
+    }
+
+    GL3PlusAsyncReadback::~GL3PlusAsyncReadback()
+    {
+        if (mSync)
+            OGRE_CHECK_GL_ERROR(glDeleteSync(mSync));
+        if (GL3PlusStateCacheManager* stateCacheManager = mRenderSystem->_getStateCacheManager())
+            stateCacheManager->deleteGLBuffer(GL_PIXEL_PACK_BUFFER, mBufferId);
+    }
+
+    void GL3PlusAsyncReadback::fence(void)
+    {
+        // Reads into client memory must not go to the buffer
+        mRenderSystem->_getStateCacheManager()->bindGLBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        OGRE_CHECK_GL_ERROR(mSync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        // Submit the commands, or polling the fence may never see it signalled
+        OGRE_CHECK_GL_ERROR(glFlush());
+    }
+
+    bool GL3PlusAsyncReadback::isReady(void)
+    {
+        if (!mSync)
+            return true;
+
+        GLenum result;
+        OGRE_CHECK_GL_ERROR(result = glClientWaitSync(mSync, 0, 0));
+        return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+    }
+
+    void GL3PlusAsyncReadback::fetch(const PixelBox& dst)
+    {
+        if (mSync)
+        {
+            GLenum result;
+            do
+            {
+                OGRE_CHECK_GL_ERROR(result = glClientWaitSync(mSync, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                                              1000000));
+            } while (result == GL_TIMEOUT_EXPIRED);
+
+            OGRE_CHECK_GL_ERROR(glDeleteSync(mSync));
+            mSync = 0;
+        }
+
+        GL3PlusStateCacheManager* stateCacheManager = mRenderSystem->_getStateCacheManager();
+        stateCacheManager->bindGLBuffer(GL_PIXEL_PACK_BUFFER, mBufferId);
+        PixelBox pixels = mLayout;
+        OGRE_CHECK_GL_ERROR(pixels.data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                           mLayout.getConsecutiveSize(),
+                                                           GL_MAP_READ_BIT));
+        copyPixels(pixels.getSubVolume(mBox), dst);
+        OGRE_CHECK_GL_ERROR(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+        stateCacheManager->bindGLBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        if (mFlip)
+            PixelUtil::bulkPixelVerticalFlip(dst);
+    }
+}
@@ -30,11 +30,13 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreRoot.h"
 #include "OgreGL3PlusRenderSystem.h"
 #include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusRingBuffer.h"
 
 namespace Ogre {
 
     GL3PlusHardwareBuffer::GL3PlusHardwareBuffer(GLenum target, size_t sizeInBytes, GLenum usage)
-    : mTarget(target), mSizeInBytes(sizeInBytes), mUsage(usage)
+    : mTarget(target), mSizeInBytes(sizeInBytes), mUsage(usage),
+      mLockStaged(false), mLockOffset(0), mStagingOffset(0)
     {
         mRenderSystem = static_cast<GL3PlusRenderSystem*>(Root::getSingleton().getRenderSystem());
 
@@ -58,9 +60,53 @@ namespace Ogre {
             stateCacheManager->deleteGLBuffer(mTarget,mBufferId);
     }
 
+    GL3PlusRingBuffer* GL3PlusHardwareBuffer::getStagingRingBuffer(size_t length) const
+    {
+        // Only buffers refilled all the time are worth staging, and large
+        // updates are left out so they do not take up the ring from the others
+        GL3PlusRingBuffer* ringBuffer = mRenderSystem->_getRingBuffer();
+        if (ringBuffer &&
+            (mUsage & HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE) ==
+                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE &&
+            length <= ringBuffer->getSizeInBytes() / 4)
+        {
+            return ringBuffer;
+        }
+        return 0;
+    }
+
+    void GL3PlusHardwareBuffer::copyFromRingBuffer(GL3PlusRingBuffer* ringBuffer, size_t stagingOffset,
+                                                   size_t offset, size_t length)
+    {
+        GL3PlusStateCacheManager* stateCacheManager = mRenderSystem->_getStateCacheManager();
+        stateCacheManager->bindGLBuffer(GL_COPY_READ_BUFFER, ringBuffer->getGLBufferId());
+        stateCacheManager->bindGLBuffer(GL_COPY_WRITE_BUFFER, mBufferId);
+
+        OGRE_CHECK_GL_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                                stagingOffset, offset, length));
+
+        stateCacheManager->bindGLBuffer(GL_COPY_READ_BUFFER, 0);
+        stateCacheManager->bindGLBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
     void* GL3PlusHardwareBuffer::lockImpl(size_t offset, size_t length,
                                           HardwareBuffer::LockOptions options)
     {
+        // Only locks which give up the old contents are staged, as the whole
+        // range is copied back. HBL_NORMAL and HBL_WRITE_ONLY keep the bytes
+        // the caller leaves alone, so they map the buffer itself.
+        if (options == HardwareBuffer::HBL_DISCARD || options == HardwareBuffer::HBL_NO_OVERWRITE)
+        {
+            if (GL3PlusRingBuffer* ringBuffer = getStagingRingBuffer(length))
+            {
+                // The ring buffer space can be handed out as it is
+                mLockStaged = true;
+                mLockOffset = offset;
+                mStagingOffset = ringBuffer->allocate(length);
+                return ringBuffer->getMappedData(mStagingOffset);
+            }
+        }
+
         GLenum access = 0;
 
         // Use glMapBuffer
@@ -102,6 +148,13 @@ namespace Ogre {
 
     void GL3PlusHardwareBuffer::unlockImpl(size_t lockSize)
     {
+        if (mLockStaged)
+        {
+            mLockStaged = false;
+            copyFromRingBuffer(mRenderSystem->_getRingBuffer(), mStagingOffset, mLockOffset, lockSize);
+            return;
+        }
+
         mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
 
         if (mUsage & HardwareBuffer::HBU_WRITE_ONLY)
@@ -130,6 +183,14 @@ namespace Ogre {
     void GL3PlusHardwareBuffer::writeData(size_t offset, size_t length, const void* pSource,
                                           bool discardWholeBuffer)
     {
+        if (GL3PlusRingBuffer* ringBuffer = getStagingRingBuffer(length))
+        {
+            size_t stagingOffset = ringBuffer->allocate(length);
+            memcpy(ringBuffer->getMappedData(stagingOffset), pSource, length);
+            copyFromRingBuffer(ringBuffer, stagingOffset, offset, length);
+            return;
+        }
+
         mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
 
         if (offset == 0 && length == mSizeInBytes)
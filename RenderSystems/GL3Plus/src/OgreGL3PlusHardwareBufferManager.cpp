@@ -204,6 +204,9 @@ namespace Ogre {
         case VET_USHORT2_NORM:
         case VET_USHORT4_NORM:
             return GL_UNSIGNED_SHORT;
+        case VET_HALF2:
+        case VET_HALF4:
+            return GL_HALF_FLOAT;
         case VET_COLOUR:
         case VET_COLOUR_ABGR:
         case VET_COLOUR_ARGB:
@@ -0,0 +1,67 @@
+/*
+  -----------------------------------------------------------------------------
+  This source file is part of OGRE
+  (Object-oriented Graphics Rendering Engine)
+  For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+  -----------------------------------------------------------------------------
+*/
+
+#include "OgreGL3PlusHardwareTimerQuery.h"
+
+namespace Ogre {
+
+    GL3PlusHardwareTimerQuery::GL3PlusHardwareTimerQuery()
+    {
+        OGRE_CHECK_GL_ERROR(glGenQueries(1, &mQueryID));
+    }
+
+    GL3PlusHardwareTimerQuery::~GL3PlusHardwareTimerQuery()
+    {
+        OGRE_CHECK_GL_ERROR(glDeleteQueries(1, &mQueryID));
+    }
+
+    void GL3PlusHardwareTimerQuery::queryTimestamp(void)
+    {
+        OGRE_CHECK_GL_ERROR(glQueryCounter(mQueryID, GL_TIMESTAMP));
+    }
+
+    bool GL3PlusHardwareTimerQuery::isStillOutstanding(void)
+    {
+        GLuint available = GL_FALSE;
+
+        OGRE_CHECK_GL_ERROR(glGetQueryObjectuiv(mQueryID, GL_QUERY_RESULT_AVAILABLE, &available));
+
+        // GL_TRUE means a wait would occur
+        return !(available == GL_TRUE);
+    }
+
+    bool GL3PlusHardwareTimerQuery::pullTimestamp(uint64* nanoseconds)
+    {
+        GLuint64 timestamp = 0;
+
+        OGRE_CHECK_GL_ERROR(glGetQueryObjectui64v(mQueryID, GL_QUERY_RESULT, &timestamp));
+        *nanoseconds = timestamp;
+        return true;
+    }
+
+}
@@ -46,12 +46,15 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreException.h"
 #include "OgreGLSLExtSupport.h"
 #include "OgreGL3PlusHardwareOcclusionQuery.h"
+#include "OgreGL3PlusHardwareTimerQuery.h"
 #include "OgreGL3PlusDepthBuffer.h"
 #include "OgreGL3PlusHardwarePixelBuffer.h"
 #include "OgreGLContext.h"
 #include "OgreGLSLShaderFactory.h"
 #include "OgreGL3PlusFBORenderTexture.h"
 #include "OgreGL3PlusHardwareBufferManager.h"
+#include "OgreGL3PlusRingBuffer.h"
+#include "OgreGL3PlusAsyncReadback.h"
 #include "OgreGLSLSeparableProgramManager.h"
 #include "OgreGLSLSeparableProgram.h"
 #include "OgreGLSLMonolithicProgramManager.h"
@@ -129,8 +132,41 @@ namespace Ogre {
         return (GL3WglProc)glsupport->getProcAddress(proc);
     }
 
+    /// Gets the component count and normalisation GL expects for a vertex element type
+    static void getGLVertexFormat(VertexElementType type, unsigned short& typeCount, GLboolean& normalised)
+    {
+        typeCount = VertexElement::getTypeCount(type);
+        normalised = GL_FALSE;
+        switch(type)
+        {
+        case VET_COLOUR:
+        case VET_COLOUR_ABGR:
+        case VET_COLOUR_ARGB:
+            // Because GL takes these as a sequence of single unsigned bytes, count needs to be 4
+            // VertexElement::getTypeCount treats them as 1 (RGBA)
+            // Also need to normalise the fixed-point data
+            typeCount = 4;
+            normalised = GL_TRUE;
+            break;
+        case VET_UBYTE4_NORM:
+        case VET_SHORT2_NORM:
+        case VET_USHORT2_NORM:
+        case VET_SHORT4_NORM:
+        case VET_USHORT4_NORM:
+            normalised = GL_TRUE;
+            break;
+        default:
+            break;
+        };
+    }
+
     GL3PlusRenderSystem::GL3PlusRenderSystem()
-        : mDepthWrite(true),
+        : mHasSamplerObjects(false),
+          mSamplersDirty(false),
+          mHasBindlessTexture(false),
+          mBindlessTexturesEnabled(false),
+          mWarningTextureHandle(0),
+          mDepthWrite(true),
           mScissorsEnabled(false),
           mStencilWriteMask(0xFFFFFFFF),
           mStateCacheManager(0),
@@ -138,7 +174,23 @@ namespace Ogre {
           mGLSLShaderFactory(0),
           mHardwareBufferManager(0),
           mRTTManager(0),
-          mActiveTextureUnit(0)
+          mActiveTextureUnit(0),
+          mRingBuffer(0),
+          mPackedUniformBinding(0),
+          mUniformBufferOffsetAlignment(256),
+          mHasVertexAttribBinding(false),
+          mHasMultiDrawIndirect(false),
+          mHasParallelShaderCompile(false),
+          mDrawBatchOpen(false),
+          mDrawBatchDataBinding(0),
+          mDrawBatchVao(0),
+          mDrawBatchIndexBuffer(0),
+          mDrawBatchIndexType(0),
+          mDrawBatchPrimType(0),
+          mDrawBatchPooled(false),
+          mDrawBatchWorldMatrix(Matrix4::IDENTITY),
+          mDrawIndirectBuffer(0),
+          mDrawIndirectBufferSize(0)
     {
         size_t i;
 
@@ -156,7 +208,12 @@ namespace Ogre {
         {
             // Dummy value
             mTextureTypes[i] = 0;
+            mBindlessHandles[i] = 0;
+            mBindlessPendingTextures[i] = 0;
+            mUnboundTextures[i] = 0;
+            mBoundSamplers[i] = ~0u;
         }
+        memset(mSamplerDescs, 0, sizeof(mSamplerDescs));
 
         mActiveRenderTarget = 0;
         mCurrentContext = 0;
@@ -548,6 +605,19 @@ namespace Ogre {
         // Use VBO's by default
         mHardwareBufferManager = new GL3PlusHardwareBufferManager();
 
+        // Stage dynamic buffer updates in a persistently mapped ring buffer, which
+        // is large enough for a few frames of typical billboard and overlay data
+        if (hasMinGLVersion(4, 4) || checkExtension("GL_ARB_buffer_storage"))
+        {
+            LogManager::getSingleton().logMessage("GL3+: Using a persistently mapped ring buffer for dynamic buffers");
+            mRingBuffer = new GL3PlusRingBuffer(16 * 1024 * 1024);
+        }
+        OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &mUniformBufferOffsetAlignment));
+        // Keep the packed uniform block out of the way of shared parameter blocks, which count up from 0
+        GLint maxUniformBufferBindings;
+        OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxUniformBufferBindings));
+        mPackedUniformBinding = maxUniformBufferBindings - 1;
+
         // Use FBO's for RTT, PBuffers and Copy are no longer supported
         // Create FBO manager
         LogManager::getSingleton().logMessage("GL3+: Using FBOs for rendering to textures");
@@ -572,8 +642,80 @@ namespace Ogre {
         mGLInitialised = true;
     }
 
+    void GL3PlusRenderSystem::_insertFrameFence(void)
+    {
+        GLsync sync;
+        OGRE_CHECK_GL_ERROR(sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        mFrameFences.push_back(sync);
+    }
+
+    void GL3PlusRenderSystem::_waitFrameFences(size_t maxPending)
+    {
+        while (mFrameFences.size() > maxPending)
+        {
+            GLenum result;
+            do
+            {
+                // Flush on the first wait, or the fence may never be signalled
+                OGRE_CHECK_GL_ERROR(result = glClientWaitSync(mFrameFences.front(),
+                                                              GL_SYNC_FLUSH_COMMANDS_BIT, 1000000));
+            } while (result == GL_TIMEOUT_EXPIRED);
+
+            OGRE_CHECK_GL_ERROR(glDeleteSync(mFrameFences.front()));
+            mFrameFences.pop_front();
+        }
+    }
+
+    void GL3PlusRenderSystem::_discardRenderTarget(RenderTarget* target, unsigned int buffers)
+    {
+        if (!hasMinGLVersion(4, 3) && !checkExtension("GL_ARB_invalidate_subdata"))
+            return;
+
+        GLenum attachments[OGRE_MAX_MULTIPLE_RENDER_TARGETS + 2];
+        GLsizei count = 0;
+
+        GL3PlusFrameBufferObject *fbo = 0;
+        target->getCustomAttribute(GLRenderTexture::CustomAttributeString_FBO, &fbo);
+        if (fbo)
+        {
+            for (size_t x = 0; (buffers & FBT_COLOUR) && x < OGRE_MAX_MULTIPLE_RENDER_TARGETS; ++x)
+            {
+                if (fbo->getSurface(x).buffer)
+                    attachments[count++] = static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + x);
+            }
+            if (buffers & FBT_DEPTH)
+                attachments[count++] = GL_DEPTH_ATTACHMENT;
+            if (buffers & FBT_STENCIL)
+                attachments[count++] = GL_STENCIL_ATTACHMENT;
+        }
+        else
+        {
+            // The default framebuffer names its buffers directly
+            if (buffers & FBT_COLOUR)
+                attachments[count++] = GL_COLOR;
+            if (buffers & FBT_DEPTH)
+                attachments[count++] = GL_DEPTH;
+            if (buffers & FBT_STENCIL)
+                attachments[count++] = GL_STENCIL;
+        }
+
+        if (!count)
+            return;
+
+        // Bind the target for the call only, the viewport may skip binding it again
+        RenderTarget* previous = mActiveRenderTarget;
+        if (previous != target)
+            _setRenderTarget(target);
+        OGRE_CHECK_GL_ERROR(glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, count, attachments));
+        if (previous != target)
+            _setRenderTarget(previous);
+    }
+
     void GL3PlusRenderSystem::shutdown(void)
     {
+        // Release the fences while the context is alive
+        _waitFrameFences(0);
+
         RenderSystem::shutdown();
 
         // Deleting the GLSL program factory
@@ -590,6 +732,19 @@ namespace Ogre {
         OGRE_DELETE mShaderManager;
         mShaderManager = 0;
 
+        destroySamplers();
+
+        if (GpuProgramManager::getSingletonPtr())
+            GpuProgramManager::getSingleton()._releaseSharedParametersBuffers();
+
+        delete mDrawIndirectBuffer;
+        mDrawIndirectBuffer = 0;
+        mDrawIndirectBufferSize = 0;
+        mDrawDataBuffer.reset();
+
+        delete mRingBuffer;
+        mRingBuffer = 0;
+
         OGRE_DELETE mHardwareBufferManager;
         mHardwareBufferManager = 0;
 
@@ -839,6 +994,7 @@ namespace Ogre {
                                                   bool attenuationEnabled, Real constant, Real linear, Real quadratic,
                                                   Real minSize, Real maxSize)
     {
+        flushDrawBatch();
 
         if (attenuationEnabled)
         {
@@ -871,6 +1027,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setPointSpritesEnabled(bool enabled)
     {
+        flushDrawBatch();
         // Point sprites are always on in OpenGL 3.2 and up.
     }
 
@@ -878,6 +1035,43 @@ namespace Ogre {
     {
         GL3PlusTexturePtr tex = static_pointer_cast<GL3PlusTexture>(texPtr);
 
+        mBindlessPendingTextures[stage] = 0;
+        if (mBindlessTexturesEnabled && enabled)
+        {
+            if (!tex || tex->hasBindlessHandle())
+            {
+                // Passed by handle when drawing, the unit is only bound for programs
+                // without bindless samplers
+                if (tex)
+                {
+                    tex->touch();
+                    mTextureTypes[stage] = tex->getGL3PlusTextureTarget();
+                    mUnboundTextures[stage] = tex->getGLID();
+                    mBindlessHandles[stage] = tex->getBindlessHandle();
+                }
+                else
+                {
+                    mTextureTypes[stage] = GL_TEXTURE_2D;
+                    mUnboundTextures[stage] = static_cast<GL3PlusTextureManager*>(mTextureManager)->getWarningTextureID();
+                    if (!mWarningTextureHandle)
+                    {
+                        OGRE_CHECK_GL_ERROR(mWarningTextureHandle = glGetTextureHandleARB(mUnboundTextures[stage]));
+                        OGRE_CHECK_GL_ERROR(glMakeTextureHandleResidentARB(mWarningTextureHandle));
+                    }
+                    mBindlessHandles[stage] = mWarningTextureHandle;
+                }
+                return;
+            }
+
+            // Bound as usual so that the sampling state set next still applies
+            // to it, the handle is created once that is done
+            mBindlessPendingTextures[stage] = tex.get();
+        }
+        mBindlessHandles[stage] = 0;
+        mUnboundTextures[stage] = 0;
+
+        flushDrawBatch();
+
         if (!mStateCacheManager->activateGLTextureUnit(stage))
             return;
 
@@ -958,6 +1152,21 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setTextureAddressingMode(size_t stage, const TextureUnitState::UVWAddressingMode& uvw)
     {
+        if (mBindlessHandles[stage]) // fixed by the texture handle
+            return;
+
+        if (useSamplerObjects())
+        {
+            SamplerDesc& desc = mSamplerDescs[stage];
+            desc.wrap[0] = getTextureAddressingMode(uvw.u);
+            desc.wrap[1] = getTextureAddressingMode(uvw.v);
+            desc.wrap[2] = getTextureAddressingMode(uvw.w);
+            // only set again when a border is used, so stages without one share samplers
+            memset(desc.borderColour, 0, sizeof(desc.borderColour));
+            mSamplersDirty = true;
+            return;
+        }
+
         if (!mStateCacheManager->activateGLTextureUnit(stage))
             return;
         mStateCacheManager->setTexParameteri( mTextureTypes[stage], GL_TEXTURE_WRAP_S,
@@ -971,7 +1180,17 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setTextureBorderColour(size_t stage, const ColourValue& colour)
     {
+        if (mBindlessHandles[stage]) // fixed by the texture handle
+            return;
+
         GLfloat border[4] = { colour.r, colour.g, colour.b, colour.a };
+        if (useSamplerObjects())
+        {
+            memcpy(mSamplerDescs[stage].borderColour, border, sizeof(border));
+            mSamplersDirty = true;
+            return;
+        }
+
         if (mStateCacheManager->activateGLTextureUnit(stage))
         {
             OGRE_CHECK_GL_ERROR(glTexParameterfv( mTextureTypes[stage], GL_TEXTURE_BORDER_COLOR, border));
@@ -981,6 +1200,16 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setTextureMipmapBias(size_t stage, float bias)
     {
+        if (mBindlessHandles[stage]) // fixed by the texture handle
+            return;
+
+        if (useSamplerObjects())
+        {
+            mSamplerDescs[stage].mipmapBias = bias;
+            mSamplersDirty = true;
+            return;
+        }
+
         if (mStateCacheManager->activateGLTextureUnit(stage))
         {
             OGRE_CHECK_GL_ERROR(glTexParameterf(mTextureTypes[stage], GL_TEXTURE_LOD_BIAS, bias));
@@ -1020,6 +1249,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor, SceneBlendOperation op)
     {
+        flushDrawBatch();
         GLenum sourceBlend = getBlendMode(sourceFactor);
         GLenum destBlend = getBlendMode(destFactor);
         if (sourceFactor == SBF_ONE && destFactor == SBF_ZERO)
@@ -1060,6 +1290,7 @@ namespace Ogre {
         SceneBlendFactor sourceFactorAlpha, SceneBlendFactor destFactorAlpha,
         SceneBlendOperation op, SceneBlendOperation alphaOp )
     {
+        flushDrawBatch();
         GLenum sourceBlend = getBlendMode(sourceFactor);
         GLenum destBlend = getBlendMode(destFactor);
         GLenum sourceBlendAlpha = getBlendMode(sourceFactorAlpha);
@@ -1121,11 +1352,13 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setAlphaRejectSettings(CompareFunction func, unsigned char value, bool alphaToCoverage)
     {
+        flushDrawBatch();
         mStateCacheManager->setEnabled(GL_SAMPLE_ALPHA_TO_COVERAGE, (func != CMPF_ALWAYS_PASS) && alphaToCoverage);
     }
 
     void GL3PlusRenderSystem::_setViewport(Viewport *vp)
     {
+        flushDrawBatch();
         // Check if viewport is different
         if (!vp)
         {
@@ -1181,6 +1414,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_endFrame(void)
     {
+        flushDrawBatch();
         // Deactivate the viewport clipping.
         mScissorsEnabled = false;
         mStateCacheManager->setEnabled(GL_SCISSOR_TEST, false);
@@ -1199,10 +1433,15 @@ namespace Ogre {
             if (mDriverVersion.minor >= 3)
                 unbindGpuProgram(GPT_COMPUTE_PROGRAM);
         }
+
+        // Retire the dynamic buffer updates of this frame once the GPU is done with them
+        if (mRingBuffer)
+            mRingBuffer->fence();
     }
 
     void GL3PlusRenderSystem::_setCullingMode(CullingMode mode)
     {
+        flushDrawBatch();
         mCullingMode = mode;
         // NB: Because two-sided stencil API dependence of the front face, we must
         // use the same 'winding' for the front face everywhere. As the OGRE default
@@ -1258,6 +1497,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setDepthBufferCheckEnabled(bool enabled)
     {
+        flushDrawBatch();
         if (enabled)
         {
             mStateCacheManager->setClearDepth(1.0f);
@@ -1267,6 +1507,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setDepthBufferWriteEnabled(bool enabled)
     {
+        flushDrawBatch();
         GLboolean flag = enabled ? GL_TRUE : GL_FALSE;
         mStateCacheManager->setDepthMask( flag );
 
@@ -1276,11 +1517,13 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setDepthBufferFunction(CompareFunction func)
     {
+        flushDrawBatch();
         mStateCacheManager->setDepthFunc(convertCompareFunction(func));
     }
 
     void GL3PlusRenderSystem::_setDepthBias(float constantBias, float slopeScaleBias)
     {
+        flushDrawBatch();
         //FIXME glPolygonOffset currently is buggy in GL3+ RS but not GL RS.
         bool enable = constantBias != 0 || slopeScaleBias != 0;
         mStateCacheManager->setEnabled(GL_POLYGON_OFFSET_FILL, enable);
@@ -1295,6 +1538,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setColourBufferWriteEnabled(bool red, bool green, bool blue, bool alpha)
     {
+        flushDrawBatch();
         mStateCacheManager->setColourMask(red, green, blue, alpha);
 
         // record this
@@ -1311,24 +1555,41 @@ namespace Ogre {
         return ret;
     }
 
+    HardwareTimerQuery* GL3PlusRenderSystem::createHardwareTimerQuery(void)
+    {
+        if (!hasMinGLVersion(3, 3) && !checkExtension("GL_ARB_timer_query"))
+            return 0;
+
+        GL3PlusHardwareTimerQuery* ret = new GL3PlusHardwareTimerQuery();
+        mHwTimerQueries.push_back(ret);
+        return ret;
+    }
+
     void GL3PlusRenderSystem::_setPolygonMode(PolygonMode level)
     {
+        GLenum mode = GL_FILL;
         switch(level)
         {
         case PM_POINTS:
-            mStateCacheManager->setPolygonMode(GL_POINT);
+            mode = GL_POINT;
             break;
         case PM_WIREFRAME:
-            mStateCacheManager->setPolygonMode(GL_LINE);
+            mode = GL_LINE;
             break;
         case PM_SOLID:
-            mStateCacheManager->setPolygonMode(GL_FILL);
+            mode = GL_FILL;
             break;
         }
+
+        // This is set for every renderable, so only break the batch on a change
+        if (mode != mStateCacheManager->getPolygonMode())
+            flushDrawBatch();
+        mStateCacheManager->setPolygonMode(mode);
     }
 
     void GL3PlusRenderSystem::setStencilCheckEnabled(bool enabled)
     {
+        flushDrawBatch();
         mStateCacheManager->setEnabled(GL_STENCIL_TEST, enabled);
     }
 
@@ -1340,6 +1601,7 @@ namespace Ogre {
                                                      bool twoSidedOperation,
                                                      bool readBackAsTexture)
     {
+        flushDrawBatch();
         bool flip;
         mStencilWriteMask = writeMask;
 
@@ -1381,13 +1643,13 @@ namespace Ogre {
         }
     }
 
-    GLint GL3PlusRenderSystem::getCombinedMinMipFilter(void) const
+    GLint GL3PlusRenderSystem::getCombinedMinMipFilter(FilterOptions minFilter, FilterOptions mipFilter) const
     {
-        switch(mMinFilter)
+        switch(minFilter)
         {
         case FO_ANISOTROPIC:
         case FO_LINEAR:
-            switch (mMipFilter)
+            switch (mipFilter)
             {
             case FO_ANISOTROPIC:
             case FO_LINEAR:
@@ -1403,7 +1665,7 @@ namespace Ogre {
             break;
         case FO_POINT:
         case FO_NONE:
-            switch (mMipFilter)
+            switch (mipFilter)
             {
             case FO_ANISOTROPIC:
             case FO_LINEAR:
@@ -1425,6 +1687,29 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setTextureUnitFiltering(size_t unit, FilterType ftype, FilterOptions fo)
     {
+        if (mBindlessHandles[unit]) // fixed by the texture handle
+            return;
+
+        if (useSamplerObjects())
+        {
+            SamplerDesc& desc = mSamplerDescs[unit];
+            switch (ftype)
+            {
+            case FT_MIN:
+                desc.minFilter = fo;
+                break;
+            case FT_MAG:
+                // GL treats linear and aniso the same
+                desc.magFilter = (fo == FO_POINT || fo == FO_NONE) ? GL_NEAREST : GL_LINEAR;
+                break;
+            case FT_MIP:
+                desc.mipFilter = fo;
+                break;
+            }
+            mSamplersDirty = true;
+            return;
+        }
+
         if (!mStateCacheManager->activateGLTextureUnit(unit))
             return;
 
@@ -1436,7 +1721,7 @@ namespace Ogre {
             // Combine with existing mip filter
             mStateCacheManager->setTexParameteri(mTextureTypes[unit],
                                                 GL_TEXTURE_MIN_FILTER,
-                                                getCombinedMinMipFilter());
+                                                getCombinedMinMipFilter(mMinFilter, mMipFilter));
             break;
 
         case FT_MAG:
@@ -1462,7 +1747,7 @@ namespace Ogre {
             // Combine with existing min filter
             mStateCacheManager->setTexParameteri(mTextureTypes[unit],
                                                 GL_TEXTURE_MIN_FILTER,
-                                                getCombinedMinMipFilter());
+                                                getCombinedMinMipFilter(mMinFilter, mMipFilter));
             break;
         }
 
@@ -1471,30 +1756,167 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setTextureUnitCompareFunction(size_t unit, CompareFunction function)
     {
-        // TODO: Sampler objects, GL 3.3 or GL_ARB_sampler_objects required. For example:
-        //        OGRE_CHECK_GL_ERROR(glSamplerParameteri(m_rt_ss, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE));
-        //        OGRE_CHECK_GL_ERROR(glSamplerParameteri(m_rt_ss, GL_TEXTURE_COMPARE_FUNC, GL_NEVER));
+        // Only supported through sampler objects
+        if (!useSamplerObjects())
+            return;
+
+        mSamplerDescs[unit].compareFunction = convertCompareFunction(function);
+        mSamplersDirty = true;
     }
 
     void GL3PlusRenderSystem::_setTextureUnitCompareEnabled(size_t unit, bool compare)
     {
-        // TODO: GL 3.3 or later or GL_ARB_sampler_objects
+        // Only supported through sampler objects
+        if (!useSamplerObjects())
+            return;
+
+        mSamplerDescs[unit].compareMode = compare ? GL_COMPARE_REF_TO_TEXTURE : GL_NONE;
+        mSamplersDirty = true;
     }
 
     void GL3PlusRenderSystem::_setTextureLayerAnisotropy(size_t unit, unsigned int maxAnisotropy)
     {
+        if (mBindlessHandles[unit]) // fixed by the texture handle
+            return;
+
         if (!mCurrentCapabilities->hasCapability(RSC_ANISOTROPY))
             return;
 
+        maxAnisotropy = std::min<uint>(mLargestSupportedAnisotropy, maxAnisotropy);
+
+        if (useSamplerObjects())
+        {
+            mSamplerDescs[unit].maxAnisotropy = maxAnisotropy;
+            mSamplersDirty = true;
+            return;
+        }
+
         if (!mStateCacheManager->activateGLTextureUnit(unit))
             return;
 
-        maxAnisotropy = std::min<uint>(mLargestSupportedAnisotropy, maxAnisotropy);
         mStateCacheManager->setTexParameteri(mTextureTypes[unit], GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropy);
 
         mStateCacheManager->activateGLTextureUnit(0);
     }
 
+    void GL3PlusRenderSystem::bindSamplers(void)
+    {
+        mSamplersDirty = false;
+        bool useSamplers = useSamplerObjects();
+
+        for (size_t i = 0; i < OGRE_MAX_TEXTURE_LAYERS; ++i)
+        {
+            GLuint sampler = 0;
+            if (useSamplers)
+            {
+                const SamplerDesc& desc = mSamplerDescs[i];
+                std::pair<SamplerMap::iterator, bool> inserted =
+                    mSamplers.insert(SamplerMap::value_type(desc, 0));
+                if (inserted.second)
+                {
+                    OGRE_CHECK_GL_ERROR(glGenSamplers(1, &inserted.first->second));
+                    sampler = inserted.first->second;
+                    OGRE_CHECK_GL_ERROR(glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER,
+                        getCombinedMinMipFilter(FilterOptions(desc.minFilter), FilterOptions(desc.mipFilter))));
+                    OGRE_CHECK_GL_ERROR(glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER,
+                        desc.magFilter ? desc.magFilter : GL_LINEAR));
+                    OGRE_CHECK_GL_ERROR(glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, desc.wrap[0] ? desc.wrap[0] : GL_REPEAT));
+                    OGRE_CHECK_GL_ERROR(glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, desc.wrap[1] ? desc.wrap[1] : GL_REPEAT));
+                    OGRE_CHECK_GL_ERROR(glSamplerParameteri(sampler, GL_TEXTURE_WRAP_R, desc.wrap[2] ? desc.wrap[2] : GL_REPEAT));
+                    OGRE_CHECK_GL_ERROR(glSamplerParameterfv(sampler, GL_TEXTURE_BORDER_COLOR, desc.borderColour));
+                    OGRE_CHECK_GL_ERROR(glSamplerParameterf(sampler, GL_TEXTURE_LOD_BIAS, desc.mipmapBias));
+                    if (desc.maxAnisotropy)
+                    {
+                        OGRE_CHECK_GL_ERROR(glSamplerParameteri(sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT, desc.maxAnisotropy));
+                    }
+                    if (desc.compareMode)
+                    {
+                        OGRE_CHECK_GL_ERROR(glSamplerParameteri(sampler, GL_TEXTURE_COMPARE_MODE, desc.compareMode));
+                        OGRE_CHECK_GL_ERROR(glSamplerParameteri(sampler, GL_TEXTURE_COMPARE_FUNC, desc.compareFunction));
+                    }
+                }
+                sampler = inserted.first->second;
+            }
+
+            if (mBoundSamplers[i] != sampler)
+            {
+                // Pending draws sample with the samplers bound so far
+                flushDrawBatch();
+                OGRE_CHECK_GL_ERROR(glBindSampler(GLuint(i), sampler));
+                mBoundSamplers[i] = sampler;
+            }
+        }
+    }
+
+    void GL3PlusRenderSystem::destroySamplers(void)
+    {
+        for (SamplerMap::iterator i = mSamplers.begin(); i != mSamplers.end(); ++i)
+        {
+            OGRE_CHECK_GL_ERROR(glDeleteSamplers(1, &i->second));
+        }
+        mSamplers.clear();
+
+        for (size_t i = 0; i < OGRE_MAX_TEXTURE_LAYERS; ++i)
+            mBoundSamplers[i] = ~0u;
+    }
+
+    void GL3PlusRenderSystem::_dispatchCompute(const Vector3& workgroupDim)
+    {
+        if (!mCurrentComputeShader)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                        "A compute program must be bound to dispatch",
+                        "GL3PlusRenderSystem::_dispatchCompute");
+        }
+
+        // Pending draws may write what the program reads
+        flushDrawBatch();
+
+        if (mSamplersDirty)
+            bindSamplers();
+
+        GLSLProgram* program;
+        if (mCurrentCapabilities->hasCapability(RSC_SEPARATE_SHADER_OBJECTS))
+        {
+            program = GLSLSeparableProgramManager::getSingleton().getCurrentSeparableProgram();
+        }
+        else
+        {
+            program = GLSLMonolithicProgramManager::getSingleton().getActiveMonolithicProgram();
+        }
+
+        if (!program)
+        {
+            LogManager::getSingleton().logMessage("ERROR: Failed to create shader program.",
+                                                  LML_CRITICAL);
+            return;
+        }
+
+        if (program->hasPackedUniforms())
+            program->_bindPackedUniforms();
+
+        if (mBindlessTexturesEnabled)
+        {
+            // Compute programs sample through the texture units
+            for (size_t i = 0; i < OGRE_MAX_TEXTURE_LAYERS; ++i)
+            {
+                if (mUnboundTextures[i] && mStateCacheManager->activateGLTextureUnit(i))
+                {
+                    mStateCacheManager->bindGLTexture(mTextureTypes[i], mUnboundTextures[i]);
+                    mUnboundTextures[i] = 0;
+                }
+            }
+            mStateCacheManager->activateGLTextureUnit(0);
+        }
+
+        OGRE_CHECK_GL_ERROR(glDispatchCompute(GLuint(workgroupDim[0]),
+                                              GLuint(workgroupDim[1]),
+                                              GLuint(workgroupDim[2])));
+        OGRE_CHECK_GL_ERROR(glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT |
+                                            GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
+                                            GL_FRAMEBUFFER_BARRIER_BIT));
+    }
+
     void GL3PlusRenderSystem::_render(const RenderOperation& op)
     {
         // Call super class.
@@ -1509,11 +1931,21 @@ namespace Ogre {
 
         size_t numberOfInstances = op.numberOfInstances;
 
+        // Instanced, tessellated and iterated draws are rendered directly, after
+        // the pending draws of the batch
+        bool batchDraw = mDrawBatchOpen && !hasInstanceData && !mCurrentDomainShader &&
+            !mCurrentComputeShader && mCurrentPassIterationCount <= 1;
+        if (mDrawBatchOpen && !batchDraw)
+            flushDrawBatch();
+
         if (op.useGlobalInstancingVertexBufferIsAvailable)
         {
             numberOfInstances *= getGlobalNumberOfInstances();
         }
 
+        if (mSamplersDirty)
+            bindSamplers();
+
         GLSLProgram* program;
         if (mCurrentCapabilities->hasCapability(RSC_SEPARATE_SHADER_OBJECTS))
         {
@@ -1529,16 +1961,68 @@ namespace Ogre {
             LogManager::getSingleton().logMessage("ERROR: Failed to create shader program.",
                                                   LML_CRITICAL);
         }
+        else if (program->hasPackedUniforms())
+        {
+            // Pending draws read the packed uniforms from the range bound now
+            if (mDrawBatchOpen && program->_getPackedUniformsDirty())
+                flushDrawBatch();
+            program->_bindPackedUniforms();
+        }
+
+        if (mBindlessTexturesEnabled && program)
+        {
+            if (program->hasBindlessSamplers())
+            {
+                // Textures drawn with for the first time have their sampling state now
+                for (size_t i = 0; i < OGRE_MAX_TEXTURE_LAYERS; ++i)
+                {
+                    if (mBindlessPendingTextures[i])
+                    {
+                        mBindlessHandles[i] = mBindlessPendingTextures[i]->getBindlessHandle();
+                        mBindlessPendingTextures[i] = 0;
+                    }
+                }
+
+                if (program->_getBindlessSamplersDirty(mBindlessHandles))
+                {
+                    flushDrawBatch();
+                    program->_bindBindlessSamplers(mBindlessHandles);
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < OGRE_MAX_TEXTURE_LAYERS; ++i)
+                {
+                    if (mUnboundTextures[i] && mStateCacheManager->activateGLTextureUnit(i))
+                    {
+                        flushDrawBatch();
+                        mStateCacheManager->bindGLTexture(mTextureTypes[i], mUnboundTextures[i]);
+                        mUnboundTextures[i] = 0;
+                    }
+                }
+                mStateCacheManager->activateGLTextureUnit(0);
+            }
+        }
 
         GLVertexArrayObject* vao =
             static_cast<GLVertexArrayObject*>(op.vertexData->vertexDeclaration);
         // Bind VAO (set of per-vertex attributes: position, normal, etc.).
         vao->bind(this);
-        bool updateVAO = vao->needsUpdate(op.vertexData->vertexBufferBinding,
-                                          op.vertexData->vertexStart);
+        // Batched draws of pooled vertex data pass the vertex start as base vertex,
+        // so that the draws of all the data sharing the pool buffers can be merged
+        size_t vertexStart = (batchDraw && op.vertexData->isPooled()) ? 0 : op.vertexData->vertexStart;
+        bool updateVAO = vao->needsUpdate(op.vertexData->vertexBufferBinding, vertexStart);
 
         if (updateVAO)
-            vao->bindToGpu(this, op.vertexData->vertexBufferBinding, op.vertexData->vertexStart);
+        {
+            // Pending draws need the vertex array as it was when they were added
+            if (vao == mDrawBatchVao)
+            {
+                flushDrawBatch();
+                vao->bind(this);
+            }
+            vao->bindToGpu(this, op.vertexData->vertexBufferBinding, vertexStart);
+        }
 
         // We treat index buffer binding inside VAO as volatile, always updating and never relying onto it,
         // as one shared vertex buffer could be rendered with several index buffers, from submeshes and/or LODs
@@ -1554,7 +2038,16 @@ namespace Ogre {
             for (elemIter = globalVertexDeclaration->getElements().begin(); elemIter != elemEnd; ++elemIter)
             {
                 const VertexElement & elem = *elemIter;
-                bindVertexElementToGpu(elem, globalInstanceVertexBuffer, 0);
+                if (mHasVertexAttribBinding)
+                {
+                    // Count down from the last of the (at least 16) binding indices, which
+                    // the sources of the vertex data do not use
+                    uint32 bindingIndex = 15 - elem.getSource();
+                    bindVertexElementFormatToGpu(elem, bindingIndex);
+                    bindVertexBufferToGpu(bindingIndex, globalInstanceVertexBuffer, 0);
+                }
+                else
+                    bindVertexElementToGpu(elem, globalInstanceVertexBuffer, 0);
             }
         }
 
@@ -1619,6 +2112,12 @@ namespace Ogre {
         // }
         //TODO: Reset atomic counters somewhere
 
+        if (batchDraw)
+        {
+            addToDrawBatch(op, vao, primType);
+            mStateCacheManager->bindGLVertexArray(0);
+            return;
+        }
 
         // Render to screen!
         if (mCurrentDomainShader)
@@ -1729,10 +2228,155 @@ namespace Ogre {
         mStateCacheManager->bindGLVertexArray(0);
     }
 
+    bool GL3PlusRenderSystem::_beginDrawBatch(void)
+    {
+        flushDrawBatch();
+        mDrawBatchOpen = mHasMultiDrawIndirect;
+        return mDrawBatchOpen;
+    }
+
+    void GL3PlusRenderSystem::_endDrawBatch(void)
+    {
+        flushDrawBatch();
+        mDrawBatchOpen = false;
+    }
+
+    void GL3PlusRenderSystem::_setWorldMatrix(const Matrix4 &m)
+    {
+        // Only kept for batched draws, programs get it through their parameters otherwise
+        mDrawBatchWorldMatrix = m;
+    }
+
+    void GL3PlusRenderSystem::addToDrawBatch(const RenderOperation& op, GLVertexArrayObject* vao,
+                                             GLenum primType)
+    {
+        GLuint indexBuffer = 0;
+        GLenum indexType = 0;
+        if (op.useIndexes)
+        {
+            indexBuffer = static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get())->getGLBufferId();
+            indexType = (op.indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_16BIT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        }
+
+        // Pooled vertex data has its vertex start in the commands rather than in
+        // the vertex array, so the vertex array of the first draw serves all the
+        // others with the same layout and buffers, whichever declaration they use
+        bool pooled = op.vertexData->isPooled();
+        bool sameVertices = vao == mDrawBatchVao;
+        if (!sameVertices && pooled && mDrawBatchVao && mDrawBatchPooled && *vao == *mDrawBatchVao)
+        {
+            const VertexBufferBinding::VertexBufferBindingMap& bindings =
+                op.vertexData->vertexBufferBinding->getBindings();
+            sameVertices = bindings.size() == mDrawBatchVertexBuffers.size();
+            VertexBufferBinding::VertexBufferBindingMap::const_iterator i = bindings.begin();
+            for (size_t b = 0; sameVertices && b < mDrawBatchVertexBuffers.size(); ++b, ++i)
+                sameVertices = mDrawBatchVertexBuffers[b] == std::make_pair(i->first, i->second.get());
+        }
+
+        if (!sameVertices || indexBuffer != mDrawBatchIndexBuffer ||
+            indexType != mDrawBatchIndexType || primType != mDrawBatchPrimType)
+        {
+            flushDrawBatch();
+            mDrawBatchVao = vao;
+            mDrawBatchIndexBuffer = indexBuffer;
+            mDrawBatchIndexType = indexType;
+            mDrawBatchPrimType = primType;
+            mDrawBatchPooled = pooled;
+            mDrawBatchVertexBuffers.clear();
+            if (pooled)
+            {
+                const VertexBufferBinding::VertexBufferBindingMap& bindings =
+                    op.vertexData->vertexBufferBinding->getBindings();
+                VertexBufferBinding::VertexBufferBindingMap::const_iterator i;
+                for (i = bindings.begin(); i != bindings.end(); ++i)
+                    mDrawBatchVertexBuffers.push_back(std::make_pair(i->first, i->second.get()));
+            }
+        }
+
+        // Otherwise the vertex start is part of the vertex array, so base vertex
+        // and first vertex are 0. Programs index the per-draw data with
+        // gl_DrawIDARB, which leaves the base instance free (it must be 0 without
+        // GL_ARB_base_instance).
+        GLuint vertexStart = pooled ? static_cast<GLuint>(op.vertexData->vertexStart) : 0;
+        if (op.useIndexes)
+        {
+            // DrawElementsIndirectCommand: count, instanceCount, firstIndex, baseVertex, baseInstance
+            mDrawBatchCommands.push_back(static_cast<GLuint>(op.indexData->indexCount));
+            mDrawBatchCommands.push_back(1);
+            mDrawBatchCommands.push_back(static_cast<GLuint>(op.indexData->indexStart));
+            mDrawBatchCommands.push_back(vertexStart);
+            mDrawBatchCommands.push_back(0);
+        }
+        else
+        {
+            // DrawArraysIndirectCommand: count, instanceCount, first, baseInstance
+            mDrawBatchCommands.push_back(static_cast<GLuint>(op.vertexData->vertexCount));
+            mDrawBatchCommands.push_back(1);
+            mDrawBatchCommands.push_back(vertexStart);
+            mDrawBatchCommands.push_back(0);
+        }
+
+        Matrix4 worldMatrix = mDrawBatchWorldMatrix.transpose();
+        mDrawBatchData.insert(mDrawBatchData.end(), worldMatrix[0], worldMatrix[0] + 16);
+    }
+
+    void GL3PlusRenderSystem::flushDrawBatch(void)
+    {
+        if (mDrawBatchCommands.empty())
+            return;
+
+        // Grow the buffers geometrically, so that they are soon large enough for
+        // every batch and only have their contents replaced
+        size_t commandsSize = mDrawBatchCommands.size() * sizeof(GLuint);
+        if (mDrawIndirectBufferSize < commandsSize)
+        {
+            delete mDrawIndirectBuffer;
+            mDrawIndirectBufferSize = std::max(commandsSize, mDrawIndirectBufferSize * 2);
+            mDrawIndirectBuffer = new GL3PlusHardwareBuffer(GL_DRAW_INDIRECT_BUFFER,
+                mDrawIndirectBufferSize, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        }
+        mDrawIndirectBuffer->writeData(0, commandsSize, &mDrawBatchCommands[0], true);
+
+        size_t dataSize = mDrawBatchData.size() * sizeof(float);
+        if (!mDrawDataBuffer || mDrawDataBuffer->getSizeInBytes() < dataSize)
+        {
+            size_t size = mDrawDataBuffer ? mDrawDataBuffer->getSizeInBytes() * 2 : 0;
+            mDrawDataBuffer = static_cast<GL3PlusHardwareBufferManager*>(mHardwareBufferManager)->
+                createShaderStorageBuffer(std::max(dataSize, size),
+                                          HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false);
+        }
+        mDrawDataBuffer->writeData(0, dataSize, &mDrawBatchData[0], true);
+        static_cast<GL3PlusHardwareShaderStorageBuffer*>(mDrawDataBuffer.get())->
+            setGLBufferBinding(mDrawBatchDataBinding);
+
+        mDrawBatchVao->bind(this);
+        if (mDrawBatchIndexType)
+            mStateCacheManager->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mDrawBatchIndexBuffer);
+        mStateCacheManager->bindGLBuffer(GL_DRAW_INDIRECT_BUFFER, mDrawIndirectBuffer->getGLBufferId());
+
+        GLsizei drawCount = static_cast<GLsizei>(mDrawBatchData.size() / 16);
+        if (mDrawBatchIndexType)
+        {
+            OGRE_CHECK_GL_ERROR(glMultiDrawElementsIndirect(mDrawBatchPrimType, mDrawBatchIndexType,
+                                                            0, drawCount, 0));
+        }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glMultiDrawArraysIndirect(mDrawBatchPrimType, 0, drawCount, 0));
+        }
+
+        mStateCacheManager->bindGLVertexArray(0);
+
+        mDrawBatchCommands.clear();
+        mDrawBatchData.clear();
+        mDrawBatchVao = 0;
+    }
+
     void GL3PlusRenderSystem::setScissorTest(bool enabled, size_t left,
                                              size_t top, size_t right,
                                              size_t bottom)
     {
+        flushDrawBatch();
         mScissorsEnabled = enabled;
         // If request texture flipping, use "upper-left", otherwise use "lower-left"
         bool flipping = mActiveRenderTarget->requiresTextureFlipping();
@@ -1789,6 +2433,7 @@ namespace Ogre {
                                                const ColourValue& colour,
                                                Real depth, unsigned short stencil)
     {
+        flushDrawBatch();
         bool colourMask = !mColourWrite[0] || !mColourWrite[1] ||
             !mColourWrite[2] || !mColourWrite[3];
 
@@ -1905,8 +2550,14 @@ namespace Ogre {
         mCurrentContext->setCurrent();
 
         mStateCacheManager = mCurrentContext->createOrRetrieveStateCacheManager<GL3PlusStateCacheManager>();
+        mStateCacheManager->_setRenderStats(&mRenderStats);
         _completeDeferredVaoDestruction();
 
+        // Sampler bindings are per context
+        for (size_t i = 0; i < OGRE_MAX_TEXTURE_LAYERS; ++i)
+            mBoundSamplers[i] = ~0u;
+        mSamplersDirty = true;
+
         // Check if the context has already done one-time initialisation
         if (!mCurrentContext->getInitialized())
         {
@@ -1960,6 +2611,21 @@ namespace Ogre {
         }
     }
 
+    void GL3PlusRenderSystem::setBindlessTexturesEnabled(bool enabled)
+    {
+        mBindlessTexturesEnabled = enabled && mHasBindlessTexture;
+
+        for (size_t i = 0; i < OGRE_MAX_TEXTURE_LAYERS; ++i)
+        {
+            mBindlessHandles[i] = 0;
+            mBindlessPendingTextures[i] = 0;
+            mUnboundTextures[i] = 0;
+        }
+
+        // Sampler objects are unbound when textures pass their own sampling state
+        mSamplersDirty = true;
+    }
+
     uint32 GL3PlusRenderSystem::_createVao()
     {
         uint32 vao = 0;
@@ -2012,6 +2678,40 @@ namespace Ogre {
             OGRE_CHECK_GL_ERROR(glProvokingVertex(GL_FIRST_VERTEX_CONVENTION));
         }
 
+        mHasBindlessTexture = checkExtension("GL_ARB_bindless_texture");
+
+        // Sampling state is kept in sampler objects shared by all texture units
+        mHasSamplerObjects = hasMinGLVersion(3, 3) || checkExtension("GL_ARB_sampler_objects");
+
+        // VAOs keep their attribute formats and only switch buffers
+        mHasVertexAttribBinding = hasMinGLVersion(4, 3) || checkExtension("GL_ARB_vertex_attrib_binding");
+
+        // Draw batching needs indirect multi-draws, with the per-draw data in a SSBO
+        mHasMultiDrawIndirect = hasMinGLVersion(4, 3) ||
+            (checkExtension("GL_ARB_multi_draw_indirect") &&
+             checkExtension("GL_ARB_shader_storage_buffer_object"));
+
+        // Let the driver compile and link on as many threads as it likes, GLSLShader
+        // submits the compilation when loading and checks the result when linking
+        const char* maxThreadsProc = checkExtension("GL_KHR_parallel_shader_compile") ?
+            "glMaxShaderCompilerThreadsKHR" : "glMaxShaderCompilerThreadsARB";
+        mHasParallelShaderCompile = checkExtension("GL_KHR_parallel_shader_compile") ||
+            checkExtension("GL_ARB_parallel_shader_compile");
+        if (mHasParallelShaderCompile)
+        {
+            typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSPROC)(GLuint count);
+            PFNGLMAXSHADERCOMPILERTHREADSPROC maxShaderCompilerThreads =
+                (PFNGLMAXSHADERCOMPILERTHREADSPROC)gl3wGetProcAddress(maxThreadsProc);
+            if (maxShaderCompilerThreads)
+            {
+                OGRE_CHECK_GL_ERROR(maxShaderCompilerThreads(0xFFFFFFFF));
+            }
+            else
+            {
+                mHasParallelShaderCompile = false;
+            }
+        }
+
         if (getCapabilities()->hasCapability(RSC_DEBUG))
         {
 #if ENABLE_GL_DEBUG_OUTPUT
@@ -2045,6 +2745,7 @@ namespace Ogre {
         mGLSupport->initialiseExtensions();
 
         mStateCacheManager = mCurrentContext->createOrRetrieveStateCacheManager<GL3PlusStateCacheManager>();
+        mStateCacheManager->_setRenderStats(&mRenderStats);
 
         LogManager::getSingleton().logMessage("**************************************");
         LogManager::getSingleton().logMessage("***   OpenGL 3+ Renderer Started   ***");
@@ -2053,10 +2754,14 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setRenderTarget(RenderTarget *target)
     {
+        flushDrawBatch();
         // Unbind frame buffer object
         if (mActiveRenderTarget)
             mRTTManager->unbind(mActiveRenderTarget);
 
+        if (target && target != mActiveRenderTarget)
+            ++mRenderStats.renderTargetSwitches;
+
         mActiveRenderTarget = target;
         if (target)
         {
@@ -2151,6 +2856,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::bindGpuProgram(GpuProgram* prg)
     {
+        flushDrawBatch();
         GLSLShader* glprg = static_cast<GLSLShader*>(prg);
 
         // Unbind previous shader first.
@@ -2248,6 +2954,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::unbindGpuProgram(GpuProgramType gptype)
     {
+        flushDrawBatch();
         if (gptype == GPT_VERTEX_PROGRAM && mCurrentVertexShader)
         {
             mActiveVertexGpuProgramParameters.reset();
@@ -2291,10 +2998,8 @@ namespace Ogre {
     {
         //              if (mask & (uint16)GPV_GLOBAL)
         //              {
-        //TODO We could maybe use GL_EXT_bindable_uniform here to produce Dx10-style
-        // shared constant buffers, but GPU support seems fairly weak?
-        // check the match to constant buffers & use rendersystem data hooks to store
-        // for now, just copy
+        // Shared parameters read from uniform blocks are not program uniforms, their
+        // buffer is bound by bindSharedParameters. Only plain uniforms are copied here.
         params->_copySharedParams();
 
         switch (gptype)
@@ -2394,6 +3099,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::setClipPlanesImpl(const PlaneList& planeList)
     {
+        flushDrawBatch();
     }
 
     void GL3PlusRenderSystem::registerThread()
@@ -2502,29 +3208,9 @@ namespace Ogre {
             OGRE_CHECK_GL_ERROR(glVertexAttribDivisor(attrib, hwGlBuffer->getInstanceDataStepRate()));
         }
 
-        unsigned short typeCount = VertexElement::getTypeCount(elem.getType());
-        GLboolean normalised = GL_FALSE;
-        switch(elem.getType())
-        {
-        case VET_COLOUR:
-        case VET_COLOUR_ABGR:
-        case VET_COLOUR_ARGB:
-            // Because GL takes these as a sequence of single unsigned bytes, count needs to be 4
-            // VertexElement::getTypeCount treats them as 1 (RGBA)
-            // Also need to normalise the fixed-point data
-            typeCount = 4;
-            normalised = GL_TRUE;
-            break;
-        case VET_UBYTE4_NORM:
-        case VET_SHORT2_NORM:
-        case VET_USHORT2_NORM:
-        case VET_SHORT4_NORM:
-        case VET_USHORT4_NORM:
-            normalised = GL_TRUE;
-            break;
-        default:
-            break;
-        };
+        unsigned short typeCount;
+        GLboolean normalised;
+        getGLVertexFormat(elem.getType(), typeCount, normalised);
 
         switch(elem.getBaseType(elem.getType()))
         {
@@ -2549,6 +3235,56 @@ namespace Ogre {
         // If this attribute hasn't been enabled, do so and keep a record of it.
         OGRE_CHECK_GL_ERROR(glEnableVertexAttribArray(attrib));
     }
+
+    void GL3PlusRenderSystem::bindVertexElementFormatToGpu(const VertexElement& elem, uint32 bindingIndex)
+    {
+        VertexElementSemantic sem = elem.getSemantic();
+        unsigned short elemIndex = elem.getIndex();
+
+        if (!GLSLProgramCommon::isAttributeValid(sem, elemIndex))
+        {
+            return;
+        }
+
+        GLuint attrib = (GLuint)GLSLProgramCommon::getFixedAttributeIndex(sem, elemIndex);
+
+        unsigned short typeCount;
+        GLboolean normalised;
+        getGLVertexFormat(elem.getType(), typeCount, normalised);
+
+        switch(elem.getBaseType(elem.getType()))
+        {
+        default:
+        case VET_FLOAT1:
+            OGRE_CHECK_GL_ERROR(glVertexAttribFormat(attrib,
+                                                     typeCount,
+                                                     GL3PlusHardwareBufferManager::getGLType(elem.getType()),
+                                                     normalised,
+                                                     static_cast<GLuint>(elem.getOffset())));
+            break;
+        case VET_DOUBLE1:
+            OGRE_CHECK_GL_ERROR(glVertexAttribLFormat(attrib,
+                                                      typeCount,
+                                                      GL3PlusHardwareBufferManager::getGLType(elem.getType()),
+                                                      static_cast<GLuint>(elem.getOffset())));
+            break;
+        }
+
+        OGRE_CHECK_GL_ERROR(glVertexAttribBinding(attrib, bindingIndex));
+        OGRE_CHECK_GL_ERROR(glEnableVertexAttribArray(attrib));
+    }
+
+    void GL3PlusRenderSystem::bindVertexBufferToGpu(uint32 bindingIndex,
+                                                    const HardwareVertexBufferSharedPtr& vertexBuffer,
+                                                    const size_t vertexStart)
+    {
+        const GL3PlusHardwareVertexBuffer* hwGlBuffer = static_cast<const GL3PlusHardwareVertexBuffer*>(vertexBuffer.get());
+        GLsizei stride = static_cast<GLsizei>(vertexBuffer->getVertexSize());
+        OGRE_CHECK_GL_ERROR(glBindVertexBuffer(bindingIndex, hwGlBuffer->getGLBufferId(),
+                                               static_cast<GLintptr>(vertexStart * stride), stride));
+        OGRE_CHECK_GL_ERROR(glVertexBindingDivisor(bindingIndex,
+            hwGlBuffer->getIsInstanceData() ? hwGlBuffer->getInstanceDataStepRate() : 0));
+    }
 #if OGRE_NO_QUAD_BUFFER_STEREO == 0
 	bool GL3PlusRenderSystem::setDrawBuffer(ColourBufferType colourBuffer)
 	{
@@ -2604,4 +3340,38 @@ namespace Ogre {
 
         PixelUtil::bulkPixelVerticalFlip(dst);
     }
+
+    AsyncReadbackPtr GL3PlusRenderSystem::_copyContentsToMemoryAsync(Viewport* vp, const Box& src, RenderWindow::FrameBuffer buffer)
+    {
+        PixelFormat pixelFormat = vp->getTarget()->suggestPixelFormat();
+        GLenum format = GL3PlusPixelUtil::getGLOriginFormat(pixelFormat);
+        GLenum type = GL3PlusPixelUtil::getGLOriginDataType(pixelFormat);
+
+        if ((format == GL_NONE) || (type == 0))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Unsupported format", "GL3PlusRenderSystem::_copyContentsToMemoryAsync");
+        }
+
+        // Switch context if different from current one
+        _setViewport(vp);
+
+        // Read into a pixel pack buffer, the rows are flipped when fetched
+        PixelBox layout(src.getWidth(), src.getHeight(), 1, pixelFormat);
+        GL3PlusAsyncReadback* readback = OGRE_NEW GL3PlusAsyncReadback(this, layout, layout, true);
+        AsyncReadbackPtr ticket(readback);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+        uint32_t height = vp->getTarget()->getHeight();
+
+        glReadBuffer((buffer == RenderWindow::FB_FRONT)? GL_FRONT : GL_BACK);
+        glReadPixels((GLint)src.left, (GLint)(height - src.bottom),
+                     (GLsizei)src.getWidth(), (GLsizei)src.getHeight(),
+                     format, type, 0);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+        readback->fence();
+        return ticket;
+    }
 }
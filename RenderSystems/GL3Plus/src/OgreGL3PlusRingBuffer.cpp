@@ -0,0 +1,160 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreGL3PlusRingBuffer.h"
+#include "OgreRoot.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
+
+namespace Ogre {
+
+    GL3PlusRingBuffer::GL3PlusRingBuffer(size_t sizeInBytes)
+        : mBufferId(0), mMappedData(0), mSizeInBytes(sizeInBytes), mHead(0), mTail(0), mFencedHead(0)
+    {
+        GL3PlusStateCacheManager* stateCacheManager = static_cast<GL3PlusRenderSystem*>(
+            Root::getSingleton().getRenderSystem())->_getStateCacheManager();
+
+        OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mBufferId));
+        if (!mBufferId)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        "Cannot create GL ring buffer",
+                        "GL3PlusRingBuffer::GL3PlusRingBuffer");
+        }
+
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        stateCacheManager->bindGLBuffer(GL_COPY_READ_BUFFER, mBufferId);
+        OGRE_CHECK_GL_ERROR(glBufferStorage(GL_COPY_READ_BUFFER, mSizeInBytes, NULL, flags));
+        OGRE_CHECK_GL_ERROR(mMappedData = static_cast<uint8*>(
+            glMapBufferRange(GL_COPY_READ_BUFFER, 0, mSizeInBytes, flags)));
+        stateCacheManager->bindGLBuffer(GL_COPY_READ_BUFFER, 0);
+
+        if (!mMappedData)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        "Cannot map GL ring buffer",
+                        "GL3PlusRingBuffer::GL3PlusRingBuffer");
+        }
+    }
+
+    GL3PlusRingBuffer::~GL3PlusRingBuffer()
+    {
+        for (FenceList::iterator i = mFences.begin(); i != mFences.end(); ++i)
+        {
+            OGRE_CHECK_GL_ERROR(glDeleteSync(i->sync));
+        }
+        mFences.clear();
+
+        GL3PlusStateCacheManager* stateCacheManager = static_cast<GL3PlusRenderSystem*>(
+            Root::getSingleton().getRenderSystem())->_getStateCacheManager();
+        if (stateCacheManager)
+        {
+            stateCacheManager->bindGLBuffer(GL_COPY_READ_BUFFER, mBufferId);
+            OGRE_CHECK_GL_ERROR(glUnmapBuffer(GL_COPY_READ_BUFFER));
+            stateCacheManager->deleteGLBuffer(GL_COPY_READ_BUFFER, mBufferId);
+        }
+    }
+
+    size_t GL3PlusRingBuffer::allocate(size_t length, size_t alignment)
+    {
+        assert(length <= mSizeInBytes && "Allocation larger than the ring buffer");
+
+        uint64 start = (mHead + alignment - 1) & ~uint64(alignment - 1);
+        size_t offset = static_cast<size_t>(start % mSizeInBytes);
+        // Allocations must be contiguous, so skip the end of the buffer if it is too short
+        if (offset + length > mSizeInBytes)
+        {
+            start += mSizeInBytes - offset;
+            offset = 0;
+        }
+
+        // Wait until the GPU is done with the space we wrap around onto
+        while (start + length > mTail + mSizeInBytes)
+        {
+            if (mFences.empty())
+            {
+                if (mFencedHead == mHead)
+                {
+                    // Nothing is in use
+                    mTail = start;
+                    break;
+                }
+                // All of the space is taken by this frame, fence it to wait for it
+                fence();
+                if (mFences.empty())
+                    continue;
+            }
+            retireOldest();
+        }
+
+        mHead = start + length;
+        return offset;
+    }
+
+    void GL3PlusRingBuffer::fence(void)
+    {
+        if (mHead != mFencedHead)
+        {
+            Fence fence;
+            OGRE_CHECK_GL_ERROR(fence.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+            fence.end = mHead;
+            mFences.push_back(fence);
+            mFencedHead = mHead;
+        }
+
+        // Retire what the GPU has finished with, without waiting
+        while (!mFences.empty())
+        {
+            GLenum result;
+            OGRE_CHECK_GL_ERROR(result = glClientWaitSync(mFences.front().sync, 0, 0));
+            if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+                break;
+
+            OGRE_CHECK_GL_ERROR(glDeleteSync(mFences.front().sync));
+            mTail = mFences.front().end;
+            mFences.pop_front();
+        }
+    }
+
+    void GL3PlusRingBuffer::retireOldest(void)
+    {
+        const Fence& fence = mFences.front();
+
+        GLenum result;
+        do
+        {
+            // Flush on the first wait, or the fence may never be signalled
+            OGRE_CHECK_GL_ERROR(result = glClientWaitSync(fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                                          1000000));
+        } while (result == GL_TIMEOUT_EXPIRED);
+
+        OGRE_CHECK_GL_ERROR(glDeleteSync(fence.sync));
+        mTail = fence.end;
+        mFences.pop_front();
+    }
+}
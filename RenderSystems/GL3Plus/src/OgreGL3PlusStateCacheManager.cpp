@@ -35,6 +35,7 @@
 namespace Ogre {
     
     GL3PlusStateCacheManager::GL3PlusStateCacheManager(void)
+        : mRenderStats(0)
     {
         clearCache();
     }
@@ -282,6 +283,8 @@ namespace Ogre {
         {
             mActiveVertexArray = vao;
             OGRE_CHECK_GL_ERROR(glBindVertexArray(vao));
+            if (mRenderStats)
+                ++mRenderStats->vertexArrayBinds;
             //we also need to clear the cached GL_ELEMENT_ARRAY_BUFFER value, as it is invalidated by glBindVertexArray
             mActiveBufferMap[GL_ELEMENT_ARRAY_BUFFER] = 0;
         }
@@ -373,6 +376,7 @@ namespace Ogre {
             mBlendFuncDest = dest;
             
             glBlendFunc(source, dest);
+            countStateChange();
         }
     }
 
@@ -383,6 +387,7 @@ namespace Ogre {
             mDepthMask = mask;
             
             OGRE_CHECK_GL_ERROR(glDepthMask(mask));
+            countStateChange();
         }
     }
     
@@ -393,6 +398,7 @@ namespace Ogre {
             mDepthFunc = func;
             
             OGRE_CHECK_GL_ERROR(glDepthFunc(func));
+            countStateChange();
         }
     }
     
@@ -435,6 +441,7 @@ namespace Ogre {
             mColourMask[3] = alpha;
             
             OGRE_CHECK_GL_ERROR(glColorMask(mColourMask[0], mColourMask[1], mColourMask[2], mColourMask[3]));
+            countStateChange();
         }
     }
     
@@ -445,6 +452,7 @@ namespace Ogre {
             mStencilMask = mask;
             
             OGRE_CHECK_GL_ERROR(glStencilMask(mask));
+            countStateChange();
         }
     }
     
@@ -474,6 +482,7 @@ namespace Ogre {
         {
             OGRE_CHECK_GL_ERROR(glEnable(flag));
         }
+        countStateChange();
     }
 
     void GL3PlusStateCacheManager::setViewport(GLint x, GLint y, GLsizei width, GLsizei height)
@@ -500,6 +509,7 @@ namespace Ogre {
             mCullFace = face;
             
             glCullFace(face);
+            countStateChange();
         }
     }
 
@@ -513,6 +523,7 @@ namespace Ogre {
             mBlendEquationAlpha = eq;
 
             OGRE_CHECK_GL_ERROR(glBlendEquation(eq));
+            countStateChange();
         }
     }
 
@@ -526,6 +537,7 @@ namespace Ogre {
             mBlendEquationAlpha = eqAlpha;
 
             OGRE_CHECK_GL_ERROR(glBlendEquationSeparate(eqRGB, eqAlpha));
+            countStateChange();
         }
     }
 
@@ -537,6 +549,7 @@ namespace Ogre {
         {
             mPolygonMode = mode;
             OGRE_CHECK_GL_ERROR(glPolygonMode(GL_FRONT_AND_BACK, mPolygonMode));
+            countStateChange();
         }
     }
 
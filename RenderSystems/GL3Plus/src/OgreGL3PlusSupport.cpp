@@ -51,6 +51,10 @@ namespace Ogre {
         tmpStr = (const char*)pcRenderer;
         LogManager::getSingleton().logMessage("GL_RENDERER = " + tmpStr);
 
+        // The version string carries the driver version, e.g. "4.5.0 NVIDIA 375.26"
+        const GLubyte* pcVersion = glGetString(GL_VERSION);
+        mDriverString = String((const char*)pcVendor) + " " + tmpStr + " " + (const char*)pcVersion;
+
         // Set extension list
         Log::Stream log = LogManager::getSingleton().stream();
         String str;
@@ -43,7 +43,8 @@ namespace Ogre {
                                    ResourceHandle handle, const String& group, bool isManual,
                                    ManualResourceLoader* loader, GL3PlusRenderSystem* renderSystem)
         : GLTextureCommon(creator, name, handle, group, isManual, loader),
-          mRenderSystem(renderSystem)
+          mRenderSystem(renderSystem),
+          mBindlessHandle(0)
     {
         mMipmapsHardwareGenerated = true;
     }
@@ -386,9 +387,22 @@ namespace Ogre {
         mSurfaceList.clear();
         if (GL3PlusStateCacheManager* stateCacheManager = mRenderSystem->_getStateCacheManager())
         {
+            if (mBindlessHandle)
+                OGRE_CHECK_GL_ERROR(glMakeTextureHandleNonResidentARB(mBindlessHandle));
             OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &mTextureID));
             stateCacheManager->invalidateStateForTexture(mTextureID);
         }
+        mBindlessHandle = 0;
+    }
+
+    GLuint64 GL3PlusTexture::getBindlessHandle(void)
+    {
+        if (!mBindlessHandle)
+        {
+            OGRE_CHECK_GL_ERROR(mBindlessHandle = glGetTextureHandleARB(mTextureID));
+            OGRE_CHECK_GL_ERROR(glMakeTextureHandleResidentARB(mBindlessHandle));
+        }
+        return mBindlessHandle;
     }
 
     void GL3PlusTexture::_createSurfaceList()
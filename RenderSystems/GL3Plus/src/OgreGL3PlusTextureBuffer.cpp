@@ -35,6 +35,8 @@
 #include "OgreGL3PlusPixelFormat.h"
 #include "OgreGL3PlusFBORenderTexture.h"
 #include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusAsyncReadback.h"
+#include "OgreGL3PlusRingBuffer.h"
 
 #include "OgreGLSLMonolithicProgram.h"
 #include "OgreGLSLMonolithicProgramManager.h"
@@ -138,44 +140,37 @@ namespace Ogre {
     }
 
 
-    void GL3PlusTextureBuffer::upload(const PixelBox &data, const Box &dest)
+    void GL3PlusTextureBuffer::upload(const PixelBox &src, const Box &dest)
     {
-        mRenderSystem->_getStateCacheManager()->bindGLTexture( mTarget, mTextureID );
+        GL3PlusStateCacheManager* stateCacheManager = mRenderSystem->_getStateCacheManager();
+        stateCacheManager->bindGLTexture( mTarget, mTextureID );
 
-        // PBOs have no advantage with this usage pattern
-        // see: https://www.khronos.org/opengl/wiki/Pixel_Buffer_Object
-        // but PlayPen_BlitSubTextures fails if we use them
-#if 0
-        // Calculate size for all mip levels of the texture.
-        size_t dataSize = 0;
-        if (mTarget == GL_TEXTURE_2D_ARRAY)
-        {
-            dataSize = PixelUtil::getMemorySize(dest.getWidth(), dest.getHeight(), dest.getDepth(), data.format);
-        }
-        else
+        PixelBox data = src;
+        void* pdata = data.getTopLeftFrontPixelPtr();
+
+        // Copy the pixels into the persistently mapped ring buffer and upload from
+        // there, so the driver queues the copy to the texture instead of making
+        // its own copy of client memory right away. Background threads with their
+        // own context may be uploading too, the ring buffer is for the main one.
+        GL3PlusRingBuffer* ringBuffer = mRenderSystem->_getRingBuffer();
+        size_t stagingSize = PixelUtil::getMemorySize(data.getWidth(), data.getHeight(), data.getDepth(), data.format);
+        bool staged = OGRE_THREAD_SUPPORT != 1 && ringBuffer && stagingSize <= ringBuffer->getSizeInBytes() / 4 &&
+            (!PixelUtil::isCompressed(data.format) || (data.format == mFormat && data.isConsecutive()));
+        if (staged)
         {
-            dataSize = PixelUtil::getMemorySize(data.getWidth(), data.getHeight(), mDepth, data.format);
-        }
+            size_t offset = ringBuffer->allocate(stagingSize);
+            PixelBox staging(data.getWidth(), data.getHeight(), data.getDepth(), data.format,
+                             ringBuffer->getMappedData(offset));
+            if (PixelUtil::isCompressed(data.format))
+                memcpy(staging.data, pdata, stagingSize);
+            else
+                PixelUtil::bulkPixelConversion(data, staging);
 
-        GL3PlusHardwareBuffer buffer(GL_PIXEL_UNPACK_BUFFER, dataSize, mUsage);
-        buffer.writeData(0, dataSize, data.data, false);
-
-        // std::stringstream str;
-        // str << "GL3PlusHardwarePixelBuffer::upload: " << mTextureID
-        // << " pixel buffer: " << buffer.getGLBufferId()
-        // << " bytes: " << mSizeInBytes
-        // << " dest depth: " << dest.getDepth()
-        // << " dest front: " << dest.front
-        // << " datasize: " << dataSize
-        // << " face: " << mFace << " level: " << mLevel
-        // << " width: " << mWidth << " height: "<< mHeight << " depth: " << mDepth
-        // << " format: " << PixelUtil::getFormatName(mFormat);
-        // LogManager::getSingleton().logMessage(LML_NORMAL, str.str());
-
-        void* pdata = NULL;
-#else
-        void* pdata = data.getTopLeftFrontPixelPtr();
-#endif
+            // The pixels are consecutive now, and addressed by their offset in the buffer
+            data = staging;
+            pdata = reinterpret_cast<void*>(offset);
+            stateCacheManager->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER, ringBuffer->getGLBufferId());
+        }
 
         if (PixelUtil::isCompressed(data.format))
         {
@@ -293,6 +288,8 @@ namespace Ogre {
         }
 
         // Restore defaults.
+        if (staged)
+            stateCacheManager->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
         OGRE_CHECK_GL_ERROR(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
         OGRE_CHECK_GL_ERROR(glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0));
         OGRE_CHECK_GL_ERROR(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
@@ -373,6 +370,34 @@ namespace Ogre {
         buffer.readData(offsetInBytes, mSizeInBytes, data.getTopLeftFrontPixelPtr());
     }
 
+    AsyncReadbackPtr GL3PlusTextureBuffer::blitToMemoryAsync(const Box &srcBox)
+    {
+        if (!mBuffer.contains(srcBox))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                        "source box out of range",
+                        "GL3PlusTextureBuffer::blitToMemoryAsync");
+        }
+
+        GLenum format = GL3PlusPixelUtil::getGLOriginFormat(mFormat);
+        if (PixelUtil::isCompressed(mFormat) || format == 0)
+            return GL3PlusHardwarePixelBuffer::blitToMemoryAsync(srcBox);
+
+        // We can only get the entire texture, the box is picked out when fetched
+        GL3PlusAsyncReadback* readback = OGRE_NEW GL3PlusAsyncReadback(
+            mRenderSystem, PixelBox(mWidth, mHeight, mDepth, mFormat), srcBox, false);
+        AsyncReadbackPtr ticket(readback);
+
+        mRenderSystem->_getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
+        OGRE_CHECK_GL_ERROR(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+        OGRE_CHECK_GL_ERROR(glGetTexImage(mFaceTarget, mLevel, format,
+                                          GL3PlusPixelUtil::getGLOriginDataType(mFormat), 0));
+        OGRE_CHECK_GL_ERROR(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+
+        readback->fence();
+        return ticket;
+    }
+
 
     void GL3PlusTextureBuffer::bindToFramebuffer(uint32 attachment, uint32 zoffset)
     {
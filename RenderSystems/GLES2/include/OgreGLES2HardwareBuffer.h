@@ -34,6 +34,27 @@ THE SOFTWARE.
 
 namespace Ogre {
     class GLES2RenderSystem;
+
+    /** How locks of write only buffers upload their data.
+    @remarks
+        Tile based mobile GPUs stall when a buffer still in use is mapped, and
+        which way around that is fastest depends on the driver, so
+        GLES2RenderSystem picks one by the buffer usage and the GPU vendor.
+    */
+    enum GLES2UploadStrategy
+    {
+        /// Let GLES2RenderSystem decide
+        GLES2_UPLOAD_AUTO,
+        /// Map the buffer range, invalidating it on discard
+        GLES2_UPLOAD_MAP,
+        /// Orphan the whole buffer with glBufferData(NULL) on discard, then map it
+        GLES2_UPLOAD_ORPHAN,
+        /// Write into an unsynchronised, fenced ring buffer and copy on unlock (GLES3)
+        GLES2_UPLOAD_UNSYNCHRONIZED,
+        /// Write into memory and upload it with one glBufferSubData on unlock
+        GLES2_UPLOAD_SUBDATA
+    };
+
     class GLES2HardwareBuffer
     {
         private:
@@ -44,6 +65,18 @@ namespace Ogre {
             GLuint mBufferId;
             GLES2RenderSystem* mRenderSystem;
 
+            /// How the current lock uploads its data, and where
+            GLES2UploadStrategy mLockStrategy;
+            size_t mLockOffset;
+            bool mLockDiscard;
+            /// Offset of the lock in the ring buffer, for GLES2_UPLOAD_UNSYNCHRONIZED
+            size_t mStagingOffset;
+            /// Memory written by the lock, for GLES2_UPLOAD_SUBDATA
+            void* mScratch;
+
+            /// Map the buffer, the path used before upload strategies
+            void* mapImpl(size_t offset, size_t length, HardwareBuffer::LockOptions options);
+
             /// Utility function to get the correct GL usage based on HBU's
             static GLenum getGLUsage(uint32 usage);
 
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "OgreRenderSystem.h"
 #include "OgreGLSLESProgram.h"
 #include "OgreGLRenderSystemCommon.h"
+#include "OgreGLES2HardwareBuffer.h"
 
 namespace Ogre {
     /** \addtogroup RenderSystems RenderSystems
@@ -49,6 +50,7 @@ namespace Ogre {
     class GLSLESProgramCommon;
     class GLSLESProgramFactory;
     class GLES2StateCacheManager;
+    class GLES2RingBuffer;
 #if !OGRE_NO_GLES2_CG_SUPPORT
     class GLSLESCgProgramFactory;
 #endif
@@ -87,6 +89,14 @@ namespace Ogre {
 #endif
             HardwareBufferManager* mHardwareBufferManager;
 
+            /// Staging buffer of GLES2_UPLOAD_UNSYNCHRONIZED, GLES3 only
+            GLES2RingBuffer* mRingBuffer;
+            /// Strategy set with setUploadStrategy
+            GLES2UploadStrategy mUploadStrategy;
+            /// Strategy of dynamic buffers picked by the GPU vendor
+            GLES2UploadStrategy mDynamicUploadStrategy;
+            void createRingBuffer(void);
+
             /** Manager object for creating render textures.
                 Direct render to texture via GL_OES_framebuffer_object is preferable 
                 to pbuffers, which depend on the GL support used and are generally 
@@ -254,6 +264,22 @@ namespace Ogre {
             bool checkExtension(const String& ext) const;
         
             GLES2StateCacheManager * _getStateCacheManager() { return mStateCacheManager; }
+
+            /** Set how locks of write only buffers upload their data.
+            @remarks
+                Applies to the next lock of every buffer. With GLES2_UPLOAD_AUTO,
+                the default, static buffers are mapped and dynamic ones use what
+                suits the GPU vendor: orphaning on the tile based GPUs (ARM,
+                Qualcomm, Imagination, Apple), the unsynchronised ring buffer
+                elsewhere on GLES3, and glBufferSubData when buffers cannot be
+                mapped.
+            */
+            void setUploadStrategy(GLES2UploadStrategy strategy) { mUploadStrategy = strategy; }
+            GLES2UploadStrategy getUploadStrategy(void) const { return mUploadStrategy; }
+            /// Gets the strategy a buffer with the given usage uploads with
+            GLES2UploadStrategy _getUploadStrategy(uint32 usage) const;
+            /// Gets the staging buffer of GLES2_UPLOAD_UNSYNCHRONIZED, 0 before GLES3
+            GLES2RingBuffer* _getRingBuffer(void) const { return mRingBuffer; }
         
             /** Create VAO on current context */
             uint32 _createVao();
@@ -282,6 +308,8 @@ namespace Ogre {
              * Set current render target to target, enabling its GL context if needed
              */
             void _setRenderTarget(RenderTarget *target);
+            /// @copydoc RenderSystem::_discardRenderTarget
+            void _discardRenderTarget(RenderTarget* target, unsigned int buffers);
 
             GLint convertCompareFunction(CompareFunction func) const;
             GLint convertStencilOp(StencilOperation op, bool invert = false) const;
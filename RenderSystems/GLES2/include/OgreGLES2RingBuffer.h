@@ -0,0 +1,94 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __GLES2RingBuffer_H__
+#define __GLES2RingBuffer_H__
+
+#include "OgreGLES2Prerequisites.h"
+
+namespace Ogre {
+#if OGRE_NO_GLES3_SUPPORT == 0
+    /** Buffer which updates of dynamic buffers are staged in, on GLES3.
+    @remarks
+        GLES3 has no persistent mapping, so each allocation is mapped on its
+        own with GL_MAP_UNSYNCHRONIZED_BIT, which never waits for the GPU. That
+        is safe because space is handed out in a ring and the allocations of
+        each frame are retired by a fence, which is only waited on when the
+        ring has wrapped around onto space the GPU may still be copying from.
+        GLES2HardwareBuffer copies the staged data into place on unlock.
+    */
+    class GLES2RingBuffer
+    {
+    private:
+        struct Fence
+        {
+            GLsync sync;
+            /// Ring position up to which the fenced allocations reach
+            uint64 end;
+        };
+        typedef deque<Fence>::type FenceList;
+
+        GLuint mBufferId;
+        size_t mSizeInBytes;
+        /// Positions of the next allocation and of the oldest one still in use.
+        /// They only ever grow; the offset in the buffer is the position modulo its size.
+        uint64 mHead;
+        uint64 mTail;
+        /// Position at the last fence
+        uint64 mFencedHead;
+        FenceList mFences;
+
+        /// Waits for the oldest fence and frees the space it covers
+        void retireOldest(void);
+    public:
+        /// Alignment of the allocations
+        static const size_t ALIGNMENT = 16;
+
+        explicit GLES2RingBuffer(size_t sizeInBytes);
+        ~GLES2RingBuffer();
+
+        /** Allocates length bytes, waiting for the GPU if the ring is full.
+        @return Offset of the allocation in the buffer, to be passed to map.
+        */
+        size_t allocate(size_t length);
+
+        /// Maps an allocation for writing, leaving the buffer bound to GL_COPY_READ_BUFFER
+        void* map(size_t offset, size_t length);
+        /// Unmaps the allocation mapped last, of which length bytes were written
+        void unmap(size_t length);
+
+        /** Fences the allocations made since the last call, and retires those
+            which the GPU has finished with. Call once per frame.
+        */
+        void fence(void);
+
+        GLuint getGLBufferId(void) const { return mBufferId; }
+        size_t getSizeInBytes(void) const { return mSizeInBytes; }
+    };
+#endif
+}
+#endif // __GLES2RingBuffer_H__
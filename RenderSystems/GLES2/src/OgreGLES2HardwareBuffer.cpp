@@ -30,10 +30,13 @@ THE SOFTWARE.
 #include "OgreRoot.h"
 #include "OgreGLES2RenderSystem.h"
 #include "OgreGLES2StateCacheManager.h"
+#include "OgreGLES2RingBuffer.h"
 
 namespace Ogre {
     GLES2HardwareBuffer::GLES2HardwareBuffer(GLenum target, size_t sizeInBytes, GLenum usage)
-        : mTarget(target), mSizeInBytes(sizeInBytes), mUsage(usage)
+        : mTarget(target), mSizeInBytes(sizeInBytes), mUsage(usage),
+          mLockStrategy(GLES2_UPLOAD_MAP), mLockOffset(0), mLockDiscard(false), mStagingOffset(0),
+          mScratch(0)
     {
         mRenderSystem = static_cast<GLES2RenderSystem*>(Root::getSingleton().getRenderSystem());
         createBuffer();
@@ -74,6 +77,50 @@ namespace Ogre {
 
     void* GLES2HardwareBuffer::lockImpl(size_t offset, size_t length,
                                         HardwareBuffer::LockOptions options)
+    {
+        mLockStrategy = GLES2_UPLOAD_MAP;
+        mLockOffset = offset;
+        mLockDiscard = options == HardwareBuffer::HBL_DISCARD;
+
+        // Only discarding locks may upload the range from elsewhere, others keep
+        // the bytes which are not written
+        if (!(mUsage & HardwareBuffer::HBU_WRITE_ONLY) || !mLockDiscard)
+            return mapImpl(offset, length, options);
+
+        mLockStrategy = mRenderSystem->_getUploadStrategy(mUsage);
+        switch (mLockStrategy)
+        {
+        case GLES2_UPLOAD_SUBDATA:
+            mScratch = OGRE_MALLOC_SIMD(length, MEMCATEGORY_GEOMETRY);
+            return mScratch;
+#if OGRE_NO_GLES3_SUPPORT == 0
+        case GLES2_UPLOAD_UNSYNCHRONIZED:
+            {
+                // Large updates would wrap the ring onto what the GPU still reads every time
+                GLES2RingBuffer* ringBuffer = mRenderSystem->_getRingBuffer();
+                if (ringBuffer && length <= ringBuffer->getSizeInBytes() / 4)
+                {
+                    mStagingOffset = ringBuffer->allocate(length);
+                    return ringBuffer->map(mStagingOffset, length);
+                }
+            }
+            // fall through
+#endif
+        case GLES2_UPLOAD_ORPHAN:
+            // Hand the old storage to the driver, which frees it once the GPU is done
+            mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
+            OGRE_CHECK_GL_ERROR(glBufferData(mTarget, mSizeInBytes, NULL, getGLUsage(mUsage)));
+            mLockStrategy = GLES2_UPLOAD_MAP;
+            // The new storage is not in use, so it needs no further discarding
+            return mapImpl(offset, length, HardwareBuffer::HBL_NORMAL);
+        default:
+            mLockStrategy = GLES2_UPLOAD_MAP;
+            return mapImpl(offset, length, options);
+        }
+    }
+
+    void* GLES2HardwareBuffer::mapImpl(size_t offset, size_t length,
+                                       HardwareBuffer::LockOptions options)
     {
         GLenum access = 0;
 
@@ -93,6 +140,11 @@ namespace Ogre {
                     // Discard the buffer
                     access |= GL_MAP_INVALIDATE_RANGE_BIT_EXT;
                 }
+                if (options == HardwareBuffer::HBL_NO_OVERWRITE)
+                {
+                    // The range is not in use by the GPU, so there is nothing to wait for
+                    access |= GL_MAP_UNSYNCHRONIZED_BIT_EXT;
+                }
             }
             else if (options == HardwareBuffer::HBL_READ_ONLY)
                 access = GL_MAP_READ_BIT_EXT;
@@ -133,6 +185,27 @@ namespace Ogre {
 
     void GLES2HardwareBuffer::unlockImpl(size_t lockSize)
     {
+        if (mLockStrategy == GLES2_UPLOAD_SUBDATA)
+        {
+            writeData(mLockOffset, lockSize, mScratch, mLockDiscard);
+            OGRE_FREE_SIMD(mScratch, MEMCATEGORY_GEOMETRY);
+            mScratch = 0;
+            return;
+        }
+#if OGRE_NO_GLES3_SUPPORT == 0
+        if (mLockStrategy == GLES2_UPLOAD_UNSYNCHRONIZED)
+        {
+            GLES2RingBuffer* ringBuffer = mRenderSystem->_getRingBuffer();
+            ringBuffer->unmap(lockSize);
+
+            // The ring buffer is still bound to GL_COPY_READ_BUFFER
+            mRenderSystem->_getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, mBufferId);
+            OGRE_CHECK_GL_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                                    mStagingOffset, mLockOffset, lockSize));
+            return;
+        }
+#endif
+
         mRenderSystem->_getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
 
         bool hasMapBufferRange = !OGRE_NO_GLES3_SUPPORT || mRenderSystem->checkExtension("GL_EXT_map_buffer_range");
@@ -201,19 +274,17 @@ namespace Ogre {
                                        size_t length, bool discardWholeBuffer)
     {
 #if OGRE_NO_GLES3_SUPPORT == 0
+        GLES2StateCacheManager* stateCacheManager = mRenderSystem->_getStateCacheManager();
+
         // Zero out this(destination) buffer
-        OGRE_CHECK_GL_ERROR(glBindBuffer(mTarget, mBufferId));
+        stateCacheManager->bindGLBuffer(mTarget, mBufferId);
         OGRE_CHECK_GL_ERROR(glBufferData(mTarget, length, 0, getGLUsage(mUsage)));
-        OGRE_CHECK_GL_ERROR(glBindBuffer(mTarget, 0));
 
-        // Do it the fast way.
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, srcBufferId));
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, mBufferId));
+        // Do it the fast way. Bound through the cache, which the ring buffer relies on
+        stateCacheManager->bindGLBuffer(GL_COPY_READ_BUFFER, srcBufferId);
+        stateCacheManager->bindGLBuffer(GL_COPY_WRITE_BUFFER, mBufferId);
 
         OGRE_CHECK_GL_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, dstOffset, length));
-
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, 0));
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
 #else
         OgreAssert(false, "GLES3 needed");
 #endif
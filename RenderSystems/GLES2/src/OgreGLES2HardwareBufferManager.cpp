@@ -164,6 +164,11 @@ namespace Ogre {
             case VET_USHORT4_NORM:
 #if OGRE_NO_GLES3_SUPPORT == 0
                 return GL_UNSIGNED_SHORT;
+#endif
+            case VET_HALF2:
+            case VET_HALF4:
+#if OGRE_NO_GLES3_SUPPORT == 0
+                return GL_HALF_FLOAT;
 #endif
             case VET_DOUBLE1:
             case VET_DOUBLE2:
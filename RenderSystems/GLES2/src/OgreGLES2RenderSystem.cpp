@@ -50,6 +50,7 @@ THE SOFTWARE.
 #include "OgreGLSLESProgramPipelineManager.h"
 #include "OgreGLSLESProgramPipeline.h"
 #include "OgreGLES2StateCacheManager.h"
+#include "OgreGLES2RingBuffer.h"
 #include "OgreRenderWindow.h"
 #include "OgreGLES2PixelFormat.h"
 
@@ -118,6 +119,9 @@ namespace Ogre {
           mGpuProgramManager(0),
           mGLSLESProgramFactory(0),
           mHardwareBufferManager(0),
+          mRingBuffer(0),
+          mUploadStrategy(GLES2_UPLOAD_AUTO),
+          mDynamicUploadStrategy(GLES2_UPLOAD_MAP),
           mRTTManager(0),
           mCurTexMipCount(0)
     {
@@ -255,6 +259,16 @@ namespace Ogre {
         OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &units));
         rsc->setNumTextureUnits(std::min<ushort>(16, units));
 
+        // Vertex texture fetching, guaranteed by GLES3 and optional in GLES2,
+        // needed by the VTF instancing techniques
+        GLint vUnits;
+        OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, &vUnits));
+        rsc->setNumVertexTextureUnits(static_cast<ushort>(vUnits));
+        if (vUnits > 0)
+            rsc->setCapability(RSC_VERTEX_TEXTURE_FETCH);
+        // GLES always shares vertex and fragment texture units
+        rsc->setVertexTextureUnitsShared(true);
+
         // Check for hardware stencil support and set bit depth
         GLint stencil;
 
@@ -529,6 +543,20 @@ namespace Ogre {
         // Use VBO's by default
         mHardwareBufferManager = OGRE_NEW GLES2HardwareBufferManager();
 
+        // Tilers stall on mapping a buffer the GPU still reads, orphaning hands it the old storage
+        bool hasMapBufferRange = hasMinGLVersion(3, 0) || checkExtension("GL_EXT_map_buffer_range");
+        GPUVendor vendor = caps->getVendor();
+        if (!hasMapBufferRange && !checkExtension("GL_OES_mapbuffer"))
+            mDynamicUploadStrategy = GLES2_UPLOAD_SUBDATA;
+        else if (vendor == GPU_ARM || vendor == GPU_QUALCOMM ||
+                 vendor == GPU_IMAGINATION_TECHNOLOGIES || vendor == GPU_APPLE)
+            mDynamicUploadStrategy = GLES2_UPLOAD_ORPHAN;
+        else if (hasMinGLVersion(3, 0))
+            mDynamicUploadStrategy = GLES2_UPLOAD_UNSYNCHRONIZED;
+        else
+            mDynamicUploadStrategy = GLES2_UPLOAD_ORPHAN;
+        createRingBuffer();
+
         // Create FBO manager
         LogManager::getSingleton().logMessage("GL ES 2: Using FBOs for rendering to textures");
         mRTTManager = new GLES2FBOManager();
@@ -543,6 +571,25 @@ namespace Ogre {
         mGLInitialised = true;
     }
 
+    void GLES2RenderSystem::createRingBuffer(void)
+    {
+#if OGRE_NO_GLES3_SUPPORT == 0
+        // Large enough for a few frames of typical billboard and overlay data
+        if (!mRingBuffer && hasMinGLVersion(3, 0))
+            mRingBuffer = new GLES2RingBuffer(4 * 1024 * 1024);
+#endif
+    }
+
+    GLES2UploadStrategy GLES2RenderSystem::_getUploadStrategy(uint32 usage) const
+    {
+        GLES2UploadStrategy strategy = mUploadStrategy;
+        if (strategy == GLES2_UPLOAD_AUTO)
+            strategy = (usage & HardwareBuffer::HBU_STATIC) ? GLES2_UPLOAD_MAP : mDynamicUploadStrategy;
+        if (strategy == GLES2_UPLOAD_UNSYNCHRONIZED && !mRingBuffer)
+            strategy = GLES2_UPLOAD_ORPHAN;
+        return strategy;
+    }
+
     void GLES2RenderSystem::shutdown(void)
     {
 
@@ -574,6 +621,9 @@ namespace Ogre {
         OGRE_DELETE mHardwareBufferManager;
         mHardwareBufferManager = 0;
 
+        delete mRingBuffer;
+        mRingBuffer = 0;
+
         delete mRTTManager;
         mRTTManager = 0;
 
@@ -1102,6 +1152,12 @@ namespace Ogre {
         unbindGpuProgram(GPT_VERTEX_PROGRAM);
 		unbindGpuProgram(GPT_FRAGMENT_PROGRAM);
 
+#if OGRE_NO_GLES3_SUPPORT == 0
+        // Retire the dynamic buffer updates of this frame once the GPU is done with them
+        if (mRingBuffer)
+            mRingBuffer->fence();
+#endif
+
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
         static_cast<EAGLES2Context*>(mMainContext)->bindSampleFramebuffer();
 #endif
@@ -1561,10 +1617,14 @@ namespace Ogre {
 //          OGRE_CHECK_GL_ERROR(glDisableVertexAttribArray(*ai));
         }
 
-        // Unbind any instance attributes
-        for (vector<GLuint>::type::iterator ai = mRenderInstanceAttribsBound.begin(); ai != mRenderInstanceAttribsBound.end(); ++ai)
+        // Unbind any instance attributes, with VAOs the divisors stay with the VAO
+        // and are reset by bindVertexElementToGpu when it is rebound
+        if (!getCapabilities()->hasCapability(RSC_VAO))
         {
-            glVertexAttribDivisorEXT(*ai, 0);
+            for (vector<GLuint>::type::iterator ai = mRenderInstanceAttribsBound.begin(); ai != mRenderInstanceAttribsBound.end(); ++ai)
+            {
+                glVertexAttribDivisorEXT(*ai, 0);
+            }
         }
 
         mRenderAttribsBound.clear();
@@ -1879,6 +1939,64 @@ namespace Ogre {
         }
     }
 
+    void GLES2RenderSystem::_discardRenderTarget(RenderTarget* target, unsigned int buffers)
+    {
+        bool invalidate = hasMinGLVersion(3, 0);
+        if (!invalidate && !checkExtension("GL_EXT_discard_framebuffer"))
+            return;
+
+        GLenum attachments[OGRE_MAX_MULTIPLE_RENDER_TARGETS + 2];
+        GLsizei count = 0;
+
+        GLES2FrameBufferObject *fbo = 0;
+        target->getCustomAttribute("FBO", &fbo);
+        if (fbo)
+        {
+            for (size_t x = 0; (buffers & FBT_COLOUR) && x < OGRE_MAX_MULTIPLE_RENDER_TARGETS; ++x)
+            {
+                if (fbo->getSurface(x).buffer)
+                    attachments[count++] = static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + x);
+            }
+            if (buffers & FBT_DEPTH)
+                attachments[count++] = GL_DEPTH_ATTACHMENT;
+            if (buffers & FBT_STENCIL)
+                attachments[count++] = GL_STENCIL_ATTACHMENT;
+        }
+#if OGRE_PLATFORM != OGRE_PLATFORM_APPLE_IOS
+        else
+        {
+            // The default framebuffer names its buffers directly, iOS windows
+            // are framebuffer objects which discard their own buffers on swap
+            if (buffers & FBT_COLOUR)
+                attachments[count++] = GL_COLOR_EXT;
+            if (buffers & FBT_DEPTH)
+                attachments[count++] = GL_DEPTH_EXT;
+            if (buffers & FBT_STENCIL)
+                attachments[count++] = GL_STENCIL_EXT;
+        }
+#endif
+
+        if (!count)
+            return;
+
+        // Bind the target for the call only, the viewport may skip binding it again
+        RenderTarget* previous = mActiveRenderTarget;
+        if (previous != target)
+            _setRenderTarget(target);
+#if OGRE_NO_GLES3_SUPPORT == 0
+        if (invalidate)
+        {
+            OGRE_CHECK_GL_ERROR(glInvalidateFramebuffer(GL_FRAMEBUFFER, count, attachments));
+        }
+        else
+#endif
+        {
+            OGRE_CHECK_GL_ERROR(glDiscardFramebufferEXT(GL_FRAMEBUFFER, count, attachments));
+        }
+        if (previous != target)
+            _setRenderTarget(previous);
+    }
+
     GLint GLES2RenderSystem::convertCompareFunction(CompareFunction func) const
     {
         switch(func)
@@ -2131,6 +2249,9 @@ namespace Ogre {
 #if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID || OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
     void GLES2RenderSystem::notifyOnContextLost() {
         static_cast<GLES2HardwareBufferManager*>(HardwareBufferManager::getSingletonPtr())->notifyContextDestroyed(mCurrentContext);
+        // The buffer and fences died with the context
+        delete mRingBuffer;
+        mRingBuffer = 0;
         GLES2RenderSystem::mResourceManager->notifyOnContextLost();
     }
 
@@ -2157,6 +2278,7 @@ namespace Ogre {
         GLES2RenderSystem::mResourceManager->notifyOnContextReset();
         
         mStateCacheManager->clearCache();
+        createRingBuffer();
         _setViewport(NULL);
         _setRenderTarget(win);
     }
@@ -2209,6 +2331,11 @@ namespace Ogre {
                     OGRE_CHECK_GL_ERROR(glVertexAttribDivisorEXT(attrib, static_cast<GLuint>(hwGlBuffer->getInstanceDataStepRate())));
                     mRenderInstanceAttribsBound.push_back(attrib);
                 }
+                else if (getCapabilities()->hasCapability(RSC_VAO))
+                {
+                    // The divisor is VAO state, a reused VAO may still have one set for this attribute
+                    OGRE_CHECK_GL_ERROR(glVertexAttribDivisorEXT(attrib, 0));
+                }
             }
         }
 
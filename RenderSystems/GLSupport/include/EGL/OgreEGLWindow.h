@@ -86,6 +86,7 @@ namespace Ogre {
             void setVisible(bool visible);
             void swapBuffers();
             void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer);
+            AsyncReadbackPtr copyContentsToMemoryAsync(const Box& src, FrameBuffer buffer);
 
             /** @copydoc see RenderWindow::setVSyncEnabled */
             void setVSyncEnabled(bool vsync);
@@ -67,6 +67,13 @@ namespace Ogre {
     public:
         virtual ~GLSLProgramManagerCommon() {}
 
+        /** Name of the uniform block whose members are parsed as ordinary
+            uniforms, so that they can be bound to (auto) parameters.
+            Render systems which support it pack them into one buffer
+            range per draw instead of setting them one at a time.
+        */
+        static const String PACKED_UNIFORM_BLOCK_NAME;
+
         /** Populate a list of uniforms based on GLSL source and store
             them in GpuNamedConstants.  
             @param src Reference to the source code.
@@ -94,6 +94,8 @@ namespace Ogre
         
         /** @copydoc see RenderTarget::copyContentsToMemory */
         void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer);
+        /** @copydoc see RenderTarget::copyContentsToMemoryAsync */
+        AsyncReadbackPtr copyContentsToMemoryAsync(const Box& src, FrameBuffer buffer);
         
         /**
            @remarks
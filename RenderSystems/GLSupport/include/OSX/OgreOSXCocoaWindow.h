@@ -105,6 +105,8 @@ namespace Ogre {
         void swapBuffers();
         /** Overridden - see RenderTarget */
         virtual void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer);
+        /** Overridden - see RenderTarget */
+        virtual AsyncReadbackPtr copyContentsToMemoryAsync(const Box& src, FrameBuffer buffer);
         /** Overridden - see RenderWindow */
         virtual void setFullscreen(bool fullScreen, unsigned int widthPt, unsigned int heightPt);
         /** Overridden - see RenderWindow */
@@ -51,6 +51,16 @@ namespace Ogre {
         virtual void _copyContentsToMemory(Viewport* vp, const Box& src, const PixelBox& dst,
                                            RenderWindow::FrameBuffer buffer) = 0;
 
+        /** @copydoc RenderTarget::copyContentsToMemoryAsync
+            @return the ticket, or a null one if the render system has no
+            asynchronous readback and the window is to copy at once
+        */
+        virtual AsyncReadbackPtr _copyContentsToMemoryAsync(Viewport* vp, const Box& src,
+                                                            RenderWindow::FrameBuffer buffer)
+        {
+            return AsyncReadbackPtr();
+        }
+
         /** Returns the main context */
         GLContext* _getMainContext() { return mMainContext; }
 
@@ -70,6 +80,17 @@ namespace Ogre {
                                             const HardwareVertexBufferSharedPtr& vertexBuffer,
                                             const size_t vertexStart) = 0;
 
+        /** Whether vertex attribute formats can be specified separately from the vertex
+            buffers (GL_ARB_vertex_attrib_binding), so that a VAO can keep its formats and
+            only switch buffers with bindVertexBufferToGpu */
+        virtual bool _hasSeparateVertexFormat() const { return false; }
+        /// Specifies the format of the attribute of elem and reads it from bindingIndex
+        virtual void bindVertexElementFormatToGpu(const VertexElement& elem, uint32 bindingIndex) {}
+        /// Binds vertexBuffer to bindingIndex of the current VAO
+        virtual void bindVertexBufferToGpu(uint32 bindingIndex,
+                                           const HardwareVertexBufferSharedPtr& vertexBuffer,
+                                           const size_t vertexStart) {}
+
         Real getHorizontalTexelOffset(void) { return 0.0; }               // No offset in GL
         Real getVerticalTexelOffset(void) { return 0.0; }                 // No offset in GL
         Real getMinimumDepthInputValue(void) { return -1.0f; }            // Range [-1.0f, 1.0f]
@@ -49,6 +49,13 @@ namespace Ogre {
         vector<uint32>::type mInstanceAttribsBound;
         size_t mVertexStart;
 
+        /// Whether the attribute formats are kept separately from the buffers
+        bool mSeparateFormat;
+        /// With separate formats, buffer and vertex start bound to each source binding index
+        vector<std::pair<HardwareVertexBuffer*, size_t> >::type mBuffersBound;
+
+        void bindSeparateFormatToGpu(GLRenderSystemCommon* rs, VertexBufferBinding* vertexBufferBinding, size_t vertexStart);
+
         void notifyChanged() { mNeedsUpdate = true; }
     public:
         GLVertexArrayObject();
@@ -58,6 +58,8 @@ namespace Ogre {
 
         /** Overridden - see RenderTarget. */
         virtual void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer);
+        /** Overridden - see RenderTarget. */
+        virtual AsyncReadbackPtr copyContentsToMemoryAsync(const Box& src, FrameBuffer buffer);
 
         bool requiresTextureFlipping() const { return false; }
 
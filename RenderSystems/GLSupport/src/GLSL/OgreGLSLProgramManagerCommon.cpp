@@ -32,6 +32,8 @@
 
 namespace Ogre {
 
+    const String GLSLProgramManagerCommon::PACKED_UNIFORM_BLOCK_NAME = "OgrePackedUniforms";
+
     void GLSLProgramManagerCommon::parseGLSLUniform(
         String line, GpuNamedConstants& defs,
         const String& filename, const GpuSharedParametersPtr& sharedParams)
@@ -219,6 +221,9 @@ namespace Ogre {
                 {
                     // Gobble up the external name
                     String externalName = parts.front();
+                    String::size_type nameEndPos = externalName.find("{");
+                    if (nameEndPos != String::npos)
+                        externalName.erase(nameEndPos);
 
                     // Now there should be an opening brace
                     String::size_type openBracePos = src.find("{", currPos);
@@ -236,6 +241,20 @@ namespace Ogre {
                     // First we need to find the internal name for the uniform block
                     String::size_type endBracePos = src.find("}", currPos);
 
+                    // Members of the packed block are set like any other uniform,
+                    // the render system takes care of laying them out in the block
+                    if (externalName == PACKED_UNIFORM_BLOCK_NAME && endBracePos != String::npos)
+                    {
+                        StringVector members = StringUtil::split(
+                            src.substr(currPos, endBracePos - currPos), ";");
+                        for (StringVector::iterator i = members.begin(); i != members.end(); ++i)
+                        {
+                            StringUtil::trim(*i);
+                            if (!i->empty())
+                                parseGLSLUniform(*i, defs, filename, blockSharedParams);
+                        }
+                    }
+
                     // Find terminating semicolon
                     currPos = endBracePos + 1;
                     endPos = src.find(";", currPos);
@@ -497,6 +497,27 @@ namespace Ogre {
                 ->_copyContentsToMemory(getViewport(0), src, dst, buffer);
     }
 
+    AsyncReadbackPtr CocoaWindow::copyContentsToMemoryAsync(const Box& src, FrameBuffer buffer)
+    {
+        if(src.right > mWidth || src.bottom > mHeight || src.front != 0 || src.back != 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box.", "CocoaWindow::copyContentsToMemoryAsync");
+        }
+
+        if (buffer == FB_AUTO)
+        {
+            buffer = mIsFullScreen? FB_FRONT : FB_BACK;
+        }
+
+        AsyncReadbackPtr ticket = static_cast<GLRenderSystemCommon*>(Root::getSingleton().getRenderSystem())
+                ->_copyContentsToMemoryAsync(getViewport(0), src, buffer);
+        if (ticket)
+            return ticket;
+
+        // The render system has no asynchronous readback, copy at once
+        return RenderTarget::copyContentsToMemoryAsync(src, buffer);
+    }
+
     float CocoaWindow::getViewPointToPixelScale()
     {
         return mContentScalingFactor > 1.0f ? mContentScalingFactor : 1.0f;
@@ -30,15 +30,13 @@ THE SOFTWARE.
 #include "OgreResourceGroupManager.h"
 #include "OgreRoot.h"
 #include "OgreBitwise.h"
+#include "Threading/OgreParallel.h"
 
 namespace Ogre
 {
-void GLTextureCommon::readImage(LoadedImages& imgs, const String& name, const String& ext, bool haveNPOT)
+namespace {
+void decodeImage(Image& img, DataStreamPtr& dstream, const String& ext, bool haveNPOT)
 {
-    imgs.push_back(Image());
-    Image& img = imgs.back();
-
-    DataStreamPtr dstream = ResourceGroupManager::getSingleton().openResource(name, mGroup, this);
     img.load(dstream, ext);
 
     if( haveNPOT )
@@ -51,6 +49,37 @@ void GLTextureCommon::readImage(LoadedImages& imgs, const String& name, const St
         img.resize(w, h);
 }
 
+/// Decodes the faces of a cube map on separate threads
+struct CubeFaceDecoder
+{
+    Image* images;
+    DataStreamPtr* streams;
+    /// exceptions can not leave worker threads, so they are reported here
+    String* errors;
+    String ext;
+    bool haveNPOT;
+
+    void operator()(size_t face) const
+    {
+        try
+        {
+            decodeImage(images[face], streams[face], ext, haveNPOT);
+        }
+        catch (Exception& e)
+        {
+            errors[face] = e.getFullDescription();
+        }
+    }
+};
+}
+
+void GLTextureCommon::readImage(LoadedImages& imgs, const String& name, const String& ext, bool haveNPOT)
+{
+    imgs.push_back(Image());
+    DataStreamPtr dstream = ResourceGroupManager::getSingleton().openResource(name, mGroup, this);
+    decodeImage(imgs.back(), dstream, ext, haveNPOT);
+}
+
 HardwarePixelBufferSharedPtr GLTextureCommon::getBuffer(size_t face, size_t mipmap)
 {
     if (face >= getNumFaces())
@@ -133,6 +162,7 @@ void GLTextureCommon::prepareImpl(void)
         }
         else
         {
+            DataStreamPtr streams[6];
             for (size_t i = 0; i < 6; i++)
             {
                 String fullName = baseName + CUBEMAP_SUFFIXES[i];
@@ -140,7 +170,24 @@ void GLTextureCommon::prepareImpl(void)
                     fullName = fullName + "." + ext;
                 // find & load resource data intro stream to allow resource
                 // group changes if required
-                readImage(loadedImages, fullName, ext, haveNPOT);
+                streams[i] = ResourceGroupManager::getSingleton().openResource(fullName, mGroup, this);
+            }
+
+            // the faces are independent, so decode them in parallel
+            loadedImages.resize(6);
+            String errors[6];
+            CubeFaceDecoder decoder;
+            decoder.images = &loadedImages[0];
+            decoder.streams = streams;
+            decoder.errors = errors;
+            decoder.ext = ext;
+            decoder.haveNPOT = haveNPOT;
+            parallelFor(0, 6, decoder);
+
+            for (size_t i = 0; i < 6; i++)
+            {
+                if (!errors[i].empty())
+                    OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, errors[i], "GLTextureCommon::prepareImpl");
             }
         }
     }
@@ -32,7 +32,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGLRenderSystemCommon.h"
 
 namespace Ogre {
-    GLVertexArrayObject::GLVertexArrayObject() : mCreatorContext(0), mVAO(0), mNeedsUpdate(true), mVertexStart(0) {
+    GLVertexArrayObject::GLVertexArrayObject() : mCreatorContext(0), mVAO(0), mNeedsUpdate(true), mVertexStart(0), mSeparateFormat(false) {
     }
 
     void GLVertexArrayObject::bind(GLRenderSystemCommon* rs)
@@ -49,6 +49,7 @@ namespace Ogre {
         {
             mCreatorContext = rs->_getCurrentContext();
             mVAO = rs->_createVao();
+            mSeparateFormat = rs->_hasSeparateVertexFormat();
             mNeedsUpdate = true;
         }
         rs->_bindVao(mCreatorContext, mVAO);
@@ -78,9 +79,17 @@ namespace Ogre {
             if (!GLSLProgramCommon::isAttributeValid(sem, elemIndex))
                 continue; // Skip unused elements
 
+            const HardwareVertexBufferSharedPtr& vertexBuffer = vertexBufferBinding->getBuffer(source);
+            if (mSeparateFormat)
+            {
+                if (source >= mBuffersBound.size() ||
+                    mBuffersBound[source] != std::make_pair(vertexBuffer.get(), vertexStart))
+                    return true;
+                continue;
+            }
+
             uint32 attrib = (uint32)GLSLProgramCommon::getFixedAttributeIndex(sem, elemIndex);
 
-            const HardwareVertexBufferSharedPtr& vertexBuffer = vertexBufferBinding->getBuffer(source);
             if (std::find(mAttribsBound.begin(), mAttribsBound.end(),
                           std::make_pair(attrib, vertexBuffer.get())) == mAttribsBound.end())
                 return true;
@@ -102,6 +111,12 @@ namespace Ogre {
                                         VertexBufferBinding* vertexBufferBinding,
                                         size_t vertexStart)
     {
+        if (mSeparateFormat)
+        {
+            bindSeparateFormatToGpu(rs, vertexBufferBinding, vertexStart);
+            return;
+        }
+
         mAttribsBound.clear();
         mInstanceAttribsBound.clear();
 
@@ -138,4 +153,61 @@ namespace Ogre {
         mVertexStart = vertexStart;
         mNeedsUpdate = false;
     }
+
+    void GLVertexArrayObject::bindSeparateFormatToGpu(GLRenderSystemCommon* rs,
+                                                      VertexBufferBinding* vertexBufferBinding,
+                                                      size_t vertexStart)
+    {
+        if (mNeedsUpdate)
+            mBuffersBound.clear();
+
+        VertexDeclaration::VertexElementList::const_iterator elemIter, elemEnd;
+        elemEnd = mElementList.end();
+
+        // Each source is read from the binding index of the same number, so the formats
+        // only have to be specified the first time a source gets a buffer
+        for (elemIter = mElementList.begin(); elemIter != elemEnd; ++elemIter)
+        {
+            const VertexElement& elem = *elemIter;
+
+            uint16 source = elem.getSource();
+
+            if (!vertexBufferBinding->isBufferBound(source))
+                continue; // Skip unbound elements
+
+            if (!GLSLProgramCommon::isAttributeValid(elem.getSemantic(), elem.getIndex()))
+                continue; // Skip unused elements
+
+            if (source >= mBuffersBound.size() || !mBuffersBound[source].first)
+                rs->bindVertexElementFormatToGpu(elem, source);
+        }
+
+        // Then only the buffers that changed are switched
+        for (elemIter = mElementList.begin(); elemIter != elemEnd; ++elemIter)
+        {
+            const VertexElement& elem = *elemIter;
+
+            uint16 source = elem.getSource();
+
+            if (!vertexBufferBinding->isBufferBound(source))
+                continue; // Skip unbound elements
+
+            if (!GLSLProgramCommon::isAttributeValid(elem.getSemantic(), elem.getIndex()))
+                continue; // Skip unused elements
+
+            if (source >= mBuffersBound.size())
+                mBuffersBound.resize(source + 1, std::pair<HardwareVertexBuffer*, size_t>(NULL, 0));
+
+            const HardwareVertexBufferSharedPtr& vertexBuffer = vertexBufferBinding->getBuffer(source);
+            std::pair<HardwareVertexBuffer*, size_t> bound(vertexBuffer.get(), vertexStart);
+            if (mBuffersBound[source] != bound)
+            {
+                rs->bindVertexBufferToGpu(source, vertexBuffer, vertexStart);
+                mBuffersBound[source] = bound;
+            }
+        }
+
+        mVertexStart = vertexStart;
+        mNeedsUpdate = false;
+    }
 }
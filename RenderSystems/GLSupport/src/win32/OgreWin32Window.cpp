@@ -874,6 +874,27 @@ namespace Ogre {
                 ->_copyContentsToMemory(getViewport(0), src, dst, buffer);
     }
 
+    AsyncReadbackPtr Win32Window::copyContentsToMemoryAsync(const Box& src, FrameBuffer buffer)
+    {
+        if(src.right > mWidth || src.bottom > mHeight || src.front != 0 || src.back != 1)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box.", "Win32Window::copyContentsToMemoryAsync");
+        }
+
+        if (buffer == FB_AUTO)
+        {
+            buffer = mIsFullScreen? FB_FRONT : FB_BACK;
+        }
+
+        AsyncReadbackPtr ticket = static_cast<GLRenderSystemCommon*>(Root::getSingleton().getRenderSystem())
+                ->_copyContentsToMemoryAsync(getViewport(0), src, buffer);
+        if (ticket)
+            return ticket;
+
+        // The render system has no asynchronous readback, copy at once
+        return RenderTarget::copyContentsToMemoryAsync(src, buffer);
+    }
+
     void Win32Window::getCustomAttribute( const String& name, void* pData )
     {
         if( name == "GLCONTEXT" ) {
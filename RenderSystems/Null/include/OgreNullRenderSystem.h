@@ -0,0 +1,168 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullRenderSystem_H__
+#define __NullRenderSystem_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreRenderSystem.h"
+
+namespace Ogre {
+    class DefaultHardwareBufferManager;
+
+    /** \addtogroup RenderSystems RenderSystems
+    *  @{
+    */
+    /** \defgroup Null Null
+    * Render system that renders nothing
+    *  @{
+    */
+    /** Render system accepting every call without a GPU.
+    @remarks
+        For dedicated servers and for measuring what the engine costs on the
+        CPU: the frame loop, culling, animation and queries run as usual, but
+        nothing is sent anywhere. Windows are not opened, vertex and index
+        buffers live in system memory so they can still be read, and
+        textures keep their size and format but no pixels.
+    @par
+        The capabilities report no program syntax, so techniques made of
+        programs are unsupported and materials fall back to their fixed
+        function techniques, if any. Occlusion queries report everything as
+        visible.
+    */
+    class _OgreNullExport NullRenderSystem : public RenderSystem
+    {
+    public:
+        NullRenderSystem();
+        ~NullRenderSystem();
+
+        const String& getName(void) const;
+        ConfigOptionMap& getConfigOptions(void) { return mOptions; }
+        void setConfigOption(const String& name, const String& value);
+        String validateConfigOptions(void);
+
+        RenderWindow* _initialise(bool autoCreateWindow, const String& windowTitle = "OGRE Render Window");
+        RenderSystemCapabilities* createRenderSystemCapabilities() const;
+        void reinitialise(void);
+        void shutdown(void);
+
+        RenderWindow* _createRenderWindow(const String& name, unsigned int width, unsigned int height,
+            bool fullScreen, const NameValuePairList* miscParams = 0);
+        MultiRenderTarget* createMultiRenderTarget(const String& name);
+        DepthBuffer* _createDepthBufferFor(RenderTarget* renderTarget);
+        HardwareOcclusionQuery* createHardwareOcclusionQuery(void);
+
+        void _setPointSpritesEnabled(bool enabled) {}
+        void _setPointParameters(Real size, bool attenuationEnabled,
+            Real constant, Real linear, Real quadratic, Real minSize, Real maxSize) {}
+        void _setTexture(size_t unit, bool enabled, const TexturePtr& texPtr) {}
+        void _setTextureCoordSet(size_t unit, size_t index) {}
+        void _setTextureUnitFiltering(size_t unit, FilterType ftype, FilterOptions filter) {}
+        void _setTextureUnitCompareEnabled(size_t unit, bool compare) {}
+        void _setTextureUnitCompareFunction(size_t unit, CompareFunction function) {}
+        void _setTextureLayerAnisotropy(size_t unit, unsigned int maxAnisotropy) {}
+        void _setTextureAddressingMode(size_t unit, const TextureUnitState::UVWAddressingMode& uvw) {}
+        void _setTextureBorderColour(size_t unit, const ColourValue& colour) {}
+        void _setTextureMipmapBias(size_t unit, float bias) {}
+        void _setSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor,
+            SceneBlendOperation op = SBO_ADD) {}
+        void _setSeparateSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor,
+            SceneBlendFactor sourceFactorAlpha, SceneBlendFactor destFactorAlpha,
+            SceneBlendOperation op = SBO_ADD, SceneBlendOperation alphaOp = SBO_ADD) {}
+        void _setAlphaRejectSettings(CompareFunction func, unsigned char value, bool alphaToCoverage) {}
+
+        void _beginFrame(void) {}
+        void _endFrame(void) {}
+        void _setViewport(Viewport* vp);
+        void _setRenderTarget(RenderTarget* target);
+        void _setCullingMode(CullingMode mode) { mCullingMode = mode; }
+        void _setDepthBufferParams(bool depthTest = true, bool depthWrite = true,
+            CompareFunction depthFunction = CMPF_LESS_EQUAL) {}
+        void _setDepthBufferCheckEnabled(bool enabled = true) {}
+        void _setDepthBufferWriteEnabled(bool enabled = true) {}
+        void _setDepthBufferFunction(CompareFunction func = CMPF_LESS_EQUAL) {}
+        void _setColourBufferWriteEnabled(bool red, bool green, bool blue, bool alpha) {}
+        void _setDepthBias(float constantBias, float slopeScaleBias = 0.0f) {}
+        void _setPolygonMode(PolygonMode level) {}
+        void setStencilCheckEnabled(bool enabled) {}
+        void setStencilBufferParams(CompareFunction func = CMPF_ALWAYS_PASS,
+            uint32 refValue = 0, uint32 compareMask = 0xFFFFFFFF, uint32 writeMask = 0xFFFFFFFF,
+            StencilOperation stencilFailOp = SOP_KEEP, StencilOperation depthFailOp = SOP_KEEP,
+            StencilOperation passOp = SOP_KEEP, bool twoSidedOperation = false,
+            bool readBackAsTexture = false) {}
+        void setScissorTest(bool enabled, size_t left = 0, size_t top = 0,
+            size_t right = 800, size_t bottom = 600) {}
+        void clearFrameBuffer(unsigned int buffers, const ColourValue& colour = ColourValue::Black,
+            Real depth = 1.0f, unsigned short stencil = 0) {}
+        void _dispatchCompute(const Vector3& workgroupDim) {}
+
+        void bindGpuProgramParameters(GpuProgramType gptype,
+            GpuProgramParametersSharedPtr params, uint16 variabilityMask) {}
+        void bindGpuProgramPassIterationParameters(GpuProgramType gptype) {}
+
+        VertexElementType getColourVertexElementType(void) const { return VET_COLOUR_ABGR; }
+        void _convertProjectionMatrix(const Matrix4& matrix, Matrix4& dest, bool forGpuProgram = false)
+        {
+            dest = matrix;
+        }
+        void _makeProjectionMatrix(const Radian& fovy, Real aspect, Real nearPlane, Real farPlane,
+            Matrix4& dest, bool forGpuProgram = false);
+        void _makeProjectionMatrix(Real left, Real right, Real bottom, Real top,
+            Real nearPlane, Real farPlane, Matrix4& dest, bool forGpuProgram = false);
+        void _makeOrthoMatrix(const Radian& fovy, Real aspect, Real nearPlane, Real farPlane,
+            Matrix4& dest, bool forGpuProgram = false);
+        void _applyObliqueDepthProjection(Matrix4& matrix, const Plane& plane, bool forGpuProgram);
+
+        Real getHorizontalTexelOffset(void) { return 0; }
+        Real getVerticalTexelOffset(void) { return 0; }
+        Real getMinimumDepthInputValue(void) { return -1; }
+        Real getMaximumDepthInputValue(void) { return 1; }
+
+        void preExtraThreadsStarted() {}
+        void postExtraThreadsStarted() {}
+        void registerThread() {}
+        void unregisterThread() {}
+        unsigned int getDisplayMonitorCount() const { return 1; }
+        void beginProfileEvent(const String& eventName) {}
+        void endProfileEvent(void) {}
+        void markProfileEvent(const String& event) {}
+        bool hasAnisotropicMipMapFilter() const { return false; }
+
+    protected:
+        ConfigOptionMap mOptions;
+        DefaultHardwareBufferManager* mHardwareBufferManager;
+        NullGpuProgramManager* mGpuProgramManager;
+        bool mInitialised;
+
+        void setClipPlanesImpl(const PlaneList& clipPlanes) {}
+        void initialiseFromRenderSystemCapabilities(RenderSystemCapabilities* caps, RenderTarget* primary);
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -0,0 +1,127 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullHardwarePixelBuffer.h"
+#include "OgreNullRenderTexture.h"
+#include "OgreRenderSystem.h"
+#include "OgreRoot.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    NullHardwarePixelBuffer::NullHardwarePixelBuffer(const String& baseName, uint32 width,
+        uint32 height, uint32 depth, PixelFormat format, HardwareBuffer::Usage usage)
+        : HardwarePixelBuffer(width, height, depth, format, usage, false, false)
+        , mScratch(0)
+    {
+        mRowPitch = mWidth;
+        mSlicePitch = mHeight * mWidth;
+        mSizeInBytes = PixelUtil::getMemorySize(mWidth, mHeight, mDepth, mFormat);
+
+        if (mUsage & TU_RENDERTARGET)
+        {
+            mSliceTRT.reserve(mDepth);
+            for (uint32 zoffset = 0; zoffset < mDepth; ++zoffset)
+            {
+                String name = "rtt/" + StringConverter::toString((size_t)this) + "/" + baseName;
+                RenderTexture* trt = OGRE_NEW NullRenderTexture(name, this, zoffset);
+                mSliceTRT.push_back(trt);
+                Root::getSingleton().getRenderSystem()->attachRenderTarget(*trt);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    NullHardwarePixelBuffer::~NullHardwarePixelBuffer()
+    {
+        // Delete the render targets the user did not delete already
+        for (SliceTRT::const_iterator it = mSliceTRT.begin(); it != mSliceTRT.end(); ++it)
+        {
+            if (*it)
+                Root::getSingleton().getRenderSystem()->destroyRenderTarget((*it)->getName());
+        }
+        OGRE_FREE(mScratch, MEMCATEGORY_RENDERSYS);
+    }
+    //-----------------------------------------------------------------------
+    PixelBox NullHardwarePixelBuffer::lockImpl(const Box& lockBox, LockOptions options)
+    {
+        PixelBox box(lockBox.getWidth(), lockBox.getHeight(), lockBox.getDepth(), mFormat);
+        mScratch = OGRE_ALLOC_T(uchar, box.getConsecutiveSize(), MEMCATEGORY_RENDERSYS);
+        if (options != HBL_DISCARD && options != HBL_WRITE_ONLY)
+            memset(mScratch, 0, box.getConsecutiveSize());
+        box.data = mScratch;
+        return box;
+    }
+    //-----------------------------------------------------------------------
+    void NullHardwarePixelBuffer::unlockImpl(void)
+    {
+        OGRE_FREE(mScratch, MEMCATEGORY_RENDERSYS);
+        mScratch = 0;
+    }
+    //-----------------------------------------------------------------------
+    void NullHardwarePixelBuffer::blitFromMemory(const PixelBox& src, const Box& dstBox)
+    {
+        // nothing is stored
+    }
+    //-----------------------------------------------------------------------
+    void NullHardwarePixelBuffer::blitToMemory(const Box& srcBox, const PixelBox& dst)
+    {
+        clearPixels(dst);
+    }
+    //-----------------------------------------------------------------------
+    void NullHardwarePixelBuffer::clearPixels(const PixelBox& dst)
+    {
+        if (dst.isConsecutive() || PixelUtil::isCompressed(dst.format))
+        {
+            memset(dst.getTopLeftFrontPixelPtr(), 0, dst.getConsecutiveSize());
+            return;
+        }
+
+        size_t pixelSize = PixelUtil::getNumElemBytes(dst.format);
+        uchar* slice = static_cast<uchar*>(dst.getTopLeftFrontPixelPtr());
+        for (uint32 z = 0; z < dst.getDepth(); ++z)
+        {
+            uchar* row = slice;
+            for (uint32 y = 0; y < dst.getHeight(); ++y)
+            {
+                memset(row, 0, dst.getWidth() * pixelSize);
+                row += dst.rowPitch * pixelSize;
+            }
+            slice += dst.slicePitch * pixelSize;
+        }
+    }
+    //-----------------------------------------------------------------------
+    RenderTexture* NullHardwarePixelBuffer::getRenderTarget(size_t zoffset)
+    {
+        assert(mUsage & TU_RENDERTARGET);
+        assert(zoffset < mDepth);
+        return mSliceTRT[zoffset];
+    }
+    //-----------------------------------------------------------------------
+    void NullHardwarePixelBuffer::_clearSliceRTT(size_t zoffset)
+    {
+        mSliceTRT[zoffset] = 0;
+    }
+}
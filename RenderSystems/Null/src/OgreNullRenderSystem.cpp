@@ -0,0 +1,367 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullRenderSystem.h"
+#include "OgreNullGpuProgramManager.h"
+#include "OgreNullHardwareOcclusionQuery.h"
+#include "OgreNullRenderTexture.h"
+#include "OgreNullRenderWindow.h"
+#include "OgreNullTextureManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreDepthBuffer.h"
+#include "OgreFrustum.h"
+#include "OgreLogManager.h"
+#include "OgreViewport.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    NullRenderSystem::NullRenderSystem()
+        : mHardwareBufferManager(0), mGpuProgramManager(0), mInitialised(false)
+    {
+        ConfigOption optFullScreen;
+        optFullScreen.name = "Full Screen";
+        optFullScreen.possibleValues.push_back("No");
+        optFullScreen.possibleValues.push_back("Yes");
+        optFullScreen.currentValue = "No";
+        optFullScreen.immutable = false;
+        mOptions[optFullScreen.name] = optFullScreen;
+
+        ConfigOption optVideoMode;
+        optVideoMode.name = "Video Mode";
+        optVideoMode.possibleValues.push_back("640 x 480");
+        optVideoMode.possibleValues.push_back("800 x 600");
+        optVideoMode.possibleValues.push_back("1024 x 768");
+        optVideoMode.possibleValues.push_back("1280 x 720");
+        optVideoMode.possibleValues.push_back("1920 x 1080");
+        optVideoMode.currentValue = "800 x 600";
+        optVideoMode.immutable = false;
+        mOptions[optVideoMode.name] = optVideoMode;
+    }
+    //-----------------------------------------------------------------------
+    NullRenderSystem::~NullRenderSystem()
+    {
+        shutdown();
+    }
+    //-----------------------------------------------------------------------
+    const String& NullRenderSystem::getName(void) const
+    {
+        static String strName("Null Rendering Subsystem");
+        return strName;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::setConfigOption(const String& name, const String& value)
+    {
+        ConfigOptionMap::iterator it = mOptions.find(name);
+
+        if (it == mOptions.end())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Option named '" + name + "' does not exist.",
+                "NullRenderSystem::setConfigOption");
+        }
+
+        it->second.currentValue = value;
+    }
+    //-----------------------------------------------------------------------
+    String NullRenderSystem::validateConfigOptions(void)
+    {
+        return BLANKSTRING;
+    }
+    //-----------------------------------------------------------------------
+    RenderWindow* NullRenderSystem::_initialise(bool autoCreateWindow, const String& windowTitle)
+    {
+        mHardwareBufferManager = OGRE_NEW DefaultHardwareBufferManager();
+        mGpuProgramManager = OGRE_NEW NullGpuProgramManager();
+        mTextureManager = OGRE_NEW NullTextureManager();
+
+        RenderWindow* autoWindow = 0;
+
+        if (autoCreateWindow)
+        {
+            StringVector tokens = StringUtil::split(mOptions["Video Mode"].currentValue, " x");
+            unsigned int width = tokens.size() > 0 ? StringConverter::parseUnsignedInt(tokens[0], 800) : 800;
+            unsigned int height = tokens.size() > 1 ? StringConverter::parseUnsignedInt(tokens[1], 600) : 600;
+            bool fullScreen = mOptions["Full Screen"].currentValue == "Yes";
+
+            autoWindow = _createRenderWindow(windowTitle, width, height, fullScreen);
+        }
+
+        RenderSystem::_initialise(autoCreateWindow, windowTitle);
+
+        return autoWindow;
+    }
+    //-----------------------------------------------------------------------
+    RenderSystemCapabilities* NullRenderSystem::createRenderSystemCapabilities() const
+    {
+        RenderSystemCapabilities* rsc = OGRE_NEW RenderSystemCapabilities();
+
+        rsc->setRenderSystemName(getName());
+        rsc->setDriverVersion(mDriverVersion);
+        rsc->setVendor(GPU_UNKNOWN);
+        rsc->setDeviceName("Null");
+
+        rsc->setCapability(RSC_AUTOMIPMAP);
+        rsc->setCapability(RSC_CUBEMAPPING);
+        rsc->setCapability(RSC_HWSTENCIL);
+        rsc->setCapability(RSC_VBO);
+        rsc->setCapability(RSC_32BIT_INDEX);
+        rsc->setCapability(RSC_HWOCCLUSION);
+        rsc->setCapability(RSC_INFINITE_FAR_PLANE);
+        rsc->setCapability(RSC_HWRENDER_TO_TEXTURE);
+        rsc->setCapability(RSC_TEXTURE_FLOAT);
+        rsc->setCapability(RSC_NON_POWER_OF_2_TEXTURES);
+        rsc->setCapability(RSC_TEXTURE_3D);
+        rsc->setCapability(RSC_TEXTURE_COMPRESSION);
+        rsc->setCapability(RSC_FIXED_FUNCTION);
+        rsc->setCapability(RSC_MRT_DIFFERENT_BIT_DEPTHS);
+
+        rsc->setNumTextureUnits(16);
+        rsc->setNumMultiRenderTargets(8);
+        rsc->setStencilBufferBitDepth(8);
+        rsc->setMaxPointSize(256);
+
+        // No program syntax is reported, so no program is ever considered
+        // supported and techniques fall back to fixed function
+        return rsc;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::initialiseFromRenderSystemCapabilities(RenderSystemCapabilities* caps, RenderTarget* primary)
+    {
+        if (caps->getRenderSystemName() != getName())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Trying to initialize NullRenderSystem from RenderSystemCapabilities of another render system",
+                "NullRenderSystem::initialiseFromRenderSystemCapabilities");
+        }
+
+        Log* defaultLog = LogManager::getSingleton().getDefaultLog();
+        if (defaultLog)
+        {
+            caps->log(defaultLog);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::reinitialise(void)
+    {
+        shutdown();
+        _initialise(true);
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::shutdown(void)
+    {
+        RenderSystem::shutdown();
+
+        OGRE_DELETE mGpuProgramManager;
+        mGpuProgramManager = 0;
+
+        OGRE_DELETE mHardwareBufferManager;
+        mHardwareBufferManager = 0;
+
+        OGRE_DELETE mTextureManager;
+        mTextureManager = 0;
+
+        mInitialised = false;
+    }
+    //-----------------------------------------------------------------------
+    RenderWindow* NullRenderSystem::_createRenderWindow(const String& name, unsigned int width,
+        unsigned int height, bool fullScreen, const NameValuePairList* miscParams)
+    {
+        if (mRenderTargets.find(name) != mRenderTargets.end())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Window with name '" + name + "' already exists",
+                "NullRenderSystem::_createRenderWindow");
+        }
+
+        NullRenderWindow* win = OGRE_NEW NullRenderWindow(!mInitialised);
+        win->create(name, width, height, fullScreen, miscParams);
+        attachRenderTarget(*win);
+
+        if (!mInitialised)
+        {
+            mRealCapabilities = createRenderSystemCapabilities();
+
+            // Use real capabilities if custom capabilities are not available
+            if (!mUseCustomCapabilities)
+                mCurrentCapabilities = mRealCapabilities;
+
+            fireEvent("RenderSystemCapabilitiesCreated");
+
+            initialiseFromRenderSystemCapabilities(mCurrentCapabilities, win);
+            mInitialised = true;
+        }
+
+        return win;
+    }
+    //-----------------------------------------------------------------------
+    MultiRenderTarget* NullRenderSystem::createMultiRenderTarget(const String& name)
+    {
+        MultiRenderTarget* retval = OGRE_NEW NullMultiRenderTarget(name);
+        attachRenderTarget(*retval);
+        return retval;
+    }
+    //-----------------------------------------------------------------------
+    DepthBuffer* NullRenderSystem::_createDepthBufferFor(RenderTarget* renderTarget)
+    {
+        return OGRE_NEW DepthBuffer(DepthBuffer::POOL_DEFAULT, 24, renderTarget->getWidth(),
+            renderTarget->getHeight(), renderTarget->getFSAA(), renderTarget->getFSAAHint(), false);
+    }
+    //-----------------------------------------------------------------------
+    HardwareOcclusionQuery* NullRenderSystem::createHardwareOcclusionQuery(void)
+    {
+        NullHardwareOcclusionQuery* ret = OGRE_NEW NullHardwareOcclusionQuery();
+        mHwOcclusionQueries.push_back(ret);
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setViewport(Viewport* vp)
+    {
+        if (!vp)
+        {
+            mActiveViewport = 0;
+            _setRenderTarget(0);
+        }
+        else if (vp != mActiveViewport || vp->_isUpdated())
+        {
+            mActiveViewport = vp;
+            _setRenderTarget(vp->getTarget());
+            vp->_clearUpdatedFlag();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setRenderTarget(RenderTarget* target)
+    {
+        mActiveRenderTarget = target;
+
+        // Keep depth buffers attached, as code may query them
+        if (target && target->getDepthBufferPool() != DepthBuffer::POOL_NO_DEPTH &&
+            !target->getDepthBuffer())
+        {
+            setDepthBufferFor(target);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_makeProjectionMatrix(const Radian& fovy, Real aspect,
+        Real nearPlane, Real farPlane, Matrix4& dest, bool forGpuProgram)
+    {
+        Radian thetaY(fovy / 2.0f);
+        Real tanThetaY = Math::Tan(thetaY);
+
+        // Same as GL, with Z in range [-1,1]
+        Real w = (1.0f / tanThetaY) / aspect;
+        Real h = 1.0f / tanThetaY;
+        Real q, qn;
+        if (farPlane == 0)
+        {
+            // Infinite far plane
+            q = Frustum::INFINITE_FAR_PLANE_ADJUST - 1;
+            qn = nearPlane * (Frustum::INFINITE_FAR_PLANE_ADJUST - 2);
+        }
+        else
+        {
+            q = -(farPlane + nearPlane) / (farPlane - nearPlane);
+            qn = -2 * (farPlane * nearPlane) / (farPlane - nearPlane);
+        }
+
+        dest = Matrix4::ZERO;
+        dest[0][0] = w;
+        dest[1][1] = h;
+        dest[2][2] = q;
+        dest[2][3] = qn;
+        dest[3][2] = -1;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_makeProjectionMatrix(Real left, Real right, Real bottom, Real top,
+        Real nearPlane, Real farPlane, Matrix4& dest, bool forGpuProgram)
+    {
+        Real width = right - left;
+        Real height = top - bottom;
+        Real q, qn;
+        if (farPlane == 0)
+        {
+            // Infinite far plane
+            q = Frustum::INFINITE_FAR_PLANE_ADJUST - 1;
+            qn = nearPlane * (Frustum::INFINITE_FAR_PLANE_ADJUST - 2);
+        }
+        else
+        {
+            q = -(farPlane + nearPlane) / (farPlane - nearPlane);
+            qn = -2 * (farPlane * nearPlane) / (farPlane - nearPlane);
+        }
+
+        dest = Matrix4::ZERO;
+        dest[0][0] = 2 * nearPlane / width;
+        dest[0][2] = (right+left) / width;
+        dest[1][1] = 2 * nearPlane / height;
+        dest[1][2] = (top+bottom) / height;
+        dest[2][2] = q;
+        dest[2][3] = qn;
+        dest[3][2] = -1;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_makeOrthoMatrix(const Radian& fovy, Real aspect,
+        Real nearPlane, Real farPlane, Matrix4& dest, bool forGpuProgram)
+    {
+        Radian thetaY(fovy / 2.0f);
+        Real tanThetaY = Math::Tan(thetaY);
+
+        Real tanThetaX = tanThetaY * aspect;
+        Real half_w = tanThetaX * nearPlane;
+        Real half_h = tanThetaY * nearPlane;
+        Real iw = 1.0f / half_w;
+        Real ih = 1.0f / half_h;
+        Real q = farPlane == 0 ? 0 : 2.0f / (farPlane - nearPlane);
+
+        dest = Matrix4::ZERO;
+        dest[0][0] = iw;
+        dest[1][1] = ih;
+        dest[2][2] = -q;
+        dest[2][3] = -(farPlane + nearPlane) / (farPlane - nearPlane);
+        dest[3][3] = 1;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_applyObliqueDepthProjection(Matrix4& matrix, const Plane& plane,
+        bool forGpuProgram)
+    {
+        // Calculate the clip-space corner point opposite the clipping plane
+        // and transform it into camera space, see GLRenderSystemCommon
+        Vector4 q;
+        q.x = (Math::Sign(plane.normal.x) + matrix[0][2]) / matrix[0][0];
+        q.y = (Math::Sign(plane.normal.y) + matrix[1][2]) / matrix[1][1];
+        q.z = -1.0F;
+        q.w = (1.0F + matrix[2][2]) / matrix[2][3];
+
+        // Calculate the scaled plane vector
+        Vector4 clipPlane4d(plane.normal.x, plane.normal.y, plane.normal.z, plane.d);
+        Vector4 c = clipPlane4d * (2.0F / (clipPlane4d.dotProduct(q)));
+
+        // Replace the third row of the projection matrix
+        matrix[2][0] = c.x;
+        matrix[2][1] = c.y;
+        matrix[2][2] = c.z + 1.0F;
+        matrix[2][3] = c.w;
+    }
+}
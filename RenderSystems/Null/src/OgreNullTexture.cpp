@@ -0,0 +1,109 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullTexture.h"
+#include "OgreNullHardwarePixelBuffer.h"
+#include "OgreMath.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    NullTexture::NullTexture(ResourceManager* creator, const String& name, ResourceHandle handle,
+        const String& group, bool isManual, ManualResourceLoader* loader)
+        : Texture(creator, name, handle, group, isManual, loader)
+    {
+    }
+    //-----------------------------------------------------------------------
+    NullTexture::~NullTexture()
+    {
+        // have to call this here rather than in Resource destructor
+        // since calling virtual methods in base destructors causes crash
+        if (isLoaded())
+        {
+            unload();
+        }
+        else
+        {
+            freeInternalResources();
+        }
+    }
+    //-----------------------------------------------------------------------
+    HardwarePixelBufferSharedPtr NullTexture::getBuffer(size_t face, size_t mipmap)
+    {
+        if (face >= getNumFaces())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Face index out of range",
+                "NullTexture::getBuffer");
+        }
+
+        if (mipmap > mNumMipmaps)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Mipmap index out of range",
+                "NullTexture::getBuffer");
+        }
+
+        return mSurfaceList[face * (mNumMipmaps + 1) + mipmap];
+    }
+    //-----------------------------------------------------------------------
+    void NullTexture::loadImpl(void)
+    {
+        // the image is never needed, so it is not read
+        createInternalResources();
+    }
+    //-----------------------------------------------------------------------
+    void NullTexture::createInternalResourcesImpl(void)
+    {
+        if (mFormat == PF_UNKNOWN)
+            mFormat = PF_A8R8G8B8;
+
+        // as many mipmaps as the size allows
+        uint32 maxMips = static_cast<uint32>(Math::Log2(static_cast<Real>(
+            std::max(mWidth, std::max(mHeight, mDepth)))));
+        mNumMipmaps = std::min(mNumRequestedMipmaps, maxMips);
+
+        for (size_t face = 0; face < getNumFaces(); ++face)
+        {
+            uint32 width = mWidth;
+            uint32 height = mHeight;
+            uint32 depth = mDepth;
+            for (uint32 mip = 0; mip <= mNumMipmaps; ++mip)
+            {
+                mSurfaceList.push_back(HardwarePixelBufferSharedPtr(OGRE_NEW NullHardwarePixelBuffer(
+                    mName, width, height, depth, mFormat, static_cast<HardwareBuffer::Usage>(mUsage))));
+
+                width = std::max<uint32>(1, width / 2);
+                height = std::max<uint32>(1, height / 2);
+                if (mTextureType != TEX_TYPE_2D_ARRAY)
+                    depth = std::max<uint32>(1, depth / 2);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NullTexture::freeInternalResourcesImpl(void)
+    {
+        mSurfaceList.clear();
+    }
+}
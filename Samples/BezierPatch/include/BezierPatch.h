@@ -20,7 +20,17 @@ public:
 
     void checkBoxToggled(CheckBox* box)
     {
+        if (box->getName() == "Hardware")
+        {
+            // switch between the patch tessellated on the CPU and the one tessellated on the GPU
+            mPatchEntity->setVisible(!box->isChecked());
+            mTessEntity->setVisible(box->isChecked());
+            return;
+        }
+
         mPatchPass->setPolygonMode(box->isChecked() ? PM_WIREFRAME : PM_SOLID);
+        if (mTessPass)
+            mTessPass->setPolygonMode(mPatchPass->getPolygonMode());
 
 #ifdef INCLUDE_RTSHADER_SYSTEM
         Material* mat = mPatchPass->getParent()->getParent();
@@ -84,12 +94,28 @@ protected:
         mPatch->setSubdivision(0);   // start at 0 detail
 
         // create a patch entity from the mesh, give it a material, and attach it to the origin
-        Entity* ent = mSceneMgr->createEntity("Patch", "patch");
-        ent->setMaterialName("Examples/BumpyMetal");
-        mSceneMgr->getRootSceneNode()->attachObject(ent);
+        mPatchEntity = mSceneMgr->createEntity("Patch", "patch");
+        mPatchEntity->setMaterialName("Examples/BumpyMetal");
+        mSceneMgr->getRootSceneNode()->attachObject(mPatchEntity);
 
         // save the main pass of the material so we can toggle wireframe on it
-        mPatchPass = ent->getSubEntity(0)->getMaterial()->getTechnique(0)->getPass(0);
+        mPatchPass = mPatchEntity->getSubEntity(0)->getMaterial()->getTechnique(0)->getPass(0);
+
+        // with tessellation programs, the same patch can be subdivided on the GPU by distance
+        mTessPass = 0;
+        const RenderSystemCapabilities* caps = Root::getSingleton().getRenderSystem()->getCapabilities();
+        if (caps->hasCapability(RSC_TESSELLATION_HULL_PROGRAM) && caps->hasCapability(RSC_TESSELLATION_DOMAIN_PROGRAM))
+        {
+            mTessPatch = MeshManager::getSingleton().createBezierPatch("patchTess",
+                ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, (float*)verts, mDecl, 3, 3, 5, 5, PatchSurface::VS_BOTH,
+                HardwareBuffer::HBU_STATIC_WRITE_ONLY, HardwareBuffer::HBU_STATIC_WRITE_ONLY, false, false, true);
+
+            mTessEntity = mSceneMgr->createEntity("PatchTess", "patchTess");
+            mTessEntity->setMaterialName("Examples/BezierPatchTessellation");
+            mTessEntity->setVisible(false);
+            mSceneMgr->getRootSceneNode()->attachObject(mTessEntity);
+            mTessPass = mTessEntity->getSubEntity(0)->getMaterial()->getTechnique(0)->getPass(0);
+        }
 
         // use an orbit style camera
         mCameraMan->setStyle(CS_ORBIT);
@@ -100,6 +126,8 @@ protected:
         // create slider to adjust detail and checkbox to toggle wireframe
         mTrayMgr->createThickSlider(TL_TOPLEFT, "Detail", "Detail", 120, 44, 0, 1, 6);
         mTrayMgr->createCheckBox(TL_TOPLEFT, "Wireframe", "Wireframe", 120);
+        if (mTessPass)
+            mTrayMgr->createCheckBox(TL_TOPLEFT, "Hardware", "GPU Tessellation", 120);
     }
 
     void cleanupContent()
@@ -107,11 +135,20 @@ protected:
         HardwareBufferManager::getSingleton().destroyVertexDeclaration(mDecl);
         mPatchPass->setPolygonMode(PM_SOLID);
         MeshManager::getSingleton().remove(mPatch->getHandle());
+        if (mTessPass)
+        {
+            mTessPass->setPolygonMode(PM_SOLID);
+            MeshManager::getSingleton().remove(mTessPatch->getHandle());
+        }
     }
 
     VertexDeclaration* mDecl;
     PatchMeshPtr mPatch;
+    PatchMeshPtr mTessPatch;
+    Entity* mPatchEntity;
+    Entity* mTessEntity;
     Pass* mPatchPass;
+    Pass* mTessPass;
 };
 
 #endif
@@ -40,6 +40,10 @@ public:
     */
     virtual bool getCastChadows() const;
 
+    /** Radius of the volume lit by a light, based on its attenuation
+     */
+    static float getLightRadius(const Ogre::Light* light);
+
     /** @copydoc MovableObject::getBoundingRadius */
     virtual Ogre::Real getBoundingRadius(void) const;
     /** @copydoc Renderable::getSquaredViewDepth */
@@ -21,6 +21,7 @@ same license as the rest of the engine.
 #include "DLight.h"
 #include "MaterialGenerator.h"
 #include "AmbientLight.h"
+#include "InstancedLights.h"
 
 //The render operation that will be called each frame in the custom composition pass
 //This is the class that will send the actual render calls of the spheres (point lights),
@@ -54,6 +55,9 @@ private:
     //The ambient light used to render the scene
     AmbientLight* mAmbientLight;
 
+    //The point lights rendered in one instanced draw, 0 if not supported
+    InstancedLights* mInstancedLights;
+
     //The viewport that we are rendering to
     Ogre::Viewport* mViewport;
 };
@@ -0,0 +1,74 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Also see acknowledgements in Readme.html
+
+You may use this sample code for anything you like, it is not covered by the
+same license as the rest of the engine.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _INSTANCEDLIGHTS_H
+#define _INSTANCEDLIGHTS_H
+
+#include "OgreSimpleRenderable.h"
+
+/** Renders many point lights with a single instanced draw.
+    A unit sphere is scaled to the radius of each light and the light's
+    colours and attenuation are passed as per instance vertex data, so the
+    cost doesn't grow with the number of materials or render calls.
+    Requires GLSL 1.50 and instanced vertex buffers, lights casting shadows
+    still go through DLight.
+ */
+class InstancedLights : public Ogre::SimpleRenderable
+{
+public:
+    InstancedLights();
+    ~InstancedLights();
+
+    /** Whether the render system can render the batched lights
+     */
+    bool isSupported() const;
+
+    /** Whether a light can be rendered by the batch
+     */
+    static bool canBatch(const Ogre::Light* light);
+
+    /** Remove the lights added for the previous frame
+     */
+    void clear() { mData.clear(); mRenderOp.numberOfInstances = 0; }
+
+    /** Add a light to render in this frame
+     */
+    void addLight(const Ogre::Light* light);
+
+    /** Upload the lights added since clear and update the camera parameters
+        @return false if there is nothing to render
+     */
+    bool update(Ogre::Camera* camera);
+
+    /** @copydoc MovableObject::getBoundingRadius */
+    virtual Ogre::Real getBoundingRadius(void) const { return 0; }
+    /** @copydoc Renderable::getSquaredViewDepth */
+    virtual Ogre::Real getSquaredViewDepth(const Ogre::Camera*) const { return 0; }
+    /** @copydoc Renderable::getMaterial */
+    virtual const Ogre::MaterialPtr& getMaterial(void) const { return mMatPtr; }
+    /** @copydoc Renderable::getWorldTransforms */
+    virtual void getWorldTransforms(Ogre::Matrix4* xform) const { *xform = Ogre::Matrix4::IDENTITY; }
+
+protected:
+    /// Floats of instance data per light
+    static const size_t FLOATS_PER_LIGHT = 16;
+
+    Ogre::MaterialPtr mMatPtr;
+    /// Instance data of the lights added since clear
+    std::vector<float> mData;
+    /// Number of lights the instance buffer holds
+    size_t mCapacity;
+};
+
+#endif
@@ -53,30 +53,38 @@ void DLight::setAttenuation(float c, float b, float a)
 {
     // Set Attenuation parameter to shader
     //setCustomParameter(3, Vector4(c, b, a, 0));
-    float outerRadius = mParentLight->getAttenuationRange();
     /// There is attenuation? Set material accordingly
     if(c != 1.0f || b != 0.0f || a != 0.0f)
     {
         ENABLE_BIT(mPermutation, LightMaterialGenerator::MI_ATTENUATED);
-        if (mParentLight->getType() == Light::LT_POINT)
-        {
-            //// Calculate radius from Attenuation
-            int threshold_level = 10;// difference of 10-15 levels deemed unnoticeable
-            float threshold = 1.0f/((float)threshold_level/256.0f); 
-
-            //// Use quadratic formula to determine outer radius
-            c = c-threshold;
-            float d=sqrt(b*b-4*a*c);
-            outerRadius = (-2*c)/(b+d);
-            outerRadius *= 1.2;
-        }
     }
     else
     {
         DISABLE_BIT(mPermutation,LightMaterialGenerator::MI_ATTENUATED);
     }
     
-    rebuildGeometry(outerRadius);
+    rebuildGeometry(getLightRadius(mParentLight));
+}
+//-----------------------------------------------------------------------
+float DLight::getLightRadius(const Light* light)
+{
+    float outerRadius = light->getAttenuationRange();
+    float c = light->getAttenuationConstant();
+    float b = light->getAttenuationLinear();
+    float a = light->getAttenuationQuadric();
+    if((c != 1.0f || b != 0.0f || a != 0.0f) && light->getType() == Light::LT_POINT)
+    {
+        //// Calculate radius from Attenuation
+        int threshold_level = 10;// difference of 10-15 levels deemed unnoticeable
+        float threshold = 1.0f/((float)threshold_level/256.0f); 
+
+        //// Use quadratic formula to determine outer radius
+        c = c-threshold;
+        float d=sqrt(b*b-4*a*c);
+        outerRadius = (-2*c)/(b+d);
+        outerRadius *= 1.2;
+    }
+    return outerRadius;
 }
 //-----------------------------------------------------------------------
 void DLight::setSpecularColour(const ColourValue &col)
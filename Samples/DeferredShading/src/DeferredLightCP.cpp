@@ -38,6 +38,14 @@ DeferredLightRenderOperation::DeferredLightRenderOperation(
     mAmbientLight = new AmbientLight();
     const MaterialPtr& mat = mAmbientLight->getMaterial();
     mat->load();
+
+    // Batch the point lights if the render system can draw instances
+    mInstancedLights = new InstancedLights();
+    if (!mInstancedLights->isSupported())
+    {
+        delete mInstancedLights;
+        mInstancedLights = 0;
+    }
 }
 //-----------------------------------------------------------------------
 DLight* DeferredLightRenderOperation::createDLight(Ogre::Light* light)
@@ -72,10 +80,21 @@ void DeferredLightRenderOperation::execute(SceneManager *sm, RenderSystem *rs)
     Technique* tech = mAmbientLight->getMaterial()->getBestTechnique();
     injectTechnique(sm, tech, mAmbientLight, 0);
 
+    if (mInstancedLights)
+        mInstancedLights->clear();
+
     const LightList& lightList = sm->_getLightsAffectingFrustum();
     for (LightList::const_iterator it = lightList.begin(); it != lightList.end(); it++) 
     {
         Light* light = *it;
+
+        // Lights without shadows are rendered together after the loop
+        if (mInstancedLights && InstancedLights::canBatch(light))
+        {
+            mInstancedLights->addLight(light);
+            continue;
+        }
+
         Ogre::LightList ll;
         ll.push_back(light);
 
@@ -118,6 +137,12 @@ void DeferredLightRenderOperation::execute(SceneManager *sm, RenderSystem *rs)
         
         injectTechnique(sm, tech, dLight, &ll);
     }
+
+    if (mInstancedLights && mInstancedLights->update(cam))
+    {
+        tech = mInstancedLights->getMaterial()->getBestTechnique();
+        injectTechnique(sm, tech, mInstancedLights, 0);
+    }
 }
 //! [execute]
 //-----------------------------------------------------------------------
@@ -130,6 +155,7 @@ DeferredLightRenderOperation::~DeferredLightRenderOperation()
     mLights.clear();
     
     delete mAmbientLight;
+    delete mInstancedLights;
     delete mLightMaterialGenerator;
 }
 //-----------------------------------------------------------------------
@@ -0,0 +1,121 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Also see acknowledgements in Readme.html
+
+You may use this sample code for anything you like, it is not covered by the
+same license as the rest of the engine.
+-----------------------------------------------------------------------------
+*/
+
+#include "InstancedLights.h"
+
+#include "OgreHardwareBufferManager.h"
+#include "OgreCamera.h"
+#include "OgreLight.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+#include "DLight.h"
+#include "GeomUtils.h"
+
+using namespace Ogre;
+
+//-----------------------------------------------------------------------
+InstancedLights::InstancedLights() : mCapacity(0)
+{
+    mRenderOp.operationType = RenderOperation::OT_TRIANGLE_LIST;
+    mRenderOp.indexData = 0;
+    mRenderOp.vertexData = 0;
+    mRenderOp.useIndexes = true;
+    mRenderOp.numberOfInstances = 0;
+
+    // The lights are scaled in the vertex shader, so one unit sphere serves all
+    GeomUtils::createSphere(mRenderOp.vertexData, mRenderOp.indexData, 1, 10, 10, false, false);
+
+    // Position and radius, diffuse, specular and attenuation of each light
+    VertexDeclaration* decl = mRenderOp.vertexData->vertexDeclaration;
+    for (unsigned short i = 0; i < 4; ++i)
+        decl->addElement(1, i * VertexElement::getTypeSize(VET_FLOAT4), VET_FLOAT4, VES_TEXTURE_COORDINATES, i + 1);
+
+    setBoundingBox(AxisAlignedBox::BOX_INFINITE);
+
+    mMatPtr = MaterialManager::getSingleton().getByName("DeferredShading/LightMaterial/InstancedGeometry");
+    assert(mMatPtr);
+    mMatPtr->load();
+}
+//-----------------------------------------------------------------------
+InstancedLights::~InstancedLights()
+{
+    // need to release IndexData and vertexData created for renderable
+    delete mRenderOp.indexData;
+    delete mRenderOp.vertexData;
+}
+//-----------------------------------------------------------------------
+bool InstancedLights::isSupported() const
+{
+    return Root::getSingleton().getRenderSystem()->getCapabilities()->hasCapability(RSC_VERTEX_BUFFER_INSTANCE_DATA) &&
+        mMatPtr->getBestTechnique() != 0;
+}
+//-----------------------------------------------------------------------
+bool InstancedLights::canBatch(const Light* light)
+{
+    // Point lights never cast shadows here, see DLight::getCastChadows
+    return light->getType() == Light::LT_POINT;
+}
+//-----------------------------------------------------------------------
+void InstancedLights::addLight(const Light* light)
+{
+    const Vector3& pos = light->getDerivedPosition();
+    const ColourValue& diffuse = light->getDiffuseColour();
+    const ColourValue& specular = light->getSpecularColour();
+    const float c = light->getAttenuationConstant();
+    const float b = light->getAttenuationLinear();
+    const float a = light->getAttenuationQuadric();
+    const float range = light->getAttenuationRange();
+    const float radius = DLight::getLightRadius(light);
+
+    const float data[FLOATS_PER_LIGHT] = {
+        float(pos.x), float(pos.y), float(pos.z), radius,
+        diffuse.r, diffuse.g, diffuse.b, 0,
+        specular.r, specular.g, specular.b, 0,
+        range, c, b, a
+    };
+    mData.insert(mData.end(), data, data + FLOATS_PER_LIGHT);
+}
+//-----------------------------------------------------------------------
+bool InstancedLights::update(Camera* camera)
+{
+    const size_t count = mData.size() / FLOATS_PER_LIGHT;
+    mRenderOp.numberOfInstances = count;
+    if (count == 0)
+        return false;
+
+    if (count > mCapacity)
+    {
+        // Grow in steps so a slowly increasing light count doesn't reallocate every frame
+        mCapacity = std::max(count, mCapacity * 2);
+        HardwareVertexBufferSharedPtr buffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+            FLOATS_PER_LIGHT * sizeof(float), mCapacity, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        buffer->setIsInstanceData(true);
+        buffer->setInstanceDataStepRate(1);
+        mRenderOp.vertexData->vertexBufferBinding->setBinding(1, buffer);
+    }
+    mRenderOp.vertexData->vertexBufferBinding->getBuffer(1)->writeData(
+        0, mData.size() * sizeof(float), &mData[0], true);
+
+    Vector3 farCorner = camera->getViewMatrix(true) * camera->getWorldSpaceCorners()[4];
+    Technique* tech = mMatPtr->getBestTechnique();
+    for (unsigned short i = 0; i < tech->getNumPasses(); ++i)
+    {
+        GpuProgramParametersSharedPtr params = tech->getPass(i)->getFragmentProgramParameters();
+        if (params->_findNamedConstantDefinition("farCorner"))
+            params->setNamedConstant("farCorner", farCorner);
+    }
+    return true;
+}
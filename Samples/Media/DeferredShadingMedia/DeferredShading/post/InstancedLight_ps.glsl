@@ -0,0 +1,76 @@
+/******************************************************************************
+Copyright (c) W.J. van der Laan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software  and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to use, 
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so, subject 
+to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies 
+or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,OUT OF OR IN CONNECTION WITH THE 
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+/** Deferred shading framework
+	Post shader: Instanced point light geometry, see LightMaterial_ps
+*/
+#version 150
+
+in vec4 oPos;
+flat in vec3 oLightPos;
+flat in vec3 oLightDiffuse;
+flat in vec3 oLightSpecular;
+flat in vec4 oLightFalloff;
+
+uniform sampler2D Tex0;
+uniform sampler2D Tex1;
+
+uniform vec3 farCorner;
+uniform float flip;
+uniform float farClipDistance;
+
+out vec4 fragColour;
+
+void main()
+{
+    vec4 normProjPos = oPos / oPos.w;
+    // -1 is because generally +Y is down for textures but up for the screen
+    vec2 uv = vec2(normProjPos.x, normProjPos.y * -1 * flip) * 0.5 + 0.5;
+    vec3 ray = vec3(normProjPos.x, normProjPos.y * flip, 1) * farCorner;
+
+    vec4 a0 = texture(Tex0, uv); // Attribute 0: Diffuse color+shininess
+    vec4 a1 = texture(Tex1, uv); // Attribute 1: Normal+depth
+
+    vec3 colour = a0.rgb;
+    float specularity = a0.a;
+    float distance = a1.w;
+    vec3 normal = a1.xyz;
+
+    // Calculate position of texel in view space
+    vec3 viewPos = normalize(ray)*distance*farClipDistance;
+
+    vec3 objToLightVec = oLightPos - viewPos;
+    float len_sq = dot(objToLightVec, objToLightVec);
+    float len = sqrt(len_sq);
+    vec3 objToLightDir = objToLightVec/len;
+
+    if(oLightFalloff.x - len < 0.0)
+        discard;
+
+    vec3 total_light_contrib = max(0.0,dot(objToLightDir, normal)) * oLightDiffuse;
+
+    vec3 viewDir = -normalize(viewPos);
+    vec3 h = normalize(viewDir + objToLightDir);
+    total_light_contrib += specularity * pow(max(dot(normal, h), 0.0), 32.0) * oLightSpecular;
+
+    // Unattenuated lights have a falloff of (range, 1, 0, 0)
+    total_light_contrib /= dot(oLightFalloff.yzw, vec3(1.0, len, len_sq));
+
+    fragColour = vec4(total_light_contrib*colour, 0.0);
+}
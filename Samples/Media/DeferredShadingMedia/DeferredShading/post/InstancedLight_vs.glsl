@@ -0,0 +1,49 @@
+/******************************************************************************
+Copyright (c) W.J. van der Laan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software  and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to use, 
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so, subject 
+to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies 
+or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A 
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,OUT OF OR IN CONNECTION WITH THE 
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+/** Deferred shading framework
+	Post shader: Instanced point light geometry
+*/
+#version 150
+
+in vec4 vertex;
+// Per instance: position and radius, diffuse, specular, falloff
+in vec4 uv1;
+in vec4 uv2;
+in vec4 uv3;
+in vec4 uv4;
+
+out vec4 oPos;
+flat out vec3 oLightPos;
+flat out vec3 oLightDiffuse;
+flat out vec3 oLightSpecular;
+flat out vec4 oLightFalloff;
+
+uniform mat4 viewProj;
+uniform mat4 view;
+
+void main()
+{
+	gl_Position = viewProj * vec4(vertex.xyz * uv1.w + uv1.xyz, 1.0);
+	oPos = gl_Position;
+	oLightPos = (view * vec4(uv1.xyz, 1.0)).xyz;
+	oLightDiffuse = uv2.rgb;
+	oLightSpecular = uv3.rgb;
+	oLightFalloff = uv4;
+}
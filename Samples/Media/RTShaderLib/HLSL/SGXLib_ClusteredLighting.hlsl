@@ -0,0 +1,134 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+//-----------------------------------------------------------------------------
+// Program Name: SGXLib_ClusteredLighting
+// Program Desc: Clustered forward lighting functions.
+// Program Type: Pixel shader
+// Language: HLSL
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+float4 SGX_ClusterTexel(in sampler2D clusterTexture, in float4 vClusterTexel, in float texel)
+{
+	float row = floor(texel * vClusterTexel.y);
+	float column = texel - row * vClusterTexel.x;
+	return tex2D(clusterTexture, float2((column + 0.5) * vClusterTexel.y, (row + 0.5) * vClusterTexel.z));
+}
+
+//-----------------------------------------------------------------------------
+void SGX_ClusterLight(
+				    in sampler2D clusterTexture,
+				    in float4 vClusterTexel,
+				    in float lightTexel,
+				    in float3 vNormalView,
+				    in float3 vViewPos,
+				    in float3 vSurfaceDiffuse,
+				    in float3 vSurfaceSpecular,
+				    in float fSpecularPower,
+				    inout float3 vOutDiffuse,
+				    inout float3 vOutSpecular)
+{
+	float4 vPosType   = SGX_ClusterTexel(clusterTexture, vClusterTexel, lightTexel);
+	float3 vDirection = SGX_ClusterTexel(clusterTexture, vClusterTexel, lightTexel + 1.0).xyz;
+	float3 vLightView = vDirection;
+	float fAtten    = 1.0;
+
+	// point and spot lights
+	if (vPosType.w != 1.0)
+	{
+		float4 vAttParams = SGX_ClusterTexel(clusterTexture, vClusterTexel, lightTexel + 4.0);
+		vLightView      = vPosType.xyz - vViewPos;
+		float fLightD   = length(vLightView);
+		if (fLightD > vAttParams.x)
+			return;
+		vLightView /= fLightD;
+		fAtten = 1.0 / (vAttParams.y + vAttParams.z*fLightD + vAttParams.w*fLightD*fLightD);
+
+		if (vPosType.w == 2.0)
+		{
+			float3 vSpotParams = SGX_ClusterTexel(clusterTexture, vClusterTexel, lightTexel + 5.0).xyz;
+			float rho        = dot(vDirection, vLightView);
+			float fSpotE     = clamp((rho - vSpotParams.y) / (vSpotParams.x - vSpotParams.y), 0.0, 1.0);
+			fAtten          *= pow(fSpotE, vSpotParams.z);
+		}
+	}
+
+	float nDotL = dot(vNormalView, vLightView);
+	if (nDotL > 0.0)
+	{
+		float3 vDiffuseColour  = SGX_ClusterTexel(clusterTexture, vClusterTexel, lightTexel + 2.0).xyz;
+		float3 vSpecularColour = SGX_ClusterTexel(clusterTexture, vClusterTexel, lightTexel + 3.0).xyz;
+		float3 vHalfWay        = normalize(vLightView - normalize(vViewPos));
+		float nDotH          = dot(vNormalView, vHalfWay);
+
+		vOutDiffuse  += vSurfaceDiffuse * vDiffuseColour * nDotL * fAtten;
+		vOutSpecular += vSurfaceSpecular * vSpecularColour * pow(clamp(nDotH, 0.0, 1.0), fSpecularPower) * fAtten;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void SGX_Light_Clustered(
+				    in float3 vNormal,
+				    in float3 vViewPos,
+				    in float4x4 mProj,
+				    in float4 vClusterGrid,
+				    in float4 vClusterLayout,
+				    in float4 vClusterTexel,
+				    in sampler2D clusterTexture,
+				    in float3 vSurfaceDiffuse,
+				    in float3 vSurfaceSpecular,
+				    in float fSpecularPower,
+				    inout float3 vOutDiffuse,
+				    inout float3 vOutSpecular)
+{
+	float3 vNormalView = normalize(vNormal);
+
+	// directional lights are in no cluster
+	for (float i = 0.0; i < vClusterLayout.z; i += 1.0)
+	{
+		SGX_ClusterLight(clusterTexture, vClusterTexel, vClusterLayout.x + i * 6.0, vNormalView, vViewPos,
+			vSurfaceDiffuse, vSurfaceSpecular, fSpecularPower, vOutDiffuse, vOutSpecular);
+	}
+
+	if (vClusterLayout.w == 0.0)
+		return;
+
+	// cluster of the fragment
+	float4 vClip    = mul(mProj, float4(vViewPos, 1.0));
+	float2 vTile    = clamp(floor((vClip.xy / vClip.w * 0.5 + 0.5) * vClusterGrid.xy), float2(0.0, 0.0), vClusterGrid.xy - 1.0);
+	float fSlice  = clamp(floor(log(max(-vViewPos.z, 1e-5)) * vClusterGrid.z + vClusterGrid.w), 0.0, vClusterLayout.w - 1.0);
+	float4 vCluster = SGX_ClusterTexel(clusterTexture, vClusterTexel,
+		vTile.x + (vTile.y + fSlice * vClusterGrid.y) * vClusterGrid.x);
+
+	for (float i = 0.0; i < vCluster.y; i += 1.0)
+	{
+		float lightIndex = SGX_ClusterTexel(clusterTexture, vClusterTexel, vCluster.x + i).x;
+		SGX_ClusterLight(clusterTexture, vClusterTexel, vClusterLayout.x + lightIndex * 6.0, vNormalView, vViewPos,
+			vSurfaceDiffuse, vSurfaceSpecular, fSpecularPower, vOutDiffuse, vOutSpecular);
+	}
+}
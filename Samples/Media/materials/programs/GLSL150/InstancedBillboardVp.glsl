@@ -0,0 +1,50 @@
+#version 150
+
+// Expands the quads of a BillboardSet with instancing enabled,
+// see BillboardSet::setInstancingEnabled for the layout
+
+// Corner of the quad, (0, 0) is left top and (1, 1) right bottom
+in vec2 uv0;
+// Position and rotation, per billboard
+in vec4 vertex;
+in vec4 colour;
+// Width and height
+in vec2 uv1;
+// Texture coordinates, left, top, right and bottom
+in vec4 uv2;
+
+uniform mat4 worldViewProj;
+uniform vec4 axisX;
+uniform vec4 axisY;
+// Parametric left, right, top and bottom offsets of the origin
+uniform vec4 origin;
+// x is 1 when rotating the vertices rather than the texture coordinates
+uniform vec4 rotationType;
+
+out vec2 oUv0;
+out vec4 oColour;
+
+void main()
+{
+    vec2 offset = vec2(mix(origin.x, origin.y, uv0.x) * uv1.x,
+                       mix(origin.z, origin.w, uv0.y) * uv1.y);
+    vec2 side = uv0 * 2.0 - 1.0;
+    vec2 halfSize = (uv2.zw - uv2.xy) * 0.5;
+    vec2 mid = uv2.xy + halfSize;
+    float c = cos(vertex.w);
+    float s = sin(vertex.w);
+    if (rotationType.x > 0.5)
+    {
+        offset = vec2(offset.x * c + offset.y * s, offset.y * c - offset.x * s);
+        oUv0 = mid + side * halfSize;
+    }
+    else
+    {
+        oUv0 = mid + vec2(side.x * c * halfSize.x - side.y * s * halfSize.y,
+                          side.x * s * halfSize.x + side.y * c * halfSize.y);
+    }
+
+    vec3 pos = vertex.xyz + axisX.xyz * offset.x + axisY.xyz * offset.y;
+    gl_Position = worldViewProj * vec4(pos, 1.0);
+    oColour = colour;
+}
@@ -0,0 +1,20 @@
+#version 400 core
+
+uniform sampler2D diffuseMap;
+uniform vec4 lightPosition;
+uniform vec4 lightDiffuse;
+uniform vec4 ambient;
+
+in vec3 oNormal;
+in vec3 oPosition;
+in vec2 oUV;
+
+out vec4 fragColour;
+
+// Diffuse lighting from one light, lit from both sides.
+void main()
+{
+    vec3 lightDir = normalize(lightPosition.xyz - oPosition * lightPosition.w);
+    float diffuse = abs(dot(normalize(oNormal), lightDir));
+    fragColour = texture(diffuseMap, oUV) * (ambient + lightDiffuse * diffuse);
+}
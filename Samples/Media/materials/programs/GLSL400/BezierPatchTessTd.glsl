@@ -0,0 +1,44 @@
+#version 400 core
+
+uniform mat4 worldViewProj;
+
+in vec3 tcNormal[];
+in vec2 tcUV[];
+
+out vec3 oNormal;
+out vec3 oPosition;
+out vec2 oUV;
+
+// Quadratic Bernstein polynomials
+vec3 bernstein(float t)
+{
+    float s = 1.0 - t;
+    return vec3(s * s, 2.0 * s * t, t * t);
+}
+
+// GLSL tessellation evaluation shader (domain shader in HLSL).
+layout(quads, fractional_even_spacing, ccw) in;
+void main()
+{
+    vec3 bu = bernstein(gl_TessCoord.x);
+    vec3 bv = bernstein(gl_TessCoord.y);
+
+    vec4 pos = vec4(0.0);
+    vec3 norm = vec3(0.0);
+    vec2 uv = vec2(0.0);
+    for (int v = 0; v < 3; ++v)
+    {
+        for (int u = 0; u < 3; ++u)
+        {
+            float w = bu[u] * bv[v];
+            pos += w * gl_in[v * 3 + u].gl_Position;
+            norm += w * tcNormal[v * 3 + u];
+            uv += w * tcUV[v * 3 + u];
+        }
+    }
+
+    gl_Position = worldViewProj * pos;
+    oPosition = pos.xyz;
+    oNormal = normalize(norm);
+    oUV = uv;
+}
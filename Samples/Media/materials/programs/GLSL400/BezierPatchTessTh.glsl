@@ -0,0 +1,43 @@
+#version 400 core
+
+uniform vec4 cameraPosition;
+uniform float maxTessellation;
+uniform float detailDistance;
+
+in vec3 vsNormal[];
+in vec2 vsUV[];
+
+out vec3 tcNormal[];
+out vec2 tcUV[];
+
+// Level of an edge, from the distance of its midpoint to the camera (in object space).
+// Patches sharing an edge compute the same level for it, which keeps the surface closed.
+float edgeLevel(vec3 a, vec3 b)
+{
+    float dist = max(distance(cameraPosition.xyz, (a + b) * 0.5), 0.0001);
+    return clamp(maxTessellation * detailDistance / dist, 1.0, maxTessellation);
+}
+
+// GLSL tessellation control shader, one biquadratic patch of 3x3 control points.
+layout (vertices = 9) out;
+void main()
+{
+    gl_out[gl_InvocationID].gl_Position = gl_in[gl_InvocationID].gl_Position;
+    tcNormal[gl_InvocationID] = vsNormal[gl_InvocationID];
+    tcUV[gl_InvocationID] = vsUV[gl_InvocationID];
+
+    if (gl_InvocationID == 0)
+    {
+        vec3 p00 = gl_in[0].gl_Position.xyz;
+        vec3 p10 = gl_in[2].gl_Position.xyz;
+        vec3 p01 = gl_in[6].gl_Position.xyz;
+        vec3 p11 = gl_in[8].gl_Position.xyz;
+
+        gl_TessLevelOuter[0] = edgeLevel(p00, p01);
+        gl_TessLevelOuter[1] = edgeLevel(p00, p10);
+        gl_TessLevelOuter[2] = edgeLevel(p10, p11);
+        gl_TessLevelOuter[3] = edgeLevel(p01, p11);
+        gl_TessLevelInner[0] = max(gl_TessLevelOuter[1], gl_TessLevelOuter[3]);
+        gl_TessLevelInner[1] = max(gl_TessLevelOuter[0], gl_TessLevelOuter[2]);
+    }
+}
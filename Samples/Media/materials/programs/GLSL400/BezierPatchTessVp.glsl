@@ -0,0 +1,16 @@
+#version 400 core
+
+in vec4 vertex;
+in vec3 normal;
+in vec2 uv0;
+
+out vec3 vsNormal;
+out vec2 vsUV;
+
+// Pass-through vertex shader, the control points are evaluated after tessellation.
+void main()
+{
+    gl_Position = vertex;
+    vsNormal = normal;
+    vsUV = uv0;
+}
@@ -0,0 +1,122 @@
+// Biquadratic Bezier patches of 3x3 control points, subdivided by distance to the camera.
+
+float4 cameraPosition;
+float maxTessellation;
+float detailDistance;
+float4x4 worldViewProj;
+float4 lightPosition;
+float4 lightDiffuse;
+float4 ambient;
+
+struct VS_CONTROL_POINT
+{
+    float3 position : POSITION;
+    float3 normal   : NORMAL;
+    float2 uv       : TEXCOORD0;
+};
+
+struct HS_CONSTANT_DATA_OUTPUT
+{
+    float edges[4]  : SV_TessFactor;
+    float inside[2] : SV_InsideTessFactor;
+};
+
+struct DS_OUTPUT
+{
+    float4 position       : SV_POSITION;
+    float3 normal         : TEXCOORD0;
+    float3 objectPosition : TEXCOORD1;
+    float2 uv             : TEXCOORD2;
+};
+
+// Pass-through vertex shader, the control points are evaluated after tessellation.
+VS_CONTROL_POINT VS(VS_CONTROL_POINT input)
+{
+    return input;
+}
+
+// Level of an edge, from the distance of its midpoint to the camera (in object space).
+// Patches sharing an edge compute the same level for it, which keeps the surface closed.
+float edgeLevel(float3 a, float3 b)
+{
+    float dist = max(distance(cameraPosition.xyz, (a + b) * 0.5), 0.0001);
+    return clamp(maxTessellation * detailDistance / dist, 1.0, maxTessellation);
+}
+
+// Executed once per patch
+HS_CONSTANT_DATA_OUTPUT ConstantHS(InputPatch<VS_CONTROL_POINT, 9> ip)
+{
+    HS_CONSTANT_DATA_OUTPUT output;
+
+    output.edges[0] = edgeLevel(ip[0].position, ip[6].position);
+    output.edges[1] = edgeLevel(ip[0].position, ip[2].position);
+    output.edges[2] = edgeLevel(ip[2].position, ip[8].position);
+    output.edges[3] = edgeLevel(ip[6].position, ip[8].position);
+    output.inside[0] = max(output.edges[1], output.edges[3]);
+    output.inside[1] = max(output.edges[0], output.edges[2]);
+
+    return output;
+}
+
+[domain("quad")]
+[partitioning("fractional_even")]
+[outputtopology("triangle_ccw")]
+[outputcontrolpoints(9)]
+[patchconstantfunc("ConstantHS")]
+VS_CONTROL_POINT HS(InputPatch<VS_CONTROL_POINT, 9> p, uint i : SV_OutputControlPointID)
+{
+    return p[i];
+}
+
+// Quadratic Bernstein polynomials
+float3 bernstein(float t)
+{
+    float s = 1.0 - t;
+    return float3(s * s, 2.0 * s * t, t * t);
+}
+
+[domain("quad")]
+DS_OUTPUT DS(HS_CONSTANT_DATA_OUTPUT input, float2 uv : SV_DomainLocation,
+    const OutputPatch<VS_CONTROL_POINT, 9> patch)
+{
+    float3 bu = bernstein(uv.x);
+    float3 bv = bernstein(uv.y);
+
+    float3 pos = 0;
+    float3 norm = 0;
+    float2 texCoord = 0;
+    for (int v = 0; v < 3; ++v)
+    {
+        for (int u = 0; u < 3; ++u)
+        {
+            float w = bu[u] * bv[v];
+            pos += w * patch[v * 3 + u].position;
+            norm += w * patch[v * 3 + u].normal;
+            texCoord += w * patch[v * 3 + u].uv;
+        }
+    }
+
+    DS_OUTPUT output;
+    output.position = mul(worldViewProj, float4(pos, 1));
+    output.objectPosition = pos;
+    output.normal = normalize(norm);
+    output.uv = texCoord;
+    return output;
+}
+
+Texture2D diffuseMap;
+
+SamplerState g_samLinear
+{
+    Filter = MIN_MAG_MIP_LINEAR;
+    AddressU = Wrap;
+    AddressV = Wrap;
+};
+
+// Diffuse lighting from one light, lit from both sides.
+float4 PS(DS_OUTPUT input) : SV_TARGET
+{
+    float3 lightDir = normalize(lightPosition.xyz - input.objectPosition * lightPosition.w);
+    float diffuse = abs(dot(normalize(input.normal), lightDir));
+    return diffuseMap.Sample(g_samLinear, input.uv) * (ambient + lightDiffuse * diffuse);
+}
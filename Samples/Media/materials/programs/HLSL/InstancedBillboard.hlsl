@@ -0,0 +1,54 @@
+// Expands the quads of a BillboardSet with instancing enabled,
+// see BillboardSet::setInstancingEnabled for the layout
+
+struct a2v
+{
+	// Corner of the quad, (0, 0) is left top and (1, 1) right bottom
+	float2 corner	: TEXCOORD0;
+	// Position and rotation, per billboard
+	float4 position	: POSITION;
+	float4 colour	: COLOR;
+	// Width and height
+	float2 size		: TEXCOORD1;
+	// Texture coordinates, left, top, right and bottom
+	float4 rect		: TEXCOORD2;
+};
+
+struct v2p
+{
+	float4 oPosition	: SV_POSITION;
+	float2 oUv			: TEXCOORD0;
+	float4 colour		: COLOR;
+};
+
+v2p instancedBillboard_vp(a2v input,
+						  uniform float4x4 worldViewProj,
+						  uniform float4 axisX,
+						  uniform float4 axisY,
+						  uniform float4 origin,
+						  uniform float4 rotationType)
+{
+	v2p output;
+	float2 offset = float2(lerp(origin.x, origin.y, input.corner.x) * input.size.x,
+						   lerp(origin.z, origin.w, input.corner.y) * input.size.y);
+	float2 side = input.corner * 2.0 - 1.0;
+	float2 halfSize = (input.rect.zw - input.rect.xy) * 0.5;
+	float2 mid = input.rect.xy + halfSize;
+	float c = cos(input.position.w);
+	float s = sin(input.position.w);
+	if (rotationType.x > 0.5)
+	{
+		offset = float2(offset.x * c + offset.y * s, offset.y * c - offset.x * s);
+		output.oUv = mid + side * halfSize;
+	}
+	else
+	{
+		output.oUv = mid + float2(side.x * c * halfSize.x - side.y * s * halfSize.y,
+								  side.x * s * halfSize.x + side.y * c * halfSize.y);
+	}
+
+	float3 pos = input.position.xyz + axisX.xyz * offset.x + axisY.xyz * offset.y;
+	output.oPosition = mul(worldViewProj, float4(pos, 1.0));
+	output.colour = input.colour;
+	return output;
+}
@@ -157,9 +157,7 @@ void Sample_VolumeTerrain::shootRay(Ray ray, bool doUnion)
         CSGOperationSource *operation = doUnion ? static_cast<CSGOperationSource*>(new CSGUnionSource()) : new CSGDifferenceSource();
         static_cast<TextureSource*>(mVolumeRoot->getChunkParameters()->src)->combineWithSource(operation, &sphere, intersection, radius * (Real)1.5);
         
-        mVolumeRoot->getChunkParameters()->updateFrom = intersection - radius * (Real)1.5;
-        mVolumeRoot->getChunkParameters()->updateTo = intersection + radius * (Real)1.5;
-        mVolumeRoot->load(mVolumeRootNode, Vector3::ZERO, Vector3(384), 5, mVolumeRoot->getChunkParameters());
+        mVolumeRoot->updateRegion(intersection - radius * (Real)1.5, intersection + radius * (Real)1.5);
         delete operation;
     }
 }
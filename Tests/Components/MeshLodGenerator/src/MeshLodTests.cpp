@@ -18,6 +18,7 @@
 #include "OgreRenderWindow.h"
 #include "OgreLodConfigSerializer.h"
 #include "OgreWorkQueue.h"
+#include "OgreLodData.h"
 
 //--------------------------------------------------------------------------
 void MeshLodTests::SetUp()
@@ -191,3 +192,53 @@ void MeshLodTests::setTestLodConfig(LodConfig& config)
     config.advanced.useBackgroundQueue = false;
 }
 //--------------------------------------------------------------------------
+TEST(LodCollapseCostHeap,MultimapOrder)
+{
+    // The heap has to give the order of the multimap it replaced, where equal
+    // costs come out in insertion order and an update reinserts the vertex.
+    typedef std::multimap<Real, LodData::Vertex*> CostMap;
+    const size_t count = 200;
+    std::vector<LodData::Vertex> vertices(count);
+    std::vector<CostMap::iterator> mapPositions(count);
+    LodData::CollapseCostHeap heap;
+    CostMap map;
+
+    // few distinct costs, so that most comparisons are ties
+    srand(0);
+    for (size_t i = 0; i < count; i++)
+    {
+        Real cost = Real(rand() % 8);
+        heap.insert(&vertices[i], cost);
+        mapPositions[i] = map.insert(std::make_pair(cost, &vertices[i]));
+    }
+    for (size_t n = 0; n < 1000; n++)
+    {
+        size_t i = rand() % count;
+        if (!heap.contains(&vertices[i]))
+            continue;
+        map.erase(mapPositions[i]);
+        if (rand() % 8 == 0)
+        {
+            heap.erase(&vertices[i]);
+            EXPECT_FALSE(heap.contains(&vertices[i]));
+        }
+        else
+        {
+            Real cost = Real(rand() % 8);
+            heap.update(&vertices[i], cost);
+            mapPositions[i] = map.insert(std::make_pair(cost, &vertices[i]));
+            EXPECT_EQ(cost, heap.getCost(&vertices[i]));
+        }
+    }
+
+    ASSERT_EQ(map.size(), heap.size());
+    for (CostMap::iterator it = map.begin(); it != map.end(); ++it)
+    {
+        ASSERT_FALSE(heap.empty());
+        EXPECT_EQ(it->first, heap.topCost());
+        EXPECT_EQ(it->second, heap.top());
+        heap.erase(heap.top());
+    }
+    EXPECT_TRUE(heap.empty());
+}
+//--------------------------------------------------------------------------
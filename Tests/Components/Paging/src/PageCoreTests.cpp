@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "PageCoreTests.h"
 #include "OgrePaging.h"
 #include "OgreLogManager.h"
+#include "OgreWorkQueue.h"
 
 
 // Register the test suite
@@ -92,3 +93,57 @@ TEST_F(PageCoreTests,SimpleCreateSaveLoadWorld)
 }
 //--------------------------------------------------------------------------
 
+namespace {
+    /// Counts the collections it destroys
+    class CountingCollectionFactory : public SimplePageContentCollectionFactory
+    {
+    public:
+        static String NAME;
+        size_t destroyed;
+
+        CountingCollectionFactory() : destroyed(0) {}
+        const String& getName() const { return NAME; }
+        void destroyInstance(PageContentCollection* c)
+        {
+            ++destroyed;
+            SimplePageContentCollectionFactory::destroyInstance(c);
+        }
+    };
+    String CountingCollectionFactory::NAME = "Counting";
+}
+//--------------------------------------------------------------------------
+TEST_F(PageCoreTests,ContentCollectionsDestroyedByFactory)
+{
+    CountingCollectionFactory factory;
+    mPageManager->addContentCollectionFactory(&factory);
+
+    PagedWorld* world = mPageManager->createWorld("CollectionWorld");
+    PagedWorldSection* section = world->createSection("Grid2D", mSceneMgr, "Section");
+    Page* p = section->loadOrCreatePage(Vector3::ZERO);
+    p->createContentCollection(CountingCollectionFactory::NAME);
+    p->save();
+
+    p->unload();
+    EXPECT_EQ(1u, factory.destroyed);
+    EXPECT_EQ(0u, p->getContentCollectionCount());
+
+    // prepare in the background, but cancel before the manager finalises the page
+    WorkQueue* wq = Root::getSingleton().getWorkQueue();
+    wq->startup();
+    p->load(false);
+    mPageManager->_processPageLoads();
+    for (int i = 0; i < 5000 && !p->_isPrepared(); i++)
+    {
+        OGRE_WQ_THREAD_SLEEP(1);
+        wq->processResponses();
+    }
+    ASSERT_TRUE(p->_isPrepared());
+
+    p->unload();
+    EXPECT_FALSE(p->_isPrepared());
+    EXPECT_EQ(2u, factory.destroyed);
+
+    mPageManager->destroyWorld(world);
+    mPageManager->removeContentCollectionFactory(&factory);
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,258 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+/** Times the CPU side of the terrain component, without a render system.
+
+    Usage: Test_TerrainBenchmark [output.csv]
+
+    Every case is run on procedurally generated terrains of several sizes, and
+    one line per case and size is written as CSV with the columns
+    benchmark,terrainSize,iterations,totalMs,microsecondsPerIteration
+*/
+
+#include "OgreRoot.h"
+#include "OgreLogManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreTerrain.h"
+#include "OgreTerrainGroup.h"
+#include "OgreStreamSerialiser.h"
+#include "OgreTimer.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace Ogre;
+
+namespace
+{
+    const uint16 TERRAIN_SIZES[] = { 129, 257, 513, 1025 };
+    const Real WORLD_SIZE = 10000;
+    const size_t QUERY_COUNT = 100000;
+
+    /// Rolling hills, so that rays travel some distance before hitting
+    vector<float>::type generateHeights(uint16 size)
+    {
+        vector<float>::type heights(size * size);
+        for (uint16 y = 0; y < size; ++y)
+        {
+            for (uint16 x = 0; x < size; ++x)
+            {
+                Real u = x / (Real)(size - 1);
+                Real v = y / (Real)(size - 1);
+                heights[y * size + x] = 300 * Math::Sin(u * 23) * Math::Cos(v * 17)
+                    + 80 * Math::Sin((u + v) * 131);
+            }
+        }
+        return heights;
+    }
+
+    Terrain::ImportData makeImportData(uint16 size, float* heights)
+    {
+        Terrain::ImportData imp;
+        imp.terrainSize = size;
+        imp.worldSize = WORLD_SIZE;
+        imp.inputFloat = heights;
+        imp.inputScale = 1;
+        imp.minBatchSize = 33;
+        imp.maxBatchSize = 65;
+        return imp;
+    }
+
+    class Results
+    {
+    public:
+        Results(std::ostream& out) : mOut(out)
+        {
+            mOut << "benchmark,terrainSize,iterations,totalMs,microsecondsPerIteration\n";
+        }
+
+        void add(const String& name, uint16 size, size_t iterations, unsigned long micros)
+        {
+            mOut << name << "," << size << "," << iterations << ","
+                << micros / 1000.0 << "," << micros / (double)iterations << "\n";
+            mOut.flush();
+        }
+
+    private:
+        std::ostream& mOut;
+    };
+
+    void benchmarkTerrain(SceneManager* sceneMgr, uint16 size, Results& results)
+    {
+        vector<float>::type heights = generateHeights(size);
+        Terrain::ImportData imp = makeImportData(size, &heights[0]);
+        Timer timer;
+        // fewer repeats for the big terrains, so that each size takes a similar time
+        size_t repeats = std::max<size_t>(1, 1025 / size);
+
+        // import
+        Terrain* terrain = 0;
+        timer.reset();
+        for (size_t i = 0; i < repeats; ++i)
+        {
+            OGRE_DELETE terrain;
+            terrain = OGRE_NEW Terrain(sceneMgr);
+            terrain->prepare(imp);
+        }
+        results.add("import", size, repeats, timer.getMicroseconds());
+
+        // derived data, which is what updateDerivedData does in the background
+        Rect rect(0, 0, size, size);
+        timer.reset();
+        for (size_t i = 0; i < repeats; ++i)
+            terrain->calculateHeightDeltas(rect);
+        results.add("heightDeltas", size, repeats, timer.getMicroseconds());
+
+        timer.reset();
+        for (size_t i = 0; i < repeats; ++i)
+        {
+            Rect finalRect;
+            PixelBox* normals = terrain->calculateNormals(rect, finalRect);
+            OGRE_FREE(normals->data, MEMCATEGORY_GENERAL);
+            OGRE_DELETE normals;
+        }
+        results.add("normals", size, repeats, timer.getMicroseconds());
+
+        timer.reset();
+        for (size_t i = 0; i < repeats; ++i)
+        {
+            Rect finalRect;
+            PixelBox* lightmap = terrain->calculateLightmap(rect, Rect(), finalRect);
+            OGRE_FREE(lightmap->data, MEMCATEGORY_GENERAL);
+            OGRE_DELETE lightmap;
+        }
+        results.add("lightmap", size, repeats, timer.getMicroseconds());
+
+        // save & load through memory, so that disk speed doesn't count
+        size_t capacity = size * size * sizeof(float) * 4 + 16 * 1024 * 1024;
+        DataStreamPtr stream(OGRE_NEW MemoryDataStream(capacity));
+        timer.reset();
+        for (size_t i = 0; i < repeats; ++i)
+        {
+            stream->seek(0);
+            StreamSerialiser ser(stream);
+            terrain->save(ser);
+        }
+        results.add("save", size, repeats, timer.getMicroseconds());
+
+        Terrain* loaded = OGRE_NEW Terrain(sceneMgr);
+        timer.reset();
+        for (size_t i = 0; i < repeats; ++i)
+        {
+            stream->seek(0);
+            loaded->prepare(stream);
+        }
+        results.add("load", size, repeats, timer.getMicroseconds());
+        OGRE_DELETE loaded;
+
+        // queries at the same places for every size
+        vector<Vector3>::type positions(QUERY_COUNT);
+        vector<Ray>::type rays(QUERY_COUNT);
+        uint32 seed = 12345;
+        for (size_t i = 0; i < QUERY_COUNT; ++i)
+        {
+            Real p[4];
+            for (int c = 0; c < 4; ++c)
+            {
+                // LCG rather than rand(), so the places don't depend on the C runtime
+                seed = seed * 1664525 + 1013904223;
+                p[c] = (seed >> 8) / (Real)(1 << 24) - 0.5f;
+            }
+            positions[i] = Vector3(p[0] * WORLD_SIZE, 0, p[1] * WORLD_SIZE);
+            // shallow rays cross a good part of the terrain before hitting it
+            rays[i] = Ray(positions[i] + Vector3(0, 1000, 0), 
+                Vector3(p[2], -0.2f, p[3]).normalisedCopy());
+        }
+
+        volatile float heightSum = 0;
+        timer.reset();
+        for (size_t i = 0; i < QUERY_COUNT; ++i)
+            heightSum += terrain->getHeightAtWorldPosition(positions[i]);
+        results.add("getHeightAtWorldPosition", size, QUERY_COUNT, timer.getMicroseconds());
+
+        vector<float>::type batchHeights(QUERY_COUNT);
+        timer.reset();
+        terrain->getHeightsAtWorldPositions(&positions[0], QUERY_COUNT, &batchHeights[0]);
+        results.add("getHeightsAtWorldPositions", size, QUERY_COUNT, timer.getMicroseconds());
+
+        volatile size_t hits = 0;
+        timer.reset();
+        for (size_t i = 0; i < QUERY_COUNT; ++i)
+            hits += terrain->rayIntersects(rays[i]).first;
+        results.add("rayIntersects", size, QUERY_COUNT, timer.getMicroseconds());
+
+        vector<std::pair<bool, Vector3> >::type batchHits(QUERY_COUNT);
+        timer.reset();
+        terrain->rayIntersects(&rays[0], QUERY_COUNT, &batchHits[0]);
+        results.add("rayIntersectsBatch", size, QUERY_COUNT, timer.getMicroseconds());
+
+        // the same through a group, as used from other threads
+        TerrainGroupHeightSnapshot group(Terrain::ALIGN_X_Z, WORLD_SIZE, Vector3::ZERO);
+        group.addTerrain(0, 0, terrain->getHeightSnapshot());
+        timer.reset();
+        for (size_t i = 0; i < QUERY_COUNT; ++i)
+            hits += group.rayIntersects(rays[i]).first;
+        results.add("groupSnapshotRayIntersects", size, QUERY_COUNT, timer.getMicroseconds());
+
+        OGRE_DELETE terrain;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::ofstream file;
+    if (argc > 1)
+    {
+        file.open(argv[1]);
+        if (!file)
+        {
+            std::cerr << "Can't write to " << argv[1] << std::endl;
+            return 1;
+        }
+    }
+
+    LogManager* logMgr = OGRE_NEW LogManager();
+    logMgr->createLog("OgreTerrainBenchmark.log", true, false);
+
+    {
+        // no render system, all the buffers live in system memory
+        Root root("", "", "");
+        DefaultHardwareBufferManager bufferMgr;
+        TerrainGlobalOptions terrainOpts;
+        SceneManager* sceneMgr = root.createSceneManager(ST_GENERIC);
+
+        Results results(argc > 1 ? file : std::cout);
+        for (size_t i = 0; i < sizeof(TERRAIN_SIZES) / sizeof(TERRAIN_SIZES[0]); ++i)
+            benchmarkTerrain(sceneMgr, TERRAIN_SIZES[i], results);
+
+        root.destroySceneManager(sceneMgr);
+    }
+
+    OGRE_DELETE logMgr;
+    return 0;
+}
@@ -103,3 +103,214 @@ TEST_F(TerrainTests, create)
     ASSERT_TRUE(1);
 }
 //--------------------------------------------------------------------------
+TEST_F(TerrainTests, rayIntersects)
+{
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.terrainSize = 513;
+    imp.worldSize = 1000;
+    imp.inputScale = 100;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    t->prepare(imp);
+
+    // rays straight down hit the terrain at its height
+    const size_t count = 256;
+    vector<Ray>::type rays;
+    vector<Vector3>::type positions;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vector3 pos(Math::RangeRandom(-490, 490), 0, Math::RangeRandom(-490, 490));
+        positions.push_back(pos);
+        rays.push_back(Ray(pos + Vector3(0, 1000, 0), Vector3::NEGATIVE_UNIT_Y));
+    }
+    vector<std::pair<bool, Vector3> >::type results(count);
+    vector<float>::type heights(count);
+    t->rayIntersects(&rays[0], count, &results[0]);
+    t->getHeightsAtWorldPositions(&positions[0], count, &heights[0]);
+    for (size_t i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(t->getHeightAtWorldPosition(positions[i]), heights[i]);
+        ASSERT_TRUE(results[i].first);
+        EXPECT_NEAR(positions[i].x, results[i].second.x, 1e-2);
+        EXPECT_NEAR(positions[i].z, results[i].second.z, 1e-2);
+        EXPECT_NEAR(heights[i], results[i].second.y, 1e-1);
+    }
+
+    // batched oblique rays agree with single ones, also after changing heights
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vector3 dir(Math::RangeRandom(-1, 1), -0.2f, Math::RangeRandom(-1, 1));
+        rays[i] = Ray(positions[i] + Vector3(0, 150, 0), dir.normalisedCopy());
+    }
+    for (long y = 200; y < 300; ++y)
+        for (long x = 200; x < 300; ++x)
+            *t->getHeightData(x, y) = 200;
+    t->dirtyRect(Rect(200, 200, 300, 300));
+
+    t->rayIntersects(&rays[0], count, &results[0]);
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::pair<bool, Vector3> single = t->rayIntersects(rays[i]);
+        ASSERT_EQ(single.first, results[i].first);
+        if (single.first)
+            EXPECT_EQ(single.second, results[i].second);
+    }
+
+    // a ray pointing away from the terrain misses it
+    EXPECT_FALSE(t->rayIntersects(Ray(Vector3(0, 1000, 0), Vector3::UNIT_Y)).first);
+
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, heightSnapshot)
+{
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    EXPECT_FALSE(t->getHeightSnapshot());
+
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.terrainSize = 513;
+    imp.worldSize = 1000;
+    imp.inputScale = 100;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    t->prepare(imp);
+
+    // a snapshot answers like the terrain it was taken from
+    TerrainHeightSnapshotPtr snapshot = t->getHeightSnapshot();
+    ASSERT_TRUE(snapshot);
+    for (int i = 0; i < 256; ++i)
+    {
+        Vector3 pos(Math::RangeRandom(-500, 500), 0, Math::RangeRandom(-500, 500));
+        EXPECT_EQ(t->getHeightAtWorldPosition(pos), snapshot->getHeightAtWorldPosition(pos));
+        Ray ray(pos + Vector3(0, 1000, 0), Vector3::NEGATIVE_UNIT_Y);
+        EXPECT_EQ(t->rayIntersects(ray), snapshot->rayIntersects(ray));
+    }
+
+    // edits aren't visible to readers of the snapshot
+    Vector3 centre(0, 0, 0);
+    float height = snapshot->getHeightAtWorldPosition(centre);
+    for (long y = 250; y < 260; ++y)
+        for (long x = 250; x < 260; ++x)
+            *t->getHeightData(x, y) = 300;
+    t->dirtyRect(Rect(250, 250, 260, 260));
+    EXPECT_EQ(height, snapshot->getHeightAtWorldPosition(centre));
+    EXPECT_EQ(snapshot, t->getHeightSnapshot());
+
+    // moving the terrain publishes a new snapshot, the old one stays valid
+    t->setPosition(Vector3(1000, 0, 0));
+    TerrainHeightSnapshotPtr moved = t->getHeightSnapshot();
+    ASSERT_TRUE(moved);
+    EXPECT_NE(snapshot, moved);
+    EXPECT_EQ(Vector3::ZERO, snapshot->getPosition());
+    EXPECT_EQ(300, moved->getHeightAtWorldPosition(Vector3(1000, 0, 0)));
+
+    OGRE_DELETE t;
+    EXPECT_EQ(height, snapshot->getHeightAtWorldPosition(centre));
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, compressHeightData)
+{
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.terrainSize = 513;
+    imp.worldSize = 1000;
+    imp.inputScale = 100;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    t->prepare(imp);
+
+    vector<float>::type heights(t->getHeightData(), t->getHeightData() + 513 * 513);
+    t->compressHeightData();
+    ASSERT_TRUE(t->isHeightDataCompressed());
+
+    // queries read the packed heights, which are within 1/65535 of the input scale
+    for (long y = 0; y < 513; y += 7)
+        for (long x = 0; x < 513; x += 7)
+            EXPECT_NEAR(heights[y * 513 + x], t->getHeightAtPoint(x, y), 100.0f / 65535);
+    Ray ray(Vector3(12, 1000, 34), Vector3::NEGATIVE_UNIT_Y);
+    std::pair<bool, Vector3> hit = t->rayIntersects(ray);
+    ASSERT_TRUE(hit.first);
+    EXPECT_NEAR(t->getHeightAtWorldPosition(12, 0, 34), hit.second.y, 1e-2);
+    EXPECT_TRUE(t->isHeightDataCompressed());
+
+    // snapshots share the packed heights
+    EXPECT_EQ(t->getHeightAtWorldPosition(12, 0, 34), 
+        t->getHeightSnapshot()->getHeightAtWorldPosition(Vector3(12, 0, 34)));
+
+    // raw access unpacks them again
+    float packedHeight = t->getHeightAtPoint(100, 200);
+    EXPECT_EQ(packedHeight, *t->getHeightData(100, 200));
+    EXPECT_FALSE(t->isHeightDataCompressed());
+
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, instancedPatchesNeedSupport)
+{
+    // without a render system there's no vertex texture fetch, so nodes keep
+    // their own vertex data even when instanced patches are requested
+    mTerrainOpts->setUseInstancedPatches(true);
+    EXPECT_TRUE(mTerrainOpts->getUseInstancedPatches());
+
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.terrainSize = 513;
+    imp.worldSize = 1000;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    t->prepare(imp);
+
+    EXPECT_FALSE(t->_getUseInstancedPatches());
+    EXPECT_FALSE(t->_getPatchRenderer());
+    EXPECT_FALSE(t->getHeightTexture());
+
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, resetForReuse)
+{
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.terrainSize = 513;
+    imp.worldSize = 1000;
+    imp.inputScale = 100;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    t->prepare(imp);
+    float height = t->getHeightAtPoint(100, 200);
+
+    ASSERT_TRUE(t->_resetForReuse());
+    EXPECT_FALSE(t->getHeightData());
+    EXPECT_FALSE(t->getQuadTree());
+    EXPECT_EQ(0, t->getLayerCount());
+
+    // a recycled instance prepares like a new one
+    imp.inputScale = 50;
+    imp.worldSize = 500;
+    t->prepare(imp);
+    EXPECT_EQ(500, t->getWorldSize());
+    EXPECT_NEAR(height / 2, t->getHeightAtPoint(100, 200), 1e-3);
+
+    OGRE_DELETE t;
+}
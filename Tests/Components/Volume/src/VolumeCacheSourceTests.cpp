@@ -0,0 +1,120 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreVolumeCacheSource.h"
+#include "Threading/OgreParallel.h"
+#include "Threading/OgreWorkStealingQueue.h"
+
+using namespace Ogre;
+using namespace Ogre::Volume;
+
+namespace {
+    /// A plane at y = 0 which counts how often it is evaluated
+    class CountingSource : public Source
+    {
+    public:
+        mutable AtomicScalar<int> calls;
+        CountingSource() : calls(0) {}
+
+        Vector4 getValueAndGradient(const Vector3 &position) const
+        {
+            ++calls;
+            return Vector4(0, 1, 0, -position.y);
+        }
+        Real getValue(const Vector3 &position) const
+        {
+            return getValueAndGradient(position).w;
+        }
+    };
+
+    struct Query
+    {
+        const CacheSource* cache;
+        Real* out;
+        Query(const CacheSource* c, Real* o) : cache(c), out(o) {}
+        void operator()(size_t i) const
+        {
+            // every position is queried by several iterations
+            out[i] = cache->getValue(Vector3(0, Real(i % 100), 0));
+        }
+    };
+}
+
+TEST(VolumeCacheSource, cachesValues)
+{
+    CountingSource src;
+    CacheSource cache(&src, 1024);
+
+    // nothing is allocated before the first value
+    EXPECT_EQ(0u, cache.getAllocatedEntries());
+
+    EXPECT_EQ(-2, cache.getValue(Vector3(1, 2, 3)));
+    EXPECT_EQ(1, src.calls.load());
+    EXPECT_EQ(-2, cache.getValue(Vector3(1, 2, 3)));
+    EXPECT_EQ(Vector4(0, 1, 0, -2), cache.getValueAndGradient(Vector3(1, 2, 3)));
+    EXPECT_EQ(1, src.calls.load());
+
+    // only the used shard has a table
+    EXPECT_GT(cache.getAllocatedEntries(), 0u);
+    EXPECT_LT(cache.getAllocatedEntries(), 1024u);
+
+    cache.clear();
+    EXPECT_EQ(-2, cache.getValue(Vector3(1, 2, 3)));
+    EXPECT_EQ(2, src.calls.load());
+}
+
+TEST(VolumeCacheSource, boundedSize)
+{
+    CountingSource src;
+    CacheSource cache(&src, 1024);
+    for (int i = 0; i < 10000; ++i)
+        EXPECT_EQ(Real(-i), cache.getValue(Vector3(0, Real(i), 0)));
+    EXPECT_EQ(10000, src.calls.load());
+    EXPECT_EQ(1024u, cache.getAllocatedEntries());
+}
+
+TEST(VolumeCacheSource, workerThreads)
+{
+    Root root;
+    WorkStealingQueue* queue = OGRE_NEW WorkStealingQueue("Test");
+    root.setWorkQueue(queue);
+    queue->setWorkerThreadCount(4);
+    queue->startup();
+
+    CountingSource src;
+    CacheSource cache(&src);
+    Real out[1000];
+    parallelFor(0, 1000, Query(&cache, out), 8);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(Real(-(i % 100)), out[i]);
+    // threads racing for a missing value may each evaluate it
+    EXPECT_GE(src.calls.load(), 100);
+    EXPECT_LT(src.calls.load(), 1000);
+}
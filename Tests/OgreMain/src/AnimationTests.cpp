@@ -0,0 +1,252 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreSkeletonManager.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreSkeletonAnimationCache.h"
+#include "OgreBone.h"
+#include "OgreAnimation.h"
+#include "OgreKeyFrame.h"
+#include "OgreMath.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+static const Real sTolerance = 1e-4f;
+// Quaternion::equals compares the angle between the rotations
+static const Radian sRotationTolerance = Degree(0.1f);
+
+// More bones than a batch of Animation::applyBatchedNodeTracks
+static const unsigned short sNumBones = 70;
+
+//--------------------------------------------------------------------------
+static Animation* createRandomAnimation(Skeleton& skel, Real length)
+{
+    for (unsigned short b = 0; b < sNumBones; ++b)
+    {
+        Bone* bone = skel.createBone(b);
+        if (b)
+            skel.getBone((b - 1) / 2)->addChild(bone);
+        bone->setPosition(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1));
+    }
+    skel.setBindingPose();
+
+    Animation* anim = skel.createAnimation("random", length);
+    for (unsigned short b = 0; b < sNumBones; ++b)
+    {
+        // Leave a few bones without track or keyframes
+        if (b % 11 == 10)
+            continue;
+        NodeAnimationTrack* track = anim->createNodeTrack(b, skel.getBone(b));
+        if (b % 13 == 12)
+            continue;
+        track->setUseShortestRotationPath(b % 7 != 0);
+
+        // Keyframe times differ between tracks
+        size_t numKeys = 1 + b % 5;
+        for (size_t k = 0; k < numKeys; ++k)
+        {
+            TransformKeyFrame* kf = track->createNodeKeyFrame(length * (k + Math::UnitRandom() * 0.5f) / numKeys);
+            kf->setRotation(Quaternion(Radian(Math::RangeRandom(-Math::PI, Math::PI)),
+                Vector3(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), 1).normalisedCopy()));
+            kf->setTranslate(Vector3(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1)));
+            if (b % 3 == 0)
+                kf->setScale(Vector3(Math::RangeRandom(0.5f, 2), Math::RangeRandom(0.5f, 2), 1));
+        }
+    }
+    return anim;
+}
+//--------------------------------------------------------------------------
+static void expectSameBones(const vector<Bone*>::type& bones, const vector<Quaternion>::type& orientations,
+    const vector<Vector3>::type& positions, const vector<Vector3>::type& scales)
+{
+    for (unsigned short b = 0; b < sNumBones; ++b)
+    {
+        EXPECT_TRUE(bones[b]->getOrientation().equals(orientations[b], sRotationTolerance)) << "bone " << b;
+        EXPECT_TRUE(bones[b]->getPosition().positionEquals(positions[b], sTolerance)) << "bone " << b;
+        EXPECT_TRUE(bones[b]->getScale().positionEquals(scales[b], sTolerance)) << "bone " << b;
+    }
+}
+//--------------------------------------------------------------------------
+TEST(AnimationTests,BatchedSkeletonAnimation)
+{
+    const Real length = 3;
+    Skeleton skel(0, "AnimationTests", 0, "General");
+    Animation* anim = createRandomAnimation(skel, length);
+
+    AnimationState::BoneBlendMask blendMask(sNumBones);
+    for (unsigned short b = 0; b < sNumBones; ++b)
+        blendMask[b] = b % 4 ? Math::UnitRandom() : 0;
+
+    vector<Bone*>::type bones(sNumBones);
+    for (unsigned short b = 0; b < sNumBones; ++b)
+        bones[b] = skel.getBone(b);
+
+    const Real times[] = { 0, 0.3f, 1.5f, length, length + 0.7f };
+    const Real scales[] = { 1, 0.5f };
+    for (size_t i = 0; i < sizeof(times) / sizeof(times[0]); ++i)
+    {
+        for (size_t s = 0; s < 2; ++s)
+        {
+            for (size_t m = 0; m < 2; ++m)
+            {
+                Real weight = 0.75f;
+                const AnimationState::BoneBlendMask* mask = m ? &blendMask : 0;
+
+                // Reference result, one track at a time
+                skel.reset();
+                TimeIndex timeIndex = anim->_getTimeIndex(times[i]);
+                Animation::NodeTrackIterator it = anim->getNodeTrackIterator();
+                while (it.hasMoreElements())
+                {
+                    NodeAnimationTrack* track = it.getNext();
+                    unsigned short handle = track->getHandle();
+                    track->applyToNode(bones[handle], timeIndex, mask ? (*mask)[handle] * weight : weight, scales[s]);
+                }
+                vector<Quaternion>::type orientations(sNumBones);
+                vector<Vector3>::type positions(sNumBones), boneScales(sNumBones);
+                for (unsigned short b = 0; b < sNumBones; ++b)
+                {
+                    orientations[b] = bones[b]->getOrientation();
+                    positions[b] = bones[b]->getPosition();
+                    boneScales[b] = bones[b]->getScale();
+                }
+
+                skel.reset();
+                if (mask)
+                    anim->apply(&skel, times[i], weight, mask, scales[s]);
+                else
+                    anim->apply(&skel, times[i], weight, scales[s]);
+                expectSameBones(bones, orientations, positions, boneScales);
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(AnimationTests,KeyFrameChangesRebuildBatchedTracks)
+{
+    Skeleton skel(0, "AnimationTests", 0, "General");
+    Animation* anim = createRandomAnimation(skel, 2);
+    Bone* bone = skel.getBone(1);
+    NodeAnimationTrack* track = anim->getNodeTrack(1);
+
+    skel.reset();
+    anim->apply(&skel, 0.5f);
+
+    // Editing a keyframe after the first evaluation must be picked up
+    for (unsigned short k = 0; k < track->getNumKeyFrames(); ++k)
+    {
+        track->getNodeKeyFrame(k)->setRotation(Quaternion::IDENTITY);
+        track->getNodeKeyFrame(k)->setTranslate(Vector3(0, 0, 1));
+    }
+    skel.reset();
+    anim->apply(&skel, 0.5f);
+    EXPECT_TRUE(bone->getOrientation().equals(bone->getInitialOrientation(), sRotationTolerance));
+    EXPECT_TRUE(bone->getPosition().positionEquals(bone->getInitialPosition() + Vector3(0, 0, 1), sTolerance));
+}
+//--------------------------------------------------------------------------
+TEST(AnimationTests,KeyFrameIndexHint)
+{
+    Skeleton skel(0, "AnimationTests", 0, "General");
+    const Real length = 2;
+    Animation* anim = createRandomAnimation(skel, length);
+
+    uint hint = 0;
+    for (Real t = 0; t < length * 3; t += 0.05f)
+    {
+        TimeIndex expected = anim->_getTimeIndex(t);
+        TimeIndex result = anim->_getTimeIndex(t, &hint);
+        EXPECT_EQ(expected.getKeyIndex(), result.getKeyIndex()) << "time " << t;
+        EXPECT_EQ(expected.getKeyIndex(), hint) << "time " << t;
+        EXPECT_EQ(expected.getTimePos(), result.getTimePos()) << "time " << t;
+    }
+
+    // A stale hint, e.g. from an other animation, is still safe
+    hint = 1000;
+    EXPECT_EQ(anim->_getTimeIndex(0.1f).getKeyIndex(), anim->_getTimeIndex(0.1f, &hint).getKeyIndex());
+}
+//--------------------------------------------------------------------------
+typedef RootWithoutRenderSystemFixture SkeletonAnimationCacheTests;
+TEST_F(SkeletonAnimationCacheTests,SharePoses)
+{
+    SkeletonPtr skel = SkeletonManager::getSingleton().create("AnimationCacheTests",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+    createRandomAnimation(*skel, 2);
+    skel->load();
+
+    SkeletonInstance instance1(skel), instance2(skel);
+    instance1.load();
+    instance2.load();
+    AnimationStateSet states1, states2;
+    skel->_initAnimationState(&states1);
+    skel->_initAnimationState(&states2);
+    states1.getAnimationState("random")->setEnabled(true);
+    states2.getAnimationState("random")->setEnabled(true);
+
+    vector<Matrix4>::type expected(sNumBones), matrices1(sNumBones), matrices2(sNumBones);
+    instance1.setAnimationState(states1);
+    instance1._getBoneMatrices(&expected[0]);
+
+    // Same state, the second instance copies the pose of the first
+    SkeletonAnimationCache cache;
+    EXPECT_FALSE(cache._getBoneMatrices(skel.get(), &instance1, states1, &matrices1[0], 1));
+    EXPECT_TRUE(cache._getBoneMatrices(skel.get(), &instance2, states2, &matrices2[0], 1));
+    EXPECT_EQ(1u, cache.getNumEntries());
+    EXPECT_EQ(1u, cache.getNumHits());
+    for (unsigned short b = 0; b < sNumBones; ++b)
+    {
+        EXPECT_EQ(expected[b], matrices1[b]) << "bone " << b;
+        EXPECT_EQ(expected[b], matrices2[b]) << "bone " << b;
+    }
+
+    // Different time or weight
+    states2.getAnimationState("random")->setTimePosition(0.01f);
+    EXPECT_FALSE(cache._getBoneMatrices(skel.get(), &instance2, states2, &matrices2[0], 1));
+    states2.getAnimationState("random")->setTimePosition(0);
+    states2.getAnimationState("random")->setWeight(0.5f);
+    EXPECT_FALSE(cache._getBoneMatrices(skel.get(), &instance2, states2, &matrices2[0], 1));
+    states2.getAnimationState("random")->setWeight(1);
+    EXPECT_TRUE(cache._getBoneMatrices(skel.get(), &instance2, states2, &matrices2[0], 1));
+    EXPECT_EQ(3u, cache.getNumEntries());
+
+    // Close enough once quantised
+    cache.setTimeQuantum(0.1f);
+    states2.getAnimationState("random")->setTimePosition(0.01f);
+    EXPECT_FALSE(cache._getBoneMatrices(skel.get(), &instance1, states1, &matrices1[0], 1));
+    EXPECT_TRUE(cache._getBoneMatrices(skel.get(), &instance2, states2, &matrices2[0], 1));
+
+    // Emptied on the next frame
+    EXPECT_FALSE(cache._getBoneMatrices(skel.get(), &instance2, states2, &matrices2[0], 2));
+    EXPECT_EQ(1u, cache.getNumEntries());
+    EXPECT_EQ(0u, cache.getNumHits());
+
+    instance1.unload();
+    instance2.unload();
+    SkeletonManager::getSingleton().remove(skel->getHandle());
+}
@@ -309,6 +309,27 @@ TEST_F(FileSystemArchiveTests,ReadInterleave)
     EXPECT_TRUE(stream2->eof());
 }
 //--------------------------------------------------------------------------
+TEST_F(FileSystemArchiveTests,MappedFileRead)
+{
+    FileSystemArchive arch(mTestPath, "FileSystem", true);
+    arch.load();
+
+    size_t threshold = FileSystemArchive::getMemoryMapThreshold();
+    FileSystemArchive::setMemoryMapThreshold(1);
+    DataStreamPtr stream = arch.open("rootfile.txt");
+    FileSystemArchive::setMemoryMapThreshold(threshold);
+
+    MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+    ASSERT_TRUE(memStream != NULL);
+    EXPECT_EQ(0, memcmp(memStream->getPtr(), "this is line 1 in file 1", 24));
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    EXPECT_EQ(String("this is line 2 in file 1"), stream->getLine());
+    stream->seek(0);
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    EXPECT_FALSE(stream->isWriteable());
+    stream->close();
+}
+//--------------------------------------------------------------------------
 TEST_F(FileSystemArchiveTests,CreateAndRemoveFile)
 {
     FileSystemArchive arch("./", "FileSystem", false);
@@ -29,9 +29,56 @@ THE SOFTWARE.
 
 #include "OgreRoot.h"
 #include "OgreSceneNode.h"
+#include "OgreScriptCompiler.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreCamera.h"
 
 using namespace Ogre;
 
+namespace
+{
+    /// Movable object recording the order in which it is queued
+    class QueueRecorder : public MovableObject
+    {
+    public:
+        QueueRecorder(const String& name, StringVector* queued)
+            : MovableObject(name), mQueued(queued), mBox(-Vector3::UNIT_SCALE, Vector3::UNIT_SCALE) {}
+
+        const String& getMovableType(void) const { static String type = "QueueRecorder"; return type; }
+        const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+        Real getBoundingRadius(void) const { return Math::Sqrt(3); }
+        void _updateRenderQueue(RenderQueue*) { mQueued->push_back(mName); }
+        void visitRenderables(Renderable::Visitor*, bool) {}
+
+    private:
+        StringVector* mQueued;
+        AxisAlignedBox mBox;
+    };
+
+    /// Camera with an orthographic frustum 100 units wide, which needs no render system
+    class OrthoTestCamera : public Camera
+    {
+    public:
+        OrthoTestCamera(SceneManager* sm) : Camera("OrthoTestCamera", sm) {}
+
+    protected:
+        void updateFrustumImpl(void) const
+        {
+            Real n = 1, f = 1000;
+            mProjMatrix = Matrix4(
+                Real(0.02), 0, 0, 0,
+                0, Real(0.02), 0, 0,
+                0, 0, -2 / (f - n), -(f + n) / (f - n),
+                0, 0, 0, 1);
+            mBoundingBox.setExtents(Vector3(-50, -50, -f), Vector3(50, 50, -n));
+            mRecalcFrustum = false;
+            mRecalcFrustumPlanes = true;
+        }
+    };
+}
+
 TEST(Root,shutdown)
 {
     Root root;
@@ -46,3 +93,318 @@ TEST(SceneManager,removeAndDestroyAllChildren)
     sm->getRootSceneNode()->createChildSceneNode();
     sm->getRootSceneNode()->removeAndDestroyAllChildren();
 }
+
+TEST(SceneManager,parallelUpdateDepth)
+{
+    Root root;
+    SceneManager* sm = root.createSceneManager(ST_GENERIC);
+
+    size_t depth = 2;
+    ASSERT_TRUE(sm->setOption("ParallelUpdateDepth", &depth));
+
+    SceneNode* parent = sm->getRootSceneNode()->createChildSceneNode(Vector3(1, 0, 0));
+    SceneNode* leaf = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        SceneNode* child = parent->createChildSceneNode(Vector3(0, Real(i), 0));
+        leaf = child->createChildSceneNode(Vector3(0, 0, 1));
+    }
+
+    sm->_updateSceneGraph(0);
+    EXPECT_EQ(Vector3(1, 15, 1), leaf->_getDerivedPosition());
+
+    // selective update of a single subtree below the split depth
+    parent->setPosition(Vector3(2, 0, 0));
+    sm->_updateSceneGraph(0);
+    EXPECT_EQ(Vector3(2, 15, 1), leaf->_getDerivedPosition());
+}
+
+TEST(SceneManager,parallelCullingDepth)
+{
+    Root root;
+    SceneManager* sm = root.createSceneManager(ST_GENERIC);
+    OrthoTestCamera cam(sm);
+
+    // groups at x = +-200 are outside of the frustum, those at x = +-20 inside
+    StringVector queued;
+    vector<QueueRecorder*>::type objects;
+    Real groupX[] = { -200, -20, 20, 200 };
+    for (int g = 0; g < 4; ++g)
+    {
+        SceneNode* group = sm->getRootSceneNode()->createChildSceneNode(Vector3(groupX[g], 0, -100));
+        for (int i = 0; i < 4; ++i)
+        {
+            SceneNode* child = group->createChildSceneNode(Vector3(0, Real(i * 10 - 15), 0));
+            objects.push_back(OGRE_NEW QueueRecorder(StringConverter::toString(g * 4 + i), &queued));
+            child->createChildSceneNode()->attachObject(objects.back());
+        }
+    }
+    sm->_updateSceneGraph(&cam);
+
+    // the parallel pass queues the same objects in the same order, at any split depth
+    StringVector expected;
+    for (size_t depth = 0; depth < 4; ++depth)
+    {
+        ASSERT_TRUE(sm->setOption("ParallelCullingDepth", &depth));
+        queued.clear();
+        VisibleObjectsBoundsInfo bounds;
+        sm->_findVisibleObjects(&cam, &bounds, false);
+        sm->getRenderQueue()->clear();
+
+        if (depth == 0)
+            expected = queued;
+        EXPECT_EQ(expected, queued);
+    }
+
+    // the order depends on the child node storage, the set does not
+    StringVector visible;
+    for (int i = 4; i < 12; ++i)
+        visible.push_back(StringConverter::toString(i));
+    std::sort(visible.begin(), visible.end());
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(visible, expected);
+
+    sm->clearScene();
+    for (size_t i = 0; i < objects.size(); ++i)
+        OGRE_DELETE objects[i];
+}
+
+TEST(SceneManager,transformPool)
+{
+    Root root;
+    SceneManager* sm = root.createSceneManager(ST_GENERIC);
+
+    SceneNode* parent = sm->getRootSceneNode()->createChildSceneNode(Vector3(1, 0, 0));
+    SceneNode* child = parent->createChildSceneNode(Vector3(0, 1, 0));
+
+    bool enable = true;
+    ASSERT_TRUE(sm->setOption("TransformPool", &enable));
+    EXPECT_TRUE(child->_getTransformPool());
+
+    SceneNode* leaf = child->createChildSceneNode(Vector3(0, 0, 1));
+    EXPECT_TRUE(leaf->_getTransformPool());
+
+    sm->_updateSceneGraph(0);
+    EXPECT_EQ(Vector3(1, 1, 1), leaf->_getDerivedPosition());
+
+    // moving a subtree to another depth keeps it in the pool
+    child->removeChild(leaf);
+    EXPECT_FALSE(leaf->_getTransformPool());
+    sm->getRootSceneNode()->addChild(leaf);
+    sm->_updateSceneGraph(0);
+    EXPECT_EQ(Vector3(0, 0, 1), leaf->_getDerivedPosition());
+
+    // references to derived values survive other nodes joining and leaving the pool
+    const Vector3& leafPosition = leaf->_getDerivedPosition();
+    vector<SceneNode*>::type others;
+    for (int i = 0; i < 1000; ++i)
+        others.push_back(sm->getRootSceneNode()->createChildSceneNode(Vector3(Real(i), 0, 0)));
+    for (size_t i = 0; i < others.size(); i += 2)
+        sm->destroySceneNode(others[i]);
+    EXPECT_EQ(&leafPosition, &leaf->_getDerivedPosition());
+    EXPECT_EQ(Vector3(0, 0, 1), leafPosition);
+    sm->_updateSceneGraph(0);
+    EXPECT_EQ(Vector3(999, 0, 0), others.back()->_getDerivedPosition());
+
+    enable = false;
+    ASSERT_TRUE(sm->setOption("TransformPool", &enable));
+    EXPECT_FALSE(leaf->_getTransformPool());
+    EXPECT_EQ(Vector3(0, 0, 1), leaf->_getDerivedPosition());
+}
+
+TEST(GpuProgramParameters,unchangedAutoConstantsAreSkipped)
+{
+    Root root;
+    GpuLogicalBufferStructPtr floatLogical(OGRE_NEW GpuLogicalBufferStruct());
+    GpuLogicalBufferStructPtr otherLogical(OGRE_NEW GpuLogicalBufferStruct());
+    GpuProgramParameters params;
+    params._setLogicalIndexes(floatLogical, otherLogical, otherLogical, otherLogical, otherLogical);
+    params.setAutoConstant(0, GpuProgramParameters::ACT_WORLD_MATRIX);
+    params.setAutoConstant(4, GpuProgramParameters::ACT_AMBIENT_LIGHT_COLOUR);
+
+    AutoParamDataSource source;
+    Matrix4 world = Matrix4::IDENTITY;
+    source.setWorldMatrices(&world, 1);
+    source.setAmbientLightColour(ColourValue::Red);
+
+    params._updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(2u, source._getNumAutoConstantsUpdated());
+    EXPECT_EQ(0u, source._getNumAutoConstantsSkipped());
+
+    // nothing changed since
+    params._updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(2u, source._getNumAutoConstantsUpdated());
+    EXPECT_EQ(2u, source._getNumAutoConstantsSkipped());
+
+    // only the per object constant is derived from the world matrix
+    world.makeTrans(1, 2, 3);
+    source.setWorldMatrices(&world, 1);
+    params._updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(3u, source._getNumAutoConstantsUpdated());
+    EXPECT_EQ(3u, source._getNumAutoConstantsSkipped());
+    EXPECT_EQ(1.0f, params.getFloatPointer(0)[3]);
+    EXPECT_EQ(1.0f, params.getFloatPointer(params.getAutoConstantEntry(1)->physicalIndex)[0]);
+}
+
+TEST(GpuProgramParameters,constantHandles)
+{
+    GpuNamedConstantsPtr constants(OGRE_NEW GpuNamedConstants());
+    GpuConstantDefinition def;
+    def.constType = GCT_FLOAT4;
+    def.physicalIndex = 4;
+    def.elementSize = 4;
+    def.arraySize = 1;
+    constants->map["colour"] = def;
+    constants->floatBufferSize = 8;
+
+    GpuProgramParameters params;
+    params._setNamedConstants(constants);
+    GpuConstantHandle handle = params.getConstantHandle("colour");
+    ASSERT_TRUE(handle.isValid());
+    params.setNamedConstant(handle, ColourValue(1, 2, 3, 4));
+    EXPECT_EQ(3.0f, params.getFloatPointer(4)[2]);
+
+    EXPECT_THROW(params.getConstantHandle("missing"), InvalidParametersException);
+    params.setIgnoreMissingParams(true);
+    EXPECT_FALSE(params.getConstantHandle("missing").isValid());
+}
+
+TEST(GpuProgramParameters,sharedConstants)
+{
+    GpuNamedConstantsPtr constants(OGRE_NEW GpuNamedConstants());
+    GpuConstantDefinition def;
+    def.constType = GCT_FLOAT4;
+    def.physicalIndex = 0;
+    def.elementSize = 4;
+    def.arraySize = 1;
+    constants->map["colour"] = def;
+    constants->floatBufferSize = 4;
+
+    GpuProgramParameters a, b, c;
+    a._setNamedConstants(constants);
+    c._setNamedConstants(constants);
+    a.setNamedConstant("colour", Vector4(1, 2, 3, 4));
+    c.setNamedConstant("colour", Vector4(1, 2, 3, 4));
+
+    // copies share the buffer until one of them writes
+    b._setNamedConstants(constants);
+    b.copyConstantsFrom(a);
+    EXPECT_EQ(&a.getFloatConstantList()[0], &b.getFloatConstantList()[0]);
+    b.setNamedConstant("colour", Vector4(5, 6, 7, 8));
+    EXPECT_NE(&a.getFloatConstantList()[0], &b.getFloatConstantList()[0]);
+    EXPECT_EQ(1.0f, a.getFloatConstantList()[0]);
+
+    vector<GpuProgramParameters*>::type params;
+    params.push_back(&a);
+    params.push_back(&b);
+    params.push_back(&c);
+    EXPECT_EQ(4 * sizeof(float), GpuProgramParameters::shareIdenticalConstants(params));
+    EXPECT_EQ(&a.getFloatConstantList()[0], &c.getFloatConstantList()[0]);
+    EXPECT_NE(&a.getFloatConstantList()[0], &b.getFloatConstantList()[0]);
+    EXPECT_EQ(0u, GpuProgramParameters::shareIdenticalConstants(params));
+}
+
+TEST(ScriptCompilerManager,compiledScriptCache)
+{
+    Root root;
+    MaterialManager::getSingleton().initialise();
+    ScriptCompilerManager& compilers = ScriptCompilerManager::getSingleton();
+    compilers.setSaveCompiledScriptsToCache(true);
+
+    String script =
+        "abstract material Base { technique { pass { lighting off } } }\n"
+        "material Derived : Base { technique { pass { depth_write off } } }\n";
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream("Cached.material", &script[0], script.size()));
+    compilers.parseScript(stream, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    EXPECT_TRUE(compilers.isScriptCacheDirty());
+
+    DataStreamPtr cache(OGRE_NEW MemoryDataStream(65536));
+    compilers.saveScriptCache(cache);
+    cache->seek(0);
+    compilers.loadScriptCache(cache);
+    EXPECT_FALSE(compilers.isScriptCacheDirty());
+
+    // compiled from the cache, which stays unchanged
+    MaterialManager::getSingleton().remove("Derived");
+    stream->seek(0);
+    compilers.parseScript(stream, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    EXPECT_FALSE(compilers.isScriptCacheDirty());
+
+    MaterialPtr mat = MaterialManager::getSingleton().getByName("Derived");
+    ASSERT_TRUE(mat);
+    Pass* pass = mat->getTechnique(0)->getPass(0);
+    EXPECT_FALSE(pass->getLightingEnabled());
+    EXPECT_FALSE(pass->getDepthWriteEnabled());
+}
+
+TEST(ScriptCompilerManager,corruptScriptCache)
+{
+    Root root;
+    MaterialManager::getSingleton().initialise();
+    ScriptCompilerManager& compilers = ScriptCompilerManager::getSingleton();
+    compilers.setSaveCompiledScriptsToCache(true);
+
+    String script = "material Cached { technique { pass { lighting off } } }\n";
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream("Cached.material", &script[0], script.size()));
+    compilers.parseScript(stream, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    MemoryDataStreamPtr saved(OGRE_NEW MemoryDataStream(65536));
+    compilers.saveScriptCache(saved);
+    size_t savedSize = saved->tell();
+    ASSERT_GT(savedSize, 12u);
+
+    // every truncation is rejected, including those inside a length
+    for (size_t size = 4; size < savedSize; ++size)
+    {
+        DataStreamPtr truncated(OGRE_NEW MemoryDataStream(saved->getPtr(), size));
+        compilers.loadScriptCache(truncated);
+        EXPECT_TRUE(compilers.isScriptCacheDirty()) << size;
+    }
+
+    // a name length beyond the end of the file
+    String corrupt(reinterpret_cast<const char*>(saved->getPtr()), savedSize);
+    uint32 length = 0x7fffffff;
+    memcpy(&corrupt[8], &length, sizeof(length));
+    DataStreamPtr corruptStream(OGRE_NEW MemoryDataStream(&corrupt[0], corrupt.size()));
+    compilers.loadScriptCache(corruptStream);
+    EXPECT_TRUE(compilers.isScriptCacheDirty());
+
+    // the script is compiled from its text again
+    MaterialManager::getSingleton().remove("Cached");
+    stream->seek(0);
+    compilers.parseScript(stream, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    MaterialPtr mat = MaterialManager::getSingleton().getByName("Cached");
+    ASSERT_TRUE(mat);
+    EXPECT_FALSE(mat->getTechnique(0)->getPass(0)->getLightingEnabled());
+}
+
+TEST(ScriptCompilerManager,reloadChangedObjects)
+{
+    Root root;
+    MaterialManager::getSingleton().initialise();
+    ScriptCompilerManager& compilers = ScriptCompilerManager::getSingleton();
+    compilers.setScriptReloadingEnabled(true);
+
+    String script =
+        "material First { technique { pass { lighting off } } }\n"
+        "material Second { technique { pass { depth_write off } } }\n";
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream("Reloaded.material", &script[0], script.size()));
+    compilers.parseScript(stream, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    MaterialPtr first = MaterialManager::getSingleton().getByName("First");
+    MaterialPtr second = MaterialManager::getSingleton().getByName("Second");
+    ASSERT_TRUE(first && second);
+    Technique* secondTechnique = second->getTechnique(0);
+
+    // only the changed material is rebuilt, the moved one is kept
+    String changed =
+        "material First { technique { pass { lighting on } } }\n"
+        "\n"
+        "material Second { technique { pass { depth_write off } } }\n";
+    stream.reset(OGRE_NEW MemoryDataStream("Reloaded.material", &changed[0], changed.size()));
+    EXPECT_EQ(1u, compilers.reloadScript(stream, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME));
+
+    EXPECT_EQ(first, MaterialManager::getSingleton().getByName("First"));
+    EXPECT_TRUE(first->getTechnique(0)->getPass(0)->getLightingEnabled());
+    EXPECT_EQ(secondTechnique, second->getTechnique(0));
+}
@@ -0,0 +1,128 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreLight.h"
+#include "OgreLightClusters.h"
+
+using namespace Ogre;
+
+namespace {
+    Light* createPointLight(SceneManager* sm, const Vector3& position, Real range)
+    {
+        Light* light = sm->createLight();
+        light->setType(Light::LT_POINT);
+        light->setPosition(position);
+        light->setAttenuation(range, 1, 0, 0);
+        return light;
+    }
+
+    /// Right handed projection with a 45 degree field of view
+    Matrix4 makeProjection(Real aspect, Real nearDist, Real farDist)
+    {
+        Real f = 1 / Math::Tan(Degree(22.5f));
+        return Matrix4(
+            f / aspect, 0, 0, 0,
+            0, f, 0, 0,
+            0, 0, (farDist + nearDist) / (nearDist - farDist), 2 * farDist * nearDist / (nearDist - farDist),
+            0, 0, -1, 0);
+    }
+}
+
+TEST(LightClusters,binning)
+{
+    Root root;
+    SceneManager* sm = root.createSceneManager(ST_GENERIC);
+
+    Light* sun = sm->createLight();
+    sun->setType(Light::LT_DIRECTIONAL);
+    LightList lights;
+    lights.push_back(createPointLight(sm, Vector3(0, 0, -10), 1));
+    lights.push_back(sun);
+    // behind the camera
+    lights.push_back(createPointLight(sm, Vector3(0, 0, 10), 1));
+
+    LightClusters clusters("test");
+    clusters.setGrid(4, 4, 8);
+    clusters.build(Matrix4::IDENTITY, makeProjection(1, 1, 100), 1, 100, lights);
+
+    // directional lights first, the light behind the camera is dropped
+    ASSERT_EQ(2u, clusters.getLights().size());
+    EXPECT_EQ(sun, clusters.getLights()[0]);
+    EXPECT_EQ(1u, clusters.getDirectionalLightCount());
+
+    size_t slice = clusters.getSlice(10);
+    EXPECT_EQ(slice, clusters.getSlice(10.5));
+    EXPECT_LT(clusters.getSlice(2), slice);
+    for (size_t s = 0; s < clusters.getSlices(); ++s)
+    {
+        for (size_t y = 0; y < 4; ++y)
+        {
+            for (size_t x = 0; x < 4; ++x)
+            {
+                // the light only covers the centre tiles around its depth
+                bool centre = x >= 1 && x <= 2 && y >= 1 && y <= 2;
+                if (s == slice && centre)
+                {
+                    ASSERT_EQ(1u, clusters.getClusterLightCount(x, y, s));
+                    EXPECT_EQ(1, clusters.getClusterLights(x, y, s)[0]);
+                }
+                else if (s < slice - 1 || s > slice + 1 || !centre)
+                {
+                    EXPECT_EQ(0u, clusters.getClusterLightCount(x, y, s));
+                }
+            }
+        }
+    }
+}
+
+TEST(LightClusters,limits)
+{
+    Root root;
+    SceneManager* sm = root.createSceneManager(ST_GENERIC);
+
+    LightList lights;
+    for (int i = 0; i < 5; ++i)
+        lights.push_back(createPointLight(sm, Vector3(0, 0, -10.0f - i), 2));
+
+    LightClusters clusters("test");
+    clusters.setGrid(2, 2, 4, 2, 4);
+    clusters.build(Matrix4::IDENTITY, makeProjection(1, 1, 100), 1, 100, lights);
+
+    // the nearest lights are kept, the clusters are capped
+    ASSERT_EQ(4u, clusters.getLights().size());
+    EXPECT_EQ(std::find(clusters.getLights().begin(), clusters.getLights().end(), lights[4]),
+        clusters.getLights().end());
+    for (size_t s = 0; s < clusters.getSlices(); ++s)
+        EXPECT_LE(clusters.getClusterLightCount(0, 0, s), 2u);
+    EXPECT_EQ(2u, clusters.getClusterLightCount(0, 0, clusters.getSlice(10)));
+
+    EXPECT_THROW(clusters.setGrid(0, 2, 4), Exception);
+}
@@ -200,11 +200,42 @@ TEST_F(MeshSerializerTests,Skeleton_Version_1_0)
     }
 }
 //--------------------------------------------------------------------------
-TEST_F(MeshSerializerTests,Mesh_Version_1_10)
+TEST_F(MeshSerializerTests,Mesh_Version_1_11)
 {
     testMesh(MESH_VERSION_LATEST);
 }
 //--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_Version_1_11_Embedded)
+{
+    // Buffer data is aligned relative to the start of the mesh, so the mesh is
+    // written the same wherever it is in the stream
+    MeshSerializer serializer;
+    const size_t offset = 3;
+    const size_t size = 4 * 1024 * 1024;
+    DataStreamPtr plain(OGRE_NEW MemoryDataStream(size));
+    serializer.exportMesh(mOrigMesh.get(), plain, MESH_VERSION_LATEST);
+    DataStreamPtr embedded(OGRE_NEW MemoryDataStream(size));
+    embedded->seek(offset);
+    serializer.exportMesh(mOrigMesh.get(), embedded, MESH_VERSION_LATEST);
+
+    size_t meshSize = plain->tell();
+    ASSERT_EQ(meshSize + offset, embedded->tell());
+    const uchar* plainData = static_cast<MemoryDataStream*>(plain.get())->getPtr();
+    const uchar* embeddedData = static_cast<MemoryDataStream*>(embedded.get())->getPtr();
+    EXPECT_EQ(0, memcmp(plainData, embeddedData + offset, meshSize));
+
+    embedded->seek(offset);
+    MeshPtr mesh = MeshManager::getSingleton().create(mMesh->getName() + ".embedded.mesh", mMesh->getGroup());
+    serializer.importMesh(embedded, mesh.get());
+    assertMeshClone(mOrigMesh.get(), mesh.get());
+    MeshManager::getSingleton().remove(mesh);
+}
+//--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_Version_1_10)
+{
+    testMesh(MESH_VERSION_1_10);
+}
+//--------------------------------------------------------------------------
 TEST_F(MeshSerializerTests,Mesh_Version_1_8)
 {
     testMesh(MESH_VERSION_1_8);
@@ -251,6 +282,7 @@ TEST_F(MeshSerializerTests,Mesh_Version_1_2)
             }
             mOrigMesh = mMesh->clone(mMesh->getName() + ".orig.mesh", mMesh->getGroup());
             testMesh_XML();
+            testMesh(MESH_VERSION_1_11);
             testMesh(MESH_VERSION_1_10);
             testMesh(MESH_VERSION_1_8);
             testMesh(MESH_VERSION_1_7);
@@ -0,0 +1,353 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreOptimisedUtil.h"
+#include "OgreFrustum.h"
+#include "OgrePlane.h"
+#include "OgreMath.h"
+#include "OgreMatrix4.h"
+#include "OgreQuaternion.h"
+
+using namespace Ogre;
+
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,CalculateBoxVisibility)
+{
+    const Plane planes[] = {
+        Plane(Vector3::UNIT_X, 0),
+        Plane(Vector3(-1, 1, 0).normalisedCopy(), 10),
+        Plane(Vector3::NEGATIVE_UNIT_Z, 20)
+    };
+    const size_t numPlanes = sizeof(planes) / sizeof(planes[0]);
+
+    float packedPlanes[numPlanes * 4];
+    for (size_t p = 0; p < numPlanes; ++p)
+    {
+        packedPlanes[p * 4 + 0] = planes[p].normal.x;
+        packedPlanes[p * 4 + 1] = planes[p].normal.y;
+        packedPlanes[p * 4 + 2] = planes[p].normal.z;
+        packedPlanes[p * 4 + 3] = planes[p].d;
+    }
+
+    // not a multiple of four nor of 32, to check the padding
+    const size_t numBoxes = 37;
+    vector<AxisAlignedBox>::type boxes;
+    boxes.push_back(AxisAlignedBox());
+    boxes.push_back(AxisAlignedBox(AxisAlignedBox::EXTENT_INFINITE));
+    for (size_t i = boxes.size(); i < numBoxes; ++i)
+    {
+        Vector3 centre(Math::RangeRandom(-40, 40), Math::RangeRandom(-40, 40),
+            Math::RangeRandom(-40, 40));
+        Vector3 halfSize(Math::RangeRandom(0, 10), Math::RangeRandom(0, 10),
+            Math::RangeRandom(0, 10));
+        boxes.push_back(AxisAlignedBox(centre - halfSize, centre + halfSize));
+    }
+
+    float* bounds = static_cast<float*>(OGRE_MALLOC_SIMD(
+        Frustum::getPackedBoundsSize(numBoxes) * sizeof(float), MEMCATEGORY_GENERAL));
+    for (size_t i = 0; i < numBoxes; ++i)
+        Frustum::packBounds(boxes[i], i, bounds);
+
+    uint32 visibility[2] = { 0xFFFFFFFF, 0xFFFFFFFF };
+    OptimisedUtil::getImplementation()->calculateBoxVisibility(
+        packedPlanes, numPlanes, bounds, visibility, numBoxes);
+    OGRE_FREE_SIMD(bounds, MEMCATEGORY_GENERAL);
+
+    for (size_t i = 0; i < numBoxes; ++i)
+    {
+        bool expected = !boxes[i].isNull();
+        for (size_t p = 0; expected && !boxes[i].isInfinite() && p < numPlanes; ++p)
+            expected = planes[p].getSide(boxes[i]) != Plane::NEGATIVE_SIDE;
+
+        EXPECT_EQ(expected, (visibility[i / 32] & (1u << (i % 32))) != 0) << "box " << i;
+    }
+    EXPECT_EQ(0u, visibility[1] >> (numBoxes % 32));
+}
+//--------------------------------------------------------------------------
+// The tests below compare whatever implementation was selected for this CPU
+// (SSE, AVX2, NEON...) against a straightforward evaluation of the same maths.
+static const Real sTolerance = 1e-4f;
+// Quaternion::equals compares the angle between the rotations
+static const Radian sRotationTolerance = Degree(0.1f);
+// normals and extrusion directions may use an approximate reciprocal square root
+static const Real sNormalTolerance = 1e-3f;
+//--------------------------------------------------------------------------
+static Vector3 randomVector(Real range)
+{
+    return Vector3(Math::RangeRandom(-range, range), Math::RangeRandom(-range, range),
+        Math::RangeRandom(-range, range));
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,SoftwareVertexSkinning)
+{
+    const size_t numMatrices = 4;
+    const size_t numWeights = 3;
+    // odd count, stride covers an interleaved position and normal
+    const size_t numVertices = 19;
+    const size_t stride = 6 * sizeof(float);
+
+    Matrix4 matrices[numMatrices];
+    const Matrix4* matrixPtrs[numMatrices];
+    for (size_t i = 0; i < numMatrices; ++i)
+    {
+        Quaternion q(Radian(Math::RangeRandom(0, Math::TWO_PI)), randomVector(1).normalisedCopy());
+        matrices[i].makeTransform(randomVector(10), Vector3::UNIT_SCALE, q);
+        matrixPtrs[i] = &matrices[i];
+    }
+
+    vector<float>::type src(numVertices * 6), dst(numVertices * 6);
+    vector<float>::type weights(numVertices * numWeights);
+    vector<unsigned char>::type indices(numVertices * numWeights);
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        Vector3 pos = randomVector(5), norm = randomVector(1).normalisedCopy();
+        memcpy(&src[v * 6], pos.ptr(), 3 * sizeof(float));
+        memcpy(&src[v * 6 + 3], norm.ptr(), 3 * sizeof(float));
+
+        // first vertex uses a single bone, the others a zero weight too
+        Real w0 = v ? Math::RangeRandom(0, 1) : 1;
+        Real w1 = v ? Math::RangeRandom(0, 1 - w0) : 0;
+        weights[v * numWeights + 0] = w0;
+        weights[v * numWeights + 1] = w1;
+        weights[v * numWeights + 2] = v % 2 ? 1 - w0 - w1 : 0;
+        for (size_t w = 0; w < numWeights; ++w)
+            indices[v * numWeights + w] = static_cast<unsigned char>((v + w) % numMatrices);
+    }
+
+    OptimisedUtil::getImplementation()->softwareVertexSkinning(
+        &src[0], &dst[0], &src[3], &dst[3], &weights[0], &indices[0], matrixPtrs,
+        stride, stride, stride, stride,
+        numWeights * sizeof(float), numWeights, numWeights, numVertices);
+
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        Vector3 pos(&src[v * 6]), norm(&src[v * 6 + 3]);
+        Vector3 expectedPos = Vector3::ZERO, expectedNorm = Vector3::ZERO;
+        for (size_t w = 0; w < numWeights; ++w)
+        {
+            const Matrix4& m = matrices[indices[v * numWeights + w]];
+            Real weight = weights[v * numWeights + w];
+            expectedPos += m.transformAffine(pos) * weight;
+            Matrix3 rotation;
+            m.extract3x3Matrix(rotation);
+            expectedNorm += rotation * norm * weight;
+        }
+        expectedNorm.normalise();
+
+        EXPECT_TRUE(Vector3(&dst[v * 6]).positionEquals(expectedPos, sTolerance)) << "vertex " << v;
+        EXPECT_TRUE(Vector3(&dst[v * 6 + 3]).positionEquals(expectedNorm, sNormalTolerance)) << "vertex " << v;
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,SoftwareVertexMorph)
+{
+    const size_t numVertices = 13;
+    const Real t = 0.3f;
+
+    // packed positions
+    vector<float>::type src1(numVertices * 6), src2(numVertices * 6), dst(numVertices * 6);
+    for (size_t i = 0; i < src1.size(); ++i)
+    {
+        src1[i] = Math::RangeRandom(-10, 10);
+        src2[i] = Math::RangeRandom(-10, 10);
+    }
+    OptimisedUtil::getImplementation()->softwareVertexMorph(t, &src1[0], &src2[0], &dst[0],
+        3 * sizeof(float), 3 * sizeof(float), 3 * sizeof(float), numVertices, false);
+    for (size_t i = 0; i < numVertices * 3; ++i)
+        EXPECT_NEAR(src1[i] + t * (src2[i] - src1[i]), dst[i], sTolerance);
+
+    // positions followed by normals
+    OptimisedUtil::getImplementation()->softwareVertexMorph(t, &src1[0], &src2[0], &dst[0],
+        6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float), numVertices, true);
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        Vector3 expectedPos = Vector3(&src1[v * 6]) + t * (Vector3(&src2[v * 6]) - Vector3(&src1[v * 6]));
+        Vector3 expectedNorm = Vector3(&src1[v * 6 + 3]) +
+            t * (Vector3(&src2[v * 6 + 3]) - Vector3(&src1[v * 6 + 3]));
+        expectedNorm.normalise();
+        EXPECT_TRUE(Vector3(&dst[v * 6]).positionEquals(expectedPos, sTolerance)) << "vertex " << v;
+        EXPECT_TRUE(Vector3(&dst[v * 6 + 3]).positionEquals(expectedNorm, sNormalTolerance)) << "vertex " << v;
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,ConcatenateAffineMatrices)
+{
+    const size_t numMatrices = 5;
+    Matrix4 base;
+    base.makeTransform(randomVector(10), Vector3(2, 3, 4),
+        Quaternion(Radian(1), randomVector(1).normalisedCopy()));
+
+    Matrix4 src[numMatrices], dst[numMatrices];
+    for (size_t i = 0; i < numMatrices; ++i)
+        src[i].makeTransform(randomVector(10), Vector3::UNIT_SCALE,
+            Quaternion(Radian(Math::RangeRandom(0, Math::TWO_PI)), randomVector(1).normalisedCopy()));
+
+    OptimisedUtil::getImplementation()->concatenateAffineMatrices(base, src, dst, numMatrices);
+
+    for (size_t i = 0; i < numMatrices; ++i)
+    {
+        Matrix4 expected = base.concatenateAffine(src[i]);
+        for (size_t r = 0; r < 4; ++r)
+            for (size_t c = 0; c < 4; ++c)
+                EXPECT_NEAR(expected[r][c], dst[i][r][c], sTolerance) << i << " " << r << " " << c;
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,FaceNormalsAndLightFacing)
+{
+    // not a multiple of eight
+    const size_t numTriangles = 21;
+    const size_t numVertices = numTriangles + 2;
+
+    vector<float>::type positions(numVertices * 3);
+    for (size_t i = 0; i < positions.size(); ++i)
+        positions[i] = Math::RangeRandom(-10, 10);
+
+    vector<EdgeData::Triangle>::type triangles(numTriangles);
+    for (size_t i = 0; i < numTriangles; ++i)
+    {
+        // a strip
+        triangles[i].vertIndex[0] = i;
+        triangles[i].vertIndex[1] = i + 1;
+        triangles[i].vertIndex[2] = i + 2;
+    }
+
+    Vector4* faceNormals = static_cast<Vector4*>(
+        OGRE_MALLOC_SIMD(numTriangles * sizeof(Vector4), MEMCATEGORY_GENERAL));
+    OptimisedUtil::getImplementation()->calculateFaceNormals(
+        &positions[0], &triangles[0], faceNormals, numTriangles);
+
+    for (size_t i = 0; i < numTriangles; ++i)
+    {
+        Vector4 expected = Math::calculateFaceNormalWithoutNormalize(
+            Vector3(&positions[i * 3]), Vector3(&positions[i * 3 + 3]), Vector3(&positions[i * 3 + 6]));
+        for (size_t c = 0; c < 4; ++c)
+            EXPECT_NEAR(expected[c], faceNormals[i][c], 1e-2f) << "triangle " << i;
+    }
+
+    const Vector4 lightPos(3, -4, 5, 1);
+    vector<char>::type facings(numTriangles);
+    OptimisedUtil::getImplementation()->calculateLightFacing(
+        lightPos, faceNormals, &facings[0], numTriangles);
+    for (size_t i = 0; i < numTriangles; ++i)
+        EXPECT_EQ(lightPos.dotProduct(faceNormals[i]) > 0, facings[i] != 0) << "triangle " << i;
+
+    OGRE_FREE_SIMD(faceNormals, MEMCATEGORY_GENERAL);
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,ExtrudeVertices)
+{
+    // not a multiple of eight
+    const size_t numVertices = 27;
+    const Real extrudeDist = 100;
+
+    vector<float>::type src(numVertices * 3), dst(numVertices * 3);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = Math::RangeRandom(-10, 10);
+
+    const Vector4 directional(1, -2, 3, 0);
+    OptimisedUtil::getImplementation()->extrudeVertices(
+        directional, extrudeDist, &src[0], &dst[0], numVertices);
+    Vector3 offset = -Vector3(directional.ptr()).normalisedCopy() * extrudeDist;
+    for (size_t v = 0; v < numVertices; ++v)
+        EXPECT_TRUE(Vector3(&dst[v * 3]).positionEquals(Vector3(&src[v * 3]) + offset, sNormalTolerance * extrudeDist))
+            << "vertex " << v;
+
+    const Vector4 point(1, -2, 3, 1);
+    OptimisedUtil::getImplementation()->extrudeVertices(
+        point, extrudeDist, &src[0], &dst[0], numVertices);
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        Vector3 pos(&src[v * 3]);
+        Vector3 expected = pos + (pos - Vector3(point.ptr())).normalisedCopy() * extrudeDist;
+        EXPECT_TRUE(Vector3(&dst[v * 3]).positionEquals(expected, sNormalTolerance * extrudeDist)) << "vertex " << v;
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,BlendTransformKeyFrames)
+{
+    // not a multiple of four
+    const size_t numTransforms = 11;
+
+    vector<float>::type keys(numTransforms * 2 * 12);
+    vector<const float*>::type keyFrames1(numTransforms), keyFrames2(numTransforms);
+    vector<float>::type interpolations(numTransforms), weights(numTransforms);
+    for (size_t i = 0; i < numTransforms * 2; ++i)
+    {
+        Quaternion q(Radian(Math::RangeRandom(-Math::PI, Math::PI)), randomVector(1).normalisedCopy());
+        // both hemispheres, to check the shortest path handling
+        if (i % 3 == 0)
+            q = -q;
+        float* key = &keys[i * 12];
+        key[0] = q.w; key[1] = q.x; key[2] = q.y; key[3] = q.z;
+        Vector3 translate = randomVector(10);
+        key[4] = translate.x; key[5] = translate.y; key[6] = translate.z; key[7] = 0;
+        key[8] = Math::RangeRandom(0.5f, 2); key[9] = Math::RangeRandom(0.5f, 2);
+        key[10] = Math::RangeRandom(0.5f, 2); key[11] = 0;
+    }
+    for (size_t i = 0; i < numTransforms; ++i)
+    {
+        keyFrames1[i] = &keys[i * 24];
+        keyFrames2[i] = &keys[i * 24 + 12];
+        interpolations[i] = i ? Math::UnitRandom() : 0;
+        weights[i] = i % 2 ? Math::UnitRandom() : 1;
+    }
+
+    const Real scales[] = { 1, 0.5f };
+    for (size_t s = 0; s < 2; ++s)
+    {
+        for (size_t path = 0; path < 2; ++path)
+        {
+            bool shortestPath = path != 0;
+            vector<float>::type transforms(numTransforms * 12);
+            OptimisedUtil::getImplementation()->blendTransformKeyFrames(&keyFrames1[0], &keyFrames2[0],
+                &interpolations[0], &weights[0], scales[s], shortestPath, &transforms[0], numTransforms);
+
+            for (size_t i = 0; i < numTransforms; ++i)
+            {
+                const float* k1 = keyFrames1[i];
+                const float* k2 = keyFrames2[i];
+                Real t = interpolations[i], w = weights[i], scl = scales[s];
+
+                Quaternion rotation = Quaternion::nlerp(t, Quaternion(k1[0], k1[1], k1[2], k1[3]),
+                    Quaternion(k2[0], k2[1], k2[2], k2[3]), shortestPath);
+                rotation = Quaternion::nlerp(w, Quaternion::IDENTITY, rotation, shortestPath);
+                Vector3 translate = (Vector3(k1 + 4) + (Vector3(k2 + 4) - Vector3(k1 + 4)) * t) * w * scl;
+                Vector3 scale = Vector3(k1 + 8) + (Vector3(k2 + 8) - Vector3(k1 + 8)) * t;
+                scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * (scl != 1 ? scl : w);
+
+                const float* result = &transforms[i * 12];
+                EXPECT_TRUE(Quaternion(result[0], result[1], result[2], result[3]).equals(rotation, sRotationTolerance))
+                    << "transform " << i;
+                EXPECT_TRUE(Vector3(result + 4).positionEquals(translate, sTolerance)) << "transform " << i;
+                EXPECT_TRUE(Vector3(result + 8).positionEquals(scale, sTolerance)) << "transform " << i;
+            }
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "Threading/OgreParallel.h"
+#include "Threading/OgreWorkStealingQueue.h"
+
+using namespace Ogre;
+
+namespace {
+    struct Square
+    {
+        int* out;
+        Square(int* o) : out(o) {}
+        void operator()(size_t i) const { out[i] = int(i * i); }
+    };
+
+    void checkParallelFor()
+    {
+        int out[1000] = { 0 };
+        parallelFor(10, 1000, Square(out), 16);
+        for (int i = 0; i < 10; ++i)
+            EXPECT_EQ(0, out[i]);
+        for (int i = 10; i < 1000; ++i)
+            EXPECT_EQ(i * i, out[i]);
+
+        // empty range
+        parallelFor(5, 5, Square(out));
+
+        // started in the background and completed later
+        int started[100] = { 0 };
+        ParallelJobPtr job(OGRE_NEW ParallelForJob<Square>(0, 100, Square(started), 8));
+        ParallelJob::start(job);
+        job->complete();
+        EXPECT_TRUE(job->isComplete());
+        for (int i = 0; i < 100; ++i)
+            EXPECT_EQ(i * i, started[i]);
+    }
+
+    /// Records the order tasks complete in
+    struct StampTask : public TaskGraph::Task
+    {
+        AtomicScalar<int>* clock;
+        int stamp;
+        StampTask() : clock(0), stamp(-1) {}
+        void execute() { stamp = (*clock)++; }
+    };
+
+    void checkTaskGraph()
+    {
+        // a diamond feeding a chain
+        AtomicScalar<int> clock(0);
+        StampTask tasks[6];
+        TaskGraph graph;
+        TaskGraph::TaskID ids[6];
+        for (int i = 0; i < 6; ++i)
+        {
+            tasks[i].clock = &clock;
+            ids[i] = graph.addTask(&tasks[i]);
+        }
+        graph.addDependency(ids[1], ids[0]);
+        graph.addDependency(ids[2], ids[0]);
+        graph.addDependency(ids[3], ids[1]);
+        graph.addDependency(ids[3], ids[2]);
+        graph.addDependency(ids[4], ids[3]);
+        EXPECT_EQ(6u, graph.getTaskCount());
+
+        for (int run = 0; run < 2; ++run)
+        {
+            clock.store(0);
+            graph.run();
+            EXPECT_EQ(6, clock.load());
+            EXPECT_LT(tasks[0].stamp, tasks[1].stamp);
+            EXPECT_LT(tasks[0].stamp, tasks[2].stamp);
+            EXPECT_LT(tasks[1].stamp, tasks[3].stamp);
+            EXPECT_LT(tasks[2].stamp, tasks[3].stamp);
+            EXPECT_LT(tasks[3].stamp, tasks[4].stamp);
+            EXPECT_NE(-1, tasks[5].stamp);
+        }
+
+        graph.addDependency(ids[0], ids[4]);
+        EXPECT_THROW(graph.run(), Exception);
+    }
+}
+
+TEST(Parallel,withoutRoot)
+{
+    checkParallelFor();
+    checkTaskGraph();
+}
+
+TEST(Parallel,defaultWorkQueue)
+{
+    Root root;
+    root.getWorkQueue()->startup();
+    checkParallelFor();
+    checkTaskGraph();
+}
+
+TEST(Parallel,workStealingQueue)
+{
+    Root root;
+    WorkStealingQueue* queue = OGRE_NEW WorkStealingQueue("Test");
+    root.setWorkQueue(queue);
+    queue->setWorkerThreadCount(4);
+    queue->startup();
+    checkParallelFor();
+    checkTaskGraph();
+}
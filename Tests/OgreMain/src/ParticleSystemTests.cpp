@@ -0,0 +1,134 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreParticleSystemManager.h"
+#include "OgreParticleSystem.h"
+#include "OgreParticleEmitter.h"
+#include "OgreParticleEmitterFactory.h"
+#include "OgreParticle.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreStringConverter.h"
+#include "Threading/OgreWorkStealingQueue.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Emits from its position with all the randomised properties of the base class
+    class TestEmitter : public ParticleEmitter
+    {
+    public:
+        TestEmitter(ParticleSystem* psys) : ParticleEmitter(psys) { mType = "Test"; }
+
+        unsigned short _getEmissionCount(Real timeElapsed)
+        {
+            return genConstantEmissionCount(timeElapsed);
+        }
+        void _initParticle(Particle* p)
+        {
+            ParticleEmitter::_initParticle(p);
+            p->mPosition = getPosition();
+            genEmissionDirection(p->mPosition, p->mDirection);
+            genEmissionVelocity(p->mDirection);
+            p->mTimeToLive = p->mTotalTimeToLive = genEmissionTTL();
+            genEmissionColour(p->mColour);
+        }
+    };
+
+    class TestEmitterFactory : public ParticleEmitterFactory
+    {
+    public:
+        String getName() const { return "Test"; }
+        ParticleEmitter* createEmitter(ParticleSystem* psys)
+        {
+            ParticleEmitter* e = OGRE_NEW TestEmitter(psys);
+            mEmitters.push_back(e);
+            return e;
+        }
+    };
+
+    /// Runs a few frames of several systems and returns the state of all particles
+    vector<Vector4>::type simulate(Root* root, bool parallel)
+    {
+        ParticleSystemManager& psm = ParticleSystemManager::getSingleton();
+        psm.setParallelUpdateEnabled(parallel);
+
+        SceneManager* sm = root->createSceneManager(ST_GENERIC);
+        for (int i = 0; i < 20; ++i)
+        {
+            ParticleSystem* ps = sm->createParticleSystem("System" + StringConverter::toString(i), 100);
+            ParticleEmitter* e = ps->addEmitter("Test");
+            e->setEmissionRate(50);
+            e->setAngle(Degree(30));
+            e->setParticleVelocity(1, 5);
+            e->setTimeToLive(0.5, 1);
+            e->setColour(ColourValue::Black, ColourValue::White);
+            sm->getRootSceneNode()->createChildSceneNode(Vector3(Real(i), 0, 0))->attachObject(ps);
+        }
+
+        for (int frame = 0; frame < 30; ++frame)
+            psm._updateSystems(Real(1) / 30);
+
+        vector<Vector4>::type state;
+        for (int i = 0; i < 20; ++i)
+        {
+            ParticleSystem* ps = sm->getParticleSystem("System" + StringConverter::toString(i));
+            for (size_t j = 0; j < ps->getNumParticles(); ++j)
+            {
+                Particle* p = ps->getParticle(j);
+                state.push_back(Vector4(p->mPosition.x, p->mPosition.y, p->mPosition.z, p->mTimeToLive));
+                state.push_back(Vector4(p->mDirection.x, p->mDirection.y, p->mDirection.z, p->mColour.r));
+            }
+        }
+        root->destroySceneManager(sm);
+        return state;
+    }
+}
+
+typedef RootWithoutRenderSystemFixture ParticleSystemTests;
+
+TEST_F(ParticleSystemTests, ParallelUpdateDeterministic)
+{
+    TestEmitterFactory factory;
+    ParticleSystemManager::getSingleton().addEmitterFactory(&factory);
+
+    WorkStealingQueue* queue = OGRE_NEW WorkStealingQueue("Test");
+    mRoot->setWorkQueue(queue);
+    queue->setWorkerThreadCount(4);
+    queue->startup();
+
+    vector<Vector4>::type serial = simulate(mRoot, false);
+    EXPECT_FALSE(serial.empty());
+
+    // each system draws from its own random sequence, whichever thread runs it
+    for (int run = 0; run < 3; ++run)
+        EXPECT_TRUE(simulate(mRoot, true) == serial);
+}
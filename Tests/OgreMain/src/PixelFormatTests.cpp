@@ -26,6 +26,12 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "PixelFormatTests.h"
+#include "OgreImage.h"
+#include "OgreDDSCodec.h"
+#include "OgreDataStream.h"
+#include "OgreException.h"
+#include "OgreTimer.h"
+#include "OgreColourValue.h"
 #include <cstdlib>
 #include <iomanip>
 
@@ -220,6 +226,183 @@ TEST_F(PixelFormatTests,BulkConversion)
     testCase(PF_X8B8G8R8, PF_A8B8G8R8);
     testCase(PF_X8B8G8R8, PF_B8G8R8A8);
     testCase(PF_X8B8G8R8, PF_R8G8B8A8);
+    testCase(PF_L8, PF_R8G8B8A8);
+    testCase(PF_FLOAT32_R, PF_FLOAT16_R);
+    testCase(PF_FLOAT32_GR, PF_FLOAT16_GR);
+    testCase(PF_FLOAT32_RGB, PF_FLOAT16_RGB);
+    testCase(PF_FLOAT32_RGBA, PF_FLOAT16_RGBA);
 }
 //--------------------------------------------------------------------------
+TEST_F(PixelFormatTests,ShuffleConversion)
+{
+    const PixelFormat pairs[][2] = {
+        // swizzles
+        {PF_A8R8G8B8, PF_A8B8G8R8},
+        {PF_A8B8G8R8, PF_A8R8G8B8},
+        {PF_R5G6B5, PF_B5G6R5},
+        // luminance
+        {PF_L8, PF_A8R8G8B8},
+        {PF_A4L4, PF_A4R4G4B4},
+        // alpha fill
+        {PF_X8R8G8B8, PF_A8R8G8B8},
+        {PF_R8G8B8, PF_A8R8G8B8},
+    };
+    for(size_t i = 0; i < sizeof(pairs) / sizeof(pairs[0]); i++)
+    {
+        setupBoxes(pairs[i][0], pairs[i][1]);
+        size_t eob = mDst1.getWidth()*PixelUtil::getNumElemBytes(pairs[i][1]);
+
+        // the bit moves must give the same pixels as packColour / unpackColour
+        EXPECT_TRUE(PixelUtil::_shuffleConversion(mSrc, mDst1));
+        naiveBulkPixelConversion(mSrc, mDst2);
+        EXPECT_TRUE(memcmp(mDst1.data, mDst2.data, eob) == 0)
+            << PixelUtil::getFormatName(pairs[i][0]) << "->" << PixelUtil::getFormatName(pairs[i][1]);
+    }
+
+    // channels of different sizes have to be rescaled
+    setupBoxes(PF_L8, PF_L16);
+    EXPECT_FALSE(PixelUtil::_shuffleConversion(mSrc, mDst1));
+}
+//--------------------------------------------------------------------------
+TEST_F(PixelFormatTests,AlphaExpansion)
+{
+    setupBoxes(PF_A8, PF_BYTE_RGBA);
+    PixelUtil::bulkPixelConversion(mSrc, mDst1);
+    for(size_t x = 0; x < mSrc.getWidth(); x++)
+    {
+        float r, g, b, a;
+        PixelUtil::unpackColour(&r, &g, &b, &a, PF_BYTE_RGBA, mTemp + x * 4);
+        EXPECT_EQ(ColourValue(0, 0, 0, mRandomData[x] / 255.0f), ColourValue(r, g, b, a));
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(PixelFormatTests,DISABLED_ConversionThroughput)
+{
+    // run with --gtest_also_run_disabled_tests
+    const PixelFormat pairs[][2] = {
+        {PF_BYTE_RGBA, PF_BYTE_BGRA},
+        {PF_BYTE_BGRA, PF_BYTE_RGBA},
+        {PF_BYTE_RGB, PF_BYTE_RGBA},
+        {PF_FLOAT32_RGBA, PF_FLOAT16_RGBA},
+        {PF_L8, PF_BYTE_RGBA},
+        {PF_A8, PF_BYTE_RGBA},
+    };
+    const uint32 size = 1024;
+    const int iterations = 20;
+    std::vector<uint8> src(size * size * 16), dst(size * size * 16);
+    for(size_t i = 0; i < src.size(); i++)
+        src[i] = mRandomData[i % mSize];
+
+    Timer timer;
+    for(size_t i = 0; i < sizeof(pairs) / sizeof(pairs[0]); i++)
+    {
+        PixelBox srcBox(size, size, 1, pairs[i][0], &src[0]);
+        PixelBox dstBox(size, size, 1, pairs[i][1], &dst[0]);
+        timer.reset();
+        for(int j = 0; j < iterations; j++)
+            PixelUtil::bulkPixelConversion(srcBox, dstBox);
+        double seconds = std::max<unsigned long>(1, timer.getMicroseconds()) / 1e6;
+        std::cout << PixelUtil::getFormatName(pairs[i][0]) << " -> " << PixelUtil::getFormatName(pairs[i][1])
+                  << ": " << size * size * iterations / seconds / 1e6 << " MPixel/s" << std::endl;
+    }
+}
+//--------------------------------------------------------------------------
+
+TEST_F(PixelFormatTests,ScaleInBands)
+{
+    // big enough to be resampled in bands of rows
+    std::vector<uint8> src(256 * 256), dst(512 * 512);
+    for (size_t y = 0; y < 256; y++)
+        for (size_t x = 0; x < 256; x++)
+            src[y * 256 + x] = uint8(x ^ y);
+
+    Image::scale(PixelBox(256, 256, 1, PF_L8, &src[0]), PixelBox(512, 512, 1, PF_L8, &dst[0]),
+                 Image::FILTER_NEAREST);
+    for (size_t y = 0; y < 512; y++)
+        for (size_t x = 0; x < 512; x++)
+            ASSERT_EQ(src[(y / 2) * 256 + x / 2], dst[y * 512 + x]);
 
+    // each pair of rows averages to a row of the scaled image
+    for (size_t y = 0; y < 512; y++)
+        for (size_t x = 0; x < 512; x++)
+            dst[y * 512 + x] = uint8(y / 2);
+    Image::scale(PixelBox(512, 512, 1, PF_L8, &dst[0]), PixelBox(256, 256, 1, PF_L8, &src[0]),
+                 Image::FILTER_BILINEAR);
+    for (size_t y = 0; y < 256; y++)
+        for (size_t x = 0; x < 256; x++)
+            ASSERT_EQ(uint8(y), src[y * 256 + x]);
+}
+//--------------------------------------------------------------------------
+
+TEST_F(PixelFormatTests,RuntimeCompression)
+{
+    std::vector<uint8> red(8 * 8 * 3);
+    for (size_t i = 0; i < red.size(); i += 3)
+    {
+        red[i] = 255;
+        red[i + 1] = red[i + 2] = 0;
+    }
+
+    Image img;
+    img.loadDynamicImage(&red[0], 8, 8, 1, PF_BYTE_RGB);
+    img.generateMipmaps(3);
+    EXPECT_EQ(3u, img.getNumMipmaps());
+
+    Image dxt(img);
+    dxt.compress(PF_DXT1);
+    EXPECT_EQ(PF_DXT1, dxt.getFormat());
+    EXPECT_EQ(3u, dxt.getNumMipmaps());
+    // 8x8 has four blocks, the mipmaps one each
+    EXPECT_EQ(size_t((4 + 1 + 1 + 1) * 8), dxt.getSize());
+    const uint8* block = dxt.getData();
+    for (size_t i = 0; i < 4; i++)
+    {
+        // both endpoints are pure red in RGB565
+        EXPECT_EQ(0x00, block[i * 8]);
+        EXPECT_EQ(0xf8, block[i * 8 + 1]);
+        EXPECT_EQ(0x00, block[i * 8 + 2]);
+        EXPECT_EQ(0xf8, block[i * 8 + 3]);
+    }
+
+    Image etc(img);
+    etc.compress(PF_ETC1_RGB8);
+    EXPECT_EQ(PF_ETC1_RGB8, etc.getFormat());
+    block = etc.getData();
+    EXPECT_EQ(0xff, block[0]);
+    EXPECT_EQ(0x00, block[1]);
+    EXPECT_EQ(0x00, block[2]);
+
+    EXPECT_FALSE(Image::isCompressionSupported(PF_R8G8B8A8));
+    EXPECT_THROW(dxt.compress(PF_DXT5), Exception);
+}
+//--------------------------------------------------------------------------
+
+TEST_F(PixelFormatTests,RuntimeCompressionCache)
+{
+    std::vector<uint8> pixels(16 * 16 * 4);
+    for (size_t i = 0; i < pixels.size(); i++)
+        pixels[i] = uint8(rand());
+
+    Image img;
+    img.loadDynamicImage(&pixels[0], 16, 16, 1, PF_BYTE_RGBA);
+    img.generateMipmaps(4);
+    img.compress(PF_DXT5);
+
+    // the cache is written as DDS, with the blocks as they are
+    DDSCodec::startup();
+    DataStreamPtr stream = img.encode("dds");
+    DDSCodec::shutdown();
+
+    // magic and header
+    const size_t headerSize = 4 + 124;
+    ASSERT_EQ(headerSize + img.getSize(), stream->size());
+    std::vector<uint8> file(stream->size());
+    stream->read(&file[0], file.size());
+    EXPECT_EQ(0, memcmp(&file[0], "DDS ", 4));
+    uint32 mipMapCount;
+    memcpy(&mipMapCount, &file[4 + 24], 4);
+    EXPECT_EQ(5u, mipMapCount);
+    EXPECT_EQ(0, memcmp(&file[4 + 80], "DXT5", 4));
+    EXPECT_EQ(0, memcmp(&file[headerSize], img.getData(), img.getSize()));
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgrePotentiallyVisibleSet.h"
+#include "OgreDataStream.h"
+
+using namespace Ogre;
+
+//--------------------------------------------------------------------------
+TEST(PotentiallyVisibleSetTests,GridCells)
+{
+    PotentiallyVisibleSet pvs;
+    pvs.setGrid(AxisAlignedBox(0, 0, 0, 40, 20, 10), 4, 2, 1);
+    EXPECT_EQ(pvs.getCellCount(), (size_t)8);
+
+    EXPECT_EQ(pvs.getCell(Vector3(5, 5, 5)), (size_t)0);
+    EXPECT_EQ(pvs.getCell(Vector3(35, 15, 5)), (size_t)7);
+    EXPECT_EQ(pvs.getCell(Vector3(-1, 5, 5)), PotentiallyVisibleSet::NO_CELL);
+    EXPECT_EQ(pvs.getCellBounds(5).getMinimum(), Vector3(10, 10, 0));
+    EXPECT_EQ(pvs.getCellBounds(5).getMaximum(), Vector3(20, 20, 10));
+
+    // cells only see themselves until told otherwise
+    EXPECT_TRUE(pvs.isVisible(0, 0));
+    EXPECT_FALSE(pvs.isVisible(0, 7));
+    EXPECT_EQ(pvs.getVisibleCount(0), (size_t)1);
+
+    pvs.setVisible(0, 7);
+    EXPECT_TRUE(pvs.isVisible(0, 7));
+    EXPECT_FALSE(pvs.isVisible(7, 0));
+    EXPECT_EQ(pvs.getVisibleCount(0), (size_t)2);
+}
+//--------------------------------------------------------------------------
+TEST(PotentiallyVisibleSetTests,BoxVisibility)
+{
+    PotentiallyVisibleSet pvs;
+    pvs.setGrid(AxisAlignedBox(0, 0, 0, 40, 20, 10), 4, 2, 1);
+    pvs.setVisible(0, 3);
+
+    EXPECT_TRUE(pvs.isVisible(0, AxisAlignedBox(32, 2, 2, 38, 8, 8)));
+    EXPECT_FALSE(pvs.isVisible(0, AxisAlignedBox(22, 2, 2, 28, 8, 8)));
+    // overlapping a visible cell is enough
+    EXPECT_TRUE(pvs.isVisible(0, AxisAlignedBox(22, 2, 2, 32, 8, 8)));
+    // out of the grid nothing is known, so it may be seen
+    EXPECT_TRUE(pvs.isVisible(0, AxisAlignedBox(22, 2, 2, 28, 8, 18)));
+    EXPECT_FALSE(pvs.isVisible(0, AxisAlignedBox()));
+}
+//--------------------------------------------------------------------------
+TEST(PotentiallyVisibleSetTests,Serialize)
+{
+    StringVector names;
+    names.push_back("Hall");
+    names.push_back("Kitchen");
+    names.push_back("Cellar");
+
+    PotentiallyVisibleSet pvs;
+    pvs.setCellNames(names);
+    pvs.setVisible(0, 1);
+    pvs.setVisible(2, 0);
+
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream(1024));
+    PotentiallyVisibleSetSerializer serializer;
+    serializer.exportPVS(&pvs, stream);
+    stream->seek(0);
+
+    PotentiallyVisibleSet loaded;
+    serializer.importPVS(stream, &loaded);
+
+    EXPECT_FALSE(loaded.isGrid());
+    ASSERT_EQ(loaded.getCellCount(), (size_t)3);
+    EXPECT_EQ(loaded.getCell("Cellar"), (size_t)2);
+    EXPECT_EQ(loaded.getCell("Attic"), PotentiallyVisibleSet::NO_CELL);
+    for (size_t from = 0; from < 3; ++from)
+    {
+        for (size_t to = 0; to < 3; ++to)
+            EXPECT_EQ(loaded.isVisible(from, to), pvs.isVisible(from, to));
+    }
+}
@@ -203,5 +203,60 @@ TEST_F(RadixSortTests,IntVector)
     }
 }
 //--------------------------------------------------------------------------
+class UnsignedInt64SortFunctor
+{
+public:
+    uint64 operator()(const uint64& p) const
+    {
+        return p;
+    }
+};
+//--------------------------------------------------------------------------
+TEST_F(RadixSortTests,UnsignedInt64Vector)
+{
+    std::vector<uint64> container;
+    UnsignedInt64SortFunctor func;
+    RadixSort<std::vector<uint64>, uint64, uint64> sorter;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        // Use both halves, so that every byte pass matters
+        uint64 high = (uint64)Math::RangeRandom(0, UINT_MAX);
+        container.push_back((high << 32) | (uint64)Math::RangeRandom(0, UINT_MAX));
+    }
+
+    sorter.sort(container, func);
 
+    std::vector<uint64>::iterator v = container.begin();
+    uint64 lastValue = *v++;
+    for (;v != container.end(); ++v)
+    {
+        EXPECT_TRUE(*v >= lastValue);
+        lastValue = *v;
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(RadixSortTests,ParallelMatchesSerial)
+{
+    std::vector<float> floats;
+    std::vector<int> ints;
+    for (int i = 0; i < 5000; ++i)
+    {
+        // Few distinct values, so that stability matters
+        floats.push_back((float)(int)Math::RangeRandom(-50, 50));
+        ints.push_back((int)Math::RangeRandom(INT_MIN, INT_MAX));
+    }
+    std::vector<float> serialFloats = floats;
+    std::vector<int> serialInts = ints;
+
+    RadixSort<std::vector<float>, float, float> floatSorter;
+    floatSorter.sort(serialFloats, FloatSortFunctor());
+    // Small chunks, so that there are many of them
+    floatSorter.sortParallel(floats, FloatSortFunctor(), 300);
+    EXPECT_TRUE(floats == serialFloats);
 
+    RadixSort<std::vector<int>, int, int> intSorter;
+    intSorter.sort(serialInts, IntSortFunctor());
+    intSorter.sortParallel(ints, IntSortFunctor(), 300);
+    EXPECT_TRUE(ints == serialInts);
+}
@@ -0,0 +1,218 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRenderQueueSortingGrouping.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgreRenderable.h"
+#include "OgreRenderCommandList.h"
+#include "OgreRenderQueue.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreManualObject.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Renderable at a fixed view depth
+    class DepthRenderable : public Renderable
+    {
+    public:
+        Real depth;
+        MaterialPtr material;
+        LightList lights;
+
+        DepthRenderable(Real d) : depth(d) {}
+        const MaterialPtr& getMaterial(void) const { return material; }
+        void getRenderOperation(RenderOperation&) {}
+        void getWorldTransforms(Matrix4* xform) const { *xform = Matrix4::IDENTITY; }
+        Real getSquaredViewDepth(const Camera*) const { return depth; }
+        const LightList& getLights(void) const { return lights; }
+    };
+
+    /// Records the visits, tells which ones are grouped by pass
+    class RecordingVisitor : public QueuedRenderableVisitor
+    {
+    public:
+        vector<std::pair<const Pass*, Renderable*> >::type visits;
+        const Pass* currentPass;
+        const Pass* skippedPass;
+
+        RecordingVisitor() : currentPass(0), skippedPass(0) {}
+        void visit(RenderablePass* rp) { visits.push_back(std::make_pair(rp->pass, rp->renderable)); }
+        bool visit(const Pass* p) { currentPass = p; return p != skippedPass; }
+        void visit(Renderable* r) { visits.push_back(std::make_pair(currentPass, r)); }
+    };
+}
+
+typedef RootWithoutRenderSystemFixture RenderQueueTests;
+//--------------------------------------------------------------------------
+TEST_F(RenderQueueTests,SortKeyGroupsByPassFrontToBack)
+{
+    MaterialPtr mat = MaterialManager::getSingleton().create("RenderQueueTests",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    Technique* tech = mat->getTechnique(0);
+    const size_t numPasses = 3;
+    Pass* passes[numPasses] = { tech->getPass(0), tech->createPass(), tech->createPass() };
+    for (size_t p = 0; p < numPasses; ++p)
+        passes[p]->_recalculateHash();
+
+    // Enough items for the radix sort path
+    const size_t numRenderables = 2500;
+    vector<DepthRenderable*>::type renderables;
+    QueuedRenderableCollection collection;
+    collection.addOrganisationMode(QueuedRenderableCollection::OM_SORT_KEY);
+    for (size_t i = 0; i < numRenderables; ++i)
+    {
+        renderables.push_back(new DepthRenderable(Math::RangeRandom(0, 1000)));
+        collection.addRenderable(passes[i % numPasses], renderables.back());
+    }
+    collection.sort(0);
+
+    // Requested as a pass group, served by the keyed list
+    RecordingVisitor visitor;
+    collection.acceptVisitor(&visitor, QueuedRenderableCollection::OM_PASS_GROUP);
+    ASSERT_EQ(numRenderables, visitor.visits.size());
+
+    set<const Pass*>::type finishedPasses;
+    for (size_t i = 1; i < visitor.visits.size(); ++i)
+    {
+        const Pass* prev = visitor.visits[i - 1].first;
+        const Pass* pass = visitor.visits[i].first;
+        if (pass != prev)
+        {
+            // Each pass is visited in a single run
+            EXPECT_TRUE(finishedPasses.insert(prev).second);
+            EXPECT_LE(prev->getHash(), pass->getHash());
+        }
+        else
+        {
+            // Depths are quantised to 16 mantissa bits
+            EXPECT_LE(visitor.visits[i - 1].second->getSquaredViewDepth(0),
+                visitor.visits[i].second->getSquaredViewDepth(0) * (1 + 1e-4f));
+        }
+    }
+    EXPECT_EQ(numPasses - 1, finishedPasses.size());
+
+    // Skipping a pass skips its renderables only
+    RecordingVisitor skipping;
+    skipping.skippedPass = passes[1];
+    collection.acceptVisitor(&skipping, QueuedRenderableCollection::OM_SORT_KEY);
+    EXPECT_EQ(numRenderables - numRenderables / numPasses, skipping.visits.size());
+
+    // Removing a pass drops its items
+    collection.removePassGroup(passes[2]);
+    RecordingVisitor removed;
+    collection.acceptVisitor(&removed, QueuedRenderableCollection::OM_SORT_KEY);
+    EXPECT_EQ(numRenderables - numRenderables / numPasses, removed.visits.size());
+
+    collection.clear();
+    for (size_t i = 0; i < numRenderables; ++i)
+        delete renderables[i];
+    MaterialManager::getSingleton().remove(mat->getHandle());
+}
+//--------------------------------------------------------------------------
+TEST_F(RenderQueueTests,CommandListFollowsGroupContents)
+{
+    MaterialPtr mat = MaterialManager::getSingleton().create("RenderQueueTests",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    mat->load();
+    Technique* tech = mat->getTechnique(0);
+
+    DepthRenderable first(1), second(2);
+    first.material = mat;
+    second.material = mat;
+    RenderQueueGroup group(0, false, false, false);
+
+    // Queueing the same renderables gives the same hash
+    group.addRenderable(&first, tech, 0);
+    group.addRenderable(&second, tech, 0);
+    uint32 hash = group.getContentHash();
+    group.clear();
+    EXPECT_EQ(0u, group.getContentHash());
+    group.addRenderable(&first, tech, 0);
+    group.addRenderable(&second, tech, 0);
+    EXPECT_EQ(hash, group.getContentHash());
+
+    // But not in another order or priority
+    group.clear();
+    group.addRenderable(&second, tech, 0);
+    group.addRenderable(&first, tech, 0);
+    EXPECT_NE(hash, group.getContentHash());
+    group.clear();
+    group.addRenderable(&first, tech, 0);
+    group.addRenderable(&second, tech, 1);
+    EXPECT_NE(hash, group.getContentHash());
+    group.clear();
+
+    RenderCommandList commandList;
+    commandList.beginRecording(hash);
+    commandList.recordPass(tech->getPass(0));
+    commandList.recordRenderable(&first, true, true, 0);
+    commandList.recordRenderable(&second, true, true, 0);
+    EXPECT_FALSE(commandList.isValidFor(hash));
+    commandList.endRecording();
+    EXPECT_EQ(3u, commandList.getCommands().size());
+    EXPECT_TRUE(commandList.isValidFor(hash));
+    EXPECT_FALSE(commandList.isValidFor(hash + 1));
+
+    // Any new, removed or rehashed pass requires recording again
+    tech->createPass();
+    EXPECT_FALSE(commandList.isValidFor(hash));
+
+    commandList.beginRecording(hash);
+    commandList.abortRecording();
+    commandList.recordPass(tech->getPass(0));
+    EXPECT_TRUE(commandList.getCommands().empty());
+    EXPECT_FALSE(commandList.isValidFor(hash));
+
+    MaterialManager::getSingleton().remove(mat->getHandle());
+}
+//--------------------------------------------------------------------------
+TEST_F(RenderQueueTests,ShadowCasterFilter)
+{
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    ManualObject* dynamicCaster = sceneMgr->createManualObject("Dynamic");
+    ManualObject* staticCaster = sceneMgr->createManualObject("Static");
+    staticCaster->setStaticShadowCaster(true);
+
+    RenderQueue queue;
+    EXPECT_TRUE(queue.isShadowCasterIncluded(dynamicCaster));
+    EXPECT_TRUE(queue.isShadowCasterIncluded(staticCaster));
+
+    queue.setShadowCasterFilter(RenderQueue::SCF_STATIC);
+    EXPECT_FALSE(queue.isShadowCasterIncluded(dynamicCaster));
+    EXPECT_TRUE(queue.isShadowCasterIncluded(staticCaster));
+
+    queue.setShadowCasterFilter(RenderQueue::SCF_DYNAMIC);
+    EXPECT_TRUE(queue.isShadowCasterIncluded(dynamicCaster));
+    EXPECT_FALSE(queue.isShadowCasterIncluded(staticCaster));
+
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+}
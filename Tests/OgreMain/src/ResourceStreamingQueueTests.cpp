@@ -0,0 +1,114 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreResourceStreamingQueue.h"
+#include "OgreMeshManager.h"
+#include "OgreMesh.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Exposes the state of the requests, so that loading can be tested without worker threads
+    class TestStreamingQueue : public ResourceStreamingQueue
+    {
+    public:
+        void setPrepared(BackgroundProcessTicket ticket)
+        {
+            mTickets[ticket]->state = RS_PREPARED;
+        }
+    };
+
+    /// Records completions and cancels another request from within the callback
+    struct CancellingListener : public ResourceBackgroundQueue::Listener
+    {
+        ResourceStreamingQueue* queue;
+        BackgroundProcessTicket cancelTicket;
+        vector<BackgroundProcessTicket>::type completed;
+        vector<bool>::type errors;
+
+        CancellingListener() : queue(0), cancelTicket(0) {}
+
+        void operationCompleted(BackgroundProcessTicket ticket, const BackgroundProcessResult& result)
+        {
+            completed.push_back(ticket);
+            errors.push_back(result.error);
+            if (queue && cancelTicket)
+                queue->cancel(cancelTicket);
+        }
+    };
+}
+
+typedef RootWithoutRenderSystemFixture ResourceStreamingQueueTests;
+
+TEST_F(ResourceStreamingQueueTests, cancelFromListener)
+{
+    TestStreamingQueue queue;
+    queue.setFrameTimeBudget(std::numeric_limits<unsigned long>::max());
+
+    CancellingListener first, second;
+    BackgroundProcessTicket nearTicket = queue.request("Mesh", "knot.mesh", "General",
+        ResourceStreamingQueue::PC_NORMAL, 1, &first);
+    BackgroundProcessTicket farTicket = queue.request("Mesh", "sphere.mesh", "General",
+        ResourceStreamingQueue::PC_NORMAL, 2, &second);
+    queue.setPrepared(nearTicket);
+    queue.setPrepared(farTicket);
+
+    // Loading the near mesh cancels the far one, which must not be loaded after
+    first.queue = &queue;
+    first.cancelTicket = farTicket;
+    queue.update(0);
+
+    ASSERT_EQ(1u, first.completed.size());
+    EXPECT_EQ(nearTicket, first.completed[0]);
+    EXPECT_FALSE(first.errors[0]);
+    EXPECT_TRUE(second.completed.empty());
+    EXPECT_TRUE(queue.isComplete(nearTicket));
+    EXPECT_TRUE(queue.isComplete(farTicket));
+    EXPECT_EQ(0u, queue.getNumPendingResources());
+
+    EXPECT_TRUE(MeshManager::getSingleton().getByName("knot.mesh", "General")->isLoaded());
+    MeshPtr far = MeshManager::getSingleton().getByName("sphere.mesh", "General");
+    EXPECT_TRUE(!far || !far->isLoaded());
+}
+
+TEST_F(ResourceStreamingQueueTests, unknownResourceType)
+{
+    ResourceStreamingQueue queue;
+
+    CancellingListener listener;
+    BackgroundProcessTicket ticket = queue.request("NoSuchType", "knot.mesh", "General",
+        ResourceStreamingQueue::PC_NORMAL, 0, &listener);
+
+    ASSERT_EQ(1u, listener.completed.size());
+    EXPECT_EQ(ticket, listener.completed[0]);
+    EXPECT_TRUE(listener.errors[0]);
+    EXPECT_TRUE(queue.isComplete(ticket));
+    EXPECT_EQ(0u, queue.getNumPendingResources());
+}
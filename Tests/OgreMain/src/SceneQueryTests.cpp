@@ -0,0 +1,128 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreSceneManager.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreSceneQuery.h"
+#include "OgreEntity.h"
+#include "OgreSceneNode.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture SceneQueryTests;
+
+namespace {
+    /// Three robots along the x axis, far enough apart for their boxes not to touch
+    void createRobots(SceneManager* sceneMgr, Entity* robots[3])
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            robots[i] = sceneMgr->createEntity("robot.mesh");
+            SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(i * 500.0f, 0, 0));
+            node->attachObject(robots[i]);
+        }
+        sceneMgr->getRootSceneNode()->_update(true, false);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(SceneQueryTests, RegionResultsIntoBuffer)
+{
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    Entity* robots[3];
+    createRobots(sceneMgr, robots);
+
+    AxisAlignedBoxSceneQuery* query = sceneMgr->createAABBQuery(AxisAlignedBox(-100, -100, -100, 600, 100, 100));
+    SceneQueryResultMovableVector results;
+    query->execute(results);
+    ASSERT_EQ(2U, results.size());
+    EXPECT_TRUE(std::find(results.begin(), results.end(), robots[0]) != results.end());
+    EXPECT_TRUE(std::find(results.begin(), results.end(), robots[1]) != results.end());
+
+    // Same as the list results
+    SceneQueryResult& listResults = query->execute();
+    EXPECT_EQ(listResults.movables.size(), results.size());
+
+    // The buffer is reused
+    query->setBox(AxisAlignedBox(900, -100, -100, 1100, 100, 100));
+    query->execute(results);
+    ASSERT_EQ(1U, results.size());
+    EXPECT_EQ(robots[2], results[0]);
+
+    AxisAlignedBox boxes[3] = {
+        AxisAlignedBox(-100, -100, -100, 100, 100, 100),
+        AxisAlignedBox(2000, -100, -100, 2100, 100, 100),
+        AxisAlignedBox(-100, -100, -100, 1100, 100, 100)
+    };
+    SceneQueryBatchOffsets offsets;
+    query->executeBatch(boxes, 3, results, offsets);
+    ASSERT_EQ(4U, offsets.size());
+    EXPECT_EQ(1U, offsets[1] - offsets[0]);
+    EXPECT_EQ(0U, offsets[2] - offsets[1]);
+    EXPECT_EQ(3U, offsets[3] - offsets[2]);
+    EXPECT_EQ(robots[0], results[offsets[0]]);
+    EXPECT_EQ(AxisAlignedBox(900, -100, -100, 1100, 100, 100), query->getBox());
+
+    sceneMgr->destroyQuery(query);
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+}
+//--------------------------------------------------------------------------
+TEST_F(SceneQueryTests, RayBatchSortedPerRay)
+{
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    Entity* robots[3];
+    createRobots(sceneMgr, robots);
+
+    Ray rays[2] = {
+        Ray(Vector3(-1000, 50, 0), Vector3::UNIT_X),
+        Ray(Vector3(2000, 50, 0), Vector3::NEGATIVE_UNIT_X)
+    };
+    RaySceneQuery* query = sceneMgr->createRayQuery(Ray());
+    query->setSortByDistance(true, 2);
+    RaySceneQueryResult results;
+    SceneQueryBatchOffsets offsets;
+    query->executeBatch(rays, 2, results, offsets);
+
+    ASSERT_EQ(3U, offsets.size());
+    ASSERT_EQ(2U, offsets[1] - offsets[0]);
+    ASSERT_EQ(2U, offsets[2] - offsets[1]);
+    EXPECT_EQ(robots[0], results[0].movable);
+    EXPECT_EQ(robots[1], results[1].movable);
+    EXPECT_EQ(robots[2], results[2].movable);
+    EXPECT_EQ(robots[1], results[3].movable);
+
+    query->setRay(rays[1]);
+    query->setSortByDistance(true);
+    query->execute(results);
+    ASSERT_EQ(3U, results.size());
+    EXPECT_EQ(robots[0], results[2].movable);
+
+    sceneMgr->destroyQuery(query);
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+}
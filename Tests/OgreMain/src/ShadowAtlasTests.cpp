@@ -0,0 +1,117 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreShadowTextureManager.h"
+
+using namespace Ogre;
+
+namespace
+{
+    bool overlap(const Rect& a, const Rect& b)
+    {
+        return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+    }
+}
+//--------------------------------------------------------------------------
+TEST(ShadowAtlasTests,PowerOfTwoSizes)
+{
+    ShadowAtlasAllocator allocator(3000, 100);
+    EXPECT_EQ(allocator.getAtlasSize(), (uint32)2048);
+    EXPECT_EQ(allocator.getMinRegionSize(), (uint32)64);
+    EXPECT_EQ(allocator.getMaxRegions(), (size_t)1024);
+}
+//--------------------------------------------------------------------------
+TEST(ShadowAtlasTests,RegionsFit)
+{
+    ShadowAtlasAllocator allocator(1024, 64);
+    vector<uint32>::type sizes;
+    sizes.push_back(300);
+    sizes.push_back(512);
+    sizes.push_back(10);
+    sizes.push_back(512);
+    vector<Rect>::type regions;
+    EXPECT_TRUE(allocator.allocate(sizes, regions));
+    ASSERT_EQ(regions.size(), (size_t)4);
+
+    // rounded down, but no smaller than the minimum
+    EXPECT_EQ(regions[0].width(), 256);
+    EXPECT_EQ(regions[1].width(), 512);
+    EXPECT_EQ(regions[2].width(), 64);
+    EXPECT_EQ(regions[3].width(), 512);
+
+    for (size_t i = 0; i < regions.size(); ++i)
+    {
+        EXPECT_EQ(regions[i].width(), regions[i].height());
+        EXPECT_GE(regions[i].left, 0);
+        EXPECT_GE(regions[i].top, 0);
+        EXPECT_LE(regions[i].right, 1024);
+        EXPECT_LE(regions[i].bottom, 1024);
+        // aligned to their size, like quadtree nodes
+        EXPECT_EQ(regions[i].left % regions[i].width(), 0);
+        EXPECT_EQ(regions[i].top % regions[i].height(), 0);
+        for (size_t j = 0; j < i; ++j)
+            EXPECT_FALSE(overlap(regions[i], regions[j]));
+    }
+}
+//--------------------------------------------------------------------------
+TEST(ShadowAtlasTests,LargestShrinkFirst)
+{
+    ShadowAtlasAllocator allocator(1024, 64);
+    vector<uint32>::type sizes(3, 1024);
+    sizes.push_back(128);
+    vector<Rect>::type regions;
+    EXPECT_TRUE(allocator.allocate(sizes, regions));
+
+    EXPECT_EQ(regions[0].width(), 512);
+    EXPECT_EQ(regions[1].width(), 512);
+    EXPECT_EQ(regions[2].width(), 512);
+    EXPECT_EQ(regions[3].width(), 128);
+    for (size_t i = 0; i < regions.size(); ++i)
+    {
+        for (size_t j = 0; j < i; ++j)
+            EXPECT_FALSE(overlap(regions[i], regions[j]));
+    }
+}
+//--------------------------------------------------------------------------
+TEST(ShadowAtlasTests,TooManyRegions)
+{
+    ShadowAtlasAllocator allocator(256, 128);
+    vector<uint32>::type sizes(5, 256);
+    vector<Rect>::type regions;
+    EXPECT_FALSE(allocator.allocate(sizes, regions));
+
+    size_t placed = 0;
+    for (size_t i = 0; i < regions.size(); ++i)
+    {
+        if (regions[i].width() != 0)
+            ++placed;
+    }
+    EXPECT_EQ(placed, (size_t)4);
+}
+//--------------------------------------------------------------------------
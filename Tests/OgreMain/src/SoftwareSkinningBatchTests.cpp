@@ -0,0 +1,261 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreMesh.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreSoftwareSkinningBatch.h"
+#include "OgreWorkQueue.h"
+#include "OgreEntity.h"
+#include "OgreSubEntity.h"
+#include "OgreSubMesh.h"
+#include "OgreMeshManager.h"
+#include "OgreSceneManager.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Positions and normals in one buffer, blend indices and weights in another
+    VertexData* createSource(size_t count)
+    {
+        VertexData* data = OGRE_NEW VertexData();
+        data->vertexCount = count;
+        VertexDeclaration* decl = data->vertexDeclaration;
+        size_t offset = decl->addElement(0, 0, VET_FLOAT3, VES_POSITION).getSize();
+        decl->addElement(0, offset, VET_FLOAT3, VES_NORMAL);
+        offset = decl->addElement(1, 0, VET_UBYTE4, VES_BLEND_INDICES).getSize();
+        decl->addElement(1, offset, VET_FLOAT2, VES_BLEND_WEIGHTS);
+
+        HardwareVertexBufferSharedPtr geom = HardwareBufferManager::getSingleton().createVertexBuffer(
+            decl->getVertexSize(0), count, HardwareBuffer::HBU_STATIC);
+        HardwareVertexBufferSharedPtr blend = HardwareBufferManager::getSingleton().createVertexBuffer(
+            decl->getVertexSize(1), count, HardwareBuffer::HBU_STATIC);
+        data->vertexBufferBinding->setBinding(0, geom);
+        data->vertexBufferBinding->setBinding(1, blend);
+
+        float* pGeom = static_cast<float*>(geom->lock(HardwareBuffer::HBL_DISCARD));
+        unsigned char* pBlend = static_cast<unsigned char*>(blend->lock(HardwareBuffer::HBL_DISCARD));
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (int c = 0; c < 3; ++c)
+                *pGeom++ = float(i % 7) - c;
+            Vector3 n = Vector3(float(i % 3), 1, float(i % 5)).normalisedCopy();
+            *pGeom++ = n.x;
+            *pGeom++ = n.y;
+            *pGeom++ = n.z;
+
+            pBlend[0] = i % 3;
+            pBlend[1] = (i + 1) % 3;
+            pBlend[2] = pBlend[3] = 0;
+            float* pWeight = reinterpret_cast<float*>(pBlend + 4);
+            pWeight[0] = 0.25f + (i % 4) * 0.125f;
+            pWeight[1] = 1 - pWeight[0];
+            pBlend += decl->getVertexSize(1);
+        }
+        geom->unlock();
+        blend->unlock();
+        return data;
+    }
+
+    VertexData* createTarget(size_t count)
+    {
+        VertexData* data = OGRE_NEW VertexData();
+        data->vertexCount = count;
+        size_t offset = data->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION).getSize();
+        data->vertexDeclaration->addElement(0, offset, VET_FLOAT3, VES_NORMAL);
+        data->vertexBufferBinding->setBinding(0, HardwareBufferManager::getSingleton().createVertexBuffer(
+            data->vertexDeclaration->getVertexSize(0), count, HardwareBuffer::HBU_DYNAMIC));
+        return data;
+    }
+
+    /// Scene manager batching the skinning of all entities updated in between
+    class SkinningSceneManager : public SceneManager
+    {
+    public:
+        SkinningSceneManager() : SceneManager("SkinningSceneManager")
+        {
+            bool enable = true;
+            setOption("ParallelSoftwareSkinning", &enable);
+        }
+        const String& getTypeName(void) const
+        {
+            static String name = "SkinningSceneManager";
+            return name;
+        }
+        void beginBatch() { mSoftwareSkinningBatchActive = true; }
+        void endBatch()
+        {
+            mSoftwareSkinningBatch->flush();
+            mSoftwareSkinningBatchActive = false;
+        }
+    };
+
+    void expectSamePositions(const VertexData* a, const VertexData* b)
+    {
+        ASSERT_TRUE(a && b);
+        ASSERT_EQ(a->vertexCount, b->vertexCount);
+        const VertexElement* elemA = a->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        const VertexElement* elemB = b->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        HardwareVertexBufferSharedPtr bufA = a->vertexBufferBinding->getBuffer(elemA->getSource());
+        HardwareVertexBufferSharedPtr bufB = b->vertexBufferBinding->getBuffer(elemB->getSource());
+        EXPECT_FALSE(bufA->isLocked());
+        EXPECT_FALSE(bufB->isLocked());
+
+        unsigned char* pA = static_cast<unsigned char*>(bufA->lock(HardwareBuffer::HBL_READ_ONLY));
+        unsigned char* pB = static_cast<unsigned char*>(bufB->lock(HardwareBuffer::HBL_READ_ONLY));
+        for (size_t i = 0; i < a->vertexCount; ++i)
+        {
+            float* posA;
+            float* posB;
+            elemA->baseVertexPointerToElement(pA + i * bufA->getVertexSize(), &posA);
+            elemB->baseVertexPointerToElement(pB + i * bufB->getVertexSize(), &posB);
+            for (int c = 0; c < 3; ++c)
+                ASSERT_FLOAT_EQ(posA[c], posB[c]) << "vertex " << i;
+        }
+        bufA->unlock();
+        bufB->unlock();
+    }
+
+    void checkBatch()
+    {
+        Matrix4 bones[3];
+        bones[0].makeTransform(Vector3(1, 2, 3), Vector3::UNIT_SCALE, Quaternion(Degree(30), Vector3::UNIT_Y));
+        bones[1].makeTransform(Vector3(-1, 0, 2), Vector3(2, 2, 2), Quaternion(Degree(45), Vector3::UNIT_X));
+        bones[2] = Matrix4::IDENTITY;
+        const Matrix4* blendMatrices[3] = { &bones[0], &bones[1], &bones[2] };
+
+        const size_t counts[2] = { 1000, 37 };
+        VertexData* sources[2];
+        VertexData* expected[2];
+        VertexData* results[2];
+
+        SoftwareSkinningBatch batch;
+        batch.setVerticesPerItem(64);
+        for (int m = 0; m < 2; ++m)
+        {
+            sources[m] = createSource(counts[m]);
+            expected[m] = createTarget(counts[m]);
+            results[m] = createTarget(counts[m]);
+            Mesh::softwareVertexBlend(sources[m], expected[m], blendMatrices, 3, true);
+            batch.addBlend(sources[m], results[m], blendMatrices, 3, true);
+        }
+        EXPECT_FALSE(batch.isEmpty());
+        EXPECT_EQ(counts[0] + counts[1], batch.getVertexCount());
+
+        // the blend matrix array of the caller may change once added
+        blendMatrices[0] = blendMatrices[1] = blendMatrices[2] = 0;
+        batch.flush();
+        EXPECT_TRUE(batch.isEmpty());
+
+        for (int m = 0; m < 2; ++m)
+        {
+            HardwareVertexBufferSharedPtr expectedBuf = expected[m]->vertexBufferBinding->getBuffer(0);
+            HardwareVertexBufferSharedPtr resultBuf = results[m]->vertexBufferBinding->getBuffer(0);
+            EXPECT_FALSE(resultBuf->isLocked());
+            EXPECT_FALSE(sources[m]->vertexBufferBinding->getBuffer(0)->isLocked());
+
+            const float* pExpected = static_cast<const float*>(expectedBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+            const float* pResult = static_cast<const float*>(resultBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+            for (size_t i = 0; i < counts[m] * 6; ++i)
+                ASSERT_FLOAT_EQ(pExpected[i], pResult[i]) << "mesh " << m << " float " << i;
+            expectedBuf->unlock();
+            resultBuf->unlock();
+
+            OGRE_DELETE sources[m];
+            OGRE_DELETE expected[m];
+            OGRE_DELETE results[m];
+        }
+    }
+}
+
+TEST(SoftwareSkinningBatch,flush)
+{
+    Root root;
+    DefaultHardwareBufferManager bufferManager;
+    root.getWorkQueue()->startup();
+    checkBatch();
+}
+
+TEST(SoftwareSkinningBatch,sceneManagerOption)
+{
+    Root root;
+    SceneManager* sm = root.createSceneManager(ST_GENERIC);
+    bool enable = true;
+    EXPECT_TRUE(sm->hasOption("ParallelSoftwareSkinning"));
+    EXPECT_TRUE(sm->setOption("ParallelSoftwareSkinning", &enable));
+    enable = false;
+    EXPECT_TRUE(sm->getOption("ParallelSoftwareSkinning", &enable));
+    EXPECT_TRUE(enable);
+    // only active while finding visible objects
+    EXPECT_EQ(0, sm->_getSoftwareSkinningBatch());
+}
+
+typedef RootWithoutRenderSystemFixture SoftwareSkinningBatchEntities;
+TEST_F(SoftwareSkinningBatchEntities,sharedMesh)
+{
+    SkinningSceneManager sm;
+    Entity* entities[2];
+    for (int e = 0; e < 2; ++e)
+    {
+        entities[e] = sm.createEntity("robot.mesh");
+        // skin in software, without loading the textures of the robot material
+        entities[e]->setMaterialName("BaseWhite");
+        entities[e]->addSoftwareAnimationRequest(false);
+    }
+
+    // both entities read the same source buffers of the mesh
+    sm.beginBatch();
+    for (int e = 0; e < 2; ++e)
+        entities[e]->_updateAnimation();
+    EXPECT_FALSE(sm._getSoftwareSkinningBatch()->isEmpty());
+    sm.endBatch();
+
+    // both in the bind pose
+    if (entities[0]->_getSkelAnimVertexData())
+    {
+        expectSamePositions(entities[0]->_getSkelAnimVertexData(),
+            entities[1]->_getSkelAnimVertexData());
+        expectSamePositions(entities[0]->getMesh()->sharedVertexData,
+            entities[0]->_getSkelAnimVertexData());
+    }
+    for (size_t i = 0; i < entities[0]->getNumSubEntities(); ++i)
+    {
+        SubEntity* sub = entities[0]->getSubEntity(i);
+        if (!sub->_getSkelAnimVertexData())
+            continue;
+        expectSamePositions(sub->_getSkelAnimVertexData(),
+            entities[1]->getSubEntity(i)->_getSkelAnimVertexData());
+        expectSamePositions(sub->getSubMesh()->vertexData, sub->_getSkelAnimVertexData());
+    }
+
+    MeshPtr mesh = entities[0]->getMesh();
+    sm.destroyAllEntities();
+    MeshManager::getSingleton().remove(mesh->getHandle());
+}
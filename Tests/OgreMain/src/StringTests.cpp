@@ -31,6 +31,12 @@ THE SOFTWARE.
 #include "OgreQuaternion.h"
 #include "OgreMatrix4.h"
 #include "OgreColourValue.h"
+#include <clocale>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <locale>
 
 
 using namespace Ogre;
@@ -274,3 +280,122 @@ TEST_F(StringTests,StartsWith)
     EXPECT_FALSE(StringUtil::startsWith(s, "hello", false));
     EXPECT_FALSE(StringUtil::startsWith(s, "", false));
 }
+//--------------------------------------------------------------------------
+namespace {
+    /// Runs f with the C numeric locale, restoring the one set by the fixture
+    template<typename F> void withCLocale(F& f)
+    {
+        std::string previous = setlocale(LC_NUMERIC, NULL);
+        setlocale(LC_NUMERIC, "C");
+        f();
+        setlocale(LC_NUMERIC, previous.c_str());
+    }
+
+    struct CompareStrtod
+    {
+        const char* str;
+        double expected;
+        ptrdiff_t expectedLength;
+        void operator()()
+        {
+            char* end;
+            expected = strtod(str, &end);
+            expectedLength = end - str;
+        }
+    };
+
+    /// Formats as the StringStream fallback would
+    template<typename T> String streamed(T val, int precision = 6)
+    {
+        StringStream stream;
+        stream.imbue(std::locale::classic());
+        stream.precision(precision);
+        stream << val;
+        return stream.str();
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(StringTests,StrtodMatchesRuntime)
+{
+    const char* numbers[] = {
+        "0", "-0", "1", "1.5", "0.1", "-3.14159", ".5", "5.", "  7", "+3", "1.5xyz",
+        // exact fast path limits
+        "123456789012345678", "1e22", "1e-22", "9007199254740992",
+        // rounding beyond the fast path
+        "9007199254740993", "1234567890123456789012", "1e23", "1e-23",
+        "0.30000000000000004", "2.2250738585072014e-308",
+        // denormals, overflow and underflow
+        "4.9406564584124654e-324", "1e-320", "1e400", "-1e400", "1e-400",
+        // handled by the runtime
+        "0x1p3", "inf", "-Infinity",
+        // incomplete exponents end the number before the e
+        "1e", "2e+", "3E-x",
+        // no number
+        "", "abc", "-", "." };
+
+    for (size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); ++i)
+    {
+        CompareStrtod ref = { numbers[i], 0, 0 };
+        withCLocale(ref);
+
+        char* end;
+        double value = StringConverter::_strtod(numbers[i], &end);
+        EXPECT_EQ(ref.expectedLength, end - numbers[i]) << numbers[i];
+        // bitwise, so that the sign of zero counts too
+        EXPECT_EQ(0, memcmp(&ref.expected, &value, sizeof(double))) << numbers[i];
+    }
+
+    const char* nan = "nan";
+    char* end;
+    EXPECT_TRUE(std::isnan(StringConverter::_strtod(nan, &end)));
+    EXPECT_EQ(nan + 3, end);
+}
+//--------------------------------------------------------------------------
+TEST_F(StringTests,FormatMatchesStream)
+{
+    const double values[] = {
+        0, 1, -1, 0.1, 1.0 / 3, 2.0 / 3, 0.5, 1.5, 2.5, 23.454, 123456789, 1e21, 1e-5,
+        -0.0, 1e-310, std::numeric_limits<double>::denorm_min(),
+        std::numeric_limits<double>::max(), std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity() };
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+    {
+        for (int precision = 0; precision <= 17; precision += 3)
+        {
+            EXPECT_EQ(streamed(values[i], precision),
+                StringConverter::toString(values[i], (unsigned short)precision)) << values[i];
+            EXPECT_EQ(streamed(float(values[i]), precision),
+                StringConverter::toString(float(values[i]), (unsigned short)precision)) << values[i];
+        }
+    }
+
+    // round half to even on the binary value, as printf does
+    EXPECT_EQ("0.12", StringConverter::toString(0.125, 2));
+    EXPECT_EQ("0.38", StringConverter::toString(0.375, 2));
+    EXPECT_EQ(streamed(std::numeric_limits<float>::denorm_min()),
+        StringConverter::toString(std::numeric_limits<float>::denorm_min()));
+    EXPECT_EQ("1 2.5 -3", StringConverter::toString(Vector3(1, 2.5, -3)));
+}
+//--------------------------------------------------------------------------
+TEST_F(StringTests,NumbersIgnoreLocale)
+{
+    // a locale with a decimal comma, if the system has one
+    const char* locales[] = { "de_DE.UTF-8", "de_DE", "fr_FR.UTF-8", "German" };
+    std::string previous = setlocale(LC_NUMERIC, NULL);
+    bool found = false;
+    for (size_t i = 0; i < sizeof(locales) / sizeof(locales[0]) && !found; ++i)
+        found = setlocale(LC_NUMERIC, locales[i]) != NULL;
+    if (!found)
+        return;
+
+    EXPECT_EQ(1.5, StringConverter::parseReal("1.5"));
+    EXPECT_EQ(1e30, StringConverter::parseReal("1e30"));
+    EXPECT_EQ(1.5, StringConverter::parseReal("1.50000000000000000000001"));
+    EXPECT_TRUE(StringConverter::isNumber("1.5"));
+    EXPECT_EQ("1.5", StringConverter::toString(1.5f));
+    EXPECT_EQ("0.333333", StringConverter::toString(1.0 / 3));
+    EXPECT_EQ("1.5 -2.25", StringConverter::toString(Vector2(1.5, -2.25)));
+
+    setlocale(LC_NUMERIC, previous.c_str());
+}
@@ -0,0 +1,244 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreFrameListener.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Pixel buffer which drops all uploads
+    class DiscardPixelBuffer : public HardwarePixelBuffer
+    {
+    public:
+        DiscardPixelBuffer(uint32 width, uint32 height, uint32 depth, PixelFormat format)
+            : HardwarePixelBuffer(width, height, depth, format, HBU_STATIC, false, false) {}
+
+        void blitFromMemory(const PixelBox& src, const Box& dstBox) {}
+        void blitToMemory(const Box& srcBox, const PixelBox& dst) {}
+    protected:
+        PixelBox lockImpl(const Box& lockBox, LockOptions options)
+        {
+            mScratch.resize(PixelUtil::getMemorySize(lockBox.getWidth(), lockBox.getHeight(),
+                lockBox.getDepth(), mFormat));
+            return PixelBox(lockBox, mFormat, mScratch.empty() ? 0 : &mScratch[0]);
+        }
+        void unlockImpl(void) {}
+
+        vector<uchar>::type mScratch;
+    };
+
+    /// Texture which is loaded from its image, without a render system
+    class StreamingTestTexture : public Texture
+    {
+    public:
+        StreamingTestTexture(ResourceManager* creator, const String& name, ResourceHandle handle,
+            const String& group, bool isManual, ManualResourceLoader* loader)
+            : Texture(creator, name, handle, group, isManual, loader) {}
+        ~StreamingTestTexture() { unload(); }
+
+        HardwarePixelBufferSharedPtr getBuffer(size_t face, size_t mipmap)
+        {
+            return mSurfaces[face * (mNumMipmaps + 1) + mipmap];
+        }
+    protected:
+        void loadImpl(void)
+        {
+            Image image;
+            image.load(mName, mGroup);
+            ConstImagePtrList images(1, &image);
+            _loadImages(images);
+        }
+        void createInternalResourcesImpl(void)
+        {
+            for (size_t face = 0; face < getNumFaces(); ++face)
+            {
+                for (uint32 mip = 0; mip <= mNumMipmaps; ++mip)
+                {
+                    mSurfaces.push_back(HardwarePixelBufferSharedPtr(OGRE_NEW DiscardPixelBuffer(
+                        std::max<uint32>(mWidth >> mip, 1), std::max<uint32>(mHeight >> mip, 1),
+                        std::max<uint32>(mDepth >> mip, 1), mFormat)));
+                }
+            }
+        }
+        void freeInternalResourcesImpl(void) { mSurfaces.clear(); }
+
+        vector<HardwarePixelBufferSharedPtr>::type mSurfaces;
+    };
+
+    class StreamingTestTextureManager : public TextureManager
+    {
+    public:
+        StreamingTestTextureManager()
+        {
+            ResourceGroupManager::getSingleton()._registerResourceManager(mResourceType, this);
+        }
+        ~StreamingTestTextureManager()
+        {
+            removeAll();
+            ResourceGroupManager::getSingleton()._unregisterResourceManager(mResourceType);
+        }
+
+        PixelFormat getNativeFormat(TextureType ttype, PixelFormat format, int usage) { return format; }
+        bool isHardwareFilteringSupported(TextureType ttype, PixelFormat format, int usage,
+            bool preciseFormatOnly) { return true; }
+
+        size_t getNumMipmapStreams() const { return mMipmapStreams.size(); }
+    protected:
+        Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+            bool isManual, ManualResourceLoader* loader, const NameValuePairList* createParams)
+        {
+            return OGRE_NEW StreamingTestTexture(this, name, handle, group, isManual, loader);
+        }
+    };
+}
+
+class TextureStreamingTests : public RootWithoutRenderSystemFixture
+{
+public:
+    StreamingTestTextureManager* mManager;
+
+    void SetUp()
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+        mManager = OGRE_NEW StreamingTestTextureManager();
+        mManager->setMipmapStreamingInitialSize(16);
+    }
+    void TearDown()
+    {
+        OGRE_DELETE mManager;
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+
+    /// Loads a 256x256 texture with 9 mipmaps, as small as streaming allows
+    TexturePtr loadStreamed()
+    {
+        TexturePtr texture = mManager->create("flare_alpha.dds", "General");
+        texture->setMipmapStreamed(true);
+        texture->load();
+        return texture;
+    }
+
+    /// Lets the next update read the images which no worker read in time
+    void nextFrame()
+    {
+        FrameEvent evt;
+        mRoot->_fireFrameRenderingQueued(evt);
+    }
+};
+
+TEST_F(TextureStreamingTests, DesiredSkipFromScreenSize)
+{
+    TexturePtr texture = loadStreamed();
+    EXPECT_EQ(4, texture->getMipmapSkip());
+    EXPECT_EQ(4, texture->getMaxMipmapSkip());
+
+    // Without any screen size the desired skip is left to the owner
+    texture->setDesiredMipmapSkip(1);
+    texture->_updateDesiredMipmapSkip();
+    EXPECT_EQ(1, texture->getDesiredMipmapSkip());
+
+    // 256 texels over at most 50 pixels
+    texture->_notifyScreenSize(20);
+    texture->_notifyScreenSize(50);
+    texture->_updateDesiredMipmapSkip();
+    EXPECT_EQ(2, texture->getDesiredMipmapSkip());
+
+    // Not seen since, so the smallest mipmaps do
+    texture->_updateDesiredMipmapSkip();
+    EXPECT_EQ(4, texture->getDesiredMipmapSkip());
+
+    // Larger than the texture
+    texture->_notifyScreenSize(1000);
+    texture->_updateDesiredMipmapSkip();
+    EXPECT_EQ(0, texture->getDesiredMipmapSkip());
+}
+
+TEST_F(TextureStreamingTests, StreamInOnWorker)
+{
+    TexturePtr texture = loadStreamed();
+    texture->setDesiredMipmapSkip(0);
+
+    // The texture keeps its mipmaps until its image is read
+    mManager->_updateMipmapStreaming();
+    EXPECT_EQ(1u, mManager->getNumMipmapStreams());
+    EXPECT_EQ(4, texture->getMipmapSkip());
+
+    nextFrame();
+    mManager->_updateMipmapStreaming();
+    EXPECT_EQ(3, texture->getMipmapSkip());
+    EXPECT_EQ(32u, texture->getWidth());
+    EXPECT_TRUE(texture->isLoaded());
+}
+
+TEST_F(TextureStreamingTests, DropOnWorkerOverBudget)
+{
+    TexturePtr texture = loadStreamed();
+    texture->setDesiredMipmapSkip(2);
+    for (int i = 0; i < 2; ++i)
+    {
+        mManager->_updateMipmapStreaming();
+        nextFrame();
+    }
+    mManager->_updateMipmapStreaming();
+    ASSERT_EQ(2, texture->getMipmapSkip());
+
+    // Over budget the largest mipmap is dropped, also after reading the image
+    mManager->setMipmapStreamingBudget(1);
+    mManager->_updateMipmapStreaming();
+    EXPECT_EQ(1u, mManager->getNumMipmapStreams());
+    EXPECT_EQ(2, texture->getMipmapSkip());
+
+    nextFrame();
+    mManager->_updateMipmapStreaming();
+    EXPECT_EQ(3, texture->getMipmapSkip());
+}
+
+TEST_F(TextureStreamingTests, SmallestTexturesLeftAlone)
+{
+    // As small as the initial size allows, and without any mipmaps in the image
+    TexturePtr streamed = loadStreamed();
+    TexturePtr plain = mManager->create("particle.dds", "General");
+    plain->setMipmapStreamed(true);
+    plain->load();
+    EXPECT_EQ(0, plain->getMaxMipmapSkip());
+
+    mManager->setMipmapStreamingBudget(1);
+    for (int i = 0; i < 3; ++i)
+    {
+        mManager->_updateMipmapStreaming();
+        EXPECT_EQ(0u, mManager->getNumMipmapStreams());
+        nextFrame();
+    }
+    EXPECT_EQ(4, streamed->getMipmapSkip());
+    EXPECT_EQ(0, plain->getMipmapSkip());
+}
@@ -0,0 +1,138 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+
+using namespace Ogre;
+
+#if OGRE_THREAD_SUPPORT
+namespace {
+    /// Holds its requests until released, tracking how many run at once
+    struct GateHandler : public WorkQueue::RequestHandler
+    {
+        AtomicScalar<bool> released;
+        AtomicScalar<int> started;
+        AtomicScalar<int> running;
+        AtomicScalar<int> maxRunning;
+
+        GateHandler() : released(false), started(0), running(0), maxRunning(0) {}
+
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            ++started;
+            int now = ++running;
+            int seen = maxRunning.load();
+            while (now > seen && !maxRunning.compare_exchange_strong(seen, now))
+                seen = maxRunning.load();
+
+            while (!released.load())
+                OGRE_WQ_THREAD_YIELD;
+
+            --running;
+            return OGRE_NEW WorkQueue::Response(req, true, Any());
+        }
+    };
+
+    struct CountHandler : public WorkQueue::RequestHandler
+    {
+        AtomicScalar<int> handled;
+
+        CountHandler() : handled(0) {}
+
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            ++handled;
+            return OGRE_NEW WorkQueue::Response(req, true, Any());
+        }
+    };
+}
+
+TEST(WorkQueue,channelWorkerLimit)
+{
+    Root root;
+    DefaultWorkQueueBase* queue = dynamic_cast<DefaultWorkQueueBase*>(root.getWorkQueue());
+    ASSERT_TRUE(queue);
+    queue->setWorkerThreadCount(3);
+    queue->startup();
+
+    GateHandler gate;
+    CountHandler counter;
+    uint16 limited = queue->getChannel("Limited");
+    uint16 other = queue->getChannel("Other");
+    queue->setChannelWorkerLimit(limited, 1);
+    EXPECT_EQ(1u, queue->getChannelWorkerLimit(limited));
+    queue->addRequestHandler(limited, &gate);
+    queue->addRequestHandler(other, &counter);
+
+    for (int i = 0; i < 4; ++i)
+        queue->addRequest(limited, 0, Any());
+
+    while (gate.started.load() < 1)
+        OGRE_WQ_THREAD_YIELD;
+
+    // the other channel still gets the free workers, unless the limited one took them
+    queue->addRequest(other, 0, Any());
+    for (int i = 0; i < 5000 && counter.handled.load() < 1; ++i)
+        OGRE_WQ_THREAD_SLEEP(1);
+
+    // two workers are idle, yet the limited channel keeps waiting
+    int startedWhileHeld = gate.started.load();
+    DefaultWorkQueueBase::ChannelStatistics stats = queue->getChannelStatistics(limited);
+    gate.released.store(true);
+
+    EXPECT_EQ(1, counter.handled.load());
+    EXPECT_EQ(1, startedWhileHeld);
+    EXPECT_EQ(3u, stats.pending);
+    EXPECT_EQ(1u, stats.active);
+    EXPECT_EQ(0u, stats.processed);
+
+    queue->setResponseProcessingTimeLimit(0);
+    while (queue->getChannelStatistics(limited).processed < 4 ||
+           queue->getChannelStatistics(other).processed < 1)
+    {
+        queue->processResponses();
+        OGRE_WQ_THREAD_YIELD;
+    }
+    queue->processResponses();
+
+    stats = queue->getChannelStatistics(limited);
+    EXPECT_EQ(0u, stats.pending);
+    EXPECT_EQ(0u, stats.active);
+    EXPECT_EQ(4u, stats.processed);
+    EXPECT_EQ(1, gate.maxRunning.load());
+    EXPECT_EQ(1u, queue->getChannelStatistics(other).processed);
+
+    queue->resetChannelStatistics();
+    EXPECT_EQ(0u, queue->getChannelStatistics(limited).processed);
+
+    queue->removeRequestHandler(limited, &gate);
+    queue->removeRequestHandler(other, &counter);
+}
+#endif
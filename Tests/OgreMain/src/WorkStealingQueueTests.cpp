@@ -0,0 +1,150 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "Threading/OgreWorkStealingQueue.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Sums a range by splitting it into forked halves
+    struct SumTask : public WorkStealingQueue::Task
+    {
+        WorkStealingQueue* queue;
+        const int* data;
+        size_t count;
+        AtomicScalar<int>* sum;
+
+        SumTask(WorkStealingQueue* q, const int* d, size_t c, AtomicScalar<int>* s)
+            : queue(q), data(d), count(c), sum(s) {}
+
+        void execute()
+        {
+            if (count <= 4)
+            {
+                for (size_t i = 0; i < count; ++i)
+                    *sum += data[i];
+                return;
+            }
+
+            size_t half = count / 2;
+            SumTask left(queue, data, half, sum);
+            SumTask right(queue, data + half, count - half, sum);
+            WorkStealingQueue::TaskGroup group;
+            queue->fork(&left, group);
+            queue->fork(&right, group);
+            queue->join(group);
+        }
+    };
+
+    struct EchoHandler : public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
+    {
+        AtomicScalar<int> handled;
+        int responses;
+        int sum;
+
+        EchoHandler() : handled(0), responses(0), sum(0) {}
+
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            ++handled;
+            return OGRE_NEW WorkQueue::Response(req, true, req->getData());
+        }
+
+        void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+        {
+            ++responses;
+            sum += any_cast<int>(res->getData());
+        }
+    };
+}
+
+TEST(WorkStealingQueue,forkJoin)
+{
+    Root root;
+    WorkStealingQueue* queue = OGRE_NEW WorkStealingQueue("Test");
+    root.setWorkQueue(queue);
+    queue->setWorkerThreadCount(4);
+    queue->startup();
+
+    int data[1000];
+    int expected = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        data[i] = i;
+        expected += i;
+    }
+
+    AtomicScalar<int> sum(0);
+    SumTask task(queue, data, 1000, &sum);
+    WorkStealingQueue::TaskGroup group;
+    queue->fork(&task, group);
+    queue->join(group);
+
+    EXPECT_TRUE(group.isComplete());
+    EXPECT_EQ(expected, sum.load());
+    EXPECT_EQ(queue, WorkStealingQueue::getRootQueue());
+}
+
+TEST(WorkStealingQueue,requests)
+{
+    Root root;
+    WorkStealingQueue* queue = OGRE_NEW WorkStealingQueue("Test");
+    root.setWorkQueue(queue);
+    queue->setWorkerThreadCount(3);
+    queue->startup();
+
+    EchoHandler handler;
+    uint16 channel = queue->getChannel("Test");
+    queue->setChannelPriority(channel, WorkStealingQueue::PRIORITY_HIGH);
+    EXPECT_EQ(WorkStealingQueue::PRIORITY_HIGH, queue->getChannelPriority(channel));
+    queue->addRequestHandler(channel, &handler);
+    queue->addResponseHandler(channel, &handler);
+
+    int expected = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_NE(0u, queue->addRequest(channel, 0, Any(i)));
+        expected += i;
+    }
+
+    // unlimited response processing time, wait for all of them
+    queue->setResponseProcessingTimeLimit(0);
+    while (handler.responses < 100)
+    {
+        queue->processResponses();
+        OGRE_WQ_THREAD_YIELD;
+    }
+
+    EXPECT_EQ(100, handler.handled.load());
+    EXPECT_EQ(expected, handler.sum);
+
+    queue->removeRequestHandler(channel, &handler);
+    queue->removeResponseHandler(channel, &handler);
+}
@@ -250,3 +250,63 @@ TEST_F(ZipArchiveTests,ReadInterleave)
     EXPECT_TRUE(stream2->eof());
 }
 //--------------------------------------------------------------------------
+TEST(IndexedZipArchiveTests,MatchesZipArchive)
+{
+    Ogre::ConfigFile cf;
+    cf.load(Ogre::FileSystemLayer(OGRE_VERSION_NAME).getConfigFilePath("resources.cfg"));
+    Ogre::String testPath = cf.getSettings("Tests").begin()->second+"/misc/ArchiveTest.zip";
+
+    ZipArchive zipArch(testPath, "Zip");
+    zipArch.load();
+    IndexedZipArchive arch(testPath, "IndexedZip");
+    arch.load();
+
+    FileInfoListPtr expected = zipArch.listFileInfo(true, true);
+    FileInfoListPtr vec = arch.listFileInfo(true, true);
+    ASSERT_EQ(expected->size(), vec->size());
+    for (size_t i = 0; i < vec->size(); ++i)
+    {
+        EXPECT_EQ(expected->at(i).filename, vec->at(i).filename);
+        EXPECT_EQ(expected->at(i).path, vec->at(i).path);
+        EXPECT_EQ(expected->at(i).compressedSize, vec->at(i).compressedSize);
+        EXPECT_EQ(expected->at(i).uncompressedSize, vec->at(i).uncompressedSize);
+    }
+
+    EXPECT_TRUE(arch.exists("rootfile2.txt"));
+    EXPECT_TRUE(arch.exists(fileId("level1/materials/scripts/file.material")));
+    EXPECT_FALSE(arch.exists("nonexistent.txt"));
+}
+//--------------------------------------------------------------------------
+TEST(IndexedZipArchiveTests,CachedFileRead)
+{
+    Ogre::ConfigFile cf;
+    cf.load(Ogre::FileSystemLayer(OGRE_VERSION_NAME).getConfigFilePath("resources.cfg"));
+    Ogre::String testPath = cf.getSettings("Tests").begin()->second+"/misc/ArchiveTest.zip";
+
+    IndexedZipArchive arch(testPath, "IndexedZip");
+    arch.load();
+
+    DataStreamPtr stream1 = arch.open("rootfile.txt");
+    EXPECT_EQ((size_t)130, arch.getCacheSize());
+    DataStreamPtr stream2 = arch.open("rootfile.txt");
+    EXPECT_EQ((size_t)130, arch.getCacheSize());
+
+    // evicting the inflated data does not affect open streams
+    arch.setCacheBudget(0);
+    EXPECT_EQ((size_t)0, arch.getCacheSize());
+
+    EXPECT_EQ(String("this is line 1 in file 1"), stream1->getLine());
+    EXPECT_EQ(String("this is line 1 in file 1"), stream2->getLine());
+    EXPECT_EQ(String("this is line 2 in file 1"), stream1->getLine());
+    EXPECT_EQ(String("this is line 3 in file 1"), stream1->getLine());
+    EXPECT_EQ(String("this is line 4 in file 1"), stream1->getLine());
+    EXPECT_EQ(String("this is line 5 in file 1"), stream1->getLine());
+    EXPECT_TRUE(stream1->eof());
+
+    DataStreamPtr stream3 = arch.open("rootfile2.txt");
+    EXPECT_EQ((size_t)0, arch.getCacheSize());
+    EXPECT_EQ(String("this is line 1 in file 2"), stream3->getLine());
+
+    EXPECT_THROW(arch.open("nonexistent.txt"), Exception);
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,366 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __BenchmarkResults_H__
+#define __BenchmarkResults_H__
+
+#include "Ogre.h"
+#include "OgreHardwareTimerQuery.h"
+
+#include <fstream>
+
+/** Records the frame times and render statistics of the tests run in benchmark mode
+ *        @remarks The results are written as JSON, one object per test holding the
+ *            CPU and GPU frame time percentiles in milliseconds and the render
+ *            statistics averaged per frame. A file written this way can be loaded
+ *            back as the baseline of a later run. */
+class BenchmarkResults : public Ogre::GeneralAllocatedObject
+{
+public:
+
+    /// The metrics of a single test by name, e.g. "cpu.p50" or "drawCalls"
+    typedef std::map<Ogre::String, double> Metrics;
+    /// The metrics of each test by title
+    typedef std::map<Ogre::String, Metrics> TestMetrics;
+
+    BenchmarkResults(Ogre::RenderSystem* rs)
+        :mRenderSystem(rs)
+        ,mGpuTimersSupported(true)
+        ,mCurrentQuery(0, 0)
+    {
+    }
+
+    ~BenchmarkResults()
+    {
+        destroyQueries();
+    }
+
+    /** Starts recording a test
+     *        @param title The title of the test */
+    void beginTest(const Ogre::String& title)
+    {
+        mCurrentTitle = title;
+        mCpuTimes.clear();
+        mGpuTimes.clear();
+        mStatSums.clear();
+    }
+
+    /** Starts timing a frame
+     *        @param record Whether this frame counts, false while warming up */
+    void frameStarted(bool record)
+    {
+        if (!record)
+            return;
+
+        mTimer.reset();
+
+        if (!mGpuTimersSupported)
+            return;
+
+        if (mFreeQueries.empty())
+        {
+            Ogre::HardwareTimerQuery* begin = mRenderSystem->createHardwareTimerQuery();
+            Ogre::HardwareTimerQuery* end = begin ? mRenderSystem->createHardwareTimerQuery() : 0;
+            if (!end)
+            {
+                if (begin)
+                    mRenderSystem->destroyHardwareTimerQuery(begin);
+                mGpuTimersSupported = false;
+                return;
+            }
+            mFreeQueries.push_back(QueryPair(begin, end));
+        }
+
+        mCurrentQuery = mFreeQueries.back();
+        mFreeQueries.pop_back();
+        mCurrentQuery.first->queryTimestamp();
+    }
+
+    /** Finishes timing a frame, after its buffers were swapped
+     *        @param record Whether this frame counts, false while warming up */
+    void frameEnded(bool record)
+    {
+        if (!record)
+            return;
+
+        mCpuTimes.push_back(mTimer.getMicroseconds() / 1000.0);
+
+        if (mCurrentQuery.first)
+        {
+            mCurrentQuery.second->queryTimestamp();
+            mPendingQueries.push_back(mCurrentQuery);
+            mCurrentQuery = QueryPair(0, 0);
+        }
+        resolveQueries(false);
+
+        // the statistics of the frame just swapped
+        const Ogre::RenderSystem::RenderStats& stats = mRenderSystem->getRenderStats();
+        mStatSums["drawCalls"] += stats.drawCalls;
+        mStatSums["programBinds"] += stats.programBinds;
+        mStatSums["textureBinds"] += stats.textureBinds;
+        mStatSums["stateChanges"] += stats.stateChanges;
+        mStatSums["uniformBytes"] += stats.uniformBytes;
+        mStatSums["lockBytesStatic"] += stats.bufferLockBytes[Ogre::HardwareBuffer::LU_STATIC];
+        mStatSums["lockBytesDynamic"] += stats.bufferLockBytes[Ogre::HardwareBuffer::LU_DYNAMIC];
+        mStatSums["lockBytesDiscardable"] += stats.bufferLockBytes[Ogre::HardwareBuffer::LU_DISCARDABLE];
+        mStatSums["vertexArrayBinds"] += stats.vertexArrayBinds;
+        mStatSums["renderTargetSwitches"] += stats.renderTargetSwitches;
+        mStatSums["renderTargetUpdates"] += stats.renderTargetUpdates;
+        mStatSums["renderTargetsSkipped"] += stats.renderTargetsSkipped;
+    }
+
+    /** Finishes recording the current test and stores its metrics */
+    void endTest()
+    {
+        // wait for the GPU to finish the remaining frames
+        resolveQueries(true);
+        destroyQueries();
+
+        if (mCpuTimes.empty())
+            return;
+
+        Metrics& metrics = mResults[mCurrentTitle];
+        addPercentiles(metrics, "cpu", mCpuTimes);
+        if (!mGpuTimes.empty())
+            addPercentiles(metrics, "gpu", mGpuTimes);
+
+        for (Metrics::iterator i = mStatSums.begin(); i != mStatSums.end(); ++i)
+            metrics[i->first] = i->second / mCpuTimes.size();
+    }
+
+    const TestMetrics& getResults() const { return mResults; }
+
+    /** Writes the results to a JSON file
+     *        @param filename The file to write
+     *        @param renderSystem The name of the render system the tests ran on
+     *        @param frames The number of frames recorded per test */
+    void writeToFile(const Ogre::String& filename, const Ogre::String& renderSystem, size_t frames) const
+    {
+        std::ofstream out(filename.c_str());
+        if (!out.is_open())
+            return;
+
+        out << "{\n";
+        out << "  \"renderSystem\": \"" << escape(renderSystem) << "\",\n";
+        out << "  \"frames\": " << frames << ",\n";
+        out << "  \"tests\": {\n";
+        for (TestMetrics::const_iterator i = mResults.begin(); i != mResults.end(); ++i)
+        {
+            if (i != mResults.begin())
+                out << ",\n";
+            out << "    \"" << escape(i->first) << "\": {\n";
+            for (Metrics::const_iterator j = i->second.begin(); j != i->second.end(); ++j)
+            {
+                if (j != i->second.begin())
+                    out << ",\n";
+                out << "      \"" << j->first << "\": " << j->second;
+            }
+            out << "\n    }";
+        }
+        out << "\n";
+        out << "  }\n";
+        out << "}\n";
+    }
+
+    /** Loads the results of an earlier run, as written by writeToFile
+     *        @param filename The file to read
+     *        @param results Gets the metrics of each test
+     *        @return false if the file could not be opened */
+    static bool loadFromFile(const Ogre::String& filename, TestMetrics& results)
+    {
+        std::ifstream in(filename.c_str());
+        if (!in.is_open())
+            return false;
+
+        // the objects enclosing the current line, "" for the outermost
+        std::vector<Ogre::String> scope;
+        Ogre::String line;
+        while (std::getline(in, line))
+        {
+            Ogre::StringUtil::trim(line);
+            if (line.empty())
+                continue;
+
+            if (line[0] == '}')
+            {
+                if (!scope.empty())
+                    scope.pop_back();
+                continue;
+            }
+
+            size_t pos = 0;
+            Ogre::String key = line[0] == '"' ? readString(line, pos) : "";
+
+            if (line[line.size() - 1] == '{')
+            {
+                scope.push_back(key);
+            }
+            else if (scope.size() == 3 && scope[1] == "tests")
+            {
+                pos = line.find(':', pos);
+                if (pos != Ogre::String::npos)
+                    results[scope[2]][key] = Ogre::StringConverter::parseReal(line.substr(pos + 1));
+            }
+        }
+        return true;
+    }
+
+    /** Compares the results against a baseline
+     *        @param baseline The results of an earlier run
+     *        @param threshold The relative increase over the baseline that is a regression, e.g. 0.1
+     *        @return A description of each regression found, empty if there were none */
+    Ogre::StringVector compare(const TestMetrics& baseline, double threshold) const
+    {
+        // frame times are compared by their median and tail, the statistics by draw calls
+        static const char* compared[] = { "cpu.p50", "cpu.p90", "gpu.p50", "gpu.p90", "drawCalls" };
+
+        Ogre::StringVector regressions;
+        for (TestMetrics::const_iterator i = mResults.begin(); i != mResults.end(); ++i)
+        {
+            TestMetrics::const_iterator base = baseline.find(i->first);
+            if (base == baseline.end())
+                continue;
+
+            for (size_t j = 0; j < sizeof(compared) / sizeof(compared[0]); ++j)
+            {
+                Metrics::const_iterator current = i->second.find(compared[j]);
+                Metrics::const_iterator previous = base->second.find(compared[j]);
+                if (current == i->second.end() || previous == base->second.end() || previous->second <= 0)
+                    continue;
+
+                if (current->second > previous->second * (1 + threshold))
+                {
+                    Ogre::StringStream msg;
+                    msg << i->first << ": " << compared[j] << " " << current->second
+                        << " exceeds baseline " << previous->second;
+                    regressions.push_back(msg.str());
+                }
+            }
+        }
+        return regressions;
+    }
+
+protected:
+
+    typedef std::pair<Ogre::HardwareTimerQuery*, Ogre::HardwareTimerQuery*> QueryPair;
+
+    /** Pulls the GPU times of the finished frames
+     *        @param wait Whether to wait for the frames still outstanding */
+    void resolveQueries(bool wait)
+    {
+        while (!mPendingQueries.empty())
+        {
+            QueryPair& query = mPendingQueries.front();
+            if (!wait && query.second->isStillOutstanding())
+                break;
+
+            Ogre::uint64 begin, end;
+            if (query.first->pullTimestamp(&begin) && query.second->pullTimestamp(&end) && end >= begin)
+                mGpuTimes.push_back((end - begin) / 1000000.0);
+
+            mFreeQueries.push_back(query);
+            mPendingQueries.pop_front();
+        }
+    }
+
+    void destroyQueries()
+    {
+        resolveQueries(true);
+        for (size_t i = 0; i < mFreeQueries.size(); ++i)
+        {
+            mRenderSystem->destroyHardwareTimerQuery(mFreeQueries[i].first);
+            mRenderSystem->destroyHardwareTimerQuery(mFreeQueries[i].second);
+        }
+        mFreeQueries.clear();
+    }
+
+    /** Adds the percentiles of a set of frame times
+     *        @param metrics The metrics to add to
+     *        @param prefix Prefix of the metric names
+     *        @param times The frame times, sorted in place */
+    static void addPercentiles(Metrics& metrics, const Ogre::String& prefix, std::vector<double>& times)
+    {
+        std::sort(times.begin(), times.end());
+        metrics[prefix + ".p50"] = percentile(times, 50);
+        metrics[prefix + ".p90"] = percentile(times, 90);
+        metrics[prefix + ".p99"] = percentile(times, 99);
+        metrics[prefix + ".max"] = times.back();
+    }
+
+    /// Nearest rank percentile of sorted values
+    static double percentile(const std::vector<double>& sorted, size_t p)
+    {
+        size_t rank = (p * sorted.size() + 99) / 100;
+        return sorted[rank > 0 ? rank - 1 : 0];
+    }
+
+    static Ogre::String escape(const Ogre::String& str)
+    {
+        Ogre::String out;
+        for (size_t i = 0; i < str.size(); ++i)
+        {
+            if (str[i] == '"' || str[i] == '\\')
+                out += '\\';
+            out += str[i];
+        }
+        return out;
+    }
+
+    /// Reads the quoted string starting at pos, leaving pos after its closing quote
+    static Ogre::String readString(const Ogre::String& line, size_t& pos)
+    {
+        Ogre::String out;
+        for (pos = 1; pos < line.size() && line[pos] != '"'; ++pos)
+        {
+            if (line[pos] == '\\' && pos + 1 < line.size())
+                ++pos;
+            out += line[pos];
+        }
+        ++pos;
+        return out;
+    }
+
+    Ogre::RenderSystem* mRenderSystem;
+    Ogre::Timer mTimer;
+    bool mGpuTimersSupported;
+
+    // GPU timestamps around each frame
+    QueryPair mCurrentQuery;
+    std::deque<QueryPair> mPendingQueries;
+    std::vector<QueryPair> mFreeQueries;
+
+    // samples of the current test
+    Ogre::String mCurrentTitle;
+    std::vector<double> mCpuTimes;
+    std::vector<double> mGpuTimes;
+    Metrics mStatSums;
+
+    TestMetrics mResults;
+};
+
+#endif
@@ -46,6 +46,7 @@ extern char ***_NSGetArgv(void);
 #endif
 
 class TestBatch;
+class BenchmarkResults;
 using namespace Ogre;
 
 typedef std::map<String, OgreBites::SamplePlugin *> PluginMap;
@@ -95,6 +96,10 @@ class TestContext : public OgreBites::SampleContext
     /** Called after tests successfully complete, generates output */
     virtual void finishedTests();
 
+    /** Called instead of finishedTests in benchmark mode, writes the results
+     *        and compares them against the baseline if one was given */
+    virtual void finishedBenchmarks();
+
     /** Sets the timstep value
      *        @param timestep The time to simulate elapsed between each frame
      *        @remarks Use with care! Screenshots produced at different timesteps
@@ -141,6 +146,9 @@ class TestContext : public OgreBites::SampleContext
     /// Info about the running batch of tests
     TestBatch* mBatch;
 
+    /// Frame times and statistics of the tests, in benchmark mode
+    BenchmarkResults* mBenchmark;
+
     // A structure to map plugin names to class types
     PluginMap mPluginNameMap;
 
@@ -167,6 +175,14 @@ class TestContext : public OgreBites::SampleContext
     String mTestSetName;
     // Location to output a test summary (used for CTest)
     String mSummaryOutputDir;
+    // Run the tests as benchmarks instead of taking screenshots?
+    bool mBenchmarkMode;
+    // Frames to record per test in benchmark mode
+    unsigned int mBenchmarkFrames;
+    // Benchmark results to compare against
+    String mBenchmarkBaseline;
+    // Relative slowdown over the baseline that fails a benchmark
+    Real mBenchmarkThreshold;
 };
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE && defined(__OBJC__)
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "TestResultWriter.h"
 #include "HTMLWriter.h"
 #include "CppUnitResultWriter.h"
+#include "BenchmarkResults.h"
 #include "OgreConfigFile.h"
 #include "OgrePlatform.h"
 #include "OgreBitesConfigDialog.h"
@@ -51,7 +52,10 @@ static id mAppDelegate;
 #include "PlayPenTestPlugin.h"
 #endif
 
-TestContext::TestContext(int argc, char** argv) : OgreBites::SampleContext(), mSuccess(true), mTimestep(0.01f), mCurrentTest(0), mBatch(0)
+// frames run before recording a benchmark, so loading and shader compilation are left out
+static const unsigned int BENCHMARK_WARMUP_FRAMES = 10;
+
+TestContext::TestContext(int argc, char** argv) : OgreBites::SampleContext(), mSuccess(true), mTimestep(0.01f), mCurrentTest(0), mBatch(0), mBenchmark(0)
 {
     Ogre::UnaryOptionList unOpt;
     Ogre::BinaryOptionList binOpt;
@@ -63,6 +67,7 @@ TestContext::TestContext(int argc, char** argv) : OgreBites::SampleContext(), mS
     unOpt["--nograb"] = false;  // do not grab mouse
     unOpt["-h"] = false;        // help, give usage details
     unOpt["--help"] = false;    // help, give usage details
+    unOpt["--bench"] = false;   // run as benchmarks
     binOpt["-m"] = "";          // optional comment
     binOpt["-rp"] = "";         // optional specified reference set location
     binOpt["-od"] = "";         // directory to write output to
@@ -71,6 +76,9 @@ TestContext::TestContext(int argc, char** argv) : OgreBites::SampleContext(), mS
     binOpt["-n"] = "AUTO";      // name for this batch
     binOpt["-rs"] = "SAVED";    // rendersystem to use (default: use name from the config file/dialog)
     binOpt["-o"] = "NONE";      // path to output a summary file to (default: don't output a file)
+    binOpt["-bf"] = "200";      // frames to record per benchmark
+    binOpt["-bb"] = "";         // benchmark results to compare against
+    binOpt["-bt"] = "10";       // slowdown in percent that fails a benchmark
 
     // Parse.
     Ogre::findCommandLineOpts(argc, argv, unOpt, binOpt);
@@ -88,6 +96,10 @@ TestContext::TestContext(int argc, char** argv) : OgreBites::SampleContext(), mS
     mReferenceSetPath = binOpt["-rp"];
     mSummaryOutputDir = binOpt["-o"];
     mHelp = unOpt["-h"] || unOpt["--help"];
+    mBenchmarkMode = unOpt["--bench"];
+    mBenchmarkFrames = StringConverter::parseUnsignedInt(binOpt["-bf"], 200);
+    mBenchmarkBaseline = binOpt["-bb"];
+    mBenchmarkThreshold = StringConverter::parseReal(binOpt["-bt"], 10) / 100;
 
     if(mReferenceSetPath == BLANKSTRING)
         mReferenceSetPath = mOutputDir;
@@ -98,6 +110,7 @@ TestContext::~TestContext()
 {
     if (mBatch)
         delete mBatch;
+    delete mBenchmark;
 }
 //-----------------------------------------------------------------------
 
@@ -221,6 +234,9 @@ void TestContext::setup()
                            mWindow->getWidth(), mWindow->getHeight(), mOutputDir + batchName + "/");
     mBatch->comment = mComment;
 
+    if (mBenchmarkMode)
+        mBenchmark = new BenchmarkResults(mRoot->getRenderSystem());
+
     OgreBites::Sample* firstTest = loadTests(mTestSetName);
     if (firstTest)
         runSample(firstTest);
@@ -332,6 +348,9 @@ bool TestContext::frameStarted(const Ogre::FrameEvent& evt)
         // track frame number for screenshot purposes
         ++mCurrentFrame;
 
+        if (mBenchmark)
+            mBenchmark->frameStarted(mCurrentFrame > BENCHMARK_WARMUP_FRAMES);
+
         // regular update function
         return mCurrentTest->frameStarted(fixed_evt);
     }
@@ -355,7 +374,24 @@ bool TestContext::frameEnded(const Ogre::FrameEvent& evt)
     fixed_evt.timeSinceLastFrame = mTimestep;
     fixed_evt.timeSinceLastEvent = mTimestep;
 
-    if (mCurrentTest) // if a test is running
+    if (mCurrentTest && mBenchmark) // if a benchmark is running
+    {
+        mBenchmark->frameEnded(mCurrentFrame > BENCHMARK_WARMUP_FRAMES);
+
+        if (mCurrentFrame >= BENCHMARK_WARMUP_FRAMES + mBenchmarkFrames)
+        {
+            mBenchmark->endTest();
+            createDummyScene();
+
+            // continue onto the next test
+            runSample(0);
+
+            return true;
+        }
+
+        return mCurrentTest->frameEnded(fixed_evt);
+    }
+    else if (mCurrentTest) // if a test is running
     {
         if (mCurrentTest->isScreenshotFrame(mCurrentFrame))
         {
@@ -426,6 +462,9 @@ void TestContext::runSample(OgreBites::Sample* s)
         // Give a fixed timestep for particles and other time-dependent things in OGRE
         Ogre::ControllerManager::getSingleton().setFrameDelay(mTimestep);
         LogManager::getSingleton().logMessage("----- Running Visual Test " + mCurrentTest->getInfo()["Title"] + " -----");
+
+        if (mBenchmark)
+            mBenchmark->beginTest(mCurrentTest->getInfo()["Title"]);
     }
 
 #ifdef INCLUDE_RTSHADER_SYSTEM
@@ -483,6 +522,10 @@ void TestContext::go(OgreBites::Sample* initialSample)
         std::cout<<"\t-n [name]    Name for this result image set.\n";
         std::cout<<"\t-rs [name]   Render system to use.\n";
         std::cout<<"\t-o [path]    Path to output a simple summary file to.\n";
+        std::cout<<"\t--bench     Record frame times and render statistics instead of screenshots.\n";
+        std::cout<<"\t-bf [frames] Frames to record per test in benchmark mode (default 200).\n";
+        std::cout<<"\t-bb [path]   Benchmark results to compare against.\n";
+        std::cout<<"\t-bt [pct]    Slowdown over the baseline in percent that fails a test (default 10).\n";
         std::cout<<"\t--nograb     Do not restrict mouse to window (warning: may affect results).\n\n";
     }
 }
@@ -573,6 +616,12 @@ void TestContext::setupDirectories(Ogre::String batchName)
 
 void TestContext::finishedTests()
 {
+    if (mBenchmark)
+    {
+        finishedBenchmarks();
+        return;
+    }
+
     if ((mGenerateHtml || mSummaryOutputDir != "NONE") && !mReferenceSet)
     {
         const TestBatch* compareTo = 0;
@@ -650,6 +699,32 @@ void TestContext::finishedTests()
 }
 //-----------------------------------------------------------------------
 
+void TestContext::finishedBenchmarks()
+{
+    mBenchmark->writeToFile(mOutputDir + mBatch->name + "/benchmark.json", mRenderSystemName, mBenchmarkFrames);
+
+    if (mBenchmarkBaseline.empty())
+        return;
+
+    BenchmarkResults::TestMetrics baseline;
+    if (!BenchmarkResults::loadFromFile(mBenchmarkBaseline, baseline))
+    {
+        LogManager::getSingleton().logMessage("Could not load benchmark baseline " + mBenchmarkBaseline, LML_CRITICAL);
+        mSuccess = false;
+        return;
+    }
+
+    Ogre::StringVector regressions = mBenchmark->compare(baseline, mBenchmarkThreshold);
+    for (size_t i = 0; i < regressions.size(); ++i)
+    {
+        LogManager::getSingleton().logMessage("Benchmark regression - " + regressions[i], LML_CRITICAL);
+        std::cerr << "Benchmark regression - " << regressions[i] << std::endl;
+    }
+
+    mSuccess = mSuccess && regressions.empty();
+}
+//-----------------------------------------------------------------------
+
 Ogre::Real TestContext::getTimestep()
 {
     return mTimestep;
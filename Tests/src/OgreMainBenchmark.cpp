@@ -0,0 +1,412 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+/** Times the hot math and core primitives of OgreMain.
+
+    Usage: Test_OgreMainBenchmark [output.csv]
+
+    One line per case and size is written as CSV with the columns
+    benchmark,size,iterations,totalMs,nanosecondsPerItem
+    where an item is one element of the input, e.g. one matrix or one sorted key.
+*/
+
+#include "OgreLogManager.h"
+#include "OgreMatrix4.h"
+#include "OgreQuaternion.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreRadixSort.h"
+#include "OgreOptimisedUtil.h"
+#include "OgreEdgeListBuilder.h"
+#include "OgreFrustum.h"
+#include "OgreStringConverter.h"
+#include "OgreIdString.h"
+#include "OgreMurmurHash3.h"
+#include "OgreTimer.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace Ogre;
+
+namespace
+{
+    /// Elements per batch for the per element cases
+    const size_t BATCH_SIZE = 1024;
+    /// Batches run per case, so that each case takes a measurable time
+    const size_t BATCH_REPEATS = 2000;
+    /// Total number of keys sorted per size, so that each size takes a similar time
+    const size_t SORT_KEYS = 1 << 22;
+    const size_t SORT_SIZES[] = { 1000, 10000, 100000, 1000000 };
+
+    /// Written to, so that the compiler can't drop the timed work
+    volatile float gSink = 0;
+
+    uint32 gSeed = 12345;
+
+    /// LCG rather than rand(), so the inputs don't depend on the C runtime
+    Real random(Real low, Real high)
+    {
+        gSeed = gSeed * 1664525 + 1013904223;
+        return low + (high - low) * ((gSeed >> 8) / (Real)(1 << 24));
+    }
+
+    Matrix4 randomAffine(void)
+    {
+        Quaternion q(Radian(random(0, Math::TWO_PI)),
+            Vector3(random(-1, 1), random(-1, 1), random(-1, 1)).normalisedCopy());
+        Matrix4 m;
+        m.makeTransform(Vector3(random(-100, 100), random(-100, 100), random(-100, 100)),
+            Vector3(random(0.5f, 2), random(0.5f, 2), random(0.5f, 2)), q);
+        return m;
+    }
+
+    Quaternion randomOrientation(void)
+    {
+        Quaternion q(random(-1, 1), random(-1, 1), random(-1, 1), random(-1, 1));
+        q.normalise();
+        return q;
+    }
+
+    class Results
+    {
+    public:
+        Results(std::ostream& out) : mOut(out)
+        {
+            mOut << "benchmark,size,iterations,totalMs,nanosecondsPerItem\n";
+        }
+
+        void add(const String& name, size_t size, size_t iterations, unsigned long micros)
+        {
+            mOut << name << "," << size << "," << iterations << ","
+                << micros / 1000.0 << "," << micros * 1000.0 / (size * iterations) << "\n";
+            mOut.flush();
+        }
+
+    private:
+        std::ostream& mOut;
+    };
+
+    void benchmarkMath(Results& results)
+    {
+        vector<Matrix4>::type matrices(BATCH_SIZE);
+        vector<Matrix4>::type outMatrices(BATCH_SIZE);
+        vector<Quaternion>::type from(BATCH_SIZE);
+        vector<Quaternion>::type to(BATCH_SIZE);
+        vector<AxisAlignedBox>::type boxes(BATCH_SIZE);
+        for (size_t i = 0; i < BATCH_SIZE; ++i)
+        {
+            matrices[i] = randomAffine();
+            from[i] = randomOrientation();
+            to[i] = randomOrientation();
+            Vector3 centre(random(-100, 100), random(-100, 100), random(-100, 100));
+            Vector3 halfSize(random(1, 10), random(1, 10), random(1, 10));
+            boxes[i].setExtents(centre - halfSize, centre + halfSize);
+        }
+        const Matrix4 base = randomAffine();
+        Timer timer;
+
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+            for (size_t i = 0; i < BATCH_SIZE; ++i)
+                outMatrices[i] = base * matrices[i];
+        results.add("Matrix4::concatenate", BATCH_SIZE, BATCH_REPEATS, timer.getMicroseconds());
+        gSink += outMatrices[BATCH_SIZE - 1][0][3];
+
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+            for (size_t i = 0; i < BATCH_SIZE; ++i)
+                outMatrices[i] = base.concatenateAffine(matrices[i]);
+        results.add("Matrix4::concatenateAffine", BATCH_SIZE, BATCH_REPEATS, timer.getMicroseconds());
+        gSink += outMatrices[BATCH_SIZE - 1][0][3];
+
+        Quaternion sum(0, 0, 0, 0);
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+            for (size_t i = 0; i < BATCH_SIZE; ++i)
+                sum = sum + Quaternion::Slerp(0.3f, from[i], to[i], true);
+        results.add("Quaternion::Slerp", BATCH_SIZE, BATCH_REPEATS, timer.getMicroseconds());
+
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+            for (size_t i = 0; i < BATCH_SIZE; ++i)
+                sum = sum + Quaternion::nlerp(0.3f, from[i], to[i], true);
+        results.add("Quaternion::nlerp", BATCH_SIZE, BATCH_REPEATS, timer.getMicroseconds());
+        gSink += sum.w;
+
+        vector<AxisAlignedBox>::type outBoxes(BATCH_SIZE);
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+        {
+            for (size_t i = 0; i < BATCH_SIZE; ++i)
+            {
+                outBoxes[i] = boxes[i];
+                outBoxes[i].transformAffine(matrices[i]);
+            }
+        }
+        results.add("AxisAlignedBox::transformAffine", BATCH_SIZE, BATCH_REPEATS, timer.getMicroseconds());
+        gSink += outBoxes[BATCH_SIZE - 1].getMaximum().x;
+    }
+
+    struct FloatSortFunctor
+    {
+        float operator()(const float& p) const { return p; }
+    };
+
+    void benchmarkRadixSort(Results& results)
+    {
+        for (size_t s = 0; s < sizeof(SORT_SIZES) / sizeof(SORT_SIZES[0]); ++s)
+        {
+            size_t size = SORT_SIZES[s];
+            size_t repeats = SORT_KEYS / size;
+
+            // a fresh unsorted copy per repeat, made before timing
+            vector<vector<float>::type>::type lists(repeats);
+            for (size_t r = 0; r < repeats; ++r)
+            {
+                lists[r].resize(size);
+                for (size_t i = 0; i < size; ++i)
+                    lists[r][i] = random(-10000, 10000);
+            }
+
+            RadixSort<vector<float>::type, float, float> sorter;
+            FloatSortFunctor func;
+            Timer timer;
+            for (size_t r = 0; r < repeats; ++r)
+                sorter.sort(lists[r], func);
+            results.add("RadixSort", size, repeats, timer.getMicroseconds());
+            gSink += lists[repeats - 1][0];
+        }
+    }
+
+    void benchmarkOptimisedUtil(Results& results)
+    {
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        const size_t count = BATCH_SIZE;
+        const size_t weights = 4;
+
+        // positions and normals interleaved, as in a typical vertex buffer
+        vector<float>::type srcVertices(count * 6);
+        vector<float>::type dstVertices(count * 6);
+        vector<float>::type morphTarget(count * 3);
+        vector<float>::type blendWeights(count * weights);
+        vector<unsigned char>::type blendIndices(count * weights);
+        vector<Matrix4>::type bones(64);
+        vector<Matrix4*>::type bonePointers(bones.size());
+        for (size_t i = 0; i < bones.size(); ++i)
+        {
+            bones[i] = randomAffine();
+            bonePointers[i] = &bones[i];
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (size_t c = 0; c < 6; ++c)
+                srcVertices[i * 6 + c] = random(-1, 1);
+            for (size_t c = 0; c < 3; ++c)
+                morphTarget[i * 3 + c] = random(-1, 1);
+            for (size_t w = 0; w < weights; ++w)
+            {
+                blendWeights[i * weights + w] = 1.0f / weights;
+                blendIndices[i * weights + w] = (unsigned char)(random(0, 63.99f));
+            }
+        }
+        Timer timer;
+
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+        {
+            util->softwareVertexSkinning(&srcVertices[0], &dstVertices[0],
+                &srcVertices[3], &dstVertices[3], &blendWeights[0], &blendIndices[0],
+                &bonePointers[0], 24, 24, 24, 24, weights * sizeof(float), weights, weights, count);
+        }
+        results.add("OptimisedUtil::softwareVertexSkinning", count, BATCH_REPEATS, timer.getMicroseconds());
+        gSink += dstVertices[0];
+
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+        {
+            util->softwareVertexMorph(0.3f, &srcVertices[0], &morphTarget[0], &dstVertices[0],
+                24, 12, 24, count, false);
+        }
+        results.add("OptimisedUtil::softwareVertexMorph", count, BATCH_REPEATS, timer.getMicroseconds());
+        gSink += dstVertices[0];
+
+        vector<Matrix4>::type srcMatrices(count);
+        vector<Matrix4>::type dstMatrices(count);
+        for (size_t i = 0; i < count; ++i)
+            srcMatrices[i] = randomAffine();
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+            util->concatenateAffineMatrices(bones[0], &srcMatrices[0], &dstMatrices[0], count);
+        results.add("OptimisedUtil::concatenateAffineMatrices", count, BATCH_REPEATS, timer.getMicroseconds());
+        gSink += dstMatrices[0][0][0];
+
+        // a triangle per vertex, indexing neighbours
+        vector<float>::type positions(count * 3);
+        vector<EdgeData::Triangle>::type triangles(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (size_t c = 0; c < 3; ++c)
+                positions[i * 3 + c] = srcVertices[i * 6 + c];
+            for (size_t v = 0; v < 3; ++v)
+                triangles[i].vertIndex[v] = (i + v * 7) % count;
+        }
+        Vector4* faceNormals = static_cast<Vector4*>(OGRE_MALLOC_SIMD(count * sizeof(Vector4), MEMCATEGORY_GENERAL));
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+            util->calculateFaceNormals(&positions[0], &triangles[0], faceNormals, count);
+        results.add("OptimisedUtil::calculateFaceNormals", count, BATCH_REPEATS, timer.getMicroseconds());
+
+        const Vector4 lightPos(10, 20, 30, 1);
+        vector<char>::type lightFacings(count);
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+            util->calculateLightFacing(lightPos, faceNormals, &lightFacings[0], count);
+        results.add("OptimisedUtil::calculateLightFacing", count, BATCH_REPEATS, timer.getMicroseconds());
+        gSink += lightFacings[0];
+        OGRE_FREE_SIMD(faceNormals, MEMCATEGORY_GENERAL);
+
+        vector<float>::type extruded(count * 3);
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+            util->extrudeVertices(lightPos, 1000, &positions[0], &extruded[0], count);
+        results.add("OptimisedUtil::extrudeVertices", count, BATCH_REPEATS, timer.getMicroseconds());
+        gSink += extruded[0];
+
+        // the six planes of a frustum looking down -z
+        const float planes[] = {
+            0, 0, -1, -1,   0, 0, 1, 1000,
+            0.7f, 0, -0.7f, 0,   -0.7f, 0, -0.7f, 0,
+            0, 0.7f, -0.7f, 0,   0, -0.7f, -0.7f, 0 };
+        float* bounds = static_cast<float*>(OGRE_MALLOC_SIMD(
+            Frustum::getPackedBoundsSize(count) * sizeof(float), MEMCATEGORY_GENERAL));
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3 centre(random(-500, 500), random(-500, 500), random(-1000, 0));
+            Vector3 halfSize(random(1, 20), random(1, 20), random(1, 20));
+            Frustum::packBounds(AxisAlignedBox(centre - halfSize, centre + halfSize), i, bounds);
+        }
+        vector<uint32>::type visibility((count + 31) / 32);
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+            util->calculateBoxVisibility(planes, 6, bounds, &visibility[0], count);
+        results.add("OptimisedUtil::calculateBoxVisibility", count, BATCH_REPEATS, timer.getMicroseconds());
+        gSink += (float)visibility[0];
+        OGRE_FREE_SIMD(bounds, MEMCATEGORY_GENERAL);
+    }
+
+    void benchmarkStrings(Results& results)
+    {
+        const size_t repeats = BATCH_REPEATS / 10;
+        StringVector reals(BATCH_SIZE);
+        StringVector ints(BATCH_SIZE);
+        StringVector vectors(BATCH_SIZE);
+        StringVector names(BATCH_SIZE);
+        for (size_t i = 0; i < BATCH_SIZE; ++i)
+        {
+            reals[i] = StringConverter::toString(random(-1000, 1000));
+            ints[i] = StringConverter::toString((int)random(-100000, 100000));
+            vectors[i] = StringConverter::toString(Vector3(random(-1, 1), random(-1, 1), random(-1, 1)));
+            // resource like names of varying length
+            names[i] = "Examples/Material/" + StringConverter::toString(i) + "/Pass" +
+                String((size_t)random(0, 32), 'x');
+        }
+        Timer timer;
+
+        float sum = 0;
+        timer.reset();
+        for (size_t r = 0; r < repeats; ++r)
+            for (size_t i = 0; i < BATCH_SIZE; ++i)
+                sum += StringConverter::parseReal(reals[i]);
+        results.add("StringConverter::parseReal", BATCH_SIZE, repeats, timer.getMicroseconds());
+
+        timer.reset();
+        for (size_t r = 0; r < repeats; ++r)
+            for (size_t i = 0; i < BATCH_SIZE; ++i)
+                sum += (float)StringConverter::parseInt(ints[i]);
+        results.add("StringConverter::parseInt", BATCH_SIZE, repeats, timer.getMicroseconds());
+
+        timer.reset();
+        for (size_t r = 0; r < repeats; ++r)
+            for (size_t i = 0; i < BATCH_SIZE; ++i)
+                sum += StringConverter::parseVector3(vectors[i]).x;
+        results.add("StringConverter::parseVector3", BATCH_SIZE, repeats, timer.getMicroseconds());
+        gSink += sum;
+
+        uint32 hashes = 0;
+        timer.reset();
+        for (size_t r = 0; r < BATCH_REPEATS; ++r)
+            for (size_t i = 0; i < BATCH_SIZE; ++i)
+                hashes ^= IdString(names[i]).mHash;
+        results.add("IdString", BATCH_SIZE, BATCH_REPEATS, timer.getMicroseconds());
+
+        // hashing of larger blocks, e.g. for caches keyed by content
+        vector<unsigned char>::type block(64 * 1024);
+        for (size_t i = 0; i < block.size(); ++i)
+            block[i] = (unsigned char)random(0, 255.99f);
+        const size_t blockRepeats = 2000;
+        uint32 hash32 = 0;
+        timer.reset();
+        for (size_t r = 0; r < blockRepeats; ++r)
+            MurmurHash3_x86_32(&block[0], block.size(), (uint32)r, &hash32);
+        results.add("MurmurHash3_x86_32", block.size(), blockRepeats, timer.getMicroseconds());
+        hashes ^= hash32;
+
+        uint32 hash128[4];
+        timer.reset();
+        for (size_t r = 0; r < blockRepeats; ++r)
+            MurmurHash3_128(&block[0], block.size(), (uint32)r, hash128);
+        results.add("MurmurHash3_128", block.size(), blockRepeats, timer.getMicroseconds());
+        gSink += (float)(hashes ^ hash128[0]);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::ofstream file;
+    if (argc > 1)
+    {
+        file.open(argv[1]);
+        if (!file)
+        {
+            std::cerr << "Can't write to " << argv[1] << std::endl;
+            return 1;
+        }
+    }
+
+    LogManager* logMgr = OGRE_NEW LogManager();
+    logMgr->createLog("OgreMainBenchmark.log", true, false);
+
+    Results results(argc > 1 ? file : std::cout);
+    benchmarkMath(results);
+    benchmarkRadixSort(results);
+    benchmarkOptimisedUtil(results);
+    benchmarkStrings(results);
+
+    OGRE_DELETE logMgr;
+    return 0;
+}
@@ -70,8 +70,12 @@ void help(void)
     cout << "-srcgl     = Interpret ambiguous colours as GL style" << endl;
     cout << "-E endian  = Set endian mode 'big' 'little' or 'native' (default)" << endl;
     cout << "-b         = Recalculate bounding box (static meshes only)" << endl;
+    cout << "-o         = Reorder faces and vertices for the vertex cache" << endl;
+    cout << "-pack      = Pack vertex data into half floats and normalised shorts" << endl;
+    cout << "-bones max = Split submeshes influenced by more than max bones, so they" << endl;
+    cout << "             can be skinned in a vertex program (at least 12)" << endl;
     cout << "-V version = Specify OGRE version format to write instead of latest" << endl;
-    cout << "             Options are: 1.10, 1.8, 1.7, 1.4, 1.0" << endl;
+    cout << "             Options are: 1.11, 1.10, 1.8, 1.7, 1.4, 1.0" << endl;
     cout << "sourcefile = name of file to convert" << endl;
     cout << "destfile   = optional name of file to write to. If you don't" << endl;
     cout << "             specify this OGRE overwrites the existing file." << endl;
@@ -100,6 +104,9 @@ struct UpgradeOptions {
     bool usePercent;
     Serializer::Endian endian;
     bool recalcBounds;
+    bool optimiseVertexCache;
+    bool packVertexData;
+    size_t maxBonesPerSubMesh;
     MeshVersion targetVersion;
 
 };
@@ -141,6 +148,9 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
     opts.numLods = 0;
     opts.usePercent = true;
     opts.recalcBounds = false;
+    opts.optimiseVertexCache = false;
+    opts.packVertexData = false;
+    opts.maxBonesPerSubMesh = 0;
     opts.targetVersion = MESH_VERSION_LATEST;
 
 
@@ -184,6 +194,10 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
     if (ui->second) {
         opts.recalcBounds = true;
     }
+    ui = unOpts.find("-o");
+    opts.optimiseVertexCache = ui->second;
+    ui = unOpts.find("-pack");
+    opts.packVertexData = ui->second;
 
 
     BinaryOptionList::iterator bi = binOpts.find("-l");
@@ -219,6 +233,10 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
             opts.endian = Serializer::ENDIAN_NATIVE;
     }
     }
+    bi = binOpts.find("-bones");
+    if (!bi->second.empty()) {
+        opts.maxBonesPerSubMesh = StringConverter::parseUnsignedInt(bi->second);
+    }
     bi = binOpts.find("-td");
     if (!bi->second.empty()) {
         if (bi->second == "uvw") {
@@ -236,7 +254,9 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
     
     bi = binOpts.find("-V");
     if (!bi->second.empty()) {
-        if (bi->second == "1.10") {
+        if (bi->second == "1.11") {
+            opts.targetVersion = MESH_VERSION_1_11;
+        } else if (bi->second == "1.10") {
             opts.targetVersion = MESH_VERSION_1_10;
         } else if (bi->second == "1.8") {
             opts.targetVersion = MESH_VERSION_1_8;
@@ -595,6 +615,26 @@ void recalcBounds(Mesh* mesh)
     mesh->_setBoundingSphereRadius(radius);
 }
 
+void packVertexData(Mesh* mesh)
+{
+    // Animation on the CPU and shadow volumes read positions and normals as floats
+    bool packGeometry = !mesh->hasSkeleton() && !mesh->hasVertexAnimation() &&
+        mesh->getPoseList().empty() && !mesh->isEdgeListBuilt();
+    if (!packGeometry) {
+        cout << "\nMesh is animated or has edge lists, only packing texture coordinates";
+    }
+
+    if (mesh->sharedVertexData) {
+        mesh->sharedVertexData->packElements(packGeometry, packGeometry, true);
+    }
+    for (unsigned short i = 0; i < mesh->getNumSubMeshes(); ++i) {
+        SubMesh* sm = mesh->getSubMesh(i);
+        if (!sm->useSharedVertices) {
+            sm->vertexData->packElements(packGeometry, packGeometry, true);
+        }
+    }
+}
+
 void printLodConfig(const LodConfig& lodConfig)
 {
     cout << "\n\nLOD config summary:";
@@ -1019,6 +1059,8 @@ int main(int numargs, char** args)
         unOptList["-srcd3d"] = false;
         unOptList["-autogen"] = false;
         unOptList["-b"] = false;
+        unOptList["-o"] = false;
+        unOptList["-pack"] = false;
         binOptList["-l"] = "";
         binOptList["-d"] = "";
         binOptList["-p"] = "";
@@ -1027,6 +1069,7 @@ int main(int numargs, char** args)
         binOptList["-td"] = "";
         binOptList["-ts"] = "";
         binOptList["-V"] = "";
+        binOptList["-bones"] = "";
 
         int startIdx = findCommandLineOpts(numargs, args, unOptList, binOptList);
         parseOpts(unOptList, binOptList);
@@ -1071,9 +1114,23 @@ int main(int numargs, char** args)
 
         // Deal with VET_COLOUR ambiguities
         resolveColourAmbiguities(mesh);
+
+        // Before the LOD, which is generated per submesh
+        if (opts.maxBonesPerSubMesh) {
+            cout << "\nSplitting submeshes by bones...";
+            mesh->splitSubMeshesByBones(opts.maxBonesPerSubMesh);
+            cout << "success\n";
+        }
         
         buildLod(meshPtr);
 
+        // Before the edge lists, which would otherwise have to be rebuilt
+        if (opts.optimiseVertexCache) {
+            cout << "\nOptimising for the vertex cache...";
+            mesh->optimiseVertexCache();
+            cout << "success\n";
+        }
+
         if (opts.interactive) {
             do {
                 std::cout << "\nWould you like to (b)uild/(r)emove/(k)eep Edge lists? (b/r/k) ";
@@ -1159,6 +1216,13 @@ int main(int numargs, char** args)
             recalcBounds(mesh);
         }
 
+        // Last, as the steps above read the vertices as floats
+        if (opts.packVertexData) {
+            cout << "\nPacking vertex data...";
+            packVertexData(mesh);
+            cout << "success\n";
+        }
+
         meshSerializer->exportMesh(mesh, dest, opts.targetVersion, opts.endian);
     
     }
@@ -0,0 +1,358 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Ogre.h"
+#include "OgreConfigFile.h"
+#include "OgreFileSystemLayer.h"
+#include "OgreRTShaderSystem.h"
+
+#include <iostream>
+#include <fstream>
+
+using namespace std;
+using namespace Ogre;
+
+struct BuilderOptions
+{
+    String pluginsFile;
+    String resourcesFile;
+    String renderSystem;
+    String rtShaderLibPath;
+    String logFile;
+    String outputFile;
+    StringVector schemes;
+    StringVector groups;
+    // Point, directional and spot light counts of each light configuration
+    Ogre::vector<int>::type lightCounts;
+
+    BuilderOptions()
+        : pluginsFile("plugins.cfg")
+        , resourcesFile("resources.cfg")
+        , logFile("OgreShaderCacheBuilder.log")
+    {
+    }
+};
+
+void help(void)
+{
+    // Print help message
+    cout << endl << "OgreShaderCacheBuilder: Compiles the shaders of a content set ahead of time." << endl;
+    cout << "Loads the resources, generates the RTSS programs of every material for every" << endl;
+    cout << "scheme and light configuration, renders every material once so the programs" << endl;
+    cout << "get compiled and linked, and writes the GpuProgramManager microcode cache." << endl << endl;
+    cout << "Usage: OgreShaderCacheBuilder [opts] outputfile" << endl;
+    cout << "-plugins file      = plugins file (default plugins.cfg)" << endl;
+    cout << "-resources file    = resources file (default resources.cfg)" << endl;
+    cout << "-rendersystem name = render system to compile for (default the first one loaded)" << endl;
+    cout << "-rtss path         = RTShaderLib directory, enables the RTSS" << endl;
+    cout << "-scheme name       = RTSS scheme to generate, may be repeated" << endl;
+    cout << "                     (default " << RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME << ")" << endl;
+    cout << "-lights p,d,s      = RTSS light configuration as point, directional and spot" << endl;
+    cout << "                     light counts, may be repeated (default 0,1,0)" << endl;
+    cout << "-group name        = only build the materials of this resource group, may be repeated" << endl;
+    cout << "-log filename      = name of the log file (default OgreShaderCacheBuilder.log)" << endl;
+    cout << "outputfile         = microcode cache file to write, load it at runtime with" << endl;
+    cout << "                     GpuProgramManager::loadMicrocodeCache" << endl;
+    cout << endl;
+}
+
+bool parseArgs(int numargs, char** args, BuilderOptions& opts)
+{
+    for (int i = 1; i < numargs; ++i)
+    {
+        String arg = args[i];
+        bool hasValue = i + 1 < numargs;
+
+        if (arg == "-plugins" && hasValue)
+            opts.pluginsFile = args[++i];
+        else if (arg == "-resources" && hasValue)
+            opts.resourcesFile = args[++i];
+        else if (arg == "-rendersystem" && hasValue)
+            opts.renderSystem = args[++i];
+        else if (arg == "-rtss" && hasValue)
+            opts.rtShaderLibPath = args[++i];
+        else if (arg == "-scheme" && hasValue)
+            opts.schemes.push_back(args[++i]);
+        else if (arg == "-group" && hasValue)
+            opts.groups.push_back(args[++i]);
+        else if (arg == "-log" && hasValue)
+            opts.logFile = args[++i];
+        else if (arg == "-lights" && hasValue)
+        {
+            StringVector counts = StringUtil::split(args[++i], ",");
+            if (counts.size() != 3)
+                return false;
+            for (int j = 0; j < 3; ++j)
+                opts.lightCounts.push_back(StringConverter::parseInt(counts[j]));
+        }
+        else if (arg[0] != '-' && opts.outputFile.empty())
+            opts.outputFile = arg;
+        else
+            return false;
+    }
+
+    if (opts.schemes.empty())
+        opts.schemes.push_back(RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME);
+
+    if (opts.lightCounts.empty())
+    {
+        opts.lightCounts.push_back(0);
+        opts.lightCounts.push_back(1);
+        opts.lightCounts.push_back(0);
+    }
+
+    return !opts.outputFile.empty();
+}
+
+void locateResources(const BuilderOptions& opts)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+
+    ConfigFile cf;
+    cf.load(opts.resourcesFile);
+
+    // go through all specified resource groups
+    ConfigFile::SettingsBySection_::const_iterator seci;
+    for (seci = cf.getSettingsBySection().begin(); seci != cf.getSettingsBySection().end(); ++seci)
+    {
+        const ConfigFile::SettingsMultiMap& settings = seci->second;
+        ConfigFile::SettingsMultiMap::const_iterator i;
+
+        for (i = settings.begin(); i != settings.end(); ++i)
+            rgm.addResourceLocation(FileSystemLayer::resolveBundlePath(i->second), i->first, seci->first);
+    }
+
+    if (opts.rtShaderLibPath.empty())
+        return;
+
+    // Add the RTSS libraries of the language the render system compiles
+    const String& path = opts.rtShaderLibPath;
+    const String& group = ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME;
+    GpuProgramManager& gpm = GpuProgramManager::getSingleton();
+
+    rgm.addResourceLocation(path + "/materials", "FileSystem", group);
+    if (gpm.isSyntaxSupported("glsles"))
+    {
+        rgm.addResourceLocation(path + "/GLSL", "FileSystem", group);
+        rgm.addResourceLocation(path + "/GLSLES", "FileSystem", group);
+    }
+    else if (gpm.isSyntaxSupported("glsl"))
+    {
+        rgm.addResourceLocation(path + "/GLSL", "FileSystem", group);
+    }
+    else if (gpm.isSyntaxSupported("hlsl"))
+    {
+        rgm.addResourceLocation(path + "/HLSL", "FileSystem", group);
+        rgm.addResourceLocation(path + "/HLSL_Cg", "FileSystem", group);
+    }
+}
+
+bool selectMaterial(const MaterialPtr& mat, const BuilderOptions& opts)
+{
+    if (opts.groups.empty())
+        return true;
+
+    return std::find(opts.groups.begin(), opts.groups.end(), mat->getGroup()) != opts.groups.end();
+}
+
+/// Render every material once with the given scheme so its programs get compiled and linked
+size_t renderMaterials(Root* root, Viewport* vp, Entity* ent,
+    const Ogre::vector<MaterialPtr>::type& materials, const String& scheme)
+{
+    size_t rendered = 0;
+
+    vp->setMaterialScheme(scheme);
+
+    for (size_t i = 0; i < materials.size(); ++i)
+    {
+        const MaterialPtr& mat = materials[i];
+
+        mat->load();
+        if (mat->getBestTechnique() == NULL)
+            continue;
+
+        ent->setMaterial(mat);
+        try
+        {
+            root->renderOneFrame();
+            ++rendered;
+        }
+        catch (Exception& e)
+        {
+            LogManager::getSingleton().logMessage("Could not render material '" + mat->getName() +
+                "' with scheme '" + scheme + "': " + e.getDescription(), LML_CRITICAL);
+        }
+    }
+
+    return rendered;
+}
+
+int main(int numargs, char** args)
+{
+    BuilderOptions opts;
+
+    if (!parseArgs(numargs, args, opts))
+    {
+        help();
+        return -1;
+    }
+
+    Root* root = new Root(opts.pluginsFile, "", opts.logFile);
+
+    // Pick the render system
+    const RenderSystemList& renderers = root->getAvailableRenderers();
+    RenderSystem* rs = opts.renderSystem.empty() ?
+        (renderers.empty() ? NULL : renderers.front()) : root->getRenderSystemByName(opts.renderSystem);
+
+    if (!rs)
+    {
+        cout << "No render system found, check " << opts.pluginsFile << endl;
+        delete root;
+        return -1;
+    }
+
+    rs->setConfigOption("Full Screen", "No");
+    root->setRenderSystem(rs);
+    root->initialise(false);
+
+    // The programs need a context to compile in, but nothing has to be shown
+    NameValuePairList miscParams;
+    miscParams["hidden"] = "true";
+    RenderWindow* window = root->createRenderWindow("OgreShaderCacheBuilder", 64, 64, false, &miscParams);
+
+    GpuProgramManager::getSingleton().setSaveMicrocodesToCache(true);
+
+    locateResources(opts);
+
+    RTShader::ShaderGenerator* shaderGenerator = NULL;
+    if (!opts.rtShaderLibPath.empty() && RTShader::ShaderGenerator::initialize())
+        shaderGenerator = RTShader::ShaderGenerator::getSingletonPtr();
+
+    ResourceGroupManager::getSingleton().initialiseAllResourceGroups();
+
+    // A scene with a single entity each material is drawn on
+    SceneManager* sceneMgr = root->createSceneManager(ST_GENERIC);
+    if (shaderGenerator)
+        shaderGenerator->addSceneManager(sceneMgr);
+
+    Camera* cam = sceneMgr->createCamera("ShaderCacheBuilderCamera");
+    cam->setNearClipDistance(0.1f);
+    cam->setPosition(0, 0, 2);
+    cam->lookAt(0, 0, 0);
+    Viewport* vp = window->addViewport(cam);
+
+    MeshPtr plane = MeshManager::getSingleton().createPlane("ShaderCacheBuilderPlane",
+        ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, Plane(Vector3::UNIT_Z, 0), 1, 1);
+    plane->buildTangentVectors();
+    Entity* ent = sceneMgr->createEntity(plane);
+    sceneMgr->getRootSceneNode()->attachObject(ent);
+
+    Ogre::vector<MaterialPtr>::type materials;
+    ResourceManager::ResourceMapIterator it = MaterialManager::getSingleton().getResourceIterator();
+    while (it.hasMoreElements())
+    {
+        MaterialPtr mat = static_pointer_cast<Material>(it.getNext());
+        if (selectMaterial(mat, opts))
+            materials.push_back(mat);
+    }
+
+    cout << "Building the shaders of " << materials.size() << " materials with " << rs->getName() << endl;
+
+    // The hand written programs of the materials
+    size_t rendered = renderMaterials(root, vp, ent, materials, MaterialManager::DEFAULT_SCHEME_NAME);
+
+    if (shaderGenerator)
+    {
+        for (size_t i = 0; i < materials.size(); ++i)
+        {
+            for (size_t s = 0; s < opts.schemes.size(); ++s)
+            {
+                shaderGenerator->createShaderBasedTechnique(*materials[i],
+                    MaterialManager::DEFAULT_SCHEME_NAME, opts.schemes[s]);
+            }
+        }
+
+        for (size_t l = 0; l + 2 < opts.lightCounts.size(); l += 3)
+        {
+            const int lightCount[3] = { opts.lightCounts[l], opts.lightCounts[l + 1], opts.lightCounts[l + 2] };
+
+            // Lights matching the configuration, for passes iterating per light
+            sceneMgr->destroyAllLights();
+            const Light::LightTypes lightTypes[3] = { Light::LT_POINT, Light::LT_DIRECTIONAL, Light::LT_SPOTLIGHT };
+            for (int type = 0; type < 3; ++type)
+            {
+                for (int n = 0; n < lightCount[type]; ++n)
+                {
+                    Light* light = sceneMgr->createLight();
+                    light->setType(lightTypes[type]);
+                    light->setPosition(0, 0, 1);
+                    light->setDirection(0, 0, -1);
+                }
+            }
+
+            for (size_t s = 0; s < opts.schemes.size(); ++s)
+            {
+                const String& scheme = opts.schemes[s];
+                RTShader::RenderState* renderState = shaderGenerator->getRenderState(scheme);
+
+                renderState->setLightCountAutoUpdate(false);
+                renderState->setLightCount(lightCount);
+                shaderGenerator->invalidateScheme(scheme);
+                shaderGenerator->validateScheme(scheme);
+
+                cout << "Scheme " << scheme << ", lights " << lightCount[0] << "," << lightCount[1] << "," << lightCount[2] << endl;
+                rendered += renderMaterials(root, vp, ent, materials, scheme);
+            }
+        }
+    }
+
+    // Write the microcode cache
+    std::fstream outFile(opts.outputFile.c_str(), std::ios::out | std::ios::binary);
+    int result = 0;
+
+    if (outFile.is_open())
+    {
+        DataStreamPtr ostream(new FileStreamDataStream(opts.outputFile, &outFile, false));
+        GpuProgramManager::getSingleton().saveMicrocodeCache(ostream);
+        cout << "Rendered " << rendered << " material permutations, wrote " << opts.outputFile << endl;
+    }
+    else
+    {
+        cout << "Could not write " << opts.outputFile << endl;
+        result = -1;
+    }
+
+    if (shaderGenerator)
+    {
+        shaderGenerator->removeSceneManager(sceneMgr);
+        RTShader::ShaderGenerator::destroy();
+    }
+    delete root;
+
+    return result;
+}
@@ -71,6 +71,8 @@ struct XmlOptions
     bool tangentSplitRotated;
     bool reorganiseBuffers;
     bool optimiseAnimations;
+    /// Keyframe reduction tolerances: position, orientation in degrees, scale (none if empty)
+    Vector3 keyFrameTolerances;
     bool quietMode;
     bool d3d;
     bool gl;
@@ -98,6 +100,9 @@ void help(void)
     cout << "                 n0 and n1 must be in the same buffer source & adjacent" << endl;
     cout << "                 to each other for the merge to work." << endl;
     cout << "-o             = DON'T optimise out redundant tracks & keyframes" << endl;
+    cout << "-kr p,d,s      = Reduce skeleton keyframes which interpolation reproduces" << endl;
+    cout << "                 within p units of position, d degrees of rotation and" << endl;
+    cout << "                 s of scale; for sampled animation like motion capture" << endl;
     cout << "-d3d           = Prefer D3D packed colour formats (default on Windows)" << endl;
     cout << "-gl            = Prefer GL packed colour formats (default on non-Windows)" << endl;
     cout << "-E endian      = Set endian mode 'big' 'little' or 'native' (default)" << endl;
@@ -136,6 +141,7 @@ XmlOptions parseArgs(int numArgs, char **args)
     //opts.tangentSplitRotated = false;
     //opts.reorganiseBuffers = true;
     opts.optimiseAnimations = true;
+    opts.keyFrameTolerances = Vector3::ZERO;
     opts.quietMode = false;
     opts.endian = Serializer::ENDIAN_NATIVE;
 
@@ -165,6 +171,7 @@ XmlOptions parseArgs(int numArgs, char **args)
     //binOpt["-f"] = "";
     binOpt["-E"] = "";
     binOpt["-x"] = "";
+    binOpt["-kr"] = "";
     binOpt["-log"] = "OgreXMLConverter.log";
     binOpt["-td"] = "";
     binOpt["-ts"] = "";
@@ -231,6 +238,16 @@ XmlOptions parseArgs(int numArgs, char **args)
             opts.mergeTexcoordResult = 1;
         }
 
+        bi = binOpt.find("-kr");
+        if (!bi->second.empty())
+        {
+            StringVector tolerances = StringUtil::split(bi->second, ",");
+            for (size_t i = 0; i < 3 && i < tolerances.size(); ++i)
+            {
+                opts.keyFrameTolerances[i] = StringConverter::parseReal(tolerances[i]);
+            }
+        }
+
         bi = binOpt.find("-x");
         if (!bi->second.empty())
         {
@@ -484,6 +501,15 @@ void XMLToBinary(XmlOptions opts)
         {
             newSkel->optimiseAllAnimations();
         }
+        if (opts.keyFrameTolerances != Vector3::ZERO)
+        {
+            size_t removed = newSkel->reduceAllAnimations(opts.keyFrameTolerances.x,
+                Degree(opts.keyFrameTolerances.y), opts.keyFrameTolerances.z);
+            if (!opts.quietMode)
+            {
+                cout << "Removed " << removed << " keyframes." << endl;
+            }
+        }
         skeletonSerializer->exportSkeleton(newSkel.get(), opts.dest, SKELETON_VERSION_LATEST, opts.endian);
 
         // Clean up the conversion skeleton